@@ -418,6 +418,18 @@ class CoreMLBackend(BackendDetails):
         minimum_deployment_target: ct.target = (
             CoreMLBackend.min_deployment_target_from_compile_specs(compile_specs)
         )
+        # Mutable buffers that the partitioner took over become Core ML states,
+        # which stay resident in MLState across predictions instead of being
+        # copied in and out as inputs and outputs. States require iOS18.
+        if (
+            len(edge_program.graph_signature.buffers_to_mutate) > 0
+            and minimum_deployment_target.value < ct.target.iOS18.value
+        ):
+            logger.warning(
+                "Raising the minimum deployment target to iOS18, "
+                "since the model mutates buffers that are converted to Core ML states."
+            )
+            minimum_deployment_target = ct.target.iOS18
         compute_units: ct.ComputeUnit = CoreMLBackend.compute_unit_from_compile_specs(
             compile_specs
         )
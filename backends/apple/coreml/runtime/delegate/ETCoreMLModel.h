@@ -68,6 +68,9 @@ __attribute__((objc_subclassing_restricted))
 
 - (BOOL)prewarmAndReturnError:(NSError* __autoreleasing*)error;
 
+/// Zeroes the model state, if the model has one.
+- (void)resetState;
+
 @end
 
 NS_ASSUME_NONNULL_END
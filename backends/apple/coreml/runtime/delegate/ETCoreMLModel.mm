@@ -323,6 +323,16 @@ void reset_state_for_feature_name(NSString *feature_name, MLState *state) {
                          self.identifier);
     }
 
+    [self resetState];
+
+    if (error) {
+        *error = localError;
+    }
+
+    return result;
+}
+
+- (void)resetState {
 #if MODEL_STATE_IS_SUPPORTED
     if (@available(macOS 15.0, iOS 18.0, tvOS 18.0, watchOS 11.0, *)) {
         NSDictionary<NSString *, MLFeatureDescription *> *stateDescriptions = self.mlModel.modelDescription.stateDescriptionsByName;
@@ -331,13 +341,6 @@ void reset_state_for_feature_name(NSString *feature_name, MLState *state) {
         }];
     }
 #endif
-
-
-    if (error) {
-        *error = localError;
-    }
-
-    return result;
 }
 
 @end
@@ -35,6 +35,12 @@ __attribute__((objc_subclassing_restricted))
 /// @param assetManager The asset manager used to manage storage of compiled models.
 - (instancetype)initWithAssetManager:(ETCoreMLAssetManager*)assetManager NS_DESIGNATED_INITIALIZER;
 
+/// The maximum number of unloaded models that are kept in memory, the least recently unloaded
+/// model is dropped first. Loading a model that is kept in memory reuses it instead of loading and
+/// specializing the compiled model again. The models are dropped when the system is low on memory.
+/// Defaults to `0`.
+@property (assign, atomic) NSUInteger maxInMemoryModelsCount;
+
 /// Loads the model from the AOT  data.
 ///
 /// The data is the AOT blob stored in the executorch Program. The method first parses the model
@@ -103,6 +109,19 @@ __attribute__((objc_subclassing_restricted))
 /// @retval `YES` if the model was pre-warmed otherwise `NO`.
 - (BOOL)prewarmModelWithHandle:(ModelHandle*)handle error:(NSError* __autoreleasing*)error;
 
+/// Pre-warms the model associated with the handle on a background queue. The executions of the
+/// model wait for the pre-warm to finish, so that the model is never executed concurrently with it.
+///
+/// @param handle The handle to the loaded model.
+- (void)prewarmModelAsynchronouslyWithHandle:(ModelHandle*)handle;
+
+/// Waits for the asynchronous pre-warm of the model associated with the handle, if any.
+///
+/// @param handle The handle to the loaded model.
+/// @param timeout When to stop waiting.
+/// @retval `YES` if the model is ready to execute otherwise `NO` if the wait timed out.
+- (BOOL)waitUntilModelIsReadyWithHandle:(ModelHandle*)handle timeout:(dispatch_time_t)timeout;
+
 /// Purges model cache.
 ///
 /// @param error   On failure, error is filled with the failure information.
@@ -341,6 +341,10 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
 @property (nonatomic, readonly, strong) NSMapTable<NSString *, dispatch_queue_t> *modelIdentifierToLoadingQueueMap;
 @property (nonatomic, readonly, strong) NSMutableDictionary<NSString *, ETCoreMLAsset *> *modelIdentifierToPrewarmedAssetMap;
 @property (nonatomic, readonly, strong) dispatch_queue_t prewarmQueue;
+@property (nonatomic, readonly, strong) NSMutableDictionary<NSValue *, dispatch_group_t> *handleToPrewarmGroupMap;
+// The executors of the unloaded models that are kept in memory, the least recently unloaded first.
+@property (nonatomic, readonly, strong) NSMutableArray<id<ETCoreMLModelExecutor>> *inMemoryExecutors;
+@property (nonatomic, readonly, strong) dispatch_source_t memoryPressureSource;
 
 @end
 
@@ -357,11 +361,26 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
         _fileManager = [[NSFileManager alloc] init];
         dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_DEFAULT, -1);
         _prewarmQueue = dispatch_queue_create("com.executorchcoreml.modelmanager.prewarm", attr);
+        _handleToPrewarmGroupMap = [NSMutableDictionary dictionary];
+        _inMemoryExecutors = [NSMutableArray array];
+        _memoryPressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE,
+                                                       0,
+                                                       DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL,
+                                                       dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+        __weak __typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(_memoryPressureSource, ^{
+            [weakSelf removeInMemoryModels];
+        });
+        dispatch_resume(_memoryPressureSource);
     }
     
     return self;
 }
 
+- (void)dealloc {
+    dispatch_source_cancel(_memoryPressureSource);
+}
+
 - (nullable id<ETCoreMLModelExecutor>)executorWithHandle:(ModelHandle *)handle {
     id<ETCoreMLModelExecutor> executor = nil;
     NSValue *key = [NSValue valueWithPointer:handle];
@@ -553,6 +572,13 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
     dispatch_queue_t loadingQueue = [self queueForLoadingModelWithIdentifier:identifier];
     auto inMemoryFSPtr = inMemoryFS.get();
     dispatch_sync(loadingQueue, ^{
+        executor = [self takeInMemoryExecutorWithIdentifier:identifier];
+        if (executor) {
+            // The previous user of the model may have left its state dirty.
+            [executor.model resetState];
+            return;
+        }
+        
         executor = [self modelExecutorWithMetadata:metadataValue
                                         inMemoryFS:inMemoryFSPtr
                                      configuration:configuration
@@ -562,6 +588,32 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
     return executor;
 }
 
+- (nullable id<ETCoreMLModelExecutor>)takeInMemoryExecutorWithIdentifier:(NSString *)identifier {
+    id<ETCoreMLModelExecutor> executor = nil;
+    os_unfair_lock_lock(&_lock);
+    for (NSUInteger i = self.inMemoryExecutors.count; i > 0; i--) {
+        id<ETCoreMLModelExecutor> inMemoryExecutor = self.inMemoryExecutors[i - 1];
+        if ([inMemoryExecutor.model.identifier isEqualToString:identifier]) {
+            executor = inMemoryExecutor;
+            [self.inMemoryExecutors removeObjectAtIndex:i - 1];
+            break;
+        }
+    }
+    os_unfair_lock_unlock(&_lock);
+    
+    return executor;
+}
+
+- (void)removeInMemoryModels {
+    NSArray<id<ETCoreMLModelExecutor>> *executors = nil;
+    os_unfair_lock_lock(&_lock);
+    executors = [self.inMemoryExecutors copy];
+    [self.inMemoryExecutors removeAllObjects];
+    os_unfair_lock_unlock(&_lock);
+    // Release the models outside of the lock.
+    executors = nil;
+}
+
 - (dispatch_queue_t)queueForLoadingModelWithIdentifier:(NSString *)identifier {
     os_unfair_lock_lock(&_lock);
     dispatch_queue_t queue = [self.modelIdentifierToLoadingQueueMap objectForKey:identifier];
@@ -602,6 +654,53 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
     return [model prewarmAndReturnError:error];
 }
 
+- (void)prewarmModelAsynchronouslyWithHandle:(ModelHandle *)handle {
+    ETCoreMLModel *model = [self modelWithHandle:handle];
+    if (!model) {
+        return;
+    }
+    
+    dispatch_group_t group = dispatch_group_create();
+    {
+        os_unfair_lock_lock(&_lock);
+        self.handleToPrewarmGroupMap[[NSValue valueWithPointer:handle]] = group;
+        os_unfair_lock_unlock(&_lock);
+    }
+    
+    dispatch_group_async(group, self.prewarmQueue, ^{
+        // The model logs the failure, and a model that failed to pre-warm can still be executed.
+        (void)[model prewarmAndReturnError:nil];
+    });
+}
+
+- (BOOL)waitUntilModelIsReadyWithHandle:(ModelHandle *)handle timeout:(dispatch_time_t)timeout {
+    NSValue *key = [NSValue valueWithPointer:handle];
+    dispatch_group_t group = nil;
+    {
+        os_unfair_lock_lock(&_lock);
+        group = self.handleToPrewarmGroupMap[key];
+        os_unfair_lock_unlock(&_lock);
+    }
+    
+    if (!group) {
+        return YES;
+    }
+    
+    if (dispatch_group_wait(group, timeout) != 0) {
+        return NO;
+    }
+    
+    {
+        os_unfair_lock_lock(&_lock);
+        if (self.handleToPrewarmGroupMap[key] == group) {
+            [self.handleToPrewarmGroupMap removeObjectForKey:key];
+        }
+        os_unfair_lock_unlock(&_lock);
+    }
+    
+    return YES;
+}
+
 - (void)prewarmRecentlyUsedAssetsWithMaxCount:(NSUInteger)maxCount {
     NSError *localError = nil;
     NSArray<ETCoreMLAsset *> *assets = [self.assetManager mostRecentlyUsedAssetsWithMaxCount:maxCount error:&localError];
@@ -690,6 +789,7 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
                 loggingOptions:(const executorchcoreml::ModelLoggingOptions&)loggingOptions
                    eventLogger:(const executorchcoreml::ModelEventLogger* _Nullable)eventLogger
                          error:(NSError * __autoreleasing *)error {
+    (void)[self waitUntilModelIsReadyWithHandle:handle timeout:DISPATCH_TIME_FOREVER];
     id<ETCoreMLModelExecutor> executor = [self executorWithHandle:handle];
     if (!executor) {
         ETCoreMLLogErrorAndSetNSError(error,
@@ -738,6 +838,7 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
                 loggingOptions:(const executorchcoreml::ModelLoggingOptions&)loggingOptions
                    eventLogger:(const executorchcoreml::ModelEventLogger* _Nullable)eventLogger
                          error:(NSError * __autoreleasing *)error {
+    (void)[self waitUntilModelIsReadyWithHandle:handle timeout:DISPATCH_TIME_FOREVER];
     id<ETCoreMLModelExecutor> executor = [self executorWithHandle:handle];
     if (!executor) {
         ETCoreMLLogErrorAndSetNSError(error,
@@ -792,11 +893,24 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
 
 - (BOOL)unloadModelWithHandle:(ModelHandle *)handle {
     BOOL result = NO;
+    // Let the pre-warm finish, so that it never runs concurrently with the next user of a model that
+    // is kept in memory.
+    (void)[self waitUntilModelIsReadyWithHandle:handle timeout:DISPATCH_TIME_FOREVER];
     @autoreleasepool {
         NSValue *key = [NSValue valueWithPointer:handle];
+        NSUInteger maxInMemoryModelsCount = self.maxInMemoryModelsCount;
+        NSMutableArray<id<ETCoreMLModelExecutor>> *droppedExecutors = [NSMutableArray array];
         os_unfair_lock_lock(&_lock);
-        result = (self.handleToExecutorMap[key] != nil);
+        id<ETCoreMLModelExecutor> executor = self.handleToExecutorMap[key];
+        result = (executor != nil);
         [self.handleToExecutorMap removeObjectForKey:key];
+        if (executor && maxInMemoryModelsCount > 0) {
+            [self.inMemoryExecutors addObject:executor];
+        }
+        while (self.inMemoryExecutors.count > maxInMemoryModelsCount) {
+            [droppedExecutors addObject:self.inMemoryExecutors.firstObject];
+            [self.inMemoryExecutors removeObjectAtIndex:0];
+        }
         os_unfair_lock_unlock(&_lock);
     }
     
@@ -804,6 +918,8 @@ ETCoreMLModelDebugInfo * _Nullable get_model_debug_info(const inmemoryfs::InMemo
 }
 
 - (BOOL)purgeModelsCacheAndReturnError:(NSError *__autoreleasing *)error {
+    // The models that are kept in memory keep their assets in use.
+    [self removeInMemoryModels];
     return [self.assetManager purgeAndReturnError:error];
 }
 
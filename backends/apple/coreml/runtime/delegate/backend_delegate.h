@@ -29,8 +29,12 @@ public:
         size_t max_models_cache_size = 10 * size_t(1024) * size_t(1024) * size_t(1024);
         // If set to `true`, delegate pre-warms the most recently used asset.
         bool should_prewarm_asset = false;
-        // If set to `true`, delegate pre-warms the model in `init`.
+        // If set to `true`, delegate pre-warms the model in the background after `init`, the
+        // executions of the model wait for the pre-warm to finish.
         bool should_prewarm_model = true;
+        // Max number of unloaded models that are kept in memory, to load them again without
+        // specializing them.
+        size_t max_in_memory_models_count = 1;
     };
 
     /// The error codes for the `BackendDelegate`.
@@ -152,6 +152,7 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
         return NO;
     }
     
+    modelManager.maxInMemoryModelsCount = self.config.max_in_memory_models_count;
     self.impl = modelManager;
     
     if (self.config.should_prewarm_asset) {
@@ -192,7 +193,7 @@ ETCoreMLAssetManager * _Nullable create_asset_manager(NSString *assets_directory
                                     configuration:configuration
                                             error:error];
     if ((handle != NULL) && self.config.should_prewarm_model) {
-        [self.impl prewarmModelWithHandle:handle error:nil];
+        [self.impl prewarmModelAsynchronouslyWithHandle:handle];
     }
 
     return handle;
@@ -122,6 +122,13 @@ std::optional<BackendDelegate::Config> parse_config(NSURL *plistURL) {
         }
     }
 
+    {
+        NSNumber *max_in_memory_models_count = SAFE_CAST(dict[@"maxInMemoryModelsCount"], NSNumber);
+        if (max_in_memory_models_count) {
+            config.max_in_memory_models_count = max_in_memory_models_count.unsignedLongValue;
+        }
+    }
+
     return config;
 }
 
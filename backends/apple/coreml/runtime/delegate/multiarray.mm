@@ -10,10 +10,12 @@
 
 #import <Accelerate/Accelerate.h>
 #import <CoreML/CoreML.h>
+#import <cstring>
 #import <functional>
 #import <numeric>
 #import <objc_array_util.h>
 #import <optional>
+#import <type_traits>
 #import <vector>
 
 namespace  {
@@ -138,28 +140,6 @@ bool copy_using_bnns(const MultiArray& src, MultiArray& dst) {
     return BNNSCopy(&dst_descriptor, &src_descriptor, NULL) == 0;
 }
 
-std::vector<MultiArray::MemoryLayout> get_layouts(const std::vector<MultiArray>& arrays) {
-    std::vector<MultiArray::MemoryLayout> result;
-    result.reserve(arrays.size());
-    
-    std::transform(arrays.begin(), arrays.end(), std::back_inserter(result), [](const auto& array) {
-        return array.layout();
-    });
-    
-    return result;
-}
-
-std::vector<void *> get_datas(const std::vector<MultiArray>& arrays) {
-    std::vector<void *> result;
-    result.reserve(arrays.size());
-    
-    std::transform(arrays.begin(), arrays.end(), std::back_inserter(result), [](const auto& array) {
-        return array.data();
-    });
-    
-    return result;
-}
-
 // We can coalesce two adjacent dimensions if either dim has size 1 or if `shape[n] * stride[n] == stride[n + 1]`.
 bool can_coalesce_dimensions(const std::vector<size_t>& shape,
                              const std::vector<ssize_t>& strides,
@@ -250,218 +230,141 @@ std::vector<MultiArray::MemoryLayout> coalesce_dimensions(std::vector<MultiArray
     return result;
 }
 
-enum class Direction : uint8_t {
-    Forward = 0,
-    Backward
-};
-
-void set_data_pointers(std::vector<void *>& data_pointers,
-                       ssize_t index,
-                       size_t dim,
-                       Direction direction,
-                       const std::vector<MultiArray::MemoryLayout>& layouts) {
-    for (size_t i = 0; i < layouts.size(); ++i) {
-        const auto& layout = layouts[i];
-        const ssize_t stride = layout.strides()[dim];
-        const size_t num_bytes = layout.num_bytes();
-        ssize_t offset = 0;
-        switch (direction) {
-            case Direction::Forward: {
-                offset = stride * index * num_bytes;
-                break;
-            }
-            case Direction::Backward: {
-                offset = - stride * index * num_bytes;
-                break;
-            }
-        }
-        data_pointers[i] = (void *)(static_cast<uint8_t *>(data_pointers[i]) + offset);
-    }
-}
-
-void increment_data_pointers(std::vector<void *>& data_pointers,
-                             size_t index,
-                             size_t dim,
-                             const std::vector<MultiArray::MemoryLayout>& layouts) {
-    set_data_pointers(data_pointers, index, dim, Direction::Forward, layouts);
-}
-
-void decrement_data_pointers(std::vector<void *>& data_pointers,
-                             size_t index,
-                             size_t dim,
-                             const std::vector<MultiArray::MemoryLayout>& layouts) {
-    set_data_pointers(data_pointers, index, dim, Direction::Backward, layouts);
-}
-
-class MultiArrayIterator final {
-public:
-    explicit MultiArrayIterator(const std::vector<MultiArray>& arrays)
-    :datas_(get_datas(arrays)), 
-    layouts_(coalesce_dimensions(get_layouts(arrays)))
-    {}
-    
-private:
-    template<typename FN>
-    void exec(FN&& fn, const std::vector<MultiArray::MemoryLayout>& layouts, std::vector<void *> datas, size_t n) {
-        const auto& layout = layouts.back();
-        // Avoid function call for rank <= 2.
-        switch (n) {
-            case 0: {
-                break;
-            }
-            case 1: {
-                for (size_t i = 0; i < layout.shape()[0]; ++i) {
-                    ::increment_data_pointers(datas, i, 0, layouts);
-                    fn(datas);
-                    ::decrement_data_pointers(datas, i, 0, layouts);
-                }
-                break;
-            }
-            case 2: {
-                for (size_t i = 0; i < layout.shape()[1]; ++i) {
-                    ::increment_data_pointers(datas, i, 1, layouts);
-                    for (size_t j = 0; j < layout.shape()[0]; ++j) {
-                        ::increment_data_pointers(datas, j, 0, layouts);
-                        fn(datas);
-                        ::decrement_data_pointers(datas, j, 0, layouts);
-                    }
-                    ::decrement_data_pointers(datas, i, 1, layouts);
-                }
-                
-                break;
-            }
-                
-            default: {
-                const size_t bound = layouts.back().shape()[n - 1];
-                for (size_t index = 0; index < bound; ++index) {
-                    ::increment_data_pointers(datas, index, n - 1, layouts);
-                    exec(std::forward<FN>(fn), layouts, datas, n - 1);
-                    ::decrement_data_pointers(datas, index, n - 1, layouts);
-                }
+/// Copies `count` values from `src` to `dst`, converting them from `T2` to `T1`.
+///
+/// The strides are in elements. Rows with unit strides are copied with `memcpy` when
+/// the types match and with a plain loop that the compiler vectorizes otherwise.
+template<typename T1, typename T2>
+void copy_row(void *dst, ssize_t dst_stride, const void *src, ssize_t src_stride, size_t count) {
+    T1 *dst_ptr = static_cast<T1 *>(dst);
+    const T2 *src_ptr = static_cast<const T2 *>(src);
+    if (dst_stride == 1 && src_stride == 1) {
+        if constexpr (std::is_same_v<T1, T2>) {
+            std::memcpy(dst_ptr, src_ptr, count * sizeof(T1));
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                dst_ptr[i] = static_cast<T1>(src_ptr[i]);
             }
         }
+        return;
     }
     
-public:
-    template<typename FN>
-    void exec(FN&& fn) {
-        std::vector<void *> datas = datas_;
-        exec(fn, layouts_, datas, layouts_[0].rank());
+    for (size_t i = 0; i < count; ++i) {
+        dst_ptr[i * dst_stride] = static_cast<T1>(src_ptr[i * src_stride]);
     }
-    
-private:
-    std::vector<void *> datas_;
-    std::vector<MultiArray::MemoryLayout> layouts_;
-};
-
-/// BNNS has no double type, so we handle the conversions here.
-template<typename T1, typename T2>
-inline void copy_value(void *dst, const void *src) {
-    const T2 *src_ptr = static_cast<const T2 *>(src);
-    T1 *dst_ptr = static_cast<T1 *>(dst);
-    *dst_ptr = static_cast<T1>(*src_ptr);
 }
 
+using CopyRowFn = void (*)(void *dst, ssize_t dst_stride, const void *src, ssize_t src_stride, size_t count);
+
+/// BNNS has no double type, so we handle the conversions here.
 template<typename T>
-void copy(void *dst,
-          MultiArray::DataType dst_data_type,
-          const void *src) {
+CopyRowFn get_copy_row_fn(MultiArray::DataType dst_data_type) {
     switch (dst_data_type) {
         case MultiArray::DataType::Bool: {
-            ::copy_value<bool, T>(dst, src);
-            break;
+            return &::copy_row<bool, T>;
         }
-            
         case MultiArray::DataType::Byte: {
-            ::copy_value<uint8_t, T>(dst, src);
-            break;
+            return &::copy_row<uint8_t, T>;
         }
-            
         case MultiArray::DataType::Char: {
-            ::copy_value<int8_t, T>(dst, src);
-            break;
+            return &::copy_row<int8_t, T>;
         }
-            
         case MultiArray::DataType::Short: {
-            ::copy_value<int16_t, T>(dst, src);
-            break;
+            return &::copy_row<int16_t, T>;
         }
-            
         case MultiArray::DataType::Int32: {
-            ::copy_value<int32_t, T>(dst, src);
-            break;
+            return &::copy_row<int32_t, T>;
         }
-            
         case MultiArray::DataType::Int64: {
-            ::copy_value<int64_t, T>(dst, src);
-            break;
+            return &::copy_row<int64_t, T>;
         }
-            
         case MultiArray::DataType::Float16: {
-            ::copy_value<_Float16, T>(dst, src);
-            break;
+            return &::copy_row<_Float16, T>;
         }
-            
         case MultiArray::DataType::Float32: {
-            ::copy_value<float, T>(dst, src);
-            break;
+            return &::copy_row<float, T>;
         }
-            
         case MultiArray::DataType::Float64: {
-            ::copy_value<double, T>(dst, src);
-            break;
+            return &::copy_row<double, T>;
         }
     }
 }
 
-void copy(void *dst,
-          MultiArray::DataType dst_data_type,
-          const void *src,
-          MultiArray::DataType src_data_type) {
+CopyRowFn get_copy_row_fn(MultiArray::DataType dst_data_type, MultiArray::DataType src_data_type) {
     switch (src_data_type) {
         case MultiArray::DataType::Bool: {
-            ::copy<uint8_t>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<uint8_t>(dst_data_type);
         }
-            
         case MultiArray::DataType::Byte: {
-            ::copy<uint8_t>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<uint8_t>(dst_data_type);
         }
-            
         case MultiArray::DataType::Char: {
-            ::copy<int8_t>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<int8_t>(dst_data_type);
         }
-            
         case MultiArray::DataType::Short: {
-            ::copy<int16_t>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<int16_t>(dst_data_type);
         }
-            
         case MultiArray::DataType::Int32: {
-            ::copy<int32_t>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<int32_t>(dst_data_type);
         }
-            
         case MultiArray::DataType::Int64: {
-            ::copy<int64_t>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<int64_t>(dst_data_type);
         }
-            
         case MultiArray::DataType::Float16: {
-            ::copy<_Float16>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<_Float16>(dst_data_type);
         }
-            
         case MultiArray::DataType::Float32: {
-            ::copy<float>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<float>(dst_data_type);
         }
-            
         case MultiArray::DataType::Float64: {
-            ::copy<double>(dst, dst_data_type, src);
-            break;
+            return ::get_copy_row_fn<double>(dst_data_type);
+        }
+    }
+}
+
+/// Copies the arrays row by row, where a row is the innermost dimension after coalescing.
+///
+/// The type dispatch happens once per copy and the outer dimensions are walked like an
+/// odometer, so the per-element work is only the conversion itself.
+void copy_rows(const MultiArray& src, MultiArray& dst) {
+    if (src.layout().num_elements() == 0) {
+        return;
+    }
+    
+    const auto layouts = ::coalesce_dimensions({src.layout(), dst.layout()});
+    const auto& src_layout = layouts[0];
+    const auto& dst_layout = layouts[1];
+    const auto copy_row = ::get_copy_row_fn(dst_layout.dataType(), src_layout.dataType());
+    const auto& shape = src_layout.shape();
+    const auto& src_strides = src_layout.strides();
+    const auto& dst_strides = dst_layout.strides();
+    const size_t src_num_bytes = src_layout.num_bytes();
+    const size_t dst_num_bytes = dst_layout.num_bytes();
+    const size_t inner_dim = src_layout.rank() - 1;
+    const size_t row_size = shape[inner_dim];
+    const size_t num_rows = src_layout.num_elements() / row_size;
+    
+    const uint8_t *src_data = static_cast<const uint8_t *>(src.data());
+    uint8_t *dst_data = static_cast<uint8_t *>(dst.data());
+    std::vector<size_t> indices(inner_dim, 0);
+    ssize_t src_offset = 0;
+    ssize_t dst_offset = 0;
+    for (size_t row = 0; row < num_rows; ++row) {
+        copy_row(dst_data + dst_offset * dst_num_bytes,
+                 dst_strides[inner_dim],
+                 src_data + src_offset * src_num_bytes,
+                 src_strides[inner_dim],
+                 row_size);
+        for (size_t dim = inner_dim; dim > 0; --dim) {
+            const size_t d = dim - 1;
+            src_offset += src_strides[d];
+            dst_offset += dst_strides[d];
+            if (++indices[d] < shape[d]) {
+                break;
+            }
+            indices[d] = 0;
+            src_offset -= src_strides[d] * static_cast<ssize_t>(shape[d]);
+            dst_offset -= dst_strides[d] * static_cast<ssize_t>(shape[d]);
         }
     }
 }
@@ -479,12 +382,7 @@ void copy(const MultiArray& src, MultiArray& dst, MultiArray::CopyOptions option
         return;
     }
     
-    auto iterator = MultiArrayIterator({src, dst});
-    iterator.exec([&](const std::vector<void *>& datas){
-        void *src_data = datas[0];
-        void *dst_data = datas[1];
-        ::copy(dst_data, dst.layout().dataType(), src_data, src.layout().dataType());
-    });
+    ::copy_rows(src, dst);
 }
 
 ssize_t get_data_offset(const std::vector<size_t>& indices, const std::vector<ssize_t>& strides) {
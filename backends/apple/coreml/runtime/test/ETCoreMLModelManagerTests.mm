@@ -91,6 +91,40 @@
     XCTAssertTrue([self.modelManager prewarmModelWithHandle:handle error:&localError]);
 }
 
+- (void)testModelAsynchronousPrewarm {
+    NSURL *modelURL = [[self class] bundledResourceWithName:@"add_coreml_all" extension:@"bin"];
+    NSError *localError = nil;
+    XCTAssertNotNil(modelURL);
+    NSData *data = [NSData dataWithContentsOfURL:modelURL];
+    MLModelConfiguration *configuration = [[MLModelConfiguration alloc] init];
+    configuration.computeUnits = MLComputeUnitsAll;
+    ModelHandle *handle = [self.modelManager loadModelFromAOTData:data configuration:configuration error:&localError];
+    [self.modelManager prewarmModelAsynchronouslyWithHandle:handle];
+    XCTAssertTrue([self.modelManager waitUntilModelIsReadyWithHandle:handle timeout:DISPATCH_TIME_FOREVER]);
+    XCTAssertTrue([self.modelManager unloadModelWithHandle:handle]);
+}
+
+- (void)testInMemoryModelReuse {
+    NSURL *modelURL = [[self class] bundledResourceWithName:@"add_coreml_all" extension:@"bin"];
+    NSError *localError = nil;
+    XCTAssertNotNil(modelURL);
+    NSData *data = [NSData dataWithContentsOfURL:modelURL];
+    MLModelConfiguration *configuration = [[MLModelConfiguration alloc] init];
+    configuration.computeUnits = MLComputeUnitsAll;
+    self.modelManager.maxInMemoryModelsCount = 1;
+    ModelHandle *handle1 = [self.modelManager loadModelFromAOTData:data configuration:configuration error:&localError];
+    MLModel *mlModel = [self.modelManager modelWithHandle:handle1].mlModel;
+    XCTAssertTrue([self.modelManager unloadModelWithHandle:handle1]);
+    // The unloaded model is kept in memory and reused.
+    ModelHandle *handle2 = [self.modelManager loadModelFromAOTData:data configuration:configuration error:&localError];
+    XCTAssertEqual([self.modelManager modelWithHandle:handle2].mlModel, mlModel);
+    // A model that is in use is never shared.
+    ModelHandle *handle3 = [self.modelManager loadModelFromAOTData:data configuration:configuration error:&localError];
+    XCTAssertNotEqual([self.modelManager modelWithHandle:handle3].mlModel, mlModel);
+    XCTAssertTrue([self.modelManager unloadModelWithHandle:handle2]);
+    XCTAssertTrue([self.modelManager unloadModelWithHandle:handle3]);
+}
+
 - (void)testAddModelExecution {
     NSURL *modelURL = [[self class] bundledResourceWithName:@"add_coreml_all" extension:@"bin"];
     XCTAssertNotNil(modelURL);
@@ -130,4 +130,12 @@ void verify_copy(const std::vector<size_t>& shape,
     [self verifyDataCopyWithShape:shape srcStrides:srcStrides dstStrides:dstStrides];
 }
 
+- (void)testPaddedRowDataCopy {
+    // Rows padded to 16 elements, as CoreML may lay out the arrays it allocates.
+    std::vector<size_t> shape = {2, 3, 10};
+    std::vector<ssize_t> srcStrides = {3 * 10, 10, 1};
+    std::vector<ssize_t> dstStrides = {3 * 16, 16, 1};
+    [self verifyDataCopyWithShape:shape srcStrides:srcStrides dstStrides:dstStrides];
+}
+
 @end
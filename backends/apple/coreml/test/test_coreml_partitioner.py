@@ -126,9 +126,51 @@ class TestCoreMLPartitioner(unittest.TestCase):
             "getitem",
         ]
 
+    def test_buffer_without_deployment_target(self):
+        embedding_dim = 3
+        max_seq_len = 2
+
+        class Model(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.register_buffer(
+                    "cache",
+                    torch.zeros((max_seq_len, embedding_dim), dtype=torch.float32),
+                )
+
+            def forward(self, k_val, input_pos):
+                k = torch.ops.aten.index_put_(self.cache, [input_pos, None], k_val)
+                return k.sum()
+
+        model = Model()
+        model.eval()
+
+        k_val = torch.randn((1, embedding_dim))
+        input_pos = torch.tensor([0])
+        example_inputs = (k_val, input_pos)
+        exir_program_aten = torch.export.export(model, example_inputs)
+
+        # The buffer becomes a Core ML state, which raises the default
+        # minimum deployment target to iOS18.
+        partitioner = CoreMLPartitioner()
+        edge_program_manager = executorch.exir.to_edge(
+            exir_program_aten, compile_config=self.edge_compile_config
+        )
+        delegated_program_manager = edge_program_manager.to_backend(partitioner)
+
+        assert [
+            node.target.__name__
+            for node in delegated_program_manager.exported_program().graph.nodes
+            if node.op == "call_function"
+        ] == [
+            "executorch_call_delegate",
+            "getitem",
+        ]
+
 
 if __name__ == "__main__":
     test_runner = TestCoreMLPartitioner()
     test_runner.test_add_sub_skip_mm()
     test_runner.test_vit_skip_conv()
     test_runner.test_buffer()
+    test_runner.test_buffer_without_deployment_target()
@@ -67,7 +67,7 @@ class MPSBackend final : public ::executorch::runtime::BackendInterface {
 
   // Function that actually executes the model in the backend.
   Error execute(
-    ET_UNUSED BackendExecutionContext& context,
+    BackendExecutionContext& context,
     DelegateHandle* handle,
     EValue** args) const override {
     auto executor = static_cast<mps::delegate::MPSExecutor*>(handle);
@@ -115,7 +115,9 @@ class MPSBackend final : public ::executorch::runtime::BackendInterface {
       return err;
     }
 
-    err = executor->forward(output_pointers);
+    // Consecutive MPS partitions share one command buffer, and only the last one
+    // waits for the GPU.
+    err = executor->forward(output_pointers, context.is_followed_by_same_backend());
     return err;
   }
 
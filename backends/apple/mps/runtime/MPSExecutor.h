@@ -36,11 +36,25 @@ class MPSExecutor {
   //   - False: Simulator or x86 or pre-macOS15/iOS17/iPadOS17
   bool _use_shared_mem;
   bool _buffers_initialized;
+  // Whether the GPU can access host memory in place (Apple Silicon). When shared
+  // memory is not used, the page aligned inputs/outputs are still bound in place
+  // on such devices instead of being copied.
+  bool _has_unified_memory;
 
   // Input/Output GPU buffer pointer
   std::vector<id<MTLBuffer>> _inputGPUBuffers;
   std::vector<id<MTLBuffer>> _outputGPUBuffers;
 
+  // Input/Output host memory wrapped as MTLBuffers, reused across inference runs
+  // while the tensors keep their memory.
+  std::vector<id<MTLBuffer>> _inputHostBuffers;
+  std::vector<id<MTLBuffer>> _outputHostBuffers;
+
+  // Preallocated GPU buffers that the inputs/outputs are copied through when their
+  // memory can not be bound in place.
+  std::vector<id<MTLBuffer>> _inputCopyBuffers;
+  std::vector<id<MTLBuffer>> _outputCopyBuffers;
+
   // Input/Output CPU buffer pointers
   std::vector<CPUBufferWrapper> _inputCPUBuffers;
   std::vector<CPUBufferWrapper> _outputCPUBuffers;
@@ -59,6 +73,12 @@ class MPSExecutor {
 
     _inputsArray = nil;
     _outputsArray = nil;
+
+    for (auto buffers : {&_inputHostBuffers, &_outputHostBuffers, &_inputCopyBuffers, &_outputCopyBuffers}) {
+      for (id<MTLBuffer> buffer : *buffers) {
+        [buffer release];
+      }
+    }
   }
 
   inline size_t getNumInputs() {
@@ -73,7 +93,11 @@ class MPSExecutor {
     return _executable;
   }
 
-  ET_NODISCARD executorch::runtime::Error forward(std::vector<const executorch::aten::Tensor*>& outputs);
+  // When defer_sync is set, the graph is encoded into the live command buffer of the
+  // stream and left there, so that the next MPS delegate call encodes into the same
+  // command buffer and waits for both. Only set it when no one else reads the outputs
+  // before that call.
+  ET_NODISCARD executorch::runtime::Error forward(std::vector<const executorch::aten::Tensor*>& outputs, bool defer_sync = false);
 
   ET_NODISCARD executorch::runtime::Error
   set_inputs_outputs(std::vector<const executorch::aten::Tensor*>& inputs, std::vector<const executorch::aten::Tensor*>& outputs);
@@ -82,6 +106,10 @@ class MPSExecutor {
   executorch::runtime::Error updateDataBuffers(std::vector<const executorch::aten::Tensor*>& inputs, std::vector<const executorch::aten::Tensor*>& outputs);
   executorch::runtime::Error syncOutputBuffers(std::vector<const executorch::aten::Tensor*>& outputs);
 
+  // Returns the memory of the tensor as an MTLBuffer that the GPU accesses in place,
+  // reusing hostBuffer if it still wraps that memory, or nil if the memory must be copied.
+  id<MTLBuffer> bindHostBuffer(const executorch::aten::Tensor& tensor, id<MTLBuffer>& hostBuffer);
+
   friend class MPSCompiler;
 };
 
@@ -35,6 +35,7 @@ MPSExecutor::MPSExecutor() {
   if (!is_macos_13_or_newer(MacOSVersion::MACOS_VER_14_0_PLUS)) {
     _use_shared_mem = false;
   }
+  _has_unified_memory = [MPSDevice::getInstance()->device() hasUnifiedMemory];
 
   _inputsArray = [[NSMutableArray<MPSGraphTensorData *> alloc]  initWithCapacity:getNumInputs()];
   _outputsArray = [[NSMutableArray<MPSGraphTensorData *> alloc] initWithCapacity:getNumOutputs()];
@@ -64,10 +65,14 @@ MPSExecutor::set_inputs_outputs(std::vector<const Tensor*>& inputs, std::vector<
   return Error::Ok;
 }
 
-ET_NODISCARD Error MPSExecutor::forward(std::vector<const Tensor*>& outputs) {
+ET_NODISCARD Error MPSExecutor::forward(std::vector<const Tensor*>& outputs, bool defer_sync) {
   Error err = Error::Ok;
   MPSStream* mpsStream = getDefaultMPSStream();
-  if (mpsStream->commitAndContinueEnabled() || mpsStream->hasLiveCommandBuffer()) {
+#if TARGET_OS_SIMULATOR
+  // On simulator, the outputs are copied on the CPU, which needs the results.
+  defer_sync = false;
+#endif
+  if (mpsStream->commitAndContinueEnabled() || mpsStream->hasLiveCommandBuffer() || defer_sync) {
     id<MTLCommandBuffer> commandBuffer = mpsStream->commandBuffer();
     [_executable encodeToCommandBuffer:commandBuffer
                           inputsArray:_inputsArray
@@ -83,6 +88,10 @@ ET_NODISCARD Error MPSExecutor::forward(std::vector<const Tensor*>& outputs) {
 
   // On simulator, the buffers are synchronized during `syncOutputBuffer`
 #if !TARGET_OS_SIMULATOR
+  if (defer_sync) {
+    // The next MPS delegate call commits and waits for this command buffer.
+    return Error::Ok;
+  }
   if (mpsStream->commitAndContinueEnabled()) {
     err = mpsStream->synchronize(SyncType::COMMIT_AND_CONTINUE);
   } else {
@@ -110,15 +119,13 @@ MPSExecutor::initDataBuffers() {
 
   _inputGPUBuffers.resize(nInputs);
   _outputGPUBuffers.resize(nOutputs);
-
-  if (!_use_shared_mem) {
-    _inputCPUBuffers.resize(nInputs);
-    _outputCPUBuffers.resize(nOutputs);
-  }
+  _inputHostBuffers.resize(nInputs, nil);
+  _outputHostBuffers.resize(nOutputs, nil);
 
   // In case of shared memory, the CPU raw buffer is used directly as an MTLBuffer.
   // In case of not being able to use shared memory, initialize the data buffers once
-  // and keep reusing them across inference runs.
+  // and keep reusing them across inference runs for the tensors that can not be
+  // bound in place.
   auto getDataBuffer = [] (MPSShape* shape, MPSDataType mpsDataType) {
     __block int64_t length = 1;
     [shape enumerateObjectsUsingBlock:^(NSNumber * _Nonnull obj, NSUInteger idx, BOOL * _Nonnull stop) {
@@ -135,63 +142,108 @@ MPSExecutor::initDataBuffers() {
   // Preallocate at init time the GPU buffers used to run
   // the model in case shared memory is not being used.
   if (!_use_shared_mem) {
+    _inputCopyBuffers.resize(nInputs);
+    _outputCopyBuffers.resize(nOutputs);
     for (int i = 0; i < nInputs; i++) {
-      _inputGPUBuffers[i] = getDataBuffer([_inputShapes[i] shape], [_inputShapes[i] dataType]);
+      _inputCopyBuffers[i] = getDataBuffer([_inputShapes[i] shape], [_inputShapes[i] dataType]);
     }
     for (int i = 0; i < nOutputs; i++) {
-      _outputGPUBuffers[i] = getDataBuffer([_outputShapes[i] shape], [_outputShapes[i] dataType]);
+      _outputCopyBuffers[i] = getDataBuffer([_outputShapes[i] shape], [_outputShapes[i] dataType]);
     }
   }
 
   return error;
 }
 
+id<MTLBuffer>
+MPSExecutor::bindHostBuffer(const Tensor& tensor, id<MTLBuffer>& hostBuffer) {
+  void* host_ptr = tensor.mutable_data_ptr<void*>();
+  NSUInteger length = tensor.nbytes();
+  MTLResourceOptions options = 0;
+  if (!_use_shared_mem) {
+#if TARGET_OS_SIMULATOR
+    // Simulator crashes when using newBufferWithBytesNoCopy.
+    return nil;
+#else
+    // Without shared memory, only page aligned memory can be wrapped in place,
+    // and only GPUs with unified memory access it without a copy.
+    if (!_has_unified_memory || (uintptr_t(host_ptr) & (PAGE_SIZE - 1)) != 0) {
+      return nil;
+    }
+    pageAlignedBlockPtr(host_ptr, length, &length);
+    options = MTLResourceCPUCacheModeDefaultCache | MTLResourceStorageModeShared;
+#endif
+  }
+
+  // Planned memory stays the same across inference runs, so the wrapper is usually reused.
+  if (hostBuffer != nil && [hostBuffer contents] == host_ptr && [hostBuffer length] == length) {
+    return hostBuffer;
+  }
+  [hostBuffer release];
+  hostBuffer = [MPSDevice::getInstance()->device() newBufferWithBytesNoCopy:host_ptr
+                                                                      length:length
+                                                                     options:options
+                                                                 deallocator:nil];
+  return hostBuffer;
+}
+
 Error
 MPSExecutor::updateDataBuffers(
   std::vector<const Tensor*>& inputs, std::vector<const Tensor*>& outputs
 ) {
+  _inputCPUBuffers.clear();
   for (int i = 0; i < inputs.size(); i++) {
     const Tensor& tensor = *inputs[i];
     void* host_src = tensor.mutable_data_ptr<void*>();
-    if (_use_shared_mem) {
-      // Use directly the CPU buffer when using shared memory.
-      _inputGPUBuffers[i] = getMTLBufferStorage(tensor);
-    } else {
-      _inputCPUBuffers[i].flags = 0;
+    id<MTLBuffer> hostBuffer = bindHostBuffer(tensor, _inputHostBuffers[i]);
+    if (hostBuffer != nil || _use_shared_mem) {
+      // Use directly the CPU buffer when the GPU can access it in place.
+      _inputGPUBuffers[i] = hostBuffer;
+      continue;
+    }
+
+    _inputGPUBuffers[i] = _inputCopyBuffers[i];
+    CPUBufferWrapper cpuBuffer;
+    cpuBuffer.flags = 0;
 #if TARGET_OS_SIMULATOR
-      // Simulator crashes when using newBufferWithBytesNoCopy.
-      // Use memcpy directly instead of using blit to copy the CPU
-      // data into the GPU buffer.
-      _inputCPUBuffers[i].srcOffset = 0;
-      _inputCPUBuffers[i].srcBuffer = host_src;
-      _inputCPUBuffers[i].srcCpu = 1;
+    // Simulator crashes when using newBufferWithBytesNoCopy.
+    // Use memcpy directly instead of using blit to copy the CPU
+    // data into the GPU buffer.
+    cpuBuffer.srcOffset = 0;
+    cpuBuffer.srcBuffer = host_src;
+    cpuBuffer.srcCpu = 1;
 #else
-      MTLResourceOptions options = MTLResourceCPUCacheModeDefaultCache | MTLResourceStorageModeShared;
-      NSUInteger alignedLength = 0;
-      void* alignedPtr = pageAlignedBlockPtr(host_src, (NSUInteger)tensor.nbytes(), &alignedLength);
-      _inputCPUBuffers[i].srcOffset = uintptr_t(host_src) - uintptr_t(alignedPtr);
-      _inputCPUBuffers[i].srcBuffer = [MPSDevice::getInstance()->device() newBufferWithBytesNoCopy:alignedPtr
-                                                        length:alignedLength
-                                                      options:options
-                                                  deallocator:nil];
+    MTLResourceOptions options = MTLResourceCPUCacheModeDefaultCache | MTLResourceStorageModeShared;
+    NSUInteger alignedLength = 0;
+    void* alignedPtr = pageAlignedBlockPtr(host_src, (NSUInteger)tensor.nbytes(), &alignedLength);
+    cpuBuffer.srcOffset = uintptr_t(host_src) - uintptr_t(alignedPtr);
+    cpuBuffer.srcBuffer = [MPSDevice::getInstance()->device() newBufferWithBytesNoCopy:alignedPtr
+                                                      length:alignedLength
+                                                    options:options
+                                                deallocator:nil];
 
 #endif
-      _inputCPUBuffers[i].dstBuffer = _inputGPUBuffers[i];
-      _inputCPUBuffers[i].dstOffset = 0;
-      _inputCPUBuffers[i].length = tensor.nbytes();
-    }
+    cpuBuffer.dstBuffer = _inputGPUBuffers[i];
+    cpuBuffer.dstOffset = 0;
+    cpuBuffer.length = tensor.nbytes();
+    _inputCPUBuffers.push_back(cpuBuffer);
   }
 
-  if (_use_shared_mem) {
-    for (int i = 0; i < outputs.size(); i++) {
-      _outputGPUBuffers[i] = getMTLBufferStorage(*outputs[i]);
-    }
+  for (int i = 0; i < outputs.size(); i++) {
+    id<MTLBuffer> hostBuffer = bindHostBuffer(*outputs[i], _outputHostBuffers[i]);
+    _outputGPUBuffers[i] = (hostBuffer != nil || _use_shared_mem) ? hostBuffer : _outputCopyBuffers[i];
   }
 
-  if (!_use_shared_mem) {
+  if (!_inputCPUBuffers.empty()) {
     MPSStream* mpsStream = getDefaultMPSStream();
       mpsStream->copy_and_sync(
         _inputCPUBuffers, /*non_blocking=*/true);
+#if !TARGET_OS_SIMULATOR
+    // The command buffer retains the source buffers until the blits complete.
+    for (const CPUBufferWrapper& cpuBuffer : _inputCPUBuffers) {
+      [(id<MTLBuffer>)cpuBuffer.srcBuffer release];
+    }
+#endif
   }
 
   return Error::Ok;
@@ -206,33 +258,42 @@ MPSExecutor::syncOutputBuffers(
     MPSStream* mpsStream = getDefaultMPSStream();
 
   if (!_buffers_initialized) {
+      _outputCPUBuffers.clear();
       for (int i = 0; i < outputs.size(); i++) {
+        if (_outputGPUBuffers[i] != _outputCopyBuffers[i]) {
+          // The GPU wrote the output in place.
+          continue;
+        }
         const Tensor& tensor = *outputs[i];
         void* host_dst = tensor.mutable_data_ptr<void*>();
-        _outputCPUBuffers[i].flags = 0;
+        CPUBufferWrapper cpuBuffer;
+        cpuBuffer.flags = 0;
 #if TARGET_OS_SIMULATOR
-        _outputCPUBuffers[i].dstOffset = 0;
-        _outputCPUBuffers[i].dstBuffer = host_dst;
-        _outputCPUBuffers[i].dstCpu = 1;
+        cpuBuffer.dstOffset = 0;
+        cpuBuffer.dstBuffer = host_dst;
+        cpuBuffer.dstCpu = 1;
 #else
         void* alignedPtr = pageAlignedBlockPtr(host_dst, (NSUInteger)tensor.nbytes(), &alignedLength);
-        _outputCPUBuffers[i].dstOffset = (uintptr_t(host_dst) - uintptr_t(alignedPtr));
+        cpuBuffer.dstOffset = (uintptr_t(host_dst) - uintptr_t(alignedPtr));
         // 4 bytes alignment required on MacOS for blits.
-        ET_CHECK_MSG(_outputCPUBuffers[i].dstOffset % 4 == 0, "Unaligned blit request");
-        _outputCPUBuffers[i].dstBuffer = [MPSDevice::getInstance()->device() newBufferWithBytesNoCopy:alignedPtr
+        ET_CHECK_MSG(cpuBuffer.dstOffset % 4 == 0, "Unaligned blit request");
+        cpuBuffer.dstBuffer = [MPSDevice::getInstance()->device() newBufferWithBytesNoCopy:alignedPtr
                                                               length:alignedLength
                                                             options:options
                                                         deallocator:nil];
 #endif
-        _outputCPUBuffers[i].srcBuffer = _outputGPUBuffers[i];
-        _outputCPUBuffers[i].srcOffset = 0;
-        _outputCPUBuffers[i].length = tensor.nbytes();
+        cpuBuffer.srcBuffer = _outputGPUBuffers[i];
+        cpuBuffer.srcOffset = 0;
+        cpuBuffer.length = tensor.nbytes();
+        _outputCPUBuffers.push_back(cpuBuffer);
       }
     }
 
-    mpsStream->copy_and_sync(
-      _outputCPUBuffers, /*non_blocking=*/true
-    );
+    if (!_outputCPUBuffers.empty()) {
+      mpsStream->copy_and_sync(
+        _outputCPUBuffers, /*non_blocking=*/true
+      );
+    }
   }
 
   _buffers_initialized = true;
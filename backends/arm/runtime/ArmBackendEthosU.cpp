@@ -15,6 +15,7 @@
 
 #include <ethosu_driver.h>
 
+#include <executorch/backends/arm/runtime/ArmBackendEthosU.h>
 #include <executorch/backends/arm/runtime/VelaBinStream.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
@@ -30,6 +31,7 @@ using executorch::runtime::Backend;
 using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::BackendInitContext;
 using executorch::runtime::CompileSpec;
+using executorch::runtime::DelegateCompletionCallback;
 using executorch::runtime::DelegateHandle;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
@@ -41,11 +43,26 @@ namespace executorch {
 namespace backends {
 namespace arm {
 
-typedef struct {
+typedef struct ExecutionHandle {
   FreeableBuffer* processed;
   bool permuted_io_flag;
+  // State of the inference started by execute_async(), while it runs
+  ethosu_driver* driver;
+  VelaHandles handles;
+  uint64_t bases[2];
+  size_t bases_size[2];
+  EValue** args;
+  DelegateCompletionCallback callback;
+  void* callback_context;
+  struct ExecutionHandle* next_pending;
 } ExecutionHandle;
 
+namespace {
+// Inferences started by execute_async() that ArmBackend_poll() has not seen
+// finish yet
+ExecutionHandle* pending_executions = nullptr;
+} // namespace
+
 extern "C" {
 void __attribute__((weak)) ArmBackend_execute_begin() {}
 void __attribute__((weak)) ArmBackend_execute_end() {}
@@ -93,6 +110,11 @@ class ArmBackend final : public ::executorch::runtime::BackendInterface {
     handle->processed = processed;
 
     handle->permuted_io_flag = false;
+    handle->driver = nullptr;
+    handle->args = nullptr;
+    handle->callback = nullptr;
+    handle->callback_context = nullptr;
+    handle->next_pending = nullptr;
     for (auto& compile_spec : compile_specs) {
       if (0 == std::strcmp(compile_spec.key, "permute_memory_format") &&
           0 == std::memcmp(compile_spec.value.buffer, "nhwc", 4)) {
@@ -113,12 +135,157 @@ class ArmBackend final : public ::executorch::runtime::BackendInterface {
     VelaHandles handles;
 
     ArmBackendExecuteCallbacks ArmBackend_execute_callbacks;
+    ET_CHECK_OK_OR_RETURN_ERROR(read_handles(execution_handle, &handles));
+    ET_CHECK_OK_OR_RETURN_ERROR(copy_inputs(execution_handle, handles, args));
+
+    // Allocate driver handle and synchronously invoke driver
+    auto driver =
+        std::unique_ptr<ethosu_driver, decltype(&ethosu_release_driver)>(
+            ethosu_reserve_driver(), ethosu_release_driver);
+    if (driver == NULL) {
+      ET_LOG(Error, "ArmBackend::execute: ethosu_reserve_driver failed");
+      return Error::InvalidState;
+    }
+
+    // Ethos-U low level driver expected order for Ethos U-55, we have
+    // constant weight data, then scratch (which contains input and output)
+    // scratch is written above in this function.
+    uint64_t bases[2] = {
+        (uint64_t)handles.weight_data, (uint64_t)handles.scratch_data};
+    size_t bases_size[2] = {
+        handles.weight_data_size, handles.scratch_data_size};
+    int result = ethosu_invoke_v3(
+        driver.get(),
+        (void*)handles.cmd_data,
+        handles.cmd_data_size,
+        bases,
+        bases_size,
+        2, /* fixed array of pointers to binary interface*/
+        nullptr);
+
+    if (result != 0) {
+      ET_LOG(
+          Error,
+          "ArmBackend::execute: Ethos-U invocation failed error (%d)",
+          result);
+      return Error::InvalidProgram;
+    }
+    return copy_outputs(execution_handle, handles, args);
+  }
+
+  Error execute_async(
+      BackendExecutionContext& context,
+      DelegateHandle* input_handle,
+      EValue** args,
+      DelegateCompletionCallback callback,
+      void* callback_context) const override {
+    ExecutionHandle* execution_handle = (ExecutionHandle*)input_handle;
+    if (execution_handle->driver != nullptr) {
+      ET_LOG(Error, "ArmBackend::execute_async: delegate is already running");
+      return Error::InvalidState;
+    }
+
+    VelaHandles& handles = execution_handle->handles;
+    ET_CHECK_OK_OR_RETURN_ERROR(read_handles(execution_handle, &handles));
+    ET_CHECK_OK_OR_RETURN_ERROR(copy_inputs(execution_handle, handles, args));
+
+    ethosu_driver* driver = ethosu_reserve_driver();
+    if (driver == nullptr) {
+      ET_LOG(Error, "ArmBackend::execute_async: ethosu_reserve_driver failed");
+      return Error::InvalidState;
+    }
+
+    // The driver may read the base addresses until the inference finishes,
+    // so they live in the execution handle rather than on the stack.
+    execution_handle->bases[0] = (uint64_t)handles.weight_data;
+    execution_handle->bases[1] = (uint64_t)handles.scratch_data;
+    execution_handle->bases_size[0] = handles.weight_data_size;
+    execution_handle->bases_size[1] = handles.scratch_data_size;
+
+    ArmBackend_execute_begin();
+    int result = ethosu_invoke_async(
+        driver,
+        (void*)handles.cmd_data,
+        handles.cmd_data_size,
+        execution_handle->bases,
+        execution_handle->bases_size,
+        2, /* fixed array of pointers to binary interface*/
+        nullptr);
+    if (result != 0) {
+      ArmBackend_execute_end();
+      ethosu_release_driver(driver);
+      ET_LOG(
+          Error,
+          "ArmBackend::execute_async: Ethos-U invocation failed error (%d)",
+          result);
+      return Error::InvalidProgram;
+    }
+
+    execution_handle->driver = driver;
+    execution_handle->args = args;
+    execution_handle->callback = callback;
+    execution_handle->callback_context = callback_context;
+    execution_handle->next_pending = pending_executions;
+    pending_executions = execution_handle;
+    return Error::Ok;
+  }
+
+  int poll(bool block) const {
+    int running = 0;
+    ExecutionHandle** link = &pending_executions;
+    while (*link != nullptr) {
+      ExecutionHandle* execution_handle = *link;
+      int result = ethosu_wait(execution_handle->driver, block);
+      if (result == 1) {
+        // Still running
+        running++;
+        link = &execution_handle->next_pending;
+        continue;
+      }
+      *link = execution_handle->next_pending;
+
+      Error error = Error::Ok;
+      if (result != 0) {
+        ET_LOG(
+            Error,
+            "ArmBackend::poll: Ethos-U invocation failed error (%d)",
+            result);
+        error = Error::InvalidProgram;
+      } else {
+        error = copy_outputs(
+            execution_handle,
+            execution_handle->handles,
+            execution_handle->args);
+      }
+      ethosu_release_driver(execution_handle->driver);
+      ArmBackend_execute_end();
+
+      // Clear the state first, the callback may run the delegate again.
+      DelegateCompletionCallback callback = execution_handle->callback;
+      void* callback_context = execution_handle->callback_context;
+      execution_handle->driver = nullptr;
+      execution_handle->args = nullptr;
+      execution_handle->callback = nullptr;
+      execution_handle->callback_context = nullptr;
+      execution_handle->next_pending = nullptr;
+      callback(callback_context, error);
+    }
+    return running;
+  }
+
+  void destroy(DelegateHandle* handle) const override {
+    return;
+  }
+
+ private:
+  Error read_handles(ExecutionHandle* execution_handle, VelaHandles* handles)
+      const {
     // Command stream - we know at this point it's aligned
     char* data = (char*)execution_handle->processed->data();
     ET_LOG(Debug, "ArmBackend::execute %p", data);
 
     // Read key sections from the vela_bin_stream
-    if (vela_bin_read(data, &handles, execution_handle->processed->size()) ==
+    if (vela_bin_read(data, handles, execution_handle->processed->size()) ==
         false) {
       ET_LOG(Error, "ArmBackend::vela_read: error, invalid binary layout");
       return Error::InvalidProgram;
@@ -127,13 +294,19 @@ class ArmBackend final : public ::executorch::runtime::BackendInterface {
     ET_LOG(
         Debug,
         "ArmBackend::execute: Running program data:\n  cmd %p %zu\n  weight %p %zu\n  scratch %p %zu\n",
-        handles.cmd_data,
-        handles.cmd_data_size,
-        handles.weight_data,
-        handles.weight_data_size,
-        handles.scratch_data,
-        handles.scratch_data_size);
+        handles->cmd_data,
+        handles->cmd_data_size,
+        handles->weight_data,
+        handles->weight_data_size,
+        handles->scratch_data,
+        handles->scratch_data_size);
+    return Error::Ok;
+  }
 
+  Error copy_inputs(
+      ExecutionHandle* execution_handle,
+      const VelaHandles& handles,
+      EValue** args) const {
     // Write argument values (from EValue tensor) into Ethos-U scratch
     // TODO(MLETORCH-123): Optimise into direct write from Vela into the SRAM
     //                     or DRAM output for compatible data layouts.
@@ -217,39 +390,13 @@ class ArmBackend final : public ::executorch::runtime::BackendInterface {
         }
       }
     }
+    return Error::Ok;
+  }
 
-    // Allocate driver handle and synchronously invoke driver
-    auto driver =
-        std::unique_ptr<ethosu_driver, decltype(&ethosu_release_driver)>(
-            ethosu_reserve_driver(), ethosu_release_driver);
-    if (driver == NULL) {
-      ET_LOG(Error, "ArmBackend::execute: ethosu_reserve_driver failed");
-      return Error::InvalidState;
-    }
-
-    // Ethos-U low level driver expected order for Ethos U-55, we have
-    // constant weight data, then scratch (which contains input and output)
-    // scratch is written above in this function.
-    uint64_t bases[2] = {
-        (uint64_t)handles.weight_data, (uint64_t)handles.scratch_data};
-    size_t bases_size[2] = {
-        handles.weight_data_size, handles.scratch_data_size};
-    int result = ethosu_invoke_v3(
-        driver.get(),
-        (void*)handles.cmd_data,
-        handles.cmd_data_size,
-        bases,
-        bases_size,
-        2, /* fixed array of pointers to binary interface*/
-        nullptr);
-
-    if (result != 0) {
-      ET_LOG(
-          Error,
-          "ArmBackend::execute: Ethos-U invocation failed error (%d)",
-          result);
-      return Error::InvalidProgram;
-    }
+  Error copy_outputs(
+      ExecutionHandle* execution_handle,
+      const VelaHandles& handles,
+      EValue** args) const {
     int tensor_dim = 0, io_dim = 0;
     // Write outputs from scratch into EValue pointers
     for (int i = 0; i < handles.outputs->count; i++) {
@@ -285,15 +432,13 @@ class ArmBackend final : public ::executorch::runtime::BackendInterface {
             tensor_out.size(2),
             tensor_out.size(3));
       } else {
-        for (int j = 0; j < tensor_out.numel(); j++) {
-          if (tensor_out.scalar_type() == ScalarType::Char) {
-            char* output_address = (char*)output_addr;
-            tensor_out.mutable_data_ptr<char>()[j] = output_address[j];
-          } else {
-            int* output_address = (int*)output_addr;
-            tensor_out.mutable_data_ptr<int>()[j] = output_address[j];
-          }
-        }
+        size_t elem_size = tensor_out.scalar_type() == ScalarType::Char
+            ? sizeof(char)
+            : sizeof(int);
+        memcpy(
+            tensor_out.mutable_data_ptr<char>(),
+            output_addr,
+            tensor_out.numel() * elem_size);
       }
     }
     if (tensor_dim != io_dim) {
@@ -305,11 +450,6 @@ class ArmBackend final : public ::executorch::runtime::BackendInterface {
     return Error::Ok;
   }
 
-  void destroy(DelegateHandle* handle) const override {
-    return;
-  }
-
- private:
   void calculate_dimensions(
       const executorch::aten::Tensor tensor,
       VelaIO* io,
@@ -379,6 +519,10 @@ Backend backend_id{"ArmBackend", &backend};
 static auto registered = register_backend(backend_id);
 } // namespace
 
+extern "C" int ArmBackend_poll(bool block) {
+  return backend.poll(block);
+}
+
 } // namespace arm
 } // namespace backends
 } // namespace executorch
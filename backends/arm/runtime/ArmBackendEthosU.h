@@ -0,0 +1,34 @@
+/*
+ * Copyright 2024 Arm Limited and/or its affiliates.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ * Interface of the Arm backend for Ethos-U baremetal driver stack that
+ * applications call directly.
+ */
+
+#pragma once
+
+namespace executorch {
+namespace backends {
+namespace arm {
+
+extern "C" {
+/*
+ * Completes the Ethos-U inferences started by Method::execute_async() that
+ * have finished, copying their outputs and calling their completion callbacks
+ * on the calling thread. The NPU signals completion by interrupt, so the CPU
+ * is free to do other work between calls. If block is true, waits for every
+ * pending inference to finish instead.
+ *
+ * Returns the number of inferences that are still running.
+ */
+int ArmBackend_poll(bool block);
+}
+
+} // namespace arm
+} // namespace backends
+} // namespace executorch
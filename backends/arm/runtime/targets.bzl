@@ -13,7 +13,7 @@ def define_common_targets():
     runtime.cxx_library(
         name = "arm_backend",
         srcs = ["ArmBackendEthosU.cpp"],
-        headers = [],
+        exported_headers = ["ArmBackendEthosU.h"],
         compatible_with = ["ovr_config//cpu:arm32-embedded"],
         # arm_executor_runner.cpp needs to compile with executor as whole
         # @lint-ignore BUCKLINT: Avoid `link_whole=True` (https://fburl.com/avoid-link-whole)
@@ -36,6 +36,9 @@
 #include <executorch/runtime/platform/runtime.h>
 
 static uint8_t method_allocator_pool[18 * 1024U]; // 4 MB
+// Scratch memory of the kernels, e.g. for the nnlib conv kernels. Reset after
+// each kernel.
+static uint8_t temp_allocator_pool[128 * 1024U];
 
 #include <xtensa/config/core.h>
 
@@ -163,8 +166,12 @@ int main(int argc, char** argv) {
   executorch::runtime::HierarchicalAllocator planned_memory(
       {planned_spans.data(), planned_spans.size()});
 
+  executorch::runtime::MemoryAllocator temp_allocator{
+      executorch::runtime::MemoryAllocator(
+          sizeof(temp_allocator_pool), temp_allocator_pool)};
+
   executorch::runtime::MemoryManager memory_manager(
-      &method_allocator, &planned_memory);
+      &method_allocator, &planned_memory, &temp_allocator);
 
   Result<executorch::runtime::Method> method =
       program->load_method(method_name, &memory_manager);
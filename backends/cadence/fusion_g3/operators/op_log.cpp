@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/kernels/portable/cpu/pattern/pattern.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::KernelRuntimeContext;
+
+namespace cadence {
+namespace impl {
+namespace G3 {
+namespace native {
+
+Tensor& log_out(KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) {
+  if (in.scalar_type() != ScalarType::Float ||
+      out.scalar_type() != ScalarType::Float) {
+    return torch::executor::native::internal::
+        unary_ufunc_realhbbf16_to_floathbf16(std::log, ctx, in, out);
+  }
+
+  // Resize for dynamic shape
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, in.sizes()) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor.");
+
+  ET_KERNEL_CHECK(
+      ctx,
+      executorch::runtime::tensors_have_same_dim_order(in, out),
+      InvalidArgument,
+      out);
+
+  // Single precision log over contiguous data, which the compiler maps onto
+  // the vector FPU, instead of the double precision log of the portable
+  // kernel that the DSP computes in software.
+  const float* __restrict__ in_data = in.const_data_ptr<float>();
+  float* __restrict__ out_data = out.mutable_data_ptr<float>();
+  const size_t num_elm = out.numel();
+  for (size_t i = 0; i < num_elm; ++i) {
+    out_data[i] = std::log(in_data[i]);
+  }
+
+  return out;
+}
+
+} // namespace native
+} // namespace G3
+} // namespace impl
+} // namespace cadence
@@ -34,8 +34,11 @@ OPERATORS = [
     "add",
     "cat",
     "dequantize",
+    "exp",
+    "log",
     "mul",
     "native_layer_norm",
+    "pow",
     "quantize",
     "softmax",
 ]
@@ -0,0 +1,972 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+#include <executorch/backends/cadence/hifi/operators/operators.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <xa_nnlib_kernels_api.h>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace cadence {
+namespace impl {
+namespace HiFi {
+namespace native {
+
+using ::executorch::aten::IntArrayRef;
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::KernelRuntimeContext;
+
+// This implements a generic 2d conv kernel that operates on raw pointers.
+// The version handles both quantized and fp32 convolutions.
+// The input is of shape [n x c x h x w]
+// The weight is of shape [oc x wc x wh x ww], where wc == c
+// The output is of shape [n x oc x oh x ow]
+// The bias is of shape [oc]
+template <
+    typename IT = float,
+    typename WT = IT,
+    typename BT = IT,
+    typename OT = IT,
+    bool quantized = false>
+__attribute__((noinline)) void conv2d_nchw_core_generic(
+    // All the arrays
+    const IT* __restrict__ p_in,
+    const WT* __restrict__ p_weight,
+    const BT* __restrict__ p_bias,
+    OT* __restrict__ p_out,
+    // The array sizes
+    int32_t n,
+    int32_t c,
+    int32_t h,
+    int32_t w,
+    int32_t oc,
+    int32_t wc,
+    int32_t wh,
+    int32_t ww,
+    int32_t oh,
+    int32_t ow,
+    // Stride
+    int16_t s0,
+    int16_t s1,
+    // Padding
+    int16_t p0,
+    int16_t p1,
+    // Dilation
+    int16_t d0,
+    int16_t d1,
+    // Group for depthwise conv
+    int16_t groups,
+    // Optional args that are only relevant for quantized convolution
+    // input zero point
+    IT in_zero_point = 0,
+    // weight zero point
+    int32_t weight_zero_point = 0,
+    float bias_scale = 1,
+    float out_scale = 1,
+    OT out_zero_point = 0) {
+  float inv_out_scale = 1. / out_scale;
+  bool zero_pad_unit_dilation = d0 == 1 && d1 == 1 && p0 == 0 && p1 == 0;
+
+  // Compute the number of in and out channels per group
+  const int ocpg = oc / groups;
+  const int icpg = c / groups;
+
+  // Iterate over all the output batches (i.e., n)
+  for (int _n = 0; _n < n; ++_n) {
+    const IT* in_batch = p_in + _n * c * h * w;
+    OT* out_batch = p_out + _n * oc * oh * ow;
+    // Compute separable convolution for each group
+    for (int _g = 0; _g < groups; ++_g) {
+      // Identify the input and output channels involved in the computation
+      // of this group
+      int sic = _g * icpg;
+      int soc = _g * ocpg;
+      // Populate all the output channels in the group
+      for (int _oc = soc; _oc < soc + ocpg; ++_oc) {
+        OT* out_plane = out_batch + _oc * oh * ow;
+        const WT* weight_batch = p_weight + _oc * wc * wh * ww;
+        // We compute one output channel at a time. The computation can be
+        // thought of as a stencil computation: we iterate over an input of size
+        // icpg x h x w, with a stencil of size icpg x wh x ww, to compute an
+        // output channel of size 1 x oh x ow.
+        for (int _h = 0, _oh = 0; _oh < oh; _h += s0, ++_oh) {
+          for (int _w = 0, _ow = 0; _ow < ow; _w += s1, ++_ow) {
+            float acc = p_bias[_oc];
+            // Below is the stencil computation that performs the hadamard
+            // product+accumulation of each input channel (contributing to the
+            // output channel being computed) with the corresponding weight
+            // channel.
+            // If the padding is 0, and dilation is 1, then we can remove the
+            // unnecessary checks, and simplify the code so that it can be
+            // vectorized by Tensilica compiler.
+            if (zero_pad_unit_dilation) {
+              for (int _ic = sic; _ic < sic + icpg; ++_ic) {
+                const IT* in_plane = in_batch + _ic * h * w;
+                const WT* weight_plane = weight_batch + (_ic - sic) * wh * ww;
+                for (int _wh = 0; _wh < wh; ++_wh) {
+                  for (int _ww = 0; _ww < ww; ++_ww) {
+                    int ioff = (_h + _wh) * w + (_w + _ww);
+                    int woff = _wh * ww + _ww;
+                    float lhs = in_plane[ioff] - in_zero_point;
+                    float rhs = weight_plane[woff] -
+                        (quantized ? weight_zero_point : 0);
+                    acc += lhs * rhs;
+                  }
+                }
+              }
+            } else {
+              for (int _ic = sic; _ic < sic + icpg; ++_ic) {
+                const IT* in_plane = in_batch + _ic * h * w;
+                const WT* weight_plane = weight_batch + (_ic - sic) * wh * ww;
+                for (int _wh = 0; _wh < wh; ++_wh) {
+                  for (int _ww = 0; _ww < ww; ++_ww) {
+                    if (((_h + d0 * _wh - p0) >= 0) &&
+                        ((_h + d0 * _wh - p0) < h) &&
+                        ((_w + d1 * _ww - p1) >= 0) &&
+                        ((_w + d1 * _ww - p1 < w))) {
+                      int ioff =
+                          (_h + d0 * _wh - p0) * w + (_w + d1 * _ww - p1);
+                      int woff = _wh * ww + _ww;
+                      float lhs = in_plane[ioff] - in_zero_point;
+                      float rhs = weight_plane[woff] -
+                          (quantized ? weight_zero_point : 0);
+                      acc += lhs * rhs;
+                    }
+                  }
+                }
+              }
+            }
+            if (quantized) {
+              float val = bias_scale * acc;
+              out_plane[_oh * ow + _ow] = kernels::quantize<OT>(
+                  val, inv_out_scale, out_zero_point);
+            } else {
+              out_plane[_oh * ow + _ow] = acc;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+template <
+    typename IT = float,
+    typename WT = IT,
+    typename BT = IT,
+    typename OT = IT,
+    bool quantized = false>
+__attribute__((noinline)) void conv2d_nhwc_core_generic(
+    // All the arrays
+    const IT* __restrict__ p_in,
+    const WT* __restrict__ p_weight,
+    const BT* __restrict__ p_bias,
+    OT* __restrict__ p_out,
+    // The array sizes
+    int32_t n,
+    int32_t h,
+    int32_t w,
+    int32_t c,
+    int32_t oc,
+    int32_t wh,
+    int32_t ww,
+    int32_t wc,
+    int32_t oh,
+    int32_t ow,
+    // Stride
+    int16_t s0,
+    int16_t s1,
+    // Padding
+    int16_t p0,
+    int16_t p1,
+    // Dilation
+    int16_t d0,
+    int16_t d1,
+    // Group for depthwise conv
+    int16_t groups,
+    // Optional args that are only relevant for quantized convolution
+    // input zero point
+    IT in_zero_point = 0,
+    // weight zero point
+    int32_t weight_zero_point = 0,
+    float bias_scale = 1,
+    float out_scale = 1,
+    OT out_zero_point = 0) {
+  float inv_out_scale = 1. / out_scale;
+  bool zero_pad_unit_dilation = d0 == 1 && d1 == 1 && p0 == 0 && p1 == 0;
+
+  // Compute the number of in and out channels per group
+  const int ocpg = oc / groups;
+  const int icpg = c / groups;
+
+  // Iterate over all the output batches (i.e., n)
+  for (int _n = 0; _n < n; ++_n) {
+    const IT* in_batch = p_in + _n * h * w * c;
+    OT* out_batch = p_out + _n * oh * ow * oc;
+    for (int _h = 0, _oh = 0; _oh < oh; _h += s0, ++_oh) {
+      for (int _w = 0, _ow = 0; _ow < ow; _w += s1, ++_ow) {
+        OT* out_line = out_batch + (_oh * ow + _ow) * oc;
+        // Compute separable convolution for each group
+        for (int _g = 0; _g < groups; ++_g) {
+          // Identify the input and output channels involved in the computation
+          // of this group
+          int sic = _g * icpg;
+          int soc = _g * ocpg;
+          // Populate all the output channels in the group
+          for (int _oc = soc; _oc < soc + ocpg; ++_oc) {
+            const WT* weight_batch = p_weight + _oc * wh * ww * wc;
+            // We compute one output channel at a time. The computation can be
+            // thought of as a stencil computation: we iterate over an input of
+            // size h x w x icpg, with a stencil of size wh x ww x icpg, to
+            // compute an output channel of size oh x ow x 1.
+            float acc = p_bias[_oc];
+            // Below is the stencil computation that performs the hadamard
+            // product+accumulation of each input channel (contributing to
+            // the output channel being computed) with the corresponding
+            // weight channel. If the padding is 0, and dilation is 1, then
+            // we can remove the unnecessary checks, and simplify the code
+            // so that it can be vectorized by Tensilica compiler.
+            if (zero_pad_unit_dilation) {
+              for (int _wh = 0; _wh < wh; ++_wh) {
+                for (int _ww = 0; _ww < ww; ++_ww) {
+                  const IT* in_line =
+                      in_batch + (_h + _wh) * w * c + (_w + _ww) * c;
+                  const WT* weight_line =
+                      weight_batch + _wh * ww * wc + _ww * wc;
+                  for (int _ic = sic; _ic < sic + icpg; ++_ic) {
+                    float lhs = in_line[_ic] - in_zero_point;
+                    float rhs = weight_line[_ic - sic] -
+                        (quantized ? weight_zero_point : 0);
+                    acc += lhs * rhs;
+                  }
+                }
+              }
+            } else {
+              for (int _wh = 0; _wh < wh; ++_wh) {
+                for (int _ww = 0; _ww < ww; ++_ww) {
+                  if (((_h + d0 * _wh - p0) >= 0) &&
+                      ((_h + d0 * _wh - p0) < h) &&
+                      ((_w + d1 * _ww - p1) >= 0) &&
+                      ((_w + d1 * _ww - p1 < w))) {
+                    const IT* in_line = in_batch +
+                        (_h + d0 * _wh - p0) * w * c + (_w + d1 * _ww - p1) * c;
+                    const WT* weight_line =
+                        weight_batch + _wh * ww * wc + _ww * wc;
+                    for (int _ic = sic; _ic < sic + icpg; ++_ic) {
+                      float lhs = in_line[_ic] - in_zero_point;
+                      float rhs = weight_line[_ic - sic] -
+                          (quantized ? weight_zero_point : 0);
+                      acc += lhs * rhs;
+                    }
+                  }
+                }
+              }
+            }
+            if (quantized) {
+              float val = bias_scale * acc;
+              out_line[_oc] = kernels::quantize<OT>(
+                  val, inv_out_scale, out_zero_point);
+            } else {
+              out_line[_oc] = acc;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// The quantized convolution kernel. in_scale and weight_scale are implicit in
+// bias_scale, since it is a product of the two. The kernel will branch to
+// quantized::conv1d or quantized::conv2d based on the dimensionality of
+// activation tensor.
+void quantized_conv_nchw(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int16_t groups,
+    int32_t in_zero_point,
+    int32_t weight_zero_point,
+    float bias_scale,
+    float output_scale,
+    int32_t output_zero_point,
+    Tensor& out) {
+  bool conv1d = input.dim() == 3;
+  // input = [n, c, h, w]
+  const int n = input.size(0);
+  const int c = input.size(1);
+  const int h = conv1d ? 1 : input.size(2);
+  const int w = conv1d ? input.size(2) : input.size(3);
+  // weight = [oc, wc, wh, ww]
+  const int oc = weight.size(0);
+  const int wc = weight.size(1);
+  const int wh = conv1d ? 1 : weight.size(2);
+  const int ww = conv1d ? weight.size(2) : weight.size(3);
+  // output = [n, oc, oh, ow]
+  const int oh = conv1d ? 1 : out.size(2);
+  const int ow = conv1d ? out.size(2) : out.size(3);
+
+#define typed_quantized_conv2d_nchw(ctype, dtype)                 \
+  case ScalarType::dtype: {                                       \
+    conv2d_nchw_core_generic<ctype, ctype, int32_t, ctype, true>( \
+        input.const_data_ptr<ctype>(),                            \
+        weight.const_data_ptr<ctype>(),                           \
+        bias.const_data_ptr<int32_t>(),                           \
+        out.mutable_data_ptr<ctype>(),                            \
+        n,                                                        \
+        c,                                                        \
+        h,                                                        \
+        w,                                                        \
+        oc,                                                       \
+        wc,                                                       \
+        wh,                                                       \
+        ww,                                                       \
+        oh,                                                       \
+        ow,                                                       \
+        stride[0],                                                \
+        stride[1],                                                \
+        padding[0],                                               \
+        padding[1],                                               \
+        dilation[0],                                              \
+        dilation[1],                                              \
+        groups,                                                   \
+        in_zero_point,                                            \
+        weight_zero_point,                                        \
+        bias_scale,                                               \
+        output_scale,                                             \
+        (ctype)output_zero_point);                                \
+    break;                                                        \
+  }
+  ScalarType dtype = out.scalar_type();
+  switch (dtype) {
+    ET_FORALL_CADENCE_QUANTIZED_TYPES(typed_quantized_conv2d_nchw);
+    default:
+      ET_DCHECK_MSG(
+          false, "Unhandled dtype %s", torch::executor::toString(dtype));
+  }
+
+#undef typed_quantized_conv2d_nchw
+}
+
+void quantized_conv_nhwc(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int16_t groups,
+    int32_t in_zero_point,
+    int32_t weight_zero_point,
+    float bias_scale,
+    float output_scale,
+    int32_t output_zero_point,
+    Tensor& out) {
+  bool conv1d = input.dim() == 3;
+  // input = [n, h, w, c]
+  const int n = input.size(0);
+  const int h = conv1d ? 1 : input.size(1);
+  const int w = conv1d ? input.size(1) : input.size(2);
+  const int c = conv1d ? input.size(2) : input.size(3);
+  // weight = [oc, wh, ww, wc]
+  const int oc = weight.size(0);
+  const int wh = conv1d ? 1 : weight.size(1);
+  const int ww = conv1d ? weight.size(1) : weight.size(2);
+  const int wc = conv1d ? weight.size(2) : weight.size(3);
+  // output = [n, oh, ow, oc]
+  const int oh = conv1d ? 1 : out.size(1);
+  const int ow = conv1d ? out.size(1) : out.size(2);
+
+#define typed_quantized_conv2d_nhwc(ctype, dtype)                 \
+  case ScalarType::dtype: {                                       \
+    conv2d_nhwc_core_generic<ctype, ctype, int32_t, ctype, true>( \
+        input.const_data_ptr<ctype>(),                            \
+        weight.const_data_ptr<ctype>(),                           \
+        bias.const_data_ptr<int32_t>(),                           \
+        out.mutable_data_ptr<ctype>(),                            \
+        n,                                                        \
+        h,                                                        \
+        w,                                                        \
+        c,                                                        \
+        oc,                                                       \
+        wh,                                                       \
+        ww,                                                       \
+        wc,                                                       \
+        oh,                                                       \
+        ow,                                                       \
+        stride[0],                                                \
+        stride[1],                                                \
+        padding[0],                                               \
+        padding[1],                                               \
+        dilation[0],                                              \
+        dilation[1],                                              \
+        groups,                                                   \
+        in_zero_point,                                            \
+        weight_zero_point,                                        \
+        bias_scale,                                               \
+        output_scale,                                             \
+        (ctype)output_zero_point);                                \
+    break;                                                        \
+  }
+  ScalarType dtype = out.scalar_type();
+  switch (dtype) {
+    ET_FORALL_CADENCE_QUANTIZED_TYPES(typed_quantized_conv2d_nhwc);
+    default:
+      ET_DCHECK_MSG(
+          false, "Unhandled dtype %s", torch::executor::toString(dtype));
+  }
+
+#undef typed_quantized_conv2d_nhwc
+}
+
+// Splits the requantization scale of the accumulators into the Q31 multiplier
+// and the left shift that the nnlib kernels take. Returns false if the shift
+// is out of the range that nnlib supports.
+bool inline _nnlib_requantize_params(
+    float requant_scale,
+    int32_t* out_multiplier,
+    int32_t* out_shift) {
+  int exponent = 0;
+  const double mantissa = std::frexp(requant_scale, &exponent);
+  int64_t multiplier = std::llround(mantissa * (1ll << 31));
+  if (multiplier == (1ll << 31)) {
+    multiplier /= 2;
+    ++exponent;
+  }
+  *out_multiplier = static_cast<int32_t>(multiplier);
+  *out_shift = exponent;
+  return exponent >= -31 && exponent <= 31;
+}
+
+// Returns 8-byte aligned scratch memory from the temp allocator, or nullptr if
+// there is not enough of it.
+void* _nnlib_scratch(KernelRuntimeContext& ctx, int32_t size) {
+  if (size < 0) {
+    return nullptr;
+  }
+  auto scratch = ctx.allocate_temp(size == 0 ? 8 : size, 8);
+  return scratch.ok() ? scratch.get() : nullptr;
+}
+
+// Fills one multiplier and shift per output channel, for the per-channel
+// int8 kernels.
+int32_t* _nnlib_per_channel_params(
+    KernelRuntimeContext& ctx,
+    int32_t oc,
+    int32_t out_multiplier,
+    int32_t out_shift) {
+  auto params = ctx.allocate_temp(2 * oc * sizeof(int32_t));
+  if (!params.ok()) {
+    return nullptr;
+  }
+  int32_t* p = static_cast<int32_t*>(params.get());
+  std::fill(p, p + oc, out_multiplier);
+  std::fill(p + oc, p + 2 * oc, out_shift);
+  return p;
+}
+
+// Copies an [n, c, h, w] array to [n, h, w, c] layout.
+template <typename T>
+void _nchw_to_nhwc(
+    T* __restrict__ dst,
+    const T* __restrict__ src,
+    int n,
+    int c,
+    int h,
+    int w) {
+  for (int _n = 0; _n < n; ++_n) {
+    for (int _c = 0; _c < c; ++_c) {
+      const T* src_plane = src + (_n * c + _c) * h * w;
+      T* dst_batch = dst + _n * h * w * c;
+      for (int i = 0; i < h * w; ++i) {
+        dst_batch[i * c + _c] = src_plane[i];
+      }
+    }
+  }
+}
+
+// Runs a non-grouped conv with the nnlib standard conv kernels, which take
+// NHWC input and [oc, wh, ww, wc] weights, and write NHWC or NCHW output.
+// Channels-first input and weights are copied to channels-last layout first,
+// which is cheap compared to the conv. Returns false if nnlib can't run it, in
+// which case nothing was written.
+template <typename T>
+bool _nnlib_conv2d(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    int32_t in_zero_point,
+    int32_t weight_zero_point,
+    int32_t out_multiplier,
+    int32_t out_shift,
+    int32_t output_zero_point,
+    bool channel_last,
+    Tensor& out) {
+  bool conv1d = input.dim() == 3;
+  const int n = input.size(0);
+  int c, h, w, oc, wh, ww, oh, ow;
+  if (channel_last) {
+    // input = [n, h, w, c]
+    h = conv1d ? 1 : input.size(1);
+    w = conv1d ? input.size(1) : input.size(2);
+    c = conv1d ? input.size(2) : input.size(3);
+    // weight = [oc, wh, ww, wc]
+    oc = weight.size(0);
+    wh = conv1d ? 1 : weight.size(1);
+    ww = conv1d ? weight.size(1) : weight.size(2);
+    // output = [n, oh, ow, oc]
+    oh = conv1d ? 1 : out.size(1);
+    ow = conv1d ? out.size(1) : out.size(2);
+  } else {
+    // input = [n, c, h, w]
+    c = input.size(1);
+    h = conv1d ? 1 : input.size(2);
+    w = conv1d ? input.size(2) : input.size(3);
+    // weight = [oc, wc, wh, ww]
+    oc = weight.size(0);
+    wh = conv1d ? 1 : weight.size(2);
+    ww = conv1d ? weight.size(2) : weight.size(3);
+    // output = [n, oc, oh, ow]
+    oh = conv1d ? 1 : out.size(2);
+    ow = conv1d ? out.size(2) : out.size(3);
+  }
+
+  constexpr bool is_uint8 = std::is_same<T, uint8_t>::value;
+  // The int8 kernel only supports symmetric weights.
+  if (!is_uint8 && weight_zero_point != 0) {
+    return false;
+  }
+  void* p_scratch = _nnlib_scratch(
+      ctx,
+      xa_nn_conv2d_std_getsize(
+          h,
+          c,
+          wh,
+          ww,
+          stride[0],
+          padding[0],
+          oh,
+          oc,
+          is_uint8 ? PREC_ASYM8U : PREC_ASYM8S));
+  if (p_scratch == nullptr) {
+    return false;
+  }
+  int32_t* per_channel_params = nullptr;
+  if (!is_uint8) {
+    per_channel_params =
+        _nnlib_per_channel_params(ctx, oc, out_multiplier, out_shift);
+    if (per_channel_params == nullptr) {
+      return false;
+    }
+  }
+
+  const T* in_data = input.const_data_ptr<T>();
+  const T* weight_data = weight.const_data_ptr<T>();
+  if (!channel_last) {
+    auto in_nhwc = ctx.allocate_temp(n * h * w * c * sizeof(T));
+    auto weight_nhwc = ctx.allocate_temp(oc * wh * ww * c * sizeof(T));
+    if (!in_nhwc.ok() || !weight_nhwc.ok()) {
+      return false;
+    }
+    _nchw_to_nhwc(static_cast<T*>(in_nhwc.get()), in_data, n, c, h, w);
+    _nchw_to_nhwc(
+        static_cast<T*>(weight_nhwc.get()), weight_data, oc, c, wh, ww);
+    in_data = static_cast<T*>(in_nhwc.get());
+    weight_data = static_cast<T*>(weight_nhwc.get());
+  }
+  // 0 is NHWC, 1 is NCHW
+  const WORD32 out_data_format = channel_last ? 0 : 1;
+
+  for (int _n = 0; _n < n; ++_n) {
+    WORD32 ret = -1;
+    if constexpr (is_uint8) {
+      ret = xa_nn_conv2d_std_asym8xasym8(
+          out.mutable_data_ptr<T>() + _n * oh * ow * oc,
+          in_data + _n * h * w * c,
+          weight_data,
+          bias.const_data_ptr<int32_t>(),
+          h,
+          w,
+          c,
+          wh,
+          ww,
+          oc,
+          stride[1], // x_stride
+          stride[0], // y_stride
+          padding[1], // x_padding
+          padding[0], // y_padding
+          oh,
+          ow,
+          -in_zero_point, // input_zero_bias
+          -weight_zero_point, // kernel_zero_bias
+          out_multiplier,
+          out_shift,
+          output_zero_point,
+          out_data_format,
+          p_scratch);
+    } else {
+      ret = xa_nn_conv2d_std_per_chan_sym8sxasym8s(
+          out.mutable_data_ptr<T>() + _n * oh * ow * oc,
+          in_data + _n * h * w * c,
+          weight_data,
+          bias.const_data_ptr<int32_t>(),
+          h,
+          w,
+          c,
+          wh,
+          ww,
+          oc,
+          stride[1], // x_stride
+          stride[0], // y_stride
+          padding[1], // x_padding
+          padding[0], // y_padding
+          oh,
+          ow,
+          -in_zero_point, // input_zero_bias
+          per_channel_params, // p_out_multiplier
+          per_channel_params + oc, // p_out_shift
+          output_zero_point,
+          out_data_format,
+          p_scratch);
+    }
+    // nnlib validates the arguments before it writes any output, and they are
+    // the same for every batch.
+    if (ret != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs a depthwise channels-first conv with the nnlib depthwise conv kernels,
+// which take NCHW input and [oc, wh, ww] weights. Returns false if nnlib can't
+// run it, in which case nothing was written.
+bool _nnlib_depthwise_conv2d_nchw(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    int32_t in_zero_point,
+    int32_t weight_zero_point,
+    int32_t out_multiplier,
+    int32_t out_shift,
+    int32_t output_zero_point,
+    Tensor& out) {
+  bool conv1d = input.dim() == 3;
+  // input = [n, c, h, w]
+  const int n = input.size(0);
+  const int c = input.size(1);
+  const int h = conv1d ? 1 : input.size(2);
+  const int w = conv1d ? input.size(2) : input.size(3);
+  // weight = [oc, 1, wh, ww]
+  const int oc = weight.size(0);
+  const int wh = conv1d ? 1 : weight.size(2);
+  const int ww = conv1d ? weight.size(2) : weight.size(3);
+  // output = [n, oc, oh, ow]
+  const int oh = conv1d ? 1 : out.size(2);
+  const int ow = conv1d ? out.size(2) : out.size(3);
+  const int channels_multiplier = oc / c;
+
+  const ScalarType dtype = out.scalar_type();
+  // The int8 kernel only supports symmetric weights.
+  if (dtype == ScalarType::Char && weight_zero_point != 0) {
+    return false;
+  }
+  const WORD32 precision =
+      dtype == ScalarType::Byte ? PREC_ASYM8U : PREC_ASYM8S;
+  void* p_scratch = _nnlib_scratch(
+      ctx,
+      xa_nn_conv2d_depthwise_getsize(
+          h,
+          w,
+          c,
+          wh,
+          ww,
+          channels_multiplier,
+          stride[1],
+          stride[0],
+          padding[1],
+          padding[0],
+          oh,
+          ow,
+          precision,
+          1)); // inp_data_format, i.e., NCHW
+  if (p_scratch == nullptr) {
+    return false;
+  }
+  int32_t* per_channel_params = nullptr;
+  if (dtype == ScalarType::Char) {
+    per_channel_params =
+        _nnlib_per_channel_params(ctx, oc, out_multiplier, out_shift);
+    if (per_channel_params == nullptr) {
+      return false;
+    }
+  }
+
+  for (int _n = 0; _n < n; ++_n) {
+    WORD32 ret = -1;
+    if (dtype == ScalarType::Byte) {
+      ret = xa_nn_conv2d_depthwise_asym8xasym8(
+          out.mutable_data_ptr<uint8_t>() + _n * oc * oh * ow,
+          weight.const_data_ptr<uint8_t>(),
+          input.const_data_ptr<uint8_t>() + _n * c * h * w,
+          bias.const_data_ptr<int32_t>(),
+          h,
+          w,
+          c,
+          wh,
+          ww,
+          channels_multiplier,
+          stride[1], // x_stride
+          stride[0], // y_stride
+          padding[1], // x_padding
+          padding[0], // y_padding
+          oh,
+          ow,
+          -in_zero_point, // input_zero_bias
+          -weight_zero_point, // kernel_zero_bias
+          out_multiplier,
+          out_shift,
+          output_zero_point,
+          1, // inp_data_format, i.e., NCHW
+          1, // out_data_format, i.e., NCHW
+          p_scratch);
+    } else if (dtype == ScalarType::Char) {
+      ret = xa_nn_conv2d_depthwise_per_chan_sym8sxasym8s(
+          out.mutable_data_ptr<int8_t>() + _n * oc * oh * ow,
+          weight.const_data_ptr<int8_t>(),
+          input.const_data_ptr<int8_t>() + _n * c * h * w,
+          bias.const_data_ptr<int32_t>(),
+          h,
+          w,
+          c,
+          wh,
+          ww,
+          channels_multiplier,
+          stride[1], // x_stride
+          stride[0], // y_stride
+          padding[1], // x_padding
+          padding[0], // y_padding
+          oh,
+          ow,
+          -in_zero_point, // input_zero_bias
+          per_channel_params, // p_out_multiplier
+          per_channel_params + oc, // p_out_shift
+          output_zero_point,
+          1, // inp_data_format, i.e., NCHW
+          1, // out_data_format, i.e., NCHW
+          p_scratch);
+    }
+    if (ret != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Runs the quantized conv with nnlib when it supports the layout and
+// arguments, and with the generic kernels otherwise.
+void _quantized_conv(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int16_t groups,
+    int32_t in_zero_point,
+    int32_t weight_zero_point,
+    float bias_scale,
+    float output_scale,
+    int32_t output_zero_point,
+    bool channel_last,
+    Tensor& out) {
+  const int c = channel_last ? input.size(input.dim() - 1) : input.size(1);
+  const int oc = weight.size(0);
+  int32_t out_multiplier = 0;
+  int32_t out_shift = 0;
+  const bool nnlib_supported = dilation[0] == 1 && dilation[1] == 1 &&
+      _nnlib_requantize_params(
+          bias_scale / output_scale, &out_multiplier, &out_shift);
+
+  if (nnlib_supported && groups == 1) {
+    bool done = false;
+    if (out.scalar_type() == ScalarType::Byte) {
+      done = _nnlib_conv2d<uint8_t>(
+          ctx,
+          input,
+          weight,
+          bias,
+          stride,
+          padding,
+          in_zero_point,
+          weight_zero_point,
+          out_multiplier,
+          out_shift,
+          output_zero_point,
+          channel_last,
+          out);
+    } else if (out.scalar_type() == ScalarType::Char) {
+      done = _nnlib_conv2d<int8_t>(
+          ctx,
+          input,
+          weight,
+          bias,
+          stride,
+          padding,
+          in_zero_point,
+          weight_zero_point,
+          out_multiplier,
+          out_shift,
+          output_zero_point,
+          channel_last,
+          out);
+    }
+    if (done) {
+      return;
+    }
+  }
+  if (nnlib_supported && !channel_last && groups > 1 && groups == c &&
+      oc % c == 0 &&
+      _nnlib_depthwise_conv2d_nchw(
+          ctx,
+          input,
+          weight,
+          bias,
+          stride,
+          padding,
+          in_zero_point,
+          weight_zero_point,
+          out_multiplier,
+          out_shift,
+          output_zero_point,
+          out)) {
+    return;
+  }
+
+  if (channel_last) {
+    quantized_conv_nhwc(
+        input,
+        weight,
+        bias,
+        stride,
+        padding,
+        dilation,
+        groups,
+        in_zero_point,
+        weight_zero_point,
+        bias_scale,
+        output_scale,
+        output_zero_point,
+        out);
+  } else {
+    quantized_conv_nchw(
+        input,
+        weight,
+        bias,
+        stride,
+        padding,
+        dilation,
+        groups,
+        in_zero_point,
+        weight_zero_point,
+        bias_scale,
+        output_scale,
+        output_zero_point,
+        out);
+  }
+}
+
+void quantized_conv_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    int64_t in_zero_point,
+    const Tensor& weight_zero_point,
+    const Tensor& bias_scale,
+    double output_scale,
+    int64_t output_zero_point,
+    __ET_UNUSED const Tensor& out_multiplier,
+    __ET_UNUSED const Tensor& out_shift,
+    bool channel_last,
+    Tensor& out) {
+  _quantized_conv(
+      ctx,
+      input,
+      weight,
+      bias,
+      stride,
+      padding,
+      dilation,
+      groups,
+      in_zero_point,
+      weight_zero_point.const_data_ptr<int32_t>()[0],
+      bias_scale.const_data_ptr<float>()[0],
+      output_scale,
+      output_zero_point,
+      channel_last,
+      out);
+}
+
+void quantized_conv_per_tensor_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    int64_t in_zero_point,
+    int64_t weight_zero_point,
+    double bias_scale,
+    double output_scale,
+    int64_t output_zero_point,
+    __ET_UNUSED int64_t out_multiplier,
+    __ET_UNUSED int64_t out_shift,
+    bool channel_last,
+    Tensor& out) {
+  _quantized_conv(
+      ctx,
+      input,
+      weight,
+      bias,
+      stride,
+      padding,
+      dilation,
+      groups,
+      in_zero_point,
+      weight_zero_point,
+      bias_scale,
+      output_scale,
+      output_zero_point,
+      channel_last,
+      out);
+}
+
+}; // namespace native
+}; // namespace HiFi
+}; // namespace impl
+}; // namespace cadence
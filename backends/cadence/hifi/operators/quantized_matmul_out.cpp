@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/cadence/hifi/kernels/kernels.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <xa_nnlib_kernels_api.h>
+#include <algorithm>
+
+namespace cadence {
+namespace impl {
+namespace HiFi {
+namespace native {
+
+using ::executorch::aten::optional;
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::Tensor;
+using ::executorch::runtime::getLeadingDims;
+using ::executorch::runtime::KernelRuntimeContext;
+
+// The nnlib matmul kernels multiply a matrix with a set of vectors, i.e.,
+// compute X x Y' with Y in [out_dim, in_dim] layout. They take the zero points
+// as biases to add, and requantize with a Q31 multiplier and a left shift.
+WORD32 inline _nnlib_matmul(
+    uint8_t* __restrict__ z,
+    const uint8_t* __restrict__ x,
+    const uint8_t* __restrict__ y,
+    const int32_t* __restrict__ bias,
+    int32_t leading_dim,
+    int32_t in_dim,
+    int32_t out_dim,
+    int32_t X_zero_point,
+    int32_t Y_zero_point,
+    int32_t out_multiplier,
+    int32_t out_shift,
+    int32_t out_zero_point) {
+  return kernels::xa_nn_matmul_asym8uxasym8u_asym8u(
+      z, // p_out
+      y, // p_mat1,
+      x, // p_mat2,
+      bias, // p_bias
+      out_dim, // rows of p_mat1
+      in_dim, // cols of p_mat1
+      in_dim, // row_stride of p_mat1
+      leading_dim, // vec_count, i.e., rows of p_mat2
+      in_dim, // vec_offset of p_mat2.
+      out_dim, // out_offset, i.e., offset of next output element written
+      1, // out_stride, i.e., stride to go to next output row
+      -Y_zero_point, // mat1_zero_bias
+      -X_zero_point, // mat2_zero_bias
+      out_multiplier, // out_multiplier
+      out_shift, // out_shift
+      out_zero_point); // out_zero_bias
+}
+
+WORD32 inline _nnlib_matmul(
+    int8_t* __restrict__ z,
+    const int8_t* __restrict__ x,
+    const int8_t* __restrict__ y,
+    const int32_t* __restrict__ bias,
+    int32_t leading_dim,
+    int32_t in_dim,
+    int32_t out_dim,
+    int32_t X_zero_point,
+    int32_t Y_zero_point,
+    int32_t out_multiplier,
+    int32_t out_shift,
+    int32_t out_zero_point) {
+  return xa_nn_matmul_asym8sxasym8s_asym8s(
+      z, // p_out
+      y, // p_mat1,
+      x, // p_mat2,
+      bias, // p_bias
+      out_dim, // rows of p_mat1
+      in_dim, // cols of p_mat1
+      in_dim, // row_stride of p_mat1
+      leading_dim, // vec_count, i.e., rows of p_mat2
+      in_dim, // vec_offset of p_mat2.
+      out_dim, // out_offset, i.e., offset of next output element written
+      1, // out_stride, i.e., stride to go to next output row
+      -Y_zero_point, // mat1_zero_bias
+      -X_zero_point, // mat2_zero_bias
+      out_multiplier, // out_multiplier
+      out_shift, // out_shift
+      out_zero_point); // out_zero_bias
+}
+
+template <typename T>
+void inline _typed_quantized_matmul(
+    KernelRuntimeContext& ctx,
+    const Tensor& X,
+    int64_t X_zero_point,
+    const Tensor& Y,
+    int64_t Y_zero_point,
+    __ET_UNUSED const optional<Tensor>& bias,
+    int64_t out_multiplier,
+    int64_t out_shift,
+    int64_t out_zero_point,
+    bool transposed,
+    Tensor& out) {
+  size_t batch_size = getLeadingDims(X, X.dim() - 2);
+  size_t leading_dim = X.size(X.dim() - 2);
+  size_t out_dim = Y.size(Y.dim() - 1 - transposed);
+  size_t in_dim = X.size(X.dim() - 1);
+
+  T* __restrict__ out_data = out.mutable_data_ptr<T>();
+  const T* __restrict__ X_data = X.const_data_ptr<T>();
+  const T* __restrict__ Y_data = Y.const_data_ptr<T>();
+
+  // Like the reference kernel, the output is not biased. nnlib reads the bias
+  // vector, so hand it zeros.
+  auto zero_bias = ctx.allocate_temp(out_dim * sizeof(int32_t));
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      zero_bias.ok(),
+      MemoryAllocationFailed,
+      ,
+      "Failed to allocate the bias of quantized_matmul");
+  int32_t* bias_data = static_cast<int32_t*>(zero_bias.get());
+  std::fill(bias_data, bias_data + out_dim, 0);
+
+  // nnlib wants Y in [out_dim, in_dim] layout, so transpose Y into scratch
+  // memory if it comes in [in_dim, out_dim].
+  T* y_transposed = nullptr;
+  if (!transposed) {
+    auto scratch = ctx.allocate_temp(in_dim * out_dim * sizeof(T));
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        scratch.ok(),
+        MemoryAllocationFailed,
+        ,
+        "Failed to allocate the transposed input of quantized_matmul");
+    y_transposed = static_cast<T*>(scratch.get());
+  }
+
+  for (size_t i = 0; i < batch_size; ++i) {
+    const T* x = X_data + i * leading_dim * in_dim;
+    const T* y = Y_data + i * in_dim * out_dim;
+    T* z = out_data + i * leading_dim * out_dim;
+    if (!transposed) {
+      for (size_t k = 0; k < in_dim; ++k) {
+        for (size_t j = 0; j < out_dim; ++j) {
+          y_transposed[j * in_dim + k] = y[k * out_dim + j];
+        }
+      }
+      y = y_transposed;
+    }
+    WORD32 ret = _nnlib_matmul(
+        z,
+        x,
+        y,
+        bias_data,
+        leading_dim,
+        in_dim,
+        out_dim,
+        static_cast<int32_t>(X_zero_point),
+        static_cast<int32_t>(Y_zero_point),
+        static_cast<int32_t>(out_multiplier),
+        static_cast<int32_t>(out_shift),
+        static_cast<int32_t>(out_zero_point));
+    ET_DCHECK_MSG(ret == 0, "HiFi quantized::matmul failed");
+  }
+}
+
+void quantized_matmul_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& X,
+    int64_t X_zero_point,
+    const Tensor& Y,
+    int64_t Y_zero_point,
+    const optional<Tensor>& bias,
+    int64_t out_multiplier,
+    int64_t out_shift,
+    int64_t out_zero_point,
+    bool transposed,
+    Tensor& out) {
+  if (out.scalar_type() == ScalarType::Byte) {
+    _typed_quantized_matmul<uint8_t>(
+        ctx,
+        X,
+        X_zero_point,
+        Y,
+        Y_zero_point,
+        bias,
+        out_multiplier,
+        out_shift,
+        out_zero_point,
+        transposed,
+        out);
+  } else if (out.scalar_type() == ScalarType::Char) {
+    _typed_quantized_matmul<int8_t>(
+        ctx,
+        X,
+        X_zero_point,
+        Y,
+        Y_zero_point,
+        bias,
+        out_multiplier,
+        out_shift,
+        out_zero_point,
+        transposed,
+        out);
+  } else {
+    ET_CHECK_MSG(
+        false,
+        "Unhandled input dtype %hhd",
+        static_cast<int8_t>(X.scalar_type()));
+  }
+}
+
+}; // namespace native
+}; // namespace HiFi
+}; // namespace impl
+}; // namespace cadence
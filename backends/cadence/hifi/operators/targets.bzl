@@ -92,6 +92,48 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "quantized_conv_out",
+        srcs = [
+            "quantized_conv_out.cpp"
+        ],
+        exported_headers = ["operators.h"],
+        platforms = CXX,
+        deps = [
+            "//executorch/kernels/portable/cpu/util:all_deps",
+            "//executorch/kernels/portable/cpu/pattern:all_deps",
+            "//executorch/runtime/kernel:kernel_includes",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/backends/cadence/hifi/kernels:kernels",
+            "//executorch/backends/cadence/hifi/third-party/nnlib:nnlib-extensions"
+        ],
+        visibility = [
+            "//executorch/backends/cadence/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "quantized_matmul_out",
+        srcs = [
+            "quantized_matmul_out.cpp"
+        ],
+        exported_headers = ["operators.h"],
+        platforms = CXX,
+        deps = [
+            "//executorch/kernels/portable/cpu/util:all_deps",
+            "//executorch/kernels/portable/cpu/pattern:all_deps",
+            "//executorch/runtime/kernel:kernel_includes",
+            "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/backends/cadence/hifi/kernels:kernels",
+            "//executorch/backends/cadence/hifi/third-party/nnlib:nnlib-extensions"
+        ],
+        visibility = [
+            "//executorch/backends/cadence/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
     runtime.cxx_library(
         name = "op_add",
         srcs = [
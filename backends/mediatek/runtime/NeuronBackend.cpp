@@ -12,6 +12,7 @@
 #include "NeuronPayloadHeader.h"
 #include "api/NeuronAdapter.h"
 
+#include "executorch/runtime/core/device_allocator.h"
 #include "executorch/runtime/core/error.h"
 
 #include <algorithm>
@@ -106,8 +107,14 @@ Error NeuronExecuTorchDelegate::execute(
     return Error::InvalidState;
   };
 
+  // Inputs and outputs allocated from the Neuron allocator, either as the temp
+  // allocator or through the registered device allocator, are bound to the
+  // device by their AHardwareBuffer instead of being copied.
   auto allocator = dynamic_cast<torch::executor::neuron::BufferAllocator*>(
       context.get_temp_allocator());
+  if (allocator == nullptr) {
+    allocator = &GET_NEURON_ALLOCATOR;
+  }
   size_t inputCount = mInputSizes.size(), outputCount = mOutputSizes.size();
 
   for (int i = 0; i < inputCount; i++) {
@@ -116,7 +123,7 @@ Error NeuronExecuTorchDelegate::execute(
     if (IsCached</*isInput=*/true>(i, data_ptr)) {
       continue;
     };
-    auto unit = allocator != nullptr ? allocator->Find(data_ptr) : nullptr;
+    auto unit = allocator->Find(data_ptr);
     if (unit) {
       UpdateCache<true>(i, data_ptr);
       size_t offset = (char*)data_ptr - (char*)unit->GetAddress();
@@ -134,7 +141,7 @@ Error NeuronExecuTorchDelegate::execute(
     if (IsCached</*isInput=*/false>(output_index, data_ptr)) {
       continue;
     };
-    auto unit = allocator != nullptr ? allocator->Find(data_ptr) : nullptr;
+    auto unit = allocator->Find(data_ptr);
     if (unit) {
       UpdateCache</*isInput=*/false>(output_index, data_ptr);
       size_t offset = (char*)data_ptr - (char*)unit->GetAddress();
@@ -192,8 +199,35 @@ int NeuronExecuTorchDelegate::HintNeuronBackend(EValue** args) const {
 } // namespace executorch
 
 namespace {
+// Allocates AHardwareBuffer backed memory that the delegate binds to the APU
+// by its NeuronMemory instead of copying.
+class NeuronDeviceAllocator final
+    : public executorch::runtime::DeviceAllocator {
+ public:
+  void* allocate(size_t size, size_t alignment) override {
+    // AHardwareBuffer mappings are page aligned.
+    if (alignment > kPageSize) {
+      return nullptr;
+    }
+    return GET_NEURON_ALLOCATOR.Allocate(size);
+  }
+
+  void free(void* ptr) override {
+    GET_NEURON_ALLOCATOR.RemoveBuffer(ptr);
+  }
+
+ private:
+  static constexpr size_t kPageSize = 4096;
+};
+
 auto cls = executorch::backends::neuron::NeuronBackend();
 executorch::runtime::Backend backend{"NeuropilotBackend", &cls};
 static auto success_with_compiler =
     executorch::runtime::register_backend(backend);
+
+auto device_allocator = NeuronDeviceAllocator();
+static auto success_with_device_allocator =
+    executorch::runtime::register_device_allocator(
+        "NeuropilotBackend",
+        &device_allocator);
 } // namespace
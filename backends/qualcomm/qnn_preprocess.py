@@ -25,6 +25,7 @@ from executorch.exir.backend.backend_details import (
     CompileSpec,
     PreprocessResult,
 )
+from executorch.exir.backend.utils import DelegateMappingBuilder
 from executorch.exir.passes import PassManager
 from torch.export.exported_program import ExportedProgram
 
@@ -64,6 +65,9 @@ class QnnBackend(BackendDetails):
             edge_program, enable_tensor_dump=enable_tensor_dump
         )
         py_op_wrapper_list = []
+        # Maps the names of the QNN nodes, which the runtime profiles the nodes
+        # under, to the debug handles of the ops that they were built from.
+        delegate_mapping_builder = DelegateMappingBuilder()
         for node in pass_result.graph_module.graph.nodes:
             if node.op == "call_function":
                 logger.info(f"Visiting: {node}, {node.target.__name__}")
@@ -72,10 +76,16 @@ class QnnBackend(BackendDetails):
                         node, nodes_to_wrappers
                     )
                     if py_op_wrapper is not None:
-                        if isinstance(py_op_wrapper, List):
-                            py_op_wrapper_list.extend(py_op_wrapper)
-                        else:
-                            py_op_wrapper_list.append(py_op_wrapper)
+                        if not isinstance(py_op_wrapper, List):
+                            py_op_wrapper = [py_op_wrapper]
+                        py_op_wrapper_list.extend(py_op_wrapper)
+                        # Nodes inserted by the passes above have no debug handle.
+                        if node.meta.get("debug_handle") is not None:
+                            for wrapper in py_op_wrapper:
+                                delegate_mapping_builder.insert_delegate_mapping_entry(
+                                    nodes=node,
+                                    identifier=wrapper.GetOpWrapper().GetName(),
+                                )
                 else:
                     err_msg = (
                         f"For {node}, {node.op}:{node.target.__name__} "
@@ -109,8 +119,7 @@ class QnnBackend(BackendDetails):
         )
         assert len(qnn_context_binary) != 0, "Failed to generate Qnn context binary."
         qnn_manager.Destroy()
-        # For now, debug_handle_map is not used by QNN ExecuTorch
         return PreprocessResult(
             processed_bytes=bytes(qnn_context_binary),
-            debug_handle_map={},
+            debug_handle_map=delegate_mapping_builder.get_delegate_mapping(),
         )
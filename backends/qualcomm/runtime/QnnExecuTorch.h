@@ -65,6 +65,16 @@ void QnnExecuTorchAddCustomMemTensorInfo(const CustomMemTensorInfo& info);
 /// Free the allocated shared memory.
 void QnnExecuTorchFreeCustomMem(void* buffer_ptr);
 
+/// Vote for an HTP performance mode on behalf of every initialized delegate,
+/// in place of the performance mode of their compile specs. perf_mode takes
+/// the values of QnnExecuTorchHtpPerformanceMode in qc_compiler_spec.fbs, e.g.
+/// kHtpBurst while generating and kHtpPowerSaver in between; kHtpDefault
+/// releases the vote. If idle_timeout_ms is not 0, the vote is released once
+/// no graph executed for that long, and made again at the next execution.
+void QnnExecuTorchSetHtpPerformanceMode(
+    int perf_mode,
+    uint32_t idle_timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -10,6 +10,8 @@
 #include <executorch/backends/qualcomm/qc_compiler_spec_generated.h>
 #include <executorch/backends/qualcomm/runtime/QnnExecuTorchBackend.h>
 #include <executorch/backends/qualcomm/runtime/QnnManager.h>
+#include <executorch/backends/qualcomm/runtime/SharedBuffer.h>
+#include <executorch/runtime/core/device_allocator.h>
 
 namespace executorch {
 namespace backends {
@@ -20,6 +22,7 @@ using executorch::runtime::ArrayRef;
 using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::BackendInitContext;
 using executorch::runtime::CompileSpec;
+using executorch::runtime::DelegateCompletionCallback;
 using executorch::runtime::DelegateHandle;
 using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
@@ -48,29 +51,32 @@ Result<DelegateHandle*> QnnExecuTorchBackend::init(
       QNN_EXECUTORCH_LOG_WARN("unknown argument: %s", compile_spec.key);
   }
 
-  // Create QnnManager
-  MemoryAllocator* runtime_allocator = context.get_runtime_allocator();
-  QnnManager* qnn_manager =
-      ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(runtime_allocator, QnnManager);
-
-  // NOTE: Since we use placement new and since this type is not trivially
-  // destructible, we must call the destructor manually in destroy().
-  new (qnn_manager) QnnManager(qnn_executorch_options, qnn_context_blob);
-
   // TODO: this is a temporal solution for multi-graph support, will be
   //       removed once framework starts to accept runtime configuration
   // ---
   // check if current context binary has already been initialized
-  // return cached one for reducing memory footprint
-  std::string signature = qnn_manager->GetBinarySignature();
-  auto iter = delegate_map_.find(signature);
-  if (iter != delegate_map_.end()) {
+  // return cached one for reducing memory footprint. With multiple_graphs,
+  // the graphs of every method share one context and its weights, so the
+  // copy of the context binary in this delegate is not loaded at all.
+  std::string signature = QnnManager::GetBinarySignature(qnn_context_blob);
+  DelegateHandle* cached_handle = acquire_cached_delegate(signature);
+  if (cached_handle != nullptr) {
     QNN_EXECUTORCH_LOG_INFO(
         "Use cached delegate handle for current method: %s",
         context.get_method_name());
-    return iter->second;
+    processed->Free();
+    return cached_handle;
   }
 
+  // Create QnnManager
+  MemoryAllocator* runtime_allocator = context.get_runtime_allocator();
+  QnnManager* qnn_manager =
+      ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(runtime_allocator, QnnManager);
+
+  // NOTE: Since we use placement new and since this type is not trivially
+  // destructible, we must call the destructor manually in destroy().
+  new (qnn_manager) QnnManager(qnn_executorch_options, qnn_context_blob);
+
   ET_CHECK_OR_RETURN_ERROR(
       qnn_manager->Init() == Error::Ok,
       Internal,
@@ -95,23 +101,19 @@ Result<DelegateHandle*> QnnExecuTorchBackend::init(
   return qnn_manager;
 }
 
-Error QnnExecuTorchBackend::execute(
-    BackendExecutionContext& context,
-    DelegateHandle* handle,
-    EValue** args) const {
-  ET_CHECK_OR_RETURN_ERROR(
-      delegate_map_rev_.count(handle) != 0,
-      Internal,
-      "DelegateHandle has been deleted");
-  QnnManager* qnn_manager = static_cast<QnnManager*>(handle);
-
-  std::string method_name = context.get_method_name();
+namespace {
+// Points the tensors of the graph at the memory of the arguments, and returns
+// the tensor structs to execute the graph with.
+void prepare_tensor_structs(
+    QnnManager* qnn_manager,
+    const std::string& method_name,
+    EValue** args,
+    std::vector<Qnn_Tensor_t>& input_tensor_structs,
+    std::vector<Qnn_Tensor_t>& output_tensor_structs) {
   std::vector<std::shared_ptr<TensorWrapper>> input_tensors =
       qnn_manager->GetGraphInputs(method_name);
   std::vector<std::shared_ptr<TensorWrapper>> output_tensors =
       qnn_manager->GetGraphOutputs(method_name);
-  std::vector<Qnn_Tensor_t> input_tensor_structs;
-  std::vector<Qnn_Tensor_t> output_tensor_structs;
 
   input_tensor_structs.reserve(input_tensors.size());
   for (int i = 0; i < input_tensors.size(); ++i) {
@@ -139,6 +141,28 @@ Error QnnExecuTorchBackend::execute(
     }
     output_tensor_structs.push_back(output_tensor->CloneTensorStruct());
   }
+}
+} // namespace
+
+Error QnnExecuTorchBackend::execute(
+    BackendExecutionContext& context,
+    DelegateHandle* handle,
+    EValue** args) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      delegate_map_rev_.count(handle) != 0,
+      Internal,
+      "DelegateHandle has been deleted");
+  QnnManager* qnn_manager = static_cast<QnnManager*>(handle);
+
+  std::string method_name = context.get_method_name();
+  std::vector<Qnn_Tensor_t> input_tensor_structs;
+  std::vector<Qnn_Tensor_t> output_tensor_structs;
+  prepare_tensor_structs(
+      qnn_manager,
+      method_name,
+      args,
+      input_tensor_structs,
+      output_tensor_structs);
 
   ET_CHECK_OR_RETURN_ERROR(
       qnn_manager->Execute(
@@ -157,11 +181,44 @@ Error QnnExecuTorchBackend::execute(
   return Error::Ok;
 }
 
+Error QnnExecuTorchBackend::execute_async(
+    BackendExecutionContext& context,
+    DelegateHandle* handle,
+    EValue** args,
+    DelegateCompletionCallback callback,
+    void* callback_context) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      delegate_map_rev_.count(handle) != 0,
+      Internal,
+      "DelegateHandle has been deleted");
+  QnnManager* qnn_manager = static_cast<QnnManager*>(handle);
+
+  std::string method_name = context.get_method_name();
+  std::vector<Qnn_Tensor_t> input_tensor_structs;
+  std::vector<Qnn_Tensor_t> output_tensor_structs;
+  prepare_tensor_structs(
+      qnn_manager,
+      method_name,
+      args,
+      input_tensor_structs,
+      output_tensor_structs);
+
+  // NotSupported makes the runtime fall back to execute(), which registers
+  // the same memory again at no cost.
+  return qnn_manager->ExecuteAsync(
+      method_name,
+      std::move(input_tensor_structs),
+      std::move(output_tensor_structs),
+      callback,
+      callback_context);
+}
+
 void QnnExecuTorchBackend::destroy(DelegateHandle* handle) const {
-  if (handle != nullptr && delegate_map_rev_.count(handle)) {
+  // The methods that share a context release it one by one, and only the
+  // last one destroys it.
+  if (handle != nullptr && erase_cached_delegate(handle)) {
     QnnManager* qnn_manager = static_cast<QnnManager*>(handle);
     qnn_manager->Destroy();
-    erase_cached_delegate(handle);
   }
 }
 
@@ -169,30 +226,122 @@ bool QnnExecuTorchBackend::is_available() const {
   return true;
 }
 
+Error QnnExecuTorchBackend::set_htp_performance_mode(
+    QnnExecuTorchHtpPerformanceMode perf_mode,
+    uint32_t idle_timeout_ms) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  Error ret = Error::Ok;
+  for (const auto& entry : delegate_map_rev_) {
+    QnnManager* qnn_manager = static_cast<QnnManager*>(entry.first);
+    Error error =
+        qnn_manager->SetHtpPerformanceMode(perf_mode, idle_timeout_ms);
+    if (error != Error::Ok) {
+      ret = error;
+    }
+  }
+  return ret;
+}
+
 void QnnExecuTorchBackend::add_cached_delegate(
     const std::string& signature,
     executorch::runtime::DelegateHandle* handle) const {
   std::lock_guard<std::mutex> guard(mutex_);
-  delegate_map_[signature] = handle;
+  // Context binaries without a signature can not be told apart, so they are
+  // never shared
+  if (!signature.empty()) {
+    delegate_map_[signature] = handle;
+  }
   delegate_map_rev_[handle] = signature;
+  delegate_ref_count_[handle] = 1;
+}
+
+executorch::runtime::DelegateHandle*
+QnnExecuTorchBackend::acquire_cached_delegate(
+    const std::string& signature) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto iter = delegate_map_.find(signature);
+  if (iter == delegate_map_.end()) {
+    return nullptr;
+  }
+  delegate_ref_count_[iter->second]++;
+  return iter->second;
 }
 
-void QnnExecuTorchBackend::erase_cached_delegate(
+bool QnnExecuTorchBackend::erase_cached_delegate(
     executorch::runtime::DelegateHandle* handle) const {
   std::lock_guard<std::mutex> guard(mutex_);
   auto iter = delegate_map_rev_.find(handle);
   if (iter == delegate_map_rev_.end()) {
-    return;
+    return false;
+  }
+  if (--delegate_ref_count_[handle] > 0) {
+    return false;
   }
-  delegate_map_.erase(iter->second);
-  delegate_map_rev_.erase(handle);
+  if (!iter->second.empty()) {
+    delegate_map_.erase(iter->second);
+  }
+  delegate_map_rev_.erase(iter);
+  delegate_ref_count_.erase(handle);
+  return true;
 }
 
 namespace {
+// Allocates the rpcmem buffers that QnnManager registers with the HTP backend
+// instead of copying, when the delegate was compiled with shared buffers.
+class QnnDeviceAllocator final : public executorch::runtime::DeviceAllocator {
+ public:
+  void* allocate(size_t size, size_t alignment) override {
+    return SharedBuffer::GetSharedBufferManager().AllocMem(size, alignment);
+  }
+
+  void free(void* ptr) override {
+    SharedBuffer::GetSharedBufferManager().FreeMem(ptr);
+  }
+
+  Result<int> get_fd(void* ptr) override {
+    int32_t mem_fd = SharedBuffer::GetSharedBufferManager().MemToFd(ptr);
+    if (mem_fd == -1) {
+      return executorch::runtime::Error::NotSupported;
+    }
+    return mem_fd;
+  }
+};
+
 auto cls = QnnExecuTorchBackend();
 executorch::runtime::Backend backend{"QnnBackend", &cls};
 static auto success_with_compiler = register_backend(backend);
+
+auto device_allocator = QnnDeviceAllocator();
+static auto success_with_device_allocator =
+    executorch::runtime::register_device_allocator(
+        "QnnBackend",
+        &device_allocator);
 } // namespace
 } // namespace qnn
 } // namespace backends
 } // namespace executorch
+
+void QnnExecuTorchSetHtpPerformanceMode(
+    int perf_mode,
+    uint32_t idle_timeout_ms) {
+  using qnn_delegate::QnnExecuTorchHtpPerformanceMode;
+  if (perf_mode < static_cast<int>(QnnExecuTorchHtpPerformanceMode::MIN) ||
+      perf_mode > static_cast<int>(QnnExecuTorchHtpPerformanceMode::MAX)) {
+    QNN_EXECUTORCH_LOG_ERROR("Unknown HTP performance mode: %d", perf_mode);
+    return;
+  }
+  auto* backend = static_cast<executorch::backends::qnn::QnnExecuTorchBackend*>(
+      executorch::runtime::get_backend_class("QnnBackend"));
+  if (backend == nullptr) {
+    QNN_EXECUTORCH_LOG_ERROR("QnnBackend is not registered");
+    return;
+  }
+  if (backend->set_htp_performance_mode(
+          static_cast<QnnExecuTorchHtpPerformanceMode>(perf_mode),
+          idle_timeout_ms) != executorch::runtime::Error::Ok) {
+    QNN_EXECUTORCH_LOG_WARN(
+        "Failed to vote for HTP performance mode %s on some delegates",
+        qnn_delegate::EnumNameQnnExecuTorchHtpPerformanceMode(
+            static_cast<QnnExecuTorchHtpPerformanceMode>(perf_mode)));
+  }
+}
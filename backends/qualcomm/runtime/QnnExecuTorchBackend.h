@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <executorch/backends/qualcomm/qc_compiler_spec_generated.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
@@ -34,21 +35,44 @@ class QnnExecuTorchBackend final
       executorch::runtime::DelegateHandle* handle,
       executorch::runtime::EValue** args) const override;
 
+  // Queues the graph on the backend with graphExecuteAsync, so that the caller
+  // can prepare the next execution while the accelerator runs this one.
+  executorch::runtime::Error execute_async(
+      executorch::runtime::BackendExecutionContext& context,
+      executorch::runtime::DelegateHandle* handle,
+      executorch::runtime::EValue** args,
+      executorch::runtime::DelegateCompletionCallback callback,
+      void* callback_context) const override;
+
   void destroy(executorch::runtime::DelegateHandle* handle) const override;
 
   bool is_available() const override;
 
+  // Votes for the HTP performance mode of every initialized delegate; see
+  // QnnExecuTorchSetHtpPerformanceMode().
+  executorch::runtime::Error set_htp_performance_mode(
+      qnn_delegate::QnnExecuTorchHtpPerformanceMode perf_mode,
+      uint32_t idle_timeout_ms) const;
+
  private:
   void add_cached_delegate(
       const std::string& signature,
       executorch::runtime::DelegateHandle* handle) const;
-  void erase_cached_delegate(executorch::runtime::DelegateHandle* handle) const;
+  // Returns the delegate initialized with the context binary of the signature,
+  // if any, and counts one more method that uses it.
+  executorch::runtime::DelegateHandle* acquire_cached_delegate(
+      const std::string& signature) const;
+  // Counts one less method that uses the delegate. Returns true if none does
+  // anymore, in which case the delegate is no longer cached.
+  bool erase_cached_delegate(executorch::runtime::DelegateHandle* handle) const;
 
   mutable std::mutex mutex_;
   mutable std::unordered_map<std::string, executorch::runtime::DelegateHandle*>
       delegate_map_;
   mutable std::unordered_map<executorch::runtime::DelegateHandle*, std::string>
       delegate_map_rev_;
+  mutable std::unordered_map<executorch::runtime::DelegateHandle*, size_t>
+      delegate_ref_count_;
 };
 
 } // namespace qnn
@@ -385,8 +385,15 @@ Error QnnManager::Execute(
     executorch::runtime::EventTracer* event_tracer) {
   Qnn_ErrorHandle_t error = QNN_SUCCESS;
 
+  QnnDevice* qnn_device = backend_params_ptr_->qnn_device_ptr_.get();
+  if (qnn_device != nullptr) {
+    qnn_device->BeginExecution();
+  }
   error = backend_params_ptr_->qnn_graph_ptr_->GraphExecute(
       graph_name, input_tensor_structs, output_tensor_structs);
+  if (qnn_device != nullptr) {
+    qnn_device->EndExecution();
+  }
 
   if (error != QNN_SUCCESS) {
     QNN_EXECUTORCH_LOG_ERROR(
@@ -422,6 +429,79 @@ Error QnnManager::Execute(
   return Error::Ok;
 }
 
+namespace {
+// Owns what an asynchronous execution needs until QNN notifies its completion
+struct AsyncExecution {
+  std::vector<Qnn_Tensor_t> input_tensor_structs;
+  std::vector<Qnn_Tensor_t> output_tensor_structs;
+  QnnDevice* qnn_device;
+  executorch::runtime::DelegateCompletionCallback callback;
+  void* callback_context;
+};
+
+void NotifyAsyncExecution(void* notify_param, Qnn_NotifyStatus_t status) {
+  std::unique_ptr<AsyncExecution> execution(
+      static_cast<AsyncExecution*>(notify_param));
+  if (execution->qnn_device != nullptr) {
+    execution->qnn_device->EndExecution();
+  }
+  Error error = Error::Ok;
+  if (status.error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG_ERROR(
+        "qnn_graph_execute_async failed. Error %d",
+        QNN_GET_ERROR_CODE(status.error));
+    error = Error::Internal;
+  }
+  execution->callback(execution->callback_context, error);
+}
+} // namespace
+
+Error QnnManager::ExecuteAsync(
+    const std::string& graph_name,
+    std::vector<Qnn_Tensor_t> input_tensor_structs,
+    std::vector<Qnn_Tensor_t> output_tensor_structs,
+    executorch::runtime::DelegateCompletionCallback callback,
+    void* callback_context) {
+  if (IsTensorDump() ||
+      options_->profile_level() != QnnExecuTorchProfileLevel::kProfileOff ||
+      !qnn_loaded_backend_.GetQnnInterface().HasGraphExecuteAsync()) {
+    return Error::NotSupported;
+  }
+
+  QnnDevice* qnn_device = backend_params_ptr_->qnn_device_ptr_.get();
+  auto* execution = new AsyncExecution{
+      std::move(input_tensor_structs),
+      std::move(output_tensor_structs),
+      qnn_device,
+      callback,
+      callback_context};
+  if (qnn_device != nullptr) {
+    qnn_device->BeginExecution();
+  }
+  // On success the notify function takes ownership of `execution`, and may
+  // already have run by the time GraphExecuteAsync() returns.
+  Qnn_ErrorHandle_t error =
+      backend_params_ptr_->qnn_graph_ptr_->GraphExecuteAsync(
+          graph_name,
+          execution->input_tensor_structs,
+          execution->output_tensor_structs,
+          NotifyAsyncExecution,
+          execution);
+  if (error != QNN_SUCCESS) {
+    if (qnn_device != nullptr) {
+      qnn_device->EndExecution();
+    }
+    delete execution;
+    if (QNN_GET_ERROR_CODE(error) == QNN_GRAPH_ERROR_UNSUPPORTED_FEATURE) {
+      return Error::NotSupported;
+    }
+    QNN_EXECUTORCH_LOG_ERROR(
+        "qnn_graph_execute_async failed. Error %d", QNN_GET_ERROR_CODE(error));
+    return Error::Internal;
+  }
+  return Error::Ok;
+}
+
 Error QnnManager::ProfileExecuteData(
     const std::string& graph_name,
     executorch::runtime::EventTracer* event_tracer) {
@@ -438,6 +518,16 @@ Error QnnManager::ProfileExecuteData(
   return Error::Ok;
 }
 
+Error QnnManager::SetHtpPerformanceMode(
+    QnnExecuTorchHtpPerformanceMode perf_mode,
+    uint32_t idle_timeout_ms) {
+  if (backend_params_ptr_->qnn_device_ptr_ == nullptr) {
+    return Error::InvalidState;
+  }
+  return backend_params_ptr_->qnn_device_ptr_->SetPerformanceMode(
+      perf_mode, idle_timeout_ms);
+}
+
 void QnnManager::Destroy() {
   QNN_EXECUTORCH_LOG_INFO("Destroy Qnn backend parameters");
   backend_params_ptr_.reset(new BackendConfigParameters());
@@ -685,11 +775,16 @@ Error QnnManager::Compile(
 }
 
 std::string QnnManager::GetBinarySignature() {
+  return GetBinarySignature(qnn_context_blob_);
+}
+
+std::string QnnManager::GetBinarySignature(
+    const QnnExecuTorchContextBinary& qnn_context_blob) {
   flatbuffers::Verifier verifier(
-      static_cast<const uint8_t* const>(qnn_context_blob_.buffer),
-      qnn_context_blob_.nbytes);
+      static_cast<const uint8_t* const>(qnn_context_blob.buffer),
+      qnn_context_blob.nbytes);
   return VerifyBinaryInfoBuffer(verifier)
-      ? GetBinaryInfo(qnn_context_blob_.buffer)->signature()->str()
+      ? GetBinaryInfo(qnn_context_blob.buffer)->signature()->str()
       : "";
 }
 
@@ -13,6 +13,7 @@
 #include <executorch/backends/qualcomm/runtime/Logging.h>
 #include <executorch/backends/qualcomm/runtime/QnnExecuTorch.h>
 #include <executorch/backends/qualcomm/runtime/backends/QnnBackendFactory.h>
+#include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 
 #include <memory>
@@ -42,10 +43,28 @@ class QnnManager {
       std::vector<Qnn_Tensor_t>& output_tensor_structs,
       executorch::runtime::EventTracer* event_tracer);
 
+  // Starts an execution of the graph and returns without waiting for it to
+  // finish. On success, callback is called with callback_context from a QNN
+  // thread once the outputs are written. Returns NotSupported if the backend
+  // can not execute graphs asynchronously, or if profiling or tensor dump is
+  // enabled, since both read the results of the execution.
+  executorch::runtime::Error ExecuteAsync(
+      const std::string& graph_name,
+      std::vector<Qnn_Tensor_t> input_tensor_structs,
+      std::vector<Qnn_Tensor_t> output_tensor_structs,
+      executorch::runtime::DelegateCompletionCallback callback,
+      void* callback_context);
+
   executorch::runtime::Error ProfileExecuteData(
       const std::string& graph_name,
       executorch::runtime::EventTracer* event_tracer);
 
+  // Votes for the HTP performance mode of the device of this delegate; see
+  // QnnExecuTorchSetHtpPerformanceMode().
+  executorch::runtime::Error SetHtpPerformanceMode(
+      QnnExecuTorchHtpPerformanceMode perf_mode,
+      uint32_t idle_timeout_ms);
+
   void Destroy();
 
   bool IsAvailable() {
@@ -109,6 +128,11 @@ class QnnManager {
 
   std::string GetBinarySignature();
 
+  // Returns the signature that identifies the context binary in the blob, or
+  // an empty string if the blob does not hold one, e.g. for online prepare.
+  static std::string GetBinarySignature(
+      const QnnExecuTorchContextBinary& qnn_context_blob);
+
  private:
   executorch::runtime::Error LoadQnnLibrary();
 
@@ -33,6 +33,12 @@ class QnnBackend {
       QnnProfile_EventType_t /*event_type*/) {
     return false;
   }
+  // Whether an event of this type is the time that the accelerator took to
+  // execute the graph, which converts the cycles of its nodes into time.
+  virtual bool IsProfileEventTypeAccelTime(
+      QnnProfile_EventType_t /*event_type*/) {
+    return false;
+  }
 
   executorch::runtime::Error Configure();
 
@@ -31,6 +31,18 @@ class QnnDevice {
 
   executorch::runtime::Error Configure();
 
+  // Votes for the performance mode of the device from now on. Backends that
+  // can not vote for performance modes return Error::NotSupported.
+  virtual executorch::runtime::Error SetPerformanceMode(
+      QnnExecuTorchHtpPerformanceMode perf_mode,
+      uint32_t idle_timeout_ms) {
+    return executorch::runtime::Error::NotSupported;
+  }
+
+  // Called around each graph execution on the device
+  virtual void BeginExecution() {}
+  virtual void EndExecution() {}
+
  protected:
   virtual executorch::runtime::Error MakeConfig(
       std::vector<const QnnDevice_Config_t*>& config) {
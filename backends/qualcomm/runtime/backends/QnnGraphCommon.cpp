@@ -89,6 +89,32 @@ Qnn_ErrorHandle_t QnnGraph::GraphExecute(
       /*signalHandle=*/nullptr);
 };
 
+Qnn_ErrorHandle_t QnnGraph::GraphExecuteAsync(
+    const std::string& graph_name,
+    const std::vector<Qnn_Tensor_t>& input_tensor_structs,
+    std::vector<Qnn_Tensor_t>& output_tensor_structs,
+    Qnn_NotifyFn_t notify_fn,
+    void* notify_param) {
+  if (!handle_.count(graph_name)) {
+    QNN_EXECUTORCH_LOG_ERROR(
+        "graph name: %s does not exist.", graph_name.c_str());
+    return QNN_COMMON_ERROR_GENERAL;
+  }
+
+  // The profile of an execution is only complete once it is notified, so
+  // asynchronous executions are not profiled.
+  return implementation_.GetQnnInterface().qnn_graph_execute_async(
+      handle_[graph_name],
+      input_tensor_structs.data(),
+      input_tensor_structs.size(),
+      output_tensor_structs.data(),
+      output_tensor_structs.size(),
+      /*profileHandle=*/nullptr,
+      /*signalHandle=*/nullptr,
+      notify_fn,
+      notify_param);
+};
+
 Error QnnGraph::EnsureTensorInQnnGraph(
     const std::string& graph_name,
     const std::shared_ptr<TensorWrapper>& tensor_wrapper) {
@@ -41,6 +41,16 @@ class QnnGraph {
       const std::vector<Qnn_Tensor_t>& input_tensor_structs,
       std::vector<Qnn_Tensor_t>& output_tensor_structs);
 
+  // Queues an execution of the graph and returns without waiting for it. The
+  // backend calls notify_fn with notify_param once the outputs are ready, and
+  // the tensor structs must stay valid until then.
+  Qnn_ErrorHandle_t GraphExecuteAsync(
+      const std::string& graph_name,
+      const std::vector<Qnn_Tensor_t>& input_tensor_structs,
+      std::vector<Qnn_Tensor_t>& output_tensor_structs,
+      Qnn_NotifyFn_t notify_fn,
+      void* notify_param);
+
   Qnn_ErrorHandle_t GraphAddNode(
       const std::string& graph_name,
       const Qnn_OpConfig_t& op_config) {
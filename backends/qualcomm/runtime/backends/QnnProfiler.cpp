@@ -7,6 +7,7 @@
  */
 
 #include <executorch/backends/qualcomm/runtime/backends/QnnProfiler.h>
+#include <executorch/runtime/platform/platform.h>
 
 namespace executorch {
 namespace backends {
@@ -84,6 +85,9 @@ Qnn_ErrorHandle_t QnnProfile::ProfileData(
         "ProfileData failed to get events: %d", QNN_GET_ERROR_CODE(error));
     return error;
   }
+  std::vector<NodeTime> node_times;
+  std::uint64_t accel_cycles = 0;
+  std::uint64_t accel_us = 0;
   QnnProfile_EventData_t event_data;
   for (std::uint32_t i = 0; i < num_events; ++i) {
     error =
@@ -96,9 +100,16 @@ Qnn_ErrorHandle_t QnnProfile::ProfileData(
           QNN_GET_ERROR_CODE(error));
       return error;
     }
+    if (backend_->IsProfileEventTypeAccelTime(event_data.type) &&
+        event_data.unit == QNN_PROFILE_EVENTUNIT_MICROSEC) {
+      accel_us = event_data.value;
+    }
     // Check an event's sub events only if it relates to graph execution time
     // (and its sub events are the individual op executions):
     if (backend_->IsProfileEventTypeParentOfNodeTime(event_data.type)) {
+      if (event_data.unit == QNN_PROFILE_EVENTUNIT_CYCLES) {
+        accel_cycles = event_data.value;
+      }
       error = qnn_interface.qnn_profile_get_sub_events(
           events_ptr[i], &sub_events_ptr, &num_sub_events);
       if (error != QNN_SUCCESS) {
@@ -125,20 +136,82 @@ Qnn_ErrorHandle_t QnnProfile::ProfileData(
         if (sub_event_data.type == QNN_PROFILE_EVENTTYPE_NODE &&
             (sub_event_data.unit == QNN_PROFILE_EVENTUNIT_MICROSEC ||
              sub_event_data.unit == QNN_PROFILE_EVENTUNIT_CYCLES)) {
-          executorch::runtime::event_tracer_log_profiling_delegate(
-              event_tracer,
-              sub_event_data.identifier,
-              /*delegate_debug_id=*/
-              static_cast<executorch::runtime::DebugHandle>(-1),
-              0,
-              sub_event_data.value);
+          node_times.push_back(
+              {GetNodeName(sub_event_data.identifier),
+               sub_event_data.value,
+               sub_event_data.unit});
         }
       }
     }
   }
+  LogNodeTimes(event_tracer, node_times, accel_cycles, accel_us);
   return error;
 }
 
+std::string QnnProfile::GetNodeName(const char* identifier) {
+  // The backend may append the op id and the unit to the name of the node,
+  // e.g. "aten_add_tensor:OpId_12 (cycles)".
+  std::string name(identifier);
+  size_t end = name.find(":OpId_");
+  if (end == std::string::npos) {
+    end = name.find(" (");
+  }
+  return name.substr(0, end);
+}
+
+void QnnProfile::LogNodeTimes(
+    executorch::runtime::EventTracer* event_tracer,
+    const std::vector<NodeTime>& node_times,
+    std::uint64_t accel_cycles,
+    std::uint64_t accel_us) {
+  // Convert from microseconds (QNN) to PAL ticks (ET). Cycles are converted
+  // at the rate at which the accelerator ran the whole graph, if the backend
+  // reports it.
+  auto tick_ns_conv_multiplier = et_pal_ticks_to_ns_multiplier();
+  const double ticks_per_us = 1000.0 * tick_ns_conv_multiplier.denominator /
+      tick_ns_conv_multiplier.numerator;
+  const double ticks_per_cycle = accel_cycles > 0
+      ? ticks_per_us * static_cast<double>(accel_us) / accel_cycles
+      : 0;
+
+  std::vector<et_timestamp_t> durations;
+  durations.reserve(node_times.size());
+  et_timestamp_t total = 0;
+  for (const auto& node_time : node_times) {
+    const double ticks = node_time.unit == QNN_PROFILE_EVENTUNIT_CYCLES
+        ? node_time.value * ticks_per_cycle
+        : node_time.value * ticks_per_us;
+    durations.push_back(static_cast<et_timestamp_t>(ticks));
+    total += durations.back();
+  }
+
+  // The nodes ran one after another, and the graph finished executing just
+  // before its profile is read.
+  const et_timestamp_t now = et_pal_current_ticks();
+  et_timestamp_t time = now > total ? now - total : 0;
+  std::string metadata;
+  for (size_t i = 0; i < node_times.size(); ++i) {
+    // Cycle counts are exact where their conversion to time is not, so they
+    // are kept as the metadata of the event.
+    metadata.clear();
+    if (node_times[i].unit == QNN_PROFILE_EVENTUNIT_CYCLES) {
+      metadata = "{\"cycles\": " + std::to_string(node_times[i].value) + "}";
+    }
+    // Named after the node, which the delegate mapping of the program ties to
+    // the debug handles of the ops that it was built from.
+    executorch::runtime::event_tracer_log_profiling_delegate(
+        event_tracer,
+        node_times[i].name.c_str(),
+        /*delegate_debug_id=*/
+        static_cast<executorch::runtime::DebugHandle>(-1),
+        time,
+        time + durations[i],
+        metadata.empty() ? nullptr : metadata.data(),
+        metadata.size());
+    time += durations[i];
+  }
+}
+
 QnnProfile::~QnnProfile() {
   const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
   if (handle_ != nullptr) {
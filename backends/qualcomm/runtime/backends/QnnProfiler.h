@@ -12,6 +12,11 @@
 #include <executorch/backends/qualcomm/runtime/backends/QnnImplementation.h>
 #include <executorch/runtime/core/event_tracer_hooks_delegate.h>
 #include "QnnProfile.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace executorch {
 namespace backends {
 namespace qnn {
@@ -30,6 +35,22 @@ class QnnProfile {
   }
 
  private:
+  // The time that one node of the graph took to execute.
+  struct NodeTime {
+    std::string name;
+    std::uint64_t value;
+    QnnProfile_EventUnit_t unit;
+  };
+
+  static std::string GetNodeName(const char* identifier);
+  // Logs the node times as delegate profiling events, laid out one after
+  // another, with the cycle counts of the nodes as their metadata.
+  static void LogNodeTimes(
+      executorch::runtime::EventTracer* event_tracer,
+      const std::vector<NodeTime>& node_times,
+      std::uint64_t accel_cycles,
+      std::uint64_t accel_us);
+
   Qnn_ProfileHandle_t handle_;
   const QnnImplementation& implementation_;
   QnnBackend* backend_;
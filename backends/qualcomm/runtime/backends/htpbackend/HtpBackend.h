@@ -26,6 +26,12 @@ class HtpBackend : public QnnBackend {
         event_type == QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_ACCEL_TIME_CYCLE);
   }
 
+  bool IsProfileEventTypeAccelTime(QnnProfile_EventType_t event_type) override {
+    return (
+        event_type ==
+        QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_ACCEL_TIME_MICROSEC);
+  }
+
   Qnn_Version_t GetExpectedBackendVersion() const override {
     Qnn_Version_t backend_version;
     backend_version.major = QNN_HTP_API_VERSION_MAJOR;
@@ -282,6 +282,14 @@ std::vector<QnnHtpPerfInfrastructure_PowerConfig_t> SetRpcPollingPowerConfig(
 } // namespace
 
 HtpDevice::~HtpDevice() {
+  if (relax_thread_.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(perf_vote_mutex_);
+      stop_relax_thread_ = true;
+    }
+    relax_cv_.notify_all();
+    relax_thread_.join();
+  }
   if (htp_perf_infra_ != nullptr && powerconfig_client_id_ != 0 &&
       !down_vote_power_configs_ptr_.empty()) {
     htp_perf_infra_->setPowerConfig(
@@ -360,65 +368,80 @@ Error HtpDevice::MakeConfig(std::vector<const QnnDevice_Config_t*>& config) {
   return Error::Ok;
 }
 
+Error HtpDevice::CreatePowerConfigId() {
+  if (htp_perf_infra_ != nullptr && powerconfig_client_id_ != 0) {
+    return Error::Ok;
+  }
+  const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
+  Qnn_ErrorHandle_t error = QNN_SUCCESS;
+
+  // Get htp_perf_infra
+  htp_perf_infra_ = &owned_htp_perf_infra_;
+  if (GetPerfInfra(qnn_interface, htp_perf_infra_) != Error::Ok) {
+    htp_perf_infra_ = nullptr;
+    return Error::Internal;
+  }
+
+  // Get power client id
+  error = htp_perf_infra_->createPowerConfigId(
+      /*device_id=*/0, /*core_id=*/0, &powerconfig_client_id_);
+
+  if (error != QNN_SUCCESS) {
+    QNN_EXECUTORCH_LOG_ERROR(
+        "HTP backend unable to create "
+        "power config. Error %d",
+        QNN_GET_ERROR_CODE(error));
+    htp_perf_infra_ = nullptr;
+    return Error::Internal;
+  }
+
+  down_vote_power_configs_ = SetVotePowerConfig(
+      powerconfig_client_id_,
+      QnnExecuTorchHtpPerformanceMode::kHtpDefault,
+      PerformanceModeVoteType::kDownVote);
+  down_vote_power_configs_ptr_ =
+      ObtainNullTermPtrVector(down_vote_power_configs_);
+
+  return Error::Ok;
+}
+
+void HtpDevice::SetPowerConfigs(QnnExecuTorchHtpPerformanceMode perf_mode) {
+  // Set vector of PowerConfigs and map it to a vector of pointers.
+  perf_power_configs_ = SetVotePowerConfig(
+      powerconfig_client_id_, perf_mode, PerformanceModeVoteType::kUpVote);
+  perf_power_configs_ptr_ = ObtainNullTermPtrVector(perf_power_configs_);
+
+  rpc_power_configs_ = SetRpcPollingPowerConfig(perf_mode);
+  rpc_power_configs_ptr_ = ObtainNullTermPtrVector(rpc_power_configs_);
+}
+
 void HtpDevice::PerformanceVote() {
   if (IsPerfModeEnabled()) {
     htp_perf_infra_->setPowerConfig(
         powerconfig_client_id_, perf_power_configs_ptr_.data());
+    is_voted_ = true;
   }
 };
 
 void HtpDevice::ReleasePerformanceVote() {
-  if (IsPerfModeEnabled()) {
+  if (is_voted_) {
     htp_perf_infra_->setPowerConfig(
         powerconfig_client_id_, down_vote_power_configs_ptr_.data());
+    is_voted_ = false;
   }
 };
 
 Error HtpDevice::AfterCreateDevice() {
   if (IsPerfModeEnabled()) {
-    const QnnInterface& qnn_interface = implementation_.GetQnnInterface();
-    Qnn_ErrorHandle_t error = QNN_SUCCESS;
-
-    // Get htp_perf_infra
-    htp_perf_infra_ = &owned_htp_perf_infra_;
-    if (GetPerfInfra(qnn_interface, htp_perf_infra_) != Error::Ok) {
+    if (CreatePowerConfigId() != Error::Ok) {
       return Error::Internal;
     }
-
-    // Get power client id
-    error = htp_perf_infra_->createPowerConfigId(
-        /*device_id=*/0, /*core_id=*/0, &powerconfig_client_id_);
-
-    if (error != QNN_SUCCESS) {
-      QNN_EXECUTORCH_LOG_ERROR(
-          "HTP backend unable to create "
-          "power config. Error %d",
-          QNN_GET_ERROR_CODE(error));
-      return Error::Internal;
-    }
-
-    // Set vector of PowerConfigs and map it to a vector of pointers.
-    perf_power_configs_ = SetVotePowerConfig(
-        powerconfig_client_id_,
-        htp_options_->performance_mode(),
-        PerformanceModeVoteType::kUpVote);
-    perf_power_configs_ptr_ = ObtainNullTermPtrVector(perf_power_configs_);
-
-    down_vote_power_configs_ = SetVotePowerConfig(
-        powerconfig_client_id_,
-        QnnExecuTorchHtpPerformanceMode::kHtpDefault,
-        PerformanceModeVoteType::kDownVote);
-    down_vote_power_configs_ptr_ =
-        ObtainNullTermPtrVector(down_vote_power_configs_);
+    SetPowerConfigs(perf_mode_);
 
     // vote immediately
     PerformanceVote();
 
     // Set Rpc polling mode
-    rpc_power_configs_ =
-        SetRpcPollingPowerConfig(htp_options_->performance_mode());
-    rpc_power_configs_ptr_ = ObtainNullTermPtrVector(rpc_power_configs_);
-
     htp_perf_infra_->setPowerConfig(
         powerconfig_client_id_, rpc_power_configs_ptr_.data());
   }
@@ -426,6 +449,80 @@ Error HtpDevice::AfterCreateDevice() {
   return Error::Ok;
 }
 
+Error HtpDevice::SetPerformanceMode(
+    QnnExecuTorchHtpPerformanceMode perf_mode,
+    uint32_t idle_timeout_ms) {
+  std::unique_lock<std::mutex> lock(perf_vote_mutex_);
+
+  if (perf_mode == QnnExecuTorchHtpPerformanceMode::kHtpDefault) {
+    ReleasePerformanceVote();
+    perf_mode_ = perf_mode;
+    idle_timeout_ms_ = idle_timeout_ms;
+    return Error::Ok;
+  }
+
+  if (CreatePowerConfigId() != Error::Ok) {
+    return Error::Internal;
+  }
+  perf_mode_ = perf_mode;
+  idle_timeout_ms_ = idle_timeout_ms;
+  SetPowerConfigs(perf_mode_);
+
+  // Vote right away, so that the first execution of a session already runs
+  // at the clocks of the mode
+  PerformanceVote();
+  htp_perf_infra_->setPowerConfig(
+      powerconfig_client_id_, rpc_power_configs_ptr_.data());
+
+  if (idle_timeout_ms_ != 0) {
+    last_execution_end_ = std::chrono::steady_clock::now();
+    if (!relax_thread_.joinable()) {
+      relax_thread_ = std::thread(&HtpDevice::RelaxAfterIdleTimeout, this);
+    }
+    lock.unlock();
+    relax_cv_.notify_all();
+  }
+  return Error::Ok;
+}
+
+void HtpDevice::BeginExecution() {
+  std::lock_guard<std::mutex> lock(perf_vote_mutex_);
+  ++num_executions_;
+  // Votes again if the vote was released after an idle timeout
+  if (!is_voted_) {
+    PerformanceVote();
+  }
+}
+
+void HtpDevice::EndExecution() {
+  {
+    std::lock_guard<std::mutex> lock(perf_vote_mutex_);
+    --num_executions_;
+    last_execution_end_ = std::chrono::steady_clock::now();
+  }
+  relax_cv_.notify_all();
+}
+
+void HtpDevice::RelaxAfterIdleTimeout() {
+  std::unique_lock<std::mutex> lock(perf_vote_mutex_);
+  while (!stop_relax_thread_) {
+    if (!is_voted_ || idle_timeout_ms_ == 0 || num_executions_ != 0) {
+      // Nothing to release until a vote with an idle timeout, or until the
+      // running executions end
+      relax_cv_.wait(lock);
+      continue;
+    }
+    const auto deadline = last_execution_end_ +
+        std::chrono::milliseconds(idle_timeout_ms_);
+    if (std::chrono::steady_clock::now() >= deadline) {
+      ReleasePerformanceVote();
+      continue;
+    }
+    // Wakes up early whenever an execution ends, which moves the deadline
+    relax_cv_.wait_until(lock, deadline);
+  }
+}
+
 } // namespace qnn
 } // namespace backends
 } // namespace executorch
@@ -10,7 +10,11 @@
 #include <executorch/backends/qualcomm/runtime/backends/QnnDeviceCommon.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDeviceCustomConfig.h>
 #include <executorch/backends/qualcomm/runtime/backends/htpbackend/HtpDevicePlatformInfoConfig.h>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include "HTP/QnnHtpDevice.h"
 
@@ -29,7 +33,8 @@ class HtpDevice : public QnnDevice {
       const QnnExecuTorchHtpBackendOptions* htp_options)
       : QnnDevice(implementation, logger),
         qcom_target_soc_info_(soc_info),
-        htp_options_(htp_options) {
+        htp_options_(htp_options),
+        perf_mode_(htp_options->performance_mode()) {
     htp_device_platform_info_config_ =
         std::make_unique<HtpDevicePlatformInfoConfig>(htp_options);
     htp_device_custom_config_ =
@@ -44,6 +49,19 @@ class HtpDevice : public QnnDevice {
     kDownVote = 2,
   };
 
+  // Votes for perf_mode instead of the performance mode of the compile spec.
+  // If idle_timeout_ms is 0, the vote holds until the mode changes again, as
+  // the vote of the compile spec does. Otherwise it is released once no graph
+  // executed for idle_timeout_ms, and made again at the next execution, so
+  // that the HTP only runs at high clocks while it is busy. kHtpDefault
+  // releases the vote.
+  executorch::runtime::Error SetPerformanceMode(
+      QnnExecuTorchHtpPerformanceMode perf_mode,
+      uint32_t idle_timeout_ms) override;
+
+  void BeginExecution() override;
+  void EndExecution() override;
+
  protected:
   executorch::runtime::Error MakeConfig(
       std::vector<const QnnDevice_Config_t*>& config) override;
@@ -51,12 +69,16 @@ class HtpDevice : public QnnDevice {
   executorch::runtime::Error AfterCreateDevice() override;
 
  private:
+  executorch::runtime::Error CreatePowerConfigId();
+  // Sets the power configs of the votes for the performance mode
+  void SetPowerConfigs(QnnExecuTorchHtpPerformanceMode perf_mode);
   void PerformanceVote();
   void ReleasePerformanceVote();
+  // Releases the vote once the device is idle for idle_timeout_ms_
+  void RelaxAfterIdleTimeout();
 
   inline bool IsPerfModeEnabled() {
-    return htp_options_->performance_mode() !=
-        QnnExecuTorchHtpPerformanceMode::kHtpDefault;
+    return perf_mode_ != QnnExecuTorchHtpPerformanceMode::kHtpDefault;
   }
 
   template <typename T>
@@ -91,6 +113,18 @@ class HtpDevice : public QnnDevice {
 
   const SocInfo* qcom_target_soc_info_;
   const QnnExecuTorchHtpBackendOptions* htp_options_;
+
+  // Guards the performance vote, which executions and SetPerformanceMode()
+  // may change from different threads
+  std::mutex perf_vote_mutex_;
+  QnnExecuTorchHtpPerformanceMode perf_mode_;
+  uint32_t idle_timeout_ms_{0};
+  bool is_voted_{false};
+  uint32_t num_executions_{0};
+  std::chrono::steady_clock::time_point last_execution_end_;
+  std::condition_variable relax_cv_;
+  std::thread relax_thread_;
+  bool stop_relax_thread_{false};
 };
 } // namespace qnn
 } // namespace backends
@@ -4,10 +4,11 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
+import json
 import operator
 import warnings
 from collections import OrderedDict
-from typing import Callable, Dict, FrozenSet, List, Tuple
+from typing import Any, Callable, Dict, FrozenSet, List, Tuple
 
 import executorch.backends.qualcomm.python.PyQnnManagerAdaptor as PyQnnManagerAdaptor
 
@@ -885,6 +886,9 @@ def generate_qnn_executorch_compiler_spec(
         profile: Enable profile the performance of per operator.
             Note that for now only support kProfileDetailed to
             profile the performance of each operator with cycle unit.
+            The operators are logged to ETDump as delegate events, tied to
+            the ops they were built from, with their cycle counts as metadata
+            (see parse_qnn_delegate_metadata).
         shared_buffer: Enables usage of shared buffer between application
             and backend for graph I/O.
         is_from_context_binary: True if current graph comes from pre-built context binary.
@@ -988,3 +992,25 @@ def tag_quant_io(gm: torch.fx.GraphModule, get_quant_io_dtype_fn: Callable):
     for node in gm.graph.nodes:
         if dtype := get_quant_io_dtype_fn(node):
             node.meta[QCOM_QUANTIZED_IO] = dtype
+
+
+def parse_qnn_delegate_metadata(delegate_metadatas: List[str]) -> Dict[str, Any]:
+    """
+    Delegate metadata parser for the Inspector, which reads the cycle counts of the
+    QNN operators profiled with generate_qnn_executorch_compiler_spec(profile=True):
+
+        Inspector(..., delegate_metadata_parser=parse_qnn_delegate_metadata)
+
+    Returns:
+        {"cycles": average cycle count of the operator over the runs}, or {} if the
+        backend reported no cycle counts.
+    """
+    cycles = []
+    for metadata in delegate_metadatas:
+        try:
+            cycles.append(json.loads(metadata)["cycles"])
+        except (ValueError, KeyError, TypeError):
+            continue
+    if len(cycles) == 0:
+        return {}
+    return {"cycles": sum(cycles) / len(cycles)}
@@ -21,12 +21,17 @@
 #endif // ET_EVENT_TRACER_ENABLED
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/platform/compiler.h>
+#ifdef ET_EVENT_TRACER_ENABLED
+#include <executorch/runtime/platform/platform.h>
+#endif // ET_EVENT_TRACER_ENABLED
 #include <executorch/runtime/platform/profiler.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib> /* strtol */
 #include <cstring>
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -140,6 +145,18 @@ GraphConfig get_graph_config(ArrayRef<CompileSpec>& compile_specs) {
 
       config.set_memory_layout_override(memory_layout);
     }
+    if (strcmp(spec.key, "indirect_dispatch") == 0) {
+      ET_CHECK_MSG(value_size == sizeof(uint8_t), "Unexpected value size!");
+      config.enable_indirect_dispatch = value_data[0] != 0;
+    }
+    if (strcmp(spec.key, "memory_aliasing") == 0) {
+      ET_CHECK_MSG(value_size == sizeof(uint8_t), "Unexpected value size!");
+      config.enable_memory_aliasing = value_data[0] != 0;
+    }
+    if (strcmp(spec.key, "tune_local_wg_sizes") == 0) {
+      ET_CHECK_MSG(value_size == sizeof(uint8_t), "Unexpected value size!");
+      config.enable_local_wg_size_tuning = value_data[0] != 0;
+    }
   }
 #ifdef ET_EVENT_TRACER_ENABLED
   config.enable_querypool = true;
@@ -461,6 +478,69 @@ void maybe_resize_output(
   ET_CHECK_MSG(err == Error::Ok, "Failed to resize output tensor.");
 }
 
+#ifdef ET_EVENT_TRACER_ENABLED
+std::string stringize_wg_size(const VkExtent3D& wg_size) {
+  return "[" + std::to_string(wg_size.width) + ", " +
+      std::to_string(wg_size.height) + ", " + std::to_string(wg_size.depth) +
+      "]";
+}
+
+/*
+ * Logs the GPU execution time of every shader dispatch of the last execution
+ * as a delegate profiling event. GPU timestamps do not share a time base with
+ * the CPU, so the events are placed on the CPU timeline relative to
+ * submit_time, which is when the execution was submitted. Each event carries
+ * the work group sizes of its dispatch as JSON metadata.
+ */
+void log_shader_durations(
+    runtime::EventTracer* event_tracer,
+    ComputeGraph* compute_graph,
+    const et_timestamp_t submit_time) {
+  if (event_tracer == nullptr) {
+    return;
+  }
+
+  vkapi::QueryPool& querypool = compute_graph->context()->querypool();
+  querypool.extract_results();
+  const std::vector<vkapi::ShaderDuration> shader_durations =
+      querypool.get_shader_durations();
+  if (shader_durations.empty()) {
+    return;
+  }
+
+  const et_tick_ratio_t ticks_to_ns = et_pal_ticks_to_ns_multiplier();
+  const auto ns_to_ticks = [&](const uint64_t ns) {
+    return static_cast<et_timestamp_t>(
+        ns * ticks_to_ns.denominator / ticks_to_ns.numerator);
+  };
+
+  uint64_t first_start_time_ns = shader_durations.front().start_time_ns;
+  for (const vkapi::ShaderDuration& entry : shader_durations) {
+    first_start_time_ns = std::min(first_start_time_ns, entry.start_time_ns);
+  }
+
+  for (const vkapi::ShaderDuration& entry : shader_durations) {
+    const std::string event_name =
+        entry.kernel_name + "_" + std::to_string(entry.dispatch_id);
+    const std::string metadata = "{\"global_wg_size\": " +
+        stringize_wg_size(entry.global_workgroup_size) +
+        ", \"local_wg_size\": " +
+        stringize_wg_size(entry.local_workgroup_size) + "}";
+
+    const et_timestamp_t start_time =
+        submit_time + ns_to_ticks(entry.start_time_ns - first_start_time_ns);
+    event_tracer_log_profiling_delegate(
+        event_tracer,
+        event_name.c_str(),
+        /*delegate_debug_id=*/static_cast<runtime::DebugHandle>(-1),
+        start_time,
+        start_time + ns_to_ticks(entry.execution_duration_ns),
+        metadata.data(),
+        metadata.size());
+  }
+}
+#endif // ET_EVENT_TRACER_ENABLED
+
 //
 // VulkanBackend class
 //
@@ -579,6 +659,9 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
     if (should_propagate_resize) {
       compute_graph->propagate_resize();
     }
+#ifdef ET_EVENT_TRACER_ENABLED
+    const et_timestamp_t submit_time = et_pal_current_ticks();
+#endif // ET_EVENT_TRACER_ENABLED
     compute_graph->execute();
 
     for (size_t i = 0; i < compute_graph->outputs().size(); i++) {
@@ -600,19 +683,7 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
     }
 
 #ifdef ET_EVENT_TRACER_ENABLED
-    runtime::EventTracer* event_tracer = context.event_tracer();
-    compute_graph->context()->querypool().extract_results();
-    for (const auto& tup :
-         compute_graph->context()->querypool().get_shader_timestamp_data()) {
-      std::string event_name =
-          std::get<0>(tup) + "_" + std::to_string(std::get<1>(tup));
-      event_tracer_log_profiling_delegate(
-          event_tracer,
-          event_name.c_str(),
-          -1,
-          std::get<2>(tup),
-          std::get<3>(tup));
-    }
+    log_shader_durations(context.event_tracer(), compute_graph, submit_time);
 #endif // ET_EVENT_TRACER_ENABLED
 
     return Error::Ok;
@@ -625,6 +696,10 @@ class VulkanBackend final : public ::executorch::runtime::BackendInterface {
           ->adapter_ptr()
           ->compute_pipeline_cache()
           .save_cache();
+      compute_graph->context()
+          ->adapter_ptr()
+          ->local_wg_size_cache()
+          .save_cache();
       // ComputeGraph is not trivially destructible. Since
       // this was constructed manually in init(), we must destroy it manually
       // here.
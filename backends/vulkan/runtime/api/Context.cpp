@@ -115,13 +115,11 @@ vkapi::DescriptorSet Context::get_descriptor_set(
       shader_layout, shader_descriptor.kernel_layout);
 }
 
-void Context::register_shader_dispatch(
-    const vkapi::DescriptorSet& descriptors,
-    vkapi::PipelineBarrier& pipeline_barrier,
+namespace {
+
+utils::uvec3 effective_global_wg_size(
     const vkapi::ShaderInfo& shader_descriptor,
-    const utils::uvec3& global_workgroup_size,
-    const void* push_constants_data,
-    const uint32_t push_constants_size) {
+    const utils::uvec3& global_workgroup_size) {
   // Adjust the global workgroup size based on the output tile size
   uint32_t global_wg_w = utils::div_up(
       global_workgroup_size[0u], shader_descriptor.out_tile_size[0u]);
@@ -138,12 +136,31 @@ void Context::register_shader_dispatch(
     global_wg_d = 1u;
   }
 
-  const utils::uvec3 effective_global_wg = {
-      global_wg_w,
-      global_wg_h,
-      global_wg_d,
+  return {global_wg_w, global_wg_h, global_wg_d};
+}
+
+} // namespace
+
+utils::uvec3 Context::dispatch_group_counts(
+    const vkapi::ShaderInfo& shader_descriptor,
+    const utils::uvec3& global_workgroup_size,
+    const utils::uvec3& local_workgroup_size) {
+  const utils::uvec3 effective_global_wg =
+      effective_global_wg_size(shader_descriptor, global_workgroup_size);
+
+  return {
+      utils::div_up(effective_global_wg[0u], local_workgroup_size[0u]),
+      utils::div_up(effective_global_wg[1u], local_workgroup_size[1u]),
+      utils::div_up(effective_global_wg[2u], local_workgroup_size[2u]),
   };
+}
 
+void Context::prepare_shader_dispatch(
+    const vkapi::DescriptorSet& descriptors,
+    vkapi::PipelineBarrier& pipeline_barrier,
+    const vkapi::ShaderInfo& shader_descriptor,
+    const void* push_constants_data,
+    const uint32_t push_constants_size) {
   cmd_.bind_descriptors(descriptors.get_bind_handle());
   cmd_.insert_barrier(pipeline_barrier);
 
@@ -155,10 +172,45 @@ void Context::register_shader_dispatch(
     cmd_.set_push_constants(
         pipeline_layout, push_constants_data, push_constants_size);
   }
+}
+
+void Context::register_shader_dispatch(
+    const vkapi::DescriptorSet& descriptors,
+    vkapi::PipelineBarrier& pipeline_barrier,
+    const vkapi::ShaderInfo& shader_descriptor,
+    const utils::uvec3& global_workgroup_size,
+    const void* push_constants_data,
+    const uint32_t push_constants_size) {
+  const utils::uvec3 effective_global_wg =
+      effective_global_wg_size(shader_descriptor, global_workgroup_size);
+
+  prepare_shader_dispatch(
+      descriptors,
+      pipeline_barrier,
+      shader_descriptor,
+      push_constants_data,
+      push_constants_size);
 
   cmd_.dispatch(effective_global_wg);
 }
 
+void Context::register_shader_dispatch_indirect(
+    const vkapi::DescriptorSet& descriptors,
+    vkapi::PipelineBarrier& pipeline_barrier,
+    const vkapi::ShaderInfo& shader_descriptor,
+    const vkapi::VulkanBuffer& indirect_buffer,
+    const void* push_constants_data,
+    const uint32_t push_constants_size) {
+  prepare_shader_dispatch(
+      descriptors,
+      pipeline_barrier,
+      shader_descriptor,
+      push_constants_data,
+      push_constants_size);
+
+  cmd_.dispatch_indirect(indirect_buffer);
+}
+
 void Context::register_blit(
     vkapi::PipelineBarrier& pipeline_barrier,
     vkapi::VulkanImage& src,
@@ -177,6 +229,15 @@ void Context::submit_cmd_to_gpu(VkFence fence_handle, const bool final_use) {
   }
 }
 
+void Context::submit_cmd_to_gpu(
+    vkapi::CommandBuffer& cmd,
+    VkFence fence_handle) {
+  VK_CHECK_COND(cmd, "Cannot submit a command buffer that was invalidated");
+  cmd.end();
+  adapter_p_->submit_cmd(
+      queue_, cmd.get_submit_handle(/*final_use = */ false), fence_handle);
+}
+
 void Context::flush() {
   VK_CHECK(vkQueueWaitIdle(queue()));
 
@@ -76,6 +76,14 @@ class Context final {
   // Misc
   VkImageTiling preferred_image_tiling_;
 
+  // Binds the descriptors, barriers and push constants of a dispatch
+  void prepare_shader_dispatch(
+      const vkapi::DescriptorSet&,
+      vkapi::PipelineBarrier&,
+      const vkapi::ShaderInfo&,
+      const void* push_constants_data,
+      const uint32_t push_constants_size);
+
  public:
   // Adapter access
 
@@ -204,6 +212,37 @@ class Context final {
       const void* = nullptr,
       const uint32_t = 0);
 
+  /*
+   * Like register_shader_dispatch(), but dispatches the workgroup counts that
+   * the indirect buffer holds when the command buffer is submitted, e.g. as
+   * computed by dispatch_group_counts() for the current tensor sizes.
+   */
+  void register_shader_dispatch_indirect(
+      const vkapi::DescriptorSet&,
+      vkapi::PipelineBarrier&,
+      const vkapi::ShaderInfo&,
+      const vkapi::VulkanBuffer& indirect_buffer,
+      const void* = nullptr,
+      const uint32_t = 0);
+
+  /*
+   * The number of workgroups that register_shader_dispatch() dispatches for a
+   * global and local workgroup size.
+   */
+  static utils::uvec3 dispatch_group_counts(
+      const vkapi::ShaderInfo&,
+      const utils::uvec3& global_workgroup_size,
+      const utils::uvec3& local_workgroup_size);
+
+  /*
+   * Orders all work recorded after this call after all compute and transfer
+   * work submitted before it, including earlier submissions of other command
+   * buffers.
+   */
+  inline void register_global_barrier() {
+    cmd_.insert_global_barrier();
+  }
+
   void register_blit(
       vkapi::PipelineBarrier&,
       vkapi::VulkanImage& src,
@@ -224,6 +263,18 @@ class Context final {
       VkFence fence_handle = VK_NULL_HANDLE,
       const bool final_use = false);
 
+  /*
+   * Moves the current command buffer out of the context, e.g. to keep several
+   * reusable command buffers encoded. Encoding continues in a new command
+   * buffer. The extracted command buffer is valid until the next flush().
+   */
+  inline vkapi::CommandBuffer extract_cmd() {
+    return std::move(cmd_);
+  }
+
+  // Submits a command buffer extracted with extract_cmd() for execution
+  void submit_cmd_to_gpu(vkapi::CommandBuffer& cmd, VkFence fence_handle);
+
   void flush();
 };
 
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/vulkan/runtime/api/containers/StagingBuffer.h>
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+namespace vkcompute {
+namespace api {
+
+namespace {
+
+inline float fp32_from_bits(const uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+inline uint32_t fp32_to_bits(const float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// IEEE fp32 to fp16 conversion with round to nearest even, which maps NaNs to
+// NaNs and out of range values to infinities.
+uint16_t fp16_from_fp32(const float f) {
+  const float scale_to_inf = fp32_from_bits(UINT32_C(0x77800000));
+  const float scale_to_zero = fp32_from_bits(UINT32_C(0x08800000));
+  float base = (std::abs(f) * scale_to_inf) * scale_to_zero;
+
+  const uint32_t w = fp32_to_bits(f);
+  const uint32_t shl1_w = w + w;
+  const uint32_t sign = w & UINT32_C(0x80000000);
+  uint32_t bias = shl1_w & UINT32_C(0xFF000000);
+  if (bias < UINT32_C(0x71000000)) {
+    bias = UINT32_C(0x71000000);
+  }
+
+  base = fp32_from_bits((bias >> 1) + UINT32_C(0x07800000)) + base;
+  const uint32_t bits = fp32_to_bits(base);
+  const uint32_t exp_bits = (bits >> 13) & UINT32_C(0x00007C00);
+  const uint32_t mantissa_bits = bits & UINT32_C(0x00000FFF);
+  const uint32_t nonsign = exp_bits + mantissa_bits;
+  return static_cast<uint16_t>(
+      (sign >> 16) |
+      (shl1_w > UINT32_C(0xFF000000) ? UINT16_C(0x7E00) : nonsign));
+}
+
+// IEEE fp16 to fp32 conversion, which is exact.
+float fp16_to_fp32(const uint16_t h) {
+  const uint32_t w = static_cast<uint32_t>(h) << 16;
+  const uint32_t sign = w & UINT32_C(0x80000000);
+  const uint32_t two_w = w + w;
+
+  // Normal values, with the exponent rebiased by a multiplication.
+  const uint32_t exp_offset = UINT32_C(0xE0) << 23;
+  const float exp_scale = fp32_from_bits(UINT32_C(0x7800000));
+  const float normalized_value =
+      fp32_from_bits((two_w >> 4) + exp_offset) * exp_scale;
+
+  // Denormal values, from the mantissa in the low bits of a float of 0.5.
+  const uint32_t magic_mask = UINT32_C(126) << 23;
+  const float magic_bias = 0.5f;
+  const float denormalized_value =
+      fp32_from_bits((two_w >> 17) | magic_mask) - magic_bias;
+
+  const uint32_t denormalized_cutoff = UINT32_C(1) << 27;
+  const uint32_t result = sign |
+      (two_w < denormalized_cutoff ? fp32_to_bits(denormalized_value)
+                                   : fp32_to_bits(normalized_value));
+  return fp32_from_bits(result);
+}
+
+void convert_fp32_to_fp16(const float* src, uint16_t* dst, const size_t n) {
+  size_t i = 0;
+#if defined(__aarch64__)
+  for (; i + 4 <= n; i += 4) {
+    const float16x4_t h = vcvt_f16_f32(vld1q_f32(src + i));
+    vst1_u16(dst + i, vreinterpret_u16_f16(h));
+  }
+#elif defined(__F16C__)
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h = _mm256_cvtps_ph(
+        _mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = fp16_from_fp32(src[i]);
+  }
+}
+
+void convert_fp16_to_fp32(const uint16_t* src, float* dst, const size_t n) {
+  size_t i = 0;
+#if defined(__aarch64__)
+  for (; i + 4 <= n; i += 4) {
+    const float16x4_t h = vreinterpret_f16_u16(vld1_u16(src + i));
+    vst1q_f32(dst + i, vcvt_f32_f16(h));
+  }
+#elif defined(__F16C__)
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = fp16_to_fp32(src[i]);
+  }
+}
+
+} // namespace
+
+void StagingBuffer::copy_from_float(const float* src, const size_t numel) {
+  if (dtype_ == vkapi::kFloat) {
+    copy_from(src, numel * sizeof(float));
+    return;
+  }
+  VK_CHECK_COND(
+      dtype_ == vkapi::kHalf,
+      "Only fp32 and fp16 staging buffers can be written from fp32 data");
+  VK_CHECK_COND(numel <= this->numel());
+  convert_fp32_to_fp16(src, static_cast<uint16_t*>(data()), numel);
+  vmaFlushAllocation(
+      vulkan_buffer_.vma_allocator(),
+      vulkan_buffer_.allocation(),
+      0u,
+      VK_WHOLE_SIZE);
+}
+
+void StagingBuffer::copy_to_float(float* dst, const size_t numel) {
+  if (dtype_ == vkapi::kFloat) {
+    copy_to(dst, numel * sizeof(float));
+    return;
+  }
+  VK_CHECK_COND(
+      dtype_ == vkapi::kHalf,
+      "Only fp32 and fp16 staging buffers can be read as fp32 data");
+  VK_CHECK_COND(numel <= this->numel());
+  vmaInvalidateAllocation(
+      vulkan_buffer_.vma_allocator(),
+      vulkan_buffer_.allocation(),
+      0u,
+      VK_WHOLE_SIZE);
+  convert_fp16_to_fp32(static_cast<const uint16_t*>(data()), dst, numel);
+}
+
+} // namespace api
+} // namespace vkcompute
@@ -91,6 +91,19 @@ class StagingBuffer final {
     memcpy(dst, data(), nbytes);
   }
 
+  /*
+   * Writes `numel` fp32 values into the staging buffer, converting them to
+   * fp16 on the host if the staging buffer is fp16. This halves the data that
+   * is uploaded for fp16 tensors compared to staging the fp32 data.
+   */
+  void copy_from_float(const float* src, const size_t numel);
+
+  /*
+   * Reads `numel` values of the staging buffer as fp32 values, converting them
+   * from fp16 on the host if the staging buffer is fp16.
+   */
+  void copy_to_float(float* dst, const size_t numel);
+
   inline void set_staging_zeros() {
     memset(data(), 0, nbytes());
   }
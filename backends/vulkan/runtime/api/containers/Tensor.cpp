@@ -754,6 +754,9 @@ void vTensor::bind_allocation(const vkapi::Allocation& allocation) {
       storage_.image_.bind_allocation(allocation);
       break;
   }
+  // Other tensors may have used the memory before, so make the first access
+  // wait for compute shaders as if the storage had been written to.
+  storage_.last_access_ = {vkapi::PipelineStage::COMPUTE, vkapi::kWrite};
 }
 
 void vTensor::update_metadata() {
@@ -791,6 +791,7 @@ class ShaderInfo:
     weight_storage_type: str = ""
     bias_storage_type: str = ""
     register_for: Optional[Tuple[str, List[str]]] = None
+    fixed_local_wg_size: bool = False
 
 
 def getName(filePath: str) -> str:
@@ -875,6 +876,21 @@ def determineDescriptorType(lineStr: str) -> str:
     )
 
 
+def usesLocalWorkGroup(lineStr: str) -> bool:
+    # Shaders that share memory or otherwise cooperate within a work group, or
+    # that index with anything but gl_GlobalInvocationID, are only correct with
+    # the local work group size they are dispatched with.
+    code = lineStr.split("//")[0]
+    if re.match(r"^\s*\*", code) or re.match(r"^\s*/\*", code):
+        return False
+    local_wg_id = (
+        r"^\s*shared\b|\bbarrier\(|\bsubgroup[A-Za-z]*\(|"
+        r"\bgl_(LocalInvocationID|LocalInvocationIndex|WorkGroupID|"
+        r"NumWorkGroups|WorkGroupSize|SubgroupID|SubgroupInvocationID)\b"
+    )
+    return re.search(local_wg_id, code) is not None
+
+
 def getShaderInfo(srcFilePath: str) -> ShaderInfo:
     shader_info = ShaderInfo([], [], "")
     with open(srcFilePath) as srcFile:
@@ -889,6 +905,8 @@ def getShaderInfo(srcFilePath: str) -> ShaderInfo:
                 shader_info.bias_storage_type = getBiasStorageType(line)
             if isRegisterForLine(line):
                 shader_info.register_for = findRegisterFor(line)
+            if usesLocalWorkGroup(line):
+                shader_info.fixed_local_wg_size = True
 
     return shader_info
 
@@ -958,6 +976,7 @@ def generateShaderInfoStr(shader_info: ShaderInfo, name: str, sizeBytes: int) ->
         str(sizeBytes),
         shader_info_layouts,
         tile_size,
+        "true" if shader_info.fixed_local_wg_size else "false",
     ]
 
     shader_info_str = textwrap.indent(
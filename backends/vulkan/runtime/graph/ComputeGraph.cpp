@@ -15,6 +15,9 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/utils/StagingUtils.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace vkcompute {
 
 //
@@ -130,7 +133,11 @@ ComputeGraph::ComputeGraph(GraphConfig config)
       prepack_nodes_{},
       execute_nodes_{},
       inputs_{},
-      outputs_{} {
+      outputs_{},
+      pipelined_staging_{},
+      spare_staging_{},
+      pipelined_cmds_{},
+      pipelined_fences_{} {
   // Ensure that descriptor counts are initialized to 0
   prepack_descriptor_counts_.descriptor_pool_max_sets = 0;
   prepack_descriptor_counts_.descriptor_uniform_buffer_count = 0;
@@ -149,6 +156,7 @@ ComputeGraph::ComputeGraph(GraphConfig config)
 
 ComputeGraph::~ComputeGraph() {
   values_.clear();
+  spare_staging_.clear();
 
   prepack_nodes_.clear();
   execute_nodes_.clear();
@@ -240,14 +248,19 @@ ValueRef ComputeGraph::add_tensor(
     const utils::StorageType storage_type,
     const utils::GPUMemoryLayout memory_layout,
     const int64_t shared_object_idx) {
-  bool allocate_memory = shared_object_idx < 0;
+  const bool alias_memory = shared_object_idx < 0 &&
+      config_.enable_memory_aliasing && !memory_aliasing_planned_;
+  bool allocate_memory = shared_object_idx < 0 && !alias_memory;
 
   ValueRef idx(static_cast<int>(values_.size()));
   check_no_active_value_ptrs();
   values_.emplace_back(api::vTensor(
       context(), sizes, dtype, storage_type, memory_layout, allocate_memory));
 
-  if (!allocate_memory) {
+  if (alias_memory) {
+    aliasing_candidates_.emplace_back(idx);
+    aliasing_roots_.emplace(idx, idx);
+  } else if (!allocate_memory) {
     get_shared_object(shared_object_idx).add_user(this, idx);
   }
   return idx;
@@ -313,6 +326,11 @@ ValueRef ComputeGraph::add_tensor_view(const ValueRef vref) {
       sobj.add_user(this, idx);
     }
   }
+  const auto root = aliasing_roots_.find(vref);
+  if (root != aliasing_roots_.end()) {
+    const ValueRef root_ref = root->second;
+    aliasing_roots_.emplace(idx, root_ref);
+  }
   return idx;
 }
 
@@ -329,6 +347,11 @@ ValueRef ComputeGraph::add_tensor_view(
       sobj.add_user(this, idx);
     }
   }
+  const auto root = aliasing_roots_.find(vref);
+  if (root != aliasing_roots_.end()) {
+    const ValueRef root_ref = root->second;
+    aliasing_roots_.emplace(idx, root_ref);
+  }
   return idx;
 }
 
@@ -381,15 +404,22 @@ ValueRef ComputeGraph::add_symint(const int32_t val) {
 
 ValueRef ComputeGraph::set_input_tensor(
     const ValueRef idx,
-    const bool use_staging) {
+    const bool use_staging,
+    const vkapi::ScalarType staging_dtype) {
   if (use_staging) {
-    vkapi::ScalarType dtype = get_tensor(idx)->dtype();
+    vkapi::ScalarType dtype = staging_dtype != vkapi::ScalarType::Undefined
+        ? staging_dtype
+        : get_tensor(idx)->dtype();
     // For texture storage, the buffer size needs to account for the zero
     // padding applied by unused texel elements.
     size_t buf_numel = get_tensor(idx)->staging_buffer_numel();
     ValueRef staging_idx = add_staging(dtype, buf_numel);
     add_staging_to_tensor_node(*this, staging_idx, idx);
     inputs_.push_back({idx, staging_idx});
+    if (config_.enable_pipelined_execution) {
+      pipelined_staging_.push_back(staging_idx);
+      spare_staging_.emplace_back(context(), dtype, buf_numel);
+    }
     return staging_idx;
   }
   inputs_.push_back({idx, kDummyValueRef});
@@ -412,6 +442,10 @@ ValueRef ComputeGraph::set_output_tensor(
       add_tensor_to_staging_node(*this, idx, staging_idx);
     }
     outputs_.push_back({idx, staging_idx});
+    if (config_.enable_pipelined_execution) {
+      pipelined_staging_.push_back(staging_idx);
+      spare_staging_.emplace_back(context(), dtype, buf_numel);
+    }
     return staging_idx;
   }
   outputs_.push_back({idx, kDummyValueRef});
@@ -548,12 +582,174 @@ void ComputeGraph::copy_from_staging(
   staging->copy_to(data, nbytes);
 }
 
+void ComputeGraph::copy_float_into_staging(
+    const ValueRef idx,
+    const float* data,
+    const size_t numel) {
+  get_staging(idx)->copy_from_float(data, numel);
+}
+
+void ComputeGraph::copy_float_from_staging(
+    const ValueRef idx,
+    float* data,
+    const size_t numel) {
+  get_staging(idx)->copy_to_float(data, numel);
+}
+
+namespace {
+
+constexpr size_t kNotAccessed = std::numeric_limits<size_t>::max();
+
+// The range of execute nodes over which the memory of a tensor holds its data
+struct TensorLifetime {
+  size_t first = kNotAccessed;
+  size_t last = 0u;
+
+  bool overlaps(const TensorLifetime& other) const {
+    return first <= other.last && other.first <= last;
+  }
+};
+
+} // namespace
+
+void ComputeGraph::plan_memory_aliasing() {
+  memory_aliasing_planned_ = true;
+
+  std::unordered_map<ValueRef, TensorLifetime> lifetimes;
+  const auto lifetime_of = [&](const ValueRef ref) -> TensorLifetime* {
+    const auto root = aliasing_roots_.find(ref);
+    if (root == aliasing_roots_.end()) {
+      return nullptr;
+    }
+    return &lifetimes[root->second];
+  };
+
+  // A tensor is live from the first execute node that accesses it or any of
+  // its views, to the last one
+  for (size_t i = 0; i < execute_nodes_.size(); ++i) {
+    for (const ArgGroup& arg : execute_nodes_[i]->args_) {
+      for (const ValueRef ref : arg.refs) {
+        TensorLifetime* const lifetime = lifetime_of(ref);
+        if (lifetime != nullptr) {
+          lifetime->first = std::min(lifetime->first, i);
+          lifetime->last = std::max(lifetime->last, i);
+        }
+      }
+    }
+  }
+
+  // Inputs, outputs and prepacked tensors hold data outside of the execute
+  // nodes, as may tensors that no execute node accesses, so they are live
+  // throughout and never share their memory.
+  const auto pin = [&](const ValueRef ref) {
+    TensorLifetime* const lifetime = lifetime_of(ref);
+    if (lifetime != nullptr) {
+      *lifetime = {0u, kNotAccessed};
+    }
+  };
+  for (const IOValueRef& input : inputs_) {
+    pin(input.value);
+  }
+  for (const IOValueRef& output : outputs_) {
+    pin(output.value);
+  }
+  for (const std::unique_ptr<PrepackNode>& node : prepack_nodes_) {
+    pin(node->packed_);
+  }
+
+  std::unordered_map<ValueRef, VkMemoryRequirements> mem_reqs;
+  for (const ValueRef ref : aliasing_candidates_) {
+    mem_reqs[ref] = get_tensor(ref)->get_memory_requirements();
+    TensorLifetime& lifetime = lifetimes[ref];
+    if (lifetime.first == kNotAccessed) {
+      lifetime = {0u, kNotAccessed};
+    }
+  }
+
+  // Assign the largest tensors first, so that the size of each object is that
+  // of its first user, then let each tensor join the first object that none of
+  // whose users is live at the same time. Buffers and images are kept apart,
+  // which keeps linear and optimal resources out of each other's pages.
+  std::vector<ValueRef> order(aliasing_candidates_);
+  std::stable_sort(
+      order.begin(), order.end(), [&](const ValueRef a, const ValueRef b) {
+        return mem_reqs[a].size > mem_reqs[b].size;
+      });
+
+  std::vector<std::vector<TensorLifetime>> object_lifetimes;
+  std::vector<bool> object_is_buffer;
+  std::vector<uint32_t> object_memory_types;
+  std::unordered_map<ValueRef, size_t> object_of;
+  for (const ValueRef ref : order) {
+    const VkMemoryRequirements& reqs = mem_reqs[ref];
+    if (reqs.size == 0) {
+      continue;
+    }
+    const TensorLifetime& lifetime = lifetimes[ref];
+    const bool is_buffer = get_tensor(ref)->has_buffer_storage();
+
+    size_t obj_i = 0u;
+    for (; obj_i < aliased_objects_.size(); ++obj_i) {
+      if (object_is_buffer[obj_i] != is_buffer ||
+          (object_memory_types[obj_i] & reqs.memoryTypeBits) == 0u) {
+        continue;
+      }
+      const std::vector<TensorLifetime>& users = object_lifetimes[obj_i];
+      if (std::none_of(
+              users.begin(), users.end(), [&](const TensorLifetime& user) {
+                return user.overlaps(lifetime);
+              })) {
+        break;
+      }
+    }
+    if (obj_i == aliased_objects_.size()) {
+      aliased_objects_.emplace_back();
+      object_lifetimes.emplace_back();
+      object_is_buffer.push_back(is_buffer);
+      object_memory_types.push_back(reqs.memoryTypeBits);
+    }
+
+    aliased_objects_[obj_i].add_user(this, ref);
+    object_lifetimes[obj_i].push_back(lifetime);
+    object_memory_types[obj_i] &= reqs.memoryTypeBits;
+    object_of[ref] = obj_i;
+  }
+
+  // Views are bound after the tensors that own their memory
+  for (const auto& entry : aliasing_roots_) {
+    const auto obj = object_of.find(entry.second);
+    if (entry.first != entry.second && obj != object_of.end()) {
+      aliased_objects_[obj->second].add_user(this, entry.first);
+    }
+  }
+
+  for (size_t i = 0; i < aliased_objects_.size(); ++i) {
+    SharedObject& sobj = aliased_objects_[i];
+    // The memory must suit every user, not just any of them
+    sobj.aggregate_memory_requirements.memoryTypeBits = object_memory_types[i];
+    sobj.allocate(this);
+    sobj.bind_users(this);
+  }
+
+  aliasing_candidates_.clear();
+  aliasing_roots_.clear();
+}
+
 void ComputeGraph::prepare() {
-#define MERGE_FIELD(field)                    \
-  static_cast<uint32_t>(std::ceil(            \
-      std::max(                               \
-          execute_descriptor_counts_.field,   \
-          prepack_descriptor_counts_.field) * \
+  if (config_.enable_memory_aliasing && !memory_aliasing_planned_) {
+    // Before encode_prepack(), which writes to the prepacked tensors
+    plan_memory_aliasing();
+  }
+
+  // Pipelined execution encodes the execute nodes once per staging set
+  const uint32_t num_execute_encodes =
+      config_.enable_pipelined_execution ? 2u : 1u;
+
+#define MERGE_FIELD(field)                                       \
+  static_cast<uint32_t>(std::ceil(                               \
+      std::max(                                                  \
+          execute_descriptor_counts_.field * num_execute_encodes, \
+          prepack_descriptor_counts_.field) *                    \
       config_.descriptor_pool_safety_factor))
 
   uint32_t max_sets = MERGE_FIELD(descriptor_pool_max_sets);
@@ -571,7 +767,8 @@ void ComputeGraph::prepare() {
   }
 #undef MERGE_FIELD
 
-  if (config_.enable_querypool) {
+  // Local workgroup size tuning measures the dispatches with the query pool
+  if (config_.enable_querypool || config_.enable_local_wg_size_tuning) {
     context_->initialize_querypool();
   }
 }
@@ -587,30 +784,216 @@ void ComputeGraph::prepack() const {
   vkapi::VulkanFence fence = context_->fences().get_fence();
   context_->submit_cmd_to_gpu(fence.get_submit_handle(), /*final_use = */ true);
   fence.wait();
+  context_->fences().return_fence(fence);
 
   context_->flush();
 }
 
+void ComputeGraph::tune_local_wg_sizes() {
+  // The number of times that each candidate is measured; the fastest
+  // measurement is kept, which is less noisy than the mean
+  constexpr uint32_t kNumTuningIters = 3u;
+
+  std::vector<ExecuteNode*> nodes;
+  std::vector<std::vector<utils::uvec3>> candidates;
+  for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
+    std::vector<utils::uvec3> node_candidates =
+        node->local_wg_size_candidates(this);
+    if (node_candidates.size() == 1u) {
+      node->set_local_wg_size(this, node_candidates[0]);
+    } else if (node_candidates.size() > 1u) {
+      nodes.push_back(node.get());
+      candidates.push_back(std::move(node_candidates));
+    }
+  }
+
+  vkapi::QueryPool& querypool = context_->querypool();
+  vkapi::LocalWorkGroupSizeCache& wg_size_cache =
+      context_->adapter_ptr()->local_wg_size_cache();
+
+  // Each dispatch writes two timestamps to the query pool
+  const size_t batch_size = std::max<size_t>(
+      config_.context_config.query_pool_config.max_query_count / 2u, 1u);
+
+  // Batches of nodes are dispatched on their own, in the order of the graph,
+  // once for each candidate index. The tensors hold arbitrary data, which is
+  // fine since only the durations of the dispatches matter.
+  for (size_t batch_start = 0; batch_start < nodes.size();
+       batch_start += batch_size) {
+    const size_t batch_end = std::min(nodes.size(), batch_start + batch_size);
+
+    size_t num_candidates = 0u;
+    for (size_t i = batch_start; i < batch_end; ++i) {
+      num_candidates = std::max(num_candidates, candidates[i].size());
+    }
+
+    std::vector<uint64_t> best_ns(
+        batch_end - batch_start, std::numeric_limits<uint64_t>::max());
+    std::vector<size_t> best_candidate(batch_end - batch_start, 0u);
+    std::vector<vkapi::ShaderDuration> dispatches(batch_end - batch_start);
+
+    for (size_t c = 0; c < num_candidates; ++c) {
+      for (uint32_t iter = 0; iter < kNumTuningIters; ++iter) {
+        context_->set_cmd();
+        context_->cmd_reset_querypool();
+
+        std::vector<size_t> encoded;
+        for (size_t i = batch_start; i < batch_end; ++i) {
+          if (c < candidates[i].size()) {
+            nodes[i]->set_local_wg_size(this, candidates[i][c]);
+            nodes[i]->encode(this);
+            encoded.push_back(i - batch_start);
+          }
+        }
+
+        vkapi::VulkanFence fence = context_->fences().get_fence();
+        context_->submit_cmd_to_gpu(fence.get_submit_handle());
+        fence.wait();
+        context_->fences().return_fence(fence);
+
+        querypool.extract_results();
+        const std::vector<vkapi::ShaderDuration> durations =
+            querypool.get_shader_durations();
+        VK_CHECK_COND(
+            durations.size() == encoded.size(),
+            "Expected one measurement per tuned dispatch");
+
+        for (size_t d = 0; d < durations.size(); ++d) {
+          const size_t i = encoded[d];
+          if (durations[d].execution_duration_ns < best_ns[i]) {
+            best_ns[i] = durations[d].execution_duration_ns;
+            best_candidate[i] = c;
+          }
+          dispatches[i] = durations[d];
+        }
+
+        context_->flush();
+      }
+    }
+
+    for (size_t i = batch_start; i < batch_end; ++i) {
+      const size_t b = i - batch_start;
+      const utils::uvec3& local_wg_size = candidates[i][best_candidate[b]];
+      nodes[i]->set_local_wg_size(this, local_wg_size);
+
+      const VkExtent3D& global_wg_size = dispatches[b].global_workgroup_size;
+      wg_size_cache.insert(
+          dispatches[b].kernel_name,
+          {global_wg_size.width, global_wg_size.height, global_wg_size.depth},
+          local_wg_size);
+    }
+  }
+}
+
 void ComputeGraph::encode_execute() {
   context_->flush();
-  context_->set_cmd(/*reusable = */ true);
 
-  context_->cmd_reset_querypool();
+  if (config_.enable_pipelined_execution) {
+    VK_CHECK_COND(
+        !config_.enable_querypool,
+        "Pipelined execution does not support the query pool");
+    VK_CHECK_COND(
+        !config_.enable_local_wg_size_tuning,
+        "Pipelined execution does not support local workgroup size tuning");
+    // Flushing the context reset any command buffers encoded before
+    pipelined_cmds_.clear();
+    pipelined_pending_ = {};
+    if (staging_set_ != 0u) {
+      swap_staging_sets();
+      staging_set_ = 0u;
+    }
+  }
 
   for (SharedObject& shared_object : shared_objects_) {
     shared_object.allocate(this);
     shared_object.bind_users(this);
   }
 
-  for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
-    node->encode(this);
+  // Once the tensors have memory, so that the nodes can be dispatched
+  if (config_.enable_local_wg_size_tuning) {
+    tune_local_wg_sizes();
+  }
+
+  context_->set_cmd(/*reusable = */ true);
+
+  context_->cmd_reset_querypool();
+
+  if (!config_.enable_pipelined_execution) {
+    for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
+      node->encode(this);
+    }
+    return;
+  }
+
+  // Encode a command buffer for each staging set. Each one starts with a
+  // barrier, since it can be submitted while the other one still executes.
+  for (uint32_t staging_set = 0u; staging_set < 2u; ++staging_set) {
+    context_->set_cmd(/*reusable = */ true);
+    context_->register_global_barrier();
+    for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
+      node->encode(this);
+    }
+    pipelined_cmds_.push_back(context_->extract_cmd());
+    swap_staging_sets();
+  }
+
+  while (pipelined_fences_.size() < 2u) {
+    pipelined_fences_.push_back(context_->fences().get_fence());
   }
 }
 
 void ComputeGraph::execute() const {
+  // The command buffer encoded by encode_execute() is submitted as is, so the
+  // only per inference work on the CPU is the submission itself. The fence is
+  // returned to the pool rather than destroyed, so that it is not created anew
+  // for every inference either.
   vkapi::VulkanFence fence = context_->fences().get_fence();
   context_->submit_cmd_to_gpu(fence.get_submit_handle());
   fence.wait();
+  context_->fences().return_fence(fence);
+}
+
+bool ComputeGraph::execute_pipelined() {
+  VK_CHECK_COND(
+      pipelined_cmds_.size() == 2u,
+      "Pipelined execution must be enabled in the GraphConfig, and the "
+      "graph encoded with encode_execute()");
+
+  context_->submit_cmd_to_gpu(
+      pipelined_cmds_[staging_set_],
+      pipelined_fences_[staging_set_].get_submit_handle());
+  pipelined_pending_[staging_set_] = true;
+
+  return switch_staging_set();
+}
+
+bool ComputeGraph::finish_pipelined() {
+  if (pipelined_cmds_.size() != 2u || !pipelined_pending_[staging_set_ ^ 1u]) {
+    return false;
+  }
+  return switch_staging_set();
+}
+
+void ComputeGraph::swap_staging_sets() {
+  for (size_t i = 0; i < pipelined_staging_.size(); ++i) {
+    std::swap(*get_staging(pipelined_staging_[i]), spare_staging_[i]);
+  }
+}
+
+bool ComputeGraph::switch_staging_set() {
+  staging_set_ ^= 1u;
+  swap_staging_sets();
+  pipelined_fences_[staging_set_].wait();
+
+  const bool has_outputs = pipelined_pending_[staging_set_];
+  pipelined_pending_[staging_set_] = false;
+  return has_outputs;
+}
+
+void ComputeGraph::wait_pipelined_submissions() {
+  for (vkapi::VulkanFence& fence : pipelined_fences_) {
+    fence.wait();
+  }
 }
 
 void ComputeGraph::resize_input(
@@ -621,6 +1004,8 @@ void ComputeGraph::resize_input(
 }
 
 void ComputeGraph::propagate_resize() {
+  // Tensor metadata may not change while a pipelined submission reads it
+  wait_pipelined_submissions();
   for (std::unique_ptr<ExecuteNode>& node : execute_nodes_) {
     node->trigger_resize(this);
   }
@@ -10,8 +10,10 @@
 
 // @lint-ignore-every CLANGTIDY facebook-hte-BadMemberName
 
+#include <array>
 #include <optional>
 #include <stack>
+#include <unordered_map>
 
 #include <executorch/backends/vulkan/runtime/api/api.h>
 
@@ -174,6 +176,15 @@ class ComputeGraph final {
   // for temporary tensors. See the comments of `TmpTensor` for more details
   std::stack<int64_t> tmp_shared_object_idxs_;
 
+  // With GraphConfig::enable_memory_aliasing, the tensors created without a
+  // shared object, which plan_memory_aliasing() assigns memory to. Each of
+  // them and each of their views is mapped to the tensor that owns the memory.
+  std::vector<ValueRef> aliasing_candidates_;
+  std::unordered_map<ValueRef, ValueRef> aliasing_roots_;
+  bool memory_aliasing_planned_ = false;
+  // The memory that plan_memory_aliasing() allocated for the candidates
+  std::vector<SharedObject> aliased_objects_;
+
   std::vector<Value> values_;
   std::vector<api::ParamsBuffer> param_ubos_;
 
@@ -183,6 +194,34 @@ class ComputeGraph final {
   std::vector<IOValueRef> inputs_;
   std::vector<IOValueRef> outputs_;
 
+  // Pipelined execution; see execute_pipelined(). The staging values of the
+  // inputs and outputs hold the buffers of the current staging set, and
+  // spare_staging_ those of the other one, in the same order.
+  std::vector<ValueRef> pipelined_staging_;
+  std::vector<api::StagingBuffer> spare_staging_;
+  // The command buffer that reads and writes each staging set, and the fence
+  // of its last submission.
+  std::vector<vkapi::CommandBuffer> pipelined_cmds_;
+  std::vector<vkapi::VulkanFence> pipelined_fences_;
+  // Whether the outputs of a submission of each staging set were not yet
+  // returned by execute_pipelined() or finish_pipelined().
+  std::array<bool, 2> pipelined_pending_ = {};
+  uint32_t staging_set_ = 0u;
+
+  // Swaps the buffers of the staging values with the spare ones.
+  void swap_staging_sets();
+  // Switches to the other staging set, once its last submission completed.
+  bool switch_staging_set();
+  void wait_pipelined_submissions();
+
+  // Assigns the aliasing candidates whose lifetimes do not overlap to the same
+  // memory, then allocates and binds it.
+  void plan_memory_aliasing();
+
+  // Measures the local workgroup size candidates of the execute nodes, and sets
+  // the fastest one on each node; see GraphConfig::enable_local_wg_size_tuning.
+  void tune_local_wg_sizes();
+
  protected:
   size_t values_in_use_ = 0;
 
@@ -542,7 +581,16 @@ class ComputeGraph final {
 
   ValueRef add_symint(const int32_t val);
 
-  ValueRef set_input_tensor(const ValueRef idx, const bool use_staging = true);
+  /*
+   * Marks a tensor as an input of the graph. With staging, the data of the
+   * input is copied into a staging buffer of `staging_dtype`, which defaults
+   * to the dtype of the tensor. fp16 texture tensors may use fp32 staging
+   * buffers, which are converted to fp16 on the GPU as they are packed.
+   */
+  ValueRef set_input_tensor(
+      const ValueRef idx,
+      const bool use_staging = true,
+      const vkapi::ScalarType staging_dtype = vkapi::ScalarType::Undefined);
   ValueRef set_output_tensor(const ValueRef idx, const bool use_staging = true);
 
   template <typename Block>
@@ -630,6 +678,14 @@ class ComputeGraph final {
 
   SharedObject& get_shared_object(const int64_t idx);
 
+  /*
+   * The number of memory blocks that prepare() allocated for the tensors whose
+   * memory it aliases; see GraphConfig::enable_memory_aliasing.
+   */
+  inline size_t aliased_objects_count() const {
+    return aliased_objects_.size();
+  }
+
   //
   // Graph Preparation
   //
@@ -685,6 +741,18 @@ class ComputeGraph final {
   copy_into_staging(const ValueRef idx, const void* data, const size_t numel);
   void copy_from_staging(const ValueRef idx, void* data, const size_t numel);
 
+  /*
+   * Copies fp32 data into or out of a staging buffer, converting it on the
+   * host if the staging buffer is fp16. This lets fp32 inputs and outputs be
+   * used with fp16 graphs without staging fp32 data on the device.
+   */
+  void copy_float_into_staging(
+      const ValueRef idx,
+      const float* data,
+      const size_t numel);
+  void
+  copy_float_from_staging(const ValueRef idx, float* data, const size_t numel);
+
   //
   // Graph Prepacking
   //
@@ -699,6 +767,27 @@ class ComputeGraph final {
   void encode_execute();
   void execute() const;
 
+  /*
+   * Pipelined execution, if GraphConfig::enable_pipelined_execution is set.
+   * Submits the command buffer of the current staging set, whose input
+   * staging buffers the caller filled, without waiting for it to complete.
+   * Then switches to the other staging set, once the GPU finished the
+   * inference submitted before, so that the caller can copy that inference's
+   * outputs out of, and the next inputs into, the staging buffers while the
+   * GPU executes this one.
+   *
+   * Returns whether the staging buffers now hold the outputs of an earlier
+   * inference, i.e. false for the first one.
+   */
+  bool execute_pipelined();
+
+  /*
+   * Waits for the inference that execute_pipelined() last submitted, and
+   * switches to its staging set to read its outputs. Returns false if there
+   * is no such inference.
+   */
+  bool finish_pipelined();
+
   //
   // Dynamic Shape support
   //
@@ -721,6 +810,15 @@ class ComputeGraph final {
     return context_->adapter_ptr()->has_full_int8_buffers_support();
   }
 
+  /*
+   * Check whether fp16 buffer tensors can be multiplied with cooperative
+   * matrices, i.e. with the matrix units of the GPU.
+   */
+  inline bool fp16_cooperative_matrix_enabled() const {
+    return context_->adapter_ptr()->has_full_float16_buffers_support() &&
+        context_->adapter_ptr()->supports_fp16_cooperative_matrix();
+  }
+
   //
   // Debug support (implemented in Logging.cpp)
   //
@@ -63,6 +63,20 @@ GraphConfig::GraphConfig() {
 
   enable_local_wg_size_override = false;
   local_wg_size_override = {};
+
+  // By default, shaders are dispatched with the workgroup counts of the sizes
+  // that the graph was built with, which cover any resized tensor.
+  enable_indirect_dispatch = false;
+
+  // By default, each inference waits for the GPU before returning.
+  enable_pipelined_execution = false;
+
+  // By default, every tensor without a shared object has memory of its own.
+  enable_memory_aliasing = false;
+
+  // By default, shaders are dispatched with the local workgroup sizes chosen
+  // by the operator implementations.
+  enable_local_wg_size_tuning = false;
 }
 
 void GraphConfig::set_storage_type_override(utils::StorageType storage_type) {
@@ -33,6 +33,28 @@ struct GraphConfig final {
   bool enable_local_wg_size_override;
   utils::uvec3 local_wg_size_override;
 
+  // Dispatch shaders whose global workgroup size follows their output tensor
+  // indirectly, so that after a resize they dispatch only as many workgroups
+  // as the new sizes need without re-encoding the command buffer.
+  bool enable_indirect_dispatch;
+
+  // Allocate a second set of input and output staging buffers and encode a
+  // command buffer for each set, so that ComputeGraph::execute_pipelined() can
+  // overlap copying the inputs and outputs of one inference with the GPU
+  // executing the previous one.
+  bool enable_pipelined_execution;
+
+  // Create tensors that are not assigned a shared object without memory of
+  // their own, and have ComputeGraph::prepare() alias the memory of those whose
+  // lifetimes in the execute nodes do not overlap.
+  bool enable_memory_aliasing;
+
+  // Measure a few local workgroup sizes for each shader dispatch when the
+  // graph is first encoded, and dispatch each with the fastest one. The winners
+  // are kept in the LocalWorkGroupSizeCache of the adapter, so that later
+  // graphs using the same shaders and sizes skip the measurements.
+  bool enable_local_wg_size_tuning;
+
   // Generate a default graph config with pre-configured settings
   explicit GraphConfig();
 
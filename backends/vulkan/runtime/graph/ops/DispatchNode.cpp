@@ -12,8 +12,37 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/utils/BindingUtils.h>
 
+#include <algorithm>
+
 namespace vkcompute {
 
+namespace {
+
+// Common local workgroup sizes of 64 invocations, which every Vulkan device
+// supports, spread differently across the workgroup dimensions
+const std::vector<utils::uvec3> kLocalWgSizeCandidates = {
+    {64u, 1u, 1u},
+    {32u, 2u, 1u},
+    {16u, 4u, 1u},
+    {8u, 8u, 1u},
+    {4u, 4u, 4u},
+    {8u, 4u, 2u},
+};
+
+uint32_t next_pow2(const uint32_t n) {
+  uint32_t pow2 = 1u;
+  while (pow2 < n) {
+    pow2 <<= 1u;
+  }
+  return pow2;
+}
+
+bool same_wg_size(const utils::uvec3& lhs, const utils::uvec3& rhs) {
+  return lhs[0u] == rhs[0u] && lhs[1u] == rhs[1u] && lhs[2u] == rhs[2u];
+}
+
+} // namespace
+
 DispatchNode::DispatchNode(
     ComputeGraph& graph,
     const vkapi::ShaderInfo& shader,
@@ -29,8 +58,52 @@ DispatchNode::DispatchNode(
       global_workgroup_size_(global_workgroup_size),
       local_workgroup_size_(local_workgroup_size),
       params_(params),
-      spec_vars_(spec_vars) {
+      spec_vars_(spec_vars),
+      indirect_buffer_() {
   graph.update_descriptor_counts(shader, /*execute = */ true);
+
+  // Only nodes whose workgroup size is derived from their output in the
+  // default way can recompute it after a resize, so the others dispatch
+  // directly with the size they were built with.
+  if (shader_ && graph.graphconfig().enable_indirect_dispatch &&
+      has_default_global_wg_size(graph)) {
+    indirect_buffer_ =
+        graph.context()->adapter_ptr()->vma().create_indirect_buffer(
+            sizeof(VkDispatchIndirectCommand));
+    write_indirect_dispatch(&graph);
+  }
+}
+
+ValueRef DispatchNode::indirect_dispatch_out() const {
+  if (args_.empty() || args_[0].refs.empty()) {
+    return kDummyValueRef;
+  }
+  return args_[0].refs[0];
+}
+
+bool DispatchNode::has_default_global_wg_size(ComputeGraph& graph) const {
+  const ValueRef out = indirect_dispatch_out();
+  if (out == kDummyValueRef || !graph.val_is_tensor(out)) {
+    return false;
+  }
+  const utils::uvec3 default_wg_size = graph.create_global_wg_size(out);
+  return global_workgroup_size_[0u] == default_wg_size[0u] &&
+      global_workgroup_size_[1u] == default_wg_size[1u] &&
+      global_workgroup_size_[2u] == default_wg_size[2u];
+}
+
+void DispatchNode::write_indirect_dispatch(ComputeGraph* graph) {
+  const utils::uvec3 group_counts = api::Context::dispatch_group_counts(
+      shader_,
+      graph->create_global_wg_size(indirect_dispatch_out()),
+      local_workgroup_size_);
+
+  vkapi::MemoryMap mapping(indirect_buffer_, vkapi::kWrite);
+  VkDispatchIndirectCommand* const command =
+      mapping.data<VkDispatchIndirectCommand>();
+  command->x = group_counts[0u];
+  command->y = group_counts[1u];
+  command->z = group_counts[2u];
 }
 
 void DispatchNode::encode(ComputeGraph* graph) {
@@ -57,10 +130,65 @@ void DispatchNode::encode(ComputeGraph* graph) {
 
   bind_params_to_descriptor_set(params_, descriptor_set, idx);
 
-  context->register_shader_dispatch(
-      descriptor_set, pipeline_barrier, shader_, global_workgroup_size_);
+  if (indirect_buffer_) {
+    context->register_shader_dispatch_indirect(
+        descriptor_set, pipeline_barrier, shader_, indirect_buffer_);
+  } else {
+    context->register_shader_dispatch(
+        descriptor_set, pipeline_barrier, shader_, global_workgroup_size_);
+  }
 
   context->report_shader_dispatch_end();
 }
 
+void DispatchNode::trigger_resize(ComputeGraph* graph) {
+  ExecuteNode::trigger_resize(graph);
+  if (indirect_buffer_) {
+    write_indirect_dispatch(graph);
+  }
+}
+
+std::vector<utils::uvec3> DispatchNode::local_wg_size_candidates(
+    ComputeGraph* graph) const {
+  if (!shader_ || shader_.fixed_local_wg_size ||
+      graph->graphconfig().enable_local_wg_size_override) {
+    return {};
+  }
+
+  utils::uvec3 tuned_wg_size;
+  if (graph->context()->adapter_ptr()->local_wg_size_cache().find(
+          shader_.kernel_name, global_workgroup_size_, tuned_wg_size)) {
+    return {tuned_wg_size};
+  }
+
+  std::vector<utils::uvec3> candidates = {local_workgroup_size_};
+  for (const utils::uvec3& wg_size : kLocalWgSizeCandidates) {
+    // Skip sizes that would mostly dispatch out of bounds invocations
+    bool fits = true;
+    for (uint32_t i = 0; i < 3u; ++i) {
+      fits = fits && wg_size[i] <= next_pow2(global_workgroup_size_[i]);
+    }
+    const bool is_duplicate = std::any_of(
+        candidates.begin(),
+        candidates.end(),
+        [&wg_size](const utils::uvec3& candidate) {
+          return same_wg_size(candidate, wg_size);
+        });
+    if (fits && !is_duplicate) {
+      candidates.push_back(wg_size);
+    }
+  }
+  return candidates;
+}
+
+void DispatchNode::set_local_wg_size(
+    ComputeGraph* graph,
+    const utils::uvec3& local_wg_size) {
+  local_workgroup_size_ = local_wg_size;
+  // The workgroup counts of indirect dispatches depend on the local size
+  if (indirect_buffer_) {
+    write_indirect_dispatch(graph);
+  }
+}
+
 } // namespace vkcompute
@@ -40,12 +40,40 @@ class DispatchNode final : public ExecuteNode {
 
   void encode(ComputeGraph* graph) override;
 
+  /*
+   * If the node dispatches indirectly, also writes the workgroup counts for
+   * the resized output to the indirect buffer, so that the encoded command
+   * buffer dispatches only as many workgroups as the new sizes need.
+   */
+  void trigger_resize(ComputeGraph* graph) override;
+
+  /*
+   * Returns the local workgroup size tuned for the shader and global workgroup
+   * size on this device, if any. Otherwise returns the size that the node was
+   * built with followed by a few common sizes that fit the global workgroup
+   * size. Shaders that rely on their local workgroup size, e.g. to share
+   * memory or synchronize within a workgroup, are never tuned.
+   */
+  std::vector<utils::uvec3> local_wg_size_candidates(
+      ComputeGraph* graph) const override;
+
+  void set_local_wg_size(
+      ComputeGraph* graph,
+      const utils::uvec3& local_wg_size) override;
+
  protected:
   const vkapi::ShaderInfo shader_;
   const utils::uvec3 global_workgroup_size_;
-  const utils::uvec3 local_workgroup_size_;
+  utils::uvec3 local_workgroup_size_;
   const vkapi::ParamsBindList params_;
   const vkapi::SpecVarList spec_vars_;
+  // Holds the VkDispatchIndirectCommand of the node, if it is dispatched
+  // indirectly; see GraphConfig::enable_indirect_dispatch.
+  vkapi::VulkanBuffer indirect_buffer_;
+
+  ValueRef indirect_dispatch_out() const;
+  bool has_default_global_wg_size(ComputeGraph& graph) const;
+  void write_indirect_dispatch(ComputeGraph* graph);
 
  public:
   operator bool() const {
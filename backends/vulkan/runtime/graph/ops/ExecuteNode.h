@@ -65,12 +65,30 @@ class ExecuteNode {
     (void)graph;
   }
 
-  inline void trigger_resize(ComputeGraph* graph) {
+  virtual void trigger_resize(ComputeGraph* graph) {
     if (resize_fn_ != nullptr) {
       resize_fn_(graph, args_, resize_args_);
     }
   }
 
+  /*
+   * Returns the local workgroup sizes that the node can be dispatched with,
+   * for ComputeGraph to measure; see GraphConfig::enable_local_wg_size_tuning.
+   * If a single size is returned, it is used without being measured.
+   */
+  virtual std::vector<utils::uvec3> local_wg_size_candidates(
+      ComputeGraph* graph) const {
+    (void)graph;
+    return {};
+  }
+
+  virtual void set_local_wg_size(
+      ComputeGraph* graph,
+      const utils::uvec3& local_wg_size) {
+    (void)graph;
+    (void)local_wg_size;
+  }
+
   inline void set_node_id(uint32_t node_id) {
     node_id_ = node_id;
   }
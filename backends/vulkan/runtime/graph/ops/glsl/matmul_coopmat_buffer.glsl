@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+#define T ${buffer_scalar_type(DTYPE)}
+
+$if MAT2_DTYPE == "int8":
+  #define QUANTIZED_MAT2
+
+${define_required_extensions(DTYPE)}
+${define_required_extensions(MAT2_DTYPE)}
+
+#extension GL_KHR_cooperative_matrix : require
+#extension GL_KHR_memory_scope_semantics : require
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_EXT_control_flow_attributes : require
+
+layout(std430) buffer;
+
+${layout_declare_tensor(B, "w", "t_out", DTYPE, "buffer")}
+${layout_declare_tensor(B, "r", "t_mat1", DTYPE, "buffer")}
+${layout_declare_tensor(B, "r", "t_mat2", MAT2_DTYPE, "buffer")}
+$if MAT2_DTYPE == "int8":
+  ${layout_declare_tensor(B, "r", "t_scales", DTYPE, "buffer")}
+${layout_declare_ubo(B, "ivec4", "out_sizes")}
+${layout_declare_ubo(B, "ivec4", "out_strides")}
+${layout_declare_ubo(B, "ivec4", "mat1_sizes")}
+${layout_declare_ubo(B, "ivec4", "mat1_strides")}
+${layout_declare_ubo(B, "ivec4", "mat2_strides")}
+
+#include "indexing_utils.h"
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+${layout_declare_spec_const(C, "int", "mat2_is_transposed", "0")}
+
+/*
+ * Each workgroup computes a BM x BN tile of the output, iterating over K in
+ * steps of BK. The subgroups of the workgroup share the TILE x TILE subtiles
+ * of the output tile between them, and compute each one with cooperative
+ * matrix multiply-adds, accumulating in fp32. Since cooperative matrices may
+ * not be loaded from outside of a tensor, the tiles of both inputs are first
+ * copied to shared memory, where out of bounds elements are zero.
+ */
+
+#define TILE 16
+#define BM 32
+#define BN 32
+#define BK 16
+#define NUM_SUBTILES ((BM / TILE) * (BN / TILE))
+
+shared T sh_mat1[BM * BK];
+shared T sh_mat2[BK * BN];
+shared float sh_out[BM * BN];
+
+void main() {
+  const int out_row_start = int(gl_WorkGroupID.y) * BM;
+  const int out_col_start = int(gl_WorkGroupID.x) * BN;
+  const int batch = int(gl_WorkGroupID.z);
+  const int batch_z = batch % out_sizes.z;
+  const int batch_w = batch / out_sizes.z;
+
+  const uint num_threads =
+      gl_WorkGroupSize.x * gl_WorkGroupSize.y * gl_WorkGroupSize.z;
+  const int K = mat1_sizes.x;
+
+  coopmat<float, gl_ScopeSubgroup, TILE, TILE, gl_MatrixUseAccumulator>
+      sums[NUM_SUBTILES];
+  [[unroll]] for (uint i = 0; i < NUM_SUBTILES; ++i) {
+    sums[i] =
+        coopmat<float, gl_ScopeSubgroup, TILE, TILE, gl_MatrixUseAccumulator>(
+            0.0);
+  }
+
+  for (int k_start = 0; k_start < K; k_start += BK) {
+    for (uint i = gl_LocalInvocationIndex; i < BM * BK; i += num_threads) {
+      const int row = out_row_start + int(i) / BK;
+      const int k = k_start + int(i) % BK;
+      T val = T(0);
+      if (row < mat1_sizes.y && k < K) {
+        val = t_mat1[tidx_to_bufi(
+            ivec4(k, row, batch_z, batch_w), mat1_strides)];
+      }
+      sh_mat1[i] = val;
+    }
+
+    for (uint i = gl_LocalInvocationIndex; i < BK * BN; i += num_threads) {
+      const int k = k_start + int(i) / BN;
+      const int col = out_col_start + int(i) % BN;
+      T val = T(0);
+      if (k < K && col < out_sizes.x) {
+        if (mat2_is_transposed > 0) {
+          val = T(t_mat2[tidx_to_bufi(ivec4(k, col, 0, 0), mat2_strides)]);
+        } else {
+          val = T(t_mat2[tidx_to_bufi(
+              ivec4(col, k, batch_z, batch_w), mat2_strides)]);
+        }
+      }
+      sh_mat2[i] = val;
+    }
+
+    barrier();
+
+    [[unroll]] for (uint i = 0; i < NUM_SUBTILES; ++i) {
+      // Uniform across the subgroup, as required by cooperative matrix ops
+      const uint subtile = gl_SubgroupID + i * gl_NumSubgroups;
+      if (subtile < NUM_SUBTILES) {
+        const uint subtile_row = subtile / (BN / TILE);
+        const uint subtile_col = subtile % (BN / TILE);
+
+        coopmat<T, gl_ScopeSubgroup, TILE, TILE, gl_MatrixUseA> a;
+        coopmat<T, gl_ScopeSubgroup, TILE, TILE, gl_MatrixUseB> b;
+        coopMatLoad(
+            a,
+            sh_mat1,
+            subtile_row * TILE * BK,
+            BK,
+            gl_CooperativeMatrixLayoutRowMajor);
+        coopMatLoad(
+            b,
+            sh_mat2,
+            subtile_col * TILE,
+            BN,
+            gl_CooperativeMatrixLayoutRowMajor);
+        sums[i] = coopMatMulAdd(a, b, sums[i]);
+      }
+    }
+
+    barrier();
+  }
+
+  [[unroll]] for (uint i = 0; i < NUM_SUBTILES; ++i) {
+    const uint subtile = gl_SubgroupID + i * gl_NumSubgroups;
+    if (subtile < NUM_SUBTILES) {
+      const uint subtile_row = subtile / (BN / TILE);
+      const uint subtile_col = subtile % (BN / TILE);
+      coopMatStore(
+          sums[i],
+          sh_out,
+          subtile_row * TILE * BN + subtile_col * TILE,
+          BN,
+          gl_CooperativeMatrixLayoutRowMajor);
+    }
+  }
+
+  barrier();
+
+  for (uint i = gl_LocalInvocationIndex; i < BM * BN; i += num_threads) {
+    const int row = out_row_start + int(i) / BN;
+    const int col = out_col_start + int(i) % BN;
+    if (row < out_sizes.y && col < out_sizes.x) {
+      float val = sh_out[i];
+#ifdef QUANTIZED_MAT2
+      // Weights are quantized per output channel, so they are scaled last
+      val *= float(t_scales[col]);
+#endif
+      t_out[tidx_to_bufi(ivec4(col, row, batch_z, batch_w), out_strides)] =
+          T(val);
+    }
+  }
+}
@@ -20,7 +20,12 @@ ${define_required_extensions(DTYPE)}
 layout(std430) buffer;
 
 ${layout_declare_tensor(B, "w", "t_out", DTYPE, STORAGE)}
-${layout_declare_buffer(B, "r", "buf_in", DTYPE)}
+// With FROM_FLOAT, the staging buffer holds fp32 data, which is converted to
+// DTYPE as it is packed into texels.
+$if FROM_FLOAT:
+  ${layout_declare_buffer(B, "r", "buf_in", "float")}
+$else:
+  ${layout_declare_buffer(B, "r", "buf_in", DTYPE)}
 ${layout_declare_ubo(B, "ivec4", "sizes")}
 $if not FROM_STAGING:
   ${layout_declare_ubo(B, "ivec4", "buf_strides")}
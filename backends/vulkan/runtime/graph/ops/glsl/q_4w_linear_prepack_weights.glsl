@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+${define_required_extensions("uint8")}
+
+layout(std430) buffer;
+
+${layout_declare_tensor(B, "w", "t_qmat2", "int", "buffer", is_scalar_array=False)}
+${layout_declare_buffer(B, "r", "nchw_4x2", "uint8")}
+${layout_declare_ubo(B, "ivec2", "orig_sizes")}
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+#include "indexing_utils.h"
+
+/*
+ * Packs the weights of a 4-bit linear operator, so that q_4w_linear_tiled can
+ * load the weights for 4 output channels and 8 input channels with a single
+ * read.
+ *
+ * The input has sizes (N, K / 2), where each uint8 holds 2 4-bit values; the
+ * first value of each pair is held in the high nibble. orig_sizes holds
+ * (K / 2, N).
+ *
+ * The output is an array of ivec4 with (N / 4) rows of (K / 8) elements each.
+ * Component c of the element at (n4, k8) holds the values of output channel
+ * 4 * n4 + c for input channels 8 * k8 to 8 * k8 + 7, where the value for input
+ * channel 8 * k8 + i is held in bits [4 * i, 4 * i + 3]. Output channels past N
+ * are padded with zeros.
+ */
+void main() {
+  const int k8 = int(gl_GlobalInvocationID.x);
+  const int n4 = int(gl_GlobalInvocationID.y);
+
+  const int num_k8 = orig_sizes.x >> 2;
+  if (k8 >= num_k8 || n4 >= divup4(orig_sizes.y)) {
+    return;
+  }
+
+  uvec4 packed = uvec4(0);
+  for (int comp = 0; comp < 4; comp++) {
+    const int n = n4 * 4 + comp;
+    if (n >= orig_sizes.y) {
+      break;
+    }
+    const int in_bufi = n * orig_sizes.x + k8 * 4;
+    for (int b = 0; b < 4; b++) {
+      const uint val = uint(nchw_4x2[in_bufi + b]);
+      packed[comp] |= ((val >> 4) << (8 * b)) | ((val & 0xF) << (8 * b + 4));
+    }
+  }
+
+  t_qmat2[n4 * num_k8 + k8] = ivec4(packed);
+}
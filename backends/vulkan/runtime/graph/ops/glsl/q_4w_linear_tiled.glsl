@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+#define VEC4_T ${texel_load_type(DTYPE, STORAGE)}
+
+#define TILE_ROWS ${TILE_ROWS}
+
+${define_active_storage_type(STORAGE)}
+${define_required_extensions(DTYPE)}
+
+#extension GL_EXT_control_flow_attributes : require
+
+layout(std430) buffer;
+
+${layout_declare_tensor(B, "w", "t_out", DTYPE, STORAGE)}
+${layout_declare_tensor(B, "r", "t_mat1", DTYPE, STORAGE)}
+${layout_declare_tensor(B, "r", "t_qmat2", "int", "buffer", is_scalar_array=False)}
+${layout_declare_tensor(B, "r", "t_qparams", DTYPE, STORAGE)}
+${layout_declare_ubo(B, "ivec3", "out_limits")}
+${layout_declare_ubo(B, "ivec4", "mat1_sizes")}
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+layout(constant_id = 3) const int group_size = 64;
+
+#include "indexing_utils.h"
+
+/*
+ * Computes a linear operator between a floating point input matrix mat1 and a
+ * weights matrix that is quantized group-wise to 4 bits, dequantizing the
+ * weights as they are loaded.
+ *
+ * The weights are packed by q_4w_linear_prepack_weights, so that each ivec4 of
+ * t_qmat2 holds the weights for 4 output channels and 8 input channels. The
+ * quantization parameters are laid out as for q_4w_linear.
+ *
+ * Each thread computes TILE_ROWS output texels of the same output channels.
+ * With TILE_ROWS = 1 this is a GEMV, used when mat1 has few rows; with larger
+ * tiles each dequantized weight is used for several rows of mat1.
+ *
+ * group_size must be a multiple of 8, and all tensors except t_qmat2 are
+ * expected to be width packed.
+ */
+void main() {
+  const int out_col_texel = int(gl_GlobalInvocationID.x);
+  const int out_row = int(gl_GlobalInvocationID.y) * TILE_ROWS;
+  const int out_z = int(gl_GlobalInvocationID.z);
+
+  if (out_col_texel >= out_limits.x || out_row >= out_limits.y ||
+      out_z >= out_limits.z) {
+    return;
+  }
+
+  const int n = out_col_texel * 4;
+  const int K = mat1_sizes.x;
+  int qmat2_bufi = out_col_texel * (K >> 3);
+
+  vec4 sums[TILE_ROWS];
+  [[unroll]] for (int r = 0; r < TILE_ROWS; ++r) {
+    sums[r] = vec4(0);
+  }
+
+  for (int k = 0; k < K; k += group_size) {
+    vec4 scales;
+    vec4 zeros;
+    [[unroll]] for (int comp = 0; comp < 4; comp++) {
+      const vec4 scale_and_zero =
+          load_texel(t_qparams, ivec3(0, n + comp, k / group_size));
+      scales[comp] = scale_and_zero.x;
+      zeros[comp] = scale_and_zero.y;
+    }
+
+    for (int k8 = k; k8 < k + group_size; k8 += 8, qmat2_bufi++) {
+      const uvec4 packed = uvec4(t_qmat2[qmat2_bufi]);
+
+      // The weights of input channels k8 to k8 + 3 and k8 + 4 to k8 + 7 for
+      // each of the output channels. The unpacked values are unsigned, so they
+      // are centered around 0 before the scale and zero point are applied.
+      vec4 w_lo[4];
+      vec4 w_hi[4];
+      [[unroll]] for (int comp = 0; comp < 4; comp++) {
+        w_lo[comp] =
+            (vec4((uvec4(packed[comp]) >> uvec4(0, 4, 8, 12)) & 0xF) - 8.0) *
+                scales[comp] +
+            zeros[comp];
+        w_hi[comp] =
+            (vec4((uvec4(packed[comp]) >> uvec4(16, 20, 24, 28)) & 0xF) -
+             8.0) *
+                scales[comp] +
+            zeros[comp];
+      }
+
+      const int k_texel = k8 >> 2;
+      [[unroll]] for (int r = 0; r < TILE_ROWS; ++r) {
+        const vec4 x_lo =
+            vec4(load_texel(t_mat1, ivec3(k_texel, out_row + r, out_z)));
+        const vec4 x_hi =
+            vec4(load_texel(t_mat1, ivec3(k_texel + 1, out_row + r, out_z)));
+        [[unroll]] for (int comp = 0; comp < 4; comp++) {
+          sums[r][comp] += dot(x_lo, w_lo[comp]) + dot(x_hi, w_hi[comp]);
+        }
+      }
+    }
+  }
+
+  [[unroll]] for (int r = 0; r < TILE_ROWS; ++r) {
+    if (out_row + r < out_limits.y) {
+      write_texel(
+          t_out, ivec3(out_col_texel, out_row + r, out_z), VEC4_T(sums[r]));
+    }
+  }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#version 450 core
+
+#define PRECISION ${PRECISION}
+
+#define VEC4_T ${texel_load_type(DTYPE, STORAGE)}
+
+${define_active_storage_type(STORAGE)}
+${define_required_extensions(DTYPE)}
+
+#extension GL_EXT_control_flow_attributes : require
+
+layout(std430) buffer;
+
+${layout_declare_tensor(B, "w", "t_out", DTYPE, STORAGE)}
+${layout_declare_tensor(B, "r", "t_q", DTYPE, STORAGE)}
+${layout_declare_tensor(B, "r", "t_k_cache", DTYPE, STORAGE)}
+${layout_declare_tensor(B, "r", "t_v_cache", DTYPE, STORAGE)}
+
+${layout_declare_ubo(B, "ivec4", "q_sizes")}
+${layout_declare_ubo(B, "int", "input_pos")}
+${layout_declare_ubo(B, "float", "scale")}
+
+#include "indexing_utils.h"
+
+layout(local_size_x_id = 0, local_size_y_id = 1, local_size_z_id = 2) in;
+
+// The number of query heads that share each key/value head
+layout(constant_id = 3) const int num_kv_groups = 1;
+
+// The number of keys that the work group scores at a time. Must match the
+// local work group size along x, which is set by the operator implementation.
+#define TILE_SIZE 64
+
+// The head dim texels of the query that is processed by the work group
+shared vec4 q_texels[TILE_SIZE];
+// The attention scores of the keys in the current tile
+shared float scores[TILE_SIZE];
+
+const float negative_infinity = uintBitsToFloat(0xFF800000u);
+
+/*
+ * Computes the output of an SDPA block in a single dispatch, without ever
+ * materializing the (seq_len, input_pos + seq_len) attention weight matrix.
+ * The caches are expected to have already been updated with the projected keys
+ * and values of the current sequence.
+ *
+ * t_q and t_out have sizes (1, seq_len, n_heads, head_dim) and t_k_cache and
+ * t_v_cache have sizes (1, max_seq_len, n_kv_heads, head_dim). All tensors are
+ * width packed, so a texel holds 4 elements of the head dim.
+ *
+ * Each work group computes the output of one query token for one head. The keys
+ * that the token attends to are processed in tiles of TILE_SIZE keys: each
+ * thread scores one key of the tile against the query, then the softmax is
+ * updated online. The maximum score and the sum of the exponents seen so far
+ * are kept, and whenever a tile raises the maximum, the previously accumulated
+ * sum and output are rescaled by exp(old_max - new_max). Each thread accumulates
+ * the weighted values for one texel of the head dim, so the head dim must not
+ * exceed 4 * TILE_SIZE.
+ *
+ * The mask is causal: query token s attends to cached tokens [0, input_pos + s].
+ */
+void main() {
+  const int tid = int(gl_LocalInvocationID.x);
+  const int head = int(gl_WorkGroupID.y);
+  const int s = int(gl_WorkGroupID.z);
+
+  // The check is uniform across the work group, so no thread will skip the
+  // barriers below on its own.
+  if (head >= q_sizes.y || s >= q_sizes.z) {
+    return;
+  }
+
+  const int head_dim_texels = divup4(q_sizes.x);
+  const int kv_head = head / num_kv_groups;
+  const int context_len = input_pos + s + 1;
+
+  if (tid < head_dim_texels) {
+    q_texels[tid] = vec4(load_texel(t_q, ivec3(tid, head, s)));
+  }
+  barrier();
+
+  float running_max = negative_infinity;
+  float running_sum = 0.0;
+  vec4 acc = vec4(0);
+
+  for (int tile_start = 0; tile_start < context_len; tile_start += TILE_SIZE) {
+    const int key = tile_start + tid;
+    float score = negative_infinity;
+    if (key < context_len) {
+      float qk = 0.0;
+      for (int d4 = 0; d4 < head_dim_texels; ++d4) {
+        qk += dot(
+            q_texels[d4],
+            vec4(load_texel(t_k_cache, ivec3(d4, kv_head, key))));
+      }
+      score = qk * scale;
+    }
+    scores[tid] = score;
+    barrier();
+
+    const int tile_len = min(TILE_SIZE, context_len - tile_start);
+
+    float tile_max = scores[0];
+    for (int i = 1; i < tile_len; ++i) {
+      tile_max = max(tile_max, scores[i]);
+    }
+    const float new_max = max(running_max, tile_max);
+    const float correction = exp(running_max - new_max);
+    running_sum *= correction;
+    acc *= correction;
+
+    for (int i = 0; i < tile_len; ++i) {
+      const float p = exp(scores[i] - new_max);
+      running_sum += p;
+      if (tid < head_dim_texels) {
+        acc += p *
+            vec4(load_texel(t_v_cache, ivec3(tid, kv_head, tile_start + i)));
+      }
+    }
+    running_max = new_max;
+
+    // The scores of the next tile must not be written while they are read
+    barrier();
+  }
+
+  if (tid < head_dim_texels) {
+    write_texel(t_out, ivec3(tid, head, s), VEC4_T(acc / running_sum));
+  }
+}
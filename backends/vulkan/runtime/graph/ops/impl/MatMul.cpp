@@ -107,6 +107,67 @@ void add_matmul_naive_buffer_node(
       {mat2_is_transposed}));
 }
 
+bool can_use_coopmat_matmul(ComputeGraph& graph, const ValueRef out) {
+  return graph.is_buffer_storage(out) &&
+      graph.dtype_of(out) == vkapi::kHalf &&
+      graph.fp16_cooperative_matrix_enabled();
+}
+
+utils::uvec3 coopmat_matmul_global_wg_size(
+    ComputeGraph& graph,
+    const ValueRef out) {
+  // Each workgroup computes a kCoopMatTileRows x kCoopMatTileCols output tile
+  return {
+      utils::div_up(graph.size_at<uint32_t>(-1, out), kCoopMatTileCols) *
+          kCoopMatWorkGroupSize,
+      utils::div_up(graph.size_at<uint32_t>(-2, out), kCoopMatTileRows),
+      graph.size_at<uint32_t>(-3, out) * graph.size_at<uint32_t>(-4, out)};
+}
+
+void add_matmul_coopmat_buffer_node(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef mat2_data,
+    const ValueRef out,
+    const ValueRef mat2_is_transposed) {
+  ValueRef mat2 = prepack_standard(
+      graph,
+      mat2_data,
+      graph.storage_type_of(out),
+      utils::kHeightPacked,
+      /*passthrough = */ true);
+
+  std::string kernel_name = "matmul_coopmat_buffer";
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  int mat2_is_transposed_val = (mat2_is_transposed != kDummyValueRef &&
+                                graph.get_bool(mat2_is_transposed))
+      ? 1
+      : 0;
+
+  graph.execute_nodes().emplace_back(new DispatchNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      coopmat_matmul_global_wg_size(graph, out),
+      {kCoopMatWorkGroupSize, 1u, 1u},
+      // Inputs and Outputs
+      {{out, vkapi::MemoryAccessType::WRITE},
+       {{mat1, mat2}, vkapi::MemoryAccessType::READ}},
+      // Shader params buffers
+      {
+          graph.sizes_ubo(out),
+          graph.strides_ubo(out),
+          graph.sizes_ubo(mat1),
+          graph.strides_ubo(mat1),
+          graph.strides_ubo(mat2),
+      },
+      // Specialization Constants
+      {mat2_is_transposed_val},
+      // Resizing Logic
+      resize_matmul_node,
+      {mat2_is_transposed}));
+}
+
 void add_matmul_naive_texture3d_node(
     ComputeGraph& graph,
     const ValueRef mat1,
@@ -244,7 +305,10 @@ void add_matmul_node(
     const ValueRef mat2_data,
     const ValueRef out,
     const ValueRef mat2_is_transposed) {
-  if (graph.is_buffer_storage(out)) {
+  if (can_use_coopmat_matmul(graph, out)) {
+    add_matmul_coopmat_buffer_node(
+        graph, mat1, mat2_data, out, mat2_is_transposed);
+  } else if (graph.is_buffer_storage(out)) {
     add_matmul_naive_buffer_node(
         graph, mat1, mat2_data, out, mat2_is_transposed);
   } else if (graph.packed_dim_of(mat1) == WHCN::kChannelsDim) {
@@ -12,6 +12,22 @@
 
 namespace vkcompute {
 
+// The output tile that a workgroup of the cooperative matrix shaders computes,
+// and the size of those workgroups
+constexpr uint32_t kCoopMatTileRows = 32u;
+constexpr uint32_t kCoopMatTileCols = 32u;
+constexpr uint32_t kCoopMatWorkGroupSize = 128u;
+
+/*
+ * Whether a matmul that writes to out can use a cooperative matrix shader,
+ * which multiplies fp16 buffers on the matrix units of the GPU.
+ */
+bool can_use_coopmat_matmul(ComputeGraph& graph, const ValueRef out);
+
+utils::uvec3 coopmat_matmul_global_wg_size(
+    ComputeGraph& graph,
+    const ValueRef out);
+
 void add_matmul_node(
     ComputeGraph& graph,
     const ValueRef mat1,
@@ -8,6 +8,7 @@
 
 #include <executorch/backends/vulkan/runtime/graph/ops/OperatorRegistry.h>
 
+#include <executorch/backends/vulkan/runtime/graph/ops/impl/MatMul.h>
 #include <executorch/backends/vulkan/runtime/graph/ops/impl/Staging.h>
 
 #include <executorch/backends/vulkan/runtime/graph/ops/impl/utils/ScalarUtils.h>
@@ -64,12 +65,55 @@ void resize_q_8w_linear_node(
   out->virtual_resize(new_out_sizes);
 }
 
+void add_q_8w_linear_coopmat_buffer_node(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef q_mat2_data,
+    const ValueRef scales_data,
+    const ValueRef out) {
+  ValueRef q_mat2 = prepack_standard(
+      graph, q_mat2_data, graph.storage_type_of(out), utils::kWidthPacked);
+  ValueRef scales = prepack_standard(
+      graph, scales_data, graph.storage_type_of(out), utils::kWidthPacked);
+
+  std::string kernel_name = "q_8w_linear_coopmat_buffer";
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  graph.execute_nodes().emplace_back(new DispatchNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      coopmat_matmul_global_wg_size(graph, out),
+      {kCoopMatWorkGroupSize, 1u, 1u},
+      // Inputs and Outputs
+      {{out, vkapi::MemoryAccessType::WRITE},
+       {{mat1, q_mat2, scales}, vkapi::MemoryAccessType::READ}},
+      // Shader params buffers
+      {
+          graph.sizes_ubo(out),
+          graph.strides_ubo(out),
+          graph.sizes_ubo(mat1),
+          graph.strides_ubo(mat1),
+          graph.strides_ubo(q_mat2),
+      },
+      // Specialization Constants
+      {/* mat2_is_transposed = */ 1},
+      // Resizing Logic
+      resize_q_8w_linear_node));
+}
+
 void add_q_8w_linear_node(
     ComputeGraph& graph,
     const ValueRef mat1,
     const ValueRef q_mat2_data,
     const ValueRef scales_data,
     const ValueRef out) {
+  // The int8 weights are dequantized to fp16 as they are loaded
+  if (can_use_coopmat_matmul(graph, out) && graph.int8_buffers_enabled()) {
+    add_q_8w_linear_coopmat_buffer_node(
+        graph, mat1, q_mat2_data, scales_data, out);
+    return;
+  }
+
   auto viewFn = VK_GET_OP_FN("aten.view_copy.default");
   ValueRef mat1_W_packed = mat1;
   ValueRef out_W_packed = out;
@@ -270,10 +314,11 @@ void resize_q_4w_linear_node(
 
   vTensorPtr out = graph->get_tensor(args[0].refs[0]);
   vTensorPtr mat1 = graph->get_tensor(args[1].refs[0]);
-  vTensorPtr mat2 = graph->get_tensor(args[1].refs[1]);
 
   const int out_cols = utils::val_at(-2, mat1->sizes());
-  const int out_rows = utils::val_at(-2, mat2->sizes());
+  // The weights may be prepacked, so take the number of output channels from
+  // the output, which never changes
+  const int out_rows = utils::val_at(-1, out->sizes());
 
   std::vector<int64_t> new_out_sizes(3);
   if (mat1->sizes().size() == 2) {
@@ -289,6 +334,85 @@ void resize_q_4w_linear_node(
   out->virtual_resize(new_out_sizes);
 }
 
+ValueRef prepack_q_4w_linear_weights(
+    ComputeGraph& graph,
+    const ValueRef mat2_data) {
+  const std::vector<int64_t> orig_sizes = graph.sizes_of(mat2_data);
+  const int64_t N = orig_sizes.at(0);
+  const int64_t K = orig_sizes.at(1) * 2;
+
+  // Each ivec4 holds the weights of 4 output channels for 8 input channels
+  const int64_t num_n4 = utils::div_up_4(N);
+  const int64_t num_k8 = K / 8;
+  ValueRef qmat2 = graph.add_tensor(
+      {num_n4, num_k8, 4}, vkapi::kInt, utils::kBuffer, utils::kWidthPacked);
+
+  const utils::uvec3 global_wg_size = {
+      utils::safe_downcast<uint32_t>(num_k8),
+      utils::safe_downcast<uint32_t>(num_n4),
+      1u};
+
+  graph.prepack_nodes().emplace_back(new PrepackNode(
+      graph,
+      VK_KERNEL_FROM_STR("q_4w_linear_prepack_weights"),
+      global_wg_size,
+      graph.create_local_wg_size(global_wg_size),
+      mat2_data,
+      qmat2,
+      {graph.create_params_buffer(
+          utils::make_ivec2(orig_sizes, /*reverse = */ true))},
+      // Specialization constants
+      {}));
+
+  return qmat2;
+}
+
+void add_q_4w_linear_tiled_node(
+    ComputeGraph& graph,
+    const ValueRef mat1,
+    const ValueRef mat2_data,
+    const uint32_t group_size_val,
+    const ValueRef scales_and_zeros_data,
+    const ValueRef out) {
+  ValueRef qmat2 = prepack_q_4w_linear_weights(graph, mat2_data);
+
+  ValueRef scales_and_zeros = prepack_standard(
+      graph,
+      scales_and_zeros_data,
+      graph.storage_type_of(out),
+      utils::kWidthPacked);
+
+  // Use a GEMV shader when there are too few rows in mat1 to share the
+  // dequantized weights between
+  const uint32_t M = graph.size_at<uint32_t>(-2, mat1);
+  const uint32_t tile_rows = M < 4 ? 1u : 4u;
+
+  std::string kernel_name = "q_4w_linear_tiled";
+  add_storage_type_suffix(kernel_name, graph.storage_type_of(out));
+  kernel_name += tile_rows == 1u ? "_tile_row_1" : "_tile_row_4";
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  utils::uvec3 global_wg_size = graph.logical_limits_of(out);
+  global_wg_size = utils::divup_vec(global_wg_size, {1u, tile_rows, 1u});
+  utils::uvec3 local_wg_size = graph.create_local_wg_size(global_wg_size);
+
+  graph.execute_nodes().emplace_back(new DispatchNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      global_wg_size,
+      local_wg_size,
+      // Inputs and Outputs
+      {{out, vkapi::MemoryAccessType::WRITE},
+       {{mat1, qmat2, scales_and_zeros}, vkapi::MemoryAccessType::READ}},
+      // Shader params buffers
+      {graph.logical_limits_ubo(out), graph.sizes_ubo(mat1)},
+      // Specialization Constants
+      {SV(group_size_val)},
+      // Resizing Logic
+      resize_q_4w_linear_node,
+      {}));
+}
+
 void add_q_4w_linear_node(
     ComputeGraph& graph,
     const ValueRef mat1,
@@ -299,6 +423,14 @@ void add_q_4w_linear_node(
   check_q_4w_linear_args(
       graph, mat1, mat2_data, group_size, scales_and_zeros_data, out);
 
+  // Prepack the weights so that 8 values of 4 output channels can be loaded at
+  // once, provided that the groups are made of whole loads
+  const uint32_t group_size_val = graph.extract_scalar<uint32_t>(group_size);
+  if (group_size_val % 8 == 0) {
+    return add_q_4w_linear_tiled_node(
+        graph, mat1, mat2_data, group_size_val, scales_and_zeros_data, out);
+  }
+
   utils::StorageType storage_type = graph.storage_type_of(out);
 
   ValueRef mat2 = prepack_direct_copy_buffer(graph, mat2_data);
@@ -313,8 +445,6 @@ void add_q_4w_linear_node(
   add_storage_type_suffix(kernel_name, storage_type);
   add_dtype_suffix(kernel_name, graph.dtype_of(out));
 
-  const uint32_t group_size_val = graph.extract_scalar<uint32_t>(group_size);
-
   vkapi::ParamsBindList ubos({});
   ubos.append(graph.logical_limits_ubo(out));
   ubos.append(graph.sizes_ubo(mat1));
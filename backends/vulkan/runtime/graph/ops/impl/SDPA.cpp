@@ -176,6 +176,65 @@ void resize_sdpa_out(
   graph->get_tensor(out)->virtual_resize(graph->sizes_of(q_projected));
 }
 
+// The number of keys that sdpa_flash_attention scores at a time, which is also
+// its local work group size. Must match TILE_SIZE in the shader.
+constexpr uint32_t kFlashAttentionTileSize = 64u;
+
+bool can_use_flash_attention(
+    ComputeGraph& graph,
+    const ValueRef q_projected,
+    const ValueRef out) {
+  // Each thread of the work group accumulates one texel of the head dim
+  return !graph.is_buffer_storage(q_projected) &&
+      graph.packed_dim_of(out) == WHCN::kWidthDim &&
+      utils::div_up_4(graph.size_at<uint32_t>(-1, q_projected)) <=
+      kFlashAttentionTileSize;
+}
+
+void add_flash_attention_node(
+    ComputeGraph& graph,
+    const ValueRef input_pos_symint,
+    const ValueRef q_projected,
+    const ValueRef k_cache,
+    const ValueRef v_cache,
+    const ValueRef out) {
+  std::string kernel_name("sdpa_flash_attention");
+  add_storage_type_suffix(kernel_name, graph.storage_type_of(out));
+  add_dtype_suffix(kernel_name, graph.dtype_of(out));
+
+  const int32_t head_dim_size = graph.size_at<int32_t>(-1, q_projected);
+  const float scale_val = 1.0f / std::sqrt(static_cast<float>(head_dim_size));
+
+  const int32_t num_heads = graph.size_at<int32_t>(2, q_projected);
+  const int32_t num_kv_heads = graph.size_at<int32_t>(2, k_cache);
+
+  // One work group per query token and head. The sequence length of q at this
+  // point is the largest it will be resized to.
+  const utils::uvec3 global_size = {
+      kFlashAttentionTileSize,
+      graph.size_at<uint32_t>(2, q_projected),
+      graph.size_at<uint32_t>(1, q_projected)};
+  const utils::uvec3 local_size = {kFlashAttentionTileSize, 1u, 1u};
+
+  graph.execute_nodes().emplace_back(new DispatchNode(
+      graph,
+      VK_KERNEL_FROM_STR(kernel_name),
+      global_size,
+      local_size,
+      // Inputs and Outputs
+      {{out, vkapi::kWrite},
+       {{q_projected, k_cache, v_cache}, vkapi::kRead}},
+      // Shader param buffers
+      {graph.sizes_ubo(q_projected),
+       graph.get_or_create_int_param_buffer(input_pos_symint),
+       graph.create_params_buffer(scale_val)},
+      // Specialization Constants
+      {num_heads / num_kv_heads},
+      // Resizing Logic
+      resize_sdpa_out,
+      {q_projected, out}));
+}
+
 void sdpa_with_kv_cache_impl(
     ComputeGraph& graph,
     const std::vector<ValueRef>& args) {
@@ -232,6 +291,14 @@ void sdpa_with_kv_cache_impl(
   add_kv_cache_update_node(graph, input_pos_symint, k_projected, k_cache);
   add_kv_cache_update_node(graph, input_pos_symint, v_projected, v_cache);
 
+  // Compute attention in a single dispatch where possible, which avoids
+  // writing out the (seq_len, input_pos + seq_len) attention weights
+  if (can_use_flash_attention(graph, q_projected, out)) {
+    add_flash_attention_node(
+        graph, input_pos_symint, q_projected, k_cache, v_cache, out);
+    return;
+  }
+
   // Slice caches from 0 to input_pos + sequence_len
   const ValueRef k_cache_sliced = graph.add_tensor_view(k_cache);
   const ValueRef v_cache_sliced = graph.add_tensor_view(v_cache);
@@ -26,7 +26,9 @@ void add_staging_to_tensor_node(
   VK_CHECK_COND(graph.val_is_staging(in_staging));
 
   vkapi::ShaderInfo shader = get_nchw_to_tensor_shader(
-      *graph.get_tensor(out_tensor), graph.int8_buffers_enabled());
+      *graph.get_tensor(out_tensor),
+      graph.int8_buffers_enabled(),
+      graph.get_staging(in_staging)->dtype());
 
   vkapi::ParamsBindList ubos;
   if (graph.is_buffer_storage(out_tensor)) {
@@ -22,10 +22,23 @@ bool is_bitw8(vkapi::ScalarType dtype) {
 
 vkapi::ShaderInfo get_nchw_to_tensor_shader(
     const api::vTensor& v_dst,
-    const bool int8_buffer_enabled) {
+    const bool int8_buffer_enabled,
+    const vkapi::ScalarType staging_dtype) {
   std::string kernel_name;
   kernel_name.reserve(kShaderNameReserve);
 
+  if (staging_dtype != vkapi::ScalarType::Undefined &&
+      staging_dtype != v_dst.dtype()) {
+    VK_CHECK_COND(
+        staging_dtype == vkapi::kFloat && v_dst.dtype() == vkapi::kHalf &&
+            v_dst.storage_type() != utils::kBuffer,
+        "Only fp32 staging data of fp16 texture tensors is converted");
+    kernel_name = "nchw_to_image_from_float";
+    add_storage_type_suffix(kernel_name, v_dst);
+    add_dtype_suffix(kernel_name, v_dst);
+    return VK_KERNEL_FROM_STR(kernel_name);
+  }
+
   if (is_bitw8(v_dst.dtype()) && v_dst.storage_type() != utils::kBuffer &&
       !int8_buffer_enabled) {
     kernel_name = "nchw_to_bitw8_image_nobitw8buffer";
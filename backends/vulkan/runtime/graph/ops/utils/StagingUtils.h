@@ -12,9 +12,16 @@
 
 namespace vkcompute {
 
+/*
+ * Returns the shader that copies the NCHW data of a staging buffer into
+ * `v_dst`. If `staging_dtype` is given and differs from the dtype of `v_dst`,
+ * the shader also converts the data, which is supported for fp32 staging data
+ * of fp16 texture tensors.
+ */
 vkapi::ShaderInfo get_nchw_to_tensor_shader(
     const api::vTensor& v_dst,
-    bool int8_buffer_enabled = true);
+    bool int8_buffer_enabled = true,
+    const vkapi::ScalarType staging_dtype = vkapi::ScalarType::Undefined);
 vkapi::ShaderInfo get_tensor_to_nchw_shader(
     const api::vTensor& v_src,
     bool int8_buffer_enabled = true);
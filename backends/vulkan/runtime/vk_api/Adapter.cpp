@@ -82,6 +82,9 @@ VkDevice create_logical_device(
 #ifdef VK_KHR_shader_float16_int8
       VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME,
 #endif /* VK_KHR_shader_float16_int8 */
+#ifdef VK_KHR_cooperative_matrix
+      VK_KHR_COOPERATIVE_MATRIX_EXTENSION_NAME,
+#endif /* VK_KHR_cooperative_matrix */
   };
 
   std::vector<const char*> enabled_device_extensions;
@@ -154,10 +157,19 @@ Adapter::Adapter(
       shader_layout_cache_(device_.handle),
       shader_cache_(device_.handle),
       pipeline_layout_cache_(device_.handle),
-      compute_pipeline_cache_(device_.handle, cache_data_path),
+      compute_pipeline_cache_(
+          device_.handle,
+          physical_device_.properties,
+          cache_data_path),
+      local_wg_size_cache_(physical_device_.properties),
       sampler_cache_(device_.handle),
       vma_(instance_, physical_device_.handle, device_.handle),
       linear_tiling_3d_enabled_{true} {
+  // Keep the tuned local work group sizes next to the pipeline cache data
+  if (!cache_data_path.empty()) {
+    local_wg_size_cache_.set_cache_data_path(cache_data_path + ".wg_sizes");
+  }
+
   // Test creating a 3D image with linear tiling to see if it is supported.
   // According to the Vulkan spec, linear tiling may not be supported for 3D
   // images.
@@ -305,6 +317,13 @@ std::string Adapter::stringize() const {
   ss << "    }" << std::endl;
 #endif /* VK_KHR_shader_float16_int8 */
 
+#ifdef VK_KHR_cooperative_matrix
+  ss << "    Cooperative Matrix Features {" << std::endl;
+  PRINT_PROP(physical_device_.cooperative_matrix_features, cooperativeMatrix);
+  PRINT_PROP(physical_device_, supports_fp16_cooperative_matrix);
+  ss << "    }" << std::endl;
+#endif /* VK_KHR_cooperative_matrix */
+
   const VkPhysicalDeviceMemoryProperties& mem_props =
       physical_device_.memory_properties;
 
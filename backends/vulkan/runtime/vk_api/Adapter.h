@@ -89,6 +89,7 @@ class Adapter final {
   ShaderCache shader_cache_;
   PipelineLayoutCache pipeline_layout_cache_;
   ComputePipelineCache compute_pipeline_cache_;
+  LocalWorkGroupSizeCache local_wg_size_cache_;
   // Memory Management
   SamplerCache sampler_cache_;
   Allocator vma_;
@@ -145,6 +146,10 @@ class Adapter final {
     return compute_pipeline_cache_;
   }
 
+  inline LocalWorkGroupSizeCache& local_wg_size_cache() {
+    return local_wg_size_cache_;
+  }
+
   // Memory Allocation
 
   inline SamplerCache& sampler_cache() {
@@ -199,6 +204,10 @@ class Adapter final {
     return physical_device_.supports_int16_shader_types;
   }
 
+  inline bool supports_fp16_cooperative_matrix() {
+    return physical_device_.supports_fp16_cooperative_matrix;
+  }
+
   inline bool has_full_float16_buffers_support() {
     return supports_16bit_storage_buffers() && supports_float16_shader_types();
   }
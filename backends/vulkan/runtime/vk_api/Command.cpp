@@ -29,10 +29,11 @@ CommandBuffer::CommandBuffer(
 CommandBuffer::CommandBuffer(CommandBuffer&& other) noexcept
     : handle_(other.handle_),
       flags_(other.flags_),
-      state_(CommandBuffer::State::INVALID),
+      state_(other.state_),
       bound_(other.bound_) {
   other.handle_ = VK_NULL_HANDLE;
   other.bound_.reset();
+  other.state_ = CommandBuffer::State::INVALID;
 }
 
 CommandBuffer& CommandBuffer::operator=(CommandBuffer&& other) noexcept {
@@ -178,6 +179,41 @@ void CommandBuffer::insert_barrier(PipelineBarrier& pipeline_barrier) {
   state_ = CommandBuffer::State::BARRIERS_INSERTED;
 }
 
+void CommandBuffer::insert_global_barrier() {
+  VK_CHECK_COND(
+      state_ == CommandBuffer::State::RECORDING,
+      "Vulkan CommandBuffer: called insert_global_barrier() on a command "
+      "buffer whose state is not RECORDING.");
+
+  const VkAccessFlags src_access =
+      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+  const VkAccessFlags dst_access = VK_ACCESS_SHADER_READ_BIT |
+      VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+      VK_ACCESS_TRANSFER_WRITE_BIT;
+
+  const VkMemoryBarrier memory_barrier{
+      VK_STRUCTURE_TYPE_MEMORY_BARRIER, // sType
+      nullptr, // pNext
+      src_access, // srcAccessMask
+      dst_access, // dstAccessMask
+  };
+
+  const VkPipelineStageFlags stages =
+      VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+  vkCmdPipelineBarrier(
+      handle_, // commandBuffer
+      stages, // srcStageMask
+      stages, // dstStageMask
+      0u, // dependencyFlags
+      1u, // memoryBarrierCount
+      &memory_barrier, // pMemoryBarriers
+      0u, // bufferMemoryBarrierCount
+      nullptr, // pBufferMemoryBarriers
+      0u, // imageMemoryBarrierCount
+      nullptr); // pImageMemoryBarriers
+}
+
 void CommandBuffer::dispatch(const utils::uvec3& global_workgroup_size) {
   VK_CHECK_COND(
       state_ == CommandBuffer::State::BARRIERS_INSERTED,
@@ -194,6 +230,17 @@ void CommandBuffer::dispatch(const utils::uvec3& global_workgroup_size) {
   state_ = CommandBuffer::State::RECORDING;
 }
 
+void CommandBuffer::dispatch_indirect(const VulkanBuffer& indirect_buffer) {
+  VK_CHECK_COND(
+      state_ == CommandBuffer::State::BARRIERS_INSERTED,
+      "Vulkan CommandBuffer: called dispatch_indirect() on a command buffer "
+      "whose state is not BARRIERS_INSERTED.");
+
+  vkCmdDispatchIndirect(handle_, indirect_buffer.handle(), 0u);
+
+  state_ = CommandBuffer::State::RECORDING;
+}
+
 void CommandBuffer::blit(vkapi::VulkanImage& src, vkapi::VulkanImage& dst) {
   VK_CHECK_COND(
       state_ == CommandBuffer::State::BARRIERS_INSERTED,
@@ -92,7 +92,13 @@ class CommandBuffer final {
   void set_push_constants(VkPipelineLayout, const void*, uint32_t);
 
   void insert_barrier(PipelineBarrier& pipeline_barrier);
+  // Makes all compute and transfer work submitted before, including that of
+  // earlier submissions, complete and visible before any work recorded after
+  void insert_global_barrier();
   void dispatch(const utils::uvec3&);
+  // Dispatches the workgroup counts in a VkDispatchIndirectCommand that the
+  // buffer holds, which can change without recording the dispatch again
+  void dispatch_indirect(const VulkanBuffer&);
   void blit(vkapi::VulkanImage& src, vkapi::VulkanImage& dst);
 
   void write_timestamp(VkQueryPool, const uint32_t) const;
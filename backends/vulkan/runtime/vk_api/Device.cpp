@@ -18,7 +18,64 @@
 namespace vkcompute {
 namespace vkapi {
 
-PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device_handle)
+namespace {
+
+bool has_device_extension(
+    VkPhysicalDevice physical_device,
+    const char* extension_name) {
+  uint32_t count = 0;
+  VK_CHECK(vkEnumerateDeviceExtensionProperties(
+      physical_device, nullptr, &count, nullptr));
+  std::vector<VkExtensionProperties> properties(count);
+  VK_CHECK(vkEnumerateDeviceExtensionProperties(
+      physical_device, nullptr, &count, properties.data()));
+
+  for (const VkExtensionProperties& p : properties) {
+    if (strcmp(p.extensionName, extension_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+#ifdef VK_KHR_cooperative_matrix
+bool has_fp16_cooperative_matrix_shape(
+    VkInstance instance,
+    VkPhysicalDevice physical_device) {
+  // Not exported by the loader, so it must be looked up
+  const auto get_properties =
+      reinterpret_cast<PFN_vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR>(
+          vkGetInstanceProcAddr(
+              instance, "vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR"));
+  if (get_properties == nullptr) {
+    return false;
+  }
+
+  uint32_t count = 0;
+  VK_CHECK(get_properties(physical_device, &count, nullptr));
+  std::vector<VkCooperativeMatrixPropertiesKHR> properties(
+      count, {VK_STRUCTURE_TYPE_COOPERATIVE_MATRIX_PROPERTIES_KHR});
+  VK_CHECK(get_properties(physical_device, &count, properties.data()));
+
+  for (const VkCooperativeMatrixPropertiesKHR& p : properties) {
+    if (p.MSize == 16u && p.NSize == 16u && p.KSize == 16u &&
+        p.AType == VK_COMPONENT_TYPE_FLOAT16_KHR &&
+        p.BType == VK_COMPONENT_TYPE_FLOAT16_KHR &&
+        p.CType == VK_COMPONENT_TYPE_FLOAT32_KHR &&
+        p.ResultType == VK_COMPONENT_TYPE_FLOAT32_KHR &&
+        p.scope == VK_SCOPE_SUBGROUP_KHR) {
+      return true;
+    }
+  }
+  return false;
+}
+#endif /* VK_KHR_cooperative_matrix */
+
+} // namespace
+
+PhysicalDevice::PhysicalDevice(
+    VkInstance instance,
+    VkPhysicalDevice physical_device_handle)
     : handle(physical_device_handle),
       properties{},
       memory_properties{},
@@ -34,10 +91,15 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device_handle)
       shader_float16_int8_types{
           VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR},
 #endif /* VK_KHR_shader_float16_int8 */
+#ifdef VK_KHR_cooperative_matrix
+      cooperative_matrix_features{
+          VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_KHR},
+#endif /* VK_KHR_cooperative_matrix */
       extension_features{nullptr},
       queue_families{},
       num_compute_queues(0),
       supports_int16_shader_types(false),
+      supports_fp16_cooperative_matrix(false),
       has_unified_memory(false),
       has_timestamps(properties.limits.timestampComputeAndGraphics),
       timestamp_period(properties.limits.timestampPeriod) {
@@ -79,12 +141,34 @@ PhysicalDevice::PhysicalDevice(VkPhysicalDevice physical_device_handle)
   shader_float16_int8_types.pNext = nullptr;
 #endif
 
+  // The cooperative matrix features are only chained in, and so requested
+  // when creating the device, if the device has the extension.
+#ifdef VK_KHR_cooperative_matrix
+  const bool has_cooperative_matrix_extension = has_device_extension(
+      handle, VK_KHR_COOPERATIVE_MATRIX_EXTENSION_NAME);
+  if (has_cooperative_matrix_extension) {
+    cooperative_matrix_features.pNext = features2.pNext;
+    features2.pNext = &cooperative_matrix_features;
+    extension_features = &cooperative_matrix_features;
+  }
+#endif /* VK_KHR_cooperative_matrix */
+
   vkGetPhysicalDeviceFeatures2(handle, &features2);
 
   if (features2.features.shaderInt16 == VK_TRUE) {
     supports_int16_shader_types = true;
   }
 
+#ifdef VK_KHR_cooperative_matrix
+  if (has_cooperative_matrix_extension &&
+      cooperative_matrix_features.cooperativeMatrix == VK_TRUE) {
+    supports_fp16_cooperative_matrix =
+        has_fp16_cooperative_matrix_shape(instance, handle);
+  }
+#else
+  (void)instance;
+#endif /* VK_KHR_cooperative_matrix */
+
   // Check if there are any memory types have both the HOST_VISIBLE and the
   // DEVICE_LOCAL property flags
   const VkMemoryPropertyFlags unified_memory_flags =
@@ -8,7 +8,11 @@
 
 #include <executorch/backends/vulkan/runtime/vk_api/Pipeline.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <sstream>
 
 namespace vkcompute {
 namespace vkapi {
@@ -366,12 +370,22 @@ void PipelineLayoutCache::purge() {
 
 ComputePipelineCache::ComputePipelineCache(
     VkDevice device,
+    const VkPhysicalDeviceProperties& device_properties,
     const std::string& cache_data_path)
     : cache_mutex_{},
       device_(device),
+      vendor_id_(device_properties.vendorID),
+      device_id_(device_properties.deviceID),
+      pipeline_cache_uuid_{},
       pipeline_cache_{VK_NULL_HANDLE},
       cache_{},
-      cache_data_path_(cache_data_path) {
+      cache_data_path_(cache_data_path),
+      saved_data_size_(0u) {
+  std::copy(
+      std::begin(device_properties.pipelineCacheUUID),
+      std::end(device_properties.pipelineCacheUUID),
+      pipeline_cache_uuid_.begin());
+
   VkPipelineCacheCreateInfo pipeline_cache_create_info{};
 
   auto buffer = load_cache();
@@ -386,14 +400,20 @@ ComputePipelineCache::ComputePipelineCache(
 
   VK_CHECK(vkCreatePipelineCache(
       device, &pipeline_cache_create_info, nullptr, &pipeline_cache_));
+  saved_data_size_ = buffer.size();
 }
 
 ComputePipelineCache::ComputePipelineCache(
     ComputePipelineCache&& other) noexcept
     : cache_mutex_{},
       device_(other.device_),
+      vendor_id_(other.vendor_id_),
+      device_id_(other.device_id_),
+      pipeline_cache_uuid_(other.pipeline_cache_uuid_),
       pipeline_cache_(other.pipeline_cache_),
-      cache_(std::move(other.cache_)) {
+      cache_(std::move(other.cache_)),
+      cache_data_path_(std::move(other.cache_data_path_)),
+      saved_data_size_(other.saved_data_size_) {
   std::lock_guard<std::mutex> lock(other.cache_mutex_);
 
   other.pipeline_cache_ = VK_NULL_HANDLE;
@@ -430,6 +450,53 @@ void ComputePipelineCache::purge() {
   cache_.clear();
 }
 
+void ComputePipelineCache::set_cache_data_path(const std::string& path) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+
+  cache_data_path_ = path;
+  auto buffer = load_cache();
+  if (buffer.empty()) {
+    return;
+  }
+
+  const VkPipelineCacheCreateInfo pipeline_cache_create_info{
+      VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO, // sType
+      nullptr, // pNext
+      0u, // flags
+      buffer.size(), // initialDataSize
+      buffer.data(), // pInitialData
+  };
+
+  VkPipelineCache loaded_cache{VK_NULL_HANDLE};
+  VK_CHECK(vkCreatePipelineCache(
+      device_, &pipeline_cache_create_info, nullptr, &loaded_cache));
+  const VkResult result =
+      vkMergePipelineCaches(device_, pipeline_cache_, 1u, &loaded_cache);
+  vkDestroyPipelineCache(device_, loaded_cache, nullptr);
+  VK_CHECK(result);
+
+  size_t size{};
+  VK_CHECK(vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr));
+  saved_data_size_ = size;
+}
+
+bool ComputePipelineCache::is_compatible(const std::vector<char>& data) const {
+  // Drivers are required to ignore incompatible data, but some crash on it,
+  // so check the header that every cache data begins with.
+  VkPipelineCacheHeaderVersionOne header{};
+  if (data.size() < sizeof(header)) {
+    return false;
+  }
+  std::memcpy(&header, data.data(), sizeof(header));
+  return header.headerSize >= sizeof(header) &&
+      header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+      header.vendorID == vendor_id_ && header.deviceID == device_id_ &&
+      std::equal(
+             pipeline_cache_uuid_.begin(),
+             pipeline_cache_uuid_.end(),
+             std::begin(header.pipelineCacheUUID));
+}
+
 std::vector<char> ComputePipelineCache::load_cache() {
   // No optimization if path is unspecified
   if (cache_data_path_.empty()) {
@@ -448,29 +515,167 @@ std::vector<char> ComputePipelineCache::load_cache() {
   std::vector<char> buffer(size);
   file.read(buffer.data(), size);
 
+  // The data was saved by another driver or device, e.g. before an update
+  if (file.fail() || !is_compatible(buffer)) {
+    return {};
+  }
+
   return buffer;
 }
 
 void ComputePipelineCache::save_cache() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+
   // No optimization if path is unspecified
   if (cache_data_path_.empty()) {
     return;
   }
 
-  // Return if file exists; the cache is already saved
-  std::ifstream ifile(cache_data_path_);
-  if (ifile.good()) {
+  size_t size{};
+  if (vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr) !=
+      VK_SUCCESS) {
     return;
   }
 
-  size_t size{};
-  vkGetPipelineCacheData(device_, pipeline_cache_, &size, nullptr);
+  // Return if no pipeline was added; the cache is already saved
+  if (size <= saved_data_size_) {
+    return;
+  }
 
   std::vector<char> buffer(size);
-  vkGetPipelineCacheData(device_, pipeline_cache_, &size, buffer.data());
+  if (vkGetPipelineCacheData(device_, pipeline_cache_, &size, buffer.data()) !=
+      VK_SUCCESS) {
+    return;
+  }
+  buffer.resize(size);
+
+  const std::string tmp_path = cache_data_path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(buffer.data(), buffer.size());
+    file.close();
+    if (file.fail()) {
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), cache_data_path_.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  saved_data_size_ = size;
+}
+
+//
+// LocalWorkGroupSizeCache
+//
 
-  std::ofstream file(cache_data_path_, std::ios::binary);
-  file.write(buffer.data(), buffer.size());
+LocalWorkGroupSizeCache::LocalWorkGroupSizeCache(
+    const VkPhysicalDeviceProperties& device_properties)
+    : cache_mutex_{},
+      vendor_id_(device_properties.vendorID),
+      device_id_(device_properties.deviceID),
+      driver_version_(device_properties.driverVersion),
+      cache_{},
+      cache_data_path_{},
+      modified_(false) {}
+
+std::string LocalWorkGroupSizeCache::key_of(
+    const std::string& kernel_name,
+    const utils::uvec3& global_wg_size) {
+  std::stringstream ss;
+  ss << kernel_name << " " << global_wg_size[0u] << " " << global_wg_size[1u]
+     << " " << global_wg_size[2u];
+  return ss.str();
+}
+
+std::string LocalWorkGroupSizeCache::device_header() const {
+  std::stringstream ss;
+  ss << vendor_id_ << " " << device_id_ << " " << driver_version_;
+  return ss.str();
+}
+
+bool LocalWorkGroupSizeCache::find(
+    const std::string& kernel_name,
+    const utils::uvec3& global_wg_size,
+    utils::uvec3& local_wg_size) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+
+  auto it = cache_.find(key_of(kernel_name, global_wg_size));
+  if (it == cache_.end()) {
+    return false;
+  }
+  local_wg_size = it->second;
+  return true;
+}
+
+void LocalWorkGroupSizeCache::insert(
+    const std::string& kernel_name,
+    const utils::uvec3& global_wg_size,
+    const utils::uvec3& local_wg_size) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+
+  cache_[key_of(kernel_name, global_wg_size)] = local_wg_size;
+  modified_ = true;
+}
+
+void LocalWorkGroupSizeCache::set_cache_data_path(const std::string& path) {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+
+  cache_data_path_ = path;
+  if (cache_data_path_.empty()) {
+    return;
+  }
+
+  std::ifstream file(cache_data_path_);
+  std::string line;
+  // Sizes tuned on another device or driver are of no use
+  if (!std::getline(file, line) || line != device_header()) {
+    return;
+  }
+
+  // Each line holds a kernel name, then a global and a local work group size
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    std::string kernel_name;
+    utils::uvec3 global_wg_size;
+    utils::uvec3 local_wg_size;
+    if (ss >> kernel_name >> global_wg_size[0u] >> global_wg_size[1u] >>
+        global_wg_size[2u] >> local_wg_size[0u] >> local_wg_size[1u] >>
+        local_wg_size[2u]) {
+      cache_.emplace(key_of(kernel_name, global_wg_size), local_wg_size);
+    }
+  }
+}
+
+void LocalWorkGroupSizeCache::save_cache() {
+  std::lock_guard<std::mutex> lock(cache_mutex_);
+
+  // No optimization if path is unspecified
+  if (cache_data_path_.empty() || !modified_) {
+    return;
+  }
+
+  const std::string tmp_path = cache_data_path_ + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::trunc);
+    file << device_header() << "\n";
+    for (const auto& entry : cache_) {
+      const utils::uvec3& local_wg_size = entry.second;
+      file << entry.first << " " << local_wg_size[0u] << " "
+           << local_wg_size[1u] << " " << local_wg_size[2u] << "\n";
+    }
+    file.close();
+    if (file.fail()) {
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), cache_data_path_.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  modified_ = false;
 }
 
 } // namespace vkapi
@@ -17,7 +17,9 @@
 #include <executorch/backends/vulkan/runtime/vk_api/memory/Buffer.h>
 #include <executorch/backends/vulkan/runtime/vk_api/memory/Image.h>
 
+#include <array>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 
 #define SV(x) ::vkcompute::vkapi::SpecVar(x)
@@ -216,10 +218,18 @@ class PipelineLayoutCache final {
   void purge();
 };
 
+//
+// Caches compute pipelines, and backs their VkPipelineCache with a file so that
+// later processes create them without compiling their shaders. The file is
+// only used if its header matches the vendor, device and pipelineCacheUUID of
+// the driver, which identify the drivers that can use its data.
+//
+
 class ComputePipelineCache final {
  public:
   explicit ComputePipelineCache(
       VkDevice device,
+      const VkPhysicalDeviceProperties& device_properties,
       const std::string& cache_data_path);
 
   ComputePipelineCache(const ComputePipelineCache&) = delete;
@@ -269,25 +279,97 @@ class ComputePipelineCache final {
     }
   };
 
+  // Merges the pipeline cache data saved at path, if any, into the cache, and
+  // saves the cache there from now on. Call this before compiling models to
+  // skip compiling the shaders that they share with previous processes.
+  void set_cache_data_path(const std::string& path);
+
+  // Writes the pipeline cache data to the cache data path, unless no pipeline
+  // was added since it was loaded or saved. Writes a temporary file first, so
+  // that concurrent processes never read a partial file.
   void save_cache();
 
  private:
   std::vector<char> load_cache();
+  bool is_compatible(const std::vector<char>& data) const;
 
   // Multiple threads could potentially be adding entries into the cache, so use
   // a mutex to manage access
   std::mutex cache_mutex_;
 
   VkDevice device_;
+  // Identify the cache data that the driver can use
+  uint32_t vendor_id_;
+  uint32_t device_id_;
+  std::array<uint8_t, VK_UUID_SIZE> pipeline_cache_uuid_;
   VkPipelineCache pipeline_cache_;
   std::unordered_map<Key, Value, Hasher> cache_;
-  const std::string cache_data_path_;
+  std::string cache_data_path_;
+  // The size of the pipeline cache data when it was last loaded or saved
+  size_t saved_data_size_;
 
  public:
   VkPipeline retrieve(const Key&);
   void purge();
 };
 
+//
+// Remembers the local work group size that was measured to run each shader
+// fastest for a given global work group size, and backs them with a text file
+// so that later processes skip the measurements. The file records the vendor,
+// device and driver version that the sizes were tuned on, and is ignored on any
+// other, since the best sizes differ a lot between GPUs.
+//
+
+class LocalWorkGroupSizeCache final {
+ public:
+  explicit LocalWorkGroupSizeCache(
+      const VkPhysicalDeviceProperties& device_properties);
+
+  LocalWorkGroupSizeCache(const LocalWorkGroupSizeCache&) = delete;
+  LocalWorkGroupSizeCache& operator=(const LocalWorkGroupSizeCache&) = delete;
+
+  LocalWorkGroupSizeCache(LocalWorkGroupSizeCache&&) = delete;
+  LocalWorkGroupSizeCache& operator=(LocalWorkGroupSizeCache&&) = delete;
+
+  ~LocalWorkGroupSizeCache() = default;
+
+  // Returns false if no local work group size was tuned for the arguments
+  bool find(
+      const std::string& kernel_name,
+      const utils::uvec3& global_wg_size,
+      utils::uvec3& local_wg_size);
+
+  void insert(
+      const std::string& kernel_name,
+      const utils::uvec3& global_wg_size,
+      const utils::uvec3& local_wg_size);
+
+  // Adds the sizes saved at path, if any, to the cache, and saves the cache
+  // there from now on.
+  void set_cache_data_path(const std::string& path);
+
+  // Writes the cache to the cache data path, unless nothing was inserted since
+  // it was loaded or saved.
+  void save_cache();
+
+ private:
+  static std::string key_of(
+      const std::string& kernel_name,
+      const utils::uvec3& global_wg_size);
+  std::string device_header() const;
+
+  std::mutex cache_mutex_;
+
+  // Identify the device and driver that the sizes were tuned on
+  uint32_t vendor_id_;
+  uint32_t device_id_;
+  uint32_t driver_version_;
+  std::unordered_map<std::string, utils::uvec3> cache_;
+  std::string cache_data_path_;
+  bool modified_;
+};
+
 //
 // Impl
 //
@@ -194,6 +194,14 @@ QueryPool::get_shader_timestamp_data() {
   return shader_timestamp_data;
 }
 
+std::vector<ShaderDuration> QueryPool::get_shader_durations() {
+  if (querypool_ == VK_NULL_HANDLE) {
+    return {};
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  return shader_durations_;
+}
+
 std::string QueryPool::generate_string_report() {
   std::lock_guard<std::mutex> lock(mutex_);
 
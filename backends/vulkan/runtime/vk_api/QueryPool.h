@@ -99,6 +99,9 @@ class QueryPool final {
 
   std::vector<std::tuple<std::string, uint32_t, uint64_t, uint64_t>>
   get_shader_timestamp_data();
+  // Returns the properties and timings of every shader dispatch recorded since
+  // the last reset; call extract_results() first to update the timings.
+  std::vector<ShaderDuration> get_shader_durations();
   std::string generate_string_report();
   void print_results();
   unsigned long get_total_shader_ns(std::string kernel_name);
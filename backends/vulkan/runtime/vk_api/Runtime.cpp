@@ -147,7 +147,7 @@ std::vector<Runtime::DeviceMapping> create_physical_devices(
   std::vector<Runtime::DeviceMapping> device_mappings;
   device_mappings.reserve(device_count);
   for (VkPhysicalDevice physical_device : devices) {
-    device_mappings.emplace_back(PhysicalDevice(physical_device), -1);
+    device_mappings.emplace_back(PhysicalDevice(instance, physical_device), -1);
   }
 
   return device_mappings;
@@ -254,7 +254,8 @@ std::unique_ptr<Runtime> init_global_vulkan_runtime() {
 #endif /* VULKAN_DEBUG */
   const bool init_default_device = true;
   const uint32_t num_requested_queues = 1; // TODO: raise this value
-  const std::string cache_data_path = ""; // TODO: expose to client
+  // Set with ComputePipelineCache::set_cache_data_path()
+  const std::string cache_data_path = "";
 
   const RuntimeConfig default_config{
       enable_validation_messages,
@@ -62,6 +62,9 @@ struct ShaderInfo final {
 
   // Shader Metadata
   utils::uvec3 out_tile_size{1u, 1u, 1u};
+  // Whether the shader depends on its local work group size, e.g. because it
+  // uses shared memory, so that the size may not be tuned
+  bool fixed_local_wg_size{false};
 
   explicit ShaderInfo();
 
@@ -70,7 +73,8 @@ struct ShaderInfo final {
       const uint32_t*,
       const uint32_t,
       std::vector<VkDescriptorType>,
-      const utils::uvec3 tile_size);
+      const utils::uvec3 tile_size,
+      const bool fixed_local_wg_size = false);
 
   operator bool() const {
     return src_code.bin != nullptr;
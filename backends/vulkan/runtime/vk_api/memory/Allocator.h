@@ -77,6 +77,12 @@ class Allocator final {
    */
   VulkanBuffer create_uniform_buffer(const VkDeviceSize);
 
+  /*
+   * Create a host writable buffer that holds the parameters of indirect
+   * dispatches
+   */
+  VulkanBuffer create_indirect_buffer(const VkDeviceSize);
+
   /*
    * Create a uniform buffer containing the data in an arbitrary struct
    */
@@ -222,3 +222,32 @@ TEST(VulkanInt4LinearTest, test_vulkan_impl) {
       /*K = */ 128,
       /*N = */ 32);
 }
+
+TEST(VulkanInt4LinearTest, test_vulkan_impl_gemv) {
+  if (!vkcompute::api::context()
+           ->adapter_ptr()
+           ->has_full_int8_buffers_support()) {
+    GTEST_SKIP();
+  }
+  test_vulkan_linear_int4(
+      /*B = */ 1,
+      /*M = */ 1,
+      /*K = */ 256,
+      /*N = */ 64,
+      /*group_size = */ 64);
+}
+
+TEST(VulkanInt4LinearTest, test_vulkan_impl_unpacked_weights) {
+  if (!vkcompute::api::context()
+           ->adapter_ptr()
+           ->has_full_int8_buffers_support()) {
+    GTEST_SKIP();
+  }
+  // Groups that are not a multiple of 8 long are not prepacked
+  test_vulkan_linear_int4(
+      /*B = */ 1,
+      /*M = */ 4,
+      /*K = */ 48,
+      /*N = */ 32,
+      /*group_size = */ 12);
+}
@@ -495,6 +495,27 @@ TEST(VulkanSDPATest, test_sdpa_op_llama3_params_dynamic) {
       max_seq_len);
 }
 
+TEST(VulkanSDPATest, test_sdpa_op_large_head_dim_dynamic) {
+  // The head dim is too large for the fused attention shader, so the attention
+  // weights are computed with separate matmul and softmax dispatches instead
+  const int starting_input_pos = 0;
+  const int base_sequence_len = 3;
+  const int embedding_dim = 2048;
+  const int num_heads = 4;
+  const int num_kv_heads = 2;
+  const int batch_size = 1;
+  const int max_seq_len = 12;
+
+  test_vulkan_sdpa(
+      starting_input_pos,
+      base_sequence_len,
+      embedding_dim,
+      num_heads,
+      num_kv_heads,
+      batch_size,
+      max_seq_len);
+}
+
 TEST(VulkanSDPATest, test_reference_impl) {
   const int starting_input_pos = 0;
   const int base_sequence_len = 3;
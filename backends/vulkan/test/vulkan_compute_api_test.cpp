@@ -9,6 +9,8 @@
 #include <gtest/gtest.h>
 
 #include <bitset>
+#include <cstdio>
+#include <fstream>
 #include <utility>
 #include <vector>
 
@@ -1437,6 +1439,279 @@ TEST(VulkanComputeGraphTest, test_simple_graph) {
   }
 }
 
+TEST(VulkanComputeGraphTest, test_indirect_dispatch_resize) {
+  GraphConfig config;
+  config.enable_indirect_dispatch = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {4, 16, 16};
+  std::vector<int64_t> size_small = {4, 16, 1};
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_small, vkapi::kFloat);
+
+  IOValueRef out = {};
+
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_execute();
+
+  // Run graph, resizing without re-encoding the command buffer
+
+  std::vector<std::vector<int64_t>> new_sizes_list = {
+      {4, 16, 16}, {2, 3, 5}, {4, 16, 16}, {1, 15, 9}};
+  float val_a = 1.0f;
+  for (auto& new_sizes : new_sizes_list) {
+    graph.resize_input(0, new_sizes);
+    graph.resize_input(1, {new_sizes[0], new_sizes[1], 1});
+    graph.propagate_resize();
+
+    val_a += 1.0f;
+    float val_b = val_a + 0.5f;
+    float val_c = val_a + val_b;
+
+    fill_vtensor(graph, a, val_a);
+    fill_vtensor(graph, b, val_b);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_c);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_pipelined_execution) {
+  GraphConfig config;
+  config.enable_pipelined_execution = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {4, 16, 16};
+  std::vector<int64_t> size_small = {4, 16, 1};
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_small, vkapi::kFloat);
+
+  IOValueRef out = {};
+
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_execute();
+
+  // Run graph, reading the outputs of each inference one inference later
+
+  const int num_inferences = 5;
+  auto check_outputs = [&](const int inference) {
+    float val_c = 2.0f * inference + 1.5f;
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_c);
+    }
+  };
+
+  for (int inference = 0; inference < num_inferences; ++inference) {
+    float val_a = float(inference);
+    float val_b = val_a + 1.5f;
+
+    fill_vtensor(graph, a, val_a);
+    fill_vtensor(graph, b, val_b);
+
+    EXPECT_EQ(graph.execute_pipelined(), inference > 0);
+    if (inference > 0) {
+      check_outputs(inference - 1);
+    }
+  }
+
+  EXPECT_TRUE(graph.finish_pipelined());
+  check_outputs(num_inferences - 1);
+  EXPECT_FALSE(graph.finish_pipelined());
+}
+
+TEST(VulkanComputeGraphTest, test_pipeline_cache_data_path) {
+  const std::string path =
+      ::testing::TempDir() + "vulkan_compute_api_test_pipeline_cache.bin";
+  std::remove(path.c_str());
+  vkapi::ComputePipelineCache& pipeline_cache =
+      api::context()->adapter_ptr()->compute_pipeline_cache();
+  pipeline_cache.set_cache_data_path(path);
+
+  // Create at least one pipeline, then save the cache.
+  {
+    GraphConfig config;
+    ComputeGraph graph(config);
+    IOValueRef a = graph.add_input_tensor({1, 4, 4}, vkapi::kFloat);
+    IOValueRef out = {};
+    out.value = graph.add_tensor({1, 4, 4}, vkapi::kFloat);
+    auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+    addFn(graph, {a.value, a.value, kDummyValueRef, out.value});
+    out.staging = graph.set_output_tensor(out.value);
+    graph.prepare();
+    graph.encode_execute();
+  }
+  pipeline_cache.save_cache();
+
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  ASSERT_TRUE(file.good());
+  EXPECT_GE(
+      static_cast<size_t>(file.tellg()),
+      sizeof(VkPipelineCacheHeaderVersionOne));
+  file.close();
+
+  // Loading the saved data adds no pipeline, so there is nothing to save.
+  pipeline_cache.set_cache_data_path(path);
+  std::remove(path.c_str());
+  pipeline_cache.save_cache();
+  EXPECT_FALSE(std::ifstream(path).good());
+
+  pipeline_cache.set_cache_data_path("");
+}
+
+TEST(VulkanComputeGraphTest, test_memory_aliasing) {
+  GraphConfig config;
+  config.enable_memory_aliasing = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {4, 16, 16};
+  std::vector<int64_t> size_small = {4, 16, 1};
+
+  // Build graph: a chain of additions, so that each intermediate is only live
+  // across the node that produces it and the node that consumes it
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_small, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+
+  const int num_intermediates = 4;
+  ValueRef prev = a.value;
+  for (int i = 0; i < num_intermediates; ++i) {
+    ValueRef next = graph.add_tensor(size_big, vkapi::kFloat);
+    addFn(graph, {prev, b.value, kDummyValueRef, next});
+    prev = next;
+  }
+
+  IOValueRef out = {};
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+  addFn(graph, {prev, b.value, kDummyValueRef, out.value});
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_execute();
+
+  // The inputs and the output each keep memory of their own, while the
+  // intermediates alternate between two memory blocks
+  EXPECT_TRUE(graph.aliased_objects_count() == 5);
+
+  // Run graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_a = i + 2.0f;
+    float val_b = i + 1.5f;
+    float val_out = val_a + (num_intermediates + 1) * val_b;
+
+    fill_vtensor(graph, a, val_a);
+    fill_vtensor(graph, b, val_b);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+}
+
+TEST(VulkanComputeGraphTest, test_local_wg_size_tuning) {
+  const std::string path =
+      ::testing::TempDir() + "vulkan_compute_api_test_wg_sizes.txt";
+  std::remove(path.c_str());
+  vkapi::LocalWorkGroupSizeCache& wg_size_cache =
+      api::context()->adapter_ptr()->local_wg_size_cache();
+  wg_size_cache.set_cache_data_path(path);
+
+  GraphConfig config;
+  config.enable_local_wg_size_tuning = true;
+  ComputeGraph graph(config);
+
+  std::vector<int64_t> size_big = {8, 64, 124};
+  std::vector<int64_t> size_small = {8, 1, 124};
+
+  // Build graph
+
+  IOValueRef a = graph.add_input_tensor(size_big, vkapi::kFloat);
+  IOValueRef b = graph.add_input_tensor(size_small, vkapi::kFloat);
+
+  IOValueRef out = {};
+  out.value = graph.add_tensor(size_big, vkapi::kFloat);
+
+  auto addFn = VK_GET_OP_FN("aten.add.Tensor");
+  addFn(graph, {a.value, b.value, kDummyValueRef, out.value});
+
+  out.staging = graph.set_output_tensor(out.value);
+
+  graph.prepare();
+  graph.encode_execute();
+
+  // Tuning does not change the results of the graph
+
+  for (float i = 5.0f; i < 30.0f; i += 10.0f) {
+    float val_a = i + 2.0f;
+    float val_b = i + 1.5f;
+    float val_out = val_a + val_b;
+
+    fill_vtensor(graph, a, val_a);
+    fill_vtensor(graph, b, val_b);
+
+    graph.execute();
+
+    EXTRACT_TENSOR(out);
+
+    for (size_t i = 0; i < graph.get_tensor(out.value)->numel(); ++i) {
+      CHECK_VALUE(data_out, i, val_out);
+    }
+  }
+
+  // Every node now dispatches with the size tuned for it, which is saved after
+  // the device header
+  for (std::unique_ptr<ExecuteNode>& node : graph.execute_nodes()) {
+    EXPECT_LE(node->local_wg_size_candidates(&graph).size(), 1u);
+  }
+
+  wg_size_cache.save_cache();
+  std::ifstream file(path);
+  ASSERT_TRUE(file.good());
+  size_t num_lines = 0;
+  for (std::string line; std::getline(file, line);) {
+    ++num_lines;
+  }
+  EXPECT_GE(num_lines, 2);
+  file.close();
+
+  std::remove(path.c_str());
+  wg_size_cache.set_cache_data_path("");
+}
+
 TEST(VulkanComputeGraphTest, test_simple_graph_with_symint) {
   GraphConfig config;
   config.set_storage_type_override(utils::kTexture3D);
@@ -3270,3 +3545,47 @@ TEST(VulkanComputeGraphOpsTest, test_to_copy) {
     test_to_copy();
   }
 }
+
+TEST(VulkanComputeGraphOpsTest, test_fp32_staging_of_fp16_inputs) {
+  if (!context()->adapter_ptr()->supports_16bit_storage_buffers()) {
+    GTEST_SKIP();
+  }
+  for (auto storage_type : {utils::kTexture3D, utils::kTexture2D}) {
+    GraphConfig config;
+    ComputeGraph graph(config);
+    std::vector<int64_t> sizes = {3, 5, 7};
+
+    // `a` is staged as fp32 data and converted to fp16 on the GPU, while `b`
+    // is converted to fp16 on the host as it is copied into its staging
+    // buffer.
+    IOValueRef a;
+    a.value = graph.add_tensor(sizes, vkapi::kHalf, storage_type);
+    a.staging = graph.set_input_tensor(a.value, true, vkapi::kFloat);
+    IOValueRef b = graph.add_input_tensor(sizes, vkapi::kHalf, storage_type);
+
+    IOValueRef out;
+    out.value = graph.add_tensor(sizes, vkapi::kHalf, storage_type);
+    VK_GET_OP_FN("aten.add.Tensor")
+    (graph, {a.value, b.value, kDummyValueRef, out.value});
+    out.staging = graph.set_output_tensor(out.value);
+
+    graph.prepare();
+    graph.encode_prepack();
+    graph.prepack();
+    graph.encode_execute();
+
+    const size_t numel = graph.numel_of(a.value);
+    std::vector<float> data_a = create_random_float_buffer(numel, -8, 8);
+    std::vector<float> data_b = create_random_float_buffer(numel, -8, 8);
+    graph.copy_into_staging(a.staging, data_a.data(), numel);
+    graph.copy_float_into_staging(b.staging, data_b.data(), numel);
+
+    graph.execute();
+
+    std::vector<float> data_out(numel);
+    graph.copy_float_from_staging(out.staging, data_out.data(), numel);
+    for (size_t i = 0; i < numel; ++i) {
+      EXPECT_NEAR(data_out[i], data_a[i] + data_b[i], 2e-2f);
+    }
+  }
+}
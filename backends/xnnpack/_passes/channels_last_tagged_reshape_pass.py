@@ -77,6 +77,14 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
     # is done
     PARTNER_NODE = "XNN_CHANNELS_LAST_TAGGED_RESHAPE_PARTNER_NODE"
 
+    # Tag which the partitioner adds to a node's meta to indicate that its
+    # output passes between two XNNPACK delegates in NHWC format, although the
+    # tensor between them is NCHW. The producing delegate outputs it as NHWC
+    # and the consuming delegate takes it as an NHWC input, so that neither
+    # transposes it. Placeholders copy the meta of the node that they stand
+    # for, so the tag is seen on both sides.
+    XNN_NHWC_BOUNDARY = "XNN_NHWC_BOUNDARY"
+
     def mark_as_nhwc_node(self, node: torch.fx.Node) -> None:
         node.meta[ChannelsLastTaggedReshapePass.XNN_NHWC_NODE] = True
 
@@ -89,6 +97,16 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
     def is_nchw_node(self, node: torch.fx.Node) -> bool:
         return not self.is_nhwc_node(node)
 
+    def is_nhwc_boundary(self, node: torch.fx.Node) -> bool:
+        # The producing and consuming delegates each run this check on their
+        # own copy of the node, so both must see the same result for the
+        # tensor to stay in one format between them.
+        return (
+            node.meta.get(ChannelsLastTaggedReshapePass.XNN_NHWC_BOUNDARY, False)
+            and not is_param_node(self.exported_program, node)
+            and self.can_be_converted_to_nhwc(node)
+        )
+
     def requires_nhwc_input(self, node: torch.fx.Node) -> bool:
         return node.target in self.memory_sensitive_ops_nhwc
 
@@ -345,10 +363,40 @@ class ChannelsLastTaggedReshapePass(XNNPACKPass):
             target_node=target_node,
         )
 
+    def outputs_to_nchw_or_boundary_nhwc(
+        self,
+        graph_module: torch.fx.GraphModule,
+        output_node: torch.fx.Node,
+    ) -> None:
+        """
+        Outputs are NCHW, except that those which another delegate takes as
+        NHWC inputs are output as NHWC, and stay tagged as boundaries.
+        """
+        outputs = list(output_node.args[0])
+        for i, input_node in enumerate(outputs):
+            if not isinstance(input_node, torch.fx.Node):
+                continue
+            if self.is_nhwc_boundary(input_node):
+                self.input_to_nhwc(graph_module, input_node, output_node)
+                # The output is now the NHWC copy, if one was inserted
+                output_node.args[0][i].meta[
+                    ChannelsLastTaggedReshapePass.XNN_NHWC_BOUNDARY
+                ] = True
+            else:
+                self.input_to_nchw(graph_module, input_node, output_node)
+
     def call(self, graph_module: torch.fx.GraphModule):  # noqa: C901
         graph = graph_module.graph
         original_nodes = list(graph.nodes)
         for node in original_nodes:
+            if node.op == "placeholder" and self.is_nhwc_boundary(node):
+                # Another delegate outputs this input in NHWC format
+                self.mark_as_nhwc_node(node)
+
+            if node.op == "output":
+                self.outputs_to_nchw_or_boundary_nhwc(graph_module, node)
+                continue
+
             if len(node.all_input_nodes) == 0:
                 # This node has no inputs so we don't need to change anything
                 continue
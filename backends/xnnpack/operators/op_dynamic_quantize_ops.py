@@ -18,6 +18,7 @@ from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
     XNode,
 )
 from executorch.backends.xnnpack.utils.quant_utils import (
+    is_dynamic_linear_input_quant,
     is_per_channel_group,
     is_per_token,
 )
@@ -93,8 +94,11 @@ class OpDynamicQuantizePerToken(NodeVisitor):
         debug_handle: int,
     ) -> None:
         """
-        We always define dynamic quantize per token nodes because they are always explicit
+        We always define dynamic quantize per token nodes because they are always explicit,
+        unless the linear nodes that consume them quantize their input themselves
         """
+        if is_dynamic_linear_input_quant(node):
+            return
         q_input = get_input_node(node, 0)
 
         # fp32 input
@@ -147,6 +151,9 @@ class OpQuantizeAffine(NodeVisitor):
             is_per_token(node),
             "Encountered affine quantized op which does not have per-token semantics",
         )
+        if is_dynamic_linear_input_quant(node):
+            # The linear nodes that consume this node quantize their input
+            return
         # Treat this node as dynamic per-token quantization
         q_input = get_input_node(node, 0)
 
@@ -15,10 +15,15 @@ from executorch.backends.xnnpack.operators.node_visitor import (
 )
 from executorch.backends.xnnpack.operators.quant_params import QuantParams
 from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
+    XNNDynamicFullyConnected,
     XNNFullyConnected,
     XNNGraph,
     XNode,
 )
+from executorch.backends.xnnpack.utils.quant_utils import (
+    is_dequant,
+    is_dynamic_linear_input_quant,
+)
 
 from executorch.backends.xnnpack.utils.xnnpack_constants import XNN_INVALID_VALUE_ID
 
@@ -41,13 +46,23 @@ class LinearVisitor(NodeVisitor):
         # input
         input_node = get_input_node(node, 0)
         input_quant_params = QuantParams.from_inputs(input_node, self._exported_program)
-        self.define_tensor(
-            input_node,
-            xnn_graph,
-            vals_to_ids,
-            quant_params=input_quant_params,
+        # A dynamically quantized input is quantized by the linear node itself,
+        # which then takes the float input of the quantize node.
+        dynamic_quant = is_dequant(input_node) and is_dynamic_linear_input_quant(
+            get_input_node(input_node, 0)
         )
-        input_id = vals_to_ids[input_node]
+        if dynamic_quant:
+            float_input_node = get_input_node(get_input_node(input_node, 0), 0)
+            self.define_tensor(float_input_node, xnn_graph, vals_to_ids)
+            input_id = vals_to_ids[float_input_node]
+        else:
+            self.define_tensor(
+                input_node,
+                xnn_graph,
+                vals_to_ids,
+                quant_params=input_quant_params,
+            )
+            input_id = vals_to_ids[input_node]
 
         # filter
         weight_node = get_input_node(node, 1)
@@ -91,8 +106,11 @@ class LinearVisitor(NodeVisitor):
         )
         output_id = vals_to_ids[node]
 
+        fully_connected_cls = (
+            XNNDynamicFullyConnected if dynamic_quant else XNNFullyConnected
+        )
         ser_node = XNode(
-            xnode_union=XNNFullyConnected(
+            xnode_union=fully_connected_cls(
                 input1_id=input_id,
                 filter_id=filter_id,
                 bias_id=bias_id,
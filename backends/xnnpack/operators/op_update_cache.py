@@ -0,0 +1,67 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+from typing import Dict
+
+import torch
+from executorch.backends.xnnpack.operators.node_visitor import (
+    NodeVisitor,
+    register_node_visitor,
+)
+from executorch.backends.xnnpack.serialization.xnnpack_graph_schema import (
+    XNNGraph,
+    XNNUpdateCache,
+    XNode,
+)
+from executorch.backends.xnnpack.utils.utils import check_or_raise, get_input_node
+
+
+@register_node_visitor
+class UpdateCacheVisitor(NodeVisitor):
+    """
+    Writes the value into the cache in place. The cache and the start position
+    stay delegate inputs, which the runtime binds to the rows to write at every
+    execution, so the cache is never copied in or out of the delegate.
+    """
+
+    target = "llama.update_cache.default"
+
+    def __init__(self, *args) -> None:
+        super().__init__(*args)
+
+    def define_node(
+        self,
+        node: torch.fx.Node,
+        xnn_graph: XNNGraph,
+        vals_to_ids: Dict[torch.fx.Node, int],
+        debug_handle: int,
+    ) -> None:
+        value_node = get_input_node(node, 0)
+        self.define_tensor(value_node, xnn_graph, vals_to_ids)
+        value_id = vals_to_ids[value_node]
+
+        cache_node = get_input_node(node, 1)
+        start_pos_node = node.args[2]
+        check_or_raise(
+            cache_node in self.external_ids,
+            f"Expected the cache {cache_node} of {node} to be a delegate input",
+        )
+        check_or_raise(
+            isinstance(start_pos_node, torch.fx.Node)
+            and start_pos_node in self.external_ids,
+            f"Expected the start position of {node} to be a delegate input",
+        )
+
+        ser_node = XNode(
+            xnode_union=XNNUpdateCache(
+                value_id=value_id,
+                cache_external_id=self.external_ids[cache_node].external_id,
+                start_pos_external_id=self.external_ids[start_pos_node].external_id,
+                flags=0,
+            ),
+            debug_handle=debug_handle,
+        )
+        xnn_graph.xnodes.append(ser_node)
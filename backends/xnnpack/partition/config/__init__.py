@@ -40,12 +40,13 @@ from executorch.backends.xnnpack.partition.config.generic_node_configs import (
     PowConfig,
     QuantizedPerTensorConfig,
     ReLUConfig,
-    # SDPAConfig, TODO: D60553559: preserving SDPA for fairseq fails
+    SDPAConfig,
     SigmoidConfig,
     SliceCopyConfig,
     SoftmaxConfig,
     SquareRootConfig,
     SubConfig,
+    UpdateCacheConfig,
     UpsampleBilinear2dConfig,
 )
 from executorch.backends.xnnpack.partition.config.node_configs import (
@@ -108,3 +109,14 @@ ALL_PARTITIONER_CONFIGS: List[Type[XNNPartitionerConfig]] = [
     DeQuantizeAffineConfig,
     ChooseQParamsAffineConfig,
 ]
+
+# Lowers attention with its KV cache updates to XNNPACK too, so that a
+# transformer block that uses aten SDPA with a 2D mask and llama::update_cache
+# runs as one partition. Not part of the defaults, like SDPAConfig.
+TRANSFORMER_PARTITIONER_CONFIGS: List[Type[XNNPartitionerConfig]] = (
+    ALL_PARTITIONER_CONFIGS
+    + [
+        SDPAConfig,
+        UpdateCacheConfig,
+    ]
+)
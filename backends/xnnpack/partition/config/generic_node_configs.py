@@ -525,3 +525,43 @@ class SDPAConfig(GenericNodePartitionerConfig):
 
     def supported_precision_types(self) -> List[ConfigPrecisionType]:
         return [ConfigPrecisionType.FP32]
+
+
+class UpdateCacheConfig(GenericNodePartitionerConfig):
+    """
+    Writes llama::update_cache in place into its cache, which must be a [1, seq, ...]
+    float delegate input, so that attention layers don't break the partition.
+    """
+
+    target_name = "update_cache.default"
+
+    def check_constraints(self, node: torch.fx.Node, ep: ExportedProgram) -> bool:
+        if len(self.enabled_precision_types) == 0:
+            why(node, reason="not enabled precision types")
+            return False
+
+        value, cache, start_pos = node.args[0], node.args[1], node.args[2]
+        if not isinstance(start_pos, torch.fx.Node):
+            why(node, reason="start_pos must be a runtime value")
+            return False
+        if len(node.users) != 0:
+            why(node, reason="the output of update_cache must be unused")
+            return False
+
+        value_val = value.meta.get("val", None)
+        cache_val = cache.meta.get("val", None)
+        if not (
+            isinstance(value_val, torch.Tensor) and isinstance(cache_val, torch.Tensor)
+        ):
+            return False
+        if value_val.dtype != torch.float32 or cache_val.dtype != torch.float32:
+            why(node, reason="value and cache must be float")
+            return False
+        if cache_val.dim() < 2 or cache_val.shape[0] != 1:
+            why(node, reason="cache must have a batch size of 1")
+            return False
+
+        return True
+
+    def supported_precision_types(self) -> List[ConfigPrecisionType]:
+        return [ConfigPrecisionType.FP32]
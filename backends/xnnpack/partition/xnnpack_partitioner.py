@@ -9,18 +9,25 @@ import itertools
 import logging
 from typing import List, Optional, Type, Union
 
+import torch
+from executorch.backends.xnnpack._passes.channels_last_tagged_reshape_pass import (
+    ChannelsLastTaggedReshapePass,
+)
 from executorch.backends.xnnpack.partition.config import ALL_PARTITIONER_CONFIGS
 from executorch.backends.xnnpack.partition.config.xnnpack_config import (
     ConfigPrecisionType,
     XNNPartitionerConfig,
 )
 
+from executorch.backends.xnnpack.utils.utils import is_param_node
 from executorch.backends.xnnpack.xnnpack_preprocess import XnnpackBackend
 from executorch.exir.backend.backend_details import ExportedProgram
+from executorch.exir.backend.compile_spec_schema import CompileSpec
 from executorch.exir.backend.canonical_partitioners.config_partitioner import (
     ConfigerationBasedPartitioner,
 )
-from executorch.exir.backend.partitioner import DelegationSpec
+from executorch.exir.backend.partitioner import DelegationSpec, PartitionResult
+from executorch.exir.dialects._ops import ops as exir_ops
 from torch.fx.passes.infra.partitioner import Partition
 
 logging.basicConfig(level=logging.WARNING)
@@ -36,17 +43,33 @@ class XnnpackPartitioner(ConfigerationBasedPartitioner):
         ] = None,
         per_op_mode=False,
         verbose: bool = False,
+        num_threads: Optional[int] = None,
+        channels_last_boundaries: bool = False,
         **kwargs,
     ):
         """
         @verbose: if True, print out more information about the partitioner.
             Default level is WARNING. If verbose is True, level is set to DEBUG.
+        @num_threads: if set, the delegates run on a threadpool of this many
+            threads, shared with other delegates of the same size, instead of
+            the global threadpool.
+        @channels_last_boundaries: if True, 4d tensors that pass from an NHWC
+            operator in one delegate to an NHWC operator in another stay NHWC
+            between them, rather than being transposed to NCHW and back. Their
+            data is then only meaningful to the delegates.
         """
         if verbose:
             logger.setLevel(logging.DEBUG)
             logger.debug("Verbose logging enabled for XNNPACK partitioner.")
 
-        delegation_spec = DelegationSpec(XnnpackBackend.__name__, [])
+        compile_specs = []
+        if num_threads is not None:
+            if num_threads <= 0:
+                raise ValueError(f"num_threads must be positive, got {num_threads}")
+            compile_specs.append(
+                CompileSpec("num_threads", num_threads.to_bytes(4, byteorder="little"))
+            )
+        delegation_spec = DelegationSpec(XnnpackBackend.__name__, compile_specs)
         configs_to_use = configs or ALL_PARTITIONER_CONFIGS
         # Can do logic and have extra args to filter/delete/select
         # Certain configs based on user specification
@@ -63,8 +86,76 @@ class XnnpackPartitioner(ConfigerationBasedPartitioner):
         # per_op_mode takes the first match from a partitioner config, any
         # subsequent matches that overlap with the first match are not partitioned
         self.per_op_mode = per_op_mode
+        self.channels_last_boundaries = channels_last_boundaries
         super().__init__(delegation_spec, initialized_configs)
 
+    # Ops through which a tensor keeps the layout of its input, when looking
+    # for the NHWC operators that a boundary tensor comes from or goes to.
+    _layout_preserving_ops = {
+        exir_ops.edge.quantized_decomposed.quantize_per_tensor.default,
+        exir_ops.edge.quantized_decomposed.dequantize_per_tensor.default,
+        exir_ops.edge.aten.relu.default,
+        exir_ops.edge.aten.hardtanh.default,
+        exir_ops.edge.aten.clamp.default,
+        exir_ops.edge.aten.hardswish.default,
+        exir_ops.edge.aten.sigmoid.default,
+        exir_ops.edge.aten.leaky_relu.default,
+        exir_ops.edge.aten.elu.default,
+    }
+
+    @classmethod
+    def _comes_from_nhwc_op(cls, node: torch.fx.Node) -> bool:
+        while node.op == "call_function":
+            if node.target in ChannelsLastTaggedReshapePass.memory_sensitive_ops_nhwc:
+                return True
+            if node.target not in cls._layout_preserving_ops:
+                return False
+            node = node.args[0]
+        return False
+
+    @classmethod
+    def _feeds_nhwc_op(cls, user: torch.fx.Node, node: torch.fx.Node) -> bool:
+        if user.target in ChannelsLastTaggedReshapePass.memory_sensitive_ops_nhwc:
+            return user.args[0] is node
+        return user.target in cls._layout_preserving_ops and any(
+            cls._feeds_nhwc_op(next_user, user) for next_user in user.users
+        )
+
+    def tag_channels_last_boundaries(self, ep: ExportedProgram) -> None:
+        """
+        Tags the 4d outputs of delegates which only other delegates take, that
+        come from an NHWC operator and go to one, to pass in NHWC format.
+        """
+        for node in ep.graph_module.graph.nodes:
+            tag = node.meta.get("delegation_tag", None)
+            if (
+                tag is None
+                or is_param_node(ep, node)
+                or len(node.users) == 0
+                or "val" not in node.meta
+                or not isinstance(node.meta["val"], torch.Tensor)
+                or node.meta["val"].dim() != 4
+            ):
+                continue
+            user_tags = {user.meta.get("delegation_tag", None) for user in node.users}
+            if (
+                None in user_tags
+                or user_tags == {tag}
+                or not self._comes_from_nhwc_op(node)
+            ):
+                continue
+            consumers = [
+                user for user in node.users if user.meta["delegation_tag"] != tag
+            ]
+            if any(self._feeds_nhwc_op(user, node) for user in consumers):
+                node.meta[ChannelsLastTaggedReshapePass.XNN_NHWC_BOUNDARY] = True
+
+    def partition(self, exported_program: ExportedProgram) -> PartitionResult:
+        result = super().partition(exported_program)
+        if self.channels_last_boundaries:
+            self.tag_channels_last_boundaries(result.tagged_exported_program)
+        return result
+
     def generate_partitions(self, ep: ExportedProgram) -> List[Partition]:
         """
         generate_partitions is different if partitioner is set to per_op_mode
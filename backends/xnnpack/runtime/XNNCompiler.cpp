@@ -11,6 +11,7 @@
 #include <executorch/backends/xnnpack/serialization/schema_generated.h>
 #include <executorch/extension/threadpool/threadpool.h>
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <algorithm>
 #include <unordered_map>
 
 #pragma clang diagnostic ignored "-Wmissing-prototypes"
@@ -181,6 +182,28 @@ const uint8_t* getConstantDataPtr(
   return nullptr;
 }
 
+/**
+Gets the size in bytes of the constant data associated with the given tensor
+value, or 0 if it has none.
+*/
+size_t getConstantDataSize(
+    const fb_xnnpack::XNNTensorValue* tensor_value,
+    GraphPtr flatbuffer_graph,
+    const uint8_t* constant_data_ptr) {
+  auto buffer_idx = tensor_value->constant_buffer_idx();
+  if (buffer_idx) {
+    if (!constant_data_ptr) {
+      const auto& constant_buffer = *flatbuffer_graph->constant_buffer();
+      return constant_buffer[buffer_idx]->storage()->size();
+    } else {
+      const auto& constant_data_offsets = *flatbuffer_graph->constant_data();
+      return constant_data_offsets[buffer_idx]->size();
+    }
+  }
+
+  return 0;
+}
+
 /**
 Define serialized tensor value into
 the subgraph. While also keeping track of the remapped ids from
@@ -194,7 +217,8 @@ Error defineTensor(
     const uint8_t* constant_data_ptr,
     std::vector<uint32_t>& input_ids,
     std::vector<uint32_t>& output_ids,
-    CompileAllocator& allocator) {
+    CompileAllocator& allocator,
+    XNNWeightsCache* weights_cache) {
   const fb_xnnpack::XNNTensorValue* tensor_value = nullptr;
   const fb_xnnpack::XNNQuantizedTensorValue* qtensor_value = nullptr;
 
@@ -234,6 +258,10 @@ Error defineTensor(
   const uint8_t* buffer_ptr =
       getConstantDataPtr(tensor_value, flatbuffer_graph, constant_data_ptr);
 
+  // Quantization parameters that the packed weights depend on, so that the
+  // weights cache tells apart constants that differ only in those.
+  uint64_t quant_params_hash = 0;
+
   xnn_status status;
   // The type we might have to convert to
   auto dq_datatype = getDataType(tensor_value->dq_datatype());
@@ -346,6 +374,12 @@ Error defineTensor(
             buffer_ptr,
             qparams->scale(),
             qparams->zero_point());
+        const float scale = qparams->scale();
+        const int32_t tensor_zero_point = qparams->zero_point();
+        quant_params_hash = XNNWeightsCache::hash(
+            &tensor_zero_point,
+            sizeof(tensor_zero_point),
+            XNNWeightsCache::hash(&scale, sizeof(scale)));
         status = xnn_define_quantized_tensor_value(
             /*subgraph=*/subgraph_ptr,
             /*datatype=*/getDataType(tensor_value->datatype()),
@@ -373,6 +407,10 @@ Error defineTensor(
             qparams->channel_dim(),
             dtype,
             zero_point);
+        quant_params_hash = XNNWeightsCache::hash(
+            qparams->scale()->data(),
+            qparams->scale()->size() * sizeof(float),
+            qparams->channel_dim());
         status = xnn_define_channelwise_quantized_tensor_value_v2(
             /*subgraph=*/subgraph_ptr,
             /*datatype=*/dtype,
@@ -438,6 +476,8 @@ Error defineTensor(
             datatype,
             zero_point,
             datatype);
+        quant_params_hash = XNNWeightsCache::hash(
+            scale_data, scale_numel * sizeof(uint16_t), group_size);
 
         status = xnn_define_blockwise_quantized_tensor_value(
             /*subgraph=*/subgraph_ptr,
@@ -499,6 +539,13 @@ Error defineTensor(
       tensor_value->id_out(),
       xnn_status_to_string(status));
 
+  if (weights_cache != nullptr && buffer_ptr != nullptr) {
+    weights_cache->register_constant(
+        buffer_ptr,
+        getConstantDataSize(tensor_value, flatbuffer_graph, constant_data_ptr),
+        quant_params_hash);
+  }
+
   // map serialized id to newly generated id
   remapped_ids.emplace(std::make_pair(tensor_value->id_out(), id));
 
@@ -638,6 +685,12 @@ Error defineMultiplyNode(
 };
 
 #ifdef ENABLE_XNNPACK_KLEIDI
+// This is not currently exposed at include/xnnpack.h yet once it is
+// we can remove this runtime logic and do this ahead-of-time
+#ifndef XNN_FLAG_MAYBE_PACK_FOR_QB4W_GEMM
+#define XNN_FLAG_MAYBE_PACK_FOR_QB4W_GEMM 0x00000100
+#endif
+
 bool isQP8(const fb_xnnpack::XNNGraph* graph, const NodePtr node) {
   assert(node->xnode_union_type() == fb_xnnpack::XNodeUnion::XNNConvert);
   auto graph_node = node->xnode_union_as_XNNConvert();
@@ -697,9 +750,6 @@ Error defineConvertNode(
 
   int32_t flags = graph_node->flags();
 #ifdef ENABLE_XNNPACK_KLEIDI
-// This is not currently exposed at include/xnnpack.h yet once it is
-// we can remove this runtime logic and do this ahead-of-time
-#define XNN_FLAG_MAYBE_PACK_FOR_QB4W_GEMM 0x00000100;
   if (isQP8(flatbuffer_graph, node)) {
     flags |= XNN_FLAG_MAYBE_PACK_FOR_QB4W_GEMM;
     ET_LOG(
@@ -757,6 +807,114 @@ Error defineFullyConnectedNode(
   return Error::Ok;
 };
 
+/*
+Returns the serialized tensor value with the given id, or nullptr if there is
+none
+*/
+const fb_xnnpack::XNNTensorValue* getTensorValue(
+    const fb_xnnpack::XNNGraph* graph,
+    uint32_t id) {
+  for (auto value : *graph->xvalues()) {
+    const fb_xnnpack::XNNTensorValue* tensor = nullptr;
+    if (value->xvalue_union_type() ==
+        fb_xnnpack::XValueUnion::XNNQuantizedTensorValue) {
+      tensor = value->xvalue_union_as_XNNQuantizedTensorValue()->tensor_value();
+    } else if (
+        value->xvalue_union_type() == fb_xnnpack::XValueUnion::XNNTensorValue) {
+      tensor = value->xvalue_union_as_XNNTensorValue();
+    }
+    if (tensor != nullptr && tensor->id_out() == id) {
+      return tensor;
+    }
+  }
+  return nullptr;
+}
+
+/*
+Define serialized dynamically quantized linear node into the subgraph. Its
+float input is quantized per token into an internal qdint8 value, which feeds
+a fully-connected node with the quantized filter, e.g. a qd8-qb4w linear.
+*/
+Error defineDynamicFullyConnectedNode(
+    xnn_subgraph_t subgraph_ptr,
+    const std::unordered_map<uint32_t, uint32_t>& remapped_ids,
+    const NodePtr node,
+    const fb_xnnpack::XNNGraph* graph) noexcept {
+  auto graph_node = node->xnode_union_as_XNNDynamicFullyConnected();
+
+  // TODO(T179441835): Dynamic Quantization with num_nonbatch_dims > 1
+  ET_CHECK_OR_RETURN_ERROR(
+      graph_node->num_nonbatch_dims() == 1,
+      Internal,
+      "Dynamically quantized linear node %i only supports per token quantization",
+      node->debug_handle());
+  const fb_xnnpack::XNNTensorValue* input =
+      getTensorValue(graph, graph_node->input1_id());
+  ET_CHECK_OR_RETURN_ERROR(
+      input != nullptr && input->dims() != nullptr,
+      Internal,
+      "Missing input of dynamically quantized linear node %i",
+      node->debug_handle());
+  std::vector<size_t> dims_data = flatbufferDimsToVector(input->dims());
+
+  uint32_t quantized_input_id = XNN_INVALID_VALUE_ID;
+  xnn_status status = xnn_define_dynamically_quantized_tensor_value(
+      /*subgraph=*/subgraph_ptr,
+      /*datatype=*/xnn_datatype_qdint8,
+      /*num_dims=*/input->num_dims(),
+      /*num_nonbatch_dims=*/graph_node->num_nonbatch_dims(),
+      /*dims=*/dims_data.data(),
+      /*external_id=*/XNN_INVALID_VALUE_ID,
+      /*flags=*/0,
+      /*id_out=*/&quantized_input_id);
+  ET_CHECK_OR_RETURN_ERROR(
+      status == xnn_status_success,
+      Internal,
+      "Failed to define quantized input of linear node %i with code: %s",
+      node->debug_handle(),
+      xnn_status_to_string(status));
+
+  uint32_t convert_flags = 0;
+#ifdef ENABLE_XNNPACK_KLEIDI
+  const fb_xnnpack::XNNTensorValue* filter =
+      getTensorValue(graph, graph_node->filter_id());
+  if (filter != nullptr &&
+      filter->datatype() == DataType::xnn_datatype_qbint4) {
+    convert_flags |= XNN_FLAG_MAYBE_PACK_FOR_QB4W_GEMM;
+  }
+#endif
+  status = xnn_define_convert(
+      subgraph_ptr,
+      remapped_ids.at(graph_node->input1_id()),
+      quantized_input_id,
+      convert_flags);
+  ET_CHECK_OR_RETURN_ERROR(
+      status == xnn_status_success,
+      Internal,
+      "Failed to quantize input of linear node %i with code: %s",
+      node->debug_handle(),
+      xnn_status_to_string(status));
+
+  std::pair<float, float> min_max = getOutputMinMax(node);
+  status = xnn_define_fully_connected(
+      subgraph_ptr,
+      min_max.first,
+      min_max.second,
+      quantized_input_id,
+      remapped_ids.at(graph_node->filter_id()),
+      remapped_ids.at(graph_node->bias_id()),
+      remapped_ids.at(graph_node->output_id()),
+      graph_node->flags());
+  ET_CHECK_OR_RETURN_ERROR(
+      status == xnn_status_success,
+      Internal,
+      "Failed to create linear node %i, with code: %s",
+      node->debug_handle(),
+      xnn_status_to_string(status));
+
+  return Error::Ok;
+};
+
 /*
 Define serialized clamp node into the subgraph, using the remapped ids
 to map the serialized ids, to the new ids generated when defining
@@ -1738,6 +1896,68 @@ Error defineScaledDotProductAttentionNode(
   return Error::Ok;
 }
 
+/*
+Defines a serialized cache update node into the subgraph. The node copies its
+value into a new external output, which the executor points at the rows of
+the cache that start at the start position every time it runs, so that the
+runtime writes the cache in place.
+
+XNNPACK runs the nodes in the order in which they are defined, so that nodes
+which are serialized after this one, and read the cache, see its new rows.
+*/
+Error defineUpdateCacheNode(
+    xnn_subgraph_t subgraph_ptr,
+    const std::unordered_map<uint32_t, uint32_t>& remapped_ids,
+    const NodePtr node,
+    const fb_xnnpack::XNNGraph* graph,
+    uint32_t external_id,
+    XNNExecutor::CacheUpdate* cache_update) noexcept {
+  auto graph_node = node->xnode_union_as_XNNUpdateCache();
+
+  const fb_xnnpack::XNNTensorValue* value =
+      getTensorValue(graph, graph_node->value_id());
+  ET_CHECK_OR_RETURN_ERROR(
+      value != nullptr && value->dims() != nullptr && value->num_dims() >= 2,
+      Internal,
+      "Missing value of cache update node %i",
+      node->debug_handle());
+  std::vector<size_t> dims_data = flatbufferDimsToVector(value->dims());
+
+  uint32_t output_id = XNN_INVALID_VALUE_ID;
+  xnn_status status = xnn_define_tensor_value(
+      /*subgraph=*/subgraph_ptr,
+      /*datatype=*/getDataType(value->datatype()),
+      /*num_dims=*/value->num_dims(),
+      /*dims=*/dims_data.data(),
+      /*data=*/nullptr,
+      /*external_id=*/external_id,
+      /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+      /*id_out=*/&output_id);
+  ET_CHECK_OR_RETURN_ERROR(
+      status == xnn_status_success,
+      Internal,
+      "Failed to define the output of cache update node %i with code: %s",
+      node->debug_handle(),
+      xnn_status_to_string(status));
+
+  status = xnn_define_copy(
+      subgraph_ptr,
+      remapped_ids.at(graph_node->value_id()),
+      output_id,
+      graph_node->flags());
+  ET_CHECK_OR_RETURN_ERROR(
+      status == xnn_status_success,
+      Internal,
+      "Failed to create cache update node %i with code: %s",
+      node->debug_handle(),
+      xnn_status_to_string(status));
+
+  cache_update->external_id = external_id;
+  cache_update->cache_arg = graph_node->cache_external_id();
+  cache_update->start_pos_arg = graph_node->start_pos_external_id();
+  return Error::Ok;
+}
+
 /*
 Defines batch matrix multiply node into the subgraph,
 using the remapped ids to map the serialized ids,
@@ -1835,6 +2055,7 @@ DefineNodeFunc getDefineNodeFunc(fb_xnnpack::XNodeUnion nodeType) {
     _DEFINE(StaticSlice)
     _DEFINE(ScaledDotProductAttention)
     _DEFINE(BatchMatrixMultiply)
+    _DEFINE(DynamicFullyConnected)
     case fb_xnnpack::XNodeUnion::NONE:
     default: // Adding here as a catch all, just in case
       return &defineNotImplementedNode;
@@ -1852,7 +2073,8 @@ ET_NODISCARD Error XNNCompiler::compileModel(
     size_t num_bytes,
     XNNExecutor* executor,
     MemoryAllocator* runtime_allocator,
-    xnn_workspace_t workspace) {
+    xnn_workspace_t workspace,
+    XNNWeightsCache* weights_cache) {
   Result<XNNHeader> header = XNNHeader::Parse(buffer_pointer, num_bytes);
   const uint8_t* flatbuffer_data = nullptr;
   const uint8_t* constant_data = nullptr;
@@ -1892,10 +2114,20 @@ ET_NODISCARD Error XNNCompiler::compileModel(
       "XNN Initialize failed with code: %s",
       xnn_status_to_string(status));
 
+  // Cache updates write to external outputs of their own, which are numbered
+  // after the serialized externals.
+  uint32_t num_cache_updates = 0;
+  for (auto node : *flatbuffer_graph->xnodes()) {
+    if (node->xnode_union_type() == fb_xnnpack::XNodeUnion::XNNUpdateCache) {
+      num_cache_updates++;
+    }
+  }
+
   // create xnnpack subgraph
   xnn_subgraph_t subgraph_ptr = nullptr;
   status = xnn_create_subgraph(
-      /*external_value_ids=*/flatbuffer_graph->num_externs(),
+      /*external_value_ids=*/flatbuffer_graph->num_externs() +
+          num_cache_updates,
       /*flags=*/0,
       &subgraph_ptr);
   ET_CHECK_OR_RETURN_ERROR(
@@ -1920,6 +2152,9 @@ ET_NODISCARD Error XNNCompiler::compileModel(
   std::vector<uint32_t> input_ids;
   std::vector<uint32_t> output_ids;
   Error err = Error::Ok;
+  if (weights_cache != nullptr) {
+    weights_cache->initialize_for_runtime();
+  }
   for (auto value : *flatbuffer_graph->xvalues()) {
     err = defineTensor(
         subgraph.get(),
@@ -1929,16 +2164,32 @@ ET_NODISCARD Error XNNCompiler::compileModel(
         constant_data,
         input_ids,
         output_ids,
-        compile_allocator);
+        compile_allocator,
+        weights_cache);
 
     if (err != Error::Ok) {
       return err;
     }
   }
 
+  std::vector<XNNExecutor::CacheUpdate> cache_updates;
   for (auto node : *flatbuffer_graph->xnodes()) {
-    err = getDefineNodeFunc(node->xnode_union_type())(
-        subgraph.get(), remapped_ids, node, flatbuffer_graph);
+    if (node->xnode_union_type() == fb_xnnpack::XNodeUnion::XNNUpdateCache) {
+      // Cache updates also need an external id, and are bound by the executor.
+      XNNExecutor::CacheUpdate cache_update{};
+      err = defineUpdateCacheNode(
+          subgraph.get(),
+          remapped_ids,
+          node,
+          flatbuffer_graph,
+          flatbuffer_graph->num_externs() +
+              static_cast<uint32_t>(cache_updates.size()),
+          &cache_update);
+      cache_updates.push_back(cache_update);
+    } else {
+      err = getDefineNodeFunc(node->xnode_union_type())(
+          subgraph.get(), remapped_ids, node, flatbuffer_graph);
+    }
     if (err != Error::Ok) {
       return err;
     }
@@ -1950,25 +2201,33 @@ ET_NODISCARD Error XNNCompiler::compileModel(
 #endif
 
   xnn_runtime_t runtime_ptr = nullptr;
+  xnn_weights_cache_t weights_cache_ptr =
+      weights_cache != nullptr ? weights_cache->get() : nullptr;
 
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-  ET_CHECK_OR_RETURN_ERROR(
-      workspace != nullptr, Internal, "Failed to initialize XNNPACK workspace");
-  status = xnn_create_runtime_v4(
-      subgraph.get(),
-      /*weight_cache=*/nullptr, // TODO - support weight cache
-      workspace,
-      ::executorch::extension::threadpool::get_pthreadpool(),
-      runtime_flags,
-      &runtime_ptr);
-#else
-  status = xnn_create_runtime_v3(
-      subgraph.get(),
-      /*weight_cache=*/nullptr, // TODO - support weight cache
-      ::executorch::extension::threadpool::get_pthreadpool(),
-      runtime_flags,
-      &runtime_ptr);
-#endif
+  if (workspace != nullptr) {
+    status = xnn_create_runtime_v4(
+        subgraph.get(),
+        weights_cache_ptr,
+        workspace,
+        ::executorch::extension::threadpool::get_pthreadpool(),
+        runtime_flags,
+        &runtime_ptr);
+  } else {
+    status = xnn_create_runtime_v3(
+        subgraph.get(),
+        weights_cache_ptr,
+        ::executorch::extension::threadpool::get_pthreadpool(),
+        runtime_flags,
+        &runtime_ptr);
+  }
+
+  std::vector<std::string> packed_data_names;
+  if (weights_cache != nullptr) {
+    packed_data_names = weights_cache->finalize_for_runtime();
+    if (xnn_status_success != status) {
+      weights_cache->release_packed_data(packed_data_names);
+    }
+  }
 
   ET_CHECK_OR_RETURN_ERROR(
       xnn_status_success == status,
@@ -1976,6 +2235,18 @@ ET_NODISCARD Error XNNCompiler::compileModel(
       "XNN Runtime creation failed with code: %s",
       xnn_status_to_string(status));
 
+  // The executor releases these once it deletes the runtime.
+  executor->packed_data_names_ = std::move(packed_data_names);
+  executor->cache_updates_ = std::move(cache_updates);
+  if (flatbuffer_graph->channels_last_ids() != nullptr) {
+    executor->channels_last_ids_.assign(
+        flatbuffer_graph->channels_last_ids()->begin(),
+        flatbuffer_graph->channels_last_ids()->end());
+    std::sort(
+        executor->channels_last_ids_.begin(),
+        executor->channels_last_ids_.end());
+  }
+
   err = executor->initialize( // NOLINT: runtime_ptr is non-null
       runtime_ptr,
       std::move(input_ids),
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <executorch/backends/xnnpack/runtime/XNNExecutor.h>
+#include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
 #include <executorch/runtime/platform/compiler.h>
 
 #include <xnnpack.h>
@@ -25,12 +26,15 @@ class XNNCompiler {
   // Takes Flatbuffer Serialized XNNPACK Model and rebuilds the xnn-subgraph
   // returns an executor object that holds the xnn runtime object which we
   // can then use to set inputs and run inference using the xnn graph.
+  // Constants are packed into weights_cache, if not null, and shared with
+  // the other runtimes created with it.
   ET_NODISCARD static executorch::runtime::Error compileModel(
       const void* buffer_pointer,
       size_t num_bytes,
       XNNExecutor* executor,
       executorch::runtime::MemoryAllocator* runtime_allocator,
-      xnn_workspace_t workspace);
+      xnn_workspace_t workspace,
+      XNNWeightsCache* weights_cache = nullptr);
 };
 
 } // namespace delegate
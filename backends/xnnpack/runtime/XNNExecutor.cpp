@@ -8,6 +8,9 @@
 
 #include <executorch/backends/xnnpack/runtime/XNNExecutor.h>
 
+#include <algorithm>
+#include <cinttypes>
+
 namespace executorch {
 namespace backends {
 namespace xnnpack {
@@ -34,14 +37,6 @@ ET_NODISCARD Error XNNExecutor::initialize(
   runtime_ = std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)>(
       runtime, xnn_delete_runtime);
 
-  auto error = profiler_.initialize(runtime);
-  if (error != Error::Ok) {
-    ET_LOG(
-        Error,
-        "Failed to start profiling: %u.",
-        static_cast<unsigned int>(error));
-  }
-
   // Initialize the external values for inputs and outputs
   // mapping the executorch arg idx to external IDs
   input_ids_ = std::move(input_ids);
@@ -50,7 +45,19 @@ ET_NODISCARD Error XNNExecutor::initialize(
   output_ids_ = std::move(output_ids);
   std::sort(output_ids_.begin(), output_ids_.end());
 
-  externals_.resize(input_ids_.size() + output_ids_.size());
+  externals_.resize(
+      input_ids_.size() + output_ids_.size() + cache_updates_.size());
+  input_dims_.assign(input_ids_.size() * XNN_MAX_TENSOR_DIMS, 0);
+  input_num_dims_.assign(input_ids_.size(), 0);
+  needs_reshape_ = true;
+
+  auto error = profiler_.initialize(runtime, input_ids_);
+  if (error != Error::Ok) {
+    ET_LOG(
+        Error,
+        "Failed to start profiling: %u.",
+        static_cast<unsigned int>(error));
+  }
 
   return Error::Ok;
 }
@@ -59,9 +66,10 @@ ET_NODISCARD Error XNNExecutor::initialize(
  * Prepares the args for XNNPACK Runtime.
  *
  * Creates an array of xnn_externals_values from the EValues passed in.
- * Reshapes all the external input tensors, in case any input shapes have
- * changed. The reshapes the entire runtime, propagating shape information
- * through the runtime.
+ * Reshapes the external input tensors whose shapes have changed since the
+ * last call, then reshapes the entire runtime, propagating shape information
+ * through the runtime. If no shape changed, as in fixed-shape decoding, the
+ * runtime keeps its shapes and memory plan, and nothing is reshaped.
  *
  * Note: the external ids given to the external tensors in the XNNPACK
  * runtime correspond to their index in the list of arg passed into
@@ -70,7 +78,10 @@ ET_NODISCARD Error XNNExecutor::initialize(
 ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
   // Create xnn_externals_value from evalue args
   xnn_status status;
-  for (uint32_t i = 0; i < externals_.size(); ++i) {
+  const bool force_reshape = needs_reshape_;
+  bool reshape = force_reshape;
+  const size_t num_args = input_ids_.size() + output_ids_.size();
+  for (uint32_t i = 0; i < num_args; ++i) {
     if (i < input_ids_.size()) {
       externals_[i].id = input_ids_[i];
     } else {
@@ -106,6 +117,27 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
       for (int d = 0; d < num_dims; ++d) {
         dims[d] = tensor->size(d);
       }
+      if (is_channels_last(ext_id)) {
+        ET_CHECK_OR_RETURN_ERROR(
+            num_dims == 4,
+            Internal,
+            "Expected channels last input %u to have 4 dims, but got %zu",
+            ext_id,
+            num_dims);
+        // The NCHW tensor holds NHWC data.
+        const size_t nchw[4] = {dims[0], dims[1], dims[2], dims[3]};
+        dims[1] = nchw[2];
+        dims[2] = nchw[3];
+        dims[3] = nchw[1];
+      }
+      size_t* last_dims = &input_dims_[i * XNN_MAX_TENSOR_DIMS];
+      if (!force_reshape && input_num_dims_[i] == num_dims &&
+          std::equal(dims, dims + num_dims, last_dims)) {
+        continue;
+      }
+      // Forget the last shapes until the runtime is reshaped successfully.
+      needs_reshape_ = true;
+      reshape = true;
       status =
           xnn_reshape_external_value(runtime_.get(), ext_id, num_dims, dims);
       ET_CHECK_OR_RETURN_ERROR(
@@ -113,25 +145,102 @@ ET_NODISCARD Error XNNExecutor::prepare_args(EValue** args) {
           Internal,
           "Internal Error: Reshape Input Tensor Failed with code: %s",
           xnn_status_to_string(status));
+      std::copy(dims, dims + num_dims, last_dims);
+      input_num_dims_[i] = num_dims;
+    }
+  }
+  if (reshape) {
+    // Propagate Input Shape and Memory Plan for increased allocation
+    status = xnn_reshape_runtime(runtime_.get());
+
+    ET_CHECK_OR_RETURN_ERROR(
+        status == xnn_status_success,
+        Internal,
+        "Internal Error: Propagating input shapes failed with code: %s",
+        xnn_status_to_string(status));
+    needs_reshape_ = false;
+    needs_setup_ = true;
+    profiler_.reshaped();
+  }
+
+  for (size_t i = 0; i < cache_updates_.size(); ++i) {
+    Error err = prepare_cache_update(
+        cache_updates_[i], args, externals_[num_args + i]);
+    if (err != Error::Ok) {
+      return err;
     }
   }
-  // // Propagate Input Shape and Memory Plan for increased allocation
-  status = xnn_reshape_runtime(runtime_.get());
+
+  return Error::Ok;
+}
+
+/**
+ * Points the external output of a cache update at the rows of the cache
+ * that start at the current start position. The cache is [1, seq, ...] and
+ * contiguous, so those rows are contiguous too.
+ */
+ET_NODISCARD Error XNNExecutor::prepare_cache_update(
+    const CacheUpdate& update,
+    EValue** args,
+    xnn_external_value& external) const {
+  const EValue* start_pos_arg = args[update.start_pos_arg];
+  int64_t start_pos = 0;
+  if (start_pos_arg->isInt()) {
+    start_pos = start_pos_arg->toInt();
+  } else {
+    ET_CHECK_OR_RETURN_ERROR(
+        start_pos_arg->isTensor() &&
+            start_pos_arg->toTensor().scalar_type() ==
+                ScalarType::Long &&
+            start_pos_arg->toTensor().numel() == 1,
+        InvalidArgument,
+        "Expected the start position of a cache update to be an int");
+    start_pos = start_pos_arg->toTensor().const_data_ptr<int64_t>()[0];
+  }
 
   ET_CHECK_OR_RETURN_ERROR(
-      status == xnn_status_success,
+      args[update.cache_arg]->isTensor(),
+      InvalidArgument,
+      "Expected the cache at index %" PRIu32 " to be a Tensor",
+      update.cache_arg);
+  Tensor& cache = args[update.cache_arg]->toTensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      cache.dim() >= 2 && cache.size(0) == 1 &&
+          is_contiguous_dim_order(cache.dim_order().data(), cache.dim()),
+      InvalidArgument,
+      "Expected a contiguous cache with a batch size of 1");
+
+  size_t num_dims;
+  size_t dims[XNN_MAX_TENSOR_DIMS];
+  xnn_status status = xnn_get_external_value_shape(
+      runtime_.get(), update.external_id, &num_dims, dims);
+  ET_CHECK_OR_RETURN_ERROR(
+      status == xnn_status_success &&
+          num_dims == static_cast<size_t>(cache.dim()),
       Internal,
-      "Internal Error: Propagating input shapes failed with code: %s",
-      xnn_status_to_string(status));
-
+      "Internal Error: Failed to retrieve the shape of a cache update");
+  ET_CHECK_OR_RETURN_ERROR(
+      start_pos >= 0 &&
+          static_cast<size_t>(start_pos) + dims[1] <=
+              static_cast<size_t>(cache.size(1)),
+      InvalidArgument,
+      "Cache update of %zu rows at %" PRId64 " exceeds the cache of %zu rows",
+      dims[1],
+      start_pos,
+      static_cast<size_t>(cache.size(1)));
+
+  external.id = update.external_id;
+  external.data = static_cast<uint8_t*>(cache.mutable_data_ptr()) +
+      start_pos * cache.strides()[1] * cache.element_size();
   return Error::Ok;
 }
 
 /**
  * Runs the XNNPACK Runtime.
  *
- * We first setup the runtime by feeding the externals_ to runtime setup.
- * After which we then execute the runtime through invoke_runtime.
+ * We first setup the runtime by feeding the externals_ to runtime setup,
+ * unless the runtime was set up with the same data and shapes by the last
+ * call. After which we then execute the runtime through invoke_runtime.
  */
 ET_NODISCARD Error XNNExecutor::forward(BackendExecutionContext& context) {
   ET_CHECK_OR_RETURN_ERROR(
@@ -139,14 +248,30 @@ ET_NODISCARD Error XNNExecutor::forward(BackendExecutionContext& context) {
       Internal,
       "XNNPACK Delegate did not compile correctly");
 
-  xnn_status status = xnn_setup_runtime_v2(
-      runtime_.get(), externals_.size(), externals_.data());
+  bool setup = needs_setup_ || setup_data_.size() != externals_.size();
+  for (size_t i = 0; !setup && i < externals_.size(); ++i) {
+    setup = externals_[i].data != setup_data_[i];
+  }
+
+  xnn_status status = xnn_status_success;
+  if (setup) {
+    // Set up again if this one fails.
+    needs_setup_ = true;
+    status = xnn_setup_runtime_v2(
+        runtime_.get(), externals_.size(), externals_.data());
 
-  ET_CHECK_OR_RETURN_ERROR(
-      status == xnn_status_success,
-      Internal,
-      "Internal Error: Setting up the runtime failed with code: %s",
-      xnn_status_to_string(status));
+    ET_CHECK_OR_RETURN_ERROR(
+        status == xnn_status_success,
+        Internal,
+        "Internal Error: Setting up the runtime failed with code: %s",
+        xnn_status_to_string(status));
+
+    setup_data_.resize(externals_.size());
+    for (size_t i = 0; i < externals_.size(); ++i) {
+      setup_data_[i] = externals_[i].data;
+    }
+    needs_setup_ = false;
+  }
 
   auto error = profiler_.start(context.event_tracer());
   if (error != Error::Ok) {
@@ -187,7 +312,8 @@ ET_NODISCARD Error XNNExecutor::forward(BackendExecutionContext& context) {
  */
 ET_NODISCARD Error XNNExecutor::resize_outputs(EValue** args) const {
   size_t output_idx_start = input_ids_.size();
-  for (size_t i = output_idx_start; i < externals_.size(); ++i) {
+  size_t output_idx_end = output_idx_start + output_ids_.size();
+  for (size_t i = output_idx_start; i < output_idx_end; ++i) {
     uint32_t ext_id = externals_[i].id;
     Tensor* out_tensor = &args[ext_id]->toTensor();
 
@@ -208,6 +334,18 @@ ET_NODISCARD Error XNNExecutor::resize_outputs(EValue** args) const {
     for (size_t d = 0; d < num_dim; ++d) {
       expected_output_size[d] = static_cast<SizesType>(dims[d]);
     }
+    if (is_channels_last(ext_id)) {
+      ET_CHECK_OR_RETURN_ERROR(
+          num_dim == 4,
+          Internal,
+          "Expected channels last output %u to have 4 dims, but got %zu",
+          ext_id,
+          num_dim);
+      // The NCHW tensor holds NHWC data.
+      expected_output_size[1] = static_cast<SizesType>(dims[3]);
+      expected_output_size[2] = static_cast<SizesType>(dims[1]);
+      expected_output_size[3] = static_cast<SizesType>(dims[2]);
+    }
 
     executorch::aten::ArrayRef<SizesType> output_size{
         expected_output_size, static_cast<size_t>(num_dim)};
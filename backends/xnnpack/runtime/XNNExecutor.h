@@ -9,14 +9,18 @@
 #pragma once
 
 #include <executorch/backends/xnnpack/runtime/XNNStatus.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
 #include <executorch/backends/xnnpack/runtime/profiling/XNNProfiler.h>
+#include <executorch/extension/threadpool/threadpool.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 
 #include <xnnpack.h>
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace executorch {
@@ -26,6 +30,12 @@ namespace delegate {
 
 class XNNExecutor {
  private:
+  // The workspace that runtime_ was created with, if any. Declared before
+  // runtime_ so that it outlives it.
+  std::shared_ptr<XNNWorkspace> workspace_;
+  // The threadpool that runtime_ was created with, if the backend owns it.
+  // Also declared before runtime_.
+  std::shared_ptr<::executorch::extension::threadpool::ThreadPool> threadpool_;
   std::unique_ptr<xnn_runtime, decltype(&xnn_delete_runtime)> runtime_{
       nullptr,
       &xnn_delete_runtime};
@@ -34,6 +44,46 @@ class XNNExecutor {
   std::vector<uint32_t> input_ids_;
   std::vector<uint32_t> output_ids_;
   std::vector<xnn_external_value> externals_;
+  // The dims of every input at the last reshape of the runtime, at
+  // XNN_MAX_TENSOR_DIMS per input, and their number of dims.
+  std::vector<size_t> input_dims_;
+  std::vector<size_t> input_num_dims_;
+  // Whether the runtime must be reshaped even if no input shape changed,
+  // e.g. because it was never reshaped or the last reshape failed.
+  bool needs_reshape_ = true;
+  // The data of externals_ at the last setup of the runtime, which it keeps
+  // using while neither the data nor the shapes change, e.g. when the
+  // caller binds the same buffers to every execution.
+  std::vector<void*> setup_data_;
+  bool needs_setup_ = true;
+  // The packed weights that runtime_ uses in the backend's weights cache.
+  std::vector<std::string> packed_data_names_;
+
+  // An external output of the runtime that aliases the rows of a cache input
+  // from a start position given by another input, so that the runtime writes
+  // them in place, e.g. to update a KV cache.
+  struct CacheUpdate {
+    // The external id of the output.
+    uint32_t external_id;
+    // The indices of the cache tensor and of the start position in args.
+    uint32_t cache_arg;
+    uint32_t start_pos_arg;
+  };
+  std::vector<CacheUpdate> cache_updates_;
+  // The sorted external ids of the 4d inputs and outputs whose data is NHWC,
+  // to pass between delegates without transposes, while their tensors are
+  // NCHW.
+  std::vector<uint32_t> channels_last_ids_;
+
+  inline bool is_channels_last(uint32_t ext_id) const {
+    return std::binary_search(
+        channels_last_ids_.begin(), channels_last_ids_.end(), ext_id);
+  }
+
+  ET_NODISCARD executorch::runtime::Error prepare_cache_update(
+      const CacheUpdate& update,
+      executorch::runtime::EValue** args,
+      xnn_external_value& external) const;
 
  public:
   XNNExecutor() = default;
@@ -46,6 +96,35 @@ class XNNExecutor {
     return output_ids_.size();
   }
 
+  /**
+   * The packed weights that the runtime uses in the weights cache that it was
+   * compiled with. Release them once the executor is destroyed.
+   */
+  inline const std::vector<std::string>& getPackedDataNames() const {
+    return packed_data_names_;
+  }
+
+  /**
+   * The workspace that the runtime shares with other runtimes, or null if it
+   * has its own. Hold its mutex to run or delete the runtime.
+   */
+  inline const std::shared_ptr<XNNWorkspace>& getWorkspace() const {
+    return workspace_;
+  }
+
+  inline void setWorkspace(std::shared_ptr<XNNWorkspace> workspace) {
+    workspace_ = std::move(workspace);
+  }
+
+  /**
+   * Keeps threadpool, which the runtime runs on, alive as long as the runtime.
+   */
+  inline void setThreadPool(
+      std::shared_ptr<::executorch::extension::threadpool::ThreadPool>
+          threadpool) {
+    threadpool_ = std::move(threadpool);
+  }
+
   /**
    * Initialize the XNNExecutor with a given runtime and input/output ids.
    * The input/output ids are expected to be sorted in order of their
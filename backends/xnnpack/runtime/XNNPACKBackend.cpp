@@ -7,13 +7,23 @@
  */
 
 #include <executorch/backends/xnnpack/runtime/XNNCompiler.h>
+#include <executorch/backends/xnnpack/runtime/XNNPACKBackend.h>
+#include <executorch/backends/xnnpack/runtime/XNNWorkspace.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/platform/profiler.h>
 
+#include <cstring>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
 
 #pragma clang diagnostic ignored "-Wglobal-constructors"
 
@@ -24,12 +34,16 @@ using executorch::runtime::ArrayRef;
 using executorch::runtime::Backend;
 using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::BackendInitContext;
+using executorch::runtime::BackendOption;
 using executorch::runtime::CompileSpec;
 using executorch::runtime::DelegateHandle;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
+using executorch::extension::threadpool::ThreadPool;
+using executorch::extension::threadpool::ThreadPoolGuard;
 
 class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
  public:
@@ -45,24 +59,6 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
           (unsigned int)status);
       return;
     }
-
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    // Create a workspace for the XNNExecutor to use. This workspace will be
-    // shared across all delegate instances.
-    ET_LOG(Debug, "Creating XNN workspace");
-    xnn_workspace_t workspace = nullptr;
-    status = xnn_create_workspace(&workspace);
-    if (status != xnn_status_success) {
-      ET_LOG(
-          Error,
-          "Failed to create XNN workspace, XNNPACK status: 0x%x",
-          (unsigned int)status);
-      workspace = nullptr;
-      return;
-    }
-    workspace_.reset(workspace);
-    ET_LOG(Debug, "Created XNN workspace: %p", workspace_.get());
-#endif // ENABLE_XNNPACK_SHARED_WORKSPACE
   }
 
   bool is_available() const override {
@@ -81,19 +77,55 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
     // new and since this type is not trivially destructible, we must call the
     // destructor manually in destroy().
     new (executor) xnnpack::delegate::XNNExecutor;
+
+    Result<std::shared_ptr<xnnpack::delegate::XNNWorkspace>> workspace =
+        get_workspace(context);
+    if (!workspace.ok()) {
+      executor->~XNNExecutor();
+      return workspace.error();
+    }
+    executor->setWorkspace(workspace.get());
+
+    Result<std::shared_ptr<ThreadPool>> threadpool =
+        get_threadpool(compile_specs);
+    if (!threadpool.ok()) {
+      executor->~XNNExecutor();
+      return threadpool.error();
+    }
+    // The runtime captures the threadpool that is selected while it is
+    // created.
+    std::optional<ThreadPoolGuard> threadpool_guard;
+    if (threadpool.get() != nullptr) {
+      threadpool_guard.emplace(threadpool.get().get());
+      executor->setThreadPool(threadpool.get());
+    }
+    // Creating a runtime adds it to its workspace. Take the workspace lock
+    // before the weights cache lock, in the same order as execute().
+    std::unique_lock<std::mutex> workspace_lock;
+    if (workspace.get() != nullptr) {
+      workspace_lock = std::unique_lock<std::mutex>(workspace.get()->mutex());
+    }
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    const std::unique_lock<std::shared_mutex> lock(weights_cache_mutex_);
+    xnnpack::delegate::XNNWeightsCache* weights_cache = &weights_cache_;
+#else
+    xnnpack::delegate::XNNWeightsCache* weights_cache = nullptr;
+#endif
     Error err = xnnpack::delegate::XNNCompiler::compileModel(
         processed->data(),
         processed->size(),
         executor,
         context.get_runtime_allocator(),
-        workspace_.get());
+        workspace.get() != nullptr ? workspace.get()->get() : nullptr,
+        weights_cache);
     // This backend does not need its processed data after compiling the model.
+    // Packed weights live in the runtime or in the weights cache.
     processed->Free();
 
     if (err != Error::Ok) {
       // destroy() won't be called on this handle, so we need to clean it up
       // now.
-      executor->~XNNExecutor();
+      destroy_executor(executor);
 
       ET_LOG(
           Error, "XNNCompiler::compileModel failed: 0x%x", (unsigned int)err);
@@ -108,8 +140,16 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
       EValue** args) const override {
     auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
 
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-    const std::lock_guard<std::mutex> lock(workspace_mutex_);
+    // Only runtimes that share a workspace are serialized.
+    std::unique_lock<std::mutex> workspace_lock;
+    if (executor->getWorkspace() != nullptr) {
+      workspace_lock =
+          std::unique_lock<std::mutex>(executor->getWorkspace()->mutex());
+    }
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    // Runtimes can't run while another one is compiled with the cache.
+    const std::shared_lock<std::shared_mutex> weights_lock(
+        weights_cache_mutex_);
 #endif
 
     // Prepare Inputs/Outputs and Propagate Input Shapes
@@ -132,28 +172,260 @@ class XnnpackBackend final : public ::executorch::runtime::BackendInterface {
 
   void destroy(DelegateHandle* handle) const override {
     if (handle != nullptr) {
-#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
-      // This is needed to serialize access to xnn_delete_runtime which is not
-      // thread safe. This can heppen when multiple threads call destroy() on
-      // the same backend instance.
-      const std::lock_guard<std::mutex> lock(workspace_mutex_);
-#endif
       auto executor = static_cast<xnnpack::delegate::XNNExecutor*>(handle);
-#ifdef ENABLE_XNNPACK_PROFILING
-      executor->print_avg_op_timings();
+      // This is needed to serialize access to xnn_delete_runtime which is not
+      // thread safe for runtimes that share a workspace. This can happen when
+      // multiple threads call destroy() on the same backend instance. Keeps
+      // the workspace, and its mutex, alive until the lock is released.
+      const std::shared_ptr<xnnpack::delegate::XNNWorkspace> workspace =
+          executor->getWorkspace();
+      std::unique_lock<std::mutex> workspace_lock;
+      if (workspace != nullptr) {
+        workspace_lock = std::unique_lock<std::mutex>(workspace->mutex());
+      }
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+      const std::unique_lock<std::shared_mutex> weights_lock(
+          weights_cache_mutex_);
 #endif
-      // XNNExecutor is not trivially destructible. Since this was constructed
-      // manually in init(), we must destroy it manually here.
-      executor->~XNNExecutor();
+      destroy_executor(executor);
+    }
+  }
+
+  Error set_option(DelegateHandle* handle, Span<const BackendOption> options)
+      const override {
+    // The runtime of a delegate instance keeps the threadpool and workspace it
+    // was created with, so only the backend has options.
+    ET_CHECK_OR_RETURN_ERROR(
+        handle == nullptr,
+        NotSupported,
+        "XNNPACK delegate instances have no runtime options");
+    for (const BackendOption& option : options) {
+      ET_CHECK_OR_RETURN_ERROR(
+          std::strcmp(option.key(), xnnpack::kWorkspaceSharingOption) == 0,
+          NotSupported,
+          "Unknown option %s",
+          option.key());
+      ET_CHECK_OR_RETURN_ERROR(
+          option.isInt() && option.toInt() >= 0 &&
+              option.toInt() <=
+                  static_cast<int64_t>(xnnpack::WorkspaceSharing::PerMethod),
+          InvalidArgument,
+          "Invalid value for option %s",
+          option.key());
     }
+    const std::lock_guard<std::mutex> lock(workspaces_mutex_);
+    for (const BackendOption& option : options) {
+      workspace_sharing_ =
+          static_cast<xnnpack::WorkspaceSharing>(option.toInt());
+    }
+    return Error::Ok;
+  }
+
+  Error get_option(DelegateHandle* handle, Span<BackendOption> options)
+      const override {
+    ET_CHECK_OR_RETURN_ERROR(
+        handle == nullptr,
+        NotSupported,
+        "XNNPACK delegate instances have no runtime options");
+    for (BackendOption& option : options) {
+      ET_CHECK_OR_RETURN_ERROR(
+          std::strcmp(option.key(), xnnpack::kWorkspaceSharingOption) == 0,
+          NotSupported,
+          "Unknown option %s",
+          option.key());
+      option.set(static_cast<int64_t>(get_workspace_sharing()));
+    }
+    return Error::Ok;
+  }
+
+  void set_workspace_sharing(xnnpack::WorkspaceSharing sharing) {
+    const std::lock_guard<std::mutex> lock(workspaces_mutex_);
+    workspace_sharing_ = sharing;
+  }
+
+  xnnpack::WorkspaceSharing get_workspace_sharing() const {
+    const std::lock_guard<std::mutex> lock(workspaces_mutex_);
+    return workspace_sharing_;
+  }
+
+  Error set_packed_weights_cache_path(const std::string& path) {
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    const std::string fingerprint =
+        xnnpack::delegate::XNNWeightsCache::packing_fingerprint();
+    ET_CHECK_OR_RETURN_ERROR(
+        !fingerprint.empty(),
+        NotSupported,
+        "Packed weights files need a build with ET_XNNPACK_VERSION");
+    const std::unique_lock<std::shared_mutex> lock(weights_cache_mutex_);
+    const Error err = weights_cache_.load_from_file(path, fingerprint);
+    if (err == Error::InvalidState) {
+      return err;
+    }
+    if (err != Error::Ok) {
+      // The weights are packed as usual, to be saved to path.
+      ET_LOG(Info, "No valid packed weights in %s", path.c_str());
+    }
+    packed_weights_cache_path_ = path;
+    return Error::Ok;
+#else
+    (void)path;
+    ET_LOG(Error, "XNNPACK is built without the weights cache");
+    return Error::NotSupported;
+#endif
+  }
+
+  Error save_packed_weights_cache() {
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    // Only compiling and destroying delegates changes the cache.
+    const std::shared_lock<std::shared_mutex> lock(weights_cache_mutex_);
+    ET_CHECK_OR_RETURN_ERROR(
+        !packed_weights_cache_path_.empty(),
+        InvalidState,
+        "No packed weights cache path is set");
+    return weights_cache_.save_to_file(
+        packed_weights_cache_path_,
+        xnnpack::delegate::XNNWeightsCache::packing_fingerprint());
+#else
+    ET_LOG(Error, "XNNPACK is built without the weights cache");
+    return Error::NotSupported;
+#endif
   }
 
  private:
-  // This is a global workspace for all delegate instances.
-  mutable std::mutex workspace_mutex_;
-  std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)> workspace_{
-      nullptr,
-      &xnn_release_workspace};
+  // Destroys executor, then releases its packed weights from the weights
+  // cache. Expects weights_cache_mutex_ to be held if the cache is enabled.
+  void destroy_executor(xnnpack::delegate::XNNExecutor* executor) const {
+    const std::vector<std::string> packed_data_names =
+        executor->getPackedDataNames();
+    // XNNExecutor is not trivially destructible. Since this was constructed
+    // manually in init(), we must destroy it manually here.
+    executor->~XNNExecutor();
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+    weights_cache_.release_packed_data(packed_data_names);
+#endif
+  }
+
+  // The workspace to create the runtime of a new delegate instance with,
+  // according to the sharing policy, or null if it gets its own.
+  Result<std::shared_ptr<xnnpack::delegate::XNNWorkspace>> get_workspace(
+      BackendInitContext& context) const {
+    const std::lock_guard<std::mutex> lock(workspaces_mutex_);
+    const void* key = nullptr;
+    switch (workspace_sharing_) {
+      case xnnpack::WorkspaceSharing::Disabled:
+        return std::shared_ptr<xnnpack::delegate::XNNWorkspace>();
+      case xnnpack::WorkspaceSharing::Global:
+        break;
+      case xnnpack::WorkspaceSharing::PerThread: {
+        // Unique to the calling thread while it runs.
+        static thread_local char thread_key;
+        key = &thread_key;
+        break;
+      }
+      case xnnpack::WorkspaceSharing::PerMethod:
+        // Every method allocates its delegates from its own allocator.
+        key = context.get_runtime_allocator();
+        break;
+    }
+
+    std::weak_ptr<xnnpack::delegate::XNNWorkspace>& entry =
+        workspaces_[{workspace_sharing_, key}];
+    std::shared_ptr<xnnpack::delegate::XNNWorkspace> workspace = entry.lock();
+    if (workspace == nullptr) {
+      // Forget the workspaces that no delegate instance uses anymore, whose
+      // threads or methods may be gone.
+      for (auto it = workspaces_.begin(); it != workspaces_.end();) {
+        if (it->second.expired() && &it->second != &entry) {
+          it = workspaces_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      auto created = xnnpack::delegate::XNNWorkspace::create();
+      if (!created.ok()) {
+        return created.error();
+      }
+      workspace = std::move(created.get());
+      entry = workspace;
+    }
+    return workspace;
+  }
+
+  // The threadpool of the size that compile_specs ask for, or null to run on
+  // the threadpool selected for the calling thread.
+  Result<std::shared_ptr<ThreadPool>> get_threadpool(
+      ArrayRef<CompileSpec> compile_specs) const {
+    uint32_t num_threads = 0;
+    for (const CompileSpec& spec : compile_specs) {
+      if (std::strcmp(spec.key, xnnpack::kNumThreadsCompileSpec) == 0) {
+        ET_CHECK_OR_RETURN_ERROR(
+            spec.value.nbytes == sizeof(uint32_t),
+            InvalidArgument,
+            "Unexpected %s size %zu",
+            spec.key,
+            spec.value.nbytes);
+        const uint8_t* value = static_cast<const uint8_t*>(spec.value.buffer);
+        num_threads = static_cast<uint32_t>(value[0]) |
+            static_cast<uint32_t>(value[1]) << 8 |
+            static_cast<uint32_t>(value[2]) << 16 |
+            static_cast<uint32_t>(value[3]) << 24;
+      }
+    }
+    if (num_threads == 0 || ThreadPoolGuard::current() != nullptr) {
+      return std::shared_ptr<ThreadPool>();
+    }
+
+    const std::lock_guard<std::mutex> lock(threadpools_mutex_);
+    std::weak_ptr<ThreadPool>& entry = threadpools_[num_threads];
+    std::shared_ptr<ThreadPool> threadpool = entry.lock();
+    if (threadpool == nullptr) {
+      threadpool = std::make_shared<ThreadPool>(num_threads);
+      ET_LOG(Debug, "Created a threadpool of %u threads", num_threads);
+      entry = threadpool;
+    }
+    return threadpool;
+  }
+
+  struct WorkspaceKeyHash {
+    size_t operator()(
+        const std::pair<xnnpack::WorkspaceSharing, const void*>& key) const {
+      return std::hash<const void*>()(key.second) ^
+          static_cast<size_t>(key.first);
+    }
+  };
+
+  // Guards the sharing policy and the workspaces below.
+  mutable std::mutex workspaces_mutex_;
+#ifdef ENABLE_XNNPACK_SHARED_WORKSPACE
+  mutable xnnpack::WorkspaceSharing workspace_sharing_ =
+      xnnpack::WorkspaceSharing::Global;
+#else
+  mutable xnnpack::WorkspaceSharing workspace_sharing_ =
+      xnnpack::WorkspaceSharing::Disabled;
+#endif
+  // The workspaces that delegate instances share, by policy and by what they
+  // are shared across. Delegate instances own their workspace, which is
+  // released with the last one that uses it.
+  mutable std::unordered_map<
+      std::pair<xnnpack::WorkspaceSharing, const void*>,
+      std::weak_ptr<xnnpack::delegate::XNNWorkspace>,
+      WorkspaceKeyHash>
+      workspaces_;
+
+  // The threadpools that delegate instances ask for, by number of threads.
+  // Like workspaces, they are owned by the delegate instances that use them.
+  mutable std::mutex threadpools_mutex_;
+  mutable std::unordered_map<uint32_t, std::weak_ptr<ThreadPool>>
+      threadpools_;
+
+#ifdef ENABLE_XNNPACK_WEIGHTS_CACHE
+  // Packed weights shared by all delegate instances, across methods and
+  // Modules. Compiling and destroying instances takes the lock exclusively,
+  // running them takes it shared.
+  mutable std::shared_mutex weights_cache_mutex_;
+  mutable xnnpack::delegate::XNNWeightsCache weights_cache_;
+  std::string packed_weights_cache_path_;
+#endif
 };
 
 namespace {
@@ -162,5 +434,25 @@ Backend backend{"XnnpackBackend", &cls};
 static auto success_with_compiler = register_backend(backend);
 } // namespace
 
+namespace xnnpack {
+
+Error set_packed_weights_cache_path(const std::string& path) {
+  return cls.set_packed_weights_cache_path(path);
+}
+
+Error save_packed_weights_cache() {
+  return cls.save_packed_weights_cache();
+}
+
+void set_workspace_sharing(WorkspaceSharing sharing) {
+  cls.set_workspace_sharing(sharing);
+}
+
+WorkspaceSharing get_workspace_sharing() {
+  return cls.get_workspace_sharing();
+}
+
+} // namespace xnnpack
+
 } // namespace backends
 } // namespace executorch
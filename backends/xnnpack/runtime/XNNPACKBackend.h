@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/compiler.h>
+
+#include <cstdint>
+#include <string>
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+
+/**
+ * Backs the packed weights of the XNNPACK backend with a file, so that later
+ * launches load their delegates without packing any weights.
+ *
+ * If path holds packed weights for this build of XNNPACK and this CPU,
+ * delegates take the weights they find there from its read-only mapping.
+ * Either way, save_packed_weights_cache() writes to path. Call this before
+ * loading any delegate, from one thread.
+ *
+ * @return NotSupported if the backend is built without the weights cache, or
+ *     without ET_XNNPACK_VERSION to validate the file with.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Error set_packed_weights_cache_path(
+    const std::string& path);
+
+/**
+ * Writes the packed weights that loaded delegates use to the path set with
+ * set_packed_weights_cache_path(), e.g. once the first launch has loaded its
+ * methods.
+ */
+ET_EXPERIMENTAL ::executorch::runtime::Error save_packed_weights_cache();
+
+/**
+ * The compile spec that runs a delegate on a threadpool of its own size, e.g.
+ * to keep two models that run side by side from oversubscribing the cores.
+ * Its value is the number of threads, including the calling one, as a
+ * little-endian uint32. Delegates that ask for the same number of threads
+ * share a threadpool. A ThreadPoolGuard that is active while the delegate
+ * loads takes precedence, and without either the delegate runs on the global
+ * threadpool.
+ */
+constexpr char kNumThreadsCompileSpec[] = "num_threads";
+
+/**
+ * Which XNNPACK delegates share a workspace, the scratch memory of their
+ * runtimes. Delegates that share a workspace use less memory, but run one at
+ * a time.
+ */
+enum class WorkspaceSharing : uint8_t {
+  /// Every delegate has its own workspace, and runs concurrently with all
+  /// others. The default unless the backend is built with
+  /// ENABLE_XNNPACK_SHARED_WORKSPACE.
+  Disabled,
+  /// All delegates share one workspace, and run one at a time. The default if
+  /// the backend is built with ENABLE_XNNPACK_SHARED_WORKSPACE.
+  Global,
+  /// Delegates loaded on the same thread share a workspace, e.g. when every
+  /// thread loads and runs its own Module.
+  PerThread,
+  /// The delegates of a method share a workspace, which they never use at the
+  /// same time anyway, so different methods and Modules run concurrently.
+  PerMethod,
+};
+
+/**
+ * Sets which delegates that are loaded from now on share a workspace.
+ * Delegates that are already loaded keep theirs.
+ */
+ET_EXPERIMENTAL void set_workspace_sharing(WorkspaceSharing sharing);
+
+ET_EXPERIMENTAL WorkspaceSharing get_workspace_sharing();
+
+/**
+ * The runtime option of the backend itself that holds its WorkspaceSharing, as
+ * an int. Setting it through runtime::set_backend_options("XnnpackBackend",
+ * ...) is the same as calling set_workspace_sharing().
+ */
+constexpr char kWorkspaceSharingOption[] = "workspace_sharing";
+
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
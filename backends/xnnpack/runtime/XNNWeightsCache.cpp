@@ -0,0 +1,526 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
+#include <executorch/runtime/platform/log.h>
+
+#include <cpuinfo.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+namespace delegate {
+
+namespace {
+
+using executorch::runtime::Error;
+
+constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+
+// Prefixes the keys of weights that are never shared.
+constexpr char kUnsharedKeyPrefix[] = "unshared:";
+
+/**
+ * The header of a packed weights file. It is followed by the fingerprint,
+ * then by num_entries entries of the uint64_t size of a key, the key, and the
+ * uint64_t offset and size of its packed weights from the start of the file.
+ * Every part is padded to 8 bytes, and packed weights start at multiples of
+ * 64 bytes.
+ */
+struct PackedWeightsFileHeader {
+  char magic[8];
+  uint64_t fingerprint_size;
+  uint64_t num_entries;
+  uint64_t file_size;
+};
+
+constexpr char kPackedWeightsFileMagic[8] =
+    {'E', 'T', 'X', 'N', 'P', 'W', '0', '1'};
+
+inline uint64_t pad_to(uint64_t size, uint64_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+inline uint64_t mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  return x;
+}
+
+template <typename T>
+void append_bytes(std::string& key, const T& value) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+} // namespace
+
+XNNWeightsCache::XNNWeightsCache() {
+  provider_.context = this;
+  provider_.look_up = &XNNWeightsCache::look_up;
+  provider_.reserve_space = &XNNWeightsCache::reserve_space;
+  provider_.look_up_or_insert = &XNNWeightsCache::look_up_or_insert;
+  provider_.is_finalized = &XNNWeightsCache::is_finalized;
+  provider_.offset_to_addr = &XNNWeightsCache::offset_to_addr;
+  provider_.delete_cache = &XNNWeightsCache::delete_cache;
+}
+
+XNNWeightsCache::~XNNWeightsCache() {
+  unmap();
+}
+
+uint64_t XNNWeightsCache::hash(const void* data, size_t size, uint64_t seed) {
+  constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ull;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  uint64_t h = mix(seed ^ (size * kMultiplier));
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    h = (h ^ mix(word)) * kMultiplier;
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, bytes + i, size - i);
+  return mix((h ^ mix(tail)) * kMultiplier);
+}
+
+void XNNWeightsCache::initialize_for_runtime() {
+  constants_.clear();
+  reserved_.clear();
+  runtime_packed_data_.clear();
+  is_finalized_ = false;
+}
+
+void XNNWeightsCache::register_constant(
+    const void* data,
+    size_t size,
+    uint64_t salt) {
+  // Two independent hashes make a collision between distinct constants of
+  // the same size practically impossible.
+  std::string id;
+  append_bytes(id, static_cast<uint64_t>(size));
+  append_bytes(id, hash(data, size, salt));
+  append_bytes(id, hash(data, size, ~salt));
+  constants_[data] = std::move(id);
+}
+
+std::vector<std::string> XNNWeightsCache::finalize_for_runtime() {
+  for (const auto& key : runtime_packed_data_) {
+    packed_data_.at(key).ref_count++;
+  }
+  constants_.clear();
+  // Space for weights that turned out to be packed already.
+  reserved_.clear();
+  is_finalized_ = true;
+  return std::move(runtime_packed_data_);
+}
+
+void XNNWeightsCache::release_packed_data(
+    const std::vector<std::string>& keys) {
+  for (const auto& key : keys) {
+    auto it = packed_data_.find(key);
+    if (it != packed_data_.end() && --it->second.ref_count == 0) {
+      packed_data_.erase(it);
+    }
+  }
+}
+
+std::string XNNWeightsCache::packing_fingerprint() {
+#ifdef ET_XNNPACK_VERSION
+  std::string fingerprint = "xnnpack:" ET_XNNPACK_VERSION;
+  if (!cpuinfo_initialize()) {
+    return std::string();
+  }
+  // XNNPACK picks microkernels, and so packing layouts, by these features.
+  const bool features[] = {
+#if CPUINFO_ARCH_X86 || CPUINFO_ARCH_X86_64
+      cpuinfo_has_x86_sse4_1(),
+      cpuinfo_has_x86_avx(),
+      cpuinfo_has_x86_f16c(),
+      cpuinfo_has_x86_fma3(),
+      cpuinfo_has_x86_avx2(),
+      cpuinfo_has_x86_avx512f(),
+      cpuinfo_has_x86_avx512bw(),
+      cpuinfo_has_x86_avx512vl(),
+      cpuinfo_has_x86_avx512vnni(),
+      cpuinfo_has_x86_avx512fp16(),
+      cpuinfo_has_x86_avxvnni(),
+#elif CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+      cpuinfo_has_arm_neon(),
+      cpuinfo_has_arm_neon_fp16_arith(),
+      cpuinfo_has_arm_neon_dot(),
+      cpuinfo_has_arm_i8mm(),
+      cpuinfo_has_arm_neon_bf16(),
+      cpuinfo_has_arm_sve(),
+      cpuinfo_has_arm_sve2(),
+#endif
+  };
+  fingerprint += sizeof(void*) == 8 ? ":64:" : ":32:";
+  for (const bool feature : features) {
+    fingerprint += feature ? '1' : '0';
+  }
+  return fingerprint;
+#else
+  return std::string();
+#endif
+}
+
+Error XNNWeightsCache::load_from_file(
+    const std::string& path,
+    const std::string& fingerprint) {
+  ET_CHECK_OR_RETURN_ERROR(
+      mapping_ == nullptr && packed_data_.empty(),
+      InvalidState,
+      "The weights cache is already in use");
+#ifdef _WIN32
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return Error::NotFound;
+  }
+  const auto size = static_cast<size_t>(file.tellg());
+  mapping_buffer_ =
+      std::make_unique<uint8_t[]>(size + kPackedAllocationAlignment - 1);
+  const auto address = reinterpret_cast<uintptr_t>(mapping_buffer_.get());
+  void* data = reinterpret_cast<void*>(
+      (address + kPackedAllocationAlignment - 1) &
+      ~(static_cast<uintptr_t>(kPackedAllocationAlignment) - 1));
+  file.seekg(0);
+  ET_CHECK_OR_RETURN_ERROR(
+      file.read(static_cast<char*>(data), size),
+      AccessFailed,
+      "Failed to read %s",
+      path.c_str());
+#else
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return Error::NotFound;
+  }
+  struct stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    ET_LOG(Error, "Failed to get the size of %s", path.c_str());
+    return Error::AccessFailed;
+  }
+  const auto size = static_cast<size_t>(st.st_size);
+  void* data = size > 0
+      ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0)
+      : MAP_FAILED;
+  // The mapping stays valid after the file is closed.
+  ::close(fd);
+  ET_CHECK_OR_RETURN_ERROR(
+      data != MAP_FAILED, AccessFailed, "Failed to map %s", path.c_str());
+#endif
+  mapping_ = data;
+  mapping_size_ = size;
+
+  const Error err = index_mapping(fingerprint);
+  if (err != Error::Ok) {
+    unmap();
+    return err;
+  }
+  ET_LOG(
+      Info,
+      "Loaded %zu packed weights from %s",
+      mapped_data_.size(),
+      path.c_str());
+  return Error::Ok;
+}
+
+Error XNNWeightsCache::index_mapping(const std::string& fingerprint) {
+  const auto* bytes = static_cast<const uint8_t*>(mapping_);
+  PackedWeightsFileHeader header;
+  ET_CHECK_OR_RETURN_ERROR(
+      mapping_size_ >= sizeof(header),
+      InvalidArgument,
+      "Packed weights file is truncated");
+  std::memcpy(&header, bytes, sizeof(header));
+  ET_CHECK_OR_RETURN_ERROR(
+      std::memcmp(
+          header.magic,
+          kPackedWeightsFileMagic,
+          sizeof(kPackedWeightsFileMagic)) == 0 &&
+          header.file_size == mapping_size_,
+      InvalidArgument,
+      "Not a valid packed weights file");
+
+  uint64_t offset = sizeof(header);
+  // Reads size bytes at offset, advancing offset past them and their
+  // padding.
+  auto read = [&](void* out, uint64_t size) {
+    if (size > mapping_size_ || offset > mapping_size_ - size) {
+      return false;
+    }
+    std::memcpy(out, bytes + offset, size);
+    offset += pad_to(size, sizeof(uint64_t));
+    return true;
+  };
+
+  ET_CHECK_OR_RETURN_ERROR(
+      header.fingerprint_size <= mapping_size_,
+      InvalidArgument,
+      "Packed weights file is corrupt");
+  std::string file_fingerprint(header.fingerprint_size, '\0');
+  ET_CHECK_OR_RETURN_ERROR(
+      read(&file_fingerprint[0], header.fingerprint_size),
+      InvalidArgument,
+      "Packed weights file is truncated");
+  if (file_fingerprint != fingerprint) {
+    ET_LOG(
+        Info,
+        "Packed weights file was written for %s, expected %s",
+        file_fingerprint.c_str(),
+        fingerprint.c_str());
+    return Error::NotFound;
+  }
+
+  for (uint64_t i = 0; i < header.num_entries; ++i) {
+    uint64_t key_size = 0;
+    uint64_t data_offset = 0;
+    uint64_t data_size = 0;
+    ET_CHECK_OR_RETURN_ERROR(
+        read(&key_size, sizeof(key_size)) && key_size <= mapping_size_,
+        InvalidArgument,
+        "Packed weights file is corrupt");
+    std::string key(key_size, '\0');
+    ET_CHECK_OR_RETURN_ERROR(
+        read(&key[0], key_size) && read(&data_offset, sizeof(data_offset)) &&
+            read(&data_size, sizeof(data_size)) &&
+            data_size <= mapping_size_ &&
+            data_offset <= mapping_size_ - data_size &&
+            data_offset % kPackedAllocationAlignment == 0,
+        InvalidArgument,
+        "Packed weights file is corrupt");
+    mapped_data_.emplace(
+        std::move(key), MappedData{bytes + data_offset, data_size, false});
+  }
+  return Error::Ok;
+}
+
+void XNNWeightsCache::unmap() {
+#ifdef _WIN32
+  mapping_buffer_.reset();
+#else
+  if (mapping_ != nullptr) {
+    ::munmap(mapping_, mapping_size_);
+  }
+#endif
+  mapping_ = nullptr;
+  mapping_size_ = 0;
+  mapped_data_.clear();
+}
+
+Error XNNWeightsCache::save_to_file(
+    const std::string& path,
+    const std::string& fingerprint) const {
+  struct Entry {
+    const std::string* key;
+    const void* data;
+    size_t size;
+  };
+  std::vector<Entry> entries;
+  for (const auto& it : packed_data_) {
+    // Weights whose kernel is not a constant can't be found again.
+    const size_t prefix_size = sizeof(kUnsharedKeyPrefix) - 1;
+    if (it.first.compare(0, prefix_size, kUnsharedKeyPrefix) != 0) {
+      entries.push_back({&it.first, it.second.data, it.second.size});
+    }
+  }
+  for (const auto& it : mapped_data_) {
+    if (it.second.used) {
+      entries.push_back({&it.first, it.second.data, it.second.size});
+    }
+  }
+
+  PackedWeightsFileHeader header;
+  std::memcpy(
+      header.magic, kPackedWeightsFileMagic, sizeof(kPackedWeightsFileMagic));
+  header.fingerprint_size = fingerprint.size();
+  header.num_entries = entries.size();
+  uint64_t table_end = sizeof(header) + pad_to(fingerprint.size(), 8);
+  for (const auto& entry : entries) {
+    table_end += 3 * sizeof(uint64_t) + pad_to(entry.key->size(), 8);
+  }
+  std::vector<uint64_t> data_offsets;
+  uint64_t file_size = pad_to(table_end, kPackedAllocationAlignment);
+  for (const auto& entry : entries) {
+    data_offsets.push_back(file_size);
+    file_size = pad_to(file_size + entry.size, kPackedAllocationAlignment);
+  }
+  header.file_size = file_size;
+
+  const std::string temp_path = path + ".tmp";
+  std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+  ET_CHECK_OR_RETURN_ERROR(
+      file, AccessFailed, "Failed to create %s", temp_path.c_str());
+  uint64_t offset = 0;
+  const char zeros[kPackedAllocationAlignment] = {};
+  auto write = [&](const void* data, uint64_t size) {
+    file.write(static_cast<const char*>(data), size);
+    offset += size;
+  };
+  auto pad = [&](uint64_t alignment) {
+    write(zeros, pad_to(offset, alignment) - offset);
+  };
+  write(&header, sizeof(header));
+  write(fingerprint.data(), fingerprint.size());
+  pad(8);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const uint64_t key_size = entries[i].key->size();
+    const uint64_t data_size = entries[i].size;
+    write(&key_size, sizeof(key_size));
+    write(entries[i].key->data(), key_size);
+    pad(8);
+    write(&data_offsets[i], sizeof(uint64_t));
+    write(&data_size, sizeof(data_size));
+  }
+  for (const auto& entry : entries) {
+    pad(kPackedAllocationAlignment);
+    write(entry.data, entry.size);
+  }
+  pad(kPackedAllocationAlignment);
+  file.close();
+  ET_CHECK_OR_RETURN_ERROR(
+      file && offset == file_size,
+      AccessFailed,
+      "Failed to write %s",
+      temp_path.c_str());
+  ET_CHECK_OR_RETURN_ERROR(
+      std::rename(temp_path.c_str(), path.c_str()) == 0,
+      AccessFailed,
+      "Failed to rename %s to %s",
+      temp_path.c_str(),
+      path.c_str());
+  ET_LOG(
+      Info, "Saved %zu packed weights to %s", entries.size(), path.c_str());
+  return Error::Ok;
+}
+
+std::string XNNWeightsCache::make_key(
+    const xnn_weights_cache_look_up_key* cache_key) const {
+  const auto kernel = constants_.find(cache_key->kernel);
+  if (kernel == constants_.end()) {
+    return std::string();
+  }
+  std::string key = kernel->second;
+  if (cache_key->bias != nullptr) {
+    const auto bias = constants_.find(cache_key->bias);
+    if (bias == constants_.end()) {
+      return std::string();
+    }
+    key += bias->second;
+  }
+  append_bytes(key, cache_key->seed);
+  return key;
+}
+
+size_t XNNWeightsCache::look_up(
+    void* context,
+    const xnn_weights_cache_look_up_key* cache_key) {
+  auto* cache = static_cast<XNNWeightsCache*>(context);
+  std::string key = cache->make_key(cache_key);
+  if (key.empty()) {
+    return kNotFound;
+  }
+  const auto it = cache->packed_data_.find(key);
+  if (it != cache->packed_data_.end()) {
+    cache->runtime_packed_data_.push_back(std::move(key));
+    return reinterpret_cast<size_t>(it->second.data);
+  }
+  // Mapped weights live as long as the cache, so they are not counted.
+  const auto mapped = cache->mapped_data_.find(key);
+  if (mapped != cache->mapped_data_.end()) {
+    mapped->second.used = true;
+    return reinterpret_cast<size_t>(mapped->second.data);
+  }
+  return kNotFound;
+}
+
+void* XNNWeightsCache::reserve_space(void* context, size_t n) {
+  auto* cache = static_cast<XNNWeightsCache*>(context);
+  auto buffer =
+      std::make_unique<uint8_t[]>(n + kPackedAllocationAlignment - 1);
+  const auto address = reinterpret_cast<uintptr_t>(buffer.get());
+  void* aligned = reinterpret_cast<void*>(
+      (address + kPackedAllocationAlignment - 1) &
+      ~(static_cast<uintptr_t>(kPackedAllocationAlignment) - 1));
+  cache->reserved_.emplace(aligned, std::move(buffer));
+  return aligned;
+}
+
+size_t XNNWeightsCache::look_up_or_insert(
+    void* context,
+    const xnn_weights_cache_look_up_key* cache_key,
+    void* ptr,
+    size_t size) {
+  auto* cache = static_cast<XNNWeightsCache*>(context);
+  std::string key = cache->make_key(cache_key);
+  if (!key.empty()) {
+    const auto it = cache->packed_data_.find(key);
+    if (it != cache->packed_data_.end()) {
+      if (it->second.size == size &&
+          std::memcmp(it->second.data, ptr, size) == 0) {
+        cache->reserved_.erase(ptr);
+        cache->runtime_packed_data_.push_back(std::move(key));
+        return reinterpret_cast<size_t>(it->second.data);
+      }
+      ET_LOG(Debug, "Packed weights differ for the same key, not sharing");
+      key.clear();
+    }
+  }
+  if (key.empty()) {
+    key = kUnsharedKeyPrefix + std::to_string(cache->unshared_count_++);
+  }
+
+  const auto reserved = cache->reserved_.find(ptr);
+  if (reserved == cache->reserved_.end()) {
+    ET_LOG(Error, "Packed weights %p are not in reserved space", ptr);
+    return kNotFound;
+  }
+  cache->packed_data_.emplace(
+      key,
+      PackedData{
+          std::move(reserved->second),
+          ptr,
+          size,
+          /*ref_count=*/0});
+  cache->reserved_.erase(reserved);
+  cache->runtime_packed_data_.push_back(std::move(key));
+  return reinterpret_cast<size_t>(ptr);
+}
+
+bool XNNWeightsCache::is_finalized(void* context) {
+  return static_cast<XNNWeightsCache*>(context)->is_finalized_;
+}
+
+void* XNNWeightsCache::offset_to_addr(void* context, size_t offset) {
+  (void)context;
+  // Offsets are the addresses of the packed weights, which never move.
+  return reinterpret_cast<void*>(offset);
+}
+
+xnn_status XNNWeightsCache::delete_cache(void* context) {
+  (void)context;
+  // The cache outlives every runtime and frees its weights itself.
+  return xnn_status_success;
+}
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
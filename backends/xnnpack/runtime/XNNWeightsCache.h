@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+
+#include <xnnpack.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * Packed weights shared by every XNNPACK runtime that a backend creates, so
+ * that methods and Module instances with the same constants pack and store
+ * them once.
+ *
+ * XNNPACK identifies weights by the addresses of their unpacked data, which
+ * belongs to a delegate's processed blob and is freed after compilation. The
+ * cache instead identifies every constant by a hash of its contents, and of
+ * its quantization parameters, registered while a runtime is compiled.
+ * Packed weights are reference counted per runtime and freed with the last
+ * runtime that uses them.
+ *
+ * The cache can also be backed by a file of packed weights, written by a
+ * previous process with save_to_file(). Weights found in it are used from
+ * its read-only mapping, in clean pages that the OS can share and evict,
+ * instead of being packed again.
+ *
+ * Not thread safe. XNNPACK does not set up operators while their cache is
+ * not finalized, i.e. while another runtime is compiled, so the caller must
+ * serialize compiling and releasing runtimes with running them. Compiled
+ * runtimes may run concurrently with each other.
+ */
+class XNNWeightsCache {
+ public:
+  XNNWeightsCache();
+  ~XNNWeightsCache();
+
+  XNNWeightsCache(const XNNWeightsCache&) = delete;
+  XNNWeightsCache& operator=(const XNNWeightsCache&) = delete;
+
+  /**
+   * The cache to create XNNPACK runtimes with.
+   */
+  xnn_weights_cache_t get() {
+    return &provider_;
+  }
+
+  /**
+   * Begins the compilation of a runtime, forgetting the constants of the
+   * previous one.
+   */
+  void initialize_for_runtime();
+
+  /**
+   * Registers the unpacked constant data of the runtime being compiled.
+   * @param data The constant data, as passed to XNNPACK.
+   * @param size The size of the data in bytes.
+   * @param salt Distinguishes identical data that packs differently, e.g. a
+   *     hash of its quantization parameters.
+   */
+  void register_constant(const void* data, size_t size, uint64_t salt = 0);
+
+  /**
+   * Ends the compilation of a runtime.
+   * @return The packed weights that the runtime uses, each referenced once
+   *     more. Pass them to release_packed_data() once the runtime is deleted.
+   */
+  std::vector<std::string> finalize_for_runtime();
+
+  /**
+   * Drops a reference to each of the packed weights, freeing those that no
+   * runtime uses anymore.
+   */
+  void release_packed_data(const std::vector<std::string>& keys);
+
+  size_t num_packed_data() const {
+    return packed_data_.size();
+  }
+
+  /**
+   * Maps a file written by save_to_file(), to take packed weights from it
+   * rather than packing them. Can only be called once, before compiling any
+   * runtime.
+   * @param fingerprint Identifies how weights are packed, e.g.
+   *     packing_fingerprint(). A file written with another one is ignored.
+   * @return NotFound if the file doesn't exist or was written with another
+   *     fingerprint, in which case the cache works as if it weren't loaded.
+   */
+  ::executorch::runtime::Error load_from_file(
+      const std::string& path,
+      const std::string& fingerprint);
+
+  /**
+   * Writes the packed weights that live runtimes use, and those of the
+   * loaded file that any runtime used, to path. Writes a temporary file
+   * first, so that a loaded file at path stays valid.
+   */
+  ::executorch::runtime::Error save_to_file(
+      const std::string& path,
+      const std::string& fingerprint) const;
+
+  /**
+   * Identifies the XNNPACK build and the CPU features that pick its
+   * microkernels, which together determine the layout of packed weights.
+   * Empty if the build doesn't define ET_XNNPACK_VERSION.
+   */
+  static std::string packing_fingerprint();
+
+  /**
+   * A 64-bit hash of size bytes of data, e.g. to make a salt.
+   */
+  static uint64_t hash(const void* data, size_t size, uint64_t seed = 0);
+
+ private:
+  struct PackedData {
+    std::unique_ptr<uint8_t[]> buffer;
+    void* data;
+    size_t size;
+    size_t ref_count;
+  };
+
+  // Packed weights in the loaded file.
+  struct MappedData {
+    const void* data;
+    size_t size;
+    // Whether a runtime used the weights, so that save_to_file() keeps them.
+    bool used;
+  };
+
+  static constexpr size_t kPackedAllocationAlignment = 64;
+
+  // Reads the entries of the mapped file into mapped_data_.
+  ::executorch::runtime::Error index_mapping(const std::string& fingerprint);
+  void unmap();
+
+  // The key of packed weights, or an empty string if the kernel is not a
+  // registered constant.
+  std::string make_key(const xnn_weights_cache_look_up_key* cache_key) const;
+
+  static size_t look_up(
+      void* context,
+      const xnn_weights_cache_look_up_key* cache_key);
+  static void* reserve_space(void* context, size_t n);
+  static size_t look_up_or_insert(
+      void* context,
+      const xnn_weights_cache_look_up_key* cache_key,
+      void* ptr,
+      size_t size);
+  static bool is_finalized(void* context);
+  static void* offset_to_addr(void* context, size_t offset);
+  static xnn_status delete_cache(void* context);
+
+  xnn_weights_cache_provider provider_;
+  // The identities of the constants of the runtime being compiled, by
+  // address.
+  std::unordered_map<const void*, std::string> constants_;
+  // Space that XNNPACK reserved to pack weights into, by aligned address.
+  std::unordered_map<void*, std::unique_ptr<uint8_t[]>> reserved_;
+  std::unordered_map<std::string, PackedData> packed_data_;
+  std::unordered_map<std::string, MappedData> mapped_data_;
+  // The mapping of the loaded file, if any.
+  void* mapping_ = nullptr;
+  size_t mapping_size_ = 0;
+#ifdef _WIN32
+  std::unique_ptr<uint8_t[]> mapping_buffer_;
+#endif
+  // The packed weights that the runtime being compiled uses.
+  std::vector<std::string> runtime_packed_data_;
+  // Makes keys for weights whose kernel is not a registered constant, and
+  // that are never shared.
+  size_t unshared_count_ = 0;
+  bool is_finalized_ = true;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
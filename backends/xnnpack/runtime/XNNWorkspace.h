@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+
+#include <xnnpack.h>
+#include <memory>
+#include <mutex>
+
+namespace executorch {
+namespace backends {
+namespace xnnpack {
+namespace delegate {
+
+/**
+ * An XNNPACK workspace, the scratch memory of the runtimes created with it,
+ * and the mutex that serializes them. Runtimes that share a workspace must
+ * not be created, run or deleted concurrently, so hold mutex() to do any of
+ * them. Runtimes in different workspaces are independent of each other.
+ */
+class XNNWorkspace {
+ public:
+  XNNWorkspace(const XNNWorkspace&) = delete;
+  XNNWorkspace& operator=(const XNNWorkspace&) = delete;
+
+  static ::executorch::runtime::Result<std::shared_ptr<XNNWorkspace>>
+  create() {
+    xnn_workspace_t workspace = nullptr;
+    const xnn_status status = xnn_create_workspace(&workspace);
+    if (status != xnn_status_success) {
+      ET_LOG(
+          Error,
+          "Failed to create XNN workspace, XNNPACK status: 0x%x",
+          (unsigned int)status);
+      return ::executorch::runtime::Error::Internal;
+    }
+    ET_LOG(Debug, "Created XNN workspace: %p", workspace);
+    return std::shared_ptr<XNNWorkspace>(new XNNWorkspace(workspace));
+  }
+
+  xnn_workspace_t get() {
+    return workspace_.get();
+  }
+
+  std::mutex& mutex() {
+    return mutex_;
+  }
+
+ private:
+  explicit XNNWorkspace(xnn_workspace_t workspace)
+      : workspace_(workspace, &xnn_release_workspace) {}
+
+  std::unique_ptr<xnn_workspace, decltype(&xnn_release_workspace)> workspace_;
+  std::mutex mutex_;
+};
+
+} // namespace delegate
+} // namespace xnnpack
+} // namespace backends
+} // namespace executorch
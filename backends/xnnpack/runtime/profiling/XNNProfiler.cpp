@@ -17,7 +17,6 @@
 #include <executorch/runtime/platform/types.h>
 
 #include <cinttypes>
-#include <cstring>
 #include <string>
 #include <unordered_map>
 // NOLINTEND
@@ -30,14 +29,21 @@ using executorch::runtime::EventTracer;
 #if defined(ET_EVENT_TRACER_ENABLED) || defined(ENABLE_XNNPACK_PROFILING)
 
 XNNProfiler::XNNProfiler()
-    : state_(XNNProfilerState::Uninitialized), run_count_(0) {}
-
-Error XNNProfiler::initialize(xnn_runtime_t runtime) {
+    : state_(XNNProfilerState::Uninitialized),
+      run_count_(0),
+      enabled_(false),
+      shapes_stale_(true) {}
+
+Error XNNProfiler::initialize(
+    xnn_runtime_t runtime,
+    const std::vector<uint32_t>& input_ids) {
   runtime_ = runtime;
+  input_ids_ = input_ids;
 
   // Fetch the runtime operator information from XNNPACK.
   ET_CHECK_OK_OR_RETURN_ERROR(get_runtime_num_operators());
   ET_CHECK_OK_OR_RETURN_ERROR(get_runtime_operator_names());
+  op_timings_.resize(op_count_);
 
   state_ = XNNProfilerState::Ready;
 
@@ -60,6 +66,16 @@ Error XNNProfiler::start(EventTracer* event_tracer) {
 
   event_tracer_ = event_tracer;
   state_ = XNNProfilerState::Running;
+#ifdef ENABLE_XNNPACK_PROFILING
+  enabled_ = true;
+#else
+  enabled_ = event_tracer != nullptr &&
+      event_tracer->event_tracer_profiling_level() ==
+          executorch::runtime::EventTracerProfilingLevel::kProfileAllEvents;
+#endif
+  if (!enabled_) {
+    return Error::Ok;
+  }
 
   // Log the start of execution timestamp.
   start_time_ = et_pal_current_ticks();
@@ -74,6 +90,11 @@ Error XNNProfiler::end() {
       InvalidState,
       "XNNProfiler is not running. Ensure begin_execution() is called before end_execution().");
 
+  if (!enabled_) {
+    state_ = XNNProfilerState::Ready;
+    return Error::Ok;
+  }
+
   // Retrieve operator timing from XNNPACK.
   ET_CHECK_OK_OR_RETURN_ERROR(get_runtime_operator_timings());
 
@@ -87,6 +108,10 @@ Error XNNProfiler::end() {
   return Error::Ok;
 }
 
+void XNNProfiler::reshaped() {
+  shapes_stale_ = true;
+}
+
 Error XNNProfiler::get_runtime_operator_names() {
   size_t required_size = 0;
 
@@ -100,13 +125,14 @@ Error XNNProfiler::get_runtime_operator_names() {
       &required_size // param_value_size_ret
   );
 
+  std::vector<char> names;
   if (status == xnn_status_out_of_memory) {
-    op_names_.resize(required_size);
+    names.resize(required_size);
     status = xnn_get_runtime_profiling_info(
         runtime_,
         xnn_profile_info_operator_name,
-        op_names_.size(),
-        op_names_.data(),
+        names.size(),
+        names.data(),
         &required_size);
   }
 
@@ -115,6 +141,32 @@ Error XNNProfiler::get_runtime_operator_names() {
     return Error::Internal;
   }
 
+  // Format the op names as {name} #{count} once, rather than on every run.
+  std::string formatted;
+  std::vector<size_t> offsets;
+  std::unordered_map<std::string, uint32_t> op_counts;
+  size_t name_len = 0;
+  for (size_t i = 0; i < op_count_ && name_len < names.size(); i++) {
+    const std::string op_name(&names[name_len]);
+    name_len += op_name.size() + 1;
+
+    offsets.push_back(formatted.size());
+    formatted += op_name + " #" + std::to_string(++op_counts[op_name]);
+    formatted.push_back('\0');
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      offsets.size() == op_count_,
+      Internal,
+      "Expected %zu XNNPACK operator names, but got %zu",
+      op_count_,
+      offsets.size());
+
+  op_names_.assign(formatted.begin(), formatted.end());
+  op_name_ptrs_.clear();
+  for (const size_t offset : offsets) {
+    op_name_ptrs_.push_back(&op_names_[offset]);
+  }
+
   return Error::Ok;
 }
 
@@ -139,8 +191,7 @@ Error XNNProfiler::get_runtime_num_operators() {
 Error XNNProfiler::get_runtime_operator_timings() {
   size_t required_size;
 
-  // Get number of runtime operators for timing_stats.size
-  op_timings_.resize(op_count_);
+  // op_timings_ is sized to the number of runtime operators at initialize.
   xnn_status status = xnn_get_runtime_profiling_info(
       runtime_,
       xnn_profile_info_operator_timing,
@@ -160,8 +211,6 @@ void XNNProfiler::log_operator_timings() {
 #ifdef ENABLE_XNNPACK_PROFILING
   // Update running average state and log average timing for each op.
   run_count_++;
-  size_t name_len = 0;
-  const char* op_name = nullptr;
   auto total_time = 0.0f;
 
   if (op_timings_sum_.size() != op_count_) {
@@ -169,8 +218,7 @@ void XNNProfiler::log_operator_timings() {
   }
 
   for (size_t i = 0; i < op_count_; i++) {
-    op_name = &op_names_[name_len];
-    name_len += strlen(op_name) + 1;
+    const char* op_name = op_name_ptrs_[i];
 
     op_timings_sum_[i] += op_timings_[i];
     auto avg_op_time = op_timings_sum_[i] / static_cast<float>(run_count_);
@@ -185,25 +233,46 @@ void XNNProfiler::log_operator_timings() {
 #endif
 }
 
+void XNNProfiler::format_input_shapes() {
+  shapes_.clear();
+  for (const uint32_t id : input_ids_) {
+    size_t num_dims = 0;
+    size_t dims[XNN_MAX_TENSOR_DIMS];
+    const xnn_status status =
+        xnn_get_external_value_shape(runtime_, id, &num_dims, dims);
+    if (!shapes_.empty()) {
+      shapes_ += ", ";
+    }
+    if (status != xnn_status_success) {
+      shapes_ += "?";
+      continue;
+    }
+    shapes_.push_back('[');
+    for (size_t d = 0; d < num_dims; d++) {
+      if (d > 0) {
+        shapes_.push_back(',');
+      }
+      shapes_ += std::to_string(dims[d]);
+    }
+    shapes_.push_back(']');
+  }
+  shapes_stale_ = false;
+}
+
 void XNNProfiler::submit_trace() {
   // Retrieve the system tick rate (ratio between ticks and nanoseconds).
   auto tick_ns_conv_multiplier = et_pal_ticks_to_ns_multiplier();
 
   ET_CHECK(op_timings_.size() == op_count_);
-  size_t name_len = 0;
   et_timestamp_t time = start_time_;
-  std::unordered_map<std::string, uint32_t> op_counts;
-
-  for (auto i = 0u; i < op_count_; i++) {
-    auto op_name = &op_names_[name_len];
-    name_len += strlen(op_name) + 1;
 
-    // Format the op name as {name} #{count}.
-    auto op_name_str = std::string(op_name);
-    op_counts[op_name_str]++;
-    auto name_formatted =
-        op_name_str + " #" + std::to_string(op_counts[op_name_str]);
+  // Every operator event carries the input shapes as its metadata, which
+  // tells apart the runs of a dynamically shaped delegate.
+  if (shapes_stale_) {
+    format_input_shapes();
+  }
 
+  for (auto i = 0u; i < op_count_; i++) {
     // Convert from microseconds (XNNPACK) to PAL ticks (ET).
     // The tick_ns_conv_ratio is ns / tick. We want ticks:
     //  ticks = us * (ns / us) / conv_ratio
@@ -216,10 +285,12 @@ void XNNProfiler::submit_trace() {
 
     executorch::runtime::event_tracer_log_profiling_delegate(
         event_tracer_,
-        name_formatted.c_str(),
+        op_name_ptrs_[i],
         /*delegate_debug_id=*/static_cast<executorch::runtime::DebugHandle>(-1),
         time,
-        end_time);
+        end_time,
+        shapes_.data(),
+        shapes_.size());
 
     // Assume that the next op starts immediately after the previous op.
     // This may not be strictly true, but it should be close enough.
@@ -234,8 +305,11 @@ void XNNProfiler::submit_trace() {
 // Stub implementation for when profiling is disabled.
 XNNProfiler::XNNProfiler() {}
 
-Error XNNProfiler::initialize(xnn_runtime_t runtime) {
+Error XNNProfiler::initialize(
+    xnn_runtime_t runtime,
+    const std::vector<uint32_t>& input_ids) {
   (void)runtime;
+  (void)input_ids;
   return Error::Ok;
 }
 
@@ -248,6 +322,8 @@ Error XNNProfiler::end() {
   return Error::Ok;
 }
 
+void XNNProfiler::reshaped() {}
+
 #endif
 
 } // namespace executorch::backends::xnnpack::delegate::profiling
@@ -12,6 +12,8 @@
 #include <executorch/runtime/core/event_tracer_hooks_delegate.h>
 
 #include <xnnpack.h>
+#include <cstdint>
+#include <string>
 #include <vector>
 
 namespace executorch {
@@ -29,17 +31,31 @@ class XNNProfiler {
   /**
    * Initialize the profiler. This must be called after model is
    * compiled and before calling begin_execution.
+   *
+   * @param input_ids The external ids of the runtime inputs, whose shapes
+   *     are logged as the metadata of the operator events.
    */
-  executorch::runtime::Error initialize(xnn_runtime_t runtime);
+  executorch::runtime::Error initialize(
+      xnn_runtime_t runtime,
+      const std::vector<uint32_t>& input_ids);
 
   /**
    * Start a new profiling session. This is typically invoked
    * immediately before invoking the XNNPACK runtime as part
    * of a forward pass.
+   *
+   * The session only reads the operator timings if event_tracer is not null
+   * and profiles all events, or if the backend is built with
+   * ENABLE_XNNPACK_PROFILING, so that runs without profiling cost nothing.
    */
   executorch::runtime::Error start(
       executorch::runtime::EventTracer* event_tracer);
 
+  /**
+   * Notes that the runtime inputs were reshaped since the last session.
+   */
+  void reshaped();
+
   /**
    * End a profiling session. This is typically invoked immediately
    * after the XNNPACK runtime invocation completes.
@@ -53,10 +69,21 @@ class XNNProfiler {
   XNNProfilerState state_;
 
   size_t op_count_;
+  // The operator names, formatted as "{name} #{count}" once, each null
+  // terminated, and the start of each name.
   std::vector<char> op_names_;
+  std::vector<const char*> op_name_ptrs_;
   std::vector<uint64_t> op_timings_;
   uint64_t run_count_;
   et_timestamp_t start_time_;
+  // Whether the running session reads the operator timings.
+  bool enabled_;
+
+  // The shapes of the runtime inputs, formatted as the metadata of the
+  // operator events when they changed since the last traced session.
+  std::vector<uint32_t> input_ids_;
+  std::string shapes_;
+  bool shapes_stale_;
 
 #ifdef ENABLE_XNNPACK_PROFILING
   // State needed to track average timing. Track the running sum of
@@ -70,6 +97,7 @@ class XNNProfiler {
   executorch::runtime::Error get_runtime_operator_timings();
 
   void log_operator_timings();
+  void format_input_shapes();
 
   /**
    * Submit the trace to the ET event tracer.
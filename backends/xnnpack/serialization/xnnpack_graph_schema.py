@@ -10,7 +10,7 @@
 Please refer to executorch/backends/xnnpack/serialization/schema.fbs for the schema definitions
 """
 
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from enum import IntEnum
 from typing import List, Optional, Union
 
@@ -256,6 +256,24 @@ class XNNFullyConnected:  # aten::Linear
     flags: int
 
 
+@dataclass
+class XNNDynamicFullyConnected:  # aten::Linear with dynamically quantized input
+    input1_id: int
+    filter_id: int
+    bias_id: int
+    output_id: int
+    flags: int
+    num_nonbatch_dims: int = 1
+
+
+@dataclass
+class XNNUpdateCache:  # llama::update_cache
+    value_id: int
+    cache_external_id: int
+    start_pos_external_id: int
+    flags: int
+
+
 @dataclass
 class XNNStaticReshape:
     num_dims: int
@@ -360,6 +378,8 @@ XNodeUnion = Union[
     XNNStaticSlice,
     XNNScaledDotProductAttention,
     XNNBatchMatrixMultiply,
+    XNNDynamicFullyConnected,
+    XNNUpdateCache,
 ]
 
 
@@ -464,3 +484,6 @@ class XNNGraph:
     output_ids: List[int]
 
     constant_data: List[ConstantDataOffset]
+
+    # External ids of the inputs and outputs whose data is NHWC
+    channels_last_ids: List[int] = field(default_factory=list)
@@ -3,14 +3,20 @@ load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
 
 def _get_preprocessor_flags():
     """
-    Disable if someone explictly specified a config option,
-    else Enable otherwise
+    Enable the features that are turned on through config options
     """
-    if native.read_config("executorch", "xnnpack_workspace_sharing", "0") == "0":
-        return []
+    flags = []
+    if native.read_config("executorch", "xnnpack_workspace_sharing", "0") != "0":
+        flags.append("-DENABLE_XNNPACK_SHARED_WORKSPACE")
+    if native.read_config("executorch", "xnnpack_weights_cache", "0") != "0":
+        flags.append("-DENABLE_XNNPACK_WEIGHTS_CACHE")
 
-    # Enable if not disabled through config
-    return ["-DENABLE_XNNPACK_SHARED_WORKSPACE"]
+    # Packed weights files are only valid for the XNNPACK version that wrote
+    # them.
+    xnnpack_version = native.read_config("executorch", "xnnpack_version", "")
+    if xnnpack_version:
+        flags.append("-DET_XNNPACK_VERSION=\"{}\"".format(xnnpack_version))
+    return flags
 
 def define_common_targets():
     runtime.cxx_library(
@@ -35,10 +41,14 @@ def define_common_targets():
             "runtime/*.cpp",
             "runtime/profiling/*.cpp",
         ]),
-        headers = native.glob([
-            "runtime/*.h",
-            "runtime/profiling/*.h",
-        ]),
+        headers = native.glob(
+            [
+                "runtime/*.h",
+                "runtime/profiling/*.h",
+            ],
+            exclude = ["runtime/XNNPACKBackend.h"],
+        ),
+        exported_headers = ["runtime/XNNPACKBackend.h"],
         visibility = [
             "//executorch/exir/backend:backend_lib",
             "//executorch/exir/backend/test/...",
@@ -57,6 +67,7 @@ def define_common_targets():
         ],
         deps = [
             third_party_dep("XNNPACK"),
+            third_party_dep("cpuinfo"),
             "//executorch/backends/xnnpack/serialization:xnnpack_flatbuffer_header",
             "//executorch/extension/threadpool:threadpool",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
@@ -10,10 +10,11 @@ import torch
 from executorch.backends.xnnpack._passes.channels_last_tagged_reshape_pass import (
     ChannelsLastTaggedReshapePass,
 )
+from executorch.backends.xnnpack.partition.xnnpack_partitioner import XnnpackPartitioner
 from executorch.backends.xnnpack.test.test_xnnpack_utils_classes import (
     OpSequencesAddConv2d,
 )
-from executorch.backends.xnnpack.test.tester import RunPasses, Tester
+from executorch.backends.xnnpack.test.tester import Partition, RunPasses, Tester
 
 
 class TestChannelsLastTaggedReshapePass(unittest.TestCase):
@@ -173,3 +174,34 @@ class TestChannelsLastTaggedReshapePass(unittest.TestCase):
             )
             .run_method_and_compare_outputs()
         )
+
+    class ConvReluConv(torch.nn.Module):
+        def __init__(self):
+            super().__init__()
+            self.conv1 = torch.nn.Conv2d(2, 3, 3)
+            self.relu = torch.nn.ReLU()
+            self.conv2 = torch.nn.Conv2d(3, 4, 1)
+
+        def forward(self, x):
+            return self.conv2(self.relu(self.conv1(x)))
+
+    def test_fp32_channels_last_boundaries_between_delegates(self):
+        # The tensor between the delegates stays NHWC, with NCHW sizes
+        for channels_last_boundaries in (False, True):
+            (
+                Tester(self.ConvReluConv().eval(), (torch.randn(1, 2, 7, 5),))
+                .export()
+                .to_edge()
+                .partition(
+                    Partition(
+                        XnnpackPartitioner(
+                            per_op_mode=True,
+                            channels_last_boundaries=channels_last_boundaries,
+                        )
+                    )
+                )
+                .check_count({"torch.ops.higher_order.executorch_call_delegate": 2})
+                .to_executorch()
+                .serialize()
+                .run_method_and_compare_outputs()
+            )
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/backends/xnnpack/runtime/XNNWeightsCache.h>
+#include <executorch/runtime/platform/platform.h>
+#include <gtest/gtest.h>
+#include <xnnpack.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+using executorch::backends::xnnpack::delegate::XNNWeightsCache;
+using executorch::runtime::Error;
+
+namespace {
+
+constexpr size_t kNotFound = std::numeric_limits<size_t>::max();
+
+// Packs kernel the way an operator would: looks it up, and on a miss
+// reserves space, "packs" a copy of it and inserts it.
+void* pack(
+    XNNWeightsCache& cache,
+    const float* kernel,
+    const float* bias,
+    size_t size,
+    bool* was_cached = nullptr) {
+  xnn_weights_cache_t provider = cache.get();
+  xnn_weights_cache_look_up_key key;
+  key.seed = 7;
+  key.kernel = kernel;
+  key.bias = bias;
+  size_t offset = provider->look_up(provider->context, &key);
+  if (was_cached != nullptr) {
+    *was_cached = offset != kNotFound;
+  }
+  if (offset == kNotFound) {
+    void* space = provider->reserve_space(provider->context, size);
+    std::memcpy(space, kernel, size);
+    offset = provider->look_up_or_insert(provider->context, &key, space, size);
+  }
+  EXPECT_NE(offset, kNotFound);
+  return provider->offset_to_addr(provider->context, offset);
+}
+
+} // namespace
+
+TEST(XNNWeightsCacheTest, SharesWeightsWithSameContents) {
+  XNNWeightsCache cache;
+  // Two copies of the same constants, as two Modules would load them.
+  float weights_a[] = {1, 2, 3, 4};
+  float weights_b[] = {1, 2, 3, 4};
+
+  cache.initialize_for_runtime();
+  cache.register_constant(weights_a, sizeof(weights_a));
+  bool was_cached = true;
+  void* packed_a =
+      pack(cache, weights_a, nullptr, sizeof(weights_a), &was_cached);
+  EXPECT_FALSE(was_cached);
+  EXPECT_FALSE(cache.get()->is_finalized(cache.get()->context));
+  auto names_a = cache.finalize_for_runtime();
+  EXPECT_TRUE(cache.get()->is_finalized(cache.get()->context));
+
+  cache.initialize_for_runtime();
+  cache.register_constant(weights_b, sizeof(weights_b));
+  void* packed_b =
+      pack(cache, weights_b, nullptr, sizeof(weights_b), &was_cached);
+  EXPECT_TRUE(was_cached);
+  auto names_b = cache.finalize_for_runtime();
+
+  EXPECT_EQ(packed_a, packed_b);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(packed_a) % 64, 0);
+  EXPECT_EQ(cache.num_packed_data(), 1);
+
+  // The weights outlive the first runtime that used them.
+  cache.release_packed_data(names_a);
+  EXPECT_EQ(cache.num_packed_data(), 1);
+  EXPECT_EQ(static_cast<float*>(packed_b)[3], 4.0f);
+  cache.release_packed_data(names_b);
+  EXPECT_EQ(cache.num_packed_data(), 0);
+}
+
+TEST(XNNWeightsCacheTest, DoesNotShareDifferentWeights) {
+  XNNWeightsCache cache;
+  float weights[] = {1, 2, 3, 4};
+  float other_weights[] = {1, 2, 3, 5};
+  float bias[] = {1};
+  float other_bias[] = {2};
+
+  cache.initialize_for_runtime();
+  cache.register_constant(weights, sizeof(weights));
+  cache.register_constant(other_weights, sizeof(other_weights));
+  cache.register_constant(bias, sizeof(bias));
+  cache.register_constant(other_bias, sizeof(other_bias));
+  void* packed = pack(cache, weights, bias, sizeof(weights));
+  EXPECT_NE(pack(cache, other_weights, bias, sizeof(weights)), packed);
+  EXPECT_NE(pack(cache, weights, other_bias, sizeof(weights)), packed);
+  auto names = cache.finalize_for_runtime();
+  EXPECT_EQ(cache.num_packed_data(), 3);
+
+  // The same data with different quantization parameters packs differently.
+  cache.initialize_for_runtime();
+  cache.register_constant(weights, sizeof(weights), /*salt=*/1);
+  cache.register_constant(bias, sizeof(bias));
+  bool was_cached = true;
+  pack(cache, weights, bias, sizeof(weights), &was_cached);
+  EXPECT_FALSE(was_cached);
+  auto salted_names = cache.finalize_for_runtime();
+  EXPECT_EQ(cache.num_packed_data(), 4);
+
+  cache.release_packed_data(names);
+  cache.release_packed_data(salted_names);
+  EXPECT_EQ(cache.num_packed_data(), 0);
+}
+
+TEST(XNNWeightsCacheTest, KeepsUnregisteredWeightsUnshared) {
+  XNNWeightsCache cache;
+  float weights[] = {1, 2, 3, 4};
+
+  cache.initialize_for_runtime();
+  bool was_cached = true;
+  void* packed = pack(cache, weights, nullptr, sizeof(weights), &was_cached);
+  EXPECT_FALSE(was_cached);
+  EXPECT_NE(
+      pack(cache, weights, nullptr, sizeof(weights), &was_cached), packed);
+  EXPECT_FALSE(was_cached);
+  auto names = cache.finalize_for_runtime();
+  EXPECT_EQ(cache.num_packed_data(), 2);
+
+  cache.release_packed_data(names);
+  EXPECT_EQ(cache.num_packed_data(), 0);
+}
+
+TEST(XNNWeightsCacheTest, LoadsSavedWeights) {
+  et_pal_init();
+  const std::string path =
+      ::testing::TempDir() + "test_xnn_weights_cache.bin";
+  float weights[] = {1, 2, 3, 4};
+  float bias[] = {5};
+  {
+    XNNWeightsCache cache;
+    cache.initialize_for_runtime();
+    cache.register_constant(weights, sizeof(weights));
+    cache.register_constant(bias, sizeof(bias));
+    pack(cache, weights, bias, sizeof(weights));
+    // Weights of a kernel that is not a constant are not saved.
+    pack(cache, bias, nullptr, sizeof(bias));
+    auto names = cache.finalize_for_runtime();
+    ASSERT_EQ(cache.save_to_file(path, "fingerprint"), Error::Ok);
+    cache.release_packed_data(names);
+  }
+
+  XNNWeightsCache other_build;
+  EXPECT_EQ(other_build.load_from_file(path, "other"), Error::NotFound);
+
+  XNNWeightsCache cache;
+  ASSERT_EQ(cache.load_from_file(path, "fingerprint"), Error::Ok);
+  EXPECT_EQ(cache.load_from_file(path, "fingerprint"), Error::InvalidState);
+  // Another copy of the same constants, in the next process.
+  float weights_copy[] = {1, 2, 3, 4};
+  float bias_copy[] = {5};
+  cache.initialize_for_runtime();
+  cache.register_constant(weights_copy, sizeof(weights_copy));
+  cache.register_constant(bias_copy, sizeof(bias_copy));
+  bool was_cached = false;
+  const auto* packed = static_cast<const float*>(
+      pack(cache, weights_copy, bias_copy, sizeof(weights), &was_cached));
+  EXPECT_TRUE(was_cached);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(packed) % 64, 0);
+  EXPECT_EQ(packed[2], 3.0f);
+  cache.finalize_for_runtime();
+  // Mapped weights are not packed into memory.
+  EXPECT_EQ(cache.num_packed_data(), 0);
+
+  // Weights that the process used are saved again.
+  const std::string resaved_path = path + ".resaved";
+  ASSERT_EQ(cache.save_to_file(resaved_path, "fingerprint"), Error::Ok);
+  XNNWeightsCache resaved;
+  ASSERT_EQ(resaved.load_from_file(resaved_path, "fingerprint"), Error::Ok);
+  EXPECT_EQ(
+      resaved.load_from_file(path + ".missing", "x"), Error::InvalidState);
+  std::remove(path.c_str());
+  std::remove(resaved_path.c_str());
+}
+
+TEST(XNNWeightsCacheTest, RejectsCorruptFiles) {
+  et_pal_init();
+  const std::string path =
+      ::testing::TempDir() + "test_xnn_weights_cache_corrupt.bin";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "not a packed weights file, but long enough for a header";
+  }
+  XNNWeightsCache cache;
+  EXPECT_EQ(cache.load_from_file(path, "fingerprint"), Error::InvalidArgument);
+  EXPECT_EQ(
+      cache.load_from_file(path + ".missing", "fingerprint"), Error::NotFound);
+  std::remove(path.c_str());
+}
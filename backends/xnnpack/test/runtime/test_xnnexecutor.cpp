@@ -12,6 +12,7 @@
 #include <xnnpack.h>
 
 using executorch::backends::xnnpack::delegate::XNNExecutor;
+using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::testing::TensorFactory;
@@ -92,3 +93,71 @@ TEST(XNNExecutorTest, ArgumentWithTooManyDimensions) {
   // Check for invalid number of dimensions should fail without stack overflow.
   EXPECT_EQ(executor.prepare_args(args.data()), Error::InvalidArgument);
 }
+
+TEST(XNNExecutorTest, ReshapesOnlyWhenInputShapesChange) {
+  XNNExecutor executor;
+  xnn_subgraph_t subgraph = nullptr;
+  xnn_runtime_t rt = nullptr;
+  et_pal_init();
+  ASSERT_EQ(xnn_initialize(nullptr), xnn_status_success);
+  ASSERT_EQ(xnn_create_subgraph(2, 0, &subgraph), xnn_status_success);
+  std::unique_ptr<xnn_subgraph, decltype(&xnn_delete_subgraph)> auto_subgraph(
+      subgraph, xnn_delete_subgraph);
+
+  std::vector<size_t> dims = {2};
+  uint32_t input_id = XNN_INVALID_VALUE_ID;
+  ASSERT_EQ(
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/0,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_INPUT,
+          &input_id),
+      xnn_status_success);
+  uint32_t output_id = XNN_INVALID_VALUE_ID;
+  ASSERT_EQ(
+      xnn_define_tensor_value(
+          subgraph,
+          xnn_datatype_fp32,
+          dims.size(),
+          dims.data(),
+          nullptr,
+          /*external_id=*/1,
+          /*flags=*/XNN_VALUE_FLAG_EXTERNAL_OUTPUT,
+          &output_id),
+      xnn_status_success);
+  ASSERT_EQ(
+      xnn_define_clamp(subgraph, 0.0f, 1.0f, input_id, output_id, 0),
+      xnn_status_success);
+  ASSERT_EQ(xnn_create_runtime(subgraph, &rt), xnn_status_success);
+  ASSERT_EQ(executor.initialize(rt, {0}, {1}), Error::Ok);
+
+  TensorFactory<executorch::aten::ScalarType::Float> tf;
+  BackendExecutionContext context;
+  auto run = [&](executorch::aten::Tensor input,
+                 executorch::aten::Tensor output) {
+    EValue input_ev(input);
+    EValue output_ev(output);
+    std::array<EValue*, 2> args = {&input_ev, &output_ev};
+    ASSERT_EQ(executor.prepare_args(args.data()), Error::Ok);
+    ASSERT_EQ(executor.forward(context), Error::Ok);
+    ASSERT_EQ(executor.resize_outputs(args.data()), Error::Ok);
+  };
+
+  auto output = tf.zeros({2});
+  run(tf.make({2}, {-1.0f, 0.5f}), output);
+  EXPECT_EQ(output.const_data_ptr<float>()[1], 0.5f);
+  // Same shape: the runtime keeps its plan but sees the new data.
+  run(tf.make({2}, {2.0f, 0.25f}), output);
+  EXPECT_EQ(output.const_data_ptr<float>()[0], 1.0f);
+  EXPECT_EQ(output.const_data_ptr<float>()[1], 0.25f);
+
+  // A new shape reshapes the runtime and resizes the output.
+  auto larger_output = tf.zeros({3});
+  run(tf.make({3}, {0.5f, -2.0f, 0.75f}), larger_output);
+  EXPECT_EQ(larger_output.size(0), 3);
+  EXPECT_EQ(larger_output.const_data_ptr<float>()[2], 0.75f);
+}
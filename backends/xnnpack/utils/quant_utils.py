@@ -145,6 +145,32 @@ def is_per_channel_group(node: torch.fx.Node):
     return False
 
 
+def is_dynamic_linear_input_quant(node: torch.fx.Node) -> bool:
+    """
+    Whether node dynamically quantizes, per token, an input that is only
+    dequantized into linear nodes. Those are serialized as XNNDynamicFullyConnected,
+    which quantize their float input themselves, so node needs no convert.
+    """
+    if not (is_quant(node) and is_dynamic_qdq(node) and is_per_token(node)):
+        return False
+    if len(node.users) == 0:
+        return False
+    for dq_node in node.users:
+        if not (is_dequant(dq_node) and is_per_token(dq_node)):
+            return False
+        if len(dq_node.users) == 0:
+            return False
+        for user in dq_node.users:
+            if (
+                user.op != "call_function"
+                or format_target_name(user.target.__name__)  # pyre-ignore
+                != "linear.default"
+                or user.args[0] is not dq_node
+            ):
+                return False
+    return True
+
+
 def extract_qdq_affine_op_args_for_decomposed_ops(node: torch.fx.Node):
     if not is_affine_qdq(node):
         return None, None
@@ -11,6 +11,9 @@ from typing import Dict, final, List
 import torch
 
 from executorch.backends.xnnpack._passes import XNNPACKPassManager
+from executorch.backends.xnnpack._passes.channels_last_tagged_reshape_pass import (
+    ChannelsLastTaggedReshapePass,
+)
 from executorch.backends.xnnpack._passes.convert_to_linear import ConvertToLinearPass
 from executorch.backends.xnnpack._passes.tag_implicit_q_dq_pass import (
     TagImplicitQDqPass,
@@ -80,6 +83,22 @@ def generate_node_to_external_map(
     return node_to_external_map
 
 
+def get_channels_last_external_ids(
+    node_to_external_map: Dict[torch.fx.Node, ExternalMeta],
+) -> List[int]:
+    """
+    The external ids of the inputs and outputs that pass between delegates in
+    NHWC format, whose NCHW tensors the runtime reshapes and resizes with
+    permuted dims.
+    """
+    return sorted(
+        meta.external_id
+        for node, meta in node_to_external_map.items()
+        if node.meta.get(ChannelsLastTaggedReshapePass.XNN_NHWC_BOUNDARY, False)
+        and node.meta.get(ChannelsLastTaggedReshapePass.XNN_NHWC_NODE, False)
+    )
+
+
 def assert_default_dim_order(edge_graph_module: torch.fx.GraphModule) -> None:
     for node in edge_graph_module.graph.nodes:
         if node.op != "placeholder":
@@ -159,6 +178,7 @@ class XnnpackBackend(BackendDetails):
             input_ids=[],
             output_ids=[],
             constant_data=[ConstantDataOffset(0, 0)],
+            channels_last_ids=get_channels_last_external_ids(node_to_external_map),
         )
 
         constant_data_bytes = bytearray()
@@ -8,9 +8,13 @@
 # both AOT and runtime.
 
 # Selective build. See codegen/tools/gen_oplist.py for how to use these
-# arguments.
+# arguments. OPS_FROM_MODEL is the path of a .pte file whose operators and
+# dtypes are selected. With SELECTION_HEADERS, also generates the headers
+# that target_selective_build() compiles kernel libraries against.
 function(gen_selected_ops)
-  set(arg_names LIB_NAME OPS_SCHEMA_YAML ROOT_OPS INCLUDE_ALL_OPS)
+  set(arg_names LIB_NAME OPS_SCHEMA_YAML ROOT_OPS INCLUDE_ALL_OPS
+                OPS_FROM_MODEL SELECTION_HEADERS
+  )
   cmake_parse_arguments(GEN "" "" "${arg_names}" ${ARGN})
 
   message(STATUS "Generating operator lib:")
@@ -18,6 +22,8 @@ function(gen_selected_ops)
   message(STATUS "  OPS_SCHEMA_YAML: ${GEN_OPS_SCHEMA_YAML}")
   message(STATUS "  ROOT_OPS: ${GEN_ROOT_OPS}")
   message(STATUS "  INCLUDE_ALL_OPS: ${GEN_INCLUDE_ALL_OPS}")
+  message(STATUS "  OPS_FROM_MODEL: ${GEN_OPS_FROM_MODEL}")
+  message(STATUS "  SELECTION_HEADERS: ${GEN_SELECTION_HEADERS}")
 
   set(_oplist_yaml
       ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME}/selected_operators.yaml
@@ -41,16 +47,80 @@ function(gen_selected_ops)
   if(GEN_INCLUDE_ALL_OPS)
     list(APPEND _gen_oplist_command --include_all_operators)
   endif()
+  if(GEN_OPS_FROM_MODEL)
+    list(APPEND _gen_oplist_command --model_file_path="${GEN_OPS_FROM_MODEL}")
+  endif()
 
   message("Command - ${_gen_oplist_command}")
   add_custom_command(
     COMMENT "Generating selected_operators.yaml for ${GEN_LIB_NAME}"
     OUTPUT ${_oplist_yaml}
     COMMAND ${_gen_oplist_command}
-    DEPENDS ${GEN_OPS_SCHEMA_YAML} ${_codegen_tools_srcs}
+    DEPENDS ${GEN_OPS_SCHEMA_YAML} ${GEN_OPS_FROM_MODEL} ${_codegen_tools_srcs}
     WORKING_DIRECTORY ${EXECUTORCH_ROOT}
   )
 
+  if(GEN_SELECTION_HEADERS)
+    set(_selective_build_dir
+        ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME}/selective_build
+    )
+    set(_dtype_header_dir ${_selective_build_dir}/executorch/kernels/portable/cpu)
+    set(_ops_header_dir ${_selective_build_dir}/executorch/extension/kernel_util)
+    file(MAKE_DIRECTORY ${_dtype_header_dir} ${_ops_header_dir})
+    add_custom_command(
+      COMMENT "Generating selected_op_variants.h for ${GEN_LIB_NAME}"
+      OUTPUT ${_dtype_header_dir}/selected_op_variants.h
+             ${_ops_header_dir}/selected_operators.h
+      COMMAND
+        "${PYTHON_EXECUTABLE}" -m codegen.tools.gen_selected_op_variants
+        --yaml_file_path=${_oplist_yaml} --output_dir=${_dtype_header_dir}
+      COMMAND
+        ${CMAKE_COMMAND} -E rename ${_dtype_header_dir}/selected_operators.h
+        ${_ops_header_dir}/selected_operators.h
+      DEPENDS ${_oplist_yaml} ${_codegen_tools_srcs}
+      WORKING_DIRECTORY ${EXECUTORCH_ROOT}
+    )
+    add_custom_target(
+      ${GEN_LIB_NAME}_selective_build_headers
+      DEPENDS ${_dtype_header_dir}/selected_op_variants.h
+              ${_ops_header_dir}/selected_operators.h
+    )
+  endif()
+
+endfunction()
+
+# Compiles the kernel library TARGET for the selection that
+# gen_selected_ops(LIB_NAME ... SELECTION_HEADERS ON) made: the kernels
+# registered with EXECUTORCH_LIBRARY are only registered if their operator was
+# selected and, with DTYPES, the ET_SWITCH macros of the kernels drop the cases
+# of the dtypes that were not selected for their operator.
+#
+# Invoked as target_selective_build( TARGET target LIB_NAME lib_name [DTYPES] )
+function(target_selective_build)
+  cmake_parse_arguments(GEN "DTYPES" "TARGET;LIB_NAME" "" ${ARGN})
+
+  set(_selective_build_dir
+      ${CMAKE_CURRENT_BINARY_DIR}/${GEN_LIB_NAME}/selective_build
+  )
+  add_dependencies(${GEN_TARGET} ${GEN_LIB_NAME}_selective_build_headers)
+  target_include_directories(
+    ${GEN_TARGET} BEFORE PRIVATE ${_selective_build_dir}
+  )
+  target_compile_definitions(
+    ${GEN_TARGET} PRIVATE EXECUTORCH_SELECTIVE_BUILD_OPS
+  )
+  if(GEN_DTYPES)
+    target_compile_definitions(
+      ${GEN_TARGET} PRIVATE EXECUTORCH_SELECTIVE_BUILD_DTYPE
+    )
+    # Most kernels do not include selective_build.h themselves, and it must be
+    # seen before the ET_SWITCH macros are defined for the dtype selection to
+    # apply to them.
+    target_compile_options(
+      ${GEN_TARGET}
+      PRIVATE "SHELL:-include executorch/kernels/portable/cpu/selective_build.h"
+    )
+  endif()
 endfunction()
 
 # Codegen for registering kernels. Kernels are defined in functions_yaml and
@@ -177,6 +247,11 @@ function(gen_operators_lib)
             ${_out_dir}/Functions.h ${_out_dir}/NativeFunctions.h
   )
   target_link_libraries(${GEN_LIB_NAME} PRIVATE ${GEN_DEPS})
+  if(EXECUTORCH_KERNEL_SECTION_REGISTRATION)
+    target_compile_definitions(
+      ${GEN_LIB_NAME} PRIVATE EXECUTORCH_KERNEL_SECTION_REGISTRATION
+    )
+  endif()
   if(GEN_KERNEL_LIBS)
     target_link_libraries(${GEN_LIB_NAME} PUBLIC ${GEN_KERNEL_LIBS})
   endif()
@@ -59,6 +59,9 @@ function(executorch_print_configuration_summary)
   message(STATUS "  EXECUTORCH_BUILD_EXTENSION_DATA_LOADER : "
                  "${EXECUTORCH_BUILD_EXTENSION_DATA_LOADER}"
   )
+  message(STATUS "  EXECUTORCH_BUILD_EXTENSION_FLAT_TENSOR : "
+                 "${EXECUTORCH_BUILD_EXTENSION_FLAT_TENSOR}"
+  )
   message(STATUS "  EXECUTORCH_BUILD_EXTENSION_MODULE      : "
                  "${EXECUTORCH_BUILD_EXTENSION_MODULE}"
   )
@@ -102,6 +105,9 @@ function(executorch_print_configuration_summary)
   message(STATUS "  EXECUTORCH_BUILD_KERNELS_QUANTIZED     : "
                  "${EXECUTORCH_BUILD_KERNELS_QUANTIZED}"
   )
+  message(STATUS "  EXECUTORCH_BUILD_KERNELS_BENCHMARK     : "
+                 "${EXECUTORCH_BUILD_KERNELS_BENCHMARK}"
+  )
   message(
     STATUS "  EXECUTORCH_BUILD_DEVTOOLS              : ${EXECUTORCH_BUILD_DEVTOOLS}"
   )
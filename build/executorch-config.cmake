@@ -58,6 +58,7 @@ set(lib_list
     etdump
     bundled_program
     extension_data_loader
+    extension_flat_tensor
     ${FLATCCRT_LIB}
     coremldelegate
     mpsdelegate
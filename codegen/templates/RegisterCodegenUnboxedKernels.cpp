@@ -29,6 +29,13 @@ namespace executor {
 namespace function {
 namespace {
 
+#if defined(EXECUTORCH_KERNEL_SECTION_REGISTRATION)
+// Place the kernels in the executorch_kernels linker section, where the
+// registry reads them, so that nothing runs at static initialization time.
+ET_KERNEL_SECTION static constexpr Kernel kernels_to_register[] = {
+    ${unboxed_kernels} // Generated kernels
+};
+#else
 static Kernel kernels_to_register[] = {
     ${unboxed_kernels} // Generated kernels
 };
@@ -42,6 +49,7 @@ static KernelSpan kernel_span(
 // Return value not used. Keep the static variable assignment to register
 // kernels in static initialization time.
 static auto success_with_kernel_reg = register_kernels(kernel_span);
+#endif
 } // namespace
 } // namespace function
 } // namespace executor
@@ -78,13 +78,97 @@ class KernelType(IntEnum):
     OPTIONAL_TENSOR_LIST = 11
 
 
+def _has_selective_build_module() -> bool:
+    try:
+        import executorch.codegen.tools.selective_build  # noqa: F401
+    except ImportError:
+        return False
+    return True
+
+
+def _read_program(model_file: str):
+    """
+    Deserializes the model file with the Python serializer, for builds that
+    don't have the selective_build extension module.
+    """
+    from executorch.exir._serialize._program import deserialize_pte_binary
+
+    with open(model_file, "rb") as f:
+        return deserialize_pte_binary(f.read())
+
+
+def _operator_names(plan) -> List[str]:
+    return [
+        f"{op.name}.{op.overload}" if op.overload else op.name
+        for op in plan.operators
+    ]
+
+
+def _get_operators_from_program(model_file: str) -> List[str]:
+    program = _read_program(model_file)
+    return sorted(
+        {name for plan in program.execution_plan for name in _operator_names(plan)}
+    )
+
+
+def _get_kernel_metadata_from_program(model_file: str) -> Dict[str, List[str]]:
+    """
+    Returns the kernel keys of the kernel calls in the model file, in the same
+    format as _get_kernel_metadata_for_model().
+    """
+    from executorch.exir.schema import (
+        KernelCall,
+        OptionalTensorList,
+        Tensor,
+        TensorList,
+    )
+
+    def tensor_key(tensor: Tensor) -> str:
+        dim_order = ",".join(str(int(d)) for d in tensor.dim_order)
+        return f"{int(tensor.scalar_type)};{dim_order}"
+
+    program = _read_program(model_file)
+    op_kernel_key_list: Dict[str, List[str]] = {}
+    for plan in program.execution_plan:
+        names = _operator_names(plan)
+        for chain in plan.chains:
+            for instruction in chain.instructions:
+                call = instruction.instr_args
+                if not isinstance(call, KernelCall):
+                    continue
+                keys = []
+                for arg in call.args:
+                    val = plan.values[arg].val
+                    if isinstance(val, Tensor):
+                        keys.append(tensor_key(val))
+                    elif isinstance(val, (TensorList, OptionalTensorList)):
+                        # Lists are keyed on their first tensor.
+                        items = [
+                            plan.values[i].val
+                            for i in val.items
+                            if i >= 0 and isinstance(plan.values[i].val, Tensor)
+                        ]
+                        if items:
+                            keys.append(tensor_key(items[0]))
+                kernel_key = "v1/" + "|".join(keys)
+                op_keys = op_kernel_key_list.setdefault(names[call.op_index], [])
+                if kernel_key not in op_keys:
+                    op_keys.append(kernel_key)
+    return op_kernel_key_list
+
+
 def _get_operators(model_file: str) -> List[str]:
+    print("Processing model file: ", model_file)
+    if not _has_selective_build_module():
+        operators = _get_operators_from_program(model_file)
+        print(f"Model file loaded, operators are: {operators}")
+        return operators
+
     from executorch.codegen.tools.selective_build import (
         _get_program_from_buffer,
         _get_program_operators,
     )
 
-    print("Processing model file: ", model_file)
     with open(model_file, "rb") as f:
         buf = f.read()
 
@@ -95,6 +179,8 @@ def _get_operators(model_file: str) -> List[str]:
 
 
 def _get_kernel_metadata_for_model(model_file: str) -> Dict[str, List[str]]:
+    if not _has_selective_build_module():
+        return _get_kernel_metadata_from_program(model_file)
 
     from executorch.codegen.tools.selective_build import (
         _get_io_metadata_for_program_operators,
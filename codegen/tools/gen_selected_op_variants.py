@@ -34,6 +34,17 @@ inline constexpr bool should_include_kernel_dtype(
 """
 selected_kernel_dtypes_h_template = CodeTemplate(selected_kernel_dtypes_h_template_str)
 
+selected_operators_h_template_str = """#pragma once
+/**
+ * Generated by executorch/codegen/tools/gen_selected_op_variants.py
+ */
+
+inline constexpr bool should_include_operator(const char *operator_name) {
+  return $body;
+}
+"""
+selected_operators_h_template = CodeTemplate(selected_operators_h_template_str)
+
 # enum from: https://github.com/pytorch/executorch/blob/main/runtime/core/portable_type/scalar_type.h
 dtype_enum_to_type = {
     "0": "Byte",
@@ -62,6 +73,17 @@ dtype_enum_to_type = {
 }
 
 
+def _dtypes_used_for(dtype: str) -> List[str]:
+    """
+    Returns the dtypes that a kernel may switch on to handle tensors of
+    `dtype`. Portable kernels compute on Half and BFloat16 tensors in Float,
+    so Float must also be selected for them.
+    """
+    if dtype in ("Half", "BFloat16"):
+        return [dtype, "Float"]
+    return [dtype]
+
+
 def write_selected_op_variants(yaml_file_path: str, output_dir: str) -> None:
     with open(yaml_file_path, "r") as selected_operators_file:
         # Collect et_kernel_metadata from selected_operators.yaml and extract dtypes
@@ -75,6 +97,8 @@ def write_selected_op_variants(yaml_file_path: str, output_dir: str) -> None:
             tensor_meta = []
             for kernel_metadata in kernel_metadata_str:
                 if kernel_metadata == "default" or "/" not in kernel_metadata:
+                    # The default kernel handles every dtype.
+                    tensor_meta = []
                     break
                 else:
                     x = kernel_metadata.split("/")[1]
@@ -82,7 +106,13 @@ def write_selected_op_variants(yaml_file_path: str, output_dir: str) -> None:
             conditions = ["true"]
             if len(tensor_meta) > 0:
                 dtype_set = set([x.split(";")[0] for x in tensor_meta])
-                dtype_list = sorted([dtype_enum_to_type[x] for x in dtype_set])
+                dtype_list = sorted(
+                    {
+                        dtype
+                        for x in dtype_set
+                        for dtype in _dtypes_used_for(dtype_enum_to_type[x])
+                    }
+                )
                 conditions = [
                     "scalar_type == exec_aten::ScalarType::" + x for x in dtype_list
                 ]
@@ -99,6 +129,29 @@ def write_selected_op_variants(yaml_file_path: str, output_dir: str) -> None:
             out_file.write(header_contents.encode("utf-8"))
 
 
+def write_selected_operators(yaml_file_path: str, output_dir: str) -> None:
+    """
+    Writes selected_operators.h, which tells the kernel libraries that register
+    themselves with EXECUTORCH_LIBRARY which of their operators were selected.
+    """
+    with open(yaml_file_path, "r") as selected_operators_file:
+        selected_operators_dict = yaml.safe_load(selected_operators_file)
+    if selected_operators_dict.get("include_all_operators", False):
+        body = "true"
+    else:
+        operators = sorted(selected_operators_dict.get("operators", None) or {})
+        body = (
+            "\n || ".join(
+                f'(exec_aten::string_view(operator_name).compare("{op}") == 0)'
+                for op in operators
+            )
+            or "false"
+        )
+    header_contents = selected_operators_h_template.substitute(body=body)
+    with open(os.path.join(output_dir, "selected_operators.h"), "wb") as out_file:
+        out_file.write(header_contents.encode("utf-8"))
+
+
 def main(argv: List[Any]) -> None:
     parser = argparse.ArgumentParser(description="Generate operator lists")
     parser.add_argument(
@@ -111,14 +164,15 @@ def main(argv: List[Any]) -> None:
         "--output-dir",
         "--output_dir",
         help=(
-            "The directory to store the output yaml files (selected_op_variants.h, "
-            + "selected_kernel_dtypes.h, selected_operators.yaml)"
+            "The directory to store the output files (selected_op_variants.h, "
+            + "selected_operators.h)"
         ),
         required=True,
     )
 
     options = parser.parse_args(argv)
     write_selected_op_variants(options.yaml_file_path, options.output_dir)
+    write_selected_operators(options.yaml_file_path, options.output_dir)
 
 
 if __name__ == "__main__":
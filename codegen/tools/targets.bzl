@@ -16,7 +16,11 @@ def define_common_targets(is_fbcode = False):
             "//executorch/...",
         ],
         external_deps = ["torchgen"],
-        deps = select({
+        deps = [
+            # Reads model files where :selective_build is not available.
+            "//executorch/exir/_serialize:lib",
+            "//executorch/exir:schema",
+        ] + select({
             "DEFAULT": [],
             "ovr_config//os:linux": [] if runtime.is_oss else ["//executorch/codegen/tools/fb:selective_build"],  # TODO(larryliu0820) :selective_build doesn't build in OSS yet
         }),
@@ -70,6 +74,8 @@ def define_common_targets(is_fbcode = False):
         ],
         deps = [
             ":gen_oplist_lib",
+            "//executorch/exir:scalar_type",
+            "//executorch/exir:schema",
         ],
         package_style = "inplace",
         visibility = [
@@ -8,11 +8,23 @@ import json
 import os
 import tempfile
 import unittest
+from types import SimpleNamespace
 from typing import Dict, List
 from unittest.mock import NonCallableMock, patch
 
 import executorch.codegen.tools.gen_oplist as gen_oplist
 import yaml
+from executorch.exir.scalar_type import ScalarType
+from executorch.exir.schema import (
+    EValue,
+    Instruction,
+    Int,
+    KernelCall,
+    Operator,
+    Tensor,
+    TensorList,
+    TensorShapeDynamism,
+)
 
 
 class TestGenOpList(unittest.TestCase):
@@ -253,6 +265,65 @@ class TestGenOpList(unittest.TestCase):
             "default",
         )
 
+    @patch("executorch.codegen.tools.gen_oplist._read_program")
+    def test_get_kernel_metadata_from_program(
+        self, mock_read_program: NonCallableMock
+    ) -> None:
+        def tensor(dtype: ScalarType, dim_order: List[int]) -> EValue:
+            return EValue(
+                Tensor(
+                    scalar_type=dtype,
+                    storage_offset=0,
+                    sizes=[1] * len(dim_order),
+                    dim_order=dim_order,
+                    requires_grad=False,
+                    layout=0,
+                    data_buffer_idx=0,
+                    allocation_info=None,
+                    shape_dynamism=TensorShapeDynamism.STATIC,
+                )
+            )
+
+        values = [
+            tensor(ScalarType.FLOAT, [0, 1, 2, 3]),
+            tensor(ScalarType.FLOAT, [0, 2, 3, 1]),
+            EValue(Int(1)),
+            tensor(ScalarType.INT, [0]),
+            EValue(TensorList([0, 1])),
+        ]
+        calls = [
+            # add.out on a contiguous and a channels last tensor, twice.
+            KernelCall(op_index=0, args=[0, 1, 2, 0]),
+            KernelCall(op_index=0, args=[0, 1, 2, 0]),
+            KernelCall(op_index=0, args=[3, 3, 2, 3]),
+            KernelCall(op_index=1, args=[4, 2, 0]),
+        ]
+        plan = SimpleNamespace(
+            operators=[Operator("aten::add", "out"), Operator("aten::cat", "out")],
+            values=values,
+            chains=[
+                SimpleNamespace(
+                    instructions=[Instruction(instr_args=c) for c in calls]
+                )
+            ],
+        )
+        mock_read_program.return_value = SimpleNamespace(execution_plan=[plan])
+
+        self.assertListEqual(
+            gen_oplist._get_operators_from_program("model.pte"),
+            ["aten::add.out", "aten::cat.out"],
+        )
+        self.assertDictEqual(
+            gen_oplist._get_kernel_metadata_from_program("model.pte"),
+            {
+                "aten::add.out": [
+                    "v1/6;0,1,2,3|6;0,2,3,1|6;0,1,2,3",
+                    "v1/3;0|3;0|3;0",
+                ],
+                "aten::cat.out": ["v1/6;0,1,2,3|6;0,1,2,3"],
+            },
+        )
+
     def tearDown(self):
         self.temp_dir.cleanup()
 
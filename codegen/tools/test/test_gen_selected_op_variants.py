@@ -46,6 +46,11 @@ et_kernel_metadata:
       - v1/6;0,1|6;0,1|6;0,1|6;0,1  # Float, 0, 1
   aten::sub.out:
       - default
+  aten::div.out:
+      - v1/6;0,1|6;0,1|6;0,1  # Float, 0, 1
+      - default
+  aten::sigmoid.out:
+      - v1/5;0,1|5;0,1  # Half, 0, 1
 build_features: []
 custom_classes: []
             """
@@ -78,7 +83,33 @@ inline constexpr bool should_include_kernel_dtype(
  || ((exec_aten::string_view(operator_name).compare("mul.out") == 0)
         && (scalar_type == exec_aten::ScalarType::Float))
  || ((exec_aten::string_view(operator_name).compare("sub.out") == 0)
-        && (true));
+        && (true))
+ || ((exec_aten::string_view(operator_name).compare("div.out") == 0)
+        && (true))
+ || ((exec_aten::string_view(operator_name).compare("sigmoid.out") == 0)
+        && (scalar_type == exec_aten::ScalarType::Float || scalar_type == exec_aten::ScalarType::Half));
+}
+""",
+            )
+
+    def test_generates_operators_header(self) -> None:
+        gen_selected_op_variants.write_selected_operators(
+            os.path.join(self.temp_dir.name, "selected_operators.yaml"),
+            self.temp_dir.name,
+        )
+        with open(
+            os.path.join(self.temp_dir.name, "selected_operators.h"), "r"
+        ) as result:
+            self.assertExpectedInline(
+                result.read(),
+                """#pragma once
+/**
+ * Generated by executorch/codegen/tools/gen_selected_op_variants.py
+ */
+
+inline constexpr bool should_include_operator(const char *operator_name) {
+  return (exec_aten::string_view(operator_name).compare("aten::add") == 0)
+ || (exec_aten::string_view(operator_name).compare("aten::add.int") == 0);
 }
 """,
             )
@@ -8,7 +8,10 @@
 
 #include <executorch/devtools/etdump/etdump_flatcc.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <limits>
 
 #include <executorch/devtools/etdump/emitter.h>
 #include <executorch/devtools/etdump/etdump_schema_flatcc_builder.h>
@@ -23,8 +26,10 @@ using ::exec_aten::Tensor;
 using ::executorch::runtime::AllocatorID;
 using ::executorch::runtime::ArrayRef;
 using ::executorch::runtime::ChainID;
+using ::executorch::runtime::CounterSource;
 using ::executorch::runtime::DebugHandle;
 using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::Error;
 using ::executorch::runtime::EValue;
 using ::executorch::runtime::EventTracerEntry;
 using ::executorch::runtime::LoggedEValueType;
@@ -67,10 +72,62 @@ executorch_flatbuffer_ScalarType_enum_t get_flatbuffer_scalar_type(
   }
 }
 
+// Compute the statistics of every `stride`-th element of `tensor`. NaNs are
+// only counted, and the min, max and mean are 0 if all the elements are NaN.
+etdump_TensorStats_ref_t add_tensor_stats(
+    flatcc_builder_t* builder_,
+    const exec_aten::Tensor& tensor,
+    size_t stride) {
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+  double sum = 0;
+  size_t count = 0;
+  uint64_t nan_count = 0;
+  auto accumulate = [&](double value) {
+    if (std::isnan(value)) {
+      nan_count++;
+      return;
+    }
+    min = std::min(min, value);
+    max = std::max(max, value);
+    sum += value;
+    count++;
+  };
+  const size_t numel = static_cast<size_t>(tensor.numel());
+  if (tensor.scalar_type() == exec_aten::ScalarType::UInt16 ||
+      tensor.scalar_type() == exec_aten::ScalarType::Bits16) {
+    const uint16_t* data =
+        static_cast<const uint16_t*>(tensor.const_data_ptr());
+    for (size_t i = 0; i < numel; i += stride) {
+      accumulate(static_cast<double>(data[i]));
+    }
+  } else {
+    ET_SWITCH_REALHB_TYPES(
+        tensor.scalar_type(), nullptr, "add_tensor_stats", CTYPE, [&]() {
+          const CTYPE* data = tensor.const_data_ptr<CTYPE>();
+          for (size_t i = 0; i < numel; i += stride) {
+            accumulate(static_cast<double>(data[i]));
+          }
+        });
+  }
+  if (count == 0) {
+    return etdump_TensorStats_create(builder_, 0, 0, 0, nan_count);
+  }
+  return etdump_TensorStats_create(
+      builder_, min, max, sum / static_cast<double>(count), nan_count);
+}
+
+// Add a Tensor table for `tensor`, whose data is at `offset` in the debug
+// buffer. If `statistics_stride` is not 0, the statistics of the tensor are
+// added as well.
 etdump_Tensor_ref_t add_tensor_entry(
     flatcc_builder_t* builder_,
     const exec_aten::Tensor& tensor,
-    long offset) {
+    long offset,
+    size_t statistics_stride) {
+  etdump_TensorStats_ref_t stats_ref = statistics_stride != 0
+      ? add_tensor_stats(builder_, tensor, statistics_stride)
+      : 0;
   etdump_Tensor_start(builder_);
 
   etdump_Tensor_scalar_type_add(
@@ -90,6 +147,9 @@ etdump_Tensor_ref_t add_tensor_entry(
   }
   etdump_Tensor_strides_end(builder_);
   etdump_Tensor_offset_add(builder_, offset);
+  if (stats_ref != 0) {
+    etdump_Tensor_stats_add(builder_, stats_ref);
+  }
 
   return etdump_Tensor_end(builder_);
 }
@@ -143,6 +203,7 @@ ETDumpGen::~ETDumpGen() {
 void ETDumpGen::reset() {
   state_ = State::Init;
   num_blocks_ = 0;
+  num_counter_snapshots_ = 0;
   flatcc_builder_reset(builder_);
   flatbuffers_buffer_start(builder_, etdump_ETDump_file_identifier);
   etdump_ETDump_start_as_root_with_size(builder_);
@@ -166,9 +227,69 @@ void ETDumpGen::create_event_block(const char* name) {
   if (bundled_input_index_ != -1) {
     etdump_RunData_bundled_input_index_add(builder_, bundled_input_index_);
   }
+  if (counter_source_ != nullptr) {
+    etdump_RunData_counter_names_start(builder_);
+    for (size_t i = 0; i < num_counters_; ++i) {
+      etdump_RunData_counter_names_push_create_str(
+          builder_, counter_source_->counter_name(i));
+    }
+    etdump_RunData_counter_names_end(builder_);
+  }
   state_ = State::BlockCreated;
 }
 
+Error ETDumpGen::set_counter_source(CounterSource* counter_source) {
+  if (counter_source != nullptr &&
+      counter_source->num_counters() > CounterSource::kMaxCounters) {
+    ET_LOG(
+        Error,
+        "Counter source has %zu counters, more than the maximum of %zu",
+        counter_source->num_counters(),
+        CounterSource::kMaxCounters);
+    return Error::InvalidArgument;
+  }
+  counter_source_ = counter_source;
+  num_counters_ =
+      counter_source != nullptr ? counter_source->num_counters() : 0;
+  num_counter_snapshots_ = 0;
+  return Error::Ok;
+}
+
+void ETDumpGen::start_counters(const EventTracerEntry& entry) {
+  if (counter_source_ == nullptr ||
+      num_counter_snapshots_ == kMaxCounterSnapshots) {
+    return;
+  }
+  CounterSnapshot& snapshot = counter_snapshots_[num_counter_snapshots_++];
+  snapshot.event_id = entry.event_id;
+  snapshot.start_time = entry.start_time;
+  counter_source_->read_counters(snapshot.values);
+}
+
+size_t ETDumpGen::end_counters(
+    const EventTracerEntry& entry,
+    uint64_t* counter_deltas) {
+  if (counter_source_ == nullptr) {
+    return 0;
+  }
+  uint64_t values[CounterSource::kMaxCounters];
+  counter_source_->read_counters(values);
+  for (size_t i = num_counter_snapshots_; i > 0; --i) {
+    const CounterSnapshot& snapshot = counter_snapshots_[i - 1];
+    if (snapshot.event_id == entry.event_id &&
+        snapshot.start_time == entry.start_time) {
+      // Also drop the snapshots of the events nested in this one that were
+      // never ended.
+      num_counter_snapshots_ = i - 1;
+      for (size_t j = 0; j < num_counters_; ++j) {
+        counter_deltas[j] = values[j] - snapshot.values[j];
+      }
+      return num_counters_;
+    }
+  }
+  return 0;
+}
+
 int64_t ETDumpGen::create_string_entry(const char* name) {
   return flatbuffers_string_create_str(builder_, name);
 }
@@ -215,6 +336,7 @@ EventTracerEntry ETDumpGen::start_profiling(
     prof_entry.debug_handle = debug_handle;
   }
   prof_entry.start_time = et_pal_current_ticks();
+  start_counters(prof_entry);
   return prof_entry;
 }
 
@@ -237,6 +359,7 @@ EventTracerEntry ETDumpGen::start_profiling_delegate(
       ? create_string_entry(name)
       : delegate_debug_index;
   prof_entry.start_time = et_pal_current_ticks();
+  start_counters(prof_entry);
   return prof_entry;
 }
 
@@ -245,6 +368,8 @@ void ETDumpGen::end_profiling_delegate(
     const void* metadata,
     size_t metadata_len) {
   et_timestamp_t end_time = et_pal_current_ticks();
+  uint64_t counter_deltas[CounterSource::kMaxCounters];
+  size_t num_counter_deltas = end_counters(event_tracer_entry, counter_deltas);
   check_ready_to_add_events();
 
   // Start building the ProfileEvent entry.
@@ -253,6 +378,7 @@ void ETDumpGen::end_profiling_delegate(
   etdump_ProfileEvent_end_time_add(builder_, end_time);
   etdump_ProfileEvent_chain_index_add(builder_, chain_id_);
   etdump_ProfileEvent_instruction_id_add(builder_, debug_handle_);
+  etdump_ProfileEvent_thread_id_add(builder_, thread_id_);
   // Delegate debug identifier can either be of a string type or an integer
   // type. If it's a string type then it's a value of type
   // flatbuffers_string_ref_t type, whereas if it's an integer type then we
@@ -267,6 +393,10 @@ void ETDumpGen::end_profiling_delegate(
   flatbuffers_uint8_vec_ref_t vec_ref = flatbuffers_uint8_vec_create_pe(
       builder_, (const uint8_t*)metadata, metadata_len);
   etdump_ProfileEvent_delegate_debug_metadata_add(builder_, vec_ref);
+  if (num_counter_deltas > 0) {
+    etdump_ProfileEvent_counter_deltas_create(
+        builder_, counter_deltas, num_counter_deltas);
+  }
   etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder_);
   etdump_RunData_events_push_start(builder_);
   etdump_Event_profile_event_add(builder_, id);
@@ -290,6 +420,7 @@ void ETDumpGen::log_profiling_delegate(
   etdump_ProfileEvent_end_time_add(builder_, end_time);
   etdump_ProfileEvent_chain_index_add(builder_, chain_id_);
   etdump_ProfileEvent_instruction_id_add(builder_, debug_handle_);
+  etdump_ProfileEvent_thread_id_add(builder_, thread_id_);
   if (string_id == -1) {
     etdump_ProfileEvent_delegate_debug_id_int_add(
         builder_, delegate_debug_index);
@@ -348,7 +479,10 @@ void ETDumpGen::log_intermediate_output_delegate_helper(
   ET_CHECK_MSG(
       (name == nullptr) ^ (delegate_debug_index == -1),
       "Only name or delegate_debug_index can be valid. Check DelegateMappingBuilder documentation for more details.");
-  if (debug_buffer_.empty()) {
+  if (!should_log_intermediate_output(/*is_delegate_output=*/true, name)) {
+    return;
+  }
+  if (debug_buffer_.empty() && statistics_stride_ == 0) {
     ET_CHECK_MSG(0, "Must pre-set debug buffer with set_debug_buffer()\n");
     return;
   }
@@ -368,8 +502,9 @@ void ETDumpGen::log_intermediate_output_delegate_helper(
 
   // Check the type of `output` then call the corresponding logging functions
   if constexpr (std::is_same<T, Tensor>::value) {
-    long offset = copy_tensor_to_debug_buffer(output);
-    etdump_Tensor_ref_t tensor_ref = add_tensor_entry(builder_, output, offset);
+    long offset = log_tensor_data(output);
+    etdump_Tensor_ref_t tensor_ref =
+        add_tensor_entry(builder_, output, offset, statistics_stride_);
 
     etdump_Value_start(builder_);
     etdump_Value_val_add(builder_, etdump_ValueType_Tensor);
@@ -378,9 +513,10 @@ void ETDumpGen::log_intermediate_output_delegate_helper(
   } else if constexpr (std::is_same<T, ArrayRef<Tensor>>::value) {
     etdump_Tensor_vec_start(builder_);
     for (size_t i = 0; i < output.size(); ++i) {
-      long offset = copy_tensor_to_debug_buffer(output[i]);
+      long offset = log_tensor_data(output[i]);
       etdump_Tensor_vec_push(
-          builder_, add_tensor_entry(builder_, output[i], offset));
+          builder_,
+          add_tensor_entry(builder_, output[i], offset, statistics_stride_));
     }
     etdump_Tensor_vec_ref_t tensor_vec_ref = etdump_Tensor_vec_end(builder_);
     etdump_TensorList_ref_t tensor_list_ref =
@@ -428,15 +564,48 @@ void ETDumpGen::end_profiling(EventTracerEntry prof_entry) {
   ET_CHECK_MSG(
       prof_entry.delegate_event_id_type == DelegateDebugIdType::kNone,
       "Delegate events must use end_profiling_delegate to mark the end of a delegate profiling event.");
+  uint64_t counter_deltas[CounterSource::kMaxCounters];
+  size_t num_counter_deltas = end_counters(prof_entry, counter_deltas);
+  add_profile_event(
+      prof_entry.event_id,
+      prof_entry.chain_id,
+      prof_entry.debug_handle,
+      prof_entry.start_time,
+      end_time,
+      {counter_deltas, num_counter_deltas});
+}
+
+void ETDumpGen::log_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time) {
+  int64_t name_id = name != nullptr ? create_string_entry(name) : -1;
+  add_profile_event(name_id, chain_id, debug_handle, start_time, end_time);
+}
+
+void ETDumpGen::add_profile_event(
+    int64_t name_id,
+    ChainID chain_id,
+    DebugHandle debug_handle,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    Span<const uint64_t> counter_deltas) {
   check_ready_to_add_events();
 
   etdump_ProfileEvent_start(builder_);
-  etdump_ProfileEvent_start_time_add(builder_, prof_entry.start_time);
+  etdump_ProfileEvent_start_time_add(builder_, start_time);
   etdump_ProfileEvent_end_time_add(builder_, end_time);
-  etdump_ProfileEvent_chain_index_add(builder_, prof_entry.chain_id);
-  etdump_ProfileEvent_instruction_id_add(builder_, prof_entry.debug_handle);
-  if (prof_entry.event_id != -1) {
-    etdump_ProfileEvent_name_add(builder_, prof_entry.event_id);
+  etdump_ProfileEvent_chain_index_add(builder_, chain_id);
+  etdump_ProfileEvent_instruction_id_add(builder_, debug_handle);
+  etdump_ProfileEvent_thread_id_add(builder_, thread_id_);
+  if (name_id != -1) {
+    etdump_ProfileEvent_name_add(builder_, name_id);
+  }
+  if (counter_deltas.size() > 0) {
+    etdump_ProfileEvent_counter_deltas_create(
+        builder_, counter_deltas.data(), counter_deltas.size());
   }
   etdump_ProfileEvent_ref_t id = etdump_ProfileEvent_end(builder_);
   etdump_RunData_events_push_start(builder_);
@@ -463,7 +632,13 @@ void ETDumpGen::track_allocation(
   check_ready_to_add_events();
 
   etdump_RunData_events_push_start(builder_);
-  etdump_Event_allocation_event_create(builder_, allocator_id, allocation_size);
+  etdump_Event_allocation_event_create(
+      builder_,
+      allocator_id,
+      allocation_size,
+      chain_id_,
+      debug_handle_,
+      et_pal_current_ticks());
   etdump_RunData_events_push_end(builder_);
 }
 
@@ -501,6 +676,40 @@ void ETDumpGen::set_debug_buffer(Span<uint8_t> buffer) {
   debug_buffer_ = buffer;
 }
 
+void ETDumpGen::set_tensor_logging_mode(
+    TensorLoggingMode mode,
+    size_t statistics_stride) {
+  statistics_stride_ = mode == TensorLoggingMode::kStatistics
+      ? std::max<size_t>(statistics_stride, 1)
+      : 0;
+}
+
+bool ETDumpGen::should_log_intermediate_output(
+    bool is_delegate_output,
+    const char* name) const {
+  const IntermediateOutputFilter& filter = intermediate_output_filter_;
+  if (debug_handle_ < filter.min_debug_handle ||
+      debug_handle_ > filter.max_debug_handle) {
+    return false;
+  }
+  if (!is_delegate_output) {
+    return filter.log_instruction_outputs;
+  }
+  if (!filter.log_delegate_outputs) {
+    return false;
+  }
+  const char* prefix = filter.delegate_output_name_prefix;
+  return prefix == nullptr ||
+      (name != nullptr && strncmp(name, prefix, strlen(prefix)) == 0);
+}
+
+long ETDumpGen::log_tensor_data(const exec_aten::Tensor& tensor) {
+  if (statistics_stride_ != 0) {
+    return -1;
+  }
+  return copy_tensor_to_debug_buffer(tensor);
+}
+
 size_t ETDumpGen::copy_tensor_to_debug_buffer(exec_aten::Tensor tensor) {
   if (tensor.nbytes() == 0) {
     return static_cast<size_t>(-1);
@@ -516,7 +725,12 @@ size_t ETDumpGen::copy_tensor_to_debug_buffer(exec_aten::Tensor tensor) {
 }
 
 void ETDumpGen::log_evalue(const EValue& evalue, LoggedEValueType evalue_type) {
-  if (debug_buffer_.empty()) {
+  if (debug_buffer_.empty() && statistics_stride_ == 0) {
+    return;
+  }
+  if (evalue_type == LoggedEValueType::kIntermediateOutput &&
+      !should_log_intermediate_output(
+          /*is_delegate_output=*/false, /*name=*/nullptr)) {
     return;
   }
 
@@ -530,9 +744,9 @@ void ETDumpGen::log_evalue(const EValue& evalue, LoggedEValueType evalue_type) {
   switch (evalue.tag) {
     case Tag::Tensor: {
       exec_aten::Tensor tensor = evalue.toTensor();
-      long offset = copy_tensor_to_debug_buffer(tensor);
+      long offset = log_tensor_data(tensor);
       etdump_Tensor_ref_t tensor_ref =
-          add_tensor_entry(builder_, tensor, offset);
+          add_tensor_entry(builder_, tensor, offset, statistics_stride_);
 
       etdump_Value_start(builder_);
       etdump_Value_val_add(builder_, etdump_ValueType_Tensor);
@@ -551,9 +765,10 @@ void ETDumpGen::log_evalue(const EValue& evalue, LoggedEValueType evalue_type) {
       exec_aten::ArrayRef<exec_aten::Tensor> tensors = evalue.toTensorList();
       etdump_Tensor_vec_start(builder_);
       for (size_t i = 0; i < tensors.size(); ++i) {
-        long offset = copy_tensor_to_debug_buffer(tensors[i]);
+        long offset = log_tensor_data(tensors[i]);
         etdump_Tensor_vec_push(
-            builder_, add_tensor_entry(builder_, tensors[i], offset));
+            builder_,
+            add_tensor_entry(builder_, tensors[i], offset, statistics_stride_));
       }
       etdump_Tensor_vec_ref_t tensor_vec_ref = etdump_Tensor_vec_end(builder_);
       etdump_TensorList_ref_t tensor_list_ref =
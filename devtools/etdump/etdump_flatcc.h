@@ -9,6 +9,7 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
 
 #include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/span.h>
@@ -60,6 +61,40 @@ struct ETDumpResult {
   size_t size;
 };
 
+/**
+ * How ETDumpGen logs the tensors of intermediate and program outputs.
+ */
+enum class TensorLoggingMode : uint8_t {
+  /// Copy the data of the tensors to the debug buffer.
+  kFullTensor,
+  /// Only record the min, max, mean and NaN count of the tensors in
+  /// Tensor.stats, without copying their data. Needs no debug buffer.
+  kStatistics,
+};
+
+/**
+ * Selects the intermediate outputs that ETDumpGen logs. Program outputs are
+ * always logged.
+ */
+struct IntermediateOutputFilter {
+  /// Only log the outputs of instructions whose debug handle, i.e. the
+  /// instruction id, is in [min_debug_handle, max_debug_handle].
+  ::executorch::runtime::DebugHandle min_debug_handle = 0;
+  ::executorch::runtime::DebugHandle max_debug_handle =
+      std::numeric_limits<::executorch::runtime::DebugHandle>::max();
+  /// Log the arguments of delegate calls that the Method logs with
+  /// log_evalue().
+  bool log_instruction_outputs = true;
+  /// Log the outputs that delegates log with
+  /// log_intermediate_output_delegate().
+  bool log_delegate_outputs = true;
+  /// If not null, only log the delegate outputs whose name, e.g. the name of
+  /// the operator that the delegate ran, starts with this prefix. Delegate
+  /// outputs that are identified by an index instead of a name are not
+  /// logged. Must outlive the filter.
+  const char* delegate_output_name_prefix = nullptr;
+};
+
 class ETDumpGen : public ::executorch::runtime::EventTracer {
  public:
   ETDumpGen(::executorch::runtime::Span<uint8_t> buffer = {nullptr, (size_t)0});
@@ -67,6 +102,15 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
   void clear_builder();
 
   void create_event_block(const char* name) override;
+  /**
+   * Record the deltas of the counters of counter_source in every profiling
+   * event that is started by start_profiling() or start_profiling_delegate(),
+   * and the names of the counters in every event block created after this
+   * call. Events logged with log_profiling() or log_profiling_delegate() have
+   * no counters.
+   */
+  ::executorch::runtime::Error set_counter_source(
+      ::executorch::runtime::CounterSource* counter_source) override;
   virtual ::executorch::runtime::EventTracerEntry start_profiling(
       const char* name,
       ::executorch::runtime::ChainID chain_id = -1,
@@ -87,6 +131,16 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
       et_timestamp_t end_time,
       const void* metadata,
       size_t metadata_len) override;
+  /**
+   * Log a profiling event that was timed outside of this class, e.g. one
+   * recorded by an ETDumpRingBuffer.
+   */
+  void log_profiling(
+      const char* name,
+      ::executorch::runtime::ChainID chain_id,
+      ::executorch::runtime::DebugHandle debug_handle,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time);
   virtual void track_allocation(
       ::executorch::runtime::AllocatorID id,
       size_t size) override;
@@ -136,7 +190,30 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
       const char* name,
       ::executorch::runtime::DebugHandle delegate_debug_index,
       const double& output) override;
+  /**
+   * Set the thread id that is recorded with the profiling events logged after
+   * this call, for when the events of several threads are logged through one
+   * ETDumpGen, e.g. by ETDumpRingBuffer. The thread id is 0 by default.
+   */
+  void set_thread_id(uint32_t thread_id) {
+    thread_id_ = thread_id;
+  }
   void set_debug_buffer(::executorch::runtime::Span<uint8_t> buffer);
+  /**
+   * Only log the intermediate outputs that pass `filter`, to keep numerical
+   * debugging runs of large models fast.
+   */
+  void set_intermediate_output_filter(const IntermediateOutputFilter& filter) {
+    intermediate_output_filter_ = filter;
+  }
+  /**
+   * Set how tensors are logged. With TensorLoggingMode::kStatistics, the
+   * statistics of each tensor are computed from every `statistics_stride`-th
+   * element, so that a stride larger than 1 trades accuracy for speed.
+   */
+  void set_tensor_logging_mode(
+      TensorLoggingMode mode,
+      size_t statistics_stride = 1);
   ETDumpResult get_etdump_data();
   size_t get_debug_buffer_size() const;
   size_t get_num_blocks();
@@ -153,8 +230,26 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
   };
 
   void check_ready_to_add_events();
+  void add_profile_event(
+      int64_t name_id,
+      ::executorch::runtime::ChainID chain_id,
+      ::executorch::runtime::DebugHandle debug_handle,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      ::executorch::runtime::Span<const uint64_t> counter_deltas = {});
+  void start_counters(const ::executorch::runtime::EventTracerEntry& entry);
+  size_t end_counters(
+      const ::executorch::runtime::EventTracerEntry& entry,
+      uint64_t* counter_deltas);
   int64_t create_string_entry(const char* name);
   size_t copy_tensor_to_debug_buffer(exec_aten::Tensor tensor);
+  bool should_log_intermediate_output(bool is_delegate_output, const char* name)
+      const;
+  /**
+   * Copy the data of `tensor` to the debug buffer unless only its statistics
+   * are logged, and return its offset in the debug buffer, or -1.
+   */
+  long log_tensor_data(const exec_aten::Tensor& tensor);
 
   /**
    * Templated helper function used to log various types of intermediate output.
@@ -170,9 +265,28 @@ class ETDumpGen : public ::executorch::runtime::EventTracer {
   size_t num_blocks_ = 0;
   ::executorch::runtime::Span<uint8_t> debug_buffer_;
   size_t debug_buffer_offset_ = 0;
+  IntermediateOutputFilter intermediate_output_filter_;
+  // The stride of the elements that the statistics of tensors are computed
+  // from, or 0 to copy the data of tensors instead.
+  size_t statistics_stride_ = 0;
   int bundled_input_index_ = -1;
+  uint32_t thread_id_ = 0;
   State state_ = State::Init;
   struct internal::ETDumpStaticAllocator alloc_;
+
+  // The counter values at the start of each profiling event that is in
+  // progress, innermost last. Events that start while this is full have no
+  // counters.
+  struct CounterSnapshot {
+    int64_t event_id;
+    et_timestamp_t start_time;
+    uint64_t values[::executorch::runtime::CounterSource::kMaxCounters];
+  };
+  static constexpr size_t kMaxCounterSnapshots = 16;
+  ::executorch::runtime::CounterSource* counter_source_ = nullptr;
+  size_t num_counters_ = 0;
+  CounterSnapshot counter_snapshots_[kMaxCounterSnapshots];
+  size_t num_counter_snapshots_ = 0;
 };
 
 } // namespace etdump
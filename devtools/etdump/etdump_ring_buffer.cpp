@@ -0,0 +1,475 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/etdump_ring_buffer.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/compiler.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/profiler.h>
+
+using ::exec_aten::Tensor;
+using ::executorch::runtime::AllocatorID;
+using ::executorch::runtime::ArrayRef;
+using ::executorch::runtime::ChainID;
+using ::executorch::runtime::DebugHandle;
+using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::EValue;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::kUnsetChainId;
+using ::executorch::runtime::kUnsetDebugHandle;
+using ::executorch::runtime::LoggedEValueType;
+using ::executorch::runtime::prof_event_t;
+using ::executorch::runtime::prof_header_t;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace etdump {
+
+namespace {
+
+// Name of the event block that holds the records logged before the first
+// event block that the ring buffer still holds.
+constexpr const char* kDefaultBlockName = "ETDumpRingBuffer";
+
+constexpr DebugHandle kNoDelegateDebugIndex = static_cast<DebugHandle>(-1);
+
+// Marks the sequence of a discarded record.
+constexpr uint64_t kDiscarded = uint64_t(1) << 63;
+
+// The last event block that the thread created, for discard_event_block().
+struct LastEventBlock {
+  const ETDumpRingBuffer* ring_buffer;
+  uint64_t index;
+};
+thread_local LastEventBlock last_event_block = {nullptr, 0};
+
+uint32_t current_thread_id() {
+  static std::atomic<uint32_t> next_thread_id{0};
+  thread_local uint32_t thread_id =
+      next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  return thread_id;
+}
+
+} // namespace
+
+// A record with the sequence number that guards it. Writers set the sequence
+// to 2 * index + 1 while they write the record with the given index and to
+// 2 * index + 2 once it is complete, and readers only keep a copy of a record
+// if its sequence was 2 * index + 2 before and after they copied it. Discarded
+// records have kDiscarded set in their sequence.
+struct ETDumpRingBuffer::Slot {
+  std::atomic<uint64_t> sequence;
+  RingBufferRecord record;
+};
+
+size_t ETDumpRingBuffer::buffer_size(size_t num_records) {
+  return num_records * sizeof(Slot) + alignof(Slot) - 1;
+}
+
+ETDumpRingBuffer::ETDumpRingBuffer(Span<uint8_t> buffer) {
+  uintptr_t begin = reinterpret_cast<uintptr_t>(buffer.data());
+  uintptr_t aligned = (begin + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+  size_t padding = aligned - begin;
+  capacity_ = buffer.size() > padding
+      ? (buffer.size() - padding) / sizeof(Slot)
+      : 0;
+  ET_CHECK_MSG(capacity_ > 0, "Buffer is too small to hold a record.");
+
+  slots_ = reinterpret_cast<Slot*>(aligned);
+  for (size_t i = 0; i < capacity_; ++i) {
+    new (&slots_[i]) Slot();
+    slots_[i].sequence.store(0, std::memory_order_relaxed);
+  }
+  for (size_t i = 0; i < kMaxNames; ++i) {
+    names_[i].ready.store(false, std::memory_order_relaxed);
+  }
+}
+
+uint16_t ETDumpRingBuffer::intern_name(const char* name) {
+  if (name == nullptr) {
+    return RingBufferRecord::kNoName;
+  }
+  size_t num_names =
+      std::min(num_names_.load(std::memory_order_acquire), kMaxNames);
+  for (size_t i = 0; i < num_names; ++i) {
+    if (names_[i].ready.load(std::memory_order_acquire) &&
+        strncmp(names_[i].name, name, kMaxNameLength - 1) == 0) {
+      return static_cast<uint16_t>(i);
+    }
+  }
+
+  // Two threads may add the same name concurrently, which only costs a slot.
+  size_t i = num_names_.fetch_add(1, std::memory_order_acq_rel);
+  if (i >= kMaxNames) {
+    return RingBufferRecord::kNoName;
+  }
+  strncpy(names_[i].name, name, kMaxNameLength - 1);
+  names_[i].name[kMaxNameLength - 1] = '\0';
+  names_[i].ready.store(true, std::memory_order_release);
+  return static_cast<uint16_t>(i);
+}
+
+const char* ETDumpRingBuffer::name(uint16_t name_index) const {
+  if (name_index >= kMaxNames ||
+      !names_[name_index].ready.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return names_[name_index].name;
+}
+
+uint64_t ETDumpRingBuffer::append(const RingBufferRecord& record) {
+  uint64_t index = next_record_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[index % capacity_];
+  slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.record = record;
+  slot.sequence.store(2 * index + 2, std::memory_order_release);
+  return index;
+}
+
+bool ETDumpRingBuffer::try_read(
+    uint64_t index,
+    RingBufferRecord* record,
+    bool* pending) const {
+  const Slot& slot = slots_[index % capacity_];
+  uint64_t before = slot.sequence.load(std::memory_order_acquire);
+  if (before != 2 * index + 2) {
+    // The record is either still being written, discarded or already
+    // overwritten.
+    *pending = (before & ~kDiscarded) < 2 * index + 2;
+    return false;
+  }
+  *record = slot.record;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  *pending = false;
+  return slot.sequence.load(std::memory_order_relaxed) == before;
+}
+
+size_t ETDumpRingBuffer::read_records(
+    uint64_t* cursor,
+    Span<RingBufferRecord> records) const {
+  uint64_t end = next_record_.load(std::memory_order_acquire);
+  uint64_t index = *cursor;
+  if (end > capacity_ && index < end - capacity_) {
+    index = end - capacity_;
+  }
+  size_t count = 0;
+  for (; index < end && count < records.size(); ++index) {
+    bool pending = false;
+    if (try_read(index, &records[count], &pending)) {
+      ++count;
+    } else if (pending) {
+      // Stop at the first record that is still being written, so that the
+      // next read picks it up.
+      break;
+    }
+  }
+  *cursor = index;
+  return count;
+}
+
+void ETDumpRingBuffer::write_etdump(ETDumpGen& etdump_gen, uint64_t* cursor)
+    const {
+  etdump_gen.reset();
+  bool block_created = false;
+  RingBufferRecord record;
+  while (read_records(cursor, Span<RingBufferRecord>(&record, 1)) == 1) {
+    const char* record_name = name(record.name_index);
+    if (record.kind == RingBufferRecordKind::kBlock) {
+      etdump_gen.create_event_block(
+          record_name != nullptr ? record_name : kDefaultBlockName);
+      block_created = true;
+      continue;
+    }
+    if (!block_created) {
+      etdump_gen.create_event_block(kDefaultBlockName);
+      block_created = true;
+    }
+    etdump_gen.set_thread_id(record.thread_id);
+    if (record.kind == RingBufferRecordKind::kProfile) {
+      etdump_gen.log_profiling(
+          record_name,
+          record.chain_id,
+          record.debug_handle,
+          record.start_time,
+          record.end_time);
+    } else {
+      // ETDump needs either a name or an index for a delegate event.
+      if (record_name == nullptr &&
+          record.delegate_debug_index == kNoDelegateDebugIndex) {
+        record_name = "";
+      }
+      etdump_gen.set_chain_debug_handle(record.chain_id, record.debug_handle);
+      etdump_gen.log_profiling_delegate(
+          record_name,
+          record_name != nullptr ? kNoDelegateDebugIndex
+                                 : record.delegate_debug_index,
+          record.start_time,
+          record.end_time,
+          nullptr,
+          0);
+    }
+  }
+  etdump_gen.set_chain_debug_handle(kUnsetChainId, kUnsetDebugHandle);
+  etdump_gen.set_thread_id(0);
+}
+
+ETDumpResult ETDumpRingBuffer::snapshot(ETDumpGen& etdump_gen) const {
+  uint64_t cursor = 0;
+  write_etdump(etdump_gen, &cursor);
+  return etdump_gen.get_etdump_data();
+}
+
+ETDumpResult ETDumpRingBuffer::flush(ETDumpGen& etdump_gen) {
+  uint64_t end = next_record_.load(std::memory_order_acquire);
+  if (end > capacity_ && flush_cursor_ < end - capacity_) {
+    uint64_t num_lost = end - capacity_ - flush_cursor_;
+    num_lost_records_ += num_lost;
+    ET_LOG(
+        Error,
+        "%" PRIu64
+        " records were overwritten before they were flushed. Flush more "
+        "often or use a larger buffer.",
+        num_lost);
+  }
+  write_etdump(etdump_gen, &flush_cursor_);
+  return etdump_gen.get_etdump_data();
+}
+
+size_t ETDumpRingBuffer::write_profile_results(Span<uint8_t> buffer) const {
+  size_t size = 0;
+  prof_header_t header;
+  size_t header_offset = 0;
+  bool block_created = false;
+  auto write = [&](size_t offset, const void* data, size_t data_size) {
+    if (offset + data_size <= buffer.size()) {
+      memcpy(buffer.data() + offset, data, data_size);
+    }
+  };
+  auto create_block = [&](const char* block_name) {
+    if (block_created) {
+      write(header_offset, &header, sizeof(header));
+    }
+    memset(&header, 0, sizeof(header));
+    strncpy(header.name, block_name, sizeof(header.name));
+    header.prof_ver = ET_PROF_VER;
+    header_offset = size;
+    size += sizeof(header);
+    block_created = true;
+  };
+
+  uint64_t cursor = 0;
+  RingBufferRecord record;
+  while (read_records(&cursor, Span<RingBufferRecord>(&record, 1)) == 1) {
+    const char* record_name = name(record.name_index);
+    if (record.kind == RingBufferRecordKind::kBlock) {
+      create_block(record_name != nullptr ? record_name : kDefaultBlockName);
+      continue;
+    }
+    if (!block_created) {
+      create_block(kDefaultBlockName);
+    }
+    prof_event_t event;
+    memset(&event, 0, sizeof(event));
+    if (record_name != nullptr) {
+      strncpy(event.name, record_name, sizeof(event.name));
+    } else if (record.kind == RingBufferRecordKind::kDelegate) {
+      snprintf(
+          event.name,
+          sizeof(event.name),
+          "%" PRIu32,
+          static_cast<uint32_t>(record.delegate_debug_index));
+    }
+    event.chain_idx = record.chain_id;
+    event.instruction_idx = record.debug_handle;
+    event.start_time = record.start_time;
+    event.end_time = record.end_time;
+    write(size, &event, sizeof(event));
+    size += sizeof(event);
+    header.max_prof_entries++;
+    header.prof_entries++;
+  }
+  if (block_created) {
+    write(header_offset, &header, sizeof(header));
+  }
+  return size;
+}
+
+void ETDumpRingBuffer::create_event_block(const char* name) {
+  RingBufferRecord record;
+  record.start_time = et_pal_current_ticks();
+  record.end_time = record.start_time;
+  record.chain_id = kUnsetChainId;
+  record.debug_handle = kUnsetDebugHandle;
+  record.delegate_debug_index = kNoDelegateDebugIndex;
+  record.thread_id = current_thread_id();
+  record.name_index = intern_name(name);
+  record.kind = RingBufferRecordKind::kBlock;
+  last_event_block = {this, append(record)};
+}
+
+Error ETDumpRingBuffer::discard_event_block() {
+  if (last_event_block.ring_buffer != this) {
+    return Error::NotSupported;
+  }
+  const uint32_t thread_id = current_thread_id();
+  uint64_t end = next_record_.load(std::memory_order_acquire);
+  uint64_t index = last_event_block.index;
+  if (end > capacity_ && index < end - capacity_) {
+    index = end - capacity_;
+  }
+  for (; index < end; ++index) {
+    Slot& slot = slots_[index % capacity_];
+    uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * index + 2 || slot.record.thread_id != thread_id) {
+      continue;
+    }
+    // Fails if the record was overwritten since it was checked.
+    slot.sequence.compare_exchange_strong(
+        sequence, sequence | kDiscarded, std::memory_order_acq_rel);
+  }
+  last_event_block.ring_buffer = nullptr;
+  return Error::Ok;
+}
+
+EventTracerEntry ETDumpRingBuffer::start_profiling(
+    const char* name,
+    ChainID chain_id,
+    DebugHandle debug_handle) {
+  EventTracerEntry prof_entry;
+  prof_entry.event_id = intern_name(name);
+  prof_entry.delegate_event_id_type = DelegateDebugIdType::kNone;
+  if (chain_id == kUnsetChainId) {
+    prof_entry.chain_id = chain_id_;
+    prof_entry.debug_handle = debug_handle_;
+  } else {
+    prof_entry.chain_id = chain_id;
+    prof_entry.debug_handle = debug_handle;
+  }
+  prof_entry.start_time = et_pal_current_ticks();
+  return prof_entry;
+}
+
+void ETDumpRingBuffer::end_profiling(EventTracerEntry prof_entry) {
+  RingBufferRecord record;
+  record.end_time = et_pal_current_ticks();
+  record.start_time = prof_entry.start_time;
+  record.chain_id = prof_entry.chain_id;
+  record.debug_handle = prof_entry.debug_handle;
+  record.delegate_debug_index = kNoDelegateDebugIndex;
+  record.thread_id = current_thread_id();
+  record.name_index = static_cast<uint16_t>(prof_entry.event_id);
+  record.kind = RingBufferRecordKind::kProfile;
+  append(record);
+}
+
+EventTracerEntry ETDumpRingBuffer::start_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index) {
+  EventTracerEntry prof_entry;
+  if (name != nullptr) {
+    prof_entry.delegate_event_id_type = DelegateDebugIdType::kStr;
+    prof_entry.event_id = intern_name(name);
+  } else {
+    prof_entry.delegate_event_id_type = DelegateDebugIdType::kInt;
+    prof_entry.event_id = delegate_debug_index;
+  }
+  prof_entry.chain_id = chain_id_;
+  prof_entry.debug_handle = debug_handle_;
+  prof_entry.start_time = et_pal_current_ticks();
+  return prof_entry;
+}
+
+void ETDumpRingBuffer::end_profiling_delegate(
+    EventTracerEntry prof_entry,
+    ET_UNUSED const void* metadata,
+    ET_UNUSED size_t metadata_len) {
+  RingBufferRecord record;
+  record.end_time = et_pal_current_ticks();
+  record.start_time = prof_entry.start_time;
+  record.chain_id = prof_entry.chain_id;
+  record.debug_handle = prof_entry.debug_handle;
+  if (prof_entry.delegate_event_id_type == DelegateDebugIdType::kStr) {
+    record.delegate_debug_index = kNoDelegateDebugIndex;
+    record.name_index = static_cast<uint16_t>(prof_entry.event_id);
+  } else {
+    record.delegate_debug_index = static_cast<DebugHandle>(prof_entry.event_id);
+    record.name_index = RingBufferRecord::kNoName;
+  }
+  record.thread_id = current_thread_id();
+  record.kind = RingBufferRecordKind::kDelegate;
+  append(record);
+}
+
+void ETDumpRingBuffer::log_profiling_delegate(
+    const char* name,
+    DebugHandle delegate_debug_index,
+    et_timestamp_t start_time,
+    et_timestamp_t end_time,
+    ET_UNUSED const void* metadata,
+    ET_UNUSED size_t metadata_len) {
+  RingBufferRecord record;
+  record.start_time = start_time;
+  record.end_time = end_time;
+  record.chain_id = chain_id_;
+  record.debug_handle = debug_handle_;
+  record.delegate_debug_index =
+      name != nullptr ? kNoDelegateDebugIndex : delegate_debug_index;
+  record.thread_id = current_thread_id();
+  record.name_index = intern_name(name);
+  record.kind = RingBufferRecordKind::kDelegate;
+  append(record);
+}
+
+void ETDumpRingBuffer::track_allocation(
+    ET_UNUSED AllocatorID id,
+    ET_UNUSED size_t size) {}
+
+AllocatorID ETDumpRingBuffer::track_allocator(ET_UNUSED const char* name) {
+  return 0;
+}
+
+void ETDumpRingBuffer::log_evalue(
+    ET_UNUSED const EValue& evalue,
+    ET_UNUSED LoggedEValueType evalue_type) {}
+
+void ETDumpRingBuffer::log_intermediate_output_delegate(
+    ET_UNUSED const char* name,
+    ET_UNUSED DebugHandle delegate_debug_index,
+    ET_UNUSED const Tensor& output) {}
+
+void ETDumpRingBuffer::log_intermediate_output_delegate(
+    ET_UNUSED const char* name,
+    ET_UNUSED DebugHandle delegate_debug_index,
+    ET_UNUSED const ArrayRef<Tensor> output) {}
+
+void ETDumpRingBuffer::log_intermediate_output_delegate(
+    ET_UNUSED const char* name,
+    ET_UNUSED DebugHandle delegate_debug_index,
+    ET_UNUSED const int& output) {}
+
+void ETDumpRingBuffer::log_intermediate_output_delegate(
+    ET_UNUSED const char* name,
+    ET_UNUSED DebugHandle delegate_debug_index,
+    ET_UNUSED const bool& output) {}
+
+void ETDumpRingBuffer::log_intermediate_output_delegate(
+    ET_UNUSED const char* name,
+    ET_UNUSED DebugHandle delegate_debug_index,
+    ET_UNUSED const double& output) {}
+
+} // namespace etdump
+} // namespace executorch
@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <executorch/devtools/etdump/etdump_flatcc.h>
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/platform.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * The kind of event that a RingBufferRecord describes.
+ */
+enum class RingBufferRecordKind : uint8_t {
+  /// A profiling event started with start_profiling().
+  kProfile,
+  /// A delegate profiling event, whose delegate_debug_index is valid if the
+  /// record has no name.
+  kDelegate,
+  /// The start of an event block, created with create_event_block().
+  kBlock,
+};
+
+/**
+ * A single event in an ETDumpRingBuffer. Records are plain data so that
+ * appending one is a handful of stores.
+ */
+struct RingBufferRecord {
+  et_timestamp_t start_time;
+  et_timestamp_t end_time;
+  ::executorch::runtime::ChainID chain_id;
+  ::executorch::runtime::DebugHandle debug_handle;
+  ::executorch::runtime::DebugHandle delegate_debug_index;
+  /// Small integer that identifies the thread that logged the event.
+  uint32_t thread_id;
+  /// Index of the name of the event in the name table of the ring buffer, or
+  /// kNoName.
+  uint16_t name_index;
+  RingBufferRecordKind kind;
+
+  static constexpr uint16_t kNoName = UINT16_MAX;
+};
+
+/**
+ * An EventTracer for always-on profiling, that appends fixed size records of
+ * the profiling events to a ring buffer instead of building an ETDump as it
+ * goes like ETDumpGen. Once the ring buffer is full, new records overwrite the
+ * oldest ones.
+ *
+ * Appending a record is wait-free, so multiple threads may log events
+ * concurrently. Copying the records out with read_records(), snapshot() or
+ * flush() runs concurrently with the writers, and skips records that were
+ * overwritten while it ran. Only one thread at a time may read the records.
+ *
+ * Event names are copied into a small table of kMaxNames names of at most
+ * kMaxNameLength - 1 characters the first time that they are logged. Names
+ * that do not fit are truncated, and events logged once the table is full
+ * have no name. Delegate metadata, allocations and logged values are not
+ * recorded. The ETDumps that snapshot() and flush() return record the thread
+ * that logged each event in ProfileEvent.thread_id.
+ *
+ * To collect the events of the profiling macros in runtime/platform/profiler.h
+ * as well, pass the ring buffer to set_profiling_event_tracer(), and use
+ * write_profile_results() to export the records for tools that read the
+ * results of the profiling macros, like profiler/parse_profiler_results.py.
+ */
+class ETDumpRingBuffer final : public ::executorch::runtime::EventTracer {
+ public:
+  static constexpr size_t kMaxNames = 64;
+  static constexpr size_t kMaxNameLength = 32;
+
+  /**
+   * Returns the size of a buffer that holds `num_records` records.
+   */
+  static size_t buffer_size(size_t num_records);
+
+  /**
+   * @param[in] buffer The memory to store the records in, which must outlive
+   *     this object. Use buffer_size() to size it.
+   */
+  explicit ETDumpRingBuffer(::executorch::runtime::Span<uint8_t> buffer);
+
+  ETDumpRingBuffer(const ETDumpRingBuffer&) = delete;
+  ETDumpRingBuffer& operator=(const ETDumpRingBuffer&) = delete;
+
+  void create_event_block(const char* name) override;
+  /**
+   * Drops the records that the calling thread appended since its last call
+   * to create_event_block() on this object. Records that flush() already
+   * returned stay in its ETDump.
+   */
+  ::executorch::runtime::Error discard_event_block() override;
+  ::executorch::runtime::EventTracerEntry start_profiling(
+      const char* name,
+      ::executorch::runtime::ChainID chain_id =
+          ::executorch::runtime::kUnsetChainId,
+      ::executorch::runtime::DebugHandle debug_handle =
+          ::executorch::runtime::kUnsetDebugHandle) override;
+  void end_profiling(::executorch::runtime::EventTracerEntry prof_entry)
+      override;
+  ::executorch::runtime::EventTracerEntry start_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index) override;
+  void end_profiling_delegate(
+      ::executorch::runtime::EventTracerEntry prof_entry,
+      const void* metadata,
+      size_t metadata_len) override;
+  void log_profiling_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      et_timestamp_t start_time,
+      et_timestamp_t end_time,
+      const void* metadata,
+      size_t metadata_len) override;
+  void track_allocation(::executorch::runtime::AllocatorID id, size_t size)
+      override;
+  ::executorch::runtime::AllocatorID track_allocator(const char* name) override;
+  void log_evalue(
+      const ::executorch::runtime::EValue& evalue,
+      ::executorch::runtime::LoggedEValueType evalue_type) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const exec_aten::Tensor& output) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const ::executorch::runtime::ArrayRef<exec_aten::Tensor> output)
+      override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const int& output) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const bool& output) override;
+  void log_intermediate_output_delegate(
+      const char* name,
+      ::executorch::runtime::DebugHandle delegate_debug_index,
+      const double& output) override;
+
+  /**
+   * The number of records that the ring buffer holds.
+   */
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  /**
+   * The total number of records that were appended, including those that
+   * were overwritten since.
+   */
+  uint64_t num_records() const {
+    return next_record_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * The number of records that were overwritten before flush() could log
+   * them, and are missing from its ETDumps.
+   */
+  uint64_t num_lost_records() const {
+    return num_lost_records_;
+  }
+
+  /**
+   * Returns the name with the given RingBufferRecord::name_index, or nullptr
+   * for RingBufferRecord::kNoName.
+   */
+  const char* name(uint16_t name_index) const;
+
+  /**
+   * Copies the records appended since `*cursor`, oldest first, and advances
+   * `*cursor` past them. Records that were overwritten are skipped. Start
+   * with a cursor of zero to read all the records that the ring buffer still
+   * holds.
+   *
+   * @param[in,out] cursor The number of records read so far.
+   * @param[out] records The records read.
+   *
+   * @returns The number of records copied to `records`.
+   */
+  size_t read_records(
+      uint64_t* cursor,
+      ::executorch::runtime::Span<RingBufferRecord> records) const;
+
+  /**
+   * Logs all the records that the ring buffer holds to `etdump_gen`, and
+   * returns its ETDump. Does not change what flush() logs next.
+   */
+  ETDumpResult snapshot(ETDumpGen& etdump_gen) const;
+
+  /**
+   * Logs the records appended since the previous flush to `etdump_gen`, and
+   * returns its ETDump. Call this periodically to stream the events out of
+   * the ring buffer.
+   */
+  ETDumpResult flush(ETDumpGen& etdump_gen);
+
+  /**
+   * Writes all the records that the ring buffer holds in the format of
+   * prof_result_t::prof_data of runtime/platform/profiler.h, with a profiling
+   * block for each event block. Unlike the profiling buffer, each block only
+   * holds as many events as it has and no memory allocations. Delegate events
+   * without a name are named after their delegate debug index.
+   *
+   * @param[out] buffer The buffer to write the results to. Its contents are
+   *     unspecified if the results do not fit.
+   *
+   * @returns The size of the results, which is larger than the size of
+   *     `buffer` if they do not fit.
+   */
+  size_t write_profile_results(::executorch::runtime::Span<uint8_t> buffer)
+      const;
+
+ private:
+  struct Slot;
+
+  struct NameEntry {
+    std::atomic<bool> ready;
+    char name[kMaxNameLength];
+  };
+
+  uint16_t intern_name(const char* name);
+  uint64_t append(const RingBufferRecord& record);
+  bool try_read(uint64_t index, RingBufferRecord* record, bool* pending)
+      const;
+  void write_etdump(ETDumpGen& etdump_gen, uint64_t* cursor) const;
+
+  Slot* slots_;
+  size_t capacity_;
+  std::atomic<uint64_t> next_record_{0};
+  uint64_t flush_cursor_ = 0;
+  uint64_t num_lost_records_ = 0;
+  NameEntry names_[kMaxNames];
+  std::atomic<size_t> num_names_{0};
+};
+
+} // namespace etdump
+} // namespace executorch
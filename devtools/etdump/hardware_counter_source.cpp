@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/devtools/etdump/hardware_counter_source.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <executorch/runtime/platform/log.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using ::executorch::runtime::CounterSource;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+using ::executorch::runtime::Span;
+
+namespace executorch {
+namespace etdump {
+
+const char* hardware_counter_name(HardwareCounter counter) {
+  switch (counter) {
+    case HardwareCounter::kCycles:
+      return "cycles";
+    case HardwareCounter::kInstructions:
+      return "instructions";
+    case HardwareCounter::kL1DataCacheMisses:
+      return "l1d_cache_misses";
+    case HardwareCounter::kLastLevelCacheMisses:
+      return "llc_misses";
+    case HardwareCounter::kStalledCyclesFrontend:
+      return "stalled_cycles_frontend";
+    case HardwareCounter::kStalledCyclesBackend:
+      return "stalled_cycles_backend";
+  }
+  return "unknown";
+}
+
+namespace {
+
+Error check_counters(Span<const HardwareCounter> counters) {
+  if (counters.size() == 0 || counters.size() > CounterSource::kMaxCounters) {
+    ET_LOG(
+        Error,
+        "Expected 1 to %zu counters, got %zu",
+        CounterSource::kMaxCounters,
+        counters.size());
+    return Error::InvalidArgument;
+  }
+  return Error::Ok;
+}
+
+#if defined(__linux__)
+
+void set_perf_event_config(HardwareCounter counter, perf_event_attr* attr) {
+  attr->type = PERF_TYPE_HARDWARE;
+  switch (counter) {
+    case HardwareCounter::kCycles:
+      attr->config = PERF_COUNT_HW_CPU_CYCLES;
+      return;
+    case HardwareCounter::kInstructions:
+      attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+      return;
+    case HardwareCounter::kL1DataCacheMisses:
+      attr->type = PERF_TYPE_HW_CACHE;
+      attr->config = PERF_COUNT_HW_CACHE_L1D |
+          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      return;
+    case HardwareCounter::kLastLevelCacheMisses:
+      attr->config = PERF_COUNT_HW_CACHE_MISSES;
+      return;
+    case HardwareCounter::kStalledCyclesFrontend:
+      attr->config = PERF_COUNT_HW_STALLED_CYCLES_FRONTEND;
+      return;
+    case HardwareCounter::kStalledCyclesBackend:
+      attr->config = PERF_COUNT_HW_STALLED_CYCLES_BACKEND;
+      return;
+  }
+}
+
+#endif // defined(__linux__)
+
+} // namespace
+
+Result<PerfEventCounterSource> PerfEventCounterSource::from(
+    Span<const HardwareCounter> counters) {
+  Error err = check_counters(counters);
+  if (err != Error::Ok) {
+    return err;
+  }
+#if defined(__linux__)
+  int fds[kMaxCounters];
+  for (size_t i = 0; i < counters.size(); ++i) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    set_perf_event_config(counters[i], &attr);
+    // Only the leader starts disabled; the others follow it.
+    attr.disabled = i == 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    int group_fd = i == 0 ? -1 : fds[0];
+    fds[i] = static_cast<int>(syscall(
+        __NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1, group_fd, 0));
+    if (fds[i] < 0) {
+      int error = errno;
+      ET_LOG(
+          Error,
+          "Failed to open counter %s: %s",
+          hardware_counter_name(counters[i]),
+          strerror(error));
+      for (size_t j = 0; j < i; ++j) {
+        close(fds[j]);
+      }
+      return error == ENOENT || error == EOPNOTSUPP || error == EINVAL
+          ? Error::NotSupported
+          : Error::AccessFailed;
+    }
+  }
+  ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return PerfEventCounterSource(counters, fds);
+#else // !defined(__linux__)
+  ET_LOG(Error, "perf_event_open is only available on Linux");
+  return Error::NotSupported;
+#endif // defined(__linux__)
+}
+
+PerfEventCounterSource::PerfEventCounterSource(
+    Span<const HardwareCounter> counters,
+    const int* fds)
+    : num_counters_(counters.size()) {
+  for (size_t i = 0; i < num_counters_; ++i) {
+    counters_[i] = counters[i];
+    fds_[i] = fds[i];
+  }
+}
+
+PerfEventCounterSource::PerfEventCounterSource(
+    PerfEventCounterSource&& rhs) noexcept
+    : num_counters_(rhs.num_counters_) {
+  for (size_t i = 0; i < num_counters_; ++i) {
+    counters_[i] = rhs.counters_[i];
+    fds_[i] = rhs.fds_[i];
+  }
+  rhs.num_counters_ = 0;
+}
+
+PerfEventCounterSource::~PerfEventCounterSource() {
+#if defined(__linux__)
+  // Close the leader last.
+  for (size_t i = num_counters_; i > 0; --i) {
+    close(fds_[i - 1]);
+  }
+#endif // defined(__linux__)
+}
+
+const char* PerfEventCounterSource::counter_name(size_t index) const {
+  return hardware_counter_name(counters_[index]);
+}
+
+void PerfEventCounterSource::read_counters(uint64_t* values) {
+#if defined(__linux__)
+  // With PERF_FORMAT_GROUP, the leader reads the number of counters followed
+  // by the value of each counter.
+  uint64_t buffer[1 + kMaxCounters];
+  ssize_t size = read(fds_[0], buffer, (1 + num_counters_) * sizeof(uint64_t));
+  if (size == static_cast<ssize_t>((1 + num_counters_) * sizeof(uint64_t))) {
+    memcpy(values, &buffer[1], num_counters_ * sizeof(uint64_t));
+    return;
+  }
+#endif // defined(__linux__)
+  memset(values, 0, num_counters_ * sizeof(uint64_t));
+}
+
+#if defined(__aarch64__)
+
+namespace {
+
+// Armv8-A common PMU event numbers.
+constexpr uint32_t kPmuInstRetired = 0x08;
+constexpr uint32_t kPmuL1dCacheRefill = 0x03;
+constexpr uint32_t kPmuLlCacheMissRd = 0x37;
+constexpr uint32_t kPmuStallFrontend = 0x23;
+constexpr uint32_t kPmuStallBackend = 0x24;
+
+uint32_t get_pmu_event(HardwareCounter counter) {
+  switch (counter) {
+    case HardwareCounter::kInstructions:
+      return kPmuInstRetired;
+    case HardwareCounter::kL1DataCacheMisses:
+      return kPmuL1dCacheRefill;
+    case HardwareCounter::kLastLevelCacheMisses:
+      return kPmuLlCacheMissRd;
+    case HardwareCounter::kStalledCyclesFrontend:
+      return kPmuStallFrontend;
+    case HardwareCounter::kStalledCyclesBackend:
+      return kPmuStallBackend;
+    case HardwareCounter::kCycles:
+      break;
+  }
+  return 0;
+}
+
+uint32_t read_event_counter(uint32_t counter) {
+  uint64_t value;
+  asm volatile("msr pmselr_el0, %0" : : "r"(static_cast<uint64_t>(counter)));
+  asm volatile("isb");
+  asm volatile("mrs %0, pmxevcntr_el0" : "=r"(value));
+  return static_cast<uint32_t>(value);
+}
+
+} // namespace
+
+#endif // defined(__aarch64__)
+
+Result<ArmPmuCounterSource> ArmPmuCounterSource::from(
+    Span<const HardwareCounter> counters) {
+  Error err = check_counters(counters);
+  if (err != Error::Ok) {
+    return err;
+  }
+#if defined(__aarch64__)
+  ArmPmuCounterSource source(counters);
+  uint64_t pmcr;
+  asm volatile("mrs %0, pmcr_el0" : "=r"(pmcr));
+  // PMCR_EL0.N is the number of event counters.
+  uint32_t num_event_counters = (pmcr >> 11) & 0x1f;
+  uint32_t next_event_counter = 0;
+  uint64_t enable_mask = 0;
+  for (size_t i = 0; i < source.num_counters_; ++i) {
+    if (counters[i] == HardwareCounter::kCycles) {
+      source.pmu_counters_[i] = kCycleCounter;
+    } else {
+      if (next_event_counter == num_event_counters) {
+        ET_LOG(
+            Error,
+            "The PMU has only %u event counters",
+            static_cast<unsigned>(num_event_counters));
+        return Error::NotSupported;
+      }
+      source.pmu_counters_[i] = next_event_counter++;
+      asm volatile(
+          "msr pmselr_el0, %0"
+          :
+          : "r"(static_cast<uint64_t>(source.pmu_counters_[i])));
+      asm volatile("isb");
+      asm volatile(
+          "msr pmxevtyper_el0, %0"
+          :
+          : "r"(static_cast<uint64_t>(get_pmu_event(counters[i]))));
+    }
+    enable_mask |= 1ull << source.pmu_counters_[i];
+  }
+  asm volatile("msr pmcntenset_el0, %0" : : "r"(enable_mask));
+  // Set PMCR_EL0.E to enable the counters, and PMCR_EL0.LC so that the cycle
+  // counter overflows at 64 bits.
+  asm volatile("msr pmcr_el0, %0" : : "r"(pmcr | (1ull << 0) | (1ull << 6)));
+  asm volatile("isb");
+  for (size_t i = 0; i < source.num_counters_; ++i) {
+    if (source.pmu_counters_[i] != kCycleCounter) {
+      source.last_values_[i] = read_event_counter(source.pmu_counters_[i]);
+    }
+  }
+  return source;
+#else // !defined(__aarch64__)
+  ET_LOG(Error, "The Arm PMU is only available on AArch64");
+  return Error::NotSupported;
+#endif // defined(__aarch64__)
+}
+
+ArmPmuCounterSource::ArmPmuCounterSource(Span<const HardwareCounter> counters)
+    : num_counters_(counters.size()) {
+  for (size_t i = 0; i < num_counters_; ++i) {
+    counters_[i] = counters[i];
+    pmu_counters_[i] = kCycleCounter;
+    last_values_[i] = 0;
+    totals_[i] = 0;
+  }
+}
+
+const char* ArmPmuCounterSource::counter_name(size_t index) const {
+  return hardware_counter_name(counters_[index]);
+}
+
+void ArmPmuCounterSource::read_counters(uint64_t* values) {
+#if defined(__aarch64__)
+  for (size_t i = 0; i < num_counters_; ++i) {
+    if (pmu_counters_[i] == kCycleCounter) {
+      asm volatile("mrs %0, pmccntr_el0" : "=r"(values[i]));
+    } else {
+      uint32_t value = read_event_counter(pmu_counters_[i]);
+      // Unsigned arithmetic handles a counter that wrapped around since the
+      // last read.
+      totals_[i] += static_cast<uint32_t>(value - last_values_[i]);
+      last_values_[i] = value;
+      values[i] = totals_[i];
+    }
+  }
+#else // !defined(__aarch64__)
+  memset(values, 0, num_counters_ * sizeof(uint64_t));
+#endif // defined(__aarch64__)
+}
+
+} // namespace etdump
+} // namespace executorch
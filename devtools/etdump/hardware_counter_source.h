@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/event_tracer.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
+
+namespace executorch {
+namespace etdump {
+
+/**
+ * Hardware events that a CounterSource in this file can count.
+ */
+enum class HardwareCounter : uint8_t {
+  /// CPU cycles.
+  kCycles,
+  /// Retired instructions.
+  kInstructions,
+  /// Level 1 data cache misses (refills).
+  kL1DataCacheMisses,
+  /// Last level cache misses.
+  kLastLevelCacheMisses,
+  /// Cycles in which the frontend of the CPU did not issue instructions.
+  kStalledCyclesFrontend,
+  /// Cycles in which the backend of the CPU did not retire instructions.
+  kStalledCyclesBackend,
+};
+
+/**
+ * Returns the name that is recorded in ETDump for the given counter, e.g.
+ * "cycles".
+ */
+const char* hardware_counter_name(HardwareCounter counter);
+
+/**
+ * Counts hardware events of the calling thread with the Linux perf_event_open
+ * system call. The counters are opened as one group, so that they are
+ * scheduled onto the PMU together and read with a single system call.
+ *
+ * Only the thread that created the source is counted; work that an operator
+ * hands off to other threads is not. Depending on kernel.perf_event_paranoid,
+ * counting may require CAP_PERFMON.
+ */
+class PerfEventCounterSource final
+    : public ::executorch::runtime::CounterSource {
+ public:
+  /**
+   * Opens and starts the counters on the calling thread.
+   *
+   * @param[in] counters The events to count, at most kMaxCounters.
+   *
+   * @returns A new PerfEventCounterSource on success.
+   * @retval Error::InvalidArgument `counters` is empty or too long.
+   * @retval Error::NotSupported Not on Linux, or the CPU or kernel cannot
+   *     count one of the events.
+   * @retval Error::AccessFailed The kernel refused to open the counters.
+   */
+  static ::executorch::runtime::Result<PerfEventCounterSource> from(
+      ::executorch::runtime::Span<const HardwareCounter> counters);
+
+  PerfEventCounterSource(PerfEventCounterSource&& rhs) noexcept;
+  ~PerfEventCounterSource() override;
+
+  PerfEventCounterSource(const PerfEventCounterSource&) = delete;
+  PerfEventCounterSource& operator=(const PerfEventCounterSource&) = delete;
+  PerfEventCounterSource& operator=(PerfEventCounterSource&&) = delete;
+
+  size_t num_counters() const override {
+    return num_counters_;
+  }
+  const char* counter_name(size_t index) const override;
+  void read_counters(uint64_t* values) override;
+
+ private:
+  PerfEventCounterSource(
+      ::executorch::runtime::Span<const HardwareCounter> counters,
+      const int* fds);
+
+  HardwareCounter counters_[kMaxCounters];
+  int fds_[kMaxCounters];
+  size_t num_counters_;
+};
+
+/**
+ * Counts hardware events by programming the Armv8-A PMU directly through its
+ * system registers, for AArch64 targets without an operating system that
+ * provides perf_event_open. Cycles are counted by the dedicated cycle counter
+ * and other events by the event counters, in order.
+ *
+ * The PMU is shared by everything that runs on the core and is not saved on
+ * a context switch, so the counts include whatever else ran during an event.
+ * Accessing the PMU traps unless the code runs at EL1 or higher, or the
+ * PMUSERENR_EL0 register allows EL0 to access it; on Linux, use
+ * PerfEventCounterSource instead.
+ */
+class ArmPmuCounterSource final : public ::executorch::runtime::CounterSource {
+ public:
+  /**
+   * Programs and starts the counters of the PMU of the calling core.
+   *
+   * @param[in] counters The events to count, at most kMaxCounters.
+   *
+   * @returns A new ArmPmuCounterSource on success.
+   * @retval Error::InvalidArgument `counters` is empty or too long.
+   * @retval Error::NotSupported Not on AArch64, or the PMU has fewer event
+   *     counters than requested.
+   */
+  static ::executorch::runtime::Result<ArmPmuCounterSource> from(
+      ::executorch::runtime::Span<const HardwareCounter> counters);
+
+  size_t num_counters() const override {
+    return num_counters_;
+  }
+  const char* counter_name(size_t index) const override;
+  void read_counters(uint64_t* values) override;
+
+ private:
+  explicit ArmPmuCounterSource(
+      ::executorch::runtime::Span<const HardwareCounter> counters);
+
+  HardwareCounter counters_[kMaxCounters];
+  // The PMU event counter of each counter, or kCycleCounter.
+  uint32_t pmu_counters_[kMaxCounters];
+  // The event counters are 32 bits wide, so extend them to 64 bits by
+  // accumulating the differences between reads.
+  uint32_t last_values_[kMaxCounters];
+  uint64_t totals_[kMaxCounters];
+  size_t num_counters_;
+
+  static constexpr uint32_t kCycleCounter = 31;
+};
+
+} // namespace etdump
+} // namespace executorch
@@ -18,12 +18,21 @@ from typing import List, Optional
 from executorch.exir.scalar_type import ScalarType
 
 
+@dataclass
+class TensorStats:
+    min: float
+    max: float
+    mean: float
+    nan_count: int
+
+
 @dataclass
 class Tensor:
     scalar_type: ScalarType
     sizes: List[int]
     strides: List[int]
     offset: Optional[int]
+    stats: Optional[TensorStats] = None
 
 
 @dataclass
@@ -119,12 +128,17 @@ class ProfileEvent:
     delegate_debug_metadata: Optional[bytes]
     start_time: int
     end_time: int
+    counter_deltas: Optional[List[int]] = None
+    thread_id: Optional[int] = None
 
 
 @dataclass
 class AllocationEvent:
     allocator_id: int
     allocation_size: int
+    chain_index: Optional[int] = None
+    instruction_id: Optional[int] = None
+    time: Optional[int] = None
 
 
 @dataclass
@@ -146,6 +160,7 @@ class RunData:
     bundled_input_index: Optional[int]
     allocators: Optional[List[Allocator]]
     events: Optional[List[Event]]
+    counter_names: Optional[List[str]] = None
 
 
 @dataclass
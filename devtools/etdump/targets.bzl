@@ -114,3 +114,45 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
         )
+
+        runtime.cxx_library(
+            name = "hardware_counter_source" + aten_suffix,
+            srcs = [
+                "hardware_counter_source.cpp",
+            ],
+            exported_headers = [
+                "hardware_counter_source.h",
+            ],
+            deps = [
+                "//executorch/runtime/platform:platform",
+            ],
+            exported_deps = [
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core:event_tracer" + aten_suffix,
+            ],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "etdump_ring_buffer" + aten_suffix,
+            srcs = [
+                "etdump_ring_buffer.cpp",
+            ],
+            exported_headers = [
+                "etdump_ring_buffer.h",
+            ],
+            deps = [
+                "//executorch/runtime/platform:platform",
+            ],
+            exported_deps = [
+                ":etdump_flatcc" + aten_suffix,
+                "//executorch/runtime/core:event_tracer" + aten_suffix,
+            ],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/devtools/etdump/etdump_flatcc.h>
+#include <executorch/devtools/etdump/etdump_ring_buffer.h>
+#include <executorch/devtools/etdump/etdump_schema_flatcc_builder.h>
+#include <executorch/devtools/etdump/etdump_schema_flatcc_reader.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/profiler.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ::executorch::etdump::ETDumpGen;
+using ::executorch::etdump::ETDumpResult;
+using ::executorch::etdump::ETDumpRingBuffer;
+using ::executorch::etdump::RingBufferRecord;
+using ::executorch::etdump::RingBufferRecordKind;
+using ::executorch::runtime::EventTracerEntry;
+using ::executorch::runtime::prof_event_t;
+using ::executorch::runtime::prof_header_t;
+using ::executorch::runtime::Span;
+
+class ETDumpRingBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+    buffer_.resize(ETDumpRingBuffer::buffer_size(kNumRecords));
+    ring_buffer_ = std::make_unique<ETDumpRingBuffer>(
+        Span<uint8_t>(buffer_.data(), buffer_.size()));
+  }
+
+  void log_events(size_t num_events) {
+    for (size_t i = 0; i < num_events; ++i) {
+      EventTracerEntry entry =
+          ring_buffer_->start_profiling("test_event", 0, i);
+      ring_buffer_->end_profiling(entry);
+    }
+  }
+
+  static constexpr size_t kNumRecords = 16;
+
+  std::vector<uint8_t> buffer_;
+  std::unique_ptr<ETDumpRingBuffer> ring_buffer_;
+};
+
+TEST_F(ETDumpRingBufferTest, ReadRecords) {
+  ASSERT_EQ(ring_buffer_->capacity(), kNumRecords);
+  log_events(3);
+
+  RingBufferRecord records[kNumRecords];
+  uint64_t cursor = 0;
+  ASSERT_EQ(ring_buffer_->read_records(&cursor, records), 3);
+  EXPECT_EQ(cursor, 3);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(records[i].kind, RingBufferRecordKind::kProfile);
+    EXPECT_EQ(records[i].debug_handle, i);
+    EXPECT_LE(records[i].start_time, records[i].end_time);
+    EXPECT_STREQ(ring_buffer_->name(records[i].name_index), "test_event");
+  }
+
+  // Nothing new to read.
+  EXPECT_EQ(ring_buffer_->read_records(&cursor, records), 0);
+  EXPECT_EQ(cursor, 3);
+}
+
+TEST_F(ETDumpRingBufferTest, OverwritesOldestRecords) {
+  log_events(kNumRecords + 5);
+  EXPECT_EQ(ring_buffer_->num_records(), kNumRecords + 5);
+
+  RingBufferRecord records[kNumRecords];
+  uint64_t cursor = 0;
+  ASSERT_EQ(ring_buffer_->read_records(&cursor, records), kNumRecords);
+  EXPECT_EQ(cursor, kNumRecords + 5);
+  for (size_t i = 0; i < kNumRecords; ++i) {
+    EXPECT_EQ(records[i].debug_handle, i + 5);
+  }
+}
+
+TEST_F(ETDumpRingBufferTest, LongNamesAreTruncated) {
+  std::string long_name(2 * ETDumpRingBuffer::kMaxNameLength, 'a');
+  EventTracerEntry entry = ring_buffer_->start_profiling(long_name.c_str());
+  ring_buffer_->end_profiling(entry);
+
+  RingBufferRecord record;
+  uint64_t cursor = 0;
+  ASSERT_EQ(ring_buffer_->read_records(&cursor, {&record, 1}), 1);
+  EXPECT_EQ(
+      std::string(ring_buffer_->name(record.name_index)),
+      long_name.substr(0, ETDumpRingBuffer::kMaxNameLength - 1));
+}
+
+TEST_F(ETDumpRingBufferTest, ConcurrentWriters) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kEventsPerThread = 1000;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([this]() { log_events(kEventsPerThread); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(ring_buffer_->num_records(), kNumThreads * kEventsPerThread);
+
+  RingBufferRecord records[kNumRecords];
+  uint64_t cursor = 0;
+  ASSERT_EQ(ring_buffer_->read_records(&cursor, records), kNumRecords);
+  for (size_t i = 0; i < kNumRecords; ++i) {
+    EXPECT_STREQ(ring_buffer_->name(records[i].name_index), "test_event");
+  }
+}
+
+TEST_F(ETDumpRingBufferTest, DiscardEventBlock) {
+  // Nothing to discard before a block is created.
+  EXPECT_EQ(
+      ring_buffer_->discard_event_block(),
+      ::executorch::runtime::Error::NotSupported);
+
+  ring_buffer_->create_event_block("kept_block");
+  log_events(2);
+  ring_buffer_->create_event_block("discarded_block");
+  log_events(3);
+  EXPECT_EQ(
+      ring_buffer_->discard_event_block(), ::executorch::runtime::Error::Ok);
+
+  RingBufferRecord records[kNumRecords];
+  uint64_t cursor = 0;
+  ASSERT_EQ(ring_buffer_->read_records(&cursor, records), 3);
+  EXPECT_EQ(cursor, 7);
+  EXPECT_EQ(records[0].kind, RingBufferRecordKind::kBlock);
+  EXPECT_STREQ(ring_buffer_->name(records[0].name_index), "kept_block");
+}
+
+TEST_F(ETDumpRingBufferTest, SnapshotAndFlush) {
+  ETDumpGen etdump_gen;
+  ring_buffer_->create_event_block("test_block");
+  log_events(2);
+  ring_buffer_->log_profiling_delegate(nullptr, 7, 100, 200, nullptr, 0);
+
+  for (size_t i = 0; i < 2; ++i) {
+    // A snapshot does not consume the records, so the first flush returns
+    // the same events.
+    ETDumpResult result = i == 0 ? ring_buffer_->snapshot(etdump_gen)
+                                 : ring_buffer_->flush(etdump_gen);
+    ASSERT_NE(result.buf, nullptr);
+
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    ASSERT_NE(etdump, nullptr);
+
+    etdump_RunData_vec_t run_data_vec = etdump_ETDump_run_data(etdump);
+    ASSERT_EQ(etdump_RunData_vec_len(run_data_vec), 1);
+    etdump_RunData_table_t run_data = etdump_RunData_vec_at(run_data_vec, 0);
+    EXPECT_STREQ(etdump_RunData_name(run_data), "test_block");
+
+    etdump_Event_vec_t events = etdump_RunData_events(run_data);
+    ASSERT_EQ(etdump_Event_vec_len(events), 3);
+    etdump_ProfileEvent_table_t event =
+        etdump_Event_profile_event(etdump_Event_vec_at(events, 1));
+    EXPECT_STREQ(etdump_ProfileEvent_name(event), "test_event");
+    EXPECT_EQ(etdump_ProfileEvent_instruction_id(event), 1);
+    event = etdump_Event_profile_event(etdump_Event_vec_at(events, 2));
+    EXPECT_EQ(etdump_ProfileEvent_delegate_debug_id_int(event), 7);
+    EXPECT_EQ(etdump_ProfileEvent_start_time(event), 100);
+    EXPECT_EQ(etdump_ProfileEvent_end_time(event), 200);
+
+    free(result.buf);
+  }
+
+  // Nothing was logged since the last flush.
+  ETDumpResult result = ring_buffer_->flush(etdump_gen);
+  EXPECT_EQ(result.buf, nullptr);
+}
+
+TEST_F(ETDumpRingBufferTest, FlushCountsLostRecords) {
+  ETDumpGen etdump_gen;
+  log_events(kNumRecords + 5);
+  EXPECT_EQ(ring_buffer_->num_lost_records(), 0);
+
+  ETDumpResult result = ring_buffer_->flush(etdump_gen);
+  ASSERT_NE(result.buf, nullptr);
+  free(result.buf);
+  EXPECT_EQ(ring_buffer_->num_lost_records(), 5);
+
+  // Records that are flushed in time are not lost.
+  log_events(kNumRecords);
+  result = ring_buffer_->flush(etdump_gen);
+  ASSERT_NE(result.buf, nullptr);
+  free(result.buf);
+  EXPECT_EQ(ring_buffer_->num_lost_records(), 5);
+}
+
+TEST_F(ETDumpRingBufferTest, WriteProfileResults) {
+  // Nothing to write without records.
+  EXPECT_EQ(ring_buffer_->write_profile_results({}), 0);
+
+  log_events(1);
+  ring_buffer_->create_event_block("test_block");
+  log_events(2);
+  ring_buffer_->log_profiling_delegate(nullptr, 7, 100, 200, nullptr, 0);
+
+  size_t size = ring_buffer_->write_profile_results({});
+  ASSERT_EQ(size, 2 * sizeof(prof_header_t) + 4 * sizeof(prof_event_t));
+  // The size is returned even if the results do not fit.
+  std::vector<uint8_t> results(size - 1);
+  EXPECT_EQ(
+      ring_buffer_->write_profile_results({results.data(), results.size()}),
+      size);
+  results.resize(size);
+  EXPECT_EQ(
+      ring_buffer_->write_profile_results({results.data(), results.size()}),
+      size);
+
+  // The events logged before the first block get a block of their own.
+  prof_header_t header;
+  memcpy(&header, results.data(), sizeof(header));
+  EXPECT_STREQ(header.name, "ETDumpRingBuffer");
+  EXPECT_EQ(header.prof_ver, ET_PROF_VER);
+  EXPECT_EQ(header.max_prof_entries, 1);
+  EXPECT_EQ(header.prof_entries, 1);
+  EXPECT_EQ(header.max_allocator_entries, 0);
+  EXPECT_EQ(header.max_mem_prof_entries, 0);
+
+  size_t offset = sizeof(header) + sizeof(prof_event_t);
+  memcpy(&header, results.data() + offset, sizeof(header));
+  EXPECT_STREQ(header.name, "test_block");
+  EXPECT_EQ(header.max_prof_entries, 3);
+  EXPECT_EQ(header.prof_entries, 3);
+
+  prof_event_t events[3];
+  memcpy(events, results.data() + offset + sizeof(header), sizeof(events));
+  EXPECT_STREQ(events[0].name, "test_event");
+  EXPECT_EQ(events[1].instruction_idx, 1);
+  EXPECT_LE(events[1].start_time, events[1].end_time);
+  EXPECT_STREQ(events[2].name, "7");
+  EXPECT_EQ(events[2].start_time, 100);
+  EXPECT_EQ(events[2].end_time, 200);
+}
+
+TEST_F(ETDumpRingBufferTest, FlushRecordsThreadIds) {
+  ETDumpGen etdump_gen;
+  ring_buffer_->create_event_block("test_block");
+  log_events(1);
+  std::thread thread([this]() { log_events(1); });
+  thread.join();
+
+  ETDumpResult result = ring_buffer_->flush(etdump_gen);
+  ASSERT_NE(result.buf, nullptr);
+  size_t size = 0;
+  void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+  etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+      buf, etdump_ETDump_file_identifier);
+  ASSERT_NE(etdump, nullptr);
+
+  etdump_Event_vec_t events = etdump_RunData_events(
+      etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+  ASSERT_EQ(etdump_Event_vec_len(events), 2);
+  EXPECT_NE(
+      etdump_ProfileEvent_thread_id(
+          etdump_Event_profile_event(etdump_Event_vec_at(events, 0))),
+      etdump_ProfileEvent_thread_id(
+          etdump_Event_profile_event(etdump_Event_vec_at(events, 1))));
+
+  free(result.buf);
+}
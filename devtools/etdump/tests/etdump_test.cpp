@@ -16,6 +16,7 @@
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/platform/runtime.h>
 #include <executorch/test/utils/DeathTest.h>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 #include <memory>
@@ -24,15 +25,21 @@ using ::exec_aten::ScalarType;
 using ::exec_aten::Tensor;
 using ::executorch::etdump::ETDumpGen;
 using ::executorch::etdump::ETDumpResult;
+using ::executorch::etdump::IntermediateOutputFilter;
+using ::executorch::etdump::TensorLoggingMode;
 using ::executorch::runtime::AllocatorID;
 using ::executorch::runtime::ArrayRef;
 using ::executorch::runtime::BoxedEvalueList;
+using ::executorch::runtime::CounterSource;
 using ::executorch::runtime::DelegateDebugIdType;
+using ::executorch::runtime::Error;
 using ::executorch::runtime::EValue;
 using ::executorch::runtime::EventTracerEntry;
 using ::executorch::runtime::LoggedEValueType;
 using ::executorch::runtime::Span;
 using ::executorch::runtime::Tag;
+using ::executorch::runtime::kUnsetChainId;
+using ::executorch::runtime::kUnsetDebugHandle;
 using ::executorch::runtime::testing::TensorFactory;
 
 class ProfilerETDumpTest : public ::testing::Test {
@@ -296,7 +303,9 @@ TEST_F(ProfilerETDumpTest, MultipleBlocksWithEvents) {
     AllocatorID allocator_id_1 =
         etdump_gen[i]->track_allocator("test_allocator_1");
     etdump_gen[i]->track_allocation(allocator_id_0, 64);
+    etdump_gen[i]->set_chain_debug_handle(1, 5);
     etdump_gen[i]->track_allocation(allocator_id_1, 128);
+    etdump_gen[i]->set_chain_debug_handle(kUnsetChainId, kUnsetDebugHandle);
 
     EventTracerEntry entry = etdump_gen[i]->start_profiling("test_event", 0, 1);
     etdump_gen[i]->end_profiling(entry);
@@ -352,6 +361,21 @@ TEST_F(ProfilerETDumpTest, MultipleBlocksWithEvents) {
         etdump_AllocationEvent_allocation_size(
             etdump_Event_allocation_event(event_0)),
         64);
+    EXPECT_EQ(
+        etdump_AllocationEvent_chain_index(
+            etdump_Event_allocation_event(event_0)),
+        kUnsetChainId);
+
+    etdump_AllocationEvent_table_t allocation_1 =
+        etdump_Event_allocation_event(etdump_Event_vec_at(event_vec, 1));
+    EXPECT_EQ(
+        etdump_AllocationEvent_allocator_id(allocation_1), allocator_id_1);
+    EXPECT_EQ(etdump_AllocationEvent_allocation_size(allocation_1), 128);
+    EXPECT_EQ(etdump_AllocationEvent_chain_index(allocation_1), 1);
+    EXPECT_EQ(etdump_AllocationEvent_instruction_id(allocation_1), 5);
+    EXPECT_GE(
+        etdump_AllocationEvent_time(allocation_1),
+        etdump_AllocationEvent_time(etdump_Event_allocation_event(event_0)));
 
     etdump_Event_table_t event_2 = etdump_Event_vec_at(event_vec, 2);
     flatbuffers_string_t event_2_name =
@@ -569,6 +593,122 @@ TEST_F(ProfilerETDumpTest, VerifyDelegateIntermediateLogging) {
   }
 }
 
+TEST_F(ProfilerETDumpTest, LogTensorStatistics) {
+  TensorFactory<ScalarType::Float> tf;
+  EValue evalue(tf.make({4}, {1, NAN, -2, 3}));
+
+  for (size_t i = 0; i < 2; i++) {
+    // No debug buffer is needed to log statistics.
+    etdump_gen[i]->create_event_block("test_block");
+    etdump_gen[i]->set_tensor_logging_mode(TensorLoggingMode::kStatistics);
+    etdump_gen[i]->log_evalue(evalue);
+    etdump_gen[i]->set_tensor_logging_mode(
+        TensorLoggingMode::kStatistics, /*statistics_stride=*/2);
+    etdump_gen[i]->log_evalue(evalue);
+
+    ETDumpResult result = etdump_gen[i]->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    etdump_Event_vec_t events = etdump_RunData_events(
+        etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+    ASSERT_EQ(etdump_Event_vec_len(events), 2);
+
+    etdump_Tensor_table_t tensor = etdump_Value_tensor(
+        etdump_DebugEvent_debug_entry(
+            etdump_Event_debug_event(etdump_Event_vec_at(events, 0))));
+    EXPECT_EQ(etdump_Tensor_offset(tensor), -1);
+    ASSERT_TRUE(etdump_Tensor_stats_is_present(tensor));
+    etdump_TensorStats_table_t stats = etdump_Tensor_stats(tensor);
+    EXPECT_EQ(etdump_TensorStats_min(stats), -2);
+    EXPECT_EQ(etdump_TensorStats_max(stats), 3);
+    EXPECT_DOUBLE_EQ(etdump_TensorStats_mean(stats), 2.0 / 3);
+    EXPECT_EQ(etdump_TensorStats_nan_count(stats), 1);
+
+    // Only the elements 1 and -2 are sampled with a stride of 2.
+    stats = etdump_Tensor_stats(etdump_Value_tensor(
+        etdump_DebugEvent_debug_entry(
+            etdump_Event_debug_event(etdump_Event_vec_at(events, 1)))));
+    EXPECT_EQ(etdump_TensorStats_min(stats), -2);
+    EXPECT_EQ(etdump_TensorStats_max(stats), 1);
+    EXPECT_DOUBLE_EQ(etdump_TensorStats_mean(stats), -0.5);
+    EXPECT_EQ(etdump_TensorStats_nan_count(stats), 0);
+
+    if (!etdump_gen[i]->is_static_etdump()) {
+      free(result.buf);
+    }
+  }
+}
+
+TEST_F(ProfilerETDumpTest, FilterIntermediateOutputs) {
+  TensorFactory<ScalarType::Float> tf;
+  EValue evalue(tf.ones({3, 2}));
+
+  for (size_t i = 0; i < 2; i++) {
+    etdump_gen[i]->create_event_block("test_block");
+
+    void* ptr = malloc(2048);
+    Span<uint8_t> buffer((uint8_t*)ptr, 2048);
+    etdump_gen[i]->set_debug_buffer(buffer);
+
+    IntermediateOutputFilter filter;
+    filter.min_debug_handle = 2;
+    filter.max_debug_handle = 3;
+    filter.delegate_output_name_prefix = "conv";
+    etdump_gen[i]->set_intermediate_output_filter(filter);
+
+    // Outside of the debug handle range, only program outputs are logged.
+    etdump_gen[i]->set_chain_debug_handle(0, 1);
+    etdump_gen[i]->log_evalue(evalue);
+    etdump_gen[i]->log_intermediate_output_delegate(
+        "conv_1", -1, tf.ones({3, 2}));
+    etdump_gen[i]->log_evalue(evalue, LoggedEValueType::kProgramOutput);
+
+    // Inside of the range, instruction outputs and the delegate outputs with
+    // the prefix are logged.
+    etdump_gen[i]->set_chain_debug_handle(0, 2);
+    etdump_gen[i]->log_evalue(evalue);
+    etdump_gen[i]->log_intermediate_output_delegate(
+        "conv_2", -1, tf.ones({3, 2}));
+    etdump_gen[i]->log_intermediate_output_delegate(
+        "relu_2", -1, tf.ones({3, 2}));
+    etdump_gen[i]->log_intermediate_output_delegate(
+        nullptr, 7, tf.ones({3, 2}));
+    etdump_gen[i]->set_chain_debug_handle(kUnsetChainId, kUnsetDebugHandle);
+
+    ETDumpResult result = etdump_gen[i]->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    etdump_Event_vec_t events = etdump_RunData_events(
+        etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0));
+    ASSERT_EQ(etdump_Event_vec_len(events), 3);
+
+    etdump_DebugEvent_table_t debug_event =
+        etdump_Event_debug_event(etdump_Event_vec_at(events, 0));
+    EXPECT_EQ(etdump_DebugEvent_instruction_id(debug_event), 1);
+    EXPECT_TRUE(etdump_Value_output_is_present(
+        etdump_DebugEvent_debug_entry(debug_event)));
+    debug_event = etdump_Event_debug_event(etdump_Event_vec_at(events, 1));
+    EXPECT_EQ(etdump_DebugEvent_instruction_id(debug_event), 2);
+    EXPECT_EQ(etdump_DebugEvent_delegate_debug_id_str(debug_event), nullptr);
+    debug_event = etdump_Event_debug_event(etdump_Event_vec_at(events, 2));
+    EXPECT_STREQ(
+        etdump_DebugEvent_delegate_debug_id_str(debug_event), "conv_2");
+
+    free(ptr);
+    if (!etdump_gen[i]->is_static_etdump()) {
+      free(result.buf);
+    }
+  }
+}
+
 TEST_F(ProfilerETDumpTest, LogDelegateEvents) {
   for (size_t i = 0; i < 2; i++) {
     etdump_gen[i]->create_event_block("test_block");
@@ -724,3 +864,80 @@ TEST_F(ProfilerETDumpTest, WriteAfterGetETDumpData) {
     }
   }
 }
+
+// A counter source whose counters advance by 10 and 100 on every read.
+class FakeCounterSource final : public CounterSource {
+ public:
+  size_t num_counters() const override {
+    return 2;
+  }
+  const char* counter_name(size_t index) const override {
+    return index == 0 ? "fake_a" : "fake_b";
+  }
+  void read_counters(uint64_t* values) override {
+    ++num_reads_;
+    values[0] = num_reads_ * 10;
+    values[1] = num_reads_ * 100;
+  }
+
+ private:
+  uint64_t num_reads_ = 0;
+};
+
+TEST_F(ProfilerETDumpTest, CounterDeltas) {
+  for (size_t i = 0; i < 2; i++) {
+    FakeCounterSource counter_source;
+    ASSERT_EQ(etdump_gen[i]->set_counter_source(&counter_source), Error::Ok);
+    etdump_gen[i]->create_event_block("test_block");
+
+    EventTracerEntry outer = etdump_gen[i]->start_profiling("outer", 0, 1);
+    EventTracerEntry inner = etdump_gen[i]->start_profiling("inner", 0, 2);
+    etdump_gen[i]->end_profiling(inner);
+    etdump_gen[i]->end_profiling(outer);
+    EventTracerEntry delegate =
+        etdump_gen[i]->start_profiling_delegate(nullptr, 3);
+    etdump_gen[i]->end_profiling_delegate(delegate, nullptr, 0);
+    // Events timed outside of ETDumpGen have no counters.
+    etdump_gen[i]->log_profiling_delegate(nullptr, 4, 100, 200, nullptr, 0);
+
+    ETDumpResult result = etdump_gen[i]->get_etdump_data();
+    ASSERT_TRUE(result.buf != nullptr);
+    ASSERT_TRUE(result.size != 0);
+    ASSERT_EQ(etdump_gen[i]->set_counter_source(nullptr), Error::Ok);
+
+    size_t size = 0;
+    void* buf = flatbuffers_read_size_prefix(result.buf, &size);
+    etdump_ETDump_table_t etdump = etdump_ETDump_as_root_with_identifier(
+        buf, etdump_ETDump_file_identifier);
+    ASSERT_NE(etdump, nullptr);
+
+    etdump_RunData_table_t run_data =
+        etdump_RunData_vec_at(etdump_ETDump_run_data(etdump), 0);
+    flatbuffers_string_vec_t counter_names =
+        etdump_RunData_counter_names(run_data);
+    ASSERT_EQ(flatbuffers_string_vec_len(counter_names), 2);
+    EXPECT_STREQ(flatbuffers_string_vec_at(counter_names, 0), "fake_a");
+    EXPECT_STREQ(flatbuffers_string_vec_at(counter_names, 1), "fake_b");
+
+    // The inner event ends first, and the outer event spans both of its
+    // reads.
+    const uint64_t expected_deltas[][2] = {{10, 100}, {30, 300}, {10, 100}};
+    etdump_Event_vec_t events = etdump_RunData_events(run_data);
+    ASSERT_EQ(etdump_Event_vec_len(events), 4);
+    for (size_t j = 0; j < 3; j++) {
+      flatbuffers_uint64_vec_t deltas = etdump_ProfileEvent_counter_deltas(
+          etdump_Event_profile_event(etdump_Event_vec_at(events, j)));
+      ASSERT_EQ(flatbuffers_uint64_vec_len(deltas), 2);
+      EXPECT_EQ(flatbuffers_uint64_vec_at(deltas, 0), expected_deltas[j][0]);
+      EXPECT_EQ(flatbuffers_uint64_vec_at(deltas, 1), expected_deltas[j][1]);
+    }
+    EXPECT_EQ(
+        etdump_ProfileEvent_counter_deltas(
+            etdump_Event_profile_event(etdump_Event_vec_at(events, 3))),
+        nullptr);
+
+    if (!etdump_gen[i]->is_static_etdump()) {
+      free(result.buf);
+    }
+  }
+}
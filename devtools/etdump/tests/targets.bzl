@@ -19,3 +19,16 @@ def define_common_targets():
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
         ],
     )
+
+    runtime.cxx_test(
+        name = "etdump_ring_buffer_test",
+        srcs = [
+            "etdump_ring_buffer_test.cpp",
+        ],
+        deps = [
+            "//executorch/devtools/etdump:etdump_flatcc",
+            "//executorch/devtools/etdump:etdump_ring_buffer",
+            "//executorch/devtools/etdump:etdump_schema_flatcc",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
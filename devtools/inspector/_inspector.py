@@ -7,6 +7,7 @@
 # pyre-unsafe
 
 import dataclasses
+import json
 import logging
 import sys
 import warnings
@@ -35,6 +36,7 @@ import pandas as pd
 
 from executorch.devtools.debug_format.et_schema import OperatorGraph, OperatorNode
 from executorch.devtools.etdump.schema_flatcc import (
+    AllocationEvent,
     DebugEvent,
     ETDumpFlatCC,
     ProfileEvent,
@@ -50,10 +52,12 @@ from executorch.devtools.inspector._inspector_utils import (
     find_populated_event,
     FORWARD,
     gen_etdump_object,
+    gen_chrome_trace,
     gen_graphs_from_etrecord,
     inflate_runtime_output,
     is_debug_output,
     is_inference_output_equal,
+    mann_whitney_u_test,
     ProgramOutput,
     RESERVED_FRAMEWORK_EVENT_NAMES,
     TimeScale,
@@ -80,6 +84,7 @@ class InstructionEvent:
     signature: InstructionEventSignature
     profile_events: Optional[List[ProfileEvent]] = None
     debug_events: Optional[List[DebugEvent]] = None
+    allocation_events: Optional[List[AllocationEvent]] = None
 
     @staticmethod
     def gen_from_events(run_events: List[flatcc.Event]) -> List["InstructionEvent"]:
@@ -87,11 +92,19 @@ class InstructionEvent:
         Given a list of events from a run in ETDump, collate the ProfileEvent
         and DebugEvents by instruction id and return a list of InstructionEvents
         constructed from collated events (ignoring run_output events)
+
+        AllocationEvents are attached to the (non delegate) InstructionEvent of
+        the instruction that they were made in, and ignored if there is none
         """
         instruction_events: Dict[InstructionEventSignature, InstructionEvent] = (
             OrderedDict()
         )
+        allocation_events: List[AllocationEvent] = []
         for event in run_events:
+            if event.allocation_event is not None:
+                allocation_events.append(event.allocation_event)
+                continue
+
             # Find the event that was logged
             populated_event: Union[DebugEvent, ProfileEvent] = find_populated_event(
                 event
@@ -121,6 +134,24 @@ class InstructionEvent:
                         instruction_event.debug_events = []
                     instruction_event.debug_events.append(populated_event)
 
+        # Map (chain_index, instruction_id) to the InstructionEvents of the
+        # instructions themselves, not of events logged inside delegates
+        instruction_events_by_id: Dict[Tuple[int, int], InstructionEvent] = {
+            (signature.chain_index, signature.instruction_id): instruction_event
+            for signature, instruction_event in instruction_events.items()
+            if signature.delegate_id in (None, -1) and not signature.delegate_id_str
+        }
+        for allocation_event in allocation_events:
+            instruction_event = instruction_events_by_id.get(
+                (allocation_event.chain_index, allocation_event.instruction_id)
+            )
+            if instruction_event is None:
+                # Older ETDumps, or no profile event to attribute it to
+                continue
+            if instruction_event.allocation_events is None:
+                instruction_event.allocation_events = []
+            instruction_event.allocation_events.append(allocation_event)
+
         return list(instruction_events.values())
 
 
@@ -217,7 +248,8 @@ class EventSignature:
                 )
             ]
 
-        # Generate the ProfileEventSignature
+        # Generate the ProfileEventSignature. The allocations of the instruction
+        # go with its last profile event, which encloses the others
         return [
             (
                 EventSignature(
@@ -227,9 +259,17 @@ class EventSignature:
                     ),
                     debug_event_signature=debug_signature,
                 ),
-                dataclasses.replace(instruction_event, profile_events=[profile_event]),
+                dataclasses.replace(
+                    instruction_event,
+                    profile_events=[profile_event],
+                    allocation_events=(
+                        instruction_event.allocation_events
+                        if i == len(profile_events) - 1
+                        else None
+                    ),
+                ),
             )
-            for profile_event in profile_events
+            for i, profile_event in enumerate(profile_events)
         ]
 
 
@@ -298,6 +338,8 @@ class Event:
     Args:
         name: Name of the profiling `Event`, empty if no profiling event.
         perf_data: Performance data associated with the event retrived from the runtime (available attributes: p10, p50, p90, avg, min and max).
+        counters: A dictionary mapping the name of each hardware performance counter recorded by the runtime (e.g. cycles) to the performance data of its deltas.
+        allocations: A dictionary mapping the name of each memory allocator tracked by the runtime (e.g. temp_allocator) to the bytes that the event allocated from it in each run.
         op_type: List of op types corresponding to the event.
         delegate_debug_identifier: Supplemental identifier used in combination with instruction id.
         debug_handles: Debug handles in the model graph to which this event is correlated.
@@ -318,6 +360,8 @@ class Event:
 
     name: str
     perf_data: Optional[PerfData] = None
+    counters: Dict[str, PerfData] = dataclasses.field(default_factory=dict)
+    allocations: Dict[str, PerfData] = dataclasses.field(default_factory=dict)
     op_types: List[str] = dataclasses.field(default_factory=list)
     delegate_debug_identifier: Optional[Union[int, str]] = None
     debug_handles: Optional[Union[int, Sequence[int]]] = None
@@ -416,6 +460,8 @@ class Event:
         delegate_time_scale_converter: Optional[
             Callable[[Union[int, str], Union[int, float]], Union[int, float]]
         ] = None,
+        counter_names: Optional[List[str]] = None,
+        allocator_names: Optional[List[str]] = None,
     ) -> "Event":
         """
         Given an EventSignature and a list of Events with that signature,
@@ -426,6 +472,8 @@ class Event:
         An optional inverse scale factor can be provided to adjust the event timestamps
         An optional buffer can be provided to inflate etdump references
         An optional delegate_metadata_parser can be provided to parse the delegate metadata
+        An optional list of counter_names names the counter deltas of the profile events
+        An optional list of allocator_names names the allocators of the allocation events
         """
 
         profile_event_signature = signature.profile_event_signature
@@ -441,9 +489,12 @@ class Event:
 
         # Populate fields from profile events
         Event._populate_profiling_related_fields(
-            ret_event, profile_event_signature, events, scale_factor
+            ret_event, profile_event_signature, events, scale_factor, counter_names
         )
 
+        # Populate fields from allocation events
+        Event._populate_allocation_related_fields(ret_event, events, allocator_names)
+
         # Populate fields from debug events
         Event._populate_debugging_related_fields(
             ret_event, debug_event_signature, events, output_buffer
@@ -512,6 +563,7 @@ class Event:
         profile_event_signature: Optional[ProfileEventSignature],
         events: List[InstructionEvent],
         scale_factor: float,
+        counter_names: Optional[List[str]] = None,
     ) -> None:
         """
         Given a partially constructed Event, populate the fields related to
@@ -522,6 +574,7 @@ class Event:
             delegate_debug_identifier
             is_delegated_op
             perf_data
+            counters
             delegate_debug_metadatas
         """
 
@@ -530,6 +583,7 @@ class Event:
 
         # Fill out fields from profile event
         data = []
+        counter_data: Dict[str, List[float]] = defaultdict(list)
         delegate_debug_metadatas = []
         for event in events:
             if (profile_events := event.profile_events) is not None:
@@ -571,6 +625,11 @@ class Event:
                     )
 
                 data.append(scaled_time)
+                if counter_names and profile_event.counter_deltas:
+                    for counter_name, delta in zip(
+                        counter_names, profile_event.counter_deltas
+                    ):
+                        counter_data[counter_name].append(float(delta))
                 delegate_debug_metadatas.append(
                     profile_event.delegate_debug_metadata
                     if profile_event.delegate_debug_metadata
@@ -580,9 +639,54 @@ class Event:
         # Update fields
         if len(data) > 0:
             ret_event.perf_data = PerfData(data)
+        if len(counter_data) > 0:
+            ret_event.counters = {
+                counter_name: PerfData(deltas)
+                for counter_name, deltas in counter_data.items()
+            }
         if any(delegate_debug_metadatas):
             ret_event._delegate_debug_metadatas = delegate_debug_metadatas
 
+    @staticmethod
+    def _populate_allocation_related_fields(
+        ret_event: "Event",
+        events: List[InstructionEvent],
+        allocator_names: Optional[List[str]] = None,
+    ) -> None:
+        """
+        Given a partially constructed Event, populate the fields related to
+        the allocation events
+
+        Fields Updated:
+            allocations
+        """
+
+        allocation_data: Dict[str, List[float]] = defaultdict(list)
+        for event in events:
+            if (allocation_events := event.allocation_events) is None:
+                continue
+
+            # Sum the allocations of each allocator in this run
+            allocated: Dict[str, int] = defaultdict(int)
+            for allocation_event in allocation_events:
+                # Allocator ids start at 1
+                allocator_index = allocation_event.allocator_id - 1
+                allocator_name = (
+                    allocator_names[allocator_index]
+                    if allocator_names is not None
+                    and 0 <= allocator_index < len(allocator_names)
+                    else str(allocation_event.allocator_id)
+                )
+                allocated[allocator_name] += allocation_event.allocation_size
+            for allocator_name, size in allocated.items():
+                allocation_data[allocator_name].append(float(size))
+
+        if len(allocation_data) > 0:
+            ret_event.allocations = {
+                allocator_name: PerfData(sizes)
+                for allocator_name, sizes in allocation_data.items()
+            }
+
     @staticmethod
     def _populate_debugging_related_fields(
         ret_event: "Event",
@@ -690,6 +794,12 @@ class EventBlock:
         Note: Rows that have an event_name = OPERATOR_CALL correspond to the perf of the
             previous operator + framework tax of making said operator call.
 
+        If the runtime recorded hardware performance counters, there is an extra column
+        for each counter, with the average delta of the counter over each Event.
+
+        If the runtime tracked memory allocations, there is an extra column for each
+        allocator, with the most bytes that each Event allocated from it in a run.
+
         Args:
             include_units: Whether headers should include units (default false)
             include_delegate_debug_data: Whether to show the delegate debug data
@@ -731,6 +841,36 @@ class EventBlock:
             if any(not data.empty for data in delegate_data):
                 df = pd.concat([df, pd.DataFrame(delegate_data)], axis=1)
 
+        # Add a column with the average delta of each hardware counter
+        counter_names = dict.fromkeys(
+            counter_name for event in self.events for counter_name in event.counters
+        )
+        for counter_name in counter_names:
+            df[counter_name] = [
+                (
+                    event.counters[counter_name].avg
+                    if counter_name in event.counters
+                    else None
+                )
+                for event in self.events
+            ]
+
+        # Add a column with the peak allocation from each allocator
+        allocator_names = dict.fromkeys(
+            allocator_name
+            for event in self.events
+            for allocator_name in event.allocations
+        )
+        for allocator_name in allocator_names:
+            df[f"{allocator_name} (max bytes)"] = [
+                (
+                    event.allocations[allocator_name].max
+                    if allocator_name in event.allocations
+                    else None
+                )
+                for event in self.events
+            ]
+
         return df
 
     @staticmethod
@@ -766,9 +906,11 @@ class EventBlock:
         class GroupedRunInstances:
             events: OrderedDict[EventSignature, List[InstructionEvent]]
             run_output: ProgramOutput
+            counter_names: List[str]
+            allocator_names: List[str]
 
         run_groups: Mapping[RunSignature, GroupedRunInstances] = defaultdict(
-            lambda: GroupedRunInstances(OrderedDict(), [])
+            lambda: GroupedRunInstances(OrderedDict(), [], [], [])
         )
 
         # Collect all the run data
@@ -823,6 +965,16 @@ class EventBlock:
             else:
                 verify_debug_data_equivalence(existing_run_outputs, run_outputs)
 
+            # Names of the hardware counters recorded in the profile events
+            if run.counter_names and not run_groups[run_signature].counter_names:
+                run_groups[run_signature].counter_names.extend(run.counter_names)
+
+            # Names of the allocators of the allocation events
+            if run.allocators and not run_groups[run_signature].allocator_names:
+                run_groups[run_signature].allocator_names.extend(
+                    allocator.name for allocator in run.allocators
+                )
+
         # Construct the EventBlocks
         event_blocks = []
         scale_factor = calculate_time_scale_factor(source_time_scale, target_time_scale)
@@ -841,6 +993,8 @@ class EventBlock:
                     output_buffer,
                     delegate_metadata_parser,
                     delegate_time_scale_converter,
+                    grouped_run_instance.counter_names,
+                    grouped_run_instance.allocator_names,
                 )
                 for signature, instruction_events in run_group.items()
             ]
@@ -952,6 +1106,39 @@ class EventBlock:
                         event.debug_handles = value
 
 
+def _gen_perf_events_by_key(
+    event_blocks: List[EventBlock],
+) -> "OrderedDict[Tuple[Any, ...], Event]":
+    """
+    Maps the Events with perf data in the given EventBlocks to keys that identify them
+    across ETDumps of versions of a model, for `Inspector.compare_perf_data()`.
+    """
+    events: "OrderedDict[Tuple[Any, ...], Event]" = OrderedDict()
+    occurrences: Dict[Tuple[Any, ...], int] = defaultdict(int)
+    for event_block in event_blocks:
+        for event in event_block.events:
+            if event.perf_data is None or any(
+                excluded in event.name for excluded in EXCLUDED_EVENTS_WHEN_PRINTING
+            ):
+                continue
+            if event.debug_handles is None:
+                debug_handles = ()
+            elif isinstance(event.debug_handles, int):
+                debug_handles = (event.debug_handles,)
+            else:
+                debug_handles = tuple(event.debug_handles)
+            key = (
+                event_block.name,
+                event.name,
+                tuple(event.op_types),
+                event.delegate_backend_name,
+                debug_handles,
+            )
+            events[key + (occurrences[key],)] = event
+            occurrences[key] += 1
+    return events
+
+
 class Inspector:
     """
     APIs for examining model architecture and performance stats.
@@ -1033,6 +1220,8 @@ class Inspector:
 
         # Create EventBlocks from ETDump
         etdump = gen_etdump_object(etdump_path=etdump_path, etdump_data=etdump_data)
+        self._etdump = etdump
+        self._delegate_time_scale_converter = delegate_time_scale_converter
         if debug_buffer_path is not None:
             with open(debug_buffer_path, "rb") as f:
                 output_buffer = f.read()
@@ -1205,6 +1394,140 @@ class Inspector:
         df = self._prepare_dataframe()
         df.to_csv(file, sep="\t")
 
+    def save_chrome_trace(
+        self,
+        file: IO[str],
+    ) -> None:
+        """
+        Stores the profiling events of the ETDump as a timeline in the Chrome trace event
+        format, with a track per runtime thread, to open in Perfetto
+        (https://ui.perfetto.dev) or chrome://tracing.
+
+        Args:
+            file: Which IO stream to write the JSON trace to.
+
+        Returns:
+            None
+        """
+        json.dump(
+            gen_chrome_trace(
+                self._etdump,
+                source_time_scale=self._source_time_scale,
+                target_time_scale=self._target_time_scale,
+                delegate_time_scale_converter=self._delegate_time_scale_converter,
+            ),
+            file,
+        )
+
+    def compare_perf_data(
+        self,
+        other: "Inspector",
+        significance_level: float = 0.05,
+        min_relative_delta: float = 0.05,
+        include_units: bool = True,
+    ) -> pd.DataFrame:
+        """
+        Compares the latencies of the Events of this Inspector (the baseline) with those
+        of another Inspector of the same model, e.g. from an ETDump of a new version of
+        the model or of the runtime, to find the operators and delegate calls that got
+        slower or faster.
+
+        Events are aligned by EventBlock, event name, op types, delegate backend and debug
+        handles (from the ETRecords, if provided), and by order for the Events that share
+        all of these. A change in the median latency of an Event counts only if the latencies
+        of the runs differ significantly by a Mann-Whitney U test, so record enough runs
+        (at least 8) in both ETDumps.
+
+        Args:
+            other: The Inspector to compare with this one.
+            significance_level: The largest p-value at which a change is significant.
+            min_relative_delta: The smallest relative change in the median latency that
+                counts, to ignore changes that are significant but too small to matter.
+            include_units: Whether headers should include units (default true)
+
+        Returns:
+            A pandas DataFrame with a row for each Event, sorted from the largest increase
+            in the median latency to the largest decrease. The is_regression and
+            is_improvement columns flag the significant changes. Events found in only one of the
+            Inspectors are last, without deltas.
+        """
+        if self._target_time_scale != other._target_time_scale:
+            raise ValueError(
+                f"Cannot compare latencies in {self._target_time_scale.value} with latencies in {other._target_time_scale.value}."
+            )
+        units = " (" + self._target_time_scale.value + ")" if include_units else ""
+        base_events = _gen_perf_events_by_key(self.event_blocks)
+        new_events = _gen_perf_events_by_key(other.event_blocks)
+
+        rows = []
+        for key in list(base_events) + [k for k in new_events if k not in base_events]:
+            block_name, name, op_types, delegate_backend_name, debug_handles, _ = key
+            base = base_events.get(key)
+            new = new_events.get(key)
+            base_p50 = base.perf_data.p50 if base is not None else None
+            new_p50 = new.perf_data.p50 if new is not None else None
+            delta = relative_delta = p_value = None
+            is_significant = False
+            if base is not None and new is not None:
+                delta = new_p50 - base_p50
+                relative_delta = delta / base_p50 if base_p50 else None
+                p_value = mann_whitney_u_test(base.perf_data.raw, new.perf_data.raw)
+                is_significant = p_value < significance_level and (
+                    relative_delta is None or abs(relative_delta) >= min_relative_delta
+                )
+            rows.append(
+                {
+                    "event_block_name": block_name,
+                    "event_name": name,
+                    "op_types": list(op_types),
+                    "delegate_backend_name": delegate_backend_name,
+                    "debug_handles": list(debug_handles),
+                    "base_p50" + units: base_p50,
+                    "p50" + units: new_p50,
+                    "delta_p50" + units: delta,
+                    "relative_delta": relative_delta,
+                    "p_value": p_value,
+                    "is_regression": bool(is_significant and delta > 0),
+                    "is_improvement": bool(is_significant and delta < 0),
+                }
+            )
+
+        df = pd.DataFrame(rows)
+        if df.empty:
+            return df
+        df.sort_values(
+            "delta_p50" + units,
+            ascending=False,
+            na_position="last",
+            kind="stable",
+            inplace=True,
+        )
+        df.reset_index(drop=True, inplace=True)
+        return df
+
+    def find_regressions(
+        self,
+        other: "Inspector",
+        top_k: Optional[int] = 10,
+        significance_level: float = 0.05,
+        min_relative_delta: float = 0.05,
+    ) -> pd.DataFrame:
+        """
+        Returns the `top_k` Events (or all of them, if None) of `other` whose latencies
+        regressed the most from those of this Inspector, as rows of `compare_perf_data()`.
+        An empty result means that no Event got significantly slower, so it can gate
+        runtime and model upgrades.
+        """
+        df = self.compare_perf_data(
+            other,
+            significance_level=significance_level,
+            min_relative_delta=min_relative_delta,
+        )
+        if df.empty:
+            return df
+        regressions = df[df["is_regression"]].reset_index(drop=True)
+        return regressions if top_k is None else regressions.head(top_k)
+
     # TODO: write unit test
     def find_total_for_module(self, module_name: str) -> float:
         """
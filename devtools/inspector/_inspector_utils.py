@@ -9,7 +9,18 @@
 import math
 import sys
 from enum import Enum
-from typing import Dict, IO, List, Mapping, Optional, Tuple, TypeAlias, Union
+from typing import (
+    Any,
+    Callable,
+    Dict,
+    IO,
+    List,
+    Mapping,
+    Optional,
+    Tuple,
+    TypeAlias,
+    Union,
+)
 
 import executorch.devtools.etdump.schema_flatcc as flatcc
 
@@ -21,11 +32,13 @@ from executorch.devtools.debug_format.base_schema import OperatorNode
 
 from executorch.devtools.debug_format.et_schema import FXOperatorGraph, OperatorGraph
 from executorch.devtools.etdump.schema_flatcc import (
+    AllocationEvent,
     DebugEvent,
     ETDumpFlatCC,
     ProfileEvent,
     ScalarType,
     Tensor,
+    TensorStats,
     Value,
     ValueType,
 )
@@ -79,9 +92,17 @@ def calculate_time_scale_factor(
     return TIME_SCALE_DICT[source_time_scale] / TIME_SCALE_DICT[target_time_scale]
 
 
-# Model Debug Output
+# Model Debug Output. Tensors that were logged with only their statistics are
+# represented by their TensorStats.
 InferenceOutput: TypeAlias = Union[
-    torch.Tensor, List[torch.Tensor], int, float, str, bool, None
+    torch.Tensor,
+    TensorStats,
+    List[Union[torch.Tensor, TensorStats]],
+    int,
+    float,
+    str,
+    bool,
+    None,
 ]
 ProgramOutput: TypeAlias = List[InferenceOutput]
 
@@ -93,17 +114,20 @@ def is_inference_output_equal(
     if isinstance(output1, torch.Tensor) and isinstance(output2, torch.Tensor):
         return torch.equal(output1, output2)
     elif isinstance(output1, List) and isinstance(output2, List):
-        return all(torch.equal(t1, t2) for t1, t2 in zip(output1, output2))
+        return all(
+            is_inference_output_equal(t1, t2) for t1, t2 in zip(output1, output2)
+        )
     elif output1 == output2:
         return True
     else:
         return False
 
 
-# Given a ETDump Tensor object and offset, extract into a torch.Tensor
+# Given a ETDump Tensor object and offset, extract into a torch.Tensor, or
+# return its TensorStats if only its statistics were logged
 def _parse_tensor_value(
     tensor: Optional[Tensor], output_buffer: Optional[bytes]
-) -> torch.Tensor:
+) -> Union[torch.Tensor, TensorStats]:
     def get_scalar_type_size(scalar_type: ScalarType) -> Tuple[torch.dtype, int]:
         """
         Return the size of the scalar type in bytes
@@ -128,6 +152,9 @@ def _parse_tensor_value(
                 f"Unsupported scalar type in get_scalar_type_size : {scalar_type}"
             )
 
+    if tensor is not None and tensor.stats is not None:
+        return tensor.stats
+
     if tensor is None or tensor.offset is None:
         raise ValueError("Tensor cannot be None")
 
@@ -303,6 +330,203 @@ def gen_etdump_object(
     return deserialize_from_etdump_flatcc(etdump_data)
 
 
+def gen_chrome_trace(
+    etdump: ETDumpFlatCC,
+    source_time_scale: TimeScale = TimeScale.NS,
+    target_time_scale: TimeScale = TimeScale.MS,
+    delegate_time_scale_converter: Optional[
+        Callable[[Union[int, str], Union[int, float]], Union[int, float]]
+    ] = None,
+) -> Dict[str, Any]:
+    """
+    Convert the profile events of an ETDump into the Chrome trace event format, which
+    Perfetto (https://ui.perfetto.dev) and chrome://tracing display as a timeline.
+
+    Each thread that logged events (ProfileEvent.thread_id) gets a track, on which
+    nested events, e.g. the delegate events within a DELEGATE_CALL, are stacked. Each
+    RunData adds a span covering its events on each of those tracks, so that the idle
+    time between runs, operators and delegate partitions shows up as gaps.
+
+    Each allocator of the AllocationEvents gets a counter track of the bytes that are
+    allocated from it, as a memory timeline next to the events. An allocation counts
+    from the start of the instruction that made it to when it was recorded.
+
+    Timestamps are converted to microseconds, the unit of the format, unless they are
+    in cycles. The timestamps of delegate events are converted with
+    delegate_time_scale_converter if provided (whose results are in target_time_scale,
+    as for the Inspector), and are otherwise assumed to be in source_time_scale.
+    """
+    if source_time_scale == TimeScale.CYCLES:
+        scale_factor = delegate_scale_factor = 1.0
+    else:
+        scale_factor = 1 / calculate_time_scale_factor(source_time_scale, TimeScale.US)
+        delegate_scale_factor = 1 / calculate_time_scale_factor(
+            target_time_scale, TimeScale.US
+        )
+
+    run_spans: List[Dict[str, Any]] = []
+    trace_events: List[Dict[str, Any]] = []
+    counter_events: List[Dict[str, Any]] = []
+    for run_index, run in enumerate(etdump.run_data):
+        # The [start, end] of the events of this run on each thread
+        thread_spans: Dict[int, List[float]] = {}
+        # The start of each instruction, by (chain_index, instruction_id)
+        instruction_starts: Dict[Tuple[int, int], float] = {}
+        allocation_events: List[AllocationEvent] = []
+        for event in run.events or []:
+            if event.allocation_event is not None:
+                allocation_events.append(event.allocation_event)
+                continue
+            if (profile_event := event.profile_event) is None:
+                continue
+
+            is_delegated_op = (
+                profile_event.delegate_debug_id_int is not None
+                and profile_event.delegate_debug_id_int != -1
+            ) or bool(profile_event.delegate_debug_id_str)
+            if is_delegated_op:
+                delegate_debug_identifier = (
+                    profile_event.delegate_debug_id_str
+                    or profile_event.delegate_debug_id_int
+                )
+                name = str(delegate_debug_identifier)
+            else:
+                name = profile_event.name or ""
+
+            start_time = profile_event.start_time
+            end_time = profile_event.end_time
+            # Platforms with 32 bit timestamps may wrap around within an event
+            if end_time < start_time:
+                end_time += 2**32
+            if is_delegated_op and delegate_time_scale_converter is not None:
+                start = delegate_time_scale_converter(name, start_time)
+                end = delegate_time_scale_converter(name, end_time)
+                start, end = start * delegate_scale_factor, end * delegate_scale_factor
+            else:
+                start, end = start_time * scale_factor, end_time * scale_factor
+
+            args: Dict[str, Any] = {"instruction_id": profile_event.instruction_id}
+            if is_delegated_op:
+                args["delegate_debug_identifier"] = delegate_debug_identifier
+            if run.counter_names and profile_event.counter_deltas:
+                args.update(zip(run.counter_names, profile_event.counter_deltas))
+
+            thread_id = profile_event.thread_id or 0
+            trace_events.append(
+                {
+                    "name": name,
+                    "cat": "delegate" if is_delegated_op else "runtime",
+                    "ph": "X",
+                    "ts": start,
+                    "dur": end - start,
+                    "pid": 0,
+                    "tid": thread_id,
+                    "args": args,
+                }
+            )
+            span = thread_spans.setdefault(thread_id, [start, end])
+            span[0], span[1] = min(span[0], start), max(span[1], end)
+            if not is_delegated_op:
+                key = (profile_event.chain_index, profile_event.instruction_id)
+                instruction_starts[key] = min(
+                    instruction_starts.get(key, start), start
+                )
+
+        for allocation_event in allocation_events:
+            if allocation_event.time is None:
+                # Older ETDumps do not record when the allocation happened
+                continue
+            allocator_index = allocation_event.allocator_id - 1
+            allocator_name = (
+                run.allocators[allocator_index].name
+                if run.allocators and 0 <= allocator_index < len(run.allocators)
+                else str(allocation_event.allocator_id)
+            )
+            end = allocation_event.time * scale_factor
+            start = instruction_starts.get(
+                (allocation_event.chain_index, allocation_event.instruction_id), end
+            )
+            for ts, size in ((start, allocation_event.allocation_size), (end, 0)):
+                counter_events.append(
+                    {
+                        "name": allocator_name,
+                        "cat": "memory",
+                        "ph": "C",
+                        "ts": ts,
+                        "pid": 0,
+                        "args": {"bytes": size},
+                    }
+                )
+
+        for thread_id, (start, end) in thread_spans.items():
+            run_spans.append(
+                {
+                    "name": run.name,
+                    "cat": "run",
+                    "ph": "X",
+                    "ts": start,
+                    "dur": end - start,
+                    "pid": 0,
+                    "tid": thread_id,
+                    "args": {
+                        "run_index": run_index,
+                        "bundled_input_index": run.bundled_input_index,
+                    },
+                }
+            )
+
+    # Order the events of each thread by start time, outer events first. Runs come
+    # before the events that they span, because the sort is stable.
+    events = sorted(
+        run_spans + trace_events, key=lambda e: (e["tid"], e["ts"], -e["dur"])
+    )
+    metadata: List[Dict[str, Any]] = [
+        {"name": "process_name", "ph": "M", "pid": 0, "args": {"name": "ExecuTorch"}}
+    ]
+    for thread_id in sorted({e["tid"] for e in events}):
+        metadata.append(
+            {
+                "name": "thread_name",
+                "ph": "M",
+                "pid": 0,
+                "tid": thread_id,
+                "args": {"name": f"Thread {thread_id}"},
+            }
+        )
+    counter_events.sort(key=lambda e: e["ts"])
+    return {"traceEvents": metadata + events + counter_events}
+
+
+def mann_whitney_u_test(base: List[float], new: List[float]) -> float:
+    """
+    Two-sided Mann-Whitney U test of whether the samples in `new` tend to be larger
+    or smaller than those in `base`, e.g. the latencies of an operator in each run of
+    two builds of a model. Unlike a t-test, it doesn't assume that latencies are
+    normally distributed, and a few outliers (preemptions, cold caches) don't skew it.
+
+    Uses the normal approximation of U with tie and continuity corrections, which is
+    accurate from about 8 samples on each side.
+
+    Returns:
+        The p-value: the probability of a difference at least this large between the
+        samples if both came from the same distribution.
+    """
+    n1, n2 = len(base), len(new)
+    if n1 == 0 or n2 == 0:
+        return 1.0
+    ranks = pd.Series(list(base) + list(new)).rank()
+    u = ranks[n1:].sum() - n2 * (n2 + 1) / 2
+    n = n1 + n2
+    tie_counts = ranks.value_counts()
+    tie_term = (tie_counts**3 - tie_counts).sum() / (n * (n - 1))
+    variance = n1 * n2 / 12 * ((n + 1) - tie_term)
+    if variance <= 0:
+        # All the samples are equal.
+        return 1.0
+    z = max(abs(u - n1 * n2 / 2) - 0.5, 0) / math.sqrt(variance)
+    return math.erfc(z / math.sqrt(2))
+
+
 def display_or_print_df(df: pd.DataFrame, file: IO[str] = sys.stdout):
     try:
         from IPython import get_ipython
@@ -7,9 +7,11 @@
 # pyre-unsafe
 
 import argparse
+import sys
 
 from executorch.devtools import Inspector
 from executorch.devtools.inspector import compare_results, TimeScale
+from executorch.devtools.inspector._inspector_utils import display_or_print_df
 
 
 def main() -> None:
@@ -48,7 +50,27 @@ def main() -> None:
         required=False,
         help="Provide an optional tsv file path.",
     )
+    parser.add_argument(
+        "--chrome_trace_path",
+        required=False,
+        help="Provide an optional path to write a Chrome trace (Perfetto) timeline to.",
+    )
     parser.add_argument("--compare_results", action="store_true")
+    parser.add_argument(
+        "--baseline_etdump_path",
+        required=False,
+        help="Provide an optional ETDump file path of a baseline run, e.g. of the previous version of the model or runtime, to print the events whose latencies regressed from it.",
+    )
+    parser.add_argument(
+        "--baseline_etrecord_path",
+        required=False,
+        help="Provide an optional ETRecord file path for the baseline ETDump.",
+    )
+    parser.add_argument(
+        "--fail_on_regression",
+        action="store_true",
+        help="Exit with an error if any event regressed from the baseline.",
+    )
 
     args = parser.parse_args()
 
@@ -62,6 +84,9 @@ def main() -> None:
     inspector.print_data_tabular()
     if args.tsv_path:
         inspector.save_data_to_tsv(args.tsv_path)
+    if args.chrome_trace_path:
+        with open(args.chrome_trace_path, "w") as f:
+            inspector.save_chrome_trace(f)
     if args.compare_results:
         for event_block in inspector.event_blocks:
             if event_block.name == "Execute":
@@ -70,6 +95,21 @@ def main() -> None:
                     run_output=event_block.run_output,
                     plot=True,
                 )
+    if args.baseline_etdump_path:
+        baseline = Inspector(
+            etdump_path=args.baseline_etdump_path,
+            etrecord=args.baseline_etrecord_path,
+            source_time_scale=TimeScale(args.source_time_scale),
+            target_time_scale=TimeScale(args.target_time_scale),
+        )
+        regressions = baseline.find_regressions(inspector)
+        if regressions.empty:
+            print("No regressions from the baseline.")
+        else:
+            print("Regressions from the baseline:")
+            display_or_print_df(regressions)
+            if args.fail_on_regression:
+                sys.exit(1)
 
 
 if __name__ == "__main__":
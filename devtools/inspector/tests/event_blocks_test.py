@@ -397,6 +397,114 @@ class TestEventBlock(unittest.TestCase):
         self.assertEqual(len(blocks[1].events[0].debug_data), 1)
         self.assertEqual(len(blocks[1].events[1].debug_data), 0)
 
+    def test_gen_from_etdump_counters(self) -> None:
+        """
+        Test that the hardware counter deltas of the profile events are collected
+        into Event.counters, named by the counter names of the RunData
+        """
+        run_data = []
+        for deltas in ([100, 7], [300, 9]):
+            profile_event = TestEventBlock._gen_sample_profile_event(
+                name="profile_1", instruction_id=1, time=(0, 1)
+            )
+            profile_event.counter_deltas = deltas
+            run_data.append(
+                flatcc.RunData(
+                    name="signature_a",
+                    bundled_input_index=-1,
+                    allocators=[],
+                    events=[
+                        flatcc.Event(
+                            allocation_event=None,
+                            debug_event=None,
+                            profile_event=profile_event,
+                        )
+                    ],
+                    counter_names=["cycles", "llc_misses"],
+                )
+            )
+        blocks: List[EventBlock] = EventBlock._gen_from_etdump(
+            ETDumpFlatCC(version=0, run_data=run_data)
+        )
+
+        self.assertEqual(len(blocks), 1)
+        counters = blocks[0].events[0].counters
+        self.assertEqual(list(counters.keys()), ["cycles", "llc_misses"])
+        self.assertEqual(counters["cycles"].raw, [100.0, 300.0])
+        self.assertEqual(counters["llc_misses"].avg, 8.0)
+
+        df = blocks[0].to_dataframe()
+        self.assertEqual(df["cycles"][0], 200.0)
+        self.assertEqual(df["llc_misses"][0], 8.0)
+
+    def test_gen_from_etdump_allocations(self) -> None:
+        """
+        Test that the allocation events of an instruction are collected into
+        Event.allocations of its last profile event, named by the allocators
+        of the RunData
+        """
+        run_data = []
+        for size in (64, 192):
+            events = [
+                flatcc.Event(
+                    allocation_event=None,
+                    debug_event=None,
+                    profile_event=TestEventBlock._gen_sample_profile_event(
+                        name=name, instruction_id=1, time=(0, 1)
+                    ),
+                )
+                for name in ("profile_1", "profile_2")
+            ]
+            events += [
+                flatcc.Event(
+                    allocation_event=flatcc.AllocationEvent(
+                        allocator_id=2,
+                        allocation_size=size,
+                        chain_index=0,
+                        instruction_id=1,
+                        time=1,
+                    ),
+                    debug_event=None,
+                    profile_event=None,
+                ),
+                # Not made during an instruction
+                flatcc.Event(
+                    allocation_event=flatcc.AllocationEvent(
+                        allocator_id=1,
+                        allocation_size=8,
+                        chain_index=-1,
+                        instruction_id=0,
+                        time=2,
+                    ),
+                    debug_event=None,
+                    profile_event=None,
+                ),
+            ]
+            run_data.append(
+                flatcc.RunData(
+                    name="signature_a",
+                    bundled_input_index=-1,
+                    allocators=[
+                        flatcc.Allocator(name="method_allocator"),
+                        flatcc.Allocator(name="temp_allocator"),
+                    ],
+                    events=events,
+                )
+            )
+        blocks: List[EventBlock] = EventBlock._gen_from_etdump(
+            ETDumpFlatCC(version=0, run_data=run_data)
+        )
+
+        self.assertEqual(len(blocks), 1)
+        self.assertEqual(len(blocks[0].events), 2)
+        self.assertEqual(blocks[0].events[0].allocations, {})
+        allocations = blocks[0].events[1].allocations
+        self.assertEqual(list(allocations.keys()), ["temp_allocator"])
+        self.assertEqual(allocations["temp_allocator"].raw, [64.0, 192.0])
+
+        df = blocks[0].to_dataframe()
+        self.assertEqual(df["temp_allocator (max bytes)"][1], 192.0)
+
     def test_gen_from_etdump_inconsistent_debug_data(self) -> None:
         """
         Make sure AssertionError is thrown when intermediate outputs are different across
@@ -16,6 +16,8 @@ from typing import Callable, List
 
 from unittest.mock import patch
 
+import pandas as pd
+
 from executorch.devtools import generate_etrecord, parse_etrecord
 from executorch.devtools.debug_format.et_schema import OperatorNode
 from executorch.devtools.etdump.schema_flatcc import ProfileEvent
@@ -314,6 +316,83 @@ class TestInspector(unittest.TestCase):
                     )
                 )
 
+    def test_inspector_compare_perf_data(self):
+        # Create a context manager to patch functions called by Inspector.__init__
+        with patch.object(
+            _inspector, "parse_etrecord", return_value=None
+        ), patch.object(
+            _inspector, "gen_etdump_object", return_value=None
+        ), patch.object(
+            EventBlock, "_gen_from_etdump"
+        ):
+            base = Inspector(etdump_path=ETDUMP_PATH)
+            new = Inspector(etdump_path=ETDUMP_PATH)
+            in_us = Inspector(etdump_path=ETDUMP_PATH, target_time_scale=TimeScale.US)
+
+        def event(name, raw, debug_handles=None) -> Event:
+            return Event(
+                name=name,
+                op_types=[OP_TYPE],
+                perf_data=PerfData(raw),
+                debug_handles=debug_handles,
+            )
+
+        base_raw = [10.0 + 0.1 * i for i in range(RAW_DATA_SIZE)]
+        slower_raw = [12.0 + 0.1 * i for i in range(RAW_DATA_SIZE)]
+        faster_raw = [8.0 + 0.1 * i for i in range(RAW_DATA_SIZE)]
+        noisy_raw = [10.05 + 0.1 * i for i in range(RAW_DATA_SIZE)]
+        base.event_blocks = [
+            EventBlock(
+                name=EVENT_BLOCK_NAME,
+                events=[
+                    event("op_0", base_raw, 0),
+                    # The second occurrence of an event with the same key.
+                    event("op_0", base_raw, 0),
+                    event("op_1", base_raw, 1),
+                    event("op_2", base_raw, 2),
+                    event("OPERATOR_CALL", base_raw),
+                    event("removed", base_raw),
+                ],
+            )
+        ]
+        new.event_blocks = [
+            EventBlock(
+                name=EVENT_BLOCK_NAME,
+                events=[
+                    event("op_0", base_raw, 0),
+                    event("op_0", slower_raw, 0),
+                    event("op_1", faster_raw, 1),
+                    event("op_2", noisy_raw, 2),
+                    event("OPERATOR_CALL", slower_raw),
+                    event("added", base_raw),
+                ],
+            )
+        ]
+
+        df = base.compare_perf_data(new)
+        self.assertEqual(
+            list(df["event_name"]), ["op_0", "op_2", "op_0", "op_1", "removed", "added"]
+        )
+        self.assertEqual(list(df["is_regression"]), [True] + [False] * 5)
+        self.assertEqual(
+            list(df["is_improvement"]), [False, False, False, True, False, False]
+        )
+        self.assertAlmostEqual(df["delta_p50 (ms)"][0], 2.0)
+        self.assertAlmostEqual(df["relative_delta"][3], -2.0 / 10.45)
+        self.assertTrue(pd.isna(df["p50 (ms)"][4]))
+        self.assertTrue(pd.isna(df["base_p50 (ms)"][5]))
+
+        regressions = base.find_regressions(new)
+        self.assertEqual(len(regressions), 1)
+        self.assertEqual(regressions["debug_handles"][0], [0])
+        # Compared the other way around, op_1 regressed.
+        self.assertEqual(
+            list(new.find_regressions(base, top_k=None)["event_name"]), ["op_1"]
+        )
+
+        with self.assertRaises(ValueError):
+            base.compare_perf_data(in_us)
+
     def test_populate_debugging_related_fields_raises_for_inconsistent_events(self):
         ret_event: Event = Event(
             name="event",
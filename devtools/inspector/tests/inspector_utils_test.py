@@ -32,8 +32,11 @@ from executorch.devtools.inspector._inspector_utils import (
     create_debug_handle_to_op_node_mapping,
     EDGE_DIALECT_GRAPH_KEY,
     find_populated_event,
+    gen_chrome_trace,
     gen_graphs_from_etrecord,
+    inflate_runtime_output,
     is_inference_output_equal,
+    mann_whitney_u_test,
     TimeScale,
 )
 
@@ -178,6 +181,33 @@ class TestInspectorUtils(unittest.TestCase):
             )
         )
 
+    def test_inflate_runtime_output_returns_tensor_stats(self):
+        stats = flatcc.TensorStats(min=-1.0, max=2.0, mean=0.5, nan_count=1)
+        value = flatcc.Value(
+            val=flatcc.ValueType.TENSOR_LIST.value,
+            tensor=None,
+            tensor_list=flatcc.TensorList(
+                tensors=[
+                    flatcc.Tensor(
+                        scalar_type=flatcc.ScalarType.FLOAT,
+                        sizes=[4],
+                        strides=[1],
+                        offset=-1,
+                        stats=stats,
+                    )
+                ]
+            ),
+            int_value=None,
+            float_value=None,
+            double_value=None,
+            bool_value=None,
+            output=None,
+        )
+        # Tensors logged with only their statistics need no debug buffer.
+        output = inflate_runtime_output(value, None)
+        self.assertEqual(output, [stats])
+        self.assertTrue(is_inference_output_equal(output, [stats]))
+
     def test_calculate_time_scale_factor_second_based(self):
         self.assertEqual(
             calculate_time_scale_factor(TimeScale.NS, TimeScale.MS), 1000000
@@ -191,6 +221,99 @@ class TestInspectorUtils(unittest.TestCase):
             calculate_time_scale_factor(TimeScale.CYCLES, TimeScale.CYCLES), 1
         )
 
+    def test_mann_whitney_u_test(self):
+        # Two-sided p-value of the normal approximation with continuity correction.
+        self.assertAlmostEqual(
+            mann_whitney_u_test(list(range(1, 11)), list(range(11, 21))),
+            0.000183,
+            places=6,
+        )
+        # Interleaved samples don't differ significantly.
+        self.assertGreater(
+            mann_whitney_u_test(
+                [1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0],
+                [1.1, 2.1, 3.1, 4.1, 5.1, 6.1, 7.1, 8.1],
+            ),
+            0.5,
+        )
+        self.assertEqual(mann_whitney_u_test([1.0, 1.0], [1.0, 1.0, 1.0]), 1.0)
+        self.assertEqual(mann_whitney_u_test([], [1.0]), 1.0)
+
+    def test_gen_chrome_trace(self):
+        def profile_event(
+            name, start_time, end_time, thread_id, delegate_debug_id_int=-1
+        ):
+            return flatcc.Event(
+                profile_event=flatcc.ProfileEvent(
+                    name=name,
+                    chain_index=0,
+                    instruction_id=1,
+                    delegate_debug_id_int=delegate_debug_id_int,
+                    delegate_debug_id_str="",
+                    delegate_debug_metadata=None,
+                    start_time=start_time,
+                    end_time=end_time,
+                    counter_deltas=[1234],
+                    thread_id=thread_id,
+                ),
+                allocation_event=None,
+                debug_event=None,
+            )
+
+        etdump = flatcc.ETDumpFlatCC(
+            version=0,
+            run_data=[
+                flatcc.RunData(
+                    name="Execute",
+                    bundled_input_index=-1,
+                    allocators=[flatcc.Allocator(name="temp_allocator")],
+                    events=[
+                        profile_event("DELEGATE_CALL", 1000, 5000, 0),
+                        profile_event(None, 2000, 3000, 0, delegate_debug_id_int=7),
+                        profile_event("worker_task", 1500, 2500, 1),
+                        flatcc.Event(
+                            profile_event=None,
+                            allocation_event=flatcc.AllocationEvent(
+                                allocator_id=1,
+                                allocation_size=256,
+                                chain_index=0,
+                                instruction_id=1,
+                                time=5500,
+                            ),
+                            debug_event=None,
+                        ),
+                    ],
+                    counter_names=["cycles"],
+                )
+            ],
+        )
+        trace = gen_chrome_trace(etdump, source_time_scale=TimeScale.NS)
+
+        events = [e for e in trace["traceEvents"] if e["ph"] == "X"]
+        thread_names = [e for e in trace["traceEvents"] if e["name"] == "thread_name"]
+        self.assertEqual(len(thread_names), 2)
+        # A run span per thread, followed by the events of the thread in order.
+        self.assertEqual(
+            [(e["name"], e["tid"], e["ts"], e["dur"]) for e in events],
+            [
+                ("Execute", 0, 1.0, 4.0),
+                ("DELEGATE_CALL", 0, 1.0, 4.0),
+                ("7", 0, 2.0, 1.0),
+                ("Execute", 1, 1.5, 1.0),
+                ("worker_task", 1, 1.5, 1.0),
+            ],
+        )
+        self.assertEqual(events[2]["cat"], "delegate")
+        self.assertEqual(events[2]["args"]["delegate_debug_identifier"], 7)
+        self.assertEqual(events[1]["args"]["cycles"], 1234)
+
+        # The allocation spans from the start of its instruction to when it was made.
+        counters = [e for e in trace["traceEvents"] if e["ph"] == "C"]
+        self.assertEqual(
+            [(e["name"], e["ts"], e["args"]["bytes"]) for e in counters],
+            [("temp_allocator", 1.0, 256), ("temp_allocator", 5.5, 0)],
+        )
+
     def test_compare_results(self):
         a = torch.rand(4, 4)
 
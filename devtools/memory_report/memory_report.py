@@ -0,0 +1,354 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""
+Reports how a method's memory-planned buffers are used over the course of its
+instructions: where each planned tensor lives, how many bytes are live at each
+instruction, and the peak usage of each buffer. Optionally joins the
+per-instruction timings from an ETDump, to show which instructions run while
+memory pressure is highest.
+
+The lifetimes use the same global instruction indices as
+MethodMeta::memory_planned_tensors() in the runtime, which for single-chain
+methods are also the instruction ids recorded in ETDump.
+"""
+
+import argparse
+import dataclasses
+import json
+from collections import defaultdict
+from typing import Any, Dict, List, Optional
+
+import torch
+from executorch.exir._serialize._program import deserialize_pte_binary
+from executorch.exir.schema import (
+    DelegateCall,
+    ExecutionPlan,
+    FreeCall,
+    JumpFalseCall,
+    KernelCall,
+    MoveCall,
+    OptionalTensorList,
+    Program,
+    Tensor,
+    TensorList,
+)
+from executorch.exir.tensor import get_scalar_type
+
+
+@dataclasses.dataclass
+class PlannedTensor:
+    """
+    A memory-planned tensor and its lifetime.
+
+    Args:
+        value_index: Index of the tensor in the execution plan's values.
+        mem_id: The memory-planned buffer that holds the tensor.
+        offset: Byte offset of the tensor's data in the buffer.
+        nbytes: Size of the tensor's data, or its upper bound for dynamic shapes.
+        first_use: Index of the first instruction that uses the tensor, or -1.
+        last_use: Index of the last instruction that uses the tensor, or -1.
+    """
+
+    value_index: int
+    mem_id: int
+    offset: int
+    nbytes: int
+    first_use: int = -1
+    last_use: int = -1
+
+
+@dataclasses.dataclass
+class InstructionUsage:
+    """
+    The planned memory that is live while an instruction runs.
+
+    Args:
+        instruction_index: Global index of the instruction.
+        name: Operator name, delegate id, or instruction kind.
+        live_bytes: Live bytes per mem_id.
+        avg_time_ms: Average runtime from ETDump, if timings were provided.
+    """
+
+    instruction_index: int
+    name: str
+    live_bytes: Dict[int, int]
+    avg_time_ms: Optional[float] = None
+
+
+@dataclasses.dataclass
+class ArenaReport:
+    """
+    Usage summary of one memory-planned buffer.
+
+    Args:
+        mem_id: The id of the buffer, as used in AllocationDetails.
+        size: The planned size of the buffer in bytes.
+        peak_live_bytes: The largest number of bytes live at any instruction.
+        peak_instruction: The first instruction at which the peak is reached.
+    """
+
+    mem_id: int
+    size: int
+    peak_live_bytes: int
+    peak_instruction: int
+
+    @property
+    def fragmentation(self) -> float:
+        """The fraction of the buffer that is never live at the peak."""
+        if self.size == 0:
+            return 0.0
+        return 1.0 - self.peak_live_bytes / self.size
+
+
+@dataclasses.dataclass
+class MemoryReport:
+    plan_name: str
+    tensors: List[PlannedTensor]
+    arenas: List[ArenaReport]
+    instructions: List[InstructionUsage]
+
+    def to_dict(self) -> Dict[str, Any]:
+        return {
+            "plan_name": self.plan_name,
+            "tensors": [dataclasses.asdict(t) for t in self.tensors],
+            "arenas": [
+                {**dataclasses.asdict(a), "fragmentation": a.fragmentation}
+                for a in self.arenas
+            ],
+            "instructions": [dataclasses.asdict(i) for i in self.instructions],
+        }
+
+
+def _tensor_nbytes(tensor: Tensor) -> int:
+    element_size = torch.empty(
+        0, dtype=get_scalar_type(tensor.scalar_type)
+    ).element_size()
+    numel = 1
+    for size in tensor.sizes:
+        numel *= size
+    return numel * element_size
+
+
+def _instruction_args(instr_args: Any) -> List[int]:
+    if isinstance(instr_args, (KernelCall, DelegateCall)):
+        return list(instr_args.args)
+    if isinstance(instr_args, MoveCall):
+        return [instr_args.move_from, instr_args.move_to]
+    if isinstance(instr_args, JumpFalseCall):
+        return [instr_args.cond_value_index]
+    if isinstance(instr_args, FreeCall):
+        return [instr_args.value_index]
+    return []
+
+
+def _instruction_name(plan: ExecutionPlan, instr_args: Any) -> str:
+    if isinstance(instr_args, KernelCall):
+        op = plan.operators[instr_args.op_index]
+        return f"{op.name}.{op.overload}" if op.overload else op.name
+    if isinstance(instr_args, DelegateCall):
+        return f"DELEGATE_CALL {plan.delegates[instr_args.delegate_index].id}"
+    return type(instr_args).__name__
+
+
+def get_planned_tensors(plan: ExecutionPlan) -> List[PlannedTensor]:
+    """
+    Returns the memory-planned tensors of `plan` in value order, with the
+    instructions that use them.
+    """
+    tensors: Dict[int, PlannedTensor] = {}
+    for i, value in enumerate(plan.values):
+        tensor = value.val
+        if not isinstance(tensor, Tensor) or tensor.allocation_info is None:
+            continue
+        tensors[i] = PlannedTensor(
+            value_index=i,
+            mem_id=tensor.allocation_info.memory_id,
+            offset=tensor.allocation_info.memory_offset,
+            nbytes=_tensor_nbytes(tensor),
+        )
+
+    def record_use(value_index: int, instruction_index: int) -> None:
+        indices = [value_index]
+        val = plan.values[value_index].val
+        if isinstance(val, (TensorList, OptionalTensorList)):
+            indices.extend(val.items)
+        for index in indices:
+            if (tensor := tensors.get(index)) is None:
+                continue
+            if tensor.first_use < 0:
+                tensor.first_use = instruction_index
+            tensor.last_use = instruction_index
+
+    instruction_index = 0
+    for chain in plan.chains:
+        for instruction in chain.instructions:
+            for arg in _instruction_args(instruction.instr_args):
+                record_use(arg, instruction_index)
+            instruction_index += 1
+
+    return [tensors[i] for i in sorted(tensors)]
+
+
+def get_instruction_timings(inspector: Any) -> Dict[int, float]:
+    """
+    Returns the average runtime in ms of each instruction recorded by an
+    `executorch.devtools.Inspector`, keyed by instruction id. Delegated events
+    are summed into the delegate call that produced them, unless the call
+    itself was profiled.
+    """
+    timings: Dict[int, float] = {}
+    delegated: Dict[int, float] = defaultdict(float)
+    for event_block in inspector.event_blocks:
+        for event in event_block.events:
+            if event._instruction_id is None or event.perf_data is None:
+                continue
+            if event.is_delegated_op:
+                delegated[event._instruction_id] += event.perf_data.avg
+            else:
+                timings[event._instruction_id] = event.perf_data.avg
+    for instruction_id, avg in delegated.items():
+        timings.setdefault(instruction_id, avg)
+    return timings
+
+
+def generate_memory_report(
+    plan: ExecutionPlan,
+    instruction_timings: Optional[Dict[int, float]] = None,
+) -> MemoryReport:
+    """
+    Builds the memory report of `plan`.
+
+    Method inputs are treated as live from the first instruction, and outputs
+    as live until the last one, since the caller owns them across the whole
+    execution.
+    """
+    tensors = get_planned_tensors(plan)
+    instructions = [
+        instruction for chain in plan.chains for instruction in chain.instructions
+    ]
+    last_index = max(len(instructions) - 1, 0)
+    inputs = set(plan.inputs)
+    outputs = set(plan.outputs)
+
+    usage = [
+        InstructionUsage(
+            instruction_index=i,
+            name=_instruction_name(plan, instruction.instr_args),
+            live_bytes=defaultdict(int),
+            avg_time_ms=(instruction_timings or {}).get(i),
+        )
+        for i, instruction in enumerate(instructions)
+    ]
+    for tensor in tensors:
+        begin = 0 if tensor.value_index in inputs else tensor.first_use
+        end = last_index if tensor.value_index in outputs else tensor.last_use
+        if begin < 0 or end < 0:
+            continue
+        for i in range(begin, min(end, len(usage) - 1) + 1):
+            usage[i].live_bytes[tensor.mem_id] += tensor.nbytes
+    for entry in usage:
+        entry.live_bytes = dict(entry.live_bytes)
+
+    arenas = []
+    # Memory id 0 is reserved, so non_const_buffer_sizes[0] is always 0.
+    for mem_id, size in enumerate(plan.non_const_buffer_sizes):
+        if mem_id == 0:
+            continue
+        peak_live_bytes = 0
+        peak_instruction = -1
+        for entry in usage:
+            live = entry.live_bytes.get(mem_id, 0)
+            if live > peak_live_bytes:
+                peak_live_bytes = live
+                peak_instruction = entry.instruction_index
+        arenas.append(
+            ArenaReport(
+                mem_id=mem_id,
+                size=size,
+                peak_live_bytes=peak_live_bytes,
+                peak_instruction=peak_instruction,
+            )
+        )
+
+    return MemoryReport(
+        plan_name=plan.name,
+        tensors=tensors,
+        arenas=arenas,
+        instructions=usage,
+    )
+
+
+def generate_program_memory_report(
+    program: Program,
+    instruction_timings: Optional[Dict[str, Dict[int, float]]] = None,
+) -> List[MemoryReport]:
+    """
+    Builds the memory reports of all execution plans in `program`.
+    `instruction_timings` maps plan names to per-instruction timings.
+    """
+    return [
+        generate_memory_report(
+            plan, (instruction_timings or {}).get(plan.name)
+        )
+        for plan in program.execution_plan
+    ]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument(
+        "--pte_path",
+        required=True,
+        help="The path to the .pte file to generate the memory report for",
+    )
+
+    parser.add_argument(
+        "--etdump_path",
+        default=None,
+        help="Optional path to an ETDump of the 'forward' method, to include per-instruction timings",
+    )
+
+    parser.add_argument(
+        "--etrecord_path",
+        default=None,
+        help="Optional path to the ETRecord matching the ETDump",
+    )
+
+    parser.add_argument(
+        "--output_path",
+        default="memory_report.json",
+        help="The output path for the memory report as a json file",
+    )
+
+    args = parser.parse_args()
+    return args
+
+
+def main():
+    args = parse_args()
+
+    with open(args.pte_path, "rb") as f:
+        program = deserialize_pte_binary(f.read())
+
+    instruction_timings = None
+    if args.etdump_path is not None:
+        from executorch.devtools import Inspector
+
+        inspector = Inspector(
+            etdump_path=args.etdump_path, etrecord=args.etrecord_path
+        )
+        instruction_timings = {"forward": get_instruction_timings(inspector)}
+
+    reports = generate_program_memory_report(program, instruction_timings)
+
+    with open(args.output_path, "w") as f:
+        f.write(json.dumps([report.to_dict() for report in reports]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,129 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import unittest
+from types import SimpleNamespace
+
+from executorch.devtools.memory_report.memory_report import (
+    generate_memory_report,
+    get_instruction_timings,
+    get_planned_tensors,
+)
+from executorch.exir.scalar_type import ScalarType
+from executorch.exir.schema import (
+    AllocationDetails,
+    Chain,
+    ContainerMetadata,
+    EValue,
+    ExecutionPlan,
+    Instruction,
+    KernelCall,
+    Operator,
+    Tensor,
+    TensorShapeDynamism,
+)
+
+
+def _planned_tensor(offset: int) -> EValue:
+    # A 2x2 float tensor, 16 bytes.
+    return EValue(
+        val=Tensor(
+            scalar_type=ScalarType.FLOAT,
+            storage_offset=0,
+            sizes=[2, 2],
+            dim_order=[0, 1],
+            requires_grad=False,
+            layout=0,
+            data_buffer_idx=0,
+            allocation_info=AllocationDetails(
+                memory_id=1, memory_offset_low=offset, memory_offset_high=0
+            ),
+            shape_dynamism=TensorShapeDynamism.STATIC,
+        )
+    )
+
+
+def _relu_plan() -> ExecutionPlan:
+    # out = relu(relu(x)), where the output reuses the input's slot.
+    return ExecutionPlan(
+        name="forward",
+        container_meta_type=ContainerMetadata("", ""),
+        values=[_planned_tensor(0), _planned_tensor(16), _planned_tensor(32)],
+        inputs=[0],
+        outputs=[2],
+        chains=[
+            Chain(
+                inputs=[0],
+                outputs=[2],
+                instructions=[
+                    Instruction(KernelCall(op_index=0, args=[0, 1])),
+                    Instruction(KernelCall(op_index=0, args=[1, 2])),
+                ],
+                stacktrace=None,
+            )
+        ],
+        operators=[Operator(name="aten::relu", overload="out")],
+        delegates=[],
+        non_const_buffer_sizes=[0, 64],
+    )
+
+
+class MemoryReportTest(unittest.TestCase):
+    def test_planned_tensors(self) -> None:
+        tensors = get_planned_tensors(_relu_plan())
+
+        self.assertEqual([t.value_index for t in tensors], [0, 1, 2])
+        self.assertEqual([t.offset for t in tensors], [0, 16, 32])
+        self.assertTrue(all(t.mem_id == 1 and t.nbytes == 16 for t in tensors))
+        self.assertEqual(
+            [(t.first_use, t.last_use) for t in tensors], [(0, 0), (0, 1), (1, 1)]
+        )
+
+    def test_memory_report(self) -> None:
+        report = generate_memory_report(_relu_plan(), {1: 0.5})
+
+        self.assertEqual(
+            [i.name for i in report.instructions], ["aten::relu.out"] * 2
+        )
+        self.assertEqual(
+            [i.live_bytes for i in report.instructions], [{1: 32}, {1: 32}]
+        )
+        self.assertEqual(
+            [i.avg_time_ms for i in report.instructions], [None, 0.5]
+        )
+
+        self.assertEqual(len(report.arenas), 1)
+        arena = report.arenas[0]
+        self.assertEqual(arena.mem_id, 1)
+        self.assertEqual(arena.size, 64)
+        self.assertEqual(arena.peak_live_bytes, 32)
+        self.assertEqual(arena.peak_instruction, 0)
+        self.assertAlmostEqual(arena.fragmentation, 0.5)
+
+        # Serializable to json.
+        self.assertEqual(report.to_dict()["arenas"][0]["fragmentation"], 0.5)
+
+    def test_instruction_timings(self) -> None:
+        def event(instruction_id, avg, delegated=False):
+            return SimpleNamespace(
+                _instruction_id=instruction_id,
+                perf_data=SimpleNamespace(avg=avg),
+                is_delegated_op=delegated,
+            )
+
+        inspector = SimpleNamespace(
+            event_blocks=[
+                SimpleNamespace(
+                    events=[
+                        event(None, 10.0),
+                        event(0, 1.0),
+                        event(1, 2.0, delegated=True),
+                        event(1, 3.0, delegated=True),
+                    ]
+                )
+            ]
+        )
+        self.assertEqual(get_instruction_timings(inspector), {0: 1.0, 1: 5.0})
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * This tool benchmarks a method of a BundledProgram (`.bpte`) file with the
+ * inputs of one of its testsets. It runs a number of warmup iterations
+ * followed by a number of timed iterations, and reports the latency
+ * statistics, the peak resident set size of the process and the memory that
+ * the method needs.
+ *
+ * The results are written as a JSON list of metrics in the format of the
+ * benchmark_results.json of the Android and Apple benchmark apps in
+ * extension/benchmark, so that the same tooling can consume them.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#endif
+#if defined(__linux__)
+#include <sys/sysinfo.h>
+#endif
+
+#include <executorch/devtools/bundled_program/bundled_program.h>
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/executor/method.h>
+#include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/runtime.h>
+
+static std::array<uint8_t, 4 * 1024U * 1024U> method_allocator_pool; // 4MB
+
+DEFINE_string(
+    bundled_program_path,
+    "model_bundled.bpte",
+    "Model serialized in flatbuffer format.");
+
+DEFINE_string(
+    method_name,
+    "",
+    "Name of the method to benchmark. Defaults to the first method.");
+
+DEFINE_int32(
+    testset_idx,
+    0,
+    "Index of the bundled testset whose inputs are used.");
+
+DEFINE_int32(num_warmup, 3, "Number of untimed iterations to run first.");
+
+DEFINE_int32(num_iterations, 50, "Number of timed iterations to run.");
+
+DEFINE_bool(
+    output_verification,
+    false,
+    "Compare the output of the last iteration to the reference outputs present "
+    "in the BundledProgram.");
+
+DEFINE_string(
+    model_name,
+    "",
+    "Name of the model in the results, in the <name>_<backend>_<quantization> "
+    "format of the benchmark apps. Defaults to the name of the file.");
+
+DEFINE_string(
+    json_path,
+    "benchmark_results.json",
+    "Path to write the results to, or empty to only log them.");
+
+using executorch::extension::BufferDataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::HierarchicalAllocator;
+using executorch::runtime::MemoryAllocator;
+using executorch::runtime::MemoryManager;
+using executorch::runtime::Method;
+using executorch::runtime::MethodMeta;
+using executorch::runtime::Program;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+
+namespace {
+
+std::vector<uint8_t> load_file_or_die(const char* path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  const size_t nbytes = file.tellg();
+  file.seekg(0, std::ios::beg);
+  auto file_data = std::vector<uint8_t>(nbytes);
+  ET_CHECK_MSG(
+      file.read(reinterpret_cast<char*>(file_data.data()), nbytes),
+      "Could not load contents of file '%s'",
+      path);
+  return file_data;
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+struct LatencyStats {
+  double mean = 0;
+  double variance = 0;
+  double min = 0;
+  double max = 0;
+  double p50 = 0;
+  double p90 = 0;
+  double p99 = 0;
+};
+
+// Nearest-rank percentile of sorted latencies.
+double percentile(const std::vector<double>& sorted, double quantile) {
+  size_t rank = static_cast<size_t>(std::ceil(quantile * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+LatencyStats compute_stats(std::vector<double> latencies) {
+  LatencyStats stats;
+  if (latencies.empty()) {
+    return stats;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  double sum = 0;
+  for (double latency : latencies) {
+    sum += latency;
+  }
+  stats.mean = sum / latencies.size();
+  if (latencies.size() > 1) {
+    double squares = 0;
+    for (double latency : latencies) {
+      squares += (latency - stats.mean) * (latency - stats.mean);
+    }
+    stats.variance = squares / (latencies.size() - 1);
+  }
+  stats.min = latencies.front();
+  stats.max = latencies.back();
+  stats.p50 = percentile(latencies, 0.5);
+  stats.p90 = percentile(latencies, 0.9);
+  stats.p99 = percentile(latencies, 0.99);
+  return stats;
+}
+
+// The peak resident set size of the process in bytes, or 0 if unknown.
+uint64_t peak_rss_bytes() {
+#if defined(__linux__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+    // Linux reports kilobytes.
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+  }
+#endif
+  return 0;
+}
+
+std::string json_escape(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+      escaped += buf;
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+// The benchmarkModel and deviceInfo objects that every metric repeats, like
+// BenchmarkMetric of the Android benchmark app.
+std::string metric_context_json(const std::string& model_name) {
+  std::string name = model_name;
+  std::string backend;
+  std::string quantization;
+  std::smatch match;
+  if (std::regex_match(
+          model_name, match, std::regex("(\\w+)_([\\w+]+)_(\\w+)"))) {
+    name = match[1];
+    backend = match[2];
+    quantization = match[3];
+  }
+
+  std::string device;
+  std::string arch;
+  std::string os;
+  uint64_t total_mem = 0;
+  uint64_t avail_mem = 0;
+#if defined(__linux__) || defined(__APPLE__)
+  struct utsname uts;
+  if (uname(&uts) == 0) {
+    device = uts.nodename;
+    arch = uts.machine;
+    os = std::string(uts.sysname) + " " + uts.release;
+  }
+#endif
+#if defined(__linux__)
+  struct sysinfo info;
+  if (sysinfo(&info) == 0) {
+    total_mem = static_cast<uint64_t>(info.totalram) * info.mem_unit;
+    avail_mem = static_cast<uint64_t>(info.freeram) * info.mem_unit;
+  }
+#endif
+
+  char buf[1024];
+  snprintf(
+      buf,
+      sizeof(buf),
+      "\"benchmarkModel\": {\"name\": \"%s\", \"backend\": \"%s\", "
+      "\"quantization\": \"%s\"}, \"deviceInfo\": {\"device\": \"%s\", "
+      "\"arch\": \"%s\", \"os\": \"%s\", \"totalMem\": %" PRIu64
+      ", \"availMem\": %" PRIu64 "}",
+      json_escape(name).c_str(),
+      json_escape(backend).c_str(),
+      json_escape(quantization).c_str(),
+      json_escape(device).c_str(),
+      json_escape(arch).c_str(),
+      json_escape(os).c_str(),
+      total_mem,
+      avail_mem);
+  return buf;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  if (argc != 1) {
+    std::string msg = "Extra commandline args:";
+    for (int i = 1 /* skip argv[0] (program name) */; i < argc; i++) {
+      msg += std::string(" ") + argv[i];
+    }
+    ET_LOG(Error, "%s", msg.c_str());
+    return 1;
+  }
+  ET_CHECK_MSG(
+      FLAGS_num_warmup >= 0 && FLAGS_num_iterations > 0,
+      "Expected a non-negative --num_warmup and a positive --num_iterations");
+
+  // Read in the entire file.
+  const char* bundled_program_path = FLAGS_bundled_program_path.c_str();
+  std::vector<uint8_t> file_data = load_file_or_die(bundled_program_path);
+
+  auto load_start = std::chrono::steady_clock::now();
+
+  // Find the offset to the embedded Program.
+  const void* program_data;
+  size_t program_data_len;
+  Error status = executorch::bundled_program::get_program_data(
+      reinterpret_cast<void*>(file_data.data()),
+      file_data.size(),
+      &program_data,
+      &program_data_len);
+  ET_CHECK_MSG(
+      status == Error::Ok,
+      "get_program_data() failed on file '%s': 0x%x",
+      bundled_program_path,
+      (unsigned int)status);
+
+  auto buffer_data_loader = BufferDataLoader(program_data, program_data_len);
+
+  Result<Program> program = Program::load(&buffer_data_loader);
+  if (!program.ok()) {
+    ET_LOG(Error, "Failed to parse model file %s", bundled_program_path);
+    return 1;
+  }
+
+  const char* method_name = FLAGS_method_name.c_str();
+  if (FLAGS_method_name.empty()) {
+    const auto method_name_result = program->get_method_name(0);
+    ET_CHECK_MSG(method_name_result.ok(), "Program has no methods");
+    method_name = *method_name_result;
+  }
+  ET_LOG(Info, "Benchmarking method %s", method_name);
+
+  Result<MethodMeta> method_meta = program->method_meta(method_name);
+  ET_CHECK_MSG(
+      method_meta.ok(),
+      "Failed to get method_meta for %s: 0x%x",
+      method_name,
+      (unsigned int)method_meta.error());
+
+  MemoryAllocator method_allocator{MemoryAllocator(
+      sizeof(method_allocator_pool), method_allocator_pool.data())};
+
+  // The memory-planned buffers are the footprint of the method that was
+  // determined ahead of time.
+  size_t planned_memory_size = 0;
+  std::vector<std::unique_ptr<uint8_t[]>> planned_buffers; // Owns the memory
+  std::vector<Span<uint8_t>> planned_spans; // Passed to the allocator
+  size_t num_memory_planned_buffers = method_meta->num_memory_planned_buffers();
+  for (size_t id = 0; id < num_memory_planned_buffers; ++id) {
+    // .get() will always succeed because id < num_memory_planned_buffers.
+    size_t buffer_size =
+        static_cast<size_t>(method_meta->memory_planned_buffer_size(id).get());
+    planned_memory_size += buffer_size;
+    planned_buffers.push_back(std::make_unique<uint8_t[]>(buffer_size));
+    planned_spans.push_back({planned_buffers.back().get(), buffer_size});
+  }
+  HierarchicalAllocator planned_memory(
+      {planned_spans.data(), planned_spans.size()});
+
+  MemoryManager memory_manager(&method_allocator, &planned_memory);
+
+  Result<Method> method = program->load_method(method_name, &memory_manager);
+  ET_CHECK_MSG(
+      method.ok(),
+      "Loading of method %s failed with status 0x%" PRIx32,
+      method_name,
+      static_cast<int>(method.error()));
+  double load_ms = elapsed_ms(load_start);
+  ET_LOG(Info, "Method loaded in %.3f ms.", load_ms);
+
+  // Inputs are set before every iteration, outside of the timed region, in
+  // case the method writes to its input buffers.
+  std::vector<double> latencies;
+  latencies.reserve(FLAGS_num_iterations);
+  for (int i = 0; i < FLAGS_num_warmup + FLAGS_num_iterations; ++i) {
+    status = executorch::bundled_program::load_bundled_input(
+        *method, file_data.data(), FLAGS_testset_idx);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "LoadBundledInput failed with status 0x%" PRIx32,
+        static_cast<int>(status));
+
+    auto start = std::chrono::steady_clock::now();
+    status = method->execute();
+    double latency = elapsed_ms(start);
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Execution of method %s failed with status 0x%" PRIx32,
+        method_name,
+        static_cast<int>(status));
+    if (i >= FLAGS_num_warmup) {
+      latencies.push_back(latency);
+    }
+  }
+
+  if (FLAGS_output_verification) {
+    status = executorch::bundled_program::verify_method_outputs(
+        *method,
+        file_data.data(),
+        FLAGS_testset_idx,
+        1e-3, // rtol
+        1e-5 // atol
+    );
+    ET_CHECK_MSG(
+        status == Error::Ok,
+        "Bundle verification failed with status 0x%" PRIx32,
+        static_cast<int>(status));
+    ET_LOG(Info, "Model verified successfully.");
+  }
+
+  LatencyStats stats = compute_stats(latencies);
+  uint64_t peak_rss = peak_rss_bytes();
+  size_t method_allocator_size = method_allocator.used_size();
+  ET_LOG(
+      Info,
+      "%d iterations after %d warmup iterations: mean %.3f ms, p50 %.3f ms, "
+      "p90 %.3f ms, p99 %.3f ms, min %.3f ms, max %.3f ms, variance %.3f ms^2",
+      FLAGS_num_iterations,
+      FLAGS_num_warmup,
+      stats.mean,
+      stats.p50,
+      stats.p90,
+      stats.p99,
+      stats.min,
+      stats.max,
+      stats.variance);
+  ET_LOG(
+      Info,
+      "Peak RSS %" PRIu64 " bytes, planned memory %zu bytes, method allocator "
+      "%zu bytes",
+      peak_rss,
+      planned_memory_size,
+      method_allocator_size);
+
+  if (FLAGS_json_path.empty()) {
+    return 0;
+  }
+  std::string model_name = FLAGS_model_name;
+  if (model_name.empty()) {
+    model_name = FLAGS_bundled_program_path;
+    model_name = model_name.substr(model_name.find_last_of("/\\") + 1);
+    model_name = model_name.substr(0, model_name.find('.'));
+  }
+  const std::string context = metric_context_json(model_name);
+  const std::pair<const char*, double> metrics[] = {
+      {"model_load_time(ms)", load_ms},
+      {"load_status", 0},
+      {"avg_inference_latency(ms)", stats.mean},
+      {"p50_inference_latency(ms)", stats.p50},
+      {"p90_inference_latency(ms)", stats.p90},
+      {"p99_inference_latency(ms)", stats.p99},
+      {"min_inference_latency(ms)", stats.min},
+      {"max_inference_latency(ms)", stats.max},
+      {"inference_latency_variance(ms^2)", stats.variance},
+      {"peak_rss(bytes)", static_cast<double>(peak_rss)},
+      {"planned_memory(bytes)", static_cast<double>(planned_memory_size)},
+      {"method_allocator(bytes)", static_cast<double>(method_allocator_size)},
+  };
+  FILE* f = fopen(FLAGS_json_path.c_str(), "w");
+  ET_CHECK_MSG(f != nullptr, "Could not open %s", FLAGS_json_path.c_str());
+  fprintf(f, "[");
+  for (size_t i = 0; i < sizeof(metrics) / sizeof(metrics[0]); ++i) {
+    fprintf(
+        f,
+        "%s\n  {%s, \"metric\": \"%s\", \"actualValue\": %.6f, "
+        "\"targetValue\": 0.0}",
+        i == 0 ? "" : ",",
+        context.c_str(),
+        metrics[i].first,
+        metrics[i].second);
+  }
+  fprintf(f, "\n]\n");
+  fclose(f);
+  ET_LOG(Info, "Results written to %s", FLAGS_json_path.c_str());
+
+  return 0;
+}
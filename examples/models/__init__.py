@@ -14,6 +14,10 @@ MODEL_NAME_TO_MODEL = {
     "dl3": ("deeplab_v3", "DeepLabV3ResNet50Model"),
     "edsr": ("edsr", "EdsrModel"),
     "emformer_transcribe": ("emformer_rnnt", "EmformerRnntTranscriberModel"),
+    "emformer_transcribe_streaming": (
+        "emformer_rnnt",
+        "EmformerRnntStreamingTranscriberModel",
+    ),
     "emformer_predict": ("emformer_rnnt", "EmformerRnntPredictorModel"),
     "emformer_join": ("emformer_rnnt", "EmformerRnntJoinerModel"),
     "llama2": ("llama", "Llama2Model"),
@@ -19,6 +19,7 @@ logging.basicConfig(format=FORMAT)
 
 __all__ = [
     "EmformerRnntTranscriberModel",
+    "EmformerRnntStreamingTranscriberModel",
     "EmformerRnntPredictorModel",
     "EmformerRnntJoinerModel",
 ]
@@ -59,6 +60,62 @@ class EmformerRnntTranscriberModel(EagerModelBase):
         return (transcribe_inputs,)
 
 
+class EmformerRnntStreamingTranscriberExample(torch.nn.Module):
+    """
+    This is a wrapper for exporting the transcriber for streaming, one segment
+    at a time. The state of the Emformer layers is passed in and returned as
+    flat tensors after the features and their lengths, so that the runtime can
+    carry it from one segment to the next, e.g. with StreamingSession of
+    extension/module.
+    """
+
+    # The tensors of the state of each Emformer layer.
+    STATE_TENSORS_PER_LAYER = 4
+
+    def __init__(self) -> None:
+        super().__init__()
+        bundle = torchaudio.pipelines.EMFORMER_RNNT_BASE_LIBRISPEECH
+        decoder = bundle.get_decoder()
+        m = decoder.model
+        self.rnnt = m
+        # Each segment of features is followed by the right context, which the
+        # transcriber looks ahead at.
+        self.segment_length = bundle.segment_length
+        self.right_context_length = bundle.right_context_length
+
+    def forward(self, sources, source_lengths, *state):
+        n = self.STATE_TENSORS_PER_LAYER
+        layers = [list(state[i : i + n]) for i in range(0, len(state), n)]
+        output, lengths, new_state = self.rnnt.transcribe_streaming(
+            sources, source_lengths, layers
+        )
+        return (output, lengths, *[t for layer in new_state for t in layer])
+
+
+class EmformerRnntStreamingTranscriberModel(EagerModelBase):
+    def __init__(self):
+        pass
+
+    def get_eager_model(self) -> torch.nn.Module:
+        logging.info("Loading emformer rnnt streaming transcriber")
+        m = EmformerRnntStreamingTranscriberExample()
+        logging.info("Loaded emformer rnnt streaming transcriber")
+        return m
+
+    def get_example_inputs(self):
+        m = EmformerRnntStreamingTranscriberExample()
+        frames = m.segment_length + m.right_context_length
+        sources = torch.randn(1, frames, 80)
+        source_lengths = torch.tensor([frames])
+        # The initial state of the Emformer layers is all zeros.
+        _, _, state = m.rnnt.transcribe_streaming(sources, source_lengths, None)
+        return (
+            sources,
+            source_lengths,
+            *[torch.zeros_like(t) for layer in state for t in layer],
+        )
+
+
 class EmformerRnntPredictorExample(torch.nn.Module):
     """
     This is a wrapper for validating predictor for the Emformer RNN-T architecture.
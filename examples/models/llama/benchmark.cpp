@@ -0,0 +1,474 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Measures the throughput and latency of a llama model over a sweep of
+// prompt lengths, generation lengths, concurrencies and thread counts, with
+// the components of extension/llm/runner.
+//
+// Every configuration runs --warmup_iterations untimed and then
+// --iterations timed iterations. An iteration admits `concurrency` sequences
+// with a synthetic prompt of the given length and generates exactly the given
+// number of tokens for each of them, ignoring EOS tokens, so that runs are
+// comparable across models and releases. Concurrency 1 goes through
+// TextPrefiller and TextTokenGenerator like the llama runner. Larger
+// concurrencies go through BatchedTextTokenGenerator and need a model
+// exported with a KV cache of at least that many rows.
+//
+// Prints a table and, with --output_path, writes one JSON object per
+// configuration.
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/examples/models/llama/tokenizer/llama_tiktoken.h>
+#include <executorch/extension/llm/runner/batched_text_token_generator.h>
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/runner/text_prefiller.h>
+#include <executorch/extension/llm/runner/text_token_generator.h>
+#include <executorch/extension/llm/runner/util.h>
+#include <executorch/extension/llm/tokenizer/bpe_tokenizer.h>
+#include <executorch/extension/module/module.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#if defined(ET_USE_THREADPOOL)
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
+#endif
+
+DEFINE_string(
+    model_path,
+    "llama2.pte",
+    "Model serialized in flatbuffer format.");
+
+DEFINE_string(tokenizer_path, "tokenizer.bin", "Tokenizer stuff.");
+
+DEFINE_string(
+    prompt_lengths,
+    "128",
+    "Comma-separated numbers of prompt tokens to sweep.");
+
+DEFINE_string(
+    gen_lengths,
+    "128",
+    "Comma-separated numbers of tokens to generate per sequence to sweep.");
+
+DEFINE_string(
+    concurrency,
+    "1",
+    "Comma-separated numbers of sequences to decode together to sweep. Values above 1 need a model with a batched KV cache.");
+
+DEFINE_string(
+    threads,
+    "1",
+    "Comma-separated numbers of CPU threads to sweep. Ignored without a threadpool.");
+
+DEFINE_int32(iterations, 3, "Number of timed iterations per configuration.");
+
+DEFINE_int32(
+    warmup_iterations,
+    1,
+    "Number of untimed iterations per configuration.");
+
+DEFINE_double(
+    temperature,
+    0.0f,
+    "Temperature of the sampler. 0 = greedy argmax sampling, which keeps the runs reproducible.");
+
+DEFINE_int32(
+    prefill_chunk_size,
+    0,
+    "Prefill chunk size of BatchedTextTokenGenerator for concurrencies above 1. 0 feeds one prompt token per step.");
+
+DEFINE_string(
+    output_path,
+    "",
+    "If set, where to write the results as JSON lines, one per configuration.");
+
+namespace {
+
+using ::executorch::extension::Module;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace llm = ::executorch::extension::llm;
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kEnableDynamicShape = "enable_dynamic_shape";
+constexpr auto kMaxSeqLen = "get_max_seq_len";
+constexpr auto kMaxPrefillChunkSize = "get_max_prefill_chunk_size";
+constexpr auto kUseKVCache = "use_kv_cache";
+constexpr auto kUseVocabSubset = "use_vocab_subset";
+
+// Text that the synthetic prompts are made of, repeated as needed.
+constexpr auto kPromptText =
+    "ExecuTorch is an end-to-end solution for enabling on-device inference "
+    "capabilities across mobile and edge devices including wearables, "
+    "embedded devices and microcontrollers. It is part of the PyTorch Edge "
+    "ecosystem and enables efficient deployment of PyTorch models to edge "
+    "devices. ";
+
+struct Config {
+  int32_t prompt_length;
+  int32_t gen_length;
+  int32_t concurrency;
+  int32_t threads;
+};
+
+struct RunResult {
+  Config config;
+  int64_t num_generated_tokens = 0;
+  double total_s = 0;
+  // Time to the first token of each sequence.
+  std::vector<double> ttft_ms;
+  // Time between consecutive tokens of each sequence.
+  std::vector<double> itl_ms;
+};
+
+std::vector<int32_t> parse_list(const std::string& flag) {
+  std::vector<int32_t> values;
+  std::stringstream stream(flag);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      values.push_back(std::stoi(item));
+    }
+  }
+  return values;
+}
+
+double ms_since(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+// The value below which `quantile` of the sorted values are.
+double percentile(const std::vector<double>& sorted, double quantile) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const size_t index = static_cast<size_t>(quantile * (sorted.size() - 1));
+  return sorted[index];
+}
+
+std::unique_ptr<llm::Tokenizer> load_tokenizer(const std::string& path) {
+  // Assuming tiktoken is the default tokenizer, like the llama runner.
+  std::unique_ptr<llm::Tokenizer> tokenizer =
+      example::get_tiktoken_for_llama();
+  if (tokenizer->load(path) == Error::InvalidArgument) {
+    tokenizer = std::make_unique<llm::BPETokenizer>();
+    if (tokenizer->load(path) != Error::Ok) {
+      return nullptr;
+    }
+  }
+  return tokenizer;
+}
+
+int64_t read_metadata(
+    Module& module,
+    const std::unordered_set<std::string>& method_names,
+    const std::string& name,
+    int64_t default_value) {
+  if (!method_names.count(name)) {
+    return default_value;
+  }
+  auto value = module.get(name);
+  return value.ok() ? value->toScalar().to<int64_t>() : default_value;
+}
+
+// The first prompt_length tokens of kPromptText, repeated, after the BOS
+// token.
+std::vector<uint64_t> make_prompt(
+    llm::Tokenizer& tokenizer,
+    int32_t prompt_length) {
+  const std::vector<uint64_t> text_tokens =
+      tokenizer.encode(kPromptText, /*bos=*/0, /*eos=*/0).get();
+  std::vector<uint64_t> tokens = {tokenizer.bos_tok()};
+  while (tokens.size() < static_cast<size_t>(prompt_length)) {
+    tokens.push_back(text_tokens[(tokens.size() - 1) % text_tokens.size()]);
+  }
+  tokens.resize(prompt_length);
+  return tokens;
+}
+
+class Benchmark {
+ public:
+  Benchmark(Module* module, llm::Tokenizer* tokenizer)
+      : module_(module), tokenizer_(tokenizer) {}
+
+  Error load() {
+    ET_CHECK_OK_OR_RETURN_ERROR(module_->load_method("forward"));
+    const auto method_names =
+        ET_UNWRAP(module_->method_names(), "Failed reading method names");
+    use_kv_cache_ = read_metadata(*module_, method_names, kUseKVCache, 1);
+    max_seq_len_ = read_metadata(*module_, method_names, kMaxSeqLen, 128);
+    text_decoder_runner_ = std::make_unique<llm::TextDecoderRunner>(
+        module_,
+        use_kv_cache_,
+        tokenizer_->vocab_size(),
+        FLAGS_temperature);
+    text_decoder_runner_->set_vocab_subset_input(
+        read_metadata(*module_, method_names, kUseVocabSubset, 0));
+    text_prefiller_ = std::make_unique<llm::TextPrefiller>(
+        text_decoder_runner_.get(),
+        use_kv_cache_,
+        read_metadata(*module_, method_names, kEnableDynamicShape, 0),
+        read_metadata(*module_, method_names, kMaxPrefillChunkSize, 0));
+    // Without EOS tokens, every sequence generates exactly gen_length tokens.
+    text_token_generator_ = std::make_unique<llm::TextTokenGenerator>(
+        tokenizer_,
+        text_decoder_runner_.get(),
+        use_kv_cache_,
+        std::make_unique<std::unordered_set<uint64_t>>(),
+        &stats_);
+    return Error::Ok;
+  }
+
+  Result<RunResult> run(const Config& config) {
+    ET_CHECK_OR_RETURN_ERROR(
+        config.prompt_length > 0 && config.gen_length > 0 &&
+            config.concurrency > 0,
+        InvalidArgument,
+        "Lengths and concurrency must be positive");
+    ET_CHECK_OR_RETURN_ERROR(
+        config.prompt_length + config.gen_length <= max_seq_len_,
+        InvalidArgument,
+        "prompt_length %d + gen_length %d exceeds max_seq_len %" PRId64,
+        config.prompt_length,
+        config.gen_length,
+        max_seq_len_);
+#if defined(ET_USE_THREADPOOL)
+    ::executorch::extension::threadpool::ThreadPool threadpool(config.threads);
+    ::executorch::extension::threadpool::ThreadPoolGuard guard(&threadpool);
+#endif
+    const std::vector<uint64_t> prompt =
+        make_prompt(*tokenizer_, config.prompt_length);
+
+    RunResult result{config};
+    for (int32_t i = 0; i < FLAGS_warmup_iterations; ++i) {
+      RunResult warmup{config};
+      ET_CHECK_OK_OR_RETURN_ERROR(run_iteration(config, prompt, warmup));
+    }
+    for (int32_t i = 0; i < FLAGS_iterations; ++i) {
+      ET_CHECK_OK_OR_RETURN_ERROR(run_iteration(config, prompt, result));
+    }
+    std::sort(result.ttft_ms.begin(), result.ttft_ms.end());
+    std::sort(result.itl_ms.begin(), result.itl_ms.end());
+    return result;
+  }
+
+ private:
+  Error run_iteration(
+      const Config& config,
+      const std::vector<uint64_t>& prompt,
+      RunResult& result) {
+    const auto start = Clock::now();
+    if (config.concurrency == 1) {
+      ET_CHECK_OK_OR_RETURN_ERROR(run_single(config, prompt, start, result));
+    } else {
+      ET_CHECK_OK_OR_RETURN_ERROR(run_batched(config, prompt, start, result));
+    }
+    result.total_s += ms_since(start) / 1000.0;
+    return Error::Ok;
+  }
+
+  Error run_single(
+      const Config& config,
+      const std::vector<uint64_t>& prompt,
+      Clock::time_point start,
+      RunResult& result) {
+    std::vector<uint64_t> tokens = prompt;
+    int64_t pos = 0;
+    const uint64_t first_token =
+        ET_UNWRAP(text_prefiller_->prefill(tokens, pos));
+    const double ttft_ms = ms_since(start);
+    result.ttft_ms.push_back(ttft_ms);
+
+    // The token callback runs once per token that completes a UTF-8
+    // character, which is every token for the English prompt text.
+    double last_ms = ttft_ms;
+    tokens = prompt;
+    tokens.push_back(first_token);
+    const int64_t num_generated = ET_UNWRAP(text_token_generator_->generate(
+        tokens,
+        config.prompt_length,
+        config.prompt_length + config.gen_length,
+        [&](const std::string&) {
+          const double now_ms = ms_since(start);
+          result.itl_ms.push_back(now_ms - last_ms);
+          last_ms = now_ms;
+        }));
+    result.num_generated_tokens += 1 + num_generated;
+    return Error::Ok;
+  }
+
+  Error run_batched(
+      const Config& config,
+      const std::vector<uint64_t>& prompt,
+      Clock::time_point start,
+      RunResult& result) {
+    llm::BatchedTextTokenGenerator generator(
+        tokenizer_,
+        text_decoder_runner_.get(),
+        config.concurrency,
+        max_seq_len_,
+        std::make_unique<std::unordered_set<uint64_t>>(),
+        &stats_,
+        FLAGS_prefill_chunk_size);
+    // The time of the latest token of each sequence, or a negative value
+    // before its first token.
+    std::vector<double> last_ms(config.concurrency, -1.0);
+    for (int32_t i = 0; i < config.concurrency; ++i) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          generator
+              .admit(
+                  prompt,
+                  config.prompt_length + config.gen_length,
+                  [&, i](const std::string&) {
+                    const double now_ms = ms_since(start);
+                    if (last_ms[i] < 0) {
+                      result.ttft_ms.push_back(now_ms);
+                    } else {
+                      result.itl_ms.push_back(now_ms - last_ms[i]);
+                    }
+                    last_ms[i] = now_ms;
+                  },
+                  [&](int64_t num_generated) {
+                    result.num_generated_tokens += num_generated;
+                  })
+              .error());
+    }
+    return generator.generate().error();
+  }
+
+  Module* module_;
+  llm::Tokenizer* tokenizer_;
+  bool use_kv_cache_ = true;
+  int64_t max_seq_len_ = 0;
+  llm::Stats stats_;
+  std::unique_ptr<llm::TextDecoderRunner> text_decoder_runner_;
+  std::unique_ptr<llm::TextPrefiller> text_prefiller_;
+  std::unique_ptr<llm::TextTokenGenerator> text_token_generator_;
+};
+
+std::string to_json(const RunResult& result, double peak_rss_mib) {
+  std::stringstream json;
+  json << "{\"prompt_length\":" << result.config.prompt_length
+       << ",\"gen_length\":" << result.config.gen_length
+       << ",\"concurrency\":" << result.config.concurrency
+       << ",\"threads\":" << result.config.threads
+       << ",\"iterations\":" << FLAGS_iterations
+       << ",\"generated_tokens\":" << result.num_generated_tokens
+       << ",\"tokens_per_s\":"
+       << (result.total_s > 0 ? result.num_generated_tokens / result.total_s
+                              : 0);
+  for (const auto& [name, values] :
+       {std::make_pair("ttft_ms", &result.ttft_ms),
+        std::make_pair("itl_ms", &result.itl_ms)}) {
+    for (const auto& [suffix, quantile] :
+         {std::make_pair("p50", 0.5),
+          std::make_pair("p90", 0.9),
+          std::make_pair("p99", 0.99)}) {
+      json << ",\"" << name << "_" << suffix
+           << "\":" << percentile(*values, quantile);
+    }
+  }
+  json << ",\"peak_rss_mib\":" << peak_rss_mib << "}";
+  return json.str();
+}
+
+} // namespace
+
+int32_t main(int32_t argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  ::executorch::runtime::runtime_init();
+
+  auto tokenizer = load_tokenizer(FLAGS_tokenizer_path);
+  if (tokenizer == nullptr) {
+    ET_LOG(Error, "Failed to load %s", FLAGS_tokenizer_path.c_str());
+    return 1;
+  }
+  Module module(FLAGS_model_path, Module::LoadMode::File);
+  Benchmark benchmark(&module, tokenizer.get());
+  if (benchmark.load() != Error::Ok) {
+    ET_LOG(Error, "Failed to load %s", FLAGS_model_path.c_str());
+    return 1;
+  }
+
+  std::ofstream output;
+  if (!FLAGS_output_path.empty()) {
+    output.open(FLAGS_output_path);
+  }
+  printf(
+      "%8s %8s %6s %7s %10s %10s %10s %10s %10s %9s\n",
+      "prompt",
+      "gen",
+      "conc",
+      "threads",
+      "tok/s",
+      "ttft p50",
+      "ttft p99",
+      "itl p50",
+      "itl p99",
+      "rss MiB");
+  int exit_code = 0;
+  for (int32_t threads : parse_list(FLAGS_threads)) {
+    for (int32_t concurrency : parse_list(FLAGS_concurrency)) {
+      for (int32_t prompt_length : parse_list(FLAGS_prompt_lengths)) {
+        for (int32_t gen_length : parse_list(FLAGS_gen_lengths)) {
+          const Config config{prompt_length, gen_length, concurrency, threads};
+          auto result = benchmark.run(config);
+          if (!result.ok()) {
+            ET_LOG(
+                Error,
+                "Configuration prompt=%d gen=%d concurrency=%d threads=%d failed: 0x%" PRIx32,
+                prompt_length,
+                gen_length,
+                concurrency,
+                threads,
+                static_cast<uint32_t>(result.error()));
+            exit_code = 1;
+            continue;
+          }
+          // Peak RSS of the process so far, which includes the weights.
+          const double peak_rss_mib = llm::get_rss_bytes() / 1024.0 / 1024.0;
+          printf(
+              "%8d %8d %6d %7d %10.2f %10.2f %10.2f %10.2f %10.2f %9.1f\n",
+              prompt_length,
+              gen_length,
+              concurrency,
+              threads,
+              result->total_s > 0
+                  ? result->num_generated_tokens / result->total_s
+                  : 0,
+              percentile(result->ttft_ms, 0.5),
+              percentile(result->ttft_ms, 0.99),
+              percentile(result->itl_ms, 0.5),
+              percentile(result->itl_ms, 0.99),
+              peak_rss_mib);
+          fflush(stdout);
+          if (output.is_open()) {
+            output << to_json(result.get(), peak_rss_mib) << "\n";
+          }
+        }
+      }
+    }
+  }
+  return exit_code;
+}
@@ -57,7 +57,10 @@ from .source_transformation.quantize import (
 from .source_transformation.quantized_kv_cache import (
     replace_kv_cache_with_quantized_kv_cache,
 )
-from .source_transformation.rms_norm import replace_rms_norm_with_native_rms_norm
+from .source_transformation.rms_norm import (
+    replace_rms_norm_with_custom_op,
+    replace_rms_norm_with_native_rms_norm,
+)
 
 from .source_transformation.rope import materialze_broadcast_of_rope_freq_cis
 from .source_transformation.sdpa import (
@@ -247,6 +250,12 @@ def build_args_parser() -> argparse.ArgumentParser:
         action="store_true",
         help="Whether to use sdpa_with_kv_cache update op when using kv cache",
     )
+    parser.add_argument(
+        "--use_custom_rms_norm",
+        default=False,
+        action="store_true",
+        help="Whether to replace RMSNorm with the optimized llama::rms_norm custom op",
+    )
     parser.add_argument(
         "--disable_dynamic_shape",
         dest="enable_dynamic_shape",
@@ -254,6 +263,14 @@ def build_args_parser() -> argparse.ArgumentParser:
         action="store_false",
         help="Enable dynamic shape along seq dim. Used for faster prefill",
     )
+    parser.add_argument(
+        "--max_prefill_chunk_size",
+        type=int,
+        default=None,
+        help="Maximum number of prompt tokens per forward with dynamic shape and "
+        "kv cache. The runner prefills longer prompts in chunks of this size, so "
+        "memory is only planned for a chunk instead of max_seq_length tokens.",
+    )
     parser.add_argument(
         "-p",
         "--params",
@@ -391,6 +408,14 @@ def build_args_parser() -> argparse.ArgumentParser:
         default=False,
         help="Generate logits for all inputs.",
     )
+    parser.add_argument(
+        "--fused_argmax",
+        action="store_true",
+        required=False,
+        default=False,
+        help="Output the id of the most likely next token instead of the logits, "
+        "for greedy decoding without reading the logits back from the device.",
+    )
 
     parser.add_argument(
         "--soc_model",
@@ -552,8 +577,10 @@ def _prepare_for_llama_export(args) -> LLMEdgeManager:
             use_kv_cache=args.use_kv_cache,
             use_sdpa_with_kv_cache=args.use_sdpa_with_kv_cache,
             generate_full_logits=args.generate_full_logits,
+            fused_argmax=args.fused_argmax,
             weight_type=weight_type,
             enable_dynamic_shape=args.enable_dynamic_shape,
+            max_prefill_chunk_size=args.max_prefill_chunk_size,
             calibration_tasks=args.calibration_tasks,
             calibration_limit=args.calibration_limit,
             calibration_seq_length=args.calibration_seq_length,
@@ -828,6 +855,7 @@ def _load_llama_model_metadata(
     n_layers: int,
     vocab_size: int,
     metadata_str: Optional[str] = None,
+    max_prefill_chunk_size: Optional[int] = None,
 ):
     is_fairseq2 = weight_type == WeightType.FAIRSEQ2
     metadata = {
@@ -840,6 +868,8 @@ def _load_llama_model_metadata(
         "use_sdpa_with_kv_cache": use_sdpa_with_kv_cache,
         "enable_dynamic_shape": enable_dynamic_shape,
     }
+    if max_prefill_chunk_size:
+        metadata["get_max_prefill_chunk_size"] = max_prefill_chunk_size
     if metadata_str:
         try:
             extra = json.loads(metadata_str)
@@ -859,8 +889,10 @@ def _load_llama_model(
     use_kv_cache: bool = False,
     use_sdpa_with_kv_cache: bool = False,
     generate_full_logits: bool = False,
+    fused_argmax: bool = False,
     weight_type: WeightType = WeightType.LLAMA,
     enable_dynamic_shape: bool = False,
+    max_prefill_chunk_size: Optional[int] = None,
     calibration_tasks: Optional[List[str]] = None,
     calibration_limit: Optional[int] = None,
     calibration_seq_length: Optional[int] = None,
@@ -884,6 +916,9 @@ def _load_llama_model(
     assert (
         checkpoint or checkpoint_dir
     ) and params_path, "Both checkpoint/checkpoint_dir and params can't be empty"
+    assert not (
+        fused_argmax and calibration_tasks
+    ), "Calibration needs the logits, which fused_argmax replaces with token ids"
     logging.info(
         f"Loading model with checkpoint={checkpoint}, params={params_path}, use_kv_cache={use_kv_cache}, weight_type={weight_type}"
     )
@@ -910,6 +945,7 @@ def _load_llama_model(
             use_kv_cache=use_kv_cache,
             use_sdpa_with_kv_cache=use_sdpa_with_kv_cache,
             generate_full_logits=generate_full_logits,
+            fused_argmax=fused_argmax,
             fairseq2=weight_type == WeightType.FAIRSEQ2,
             max_seq_len=max_seq_len,
             enable_dynamic_shape=enable_dynamic_shape,
@@ -956,6 +992,7 @@ def _load_llama_model(
         example_kwarg_inputs=example_kwarg_inputs,
         dynamic_shapes=dynamic_shapes,
         enable_dynamic_shape=enable_dynamic_shape,
+        max_prefill_chunk_size=max_prefill_chunk_size,
         calibration_tasks=calibration_tasks,
         calibration_limit=calibration_limit,
         calibration_seq_length=calibration_seq_length,
@@ -977,6 +1014,7 @@ def _load_llama_model(
             #  Module]`.
             model.vocab_size,
             metadata_str,
+            max_prefill_chunk_size if use_kv_cache and enable_dynamic_shape else None,
         ),
         args=args,
     )
@@ -1039,6 +1077,9 @@ def _get_source_transforms(  # noqa
     if args.use_sdpa_with_kv_cache:
         transforms.append(replace_sdpa_with_custom_op)
 
+    if args.use_custom_rms_norm:
+        transforms.append(replace_rms_norm_with_custom_op)
+
     if args.quantize_kv_cache:
         assert args.use_kv_cache, "quantize_kv_cache requires use_kv_cache=True"
         transforms.append(replace_kv_cache_with_quantized_kv_cache)
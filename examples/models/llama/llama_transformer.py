@@ -102,6 +102,9 @@ class ModelArgs:
     # at runtime. Enable it only necessary (e.g., use perplexity tools that requires
     # logits for all input tokens.)
     generate_full_logits: bool = False
+    # Return the id of the most likely next token instead of the logits, so
+    # greedy decoding only reads one integer back from the device per token.
+    fused_argmax: bool = False
     enable_dynamic_shape: bool = False  # export model with dynamic shape support
     # A dictionary mapping from pruned token-id to original token-id
     input_prune_map: Optional[Dict[int, int]] = None
@@ -543,6 +546,7 @@ class Transformer(nn.Module):
         self.output = nn.Linear(params.dim, params.vocab_size, bias=False)
         self.use_kv_cache = params.use_kv_cache
         self.generate_full_logits = params.generate_full_logits
+        self.fused_argmax = params.fused_argmax
         self.max_seq_len = params.max_seq_len
         self.input_prune_map = params.input_prune_map
         self.output_prune_map = params.output_prune_map
@@ -602,4 +606,10 @@ class Transformer(nn.Module):
                 expanded_logits[:, list(self.output_prune_map.values())] = logits
             logits = expanded_logits
 
+        if self.fused_argmax:
+            # (1, seq_len) with full logits, else (1, 1)
+            return torch.argmax(
+                logits, dim=-1, keepdim=not self.generate_full_logits
+            )
+
         return logits
@@ -8,6 +8,8 @@
 
 #include <gflags/gflags.h>
 
+#include <fstream>
+
 #include <executorch/examples/models/llama/runner/runner.h>
 
 #if defined(ET_USE_THREADPOOL)
@@ -41,6 +43,11 @@ DEFINE_int32(
 
 DEFINE_bool(warmup, false, "Whether to run a warmup run.");
 
+DEFINE_string(
+    metrics_path,
+    "",
+    "If set, where to write per-token latency percentiles, their breakdown into phases, and KV cache occupancy as JSON after generating.");
+
 int32_t main(int32_t argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
@@ -78,8 +85,16 @@ int32_t main(int32_t argc, char** argv) {
   if (warmup) {
     runner.warmup(prompt, seq_len);
   }
+  ::executorch::extension::llm::RunnerMetrics metrics;
+  if (!FLAGS_metrics_path.empty()) {
+    runner.set_metrics(&metrics);
+  }
   // generate
   runner.generate(prompt, seq_len);
 
+  if (!FLAGS_metrics_path.empty()) {
+    std::ofstream(FLAGS_metrics_path) << metrics.to_json() << "\n";
+  }
+
   return 0;
 }
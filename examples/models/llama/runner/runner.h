@@ -16,8 +16,11 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <executorch/extension/llm/runner/irunner.h>
+#include <executorch/extension/llm/runner/prefix_cache.h>
+#include <executorch/extension/llm/runner/metrics.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 #include <executorch/extension/llm/runner/text_prefiller.h>
@@ -32,7 +35,10 @@ class ET_EXPERIMENTAL Runner : public executorch::extension::llm::IRunner {
   explicit Runner(
       const std::string& model_path,
       const std::string& tokenizer_path,
-      const float temperature = 0.8f);
+      const float temperature = 0.8f,
+      // How many prompt prefixes to keep the KV cache of across generate()
+      // calls. Each one costs a copy of the model's planned memory.
+      const size_t prefix_cache_size = 0);
 
   bool is_loaded() const;
   ::executorch::runtime::Error load();
@@ -49,8 +55,24 @@ class ET_EXPERIMENTAL Runner : public executorch::extension::llm::IRunner {
       int32_t seq_len = 128);
   void stop();
 
+  /**
+   * Records per-token latencies, their breakdown into phases, and KV cache
+   * occupancy into metrics, which must outlive the runner. Nothing is
+   * recorded by default.
+   */
+  void set_metrics(::executorch::extension::llm::RunnerMetrics* metrics);
+
+  /**
+   * Restricts generation to the given token ids, e.g. a set of class labels.
+   * A model exported with a vocab subset input (see
+   * source_transformation/prune_vocab.py) computes the logits of these
+   * tokens alone. An empty list, the default, allows every token.
+   */
+  void set_allowed_tokens(std::vector<int64_t> allowed_tokens);
+
  private:
   float temperature_;
+  size_t prefix_cache_size_;
   bool shouldStop_{false};
 
   // model
@@ -63,9 +85,12 @@ class ET_EXPERIMENTAL Runner : public executorch::extension::llm::IRunner {
   std::unique_ptr<::executorch::extension::llm::TextPrefiller> text_prefiller_;
   std::unique_ptr<::executorch::extension::llm::TextTokenGenerator>
       text_token_generator_;
+  std::unique_ptr<::executorch::extension::llm::PrefixCache> prefix_cache_;
 
   // stats
   ::executorch::extension::llm::Stats stats_;
+  ::executorch::extension::llm::RunnerMetrics* metrics_ = nullptr;
+  std::vector<int64_t> allowed_tokens_;
 };
 
 } // namespace example
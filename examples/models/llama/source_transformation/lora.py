@@ -9,7 +9,7 @@
 # Helper functions for tranforming the model to be able to load checkpoints with
 # LoRA adaptors. See https://arxiv.org/abs/2106.09685 for more details about LoRA.
 
-from typing import Any
+from typing import Any, List, Optional, Tuple
 
 import torch
 from torch import nn
@@ -151,3 +151,142 @@ def transform_linear_for_lora_after_quantization(
         lora_rank,
     )
     return module
+
+
+class RuntimeLoRAState:
+    """
+    The adapter inputs of a model exported with
+    replace_linear_with_runtime_lora, shared by its RuntimeLoRALinear layers
+    for the duration of one forward pass.
+    """
+
+    def __init__(self) -> None:
+        self.adapter_ids: Optional[torch.Tensor] = None
+        self.banks: List[Tuple[torch.Tensor, torch.Tensor]] = []
+
+
+class RuntimeLoRALinear(nn.Module):
+    """
+    A linear layer whose LoRA weights are inputs of the exported method rather
+    than constants of the program, so that the runtime can switch adapters
+    without a new program. See extension/llm/runner/lora_adapter_bank.h.
+    """
+
+    def __init__(self, linear: nn.Linear, state: RuntimeLoRAState, index: int):
+        super().__init__()
+        self.in_features = linear.in_features
+        self.out_features = linear.out_features
+        self.weight = linear.weight
+        self.bias = linear.bias
+        self.state = state
+        self.index = index
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        lora_a, lora_b = self.state.banks[self.index]
+        return torch.ops.llama.lora_linear(
+            x,
+            self.weight,
+            self.bias,
+            lora_a,
+            lora_b,
+            self.state.adapter_ids,
+            1.0,
+        )
+
+
+class RuntimeLoRAInputs(nn.Module):
+    """
+    Appends the adapter inputs to the inputs of model: adapter_ids, [batch],
+    if with_adapter_ids, then lora_a and lora_b of every RuntimeLoRALinear in
+    order. Export with alloc_graph_input=False so that the runtime binds the
+    adapter banks rather than copying them on every execution.
+    """
+
+    def __init__(
+        self,
+        model: nn.Module,
+        state: RuntimeLoRAState,
+        num_model_inputs: int,
+        with_adapter_ids: bool = True,
+    ) -> None:
+        super().__init__()
+        self.model = model
+        self.state = state
+        self.num_model_inputs = num_model_inputs
+        self.with_adapter_ids = with_adapter_ids
+
+    def forward(self, *args: torch.Tensor) -> Any:
+        model_inputs = args[: self.num_model_inputs]
+        adapter_inputs = args[self.num_model_inputs :]
+        if self.with_adapter_ids:
+            self.state.adapter_ids = adapter_inputs[0]
+            adapter_inputs = adapter_inputs[1:]
+        self.state.banks = list(zip(adapter_inputs[0::2], adapter_inputs[1::2]))
+        return self.model(*model_inputs)
+
+
+def replace_linear_with_runtime_lora(
+    module: nn.Module,
+    target_modules: List[str],
+) -> Tuple[nn.Module, RuntimeLoRAState, List[str]]:
+    """
+    Replaces the nn.Linear layers whose name ends with one of target_modules,
+    e.g. ["wq", "wv"], with RuntimeLoRALinear. Returns the module, the state
+    to wrap it with RuntimeLoRAInputs, and the names of the replaced layers,
+    in the order of their adapter inputs.
+    """
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa: F401
+
+    state = RuntimeLoRAState()
+    names: List[str] = []
+    for fqn, child in list(module.named_modules()):
+        if isinstance(child, nn.Linear) and fqn.split(".")[-1] in target_modules:
+            parent_fqn, _, child_name = fqn.rpartition(".")
+            parent = module.get_submodule(parent_fqn)
+            replacement = RuntimeLoRALinear(child, state, len(names))
+            setattr(parent, child_name, replacement)
+            names.append(fqn)
+    return module, state, names
+
+
+def runtime_lora_example_inputs(
+    module: nn.Module,
+    num_slots: int,
+    rank: int,
+    batch_size: int = 1,
+    with_adapter_ids: bool = True,
+) -> Tuple[torch.Tensor, ...]:
+    """
+    Zero adapter inputs for the RuntimeLoRALinear layers of module, to append
+    to the example inputs of the model on export.
+    """
+    inputs: List[torch.Tensor] = []
+    if with_adapter_ids:
+        inputs.append(torch.full((batch_size,), -1, dtype=torch.long))
+    for child in module.modules():
+        if isinstance(child, RuntimeLoRALinear):
+            dtype = child.weight.dtype
+            inputs.append(
+                torch.zeros(num_slots, rank, child.in_features, dtype=dtype)
+            )
+            inputs.append(
+                torch.zeros(num_slots, child.out_features, rank, dtype=dtype)
+            )
+    return tuple(inputs)
+
+
+def save_runtime_lora_adapter(
+    path: str,
+    adapters: List[Tuple[torch.Tensor, torch.Tensor]],
+    scale: float = 1.0,
+    dtype: torch.dtype = torch.float32,
+) -> None:
+    """
+    Writes one adapter for LoRAAdapterBank::load_adapter: the A, [rank, in
+    features], and B, [out features, rank], of every RuntimeLoRALinear in
+    order. The adapter's scale is folded into B.
+    """
+    with open(path, "wb") as f:
+        for lora_a, lora_b in adapters:
+            for weight in (lora_a, lora_b * scale):
+                f.write(weight.detach().to(dtype).contiguous().numpy().tobytes())
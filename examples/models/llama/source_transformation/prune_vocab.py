@@ -4,7 +4,7 @@
 # This source code is licensed under the BSD-style license found in the
 # LICENSE file in the root directory of this source tree.
 
-from typing import Dict
+from typing import Any, Dict, Optional
 
 import numpy as np
 
@@ -117,3 +117,75 @@ def prune_input_vocab(
     setattr(model, imput_layer_name, pruned_layer)
 
     return model
+
+
+class VocabSubsetState:
+    """
+    The allowed_tokens input of a model exported with
+    replace_output_with_vocab_subset, for the duration of one forward pass.
+    """
+
+    def __init__(self) -> None:
+        self.allowed_tokens: Optional[torch.Tensor] = None
+
+
+class VocabSubsetLinear(torch.nn.Module):
+    """
+    An output projection that computes the logits of the allowed tokens only,
+    in their order, with the gathered_linear custom op. Unlike
+    prune_output_vocab, the subset is picked at runtime, so one program
+    serves any restricted vocabulary. See set_allowed_tokens in
+    extension/llm/runner/text_decoder_runner.h.
+    """
+
+    def __init__(self, linear: torch.nn.Linear, state: VocabSubsetState):
+        super().__init__()
+        self.in_features = linear.in_features
+        self.out_features = linear.out_features
+        self.weight = linear.weight
+        self.bias = linear.bias
+        self.state = state
+
+    def forward(self, x: torch.Tensor) -> torch.Tensor:
+        return torch.ops.llama.gathered_linear(
+            x, self.weight, self.bias, self.state.allowed_tokens
+        )
+
+
+class VocabSubsetInputs(torch.nn.Module):
+    """
+    Appends allowed_tokens, a [num_tokens] long tensor, to the inputs of
+    model. Export with a dynamic num_tokens, and with
+    --metadata '{"use_vocab_subset": 1}' so that the runner passes it.
+    """
+
+    def __init__(self, model: torch.nn.Module, state: VocabSubsetState) -> None:
+        super().__init__()
+        self.model = model
+        self.state = state
+
+    def forward(self, *args: torch.Tensor) -> Any:
+        self.state.allowed_tokens = args[-1]
+        return self.model(*args[:-1])
+
+
+def replace_output_with_vocab_subset(
+    model: torch.nn.Module,
+    output_layer_name: str = "output",
+) -> torch.nn.Module:
+    """
+    Replaces the output linear layer of model with a VocabSubsetLinear and
+    returns model wrapped in VocabSubsetInputs.
+    """
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa: F401
+
+    assert hasattr(
+        model, output_layer_name
+    ), f"Model does not have {output_layer_name} layer"
+    output_layer = getattr(model, output_layer_name)
+    assert isinstance(
+        output_layer, torch.nn.Linear
+    ), "Output layer is not a linear layer"
+    state = VocabSubsetState()
+    setattr(model, output_layer_name, VocabSubsetLinear(output_layer, state))
+    return VocabSubsetInputs(model, state)
@@ -21,3 +21,36 @@ def replace_rms_norm_with_native_rms_norm(module: torch.nn.Module):
         else:
             replace_rms_norm_with_native_rms_norm(child)
     return module
+
+
+class RMSNormCustom(torch.nn.Module):
+    """
+    RMSNorm that runs as a single llama::rms_norm op, instead of the
+    mul/mean/add/rsqrt/mul sequence that RMSNorm decomposes into.
+    """
+
+    def __init__(self, rms_norm: RMSNorm):
+        super().__init__()
+        self.dim = rms_norm.dim
+        self.eps = rms_norm.eps
+        self.weight = rms_norm.weight
+
+    def forward(self, x):
+        # Like RMSNorm, normalize in float32 and scale in the input's dtype.
+        output = torch.ops.llama.rms_norm(x.float(), [self.dim], None, self.eps)
+        return output.type_as(x) * self.weight
+
+
+def _replace_rms_norm_with_custom_op(module: torch.nn.Module):
+    for name, child in module.named_children():
+        if isinstance(child, RMSNorm):
+            setattr(module, name, RMSNormCustom(child))
+        else:
+            _replace_rms_norm_with_custom_op(child)
+
+
+def replace_rms_norm_with_custom_op(module: torch.nn.Module) -> torch.nn.Module:
+    from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+    _replace_rms_norm_with_custom_op(module)
+    return module
@@ -56,10 +56,27 @@ class SDPACustom(torch.nn.Module):
 
         k_cache = self.kv_cache.k_cache
         v_cache = self.kv_cache.v_cache
-        if hasattr(self.kv_cache, "quantized_cache_dtype"):
+        if hasattr(self.kv_cache, "k_cache_zero_points"):
+            # Quantizes k and v into the int8 cache, and attends over the
+            # cache as int8, without dequantizing it.
+            output = torch.ops.llama.sdpa_with_quantized_kv_cache(
+                q,
+                k,
+                v,
+                k_cache,
+                v_cache,
+                self.kv_cache.k_cache_scales,
+                self.kv_cache.k_cache_zero_points,
+                self.kv_cache.v_cache_scales,
+                self.kv_cache.v_cache_zero_points,
+                input_pos[0].item(),
+                None,  # Attention mask
+                0,  # dropout probability. Ignored by the code
+                True,  # is_causal
+            )
+        elif hasattr(self.kv_cache, "quantized_cache_dtype"):
             # updated quantize cache, scale and zero points
             # returns dequantized kv cache
-            # Not most optimal. Optimizations to follow next
             k_cache, v_cache = self.kv_cache.update(input_pos, k, v)
             output = torch.ops.llama.custom_sdpa(
                 q,
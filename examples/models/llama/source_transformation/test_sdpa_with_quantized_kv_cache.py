@@ -63,9 +63,13 @@ class SDPAWithQuantizedKVCacheTest(unittest.TestCase):
         self.quantized_sdpa = SDPACustom(self.quantized_kv_cache, self.dim)
         float_out = self.float_sdpa(input_pos, q, k, v, 1, self.seq_len, None)
         quantized_out = self.quantized_sdpa(input_pos, q, k, v, 1, self.seq_len, None)
+        # Attention reads the int8 cache, including the new tokens, and
+        # quantizes the query rows for the integer q @ k.T.
         torch.testing.assert_close(
             float_out,
             quantized_out,
+            rtol=1e-02,
+            atol=1e-02,
         )
 
         input_pos = torch.tensor([3], dtype=torch.int64)
@@ -76,6 +80,6 @@ class SDPAWithQuantizedKVCacheTest(unittest.TestCase):
         torch.testing.assert_close(
             float_out,
             quantized_out,
-            rtol=1e-03,
-            atol=1e-03,
+            rtol=1e-02,
+            atol=1e-02,
         )
@@ -25,3 +25,19 @@ def define_common_targets():
                 ],
                 **get_oss_build_kwargs()
             )
+
+    runtime.cxx_binary(
+        name = "benchmark",
+        srcs = [
+            "benchmark.cpp",
+        ],
+        compiler_flags = ["-Wno-global-constructors"],
+        deps = [
+            "//executorch/examples/models/llama/runner:runner",
+            "//executorch/extension/threadpool:threadpool",
+        ],
+        external_deps = [
+            "gflags",
+        ],
+        **get_oss_build_kwargs()
+    )
@@ -31,6 +31,35 @@ class PreprocessConfig:
     possible_resolutions: Optional[List[Tuple[int, int]]] = None
 
 
+class FusedCLIPImageTransform(torch.nn.Module):
+    """
+    _CLIPImageTransform as a single preprocess::resize_normalize_tile_crop op,
+    which resizes, pads, normalizes and tiles the image in one pass over the
+    output instead of materializing each intermediate image. Only supports
+    bilinear resampling without antialiasing.
+    """
+
+    def __init__(self, config: PreprocessConfig):
+        super().__init__()
+        self.image_mean = config.image_mean or []
+        self.image_std = config.image_std or []
+        self.tile_size = config.tile_size
+
+    def forward(
+        self, image: torch.Tensor, target_size: torch.Tensor, canvas_size: torch.Tensor
+    ) -> Tuple[torch.Tensor, torch.Tensor]:
+        tiles = torch.ops.preprocess.resize_normalize_tile_crop.default(
+            image,
+            target_size,
+            canvas_size,
+            self.image_mean,
+            self.image_std,
+            self.tile_size,
+        )
+        aspect_ratio = canvas_size // self.tile_size
+        return tiles, aspect_ratio
+
+
 class CLIPImageTransformModel(EagerModelBase):
     def __init__(
         self,
@@ -51,6 +80,11 @@ class CLIPImageTransformModel(EagerModelBase):
         # Replace non-exportable ops with custom ops.
         self.model.tile_crop = torch.ops.preprocess.tile_crop.default
 
+        # Replace the whole transform with the fused op where it supports the
+        # config.
+        if config.resample == "bilinear" and not config.antialias:
+            self.model = FusedCLIPImageTransform(config)
+
     def get_eager_model(self) -> torch.nn.Module:
         return self.model
 
@@ -17,7 +17,11 @@ from executorch.examples.models.checkpoint import (
 )
 
 from executorch.examples.models.model_base import EagerModelBase
-from executorch.extension.llm.modules.attention import replace_mha_with_inference_mha
+from executorch.extension.llm.modules.attention import (
+    CrossAttentionKV,
+    DecoderWithCrossAttentionKV,
+    replace_mha_with_inference_mha,
+)
 from torchtune.models.llama3_2_vision._component_builders import llama3_2_vision_decoder
 from torchtune.models.llama3_2_vision._convert_weights import llama3_vision_meta_to_tune
 
@@ -52,6 +56,10 @@ class Llama3_2Decoder(EagerModelBase):
         self.enable_dynamic_shape = kwargs.get("enable_dynamic_shape", False)
         self.output_prune_map_path = kwargs.get("output_prune_map_path", None)
         self.use_kv_cache = kwargs.get("use_kv_cache", False)
+        # Take the keys and values of the cross-attention layers as inputs,
+        # computed once per image by get_cross_attention_kv_module(), instead
+        # of projecting the encoder output at every decode step.
+        self.cross_attention_kv_inputs = kwargs.get("cross_attention_kv_inputs", False)
         self.verbose = kwargs.get("verbose", False)
         self.args = kwargs.get("args", None)
         self.dtype = kwargs.get("dtype", torch.float16)
@@ -159,9 +167,38 @@ class Llama3_2Decoder(EagerModelBase):
         self.n_tokens = 34
         self.model_.to(self.dtype)
 
+        self.cross_attention_kv_ = None
+        self.decoder_with_cross_attention_kv_ = None
+        if self.cross_attention_kv_inputs:
+            if not self.use_kv_cache:
+                raise ValueError("cross_attention_kv_inputs requires use_kv_cache.")
+            self.cross_attention_kv_ = CrossAttentionKV(self.model_)
+            self.decoder_with_cross_attention_kv_ = DecoderWithCrossAttentionKV(
+                self.model_
+            )
+
     def get_eager_model(self) -> torch.nn.Module:
+        if self.cross_attention_kv_inputs:
+            return self.decoder_with_cross_attention_kv_
         return self.model_
 
+    def get_cross_attention_kv_module(self) -> torch.nn.Module:
+        """
+        The module to export as the method that fills the cross-attention KV
+        cache of the runner from the encoder output, when the decoder takes
+        the keys and values as inputs.
+        """
+        if not self.cross_attention_kv_inputs:
+            raise ValueError("The decoder does not take cross-attention KV inputs.")
+        return self.cross_attention_kv_
+
+    def get_cross_attention_kv_example_inputs(self):
+        return (
+            torch.randn(
+                1, self.encoder_max_seq_len, self.model_.dim, dtype=self.dtype
+            ),
+        )
+
     def get_example_inputs(self):
         return (torch.ones(1, self.n_tokens, dtype=torch.int64),)
 
@@ -180,7 +217,20 @@ class Llama3_2Decoder(EagerModelBase):
         contiguous_mask.data.copy_(mask.data)
 
         # Hardcoding # of tiles to be 2. image tokens per tile is 1601.
-        if self.use_kv_cache:
+        if self.cross_attention_kv_inputs:
+            with torch.no_grad():
+                cross_kv = self.cross_attention_kv_(
+                    *self.get_cross_attention_kv_example_inputs()
+                )
+            return {
+                "input_pos": contiguous_input_pos,
+                "mask": contiguous_mask,
+                "encoder_mask": torch.ones(
+                    [1, self.n_tokens, self.encoder_max_seq_len], dtype=torch.bool
+                ),
+                "cross_kv": cross_kv,
+            }
+        elif self.use_kv_cache:
             return {
                 "input_pos": contiguous_input_pos,
                 "mask": contiguous_mask,
@@ -198,7 +248,15 @@ class Llama3_2Decoder(EagerModelBase):
         batch_size = 1
         dim_seq_len = torch.export.Dim("token_dim", min=1, max=self.max_seq_len)
         # Hardcoding # of tiles to be 2. image tokens per tile is 1601.
-        if self.use_kv_cache:
+        if self.cross_attention_kv_inputs:
+            dynamic_shapes = {
+                "tokens": {0: batch_size, 1: dim_seq_len},
+                "encoder_mask": {0: 1, 1: dim_seq_len, 2: None},
+                "mask": {0: batch_size, 1: dim_seq_len, 2: None},
+                "input_pos": {0: batch_size, 1: dim_seq_len},
+                "cross_kv": None,
+            }
+        elif self.use_kv_cache:
             dynamic_shapes = {
                 "tokens": {0: batch_size, 1: dim_seq_len},
                 "encoder_input": None,
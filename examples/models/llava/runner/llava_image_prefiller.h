@@ -29,28 +29,55 @@ class ET_EXPERIMENTAL LlavaImagePrefiller
   inline ::executorch::runtime::Result<exec_aten::Tensor> prefill(
       ::executorch::extension::llm::Image& image,
       int64_t& start_pos) override {
+    auto embeddings = ET_UNWRAP(encode(image));
+    return prefill_embeddings(embeddings, start_pos);
+  }
+
+  /**
+   * Run the image encoder on the given image input.
+   * @param image The image input to LLaVa.
+   * @return A copy of the image embeddings, which the next execution of the
+   * image encoder does not overwrite.
+   */
+  inline ::executorch::runtime::Result<::executorch::extension::TensorPtr>
+  encode(::executorch::extension::llm::Image& image) override {
     auto image_tensor = executorch::extension::from_blob(
         image.data.data(),
         {3, image.height, image.width},
         ::executorch::aten::ScalarType::Byte);
-    // Run image encoder
     auto image_encoder_outputs =
         ET_UNWRAP(module_->execute(kImageEncoderMethod, image_tensor));
+    ET_CHECK_OR_RETURN_ERROR(
+        image_encoder_outputs[0].isTensor(),
+        InvalidState,
+        "Non Tensor Output returned from executing image encoder");
+    return executorch::extension::clone_tensor_ptr(
+        image_encoder_outputs[0].toTensor());
+  }
 
+  /**
+   * Prefill an LLM Module with the image embeddings returned by encode().
+   * @param embeddings The image embeddings.
+   * @param start_pos The starting position in KV cache of the input in the LLM
+   * @return logits of the image prefill.
+   */
+  inline ::executorch::runtime::Result<exec_aten::Tensor> prefill_embeddings(
+      const ::executorch::extension::TensorPtr& embeddings,
+      int64_t& start_pos) override {
     // inputs:[start_pos, embeds]
     auto start_pos_tensor = executorch::extension::from_blob(
         &start_pos, {1}, ::executorch::aten::ScalarType::Long);
 
     // Run text model
-    auto outputs_res = ET_UNWRAP(module_->execute(
-        kTextModelMethod, {start_pos_tensor, image_encoder_outputs[0]}));
+    auto outputs_res = ET_UNWRAP(
+        module_->execute(kTextModelMethod, {start_pos_tensor, embeddings}));
     ET_CHECK_MSG(
         outputs_res[0].isTensor(),
         "Non Tensor Output returned from executing image prefill");
 
     // Update the start_pos, which is only available inside this function.
     // outputs_res can have only one logits.
-    start_pos += image_encoder_outputs[0].toTensor().size(1);
+    start_pos += embeddings->size(1);
 
     return outputs_res[0].toTensor();
   }
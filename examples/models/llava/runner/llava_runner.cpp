@@ -16,6 +16,7 @@
 #include <executorch/extension/llm/tokenizer/bpe_tokenizer.h>
 
 #include <ctime>
+#include <future>
 #include <memory>
 #include <sstream>
 #include <vector>
@@ -74,12 +75,65 @@ Error LlavaRunner::load() {
   return Error::Ok;
 }
 
+Result<std::vector<::executorch::extension::TensorPtr>>
+LlavaRunner::encode_images(std::vector<llm::Image>& images) {
+  std::vector<::executorch::extension::TensorPtr> embeddings;
+  embeddings.reserve(images.size());
+  for (auto& image : images) {
+    auto image_embeddings = image_embedding_cache_.get(image);
+    if (!image_embeddings) {
+      image_embeddings = ET_UNWRAP(image_prefiller_->encode(image));
+      image_embedding_cache_.put(image, image_embeddings);
+    }
+    embeddings.push_back(std::move(image_embeddings));
+  }
+  return embeddings;
+}
+
 Error LlavaRunner::prefill_images(
     std::vector<llm::Image>& images,
     int64_t& start_pos) {
-  for (auto& image : images) {
+  const auto embeddings = ET_UNWRAP(encode_images(images));
+  for (const auto& image_embeddings : embeddings) {
+    // pos is updated inside image prefill.
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        image_prefiller_->prefill_embeddings(image_embeddings, start_pos)
+            .error());
+  }
+  return Error::Ok;
+}
+
+Error LlavaRunner::prefill_prompt_and_images(
+    const std::string& prompt,
+    std::vector<llm::Image>& images,
+    int64_t& start_pos,
+    int8_t bos) {
+  if (!pipeline_image_encoding_ || images.empty()) {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        prefill_prompt(prompt, start_pos, bos, /*eos*/ 0).error());
+    return prefill_images(images, start_pos);
+  }
+
+  // The image encoder and the text model are separate methods with their own
+  // planned memory, so the images can be encoded while the prompt in front
+  // of them is prefilled. Only splicing the embeddings into the KV cache has
+  // to wait for the prompt.
+  auto encoded = std::async(std::launch::async, [this, &images]() {
+    const auto scope =
+        image_encoder_scope_ ? image_encoder_scope_() : nullptr;
+    return encode_images(images);
+  });
+  const auto prompt_error =
+      prefill_prompt(prompt, start_pos, bos, /*eos*/ 0).error();
+  // Wait for the encoder even if the prompt failed, since it uses images.
+  auto embeddings = encoded.get();
+  ET_CHECK_OK_OR_RETURN_ERROR(prompt_error);
+  ET_CHECK_OK_OR_RETURN_ERROR(embeddings.error());
+  for (const auto& image_embeddings : embeddings.get()) {
     // pos is updated inside image prefill.
-    ET_UNWRAP(image_prefiller_->prefill(image, start_pos));
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        image_prefiller_->prefill_embeddings(image_embeddings, start_pos)
+            .error());
   }
   return Error::Ok;
 }
@@ -156,11 +210,9 @@ Error LlavaRunner::generate(
   int64_t pos = 0;
   stats_.inference_start_ms = llm::time_in_ms();
 
-  // prefill preset prompt
-  prefill_prompt(kPresetPrompt, pos, /*bos=*/1, /*eos*/ 0);
-
-  // prefill images
-  prefill_images(images, pos);
+  // prefill preset prompt and images
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      prefill_prompt_and_images(kPresetPrompt, images, pos, /*bos=*/1));
 
   ET_LOG(
       Info,
@@ -63,6 +63,18 @@ class ET_EXPERIMENTAL LlavaRunner
       bool echo = true) override;
 
  private:
+  // Returns the embeddings of the images, encoding those that are not cached.
+  ::executorch::runtime::Result<std::vector<::executorch::extension::TensorPtr>>
+  encode_images(std::vector<::executorch::extension::llm::Image>& images);
+
+  // Prefills the prompt followed by the images. The images are encoded on
+  // another thread while the prompt is prefilled, if enabled.
+  ::executorch::runtime::Error prefill_prompt_and_images(
+      const std::string& prompt,
+      std::vector<::executorch::extension::llm::Image>& images,
+      int64_t& start_pos,
+      int8_t bos);
+
   inline static const std::string kPresetPrompt =
       "A chat between a curious human and an artificial intelligence assistant. The assistant gives helpful, detailed, and polite answers to the human's questions. USER: ";
 };
@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include <gflags/gflags.h>
 
@@ -36,6 +37,11 @@ DEFINE_string(
     model_path,
     "model.pte",
     "Model serialized in flatbuffer format.");
+DEFINE_uint32(
+    constant_scratch_bytes,
+    0,
+    "If nonzero, stream the constants of each instruction through a scratch "
+    "buffer of this size instead of keeping them all in memory.");
 
 using executorch::extension::FileDataLoader;
 using executorch::runtime::Error;
@@ -74,7 +80,11 @@ int main(int argc, char** argv) {
 
   // Parse the program file. This is immutable, and can also be reused between
   // multiple execution invocations across multiple threads.
-  Result<Program> program = Program::load(&loader.get());
+  Result<Program> program = Program::load(
+      &loader.get(),
+      Program::Verification::Minimal,
+      FLAGS_constant_scratch_bytes > 0 ? Program::ConstantLoading::Streamed
+                                       : Program::ConstantLoading::Eager);
   if (!program.ok()) {
     ET_LOG(Error, "Failed to parse model file %s", model_path);
     return 1;
@@ -142,9 +152,19 @@ int main(int argc, char** argv) {
   HierarchicalAllocator planned_memory(
       {planned_spans.data(), planned_spans.size()});
 
+  // With streamed constants, the method loads the constants of each
+  // instruction into this buffer right before the instruction runs. On
+  // microcontrollers, it would typically be placed in SRAM while the program
+  // stays in flash.
+  std::vector<uint8_t> constant_scratch(FLAGS_constant_scratch_bytes);
+
   // Assemble all of the allocators into the MemoryManager that the Executor
   // will use.
-  MemoryManager memory_manager(&method_allocator, &planned_memory);
+  MemoryManager memory_manager(
+      &method_allocator,
+      &planned_memory,
+      /*temp_allocator=*/nullptr,
+      {constant_scratch.data(), constant_scratch.size()});
 
   //
   // Load the method from the program, using the provided allocators. Running
@@ -0,0 +1,197 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+"""Chunked LZ4 compression of segment data.
+
+A segment compressed with SegmentCompression.LZ4_CHUNKED contains, with all
+integers little-endian:
+
+- The header:
+  - magic: 4 bytes, b"EZ01".
+  - chunk_size: uint32. The size of the uncompressed data of each chunk, except
+    for the last one, which may be smaller.
+  - uncompressed_size: uint64. The size of the whole uncompressed data.
+  - num_chunks: uint64.
+- The table of chunks: num_chunks uint64 values, the end offset of the
+  compressed data of each chunk, relative to the end of the table. Each chunk
+  starts where the previous one ends, and the first one at the end of the
+  table.
+- The compressed data of each chunk. A chunk whose compressed size equals its
+  uncompressed size is stored as is; any other chunk is an LZ4 block, see
+  https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md.
+
+The chunks are compressed independently, so loaders can decompress them in
+parallel, or decompress only the ones that hold the data they need. The
+runtime side is extension/data_loader/decompressing_data_loader.cpp.
+"""
+
+import struct
+from typing import List
+
+_MAGIC: bytes = b"EZ01"
+_HEADER_FORMAT: str = "<4sIQQ"
+_HEADER_LENGTH: int = struct.calcsize(_HEADER_FORMAT)
+
+# The default size of the uncompressed data of a chunk.
+DEFAULT_CHUNK_SIZE: int = 1024 * 1024
+
+# Constraints of the LZ4 block format: matches are at least 4 bytes long and
+# at most 65535 bytes back, the last match starts at least 12 bytes before the
+# end of the block, and the last 5 bytes are literals.
+_MIN_MATCH: int = 4
+_MAX_OFFSET: int = 65535
+_MATCH_START_LIMIT: int = 12
+_LAST_LITERALS: int = 5
+
+
+def _append_length(out: bytearray, length: int) -> None:
+    # Lengths of 15 or more continue in bytes after the token.
+    length -= 15
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _append_sequence(
+    out: bytearray, literals: bytes, offset: int = 0, match_length: int = 0
+) -> None:
+    literal_token = min(len(literals), 15)
+    match_token = min(match_length - _MIN_MATCH, 15) if offset else 0
+    out.append((literal_token << 4) | match_token)
+    if literal_token == 15:
+        _append_length(out, len(literals))
+    out += literals
+    if offset:
+        out += struct.pack("<H", offset)
+        if match_token == 15:
+            _append_length(out, match_length - _MIN_MATCH)
+
+
+def _lz4_compress_block_fallback(data: bytes) -> bytes:
+    # A greedy compressor that matches each position against the last one
+    # with the same 4 bytes. Much slower than the lz4 package, but has no
+    # dependencies.
+    out = bytearray()
+    last_position = {}
+    anchor = 0
+    position = 0
+    match_start_end = len(data) - _MATCH_START_LIMIT
+    while position <= match_start_end:
+        key = data[position : position + _MIN_MATCH]
+        candidate = last_position.get(key)
+        last_position[key] = position
+        if candidate is None or position - candidate > _MAX_OFFSET:
+            position += 1
+            continue
+        length = _MIN_MATCH
+        max_length = len(data) - _LAST_LITERALS - position
+        while (
+            length < max_length and data[candidate + length] == data[position + length]
+        ):
+            length += 1
+        _append_sequence(out, data[anchor:position], position - candidate, length)
+        position += length
+        anchor = position
+    _append_sequence(out, data[anchor:])
+    return bytes(out)
+
+
+def lz4_compress_block(data: bytes) -> bytes:
+    """Returns `data` compressed as an LZ4 block, without its size."""
+    try:
+        import lz4.block  # pyre-ignore[21]
+
+        return lz4.block.compress(data, store_size=False)
+    except ImportError:
+        return _lz4_compress_block_fallback(data)
+
+
+def lz4_decompress_block(data: bytes, uncompressed_size: int) -> bytes:
+    """Returns the decompressed contents of an LZ4 block."""
+    out = bytearray()
+    position = 0
+
+    def read_length(length: int) -> int:
+        nonlocal position
+        if length == 15:
+            while True:
+                extra = data[position]
+                position += 1
+                length += extra
+                if extra != 255:
+                    break
+        return length
+
+    while position < len(data):
+        token = data[position]
+        position += 1
+        literal_length = read_length(token >> 4)
+        out += data[position : position + literal_length]
+        position += literal_length
+        if position >= len(data):
+            break
+        (offset,) = struct.unpack_from("<H", data, position)
+        position += 2
+        match_length = read_length(token & 15) + _MIN_MATCH
+        if offset == 0 or offset > len(out):
+            raise ValueError(f"Invalid LZ4 match offset {offset}")
+        start = len(out) - offset
+        for i in range(match_length):
+            out.append(out[start + i])
+    if len(out) != uncompressed_size:
+        raise ValueError(
+            f"LZ4 block decompressed to {len(out)} bytes, expected {uncompressed_size}"
+        )
+    return bytes(out)
+
+
+def compress_chunked(data: bytes, chunk_size: int = DEFAULT_CHUNK_SIZE) -> bytes:
+    """Returns `data` compressed in the LZ4_CHUNKED layout."""
+    if chunk_size <= 0 or chunk_size >= 2**32:
+        raise ValueError(f"Invalid chunk size {chunk_size}")
+    chunks: List[bytes] = []
+    for start in range(0, len(data), chunk_size):
+        chunk = bytes(data[start : start + chunk_size])
+        compressed = lz4_compress_block(chunk)
+        # Store the chunk as is if compressing it does not help.
+        chunks.append(compressed if len(compressed) < len(chunk) else chunk)
+    ends: List[int] = []
+    end = 0
+    for chunk in chunks:
+        end += len(chunk)
+        ends.append(end)
+    header = struct.pack(_HEADER_FORMAT, _MAGIC, chunk_size, len(data), len(chunks))
+    table = struct.pack(f"<{len(ends)}Q", *ends)
+    return header + table + b"".join(chunks)
+
+
+def decompress_chunked(data: bytes) -> bytes:
+    """Returns the data of a segment compressed in the LZ4_CHUNKED layout."""
+    if len(data) < _HEADER_LENGTH:
+        raise ValueError(f"Compressed segment of {len(data)} bytes is too small")
+    magic, chunk_size, uncompressed_size, num_chunks = struct.unpack_from(
+        _HEADER_FORMAT, data
+    )
+    if magic != _MAGIC:
+        raise ValueError(f"Unexpected compressed segment magic {magic!r}")
+    ends = struct.unpack_from(f"<{num_chunks}Q", data, _HEADER_LENGTH)
+    base = _HEADER_LENGTH + 8 * num_chunks
+    out = bytearray()
+    start = 0
+    for index, end in enumerate(ends):
+        chunk = data[base + start : base + end]
+        size = min(chunk_size, uncompressed_size - index * chunk_size)
+        out += chunk if len(chunk) == size else lz4_decompress_block(chunk, size)
+        start = end
+    if len(out) != uncompressed_size:
+        raise ValueError(
+            f"Compressed segment decompressed to {len(out)} bytes, "
+            f"expected {uncompressed_size}"
+        )
+    return bytes(out)
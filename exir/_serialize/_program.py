@@ -7,12 +7,17 @@
 # pyre-strict
 
 import copy
+import hashlib
 import json
 import re
 
 from dataclasses import dataclass
-from typing import ClassVar, List, Literal, Optional, Tuple
+from typing import ClassVar, Dict, List, Literal, Optional, Tuple
 
+from executorch.exir._serialize._compression import (
+    compress_chunked,
+    decompress_chunked,
+)
 from executorch.exir._serialize._cord import Cord
 from executorch.exir._serialize._dataclass import _DataclassEncoder, _json_to_dataclass
 from executorch.exir._serialize._flatbuffer import (
@@ -27,8 +32,15 @@ from executorch.exir.schema import (
     Buffer,
     DataLocation,
     DataSegment,
+    DelegateCall,
+    ExecutionPlan,
+    KernelCall,
+    OptionalTensorList,
     Program,
+    SegmentCompression,
     SubsegmentOffsets,
+    Tensor,
+    TensorList,
 )
 from executorch.exir.tensor import ALIGNMENT
 
@@ -248,55 +260,80 @@ def _extract_delegate_segments(
     """Extracts the delegate segments inlined in the program into a list of buffers.
         The program is modified in-place to remove the delegate data.
 
+    Delegate data with the same contents, e.g. weights that the delegates of
+    several methods share through Program.named_data, is extracted into a single
+    segment that all of its references point to.
+
     Args:
         program: The program to extract segments from. Modified in-place.
         segments: A list of buffers to append extracted segments to. Modified in-place.
     """
     remaining_inline: List[BackendDelegateInlineData] = []
-    inline_indices_seen: set[int] = set()
-    for plan in program.execution_plan:
-        for delegate in plan.delegates:
-            if delegate.processed.location != DataLocation.INLINE:
-                raise ValueError(
-                    "Program must only contain inline delegate data, "
-                    + f"saw {repr(delegate)}"
-                )
-            # TODO(T144120904): Don't extract small blobs into segments;
-            # have a cutoff. Or callers could provide a callback that
-            # returns true/false for a given BackendDelegate, letting them
-            # use their own logic.
-            try:
-                inline: BackendDelegateInlineData = program.backend_delegate_data[
-                    delegate.processed.index
-                ]
-            except IndexError:
-                raise ValueError(
-                    f"Delegate processed index {delegate.processed.index} "
-                    + ">= len(Program.backend_delegate_data) "
-                    + f"{len(program.backend_delegate_data)} "
-                    + f"in {repr(delegate)}"
-                )
-            inline_indices_seen.add(delegate.processed.index)
-            if inline.data:
-                # Move the delegate data out of the program.
+    # The new reference for each index into backend_delegate_data.
+    moved: Dict[int, BackendDelegateDataReference] = {}
+    # {sha256 of the data: index of the segment holding it}
+    segment_by_hash: Dict[str, int] = {}
+
+    def extract(processed: BackendDelegateDataReference, owner: str) -> None:
+        if processed.location != DataLocation.INLINE:
+            raise ValueError(
+                "Program must only contain inline delegate data, " + f"saw {owner}"
+            )
+        if processed.index in moved:
+            new_reference = moved[processed.index]
+            processed.location = new_reference.location
+            processed.index = new_reference.index
+            return
+        # TODO(T144120904): Don't extract small blobs into segments;
+        # have a cutoff. Or callers could provide a callback that
+        # returns true/false for a given BackendDelegate, letting them
+        # use their own logic.
+        try:
+            inline: BackendDelegateInlineData = program.backend_delegate_data[
+                processed.index
+            ]
+        except IndexError:
+            raise ValueError(
+                f"Delegate processed index {processed.index} "
+                + ">= len(Program.backend_delegate_data) "
+                + f"{len(program.backend_delegate_data)} "
+                + f"in {owner}"
+            )
+        if inline.data:
+            # Move the delegate data out of the program.
+            hashed = hashlib.sha256(inline.data).hexdigest()
+            segment_index = segment_by_hash.get(hashed)
+            if segment_index is None:
                 segment_index = len(segments)
                 segments.append(Cord(inline.data))
-                delegate.processed = BackendDelegateDataReference(
-                    location=DataLocation.SEGMENT,
-                    index=segment_index,
-                )
-            else:
-                # Not moving into a segment. Keep it inline, but update the
-                # index.
-                new_index = len(remaining_inline)
-                remaining_inline.append(inline)
-                delegate.processed.index = new_index
+                segment_by_hash[hashed] = segment_index
+            new_reference = BackendDelegateDataReference(
+                location=DataLocation.SEGMENT,
+                index=segment_index,
+            )
+        else:
+            # Not moving into a segment. Keep it inline, but update the
+            # index.
+            new_reference = BackendDelegateDataReference(
+                location=DataLocation.INLINE,
+                index=len(remaining_inline),
+            )
+            remaining_inline.append(inline)
+        moved[processed.index] = new_reference
+        processed.location = new_reference.location
+        processed.index = new_reference.index
+
+    for plan in program.execution_plan:
+        for delegate in plan.delegates:
+            extract(delegate.processed, repr(delegate))
+    for named_data in program.named_data or []:
+        extract(named_data.data, repr(named_data))
 
     # Make sure we visited all entries in backend_delegate_data, so that it's
     # safe to overwrite it.
     remaining_indices: set[int] = set(
         range(len(program.backend_delegate_data))
-    ).difference(inline_indices_seen)
+    ).difference(moved)
     if remaining_indices:
         raise ValueError(
             "Did not handle all elements of backend_delegate_data; "
@@ -307,9 +344,47 @@ def _extract_delegate_segments(
     program.backend_delegate_data = remaining_inline
 
 
+def _constant_first_use_order(program: Program) -> List[int]:
+    """Returns the indices of program.constant_buffer in the order that the
+    instructions of the execution plans first use them.
+
+    Buffers of tensors that no instruction uses follow in the order of the
+    values that refer to them, and buffers that no value refers to come last.
+    """
+    # Insertion-ordered set of buffer indices.
+    order: Dict[int, None] = {}
+
+    def visit(plan: ExecutionPlan, value_index: int) -> None:
+        # Optional tensor lists use -1 for None.
+        if value_index < 0 or value_index >= len(plan.values):
+            return
+        val = plan.values[value_index].val
+        if isinstance(val, Tensor):
+            if val.allocation_info is None and val.data_buffer_idx > 0:
+                order.setdefault(val.data_buffer_idx)
+        elif isinstance(val, (TensorList, OptionalTensorList)):
+            for item in val.items:
+                visit(plan, item)
+
+    for plan in program.execution_plan:
+        for chain in plan.chains:
+            for instruction in chain.instructions:
+                args = instruction.instr_args
+                if isinstance(args, (KernelCall, DelegateCall)):
+                    for arg in args.args:
+                        visit(plan, arg)
+        for value_index in range(len(plan.values)):
+            visit(plan, value_index)
+    for index in range(len(program.constant_buffer)):
+        order.setdefault(index)
+    return list(order)
+
+
 def _extract_constant_segment(
     constant_buffer: List[Buffer],
     tensor_alignment: Optional[int] = None,
+    order: Optional[List[int]] = None,
+    page_alignment: Optional[int] = None,
 ) -> Tuple[Cord, List[int]]:
     """Copies the tensors from the provided list into a Cord and tracks the offsets
         of each tensor.
@@ -318,26 +393,49 @@ def _extract_constant_segment(
         constant_buffer: list of Buffers from which to extract constants from. Not modified.
         tensor_alignment: Alignment in bytes. Each tensor in the cord will be padded to align
             with this value. Defaults to ALIGNMENT.
+        order: If provided, the order of the indices of constant_buffer in the
+            cord. Defaults to the order of constant_buffer.
+        page_alignment: If provided, tensors of at least this many bytes are
+            aligned to this value instead of tensor_alignment.
+
+    If either order or page_alignment is provided, empty buffers are placed at
+    the end of the cord.
 
     Returns:
         A tuple of (constant segment, list of offsets for each tensor in the segment)
     """
     constant_segment_data: Cord = Cord()
-    constant_segment_offsets: List[int] = []
+    constant_segment_offsets: List[int] = [0] * len(constant_buffer)
     current_offset: int = 0
-    for i in range(len(constant_buffer)):
+    empty_buffers: List[int] = []
+    move_empty_buffers = order is not None or page_alignment is not None
+    for i in order if order is not None else range(len(constant_buffer)):
         buffer = constant_buffer[i]
-        constant_segment_data.append(buffer.storage)
         buffer_length = len(buffer.storage)
+        if move_empty_buffers and buffer_length == 0:
+            # Place empty buffers after all the data, so that none shares its
+            # offset with a tensor that precedes it in constant_buffer or with
+            # padding, which _restore_segments() would attribute to it.
+            empty_buffers.append(i)
+            continue
+        alignment = tensor_alignment
+        if page_alignment is not None and buffer_length >= page_alignment:
+            alignment = page_alignment
+        # Pad the end of the previous tensor, so there is never padding after
+        # the last one.
         pad_length = (
-            _padding_required(buffer_length, tensor_alignment)
-            if tensor_alignment is not None
+            _padding_required(current_offset, alignment)
+            if alignment is not None
             else 0
         )
-        if i < len(constant_buffer) - 1:
+        if pad_length > 0:
             constant_segment_data.append(b"\x00" * pad_length)
-        constant_segment_offsets.append(current_offset)
-        current_offset += buffer_length + pad_length
+        current_offset += pad_length
+        constant_segment_data.append(buffer.storage)
+        constant_segment_offsets[i] = current_offset
+        current_offset += buffer_length
+    for i in empty_buffers:
+        constant_segment_offsets[i] = current_offset
 
     return constant_segment_data, constant_segment_offsets
 
@@ -350,6 +448,9 @@ def serialize_pte_binary(
     segment_alignment: int = 128,
     constant_tensor_alignment: Optional[int] = None,
     delegate_alignment: Optional[int] = None,
+    compress_constant_segment: bool = False,
+    order_constants_by_first_use: bool = False,
+    constant_page_alignment: Optional[int] = None,
 ) -> Cord:
     """Returns the runtime binary representation of the given Program.
 
@@ -369,6 +470,16 @@ def serialize_pte_binary(
         delegate_alignment: If provided, the minimum alignment of delegate data
             in the program. Must be a power of 2. If not provided, uses the
             value in the schema file.
+        compress_constant_segment: Whether to compress the constant segment
+            with SegmentCompression.LZ4_CHUNKED. The runtime must then load
+            the program through a DecompressingDataLoader.
+        order_constants_by_first_use: Whether to lay out the constant tensors
+            in the order that the execution plans first use them, rather than
+            in the order of Program.constant_buffer.
+        constant_page_alignment: If provided, constant tensors of at least
+            this many bytes are aligned to this value in the output data, e.g.
+            the page size. Must be a power of 2. Segments are then aligned to
+            at least this value too.
     Returns:
         The serialized form of the Program, ready for execution by the runtime.
     """
@@ -376,6 +487,17 @@ def serialize_pte_binary(
     if constant_tensor_alignment is None:
         constant_tensor_alignment = ALIGNMENT
 
+    if constant_page_alignment is not None:
+        if constant_page_alignment <= 0 or (
+            constant_page_alignment & (constant_page_alignment - 1)
+        ):
+            raise ValueError(
+                f"constant_page_alignment {constant_page_alignment} "
+                "must be a power of 2"
+            )
+        # Offsets in the constant segment are relative to its start.
+        segment_alignment = max(segment_alignment, constant_page_alignment)
+
     # Don't modify the original program.
     # TODO(T144120904): Could avoid yet more huge copies with a more shallow
     # copy, reusing the actual data blobs.
@@ -383,9 +505,19 @@ def serialize_pte_binary(
 
     # Store extracted segment data; this may be constant data or delegate data.
     segments: List[Cord] = []
+    # The compression and uncompressed size of the segments that are compressed,
+    # by segment index.
+    compressed_segments: Dict[int, Tuple[SegmentCompression, int]] = {}
 
     constant_segment_data, constant_segment_offsets = _extract_constant_segment(
-        program.constant_buffer, tensor_alignment=constant_tensor_alignment
+        program.constant_buffer,
+        tensor_alignment=constant_tensor_alignment,
+        order=(
+            _constant_first_use_order(program)
+            if order_constants_by_first_use
+            else None
+        ),
+        page_alignment=constant_page_alignment,
     )
 
     # If there are no constants, len(constant_segment_data) = 0. However, there may
@@ -399,6 +531,14 @@ def serialize_pte_binary(
         )
         # Clear the constant buffer, as constant data will be stored in segments.
         program.constant_buffer = []
+        if compress_constant_segment and len(constant_segment_data) > 0:
+            compressed_segments[len(segments)] = (
+                SegmentCompression.LZ4_CHUNKED,
+                len(constant_segment_data),
+            )
+            constant_segment_data = Cord(
+                compress_chunked(bytes(constant_segment_data))
+            )
         # Add to the aggregate segments cord.
         segments.append(constant_segment_data)
 
@@ -424,15 +564,21 @@ def serialize_pte_binary(
     # each segment begins at the required alignment.
     # Update program.segments with the offsets to each segment.
     segments_data = Cord()
-    for data in segments:
+    for index, data in enumerate(segments):
         prev_end = (
             (program.segments[-1].offset + program.segments[-1].size)
             if program.segments
             else 0
         )
+        compression, uncompressed_size = compressed_segments.get(
+            index, (SegmentCompression.NONE, 0)
+        )
         program.segments.append(
             DataSegment(
-                offset=_aligned_size(prev_end, segment_alignment), size=len(data)
+                offset=_aligned_size(prev_end, segment_alignment),
+                size=len(data),
+                compression=compression,
+                uncompressed_size=uncompressed_size,
             )
         )
         # Add to aggregate segments cord with padding.
@@ -529,44 +675,57 @@ def _restore_segments(program: Program, segment_data: bytes) -> Program:
             raise ValueError(
                 f"Segment {i} {segment} overflows data length {len(segment_data)}"
             )
-        segments.append(segment_data[segment.offset : segment.offset + segment.size])
+        data = segment_data[segment.offset : segment.offset + segment.size]
+        if segment.compression == SegmentCompression.LZ4_CHUNKED:
+            data = decompress_chunked(data)
+        elif segment.compression != SegmentCompression.NONE:
+            raise ValueError(f"Segment {i} has unknown compression {segment}")
+        segments.append(data)
 
     # Find and replace the Program's references to these segments, inlining the
-    # data.
-    for plan_index, plan in enumerate(program.execution_plan):
-        for delegate_index, delegate in enumerate(plan.delegates):
-            if delegate.processed.location == DataLocation.INLINE:
-                continue
-            assert delegate.processed.location == DataLocation.SEGMENT
-            index = delegate.processed.index
-            if index >= len(segments):
-                raise ValueError(
-                    f"Plan {plan_index} delegate {delegate_index} "
-                    + f"segment index {index} >= num segments {len(segments)}"
-                )
-
-            data_index: int = len(program.backend_delegate_data)
+    # data. References to the same segment share the inlined copy.
+    inlined: Dict[int, int] = {}
+
+    def inline(processed: BackendDelegateDataReference, owner: str) -> None:
+        if processed.location == DataLocation.INLINE:
+            return
+        assert processed.location == DataLocation.SEGMENT
+        index = processed.index
+        if index >= len(segments):
+            raise ValueError(
+                f"{owner} segment index {index} >= num segments {len(segments)}"
+            )
+        if index not in inlined:
+            inlined[index] = len(program.backend_delegate_data)
             program.backend_delegate_data.append(
                 BackendDelegateInlineData(data=segments[index])
             )
-            delegate.processed = BackendDelegateDataReference(
-                location=DataLocation.INLINE, index=data_index
-            )
+        processed.location = DataLocation.INLINE
+        processed.index = inlined[index]
+
+    for plan_index, plan in enumerate(program.execution_plan):
+        for delegate_index, delegate in enumerate(plan.delegates):
+            inline(delegate.processed, f"Plan {plan_index} delegate {delegate_index}")
+    for named_data in program.named_data or []:
+        inline(named_data.data, f"Named data {named_data.key!r}")
 
     # Replace constants from constant_segment into constant_buffer.
     if program.constant_segment and len(program.constant_segment.offsets) > 0:
         buffers: List[Buffer] = []
         constant_segment = segments[program.constant_segment.segment_index]
-        for i in range(len(program.constant_segment.offsets)):
-            start_offset = program.constant_segment.offsets[i]
+        offsets = program.constant_segment.offsets
+        # Tensors may be laid out in any order. Among tensors that start at
+        # the same offset, all but the last one are empty.
+        layout = sorted(range(len(offsets)), key=lambda i: (offsets[i], i))
+        end_offsets: List[int] = [len(constant_segment)] * len(offsets)
+        for i, j in zip(layout, layout[1:]):
             # Note: this is the original end offset plus any padding between
             # it and the next start offset.
-            end_offset = (
-                program.constant_segment.offsets[i + 1]
-                if i < len(program.constant_segment.offsets) - 1
-                else len(constant_segment)
+            end_offsets[i] = offsets[j]
+        for i in range(len(offsets)):
+            buffers.append(
+                Buffer(storage=constant_segment[offsets[i] : end_offsets[i]])
             )
-            buffers.append(Buffer(storage=constant_segment[start_offset:end_offset]))
         program.constant_buffer = buffers
         program.constant_segment.segment_index = 0
         program.constant_segment.offsets = []
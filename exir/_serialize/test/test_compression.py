@@ -0,0 +1,75 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import random
+import struct
+import unittest
+
+from executorch.exir._serialize._compression import (
+    _lz4_compress_block_fallback,
+    compress_chunked,
+    decompress_chunked,
+    lz4_decompress_block,
+)
+
+
+class TestCompression(unittest.TestCase):
+    def setUp(self) -> None:
+        rng = random.Random(0)
+        self.data_sets = [
+            b"",
+            b"x",
+            b"abc" * 1000,
+            bytes(70000),
+            bytes(rng.getrandbits(8) for _ in range(5000)),
+            b"".join(
+                rng.choice([b"weights ", b"bias ", bytes([rng.getrandbits(8)])])
+                for _ in range(5000)
+            ),
+        ]
+
+    def test_lz4_block_round_trip(self) -> None:
+        for data in self.data_sets:
+            compressed = _lz4_compress_block_fallback(data)
+            self.assertEqual(lz4_decompress_block(compressed, len(data)), data)
+
+    def test_lz4_block_follows_end_of_block_rules(self) -> None:
+        # The last 5 bytes of a block must be literals, so they must be the
+        # last bytes of the compressed data too.
+        data = b"abcd" * 100
+        compressed = _lz4_compress_block_fallback(data)
+        self.assertLess(len(compressed), len(data))
+        self.assertEqual(compressed[-5:], data[-5:])
+
+    def test_chunked_round_trip(self) -> None:
+        for data in self.data_sets:
+            for chunk_size in (7, 4096, 1 << 20):
+                compressed = compress_chunked(data, chunk_size)
+                self.assertEqual(decompress_chunked(compressed), data)
+
+    def test_chunked_layout(self) -> None:
+        data = b"abc" * 1000 + bytes(range(256))
+        compressed = compress_chunked(data, chunk_size=1024)
+        magic, chunk_size, uncompressed_size, num_chunks = struct.unpack_from(
+            "<4sIQQ", compressed
+        )
+        self.assertEqual(magic, b"EZ01")
+        self.assertEqual(chunk_size, 1024)
+        self.assertEqual(uncompressed_size, len(data))
+        self.assertEqual(num_chunks, 4)
+        ends = struct.unpack_from("<4Q", compressed, 24)
+        self.assertEqual(len(compressed), 24 + 8 * 4 + ends[-1])
+        # The last chunk is mostly incompressible, so it is stored as is.
+        self.assertEqual(compressed[24 + 8 * 4 + ends[2] :], data[3072:])
+
+    def test_bad_data_fails(self) -> None:
+        compressed = compress_chunked(b"abc" * 100)
+        with self.assertRaises(ValueError):
+            decompress_chunked(b"XXXX" + compressed[4:])
+        with self.assertRaises(ValueError):
+            decompress_chunked(compressed[:10])
@@ -32,8 +32,11 @@ from executorch.exir.schema import (
     ContainerMetadata,
     DataLocation,
     DataSegment,
+    EValue,
     ExecutionPlan,
+    NamedData,
     Program,
+    SegmentCompression,
     SubsegmentOffsets,
 )
 from executorch.exir.tests.common import get_test_program
@@ -97,10 +100,12 @@ def canonicalize_delegate_indices(program: Program) -> Program:
         print(f">>> Mapping [{i}]: {old_to_new_index[i]} '{data}'")
         program.backend_delegate_data.append(BackendDelegateInlineData(data=data))
 
-    # Patch up the index pointers from the BackendDelegate entries.
+    # Patch up the index pointers from the BackendDelegate and NamedData entries.
     for plan in program.execution_plan:
         for delegate in plan.delegates:
             delegate.processed.index = old_to_new_index[delegate.processed.index]
+    for named_data in program.named_data or []:
+        named_data.data.index = old_to_new_index[named_data.data.index]
 
     return program
 
@@ -650,6 +655,70 @@ class TestProgram(unittest.TestCase):
                 segment_alignment=SEGMENT_ALIGNMENT,
             )
 
+    def test_identical_delegate_data_shares_segments(self) -> None:
+        # Create a program whose delegates and named data refer to two copies of
+        # the same blob.
+        program = get_test_program()
+        shared_blob = self.gen_blob_data(SEGMENT_ALIGNMENT, b"\x10\x11\x01")
+        other_blob = self.gen_blob_data(16, b"\x20\x22\x02")
+        add_delegate_data(
+            program, program.execution_plan[0], [shared_blob, other_blob, shared_blob]
+        )
+        program.named_data = [
+            NamedData(
+                key="weight",
+                data=BackendDelegateDataReference(
+                    location=DataLocation.INLINE, index=0
+                ),
+            ),
+            NamedData(
+                key="weight_copy",
+                data=BackendDelegateDataReference(
+                    location=DataLocation.INLINE, index=2
+                ),
+            ),
+        ]
+
+        pte_data = bytes(
+            serialize_pte_binary(
+                program,
+                extract_delegate_segments=True,
+                segment_alignment=SEGMENT_ALIGNMENT,
+            )
+        )
+
+        # The blob is stored once, and everything that refers to it points to
+        # the same segment.
+        flatbuffer_program = _json_to_program(_program_flatbuffer_to_json(pte_data))
+        self.assertEqual(len(flatbuffer_program.segments), 2)
+        self.assertEqual(len(flatbuffer_program.backend_delegate_data), 0)
+        references = [
+            delegate.processed
+            for delegate in flatbuffer_program.execution_plan[0].delegates
+        ] + [named_data.data for named_data in flatbuffer_program.named_data]
+        for reference in references:
+            self.assertEqual(reference.location, DataLocation.SEGMENT)
+        self.assertEqual([reference.index for reference in references], [0, 1, 0, 0, 0])
+        self.assertEqual(
+            [named_data.key for named_data in flatbuffer_program.named_data],
+            ["weight", "weight_copy"],
+        )
+
+        # The references still resolve to the same data after a round trip,
+        # sharing one inline copy of the blob.
+        program2 = deserialize_pte_binary(pte_data)
+        self.assertEqual(len(program2.backend_delegate_data), 2)
+        references = [
+            delegate.processed for delegate in program2.execution_plan[0].delegates
+        ] + [named_data.data for named_data in program2.named_data]
+        self.assertEqual(
+            [
+                program2.backend_delegate_data[reference.index].data
+                for reference in references
+            ],
+            [shared_blob, other_blob, shared_blob, shared_blob, shared_blob],
+        )
+
     def test_constant_segment_tensor_alignment_16(self) -> None:
         self.constant_segment_with_tensor_alignment(16)
 
@@ -671,6 +740,114 @@ class TestProgram(unittest.TestCase):
                 constant_tensor_alignment=constant_tensor_alignment,
             )
 
+    def test_round_trip_with_compressed_constant_segment(self) -> None:
+        program = get_test_program()
+        blobs = (
+            self.gen_blob_data(CONSTANT_TENSOR_ALIGNMENT * 64, b"\x10\x11\x01"),
+            self.gen_blob_data(CONSTANT_TENSOR_ALIGNMENT + 1, b"\x20\x22\x02"),
+        )
+        add_constant_data(program, blobs)
+
+        uncompressed_pte_data = bytes(
+            serialize_pte_binary(
+                program,
+                segment_alignment=SEGMENT_ALIGNMENT,
+                constant_tensor_alignment=CONSTANT_TENSOR_ALIGNMENT,
+            )
+        )
+        pte_data = bytes(
+            serialize_pte_binary(
+                program,
+                segment_alignment=SEGMENT_ALIGNMENT,
+                constant_tensor_alignment=CONSTANT_TENSOR_ALIGNMENT,
+                compress_constant_segment=True,
+            )
+        )
+        self.assertLess(len(pte_data), len(uncompressed_pte_data))
+
+        # The segment table describes the compressed data, and the offsets of
+        # the tensors are still relative to the uncompressed data.
+        program_with_segments = _json_to_program(_program_flatbuffer_to_json(pte_data))
+        segment: DataSegment = program_with_segments.segments[0]
+        self.assertEqual(segment.compression, SegmentCompression.LZ4_CHUNKED)
+        self.assertEqual(
+            segment.uncompressed_size, CONSTANT_TENSOR_ALIGNMENT * 65 + 1
+        )
+        self.assertLess(segment.size, segment.uncompressed_size)
+        self.assertEqual(
+            program_with_segments.constant_segment.offsets,
+            [0, CONSTANT_TENSOR_ALIGNMENT * 64],
+        )
+
+        # Deserializing decompresses the segment.
+        self.assert_programs_equal(
+            deserialize_pte_binary(pte_data),
+            deserialize_pte_binary(uncompressed_pte_data),
+        )
+
+    def test_constant_segment_ordered_by_first_use_and_page_aligned(self) -> None:
+        page_size = 1024
+        program = get_test_program()
+        blobs = (
+            b"",  # Placeholder for tensors without constant data.
+            self.gen_blob_data(page_size + 1, b"\x10\x11\x01"),
+            self.gen_blob_data(CONSTANT_TENSOR_ALIGNMENT - 1, b"\x20\x22\x02"),
+            self.gen_blob_data(page_size, b"\x30\x33\x03"),
+        )
+        add_constant_data(program, blobs)
+
+        # The only instruction uses buffer 3, then buffer 2. Buffer 1 is only
+        # referred to by a value.
+        plan = program.execution_plan[0]
+        for data_buffer_idx in (1, 3, 2):
+            tensor = copy.deepcopy(plan.values[4].val)
+            tensor.data_buffer_idx = data_buffer_idx
+            tensor.allocation_info = None
+            plan.values.append(EValue(val=tensor))
+        plan.chains[0].instructions[0].instr_args.args = [6, 7]
+
+        pte_data = bytes(
+            serialize_pte_binary(
+                program,
+                segment_alignment=SEGMENT_ALIGNMENT,
+                constant_tensor_alignment=CONSTANT_TENSOR_ALIGNMENT,
+                order_constants_by_first_use=True,
+                constant_page_alignment=page_size,
+            )
+        )
+        eh = self.get_and_validate_extended_header(pte_data)
+        # The constant segment starts on a page boundary.
+        self.assertEqual(eh.segment_base_offset % page_size, 0)
+
+        program_with_segments = _json_to_program(_program_flatbuffer_to_json(pte_data))
+        segment_table: List[DataSegment] = program_with_segments.segments
+        self.assertEqual(segment_table[0].offset % page_size, 0)
+        # Buffer 3 comes first, then buffer 2, then buffer 1 on the next page.
+        # The empty buffer is placed after all the data.
+        offsets = program_with_segments.constant_segment.offsets
+        self.assertEqual(offsets, [page_size * 3 + 1, page_size * 2, page_size, 0])
+        self.assertEqual(segment_table[0].size, page_size * 3 + 1)
+
+        segment_data: bytes = pte_data[
+            eh.segment_base_offset + segment_table[0].offset :
+        ]
+        for blob, offset in zip(blobs, offsets):
+            self.assertEqual(segment_data[offset : offset + len(blob)], blob)
+
+        # Convert back.
+        program2 = deserialize_pte_binary(pte_data)
+        self.assertEqual(program2.execution_plan, program.execution_plan)
+        self.assertEqual(len(program2.constant_buffer), len(program.constant_buffer))
+        self.assertEqual(program2.constant_buffer[0].storage, b"")
+        for blob, buffer in zip(blobs[1:], program2.constant_buffer[1:]):
+            self.assertEqual(buffer.storage[: len(blob)], blob)
+
+    def test_constant_page_alignment_non_power_of_2_fails(self) -> None:
+        program = get_test_program()
+        program.constant_buffer.append(Buffer(storage=b"12345"))
+        with self.assertRaises(ValueError):
+            serialize_pte_binary(program, constant_page_alignment=1000)
+
     def test_constant_segment_and_delegate_segment(self) -> None:
         # Create a program with some constant tensor data and delegate data blobs.
         program = get_test_program()
@@ -8,7 +8,7 @@ import copy
 import logging
 from contextlib import contextmanager, nullcontext
 from functools import singledispatch
-from typing import Generator, List
+from typing import Generator, List, Optional
 
 import torch
 
@@ -28,6 +28,7 @@ from executorch.exir.lowered_backend_module import (
     _unsafe_adjust_original_program,
     create_exported_program_from_submodule,
     create_submodule_from_nodes,
+    DelegateLoopSpec,
     LoweredBackendModule,
 )
 from executorch.exir.program._fake_program import (
@@ -119,6 +120,7 @@ def _(
                 backend_id=backend_id,
                 processed_bytes=preprocess_result.processed_bytes,
                 compile_specs=compile_specs,
+                named_data=preprocess_result.named_data,
             )
             lowered_module.meta = {
                 "debug_handle_map": preprocess_result.debug_handle_map
@@ -127,6 +129,134 @@ def _(
     raise NotImplementedError(f"Backend {backend_id} was not found.")
 
 
+def to_backend_loop(
+    backend_id: str,
+    body: ExportedProgram,
+    compile_specs: List[CompileSpec],
+    num_carried: int,
+    max_iterations: int,
+    predicate_output: Optional[int] = None,
+) -> LoweredBackendModule:
+    """
+    Lowers `body` to the backend identified by backend_id like to_backend(), as
+    the body of a loop that the backend runs as a whole. Each call of the
+    returned module in a program runs up to `max_iterations` iterations of
+    `body` inside the backend, without returning to the runtime in between.
+
+    After each iteration, output i of `body` becomes its input i of the next
+    one, for i < num_carried, so these inputs and outputs must have the same
+    shapes and dtypes. If `predicate_output` is given, it is the position of an
+    output of `body` holding a single bool, and the loop stops after the first
+    iteration that sets it to False. The outputs of the call are those of the
+    last iteration.
+
+    Calling the returned module eagerly, or while tracing, runs `body` once;
+    only the ExecuTorch runtime runs it as a loop.
+
+    Raises:
+        ValueError: The loop doesn't fit the inputs and outputs of `body`.
+    """
+    if max_iterations < 1:
+        raise ValueError(f"max_iterations must be positive, got {max_iterations}")
+
+    signature = body.graph_signature
+    input_vals = {
+        node.name: node.meta.get("val")
+        for node in body.graph.nodes
+        if node.op == "placeholder"
+    }
+    inputs = [input_vals[name] for name in signature.user_inputs]
+    output_node = next(node for node in body.graph.nodes if node.op == "output")
+    output_vals = {
+        getattr(arg, "name", None): getattr(arg, "meta", {}).get("val")
+        for arg in output_node.args[0]
+    }
+    outputs = [output_vals.get(name) for name in signature.user_outputs]
+
+    if num_carried > min(len(inputs), len(outputs)):
+        raise ValueError(
+            f"Can't carry {num_carried} values through a body with "
+            f"{len(inputs)} inputs and {len(outputs)} outputs"
+        )
+    for i in range(num_carried):
+        if not (
+            isinstance(inputs[i], torch.Tensor)
+            and isinstance(outputs[i], torch.Tensor)
+            and inputs[i].shape == outputs[i].shape
+            and inputs[i].dtype == outputs[i].dtype
+        ):
+            raise ValueError(
+                f"Carried output {i} must be a tensor with the shape and dtype "
+                f"of input {i}"
+            )
+    if predicate_output is None:
+        predicate_output = -1
+    elif not (
+        0 <= predicate_output < len(outputs)
+        and isinstance(outputs[predicate_output], torch.Tensor)
+        and outputs[predicate_output].dtype == torch.bool
+        and outputs[predicate_output].numel() == 1
+    ):
+        raise ValueError(
+            f"Output {predicate_output} must be a bool tensor with one element "
+            "to be the loop predicate"
+        )
+
+    lowered_module = to_backend(backend_id, body, compile_specs)
+    lowered_module._loop_spec = DelegateLoopSpec(
+        num_carried=num_carried,
+        max_iterations=max_iterations,
+        predicate_output=predicate_output,
+    )
+    return lowered_module
+
+
+def add_delegate_alternatives(
+    graph_module: torch.fx.GraphModule,
+    backend_id: str,
+    compile_specs: List[CompileSpec],
+) -> int:
+    """
+    Lowers the original program of every delegate in graph_module, including
+    those of its control flow submodules, to the backend identified by
+    backend_id as well, and adds the result as an alternative to the delegate.
+
+    The runtime runs the first lowering of each delegate that loads, so that
+    e.g. a program partitioned for a GPU backend still runs where that backend
+    is unavailable, and can switch to the fastest one while running; see
+    `Method::set_delegate_trial_interval()`. Each alternative adds its
+    processed bytes to the program.
+
+    Delegates that are already lowered to backend_id are skipped.
+
+    Returns:
+        The number of alternatives added.
+
+    Raises:
+        RuntimeError: The backend can't process one of the delegates.
+    """
+    n_added = 0
+    for module in graph_module.modules():
+        if not isinstance(module, torch.fx.GraphModule):
+            continue
+        for node in module.graph.nodes:
+            if node.op != "call_function" or node.target != executorch_call_delegate:
+                continue
+            lowered_module = getattr(module, node.args[0].target)
+            if backend_id in [
+                lowered_module.backend_id,
+                *(alt.backend_id for alt in lowered_module.alternatives),
+            ]:
+                continue
+            alternative = to_backend(
+                backend_id, lowered_module.original_module, compile_specs
+            )
+            alternative._loop_spec = copy.copy(lowered_module.loop_spec)
+            lowered_module.add_alternative(alternative)
+            n_added += 1
+    return n_added
+
+
 _ENABLE_VALIDATION: bool = True
 
 
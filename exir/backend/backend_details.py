@@ -24,6 +24,12 @@ class PreprocessResult:
     debug_handle_map: Optional[Union[Dict[int, Tuple[int]], Dict[str, Tuple[int]]]] = (
         None
     )
+    # Data for the delegate to look up by key at init, through
+    # BackendInitContext::get_named_data_map(), instead of embedding it in
+    # processed_bytes. Data with the same contents is stored once per program,
+    # so delegates of different methods can share weights this way. The same
+    # key must not map to different data anywhere in the program.
+    named_data: Optional[Dict[str, bytes]] = None
 
 
 """
@@ -11,7 +11,7 @@ import executorch.exir.tests.models as models
 import torch
 from executorch import exir
 from executorch.exir import to_edge
-from executorch.exir.backend.backend_api import to_backend
+from executorch.exir.backend.backend_api import to_backend, to_backend_loop
 from executorch.exir.backend.compile_spec_schema import CompileSpec
 from executorch.exir.backend.test.backend_with_compiler_demo import (
     BackendWithCompilerDemo,
@@ -112,6 +112,148 @@ class TestBackendAPI(unittest.TestCase):
             torch.allclose(model_outputs[0], expected_res, atol=1e-03, rtol=1e-03)
         )
 
+    @settings(deadline=500000)
+    def test_emit_lowered_backend_module_loop(self):
+        class SinModule(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+
+            def forward(self, x):
+                return torch.sin(x)
+
+        model_inputs = (torch.ones(1),)
+        edgeir_m = to_edge(
+            export(SinModule(), model_inputs),
+            compile_config=exir.EdgeCompileConfig(
+                _check_ir_validity=False, _use_edge_ops=True
+            ),
+        )
+        compile_specs = [CompileSpec("max_value", bytes([1]))]
+        lowered_sin_module = to_backend_loop(
+            BackendWithCompilerDemo.__name__,
+            edgeir_m.exported_program(),
+            compile_specs,
+            num_carried=1,
+            max_iterations=3,
+        )
+
+        program = lowered_sin_module.program()
+        delegate_calls = [
+            instruction.instr_args
+            for instruction in program.execution_plan[0].chains[0].instructions
+            if isinstance(instruction.instr_args, DelegateCall)
+        ]
+        self.assertEqual(len(delegate_calls), 1)
+        loop = delegate_calls[0].loop
+        self.assertEqual(loop.num_inputs, 1)
+        self.assertEqual(loop.num_carried, 1)
+        self.assertEqual(loop.max_iterations, 3)
+        self.assertEqual(loop.predicate_output, -1)
+        # The loop overwrites its carried input, so it gets a copy of the
+        # method input.
+        self.assertIn(
+            "aten::clone", [op.name for op in program.execution_plan[0].operators]
+        )
+
+        executorch_module = _load_for_executorch_from_buffer(
+            lowered_sin_module.buffer()
+        )
+        model_inputs = torch.ones(1)
+        model_outputs = executorch_module.forward([model_inputs])
+        self.assertEqual(model_inputs, torch.ones(1))
+        # The demo backend computes sin(x) as x - x^3 / 6.
+        expected_res = torch.ones(1)
+        for _ in range(3):
+            expected_res = expected_res - expected_res**3 / 6
+        self.assertTrue(
+            torch.allclose(model_outputs[0], expected_res, atol=1e-03, rtol=1e-03)
+        )
+
+    def test_to_backend_loop_checks_carried_values(self):
+        class ReduceModule(torch.nn.Module):
+            def forward(self, x):
+                return torch.sum(x, dim=0, keepdim=True)
+
+        edgeir_m = to_edge(
+            export(ReduceModule(), (torch.ones(2),)),
+            compile_config=exir.EdgeCompileConfig(_check_ir_validity=False),
+        )
+        with self.assertRaises(ValueError):
+            to_backend_loop(
+                BackendWithCompilerDemo.__name__,
+                edgeir_m.exported_program(),
+                [],
+                num_carried=1,
+                max_iterations=3,
+            )
+
+    def test_emit_lowered_backend_module_alternatives(self):
+        class SinModule(torch.nn.Module):
+            def forward(self, x):
+                return torch.sin(x)
+
+        model_inputs = (torch.ones(1),)
+        edgeir_m = to_edge(
+            export(SinModule(), model_inputs),
+            compile_config=exir.EdgeCompileConfig(
+                _check_ir_validity=False, _use_edge_ops=True
+            ),
+        )
+        # The runtime doesn't have QnnBackend, so the program falls back to the
+        # demo backend.
+        lowered_sin_module = to_backend(
+            QnnBackend.__name__, edgeir_m.exported_program(), []
+        )
+        lowered_sin_module.add_alternative(
+            to_backend(
+                BackendWithCompilerDemo.__name__,
+                edgeir_m.exported_program(),
+                [CompileSpec("max_value", bytes([1]))],
+            )
+        )
+
+        program = lowered_sin_module.program()
+        delegates = program.execution_plan[0].delegates
+        self.assertEqual(
+            [delegate.id for delegate in delegates],
+            [BackendWithCompilerDemo.__name__, QnnBackend.__name__],
+        )
+        self.assertEqual(delegates[1].alternatives, [0])
+        delegate_calls = [
+            instruction.instr_args
+            for instruction in program.execution_plan[0].chains[0].instructions
+            if isinstance(instruction.instr_args, DelegateCall)
+        ]
+        self.assertEqual(len(delegate_calls), 1)
+        self.assertEqual(delegate_calls[0].delegate_index, 1)
+
+        executorch_module = _load_for_executorch_from_buffer(
+            lowered_sin_module.buffer()
+        )
+        model_outputs = executorch_module.forward([torch.ones(1)])
+        # The demo backend computes sin(x) as x - x^3 / 6.
+        expected_res = torch.ones(1) - torch.ones(1) ** 3 / 6
+        self.assertTrue(
+            torch.allclose(model_outputs[0], expected_res, atol=1e-03, rtol=1e-03)
+        )
+
+    def test_add_alternative_checks_signature(self):
+        class SinModule(torch.nn.Module):
+            def forward(self, x):
+                return torch.sin(x)
+
+        def lower(shape):
+            edgeir_m = to_edge(
+                export(SinModule(), (torch.ones(shape),)),
+                compile_config=exir.EdgeCompileConfig(_check_ir_validity=False),
+            )
+            return to_backend(
+                BackendWithCompilerDemo.__name__, edgeir_m.exported_program(), []
+            )
+
+        with self.assertRaises(ValueError):
+            lower(1).add_alternative(lower(2))
+
     @given(
         unlift=st.booleans(),  # verify both lifted and unlifted graph
     )
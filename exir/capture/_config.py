@@ -58,6 +58,9 @@ class ExecutorchBackendConfig:
     # EdgeProgramManager or can be defined per program.
     memory_planning_pass: Union[PassType, Dict[str, PassType]] = MemoryPlanningPass()
     to_out_var_pass: PassType = ToOutVarPass(ignore_to_out_var_failure=False)
+    # If provided, runs right before to_out_var_pass and memory planning, to
+    # change the order in which the ops execute, e.g. ReorderForMemoryPass.
+    reorder_pass: Optional[PassType] = None
     dynamic_memory_planning_mode: DynamicMemoryPlanningMode = (
         DynamicMemoryPlanningMode.UPPER_BOUND
     )
@@ -93,3 +96,18 @@ class ExecutorchBackendConfig:
     # If set to true, all constant tensors will be stored in a separate file,
     # external to the PTE file.
     external_constants: bool = False
+
+    # If set to true, the constant segment is compressed in chunks, to make the
+    # PTE file smaller. The runtime must then load the program through a
+    # DecompressingDataLoader, see extension/data_loader.
+    compress_constant_segment: bool = False
+
+    # If set to true, constant tensors are laid out in the order that the
+    # methods first use them, so that the first inference of an mmapped program
+    # reads the constant data front to back instead of jumping around the file.
+    order_constants_by_first_use: bool = False
+
+    # If provided, constant tensors of at least this many bytes are aligned to
+    # this value in the PTE file, e.g. the page size, so that no page holds
+    # parts of two large tensors. Must be a power of 2.
+    constant_page_alignment: Optional[int] = None
@@ -18,7 +18,14 @@ from executorch.exir.emit._emitter import (
 )
 from executorch.exir.error import ExportError, ExportErrorType
 
-from executorch.exir.schema import Buffer, Program, SubsegmentOffsets
+from executorch.exir.schema import (
+    BackendDelegateDataReference,
+    Buffer,
+    DataLocation,
+    NamedData,
+    Program,
+    SubsegmentOffsets,
+)
 from executorch.exir.version import EXECUTORCH_SCHEMA_VERSION
 from torch.export.exported_program import ExportedProgram, OutputKind
 from torch.utils import _pytree as pytree
@@ -200,6 +207,19 @@ def emit_program(
             # Subsegment offsets may be added at serialization time.
             constant_segment=SubsegmentOffsets(segment_index=0, offsets=[]),
             mutable_data_segments=None,  # Will be filled in during serialization
+            named_data=(
+                [
+                    NamedData(
+                        key=key,
+                        data=BackendDelegateDataReference(
+                            location=DataLocation.INLINE, index=index
+                        ),
+                    )
+                    for key, index in sorted(program_state.named_data.items())
+                ]
+                if program_state.named_data
+                else None
+            ),
         ),
         mutable_data=(
             program_state.mutable_buffer
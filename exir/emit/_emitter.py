@@ -59,6 +59,7 @@ from executorch.exir.schema import (
     ContainerMetadata,
     DataLocation,
     DelegateCall,
+    DelegateLoop,
     Double,
     DoubleList,
     EValue,
@@ -122,6 +123,11 @@ class _ProgramState:
     # Delegate data stored directly in the flatbuffer. Pointed to by BackendDelegateDataReference,
     # and should be copied to Program.backend_delegate_data.
     backend_delegate_data: List[BackendDelegateInlineData] = field(default_factory=list)
+    # Delegate data is deduplicated by content, like constants, so that identical blobs
+    # from different methods are stored once. {sha256: index into backend_delegate_data}
+    cached_delegate_data_hash_values: Dict[str, int] = field(default_factory=dict)
+    # Data that delegates look up by key. {key: index into backend_delegate_data}
+    named_data: Dict[str, int] = field(default_factory=dict)
 
     # Constants are optionally stored in external files.
     # Aggregate unique external constants into one buffer.
@@ -144,7 +150,9 @@ class _EmitterState:
     operators: List[Operator]
     delegates: List[BackendDelegate]
     operator_cache: Dict[Tuple[str, str], int]
-    delegate_cache: Dict[bytes, int]
+    # Keyed on the processed bytes of a delegate, and those of its alternatives
+    # if it has any.
+    delegate_cache: Dict[Union[bytes, Tuple[bytes, ...]], int]
     emit_stacktrace: bool
 
     spec2id_dict: Dict[TensorSpec, int] = field(default_factory=dict)
@@ -1064,6 +1072,69 @@ class _Emitter(torch.fx.Interpreter):
         assert ret is not None, "Can't have a None ret"
         return ret
 
+    def _emit_backend_delegate_data(self, data: bytes) -> int:
+        """Adds data to the program's delegate data, unless data with the same contents
+        is already there, and returns its index."""
+        hashed = hashlib.sha256(data).hexdigest()
+        data_index = self.program_state.cached_delegate_data_hash_values.get(hashed)
+        if data_index is None:
+            data_index = len(self.program_state.backend_delegate_data)
+            self.program_state.backend_delegate_data.append(
+                BackendDelegateInlineData(data=data)
+            )
+            self.program_state.cached_delegate_data_hash_values[hashed] = data_index
+        return data_index
+
+    def _emit_backend_delegate(
+        self,
+        lowered_module: "LoweredBackendModule",  # noqa
+    ) -> int:
+        """Adds the delegate entry of lowered_module to the execution plan, after
+        those of its alternatives, unless an identical one is already there, and
+        returns its index."""
+        alternatives = getattr(lowered_module, "alternatives", [])
+        cache_key = (
+            tuple(
+                module.processed_bytes for module in [lowered_module, *alternatives]
+            )
+            if alternatives
+            else lowered_module.processed_bytes
+        )
+        delegate_index = self.emitter_state.delegate_cache.get(cache_key)
+        if delegate_index is not None:
+            return delegate_index
+
+        alternative_indices = [
+            self._emit_backend_delegate(module) for module in alternatives
+        ]
+        data_index = self._emit_backend_delegate_data(lowered_module.processed_bytes)
+        for key, data in getattr(lowered_module, "named_data", {}).items():
+            named_data_index = self._emit_backend_delegate_data(data)
+            existing_index = self.program_state.named_data.setdefault(
+                key, named_data_index
+            )
+            if existing_index != named_data_index:
+                raise InternalError(
+                    self._emit_node_specific_error(
+                        self.node,
+                        f"Named data {key!r} of backend {lowered_module.backend_id} "
+                        "differs from the data of another delegate with the same key",
+                    )
+                )
+
+        backend_delegate = BackendDelegate(
+            id=lowered_module.backend_id,
+            processed=BackendDelegateDataReference(
+                location=DataLocation.INLINE, index=data_index
+            ),
+            compile_specs=lowered_module.compile_specs,
+            alternatives=alternative_indices,
+        )
+        delegate_index = len(self.emitter_state.delegates)
+        self.emitter_state.delegates.append(backend_delegate)
+        self.emitter_state.delegate_cache[cache_key] = delegate_index
+        return delegate_index
+
     def _emit_delegate(
         self,
         lowered_module: "LoweredBackendModule",  # noqa
@@ -1072,9 +1143,6 @@ class _Emitter(torch.fx.Interpreter):
     ) -> _EmitterValue:
         """Emit the delegates inputs and outputs as specified by the schema, then emit the
         delegate's blob."""
-        processed_bytes = lowered_module.processed_bytes
-
-        delegate_index = self.emitter_state.delegate_cache.get(processed_bytes)
         delegate_ret = None
 
         if isinstance(self.node.meta["spec"], list):
@@ -1109,24 +1177,7 @@ class _Emitter(torch.fx.Interpreter):
                 f"self.node.meta['spec'] {type(self.node.meta['spec'])} is not supported"
             )
         assert delegate_ret is not None, "Can't have a None delegate_ret"
-        if delegate_index is None:
-            # Allocate an entry for the data. TODO(T150113674): Reuse any duplicate entries if
-            # present.
-            data_index: int = len(self.program_state.backend_delegate_data)
-            self.program_state.backend_delegate_data.append(
-                BackendDelegateInlineData(data=processed_bytes)
-            )
-
-            backend_delegate = BackendDelegate(
-                id=lowered_module.backend_id,
-                processed=BackendDelegateDataReference(
-                    location=DataLocation.INLINE, index=data_index
-                ),
-                compile_specs=lowered_module.compile_specs,
-            )
-            delegate_index = len(self.emitter_state.delegate_cache)
-            self.emitter_state.delegates.append(backend_delegate)
-            self.emitter_state.delegate_cache[processed_bytes] = delegate_index
+        delegate_index = self._emit_backend_delegate(lowered_module)
 
         # TODO(angelayi) Will need to emit the kwargs too, in the correct order according to the
         # function's spec and with default arguments. This requires us to store the function's spec
@@ -1136,11 +1187,26 @@ class _Emitter(torch.fx.Interpreter):
             for arg in typing.cast(List[_Argument], args)
         ]
 
+        num_inputs = len(delegate_args)
         for elem in pytree.tree_flatten(delegate_ret)[0]:
             delegate_args.append(elem.id)
 
+        loop = None
+        loop_spec = getattr(lowered_module, "loop_spec", None)
+        if loop_spec is not None:
+            loop = DelegateLoop(
+                num_inputs=num_inputs,
+                num_carried=loop_spec.num_carried,
+                max_iterations=loop_spec.max_iterations,
+                predicate_output=loop_spec.predicate_output,
+            )
+
         self.chain.instructions.append(
-            Instruction(DelegateCall(delegate_index=delegate_index, args=delegate_args))
+            Instruction(
+                DelegateCall(
+                    delegate_index=delegate_index, args=delegate_args, loop=loop
+                )
+            )
         )
 
         return delegate_ret
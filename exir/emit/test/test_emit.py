@@ -1378,6 +1378,56 @@ class TestEmit(unittest.TestCase):
         ).to_executorch()
         exec_prog.buffer
 
+    def test_delegates_share_named_data(self) -> None:
+        class BackendWithNamedDataExample(BackendDetails):
+            @staticmethod
+            def preprocess(
+                edge_program,
+                compile_specs,
+            ) -> bytes:
+                return PreprocessResult(
+                    processed_bytes=b"test",
+                    debug_handle_map=None,
+                    named_data={"weight": b"shared weight"},
+                )
+
+        class AddModule(torch.nn.Module):
+            def forward(self, x):
+                return x + x
+
+        inputs = (torch.ones(2, 2),)
+        edgeir_m = to_edge(export(AddModule(), inputs))
+
+        class CompositeModule(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.lowered_module = to_backend(
+                    "BackendWithNamedDataExample", edgeir_m.exported_program(), []
+                )
+
+            def forward(self, x):
+                return self.lowered_module(x)
+
+        program = to_edge(
+            {
+                "prefill": export(CompositeModule(), inputs),
+                "decode": export(CompositeModule(), inputs),
+            }
+        ).to_executorch()._emitter_output.program
+
+        # The delegates of both methods share their processed data, and the
+        # named data is stored once.
+        self.assertEqual(
+            [data.data for data in program.backend_delegate_data],
+            [b"test", b"shared weight"],
+        )
+        for plan in program.execution_plan:
+            self.assertEqual(len(plan.delegates), 1)
+            self.assertEqual(plan.delegates[0].processed.index, 0)
+        self.assertEqual(len(program.named_data), 1)
+        self.assertEqual(program.named_data[0].key, "weight")
+        self.assertEqual(program.named_data[0].data.index, 1)
+
     def test_delegate_mapping(self) -> None:
         debug_handle_map = {1: [1, 2]}
 
@@ -0,0 +1,54 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+"""Resolves the kernels of a program ahead of time for a specific runtime.
+
+A runtime's kernel registry can be described by its fingerprint and by the
+registry indices of its kernels, for example with
+``executorch.extension.pybindings.portable_lib._get_registry_fingerprint()`` and
+``_get_fallback_kernel_indices()``, called on a runtime built with the same
+kernel libraries as the target. When the program is later loaded by a runtime
+with the same fingerprint, Method::init uses the recorded indices instead of
+looking kernels up by name. Other runtimes ignore the table.
+"""
+
+from typing import Dict
+
+from executorch.exir.schema import KernelResolution, Operator, Program
+
+
+def _operator_name(op: Operator) -> str:
+    # Must match populate_operator_name() in runtime/executor/method.cpp.
+    return f"{op.name}.{op.overload}" if op.overload else op.name
+
+
+def add_kernel_resolution(
+    program: Program,
+    registry_fingerprint: int,
+    kernel_indices: Dict[str, int],
+) -> Program:
+    """Records the registry index of each operator's kernel in every plan.
+
+    Args:
+        program: The program to update in place.
+        registry_fingerprint: Fingerprint of the target runtime's registry.
+        kernel_indices: Maps operator names, like "aten::add.out", to the
+            registry index of their kernel. Operators that are missing are
+            looked up by name at runtime.
+
+    Returns:
+        The updated program.
+    """
+    for plan in program.execution_plan:
+        plan.kernel_resolution = KernelResolution(
+            registry_fingerprint=registry_fingerprint,
+            kernel_indices=[
+                kernel_indices.get(_operator_name(op), -1) for op in plan.operators
+            ],
+        )
+    return program
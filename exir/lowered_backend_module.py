@@ -9,6 +9,7 @@
 import copy
 import operator
 from collections import defaultdict
+from dataclasses import dataclass
 from typing import Any, Dict, List, Optional, Set, Tuple, Union
 
 import torch
@@ -20,6 +21,9 @@ from executorch.exir.emit import emit_program
 
 from executorch.exir.graph_module import _get_submodule
 
+from executorch.exir.passes.clone_delegate_loop_inputs_pass import (
+    CloneDelegateLoopInputsPass,
+)
 from executorch.exir.passes.memory_planning_pass import MemoryPlanningPass
 from executorch.exir.passes.spec_prop_pass import make_spec, SpecPropPass
 from executorch.exir.schema import Program
@@ -50,6 +54,23 @@ from torch.fx.passes.utils.fuser_utils import (
 )
 
 
+@dataclass
+class DelegateLoopSpec:
+    """
+    Runs a lowered module as the body of a loop that the backend owns; see
+    `to_backend_loop()`.
+    """
+
+    # After each iteration, output i becomes input i of the next one, for
+    # i < num_carried.
+    num_carried: int
+    # The maximum number of iterations.
+    max_iterations: int
+    # The position among the outputs of a bool tensor with one element that is
+    # false after the last iteration, or -1 to always run max_iterations.
+    predicate_output: int = -1
+
+
 class LoweredBackendModule(torch.nn.Module):
     """
     A subclass of nn.Module that is generated for modules containing
@@ -62,6 +83,11 @@ class LoweredBackendModule(torch.nn.Module):
         CompileSpec
     ]  # A list of backend-specific objects with static metadata to configure the "compilation" process.
     _original_exported_program: ExportedProgram  # The original EXIR module
+    _loop_spec: Optional[DelegateLoopSpec]  # Set if the backend runs it as a loop
+    _alternatives: List[
+        "LoweredBackendModule"
+    ]  # Other lowerings of the same program, in order of preference
+    _named_data: Dict[str, bytes]  # Data the delegate looks up by key at init
 
     def __init__(
         self,
@@ -69,12 +95,18 @@ class LoweredBackendModule(torch.nn.Module):
         backend_id: str,
         processed_bytes: bytes,
         compile_specs: List[CompileSpec],
+        loop_spec: Optional[DelegateLoopSpec] = None,
+        alternatives: Optional[List["LoweredBackendModule"]] = None,
+        named_data: Optional[Dict[str, bytes]] = None,
     ) -> None:
         super().__init__()
         self._original_exported_program = edge_program
         self._backend_id = backend_id
         self._processed_bytes = processed_bytes
         self._compile_specs = compile_specs
+        self._loop_spec = loop_spec
+        self._alternatives = alternatives if alternatives is not None else []
+        self._named_data = named_data if named_data is not None else {}
 
     # pyre-ignore
     def __deepcopy__(self, memo: Optional[Dict[int, Any]]) -> "LoweredBackendModule":
@@ -101,6 +133,9 @@ class LoweredBackendModule(torch.nn.Module):
             backend_id=self._backend_id,
             processed_bytes=self._processed_bytes,
             compile_specs=copy.deepcopy(self._compile_specs, memo),
+            loop_spec=copy.copy(self._loop_spec),
+            alternatives=copy.deepcopy(self._alternatives, memo),
+            named_data=self._named_data,
         )
         # pyre-fixme[16]: `LoweredBackendModule` has no attribute `meta`.
         res.meta = copy.copy(getattr(self, "meta", {}))
@@ -120,6 +155,14 @@ class LoweredBackendModule(torch.nn.Module):
         """
         return self._processed_bytes
 
+    @property
+    def named_data(self) -> Dict[str, bytes]:
+        """
+        Returns the data that the delegate looks up by key at init, from
+        PreprocessResult.named_data.
+        """
+        return self._named_data
+
     @property
     def compile_specs(self) -> List[CompileSpec]:
         """
@@ -127,6 +170,61 @@ class LoweredBackendModule(torch.nn.Module):
         """
         return self._compile_specs
 
+    @property
+    def loop_spec(self) -> Optional[DelegateLoopSpec]:
+        """
+        Returns how the backend runs this module as a loop, or None if it runs it
+        once per call.
+        """
+        return self._loop_spec
+
+    @property
+    def alternatives(self) -> List["LoweredBackendModule"]:
+        """
+        Returns the other lowerings of the original module, in order of
+        preference. The runtime runs the first of this module and its
+        alternatives that loads, and may switch between them.
+        """
+        return self._alternatives
+
+    def add_alternative(self, alternative: "LoweredBackendModule") -> None:
+        """
+        Adds a lowering of the same program to another backend, e.g. one for the
+        CPU to fall back to when a GPU backend is unavailable or slow. The
+        alternative is serialized as a delegate of its own, so it adds its
+        processed bytes to the program.
+
+        Raises:
+            ValueError: The alternative doesn't take and return values like this
+                module.
+        """
+
+        def signature(module: "LoweredBackendModule") -> List[Any]:
+            program = module.original_module
+            vals = {node.name: node.meta.get("val") for node in program.graph.nodes}
+            result = []
+            for name in [
+                *program.graph_signature.user_inputs,
+                *program.graph_signature.user_outputs,
+            ]:
+                val = vals.get(name)
+                if isinstance(val, torch.Tensor):
+                    result.append((val.shape, val.dtype))
+                else:
+                    result.append(type(val))
+            return result
+
+        if alternative.alternatives:
+            raise ValueError("Alternatives can't have alternatives of their own")
+        if alternative.loop_spec != self._loop_spec:
+            raise ValueError("Alternatives must run as the same loop")
+        if signature(alternative) != signature(self):
+            raise ValueError(
+                f"The lowering to {alternative.backend_id} doesn't take and "
+                f"return values like the one to {self._backend_id}"
+            )
+        self._alternatives.append(alternative)
+
     @property
     def original_module(self) -> ExportedProgram:
         """
@@ -328,7 +426,12 @@ class LoweredBackendModule(torch.nn.Module):
         )
         if memory_planning is None:
             memory_planning = MemoryPlanningPass()
-        exported_program = _transform(exported_program, SpecPropPass(), memory_planning)
+        exported_program = _transform(
+            exported_program,
+            CloneDelegateLoopInputsPass(),
+            SpecPropPass(),
+            memory_planning,
+        )
         emitted_program = emit_program(
             exported_program, emit_stacktrace=emit_stacktrace
         ).program
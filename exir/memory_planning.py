@@ -646,6 +646,498 @@ def naive(
     return bufsizes
 
 
+class _LifetimeIntervalTree:
+    r"""
+    A static centered interval tree over the lifetimes of a fixed set of specs.
+    It finds the specs whose lifetime overlaps a given one without scanning all
+    of them, which the offset based planners do once per tensor.
+    """
+
+    def __init__(self, specs: List[TensorSpec]) -> None:
+        endpoints = sorted(idx for spec in specs for idx in spec.lifetime)
+        self.center: int = endpoints[len(endpoints) // 2]
+        left, right, here = [], [], []
+        for spec in specs:
+            if spec.lifetime[1] < self.center:
+                left.append(spec)
+            elif spec.lifetime[0] > self.center:
+                right.append(spec)
+            else:
+                here.append(spec)
+        # The specs whose lifetime contains the center, sorted so that a query
+        # can stop at the first one that does not overlap.
+        self.by_start: List[TensorSpec] = sorted(here, key=lambda s: s.lifetime[0])
+        self.by_end: List[TensorSpec] = sorted(
+            here, key=lambda s: s.lifetime[1], reverse=True
+        )
+        self.left: Optional[_LifetimeIntervalTree] = (
+            _LifetimeIntervalTree(left) if left else None
+        )
+        self.right: Optional[_LifetimeIntervalTree] = (
+            _LifetimeIntervalTree(right) if right else None
+        )
+
+    def overlapping(self, lifetime: List[int]) -> Iterable[TensorSpec]:
+        r"""
+        Yield the specs whose lifetime overlaps the inclusive `lifetime`.
+        """
+        start, end = lifetime
+        nodes: List[_LifetimeIntervalTree] = [self]
+        while nodes:
+            node = nodes.pop()
+            if end < node.center:
+                for spec in node.by_start:
+                    if spec.lifetime[0] > end:
+                        break
+                    yield spec
+                if node.left is not None:
+                    nodes.append(node.left)
+            elif start > node.center:
+                for spec in node.by_end:
+                    if spec.lifetime[1] < start:
+                        break
+                    yield spec
+                if node.right is not None:
+                    nodes.append(node.right)
+            else:
+                yield from node.by_start
+                if node.left is not None:
+                    nodes.append(node.left)
+                if node.right is not None:
+                    nodes.append(node.right)
+
+
+def memory_lower_bound(specs: Iterable[TensorSpec]) -> int:
+    r"""
+    Return the peak total size of the tensors that are alive at the same time.
+    No plan can fit the tensors in a smaller buffer, so comparing a plan with
+    this bound tells how far from optimal it is at most.
+    """
+    deltas: Dict[int, int] = defaultdict(int)
+    for spec in specs:
+        deltas[spec.lifetime[0]] += spec.allocated_memory
+        deltas[spec.lifetime[1] + 1] -= spec.allocated_memory
+    peak = 0
+    live = 0
+    for idx in sorted(deltas):
+        live += deltas[idx]
+        peak = max(peak, live)
+    return peak
+
+
+def _best_fit_offset(
+    spec: TensorSpec, offsets: Dict[TensorSpec, int], tree: _LifetimeIntervalTree
+) -> int:
+    r"""
+    Return the start of the smallest gap that fits `spec` between the tensors
+    in `offsets` whose lifetime overlaps its own, or the end of the last of
+    them if none fits.
+    """
+    size = spec.allocated_memory
+    busy = sorted(
+        (offsets[other], offsets[other] + other.allocated_memory)
+        for other in tree.overlapping(spec.lifetime)
+        if other in offsets
+    )
+    best_offset = None
+    best_gap = None
+    prev_end = 0
+    for begin, end in busy:
+        gap = begin - prev_end
+        if gap >= size and (best_gap is None or gap < best_gap):
+            best_offset = prev_end
+            best_gap = gap
+        prev_end = max(prev_end, end)
+    return prev_end if best_offset is None else best_offset
+
+
+def _place_greedy_by_size(specs: List[TensorSpec]) -> Dict[TensorSpec, int]:
+    r"""
+    Place the tensors at offsets in a single arena, from the largest to the
+    smallest, each at its best fit offset.
+    """
+    offsets: Dict[TensorSpec, int] = {}
+    if not specs:
+        return offsets
+    tree = _LifetimeIntervalTree(specs)
+    for spec in sorted(specs, key=lambda s: (-s.allocated_memory, s.lifetime[0])):
+        offsets[spec] = _best_fit_offset(spec, offsets, tree)
+    return offsets
+
+
+def _arena_size(offsets: Dict[TensorSpec, int]) -> int:
+    return max(
+        (offset + spec.allocated_memory for spec, offset in offsets.items()),
+        default=0,
+    )
+
+
+def _plan_offsets(
+    algo_name: str,
+    place: Callable[[List[TensorSpec], int], Dict[TensorSpec, int]],
+    graph_module: torch.fx.GraphModule,
+    alignment: int,
+    graph_signature: Optional[ExportGraphSignature],
+    alloc_graph_input: bool,
+    alloc_graph_output: bool,
+) -> List[int]:
+    r"""
+    Run an offset based planner on each memory buffer, and record in the graph
+    module's meta the lower bound of the size of each buffer.
+
+    Unlike greedy, which packs tensors into shared objects that only tensors
+    of similar size can reuse well, these planners give each tensor its own
+    offset, so a large dead tensor can hold several smaller ones.
+    """
+    do_assertion = not getattr(graph_module, "encounter_to_out_var_failure", False)
+    specs_by_mem_id: Dict[int, List[TensorSpec]] = defaultdict(list)
+    for spec in collect_specs_from_nodes(
+        graph_module.graph.nodes,
+        graph_signature,
+        do_assertion=do_assertion,
+        ignore_graph_input=not alloc_graph_input,
+        ignore_graph_output=not alloc_graph_output,
+    ):
+        if spec.mem_id is None:
+            spec.mem_id = 1
+        spec.realign(alignment)
+        specs_by_mem_id[spec.mem_id].append(spec)
+
+    input_bufsizes = typing.cast(
+        List[int], getattr(graph_module, "input_mem_buffer_sizes", None) or []
+    )
+    num_buffers = max(
+        2, len(input_bufsizes), max(specs_by_mem_id.keys(), default=0) + 1
+    )
+    total_sizes = [0] * num_buffers
+    lower_bounds = [0] * num_buffers
+    for mem_id in range(num_buffers):
+        # Submodules of control flow ops are planned after the tensors of their
+        # parent, which come first in the buffer.
+        base = input_bufsizes[mem_id] if mem_id < len(input_bufsizes) else 0
+        specs = specs_by_mem_id.get(mem_id, [])
+        offsets = place(specs, alignment)
+        # Tensors whose storage overlaps must share a mem_obj_id, so number the
+        # groups of overlapping tensors.
+        mem_obj_id = -1
+        group_end = 0
+        for spec in sorted(specs, key=lambda s: offsets[s]):
+            if mem_obj_id < 0 or offsets[spec] >= group_end:
+                mem_obj_id += 1
+            group_end = max(group_end, offsets[spec] + spec.allocated_memory)
+            spec.mem_obj_id = mem_obj_id
+            spec.mem_offset = base + offsets[spec]
+        total_sizes[mem_id] = base + _arena_size(offsets)
+        lower_bounds[mem_id] = base + memory_lower_bound(specs)
+
+    graph_module.meta["non_const_buffer_lower_bounds"] = lower_bounds
+    logging.info(
+        f"{algo_name} algorithm returns bufsizes: {total_sizes}, "
+        f"lower bounds: {lower_bounds}"
+    )
+    return total_sizes
+
+
+def greedy_by_size(
+    graph_module: torch.fx.GraphModule,
+    alignment: int,
+    graph_signature: Optional[ExportGraphSignature] = None,
+    alloc_graph_input: bool = True,
+    alloc_graph_output: bool = True,
+) -> List[int]:
+    r"""
+    Place each tensor at an offset in its buffer, from the largest tensor to
+    the smallest, in the smallest gap left by the tensors whose lifetime
+    overlaps its own.
+
+    The lower bound of each buffer's size is stored in
+    graph_module.meta["non_const_buffer_lower_bounds"].
+    """
+    return _plan_offsets(
+        "greedy_by_size",
+        lambda specs, alignment: _place_greedy_by_size(specs),
+        graph_module,
+        alignment,
+        graph_signature,
+        alloc_graph_input,
+        alloc_graph_output,
+    )
+
+
+def _place_ilp(
+    specs: List[TensorSpec], alignment: int, time_limit: float
+) -> Dict[TensorSpec, int]:
+    r"""
+    Place the tensors with a mixed integer linear program that minimizes the
+    size of the arena, starting from the greedy_by_size placement as an upper
+    bound. Falls back to that placement if the solver finds nothing better in
+    `time_limit` seconds.
+    """
+    greedy_offsets = _place_greedy_by_size(specs)
+    greedy_size = _arena_size(greedy_offsets)
+    if greedy_size == memory_lower_bound(specs):
+        # Already optimal.
+        return greedy_offsets
+
+    try:
+        import numpy as np
+        from scipy.optimize import Bounds, LinearConstraint, milp
+        from scipy.sparse import coo_matrix
+    except ImportError as e:
+        raise RuntimeError(
+            "The ilp memory planning algorithm requires scipy. Use "
+            "greedy_by_size instead if it is not available."
+        ) from e
+
+    # Everything is in units of the alignment, which all sizes are multiples
+    # of, so that integer offsets are aligned.
+    unit = max(alignment, 1)
+    placed = [spec for spec in specs if spec.allocated_memory > 0]
+    index = {spec: i for i, spec in enumerate(placed)}
+    sizes = [spec.allocated_memory // unit for spec in placed]
+    upper = greedy_size // unit
+    tree = _LifetimeIntervalTree(placed)
+    pairs = [
+        (i, index[other])
+        for i, spec in enumerate(placed)
+        for other in tree.overlapping(spec.lifetime)
+        if index[other] > i
+    ]
+
+    # Variables: the offset of each tensor, the arena size, then for each pair
+    # of tensors alive at the same time, whether the first one goes above the
+    # second one.
+    num_vars = len(placed) + 1 + len(pairs)
+    arena = len(placed)
+    rows: List[int] = []
+    cols: List[int] = []
+    vals: List[float] = []
+    lbs: List[float] = []
+    ubs: List[float] = []
+
+    def add_row(coefs: List[Tuple[int, float]], lb: float, ub: float) -> None:
+        row = len(lbs)
+        for col, val in coefs:
+            rows.append(row)
+            cols.append(col)
+            vals.append(val)
+        lbs.append(lb)
+        ubs.append(ub)
+
+    for i, size in enumerate(sizes):
+        # offset + size <= arena
+        add_row([(i, 1), (arena, -1)], -np.inf, -size)
+    for p, (i, j) in enumerate(pairs):
+        z = arena + 1 + p
+        # Either i ends before j starts (z = 0), or j ends before i starts.
+        add_row([(i, 1), (j, -1), (z, -upper)], -np.inf, -sizes[i])
+        add_row([(j, 1), (i, -1), (z, upper)], -np.inf, upper - sizes[j])
+
+    objective = np.zeros(num_vars)
+    objective[arena] = 1
+    lower = np.zeros(num_vars)
+    upper_bounds = np.ones(num_vars)
+    upper_bounds[: len(placed)] = [upper - size for size in sizes]
+    lower[arena] = memory_lower_bound(placed) // unit
+    upper_bounds[arena] = upper
+    integrality = np.ones(num_vars)
+    integrality[arena] = 0
+    result = milp(
+        objective,
+        constraints=LinearConstraint(
+            coo_matrix((vals, (rows, cols)), shape=(len(lbs), num_vars)),
+            np.array(lbs),
+            np.array(ubs),
+        ),
+        integrality=integrality,
+        bounds=Bounds(lower, upper_bounds),
+        options={"time_limit": time_limit},
+    )
+    if result.x is None:
+        return greedy_offsets
+
+    offsets = {spec: 0 for spec in specs}
+    for i, spec in enumerate(placed):
+        offsets[spec] = int(round(result.x[i])) * unit
+    for i, j in pairs:
+        lhs, rhs = placed[i], placed[j]
+        if (
+            offsets[lhs] < offsets[rhs] + rhs.allocated_memory
+            and offsets[rhs] < offsets[lhs] + lhs.allocated_memory
+        ):
+            # Only trust solutions that are valid after rounding.
+            return greedy_offsets
+    if _arena_size(offsets) >= greedy_size:
+        return greedy_offsets
+    return offsets
+
+
+def ilp(
+    graph_module: torch.fx.GraphModule,
+    alignment: int,
+    graph_signature: Optional[ExportGraphSignature] = None,
+    alloc_graph_input: bool = True,
+    alloc_graph_output: bool = True,
+    time_limit: float = 60.0,
+) -> List[int]:
+    r"""
+    Place each tensor at the offset that minimizes the size of its buffer, by
+    solving a mixed integer linear program with scipy. Each buffer gets at most
+    `time_limit` seconds, and keeps the greedy_by_size plan if the solver does
+    not beat it in time. The program grows with the square of the number of
+    tensors alive at the same time, so this is meant for offline export rather
+    than for iterating on a model. Use functools.partial to set the time limit.
+
+    The lower bound of each buffer's size is stored in
+    graph_module.meta["non_const_buffer_lower_bounds"].
+    """
+    return _plan_offsets(
+        "ilp",
+        lambda specs, alignment: _place_ilp(specs, alignment, time_limit),
+        graph_module,
+        alignment,
+        graph_signature,
+        alloc_graph_input,
+        alloc_graph_output,
+    )
+
+
+@dataclass
+class MemoryTier:
+    r"""
+    A memory the tiered algorithm can place tensors in, e.g. on-chip SRAM,
+    TCM or external DRAM. `mem_id` is the id of the buffer the runtime's
+    HierarchicalAllocator provides for it, and `capacity` its size in bytes,
+    or None if it is unbounded.
+    """
+
+    mem_id: int
+    capacity: Optional[int] = None
+
+
+def _access_counts(graph_module: torch.fx.GraphModule) -> Dict[TensorSpec, int]:
+    r"""
+    Count the ops that read or write each tensor.
+    """
+    counts: Dict[TensorSpec, int] = defaultdict(int)
+    for node in graph_module.graph.nodes:
+        if node.op in ("placeholder", "output") or node.target == memory.alloc:
+            continue
+        touched = {
+            spec
+            for arg in [node, *node.all_input_nodes]
+            for spec in get_node_tensor_specs(arg)
+            if isinstance(spec, TensorSpec)
+        }
+        for spec in touched:
+            counts[spec] += 1
+    return counts
+
+
+def tiered(
+    graph_module: torch.fx.GraphModule,
+    alignment: int,
+    graph_signature: Optional[ExportGraphSignature] = None,
+    alloc_graph_input: bool = True,
+    alloc_graph_output: bool = True,
+    tiers: Optional[List[MemoryTier]] = None,
+) -> List[int]:
+    r"""
+    Spread the tensors over memories of different speeds, given from the
+    fastest to the slowest in `tiers`, and place them at offsets in each one
+    like greedy_by_size. Use functools.partial to set the tiers.
+
+    The tensors that are accessed most often per step of their lifetime go
+    first, each in the fastest tier where it fits within the tier's capacity,
+    so the slower tiers get the tensors that are accessed the least. Tensors
+    whose mem_id was already set, e.g. by a custom memory planning pass, keep
+    it. Raises if a tensor fits in none of the tiers.
+    """
+    tiers = tiers or [MemoryTier(mem_id=1)]
+    tier_ids = {tier.mem_id for tier in tiers}
+    input_bufsizes = typing.cast(
+        List[int], getattr(graph_module, "input_mem_buffer_sizes", None) or []
+    )
+    do_assertion = not getattr(graph_module, "encounter_to_out_var_failure", False)
+    specs = list(
+        collect_specs_from_nodes(
+            graph_module.graph.nodes,
+            graph_signature,
+            do_assertion=do_assertion,
+            ignore_graph_input=not alloc_graph_input,
+            ignore_graph_output=not alloc_graph_output,
+        )
+    )
+    for spec in specs:
+        spec.realign(alignment)
+    tree = _LifetimeIntervalTree(specs) if specs else None
+    offsets: Dict[int, Dict[TensorSpec, int]] = {mem_id: {} for mem_id in tier_ids}
+
+    def capacity(tier: MemoryTier) -> Optional[int]:
+        if tier.capacity is None:
+            return None
+        base = (
+            input_bufsizes[tier.mem_id] if tier.mem_id < len(input_bufsizes) else 0
+        )
+        return tier.capacity - base
+
+    # Tensors pinned to a tier go first.
+    for spec in sorted(
+        (spec for spec in specs if spec.mem_id in tier_ids),
+        key=lambda s: (-s.allocated_memory, s.lifetime[0]),
+    ):
+        tier_offsets = offsets[spec.mem_id]
+        tier_offsets[spec] = _best_fit_offset(spec, tier_offsets, tree)
+
+    counts = _access_counts(graph_module)
+    for spec in sorted(
+        (spec for spec in specs if spec.mem_id is None),
+        key=lambda s: (
+            -counts[s] / (s.lifetime[1] - s.lifetime[0] + 1),
+            -s.allocated_memory,
+            s.lifetime[0],
+        ),
+    ):
+        for tier in tiers:
+            tier_offsets = offsets[tier.mem_id]
+            offset = _best_fit_offset(spec, tier_offsets, tree)
+            limit = capacity(tier)
+            if limit is None or offset + spec.allocated_memory <= limit:
+                spec.mem_id = tier.mem_id
+                tier_offsets[spec] = offset
+                break
+        else:
+            raise RuntimeError(
+                f"Tensor of {spec.allocated_memory} bytes with lifetime "
+                f"{spec.lifetime} does not fit in any of the memory tiers {tiers}"
+            )
+
+    for tier in tiers:
+        limit = capacity(tier)
+        size = _arena_size(offsets[tier.mem_id])
+        if limit is not None and size > limit:
+            raise RuntimeError(
+                f"The tensors pinned to mem_id {tier.mem_id} need {size} bytes, "
+                f"more than its capacity of {tier.capacity} bytes"
+            )
+
+    def place(specs: List[TensorSpec], alignment: int) -> Dict[TensorSpec, int]:
+        if specs and specs[0] in offsets.get(specs[0].mem_id, {}):
+            return offsets[specs[0].mem_id]
+        # Buffers that are not tiers only hold tensors pinned to them.
+        return _place_greedy_by_size(specs)
+
+    return _plan_offsets(
+        "tiered",
+        place,
+        graph_module,
+        alignment,
+        graph_signature,
+        alloc_graph_input,
+        alloc_graph_output,
+    )
+
+
 def get_cond_nodes(graph_module: torch.fx.GraphModule) -> Iterable[Node]:
     for nd in graph_module.graph.nodes:
         if nd.target is torch.ops.higher_order.cond:
@@ -32,6 +32,9 @@ from executorch.exir.operator.convert import (
 
 from executorch.exir.pass_base import ExportPass
 from executorch.exir.pass_manager import PassManager, PassType
+from executorch.exir.passes.clone_delegate_loop_inputs_pass import (
+    CloneDelegateLoopInputsPass,
+)
 from executorch.exir.passes.const_prop_pass import ConstPropPass
 from executorch.exir.passes.debug_handle_generator_pass import DebugHandleGeneratorPass
 
@@ -39,7 +42,10 @@ from executorch.exir.passes.executorch_prim_ops_registry import _EXECUTORCH_SYM_
 from executorch.exir.passes.insert_write_back_for_buffers_pass import (
     insert_write_back_for_buffers_pass,
 )
-from executorch.exir.passes.memory_format_ops_pass import MemoryFormatOpsPass
+from executorch.exir.passes.memory_format_ops_pass import (
+    MemoryFormatOpsPass,
+    PropagateChannelsLastPass,
+)
 from executorch.exir.passes.memory_planning_pass import MemoryPlanningPass
 from executorch.exir.passes.normalize_transpose_pass import NormalizeTransposePass
 from executorch.exir.passes.quant_fusion_pass import QuantFusionPass
@@ -62,11 +68,13 @@ from torch.fx.passes.shape_prop import TensorMetadata
 
 __all__ = [
     "ExportPass",
+    "CloneDelegateLoopInputsPass",
     "ConstPropPass",
     "QuantFusionPass",
     "OpReplacePass",
     "EdgeToBackendOpsPass",
     "MemoryFormatOpsPass",
+    "PropagateChannelsLastPass",
     "MemoryPlanningPass",
     "HintBasedSymShapeEvalPass",
     "insert_write_back_for_buffers_pass",
@@ -0,0 +1,69 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import logging
+
+import torch
+from executorch.exir.delegate import executorch_call_delegate
+from executorch.exir.dialects._ops import ops as exir_ops
+from torch.fx.passes.infra.pass_base import PassBase, PassResult
+
+logger: logging.Logger = logging.getLogger(__name__)
+
+
+def _needs_own_value(node: torch.fx.Node) -> bool:
+    """
+    Returns True if a value passed as a carried input must be copied first: if
+    it is an input of the graph, or anything besides the loop reads it.
+    """
+    if not isinstance(node, torch.fx.Node):
+        return False
+    return node.op in ("placeholder", "get_attr") or len(node.users) > 1
+
+
+class CloneDelegateLoopInputsPass(PassBase):
+    """
+    Gives the carried inputs of delegate calls that run as loops (see
+    `to_backend_loop()`) values of their own.
+
+    Backends may overwrite the carried inputs of a loop with the values of each
+    iteration. This pass copies the carried inputs that are graph inputs, or
+    that other nodes read, so that nothing else sees those writes. Run it before
+    memory planning.
+    """
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        n_cloned = 0
+        for module in graph_module.modules():
+            if not isinstance(module, torch.fx.GraphModule):
+                continue
+            for node in list(module.graph.nodes):
+                if (
+                    node.op != "call_function"
+                    or node.target != executorch_call_delegate
+                ):
+                    continue
+                lowered_module = getattr(module, node.args[0].target)
+                loop_spec = getattr(lowered_module, "loop_spec", None)
+                if loop_spec is None:
+                    continue
+                for i in range(1, loop_spec.num_carried + 1):
+                    arg = node.args[i]
+                    if not _needs_own_value(arg):
+                        continue
+                    with module.graph.inserting_before(node):
+                        clone = module.graph.call_function(
+                            exir_ops.edge.aten.clone.default, (arg,)
+                        )
+                    clone.meta["val"] = arg.meta["val"]
+                    node.update_arg(i, clone)
+                    n_cloned += 1
+            module.recompile()
+
+        logger.debug(f"Cloned {n_cloned} carried inputs of delegate loops.")
+        return PassResult(graph_module, n_cloned > 0)
@@ -6,6 +6,7 @@
 
 # pyre-unsafe
 
+import logging
 from collections import OrderedDict
 from typing import cast, Mapping, Optional
 
@@ -35,12 +36,39 @@ _PRIMITIVE_TYPES = (
     int,
     bool,
     str,
+    type(None),
     torch.Tensor,
     torch.device,
     torch.dtype,
     torch.layout,
+    torch.memory_format,
 )
 
+_DEQUANTIZE_PER_TENSOR_TARGETS = {
+    torch.ops.quantized_decomposed.dequantize_per_tensor.default,
+    exir_ops.edge.quantized_decomposed.dequantize_per_tensor.default,
+}
+
+_DEQUANTIZE_PER_CHANNEL_TARGETS = {
+    torch.ops.quantized_decomposed.dequantize_per_channel.default,
+    exir_ops.edge.quantized_decomposed.dequantize_per_channel.default,
+}
+
+_PERMUTE_TARGETS = {
+    torch.ops.aten.permute.default,
+    torch.ops.aten.permute_copy.default,
+    exir_ops.edge.aten.permute_copy.default,
+}
+
+_TRANSPOSE_TARGETS = {
+    torch.ops.aten.t.default,
+    torch.ops.aten.t_copy.default,
+    torch.ops.aten.transpose.int,
+    torch.ops.aten.transpose_copy.int,
+    exir_ops.edge.aten.t_copy.default,
+    exir_ops.edge.aten.transpose_copy.int,
+}
+
 
 def is_const(
     arg,
@@ -85,9 +113,15 @@ def get_constant_placeholder_dict(
     Returns a dictionary of placeholder node -> constant tensor.
     """
     const_node_to_tensor: OrderedDict[torch.fx.Node, torch.Tensor] = OrderedDict()
+    signature = exported_program.graph_signature
+    # Buffers that the program writes to, e.g. KV caches, are state, not
+    # constants.
+    mutated_buffers = set(signature.buffers_to_mutate.values())
     for node in exported_program.graph.nodes:
         if node.op != "placeholder":
             continue
+        if signature.inputs_to_buffers.get(node.name, None) in mutated_buffers:
+            continue
 
         if is_param(exported_program, node):
             const_node_to_tensor[node] = cast(
@@ -104,6 +138,87 @@ def get_constant_placeholder_dict(
     return const_node_to_tensor
 
 
+def is_mutable_target(target) -> bool:
+    """
+    Whether the op writes to any of its inputs, in which case running it at
+    export time would drop the write from the program.
+    """
+    op = target._op if isinstance(target, EdgeOpOverload) else target
+    schema = getattr(op, "_schema", None)
+    return schema is not None and schema.is_mutable
+
+
+def layout_permutation(node: torch.fx.Node) -> Optional[list[int]]:
+    """
+    If the node is a permute or a transpose, returns the input dim that each
+    output dim comes from.
+    """
+    if node.target in _PERMUTE_TARGETS:
+        return list(cast(list[int], node.args[1]))
+    if node.target not in _TRANSPOSE_TARGETS:
+        return None
+    ndim = cast(torch.Tensor, node.meta["val"]).dim()
+    perm = list(range(ndim))
+    if ndim < 2:
+        return perm
+    dim0, dim1 = cast(tuple[int, int], node.args[1:3]) if len(node.args) > 1 else (0, 1)
+    dim0, dim1 = dim0 % ndim, dim1 % ndim
+    perm[dim0], perm[dim1] = perm[dim1], perm[dim0]
+    return perm
+
+
+def move_layout_op_before_dequantize(
+    exported_program: ExportedProgram,
+    node: torch.fx.Node,
+    const_node_to_tensor: OrderedDict[torch.fx.Node, torch.Tensor],
+    skip_targets: set[EdgeOpOverload],
+) -> bool:
+    """
+    Rewrites `layout_op(dequantize(weight))`, e.g. the transpose of a quantized
+    weight feeding a linear, to `dequantize(layout_op(weight))` when the
+    dequantize is not being folded, so that the layout op runs on the constant
+    quantized weight at export time instead of at every inference.
+
+    Returns whether the graph was rewritten.
+    """
+    perm = layout_permutation(node)
+    dq = node.args[0] if len(node.args) > 0 else None
+    if (
+        perm is None
+        or not isinstance(dq, torch.fx.Node)
+        or dq.target not in skip_targets
+        or len(dq.users) != 1
+        or not isinstance(dq.args[0], torch.fx.Node)
+        or dq.args[0] not in const_node_to_tensor
+    ):
+        return False
+    if dq.target in _DEQUANTIZE_PER_CHANNEL_TARGETS:
+        # The quantization axis follows its dim through the layout op.
+        axis = cast(int, dq.args[3]) % len(perm)
+        new_dq_args = dq.args[:3] + (perm.index(axis),) + dq.args[4:]
+    elif dq.target in _DEQUANTIZE_PER_TENSOR_TARGETS:
+        new_dq_args = dq.args
+    else:
+        return False
+
+    weight = dq.args[0]
+    with torch.no_grad():
+        moved_tensor = node.target(
+            const_node_to_tensor[weight], *node.args[1:], **node.kwargs
+        )
+    with exported_program.graph.inserting_before(dq):
+        moved = exported_program.graph.call_function(
+            node.target, (weight,) + node.args[1:], dict(node.kwargs)
+        )
+    moved.meta = dict(node.meta)
+    const_node_to_tensor[moved] = moved_tensor
+    dq.args = (moved,) + new_dq_args[1:]
+    dq.meta["val"] = node.meta["val"]
+    node.replace_all_uses_with(dq)
+    exported_program.graph.erase_node(node)
+    return True
+
+
 def get_propagated_const_tensor_dict(
     exported_program: ExportedProgram,
     custom_skip_targets: Optional[set[EdgeOpOverload]],
@@ -120,8 +235,14 @@ def get_propagated_const_tensor_dict(
         # Default set of targets to skip.
         all_skip_targets = _DEFAULT_SKIP_TARGETS
 
-    for node in exported_program.graph.nodes:
-        if node.op != "call_function" or node.target in all_skip_targets:
+    for node in list(exported_program.graph.nodes):
+        if node.op != "call_function":
+            continue
+        if move_layout_op_before_dequantize(
+            exported_program, node, const_node_to_tensor, all_skip_targets
+        ):
+            continue
+        if node.target in all_skip_targets or is_mutable_target(node.target):
             continue
 
         if not is_const(
@@ -143,7 +264,13 @@ def get_propagated_const_tensor_dict(
         # because of the grad_fn.
         with torch.no_grad():
             # Execute the `node.target` and create a new propagated constant tensor.
-            prop_constant_tensor = node.target(*args_data, **kwargs_data)
+            try:
+                prop_constant_tensor = node.target(*args_data, **kwargs_data)
+            except NotImplementedError:
+                # Custom ops whose CPU kernels are not loaded in this process,
+                # e.g. the llama custom ops, run at runtime instead.
+                logging.debug(f"Not propagating constants through {node.target}")
+                continue
         const_node_to_tensor[node] = prop_constant_tensor
 
     return const_node_to_tensor
@@ -271,6 +398,9 @@ def constant_prop_pass(
     Args:
         exported_program: The ExportedProgram to perform constant propagation on.
         custom_skip_targets: Optional set of EdgeOpOverload targets to skip during constant propagation.
+            When it includes the dequantize ops, weights stay quantized, and
+            the permutes and transposes of dequantized weights are folded into
+            the quantized weights instead.
 
     Returns:
         The modified ExportedProgram with constant propagation applied.
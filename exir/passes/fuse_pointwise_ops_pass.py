@@ -0,0 +1,209 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+from typing import Dict, List, Optional, Set, Tuple, Union
+
+import torch
+from executorch.exir.dialects._ops import ops as exir_ops
+from executorch.exir.pass_base import ExportPass, PassResult
+from executorch.exir.passes.fused_pointwise_ops_registry import (  # noqa: F401
+    lib,
+    MAX_POINTWISE_INSTRUCTIONS,
+    PointwiseOpcode,
+)
+from torch.fx import GraphModule, Node
+
+_BINARY_OPS: Dict[torch._ops.OpOverload, PointwiseOpcode] = {
+    exir_ops.edge.aten.add.Tensor: PointwiseOpcode.ADD,
+    exir_ops.edge.aten.sub.Tensor: PointwiseOpcode.SUB,
+    exir_ops.edge.aten.mul.Tensor: PointwiseOpcode.MUL,
+    exir_ops.edge.aten.div.Tensor: PointwiseOpcode.DIV,
+    exir_ops.edge.aten.add.Scalar: PointwiseOpcode.ADD,
+    exir_ops.edge.aten.sub.Scalar: PointwiseOpcode.SUB,
+    exir_ops.edge.aten.mul.Scalar: PointwiseOpcode.MUL,
+    exir_ops.edge.aten.div.Scalar: PointwiseOpcode.DIV,
+}
+
+_UNARY_OPS: Dict[torch._ops.OpOverload, PointwiseOpcode] = {
+    exir_ops.edge.aten.neg.default: PointwiseOpcode.NEG,
+    exir_ops.edge.aten.exp.default: PointwiseOpcode.EXP,
+    exir_ops.edge.aten.sigmoid.default: PointwiseOpcode.SIGMOID,
+    exir_ops.edge.aten.relu.default: PointwiseOpcode.RELU,
+    exir_ops.edge.aten.tanh.default: PointwiseOpcode.TANH,
+}
+
+_FUSABLE_DTYPES = (torch.float32, torch.float64)
+
+
+def _val(node: Node) -> Optional[torch.Tensor]:
+    val = node.meta.get("val", None)
+    return val if isinstance(val, torch.Tensor) else None
+
+
+def _is_fusable(node: Node) -> bool:
+    if node.op != "call_function":
+        return False
+    if node.target not in _BINARY_OPS and node.target not in _UNARY_OPS:
+        return False
+    # Only the operands and alpha are supported, not e.g. div's rounding_mode.
+    if any(k != "alpha" for k in node.kwargs):
+        return False
+    for arg in list(node.args) + list(node.kwargs.values()):
+        if not isinstance(arg, Node) and (
+            isinstance(arg, bool) or not isinstance(arg, (int, float))
+        ):
+            return False
+    val = _val(node)
+    return val is not None and val.dtype in _FUSABLE_DTYPES
+
+
+class _ProgramBuilder:
+    """
+    Builds the SSA program of the fused_ops.pointwise op for a group of nodes.
+    """
+
+    def __init__(self) -> None:
+        self.program: List[int] = []
+        self.inputs: List[Node] = []
+        self.constants: List[float] = []
+        self._registers: Dict[Union[Node, Tuple[str, float]], int] = {}
+
+    def _emit(self, opcode: PointwiseOpcode, arg0: int = 0, arg1: int = 0) -> int:
+        self.program += [int(opcode), arg0, arg1]
+        return len(self.program) // 3 - 1
+
+    def num_instructions(self) -> int:
+        return len(self.program) // 3
+
+    def input(self, node: Node) -> int:
+        if node not in self._registers:
+            self._registers[node] = self._emit(PointwiseOpcode.INPUT, len(self.inputs))
+            self.inputs.append(node)
+        return self._registers[node]
+
+    def constant(self, value: float) -> int:
+        key = ("constant", float(value))
+        if key not in self._registers:
+            self._registers[key] = self._emit(
+                PointwiseOpcode.CONSTANT, len(self.constants)
+            )
+            self.constants.append(float(value))
+        return self._registers[key]
+
+    def operand(self, arg: Union[Node, int, float]) -> int:
+        if isinstance(arg, Node):
+            if arg in self._registers:
+                return self._registers[arg]
+            return self.input(arg)
+        return self.constant(arg)
+
+    def node(self, node: Node) -> None:
+        if node.target in _UNARY_OPS:
+            reg = self._emit(_UNARY_OPS[node.target], self.operand(node.args[0]))
+        else:
+            lhs = self.operand(node.args[0])
+            rhs = self.operand(node.args[1])
+            alpha = node.kwargs.get("alpha", 1)
+            if alpha != 1 and node.target in (
+                exir_ops.edge.aten.add.Tensor,
+                exir_ops.edge.aten.sub.Tensor,
+                exir_ops.edge.aten.add.Scalar,
+                exir_ops.edge.aten.sub.Scalar,
+            ):
+                rhs = self._emit(PointwiseOpcode.MUL, rhs, self.constant(alpha))
+            reg = self._emit(_BINARY_OPS[node.target], lhs, rhs)
+        self._registers[node] = reg
+
+
+class FusePointwiseOpsPass(ExportPass):
+    """
+    Replaces chains of elementwise edge ops, such as add -> mul -> sigmoid,
+    with a single fused_ops.pointwise op that computes the whole chain in one
+    pass over memory instead of reading and writing every intermediate tensor.
+
+    A group is only fused if every node in it produces a float32 or float64
+    tensor of the same shape, every intermediate value is only used inside the
+    group, and every input to the group has the output's shape or a single
+    element.
+    """
+
+    def _grow_group(self, root: Node) -> List[Node]:
+        root_val = _val(root)
+        assert root_val is not None
+        group: Set[Node] = {root}
+        changed = True
+        while changed:
+            changed = False
+            for node in list(group):
+                for arg in node.args:
+                    if not isinstance(arg, Node) or arg in group:
+                        continue
+                    if not _is_fusable(arg):
+                        continue
+                    arg_val = _val(arg)
+                    assert arg_val is not None
+                    if (
+                        arg_val.dtype != root_val.dtype
+                        or arg_val.shape != root_val.shape
+                    ):
+                        continue
+                    if all(user in group for user in arg.users):
+                        group.add(arg)
+                        changed = True
+        # Nodes are in topological order in the graph.
+        order = {n: i for i, n in enumerate(root.graph.nodes)}
+        return sorted(group, key=lambda n: order[n])
+
+    def _inputs_are_supported(self, root: Node, inputs: List[Node]) -> bool:
+        root_val = _val(root)
+        assert root_val is not None
+        for node in inputs:
+            val = _val(node)
+            if val is None or val.dtype != root_val.dtype:
+                return False
+            if val.shape != root_val.shape and not (
+                val.numel() == 1 and val.dim() <= root_val.dim()
+            ):
+                return False
+        return True
+
+    def call(self, graph_module: GraphModule) -> PassResult:
+        modified = False
+        graph = graph_module.graph
+        fused: Set[Node] = set()
+        for root in reversed(list(graph.nodes)):
+            if root in fused or not _is_fusable(root):
+                continue
+            group = self._grow_group(root)
+            if len(group) < 2:
+                continue
+
+            builder = _ProgramBuilder()
+            for node in group:
+                builder.node(node)
+            if builder.num_instructions() > MAX_POINTWISE_INSTRUCTIONS:
+                continue
+            if not self._inputs_are_supported(root, builder.inputs):
+                continue
+
+            with graph.inserting_before(root):
+                fused_node = graph.call_function(
+                    exir_ops.edge.fused_ops.pointwise.default,
+                    (builder.inputs, builder.program, builder.constants),
+                )
+            fused_node.meta = root.meta.copy()
+            root.replace_all_uses_with(fused_node)
+            for node in reversed(group):
+                graph.erase_node(node)
+            fused.update(group)
+            modified = True
+
+        if modified:
+            graph.lint()
+            graph_module.recompile()
+        return PassResult(graph_module, modified)
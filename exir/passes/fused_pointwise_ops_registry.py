@@ -0,0 +1,112 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+from enum import IntEnum
+from typing import Callable, Dict, List, Sequence
+
+import torch
+
+from torch.library import impl, Library
+
+lib = Library("fused_ops", "DEF")
+
+# Computes a chain of pointwise ops in a single pass over memory. See
+# kernels/optimized/cpu/op_fused_pointwise.h for the encoding of `program`.
+lib.define("pointwise(Tensor[] inputs, int[] program, float[] constants) -> Tensor")
+
+lib.define(
+    "pointwise.out(Tensor[] inputs, int[] program, float[] constants, *, Tensor(a!) out) -> Tensor(a!)"
+)
+
+# The maximum number of instructions that the runtime kernel accepts.
+MAX_POINTWISE_INSTRUCTIONS = 32
+
+
+class PointwiseOpcode(IntEnum):
+    """
+    Must stay in sync with PointwiseOpcode in
+    kernels/optimized/cpu/op_fused_pointwise.h.
+    """
+
+    INPUT = 0
+    CONSTANT = 1
+    ADD = 2
+    SUB = 3
+    MUL = 4
+    DIV = 5
+    NEG = 6
+    EXP = 7
+    SIGMOID = 8
+    RELU = 9
+    TANH = 10
+
+
+_BINARY_FNS: Dict[
+    PointwiseOpcode, Callable[[torch.Tensor, torch.Tensor], torch.Tensor]
+] = {
+    PointwiseOpcode.ADD: torch.add,
+    PointwiseOpcode.SUB: torch.sub,
+    PointwiseOpcode.MUL: torch.mul,
+    PointwiseOpcode.DIV: torch.div,
+}
+
+_UNARY_FNS: Dict[PointwiseOpcode, Callable[[torch.Tensor], torch.Tensor]] = {
+    PointwiseOpcode.NEG: torch.neg,
+    PointwiseOpcode.EXP: torch.exp,
+    PointwiseOpcode.SIGMOID: torch.sigmoid,
+    PointwiseOpcode.RELU: torch.relu,
+    PointwiseOpcode.TANH: torch.tanh,
+}
+
+
+def _output_shape(inputs: Sequence[torch.Tensor]) -> List[int]:
+    return list(max(inputs, key=lambda t: t.numel()).shape)
+
+
+@impl(lib, "pointwise", "CompositeExplicitAutograd")
+def pointwise_impl(
+    inputs: List[torch.Tensor], program: List[int], constants: List[float]
+) -> torch.Tensor:
+    """
+    Reference interpreter for `program`, used when running the graph eagerly.
+    """
+    assert len(program) % 3 == 0, f"Invalid program size {len(program)}"
+    dtype = inputs[0].dtype
+    regs: List[torch.Tensor] = []
+    for i in range(0, len(program), 3):
+        opcode, arg0, arg1 = PointwiseOpcode(program[i]), program[i + 1], program[i + 2]
+        if opcode == PointwiseOpcode.INPUT:
+            regs.append(inputs[arg0])
+        elif opcode == PointwiseOpcode.CONSTANT:
+            regs.append(torch.tensor(constants[arg0], dtype=dtype))
+        elif opcode in _BINARY_FNS:
+            regs.append(_BINARY_FNS[opcode](regs[arg0], regs[arg1]))
+        else:
+            regs.append(_UNARY_FNS[opcode](regs[arg0]))
+    return regs[-1].expand(_output_shape(inputs)).clone()
+
+
+@impl(lib, "pointwise", "Meta")
+def pointwise_meta(
+    inputs: List[torch.Tensor], program: List[int], constants: List[float]
+) -> torch.Tensor:
+    return torch.empty(_output_shape(inputs), dtype=inputs[0].dtype, device="meta")
+
+
+@impl(lib, "pointwise.out", "CompositeExplicitAutograd")
+def pointwise_out_impl(
+    inputs: List[torch.Tensor],
+    program: List[int],
+    constants: List[float],
+    *,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    result = pointwise_impl(inputs, program, constants)
+    out.resize_(result.shape)
+    out.copy_(result)
+    return out
@@ -19,6 +19,48 @@ from torch.export.graph_signature import TensorArgument
 from torch.utils import _pytree as pytree
 
 
+def _written_in_place_arg(node: torch.fx.Node) -> Optional[torch.fx.Node]:
+    """
+    If `node` writes in place into one of its arguments and returns it, as the
+    schema `Tensor(a!) self -> Tensor(a!)` declares, returns that argument.
+    """
+    if node.op != "call_function":
+        return None
+    schema = getattr(node.target, "_schema", None)
+    if schema is None or len(schema.returns) != 1:
+        return None
+    ret_alias = schema.returns[0].alias_info
+    if ret_alias is None or not ret_alias.is_write:
+        return None
+    for i, arg in enumerate(schema.arguments):
+        if (
+            arg.alias_info is None
+            or not arg.alias_info.is_write
+            or not set(arg.alias_info.before_set) & set(ret_alias.before_set)
+        ):
+            continue
+        value = node.args[i] if i < len(node.args) else node.kwargs.get(arg.name)
+        return value if isinstance(value, torch.fx.Node) else None
+    return None
+
+
+def _is_updated_in_place(
+    return_node: torch.fx.Node, mutated_node: torch.fx.Node
+) -> bool:
+    """
+    Returns True if `return_node` is `mutated_node` itself, or the result of a
+    chain of ops that write in place into it, so that by the end of the graph
+    the input already holds its new value and writing it back would copy it
+    onto itself.
+    """
+    node: Optional[torch.fx.Node] = return_node
+    while node is not None:
+        if node is mutated_node:
+            return True
+        node = _written_in_place_arg(node)
+    return False
+
+
 def _insert_copy(
     gm: torch.fx.GraphModule,
     mutated_outputs: List[Optional[str]],
@@ -27,6 +69,9 @@ def _insert_copy(
     """
     Find the all the buffers and inputs that were mutated and insert copy_
     operators to reflect mutations.
+
+    Mutations that were already done in place need no copy_; the input itself
+    is returned in place of the copy.
     """
     output_node = None
     for node in gm.graph.nodes:
@@ -53,6 +98,10 @@ def _insert_copy(
                 f"Could not find {mutated_node_name} in either buffer or input nodes"
             )
 
+        if _is_updated_in_place(return_node, mutated_node):
+            buffer_output_nodes.append(mutated_node)
+            continue
+
         # insert copy
         with gm.graph.inserting_before(output_node):
             buffer_output = gm.graph.call_function(
@@ -99,16 +148,13 @@ def insert_write_back_for_buffers_pass(
         if lifted_node is not None:
             input_name_to_node[lifted_node] = input_node
 
-    # Grab the mutable buffer nodes in the outputs,
+    # Grab the mutable buffer nodes in the outputs. _insert_copy() skips those
+    # whose mutations were all done in place.
     mutated_outputs: List[Optional[str]] = [
         (
             out_spec.target
             if out_spec.kind
             in (OutputKind.BUFFER_MUTATION, OutputKind.USER_INPUT_MUTATION)
-            and out_spec.arg.name
-            not in {
-                val.name for val in input_name_to_node.values()
-            }  # if the output arg is the input value then all operations on it are in-place so theres no need to add a copy_ node
             else None
         )
         for out_spec in ep.graph_signature.output_specs
@@ -6,11 +6,19 @@
 
 import copy
 import logging
+import operator
+from typing import Dict, List, Set, Tuple
 
 import torch
+from executorch.exir.dialects._ops import ops as exir_ops
 from executorch.exir.dialects.edge._ops import EdgeOpOverload
-from executorch.exir.dim_order_utils import get_dim_order, get_memory_format
-from executorch.exir.pass_base import ExportPass, ProxyValue
+from executorch.exir.dim_order_utils import (
+    get_dim_order,
+    get_memory_format,
+    is_channel_last_dim_order,
+    is_contiguous_dim_order,
+)
+from executorch.exir.pass_base import ExportPass, PassBase, PassResult, ProxyValue
 from executorch.exir.passes.dim_order_ops_registry import (
     DimOrderOpsMap,
     MemoryFormatOpsMap,
@@ -120,3 +128,246 @@ class DimOrderOpsRevertPass(ExportPass):
             nkwargs,
             meta,
         )
+
+
+# Edge ops whose kernels take channels last inputs and produce channels last
+# outputs, mapped to the positions of the args that must have the same dim
+# order as the output. Their other args, e.g. weights, keep their dim order.
+CHANNELS_LAST_OPS: Dict[EdgeOpOverload, Tuple[int, ...]] = {
+    exir_ops.edge.aten.convolution.default: (0,),
+    exir_ops.edge.aten.avg_pool2d.default: (0,),
+    exir_ops.edge.aten.max_pool2d_with_indices.default: (0,),
+    exir_ops.edge.aten._native_batch_norm_legit_no_training.default: (0,),
+    exir_ops.edge.aten.upsample_nearest2d.vec: (0,),
+    exir_ops.edge.aten.upsample_bilinear2d.vec: (0,),
+    exir_ops.edge.aten.add.Tensor: (0, 1),
+    exir_ops.edge.aten.sub.Tensor: (0, 1),
+    exir_ops.edge.aten.mul.Tensor: (0, 1),
+    exir_ops.edge.aten.div.Tensor: (0, 1),
+    exir_ops.edge.aten.relu.default: (0,),
+    exir_ops.edge.aten.hardtanh.default: (0,),
+    exir_ops.edge.aten.clamp.default: (0,),
+    exir_ops.edge.aten.sigmoid.default: (0,),
+    exir_ops.edge.aten.tanh.default: (0,),
+}
+
+
+def _is_4d_tensor(val) -> bool:
+    return isinstance(val, torch.Tensor) and val.dim() == 4
+
+
+def _is_dim_order_copy(node: torch.fx.Node, channels_last: bool) -> bool:
+    """
+    Whether the node only converts a 4d tensor to the channels last or the
+    contiguous dim order, keeping its dtype.
+    """
+    if node.op != "call_function" or node.target != _to_dim_order_copy_op():
+        return False
+    src = node.args[0]
+    if not isinstance(src, torch.fx.Node) or not _is_4d_tensor(src.meta.get("val")):
+        return False
+    dtype = node.kwargs.get("dtype", None)
+    if dtype is not None and dtype != src.meta["val"].dtype:
+        return False
+    memory_format = torch.channels_last if channels_last else torch.contiguous_format
+    return node.kwargs.get("dim_order", None) == get_dim_order(memory_format, 4)
+
+
+def _to_dim_order_copy_op() -> EdgeOpOverload:
+    return exir_ops.edge.dim_order_ops._to_dim_order_copy.default
+
+
+class PropagateChannelsLastPass(PassBase):
+    """
+    Removes the _to_dim_order_copy round trips around chains of ops that have
+    channels last kernels, e.g. a pool and an activation between two convs of
+    a channels last model.
+
+    Starting from each copy that converts a channels last tensor to the
+    contiguous dim order, the pass grows the region of CHANNELS_LAST_OPS that
+    can consume that tensor directly, and runs them in the channels last dim
+    order instead. Copies back to channels last at the edges of the region go
+    away, and a single copy to the contiguous dim order is added for each
+    region output that is still read in that order. A region is only rewritten
+    when that removes more copies than it adds.
+
+    Runs on edge programs that use the dim order ops, e.g. through
+    `EdgeProgramManager.transform([PropagateChannelsLastPass()])`.
+    """
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        modified = False
+        for module in graph_module.modules():
+            if isinstance(module, torch.fx.GraphModule):
+                modified |= self._propagate(module.graph)
+        if modified:
+            graph_module.recompile()
+        return PassResult(graph_module, modified)
+
+    def _propagate(self, graph: torch.fx.Graph) -> bool:
+        modified = False
+        for node in list(graph.nodes):
+            # Earlier rewrites may have consumed the copy.
+            if node.graph is not graph or not self._is_entry(node):
+                continue
+            region, entries, values = self._grow(node)
+            if region and self._saves_copies(entries, values, region):
+                self._rewrite(graph, region, entries, values)
+                modified = True
+        return modified
+
+    @staticmethod
+    def _is_entry(node: torch.fx.Node) -> bool:
+        # A copy from channels last to contiguous.
+        return _is_dim_order_copy(node, channels_last=False) and (
+            is_channel_last_dim_order(node.args[0].meta["val"])  # pyre-ignore
+        )
+
+    @staticmethod
+    def _layout_values(node: torch.fx.Node) -> List[torch.fx.Node]:
+        """
+        The nodes that hold the 4d outputs of an op: the op itself, or the
+        getitems of an op with several outputs.
+        """
+        if isinstance(node.meta["val"], torch.Tensor):
+            return [node]
+        return [
+            user
+            for user in node.users
+            if user.op == "call_function"
+            and user.target is operator.getitem
+            and _is_4d_tensor(user.meta.get("val"))
+        ]
+
+    def _can_absorb(
+        self, node: torch.fx.Node, values: Set[torch.fx.Node]
+    ) -> bool:
+        if node.op != "call_function" or node.target not in CHANNELS_LAST_OPS:
+            return False
+        outputs = node.meta.get("val")
+        outputs = outputs if isinstance(outputs, (tuple, list)) else [outputs]
+        if not _is_4d_tensor(outputs[0]):
+            return False
+        # The outputs must be contiguous now, so that readers outside the
+        # region can get that dim order back with a copy.
+        if not all(
+            is_contiguous_dim_order(out) for out in outputs if _is_4d_tensor(out)
+        ):
+            return False
+        for i in CHANNELS_LAST_OPS[node.target]:  # pyre-ignore
+            arg = node.args[i] if i < len(node.args) else None
+            if not isinstance(arg, torch.fx.Node):
+                return False
+            if arg not in values and not self._is_entry(arg):
+                return False
+        return True
+
+    def _grow(
+        self, seed: torch.fx.Node
+    ) -> Tuple[Set[torch.fx.Node], Set[torch.fx.Node], Set[torch.fx.Node]]:
+        """
+        Returns the ops of the region, the entry copies that it reads, and the
+        nodes that hold its 4d outputs.
+        """
+        region: Set[torch.fx.Node] = set()
+        entries: Set[torch.fx.Node] = {seed}
+        values: Set[torch.fx.Node] = set()
+        stack = [seed]
+        while stack:
+            value = stack.pop()
+            for user in value.users:
+                if user in region or not self._can_absorb(user, values):
+                    continue
+                region.add(user)
+                for i in CHANNELS_LAST_OPS[user.target]:  # pyre-ignore
+                    arg = user.args[i]
+                    if arg not in values and arg not in entries:
+                        entries.add(arg)  # pyre-ignore
+                        stack.append(arg)
+                for output in self._layout_values(user):
+                    values.add(output)
+                    stack.append(output)
+        return region, entries, values
+
+    @staticmethod
+    def _saves_copies(
+        entries: Set[torch.fx.Node],
+        values: Set[torch.fx.Node],
+        region: Set[torch.fx.Node],
+    ) -> bool:
+        removed = 0
+        added = 0
+        for entry in entries:
+            if all(user in region for user in entry.users):
+                removed += 1
+        for value in values:
+            outside = [user for user in value.users if user not in region]
+            to_channels_last = [
+                user
+                for user in outside
+                if _is_dim_order_copy(user, channels_last=True)
+            ]
+            removed += len(to_channels_last)
+            if len(to_channels_last) < len(outside):
+                added += 1
+        return removed > added
+
+    def _rewrite(
+        self,
+        graph: torch.fx.Graph,
+        region: Set[torch.fx.Node],
+        entries: Set[torch.fx.Node],
+        values: Set[torch.fx.Node],
+    ) -> None:
+        for node in region:
+            for entry in entries:
+                node.replace_input_with(entry, entry.args[0])  # pyre-ignore
+            val = node.meta["val"]
+            if isinstance(val, torch.Tensor):
+                node.meta["val"] = val.contiguous(memory_format=torch.channels_last)
+            else:
+                node.meta["val"] = type(val)(
+                    (
+                        out.contiguous(memory_format=torch.channels_last)
+                        if _is_4d_tensor(out)
+                        else out
+                    )
+                    for out in val
+                )
+
+        contiguous_dim_order = get_dim_order(torch.contiguous_format, 4)
+        for value in values:
+            contiguous_val = value.meta["val"]
+            if value not in region:
+                # A getitem of a region op.
+                value.meta["val"] = contiguous_val.contiguous(
+                    memory_format=torch.channels_last
+                )
+            outside = [user for user in value.users if user not in region]
+            readers = []
+            for user in outside:
+                if _is_dim_order_copy(user, channels_last=True):
+                    user.replace_all_uses_with(value)
+                    graph.erase_node(user)
+                else:
+                    readers.append(user)
+            if not readers:
+                continue
+            with graph.inserting_after(value):
+                copy_node = graph.call_function(
+                    _to_dim_order_copy_op(),
+                    (value,),
+                    {"dim_order": contiguous_dim_order},
+                )
+            copy_node.meta = copy.copy(value.meta)
+            copy_node.meta["val"] = contiguous_val
+            for reader in readers:
+                reader.replace_input_with(value, copy_node)
+
+        for entry in entries:
+            if len(entry.users) == 0:
+                graph.erase_node(entry)
+        logger.debug(
+            f"Runs {len(region)} ops in channels last, "
+            f"reading {len(entries)} channels last tensors."
+        )
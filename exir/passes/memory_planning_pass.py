@@ -6,11 +6,11 @@
 
 import logging
 import warnings
-from typing import Callable, List, Optional
+from typing import Callable, List, Optional, Set
 
 import torch
 from executorch.exir.error import internal_assert
-from executorch.exir.memory import alloc
+from executorch.exir.memory import alloc, view
 from executorch.exir.memory_planning import (
     _is_out_var_node,
     apply_algo,
@@ -20,8 +20,26 @@ from executorch.exir.memory_planning import (
 )
 from executorch.exir.operator.convert import get_out_args_from_opoverload
 from executorch.exir.pass_base import PassBase, PassResult
-from executorch.exir.tensor import ALIGNMENT
+from executorch.exir.schema import TensorShapeDynamism
+from executorch.exir.tensor import ALIGNMENT, TensorSpec
 from torch.export.exported_program import ExportGraphSignature
+from torch.utils import _pytree as pytree
+
+# Out-variant ops whose kernels only read element i of `self` before writing
+# element i of `out`, so `out` may share the storage of `self` when they have
+# the same shape. Kernels for these ops must keep supporting that aliasing.
+_INPLACE_SAFE_OPS: Set[str] = {
+    "aten::add.out",
+    "aten::clamp.out",
+    "aten::hardtanh.out",
+    "aten::mul.out",
+    "aten::relu.out",
+}
+
+
+def _schema_key(node: torch.fx.Node) -> str:
+    schema = node.target._schema  # pyre-ignore
+    return f"{schema.name}.{schema.overload_name}"
 
 
 class MemoryPlanningPass(PassBase):
@@ -32,18 +50,24 @@ class MemoryPlanningPass(PassBase):
         alloc_graph_input: bool = True,
         alloc_graph_output: bool = True,
         alignment: int = ALIGNMENT,
+        alias_inplace_outputs: bool = False,
     ) -> None:
         r"""
         alloc_graph_input/alloc_graph_output will have 4 different combinations
         to control if the memory planning algorithm need allocate memory for
         the graph input/output. The default behavior is the algorithm will allocate
         memory for both graph input and output.
+
+        If alias_inplace_outputs is True, the output of an in-place safe
+        elementwise op reuses the storage of its `self` input when that input
+        is not used after the op.
         """
         self.memory_planning_algo = memory_planning_algo
         self.allow_lifetime_and_storage_overlap = allow_lifetime_and_storage_overlap
         self.alloc_graph_input = alloc_graph_input
         self.alloc_graph_output = alloc_graph_output
         self.alignment = alignment
+        self.alias_inplace_outputs = alias_inplace_outputs
 
     def _set_alloc_node_spec(self, graph_module: torch.fx.GraphModule) -> None:
         """
@@ -83,6 +107,65 @@ class MemoryPlanningPass(PassBase):
                         )
                         out_alloc_node.meta["spec"] = specs[i]
 
+    def _alias_inplace_outputs(self, graph_module: torch.fx.GraphModule) -> None:
+        """
+        Makes the output of every op in _INPLACE_SAFE_OPS share the TensorSpec
+        of its `self` input when `self` is an intermediate tensor that dies at
+        the op. The memory planning algorithm then allocates a single buffer
+        for both tensors.
+
+        Only the top-level graph is handled, since the lifetime of a tensor in
+        a control flow submodule also depends on the enclosing graph.
+        """
+        graph = graph_module.graph
+        order = {node: i for i, node in enumerate(graph.nodes)}
+        graph_outputs = set()
+        for node in graph.nodes:
+            if node.op == "output":
+                graph_outputs.update(
+                    arg
+                    for arg in pytree.tree_flatten(node.args)[0]
+                    if isinstance(arg, torch.fx.Node)
+                )
+
+        for node in graph.nodes:
+            if not _is_out_var_node(node) or _schema_key(node) not in _INPLACE_SAFE_OPS:
+                continue
+            base = node.args[0]
+            out_alloc = node.kwargs.get("out")
+            if not isinstance(base, torch.fx.Node) or not isinstance(
+                out_alloc, torch.fx.Node
+            ):
+                continue
+            # `base` must be an intermediate produced by another out-variant op.
+            # Graph outputs are left alone, since they may be replaced at
+            # runtime.
+            if not _is_out_var_node(base) or {base, node} & graph_outputs:
+                continue
+            if any(
+                user.target == view or order[user] > order[node]
+                for user in base.users
+            ):
+                continue
+            base_spec = base.meta.get("spec")
+            out_spec = node.meta.get("spec")
+            if not isinstance(base_spec, TensorSpec) or not isinstance(
+                out_spec, TensorSpec
+            ):
+                continue
+            if (
+                base_spec.const
+                or base_spec.shape_dynamism != TensorShapeDynamism.STATIC
+                or out_spec.shape_dynamism != TensorShapeDynamism.STATIC
+                or base_spec.dtype != out_spec.dtype
+                or list(base_spec.shape) != list(out_spec.shape)
+                or list(base_spec.dim_order) != list(out_spec.dim_order)
+                or base_spec.mem_id != out_spec.mem_id
+            ):
+                continue
+            node.meta["spec"] = base_spec
+            out_alloc.meta["spec"] = base_spec
+
     def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
         return self.run(graph_module)
 
@@ -96,6 +179,8 @@ class MemoryPlanningPass(PassBase):
         memory_planning_algo
         """
         self._set_alloc_node_spec(graph_module)
+        if self.alias_inplace_outputs:
+            self._alias_inplace_outputs(graph_module)
         # TODO(shunting) if people have concern of adding a field to GraphModule
         # directly, we should define a GraphModule subclass that we can add our
         # customized fields. Using the graph_module object to convey information across
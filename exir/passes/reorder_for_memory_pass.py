@@ -0,0 +1,213 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import logging
+import operator
+from typing import Dict, List, Optional, Set
+
+import torch
+from executorch.exir.pass_base import PassBase, PassResult
+from executorch.exir.tensor import TensorSpec
+from torch.fx import Node
+from torch.utils import _pytree as pytree
+
+# Minimize the bytes of tensors alive at once.
+MEMORY = "memory"
+# Run consumers right after their producers while their outputs are still in
+# cache, as long as that does not raise the peak.
+LOCALITY = "locality"
+
+
+def _storage_owner(node: Node) -> Node:
+    # getitem outputs are elements of their producer's outputs.
+    while node.op == "call_function" and node.target is operator.getitem:
+        node = node.args[0]  # pyre-ignore[9]
+    return node
+
+
+def _bytes(node: Node) -> int:
+    if node.op != "call_function" or node.target is operator.getitem:
+        return 0
+    specs, _ = pytree.tree_flatten(node.meta.get("spec", None))
+    return sum(
+        spec.nbytes()
+        for spec in specs
+        if isinstance(spec, TensorSpec) and not spec.const
+    )
+
+
+class _Liveness:
+    r"""
+    Tracks the bytes of the tensors that are alive while the nodes of a graph
+    are executed in some order. The output of a node is alive from the node
+    that produces it to its last consumer, both included.
+    """
+
+    def __init__(self, nodes: List[Node]) -> None:
+        self.sizes: Dict[Node, int] = {node: _bytes(node) for node in nodes}
+        self.consumers: Dict[Node, Set[Node]] = {node: set() for node in nodes}
+        self.owners: Dict[Node, Set[Node]] = {}
+        for node in nodes:
+            if node.op == "call_function" and node.target is operator.getitem:
+                self.owners[node] = set()
+                continue
+            owners = {_storage_owner(arg) for arg in node.all_input_nodes}
+            self.owners[node] = owners
+            for owner in owners:
+                self.consumers[owner].add(node)
+        self.remaining: Dict[Node, int] = {
+            node: len(users) for node, users in self.consumers.items()
+        }
+        self.live = 0
+        self.peak = 0
+
+    def freed_by(self, node: Node) -> List[Node]:
+        r"""
+        The owners of storage that is dead once `node` runs.
+        """
+        freed = [owner for owner in self.owners[node] if self.remaining[owner] == 1]
+        if self.remaining[node] == 0:
+            freed.append(node)
+        return freed
+
+    def delta(self, node: Node) -> int:
+        freed = self.freed_by(node)
+        return self.sizes[node] - sum(self.sizes[owner] for owner in freed)
+
+    def run(self, node: Node) -> None:
+        freed = self.freed_by(node)
+        self.live += self.sizes[node]
+        self.peak = max(self.peak, self.live)
+        for owner in self.owners[node]:
+            self.remaining[owner] -= 1
+        self.live -= sum(self.sizes[owner] for owner in freed)
+
+
+def peak_live_bytes(nodes: List[Node]) -> int:
+    r"""
+    Return the peak bytes of the non constant tensors produced by `nodes` that
+    are alive at the same time when the nodes run in the given order.
+    """
+    liveness = _Liveness(nodes)
+    for node in nodes:
+        liveness.run(node)
+    return liveness.peak
+
+
+def _is_barrier(node: Node) -> bool:
+    # Nodes that are not pure ops keep their position, and the ops between
+    # them are only reordered among themselves.
+    return node.op != "call_function" or node.is_impure()
+
+
+class ReorderForMemoryPass(PassBase):
+    r"""
+    Reorders the independent ops of each graph, which otherwise run in traced
+    order, to lower the peak bytes of tensors alive at once. Run it right
+    before memory planning, since the lifetimes it plans with follow the
+    order of the nodes.
+
+    The schedule is a list scheduling of the ops whose inputs are all ready:
+    with the MEMORY strategy the next op is the one that grows the live bytes
+    the least, and with the LOCALITY strategy it is a consumer of the last
+    op's outputs when there is one. Impure ops and non op nodes are kept in
+    place. A graph keeps its order if the new one does not lower its peak.
+
+    The peaks before and after are logged and stored in
+    graph_module.meta["peak_live_bytes_before_reorder"] and
+    graph_module.meta["peak_live_bytes_after_reorder"].
+    """
+
+    def __init__(self, strategy: str = MEMORY) -> None:
+        if strategy not in (MEMORY, LOCALITY):
+            raise ValueError(f"Unknown reorder strategy {strategy}")
+        self.strategy = strategy
+
+    def _schedule(self, nodes: List[Node]) -> List[Node]:
+        liveness = _Liveness(nodes)
+        position = {node: idx for idx, node in enumerate(nodes)}
+        order: List[Node] = []
+        segment: List[Node] = []
+
+        def flush() -> None:
+            members = set(segment)
+            pending = {
+                node: sum(1 for arg in node.all_input_nodes if arg in members)
+                for node in segment
+            }
+            ready = [node for node in segment if pending[node] == 0]
+            last: Optional[Node] = None
+            while ready:
+                candidates = ready
+                if self.strategy == LOCALITY and last is not None:
+                    owner = _storage_owner(last)
+                    consumers = [
+                        node for node in ready if owner in liveness.owners[node]
+                    ]
+                    candidates = consumers or ready
+                # getitem nodes cost nothing, so take them as soon as possible.
+                node = min(
+                    candidates,
+                    key=lambda n: (
+                        n.target is not operator.getitem,
+                        liveness.delta(n),
+                        position[n],
+                    ),
+                )
+                ready.remove(node)
+                liveness.run(node)
+                order.append(node)
+                if node.target is not operator.getitem:
+                    last = node
+                for user in node.users:
+                    if user in pending:
+                        pending[user] -= 1
+                        if pending[user] == 0:
+                            ready.append(user)
+            segment.clear()
+
+        for node in nodes:
+            if _is_barrier(node):
+                flush()
+                liveness.run(node)
+                order.append(node)
+            else:
+                segment.append(node)
+        flush()
+        return order
+
+    def _reorder(self, graph_module: torch.fx.GraphModule) -> bool:
+        nodes = list(graph_module.graph.nodes)
+        before = peak_live_bytes(nodes)
+        order = self._schedule(nodes)
+        after = peak_live_bytes(order)
+        if after >= before and (self.strategy == MEMORY or after > before):
+            after = before
+            order = nodes
+        graph_module.meta["peak_live_bytes_before_reorder"] = before
+        graph_module.meta["peak_live_bytes_after_reorder"] = after
+        logging.info(
+            f"ReorderForMemoryPass ({self.strategy}): peak live bytes {before} -> "
+            f"{after}"
+        )
+        if order == nodes:
+            return False
+        prev = order[0]
+        for node in order[1:]:
+            prev.append(node)
+            prev = node
+        graph_module.graph.lint()
+        graph_module.recompile()
+        return True
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        modified = False
+        for module in graph_module.modules():
+            if isinstance(module, torch.fx.GraphModule):
+                modified |= self._reorder(module)
+        return PassResult(graph_module, modified)
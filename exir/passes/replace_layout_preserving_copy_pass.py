@@ -0,0 +1,136 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import logging
+from typing import List, Optional
+
+import torch
+
+from executorch.exir.dialects._ops import ops
+from torch.fx.passes.infra.pass_base import PassBase, PassResult
+
+logger: logging.Logger = logging.getLogger(__name__)
+
+_PERMUTE_OPS = (
+    torch.ops.aten.permute_copy.default,
+    ops.edge.aten.permute_copy.default,
+)
+_TRANSPOSE_OPS = (
+    torch.ops.aten.transpose_copy.int,
+    ops.edge.aten.transpose_copy.int,
+)
+_SELECT_OPS = (
+    torch.ops.aten.select_copy.int,
+    ops.edge.aten.select_copy.int,
+)
+# These ops keep the order of the elements whenever they do not change the
+# number of elements.
+_NUMEL_PRESERVING_OPS = (
+    torch.ops.aten.expand_copy.default,
+    ops.edge.aten.expand_copy.default,
+    torch.ops.aten.slice_copy.Tensor,
+    ops.edge.aten.slice_copy.Tensor,
+)
+_EDGE_OPS = (
+    ops.edge.aten.permute_copy.default,
+    ops.edge.aten.transpose_copy.int,
+    ops.edge.aten.select_copy.int,
+    ops.edge.aten.expand_copy.default,
+    ops.edge.aten.slice_copy.Tensor,
+)
+
+
+def _static_contiguous_val(node: torch.fx.Node) -> Optional[torch.Tensor]:
+    val = node.meta.get("val", None)
+    if not isinstance(val, torch.Tensor):
+        return None
+    if not all(isinstance(s, int) for s in val.shape):
+        return None
+    if not val.is_contiguous():
+        return None
+    return val
+
+
+def _is_identity_permutation(shape: torch.Size, dims: List[int]) -> bool:
+    """
+    Returns true if permuting `shape` by `dims` only moves dims of size 1, so
+    that the elements stay in the same order in memory.
+    """
+    rank = len(shape)
+    if rank == 0:
+        return True
+    moved = [d % rank for d in dims if shape[d % rank] != 1]
+    return moved == sorted(moved)
+
+
+def _preserves_layout(node: torch.fx.Node) -> bool:
+    if node.op != "call_function" or node.target not in (
+        _PERMUTE_OPS + _TRANSPOSE_OPS + _SELECT_OPS + _NUMEL_PRESERVING_OPS
+    ):
+        return False
+    if not isinstance(node.args[0], torch.fx.Node):
+        return False
+    in_val = _static_contiguous_val(node.args[0])
+    out_val = _static_contiguous_val(node)
+    if in_val is None or out_val is None:
+        return False
+    if in_val.dtype != out_val.dtype or in_val.numel() != out_val.numel():
+        return False
+
+    if node.target in _PERMUTE_OPS:
+        return _is_identity_permutation(in_val.shape, list(node.args[1]))
+    if node.target in _TRANSPOSE_OPS:
+        rank = in_val.dim()
+        dims = list(range(rank))
+        if rank > 0:
+            dim0, dim1 = node.args[1] % rank, node.args[2] % rank
+            dims[dim0], dims[dim1] = dims[dim1], dims[dim0]
+        return _is_identity_permutation(in_val.shape, dims)
+    if node.target in _SELECT_OPS:
+        # Selecting from a dim of size 1 removes it without moving any data.
+        rank = in_val.dim()
+        return rank > 0 and in_val.shape[node.args[1] % rank] == 1
+    return node.target in _NUMEL_PRESERVING_OPS
+
+
+class ReplaceLayoutPreservingCopyWithViewCopyPass(PassBase):
+    """
+    Replaces permute_copy, transpose_copy, select_copy, expand_copy and
+    slice_copy nodes that do not move any data with view_copy nodes.
+
+    For example, permuting a tensor of shape [1, 8, 64] with dims [1, 0, 2]
+    only changes its shape. Once they are view_copy nodes,
+    ReplaceViewCopyWithViewPass turns these copies into views that share the
+    storage of their input during memory planning, so they cost nothing at
+    runtime.
+
+    Only tensors with static shapes and contiguous dim order are considered.
+    """
+
+    def call(self, graph_module: torch.fx.GraphModule) -> PassResult:
+        n_replaced = 0
+        for module in graph_module.modules():
+            if not isinstance(module, torch.fx.GraphModule):
+                continue
+            for node in module.graph.nodes:
+                if not _preserves_layout(node):
+                    continue
+                view_copy = (
+                    ops.edge.aten.view_copy.default
+                    if node.target in _EDGE_OPS
+                    else torch.ops.aten.view_copy.default
+                )
+                node.target = view_copy
+                node.args = (node.args[0], list(node.meta["val"].shape))
+                node.kwargs = {}
+                n_replaced += 1
+
+            module.recompile()
+
+        logger.debug(f"Replaced {n_replaced} copy nodes with view_copy nodes.")
+        return PassResult(graph_module, n_replaced > 0)
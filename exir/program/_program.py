@@ -28,6 +28,7 @@ from executorch.exir.pass_manager import PassType
 from executorch.exir.passes import (
     base_post_op_replace_passes,
     base_pre_op_replace_passes,
+    CloneDelegateLoopInputsPass,
     dead_code_elimination_pass,
     EdgeToBackendOpsPass,
     MemoryFormatOpsPass,
@@ -43,6 +44,9 @@ from executorch.exir.passes.normalize_view_copy_base_pass import (
 from executorch.exir.passes.remove_graph_asserts_pass import RemoveGraphAssertsPass
 from executorch.exir.passes.remove_mixed_type_operators import RemoveMixedTypeOperators
 from executorch.exir.passes.replace_aten_with_edge_pass import aten_to_edge
+from executorch.exir.passes.replace_layout_preserving_copy_pass import (
+    ReplaceLayoutPreservingCopyWithViewCopyPass,
+)
 from executorch.exir.passes.replace_view_copy_with_view_pass import (
     ReplaceViewCopyWithViewPass,
 )
@@ -681,17 +685,21 @@ def pre_memory_planning_passes(
         raise RuntimeError(
             f"sym_shape_eval_pass must be a dict or a PassBase, got {config.sym_shape_eval_pass}"
         )
+    reorder_passes = [config.reorder_pass] if config.reorder_pass else []
     if config.remove_view_copy:
         return [
+            ReplaceLayoutPreservingCopyWithViewCopyPass(),
             NormalizeViewCopyBasePass(),
             dead_code_elimination_pass,
             ReplaceViewCopyWithViewPass(),
             sym_shape_eval_pass,
+            *reorder_passes,
             config.to_out_var_pass,
         ]
     else:
         return [
             sym_shape_eval_pass,
+            *reorder_passes,
             config.to_out_var_pass,
         ]
 
@@ -705,6 +713,7 @@ def edge_to_executorch_passes(
     """
     passes: List[PassType] = [
         *config.passes,
+        CloneDelegateLoopInputsPass(),
         SpecPropPass(),
         # ExecuTorch backend ops are unable to handle unbacked symints. So after
         # this pass, passes cannot be Interpreter-based, because it will fail if
@@ -1451,6 +1460,9 @@ class ExecutorchProgramManager:
             segment_alignment=backend_config.segment_alignment,
             constant_tensor_alignment=backend_config.constant_tensor_alignment,
             delegate_alignment=backend_config.delegate_alignment,
+            compress_constant_segment=backend_config.compress_constant_segment,
+            order_constants_by_first_use=backend_config.order_constants_by_first_use,
+            constant_page_alignment=backend_config.constant_page_alignment,
         )
         self._buffer: Optional[bytes] = None
 
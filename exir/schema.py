@@ -6,7 +6,7 @@
 
 # pyre-strict
 
-from dataclasses import dataclass
+from dataclasses import dataclass, field
 from enum import IntEnum
 from typing import List, Optional, Union
 
@@ -179,10 +179,19 @@ class KernelCall:
     args: List[int]
 
 
+@dataclass
+class DelegateLoop:
+    num_inputs: int
+    num_carried: int
+    max_iterations: int
+    predicate_output: int = -1
+
+
 @dataclass
 class DelegateCall:
     delegate_index: int
     args: List[int]
+    loop: Optional[DelegateLoop] = None
 
 
 @dataclass
@@ -245,6 +254,9 @@ class BackendDelegate:
     id: str
     processed: BackendDelegateDataReference
     compile_specs: List[CompileSpec]
+    # Indices into ExecutionPlan.delegates of other lowerings of the same
+    # subgraph, in order of preference.
+    alternatives: List[int] = field(default_factory=list)
 
 
 @dataclass
@@ -261,6 +273,15 @@ class Operator:
     overload: str
 
 
+@dataclass
+class KernelResolution:
+    # Fingerprint of the kernel registry that kernel_indices refer to.
+    registry_fingerprint: int
+    # For each operator of the plan, the index of its kernel in the registry, or
+    # -1 to look the kernel up by name at runtime.
+    kernel_indices: List[int]
+
+
 @dataclass
 class ExecutionPlan:
     name: str
@@ -276,12 +297,20 @@ class ExecutionPlan:
     # Runtime should use the len(constant_buffer) as the ground truch of
     # constant memory buffer size, and ignore non_const_buffer_sizes[0].
     non_const_buffer_sizes: List[int]
+    kernel_resolution: Optional[KernelResolution] = None
+
+
+class SegmentCompression(IntEnum):
+    NONE = 0
+    LZ4_CHUNKED = 1
 
 
 @dataclass
 class DataSegment:
     offset: int
     size: int
+    compression: SegmentCompression = SegmentCompression.NONE
+    uncompressed_size: int = 0
 
 
 @dataclass
@@ -290,6 +319,12 @@ class SubsegmentOffsets:
     offsets: List[int]
 
 
+@dataclass
+class NamedData:
+    key: str
+    data: BackendDelegateDataReference
+
+
 @dataclass
 class Program:
     version: int
@@ -299,3 +334,4 @@ class Program:
     segments: List[DataSegment]
     constant_segment: SubsegmentOffsets
     mutable_data_segments: Optional[List[SubsegmentOffsets]] = None
+    named_data: Optional[List[NamedData]] = None
@@ -0,0 +1,85 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import unittest
+
+import torch
+from executorch.exir import to_edge
+from executorch.exir.dialects._ops import ops as exir_ops
+from executorch.exir.passes.fuse_pointwise_ops_pass import FusePointwiseOpsPass
+from torch.export import export
+from torch.testing import FileCheck
+
+
+def _count_fused(graph_module: torch.fx.GraphModule) -> int:
+    return sum(
+        1
+        for node in graph_module.graph.nodes
+        if node.target == exir_ops.edge.fused_ops.pointwise.default
+    )
+
+
+class TestFusePointwiseOpsPass(unittest.TestCase):
+    def _fuse(self, module: torch.nn.Module, inputs: tuple) -> torch.fx.GraphModule:
+        edge = to_edge(export(module, inputs))
+        edge = edge.transform([FusePointwiseOpsPass()])
+        return edge.exported_program().graph_module
+
+    def test_fuses_chain(self) -> None:
+        class M(torch.nn.Module):
+            def forward(self, x, y):
+                return torch.sigmoid((x + 2 * y) * x - 0.5).tanh()
+
+        inputs = (torch.randn(3, 17), torch.randn(3, 17))
+        gm = self._fuse(M(), inputs)
+        self.assertEqual(_count_fused(gm), 1)
+        FileCheck().check_not("aten_mul").check_not("aten_sigmoid").run(gm.code)
+        torch.testing.assert_close(gm(*inputs)[0], M()(*inputs))
+
+    def test_keeps_intermediate_with_external_user(self) -> None:
+        class M(torch.nn.Module):
+            def forward(self, x):
+                a = torch.exp(x)
+                return torch.relu(-a) + 1, a
+
+        inputs = (torch.randn(8),)
+        gm = self._fuse(M(), inputs)
+        # exp's result is a graph output, so only neg -> relu -> add is fused.
+        self.assertEqual(_count_fused(gm), 1)
+        FileCheck().check("aten_exp").run(gm.code)
+        outputs = gm(*inputs)
+        expected = M()(*inputs)
+        torch.testing.assert_close(outputs[0], expected[0])
+        torch.testing.assert_close(outputs[1], expected[1])
+
+    def test_skips_broadcast_and_integer(self) -> None:
+        class Broadcast(torch.nn.Module):
+            def forward(self, x, y):
+                return torch.exp(x + y)
+
+        gm = self._fuse(Broadcast(), (torch.randn(4, 5), torch.randn(5)))
+        self.assertEqual(_count_fused(gm), 0)
+
+        class Integer(torch.nn.Module):
+            def forward(self, x):
+                return (x + 1) * x
+
+        gm = self._fuse(Integer(), (torch.arange(6),))
+        self.assertEqual(_count_fused(gm), 0)
+
+    def test_to_executorch_uses_out_variant(self) -> None:
+        class M(torch.nn.Module):
+            def forward(self, x):
+                return torch.exp(x) * x
+
+        edge = to_edge(export(M(), (torch.randn(2, 3),)))
+        edge = edge.transform([FusePointwiseOpsPass()])
+        et = edge.to_executorch()
+        FileCheck().check("torch.ops.fused_ops.pointwise.out").run(
+            et.exported_program().graph_module.code
+        )
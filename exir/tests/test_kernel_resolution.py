@@ -0,0 +1,46 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+# pyre-strict
+
+import unittest
+
+from executorch.exir._serialize._program import _json_to_program, _program_to_json
+from executorch.exir.kernel_resolution import add_kernel_resolution
+from executorch.exir.schema import KernelResolution, Operator
+from executorch.exir.tests.common import get_test_program
+
+
+class TestKernelResolution(unittest.TestCase):
+    def test_add_kernel_resolution(self) -> None:
+        program = get_test_program()
+        program.execution_plan[0].operators.append(
+            Operator(name="aten::mul", overload="")
+        )
+
+        add_kernel_resolution(
+            program, registry_fingerprint=1234, kernel_indices={"aten::add.Tensor": 7}
+        )
+
+        # Operators without a known kernel are left for name-based lookup.
+        self.assertEqual(
+            program.execution_plan[0].kernel_resolution,
+            KernelResolution(registry_fingerprint=1234, kernel_indices=[7, -1]),
+        )
+
+    def test_kernel_resolution_round_trip(self) -> None:
+        program = add_kernel_resolution(
+            get_test_program(),
+            registry_fingerprint=2**64 - 1,
+            kernel_indices={"aten::add.Tensor": 3},
+        )
+        round_tripped = _json_to_program(_program_to_json(program).encode())
+        self.assertEqual(round_tripped, program)
+
+    def test_kernel_resolution_is_optional(self) -> None:
+        program = get_test_program()
+        round_tripped = _json_to_program(_program_to_json(program).encode())
+        self.assertIsNone(round_tripped.execution_plan[0].kernel_resolution)
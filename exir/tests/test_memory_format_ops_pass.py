@@ -22,6 +22,7 @@ from executorch.exir.dim_order_utils import (
     is_contiguous_dim_order,
 )
 from executorch.exir.pass_base import ExportPass, ProxyValue
+from executorch.exir.passes import PropagateChannelsLastPass
 
 from executorch.exir.tests.test_memory_format_ops_pass_utils import (
     MemoryFormatOpsPassTestUtils,
@@ -297,6 +298,48 @@ class TestMemoryFormatOpsPass(unittest.TestCase):
         self.assertTrue(is_contiguous_dim_order(actual))
         self.assertTrue(is_contiguous_dim_order(expected))
 
+    def test_propagate_channels_last(self) -> None:
+        class ConvPoolAddModule(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.conv1 = torch.nn.Conv2d(3, 8, 3, padding=1)
+                self.conv2 = torch.nn.Conv2d(8, 8, 3, padding=1)
+
+            def forward(self, x: torch.Tensor) -> torch.Tensor:
+                x = self.conv1(x.to(memory_format=torch.channels_last))
+                # Round trip through the contiguous dim order, as the ops
+                # between the convs would run with the default dim order.
+                y = x.to(memory_format=torch.contiguous_format)
+                y = torch.nn.functional.avg_pool2d(y, 2)
+                y = torch.relu(y) + y
+                y = y.to(memory_format=torch.channels_last)
+                return self.conv2(y)
+
+        sample_input = (torch.randn(1, 3, 8, 8),)
+        _to_dim_order_op_str = "executorch_exir_dialects_edge__ops_dim_order_ops__to_dim_order_copy_default"
+
+        before_epm = to_edge(
+            export(ConvPoolAddModule().eval(), sample_input),
+            compile_config=EdgeCompileConfig(_skip_dim_order=False),
+        )
+        before_count = before_epm.exported_program().graph_module.code.count(
+            _to_dim_order_op_str
+        )
+
+        updated_epm = before_epm.transform([PropagateChannelsLastPass()])
+
+        # The round trip between the convs is gone; the pool, relu and add run
+        # in the channels last dim order.
+        FileCheck().check_count(
+            _to_dim_order_op_str, before_count - 2, exactly=True
+        ).run(updated_epm.exported_program().graph_module.code)
+
+        expected = before_epm.exported_program().module()(*sample_input)
+        et_program = updated_epm.to_executorch()
+        executorch_module = _load_for_executorch_from_buffer(et_program.buffer)
+        actual = executorch_module.run_method("forward", sample_input)[0]
+        self.assertTrue(torch.allclose(actual, expected, atol=1e-4, rtol=1e-4))
+
     def test_resnet18(self) -> None:
         model = torchvision.models.resnet18()
         MemoryFormatOpsPassTestUtils.memory_format_test_runner(
@@ -6,6 +6,7 @@
 
 # pyre-strict
 
+import functools
 import itertools
 import unittest
 from typing import Any, Callable, List, Optional, Tuple, Type
@@ -19,7 +20,11 @@ from executorch.exir.memory_planning import (
     filter_nodes,
     get_node_tensor_specs,
     greedy,
+    greedy_by_size,
+    memory_lower_bound,
+    MemoryTier,
     naive,
+    tiered,
     Verifier,
 )
 from executorch.exir.pass_base import ExportPass, PassResult
@@ -30,6 +35,7 @@ from executorch.exir.passes import (  # noqa
     ToOutVarPass,
 )
 from executorch.exir.passes.sym_shape_eval_pass import ConstraintBasedSymShapeEvalPass
+from executorch.exir.tensor import TensorSpec
 from parameterized import parameterized
 
 from torch import nn
@@ -228,6 +234,7 @@ def maketest(
                 (naive, False),
                 # greedy algorithm should reuse tensor storages in the testing model
                 (greedy, True),
+                (greedy_by_size, True),
             ]
 
         for algo, expect_reuse in criteria:
@@ -405,6 +412,37 @@ class TestVerifier(unittest.TestCase):
         self.assertFalse(Verifier.has_overlap([5, 6], [1, 2]))
 
 
+class TestLowerBound(unittest.TestCase):
+    @staticmethod
+    def make_spec(numel: int, lifetime: List[int]) -> TensorSpec:
+        spec = TensorSpec(torch.float32, torch.Size([numel]))
+        spec.realign(1)
+        spec.lifetime = lifetime
+        return spec
+
+    def test_memory_lower_bound(self) -> None:
+        self.assertEqual(memory_lower_bound([]), 0)
+        # Tensors alive at different times only need the largest of them.
+        self.assertEqual(
+            memory_lower_bound(
+                [self.make_spec(4, [0, 1]), self.make_spec(2, [2, 3])]
+            ),
+            16,
+        )
+        # Lifetimes are inclusive, so tensors that share an endpoint are
+        # alive at the same time.
+        self.assertEqual(
+            memory_lower_bound(
+                [
+                    self.make_spec(4, [0, 1]),
+                    self.make_spec(2, [1, 3]),
+                    self.make_spec(1, [3, 4]),
+                ]
+            ),
+            24,
+        )
+
+
 class TestMisc(unittest.TestCase):
     def test_filter_nodes(self) -> None:
         g = Graph()
@@ -482,6 +520,11 @@ class TestMisc(unittest.TestCase):
                 [(1, 0), (3, 0), (1, 4), (3, 4), (1, 0)],
                 [0, 8, 0, 8],
             ),
+            (
+                greedy_by_size,
+                [(1, 0), (3, 0), (1, 4), (3, 4), (1, 0)],
+                [0, 8, 0, 8],
+            ),
         ]
     )
     def test_multiple_pools(
@@ -527,6 +570,53 @@ class TestMisc(unittest.TestCase):
                 idx += 1
         self.assertEqual(graph_module.meta["non_const_buffer_sizes"], expected_bufsizes)
 
+    def test_tiered(self) -> None:
+        fast_capacity = 96
+        edge_program = to_edge(
+            export(
+                ToyModelForMemPlanning(),
+                ToyModelForMemPlanning().get_random_inputs(),
+            )
+        )
+        edge_program.to_executorch(
+            exir.ExecutorchBackendConfig(
+                memory_planning_pass=MemoryPlanningPass(
+                    memory_planning_algo=functools.partial(
+                        tiered,
+                        tiers=[
+                            MemoryTier(mem_id=1, capacity=fast_capacity),
+                            MemoryTier(mem_id=2),
+                        ],
+                    ),
+                ),
+            )
+        )
+        graph_module = edge_program.exported_program().graph_module
+
+        verifier = Verifier(
+            graph_module,
+            alloc_graph_input=True,
+            alloc_graph_output=True,
+        )
+        verifier.verify_storage_reuse()
+        verifier.verify_graph_input_output()
+
+        mem_ids = set()
+        for node in graph_module.graph.nodes:
+            spec = node.meta.get("spec", None)
+            if not isinstance(spec, TensorSpec) or spec.mem_id is None:
+                continue
+            mem_ids.add(spec.mem_id)
+            if spec.mem_id == 1:
+                self.assertLessEqual(
+                    spec.mem_offset + spec.allocated_memory, fast_capacity
+                )
+        # The fast tier is too small for all the tensors alive at once.
+        self.assertEqual(mem_ids, {1, 2})
+        self.assertLessEqual(
+            graph_module.meta["non_const_buffer_sizes"][1], fast_capacity
+        )
+
     def test_constants_not_memory_planned(self) -> None:
         class Simple(torch.nn.Module):
             def __init__(self) -> None:
@@ -656,3 +746,39 @@ class TestMisc(unittest.TestCase):
                     self.assertIsNone(node.meta["spec"].mem_offset)
                     self.assertIsNone(node.meta["spec"].mem_id)
         self.assertEqual(constants, 2)
+
+    def test_alias_inplace_outputs(self) -> None:
+        class Chain(torch.nn.Module):
+            def forward(self, x, y):
+                a = x * y
+                b = torch.relu(a + y)
+                return torch.sigmoid(b)
+
+        def planned_offsets(alias_inplace_outputs: bool) -> List[Optional[int]]:
+            edge = to_edge(export(Chain(), (torch.randn(4, 8), torch.randn(4, 8))))
+            et = edge.to_executorch(
+                config=ExecutorchBackendConfig(
+                    memory_planning_pass=MemoryPlanningPass(
+                        alias_inplace_outputs=alias_inplace_outputs
+                    )
+                )
+            )
+            offsets = []
+            for node in et.exported_program().graph_module.graph.nodes:
+                if node.op == "call_function" and node.target in (
+                    torch.ops.aten.mul.out,
+                    torch.ops.aten.add.out,
+                    torch.ops.aten.relu.out,
+                ):
+                    offsets.append(node.meta["spec"].mem_offset)
+            return offsets
+
+        # mul, add and relu each die at the op that consumes them, so they
+        # can all share one buffer.
+        offsets = planned_offsets(alias_inplace_outputs=True)
+        self.assertEqual(len(offsets), 3)
+        self.assertEqual(len(set(offsets)), 1)
+
+        offsets = planned_offsets(alias_inplace_outputs=False)
+        self.assertEqual(len(offsets), 3)
+        self.assertGreater(len(set(offsets)), 1)
@@ -38,6 +38,7 @@ from executorch.exir.passes.debug_handle_generator_pass import (
     generate_missing_debug_handles,
 )
 from executorch.exir.passes.insert_write_back_for_buffers_pass import (
+    _insert_copy,
     insert_write_back_for_buffers_pass,
 )
 
@@ -48,6 +49,9 @@ from executorch.exir.passes.normalize_view_copy_base_pass import (
 from executorch.exir.passes.remove_graph_asserts_pass import RemoveGraphAssertsPass
 from executorch.exir.passes.remove_mixed_type_operators import RemoveMixedTypeOperators
 from executorch.exir.passes.replace_edge_with_backend_pass import EdgeToBackendOpsPass
+from executorch.exir.passes.replace_layout_preserving_copy_pass import (
+    ReplaceLayoutPreservingCopyWithViewCopyPass,
+)
 from executorch.exir.passes.replace_view_copy_with_view_pass import (
     ReplaceViewCopyWithViewPass,
 )
@@ -1297,6 +1301,57 @@ class TestPasses(unittest.TestCase):
         self.assertIn("a", new_ep.state_dict)
         self.assertEqual(count_placeholder(new_ep.graph_module), 3)
 
+    def test_constant_prop_pass_moves_transpose_before_dequantize(self) -> None:
+        dq_per_channel = exir_ops.edge.quantized_decomposed.dequantize_per_channel.default
+
+        class M(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.register_buffer(
+                    "weight", torch.randint(-128, 127, (6, 4), dtype=torch.int8)
+                )
+                self.register_buffer("scales", torch.rand(6) + 0.1)
+                self.register_buffer("zero_points", torch.zeros(6, dtype=torch.long))
+
+            def forward(self, x):
+                weight = torch.ops.quantized_decomposed.dequantize_per_channel(
+                    self.weight, self.scales, self.zero_points, 0, -128, 127, torch.int8
+                )
+                return torch.mm(x, weight.t())
+
+        x = torch.randn(2, 4)
+        edge = to_edge(export(M(), (x,)))
+        expected = edge.exported_program().module()(x)
+
+        # Keep the weight quantized, but transpose it at export time.
+        new_ep = constant_prop_pass(
+            edge.exported_program(), custom_skip_targets={dq_per_channel}
+        )
+        targets = [node.target for node in new_ep.graph.nodes]
+        self.assertEqual(targets.count(dq_per_channel), 1)
+        self.assertNotIn(exir_ops.edge.aten.permute_copy.default, targets)
+        self.assertNotIn(exir_ops.edge.aten.t_copy.default, targets)
+        dq = next(node for node in new_ep.graph.nodes if node.target == dq_per_channel)
+        # The quantization axis moved with the output channels.
+        self.assertEqual(dq.args[3], 1)
+        self.assertTrue(torch.allclose(new_ep.module()(x), expected))
+
+    def test_constant_prop_pass_skips_mutated_buffer(self) -> None:
+        class M(torch.nn.Module):
+            def __init__(self):
+                super().__init__()
+                self.register_buffer("cache", torch.zeros(2, 2))
+
+            def forward(self, x):
+                self.cache.add_(1)
+                return x + self.cache * 2
+
+        aten = export(M(), (torch.zeros(2, 2),))
+        new_ep = constant_prop_pass(aten)
+        # The cache changes between runs, so `cache * 2` is not a constant.
+        self.assertNotIn("_prop_tensor_constant0", new_ep.constants)
+        self.assertIn("cache", new_ep.state_dict)
+
     def test_constant_prop_pass_for_control_flow(self) -> None:
         class Module(torch.nn.Module):
             def __init__(self):
@@ -1382,6 +1437,27 @@ class TestPasses(unittest.TestCase):
         #     return (copy__default, aten_add_tensor)
         self.assertEqual(count_copies(gm), 1)
 
+    def test_mutable_buffers_updated_in_place(self) -> None:
+        # state.add_(x) already wrote the new value into the buffer, so there
+        # is nothing to write back.
+        graph = torch.fx.Graph()
+        state = graph.placeholder("state")
+        x = graph.placeholder("x")
+        add_ = graph.call_function(torch.ops.aten.add_.Tensor, (state, x))
+        mul = graph.call_function(torch.ops.aten.mul.Tensor, (x, x))
+        graph.output((add_, mul))
+        gm = torch.fx.GraphModule(torch.nn.Module(), graph)
+
+        outputs = _insert_copy(gm, ["state", None], {"state": state})
+
+        self.assertEqual(outputs, [state, mul])
+        self.assertFalse(
+            any(node.target == torch.ops.aten.copy_.default for node in graph.nodes)
+        )
+        # The in-place update itself stays, though nothing uses its result.
+        graph.eliminate_dead_code()
+        self.assertIn(add_, graph.nodes)
+
     def test_remove_quantized_op_noop_pass(self) -> None:
         class TestAddSliceNoop(torch.nn.Module):
             def __init__(self):
@@ -1661,6 +1737,43 @@ class TestPasses(unittest.TestCase):
             gm.code
         )
 
+    def test_replace_layout_preserving_copy_with_view_copy_pass(self) -> None:
+        class TestCopies(torch.nn.Module):
+            def forward(self, x, y):
+                # Only moves the size-1 dim, so no data is moved.
+                a = torch.ops.aten.permute_copy.default(x, [1, 0, 2])
+                # Moves data, so must stay a copy.
+                b = torch.ops.aten.transpose_copy.int(y, 0, 2)
+                c = torch.ops.aten.select_copy.int(x, 0, 0)
+                return torch.ops.aten.add.Tensor(a, b), c
+
+        gm = export(
+            TestCopies(), (torch.ones(1, 8, 4), torch.ones(4, 1, 8))
+        ).graph_module
+        p = ReplaceLayoutPreservingCopyWithViewCopyPass()
+        gm_res = p(gm)
+        assert gm_res is not None
+        gm = gm_res.graph_module
+
+        FileCheck().check_count(
+            "torch.ops.aten.permute_copy.default", 0, exactly=True
+        ).run(gm.code)
+        FileCheck().check_count(
+            "torch.ops.aten.select_copy.int", 0, exactly=True
+        ).run(gm.code)
+        FileCheck().check_count(
+            "torch.ops.aten.transpose_copy.int", 1, exactly=True
+        ).run(gm.code)
+        FileCheck().check_count(
+            "torch.ops.aten.view_copy.default", 2, exactly=True
+        ).run(gm.code)
+
+        inputs = (torch.rand(1, 8, 4), torch.rand(4, 1, 8))
+        outputs = gm(*inputs)
+        expected = TestCopies()(*inputs)
+        self.assertTrue(torch.allclose(outputs[0], expected[0]))
+        self.assertTrue(torch.allclose(outputs[1], expected[1]))
+
     def test_constant_prop_pass_for_no_grad(self) -> None:
         class LSTM(torch.nn.Module):
             def __init__(self, input_size, hidden_size, num_layers):
@@ -89,6 +89,56 @@ class TensorHybrid : public facebook::jni::HybridClass<TensorHybrid> {
         cls, jTensorBuffer, jTensorShape, jdtype, makeCxxInstance(tensor));
   }
 
+  // Returns a tensor that shares the direct buffer of the Java tensor, which
+  // must outlive it.
+  static TensorPtr newTensorFromJTensor(
+      facebook::jni::alias_ref<TensorHybrid::javaobject> jtensor) {
+    static auto cls = TensorHybrid::javaClassStatic();
+    static const auto dtypeMethod = cls->getMethod<jint()>("dtypeJniCode");
+    jint jdtype = dtypeMethod(jtensor);
+
+    static const auto shapeField = cls->getField<jlongArray>("shape");
+    auto jshape = jtensor->getFieldValue(shapeField);
+
+    static auto dataBufferMethod = cls->getMethod<
+        facebook::jni::local_ref<facebook::jni::JBuffer::javaobject>()>(
+        "getRawDataBuffer");
+    facebook::jni::local_ref<facebook::jni::JBuffer> jbuffer =
+        dataBufferMethod(jtensor);
+
+    const auto rank = jshape->size();
+
+    const auto shapeArr = jshape->getRegion(0, rank);
+    std::vector<exec_aten::SizesType> shape_vec;
+    shape_vec.reserve(rank);
+
+    auto numel = 1;
+    for (int i = 0; i < rank; i++) {
+      shape_vec.push_back(shapeArr[i]);
+    }
+    for (int i = rank - 1; i >= 0; --i) {
+      numel *= shapeArr[i];
+    }
+    JNIEnv* jni = facebook::jni::Environment::current();
+    if (java_dtype_to_scalar_type.count(jdtype) == 0) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "Unknown Tensor jdtype %d",
+          jdtype);
+    }
+    ScalarType scalar_type = java_dtype_to_scalar_type.at(jdtype);
+    const auto dataCapacity = jni->GetDirectBufferCapacity(jbuffer.get());
+    if (dataCapacity != numel) {
+      facebook::jni::throwNewJavaException(
+          facebook::jni::gJavaLangIllegalArgumentException,
+          "Tensor dimensions(elements number:%d inconsistent with buffer capacity(%d)",
+          numel,
+          dataCapacity);
+    }
+    return from_blob(
+        jni->GetDirectBufferAddress(jbuffer.get()), shape_vec, scalar_type);
+  }
+
  private:
   friend HybridBase;
 };
@@ -157,52 +207,7 @@ class JEValue : public facebook::jni::JavaClass<JEValue> {
           JEValue::javaClassStatic()
               ->getMethod<facebook::jni::alias_ref<TensorHybrid::javaobject>()>(
                   "toTensor");
-      auto jtensor = jMethodGetTensor(JEValue);
-
-      static auto cls = TensorHybrid::javaClassStatic();
-      static const auto dtypeMethod = cls->getMethod<jint()>("dtypeJniCode");
-      jint jdtype = dtypeMethod(jtensor);
-
-      static const auto shapeField = cls->getField<jlongArray>("shape");
-      auto jshape = jtensor->getFieldValue(shapeField);
-
-      static auto dataBufferMethod = cls->getMethod<
-          facebook::jni::local_ref<facebook::jni::JBuffer::javaobject>()>(
-          "getRawDataBuffer");
-      facebook::jni::local_ref<facebook::jni::JBuffer> jbuffer =
-          dataBufferMethod(jtensor);
-
-      const auto rank = jshape->size();
-
-      const auto shapeArr = jshape->getRegion(0, rank);
-      std::vector<exec_aten::SizesType> shape_vec;
-      shape_vec.reserve(rank);
-
-      auto numel = 1;
-      for (int i = 0; i < rank; i++) {
-        shape_vec.push_back(shapeArr[i]);
-      }
-      for (int i = rank - 1; i >= 0; --i) {
-        numel *= shapeArr[i];
-      }
-      JNIEnv* jni = facebook::jni::Environment::current();
-      if (java_dtype_to_scalar_type.count(jdtype) == 0) {
-        facebook::jni::throwNewJavaException(
-            facebook::jni::gJavaLangIllegalArgumentException,
-            "Unknown Tensor jdtype %d",
-            jdtype);
-      }
-      ScalarType scalar_type = java_dtype_to_scalar_type.at(jdtype);
-      const auto dataCapacity = jni->GetDirectBufferCapacity(jbuffer.get());
-      if (dataCapacity != numel) {
-        facebook::jni::throwNewJavaException(
-            facebook::jni::gJavaLangIllegalArgumentException,
-            "Tensor dimensions(elements number:%d inconsistent with buffer capacity(%d)",
-            numel,
-            dataCapacity);
-      }
-      return from_blob(
-          jni->GetDirectBufferAddress(jbuffer.get()), shape_vec, scalar_type);
+      return TensorHybrid::newTensorFromJTensor(jMethodGetTensor(JEValue));
     }
     facebook::jni::throwNewJavaException(
         facebook::jni::gJavaLangIllegalArgumentException,
@@ -214,6 +219,15 @@ class JEValue : public facebook::jni::JavaClass<JEValue> {
 class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
  private:
   friend HybridBase;
+
+  // The Java tensors bound to a method, and the tensors that share their
+  // direct buffers.
+  struct BoundTensors {
+    std::vector<facebook::jni::global_ref<TensorHybrid::javaobject>> jtensors;
+    std::vector<TensorPtr> tensors;
+  };
+
+  std::unordered_map<std::string, BoundTensors> bound_tensors_;
   std::unique_ptr<Module> module_;
 
  public:
@@ -279,6 +293,47 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
     return static_cast<jint>(module_->load_method(methodName->toStdString()));
   }
 
+  jint bind(
+      facebook::jni::alias_ref<jstring> methodName,
+      facebook::jni::alias_ref<
+          facebook::jni::JArrayClass<TensorHybrid::javaobject>::javaobject>
+          jinputs,
+      facebook::jni::alias_ref<
+          facebook::jni::JArrayClass<TensorHybrid::javaobject>::javaobject>
+          joutputs) {
+    const auto method = methodName->toStdString();
+    // Binding again, even unsuccessfully, unbinds the previous tensors.
+    BoundTensors bound;
+    std::vector<EValue> inputs;
+    std::vector<EValue> outputs;
+    for (int i = 0; i < jinputs->size(); i++) {
+      bound.jtensors.push_back(
+          facebook::jni::make_global(jinputs->getElement(i)));
+      bound.tensors.push_back(
+          TensorHybrid::newTensorFromJTensor(bound.jtensors.back()));
+      inputs.emplace_back(bound.tensors.back());
+    }
+    for (int i = 0; i < joutputs->size(); i++) {
+      bound.jtensors.push_back(
+          facebook::jni::make_global(joutputs->getElement(i)));
+      bound.tensors.push_back(
+          TensorHybrid::newTensorFromJTensor(bound.jtensors.back()));
+      outputs.emplace_back(bound.tensors.back());
+    }
+    const auto error = module_->bind(method, inputs, outputs);
+    if (error == Error::Ok) {
+      bound_tensors_[method] = std::move(bound);
+    } else {
+      bound_tensors_.erase(method);
+    }
+    return static_cast<jint>(error);
+  }
+
+  jint execute_bound(facebook::jni::alias_ref<jstring> methodName) {
+    return static_cast<jint>(
+        module_->execute_bound(methodName->toStdString()));
+  }
+
   facebook::jni::local_ref<facebook::jni::JArrayClass<JEValue>> execute_method(
       std::string method,
       facebook::jni::alias_ref<
@@ -401,6 +456,8 @@ class ExecuTorchJni : public facebook::jni::HybridClass<ExecuTorchJni> {
         makeNativeMethod("forward", ExecuTorchJni::forward),
         makeNativeMethod("execute", ExecuTorchJni::execute),
         makeNativeMethod("loadMethod", ExecuTorchJni::load_method),
+        makeNativeMethod("bind", ExecuTorchJni::bind),
+        makeNativeMethod("executeBound", ExecuTorchJni::execute_bound),
         makeNativeMethod("readLogBuffer", ExecuTorchJni::readLogBuffer),
     });
   }
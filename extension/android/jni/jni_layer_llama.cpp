@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -69,8 +70,6 @@ bool utf8_check_validity(const char* str, size_t length) {
   }
   return true; // All bytes were valid
 }
-
-std::string token_buffer;
 } // namespace
 
 namespace executorch_jni {
@@ -81,34 +80,148 @@ class ExecuTorchLlamaCallbackJni
   constexpr static const char* kJavaDescriptor =
       "Lorg/pytorch/executorch/LlamaCallback;";
 
-  void onResult(std::string result) const {
+  void onResult(const std::string& result) const {
     static auto cls = ExecuTorchLlamaCallbackJni::javaClassStatic();
     static const auto method =
         cls->getMethod<void(facebook::jni::local_ref<jstring>)>("onResult");
 
-    token_buffer += result;
-    if (!utf8_check_validity(token_buffer.c_str(), token_buffer.size())) {
-      ET_LOG(
-          Info, "Current token buffer is not valid UTF-8. Waiting for more.");
-      return;
-    }
-    result = token_buffer;
-    token_buffer = "";
     facebook::jni::local_ref<jstring> s = facebook::jni::make_jstring(result);
     method(self(), s);
   }
 
-  void onStats(const llm::Stats& result) const {
+  void onResultBytes(
+      facebook::jni::alias_ref<facebook::jni::JByteBuffer> buffer,
+      size_t length) const {
     static auto cls = ExecuTorchLlamaCallbackJni::javaClassStatic();
-    static const auto method = cls->getMethod<void(jfloat)>("onStats");
+    static const auto method = cls->getMethod<void(
+        facebook::jni::alias_ref<facebook::jni::JByteBuffer>, jint)>(
+        "onResultBytes");
+
+    method(self(), buffer, static_cast<jint>(length));
+  }
+
+  void onTokenStats(
+      const llm::Stats& result,
+      const std::vector<jlong>& token_times_ms) const {
+    static auto cls = ExecuTorchLlamaCallbackJni::javaClassStatic();
+    static const auto method =
+        cls->getMethod<void(jfloat, facebook::jni::alias_ref<jlongArray>)>(
+            "onTokenStats");
     double eval_time =
         (double)(result.inference_end_ms - result.prompt_eval_end_ms);
 
     float tps = result.num_generated_tokens / eval_time *
         result.SCALING_FACTOR_UNITS_PER_SECOND;
 
-    method(self(), tps);
+    facebook::jni::local_ref<jlongArray> times =
+        facebook::jni::make_long_array(token_times_ms.size());
+    times->setRegion(0, token_times_ms.size(), token_times_ms.data());
+    method(self(), tps, times);
+  }
+};
+
+// How the text of generated tokens is passed to the Java callback.
+struct ResultCoalescing {
+  // Pass the text once this many tokens are pending.
+  int max_tokens = 1;
+  // Also pass the text once the oldest pending token is this old, if positive.
+  int max_delay_ms = 0;
+  // Pass the text as UTF-8 in a reused direct ByteBuffer, instead of as a new
+  // String each time.
+  bool use_byte_buffer = false;
+};
+
+// A direct ByteBuffer over native memory, reused for the results of every
+// generation so that passing them to Java allocates nothing.
+class ResultBuffer final {
+ public:
+  // Copies `text` into the buffer, growing it if needed, and returns it.
+  facebook::jni::alias_ref<facebook::jni::JByteBuffer> fill(
+      const std::string& text) {
+    if (!buffer_ || text.size() > storage_.size()) {
+      storage_.resize(std::max(text.size(), 2 * storage_.size()));
+      buffer_ = facebook::jni::make_global(
+          facebook::jni::JByteBuffer::wrapBytes(
+              storage_.data(), storage_.size()));
+    }
+    std::copy(text.begin(), text.end(), storage_.begin());
+    return buffer_;
+  }
+
+ private:
+  std::vector<uint8_t> storage_;
+  facebook::jni::global_ref<facebook::jni::JByteBuffer> buffer_;
+};
+
+// Collects the tokens of one generation and passes their text to the Java
+// callback in batches, as configured by ResultCoalescing, to limit the JNI
+// calls per token. Text is only passed once it is valid UTF-8, since a token
+// may end in the middle of a character. Also records when each token was
+// generated, and reports it along with the stats in a single call.
+class ResultCoalescer final {
+ public:
+  ResultCoalescer(
+      facebook::jni::alias_ref<ExecuTorchLlamaCallbackJni> callback,
+      const ResultCoalescing& config,
+      ResultBuffer& buffer)
+      : callback_(callback),
+        config_(config),
+        buffer_(buffer),
+        start_(std::chrono::steady_clock::now()) {}
+
+  void on_token(const std::string& token) {
+    const auto now = std::chrono::steady_clock::now();
+    token_times_ms_.push_back(
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - start_)
+            .count());
+    if (pending_tokens_ == 0) {
+      pending_start_ = now;
+    }
+    pending_ += token;
+    ++pending_tokens_;
+
+    const bool timed_out = config_.max_delay_ms > 0 &&
+        now - pending_start_ >=
+            std::chrono::milliseconds(config_.max_delay_ms);
+    if (pending_tokens_ >= config_.max_tokens || timed_out) {
+      flush();
+    }
   }
+
+  void on_stats(const llm::Stats& stats) {
+    flush();
+    callback_->onTokenStats(stats, token_times_ms_);
+  }
+
+  // Passes the pending text to the callback, if it is valid UTF-8.
+  void flush() {
+    if (pending_.empty()) {
+      return;
+    }
+    if (!utf8_check_validity(pending_.c_str(), pending_.size())) {
+      ET_LOG(
+          Info, "Current token buffer is not valid UTF-8. Waiting for more.");
+      return;
+    }
+    if (config_.use_byte_buffer) {
+      callback_->onResultBytes(buffer_.fill(pending_), pending_.size());
+    } else {
+      callback_->onResult(pending_);
+    }
+    pending_.clear();
+    pending_tokens_ = 0;
+  }
+
+ private:
+  facebook::jni::alias_ref<ExecuTorchLlamaCallbackJni> callback_;
+  const ResultCoalescing& config_;
+  ResultBuffer& buffer_;
+  const std::chrono::steady_clock::time_point start_;
+  std::chrono::steady_clock::time_point pending_start_;
+  std::string pending_;
+  int pending_tokens_ = 0;
+  // Milliseconds from the start of the generation to each token.
+  std::vector<jlong> token_times_ms_;
 };
 
 class ExecuTorchLlamaJni
@@ -118,6 +231,8 @@ class ExecuTorchLlamaJni
   int model_type_category_;
   std::unique_ptr<llm::IRunner> runner_;
   std::unique_ptr<llm::MultimodalRunner> multi_modal_runner_;
+  ResultCoalescing result_coalescing_;
+  ResultBuffer result_buffer_;
 
  public:
   constexpr static auto kJavaDescriptor =
@@ -185,6 +300,7 @@ class ExecuTorchLlamaJni
       jint seq_len,
       facebook::jni::alias_ref<ExecuTorchLlamaCallbackJni> callback,
       jboolean echo) {
+    ResultCoalescer coalescer(callback, result_coalescing_, result_buffer_);
     if (model_type_category_ == MODEL_TYPE_CATEGORY_MULTIMODAL) {
       auto image_size = image->size();
       std::vector<llm::Image> images;
@@ -202,17 +318,18 @@ class ExecuTorchLlamaJni
           std::move(images),
           prompt->toStdString(),
           seq_len,
-          [callback](std::string result) { callback->onResult(result); },
-          [callback](const llm::Stats& result) { callback->onStats(result); },
+          [&](const std::string& result) { coalescer.on_token(result); },
+          [&](const llm::Stats& result) { coalescer.on_stats(result); },
           echo);
     } else if (model_type_category_ == MODEL_TYPE_CATEGORY_LLM) {
       runner_->generate(
           prompt->toStdString(),
           seq_len,
-          [callback](std::string result) { callback->onResult(result); },
-          [callback](const llm::Stats& result) { callback->onStats(result); },
+          [&](const std::string& result) { coalescer.on_token(result); },
+          [&](const llm::Stats& result) { coalescer.on_stats(result); },
           echo);
     }
+    coalescer.flush();
     return 0;
   }
 
@@ -287,13 +404,25 @@ class ExecuTorchLlamaJni
     if (model_type_category_ != MODEL_TYPE_CATEGORY_MULTIMODAL) {
       return static_cast<jint>(Error::NotSupported);
     }
-    return static_cast<jint>(multi_modal_runner_->generate_from_pos(
+    ResultCoalescer coalescer(callback, result_coalescing_, result_buffer_);
+    const auto error = multi_modal_runner_->generate_from_pos(
         prompt->toStdString(),
         seq_len,
         start_pos,
-        [callback](const std::string& result) { callback->onResult(result); },
-        [callback](const llm::Stats& stats) { callback->onStats(stats); },
-        echo));
+        [&](const std::string& result) { coalescer.on_token(result); },
+        [&](const llm::Stats& stats) { coalescer.on_stats(stats); },
+        echo);
+    coalescer.flush();
+    return static_cast<jint>(error);
+  }
+
+  void set_result_coalescing(
+      jint max_tokens,
+      jint max_delay_ms,
+      jboolean use_byte_buffer) {
+    result_coalescing_.max_tokens = std::max<jint>(max_tokens, 1);
+    result_coalescing_.max_delay_ms = std::max<jint>(max_delay_ms, 0);
+    result_coalescing_.use_byte_buffer = use_byte_buffer;
   }
 
   void stop() {
@@ -325,6 +454,8 @@ class ExecuTorchLlamaJni
             "prefillPromptNative", ExecuTorchLlamaJni::prefill_prompt),
         makeNativeMethod(
             "generateFromPos", ExecuTorchLlamaJni::generate_from_pos),
+        makeNativeMethod(
+            "setResultCoalescing", ExecuTorchLlamaJni::set_result_coalescing),
     });
   }
 };
@@ -9,6 +9,8 @@
 package org.pytorch.executorch;
 
 import com.facebook.jni.annotations.DoNotStrip;
+import java.nio.ByteBuffer;
+import java.nio.charset.StandardCharsets;
 import org.pytorch.executorch.annotations.Experimental;
 
 /**
@@ -23,11 +25,30 @@ public interface LlamaCallback {
    * Called when a new result is available from JNI. Users will keep getting onResult() invocations
    * until generate() finishes.
    *
-   * @param result Last generated token
+   * @param result Last generated tokens. See {@link LlamaModule#setResultCoalescing} for how many.
    */
   @DoNotStrip
   public void onResult(String result);
 
+  /**
+   * Called instead of onResult() when byte buffer results are enabled with {@link
+   * LlamaModule#setResultCoalescing}. The default implementation decodes the text and passes it to
+   * onResult().
+   *
+   * @param utf8 Buffer that holds the UTF-8 encoded text of the last generated tokens at indices 0
+   *     to length - 1. The buffer is reused for the next result, so it is only valid during this
+   *     call. Read it with absolute get() calls, which leave its position unchanged.
+   * @param length Number of bytes of text in the buffer.
+   */
+  @DoNotStrip
+  public default void onResultBytes(ByteBuffer utf8, int length) {
+    byte[] bytes = new byte[length];
+    for (int i = 0; i < length; i++) {
+      bytes[i] = utf8.get(i);
+    }
+    onResult(new String(bytes, StandardCharsets.UTF_8));
+  }
+
   /**
    * Called when the statistics for the generate() is available.
    *
@@ -35,4 +56,17 @@ public interface LlamaCallback {
    */
   @DoNotStrip
   public void onStats(float tps);
+
+  /**
+   * Called once when the statistics for the generate() is available, with the time at which each
+   * token was generated. The timings are collected natively, so they cost no extra JNI calls. The
+   * default implementation calls onStats().
+   *
+   * @param tps Tokens/second for generated tokens.
+   * @param tokenTimesMs Milliseconds from the start of generate() to each generated token.
+   */
+  @DoNotStrip
+  public default void onTokenStats(float tps, long[] tokenTimesMs) {
+    onStats(tps);
+  }
 }
@@ -180,6 +180,22 @@ public class LlamaModule {
   public native int generateFromPos(
       String prompt, int seqLen, long startPos, LlamaCallback callback, boolean echo);
 
+  /**
+   * Configures how the text of generated tokens is passed to {@link LlamaCallback}. By default,
+   * onResult() is called with a new String for every token. At high token rates, the JNI calls and
+   * allocations of those callbacks add up, so they can instead be batched and passed without
+   * allocating. Text is always passed in whole UTF-8 characters, and any text that is still pending
+   * is passed before onStats() and when generation ends.
+   *
+   * @param maxTokens Pass the text once this many tokens are pending.
+   * @param maxDelayMs Also pass the text when a token is generated and the oldest pending token is
+   *     at least this old, or 0 to only pass it every maxTokens tokens.
+   * @param useByteBuffer Pass the text to {@link LlamaCallback#onResultBytes} in a reused direct
+   *     ByteBuffer instead of to onResult() as a new String.
+   */
+  @DoNotStrip
+  public native void setResultCoalescing(int maxTokens, int maxDelayMs, boolean useByteBuffer);
+
   /** Stop current generate() before it finishes. */
   @DoNotStrip
   public native void stop();
@@ -99,6 +99,52 @@ public class Module {
     return mNativePeer.loadMethod(methodName);
   }
 
+  /**
+   * Binds tensors to all inputs and outputs of a method, so that it can be run repeatedly with
+   * {@link #executeBound(String)} without allocating any Java objects. Allocate the tensors once
+   * with direct buffers, e.g. from {@link Tensor#allocateFloatBuffer(int)}, write new input data
+   * into their buffers before each execution, and read the results from the buffers of the output
+   * tensors after it.
+   *
+   * <p>The native side shares the tensors' buffers: outputs that are not memory-planned are written
+   * to them directly, and the others are copied into them. The module keeps the tensors alive until
+   * they are bound again or the module is destroyed. Each output tensor must be large enough for
+   * the method's output, and the shapes of the Java tensors are not updated if the output shapes
+   * are dynamic.
+   *
+   * @param methodName name of the ExecuTorch method to bind the tensors to.
+   * @param inputs one tensor for each input of the method.
+   * @param outputs one tensor for each output of the method.
+   * @return the Error code if there was an error binding the tensors, 0 otherwise.
+   */
+  public int bind(String methodName, Tensor[] inputs, Tensor[] outputs) {
+    return mNativePeer.bind(methodName, inputs, outputs);
+  }
+
+  /**
+   * Binds tensors to all inputs and outputs of the 'forward' method. See {@link #bind(String,
+   * Tensor[], Tensor[])}.
+   */
+  public int bindForward(Tensor[] inputs, Tensor[] outputs) {
+    return bind("forward", inputs, outputs);
+  }
+
+  /**
+   * Runs the specified method on the tensors bound to it with {@link #bind(String, Tensor[],
+   * Tensor[])}, writing its results to the bound output tensors.
+   *
+   * @param methodName name of the ExecuTorch method to run.
+   * @return the Error code if there was an error executing the method, 0 otherwise.
+   */
+  public int executeBound(String methodName) {
+    return mNativePeer.executeBound(methodName);
+  }
+
+  /** Runs the 'forward' method on the tensors bound to it. See {@link #executeBound(String)}. */
+  public int forwardBound() {
+    return executeBound("forward");
+  }
+
   /** Retrieve the in-memory log buffer, containing the most recent ExecuTorch log entries. */
   public String[] readLogBuffer() {
     return mNativePeer.readLogBuffer();
@@ -55,6 +55,22 @@ class NativePeer {
   @DoNotStrip
   public native int loadMethod(String methodName);
 
+  /**
+   * Bind input and output tensors to a method, to execute it with {@link #executeBound}.
+   *
+   * @return the Error code if there was an error binding the tensors
+   */
+  @DoNotStrip
+  public native int bind(String methodName, Tensor[] inputs, Tensor[] outputs);
+
+  /**
+   * Run a method on the tensors bound to it with {@link #bind}.
+   *
+   * @return the Error code if there was an error executing the method
+   */
+  @DoNotStrip
+  public native int executeBound(String methodName);
+
   /** Retrieve the in-memory log buffer, containing the most recent ExecuTorch log entries. */
   @DoNotStrip
   public native String[] readLogBuffer();
@@ -109,13 +109,15 @@ c10::ScalarType executorch_to_torch_scalar_type(
 void alias_etensor_to_attensor(
     at::Tensor& aten_tensor,
     torch::executor::Tensor& mutable_et) {
-  // TODO(kimishpatel): contiguous according to memformat
-  // Right now we assume everything is channels first contiguous
-  // Note that input tensor must be contiguous for us to alias.
+  // Input tensor must be dense for us to alias, but may be laid out in any
+  // dim order, e.g. channels last, as long as mutable_et has the same strides,
+  // which check_tensor_meta verifies. Other tensors have to be copied by the
+  // caller, e.g. with TensorConversionCache.
   // Mixing aliasing and copying is dangerous since if we aliased
   // the instance of mutatble_et to aten_tensor in the previous call,
   // then in the next call copying will not be the correct behavior.
-  ET_CHECK_MSG(aten_tensor.is_contiguous(), "Input tensor must be contiguous");
+  ET_CHECK_MSG(
+      aten_tensor.is_non_overlapping_and_dense(), "Input tensor must be dense");
   check_tensor_meta(aten_tensor, mutable_et);
   mutable_et.unsafeGetTensorImpl()->set_data(aten_tensor.mutable_data_ptr());
 }
@@ -29,9 +29,10 @@ c10::ScalarType executorch_to_torch_scalar_type(
     torch::executor::ScalarType type);
 
 /*
- * @param[in] aten_tensor Input at::Tensor
+ * @param[in] aten_tensor Input at::Tensor, which must be dense but may be laid
+ * out in any dim order
  * @param[in,out] mutable_et ETensor whose underlying memory now will alias to
- * aten_tensor
+ * aten_tensor, and whose strides must match those of aten_tensor
  */
 void alias_etensor_to_attensor(at::Tensor& at, torch::executor::Tensor& et);
 
@@ -36,3 +36,19 @@ def define_common_targets():
             "torch-core-cpp",
         ],
     )
+
+    runtime.cxx_library(
+        name = "tensor_conversion_cache",
+        srcs = ["tensor_conversion_cache.cpp"],
+        exported_headers = ["tensor_conversion_cache.h"],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+        external_deps = [
+            "torch-core-cpp",
+        ],
+    )
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/tensor_conversion_cache.h>
+
+#include <ATen/Functions.h> // @manual=//caffe2/aten:ATen-cpu
+
+namespace executorch {
+namespace extension {
+
+namespace {
+// Returns whether dim_order holds every dim of a tensor with `dims` dims once.
+bool is_valid_dim_order(
+    executorch::runtime::Span<const uint8_t> dim_order,
+    size_t dims) {
+  if (dim_order.size() != dims) {
+    return false;
+  }
+  std::vector<bool> seen(dims);
+  for (const auto dim : dim_order) {
+    if (dim >= dims || seen[dim]) {
+      return false;
+    }
+    seen[dim] = true;
+  }
+  return true;
+}
+} // namespace
+
+bool can_alias_with_dim_order(
+    const at::Tensor& tensor,
+    executorch::runtime::Span<const uint8_t> dim_order) {
+  if (!is_valid_dim_order(dim_order, tensor.dim())) {
+    return false;
+  }
+  // Walk the dims from the fastest moving one, checking that each is as far
+  // apart as the ones inside it span.
+  int64_t expected_stride = 1;
+  for (size_t i = dim_order.size(); i > 0; --i) {
+    const auto dim = dim_order[i - 1];
+    if (tensor.size(dim) != 1 && tensor.stride(dim) != expected_stride) {
+      return false;
+    }
+    expected_stride *= tensor.size(dim);
+  }
+  return true;
+}
+
+at::Tensor TensorConversionCache::convert(
+    size_t index,
+    const at::Tensor& tensor,
+    c10::ScalarType scalar_type,
+    executorch::runtime::Span<const uint8_t> dim_order) {
+  if (tensor.scalar_type() != scalar_type &&
+      c10::promoteTypes(tensor.scalar_type(), scalar_type) != scalar_type) {
+    return tensor;
+  }
+  if (!is_valid_dim_order(dim_order, tensor.dim()) ||
+      (tensor.scalar_type() == scalar_type &&
+       can_alias_with_dim_order(tensor, dim_order))) {
+    return tensor;
+  }
+  if (buffers_.size() <= index) {
+    buffers_.resize(index + 1);
+  }
+  auto& buffer = buffers_[index];
+  if (!buffer.defined() || buffer.sizes() != tensor.sizes() ||
+      buffer.scalar_type() != scalar_type ||
+      !can_alias_with_dim_order(buffer, dim_order)) {
+    // Allocate the dims in memory order, then view them in logical order.
+    std::vector<int64_t> memory_sizes(dim_order.size());
+    std::vector<int64_t> permutation(dim_order.size());
+    for (size_t i = 0; i < dim_order.size(); ++i) {
+      memory_sizes[i] = tensor.size(dim_order[i]);
+      permutation[dim_order[i]] = i;
+    }
+    buffer = at::empty(memory_sizes, at::TensorOptions(scalar_type))
+                 .permute(permutation);
+  }
+  buffer.copy_(tensor);
+  return buffer;
+}
+
+} // namespace extension
+} // namespace executorch
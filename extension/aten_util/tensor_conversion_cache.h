@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/span.h>
+
+#include <ATen/Tensor.h> // @manual=//caffe2/aten:ATen-core
+
+#include <cstdint>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+
+/*
+ * Returns whether a tensor with the dim order `dim_order` can alias the memory
+ * of `tensor`, i.e. whether `tensor` is dense and laid out in that order. The
+ * strides of dimensions of size 1 don't matter.
+ */
+bool can_alias_with_dim_order(
+    const at::Tensor& tensor,
+    executorch::runtime::Span<const uint8_t> dim_order);
+
+/*
+ * Converts at::Tensors to the scalar types and dim orders that the inputs of a
+ * method expect, copying only those that can't be aliased. Each input index
+ * has its own buffer, which is allocated on first use and reused by later
+ * conversions of tensors with the same sizes and scalar type, so that
+ * repeated calls don't reallocate.
+ *
+ * Works with both portable and ATen mode methods, since it only looks at the
+ * at::Tensors and at the dim orders from the MethodMeta.
+ */
+class TensorConversionCache final {
+ public:
+  /*
+   * @param[in] index The index of the input, which selects the buffer.
+   * @param[in] tensor The tensor to convert.
+   * @param[in] scalar_type The scalar type that the input expects. Tensors of
+   * other scalar types are converted only if they promote to it without loss,
+   * e.g. from Int to Long, and are returned unchanged otherwise.
+   * @param[in] dim_order The dim order that the input expects.
+   * @param[ret] `tensor` if it can be aliased or not converted, or else the
+   * buffer of `index` holding a copy of it, which stays valid until the next
+   * conversion with that index.
+   */
+  at::Tensor convert(
+      size_t index,
+      const at::Tensor& tensor,
+      c10::ScalarType scalar_type,
+      executorch::runtime::Span<const uint8_t> dim_order);
+
+ private:
+  std::vector<at::Tensor> buffers_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -12,12 +12,14 @@ def define_common_targets():
         srcs = [
             "aten_bridge_test.cpp",
             "make_aten_functor_from_et_functor_test.cpp",
+            "tensor_conversion_cache_test.cpp",
         ],
         deps = [
             "//executorch/runtime/core:core",
             "//executorch/runtime/core/exec_aten:lib",
             "//executorch/runtime/kernel:operator_registry",
             "//executorch/extension/aten_util:aten_bridge",
+            "//executorch/extension/aten_util:tensor_conversion_cache",
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
         ],
         external_deps = [
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/tensor_conversion_cache.h>
+
+#include <ATen/Functions.h>
+
+#include <gtest/gtest.h>
+
+using executorch::extension::can_alias_with_dim_order;
+using executorch::extension::TensorConversionCache;
+using executorch::runtime::Span;
+
+namespace {
+const std::vector<uint8_t> kContiguous = {0, 1, 2, 3};
+const std::vector<uint8_t> kChannelsLast = {0, 2, 3, 1};
+
+Span<const uint8_t> span(const std::vector<uint8_t>& dim_order) {
+  return {dim_order.data(), dim_order.size()};
+}
+} // namespace
+
+TEST(TensorConversionCacheTest, CanAliasWithDimOrder) {
+  auto contiguous = at::rand({2, 3, 4, 5});
+  EXPECT_TRUE(can_alias_with_dim_order(contiguous, span(kContiguous)));
+  EXPECT_FALSE(can_alias_with_dim_order(contiguous, span(kChannelsLast)));
+
+  auto channels_last = contiguous.contiguous(at::MemoryFormat::ChannelsLast);
+  EXPECT_FALSE(can_alias_with_dim_order(channels_last, span(kContiguous)));
+  EXPECT_TRUE(can_alias_with_dim_order(channels_last, span(kChannelsLast)));
+
+  // Slices are not dense in any order.
+  auto sliced = contiguous.slice(1, 0, 2);
+  EXPECT_FALSE(can_alias_with_dim_order(sliced, span(kContiguous)));
+
+  // The strides of dims of size 1 don't matter.
+  auto unsqueezed = at::rand({3, 4}).unsqueeze(0).unsqueeze(3);
+  EXPECT_TRUE(can_alias_with_dim_order(unsqueezed, span(kContiguous)));
+  EXPECT_FALSE(can_alias_with_dim_order(unsqueezed, span({0, 1})));
+}
+
+TEST(TensorConversionCacheTest, AliasesMatchingTensors) {
+  TensorConversionCache cache;
+  auto contiguous = at::rand({2, 3, 4, 5});
+  auto converted = cache.convert(0, contiguous, at::kFloat, span(kContiguous));
+  EXPECT_EQ(converted.const_data_ptr(), contiguous.const_data_ptr());
+
+  // Stride-preserving: a channels-last tensor is aliased for a method that
+  // expects channels last.
+  auto channels_last = contiguous.contiguous(at::MemoryFormat::ChannelsLast);
+  converted = cache.convert(0, channels_last, at::kFloat, span(kChannelsLast));
+  EXPECT_EQ(converted.const_data_ptr(), channels_last.const_data_ptr());
+}
+
+TEST(TensorConversionCacheTest, CopiesIntoReusedBuffer) {
+  TensorConversionCache cache;
+  auto sliced = at::rand({2, 6, 4, 5}).slice(1, 0, 3);
+  auto first = cache.convert(1, sliced, at::kFloat, span(kContiguous));
+  EXPECT_NE(first.const_data_ptr(), sliced.const_data_ptr());
+  EXPECT_TRUE(first.is_contiguous());
+  EXPECT_TRUE(at::equal(first, sliced));
+
+  // The next tensor of the same sizes is copied into the same buffer.
+  auto other = at::rand({2, 6, 4, 5}).slice(1, 3, 6);
+  auto second = cache.convert(1, other, at::kFloat, span(kContiguous));
+  EXPECT_EQ(second.const_data_ptr(), first.const_data_ptr());
+  EXPECT_TRUE(at::equal(second, other));
+
+  // A channels-last tensor is copied into a contiguous buffer.
+  auto channels_last =
+      at::rand({2, 3, 4, 5}).contiguous(at::MemoryFormat::ChannelsLast);
+  auto third = cache.convert(1, channels_last, at::kFloat, span(kContiguous));
+  EXPECT_EQ(third.const_data_ptr(), first.const_data_ptr());
+  EXPECT_TRUE(third.is_contiguous());
+  EXPECT_TRUE(at::equal(third, channels_last));
+}
+
+TEST(TensorConversionCacheTest, CopiesIntoExpectedDimOrder) {
+  TensorConversionCache cache;
+  auto contiguous = at::rand({2, 3, 4, 5});
+  auto converted =
+      cache.convert(0, contiguous, at::kFloat, span(kChannelsLast));
+  EXPECT_TRUE(can_alias_with_dim_order(converted, span(kChannelsLast)));
+  EXPECT_TRUE(at::equal(converted, contiguous));
+}
+
+TEST(TensorConversionCacheTest, PromotesScalarTypes) {
+  TensorConversionCache cache;
+  auto ints = at::arange(6, at::kInt).reshape({1, 2, 3, 1});
+  auto converted = cache.convert(0, ints, at::kLong, span(kContiguous));
+  EXPECT_EQ(converted.scalar_type(), at::kLong);
+  EXPECT_TRUE(at::equal(converted, ints.to(at::kLong)));
+
+  // Conversions that may lose precision are left to the method to reject.
+  auto doubles = at::rand({2, 3, 4, 5}, at::kDouble);
+  converted = cache.convert(1, doubles, at::kFloat, span(kContiguous));
+  EXPECT_EQ(converted.const_data_ptr(), doubles.const_data_ptr());
+  EXPECT_EQ(converted.scalar_type(), at::kDouble);
+}
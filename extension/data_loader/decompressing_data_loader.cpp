@@ -0,0 +1,391 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/decompressing_data_loader.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+// The layout of compressed segments is described in
+// exir/_serialize/_compression.py.
+constexpr char kMagic[4] = {'E', 'Z', '0', '1'};
+constexpr size_t kHeaderSize = 24;
+constexpr size_t kChunkEndSize = sizeof(uint64_t);
+constexpr size_t kLz4MinMatch = 4;
+
+uint64_t read_le(const uint8_t* data, size_t num_bytes) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < num_bytes; ++i) {
+    value |= static_cast<uint64_t>(data[i]) << (8 * i);
+  }
+  return value;
+}
+
+/**
+ * Reads the rest of an LZ4 length whose token nibble is 15. Returns false if
+ * the input ends first.
+ */
+bool read_lz4_length(
+    const uint8_t*& in,
+    const uint8_t* in_end,
+    size_t& length) {
+  uint8_t extra;
+  do {
+    if (in == in_end) {
+      return false;
+    }
+    extra = *in++;
+    length += extra;
+  } while (extra == 255);
+  return true;
+}
+
+/**
+ * Decompresses an LZ4 block into exactly `dst_size` bytes. Returns false if
+ * the block is malformed or does not decompress to `dst_size` bytes. Never
+ * reads or writes out of bounds, even for malicious input.
+ */
+bool lz4_decompress_block(
+    const uint8_t* src,
+    size_t src_size,
+    uint8_t* dst,
+    size_t dst_size) {
+  const uint8_t* in = src;
+  const uint8_t* const in_end = src + src_size;
+  uint8_t* out = dst;
+  uint8_t* const out_end = dst + dst_size;
+  while (in < in_end) {
+    const uint8_t token = *in++;
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 && !read_lz4_length(in, in_end, literal_length)) {
+      return false;
+    }
+    if (literal_length > static_cast<size_t>(in_end - in) ||
+        literal_length > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    std::memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+    if (in == in_end) {
+      // The last sequence has no match.
+      break;
+    }
+
+    if (in_end - in < 2) {
+      return false;
+    }
+    const size_t match_offset = read_le(in, 2);
+    in += 2;
+    size_t match_length = token & 15;
+    if (match_length == 15 && !read_lz4_length(in, in_end, match_length)) {
+      return false;
+    }
+    match_length += kLz4MinMatch;
+    if (match_offset == 0 || match_offset > static_cast<size_t>(out - dst) ||
+        match_length > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    const uint8_t* match = out - match_offset;
+    if (match_offset >= match_length) {
+      std::memcpy(out, match, match_length);
+      out += match_length;
+    } else {
+      // The match overlaps the bytes it produces, e.g. runs of one byte.
+      for (size_t i = 0; i < match_length; ++i) {
+        *out++ = *match++;
+      }
+    }
+  }
+  return out == out_end;
+}
+
+/// The SegmentInfo for reading the raw bytes of a compressed segment.
+DataLoader::SegmentInfo raw_segment_info(
+    const DataLoader::SegmentInfo& segment_info) {
+  return DataLoader::SegmentInfo(
+      segment_info.segment_type,
+      segment_info.segment_index,
+      segment_info.descriptor);
+}
+
+void free_buffer(ET_UNUSED void* context, void* data, ET_UNUSED size_t size) {
+  std::free(data);
+}
+
+} // namespace
+
+DecompressingDataLoader::DecompressingDataLoader(
+    const DataLoader* loader,
+    size_t num_threads)
+    : loader_(loader),
+      num_threads_(
+          num_threads > 0
+              ? num_threads
+              : std::max<size_t>(1, std::thread::hardware_concurrency())) {}
+
+Result<const DecompressingDataLoader::ChunkTable*>
+DecompressingDataLoader::get_chunk_table(
+    const SegmentInfo& segment_info) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = chunk_tables_.find(segment_info.compressed_offset);
+  if (it != chunk_tables_.end()) {
+    return it->second.get();
+  }
+
+  const size_t segment_offset = segment_info.compressed_offset;
+  const size_t segment_size = segment_info.compressed_size;
+  ET_CHECK_OR_RETURN_ERROR(
+      segment_size >= kHeaderSize,
+      InvalidProgram,
+      "Compressed segment of %zu bytes is too small",
+      segment_size);
+  Result<FreeableBuffer> header = loader_->load(
+      segment_offset, kHeaderSize, raw_segment_info(segment_info));
+  if (!header.ok()) {
+    return header.error();
+  }
+  const auto* header_data = static_cast<const uint8_t*>(header->data());
+  ET_CHECK_OR_RETURN_ERROR(
+      std::memcmp(header_data, kMagic, sizeof(kMagic)) == 0,
+      InvalidProgram,
+      "Unexpected compressed segment magic");
+
+  auto table = std::make_unique<ChunkTable>();
+  table->chunk_size = read_le(header_data + 4, 4);
+  table->uncompressed_size = read_le(header_data + 8, 8);
+  const uint64_t num_chunks = read_le(header_data + 16, 8);
+  header->Free();
+  ET_CHECK_OR_RETURN_ERROR(
+      table->chunk_size > 0 &&
+          num_chunks ==
+              (table->uncompressed_size + table->chunk_size - 1) /
+                  table->chunk_size &&
+          num_chunks <= (segment_size - kHeaderSize) / kChunkEndSize,
+      InvalidProgram,
+      "Invalid compressed segment header: chunk_size %zu, "
+      "uncompressed_size %zu, num_chunks %" PRIu64,
+      table->chunk_size,
+      table->uncompressed_size,
+      num_chunks);
+
+  const size_t table_size = num_chunks * kChunkEndSize;
+  table->data_offset = segment_offset + kHeaderSize + table_size;
+  table->chunk_ends.resize(num_chunks);
+  if (num_chunks > 0) {
+    Result<FreeableBuffer> ends = loader_->load(
+        segment_offset + kHeaderSize,
+        table_size,
+        raw_segment_info(segment_info));
+    if (!ends.ok()) {
+      return ends.error();
+    }
+    const auto* ends_data = static_cast<const uint8_t*>(ends->data());
+    const size_t data_size = segment_size - kHeaderSize - table_size;
+    uint64_t prev_end = 0;
+    for (size_t i = 0; i < num_chunks; ++i) {
+      const uint64_t end = read_le(ends_data + i * kChunkEndSize, 8);
+      ET_CHECK_OR_RETURN_ERROR(
+          prev_end <= end && end <= data_size,
+          InvalidProgram,
+          "Invalid end %" PRIu64 " of compressed chunk %zu",
+          end,
+          i);
+      table->chunk_ends[i] = end;
+      prev_end = end;
+    }
+  }
+
+  const ChunkTable* result = table.get();
+  chunk_tables_.emplace(segment_offset, std::move(table));
+  return result;
+}
+
+Error DecompressingDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  if (segment_info.compressed_size == 0) {
+    return loader_->load_into(offset, size, segment_info, buffer);
+  }
+  Result<const ChunkTable*> table_result = get_chunk_table(segment_info);
+  if (!table_result.ok()) {
+    return table_result.error();
+  }
+  const ChunkTable& table = *table_result.get();
+  ET_CHECK_OR_RETURN_ERROR(
+      offset <= table.uncompressed_size &&
+          size <= table.uncompressed_size - offset,
+      InvalidArgument,
+      "offset %zu + size %zu > uncompressed segment size %zu",
+      offset,
+      size,
+      table.uncompressed_size);
+  if (size == 0) {
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer != nullptr, InvalidArgument, "Provided buffer cannot be null");
+
+  // Read the compressed data of all the chunks that overlap the range at once.
+  const size_t first_chunk = offset / table.chunk_size;
+  const size_t last_chunk = (offset + size - 1) / table.chunk_size;
+  const auto chunk_begin = [&](size_t chunk) -> uint64_t {
+    return chunk == 0 ? 0 : table.chunk_ends[chunk - 1];
+  };
+  const uint64_t compressed_begin = chunk_begin(first_chunk);
+  Result<FreeableBuffer> compressed = loader_->load(
+      table.data_offset + compressed_begin,
+      table.chunk_ends[last_chunk] - compressed_begin,
+      raw_segment_info(segment_info));
+  if (!compressed.ok()) {
+    return compressed.error();
+  }
+  const auto* compressed_data = static_cast<const uint8_t*>(compressed->data());
+  auto* out = static_cast<uint8_t*>(buffer);
+
+  const auto decompress_chunk = [&](size_t chunk) -> Error {
+    const size_t begin = chunk * table.chunk_size;
+    const size_t length =
+        std::min(table.chunk_size, table.uncompressed_size - begin);
+    const uint8_t* src =
+        compressed_data + (chunk_begin(chunk) - compressed_begin);
+    const size_t src_size = table.chunk_ends[chunk] - chunk_begin(chunk);
+    // The part of the chunk that is in the requested range.
+    const size_t copy_begin = std::max(begin, offset);
+    const size_t copy_end = std::min(begin + length, offset + size);
+    if (src_size == length) {
+      // Stored as is.
+      std::memcpy(
+          out + copy_begin - offset,
+          src + copy_begin - begin,
+          copy_end - copy_begin);
+      return Error::Ok;
+    }
+    if (copy_begin == begin && copy_end == begin + length) {
+      // The whole chunk is needed, so decompress it in place.
+      ET_CHECK_OR_RETURN_ERROR(
+          lz4_decompress_block(src, src_size, out + begin - offset, length),
+          InvalidProgram,
+          "Corrupt compressed chunk %zu",
+          chunk);
+      return Error::Ok;
+    }
+    std::vector<uint8_t> scratch(length);
+    ET_CHECK_OR_RETURN_ERROR(
+        lz4_decompress_block(src, src_size, scratch.data(), length),
+        InvalidProgram,
+        "Corrupt compressed chunk %zu",
+        chunk);
+    std::memcpy(
+        out + copy_begin - offset,
+        scratch.data() + copy_begin - begin,
+        copy_end - copy_begin);
+    return Error::Ok;
+  };
+
+  // The chunks are independent, so decompress them concurrently.
+  std::atomic<size_t> next_chunk{first_chunk};
+  std::atomic<Error> first_error{Error::Ok};
+  auto decompress_chunks = [&]() {
+    for (size_t chunk = next_chunk++; chunk <= last_chunk;
+         chunk = next_chunk++) {
+      if (first_error.load() != Error::Ok) {
+        // Another chunk failed, so the load has already failed.
+        return;
+      }
+      Error err = decompress_chunk(chunk);
+      if (err != Error::Ok) {
+        Error expected = Error::Ok;
+        first_error.compare_exchange_strong(expected, err);
+      }
+    }
+  };
+  const size_t num_threads =
+      std::min(num_threads_, last_chunk - first_chunk + 1);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(decompress_chunks);
+  }
+  // The calling thread takes its share of the chunks too.
+  decompress_chunks();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return first_error.load();
+}
+
+Result<FreeableBuffer> DecompressingDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  if (segment_info.compressed_size == 0) {
+    return loader_->load(offset, size, segment_info);
+  }
+  // Don't bother allocating/freeing for empty ranges.
+  if (size == 0) {
+    return FreeableBuffer(nullptr, 0, /*free_fn=*/nullptr);
+  }
+  void* buffer = std::malloc(size);
+  if (buffer == nullptr) {
+    ET_LOG(
+        Error,
+        "Decompressing segment data at offset %zu: malloc(%zu) failed",
+        offset,
+        size);
+    return Error::MemoryAllocationFailed;
+  }
+  Error err = load_into(offset, size, segment_info, buffer);
+  if (err != Error::Ok) {
+    std::free(buffer);
+    return err;
+  }
+  return FreeableBuffer(buffer, size, free_buffer);
+}
+
+void DecompressingDataLoader::prefetch(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  if (segment_info.compressed_size == 0) {
+    loader_->prefetch(offset, size, segment_info);
+    return;
+  }
+  // Where the compressed data of the range starts and ends is only known once
+  // the chunk table is read, so read ahead the whole segment.
+  loader_->prefetch(
+      segment_info.compressed_offset,
+      segment_info.compressed_size,
+      raw_segment_info(segment_info));
+}
+
+Result<size_t> DecompressingDataLoader::size() const {
+  return loader_->size();
+}
+
+} // namespace extension
+} // namespace executorch
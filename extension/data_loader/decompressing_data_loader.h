@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A DataLoader that decompresses the compressed segments of a program, such
+ * as a constant segment serialized with `compress_constant_segment=True`, and
+ * passes every other load through to the DataLoader it wraps.
+ *
+ * Compressed segments are split into chunks that are compressed independently
+ * (see exir/_serialize/_compression.py), so a load decompresses only the
+ * chunks that hold the requested range, on up to `num_threads` threads. This
+ * makes both eager loading of the whole segment and lazy loading of single
+ * tensors (Program::ConstantLoading::Lazy) work on compressed programs.
+ *
+ * Returned buffers are allocated with `malloc()`.
+ */
+class DecompressingDataLoader final : public executorch::runtime::DataLoader {
+ public:
+  /**
+   * Creates a DecompressingDataLoader.
+   *
+   * @param[in] loader The loader of the program data. Must outlive this
+   *     instance.
+   * @param[in] num_threads The maximum number of threads that decompress the
+   *     chunks of a load. If zero, uses the number of hardware threads.
+   */
+  explicit DecompressingDataLoader(
+      const executorch::runtime::DataLoader* loader,
+      size_t num_threads = 0);
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+  void prefetch(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+  bool supports_compressed_segments() const override {
+    return true;
+  }
+
+ private:
+  /// The table of chunks of a compressed segment.
+  struct ChunkTable {
+    size_t chunk_size;
+    size_t uncompressed_size;
+    /// The offset in the data source of the compressed data of the first
+    /// chunk.
+    size_t data_offset;
+    /// The end offset of the compressed data of each chunk, relative to
+    /// `data_offset`.
+    std::vector<uint64_t> chunk_ends;
+  };
+
+  /// Returns the chunk table of a compressed segment, reading it from the
+  /// wrapped loader the first time.
+  executorch::runtime::Result<const ChunkTable*> get_chunk_table(
+      const SegmentInfo& segment_info) const;
+
+  const executorch::runtime::DataLoader* loader_;
+  const size_t num_threads_;
+
+  // Chunk tables by the offset of their compressed segment.
+  mutable std::mutex mutex_;
+  mutable std::unordered_map<size_t, std::unique_ptr<ChunkTable>>
+      chunk_tables_;
+};
+
+} // namespace extension
+} // namespace executorch
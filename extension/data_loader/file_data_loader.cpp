@@ -9,16 +9,20 @@
 #include <executorch/extension/data_loader/file_data_loader.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstddef>
 #include <cstring>
 #include <limits>
+#include <thread>
+#include <vector>
 
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <executorch/extension/data_loader/file_prefetch.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/platform/log.h>
@@ -37,6 +41,7 @@
 using executorch::runtime::Error;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
 
 namespace executorch {
 namespace extension {
@@ -63,6 +68,9 @@ static uint8_t* align_pointer(void* ptr, size_t alignment) {
   addr = (addr | (alignment - 1)) + 1;
   return reinterpret_cast<uint8_t*>(addr);
 }
+
+/// The maximum number of reads that load_into_batch() has in flight at once.
+constexpr size_t kMaxConcurrentReads = 8;
 } // namespace
 
 FileDataLoader::~FileDataLoader() {
@@ -219,6 +227,13 @@ Result<size_t> FileDataLoader::size() const {
   return file_size_;
 }
 
+void FileDataLoader::prefetch(
+    size_t offset,
+    size_t size,
+    ET_UNUSED const DataLoader::SegmentInfo& segment_info) const {
+  internal::prefetch_file_range(fd_, file_name_, file_size_, offset, size);
+}
+
 ET_NODISCARD Error FileDataLoader::load_into(
     size_t offset,
     size_t size,
@@ -291,5 +306,74 @@ ET_NODISCARD Error FileDataLoader::load_into(
   return Error::Ok;
 }
 
+ET_NODISCARD Error
+FileDataLoader::load_into_batch(Span<const LoadIntoRequest> requests) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      // Probably had its value moved to another instance.
+      fd_ >= 0,
+      InvalidState,
+      "Uninitialized");
+  // Validate the whole batch before starting any reads.
+  for (const auto& request : requests) {
+    ET_CHECK_OR_RETURN_ERROR(
+        request.offset + request.size <= file_size_,
+        InvalidArgument,
+        "File %s: offset %zu + size %zu > file_size_ %zu",
+        file_name_,
+        request.offset,
+        request.size,
+        file_size_);
+    ET_CHECK_OR_RETURN_ERROR(
+        request.buffer != nullptr,
+        InvalidArgument,
+        "Provided buffer cannot be null");
+  }
+
+#if ET_HAVE_PREAD
+  const size_t num_threads = std::min(requests.size(), kMaxConcurrentReads);
+  if (num_threads > 1) {
+    // Let the kernel start on every range, not just the ones that are being
+    // read right now.
+    for (const auto& request : requests) {
+      prefetch(request.offset, request.size, request.segment_info);
+    }
+
+    // pread() doesn't touch the file position, so the reads can share fd_.
+    std::atomic<size_t> next_request{0};
+    std::atomic<Error> first_error{Error::Ok};
+    auto read_requests = [&]() {
+      for (size_t i = next_request++; i < requests.size();
+           i = next_request++) {
+        if (first_error.load() != Error::Ok) {
+          // Another read failed, so the batch has already failed.
+          return;
+        }
+        const auto& request = requests[i];
+        Error err = load_into(
+            request.offset, request.size, request.segment_info, request.buffer);
+        if (err != Error::Ok) {
+          Error expected = Error::Ok;
+          first_error.compare_exchange_strong(expected, err);
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(read_requests);
+    }
+    // The calling thread takes its share of the reads too.
+    read_requests();
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    return first_error.load();
+  }
+#endif // ET_HAVE_PREAD
+
+  return DataLoader::load_into_batch(requests);
+}
+
 } // namespace extension
 } // namespace executorch
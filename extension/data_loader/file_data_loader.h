@@ -72,12 +72,23 @@ class FileDataLoader final : public executorch::runtime::DataLoader {
 
   ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
 
+  /// Asks the OS to read the range into the page cache in the background.
+  void prefetch(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
   ET_NODISCARD executorch::runtime::Error load_into(
       size_t offset,
       size_t size,
       ET_UNUSED const SegmentInfo& segment_info,
       void* buffer) const override;
 
+  /// Performs the reads concurrently on a small number of threads, where the
+  /// platform supports pread().
+  ET_NODISCARD executorch::runtime::Error load_into_batch(
+      executorch::runtime::Span<const LoadIntoRequest> requests) const override;
+
  private:
   FileDataLoader(
       int fd,
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/types.h>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace extension {
+namespace internal {
+
+/**
+ * Clamps the range of `*size` bytes at `offset` to a file of `file_size`
+ * bytes, and to the offsets that an off_t can hold. Returns false if nothing
+ * is left to prefetch.
+ */
+inline bool clamp_prefetch_range(
+    size_t file_size,
+    size_t offset,
+    size_t* size) {
+  constexpr size_t kMaxOffset =
+      static_cast<size_t>(std::numeric_limits<off_t>::max());
+  if (offset >= file_size || *size == 0 || offset >= kMaxOffset) {
+    return false;
+  }
+  *size = std::min({*size, file_size - offset, kMaxOffset - offset});
+  return true;
+}
+
+/**
+ * Asks the kernel to start reading the range of `size` bytes at `offset` of
+ * the file into the page cache, without blocking on I/O. Only logs failures,
+ * since prefetching is a hint.
+ */
+inline void prefetch_file_range(
+    int fd,
+    const char* file_name,
+    size_t file_size,
+    size_t offset,
+    size_t size) {
+  if (fd < 0 || !clamp_prefetch_range(file_size, offset, &size)) {
+    return;
+  }
+#if defined(POSIX_FADV_WILLNEED)
+  int err = ::posix_fadvise(
+      fd,
+      static_cast<off_t>(offset),
+      static_cast<off_t>(size),
+      POSIX_FADV_WILLNEED);
+  if (err != 0) {
+    ET_LOG(
+        Debug,
+        "Ignoring prefetch error for file %s (off=0x%zx, size=%zu): %s (%d)",
+        file_name,
+        offset,
+        size,
+        ::strerror(err),
+        err);
+  }
+#else
+  (void)file_name;
+#endif
+}
+
+} // namespace internal
+} // namespace extension
+} // namespace executorch
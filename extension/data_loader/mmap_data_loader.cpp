@@ -8,7 +8,9 @@
 
 #include <executorch/extension/data_loader/mmap_data_loader.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <cinttypes>
 #include <cstring>
 #include <limits>
 
@@ -18,6 +20,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <executorch/extension/data_loader/file_prefetch.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/platform/log.h>
@@ -68,7 +71,8 @@ MmapDataLoader::~MmapDataLoader() {
 
 Result<MmapDataLoader> MmapDataLoader::from(
     const char* file_name,
-    MmapDataLoader::MlockConfig mlock_config) {
+    MmapDataLoader::MlockConfig mlock_config,
+    const PagePolicy& page_policy) {
   // Cache the page size.
   long page_size = sysconf(_SC_PAGESIZE);
   if (page_size < 0) {
@@ -120,7 +124,8 @@ Result<MmapDataLoader> MmapDataLoader::from(
       file_size,
       file_name_copy,
       static_cast<size_t>(page_size),
-      mlock_config);
+      mlock_config,
+      page_policy);
 }
 
 namespace {
@@ -201,6 +206,19 @@ Result<FreeableBuffer> MmapDataLoader::load(
       fd_,
       range.start);
 
+  if (!page_policy_.is_default()) {
+    // Hint before mlock() faults the pages in.
+    Error err = apply_page_policy(pages, range.size, page_policy_);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Debug,
+          "Ignoring page policy error 0x%" PRIx32 " for file %s (off=0x%zx)",
+          static_cast<uint32_t>(err),
+          file_name_,
+          offset);
+    }
+  }
+
   if (mlock_config_ == MlockConfig::UseMlock ||
       mlock_config_ == MlockConfig::UseMlockIgnoreErrors) {
     int err = ::mlock(pages, size);
@@ -257,5 +275,12 @@ Result<size_t> MmapDataLoader::size() const {
   return file_size_;
 }
 
+void MmapDataLoader::prefetch(
+    size_t offset,
+    size_t size,
+    ET_UNUSED const DataLoader::SegmentInfo& segment_info) const {
+  internal::prefetch_file_range(fd_, file_name_, file_size_, offset, size);
+}
+
 } // namespace extension
 } // namespace executorch
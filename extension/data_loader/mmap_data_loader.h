@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <executorch/extension/memory_allocator/page_memory.h>
 #include <executorch/runtime/core/data_loader.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/platform/compiler.h>
@@ -49,10 +50,15 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
    *     overhead of opening it again for every load() call.
    * @param[in] mlock_config How and whether to lock loaded pages with
    *     `mlock()`.
+   * @param[in] page_policy How to place the pages of loaded segments. Applied
+   *     on a best-effort basis: failures are logged, but do not fail loads.
+   *     Explicit huge pages can't back file mappings, so they are treated as
+   *     transparent huge pages.
    */
   static executorch::runtime::Result<MmapDataLoader> from(
       const char* file_name,
-      MlockConfig mlock_config = MlockConfig::UseMlock);
+      MlockConfig mlock_config = MlockConfig::UseMlock,
+      const PagePolicy& page_policy = PagePolicy());
 
   /// DEPRECATED: Use the lowercase `from()` instead.
   ET_DEPRECATED static executorch::runtime::Result<MmapDataLoader> From(
@@ -77,7 +83,8 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
         file_size_(rhs.file_size_),
         page_size_(rhs.page_size_),
         fd_(rhs.fd_),
-        mlock_config_(rhs.mlock_config_) {
+        mlock_config_(rhs.mlock_config_),
+        page_policy_(rhs.page_policy_) {
     const_cast<const char*&>(rhs.file_name_) = nullptr;
     const_cast<size_t&>(rhs.file_size_) = 0;
     const_cast<size_t&>(rhs.page_size_) = 0;
@@ -95,18 +102,26 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
 
   ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
 
+  /// Asks the OS to read the range into the page cache in the background.
+  void prefetch(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
  private:
   MmapDataLoader(
       int fd,
       size_t file_size,
       const char* file_name,
       size_t page_size,
-      MlockConfig mlock_config)
+      MlockConfig mlock_config,
+      const PagePolicy& page_policy)
       : file_name_(file_name),
         file_size_(file_size),
         page_size_(page_size),
         fd_(fd),
-        mlock_config_(mlock_config) {}
+        mlock_config_(mlock_config),
+        page_policy_(page_policy) {}
 
   // Not safely copyable.
   MmapDataLoader(const MmapDataLoader&) = delete;
@@ -118,6 +133,7 @@ class MmapDataLoader final : public executorch::runtime::DataLoader {
   const size_t page_size_;
   const int fd_; // Owned by the instance.
   const MlockConfig mlock_config_;
+  const PagePolicy page_policy_;
 };
 
 } // namespace extension
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/shared_file_data_loader.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <tuple>
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+
+namespace executorch {
+namespace extension {
+
+struct SharedFileDataLoader::SharedFile {
+  explicit SharedFile(FileDataLoader loader_) : loader(std::move(loader_)) {}
+
+  const FileDataLoader loader;
+  std::mutex mutex;
+  // The loaded segments, by offset and size.
+  std::map<std::pair<size_t, size_t>, std::weak_ptr<Segment>> segments;
+};
+
+struct SharedFileDataLoader::Segment {
+  // Held while loading the data, so that only one loader reads it.
+  std::mutex mutex;
+  std::optional<FreeableBuffer> data;
+  // Keeps the file open while its segments are in use.
+  std::shared_ptr<SharedFile> file;
+};
+
+namespace {
+
+// Identifies the contents of a file, and the alignment of its segments.
+using FileKey = std::tuple<
+    uint64_t, // device
+    uint64_t, // inode
+    uint64_t, // size
+    int64_t, // modification time
+    size_t>; // alignment
+
+struct Registry {
+  std::mutex mutex;
+  std::map<FileKey, std::weak_ptr<void>> files;
+};
+
+Registry& registry() {
+  // Never destroyed, so that loaders with static storage duration can still
+  // be destroyed.
+  static Registry* registry = new Registry();
+  return *registry;
+}
+
+} // namespace
+
+Result<SharedFileDataLoader> SharedFileDataLoader::from(
+    const char* file_name,
+    size_t alignment) {
+  struct stat st;
+  if (::stat(file_name, &st) != 0) {
+    ET_LOG(
+        Error, "Failed to stat %s: %s (%d)", file_name, strerror(errno), errno);
+    return Error::AccessFailed;
+  }
+  const FileKey key{
+      static_cast<uint64_t>(st.st_dev),
+      static_cast<uint64_t>(st.st_ino),
+      static_cast<uint64_t>(st.st_size),
+      static_cast<int64_t>(st.st_mtime),
+      alignment};
+
+  auto& files = registry();
+  std::lock_guard<std::mutex> lock(files.mutex);
+  auto it = files.files.find(key);
+  if (it != files.files.end()) {
+    auto file = std::static_pointer_cast<SharedFile>(it->second.lock());
+    if (file) {
+      return SharedFileDataLoader(std::move(file));
+    }
+  }
+  auto loader = FileDataLoader::from(file_name, alignment);
+  if (!loader.ok()) {
+    return loader.error();
+  }
+  auto file = std::make_shared<SharedFile>(std::move(*loader));
+  // Drop the files that are no longer in use.
+  for (auto entry = files.files.begin(); entry != files.files.end();) {
+    entry = entry->second.expired() ? files.files.erase(entry) : ++entry;
+  }
+  files.files[key] = file;
+  return SharedFileDataLoader(std::move(file));
+}
+
+Result<FreeableBuffer> SharedFileDataLoader::load(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  std::shared_ptr<Segment> segment;
+  {
+    std::lock_guard<std::mutex> lock(file_->mutex);
+    auto& entry = file_->segments[{offset, size}];
+    segment = entry.lock();
+    if (!segment) {
+      segment = std::make_shared<Segment>();
+      segment->file = file_;
+      entry = segment;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(segment->mutex);
+    if (!segment->data.has_value()) {
+      auto data = file_->loader.load(offset, size, segment_info);
+      if (!data.ok()) {
+        return data.error();
+      }
+      segment->data.emplace(std::move(*data));
+    }
+  }
+  const void* data = segment->data->data();
+  return FreeableBuffer(
+      data,
+      size,
+      release_segment,
+      new std::shared_ptr<Segment>(std::move(segment)));
+}
+
+void SharedFileDataLoader::release_segment(
+    void* context,
+    ET_UNUSED void* data,
+    ET_UNUSED size_t size) {
+  delete static_cast<std::shared_ptr<Segment>*>(context);
+}
+
+Result<size_t> SharedFileDataLoader::size() const {
+  return file_->loader.size();
+}
+
+void SharedFileDataLoader::prefetch(
+    size_t offset,
+    size_t size,
+    const DataLoader::SegmentInfo& segment_info) const {
+  file_->loader.prefetch(offset, size, segment_info);
+}
+
+Error SharedFileDataLoader::load_into(
+    size_t offset,
+    size_t size,
+    const SegmentInfo& segment_info,
+    void* buffer) const {
+  return file_->loader.load_into(offset, size, segment_info, buffer);
+}
+
+Error SharedFileDataLoader::load_into_batch(
+    Span<const LoadIntoRequest> requests) const {
+  return file_->loader.load_into_batch(requests);
+}
+
+size_t SharedFileDataLoader::num_loaded_segments() const {
+  std::lock_guard<std::mutex> lock(file_->mutex);
+  size_t count = 0;
+  for (auto it = file_->segments.begin(); it != file_->segments.end();) {
+    if (it->second.expired()) {
+      it = file_->segments.erase(it);
+    } else {
+      ++count;
+      ++it;
+    }
+  }
+  return count;
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: A DataLoader that reads segments from a file like
+ * FileDataLoader, but shares them with every other SharedFileDataLoader of
+ * the same file in the process, e.g. those of the Modules that each worker
+ * thread creates for one model. The program and its constants are then read
+ * into memory once, however many loaders use them.
+ *
+ * Loaded segments are reference-counted: a segment is read the first time a
+ * loader loads it, and freed once every FreeableBuffer for it is freed. Files
+ * are told apart by their device, inode, size and modification time, so a
+ * file that is replaced or rewritten gets segments of its own, and different
+ * paths to one file share them.
+ *
+ * Since the segments are shared, their data must not be modified.
+ */
+class SharedFileDataLoader final : public executorch::runtime::DataLoader {
+ public:
+  /**
+   * Creates a new SharedFileDataLoader for the named file, sharing the
+   * segments of the other loaders of the same file with the same alignment.
+   *
+   * @param[in] file_name Path to the file to read from.
+   * @param[in] alignment Alignment in bytes of pointers returned by this
+   *     instance. Must be a power of two.
+   *
+   * @returns A new SharedFileDataLoader on success.
+   * @retval Error::InvalidArgument `alignment` is not a power of two.
+   * @retval Error::AccessFailed `file_name` could not be opened, or its size
+   *     could not be found.
+   * @retval Error::MemoryAllocationFailed Internal memory allocation failure.
+   */
+  static executorch::runtime::Result<SharedFileDataLoader> from(
+      const char* file_name,
+      size_t alignment = alignof(std::max_align_t));
+
+  // Movable to be compatible with Result.
+  SharedFileDataLoader(SharedFileDataLoader&&) noexcept = default;
+
+  ~SharedFileDataLoader() override = default;
+
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> size() const override;
+
+  void prefetch(
+      size_t offset,
+      size_t size,
+      const DataLoader::SegmentInfo& segment_info) const override;
+
+  /// Reads into the caller's buffer without sharing, like FileDataLoader,
+  /// since the caller may modify it.
+  ET_NODISCARD executorch::runtime::Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override;
+
+  ET_NODISCARD executorch::runtime::Error load_into_batch(
+      executorch::runtime::Span<const LoadIntoRequest> requests) const override;
+
+  /// The number of segments of the file that are loaded, across all the
+  /// loaders that share them.
+  size_t num_loaded_segments() const;
+
+ private:
+  // The state shared by the loaders of one file.
+  struct SharedFile;
+  // One loaded segment of a SharedFile.
+  struct Segment;
+
+  explicit SharedFileDataLoader(std::shared_ptr<SharedFile> file)
+      : file_(std::move(file)) {}
+
+  // Not copyable, like FileDataLoader.
+  SharedFileDataLoader(const SharedFileDataLoader&) = delete;
+  SharedFileDataLoader& operator=(const SharedFileDataLoader&) = delete;
+  SharedFileDataLoader& operator=(SharedFileDataLoader&&) = delete;
+
+  // FreeableBuffer::FreeFn that drops a reference to a Segment.
+  static void release_segment(void* context, void* data, size_t size);
+
+  std::shared_ptr<SharedFile> file_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -37,6 +37,18 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "file_prefetch",
+        srcs = [],
+        exported_headers = ["file_prefetch.h"],
+        visibility = [
+            "//executorch/extension/data_loader/...",
+        ],
+        exported_deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
     runtime.cxx_library(
         name = "file_data_loader",
         srcs = ["file_data_loader.cpp"],
@@ -47,6 +59,26 @@ def define_common_targets():
             "//executorch/extension/data_loader/test/...",
             "@EXECUTORCH_CLIENTS",
         ],
+        deps = [
+            ":file_prefetch",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "shared_file_data_loader",
+        srcs = ["shared_file_data_loader.cpp"],
+        exported_headers = ["shared_file_data_loader.h"],
+        visibility = [
+            "//executorch/test/...",
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:file_data_loader",
+        ],
         exported_deps = [
             "//executorch/runtime/core:core",
         ],
@@ -78,6 +110,26 @@ def define_common_targets():
             "//executorch/extension/data_loader/test/...",
             "@EXECUTORCH_CLIENTS",
         ],
+        deps = [
+            ":file_prefetch",
+        ],
+        exported_deps = [
+            "//executorch/extension/memory_allocator:page_memory",
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "decompressing_data_loader",
+        srcs = ["decompressing_data_loader.cpp"],
+        exported_headers = ["decompressing_data_loader.h"],
+        visibility = [
+            "//executorch/test/...",
+            "//executorch/extension/pybindings/...",
+            "//executorch/runtime/executor/test/...",
+            "//executorch/extension/data_loader/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
         exported_deps = [
             "//executorch/runtime/core:core",
         ],
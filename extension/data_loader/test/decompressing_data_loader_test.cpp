@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/decompressing_data_loader.h>
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::BufferDataLoader;
+using executorch::extension::DecompressingDataLoader;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+namespace {
+
+constexpr size_t kChunkSize = 32;
+constexpr size_t kUncompressedSize = 2 * kChunkSize + 20;
+// Bytes in front of the compressed segment in the data source.
+constexpr size_t kSegmentOffset = 16;
+
+void append_le(std::vector<uint8_t>& out, uint64_t value, size_t num_bytes) {
+  for (size_t i = 0; i < num_bytes; ++i) {
+    out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+/// The uncompressed data of the segment built by make_data().
+std::vector<uint8_t> expected_data() {
+  std::vector<uint8_t> data;
+  // Chunk 0: "abcabc...".
+  for (size_t i = 0; i < kChunkSize; ++i) {
+    data.push_back("abc"[i % 3]);
+  }
+  // Chunk 1: 0, 1, 2, ...
+  for (size_t i = 0; i < kChunkSize; ++i) {
+    data.push_back(i);
+  }
+  // Chunk 2: a run of 'z'.
+  data.insert(data.end(), 20, 'z');
+  return data;
+}
+
+/**
+ * Returns a data source holding kSegmentOffset bytes of padding followed by
+ * the expected_data() compressed in the LZ4_CHUNKED layout: an LZ4 chunk with
+ * a long match, a chunk stored as is, and a short LZ4 chunk whose match
+ * overlaps its own output.
+ */
+std::vector<uint8_t> make_data() {
+  std::vector<uint8_t> chunk0 = {
+      // Literals "abc", then a match of 4 + 15 + 5 bytes at offset 3.
+      0x3f, 'a', 'b', 'c', 0x03, 0x00, 0x05,
+      // Last literals.
+      0x50, 'a', 'b', 'c', 'a', 'b'};
+  std::vector<uint8_t> chunk1;
+  for (size_t i = 0; i < kChunkSize; ++i) {
+    chunk1.push_back(i);
+  }
+  std::vector<uint8_t> chunk2 = {
+      // Literal "z", then a match of 4 + 10 bytes at offset 1.
+      0x1a, 'z', 0x01, 0x00,
+      // Last literals.
+      0x50, 'z', 'z', 'z', 'z', 'z'};
+
+  std::vector<uint8_t> data(kSegmentOffset, 0xff);
+  data.insert(data.end(), {'E', 'Z', '0', '1'});
+  append_le(data, kChunkSize, 4);
+  append_le(data, kUncompressedSize, 8);
+  append_le(data, 3, 8);
+  append_le(data, chunk0.size(), 8);
+  append_le(data, chunk0.size() + chunk1.size(), 8);
+  append_le(data, chunk0.size() + chunk1.size() + chunk2.size(), 8);
+  for (const auto* chunk : {&chunk0, &chunk1, &chunk2}) {
+    data.insert(data.end(), chunk->begin(), chunk->end());
+  }
+  return data;
+}
+
+DataLoader::SegmentInfo compressed_segment_info(
+    const std::vector<uint8_t>& data) {
+  DataLoader::SegmentInfo info(DataLoader::SegmentInfo::Type::Constant);
+  info.compressed_offset = kSegmentOffset;
+  info.compressed_size = data.size() - kSegmentOffset;
+  return info;
+}
+
+} // namespace
+
+class DecompressingDataLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(DecompressingDataLoaderTest, UncompressedLoadsPassThrough) {
+  std::vector<uint8_t> data = make_data();
+  BufferDataLoader inner(data.data(), data.size());
+  DecompressingDataLoader loader(&inner);
+
+  EXPECT_TRUE(loader.supports_compressed_segments());
+  EXPECT_FALSE(inner.supports_compressed_segments());
+  EXPECT_EQ(*loader.size(), data.size());
+
+  Result<FreeableBuffer> fb = loader.load(
+      /*offset=*/kSegmentOffset,
+      /*size=*/4,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(fb->size(), 4);
+  EXPECT_EQ(0, std::memcmp(fb->data(), "EZ01", 4));
+}
+
+TEST_F(DecompressingDataLoaderTest, LoadsWholeSegment) {
+  std::vector<uint8_t> data = make_data();
+  std::vector<uint8_t> expected = expected_data();
+  BufferDataLoader inner(data.data(), data.size());
+
+  for (size_t num_threads : {1, 2, 4}) {
+    DecompressingDataLoader loader(&inner, num_threads);
+    Result<FreeableBuffer> fb =
+        loader.load(0, kUncompressedSize, compressed_segment_info(data));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(fb->size(), kUncompressedSize);
+    EXPECT_EQ(0, std::memcmp(fb->data(), expected.data(), kUncompressedSize));
+  }
+}
+
+TEST_F(DecompressingDataLoaderTest, LoadsPartialRanges) {
+  std::vector<uint8_t> data = make_data();
+  std::vector<uint8_t> expected = expected_data();
+  BufferDataLoader inner(data.data(), data.size());
+  DecompressingDataLoader loader(&inner);
+
+  // Ranges within one chunk, across chunks, and at the end of the segment.
+  const std::pair<size_t, size_t> ranges[] = {
+      {5, 3}, {30, 20}, {40, 30}, {60, 24}, {83, 1}};
+  for (const auto& range : ranges) {
+    std::vector<uint8_t> buffer(range.second);
+    Error err = loader.load_into(
+        range.first,
+        range.second,
+        compressed_segment_info(data),
+        buffer.data());
+    ASSERT_EQ(err, Error::Ok);
+    EXPECT_EQ(
+        0,
+        std::memcmp(
+            buffer.data(), expected.data() + range.first, range.second));
+  }
+}
+
+TEST_F(DecompressingDataLoaderTest, OutOfBoundsLoadFails) {
+  std::vector<uint8_t> data = make_data();
+  BufferDataLoader inner(data.data(), data.size());
+  DecompressingDataLoader loader(&inner);
+
+  Result<FreeableBuffer> fb =
+      loader.load(80, 5, compressed_segment_info(data));
+  EXPECT_EQ(fb.error(), Error::InvalidArgument);
+}
+
+TEST_F(DecompressingDataLoaderTest, BadMagicFails) {
+  std::vector<uint8_t> data = make_data();
+  data[kSegmentOffset] = 'X';
+  BufferDataLoader inner(data.data(), data.size());
+  DecompressingDataLoader loader(&inner);
+
+  Result<FreeableBuffer> fb =
+      loader.load(0, kUncompressedSize, compressed_segment_info(data));
+  EXPECT_EQ(fb.error(), Error::InvalidProgram);
+}
+
+TEST_F(DecompressingDataLoaderTest, CorruptChunkFails) {
+  std::vector<uint8_t> data = make_data();
+  // Point the match of chunk 0 before the start of its output.
+  const size_t chunk0_offset = kSegmentOffset + 24 + 3 * 8;
+  data[chunk0_offset + 4] = 0x10;
+  BufferDataLoader inner(data.data(), data.size());
+  DecompressingDataLoader loader(&inner);
+
+  Result<FreeableBuffer> fb =
+      loader.load(0, kUncompressedSize, compressed_segment_info(data));
+  EXPECT_EQ(fb.error(), Error::InvalidProgram);
+
+  // Chunks that are not corrupt still load.
+  std::vector<uint8_t> expected = expected_data();
+  Result<FreeableBuffer> chunk1 =
+      loader.load(kChunkSize, kChunkSize, compressed_segment_info(data));
+  ASSERT_EQ(chunk1.error(), Error::Ok);
+  EXPECT_EQ(
+      0,
+      std::memcmp(chunk1->data(), expected.data() + kChunkSize, kChunkSize));
+}
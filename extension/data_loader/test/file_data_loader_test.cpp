@@ -9,6 +9,7 @@
 #include <executorch/extension/data_loader/file_data_loader.h>
 
 #include <cstring>
+#include <limits>
 
 #include <gtest/gtest.h>
 
@@ -147,6 +148,69 @@ TEST_P(FileDataLoaderTest, OutOfBoundsLoadFails) {
   }
 }
 
+TEST_P(FileDataLoaderTest, PrefetchDoesNotAffectLoads) {
+  uint8_t data[256];
+  for (int i = 0; i < sizeof(data); ++i) {
+    data[i] = i;
+  }
+  TempFile tf(data, sizeof(data));
+
+  Result<FileDataLoader> fdl =
+      FileDataLoader::from(tf.path().c_str(), alignment());
+  ASSERT_EQ(fdl.error(), Error::Ok);
+
+  // Prefetching is only a hint; out-of-bounds ranges are ignored.
+  const DataLoader::SegmentInfo info(DataLoader::SegmentInfo::Type::Constant);
+  fdl->prefetch(/*offset=*/16, /*size=*/64, info);
+  fdl->prefetch(/*offset=*/0, /*size=*/sizeof(data) * 2, info);
+  fdl->prefetch(/*offset=*/sizeof(data) + 1, /*size=*/1, info);
+  fdl->prefetch(
+      /*offset=*/static_cast<size_t>(std::numeric_limits<off_t>::max()) + 1,
+      /*size=*/1,
+      info);
+
+  Result<FreeableBuffer> fb = fdl->load(/*offset=*/16, /*size=*/64, info);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(fb->size(), 64);
+  EXPECT_EQ(0, std::memcmp(fb->data(), &data[16], fb->size()));
+}
+
+TEST_P(FileDataLoaderTest, LoadIntoBatch) {
+  uint8_t data[4096];
+  for (int i = 0; i < sizeof(data); ++i) {
+    data[i] = static_cast<uint8_t>(i * 7);
+  }
+  TempFile tf(data, sizeof(data));
+
+  Result<FileDataLoader> fdl =
+      FileDataLoader::from(tf.path().c_str(), alignment());
+  ASSERT_EQ(fdl.error(), Error::Ok);
+
+  // More requests than the loader reads at once, of varying sizes.
+  constexpr size_t kNumRequests = 20;
+  uint8_t buffers[kNumRequests][128] = {};
+  DataLoader::LoadIntoRequest requests[kNumRequests];
+  for (size_t i = 0; i < kNumRequests; ++i) {
+    requests[i] = {
+        /*offset=*/i * 200,
+        /*size=*/i + 100,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Mutable, i),
+        buffers[i]};
+  }
+  ASSERT_EQ(fdl->load_into_batch({requests, kNumRequests}), Error::Ok);
+  for (size_t i = 0; i < kNumRequests; ++i) {
+    EXPECT_EQ(0, std::memcmp(buffers[i], &data[i * 200], i + 100));
+  }
+
+  // An empty batch does nothing.
+  EXPECT_EQ(fdl->load_into_batch({}), Error::Ok);
+
+  // One out-of-bounds request fails the whole batch.
+  requests[3].offset = sizeof(data);
+  EXPECT_EQ(
+      fdl->load_into_batch({requests, kNumRequests}), Error::InvalidArgument);
+}
+
 TEST_P(FileDataLoaderTest, FromMissingFileFails) {
   // Wrapping a file that doesn't exist should fail.
   Result<FileDataLoader> fdl = FileDataLoader::from(
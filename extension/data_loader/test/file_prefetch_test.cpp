@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/file_prefetch.h>
+
+#include <limits>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::internal::clamp_prefetch_range;
+
+namespace {
+constexpr size_t kMaxOffset =
+    static_cast<size_t>(std::numeric_limits<off_t>::max());
+} // namespace
+
+class FilePrefetchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(FilePrefetchTest, ClampsToEndOfFile) {
+  size_t size = 64;
+  EXPECT_TRUE(clamp_prefetch_range(/*file_size=*/256, /*offset=*/16, &size));
+  EXPECT_EQ(size, 64);
+
+  size = 1024;
+  EXPECT_TRUE(clamp_prefetch_range(/*file_size=*/256, /*offset=*/16, &size));
+  EXPECT_EQ(size, 240);
+}
+
+TEST_F(FilePrefetchTest, RejectsEmptyRanges) {
+  size_t size = 0;
+  EXPECT_FALSE(clamp_prefetch_range(/*file_size=*/256, /*offset=*/16, &size));
+
+  size = 1;
+  EXPECT_FALSE(clamp_prefetch_range(/*file_size=*/256, /*offset=*/256, &size));
+  EXPECT_FALSE(clamp_prefetch_range(/*file_size=*/256, /*offset=*/257, &size));
+}
+
+TEST_F(FilePrefetchTest, RejectsOffsetsBeyondOffT) {
+  // A file size that no off_t can describe, so that only the off_t limit
+  // rejects the offsets.
+  constexpr size_t kFileSize = std::numeric_limits<size_t>::max();
+  size_t size = 1;
+  EXPECT_FALSE(clamp_prefetch_range(kFileSize, kMaxOffset + 1, &size));
+  EXPECT_FALSE(clamp_prefetch_range(kFileSize, kFileSize - 1, &size));
+  EXPECT_FALSE(clamp_prefetch_range(kFileSize, kMaxOffset, &size));
+
+  // Ranges that start below the limit end at it.
+  size = 1024;
+  EXPECT_TRUE(clamp_prefetch_range(kFileSize, kMaxOffset - 16, &size));
+  EXPECT_EQ(size, 16);
+}
+
+TEST_F(FilePrefetchTest, IgnoresInvalidFiles) {
+  // Must not crash or block.
+  executorch::extension::internal::prefetch_file_range(
+      /*fd=*/-1,
+      /*file_name=*/"none",
+      /*file_size=*/256,
+      /*offset=*/kMaxOffset + 1,
+      /*size=*/16);
+}
@@ -9,6 +9,7 @@
 #include <executorch/extension/data_loader/mmap_data_loader.h>
 
 #include <cstring>
+#include <limits>
 
 #include <unistd.h>
 
@@ -20,6 +21,7 @@
 
 using namespace ::testing;
 using executorch::extension::MmapDataLoader;
+using executorch::extension::PagePolicy;
 using executorch::extension::testing::TempFile;
 using executorch::runtime::DataLoader;
 using executorch::runtime::Error;
@@ -317,6 +319,65 @@ TEST_F(MmapDataLoaderTest, OutOfBoundsLoadFails) {
   }
 }
 
+TEST_F(MmapDataLoaderTest, PrefetchDoesNotAffectLoads) {
+  const size_t contents_size = 4 * page_size_;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  for (size_t i = 0; i < contents_size; ++i) {
+    contents[i] = static_cast<uint8_t>(i);
+  }
+  TempFile tf(contents.get(), contents_size);
+
+  Result<MmapDataLoader> mdl = MmapDataLoader::from(
+      tf.path().c_str(), MmapDataLoader::MlockConfig::NoMlock);
+  ASSERT_EQ(mdl.error(), Error::Ok);
+
+  // Prefetching is only a hint; out-of-bounds ranges are ignored.
+  const DataLoader::SegmentInfo info(DataLoader::SegmentInfo::Type::Constant);
+  const size_t offset = page_size_ + 3;
+  const size_t size = page_size_;
+  mdl->prefetch(offset, size, info);
+  mdl->prefetch(/*offset=*/0, /*size=*/contents_size * 2, info);
+  mdl->prefetch(/*offset=*/contents_size + 1, /*size=*/1, info);
+  mdl->prefetch(
+      /*offset=*/static_cast<size_t>(std::numeric_limits<off_t>::max()) + 1,
+      /*size=*/1,
+      info);
+
+  Result<FreeableBuffer> fb = mdl->load(offset, size, info);
+  ASSERT_EQ(fb.error(), Error::Ok);
+  EXPECT_EQ(fb->size(), size);
+  EXPECT_EQ(0, std::memcmp(fb->data(), &contents[offset], fb->size()));
+}
+
+TEST_F(MmapDataLoaderTest, PagePolicyDoesNotAffectLoads) {
+  const size_t contents_size = 4 * page_size_;
+  auto contents = std::make_unique<uint8_t[]>(contents_size);
+  for (size_t i = 0; i < contents_size; ++i) {
+    contents[i] = static_cast<uint8_t>(i);
+  }
+  TempFile tf(contents.get(), contents_size);
+
+  // Explicit huge pages can't back a file mapping, so they fall back to
+  // transparent ones; neither makes loads fail.
+  for (auto huge_pages :
+       {PagePolicy::HugePages::Transparent,
+        PagePolicy::HugePages::Explicit}) {
+    PagePolicy policy;
+    policy.huge_pages = huge_pages;
+    Result<MmapDataLoader> mdl = MmapDataLoader::from(
+        tf.path().c_str(), MmapDataLoader::MlockConfig::NoMlock, policy);
+    ASSERT_EQ(mdl.error(), Error::Ok);
+
+    const size_t offset = page_size_ + 3;
+    Result<FreeableBuffer> fb = mdl->load(
+        offset,
+        page_size_,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+    ASSERT_EQ(fb.error(), Error::Ok);
+    EXPECT_EQ(0, std::memcmp(fb->data(), &contents[offset], fb->size()));
+  }
+}
+
 TEST_F(MmapDataLoaderTest, FromMissingFileFails) {
   // Wrapping a file that doesn't exist should fail.
   Result<MmapDataLoader> mdl = MmapDataLoader::from(
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/data_loader/shared_file_data_loader.h>
+
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/testing_util/temp_file.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+#include <executorch/test/utils/alignment.h>
+
+using namespace ::testing;
+using executorch::extension::SharedFileDataLoader;
+using executorch::extension::testing::TempFile;
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+
+class SharedFileDataLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+
+    for (size_t i = 0; i < sizeof(data_); ++i) {
+      data_[i] = i;
+    }
+  }
+
+  static DataLoader::SegmentInfo constant_info() {
+    return DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Constant);
+  }
+
+  uint8_t data_[256];
+};
+
+TEST_F(SharedFileDataLoaderTest, SharesSegmentsAcrossLoaders) {
+  TempFile tf(data_, sizeof(data_));
+  Result<SharedFileDataLoader> first =
+      SharedFileDataLoader::from(tf.path().c_str());
+  ASSERT_EQ(first.error(), Error::Ok);
+  Result<SharedFileDataLoader> second =
+      SharedFileDataLoader::from(tf.path().c_str());
+  ASSERT_EQ(second.error(), Error::Ok);
+  EXPECT_EQ(second->size().get(), sizeof(data_));
+
+  Result<FreeableBuffer> a = first->load(16, 64, constant_info());
+  ASSERT_EQ(a.error(), Error::Ok);
+  Result<FreeableBuffer> b = second->load(16, 64, constant_info());
+  ASSERT_EQ(b.error(), Error::Ok);
+  EXPECT_EQ(a->data(), b->data());
+  EXPECT_EQ(b->size(), 64);
+  EXPECT_EQ(std::memcmp(b->data(), data_ + 16, 64), 0);
+  EXPECT_EQ(first->num_loaded_segments(), 1);
+
+  // Another range is another segment.
+  Result<FreeableBuffer> c = second->load(0, 16, constant_info());
+  ASSERT_EQ(c.error(), Error::Ok);
+  EXPECT_NE(c->data(), a->data());
+  EXPECT_EQ(std::memcmp(c->data(), data_, 16), 0);
+  EXPECT_EQ(first->num_loaded_segments(), 2);
+
+  // A segment stays loaded until every buffer for it is freed.
+  a->Free();
+  EXPECT_EQ(std::memcmp(b->data(), data_ + 16, 64), 0);
+  EXPECT_EQ(first->num_loaded_segments(), 2);
+  b->Free();
+  c->Free();
+  EXPECT_EQ(first->num_loaded_segments(), 0);
+}
+
+TEST_F(SharedFileDataLoaderTest, BuffersOutliveLoaders) {
+  TempFile tf(data_, sizeof(data_));
+  std::optional<FreeableBuffer> buffer;
+  {
+    Result<SharedFileDataLoader> loader =
+        SharedFileDataLoader::from(tf.path().c_str(), /*alignment=*/64);
+    ASSERT_EQ(loader.error(), Error::Ok);
+    Result<FreeableBuffer> loaded = loader->load(8, 128, constant_info());
+    ASSERT_EQ(loaded.error(), Error::Ok);
+    buffer.emplace(std::move(*loaded));
+  }
+  EXPECT_ALIGNED(buffer->data(), 64);
+  EXPECT_EQ(std::memcmp(buffer->data(), data_ + 8, 128), 0);
+
+  // A new loader of the file shares the segment that is still in use.
+  Result<SharedFileDataLoader> loader =
+      SharedFileDataLoader::from(tf.path().c_str(), /*alignment=*/64);
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<FreeableBuffer> again = loader->load(8, 128, constant_info());
+  ASSERT_EQ(again.error(), Error::Ok);
+  EXPECT_EQ(again->data(), buffer->data());
+}
+
+TEST_F(SharedFileDataLoaderTest, DoesNotShareAcrossAlignmentsOrContents) {
+  TempFile tf(data_, sizeof(data_));
+  Result<SharedFileDataLoader> first =
+      SharedFileDataLoader::from(tf.path().c_str());
+  ASSERT_EQ(first.error(), Error::Ok);
+  Result<FreeableBuffer> a = first->load(0, 32, constant_info());
+  ASSERT_EQ(a.error(), Error::Ok);
+
+  Result<SharedFileDataLoader> aligned =
+      SharedFileDataLoader::from(tf.path().c_str(), /*alignment=*/256);
+  ASSERT_EQ(aligned.error(), Error::Ok);
+  Result<FreeableBuffer> b = aligned->load(0, 32, constant_info());
+  ASSERT_EQ(b.error(), Error::Ok);
+  EXPECT_NE(a->data(), b->data());
+  EXPECT_ALIGNED(b->data(), 256);
+
+  // Rewrite the file with other contents of another size.
+  {
+    std::ofstream file(tf.path(), std::ios::binary | std::ios::trunc);
+    const std::vector<char> contents(sizeof(data_) / 2, 'x');
+    file.write(contents.data(), contents.size());
+  }
+  Result<SharedFileDataLoader> rewritten =
+      SharedFileDataLoader::from(tf.path().c_str());
+  ASSERT_EQ(rewritten.error(), Error::Ok);
+  EXPECT_EQ(rewritten->size().get(), sizeof(data_) / 2);
+  Result<FreeableBuffer> c = rewritten->load(0, 32, constant_info());
+  ASSERT_EQ(c.error(), Error::Ok);
+  EXPECT_NE(c->data(), a->data());
+  EXPECT_EQ(static_cast<const char*>(c->data())[0], 'x');
+  // The buffers of the old contents are unchanged.
+  EXPECT_EQ(std::memcmp(a->data(), data_, 32), 0);
+}
+
+TEST_F(SharedFileDataLoaderTest, LoadIntoDoesNotShare) {
+  TempFile tf(data_, sizeof(data_));
+  Result<SharedFileDataLoader> loader =
+      SharedFileDataLoader::from(tf.path().c_str());
+  ASSERT_EQ(loader.error(), Error::Ok);
+
+  uint8_t buffer[32];
+  ASSERT_EQ(
+      loader->load_into(100, sizeof(buffer), constant_info(), buffer),
+      Error::Ok);
+  EXPECT_EQ(std::memcmp(buffer, data_ + 100, sizeof(buffer)), 0);
+  EXPECT_EQ(loader->num_loaded_segments(), 0);
+}
+
+TEST_F(SharedFileDataLoaderTest, ConcurrentLoadsShareOneSegment) {
+  TempFile tf(data_, sizeof(data_));
+  constexpr size_t kNumThreads = 8;
+  std::vector<const void*> pointers(kNumThreads);
+  std::vector<FreeableBuffer> buffers;
+  buffers.reserve(kNumThreads);
+  std::mutex mutex;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      Result<SharedFileDataLoader> loader =
+          SharedFileDataLoader::from(tf.path().c_str());
+      ASSERT_EQ(loader.error(), Error::Ok);
+      Result<FreeableBuffer> buffer = loader->load(32, 128, constant_info());
+      ASSERT_EQ(buffer.error(), Error::Ok);
+      pointers[i] = buffer->data();
+      std::lock_guard<std::mutex> lock(mutex);
+      buffers.push_back(std::move(*buffer));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 1; i < kNumThreads; ++i) {
+    EXPECT_EQ(pointers[i], pointers[0]);
+  }
+  EXPECT_EQ(std::memcmp(pointers[0], data_ + 32, 128), 0);
+}
+
+TEST_F(SharedFileDataLoaderTest, FromMissingFileFails) {
+  Result<SharedFileDataLoader> loader =
+      SharedFileDataLoader::from("/path/to/nonexistent/file");
+  EXPECT_EQ(loader.error(), Error::AccessFailed);
+}
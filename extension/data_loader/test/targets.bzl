@@ -38,6 +38,17 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "shared_file_data_loader_test",
+        srcs = [
+            "shared_file_data_loader_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/testing_util:temp_file",
+            "//executorch/extension/data_loader:shared_file_data_loader",
+        ],
+    )
+
     runtime.cxx_test(
         name = "file_descriptor_data_loader_test",
         srcs = [
@@ -49,6 +60,16 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "file_prefetch_test",
+        srcs = [
+            "file_prefetch_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:file_prefetch",
+        ],
+    )
+
     runtime.cxx_test(
         name = "mmap_data_loader_test",
         srcs = [
@@ -59,3 +80,14 @@ def define_common_targets():
             "//executorch/extension/data_loader:mmap_data_loader",
         ],
     )
+
+    runtime.cxx_test(
+        name = "decompressing_data_loader_test",
+        srcs = [
+            "decompressing_data_loader_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/data_loader:buffer_data_loader",
+            "//executorch/extension/data_loader:decompressing_data_loader",
+        ],
+    )
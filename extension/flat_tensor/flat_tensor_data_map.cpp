@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstddef>
+#include <cstring>
+
+#include <executorch/extension/flat_tensor/flat_tensor_generated.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/assert.h>
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::DataLoader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+using executorch::runtime::TensorLayout;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+/**
+ * FlatTensor data must be aligned to this value to properly parse it. Must be
+ * a power of 2. Note that max_align_t is the alignment that malloc() and new
+ * guarantee.
+ */
+constexpr size_t kMinimumAlignment = alignof(std::max_align_t);
+
+bool is_aligned(const void* data) {
+  uintptr_t addr = reinterpret_cast<uintptr_t>(data);
+  return addr % kMinimumAlignment == 0;
+}
+
+Result<const flat_tensor::TensorMetadata*> get_tensor_metadata(
+    const char* key,
+    const flatbuffers::Vector<
+        flatbuffers::Offset<flat_tensor::TensorMetadata>>* tensors) {
+  ET_CHECK_OR_RETURN_ERROR(key != nullptr, InvalidArgument, "Null key");
+  if (tensors == nullptr) {
+    return Error::NotFound;
+  }
+  for (size_t i = 0; i < tensors->size(); i++) {
+    const auto* fqn = tensors->Get(i)->fully_qualified_name();
+    if (fqn != nullptr && std::strcmp(fqn->c_str(), key) == 0) {
+      return tensors->Get(i);
+    }
+  }
+  return Error::NotFound;
+}
+
+Result<TensorLayout> create_tensor_layout(
+    const flat_tensor::TensorMetadata* tensor_metadata) {
+  const auto* sizes = tensor_metadata->dim_sizes();
+  const auto* dim_order = tensor_metadata->dim_order();
+  // Scalars have no sizes or dim order.
+  return TensorLayout::create(
+      sizes == nullptr ? Span<const int32_t>()
+                       : Span<const int32_t>(sizes->data(), sizes->size()),
+      dim_order == nullptr
+          ? Span<const uint8_t>()
+          : Span<const uint8_t>(dim_order->data(), dim_order->size()),
+      static_cast<executorch::aten::ScalarType>(
+          tensor_metadata->scalar_type()));
+}
+
+} // namespace
+
+Result<FlatTensorDataMap::TensorData> FlatTensorDataMap::find_data(
+    const char* key) const {
+  Result<const flat_tensor::TensorMetadata*> metadata =
+      get_tensor_metadata(key, flat_tensor_->tensors());
+  if (!metadata.ok()) {
+    return metadata.error();
+  }
+  Result<TensorLayout> layout = create_tensor_layout(metadata.get());
+  if (!layout.ok()) {
+    return layout.error();
+  }
+
+  const uint32_t segment_index = metadata.get()->segment_index();
+  const auto* segments = flat_tensor_->segments();
+  ET_CHECK_OR_RETURN_ERROR(
+      segments != nullptr && segment_index < segments->size(),
+      InvalidExternalData,
+      "Tensor '%s' has segment index %" PRIu32 " but there are %" PRIu32
+      " segments",
+      key,
+      segment_index,
+      segments == nullptr ? 0 : segments->size());
+  const auto* segment = segments->Get(segment_index);
+
+  // Make sure that the tensor lies within its segment, and the segment within
+  // the segment data described by the header.
+  const uint64_t tensor_offset = metadata.get()->offset();
+  const uint64_t tensor_size = layout->nbytes();
+  ET_CHECK_OR_RETURN_ERROR(
+      tensor_offset <= segment->size() &&
+          tensor_size <= segment->size() - tensor_offset,
+      InvalidExternalData,
+      "Tensor '%s' at offset %" PRIu64 " of size %" PRIu64
+      " is out of bounds of segment %" PRIu32 " of size %" PRIu64,
+      key,
+      tensor_offset,
+      tensor_size,
+      segment_index,
+      segment->size());
+  ET_CHECK_OR_RETURN_ERROR(
+      segment->offset() <= header_.segment_data_size &&
+          segment->size() <= header_.segment_data_size - segment->offset(),
+      InvalidExternalData,
+      "Segment %" PRIu32 " at offset %" PRIu64 " of size %" PRIu64
+      " is out of bounds of the segment data of size %" PRIu64,
+      segment_index,
+      segment->offset(),
+      segment->size(),
+      header_.segment_data_size);
+
+  return TensorData{
+      /*offset=*/static_cast<size_t>(
+          header_.segment_base_offset + segment->offset() + tensor_offset),
+      /*size=*/static_cast<size_t>(tensor_size),
+      /*segment_index=*/segment_index,
+  };
+}
+
+ET_NODISCARD Result<TensorLayout> FlatTensorDataMap::get_metadata(
+    const char* key) const {
+  Result<const flat_tensor::TensorMetadata*> metadata =
+      get_tensor_metadata(key, flat_tensor_->tensors());
+  if (!metadata.ok()) {
+    return metadata.error();
+  }
+  return create_tensor_layout(metadata.get());
+}
+
+ET_NODISCARD Result<FreeableBuffer> FlatTensorDataMap::get_data(
+    const char* key) const {
+  Result<TensorData> tensor_data = find_data(key);
+  if (!tensor_data.ok()) {
+    return tensor_data.error();
+  }
+  return loader_->load(
+      tensor_data->offset,
+      tensor_data->size,
+      DataLoader::SegmentInfo(
+          DataLoader::SegmentInfo::Type::External, tensor_data->segment_index));
+}
+
+ET_NODISCARD Result<size_t> FlatTensorDataMap::load_data_into(
+    const char* key,
+    void* buffer,
+    size_t size) const {
+  Result<TensorData> tensor_data = find_data(key);
+  if (!tensor_data.ok()) {
+    return tensor_data.error();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      size >= tensor_data->size,
+      InvalidArgument,
+      "Buffer of size %zu is too small for tensor '%s' of size %zu",
+      size,
+      key,
+      tensor_data->size);
+  const DataLoader::SegmentInfo segment_info(
+      DataLoader::SegmentInfo::Type::External, tensor_data->segment_index);
+  Error err = loader_->load_into(
+      tensor_data->offset, tensor_data->size, segment_info, buffer);
+  if (err == Error::NotImplemented) {
+    // Not every loader can read into a caller-provided buffer; fall back to
+    // loading the data and copying it.
+    Result<FreeableBuffer> data =
+        loader_->load(tensor_data->offset, tensor_data->size, segment_info);
+    if (!data.ok()) {
+      return data.error();
+    }
+    std::memcpy(buffer, data->data(), tensor_data->size);
+    data->Free();
+    err = Error::Ok;
+  }
+  if (err != Error::Ok) {
+    return err;
+  }
+  return tensor_data->size;
+}
+
+ET_NODISCARD Result<size_t> FlatTensorDataMap::get_num_keys() const {
+  const auto* tensors = flat_tensor_->tensors();
+  return tensors == nullptr ? 0 : tensors->size();
+}
+
+ET_NODISCARD Result<const char*> FlatTensorDataMap::get_key(
+    size_t index) const {
+  const auto* tensors = flat_tensor_->tensors();
+  ET_CHECK_OR_RETURN_ERROR(
+      tensors != nullptr && index < tensors->size(),
+      InvalidArgument,
+      "Index %zu out of range of %" PRIu32 " keys",
+      index,
+      tensors == nullptr ? 0 : tensors->size());
+  const auto* fqn = tensors->Get(index)->fully_qualified_name();
+  ET_CHECK_OR_RETURN_ERROR(
+      fqn != nullptr,
+      InvalidExternalData,
+      "Tensor %zu has no fully qualified name",
+      index);
+  return fqn->c_str();
+}
+
+/* static */ Result<FlatTensorDataMap> FlatTensorDataMap::load(
+    DataLoader* loader) {
+  ET_CHECK_OR_RETURN_ERROR(
+      loader != nullptr, InvalidArgument, "Null data loader");
+
+  // Load the header. Files smaller than the header are handled by Parse().
+  Result<size_t> file_size = loader->size();
+  if (!file_size.ok()) {
+    return file_size.error();
+  }
+  size_t head_size =
+      std::min(file_size.get(), FlatTensorHeader::kNumHeadBytes);
+  Result<FreeableBuffer> header_data = loader->load(
+      /*offset=*/0,
+      head_size,
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External));
+  if (!header_data.ok()) {
+    return header_data.error();
+  }
+  Result<FlatTensorHeader> header =
+      FlatTensorHeader::Parse(header_data->data(), header_data->size());
+  header_data->Free();
+  if (header.error() == Error::NotFound) {
+    ET_LOG(Error, "Data does not start with a FlatTensor header");
+    return Error::InvalidExternalData;
+  }
+  if (!header.ok()) {
+    return header.error();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      header->segment_base_offset + header->segment_data_size <=
+          file_size.get(),
+      InvalidExternalData,
+      "FlatTensor segments end at %" PRIu64 " but the file is %zu bytes",
+      header->segment_base_offset + header->segment_data_size,
+      file_size.get());
+
+  // Load the flatbuffer, which describes the tensors.
+  Result<FreeableBuffer> flat_tensor_data = loader->load(
+      static_cast<size_t>(header->flatbuffer_offset),
+      static_cast<size_t>(header->flatbuffer_size),
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External));
+  if (!flat_tensor_data.ok()) {
+    return flat_tensor_data.error();
+  }
+
+  ET_CHECK_OR_RETURN_ERROR(
+      flat_tensor_data->size() >= 8 &&
+          flat_tensor::FlatTensorBufferHasIdentifier(flat_tensor_data->data()),
+      InvalidExternalData,
+      "FlatTensor identifier '%.4s' != expected '%.4s'",
+      flat_tensor_data->size() >= 8
+          ? flatbuffers::GetBufferIdentifier(flat_tensor_data->data())
+          : "",
+      flat_tensor::FlatTensorIdentifier());
+
+  // The flatbuffer data must start at an aligned address to ensure internal
+  // alignment of flatbuffer fields.
+  ET_CHECK_OR_RETURN_ERROR(
+      is_aligned(flat_tensor_data->data()),
+      InvalidArgument,
+      "FlatTensor data 0x%p must be aligned to %zu",
+      flat_tensor_data->data(),
+      kMinimumAlignment);
+
+  // The flatbuffer comes from outside the program, so always make sure that
+  // it is well-formed before trusting its offsets.
+  flatbuffers::Verifier verifier(
+      reinterpret_cast<const uint8_t*>(flat_tensor_data->data()),
+      flat_tensor_data->size());
+  ET_CHECK_OR_RETURN_ERROR(
+      flat_tensor::VerifyFlatTensorBuffer(verifier),
+      InvalidExternalData,
+      "FlatTensor verification failed; data may be truncated or corrupt");
+
+  const flat_tensor::FlatTensor* flat_tensor =
+      flat_tensor::GetFlatTensor(flat_tensor_data->data());
+
+  return FlatTensorDataMap(
+      header.get(), std::move(flat_tensor_data.get()), flat_tensor, loader);
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/extension/flat_tensor/flat_tensor_header.h>
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/named_data_map.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/tensor_layout.h>
+#include <executorch/runtime/platform/compiler.h>
+
+// Forward declare flatbuffer types. This is a public header and must not
+// include the generated flatbuffer header.
+namespace flat_tensor {
+struct FlatTensor;
+} // namespace flat_tensor
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A NamedDataMap that reads the tensors of a FlatTensor (.ptd) file through a
+ * DataLoader.
+ *
+ * Only the header and the flatbuffer, which describe the tensors, are read
+ * when loading. The data of a tensor is only read when get_data() or
+ * load_data_into() asks for it. With an MmapDataLoader, get_data() returns
+ * pointers into a read-only mapping of the file, so that several programs,
+ * and several processes, using the same file share its pages in the page
+ * cache instead of each holding a copy of the weights.
+ */
+class FlatTensorDataMap final
+    : public executorch::runtime::NamedDataMap {
+ public:
+  /**
+   * Creates a new FlatTensorDataMap.
+   *
+   * @param[in] loader The source of the FlatTensor file. Must outlive the
+   *     FlatTensorDataMap and any data that it returns.
+   * @returns A new FlatTensorDataMap, or an error if the file is not a valid
+   *     FlatTensor file.
+   */
+  static executorch::runtime::Result<FlatTensorDataMap> load(
+      executorch::runtime::DataLoader* loader);
+
+  ET_NODISCARD executorch::runtime::Result<executorch::runtime::TensorLayout>
+  get_metadata(const char* key) const override;
+  ET_NODISCARD
+  executorch::runtime::Result<executorch::runtime::FreeableBuffer> get_data(
+      const char* key) const override;
+  ET_NODISCARD executorch::runtime::Result<size_t>
+  load_data_into(const char* key, void* buffer, size_t size) const override;
+
+  ET_NODISCARD executorch::runtime::Result<size_t> get_num_keys()
+      const override;
+  ET_NODISCARD executorch::runtime::Result<const char*> get_key(
+      size_t index) const override;
+
+  FlatTensorDataMap(FlatTensorDataMap&&) noexcept = default;
+
+  ~FlatTensorDataMap() override = default;
+
+ private:
+  FlatTensorDataMap(
+      const FlatTensorHeader& header,
+      executorch::runtime::FreeableBuffer&& flat_tensor_data,
+      const flat_tensor::FlatTensor* flat_tensor,
+      executorch::runtime::DataLoader* loader)
+      : header_(header),
+        flat_tensor_data_(std::move(flat_tensor_data)),
+        flat_tensor_(flat_tensor),
+        loader_(loader) {}
+
+  // Not copyable or assignable.
+  FlatTensorDataMap(const FlatTensorDataMap& rhs) = delete;
+  FlatTensorDataMap& operator=(FlatTensorDataMap&& rhs) noexcept = delete;
+  FlatTensorDataMap& operator=(const FlatTensorDataMap& rhs) = delete;
+
+  // The location of the data of a tensor in the file.
+  struct TensorData {
+    size_t offset;
+    size_t size;
+    size_t segment_index;
+  };
+
+  // Finds the data of the tensor with the given key.
+  executorch::runtime::Result<TensorData> find_data(const char* key) const;
+
+  // Header of the file.
+  FlatTensorHeader header_;
+
+  // Serialized flat_tensor flatbuffer data.
+  executorch::runtime::FreeableBuffer flat_tensor_data_;
+
+  // The root of the flatbuffer, which points into flat_tensor_data_.
+  const flat_tensor::FlatTensor* flat_tensor_;
+
+  // Loader for the file, to read the tensor data with.
+  executorch::runtime::DataLoader* loader_;
+};
+
+} // namespace extension
+} // namespace executorch
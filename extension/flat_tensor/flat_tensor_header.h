@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * The header at the beginning of a FlatTensor (.ptd) file. It locates the
+ * FlatTensor flatbuffer, which describes the tensors, and the segment data
+ * that holds their contents:
+ *
+ * - [0, header length): This header, padded to the tensor alignment.
+ * - [flatbuffer_offset, +flatbuffer_size): The FlatTensor flatbuffer.
+ * - [segment_base_offset, +segment_data_size): The segments, each of which
+ *   is aligned so that it can be mmap()ed.
+ *
+ * All fields are little-endian.
+ */
+struct FlatTensorHeader {
+  /**
+   * To find the header, callers should provide at least this many bytes of the
+   * head of the file, or the whole file if it is smaller.
+   */
+  static constexpr size_t kNumHeadBytes = 64;
+
+  /**
+   * The magic bytes that identify the header.
+   *
+   * This is the canonical definition of the expected value. If the header
+   * layout ever changes in a compatibility-breaking way, increment the digits
+   * in the magic. The compatibility-preserving way to make changes is to
+   * increase the header's length field and add new fields at the end.
+   */
+  static constexpr size_t kMagicSize = 4;
+  static constexpr char kMagic[kMagicSize] = {'F', 'H', '0', '1'};
+
+  /**
+   * Look for and parse a FlatTensorHeader in the provided data.
+   *
+   * @param[in] data The contents of the beginning of the file, starting at
+   *     offset 0.
+   * @param[in] size Length of `data` in bytes.
+   *
+   * @returns a FlatTensorHeader if the header was found and is valid. Returns
+   *     NotFound if the data does not start with the header magic, and
+   *     InvalidExternalData if the header is too short or appears to be
+   *     corrupt.
+   */
+  static runtime::Result<FlatTensorHeader> Parse(const void* data, size_t size);
+
+  /// Offset in bytes of the FlatTensor flatbuffer from the start of the file.
+  uint64_t flatbuffer_offset;
+
+  /// Size in bytes of the FlatTensor flatbuffer.
+  uint64_t flatbuffer_size;
+
+  /// Offset in bytes of the first segment from the start of the file.
+  uint64_t segment_base_offset;
+
+  /// Size in bytes of all of the segments, including padding between them.
+  uint64_t segment_data_size;
+};
+
+} // namespace extension
+} // namespace executorch
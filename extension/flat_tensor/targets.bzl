@@ -0,0 +1,116 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+FLAT_TENSOR_STEM = "flat_tensor"
+SCALAR_TYPE_STEM = "scalar_type"
+
+INPUT_FLAT_TENSOR = FLAT_TENSOR_STEM + ".fbs"
+INPUT_SCALAR_TYPE = SCALAR_TYPE_STEM + ".fbs"
+
+OUTPUT_FLAT_TENSOR_HEADER = FLAT_TENSOR_STEM + "_generated.h"
+OUTPUT_SCALAR_TYPE_HEADER = SCALAR_TYPE_STEM + "_generated.h"
+
+FLAT_TENSOR_GEN_RULE_NAME = "generate_flat_tensor"
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.export_file(
+        name = INPUT_FLAT_TENSOR,
+        visibility = [
+            "//executorch/extension/flat_tensor/...",
+        ],
+    )
+    runtime.export_file(
+        name = INPUT_SCALAR_TYPE,
+        visibility = [
+            "//executorch/extension/flat_tensor/...",
+        ],
+    )
+
+    runtime.genrule(
+        name = FLAT_TENSOR_GEN_RULE_NAME,
+        srcs = [INPUT_FLAT_TENSOR, INPUT_SCALAR_TYPE],
+        # flatc takes a directory as a parameter, not a single file. Use `outs`
+        # so that `${OUT}` is expanded as the containing directory.
+        outs = {
+            header: [header]
+            for header in [OUTPUT_FLAT_TENSOR_HEADER, OUTPUT_SCALAR_TYPE_HEADER]
+        },
+        default_outs = [OUTPUT_FLAT_TENSOR_HEADER],
+        cmd = " ".join([
+            "$(exe {})".format(runtime.external_dep_location("flatc")),
+            "--cpp",
+            "--cpp-std c++11",
+            "--gen-mutable",
+            "--scoped-enums",
+            "-o ${OUT}",
+            "${SRCS}",
+            # Let our infra know that the file was generated.
+            " ".join([
+                "&& echo // @" + "generated >> ${OUT}/" + header
+                for header in [OUTPUT_FLAT_TENSOR_HEADER, OUTPUT_SCALAR_TYPE_HEADER]
+            ]),
+        ]),
+        visibility = [],  # Private
+    )
+
+    # Header-only library with the generated flat_tensor schema headers.
+    runtime.cxx_library(
+        name = FLAT_TENSOR_STEM,
+        srcs = [],
+        visibility = [
+            # Keep flatbuffers an implementation detail of the data map.
+            "//executorch/extension/flat_tensor/...",
+        ],
+        exported_headers = {
+            OUTPUT_FLAT_TENSOR_HEADER: ":{}[{}]".format(FLAT_TENSOR_GEN_RULE_NAME, OUTPUT_FLAT_TENSOR_HEADER),
+            OUTPUT_SCALAR_TYPE_HEADER: ":{}[{}]".format(FLAT_TENSOR_GEN_RULE_NAME, OUTPUT_SCALAR_TYPE_HEADER),
+        },
+        exported_external_deps = ["flatbuffers-api"],
+    )
+
+    runtime.cxx_library(
+        name = "flat_tensor_header",
+        srcs = ["flat_tensor_header.cpp"],
+        exported_headers = ["flat_tensor_header.h"],
+        visibility = [
+            "//executorch/extension/flat_tensor/...",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "flat_tensor_data_map",
+        srcs = ["flat_tensor_data_map.cpp"],
+        exported_headers = ["flat_tensor_data_map.h"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        deps = [
+            ":" + FLAT_TENSOR_STEM,
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+        exported_deps = [
+            ":flat_tensor_header",
+            "//executorch/runtime/core:core",
+            "//executorch/runtime/core:named_data_map",
+            "//executorch/runtime/core:tensor_layout",
+        ],
+    )
+
+    runtime.python_library(
+        name = "flat_tensor_schema",
+        srcs = ["flat_tensor_schema.py"],
+        visibility = [
+            "//executorch/...",
+        ],
+        deps = [
+            "//executorch/exir:scalar_type",
+        ],
+    )
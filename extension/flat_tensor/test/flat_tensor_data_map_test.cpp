@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/data_loader/buffer_data_loader.h>
+#include <executorch/extension/flat_tensor/flat_tensor_generated.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::extension::BufferDataLoader;
+using executorch::extension::FlatTensorDataMap;
+using executorch::extension::FlatTensorHeader;
+using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::Result;
+using executorch::runtime::TensorLayout;
+
+namespace {
+
+constexpr size_t kHeaderLength = 40;
+constexpr size_t kAlignment = 16;
+
+size_t align(size_t value) {
+  return (value + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+void put_le(std::vector<uint8_t>& data, size_t offset, uint64_t value, int n) {
+  for (int i = 0; i < n; i++) {
+    data[offset + i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+/**
+ * Serializes a FlatTensor file with a 2x2 float tensor "a" and a 3 element int
+ * tensor "b", both stored in segment 0.
+ */
+std::vector<uint8_t> make_flat_tensor_file(
+    uint64_t b_offset = 16,
+    uint64_t segment_size = 32) {
+  flatbuffers::FlatBufferBuilder builder;
+  const std::vector<int32_t> a_sizes = {2, 2};
+  const std::vector<uint8_t> a_dim_order = {0, 1};
+  const std::vector<int32_t> b_sizes = {3};
+  const std::vector<uint8_t> b_dim_order = {0};
+  std::vector<flatbuffers::Offset<flat_tensor::TensorMetadata>> tensors = {
+      flat_tensor::CreateTensorMetadataDirect(
+          builder,
+          "a",
+          executorch_flatbuffer::ScalarType::FLOAT,
+          &a_sizes,
+          &a_dim_order,
+          /*segment_index=*/0,
+          /*offset=*/0),
+      flat_tensor::CreateTensorMetadataDirect(
+          builder,
+          "b",
+          executorch_flatbuffer::ScalarType::INT,
+          &b_sizes,
+          &b_dim_order,
+          /*segment_index=*/0,
+          /*offset=*/b_offset),
+  };
+  std::vector<flatbuffers::Offset<flat_tensor::DataSegment>> segments = {
+      flat_tensor::CreateDataSegment(builder, /*offset=*/0, segment_size),
+  };
+  builder.Finish(
+      flat_tensor::CreateFlatTensorDirect(
+          builder,
+          /*version=*/0,
+          /*tensor_alignment=*/kAlignment,
+          &tensors,
+          &segments),
+      flat_tensor::FlatTensorIdentifier());
+
+  const size_t flatbuffer_offset = align(kHeaderLength);
+  const size_t segment_base_offset =
+      align(flatbuffer_offset + builder.GetSize());
+  std::vector<uint8_t> data(segment_base_offset + segment_size);
+
+  std::memcpy(
+      data.data(), FlatTensorHeader::kMagic, FlatTensorHeader::kMagicSize);
+  put_le(data, 4, kHeaderLength, 4);
+  put_le(data, 8, flatbuffer_offset, 8);
+  put_le(data, 16, builder.GetSize(), 8);
+  put_le(data, 24, segment_base_offset, 8);
+  put_le(data, 32, segment_size, 8);
+  std::memcpy(
+      data.data() + flatbuffer_offset,
+      builder.GetBufferPointer(),
+      builder.GetSize());
+
+  const float a[] = {1.0f, 2.0f, 3.0f, 4.0f};
+  std::memcpy(data.data() + segment_base_offset, a, sizeof(a));
+  if (b_offset + 3 * sizeof(int32_t) <= segment_size) {
+    const int32_t b[] = {5, 6, 7};
+    std::memcpy(data.data() + segment_base_offset + b_offset, b, sizeof(b));
+  }
+  return data;
+}
+
+} // namespace
+
+class FlatTensorDataMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+    data_ = make_flat_tensor_file();
+    loader_ = std::make_unique<BufferDataLoader>(data_.data(), data_.size());
+  }
+
+  std::vector<uint8_t> data_;
+  std::unique_ptr<BufferDataLoader> loader_;
+};
+
+TEST_F(FlatTensorDataMapTest, GetMetadata) {
+  Result<FlatTensorDataMap> data_map = FlatTensorDataMap::load(loader_.get());
+  ASSERT_EQ(data_map.error(), Error::Ok);
+
+  Result<TensorLayout> a = data_map->get_metadata("a");
+  ASSERT_EQ(a.error(), Error::Ok);
+  EXPECT_EQ(a->scalar_type(), ScalarType::Float);
+  ASSERT_EQ(a->sizes().size(), 2);
+  EXPECT_EQ(a->sizes()[0], 2);
+  EXPECT_EQ(a->sizes()[1], 2);
+  EXPECT_EQ(a->dim_order()[1], 1);
+  EXPECT_EQ(a->nbytes(), 16);
+
+  Result<TensorLayout> b = data_map->get_metadata("b");
+  ASSERT_EQ(b.error(), Error::Ok);
+  EXPECT_EQ(b->scalar_type(), ScalarType::Int);
+  EXPECT_EQ(b->nbytes(), 12);
+
+  EXPECT_EQ(data_map->get_metadata("c").error(), Error::NotFound);
+}
+
+TEST_F(FlatTensorDataMapTest, GetData) {
+  Result<FlatTensorDataMap> data_map = FlatTensorDataMap::load(loader_.get());
+  ASSERT_EQ(data_map.error(), Error::Ok);
+
+  Result<FreeableBuffer> a = data_map->get_data("a");
+  ASSERT_EQ(a.error(), Error::Ok);
+  ASSERT_EQ(a->size(), 16);
+  const float* a_data = static_cast<const float*>(a->data());
+  EXPECT_EQ(a_data[0], 1.0f);
+  EXPECT_EQ(a_data[3], 4.0f);
+
+  Result<FreeableBuffer> b = data_map->get_data("b");
+  ASSERT_EQ(b.error(), Error::Ok);
+  ASSERT_EQ(b->size(), 12);
+  EXPECT_EQ(static_cast<const int32_t*>(b->data())[2], 7);
+
+  EXPECT_EQ(data_map->get_data("c").error(), Error::NotFound);
+}
+
+TEST_F(FlatTensorDataMapTest, LoadDataInto) {
+  Result<FlatTensorDataMap> data_map = FlatTensorDataMap::load(loader_.get());
+  ASSERT_EQ(data_map.error(), Error::Ok);
+
+  int32_t b[3] = {};
+  Result<size_t> size = data_map->load_data_into("b", b, sizeof(b));
+  ASSERT_EQ(size.error(), Error::Ok);
+  EXPECT_EQ(size.get(), sizeof(b));
+  EXPECT_EQ(b[0], 5);
+  EXPECT_EQ(b[2], 7);
+
+  // The buffer must be large enough for the whole tensor.
+  EXPECT_EQ(
+      data_map->load_data_into("b", b, sizeof(b) - 1).error(),
+      Error::InvalidArgument);
+}
+
+TEST_F(FlatTensorDataMapTest, Keys) {
+  Result<FlatTensorDataMap> data_map = FlatTensorDataMap::load(loader_.get());
+  ASSERT_EQ(data_map.error(), Error::Ok);
+
+  Result<size_t> num_keys = data_map->get_num_keys();
+  ASSERT_EQ(num_keys.error(), Error::Ok);
+  EXPECT_EQ(num_keys.get(), 2);
+  EXPECT_STREQ(data_map->get_key(0).get(), "a");
+  EXPECT_STREQ(data_map->get_key(1).get(), "b");
+  EXPECT_EQ(data_map->get_key(2).error(), Error::InvalidArgument);
+}
+
+TEST_F(FlatTensorDataMapTest, NonFlatTensorDataFails) {
+  data_[0] = 'X';
+  EXPECT_EQ(
+      FlatTensorDataMap::load(loader_.get()).error(),
+      Error::InvalidExternalData);
+}
+
+TEST_F(FlatTensorDataMapTest, TruncatedFileFails) {
+  BufferDataLoader loader(data_.data(), data_.size() - 1);
+  EXPECT_EQ(
+      FlatTensorDataMap::load(&loader).error(), Error::InvalidExternalData);
+}
+
+TEST_F(FlatTensorDataMapTest, TensorOutsideOfSegmentFails) {
+  // Tensor "b" ends past the end of its segment.
+  std::vector<uint8_t> data =
+      make_flat_tensor_file(/*b_offset=*/24, /*segment_size=*/32);
+  BufferDataLoader loader(data.data(), data.size());
+  Result<FlatTensorDataMap> data_map = FlatTensorDataMap::load(&loader);
+  ASSERT_EQ(data_map.error(), Error::Ok);
+
+  EXPECT_EQ(data_map->get_data("a").error(), Error::Ok);
+  EXPECT_EQ(data_map->get_data("b").error(), Error::InvalidExternalData);
+}
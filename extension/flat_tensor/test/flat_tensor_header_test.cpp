@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/flat_tensor/flat_tensor_header.h>
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using executorch::extension::FlatTensorHeader;
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+
+class FlatTensorHeaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+/**
+ * An example, valid header.
+ *
+ * This data is intentionally fragile. If the header layout or magic changes,
+ * this test data must change too. The layout of the header is a contract, not
+ * an implementation detail.
+ */
+// clang-format off
+constexpr uint8_t kExampleHeaderData[] = {
+  // Magic bytes
+  'F', 'H', '0', '1',
+  // uint32_t header size (little endian)
+  0x28, 0x00, 0x00, 0x00,
+  // uint64_t flatbuffer offset
+  0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  // uint64_t flatbuffer size
+  0x10, 0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  // uint64_t segment base offset
+  0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  // uint64_t segment data size
+  0x20, 0x43, 0x65, 0x87, 0x01, 0x00, 0x00, 0x00,
+};
+// clang-format on
+
+constexpr uint64_t kExampleFlatbufferOffset = 0x40;
+constexpr uint64_t kExampleFlatbufferSize = 0x3210;
+constexpr uint64_t kExampleSegmentBaseOffset = 0x4000;
+constexpr uint64_t kExampleSegmentDataSize = 0x187654320;
+
+/// The offset to the header's length field, which is in the 4 bytes after the
+/// magic.
+constexpr size_t kHeaderLengthOffset = FlatTensorHeader::kMagicSize;
+
+/**
+ * Returns fake file head data that starts with kExampleHeaderData.
+ */
+std::vector<uint8_t> CreateExampleHead() {
+  std::vector<uint8_t> ret(FlatTensorHeader::kNumHeadBytes);
+  // Write non-zeros into it to make it more obvious if we read outside the
+  // header.
+  memset(ret.data(), 0x55, ret.size());
+  memcpy(ret.data(), kExampleHeaderData, sizeof(kExampleHeaderData));
+  return ret;
+}
+
+TEST_F(FlatTensorHeaderTest, ValidHeaderParsesCorrectly) {
+  std::vector<uint8_t> head = CreateExampleHead();
+
+  Result<FlatTensorHeader> header =
+      FlatTensorHeader::Parse(head.data(), head.size());
+
+  ASSERT_EQ(header.error(), Error::Ok);
+  EXPECT_EQ(header->flatbuffer_offset, kExampleFlatbufferOffset);
+  EXPECT_EQ(header->flatbuffer_size, kExampleFlatbufferSize);
+  EXPECT_EQ(header->segment_base_offset, kExampleSegmentBaseOffset);
+  EXPECT_EQ(header->segment_data_size, kExampleSegmentDataSize);
+}
+
+TEST_F(FlatTensorHeaderTest, LongerHeaderParsesCorrectly) {
+  std::vector<uint8_t> head = CreateExampleHead();
+  // Newer versions may add fields at the end of the header, which this
+  // version ignores.
+  head[kHeaderLengthOffset] = 0x30;
+
+  Result<FlatTensorHeader> header =
+      FlatTensorHeader::Parse(head.data(), head.size());
+
+  ASSERT_EQ(header.error(), Error::Ok);
+  EXPECT_EQ(header->flatbuffer_offset, kExampleFlatbufferOffset);
+  EXPECT_EQ(header->segment_data_size, kExampleSegmentDataSize);
+}
+
+TEST_F(FlatTensorHeaderTest, BadMagicIsNotFound) {
+  std::vector<uint8_t> head = CreateExampleHead();
+  head[3] = '2';
+
+  Result<FlatTensorHeader> header =
+      FlatTensorHeader::Parse(head.data(), head.size());
+
+  EXPECT_EQ(header.error(), Error::NotFound);
+}
+
+TEST_F(FlatTensorHeaderTest, TooShortDataIsNotFoundOrInvalid) {
+  std::vector<uint8_t> head = CreateExampleHead();
+
+  // Too short to hold the magic.
+  EXPECT_EQ(
+      FlatTensorHeader::Parse(head.data(), FlatTensorHeader::kMagicSize - 1)
+          .error(),
+      Error::NotFound);
+
+  // Has the magic, but not the rest of the header.
+  EXPECT_EQ(
+      FlatTensorHeader::Parse(head.data(), sizeof(kExampleHeaderData) - 1)
+          .error(),
+      Error::InvalidExternalData);
+}
+
+TEST_F(FlatTensorHeaderTest, ShortHeaderLengthIsInvalid) {
+  std::vector<uint8_t> head = CreateExampleHead();
+  head[kHeaderLengthOffset] = 0x20;
+
+  Result<FlatTensorHeader> header =
+      FlatTensorHeader::Parse(head.data(), head.size());
+
+  EXPECT_EQ(header.error(), Error::InvalidExternalData);
+}
+
+TEST_F(FlatTensorHeaderTest, OverlappingRegionsAreInvalid) {
+  std::vector<uint8_t> head = CreateExampleHead();
+  // Move the segments to 0x3000, before the end of the flatbuffer.
+  head[25] = 0x30;
+
+  Result<FlatTensorHeader> header =
+      FlatTensorHeader::Parse(head.data(), head.size());
+
+  EXPECT_EQ(header.error(), Error::InvalidExternalData);
+}
@@ -45,9 +45,17 @@
 #include <executorch/runtime/kernel/operator_registry.h>
 #include <cstdlib>
 #include <memory>
+#include <new>
+#include <tuple>
 #include <type_traits>
 #include <typeinfo>
 
+#ifdef EXECUTORCH_SELECTIVE_BUILD_OPS
+// include header generated by
+// executorch/codegen/tools/gen_selected_op_variants.py
+#include <executorch/extension/kernel_util/selected_operators.h>
+#endif
+
 namespace executorch {
 namespace runtime {
 class KernelRuntimeContext; // Forward declaration
@@ -111,6 +119,80 @@ struct evalue_to_arg<executorch::aten::ArrayRef<executorch::aten::optional<T>>>
   }
 };
 
+/**
+ * How an argument of type T is kept between binding and calls, see
+ * WrapUnboxedIntoFunctor::bind(). By default as its EValue, which is converted
+ * on every call like the boxed kernel does.
+ */
+template <class T>
+struct bound_arg final {
+  using storage = executorch::runtime::EValue*;
+  static bool bind(executorch::runtime::EValue& v, storage& out) {
+    out = &v;
+    return true;
+  }
+  static T get(storage s) {
+    return evalue_to_arg<T>::call(*s);
+  }
+};
+
+/// Tensors are kept as pointers to the Tensor in their EValue.
+template <class TensorRef>
+struct bound_tensor_arg {
+  using storage = executorch::aten::Tensor*;
+  static bool bind(executorch::runtime::EValue& v, storage& out) {
+    if (!v.isTensor()) {
+      return false;
+    }
+    out = &v.toTensor();
+    return true;
+  }
+  static TensorRef get(storage s) {
+    return *s;
+  }
+};
+
+template <>
+struct bound_arg<executorch::aten::Tensor&> final
+    : bound_tensor_arg<executorch::aten::Tensor&> {};
+
+template <>
+struct bound_arg<const executorch::aten::Tensor&> final
+    : bound_tensor_arg<const executorch::aten::Tensor&> {};
+
+/// Scalars are kept as pointers to their payload, whose value may change
+/// between calls.
+#define ET_INTERNAL_BOUND_SCALAR_ARG(T, is_type, member)                \
+  template <>                                                           \
+  struct bound_arg<T> final {                                           \
+    using storage = const T*;                                           \
+    static bool bind(executorch::runtime::EValue& v, storage& out) {    \
+      if (!v.is_type()) {                                               \
+        return false;                                                   \
+      }                                                                 \
+      out = &v.payload.copyable_union.member;                           \
+      return true;                                                      \
+    }                                                                   \
+    static T get(storage s) {                                           \
+      return *s;                                                        \
+    }                                                                   \
+  };
+
+ET_INTERNAL_BOUND_SCALAR_ARG(int64_t, isInt, as_int)
+ET_INTERNAL_BOUND_SCALAR_ARG(double, isDouble, as_double)
+ET_INTERNAL_BOUND_SCALAR_ARG(bool, isBool, as_bool)
+#undef ET_INTERNAL_BOUND_SCALAR_ARG
+
+template <class ArgsType>
+struct bound_args;
+
+/// The bound arguments of a kernel with the argument types of ArgsType.
+template <typename... ArgTypes>
+struct bound_args<typelist<ArgTypes...>> final {
+  using type = std::tuple<typename bound_arg<
+      typename decay_if_not_tensor<ArgTypes>::type>::storage...>;
+};
+
 template <class Functor, size_t... evalue_arg_indices, typename... ArgTypes>
 void call_functor_with_args_from_stack(
     ::executorch::runtime::KernelRuntimeContext& ctx,
@@ -123,6 +205,37 @@ void call_functor_with_args_from_stack(
           *stack[evalue_arg_indices])...);
 }
 
+template <
+    class Functor,
+    class BoundArgs,
+    size_t... evalue_arg_indices,
+    typename... ArgTypes>
+void call_functor_with_bound_args(
+    ::executorch::runtime::KernelRuntimeContext& ctx,
+    const BoundArgs& args,
+    std::index_sequence<evalue_arg_indices...>,
+    typelist<ArgTypes...>*) {
+  (*Functor::func_ptr())(
+      ctx,
+      bound_arg<typename decay_if_not_tensor<ArgTypes>::type>::get(
+          std::get<evalue_arg_indices>(args))...);
+}
+
+template <
+    class BoundArgs,
+    size_t... evalue_arg_indices,
+    typename... ArgTypes>
+bool bind_args_from_stack(
+    BoundArgs& args,
+    executorch::runtime::EValue** stack,
+    std::index_sequence<evalue_arg_indices...>,
+    typelist<ArgTypes...>*) {
+  return (
+      bound_arg<typename decay_if_not_tensor<ArgTypes>::type>::bind(
+          *stack[evalue_arg_indices], std::get<evalue_arg_indices>(args)) &&
+      ...);
+}
+
 } // namespace kernel_util_internal
 
 /**
@@ -161,16 +274,113 @@ struct WrapUnboxedIntoFunctor {
         std::make_index_sequence<num_inputs>(),
         static_cast<ContextRemovedArgsType*>(nullptr));
   }
+
+  using BoundArgs =
+      typename kernel_util_internal::bound_args<ContextRemovedArgsType>::type;
+
+  /// Calls the kernel with arguments that bind() unpacked.
+  static void call_bound(
+      ::executorch::runtime::KernelRuntimeContext& ctx,
+      const void* bound_args) {
+    constexpr size_t num_inputs =
+        kernel_util_internal::size<ContextRemovedArgsType>::value;
+    return kernel_util_internal::call_functor_with_bound_args<FuncType>(
+        ctx,
+        *static_cast<const BoundArgs*>(bound_args),
+        std::make_index_sequence<num_inputs>(),
+        static_cast<ContextRemovedArgsType*>(nullptr));
+  }
+
+  /**
+   * An OpBindFunction: resolves each EValue of a call to a typed pointer once,
+   * so that call_bound() doesn't check and convert them on every call.
+   */
+  static executorch::runtime::Result<executorch::runtime::BoundOpFunction>
+  bind(
+      executorch::runtime::MemoryAllocator* allocator,
+      executorch::runtime::EValue** stack,
+      size_t n_args) {
+    constexpr size_t num_inputs =
+        kernel_util_internal::size<ContextRemovedArgsType>::value;
+    if (n_args != num_inputs) {
+      return executorch::runtime::Error::NotSupported;
+    }
+    // Bind on the stack first, so that calls that fall back to the boxed
+    // kernel leave nothing behind in the method's memory.
+    BoundArgs args;
+    if (!kernel_util_internal::bind_args_from_stack(
+            args,
+            stack,
+            std::make_index_sequence<num_inputs>(),
+            static_cast<ContextRemovedArgsType*>(nullptr))) {
+      return executorch::runtime::Error::NotSupported;
+    }
+    // The allocator releases its memory without running destructors.
+    static_assert(
+        std::is_trivially_destructible<BoundArgs>::value,
+        "Bound arguments must be trivially destructible");
+    void* memory = allocator->allocate(sizeof(BoundArgs), alignof(BoundArgs));
+    if (memory == nullptr) {
+      return executorch::runtime::Error::MemoryAllocationFailed;
+    }
+    return executorch::runtime::BoundOpFunction{
+        &call_bound, new (memory) BoundArgs(args)};
+  }
 };
 
+/**
+ * Returns a Kernel that calls the unboxed kernel. If ET_BIND_KERNEL_ARGS is
+ * defined, the Kernel also lets Method::init() bind the arguments of each call
+ * ahead of time, at the cost of a few bytes of method memory per call and the
+ * code of WrapUnboxedIntoFunctor::bind() for each kernel.
+ */
 template <typename FuncType>
 static executorch::runtime::Kernel make_boxed_kernel(
     const char* name,
     FuncType) {
+#ifdef ET_BIND_KERNEL_ARGS
+  return executorch::runtime::Kernel(
+      name,
+      WrapUnboxedIntoFunctor<FuncType>::call,
+      WrapUnboxedIntoFunctor<FuncType>::bind);
+#else
   return executorch::runtime::Kernel(
       name, WrapUnboxedIntoFunctor<FuncType>::call);
+#endif
+}
+
+namespace kernel_util_internal {
+
+/// Whether selective build kept the operator, e.g. "llama::sdpa.out".
+constexpr bool is_operator_selected(const char* name) {
+#ifdef EXECUTORCH_SELECTIVE_BUILD_OPS
+  return should_include_operator(name);
+#else
+  (void)name;
+  return true;
+#endif
 }
 
+/**
+ * Registers the kernel only if its operator was selected. The boxed wrapper of
+ * an operator that was not selected is never instantiated, so the kernel can
+ * be dropped at link time.
+ */
+template <bool kSelected, typename FuncType>
+executorch::runtime::Error register_kernel_if_selected(
+    const char* name,
+    FuncType func) {
+  if constexpr (kSelected) {
+    return executorch::runtime::register_kernel(make_boxed_kernel(name, func));
+  } else {
+    (void)name;
+    (void)func;
+    return executorch::runtime::Error::Ok;
+  }
+}
+
+} // namespace kernel_util_internal
+
 } // namespace extension
 } // namespace executorch
 
@@ -182,11 +392,13 @@ static executorch::runtime::Kernel make_boxed_kernel(
 #define EXECUTORCH_LIBRARY(ns, op_name, func) \
   _EXECUTORCH_LIBRARY_IMPL(ns, op_name, func, ET_UID)
 
-#define _EXECUTORCH_LIBRARY_IMPL(ns, op_name, func, uid) \
-  static auto ET_CONCATENATE(res_##ns##_, uid) =         \
-      ::executorch::runtime::register_kernel(            \
-          ::executorch::extension::make_boxed_kernel(    \
-              #ns "::" op_name, EXECUTORCH_FN(func)))
+#define _EXECUTORCH_LIBRARY_IMPL(ns, op_name, func, uid)                \
+  static auto ET_CONCATENATE(res_##ns##_, uid) =                        \
+      ::executorch::extension::kernel_util_internal::                   \
+          register_kernel_if_selected<                                  \
+              ::executorch::extension::kernel_util_internal::           \
+                  is_operator_selected(#ns "::" op_name)>(              \
+              #ns "::" op_name, EXECUTORCH_FN(func))
 
 namespace torch {
 namespace executor {
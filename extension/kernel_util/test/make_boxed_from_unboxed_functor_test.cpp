@@ -20,11 +20,15 @@ using exec_aten::optional;
 using exec_aten::ScalarType;
 using exec_aten::Tensor;
 using exec_aten::TensorImpl;
+using executorch::extension::WrapUnboxedIntoFunctor;
+using executorch::runtime::BoundOpFunction;
 using executorch::runtime::BoxedEvalueList;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::get_op_function_from_registry;
 using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::MemoryAllocator;
+using executorch::runtime::Result;
 using executorch::runtime::registry_has_op_function;
 
 Tensor& my_op_out(KernelRuntimeContext& ctx, const Tensor& a, Tensor& out) {
@@ -83,6 +87,18 @@ Tensor& add_optional_tensor_out(
   return out;
 }
 
+Tensor& add_int_scalar_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& a,
+    int64_t b,
+    Tensor& out) {
+  (void)ctx;
+  for (int i = 0; i < out.numel(); i++) {
+    out.mutable_data_ptr<int32_t>()[i] = a.const_data_ptr<int32_t>()[i] + b;
+  }
+  return out;
+}
+
 class MakeBoxedFromUnboxedFunctorTest : public ::testing::Test {
  public:
   void SetUp() override {
@@ -204,3 +220,40 @@ TEST_F(MakeBoxedFromUnboxedFunctorTest, UnboxOptionalArrayRef) {
     EXPECT_EQ(stack[1]->toTensor().const_data_ptr<int32_t>()[i], 1);
   }
 }
+
+TEST_F(MakeBoxedFromUnboxedFunctorTest, BoundArgsFollowTheirEValues) {
+  using Wrapper =
+      WrapUnboxedIntoFunctor<decltype(EXECUTORCH_FN(add_int_scalar_out))>;
+  torch::executor::testing::TensorFactory<ScalarType::Int> tf;
+  EValue values[3] = {EValue(tf.ones({2})), EValue((int64_t)2), tf.zeros({2})};
+  EValue* stack[3] = {&values[0], &values[1], &values[2]};
+
+  uint8_t buffer[64];
+  MemoryAllocator allocator(sizeof(buffer), buffer);
+  Result<BoundOpFunction> bound = Wrapper::bind(&allocator, stack, 3);
+  ASSERT_EQ(bound.error(), Error::Ok);
+
+  KernelRuntimeContext context;
+  bound->function(context, bound->bound_args);
+  EXPECT_EQ(values[2].toTensor().const_data_ptr<int32_t>()[1], 3);
+
+  // Calls read the current values of the bound EValues.
+  values[1] = EValue((int64_t)5);
+  bound->function(context, bound->bound_args);
+  EXPECT_EQ(values[2].toTensor().const_data_ptr<int32_t>()[1], 6);
+}
+
+TEST_F(MakeBoxedFromUnboxedFunctorTest, BindRejectsMismatchedArgs) {
+  using Wrapper =
+      WrapUnboxedIntoFunctor<decltype(EXECUTORCH_FN(add_int_scalar_out))>;
+  torch::executor::testing::TensorFactory<ScalarType::Int> tf;
+  EValue values[3] = {EValue(tf.ones({2})), EValue(2.0), tf.zeros({2})};
+  EValue* stack[3] = {&values[0], &values[1], &values[2]};
+
+  uint8_t buffer[64];
+  MemoryAllocator allocator(sizeof(buffer), buffer);
+  EXPECT_EQ(Wrapper::bind(&allocator, stack, 3).error(), Error::NotSupported);
+  EXPECT_EQ(Wrapper::bind(&allocator, stack, 2).error(), Error::NotSupported);
+  // Calls that fall back to the boxed kernel don't take method memory.
+  EXPECT_EQ(allocator.used_size(), 0);
+}
@@ -73,13 +73,18 @@ def _validate_params(
         value.dim() == 4
     ), f"Expected value to be 4 dimensional but got {value.dim()} dimensions."
 
+    # Half and bfloat16 accumulate in float32, so the caches can stay in 16 bits.
+    assert query.dtype in (
+        torch.float32,
+        torch.float16,
+        torch.bfloat16,
+    ), f"Expected query to be float32, float16 or bfloat16 but got {query.dtype}"
     assert (
-        query.dtype == torch.float32
-    ), f"Expected query to be float32 but got {query.dtype}"
-    assert key.dtype == torch.float32, f"Expected key to be float32 but got {key.dtype}"
+        key.dtype == query.dtype
+    ), f"Expected key to be {query.dtype} but got {key.dtype}"
     assert (
-        value.dtype == torch.float32
-    ), f"Expected value to be float32 but got {value.dtype}"
+        value.dtype == query.dtype
+    ), f"Expected value to be {query.dtype} but got {value.dtype}"
 
     assert (
         key_cache.dim() == 4
@@ -89,11 +94,11 @@ def _validate_params(
     ), f"Expected value_cache to be 4 dimensional but got {value_cache.dim()}"
 
     assert (
-        key_cache.dtype == torch.float32
-    ), f"Expected key_cache to be float32 but got {key_cache.dtype}"
+        key_cache.dtype == query.dtype
+    ), f"Expected key_cache to be {query.dtype} but got {key_cache.dtype}"
     assert (
-        value_cache.dtype == torch.float32
-    ), f"Expected value_cache to be float32 but got {value_cache.dtype}"
+        value_cache.dtype == query.dtype
+    ), f"Expected value_cache to be {query.dtype} but got {value_cache.dtype}"
 
     assert (
         key_cache.size() == value_cache.size()
@@ -111,9 +116,9 @@ def _validate_params(
         assert (
             attn_mask.dim() == 2
         ), f"Expected attn_mask to be 2 dimensional but got {attn_mask.dim()} dimensions."
-        assert (attn_mask.dtype == torch.float32) or (
-            attn_mask.dtype == torch.float16
-        ), f"Expected attn_mask to be float but got {attn_mask.dtype}"
+        assert (
+            attn_mask.dtype == query.dtype
+        ), f"Expected attn_mask to be {query.dtype} but got {attn_mask.dtype}"
 
 
 @impl(custom_ops_lib, "sdpa_with_kv_cache", "Meta")
@@ -155,6 +160,118 @@ def fast_hadamard_transform_meta(mat):
     return torch.empty_like(mat)
 
 
+@impl(custom_ops_lib, "fast_hadamard_transform_quantize_per_token", "Meta")
+def fast_hadamard_transform_quantize_per_token_meta(mat, scales, zero_points):
+    qparams_shape = list(mat.shape[:-1]) + [1]
+    assert (
+        list(scales.shape) == qparams_shape
+    ), f"Expected scales of shape {qparams_shape}, got {list(scales.shape)}"
+    assert (
+        list(zero_points.shape) == qparams_shape
+    ), f"Expected zero_points of shape {qparams_shape}, got {list(zero_points.shape)}"
+    assert scales.dtype == torch.float32, "Expected float32 scales"
+    assert zero_points.dtype == torch.int64, "Expected int64 zero_points"
+    return torch.empty_like(mat, dtype=torch.int8)
+
+
+@impl(custom_ops_lib, "gathered_linear", "Meta")
+def gathered_linear_meta(input, weight, bias, indices):
+    assert weight.dim() == 2, f"Expected a 2D weight, got {weight.dim()}D"
+    assert (
+        input.size(-1) == weight.size(1)
+    ), f"Expected {weight.size(1)} input features, got {input.size(-1)}"
+    assert input.dtype == weight.dtype, "Expected input and weight of one dtype"
+    assert (
+        indices.dim() == 1 and indices.dtype == torch.int64
+    ), "Expected 1D int64 indices"
+    return torch.empty(
+        list(input.shape[:-1]) + [indices.size(0)],
+        dtype=input.dtype,
+        device=input.device,
+    )
+
+
+@impl(custom_ops_lib, "lora_linear", "Meta")
+def lora_linear_meta(
+    input, weight, bias, lora_a, lora_b, adapter_ids=None, scale=1.0
+):
+    assert weight.dim() == 2, f"Expected a 2D weight, got {weight.dim()}D"
+    assert (
+        lora_a.dim() == 3 and lora_b.dim() == 3
+    ), "Expected lora_a of [num_adapters, rank, in features] and lora_b of [num_adapters, out features, rank]"
+    assert (
+        input.size(-1) == weight.size(1) == lora_a.size(2)
+    ), f"Expected {weight.size(1)} input features, got {input.size(-1)}"
+    assert (
+        lora_b.size(1) == weight.size(0) and lora_b.size(2) == lora_a.size(1)
+    ), "Expected lora_b of [num_adapters, out features, rank]"
+    assert (
+        input.dtype == weight.dtype == lora_a.dtype == lora_b.dtype
+    ), "Expected input, weight and the adapters to have the same dtype"
+    if adapter_ids is not None:
+        assert adapter_ids.dtype == torch.int64, "Expected int64 adapter_ids"
+        assert adapter_ids.dim() == 1 and adapter_ids.size(0) == input.size(
+            0
+        ), "Expected an adapter id for every sequence of input"
+    return torch.empty(
+        list(input.shape[:-1]) + [weight.size(0)],
+        dtype=input.dtype,
+        device=input.device,
+    )
+
+
+@impl(custom_ops_lib, "rms_norm", "Meta")
+def rms_norm_meta(input, normalized_shape, weight=None, eps=1e-6):
+    assert list(input.shape[-len(normalized_shape) :]) == list(
+        normalized_shape
+    ), f"Expected normalized_shape {normalized_shape} to match the trailing dims of input {input.shape}"
+    if weight is not None:
+        assert list(weight.shape) == list(
+            normalized_shape
+        ), f"Expected weight shape {weight.shape} to be {normalized_shape}"
+        assert (
+            weight.dtype == input.dtype
+        ), f"Expected weight and input to have the same dtype but got {weight.dtype} and {input.dtype}"
+    return torch.empty_like(input)
+
+
+@impl(custom_ops_lib, "apply_rope_and_update_cache", "Meta")
+def apply_rope_and_update_cache_meta(
+    q,
+    k,
+    v,
+    k_cache,
+    v_cache,
+    start_pos,
+    freqs_cos=None,
+    freqs_sin=None,
+    theta=10000.0,
+):
+    assert (
+        q.dim() == 4 and k.dim() == 4
+    ), f"Expected q and k to be 4 dimensional but got {q.dim()} and {k.dim()} dimensions."
+    assert (
+        q.dtype == k.dtype == v.dtype == k_cache.dtype == v_cache.dtype
+    ), "Expected q, k, v and the caches to have the same dtype"
+    assert (
+        q.size(-1) % 2 == 0
+    ), f"Expected an even head_dim but got {q.size(-1)}"
+    assert (
+        k.size() == v.size()
+    ), f"Expected k and v to have the same size but got {k.size()} and {v.size()}"
+    assert (
+        (freqs_cos is None) == (freqs_sin is None)
+    ), "Expected either both of freqs_cos and freqs_sin or neither"
+    if freqs_cos is not None:
+        for freqs in (freqs_cos, freqs_sin):
+            assert list(freqs.shape) == [
+                q.size(1),
+                q.size(-1) // 2,
+            ], f"Expected freqs of shape [seq_len, head_dim / 2] but got {freqs.shape}"
+    _validate_update_cache_params(k, k_cache, start_pos)
+    return torch.empty_like(q)
+
+
 @impl(custom_ops_lib, "custom_sdpa", "Meta")
 def custom_sdpa(
     query,
@@ -233,3 +350,369 @@ def update_cache_meta(
     # workaround. Should we just return cache instead? But I am afraid that
     # will result in extra memory allocation
     return torch.empty((1,), dtype=value.dtype, device="meta")
+
+
+def _validate_paged_cache_params(
+    value,
+    cache,
+    block_table,
+    start_pos,
+):
+    seq_len = value.size(1)
+    assert (
+        value.dim() == 4
+    ), f"Expected value to be 4 dimensional but got {value.dim()} dimensions."
+    assert (
+        cache.dim() == 4
+    ), f"Expected paged cache to be 4 dimensional but got {cache.dim()} dimensions."
+    assert (
+        value.dtype == cache.dtype
+    ), f"Expected value and cache to be of the same type but got value type {value.dtype} and cache type {cache.dtype}"
+
+    for i in [2, 3]:
+        assert value.size(i) == cache.size(
+            i
+        ), f"Expected value and cache to have same size in dimension {i} but got {value.size(i)} and {cache.size(i)}"
+
+    assert (
+        block_table.dim() == 2
+    ), f"Expected block_table to be 2 dimensional but got {block_table.dim()} dimensions."
+    assert (
+        block_table.dtype == torch.int64
+    ), f"Expected block_table to be int64 but got {block_table.dtype}"
+    assert block_table.size(0) == value.size(
+        0
+    ), f"Expected one block_table row per batch entry but got {block_table.size(0)} rows for batch size {value.size(0)}"
+
+    torch._check_is_size(start_pos)
+    torch._check(start_pos + seq_len <= block_table.size(1) * cache.size(1))
+
+
+@impl(custom_ops_lib, "update_cache_paged", "Meta")
+def update_cache_paged_meta(
+    value,
+    cache,
+    block_table,
+    start_pos,
+):
+    _validate_paged_cache_params(
+        value,
+        cache,
+        block_table,
+        start_pos,
+    )
+
+    # Same placeholder output as update_cache.
+    return torch.empty((1,), dtype=value.dtype, device="meta")
+
+
+@impl(custom_ops_lib, "custom_sdpa_paged", "Meta")
+def custom_sdpa_paged_meta(
+    query,
+    key_cache,
+    value_cache,
+    block_table,
+    start_pos,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    assert (
+        query.dim() == 4
+    ), f"Expected query to be 4 dimensional but got {query.dim()} dimensions."
+    assert query.dtype in (
+        torch.float32,
+        torch.float16,
+        torch.bfloat16,
+    ), f"Expected query to be float32, float16 or bfloat16 but got {query.dtype}"
+    assert (
+        key_cache.dtype == query.dtype and value_cache.dtype == query.dtype
+    ), f"Expected the caches to be {query.dtype} but got {key_cache.dtype}"
+    assert (
+        key_cache.size() == value_cache.size()
+    ), f"Key cache and value cache must have same size but got {key_cache.size()} and {value_cache.size()}"
+    _validate_paged_cache_params(
+        query.new_empty(
+            (query.size(0), query.size(1), key_cache.size(2), key_cache.size(3)),
+            dtype=key_cache.dtype,
+        ),
+        key_cache,
+        block_table,
+        start_pos,
+    )
+
+    return torch.empty_like(query)
+
+
+@impl(custom_ops_lib, "sdpa_with_paged_kv_cache", "Meta")
+def sdpa_with_paged_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    block_table,
+    start_pos,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    _validate_paged_cache_params(key, key_cache, block_table, start_pos)
+    _validate_paged_cache_params(value, value_cache, block_table, start_pos)
+
+    return custom_sdpa_paged_meta(
+        query,
+        key_cache,
+        value_cache,
+        block_table,
+        start_pos,
+        attn_mask,
+        drpout_p,
+        is_causal,
+        scale,
+    )
+
+
+def _validate_quantized_cache_params(cache, scales, zero_points):
+    assert (
+        cache.dim() == 4
+    ), f"Expected quantized cache to be 4 dimensional but got {cache.dim()} dimensions."
+    assert (
+        cache.dtype == torch.int8
+    ), f"Expected quantized cache to be int8 but got {cache.dtype}"
+    assert scales.dtype in (
+        torch.float32,
+        torch.float64,
+    ), f"Expected scales to be float32 or float64 but got {scales.dtype}"
+    assert zero_points.dtype in (
+        torch.int8,
+        torch.int32,
+        torch.int64,
+    ), f"Expected zero points to be int8, int32 or int64 but got {zero_points.dtype}"
+    for qparams in (scales, zero_points):
+        assert (
+            qparams.dim() == 4
+            and qparams.size(0) == cache.size(0)
+            and qparams.size(1) in (cache.size(1), 1)
+            and qparams.size(2) == cache.size(2)
+            and qparams.size(3) == 1
+        ), f"Expected scales and zero points of shape [batch, max_seq_len or 1, heads, 1] but got {qparams.size()}"
+
+
+@impl(custom_ops_lib, "custom_quantized_sdpa", "Meta")
+def custom_quantized_sdpa_meta(
+    query,
+    key_cache,
+    value_cache,
+    key_scales,
+    key_zero_points,
+    value_scales,
+    value_zero_points,
+    start_pos,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    assert (
+        query.dim() == 4
+    ), f"Expected query to be 4 dimensional but got {query.dim()} dimensions."
+    assert (
+        query.dtype == torch.float32
+    ), f"Expected query to be float32 but got {query.dtype}"
+    assert (
+        key_cache.size() == value_cache.size()
+    ), f"Key cache and value cache must have same size but got {key_cache.size()} and {value_cache.size()}"
+    _validate_quantized_cache_params(key_cache, key_scales, key_zero_points)
+    _validate_quantized_cache_params(value_cache, value_scales, value_zero_points)
+    torch._check_is_size(start_pos)
+    torch._check(start_pos + query.size(1) <= key_cache.size(1))
+
+    return torch.empty_like(query)
+
+
+@impl(custom_ops_lib, "sdpa_with_quantized_kv_cache", "Meta")
+def sdpa_with_quantized_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    key_scales,
+    key_zero_points,
+    value_scales,
+    value_zero_points,
+    start_pos,
+    attn_mask=None,
+    drpout_p=0.0,
+    is_causal=False,
+    scale=None,
+):
+    for projected in (key, value):
+        assert (
+            projected.dtype == torch.float32
+        ), f"Expected key and value to be float32 but got {projected.dtype}"
+        for i in [0, 2, 3]:
+            assert projected.size(i) == key_cache.size(
+                i
+            ), f"Expected key, value and cache to have same size in dimension {i} but got {projected.size(i)} and {key_cache.size(i)}"
+    assert (
+        key_scales.size(1) == key_cache.size(1)
+        and value_scales.size(1) == value_cache.size(1)
+    ), "Expected per token scales and zero points to update the cache"
+
+    return custom_quantized_sdpa_meta(
+        query,
+        key_cache,
+        value_cache,
+        key_scales,
+        key_zero_points,
+        value_scales,
+        value_zero_points,
+        start_pos,
+        attn_mask,
+        drpout_p,
+        is_causal,
+        scale,
+    )
+
+
+def _validate_ring_cache_params(
+    value,
+    cache,
+    start_pos,
+    sink_size,
+):
+    seq_len = value.size(1)
+    assert (
+        value.dim() == 4
+    ), f"Expected value to be 4 dimensional but got {value.dim()} dimensions."
+    assert (
+        cache.dim() == 4
+    ), f"Expected ring cache to be 4 dimensional but got {cache.dim()} dimensions."
+    assert (
+        value.dtype == cache.dtype
+    ), f"Expected value and cache to be of the same type but got value type {value.dtype} and cache type {cache.dtype}"
+
+    for i in [0, 2, 3]:
+        assert value.size(i) == cache.size(
+            i
+        ), f"Expected value and cache to have same size in dimension {i} but got {value.size(i)} and {cache.size(i)}"
+
+    assert (
+        0 <= sink_size < cache.size(1)
+    ), f"Expected sink_size to leave room for a window in a cache of {cache.size(1)} but got {sink_size}"
+    assert (
+        seq_len <= cache.size(1) - sink_size
+    ), f"Expected seq_len to be at most the window of {cache.size(1) - sink_size} but got {seq_len}"
+
+    torch._check_is_size(start_pos)
+
+
+@impl(custom_ops_lib, "update_cache_ring", "Meta")
+def update_cache_ring_meta(
+    value,
+    cache,
+    start_pos,
+    sink_size,
+):
+    _validate_ring_cache_params(value, cache, start_pos, sink_size)
+
+    # Same placeholder output as update_cache.
+    return torch.empty((1,), dtype=value.dtype, device="meta")
+
+
+@impl(custom_ops_lib, "custom_sdpa_ring", "Meta")
+def custom_sdpa_ring_meta(
+    query,
+    key_cache,
+    value_cache,
+    start_pos,
+    sink_size,
+    drpout_p=0.0,
+    scale=None,
+):
+    assert (
+        query.dim() == 4
+    ), f"Expected query to be 4 dimensional but got {query.dim()} dimensions."
+    assert (
+        query.dtype == torch.float32
+    ), f"Expected query to be float32 but got {query.dtype}"
+    assert (
+        key_cache.size() == value_cache.size()
+    ), f"Key cache and value cache must have same size but got {key_cache.size()} and {value_cache.size()}"
+    _validate_ring_cache_params(
+        query.new_empty(
+            (query.size(0), query.size(1), key_cache.size(2), key_cache.size(3)),
+            dtype=key_cache.dtype,
+        ),
+        key_cache,
+        start_pos,
+        sink_size,
+    )
+
+    return torch.empty_like(query)
+
+
+@impl(custom_ops_lib, "sdpa_with_ring_kv_cache", "Meta")
+def sdpa_with_ring_kv_cache_meta(
+    query,
+    key,
+    value,
+    key_cache,
+    value_cache,
+    start_pos,
+    sink_size,
+    drpout_p=0.0,
+    scale=None,
+):
+    _validate_ring_cache_params(key, key_cache, start_pos, sink_size)
+    _validate_ring_cache_params(value, value_cache, start_pos, sink_size)
+
+    return custom_sdpa_ring_meta(
+        query,
+        key_cache,
+        value_cache,
+        start_pos,
+        sink_size,
+        drpout_p,
+        scale,
+    )
+
+
+@impl(custom_ops_lib, "cross_attention_sdpa", "Meta")
+def cross_attention_sdpa_meta(
+    query,
+    key_cache,
+    value_cache,
+    attn_mask=None,
+    scale=None,
+):
+    assert (
+        query.dim() == 4 and key_cache.dim() == 4
+    ), f"Expected query and key_cache to be 4 dimensional but got {query.dim()} and {key_cache.dim()} dimensions."
+    assert (
+        query.dtype == torch.float32
+    ), f"Expected query to be float32 but got {query.dtype}"
+    assert (
+        query.dtype == key_cache.dtype and query.dtype == value_cache.dtype
+    ), "Expected query and the caches to have the same dtype"
+    assert (
+        key_cache.size() == value_cache.size()
+    ), f"Key cache and value cache must have same size but got {key_cache.size()} and {value_cache.size()}"
+    assert (
+        query.size(0) == key_cache.size(0) and query.size(3) == key_cache.size(3)
+    ), f"Expected query {query.size()} and caches {key_cache.size()} to agree on batch size and head dim"
+    if attn_mask is not None:
+        assert (
+            attn_mask.dtype == torch.bool
+        ), f"Expected attn_mask to be bool but got {attn_mask.dtype}"
+        assert attn_mask.dim() == 2 or (
+            attn_mask.dim() == 3 and attn_mask.size(0) == 1
+        ), f"Expected attn_mask of [seq_len, encoder seq_len] but got {attn_mask.size()}"
+        torch._check(attn_mask.size(-2) == query.size(1))
+        torch._check(attn_mask.size(-1) == key_cache.size(1))
+
+    return torch.empty_like(query)
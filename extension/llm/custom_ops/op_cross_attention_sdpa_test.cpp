@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_cross_attention_sdpa(
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const optional<Tensor>& attn_mask,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::cross_attention_sdpa_out(
+      context, q, key_cache, value_cache, attn_mask, {}, out);
+}
+
+// Softmax attention of every query to the keys that mask allows, computed
+// one query and head at a time. mask is [seq_len, kv_len], or empty for
+// none.
+std::vector<float> reference_attention(
+    const std::vector<float>& q,
+    const std::vector<float>& k,
+    const std::vector<float>& v,
+    const std::vector<uint8_t>& mask,
+    int32_t batch,
+    int32_t seq_len,
+    int32_t kv_len,
+    int32_t heads,
+    int32_t kv_heads,
+    int32_t dim) {
+  std::vector<float> out(q.size());
+  const float scale = 1.0f / std::sqrt(static_cast<float>(dim));
+  for (int32_t b = 0; b < batch; ++b) {
+    for (int32_t s = 0; s < seq_len; ++s) {
+      for (int32_t h = 0; h < heads; ++h) {
+        const int32_t kv_h = h / (heads / kv_heads);
+        const float* q_row = &q[((b * seq_len + s) * heads + h) * dim];
+        std::vector<float> scores(kv_len);
+        float max = -std::numeric_limits<float>::infinity();
+        for (int32_t t = 0; t < kv_len; ++t) {
+          if (!mask.empty() && !mask[s * kv_len + t]) {
+            scores[t] = -std::numeric_limits<float>::infinity();
+            continue;
+          }
+          const float* k_row = &k[((b * kv_len + t) * kv_heads + kv_h) * dim];
+          float dot = 0;
+          for (int32_t d = 0; d < dim; ++d) {
+            dot += q_row[d] * k_row[d];
+          }
+          scores[t] = dot * scale;
+          max = std::max(max, scores[t]);
+        }
+        float sum = 0;
+        for (int32_t t = 0; t < kv_len; ++t) {
+          scores[t] = std::exp(scores[t] - max);
+          sum += scores[t];
+        }
+        float* out_row = &out[((b * seq_len + s) * heads + h) * dim];
+        for (int32_t t = 0; t < kv_len; ++t) {
+          const float* v_row = &v[((b * kv_len + t) * kv_heads + kv_h) * dim];
+          for (int32_t d = 0; d < dim; ++d) {
+            out_row[d] += scores[t] / sum * v_row[d];
+          }
+        }
+      }
+    }
+  }
+  return out;
+}
+
+void expect_matches_reference(
+    int32_t batch,
+    int32_t seq_len,
+    int32_t kv_len,
+    int32_t heads,
+    int32_t kv_heads,
+    int32_t dim,
+    bool masked) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tfb;
+  const auto q_data = make_data(batch * seq_len * heads * dim, 0.37f);
+  const auto k_data = make_data(batch * kv_len * kv_heads * dim, 0.11f);
+  const auto v_data = make_data(batch * kv_len * kv_heads * dim, 0.23f);
+  std::vector<uint8_t> mask_data;
+  if (masked) {
+    // Each query attends to a different prefix of the keys, like text
+    // tokens that follow a different number of images.
+    for (int32_t s = 0; s < seq_len; ++s) {
+      for (int32_t t = 0; t < kv_len; ++t) {
+        mask_data.push_back(t <= (s * 7) % kv_len);
+      }
+    }
+  }
+
+  Tensor q = tf.make({batch, seq_len, heads, dim}, q_data);
+  Tensor key_cache = tf.make({batch, kv_len, kv_heads, dim}, k_data);
+  Tensor value_cache = tf.make({batch, kv_len, kv_heads, dim}, v_data);
+  Tensor out = tf.zeros({batch, seq_len, heads, dim});
+  optional<Tensor> mask;
+  if (masked) {
+    mask = tfb.make({1, seq_len, kv_len}, mask_data);
+  }
+  op_cross_attention_sdpa(q, key_cache, value_cache, mask, out);
+
+  Tensor expected = tf.make(
+      {batch, seq_len, heads, dim},
+      reference_attention(
+          q_data,
+          k_data,
+          v_data,
+          mask_data,
+          batch,
+          seq_len,
+          kv_len,
+          heads,
+          kv_heads,
+          dim));
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-5, 1e-5);
+}
+
+} // namespace
+
+TEST(OpCrossAttentionSdpaTest, DecodeAttendsToWholeCache) {
+  expect_matches_reference(
+      /*batch=*/1,
+      /*seq_len=*/1,
+      /*kv_len=*/1100,
+      /*heads=*/4,
+      /*kv_heads=*/4,
+      /*dim=*/8,
+      /*masked=*/false);
+}
+
+TEST(OpCrossAttentionSdpaTest, GroupedQueryAttention) {
+  expect_matches_reference(
+      /*batch=*/2,
+      /*seq_len=*/3,
+      /*kv_len=*/40,
+      /*heads=*/8,
+      /*kv_heads=*/2,
+      /*dim=*/16,
+      /*masked=*/false);
+}
+
+TEST(OpCrossAttentionSdpaTest, PrefillWithMask) {
+  expect_matches_reference(
+      /*batch=*/1,
+      /*seq_len=*/5,
+      /*kv_len=*/600,
+      /*heads=*/4,
+      /*kv_heads=*/2,
+      /*dim=*/8,
+      /*masked=*/true);
+}
+
+TEST(OpCrossAttentionSdpaTest, MaskIsSharedByTheBatch) {
+  expect_matches_reference(
+      /*batch=*/2,
+      /*seq_len=*/4,
+      /*kv_len=*/33,
+      /*heads=*/2,
+      /*kv_heads=*/1,
+      /*dim=*/4,
+      /*masked=*/true);
+}
+
+TEST(OpCrossAttentionSdpaTest, RejectsMaskOfWrongShape) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tfb;
+  Tensor q = tf.ones({1, 2, 2, 4});
+  Tensor key_cache = tf.ones({1, 6, 2, 4});
+  Tensor value_cache = tf.ones({1, 6, 2, 4});
+  Tensor out = tf.zeros({1, 2, 2, 4});
+  optional<Tensor> mask = tfb.ones({2, 5});
+
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::cross_attention_sdpa_out(
+      context, q, key_cache, value_cache, mask, {}, out);
+  EXPECT_NE(context.failure_state(), executorch::runtime::Error::Ok);
+}
@@ -7,14 +7,190 @@
  */
 
 #include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/llm/custom_ops/op_fast_hadamard_transform.h>
 #include <executorch/extension/llm/custom_ops/spinquant/fast_hadamard_transform.h>
+#include <executorch/extension/parallel/thread_parallel.h>
 #include <executorch/kernels/optimized/utils/llvmMathExtras.h>
-#include <executorch/kernels/portable/cpu/util/reduce_util.h> // For apply_over_dim.
 #include <executorch/runtime/kernel/kernel_includes.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
 namespace torch {
 namespace executor {
 namespace native {
+namespace {
+
+// The minimum number of elements that each parallel_for chunk
+// transforms.
+constexpr int64_t kHadamardGrainSize = 32768;
+
+// How a row of the last dimension is transformed: as special_size
+// (1 if none) FHTs of 1 << log2_power_of_two_size elements.
+struct HadamardRowSize {
+  int special_size;
+  int log2_power_of_two_size;
+};
+
+bool is_power_of_two(int64_t size) {
+  return size > 0 && (size & (size - 1)) == 0;
+}
+
+bool get_hadamard_row_size(int64_t size, HadamardRowSize& row_size) {
+  int special_size = 1;
+  if (!is_power_of_two(size)) {
+    special_size = 0;
+    for (const int candidate : executorch::kHadamardSpecialSizes) {
+      if (size % candidate == 0 && is_power_of_two(size / candidate)) {
+        special_size = candidate;
+        break;
+      }
+    }
+  }
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      special_size != 0,
+      "This implementation requires power-of-2 (or power-of-2 * 12, 20, 28 or 40) input size in the last dimension!");
+  row_size.special_size = special_size;
+  row_size.log2_power_of_two_size = executorch::llvm::countTrailingZeros(
+      static_cast<unsigned int>(size / special_size),
+      executorch::llvm::ZeroBehavior::ZB_Undefined);
+  return true;
+}
+
+bool check_fast_hadamard_transform_args(
+    const Tensor& mat,
+    const Tensor& out,
+    HadamardRowSize& row_size) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(mat, out));
+  ET_LOG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(mat.dim_order().data(), mat.dim()));
+  ET_LOG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(out.dim_order().data(), out.dim()));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      mat.strides().back() == 1,
+      "input matrix that isn't contiguous in the last dimension is not supported!");
+  return get_hadamard_row_size(mat.sizes().back(), row_size);
+}
+
+template <typename T>
+void fast_hadamard_transform_row(T* row, const HadamardRowSize& row_size) {
+  if (row_size.special_size == 1) {
+    executorch::fast_hadamard_transform(
+        row, row_size.log2_power_of_two_size);
+  } else {
+    executorch::fast_hadamard_transform_special(
+        row, row_size.special_size, row_size.log2_power_of_two_size);
+  }
+}
+
+// Calls fn(row, buffer) for the rows of num_rows * row_length elements
+// in parallel, with each chunk of rows sharing a float buffer of
+// row_length elements.
+template <typename Fn>
+void for_each_row(int64_t num_rows, int64_t row_length, const Fn& fn) {
+  const int64_t grain_size =
+      std::max<int64_t>(1, kHadamardGrainSize / row_length);
+  executorch::extension::parallel_for(
+      0, num_rows, grain_size, [&](int64_t begin, int64_t end) {
+        std::vector<float> buffer(row_length);
+        for (int64_t row = begin; row < end; ++row) {
+          fn(row, buffer.data());
+        }
+      });
+}
+
+template <typename CTYPE>
+void fast_hadamard_transform_rows(
+    const CTYPE* mat_data,
+    CTYPE* out_data,
+    int64_t num_rows,
+    int64_t row_length,
+    const HadamardRowSize& row_size) {
+  for_each_row(num_rows, row_length, [&](int64_t row, float* buffer) {
+    const CTYPE* src = mat_data + row * row_length;
+    CTYPE* dst = out_data + row * row_length;
+    if constexpr (std::is_same_v<CTYPE, float>) {
+      // out may alias mat.
+      if (dst != src) {
+        std::memcpy(dst, src, row_length * sizeof(float));
+      }
+      fast_hadamard_transform_row(dst, row_size);
+    } else {
+      // Transform in float, which has the vectorized kernels, rather
+      // than accumulate the butterflies in CTYPE.
+      for (int64_t ii = 0; ii < row_length; ++ii) {
+        buffer[ii] = static_cast<float>(src[ii]);
+      }
+      fast_hadamard_transform_row(buffer, row_size);
+      for (int64_t ii = 0; ii < row_length; ++ii) {
+        dst[ii] = static_cast<CTYPE>(buffer[ii]);
+      }
+    }
+  });
+}
+
+// Quantizes row to asymmetric int8 like quantize_to_cache in
+// op_sdpa.cpp. The range always includes 0, so that it is exactly
+// representable.
+void quantize_row_asymmetric(
+    const float* row,
+    int64_t row_length,
+    int8_t* out,
+    float& scale,
+    int64_t& zero_point) {
+  constexpr int32_t qmin = std::numeric_limits<int8_t>::min();
+  constexpr int32_t qmax = std::numeric_limits<int8_t>::max();
+  float min_val = 0, max_val = 0;
+  for (int64_t ii = 0; ii < row_length; ++ii) {
+    min_val = std::min(min_val, row[ii]);
+    max_val = std::max(max_val, row[ii]);
+  }
+  scale = std::max(
+      (max_val - min_val) / static_cast<float>(qmax - qmin),
+      std::numeric_limits<float>::epsilon());
+  const float descaled_min = min_val / scale;
+  const float descaled_max = max_val / scale;
+  // Pick the zero point from the end of the range with the smaller
+  // rounding error.
+  const float zero_point_float =
+      (qmin + descaled_min) + (qmax + descaled_max) > 0
+      ? qmin - descaled_min
+      : qmax - descaled_max;
+  const int32_t zero_point_int = static_cast<int32_t>(std::nearbyint(
+      std::min<float>(std::max<float>(zero_point_float, qmin), qmax)));
+  zero_point = zero_point_int;
+
+  const float inv_scale = 1.0f / scale;
+  for (int64_t ii = 0; ii < row_length; ++ii) {
+    const float q = std::nearbyint(row[ii] * inv_scale) + zero_point_int;
+    out[ii] =
+        static_cast<int8_t>(std::min<float>(std::max<float>(q, qmin), qmax));
+  }
+}
+
+bool check_qparams(const Tensor& qparams, const Tensor& mat) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      qparams.dim() == mat.dim(),
+      "Expected scales and zero_points to have the rank of mat");
+  for (ssize_t ii = 0; ii < mat.dim() - 1; ++ii) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        qparams.size(ii) == mat.size(ii),
+        "Expected scales and zero_points to match mat in dimension %zd",
+        ii);
+  }
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      qparams.sizes().back() == 1,
+      "Expected scales and zero_points to have size 1 in the last dimension");
+  ET_LOG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(qparams.dim_order().data(), qparams.dim()));
+  return true;
+}
+
+} // namespace
 
 Tensor& fast_hadamard_transform_out(
     RuntimeContext& ctx,
@@ -34,67 +210,93 @@ Tensor& fast_hadamard_transform_out(
     return out;
   }
 
+  HadamardRowSize row_size;
   ET_KERNEL_CHECK(
       ctx,
-      is_contiguous_dim_order(mat.dim_order().data(), mat.dim()),
+      check_fast_hadamard_transform_args(mat, out, row_size),
       InvalidArgument,
       out);
 
-  ET_KERNEL_CHECK(
-      ctx,
-      is_contiguous_dim_order(out.dim_order().data(), out.dim()),
-      InvalidArgument,
-      out);
+  const int64_t row_length = mat.sizes().back();
+  const int64_t num_rows = mat.numel() / row_length;
+  ET_SWITCH_FLOATH_TYPES(mat.scalar_type(), ctx, __func__, CTYPE, [&] {
+    fast_hadamard_transform_rows(
+        mat.const_data_ptr<CTYPE>(),
+        out.mutable_data_ptr<CTYPE>(),
+        num_rows,
+        row_length,
+        row_size);
+  });
+  return out;
+}
 
+Tensor& fast_hadamard_transform_quantize_per_token_out(
+    RuntimeContext& ctx,
+    const Tensor& mat,
+    Tensor& scales,
+    Tensor& zero_points,
+    Tensor& out) {
   ET_KERNEL_CHECK_MSG(
       ctx,
-      mat.strides().back() == 1,
+      resize_tensor(out, mat.sizes()) == Error::Ok,
       InvalidArgument,
       out,
-      "input matrix that isn't contiguous in the last dimension is not supported!");
+      "Failed to resize output tensor.");
 
-  const auto last_dim_size = mat.sizes().back();
-  const auto divisible_by_28 = last_dim_size % 28 == 0;
-  auto power_of_two_size = divisible_by_28 ? last_dim_size / 28 : last_dim_size;
-  ET_KERNEL_CHECK_MSG(
+  ET_KERNEL_CHECK(
+      ctx, out.scalar_type() == ScalarType::Char, InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx, scales.scalar_type() == ScalarType::Float, InvalidArgument, out);
+  ET_KERNEL_CHECK(
       ctx,
-      (power_of_two_size & (power_of_two_size - 1)) == 0,
+      zero_points.scalar_type() == ScalarType::Long,
       InvalidArgument,
-      out,
-      "This implementation requires power-of-2 (or power-of-2 * 28) input size in the last dimension!");
+      out);
 
-  const auto log2_power_of_two_size = executorch::llvm::countTrailingZeros(
-      static_cast<unsigned int>(power_of_two_size),
-      executorch::llvm::ZeroBehavior::ZB_Undefined);
+  if (mat.dim() == 0 || mat.numel() == 0) {
+    return out;
+  }
+
+  HadamardRowSize row_size;
+  ET_KERNEL_CHECK(
+      ctx,
+      is_contiguous_dim_order(mat.dim_order().data(), mat.dim()) &&
+          is_contiguous_dim_order(out.dim_order().data(), out.dim()) &&
+          get_hadamard_row_size(mat.sizes().back(), row_size),
+      InvalidArgument,
+      out);
+  ET_KERNEL_CHECK(
+      ctx,
+      check_qparams(scales, mat) && check_qparams(zero_points, mat),
+      InvalidArgument,
+      out);
 
+  const int64_t row_length = mat.sizes().back();
+  const int64_t num_rows = mat.numel() / row_length;
+  int8_t* const out_data = out.mutable_data_ptr<int8_t>();
+  float* const scales_data = scales.mutable_data_ptr<float>();
+  int64_t* const zero_points_data = zero_points.mutable_data_ptr<int64_t>();
   ET_SWITCH_FLOATH_TYPES(mat.scalar_type(), ctx, __func__, CTYPE, [&] {
     const CTYPE* const mat_data = mat.const_data_ptr<CTYPE>();
-    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
-
-    std::memcpy(out_data, mat_data, mat.numel() * sizeof(CTYPE));
-
-    if (divisible_by_28) {
-      apply_over_dim(
-          [log2_power_of_two_size, out_data](
-              const size_t size, const size_t stride, const size_t base) {
-            executorch::fast_hadamard_transform_28N(
-                out_data + base, log2_power_of_two_size);
-          },
-          out,
-          out.dim() - 1);
-    } else {
-      apply_over_dim(
-          [log2_power_of_two_size, out_data](
-              const size_t size, const size_t stride, const size_t base) {
-            executorch::fast_hadamard_transform(
-                out_data + base, log2_power_of_two_size);
-          },
-          out,
-          out.dim() - 1);
-    }
+    // Each row is transformed in a float buffer and quantized from
+    // there, so the transformed activations are never written out.
+    for_each_row(num_rows, row_length, [&](int64_t row, float* buffer) {
+      const CTYPE* src = mat_data + row * row_length;
+      for (int64_t ii = 0; ii < row_length; ++ii) {
+        buffer[ii] = static_cast<float>(src[ii]);
+      }
+      fast_hadamard_transform_row(buffer, row_size);
+      quantize_row_asymmetric(
+          buffer,
+          row_length,
+          out_data + row * row_length,
+          scales_data[row],
+          zero_points_data[row]);
+    });
   });
   return out;
 }
+
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -103,3 +305,8 @@ EXECUTORCH_LIBRARY(
     llama,
     "fast_hadamard_transform.out",
     torch::executor::native::fast_hadamard_transform_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "fast_hadamard_transform_quantize_per_token.out",
+    torch::executor::native::fast_hadamard_transform_quantize_per_token_out);
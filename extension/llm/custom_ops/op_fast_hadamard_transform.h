@@ -17,9 +17,24 @@ namespace torch::executor::native {
 // of mat along the last dimension (which must be contiguous).
 //
 // mat.sizes().back() is currently required to be either a power of
-// two, or 28 * a power of two.
+// two, or 12, 20, 28 or 40 * a power of two. The rows are transformed
+// in parallel, and Half rows are transformed in float.
 Tensor& fast_hadamard_transform_out(
     RuntimeContext& ctx,
     const Tensor& mat,
     Tensor& out);
+
+// fast_hadamard_transform followed by the int8 dynamic quantization of
+// every row of the result, as choose_qparams_per_token_asymmetric and
+// quantize_per_token would, without writing out the transformed mat.
+//
+// scales (Float) and zero_points (Long) are of the shape of mat with a
+// last dimension of 1, and receive the quantization parameters of each
+// row. out is Char.
+Tensor& fast_hadamard_transform_quantize_per_token_out(
+    RuntimeContext& ctx,
+    const Tensor& mat,
+    Tensor& scales,
+    Tensor& zero_points,
+    Tensor& out);
 } // namespace torch::executor::native
@@ -23,6 +23,25 @@ at::Tensor fast_hadamard_transform_aten(const at::Tensor& vec) {
   (vec, out);
   return out;
 }
+
+Tensor& fast_hadamard_transform_quantize_per_token_out_no_context(
+    const Tensor& mat,
+    Tensor& scales,
+    Tensor& zero_points,
+    Tensor& out) {
+  exec_aten::RuntimeContext context;
+  return fast_hadamard_transform_quantize_per_token_out(
+      context, mat, scales, zero_points, out);
+}
+at::Tensor fast_hadamard_transform_quantize_per_token_aten(
+    const at::Tensor& mat,
+    at::Tensor& scales,
+    at::Tensor& zero_points) {
+  auto out = at::empty_like(mat, at::kChar);
+  WRAP_TO_ATEN(fast_hadamard_transform_quantize_per_token_out_no_context, 3)
+  (mat, scales, zero_points, out);
+  return out;
+}
 } // namespace
 } // namespace torch::executor::native
 
@@ -30,6 +49,12 @@ TORCH_LIBRARY_FRAGMENT(llama, m) {
   m.def("fast_hadamard_transform(Tensor mat) -> Tensor");
   m.def(
       "fast_hadamard_transform.out(Tensor mat, *, Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "fast_hadamard_transform_quantize_per_token(Tensor mat, Tensor(a!) scales, "
+      "Tensor(b!) zero_points) -> Tensor");
+  m.def(
+      "fast_hadamard_transform_quantize_per_token.out(Tensor mat, "
+      "Tensor(a!) scales, Tensor(b!) zero_points, *, Tensor(c!) out) -> Tensor(c!)");
 }
 
 TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
@@ -40,4 +65,13 @@ TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
       "fast_hadamard_transform.out",
       WRAP_TO_ATEN(
           torch::executor::native::fast_hadamard_transform_out_no_context, 1));
+  m.impl(
+      "fast_hadamard_transform_quantize_per_token",
+      torch::executor::native::fast_hadamard_transform_quantize_per_token_aten);
+  m.impl(
+      "fast_hadamard_transform_quantize_per_token.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::
+              fast_hadamard_transform_quantize_per_token_out_no_context,
+          3));
 }
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_gathered_linear.h>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+// Rows of the weight per unit of parallel work. Each row is read once for
+// all of the rows of input, so this is how many dot products a task runs
+// per input row.
+constexpr int64_t kGatheredLinearGrainSize = 32;
+
+template <typename CTYPE>
+float dot(const CTYPE* a, const CTYPE* b, int64_t size) {
+  float sum = 0;
+  for (int64_t i = 0; i < size; ++i) {
+    sum += static_cast<float>(a[i]) * static_cast<float>(b[i]);
+  }
+  return sum;
+}
+
+template <>
+float dot<float>(const float* a, const float* b, int64_t size) {
+  using Vec = executorch::vec::Vectorized<float>;
+  constexpr int64_t kStep = 4 * Vec::size();
+  // Independent accumulators hide the latency of the fused multiply-adds.
+  Vec sum0(0), sum1(0), sum2(0), sum3(0);
+  int64_t i = 0;
+  for (; i + kStep <= size; i += kStep) {
+    sum0 = executorch::vec::fmadd(Vec::loadu(a + i), Vec::loadu(b + i), sum0);
+    sum1 = executorch::vec::fmadd(
+        Vec::loadu(a + i + Vec::size()), Vec::loadu(b + i + Vec::size()), sum1);
+    sum2 = executorch::vec::fmadd(
+        Vec::loadu(a + i + 2 * Vec::size()),
+        Vec::loadu(b + i + 2 * Vec::size()),
+        sum2);
+    sum3 = executorch::vec::fmadd(
+        Vec::loadu(a + i + 3 * Vec::size()),
+        Vec::loadu(b + i + 3 * Vec::size()),
+        sum3);
+  }
+  for (; i + Vec::size() <= size; i += Vec::size()) {
+    sum0 = executorch::vec::fmadd(Vec::loadu(a + i), Vec::loadu(b + i), sum0);
+  }
+  float lanes[Vec::size()];
+  ((sum0 + sum1) + (sum2 + sum3)).store(lanes);
+  float sum = 0;
+  for (int64_t l = 0; l < Vec::size(); ++l) {
+    sum += lanes[l];
+  }
+  for (; i < size; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+bool check_gathered_linear_args(
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    const Tensor& indices,
+    const Tensor& out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.dim() >= 1 && weight.dim() == 2 && indices.dim() == 1,
+      "Expected a 2D weight and 1D indices");
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, weight, out));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      indices.scalar_type() == ScalarType::Long, "Expected Long indices");
+  for (const Tensor* t : {&input, &weight, &indices, &out}) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(*t));
+  }
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.size(input.dim() - 1) == weight.size(1),
+      "Expected input to have %zd features, got %zd",
+      weight.size(1),
+      input.size(input.dim() - 1));
+  if (bias.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, bias.value()));
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        bias.value().dim() == 1 && bias.value().size(0) == weight.size(0),
+        "Expected bias of [out features]");
+  }
+  const int64_t* indices_data = indices.const_data_ptr<int64_t>();
+  for (ssize_t i = 0; i < indices.numel(); ++i) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        indices_data[i] >= 0 && indices_data[i] < weight.size(0),
+        "Index %" PRId64 " out of range for %zd rows",
+        indices_data[i],
+        weight.size(0));
+  }
+  return true;
+}
+
+template <typename CTYPE>
+void gathered_linear(
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    const Tensor& indices,
+    Tensor& out) {
+  const int64_t in_features = weight.size(1);
+  const int64_t num_indices = indices.numel();
+  const int64_t num_rows = in_features > 0 ? input.numel() / in_features : 0;
+
+  const CTYPE* input_data = input.const_data_ptr<CTYPE>();
+  const CTYPE* weight_data = weight.const_data_ptr<CTYPE>();
+  const CTYPE* bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+  const int64_t* indices_data = indices.const_data_ptr<int64_t>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  executorch::extension::parallel_for(
+      0,
+      num_indices,
+      kGatheredLinearGrainSize,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t index = indices_data[i];
+          const CTYPE* w = weight_data + index * in_features;
+          const float b =
+              bias_data != nullptr ? static_cast<float>(bias_data[index]) : 0;
+          for (int64_t r = 0; r < num_rows; ++r) {
+            out_data[r * num_indices + i] = static_cast<CTYPE>(
+                dot(input_data + r * in_features, w, in_features) + b);
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& gathered_linear_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    const Tensor& indices,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, input.dim() >= 1 && indices.dim() == 1, InvalidArgument, out);
+  exec_aten::SizesType out_sizes[kTensorDimensionLimit];
+  for (ssize_t d = 0; d < input.dim() - 1; ++d) {
+    out_sizes[d] = input.size(d);
+  }
+  out_sizes[input.dim() - 1] = indices.size(0);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {out_sizes, static_cast<size_t>(input.dim())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_gathered_linear_args(input, weight, bias, indices, out),
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  ET_SWITCH_FLOATH_TYPES(
+      input.scalar_type(), ctx, "gathered_linear.out", CTYPE, [&]() {
+        gathered_linear<CTYPE>(input, weight, bias, indices, out);
+      });
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "gathered_linear.out",
+    torch::executor::native::gathered_linear_out);
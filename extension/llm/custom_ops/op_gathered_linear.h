@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+// A linear layer that only computes the given rows of its weight, out[...,
+// i] = input @ weight[indices[i]] + bias[indices[i]]. weight is [out
+// features, in features], and indices, a Long tensor [num_indices], picks
+// rows in [0, out features). Meant for the output projection of an LLM
+// whose decoding is restricted to a subset of the vocabulary, where it reads
+// num_indices rows of the weight instead of all of them.
+Tensor& gathered_linear_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    const Tensor& indices,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
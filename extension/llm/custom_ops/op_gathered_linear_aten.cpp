@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/llm/custom_ops/op_gathered_linear.h>
+
+#include <torch/library.h>
+
+namespace torch::executor::native {
+namespace {
+Tensor& gathered_linear_out_no_context(
+    const Tensor& input,
+    const Tensor& weight,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> bias,
+    const Tensor& indices,
+    Tensor& out) {
+  exec_aten::RuntimeContext context;
+  return gathered_linear_out(context, input, weight, bias, indices, out);
+}
+at::Tensor gathered_linear_aten(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> bias,
+    const at::Tensor& indices) {
+  auto out_sizes = input.sizes().vec();
+  out_sizes.back() = indices.size(0);
+  auto out = at::empty(out_sizes, input.options());
+  WRAP_TO_ATEN(gathered_linear_out_no_context, 4)
+  (input, weight, bias, indices, out);
+  return out;
+}
+} // namespace
+} // namespace torch::executor::native
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def(
+      "gathered_linear(Tensor input, Tensor weight, Tensor? bias, "
+      "Tensor indices) -> Tensor");
+  m.def(
+      "gathered_linear.out(Tensor input, Tensor weight, Tensor? bias, "
+      "Tensor indices, *, Tensor(a!) out) -> Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl("gathered_linear", torch::executor::native::gathered_linear_aten);
+  m.impl(
+      "gathered_linear.out",
+      WRAP_TO_ATEN(torch::executor::native::gathered_linear_out_no_context, 4));
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_gathered_linear.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::testing::TensorFactory;
+
+class OpGatheredLinearOutTest : public OperatorTest {
+ protected:
+  Tensor& op_gathered_linear_out(
+      const Tensor& input,
+      const Tensor& weight,
+      const optional<Tensor>& bias,
+      const Tensor& indices,
+      Tensor& out) {
+    return torch::executor::native::gathered_linear_out(
+        context_, input, weight, bias, indices, out);
+  }
+
+  static constexpr int32_t kRows = 3;
+  // Covers the vectorized blocks and the scalar tail of the dot product.
+  static constexpr int32_t kIn = 45;
+  static constexpr int32_t kOut = 70;
+
+  // input @ weight[indices].T + bias[indices], row by row.
+  static std::vector<float> reference(
+      const std::vector<float>& input,
+      const std::vector<float>& weight,
+      const std::vector<float>& bias,
+      const std::vector<int64_t>& indices) {
+    std::vector<float> out(kRows * indices.size());
+    for (int32_t r = 0; r < kRows; ++r) {
+      for (size_t i = 0; i < indices.size(); ++i) {
+        double y = bias.empty() ? 0 : bias[indices[i]];
+        for (int32_t k = 0; k < kIn; ++k) {
+          y += input[r * kIn + k] * weight[indices[i] * kIn + k];
+        }
+        out[r * indices.size() + i] = y;
+      }
+    }
+    return out;
+  }
+
+  TensorFactory<ScalarType::Float> tf_;
+  TensorFactory<ScalarType::Long> tf_long_;
+  const std::vector<float> input_ = make_data(kRows * kIn, 0.37f);
+  const std::vector<float> weight_ = make_data(kOut * kIn, 0.53f);
+  const std::vector<float> bias_ = make_data(kOut, 0.71f);
+};
+
+TEST_F(OpGatheredLinearOutTest, ComputesOnlyGivenRows) {
+  // Unsorted, with a repeated row.
+  const std::vector<int64_t> indices = {69, 3, 41, 3, 0};
+  Tensor out = tf_.zeros({1, kRows, 5});
+  Tensor& ret = op_gathered_linear_out(
+      tf_.make({1, kRows, kIn}, input_),
+      tf_.make({kOut, kIn}, weight_),
+      tf_.make({kOut}, bias_),
+      tf_long_.make({5}, indices),
+      out);
+  EXPECT_TENSOR_EQ(ret, out);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out,
+      tf_.make({1, kRows, 5}, reference(input_, weight_, bias_, indices)),
+      1e-5,
+      1e-5);
+}
+
+TEST_F(OpGatheredLinearOutTest, AllRowsMatchLinear) {
+  std::vector<int64_t> indices(kOut);
+  for (int64_t i = 0; i < kOut; ++i) {
+    indices[i] = i;
+  }
+  Tensor out = tf_.zeros({kRows, kOut});
+  op_gathered_linear_out(
+      tf_.make({kRows, kIn}, input_),
+      tf_.make({kOut, kIn}, weight_),
+      {},
+      tf_long_.make({kOut}, indices),
+      out);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out,
+      tf_.make({kRows, kOut}, reference(input_, weight_, {}, indices)),
+      1e-5,
+      1e-5);
+}
+
+TEST_F(OpGatheredLinearOutTest, HalfInput) {
+  TensorFactory<ScalarType::Half> tf_half;
+  const std::vector<int64_t> indices = {5, 1};
+  Tensor out = tf_half.zeros({1, 2});
+  op_gathered_linear_out(
+      tf_half.make({1, 3}, {1.0, 2.0, 3.0}),
+      tf_half.full({6, 3}, 0.5),
+      {},
+      tf_long_.make({2}, indices),
+      out);
+  EXPECT_TENSOR_CLOSE(out, tf_half.make({1, 2}, {3.0, 3.0}));
+}
+
+TEST_F(OpGatheredLinearOutTest, IndexOutOfRangeDies) {
+  Tensor out = tf_.zeros({kRows, 2});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_gathered_linear_out(
+          tf_.make({kRows, kIn}, input_),
+          tf_.make({kOut, kIn}, weight_),
+          {},
+          tf_long_.make({2}, {0, kOut}),
+          out));
+}
+
+TEST_F(OpGatheredLinearOutTest, MismatchedFeaturesDies) {
+  Tensor out = tf_.zeros({kRows, 1});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_gathered_linear_out(
+          tf_.zeros({kRows, kIn + 1}),
+          tf_.make({kOut, kIn}, weight_),
+          {},
+          tf_long_.make({1}, {0}),
+          out));
+}
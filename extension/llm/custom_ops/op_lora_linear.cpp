@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_lora_linear.h>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+bool check_lora_linear_args(
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const optional<Tensor>& adapter_ids,
+    const Tensor& out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.dim() >= 1 && weight.dim() == 2 && lora_a.dim() == 3 &&
+          lora_b.dim() == 3,
+      "Expected a 2D weight and 3D lora_a and lora_b");
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, weight, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(weight, lora_a, lora_b));
+  for (const Tensor* t : {&input, &weight, &lora_a, &lora_b, &out}) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(*t));
+  }
+
+  const int64_t in_features = weight.size(1);
+  const int64_t out_features = weight.size(0);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      in_features > 0, "Expected at least one input feature");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input.size(input.dim() - 1) == in_features,
+      "Expected input to have %zd features, got %zd",
+      weight.size(1),
+      input.size(input.dim() - 1));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      lora_a.size(0) == lora_b.size(0) && lora_a.size(2) == in_features &&
+          lora_b.size(1) == out_features && lora_b.size(2) == lora_a.size(1),
+      "Expected lora_a of [num_adapters, rank, in features] and lora_b of "
+      "[num_adapters, out features, rank]");
+  if (bias.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, bias.value()));
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        bias.value().dim() == 1 && bias.value().size(0) == out_features,
+        "Expected bias of [out features]");
+  }
+  if (adapter_ids.has_value()) {
+    const Tensor& ids = adapter_ids.value();
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        ids.scalar_type() == ScalarType::Long, "Expected Long adapter_ids");
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        input.dim() >= 2 && ids.dim() == 1 && ids.size(0) == input.size(0),
+        "Expected an adapter id for every sequence of input");
+    const int64_t* ids_data = ids.const_data_ptr<int64_t>();
+    for (ssize_t i = 0; i < ids.size(0); ++i) {
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          ids_data[i] >= -1 && ids_data[i] < lora_a.size(0),
+          "Adapter id %" PRId64 " out of range for %zd adapters",
+          ids_data[i],
+          lora_a.size(0));
+    }
+  } else {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        lora_a.size(0) >= 1, "Expected an adapter without adapter_ids");
+  }
+  return true;
+}
+
+template <typename CTYPE>
+void lora_linear(
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const optional<Tensor>& adapter_ids,
+    const double scale,
+    Tensor& out) {
+  using ::executorch::cpublas::TransposeType;
+  const int64_t in_features = weight.size(1);
+  const int64_t out_features = weight.size(0);
+  const int64_t rank = lora_a.size(1);
+  const int64_t num_sequences = input.dim() >= 2 ? input.size(0) : 1;
+  const int64_t num_rows = input.numel() / in_features;
+  const int64_t rows_per_sequence = num_rows / num_sequences;
+
+  const CTYPE* input_data = input.const_data_ptr<CTYPE>();
+  const CTYPE* weight_data = weight.const_data_ptr<CTYPE>();
+  const CTYPE* bias_data =
+      bias.has_value() ? bias.value().const_data_ptr<CTYPE>() : nullptr;
+  const CTYPE* lora_a_data = lora_a.const_data_ptr<CTYPE>();
+  const CTYPE* lora_b_data = lora_b.const_data_ptr<CTYPE>();
+  const int64_t* ids_data = adapter_ids.has_value()
+      ? adapter_ids.value().const_data_ptr<int64_t>()
+      : nullptr;
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  // Each sequence is one unit of work, since that is the granularity at
+  // which the adapter changes. The rows of a sequence are computed together
+  // so that the weights are read once per sequence rather than per row.
+  executorch::extension::parallel_for(
+      0, num_sequences, 1, [&](int64_t begin, int64_t end) {
+        // input @ lora_a.T of the rows of a sequence.
+        std::vector<CTYPE> projected(rows_per_sequence * rank);
+        for (int64_t s = begin; s < end; ++s) {
+          const CTYPE* x = input_data + s * rows_per_sequence * in_features;
+          CTYPE* y = out_data + s * rows_per_sequence * out_features;
+          if (bias_data != nullptr) {
+            for (int64_t r = 0; r < rows_per_sequence; ++r) {
+              std::copy(
+                  bias_data, bias_data + out_features, y + r * out_features);
+            }
+          }
+          // The gemms are column-major, so y.T = weight @ x.T.
+          ::executorch::cpublas::gemm(
+              TransposeType::Transpose,
+              TransposeType::NoTranspose,
+              out_features,
+              rows_per_sequence,
+              in_features,
+              static_cast<CTYPE>(1),
+              weight_data,
+              in_features,
+              x,
+              in_features,
+              static_cast<CTYPE>(bias_data != nullptr ? 1 : 0),
+              y,
+              out_features);
+
+          const int64_t id = ids_data != nullptr ? ids_data[s] : 0;
+          if (id < 0 || rank == 0) {
+            continue;
+          }
+          ::executorch::cpublas::gemm(
+              TransposeType::Transpose,
+              TransposeType::NoTranspose,
+              rank,
+              rows_per_sequence,
+              in_features,
+              static_cast<CTYPE>(1),
+              lora_a_data + id * rank * in_features,
+              in_features,
+              x,
+              in_features,
+              static_cast<CTYPE>(0),
+              projected.data(),
+              rank);
+          ::executorch::cpublas::gemm(
+              TransposeType::Transpose,
+              TransposeType::NoTranspose,
+              out_features,
+              rows_per_sequence,
+              rank,
+              static_cast<CTYPE>(scale),
+              lora_b_data + id * out_features * rank,
+              rank,
+              projected.data(),
+              rank,
+              static_cast<CTYPE>(1),
+              y,
+              out_features);
+        }
+      });
+}
+
+} // namespace
+
+Tensor& lora_linear_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const optional<Tensor>& adapter_ids,
+    const double scale,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, input.dim() >= 1 && weight.dim() == 2, InvalidArgument, out);
+  exec_aten::SizesType out_sizes[kTensorDimensionLimit];
+  for (ssize_t d = 0; d < input.dim() - 1; ++d) {
+    out_sizes[d] = input.size(d);
+  }
+  out_sizes[input.dim() - 1] = weight.size(0);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {out_sizes, static_cast<size_t>(input.dim())}) ==
+          Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_lora_linear_args(
+          input, weight, bias, lora_a, lora_b, adapter_ids, out),
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  ET_SWITCH_FLOATH_TYPES(
+      input.scalar_type(), ctx, "lora_linear.out", CTYPE, [&]() {
+        lora_linear<CTYPE>(
+            input, weight, bias, lora_a, lora_b, adapter_ids, scale, out);
+      });
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "lora_linear.out",
+    torch::executor::native::lora_linear_out);
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+// A linear layer with a low-rank adapter, out = input @ weight.T + bias +
+// scale * (input @ lora_a[i].T) @ lora_b[i].T, in one pass over each
+// sequence of the batch. weight is [out features, in features], and lora_a
+// and lora_b stack num_adapters adapters, [num_adapters, rank, in features]
+// and [num_adapters, out features, rank]. adapter_ids, [batch], picks the
+// adapter i of every sequence of input, [batch, ..., in features], so that
+// the sequences of one batch can use different adapters; -1 skips the
+// adapter. Without adapter_ids every sequence uses adapter 0.
+Tensor& lora_linear_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    const Tensor& weight,
+    const optional<Tensor>& bias,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    const optional<Tensor>& adapter_ids,
+    const double scale,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
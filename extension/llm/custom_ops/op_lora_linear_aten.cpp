@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/llm/custom_ops/op_lora_linear.h>
+
+#include <torch/library.h>
+
+namespace torch::executor::native {
+namespace {
+Tensor& lora_linear_out_no_context(
+    const Tensor& input,
+    const Tensor& weight,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> bias,
+    const Tensor& lora_a,
+    const Tensor& lora_b,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> adapter_ids,
+    const double scale,
+    Tensor& out) {
+  exec_aten::RuntimeContext context;
+  return lora_linear_out(
+      context, input, weight, bias, lora_a, lora_b, adapter_ids, scale, out);
+}
+at::Tensor lora_linear_aten(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> bias,
+    const at::Tensor& lora_a,
+    const at::Tensor& lora_b,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> adapter_ids,
+    const double scale) {
+  auto out_sizes = input.sizes().vec();
+  out_sizes.back() = weight.size(0);
+  auto out = at::empty(out_sizes, input.options());
+  WRAP_TO_ATEN(lora_linear_out_no_context, 7)
+  (input, weight, bias, lora_a, lora_b, adapter_ids, scale, out);
+  return out;
+}
+} // namespace
+} // namespace torch::executor::native
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def(
+      "lora_linear(Tensor input, Tensor weight, Tensor? bias, "
+      "Tensor lora_a, Tensor lora_b, Tensor? adapter_ids=None, "
+      "float scale=1.0) -> Tensor");
+  m.def(
+      "lora_linear.out(Tensor input, Tensor weight, Tensor? bias, "
+      "Tensor lora_a, Tensor lora_b, Tensor? adapter_ids=None, "
+      "float scale=1.0, *, Tensor(a!) out) -> Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl("lora_linear", torch::executor::native::lora_linear_aten);
+  m.impl(
+      "lora_linear.out",
+      WRAP_TO_ATEN(torch::executor::native::lora_linear_out_no_context, 7));
+}
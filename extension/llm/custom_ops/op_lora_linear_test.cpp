@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_lora_linear.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::testing::TensorFactory;
+
+class OpLoraLinearOutTest : public OperatorTest {
+ protected:
+  Tensor& op_lora_linear_out(
+      const Tensor& input,
+      const Tensor& weight,
+      const optional<Tensor>& bias,
+      const Tensor& lora_a,
+      const Tensor& lora_b,
+      const optional<Tensor>& adapter_ids,
+      double scale,
+      Tensor& out) {
+    return torch::executor::native::lora_linear_out(
+        context_, input, weight, bias, lora_a, lora_b, adapter_ids, scale, out);
+  }
+
+  static constexpr int32_t kBatch = 3;
+  static constexpr int32_t kSeqLen = 2;
+  static constexpr int32_t kIn = 6;
+  static constexpr int32_t kOut = 5;
+  static constexpr int32_t kRank = 2;
+  static constexpr int32_t kAdapters = 2;
+
+  // input @ weight.T + bias + scale * input @ lora_a[id].T @ lora_b[id].T
+  // for every sequence, computed row by row.
+  static std::vector<float> reference(
+      const std::vector<float>& input,
+      const std::vector<float>& weight,
+      const std::vector<float>& bias,
+      const std::vector<float>& lora_a,
+      const std::vector<float>& lora_b,
+      const std::vector<int64_t>& ids,
+      double scale) {
+    std::vector<float> out(kBatch * kSeqLen * kOut);
+    for (int32_t b = 0; b < kBatch; ++b) {
+      for (int32_t s = 0; s < kSeqLen; ++s) {
+        const float* x = input.data() + (b * kSeqLen + s) * kIn;
+        float projected[kRank] = {};
+        if (ids[b] >= 0) {
+          for (int32_t r = 0; r < kRank; ++r) {
+            for (int32_t i = 0; i < kIn; ++i) {
+              projected[r] += x[i] * lora_a[(ids[b] * kRank + r) * kIn + i];
+            }
+          }
+        }
+        for (int32_t o = 0; o < kOut; ++o) {
+          double y = bias.empty() ? 0 : bias[o];
+          for (int32_t i = 0; i < kIn; ++i) {
+            y += x[i] * weight[o * kIn + i];
+          }
+          if (ids[b] >= 0) {
+            for (int32_t r = 0; r < kRank; ++r) {
+              y += scale * projected[r] *
+                  lora_b[(ids[b] * kOut + o) * kRank + r];
+            }
+          }
+          out[(b * kSeqLen + s) * kOut + o] = y;
+        }
+      }
+    }
+    return out;
+  }
+
+  TensorFactory<ScalarType::Float> tf_;
+  const std::vector<float> input_ = make_data(kBatch * kSeqLen * kIn, 0.37f);
+  const std::vector<float> weight_ = make_data(kOut * kIn, 0.53f);
+  const std::vector<float> bias_ = make_data(kOut, 0.71f);
+  const std::vector<float> lora_a_ = make_data(kAdapters * kRank * kIn, 0.29f);
+  const std::vector<float> lora_b_ =
+      make_data(kAdapters * kOut * kRank, 0.91f);
+};
+
+TEST_F(OpLoraLinearOutTest, PerSequenceAdapters) {
+  TensorFactory<ScalarType::Long> tf_long;
+  // The sequences of the batch use the second adapter, none and the first.
+  const std::vector<int64_t> ids = {1, -1, 0};
+  Tensor out = tf_.zeros({kBatch, kSeqLen, kOut});
+  Tensor& ret = op_lora_linear_out(
+      tf_.make({kBatch, kSeqLen, kIn}, input_),
+      tf_.make({kOut, kIn}, weight_),
+      tf_.make({kOut}, bias_),
+      tf_.make({kAdapters, kRank, kIn}, lora_a_),
+      tf_.make({kAdapters, kOut, kRank}, lora_b_),
+      tf_long.make({kBatch}, ids),
+      0.5,
+      out);
+  EXPECT_TENSOR_EQ(ret, out);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out,
+      tf_.make(
+          {kBatch, kSeqLen, kOut},
+          reference(input_, weight_, bias_, lora_a_, lora_b_, ids, 0.5)),
+      1e-5,
+      1e-6);
+}
+
+TEST_F(OpLoraLinearOutTest, WithoutAdapterIdsUsesFirstAdapter) {
+  Tensor out = tf_.zeros({kBatch, kSeqLen, kOut});
+  op_lora_linear_out(
+      tf_.make({kBatch, kSeqLen, kIn}, input_),
+      tf_.make({kOut, kIn}, weight_),
+      {},
+      tf_.make({kAdapters, kRank, kIn}, lora_a_),
+      tf_.make({kAdapters, kOut, kRank}, lora_b_),
+      {},
+      2.0,
+      out);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      out,
+      tf_.make(
+          {kBatch, kSeqLen, kOut},
+          reference(input_, weight_, {}, lora_a_, lora_b_, {0, 0, 0}, 2.0)),
+      1e-5,
+      1e-6);
+}
+
+TEST_F(OpLoraLinearOutTest, AdapterIdOutOfRangeDies) {
+  TensorFactory<ScalarType::Long> tf_long;
+  Tensor out = tf_.zeros({kBatch, kSeqLen, kOut});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_lora_linear_out(
+          tf_.make({kBatch, kSeqLen, kIn}, input_),
+          tf_.make({kOut, kIn}, weight_),
+          {},
+          tf_.make({kAdapters, kRank, kIn}, lora_a_),
+          tf_.make({kAdapters, kOut, kRank}, lora_b_),
+          tf_long.make({kBatch}, {0, kAdapters, 0}),
+          1.0,
+          out));
+}
+
+TEST_F(OpLoraLinearOutTest, MismatchedRankDies) {
+  Tensor out = tf_.zeros({kBatch, kSeqLen, kOut});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_lora_linear_out(
+          tf_.make({kBatch, kSeqLen, kIn}, input_),
+          tf_.make({kOut, kIn}, weight_),
+          {},
+          tf_.make({kAdapters, kRank, kIn}, lora_a_),
+          tf_.zeros({kAdapters, kOut, kRank + 1}),
+          {},
+          1.0,
+          out));
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/llm/custom_ops/op_update_cache.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_update_cache_paged(
+    const Tensor& value,
+    Tensor& cache,
+    const Tensor& block_table,
+    int64_t start_pos,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::update_cache_paged_out(
+      context, value, cache, block_table, start_pos, out);
+}
+
+} // namespace
+
+TEST(OpPagedKVCacheTest, UpdateCacheWritesByBlockTable) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // 4 blocks of 2 positions, one head of dim 2.
+  Tensor cache = tf.zeros({4, 2, 1, 2});
+  Tensor block_table = tfl.make({1, 3}, {2, 0, 3});
+  Tensor value = tf.make({1, 3, 1, 2}, {1, 2, 3, 4, 5, 6});
+  Tensor out = tf.zeros({1});
+
+  op_update_cache_paged(value, cache, block_table, /*start_pos=*/1, out);
+
+  // Position 1 is the second slot of block 2, positions 2 and 3 fill block 0.
+  // clang-format off
+  EXPECT_TENSOR_EQ(cache, tf.make({4, 2, 1, 2}, {
+      3, 4, 5, 6,
+      0, 0, 0, 0,
+      0, 0, 1, 2,
+      0, 0, 0, 0,
+  }));
+  // clang-format on
+}
+
+TEST(OpPagedKVCacheTest, UpdateCacheRejectsBadBlock) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  Tensor cache = tf.zeros({2, 2, 1, 2});
+  Tensor block_table = tfl.make({1, 2}, {1, 5});
+  Tensor value = tf.ones({1, 2, 1, 2});
+  Tensor out = tf.zeros({1});
+
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::update_cache_paged_out(
+      context, value, cache, block_table, /*start_pos=*/1, out);
+  EXPECT_NE(context.failure_state(), executorch::runtime::Error::Ok);
+  // Nothing is written when any of the blocks is invalid.
+  EXPECT_TENSOR_EQ(cache, tf.zeros({2, 2, 1, 2}));
+}
+
+// Runs the same attention with a contiguous cache and with a paged cache
+// whose blocks are scattered across the pool.
+TEST(OpPagedKVCacheTest, SdpaMatchesContiguousCache) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  constexpr int32_t kBatch = 2;
+  constexpr int32_t kMaxSeqLen = 8;
+  constexpr int32_t kHeads = 2;
+  constexpr int32_t kDim = 4;
+  constexpr int32_t kBlockSize = 3;
+  constexpr int64_t kStartPos = 5;
+  constexpr int32_t kSeqLen = 2;
+  const int64_t kv_len = kStartPos + kSeqLen;
+
+  Tensor k = tf.make(
+      {kBatch, kMaxSeqLen, kHeads, kDim},
+      make_data(kBatch * kMaxSeqLen * kHeads * kDim, 0.37f));
+  Tensor v = tf.make(
+      {kBatch, kMaxSeqLen, kHeads, kDim},
+      make_data(kBatch * kMaxSeqLen * kHeads * kDim, 0.53f));
+  Tensor q = tf.make(
+      {kBatch, kSeqLen, kHeads, kDim},
+      make_data(kBatch * kSeqLen * kHeads * kDim, 0.71f));
+
+  // Each sequence needs 3 blocks for its 7 positions.
+  Tensor block_table = tfl.make({kBatch, 3}, {4, 0, 6, 2, 5, 1});
+  Tensor k_pool = tf.zeros({7, kBlockSize, kHeads, kDim});
+  Tensor v_pool = tf.zeros({7, kBlockSize, kHeads, kDim});
+  Tensor k_prefix = tf.zeros({kBatch, kv_len, kHeads, kDim});
+  Tensor v_prefix = tf.zeros({kBatch, kv_len, kHeads, kDim});
+  const size_t row = kHeads * kDim;
+  for (int32_t b = 0; b < kBatch; ++b) {
+    std::copy(
+        k.const_data_ptr<float>() + b * kMaxSeqLen * row,
+        k.const_data_ptr<float>() + (b * kMaxSeqLen + kv_len) * row,
+        k_prefix.mutable_data_ptr<float>() + b * kv_len * row);
+    std::copy(
+        v.const_data_ptr<float>() + b * kMaxSeqLen * row,
+        v.const_data_ptr<float>() + (b * kMaxSeqLen + kv_len) * row,
+        v_prefix.mutable_data_ptr<float>() + b * kv_len * row);
+  }
+  Tensor unused = tf.zeros({1});
+  op_update_cache_paged(k_prefix, k_pool, block_table, 0, unused);
+  op_update_cache_paged(v_prefix, v_pool, block_table, 0, unused);
+
+  for (bool is_causal : {false, true}) {
+    executorch::runtime::KernelRuntimeContext context{};
+    Tensor expected = tf.zeros({kBatch, kSeqLen, kHeads, kDim});
+    torch::executor::native::custom_sdpa_out(
+        context, q, k, v, kStartPos, {}, 0.0, is_causal, {}, expected);
+
+    Tensor out = tf.zeros({kBatch, kSeqLen, kHeads, kDim});
+    torch::executor::native::custom_sdpa_paged_out(
+        context,
+        q,
+        k_pool,
+        v_pool,
+        block_table,
+        kStartPos,
+        {},
+        0.0,
+        is_causal,
+        {},
+        out);
+    ASSERT_EQ(context.failure_state(), executorch::runtime::Error::Ok);
+    EXPECT_TENSOR_CLOSE(out, expected);
+  }
+}
+
+TEST(OpPagedKVCacheTest, SdpaWithPagedKVCacheUpdatesThenAttends) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // A single position: attention returns the value that was just written.
+  Tensor q = tf.make({1, 1, 1, 2}, {0.5, -0.5});
+  Tensor k = tf.make({1, 1, 1, 2}, {1, 2});
+  Tensor v = tf.make({1, 1, 1, 2}, {3, 4});
+  Tensor k_pool = tf.zeros({2, 4, 1, 2});
+  Tensor v_pool = tf.zeros({2, 4, 1, 2});
+  Tensor block_table = tfl.make({1, 1}, {1});
+  Tensor out = tf.zeros({1, 1, 1, 2});
+
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::sdpa_with_paged_kv_cache_out(
+      context,
+      q,
+      k,
+      v,
+      k_pool,
+      v_pool,
+      block_table,
+      /*start_pos=*/0,
+      {},
+      0.0,
+      /*is_causal=*/true,
+      {},
+      out);
+  ASSERT_EQ(context.failure_state(), executorch::runtime::Error::Ok);
+  EXPECT_TENSOR_CLOSE(out, v);
+  EXPECT_EQ(k_pool.const_data_ptr<float>()[8], 1);
+  EXPECT_EQ(v_pool.const_data_ptr<float>()[9], 4);
+}
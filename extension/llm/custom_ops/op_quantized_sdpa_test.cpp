@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_custom_sdpa(
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    int64_t start_pos,
+    bool is_causal,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::custom_sdpa_out(
+      context, q, k, v, start_pos, {}, 0.0, is_causal, {}, out);
+}
+
+Tensor& op_custom_quantized_sdpa(
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    const Tensor& k_scales,
+    const Tensor& k_zero_points,
+    const Tensor& v_scales,
+    const Tensor& v_zero_points,
+    int64_t start_pos,
+    bool is_causal,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::custom_quantized_sdpa_out(
+      context,
+      q,
+      k,
+      v,
+      k_scales,
+      k_zero_points,
+      v_scales,
+      v_zero_points,
+      start_pos,
+      {},
+      0.0,
+      is_causal,
+      {},
+      out);
+}
+
+Tensor& op_sdpa_with_quantized_kv_cache(
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    Tensor& k_cache,
+    Tensor& v_cache,
+    Tensor& k_scales,
+    Tensor& k_zero_points,
+    Tensor& v_scales,
+    Tensor& v_zero_points,
+    int64_t start_pos,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::sdpa_with_quantized_kv_cache_out(
+      context,
+      q,
+      k,
+      v,
+      k_cache,
+      v_cache,
+      k_scales,
+      k_zero_points,
+      v_scales,
+      v_zero_points,
+      start_pos,
+      {},
+      0.0,
+      /*is_causal=*/true,
+      {},
+      out);
+}
+
+std::vector<float> make_uneven_data(size_t size, float step) {
+  std::vector<float> data = make_data(size, step);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] += 0.25f * std::cos(0.1f * i);
+  }
+  return data;
+}
+
+// scale * (cache - zero point), with the parameters of token s of head h at
+// [b, s or 0, h].
+std::vector<float> dequantize(
+    const Tensor& cache,
+    const Tensor& scales,
+    const Tensor& zero_points) {
+  const int64_t batch = cache.size(0);
+  const int64_t seq = cache.size(1);
+  const int64_t heads = cache.size(2);
+  const int64_t dim = cache.size(3);
+  const int64_t qparam_seq = scales.size(1);
+  std::vector<float> out(cache.numel());
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t s = 0; s < seq; ++s) {
+      for (int64_t h = 0; h < heads; ++h) {
+        const int64_t t = (b * seq + s) * heads + h;
+        const int64_t p =
+            (b * qparam_seq + (qparam_seq == 1 ? 0 : s)) * heads + h;
+        const double scale = scales.const_data_ptr<double>()[p];
+        const int64_t zero_point = zero_points.const_data_ptr<int64_t>()[p];
+        for (int64_t d = 0; d < dim; ++d) {
+          out[t * dim + d] = static_cast<float>(
+              scale * (cache.const_data_ptr<int8_t>()[t * dim + d] -
+                       zero_point));
+        }
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+// Quantizing the new tokens into the cache round-trips them to within half
+// a quantization step.
+TEST(OpQuantizedSdpaTest, QuantizesNewTokensIntoCache) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tfc;
+  TensorFactory<ScalarType::Double> tfd;
+  TensorFactory<ScalarType::Long> tfl;
+
+  constexpr int32_t kMaxSeqLen = 6;
+  constexpr int32_t kHeads = 2;
+  constexpr int32_t kDim = 8;
+  constexpr int64_t kStartPos = 2;
+  constexpr int32_t kSeqLen = 3;
+
+  Tensor q = tf.make(
+      {1, kSeqLen, kHeads, kDim},
+      make_uneven_data(kSeqLen * kHeads * kDim, 0.3f));
+  Tensor k = tf.make(
+      {1, kSeqLen, kHeads, kDim},
+      make_uneven_data(kSeqLen * kHeads * kDim, 0.7f));
+  Tensor v = tf.make(
+      {1, kSeqLen, kHeads, kDim},
+      make_uneven_data(kSeqLen * kHeads * kDim, 1.1f));
+  Tensor k_cache = tfc.zeros({1, kMaxSeqLen, kHeads, kDim});
+  Tensor v_cache = tfc.zeros({1, kMaxSeqLen, kHeads, kDim});
+  Tensor k_scales = tfd.ones({1, kMaxSeqLen, kHeads, 1});
+  Tensor v_scales = tfd.ones({1, kMaxSeqLen, kHeads, 1});
+  Tensor k_zero_points = tfl.zeros({1, kMaxSeqLen, kHeads, 1});
+  Tensor v_zero_points = tfl.zeros({1, kMaxSeqLen, kHeads, 1});
+  Tensor out = tf.zeros({1, kSeqLen, kHeads, kDim});
+
+  op_sdpa_with_quantized_kv_cache(
+      q,
+      k,
+      v,
+      k_cache,
+      v_cache,
+      k_scales,
+      k_zero_points,
+      v_scales,
+      v_zero_points,
+      kStartPos,
+      out);
+
+  const std::vector<float> k_dequantized =
+      dequantize(k_cache, k_scales, k_zero_points);
+  const size_t row = kHeads * kDim;
+  for (size_t i = 0; i < kSeqLen * row; ++i) {
+    const size_t token = (kStartPos * row + i) / kDim;
+    const double step = k_scales.const_data_ptr<double>()[token];
+    EXPECT_NEAR(
+        k_dequantized[kStartPos * row + i],
+        k.const_data_ptr<float>()[i],
+        step / 2 + 1e-6);
+  }
+  // The other positions are left alone.
+  for (size_t i = 0; i < kStartPos * row; ++i) {
+    EXPECT_EQ(k_cache.const_data_ptr<int8_t>()[i], 0);
+    EXPECT_EQ(v_cache.const_data_ptr<int8_t>()[i], 0);
+  }
+}
+
+// Prefills a quantized cache and decodes a token after it, checking both
+// against custom_sdpa over the same cache dequantized to float. The only
+// difference left is the quantization of the query rows.
+TEST(OpQuantizedSdpaTest, MatchesSdpaOverDequantizedCache) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tfc;
+  TensorFactory<ScalarType::Double> tfd;
+  TensorFactory<ScalarType::Long> tfl;
+
+  constexpr int32_t kBatch = 2;
+  // More than one block of keys and of queries.
+  constexpr int32_t kMaxSeqLen = 300;
+  constexpr int32_t kPrefill = 290;
+  // Grouped query attention, 2 query heads per kv head.
+  constexpr int32_t kHeads = 4;
+  constexpr int32_t kKVHeads = 2;
+  constexpr int32_t kDim = 16;
+  // Spread the blocks of queries over several threads.
+  ::executorch::extension::threadpool::ThreadPool threadpool(4);
+  ::executorch::extension::threadpool::ThreadPoolGuard guard(&threadpool);
+
+  Tensor k_cache = tfc.zeros({kBatch, kMaxSeqLen, kKVHeads, kDim});
+  Tensor v_cache = tfc.zeros({kBatch, kMaxSeqLen, kKVHeads, kDim});
+  Tensor k_scales = tfd.ones({kBatch, kMaxSeqLen, kKVHeads, 1});
+  Tensor v_scales = tfd.ones({kBatch, kMaxSeqLen, kKVHeads, 1});
+  Tensor k_zero_points = tfl.zeros({kBatch, kMaxSeqLen, kKVHeads, 1});
+  Tensor v_zero_points = tfl.zeros({kBatch, kMaxSeqLen, kKVHeads, 1});
+
+  const std::vector<std::pair<int64_t, int32_t>> steps = {
+      {0, kPrefill}, {kPrefill, 1}};
+  for (const auto& [start_pos, seq_len] : steps) {
+    const size_t q_size = kBatch * seq_len * kHeads * kDim;
+    const size_t kv_size = kBatch * seq_len * kKVHeads * kDim;
+    Tensor q = tf.make(
+        {kBatch, seq_len, kHeads, kDim},
+        make_uneven_data(q_size, 0.29f + start_pos));
+    Tensor k = tf.make(
+        {kBatch, seq_len, kKVHeads, kDim},
+        make_uneven_data(kv_size, 0.37f + start_pos));
+    Tensor v = tf.make(
+        {kBatch, seq_len, kKVHeads, kDim},
+        make_uneven_data(kv_size, 0.53f + start_pos));
+    Tensor out = tf.zeros({kBatch, seq_len, kHeads, kDim});
+    op_sdpa_with_quantized_kv_cache(
+        q,
+        k,
+        v,
+        k_cache,
+        v_cache,
+        k_scales,
+        k_zero_points,
+        v_scales,
+        v_zero_points,
+        start_pos,
+        out);
+
+    Tensor k_float = tf.make(
+        {kBatch, kMaxSeqLen, kKVHeads, kDim},
+        dequantize(k_cache, k_scales, k_zero_points));
+    Tensor v_float = tf.make(
+        {kBatch, kMaxSeqLen, kKVHeads, kDim},
+        dequantize(v_cache, v_scales, v_zero_points));
+    Tensor expected = tf.zeros({kBatch, seq_len, kHeads, kDim});
+    op_custom_sdpa(q, k_float, v_float, start_pos, true, expected);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-2, 1e-2);
+  }
+}
+
+// One scale and zero point per head, shared by all of its tokens.
+TEST(OpQuantizedSdpaTest, SupportsPerHeadScales) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tfc;
+  TensorFactory<ScalarType::Double> tfd;
+  TensorFactory<ScalarType::Long> tfl;
+
+  constexpr int32_t kSeqLen = 5;
+  constexpr int32_t kHeads = 2;
+  constexpr int32_t kDim = 4;
+  constexpr int32_t kSize = kSeqLen * kHeads * kDim;
+
+  std::vector<int8_t> k_data(kSize), v_data(kSize);
+  for (int32_t i = 0; i < kSize; ++i) {
+    k_data[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+    v_data[i] = static_cast<int8_t>((i * 53) % 255 - 127);
+  }
+  Tensor k_cache = tfc.make({1, kSeqLen, kHeads, kDim}, k_data);
+  Tensor v_cache = tfc.make({1, kSeqLen, kHeads, kDim}, v_data);
+  Tensor k_scales = tfd.make({1, 1, kHeads, 1}, {0.01, 0.02});
+  Tensor v_scales = tfd.make({1, 1, kHeads, 1}, {0.03, 0.005});
+  Tensor k_zero_points = tfl.make({1, 1, kHeads, 1}, {3, -7});
+  Tensor v_zero_points = tfl.make({1, 1, kHeads, 1}, {0, 11});
+
+  Tensor q =
+      tf.make({1, 1, kHeads, kDim}, make_uneven_data(kHeads * kDim, 0.9f));
+  Tensor out = tf.zeros({1, 1, kHeads, kDim});
+  op_custom_quantized_sdpa(
+      q,
+      k_cache,
+      v_cache,
+      k_scales,
+      k_zero_points,
+      v_scales,
+      v_zero_points,
+      /*start_pos=*/kSeqLen - 1,
+      /*is_causal=*/true,
+      out);
+
+  Tensor k_float = tf.make(
+      {1, kSeqLen, kHeads, kDim}, dequantize(k_cache, k_scales, k_zero_points));
+  Tensor v_float = tf.make(
+      {1, kSeqLen, kHeads, kDim}, dequantize(v_cache, v_scales, v_zero_points));
+  Tensor expected = tf.zeros({1, 1, kHeads, kDim});
+  op_custom_sdpa(q, k_float, v_float, kSeqLen - 1, true, expected);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-2, 1e-2);
+}
+
+TEST(OpQuantizedSdpaTest, RejectsFloatCache) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tfd;
+  TensorFactory<ScalarType::Long> tfl;
+
+  Tensor q = tf.ones({1, 1, 1, 4});
+  Tensor cache = tf.zeros({1, 2, 1, 4});
+  Tensor scales = tfd.ones({1, 2, 1, 1});
+  Tensor zero_points = tfl.zeros({1, 2, 1, 1});
+  Tensor out = tf.zeros({1, 1, 1, 4});
+
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::custom_quantized_sdpa_out(
+      context,
+      q,
+      cache,
+      cache,
+      scales,
+      zero_points,
+      scales,
+      zero_points,
+      /*start_pos=*/0,
+      {},
+      0.0,
+      /*is_causal=*/true,
+      {},
+      out);
+  EXPECT_NE(context.failure_state(), executorch::runtime::Error::Ok);
+}
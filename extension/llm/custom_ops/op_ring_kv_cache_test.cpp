@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/llm/custom_ops/op_update_cache.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::extension::llm::testing::make_data;
+using executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+Tensor& op_update_cache_ring(
+    const Tensor& value,
+    Tensor& cache,
+    int64_t start_pos,
+    int64_t sink_size,
+    Tensor& out) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::update_cache_ring_out(
+      context, value, cache, start_pos, sink_size, out);
+}
+
+// Positions [begin, end) of data, [batch, seq_len, heads, dim].
+std::vector<float> slice_positions(
+    const std::vector<float>& data,
+    int32_t batch,
+    int32_t seq_len,
+    int32_t row,
+    int32_t begin,
+    int32_t end) {
+  std::vector<float> result;
+  for (int32_t b = 0; b < batch; ++b) {
+    result.insert(
+        result.end(),
+        data.begin() + (b * seq_len + begin) * row,
+        data.begin() + (b * seq_len + end) * row);
+  }
+  return result;
+}
+
+// Attends with a chunk of kSeqLen queries at start_pos through
+// sdpa_with_ring_kv_cache, after writing the positions before it to the
+// ring caches, and checks every query against custom_sdpa over a contiguous
+// cache of the sinks and the part of the window that it may see.
+void expect_ring_matches_reference(
+    int32_t batch,
+    int32_t heads,
+    int32_t kv_heads,
+    int32_t dim,
+    int32_t sink_size,
+    int32_t window_size,
+    int32_t start_pos,
+    int32_t seq_len) {
+  TensorFactory<ScalarType::Float> tf;
+  const int32_t end = start_pos + seq_len;
+  const int32_t kv_row = kv_heads * dim;
+  const int32_t q_row = heads * dim;
+  const std::vector<float> k_data = make_data(batch * end * kv_row, 0.37f);
+  const std::vector<float> v_data = make_data(batch * end * kv_row, 0.53f);
+  const std::vector<float> q_data = make_data(batch * seq_len * q_row, 0.71f);
+
+  Tensor k_cache = tf.zeros({batch, sink_size + window_size, kv_heads, dim});
+  Tensor v_cache = tf.zeros({batch, sink_size + window_size, kv_heads, dim});
+  Tensor unused = tf.zeros({1});
+  for (int32_t pos = 0; pos < start_pos; pos += window_size) {
+    const int32_t next = std::min(pos + window_size, start_pos);
+    Tensor k = tf.make(
+        {batch, next - pos, kv_heads, dim},
+        slice_positions(k_data, batch, end, kv_row, pos, next));
+    Tensor v = tf.make(
+        {batch, next - pos, kv_heads, dim},
+        slice_positions(v_data, batch, end, kv_row, pos, next));
+    op_update_cache_ring(k, k_cache, pos, sink_size, unused);
+    op_update_cache_ring(v, v_cache, pos, sink_size, unused);
+  }
+
+  Tensor q = tf.make({batch, seq_len, heads, dim}, q_data);
+  Tensor k = tf.make(
+      {batch, seq_len, kv_heads, dim},
+      slice_positions(k_data, batch, end, kv_row, start_pos, end));
+  Tensor v = tf.make(
+      {batch, seq_len, kv_heads, dim},
+      slice_positions(v_data, batch, end, kv_row, start_pos, end));
+  Tensor out = tf.zeros({batch, seq_len, heads, dim});
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::sdpa_with_ring_kv_cache_out(
+      context,
+      q,
+      k,
+      v,
+      k_cache,
+      v_cache,
+      start_pos,
+      sink_size,
+      0.0,
+      {},
+      out);
+  ASSERT_EQ(context.failure_state(), executorch::runtime::Error::Ok);
+
+  // The oldest position that the cache still holds past the sinks.
+  const int32_t window_begin = std::max(sink_size, end - window_size);
+  for (int32_t t = start_pos; t < end; ++t) {
+    std::vector<float> k_visible;
+    std::vector<float> v_visible;
+    for (int32_t b = 0; b < batch; ++b) {
+      for (int32_t range : {0, 1}) {
+        const int32_t begin = range == 0 ? 0 : window_begin;
+        const int32_t stop = range == 0 ? std::min(sink_size, t + 1) : t + 1;
+        for (int32_t pos = begin; pos < stop; ++pos) {
+          const auto* k_pos = k_data.data() + (b * end + pos) * kv_row;
+          const auto* v_pos = v_data.data() + (b * end + pos) * kv_row;
+          k_visible.insert(k_visible.end(), k_pos, k_pos + kv_row);
+          v_visible.insert(v_visible.end(), v_pos, v_pos + kv_row);
+        }
+      }
+    }
+    const int32_t num_visible = k_visible.size() / (batch * kv_row);
+    Tensor k_ref = tf.make({batch, num_visible, kv_heads, dim}, k_visible);
+    Tensor v_ref = tf.make({batch, num_visible, kv_heads, dim}, v_visible);
+    Tensor q_t = tf.make(
+        {batch, 1, heads, dim},
+        slice_positions(
+            q_data, batch, seq_len, q_row, t - start_pos, t - start_pos + 1));
+    Tensor expected = tf.zeros({batch, 1, heads, dim});
+    torch::executor::native::custom_sdpa_out(
+        context,
+        q_t,
+        k_ref,
+        v_ref,
+        num_visible - 1,
+        {},
+        0.0,
+        false,
+        {},
+        expected);
+    Tensor out_t = tf.make(
+        {batch, 1, heads, dim},
+        slice_positions(
+            std::vector<float>(
+                out.const_data_ptr<float>(),
+                out.const_data_ptr<float>() + out.numel()),
+            batch,
+            seq_len,
+            q_row,
+            t - start_pos,
+            t - start_pos + 1));
+    EXPECT_TENSOR_CLOSE_WITH_TOL(out_t, expected, 1e-5, 1e-6);
+  }
+}
+
+} // namespace
+
+TEST(OpRingKVCacheTest, UpdateCacheWrapsAroundWindow) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // 2 sinks and a window of 3, one head of dim 1.
+  Tensor cache = tf.zeros({1, 5, 1, 1});
+  Tensor out = tf.zeros({1});
+
+  op_update_cache_ring(tf.make({1, 3, 1, 1}, {0, 1, 2}), cache, 0, 2, out);
+  EXPECT_TENSOR_EQ(cache, tf.make({1, 5, 1, 1}, {0, 1, 2, 0, 0}));
+
+  // Positions 3 and 4 fill the window, and 5 takes the slot of 2.
+  op_update_cache_ring(tf.make({1, 3, 1, 1}, {3, 4, 5}), cache, 3, 2, out);
+  EXPECT_TENSOR_EQ(cache, tf.make({1, 5, 1, 1}, {0, 1, 5, 3, 4}));
+
+  op_update_cache_ring(tf.make({1, 2, 1, 1}, {6, 7}), cache, 6, 2, out);
+  EXPECT_TENSOR_EQ(cache, tf.make({1, 5, 1, 1}, {0, 1, 5, 6, 7}));
+}
+
+TEST(OpRingKVCacheTest, RejectsChunkLongerThanWindow) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor cache = tf.zeros({1, 5, 1, 1});
+  Tensor out = tf.zeros({1});
+
+  executorch::runtime::KernelRuntimeContext context{};
+  torch::executor::native::update_cache_ring_out(
+      context, tf.ones({1, 4, 1, 1}), cache, 0, 2, out);
+  EXPECT_NE(context.failure_state(), executorch::runtime::Error::Ok);
+  EXPECT_TENSOR_EQ(cache, tf.zeros({1, 5, 1, 1}));
+}
+
+TEST(OpRingKVCacheTest, SdpaBeforeWrapIsCausal) {
+  expect_ring_matches_reference(
+      /*batch=*/2,
+      /*heads=*/2,
+      /*kv_heads=*/2,
+      /*dim=*/4,
+      /*sink_size=*/2,
+      /*window_size=*/8,
+      /*start_pos=*/3,
+      /*seq_len=*/4);
+}
+
+TEST(OpRingKVCacheTest, DecodeAfterWrapSeesSinksAndWindow) {
+  expect_ring_matches_reference(
+      /*batch=*/1,
+      /*heads=*/4,
+      /*kv_heads=*/2,
+      /*dim=*/8,
+      /*sink_size=*/4,
+      /*window_size=*/12,
+      /*start_pos=*/37,
+      /*seq_len=*/1);
+}
+
+TEST(OpRingKVCacheTest, ChunkAfterWrapHidesLaterPositions) {
+  expect_ring_matches_reference(
+      /*batch=*/2,
+      /*heads=*/4,
+      /*kv_heads=*/2,
+      /*dim=*/4,
+      /*sink_size=*/2,
+      /*window_size=*/10,
+      /*start_pos=*/23,
+      /*seq_len=*/5);
+}
+
+TEST(OpRingKVCacheTest, ChunkAfterWrapWithoutSinks) {
+  // The first query of the chunk sees nothing in the first block of 512
+  // keys, which the later positions of the chunk took over.
+  expect_ring_matches_reference(
+      /*batch=*/1,
+      /*heads=*/1,
+      /*kv_heads=*/1,
+      /*dim=*/4,
+      /*sink_size=*/0,
+      /*window_size=*/640,
+      /*start_pos=*/1279,
+      /*seq_len=*/600);
+}
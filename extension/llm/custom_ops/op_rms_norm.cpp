@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+// The minimum number of input elements that each parallel_for chunk
+// normalizes.
+constexpr int64_t kRmsNormGrainSize = 32768;
+
+bool check_rms_norm_args(
+    const Tensor& in,
+    IntArrayRef normalized_shape,
+    const optional<Tensor>& weight,
+    const Tensor& out) {
+  const size_t ndim = normalized_shape.size();
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      ndim >= 1 && in.dim() >= ndim,
+      "Expected normalized_shape to have between 1 and input.dim() elements.");
+  const size_t shift = in.dim() - ndim;
+  for (size_t d = 0; d < ndim; ++d) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        in.size(d + shift) == normalized_shape[d],
+        "Expected normalized_shape to match the sizes of input's rightmost dimensions.");
+  }
+  if (weight.has_value()) {
+    exec_aten::SizesType shape[kTensorDimensionLimit];
+    for (size_t d = 0; d < ndim; ++d) {
+      shape[d] = static_cast<exec_aten::SizesType>(normalized_shape[d]);
+    }
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, weight.value()));
+    ET_LOG_AND_RETURN_IF_FALSE(
+        tensor_has_expected_size(weight.value(), {shape, ndim}));
+  }
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(in));
+  return true;
+}
+
+template <typename CTYPE>
+void rms_norm(
+    const Tensor& input,
+    size_t axis,
+    const optional<Tensor>& weight,
+    CTYPE eps,
+    Tensor& out) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  const int64_t M = getLeadingDims(input, axis);
+  const int64_t N = input.numel() / std::max<int64_t>(M, 1);
+  if (M == 0 || N == 0) {
+    return;
+  }
+
+  const CTYPE* input_data = input.const_data_ptr<CTYPE>();
+  const CTYPE* weight_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t grain_size = std::max<int64_t>(1, kRmsNormGrainSize / N);
+  executorch::extension::parallel_for(
+      0, M, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const CTYPE* src_ptr = input_data + i * N;
+          CTYPE* dst_ptr = out_data + i * N;
+
+          const CTYPE sum_of_squares = executorch::vec::map_reduce_all<CTYPE>(
+              [](Vec x) { return x * x; },
+              [](Vec x, Vec y) { return x + y; },
+              src_ptr,
+              N);
+          const CTYPE rstd = CTYPE(1) /
+              std::sqrt(sum_of_squares / static_cast<CTYPE>(N) + eps);
+
+          if (weight_data != nullptr) {
+            executorch::vec::map2<CTYPE>(
+                [rstd](Vec x, Vec w) { return x * Vec(rstd) * w; },
+                dst_ptr,
+                src_ptr,
+                weight_data,
+                N);
+          } else {
+            executorch::vec::map<CTYPE>(
+                [rstd](Vec x) { return x * Vec(rstd); }, dst_ptr, src_ptr, N);
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& rms_norm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const optional<Tensor>& weight,
+    const double eps,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_rms_norm_args(input, normalized_shape, weight, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, input.sizes()) == Error::Ok, InvalidArgument, out);
+
+  const size_t axis = input.dim() - normalized_shape.size();
+  ET_SWITCH_FLOAT_TYPES(input.scalar_type(), ctx, "rms_norm.out", CTYPE, [&]() {
+    rms_norm<CTYPE>(input, axis, weight, static_cast<CTYPE>(eps), out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(llama, "rms_norm.out", torch::executor::native::rms_norm_out);
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+// Computes input * rsqrt(mean(input^2) + eps) * weight over the trailing
+// normalized_shape dimensions of input, like torch.nn.functional.rms_norm.
+Tensor& rms_norm_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const optional<Tensor>& weight,
+    const double eps,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
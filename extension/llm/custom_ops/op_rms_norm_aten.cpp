@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+
+#include <torch/library.h>
+
+namespace torch::executor::native {
+namespace {
+Tensor& rms_norm_out_no_context(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> weight,
+    const double eps,
+    Tensor& out) {
+  exec_aten::RuntimeContext context;
+  return rms_norm_out(context, input, normalized_shape, weight, eps, out);
+}
+at::Tensor rms_norm_aten(
+    const at::Tensor& input,
+    at::IntArrayRef normalized_shape,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> weight,
+    const double eps) {
+  auto out = at::empty_like(input);
+  WRAP_TO_ATEN(rms_norm_out_no_context, 4)
+  (input, normalized_shape, weight, eps, out);
+  return out;
+}
+} // namespace
+} // namespace torch::executor::native
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def(
+      "rms_norm(Tensor input, int[] normalized_shape, Tensor? weight=None, "
+      "float eps=1e-06) -> Tensor");
+  m.def(
+      "rms_norm.out(Tensor input, int[] normalized_shape, Tensor? weight=None, "
+      "float eps=1e-06, *, Tensor(a!) out) -> Tensor(a!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl("rms_norm", torch::executor::native::rms_norm_aten);
+  m.impl(
+      "rms_norm.out",
+      WRAP_TO_ATEN(torch::executor::native::rms_norm_out_no_context, 4));
+}
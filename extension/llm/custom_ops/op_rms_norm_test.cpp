@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+class OpRmsNormOutTest : public OperatorTest {
+ protected:
+  Tensor& op_rms_norm_out(
+      const Tensor& input,
+      const std::vector<int64_t>& normalized_shape,
+      const optional<Tensor>& weight,
+      double eps,
+      Tensor& out) {
+    return torch::executor::native::rms_norm_out(
+        context_,
+        input,
+        ArrayRef<int64_t>(normalized_shape.data(), normalized_shape.size()),
+        weight,
+        eps,
+        out);
+  }
+
+  template <ScalarType DTYPE>
+  void test_matches_reference(int32_t rows, int32_t dim) {
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+    TensorFactory<DTYPE> tf;
+    const double eps = 1e-5;
+
+    std::vector<CTYPE> in_data(rows * dim);
+    std::vector<CTYPE> weight_data(dim);
+    for (int32_t i = 0; i < rows * dim; ++i) {
+      in_data[i] = static_cast<CTYPE>(i % 13 - 6) / 3;
+    }
+    for (int32_t j = 0; j < dim; ++j) {
+      weight_data[j] = static_cast<CTYPE>(j % 5 + 1) / 2;
+    }
+
+    std::vector<CTYPE> expected(rows * dim);
+    for (int32_t i = 0; i < rows; ++i) {
+      double sum_of_squares = 0;
+      for (int32_t j = 0; j < dim; ++j) {
+        sum_of_squares += in_data[i * dim + j] * in_data[i * dim + j];
+      }
+      const double rstd = 1 / std::sqrt(sum_of_squares / dim + eps);
+      for (int32_t j = 0; j < dim; ++j) {
+        expected[i * dim + j] =
+            static_cast<CTYPE>(in_data[i * dim + j] * rstd * weight_data[j]);
+      }
+    }
+
+    const std::vector<int64_t> normalized_shape = {dim};
+    Tensor out = tf.zeros({rows, dim});
+    Tensor& ret = op_rms_norm_out(
+        tf.make({rows, dim}, in_data),
+        normalized_shape,
+        tf.make({dim}, weight_data),
+        eps,
+        out);
+    EXPECT_TENSOR_EQ(ret, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make({rows, dim}, expected));
+  }
+};
+
+TEST_F(OpRmsNormOutTest, FloatMatchesReference) {
+  test_matches_reference<ScalarType::Float>(3, 7);
+  // Enough rows to be split across threads.
+  test_matches_reference<ScalarType::Float>(64, 4096);
+}
+
+TEST_F(OpRmsNormOutTest, DoubleMatchesReference) {
+  test_matches_reference<ScalarType::Double>(5, 33);
+}
+
+TEST_F(OpRmsNormOutTest, WithoutWeightNormalizesTrailingDims) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<int64_t> normalized_shape = {2, 2};
+  Tensor out = tf.zeros({1, 2, 2});
+  op_rms_norm_out(
+      tf.make({1, 2, 2}, {1, -1, 1, -1}), normalized_shape, {}, 0, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 2, 2}, {1, -1, 1, -1}));
+}
+
+TEST_F(OpRmsNormOutTest, MismatchedNormalizedShapeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<int64_t> normalized_shape = {3};
+  Tensor out = tf.zeros({2, 4});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_rms_norm_out(tf.ones({2, 4}), normalized_shape, {}, 1e-6, out));
+}
+
+TEST_F(OpRmsNormOutTest, MismatchedWeightDies) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<int64_t> normalized_shape = {4};
+  Tensor out = tf.zeros({2, 4});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_rms_norm_out(
+          tf.ones({2, 4}), normalized_shape, tf.ones({3}), 1e-6, out));
+}
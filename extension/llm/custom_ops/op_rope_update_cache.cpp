@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rope_update_cache.h>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+// The minimum number of elements that each parallel_for chunk rotates.
+constexpr int64_t kRopeGrainSize = 32768;
+
+bool check_freqs(
+    const Tensor& freqs,
+    const Tensor& q,
+    int64_t seq_len,
+    int64_t half_dim) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs.dim() == 2 && freqs.size(0) == seq_len &&
+          freqs.size(1) == half_dim,
+      "Expected freqs of shape [seq_len, head_dim / 2]");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs.scalar_type() == ScalarType::Float ||
+          freqs.scalar_type() == q.scalar_type(),
+      "Expected freqs to be float or of the dtype of q");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(freqs));
+  return true;
+}
+
+bool check_rope_and_update_cache_args(
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    const Tensor& k_cache,
+    const Tensor& v_cache,
+    int64_t start_pos,
+    const optional<Tensor>& freqs_cos,
+    const optional<Tensor>& freqs_sin,
+    const Tensor& out) {
+  for (const Tensor* t : {&q, &k, &v, &k_cache, &v_cache}) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        t->dim() == 4, "Expected q, k, v and the caches to be 4D tensors");
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(*t));
+  }
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(q, k, v));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(k, k_cache, v_cache));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(q, out));
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k.sizes() == v.sizes() && k_cache.sizes() == v_cache.sizes(),
+      "Expected k and v, and their caches, to have the same shape");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      q.size(0) == k.size(0) && q.size(1) == k.size(1) &&
+          q.size(3) == k.size(3) && q.size(3) % 2 == 0,
+      "Expected q and k to have the same batch, seq_len and even head_dim");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k.size(0) == k_cache.size(0) && k.size(2) == k_cache.size(2) &&
+          k.size(3) == k_cache.size(3),
+      "Expected k and its cache to have the same batch, heads and head_dim");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      start_pos >= 0 && start_pos + k.size(1) <= k_cache.size(1),
+      "start_pos + seq_len must be at most the size of the cache. "
+      "start_pos: %" PRId64 ", seq_len: %zd, cache size: %zd",
+      start_pos,
+      k.size(1),
+      k_cache.size(1));
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      freqs_cos.has_value() == freqs_sin.has_value(),
+      "Expected either both of freqs_cos and freqs_sin or neither");
+  if (freqs_cos.has_value()) {
+    const int64_t half_dim = q.size(3) / 2;
+    ET_LOG_AND_RETURN_IF_FALSE(
+        check_freqs(freqs_cos.value(), q, q.size(1), half_dim));
+    ET_LOG_AND_RETURN_IF_FALSE(
+        check_freqs(freqs_sin.value(), q, q.size(1), half_dim));
+  }
+  return true;
+}
+
+// Rotates the pairs (x[2i], x[2i + 1]) of a row of 2 * half_dim elements
+// by angles with the given cos and sin. out may be x.
+template <typename T>
+void rotate_pairs(
+    const T* x,
+    const T* cos,
+    const T* sin,
+    T* out,
+    int64_t half_dim) {
+  using Vec = executorch::vec::Vectorized<T>;
+  int64_t i = 0;
+  for (; i + Vec::size() <= half_dim; i += Vec::size()) {
+    const auto [re, im] = executorch::vec::deinterleave2(
+        Vec::loadu(x + 2 * i), Vec::loadu(x + 2 * i + Vec::size()));
+    const Vec c = Vec::loadu(cos + i);
+    const Vec s = Vec::loadu(sin + i);
+    const auto [lo, hi] =
+        executorch::vec::interleave2(re * c - im * s, re * s + im * c);
+    lo.store(out + 2 * i);
+    hi.store(out + 2 * i + Vec::size());
+  }
+  for (; i < half_dim; ++i) {
+    const T re = x[2 * i];
+    const T im = x[2 * i + 1];
+    out[2 * i] = re * cos[i] - im * sin[i];
+    out[2 * i + 1] = re * sin[i] + im * cos[i];
+  }
+}
+
+template <typename FREQS_T, typename T>
+void convert_freqs(const FREQS_T* freqs, std::vector<T>& out, int64_t size) {
+  for (int64_t i = 0; i < size; ++i) {
+    out[i] = static_cast<T>(freqs[i]);
+  }
+}
+
+template <typename CTYPE>
+void apply_rope_and_update_cache(
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    Tensor& k_cache,
+    Tensor& v_cache,
+    int64_t start_pos,
+    const optional<Tensor>& freqs_cos,
+    const optional<Tensor>& freqs_sin,
+    double theta,
+    Tensor& out) {
+  // Half is rotated in float, a row at a time.
+  using compute_t = std::
+      conditional_t<std::is_same_v<CTYPE, exec_aten::Half>, float, CTYPE>;
+  constexpr bool is_widened = !std::is_same_v<CTYPE, compute_t>;
+
+  const int64_t batch_size = q.size(0);
+  const int64_t seq_len = q.size(1);
+  const int64_t num_heads = q.size(2);
+  const int64_t num_kv_heads = k.size(2);
+  const int64_t head_dim = q.size(3);
+  const int64_t half_dim = head_dim / 2;
+  const int64_t max_seq_len = k_cache.size(1);
+
+  // cos and sin of the angle of every position and pair, shared by all the
+  // heads and sequences of the batch.
+  std::vector<compute_t> cos(seq_len * half_dim);
+  std::vector<compute_t> sin(seq_len * half_dim);
+  if (freqs_cos.has_value()) {
+    const int64_t size = seq_len * half_dim;
+    // The freqs are float or of the dtype of q.
+    if (freqs_cos.value().scalar_type() == ScalarType::Float) {
+      convert_freqs(freqs_cos.value().const_data_ptr<float>(), cos, size);
+      convert_freqs(freqs_sin.value().const_data_ptr<float>(), sin, size);
+    } else {
+      convert_freqs(freqs_cos.value().const_data_ptr<CTYPE>(), cos, size);
+      convert_freqs(freqs_sin.value().const_data_ptr<CTYPE>(), sin, size);
+    }
+  } else {
+    // Like precompute_freqs_cis, in float.
+    for (int64_t i = 0; i < half_dim; ++i) {
+      const float exponent =
+          static_cast<float>(2 * i) / static_cast<float>(head_dim);
+      const float freq = 1.0f / std::pow(static_cast<float>(theta), exponent);
+      for (int64_t s = 0; s < seq_len; ++s) {
+        const float angle = static_cast<float>(start_pos + s) * freq;
+        cos[s * half_dim + i] = static_cast<compute_t>(std::cos(angle));
+        sin[s * half_dim + i] = static_cast<compute_t>(std::sin(angle));
+      }
+    }
+  }
+
+  const CTYPE* q_data = q.const_data_ptr<CTYPE>();
+  const CTYPE* k_data = k.const_data_ptr<CTYPE>();
+  const CTYPE* v_data = v.const_data_ptr<CTYPE>();
+  CTYPE* k_cache_data = k_cache.mutable_data_ptr<CTYPE>();
+  CTYPE* v_cache_data = v_cache.mutable_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  // Every head of every token is one unit of work: the rotation of a head of
+  // q to out, or of a head of k to its cache slot along with the copy of the
+  // same head of v.
+  const int64_t heads_per_token = num_heads + num_kv_heads;
+  const int64_t grain_size = std::max<int64_t>(1, kRopeGrainSize / head_dim);
+  executorch::extension::parallel_for(
+      0,
+      batch_size * seq_len * heads_per_token,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::vector<compute_t> row(is_widened ? head_dim : 0);
+        for (int64_t u = begin; u < end; ++u) {
+          const int64_t token = u / heads_per_token;
+          const int64_t h = u % heads_per_token;
+          const int64_t b = token / seq_len;
+          const int64_t s = token % seq_len;
+
+          const CTYPE* src;
+          CTYPE* dst;
+          if (h < num_heads) {
+            src = q_data + (token * num_heads + h) * head_dim;
+            dst = out_data + (token * num_heads + h) * head_dim;
+          } else {
+            const int64_t h_kv = h - num_heads;
+            const int64_t slot =
+                ((b * max_seq_len + start_pos + s) * num_kv_heads + h_kv) *
+                head_dim;
+            src = k_data + (token * num_kv_heads + h_kv) * head_dim;
+            dst = k_cache_data + slot;
+            std::memcpy(
+                v_cache_data + slot,
+                v_data + (token * num_kv_heads + h_kv) * head_dim,
+                head_dim * sizeof(CTYPE));
+          }
+
+          const compute_t* row_cos = cos.data() + s * half_dim;
+          const compute_t* row_sin = sin.data() + s * half_dim;
+          if constexpr (is_widened) {
+            for (int64_t d = 0; d < head_dim; ++d) {
+              row[d] = static_cast<compute_t>(src[d]);
+            }
+            rotate_pairs(row.data(), row_cos, row_sin, row.data(), half_dim);
+            for (int64_t d = 0; d < head_dim; ++d) {
+              dst[d] = static_cast<CTYPE>(row[d]);
+            }
+          } else {
+            rotate_pairs(src, row_cos, row_sin, dst, half_dim);
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& apply_rope_and_update_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    Tensor& k_cache,
+    Tensor& v_cache,
+    const int64_t start_pos,
+    const optional<Tensor>& freqs_cos,
+    const optional<Tensor>& freqs_sin,
+    const double theta,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, q.sizes()) == Error::Ok, InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_rope_and_update_cache_args(
+          q, k, v, k_cache, v_cache, start_pos, freqs_cos, freqs_sin, out),
+      InvalidArgument,
+      out);
+
+  ET_SWITCH_FLOATH_TYPES(
+      q.scalar_type(), ctx, "apply_rope_and_update_cache.out", CTYPE, [&]() {
+        apply_rope_and_update_cache<CTYPE>(
+            q,
+            k,
+            v,
+            k_cache,
+            v_cache,
+            start_pos,
+            freqs_cos,
+            freqs_sin,
+            theta,
+            out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "apply_rope_and_update_cache.out",
+    torch::executor::native::apply_rope_and_update_cache_out);
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+namespace native {
+
+// Applies the rotary embedding of examples/models/llama/rope.py
+// apply_rotary_emb to q and k, [batch, seq_len, num heads, head dim], at
+// positions [start_pos, start_pos + seq_len), in one pass that writes the
+// rotated q to out and the rotated k and v straight to their caches, [batch,
+// max_seq_len, num kv heads, head dim], like update_cache. freqs_cos and
+// freqs_sin are the rows of these positions, [seq_len, head dim / 2], as
+// precompute_freqs_cis makes them; without them the frequencies are computed
+// from theta.
+Tensor& apply_rope_and_update_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    Tensor& k_cache,
+    Tensor& v_cache,
+    const int64_t start_pos,
+    const optional<Tensor>& freqs_cos,
+    const optional<Tensor>& freqs_sin,
+    const double theta,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/aten_util/make_aten_functor_from_et_functor.h>
+#include <executorch/extension/llm/custom_ops/op_rope_update_cache.h>
+
+#include <torch/library.h>
+
+namespace torch::executor::native {
+namespace {
+Tensor& apply_rope_and_update_cache_out_no_context(
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    Tensor& k_cache,
+    Tensor& v_cache,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> freqs_cos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> freqs_sin,
+    const double theta,
+    Tensor& out) {
+  exec_aten::RuntimeContext context;
+  return apply_rope_and_update_cache_out(
+      context,
+      q,
+      k,
+      v,
+      k_cache,
+      v_cache,
+      start_pos,
+      freqs_cos,
+      freqs_sin,
+      theta,
+      out);
+}
+at::Tensor apply_rope_and_update_cache_aten(
+    const at::Tensor& q,
+    const at::Tensor& k,
+    const at::Tensor& v,
+    at::Tensor& k_cache,
+    at::Tensor& v_cache,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> freqs_cos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> freqs_sin,
+    const double theta) {
+  auto out = at::empty_like(q);
+  WRAP_TO_ATEN(apply_rope_and_update_cache_out_no_context, 9)
+  (q, k, v, k_cache, v_cache, start_pos, freqs_cos, freqs_sin, theta, out);
+  return out;
+}
+} // namespace
+} // namespace torch::executor::native
+
+TORCH_LIBRARY_FRAGMENT(llama, m) {
+  m.def(
+      "apply_rope_and_update_cache(Tensor q, Tensor k, Tensor v, "
+      "Tensor(a!) k_cache, Tensor(b!) v_cache, SymInt start_pos, "
+      "Tensor? freqs_cos=None, Tensor? freqs_sin=None, "
+      "float theta=10000.0) -> Tensor");
+  m.def(
+      "apply_rope_and_update_cache.out(Tensor q, Tensor k, Tensor v, "
+      "Tensor(a!) k_cache, Tensor(b!) v_cache, SymInt start_pos, "
+      "Tensor? freqs_cos=None, Tensor? freqs_sin=None, "
+      "float theta=10000.0, *, Tensor(c!) out) -> Tensor(c!)");
+}
+
+TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
+  m.impl(
+      "apply_rope_and_update_cache",
+      torch::executor::native::apply_rope_and_update_cache_aten);
+  m.impl(
+      "apply_rope_and_update_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::apply_rope_and_update_cache_out_no_context,
+          9));
+}
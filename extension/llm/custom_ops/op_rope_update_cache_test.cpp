@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rope_update_cache.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::runtime::testing::TensorFactory;
+
+class OpApplyRopeAndUpdateCacheOutTest : public OperatorTest {
+ protected:
+  Tensor& op_apply_rope_and_update_cache_out(
+      const Tensor& q,
+      const Tensor& k,
+      const Tensor& v,
+      Tensor& k_cache,
+      Tensor& v_cache,
+      int64_t start_pos,
+      const optional<Tensor>& freqs_cos,
+      const optional<Tensor>& freqs_sin,
+      double theta,
+      Tensor& out) {
+    return torch::executor::native::apply_rope_and_update_cache_out(
+        context_,
+        q,
+        k,
+        v,
+        k_cache,
+        v_cache,
+        start_pos,
+        freqs_cos,
+        freqs_sin,
+        theta,
+        out);
+  }
+
+  // Checks the op against apply_rotary_emb followed by update_cache, with
+  // the freqs of precompute_freqs_cis either passed in or computed by the op.
+  template <ScalarType DTYPE>
+  void test_matches_reference(bool pass_freqs, double atol) {
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+    TensorFactory<DTYPE> tf;
+    TensorFactory<ScalarType::Float> tf_float;
+
+    constexpr int32_t kBatch = 2;
+    constexpr int32_t kSeqLen = 3;
+    constexpr int32_t kHeads = 4;
+    constexpr int32_t kKvHeads = 2;
+    // Pairs for a full vector and a tail.
+    constexpr int32_t kDim = 20;
+    constexpr int32_t kHalf = kDim / 2;
+    constexpr int32_t kMaxSeqLen = 8;
+    constexpr int64_t kStartPos = 4;
+    constexpr double kTheta = 10000.0;
+
+    auto make_data = [](size_t size, float step) {
+      std::vector<CTYPE> data(size);
+      for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<CTYPE>(std::sin(step * i));
+      }
+      return data;
+    };
+    const std::vector<CTYPE> q_data =
+        make_data(kBatch * kSeqLen * kHeads * kDim, 0.37f);
+    const std::vector<CTYPE> k_data =
+        make_data(kBatch * kSeqLen * kKvHeads * kDim, 0.53f);
+    const std::vector<CTYPE> v_data =
+        make_data(kBatch * kSeqLen * kKvHeads * kDim, 0.71f);
+
+    std::vector<float> cos(kSeqLen * kHalf);
+    std::vector<float> sin(kSeqLen * kHalf);
+    for (int32_t s = 0; s < kSeqLen; ++s) {
+      for (int32_t i = 0; i < kHalf; ++i) {
+        const double angle =
+            (kStartPos + s) / std::pow(kTheta, 2.0 * i / kDim);
+        cos[s * kHalf + i] = std::cos(angle);
+        sin[s * kHalf + i] = std::sin(angle);
+      }
+    }
+
+    auto rotate = [&](const std::vector<CTYPE>& x, int32_t heads) {
+      std::vector<CTYPE> result(x.size());
+      for (int32_t row = 0; row < kBatch * kSeqLen * heads; ++row) {
+        const int32_t s = row / heads % kSeqLen;
+        for (int32_t i = 0; i < kHalf; ++i) {
+          const double re = x[row * kDim + 2 * i];
+          const double im = x[row * kDim + 2 * i + 1];
+          const double c = cos[s * kHalf + i];
+          const double sn = sin[s * kHalf + i];
+          result[row * kDim + 2 * i] = static_cast<CTYPE>(re * c - im * sn);
+          result[row * kDim + 2 * i + 1] =
+              static_cast<CTYPE>(re * sn + im * c);
+        }
+      }
+      return result;
+    };
+    const std::vector<CTYPE> q_rotated = rotate(q_data, kHeads);
+    const std::vector<CTYPE> k_rotated = rotate(k_data, kKvHeads);
+
+    // The caches are zero but for the positions that were written.
+    std::vector<CTYPE> k_cache_expected(
+        kBatch * kMaxSeqLen * kKvHeads * kDim, CTYPE(0));
+    std::vector<CTYPE> v_cache_expected(k_cache_expected);
+    const int32_t token = kKvHeads * kDim;
+    for (int32_t b = 0; b < kBatch; ++b) {
+      for (int32_t j = 0; j < kSeqLen * token; ++j) {
+        const int32_t dst = (b * kMaxSeqLen + kStartPos) * token + j;
+        k_cache_expected[dst] = k_rotated[b * kSeqLen * token + j];
+        v_cache_expected[dst] = v_data[b * kSeqLen * token + j];
+      }
+    }
+
+    Tensor k_cache = tf.zeros({kBatch, kMaxSeqLen, kKvHeads, kDim});
+    Tensor v_cache = tf.zeros({kBatch, kMaxSeqLen, kKvHeads, kDim});
+    Tensor out = tf.zeros({kBatch, kSeqLen, kHeads, kDim});
+    optional<Tensor> freqs_cos;
+    optional<Tensor> freqs_sin;
+    if (pass_freqs) {
+      freqs_cos = tf_float.make({kSeqLen, kHalf}, cos);
+      freqs_sin = tf_float.make({kSeqLen, kHalf}, sin);
+    }
+    Tensor& ret = op_apply_rope_and_update_cache_out(
+        tf.make({kBatch, kSeqLen, kHeads, kDim}, q_data),
+        tf.make({kBatch, kSeqLen, kKvHeads, kDim}, k_data),
+        tf.make({kBatch, kSeqLen, kKvHeads, kDim}, v_data),
+        k_cache,
+        v_cache,
+        kStartPos,
+        freqs_cos,
+        freqs_sin,
+        kTheta,
+        out);
+    EXPECT_TENSOR_EQ(ret, out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out, tf.make({kBatch, kSeqLen, kHeads, kDim}, q_rotated), 1e-3, atol);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        k_cache,
+        tf.make({kBatch, kMaxSeqLen, kKvHeads, kDim}, k_cache_expected),
+        1e-3,
+        atol);
+    EXPECT_TENSOR_EQ(
+        v_cache,
+        tf.make({kBatch, kMaxSeqLen, kKvHeads, kDim}, v_cache_expected));
+  }
+};
+
+TEST_F(OpApplyRopeAndUpdateCacheOutTest, FloatMatchesReference) {
+  test_matches_reference<ScalarType::Float>(/*pass_freqs=*/true, 1e-6);
+}
+
+TEST_F(OpApplyRopeAndUpdateCacheOutTest, FloatComputesFreqs) {
+  test_matches_reference<ScalarType::Float>(/*pass_freqs=*/false, 1e-5);
+}
+
+TEST_F(OpApplyRopeAndUpdateCacheOutTest, HalfMatchesReference) {
+  test_matches_reference<ScalarType::Half>(/*pass_freqs=*/true, 1e-2);
+}
+
+TEST_F(OpApplyRopeAndUpdateCacheOutTest, PastEndOfCacheDies) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor k_cache = tf.zeros({1, 4, 1, 2});
+  Tensor v_cache = tf.zeros({1, 4, 1, 2});
+  Tensor out = tf.zeros({1, 2, 1, 2});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_apply_rope_and_update_cache_out(
+          tf.ones({1, 2, 1, 2}),
+          tf.ones({1, 2, 1, 2}),
+          tf.ones({1, 2, 1, 2}),
+          k_cache,
+          v_cache,
+          /*start_pos=*/3,
+          {},
+          {},
+          10000.0,
+          out));
+}
+
+TEST_F(OpApplyRopeAndUpdateCacheOutTest, OddHeadDimDies) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor k_cache = tf.zeros({1, 4, 1, 3});
+  Tensor v_cache = tf.zeros({1, 4, 1, 3});
+  Tensor out = tf.zeros({1, 1, 1, 3});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_apply_rope_and_update_cache_out(
+          tf.ones({1, 1, 1, 3}),
+          tf.ones({1, 1, 1, 3}),
+          tf.ones({1, 1, 1, 3}),
+          k_cache,
+          v_cache,
+          /*start_pos=*/0,
+          {},
+          {},
+          10000.0,
+          out));
+}
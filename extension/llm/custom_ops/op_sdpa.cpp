@@ -7,6 +7,7 @@
  */
 
 #include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/llm/custom_ops/op_update_cache.h>
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
 #include <executorch/kernels/optimized/vec/functional.h>
@@ -15,7 +16,12 @@
 // @lint-ignore CLANGTIDY facebook-unused-include-check
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 #ifdef ET_USE_THREADPOOL
@@ -148,20 +154,64 @@ inline void _mul_reduce_max_fusion_kernel(
           vec_tmp_max));
 }
 
-template <typename scalar_t>
-static inline scalar_t* conditional_data_ptr(scalar_t* ptr, scalar_t* ptr2) {
-  ET_CHECK(ptr2 == nullptr);
-  return ptr;
-}
+/*
+  Per thread buffers that blocks of Half and BFloat16 inputs are widened into
+  before they go through the gemms, so that the scores, the softmax and the
+  output accumulate in float while q, k, v and the KV cache stay in 16 bits.
+  Inputs that are already accum_t are read in place.
+*/
+template <typename scalar_t, typename accum_t>
+class WidenedBlocks {
+ public:
+  enum Slot { kQuery, kKey, kValue, kMask, kNumSlots };
+
+  // Every slot holds up to slot_size elements.
+  WidenedBlocks(int64_t num_thread, int64_t slot_size)
+      : slot_size_(slot_size),
+        buf_(
+            std::is_same<scalar_t, accum_t>::value
+                ? 0
+                : num_thread * kNumSlots * slot_size) {}
+
+  // Returns rows rows of cols elements of data, which are stride elements
+  // apart, as accum_t, and sets ld to the stride of the returned rows.
+  const accum_t* get(
+      Slot slot,
+      int64_t thread,
+      const scalar_t* data,
+      int64_t stride,
+      int64_t rows,
+      int64_t cols,
+      int64_t& ld) {
+    if constexpr (std::is_same<scalar_t, accum_t>::value) {
+      ld = stride;
+      return data;
+    } else {
+      accum_t* dst = buf_.data() + (thread * kNumSlots + slot) * slot_size_;
+      for (int64_t r = 0; r < rows; ++r) {
+        vec::convert(data + r * stride, dst + r * cols, cols);
+      }
+      ld = cols;
+      return dst;
+    }
+  }
 
-template <
-    typename scalar_t,
-    typename std::enable_if_t<
-        ::executorch::runtime::is_reduced_floating_point_v<scalar_t>,
-        int> = 0>
-static inline scalar_t* conditional_data_ptr(float* ptr, scalar_t* ptr2) {
-  (void)ptr;
-  return ptr2;
+ private:
+  const int64_t slot_size_;
+  std::vector<accum_t> buf_;
+};
+
+// out <- x * scale, rounded to scalar_t. May overwrite x.
+template <typename scalar_t, typename accum_t>
+inline void
+scale_to(scalar_t* out, accum_t* x, const accum_t scale, int64_t size) {
+  using Vec = vec::Vectorized<accum_t>;
+  if constexpr (std::is_same<scalar_t, accum_t>::value) {
+    vec::map<accum_t>([scale](Vec v) { return v * Vec(scale); }, out, x, size);
+  } else {
+    vec::map<accum_t>([scale](Vec v) { return v * Vec(scale); }, x, x, size);
+    vec::convert(x, out, size);
+  }
 }
 
 template <typename scalar_t>
@@ -213,6 +263,37 @@ sdpa_with_kv_cache does not use attn_mask.
 
 TODO: Just handle conversion of bool mask to float
 */
+
+/*
+  A ring buffer cache that has wrapped around, see update_cache_ring_out:
+  slot x holds the newest position below end that maps to it. The query at
+  position t must not see the positions in (t, end) of its own chunk, which
+  take a run of the ring slots.
+*/
+struct RingCacheMask {
+  int64_t sink_size;
+  int64_t window_size;
+  // One past the newest position in the cache.
+  int64_t end;
+
+  // qk <- -inf at the slots [n, n + size) of positions after t.
+  template <typename accum_t>
+  void apply(accum_t* qk, int64_t n, int64_t size, int64_t t) const {
+    const int64_t num_newer = end - 1 - t;
+    if (num_newer <= 0) {
+      return;
+    }
+    // The positions after t are all in the window, from offset first on.
+    const int64_t first = (t + 1 - sink_size) % window_size;
+    for (int64_t x = std::max(n, sink_size); x < n + size; ++x) {
+      const int64_t offset = x - sink_size;
+      if ((offset - first + window_size) % window_size < num_newer) {
+        qk[x - n] = -std::numeric_limits<accum_t>::infinity();
+      }
+    }
+  }
+};
+
 template <typename scalar_t, int64_t q_split_size, int64_t kv_split_size>
 void cpu_flash_attention(
     Tensor& output,
@@ -224,7 +305,8 @@ void cpu_flash_attention(
     const optional<Tensor>& attn_mask,
     const optional<double>& scale,
     bool is_seq_at_dim_1 = false,
-    const int64_t start_pos = 0) {
+    const int64_t start_pos = 0,
+    const RingCacheMask* ring_mask = nullptr) {
   (void)dropout_p;
   // Query (Batch x Num_heads  x Q_seq_len  x Dim_per_head)
   // Key   (Batch x Num_heads  x KV_seq_len x Dim_per_head)
@@ -248,12 +330,10 @@ void cpu_flash_attention(
   constexpr bool is_reduced_type =
       ::executorch::runtime::is_reduced_floating_point_v<scalar_t>;
 
-  ET_CHECK_MSG(
-      !is_reduced_type, "FlashAttention does not support reduced types.");
-  // Figure out mixed precision a little later
-  // using accum_t = at::opmath_type<scalar_t>;
-  using accum_t = scalar_t;
+  // Half and BFloat16 inputs accumulate in float, see WidenedBlocks.
+  using accum_t = std::conditional_t<is_reduced_type, float, scalar_t>;
   using Vec = vec::Vectorized<accum_t>;
+  using Widened = WidenedBlocks<scalar_t, accum_t>;
   accum_t scaling_factor =
       static_cast<accum_t>(util::calculate_scale(query, scale));
 
@@ -287,13 +367,8 @@ void cpu_flash_attention(
 
   bool has_attn_mask = attn_mask.has_value() && attn_mask.value().numel();
   if (has_attn_mask) {
-    /*
-    TODO: fix this for upcasting attn mask
-    if (is_reduced_type) {
-      // SHould not come here for now.
-      attn_mask.value() = attn_mask.value().to(at::kFloat);
-    }
-    */
+    // The mask has the type of the query, and its rows are widened with
+    // the scores they are added to.
     ET_CHECK_MSG(attn_mask.value().dim() == 2, "attn_mask must be 2D");
     ET_CHECK_MSG(
         attn_mask.value().size(0) == qSize, "attn_mask shape mismatch");
@@ -370,59 +445,290 @@ void cpu_flash_attention(
 #else
   int64_t num_thread = 1;
 #endif
+  // Every slot holds a block of keys or values, the query rows of a gemm, or
+  // a row of the mask.
+  Widened widened(
+      num_thread,
+      std::max({kvSplitSize, qSplitSize, num_reps}) * headSize);
+
+  // Split-KV ("flash decoding"): a single query token of a few heads leaves
+  // most threads idle while the others walk the whole KV cache. Instead,
+  // split the keys of every head into chunks of at least kvSplitSize, compute
+  // the softmax and output of each chunk on its own, and combine the chunks
+  // by rescaling them with their maxima (log-sum-exp).
+  //
+  // With grouped query attention, the num_reps query heads that share a kv
+  // head are computed together against every block of keys and values, so
+  // the work is split by kv head and the cache is read once per group rather
+  // than once per query head.
+  const int64_t num_keys_decode =
+      is_causal ? std::min(start_pos + 1, kvSize) : kvSize;
+  int64_t num_kv_splits = 1;
+  if (qSize == 1 && batchSize * num_heads_kv < num_thread) {
+    num_kv_splits = std::min(
+        (num_thread + batchSize * num_heads_kv - 1) /
+            (batchSize * num_heads_kv),
+        (num_keys_decode + kvSplitSize - 1) / kvSplitSize);
+  }
+  // A single query is the newest position, so a ring_mask masks nothing.
+  if (num_kv_splits > 1) {
+    const int64_t keys_per_split =
+        (num_keys_decode + num_kv_splits - 1) / num_kv_splits;
+    const int64_t num_partials = batchSize * num_head * num_kv_splits;
+    // Unnormalized output, max and sum of exponentials of every chunk, by
+    // batch, query head and chunk.
+    std::vector<accum_t> partial_out(num_partials * headSize);
+    std::vector<accum_t> partial_max(num_partials);
+    std::vector<accum_t> partial_sum(num_partials);
+    // Per thread scores of one block of keys for the query heads of a group.
+    std::vector<accum_t> qk_buf(num_thread * num_reps * kvSplitSize);
+
+    const scalar_t* q_data = query.const_data_ptr<scalar_t>();
+    const scalar_t* k_data = key.const_data_ptr<scalar_t>();
+    const scalar_t* v_data = value.const_data_ptr<scalar_t>();
+    const scalar_t* mask_data =
+        has_attn_mask ? attn_mask.value().const_data_ptr<scalar_t>() : nullptr;
+    scalar_t* out_data = output.mutable_data_ptr<scalar_t>();
+
+    auto split_lambda = [&](int64_t begin, int64_t end) {
+      int64_t i = 0, j_kv = 0, s = 0;
+      util::data_index_init(
+          begin, i, batchSize, j_kv, num_heads_kv, s, num_kv_splits);
+      const int64_t thread = torch::executor::get_thread_num();
+      accum_t* qk_data = qk_buf.data() + thread * num_reps * kvSplitSize;
+      for (int64_t z = begin; z < end; z++) {
+        // The first query head of the group. The partials of the next ones
+        // are num_kv_splits apart.
+        const int64_t j = j_kv * num_reps;
+        int64_t ldq = 0;
+        const accum_t* q_rows = widened.get(
+            Widened::kQuery,
+            thread,
+            q_data + i * qStrideB + j * qStrideH,
+            qStrideH,
+            num_reps,
+            headSize,
+            ldq);
+        const int64_t first = (i * num_head + j) * num_kv_splits + s;
+        const int64_t split_begin = s * keys_per_split;
+        const int64_t split_end =
+            std::min(split_begin + keys_per_split, num_keys_decode);
+        accum_t* dst_data = partial_out.data() + first * headSize;
+        for (int64_t r = 0; r < num_reps; ++r) {
+          fill_stub(
+              dst_data + r * num_kv_splits * headSize,
+              static_cast<accum_t>(0),
+              headSize);
+          partial_max[first + r * num_kv_splits] =
+              -std::numeric_limits<accum_t>::infinity();
+          partial_sum[first + r * num_kv_splits] = 0;
+        }
+        for (int64_t n = split_begin; n < split_end; n += kvSplitSize) {
+          const int64_t kvBlockSize = std::min(kvSplitSize, split_end - n);
+          int64_t ldk = 0;
+          const accum_t* k_block = widened.get(
+              Widened::kKey,
+              thread,
+              k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN,
+              kStrideN,
+              kvBlockSize,
+              headSize,
+              ldk);
+          // Calculate q @ k.T for all the query heads of the group, whose
+          // single rows are ldq apart.
+          ::executorch::cpublas::gemm(
+              ::executorch::cpublas::TransposeType::Transpose,
+              ::executorch::cpublas::TransposeType::NoTranspose,
+              kvBlockSize,
+              num_reps,
+              headSize,
+              static_cast<accum_t>(1),
+              k_block,
+              ldk,
+              q_rows,
+              ldq,
+              static_cast<accum_t>(0),
+              qk_data,
+              kvBlockSize);
+          for (int64_t r = 0; r < num_reps; ++r) {
+            accum_t* qk_row = qk_data + r * kvBlockSize;
+            accum_t& running_max = partial_max[first + r * num_kv_splits];
+            accum_t& running_sum = partial_sum[first + r * num_kv_splits];
+            // qk <- qk * scaling + attn_mask, and its max
+            accum_t block_max = 0;
+            if (has_attn_mask) {
+              int64_t ldm = 0;
+              vec::map2<accum_t>(
+                  [scaling_factor](Vec x, Vec y) {
+                    return x * Vec(scaling_factor) + y;
+                  },
+                  qk_row,
+                  qk_row,
+                  widened.get(
+                      Widened::kMask,
+                      thread,
+                      mask_data + n,
+                      0,
+                      1,
+                      kvBlockSize,
+                      ldm),
+                  kvBlockSize);
+              block_max = vec::reduce_all<accum_t>(
+                  [](Vec& x, Vec& y) { return vec::maximum(x, y); },
+                  qk_row,
+                  kvBlockSize);
+            } else {
+              _mul_reduce_max_fusion_kernel(
+                  qk_row, scaling_factor, kvBlockSize, qk_row, block_max);
+            }
+            const accum_t new_max = std::max(running_max, block_max);
+            // Every key so far is masked out, so this head gets nothing
+            // from the block.
+            if (new_max == -std::numeric_limits<accum_t>::infinity()) {
+              fill_stub(qk_row, static_cast<accum_t>(0), kvBlockSize);
+              continue;
+            }
+            // qk <- exp(qk - max) and its sum
+            accum_t block_sum = new_max;
+            _exp_reduce_sum_fusion_kernel(
+                qk_row, kvBlockSize, qk_row, block_sum);
+            const accum_t exp_tmp = std::exp(running_max - new_max);
+            running_sum = block_sum + exp_tmp * running_sum;
+            running_max = new_max;
+            accum_t* dst_row = dst_data + r * num_kv_splits * headSize;
+            vec::map<accum_t>(
+                [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
+                dst_row,
+                dst_row,
+                headSize);
+          }
+          // dst <- dst + exp(qk - max) @ v
+          int64_t ldv = 0;
+          const accum_t* v_block = widened.get(
+              Widened::kValue,
+              thread,
+              v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN,
+              vStrideN,
+              kvBlockSize,
+              headSize,
+              ldv);
+          ::executorch::cpublas::gemm(
+              ::executorch::cpublas::TransposeType::NoTranspose,
+              ::executorch::cpublas::TransposeType::NoTranspose,
+              headSize,
+              num_reps,
+              kvBlockSize,
+              static_cast<accum_t>(1),
+              v_block,
+              ldv,
+              qk_data,
+              kvBlockSize,
+              static_cast<accum_t>(1),
+              dst_data,
+              num_kv_splits * headSize);
+        }
+        util::data_index_step(
+            i, batchSize, j_kv, num_heads_kv, s, num_kv_splits);
+      }
+    };
+    torch::executor::parallel_for(
+        0, batchSize * num_heads_kv * num_kv_splits, 1, split_lambda);
+
+    // Rescale the chunks of every head to their common max and normalize.
+    std::vector<accum_t> combined(headSize);
+    for (int64_t z = 0; z < batchSize * num_head; ++z) {
+      const int64_t i = z / num_head;
+      const int64_t j = z % num_head;
+      const int64_t first = z * num_kv_splits;
+      accum_t global_max = -std::numeric_limits<accum_t>::infinity();
+      for (int64_t s = 0; s < num_kv_splits; ++s) {
+        global_max = std::max(global_max, partial_max[first + s]);
+      }
+      fill_stub(combined.data(), static_cast<accum_t>(0), headSize);
+      accum_t sum = 0;
+      for (int64_t s = 0; s < num_kv_splits; ++s) {
+        if (partial_max[first + s] ==
+            -std::numeric_limits<accum_t>::infinity()) {
+          continue;
+        }
+        const accum_t weight = std::exp(partial_max[first + s] - global_max);
+        sum += weight * partial_sum[first + s];
+        vec::map2<accum_t>(
+            [weight](Vec x, Vec y) { return x + y * Vec(weight); },
+            combined.data(),
+            combined.data(),
+            partial_out.data() + (first + s) * headSize,
+            headSize);
+      }
+      scale_to(
+          out_data + i * oStrideB + j * oStrideH,
+          combined.data(),
+          static_cast<accum_t>(1) / sum,
+          headSize);
+    }
+    return;
+  }
 
   // const auto dtype = query.scalar_type();
   // Following will be revisited in the future
   // const auto accumulate_dtype = dtype; // toOpMathType(dtype);
 
+  // Every work item is a block of queries of all the num_reps query heads
+  // that share a kv head, which all go through each block of keys and values
+  // while it is in cache. With a single query per head, e.g. when decoding,
+  // the rows of the heads are qStrideH apart and share one gemm; otherwise
+  // there is one gemm per head.
+  const int64_t qk_rows = std::max(qSplitSize, num_reps);
+
   // allocate per thread temp buf (accumulate type)
   int64_t size_per_thread =
-      /* qk     */ qSplitSize * kvSplitSize +
-      /* qk_max */ qSplitSize +
-      /* qk_sum */ qSplitSize +
-      /* dst    */ qSplitSize * headSize;
-
-  int64_t size_bytes = size_per_thread * num_thread * query.element_size();
-  std::vector<char> buf_vec(size_bytes);
-  void* buf = reinterpret_cast<void*>(buf_vec.data());
-  // Need to double check the following
-  size_bytes = num_thread * qSplitSize * kvSplitSize * query.element_size();
-  std::vector<char> buf_reduced_vec(size_bytes);
-  void* buf_reduced = reinterpret_cast<void*>(buf_reduced_vec.data());
-  // at::Tensor buf_reduced = at::empty(
-  //    {num_thread, qSplitSize, is_reduced_type ? kvSplitSize : 0},
-  //    query.options());
+      /* qk     */ qk_rows * kvSplitSize +
+      /* qk_max */ num_reps * qSplitSize +
+      /* qk_sum */ num_reps * qSplitSize +
+      /* dst    */ num_reps * qSplitSize * headSize;
+
+  std::vector<accum_t> buf_vec(size_per_thread * num_thread);
 
   // Data ptrs
   const scalar_t* q_data = query.const_data_ptr<scalar_t>();
   const scalar_t* k_data = key.const_data_ptr<scalar_t>();
   const scalar_t* v_data = value.const_data_ptr<scalar_t>();
-  const accum_t* mask_data =
-      has_attn_mask ? attn_mask.value().const_data_ptr<accum_t>() : nullptr;
+  const scalar_t* mask_data =
+      has_attn_mask ? attn_mask.value().const_data_ptr<scalar_t>() : nullptr;
   scalar_t* out_data = output.mutable_data_ptr<scalar_t>();
-  accum_t* buf_data = reinterpret_cast<accum_t*>(buf);
-  scalar_t* buf_reduced_data =
-      is_reduced_type ? reinterpret_cast<scalar_t*>(buf_reduced) : nullptr;
+  accum_t* buf_data = buf_vec.data();
 
   auto compute_lambda = [&](int64_t begin, int64_t end) {
-    int64_t i = 0, j = 0, k = 0;
-    util::data_index_init(begin, i, batchSize, j, num_head, k, qSlice);
+    int64_t i = 0, j_kv = 0, k = 0;
+    util::data_index_init(begin, i, batchSize, j_kv, num_heads_kv, k, qSlice);
     int ompIdx = torch::executor::get_thread_num();
     accum_t* buf_ptr = buf_data + ompIdx * size_per_thread;
     accum_t* qk_data = buf_ptr;
-    accum_t* qk_max_data = qk_data + qSplitSize * kvSplitSize;
-    accum_t* qk_sum_data = qk_max_data + qSplitSize;
-    accum_t* dst_data = qk_sum_data + qSplitSize;
-    scalar_t* qk_reduced_data = is_reduced_type
-        ? buf_reduced_data + ompIdx * qSplitSize * kvSplitSize
-        : nullptr;
+    accum_t* qk_max_data = qk_data + qk_rows * kvSplitSize;
+    accum_t* qk_sum_data = qk_max_data + num_reps * qSplitSize;
+    accum_t* dst_data = qk_sum_data + num_reps * qSplitSize;
 
     for (int64_t z = begin; z < end; z++) {
       int64_t m = k * qSplitSize;
       int64_t qBlockSize = std::min(qSplitSize, qSize - m);
+      // The query heads go through the gemms in num_passes passes of rows
+      // rows each. Row r of pass p is the query at position pos(r) of head
+      // j_kv * num_reps + head(p, r), and its softmax state is at
+      // p * rows + r either way.
+      const bool heads_as_rows = qBlockSize == 1;
+      const int64_t num_passes = heads_as_rows ? 1 : num_reps;
+      const int64_t rows = heads_as_rows ? num_reps : qBlockSize;
+      const int64_t q_row_stride = heads_as_rows ? qStrideH : qStrideM;
+      auto head_of = [&](int64_t p, int64_t r) {
+        return j_kv * num_reps + (heads_as_rows ? r : p);
+      };
+      auto pos_of = [&](int64_t r) { return heads_as_rows ? 0 : r; };
       // Initialize max and sum
       fill_stub(
-          qk_max_data, -std::numeric_limits<accum_t>::infinity(), qBlockSize);
+          qk_max_data,
+          -std::numeric_limits<accum_t>::infinity(),
+          num_reps * qBlockSize);
+      fill_stub(qk_sum_data, static_cast<accum_t>(0), num_reps * qBlockSize);
       // Original flash sdpa wasnt really meant to be used
       // for decode the way we are using via start_pos here.
       // Thus when num_keys is 1 during decode phase, we
@@ -452,141 +758,263 @@ void cpu_flash_attention(
       // However, lets just fix that as well.
       int64_t num_keys =
           is_causal ? std::min(m + start_pos + qBlockSize, kvSize) : kvSize;
-      auto j_kv = j / num_reps;
       for (int64_t n = 0; n < num_keys; n += kvSplitSize) {
         int64_t kvBlockSize = std::min(kvSplitSize, kvSize - n);
-        // Calculate scale * q @ k.T
-        fill_stub(qk_data, static_cast<accum_t>(0), qSplitSize * kvSplitSize);
-        ::executorch::cpublas::gemm(
-            ::executorch::cpublas::TransposeType::Transpose,
-            ::executorch::cpublas::TransposeType::NoTranspose,
-            kvBlockSize,
-            qBlockSize,
-            headSize,
-            static_cast<accum_t>(1),
+        int64_t ldk = 0, ldv = 0;
+        const accum_t* k_block = widened.get(
+            Widened::kKey,
+            ompIdx,
             k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN,
             kStrideN,
-            q_data + i * qStrideB + j * qStrideH + m * qStrideM,
-            qStrideM,
-            static_cast<accum_t>(0),
-            qk_data,
-            kvBlockSize);
-        // Apply causal mask, fill unused, i.e. future values, with -inf
-        // Say you have q @ k.T size = [16, 32]
-        // With qblock size = 4, say you are processing
-        // q seq len dim = 8:11.
-        // Say kvSplitSize = 4
-        // Then for causal mask, the entries that needs to be
-        // ignored are
-        // [8, 9:31], [9, 10:31], [10, 10:31], [11, 11:31]
-        // Following condition says that num_keys = 8 + 4 =12
-        // (num_keys - n) <= kvSplitSize
-        // num_keys <= n + kvSplitSize
-        // If n + kvSplitSize is larger than 12, then some
-        // entries need masked out. In our example n = 4
-        // will qualify for that
-        if (is_causal && num_keys - n <= kvSplitSize) {
-          // For this fn to work k_split_size > q_split_size
-          for (int32_t row = 0; row < qBlockSize; ++row) {
-            int64_t last_col = m + (row + start_pos) - n;
-            accum_t* row_ptr = qk_data + row * kvBlockSize;
-            fill_stub(
-                row_ptr + last_col + 1,
-                -std::numeric_limits<accum_t>::infinity(),
-                kvBlockSize - last_col - 1);
+            kvBlockSize,
+            headSize,
+            ldk);
+        const accum_t* v_block = widened.get(
+            Widened::kValue,
+            ompIdx,
+            v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN,
+            vStrideN,
+            kvBlockSize,
+            headSize,
+            ldv);
+        for (int64_t p = 0; p < num_passes; ++p) {
+          accum_t* pass_max_data = qk_max_data + p * rows;
+          accum_t* pass_sum_data = qk_sum_data + p * rows;
+          accum_t* pass_dst_data = dst_data + p * rows * headSize;
+          int64_t ldq = 0;
+          const accum_t* q_rows = widened.get(
+              Widened::kQuery,
+              ompIdx,
+              q_data + i * qStrideB + head_of(p, 0) * qStrideH + m * qStrideM,
+              q_row_stride,
+              rows,
+              headSize,
+              ldq);
+          // Calculate scale * q @ k.T
+          ::executorch::cpublas::gemm(
+              ::executorch::cpublas::TransposeType::Transpose,
+              ::executorch::cpublas::TransposeType::NoTranspose,
+              kvBlockSize,
+              rows,
+              headSize,
+              static_cast<accum_t>(1),
+              k_block,
+              ldk,
+              q_rows,
+              ldq,
+              static_cast<accum_t>(0),
+              qk_data,
+              kvBlockSize);
+          // Apply causal mask, fill unused, i.e. future values, with -inf
+          // Say you have q @ k.T size = [16, 32]
+          // With qblock size = 4, say you are processing
+          // q seq len dim = 8:11.
+          // Say kvSplitSize = 4
+          // Then for causal mask, the entries that needs to be
+          // ignored are
+          // [8, 9:31], [9, 10:31], [10, 10:31], [11, 11:31]
+          // Following condition says that num_keys = 8 + 4 =12
+          // (num_keys - n) <= kvSplitSize
+          // num_keys <= n + kvSplitSize
+          // If n + kvSplitSize is larger than 12, then some
+          // entries need masked out. In our example n = 4
+          // will qualify for that
+          if (is_causal && num_keys - n <= kvSplitSize) {
+            // For this fn to work k_split_size > q_split_size
+            for (int32_t row = 0; row < rows; ++row) {
+              int64_t last_col = m + (pos_of(row) + start_pos) - n;
+              accum_t* row_ptr = qk_data + row * kvBlockSize;
+              fill_stub(
+                  row_ptr + last_col + 1,
+                  -std::numeric_limits<accum_t>::infinity(),
+                  kvBlockSize - last_col - 1);
+            }
           }
-        }
-        // Update attention weights with attention mask
-        // And apply scaling factor
-        // qk <- qk * scaling + attn_mask
-        if (has_attn_mask) {
-          for (int64_t row = 0; row < qBlockSize; ++row) {
-            vec::map2<accum_t>(
-                [scaling_factor](Vec x, Vec y) {
-                  return x * Vec(scaling_factor) + y;
-                },
-                qk_data + row * kvBlockSize,
-                qk_data + row * kvBlockSize,
-                mask_data + i * mStrideB + j * mStrideH + (m + row) * mStrideM +
-                    n,
-                kvBlockSize);
+          if (ring_mask != nullptr) {
+            for (int64_t row = 0; row < rows; ++row) {
+              ring_mask->apply(
+                  qk_data + row * kvBlockSize,
+                  n,
+                  kvBlockSize,
+                  start_pos + m + pos_of(row));
+            }
           }
-        }
-        // Update coefficients with Softmax
-        accum_t tmp_max = 0, tmp_sum = 0, exp_tmp = 0;
-        for (int64_t row = 0; row < qBlockSize; ++row) {
+          // Update attention weights with attention mask
+          // And apply scaling factor
+          // qk <- qk * scaling + attn_mask
           if (has_attn_mask) {
-            // max per row
-            tmp_max = vec::reduce_all<accum_t>(
-                [](Vec& x, Vec& y) { return vec::maximum(x, y); },
-                qk_data + row * kvBlockSize,
-                kvBlockSize);
-          } else {
-            // apply scaling factor and max per row in fusion
-            _mul_reduce_max_fusion_kernel(
+            for (int64_t row = 0; row < rows; ++row) {
+              int64_t ldm = 0;
+              vec::map2<accum_t>(
+                  [scaling_factor](Vec x, Vec y) {
+                    return x * Vec(scaling_factor) + y;
+                  },
+                  qk_data + row * kvBlockSize,
+                  qk_data + row * kvBlockSize,
+                  widened.get(
+                      Widened::kMask,
+                      ompIdx,
+                      mask_data + i * mStrideB + head_of(p, row) * mStrideH +
+                          (m + pos_of(row)) * mStrideM + n,
+                      0,
+                      1,
+                      kvBlockSize,
+                      ldm),
+                  kvBlockSize);
+            }
+          }
+          // Update coefficients with Softmax
+          accum_t tmp_max = 0, tmp_sum = 0, exp_tmp = 0;
+          for (int64_t row = 0; row < rows; ++row) {
+            if (has_attn_mask) {
+              // max per row
+              tmp_max = vec::reduce_all<accum_t>(
+                  [](Vec& x, Vec& y) { return vec::maximum(x, y); },
+                  qk_data + row * kvBlockSize,
+                  kvBlockSize);
+            } else {
+              // apply scaling factor and max per row in fusion
+              _mul_reduce_max_fusion_kernel(
+                  qk_data + row * kvBlockSize,
+                  scaling_factor,
+                  kvBlockSize,
+                  qk_data + row * kvBlockSize,
+                  tmp_max);
+            }
+            tmp_max =
+                pass_max_data[row] > tmp_max ? pass_max_data[row] : tmp_max;
+            // Every key so far is masked out, which a ring_mask can do to
+            // whole blocks, so the row gets nothing from this one.
+            if (tmp_max == -std::numeric_limits<accum_t>::infinity()) {
+              fill_stub(
+                  qk_data + row * kvBlockSize,
+                  static_cast<accum_t>(0),
+                  kvBlockSize);
+              continue;
+            }
+            // qk <- exp(qk - max) and sum per row
+            tmp_sum = tmp_max;
+            _exp_reduce_sum_fusion_kernel(
                 qk_data + row * kvBlockSize,
-                scaling_factor,
                 kvBlockSize,
                 qk_data + row * kvBlockSize,
-                tmp_max);
+                tmp_sum);
+            // exp_tmp <- exp(max[row] - max)
+            exp_tmp = std::exp(pass_max_data[row] - tmp_max);
+            // sum[row] <- sum + exp_tmp * sum[row]
+            pass_sum_data[row] = tmp_sum + exp_tmp * pass_sum_data[row];
+            // max[row] <- max
+            pass_max_data[row] = tmp_max;
+            // dst <- dst * exp_tmp
+            if (n > 0) {
+              vec::map<accum_t>(
+                  [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
+                  pass_dst_data + row * headSize,
+                  pass_dst_data + row * headSize,
+                  headSize);
+            }
           }
-          tmp_max = qk_max_data[row] > tmp_max ? qk_max_data[row] : tmp_max;
-          // qk <- exp(qk - max) and sum per row
-          tmp_sum = tmp_max;
-          _exp_reduce_sum_fusion_kernel(
-              qk_data + row * kvBlockSize,
+          // Calculate Softmax(q @ k.T) @ v
+          ::executorch::cpublas::gemm(
+              ::executorch::cpublas::TransposeType::NoTranspose,
+              ::executorch::cpublas::TransposeType::NoTranspose,
+              headSize,
+              rows,
               kvBlockSize,
-              conditional_data_ptr(qk_data, qk_reduced_data) +
-                  row * kvBlockSize,
-              tmp_sum);
-          // exp_tmp <- exp(max[row] - max)
-          exp_tmp = std::exp(qk_max_data[row] - tmp_max);
-          // sum[row] <- sum + exp_tmp * sum[row]
-          qk_sum_data[row] = tmp_sum + exp_tmp * qk_sum_data[row];
-          // max[row] <- max
-          qk_max_data[row] = tmp_max;
-          // dst <- dst * exp_tmp
-          if (n > 0) {
-            vec::map<accum_t>(
-                [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
-                dst_data + row * headSize,
-                dst_data + row * headSize,
-                headSize);
-          }
+              static_cast<accum_t>(1),
+              v_block,
+              ldv,
+              qk_data,
+              kvBlockSize,
+              n == 0 ? static_cast<accum_t>(0) : static_cast<accum_t>(1),
+              pass_dst_data,
+              headSize);
         }
-        // Calculate Softmax(q @ k.T) @ v
-        ::executorch::cpublas::gemm(
-            ::executorch::cpublas::TransposeType::NoTranspose,
-            ::executorch::cpublas::TransposeType::NoTranspose,
-            headSize,
-            qBlockSize,
-            kvBlockSize,
-            static_cast<accum_t>(1),
-            v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN,
-            vStrideN,
-            conditional_data_ptr(qk_data, qk_reduced_data),
-            kvBlockSize,
-            n == 0 ? static_cast<accum_t>(0) : static_cast<accum_t>(1),
-            dst_data,
-            headSize);
       }
       // dst <- dst / sum[row]
       // reorder MHA output with strides
-      for (int64_t row = 0; row < qBlockSize; ++row) {
-        accum_t sum_reciprocal = 1 / qk_sum_data[row];
-        vec::map<scalar_t>(
-            [sum_reciprocal](Vec x) { return x * Vec(sum_reciprocal); },
-            out_data + i * oStrideB + j * oStrideH + m * oStrideM +
-                row * oStrideM,
-            dst_data + row * headSize,
-            headSize);
+      for (int64_t p = 0; p < num_passes; ++p) {
+        for (int64_t row = 0; row < rows; ++row) {
+          accum_t sum_reciprocal = 1 / qk_sum_data[p * rows + row];
+          scale_to(
+              out_data + i * oStrideB + head_of(p, row) * oStrideH +
+                  (m + pos_of(row)) * oStrideM,
+              dst_data + (p * rows + row) * headSize,
+              sum_reciprocal,
+              headSize);
+        }
       }
       // Move to the next query
-      util::data_index_step(i, batchSize, j, num_head, k, qSlice);
+      util::data_index_step(i, batchSize, j_kv, num_heads_kv, k, qSlice);
     }
   };
   torch::executor::parallel_for(
-      0, batchSize * num_head * qSlice, 1, compute_lambda);
+      0, batchSize * num_heads_kv * qSlice, 1, compute_lambda);
+}
+
+// Runs cpu_flash_attention over q, k and v laid out as [batch, seq_len,
+// num heads, head dim], with block sizes picked by the length of q.
+void flash_attention_seq_at_dim_1(
+    RuntimeContext& ctx,
+    Tensor& output,
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    const double dropout_p,
+    const bool is_causal,
+    const optional<Tensor>& attn_mask,
+    const optional<double>& scale,
+    const int64_t start_pos,
+    const RingCacheMask* ring_mask = nullptr) {
+  const auto q_seq_len = q.size(1);
+  // TODO(task): replace the template param selection logic
+  // with whatever apprpriately makes more sense for
+  ET_SWITCH_FLOATHBF16_TYPES(
+      q.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
+        // TODO we need to re-evaluate this for ARM CPUs
+        // And there can be many so instead of templatizing
+        // we might consider another appraoch
+        if (q_seq_len >= 768) {
+          cpu_flash_attention<CTYPE, 256, 512>(
+              output,
+              q,
+              k,
+              v,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              start_pos,
+              ring_mask);
+        } else if (q_seq_len >= 192) {
+          cpu_flash_attention<CTYPE, 64, 512>(
+              output,
+              q,
+              k,
+              v,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              start_pos,
+              ring_mask);
+        } else {
+          cpu_flash_attention<CTYPE, 32, 512>(
+              output,
+              q,
+              k,
+              v,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale,
+              true, /* is_seq_at_dim_1 */
+              start_pos,
+              ring_mask);
+        }
+      });
 }
 
 bool validate_flash_attention_args(
@@ -604,7 +1032,10 @@ bool validate_flash_attention_args(
       "scaled_dot_product_attention_flash_attention: Q/K/V should have the same head size");
 
   ET_LOG_MSG_AND_RETURN_IF_FALSE(
-      (query.scalar_type() == ScalarType::Float), "Query must be Float type");
+      (query.scalar_type() == ScalarType::Float ||
+       query.scalar_type() == ScalarType::Half ||
+       query.scalar_type() == ScalarType::BFloat16),
+      "Query must be Float, Half or BFloat16 type");
 
   ET_LOG_MSG_AND_RETURN_IF_FALSE(
       (query.scalar_type() == key.scalar_type()) &&
@@ -753,134 +1184,708 @@ void update_cache(
   }
 }
 
-} // anonymous namespace
+bool validate_paged_cache_params(
+    const Tensor& k_cache,
+    const Tensor& v_cache,
+    const Tensor& block_table,
+    int64_t batch_size,
+    int64_t kv_len) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_cache.dim() == 4, "paged key cache must be a 4D tensor");
 
-Tensor& flash_attention_kernel_out(
-    RuntimeContext& ctx,
-    const Tensor& query,
-    const Tensor& key,
-    const Tensor& value,
-    const optional<Tensor>& attn_mask,
-    const double dropout_p,
-    const bool is_causal,
-    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
-    const optional<double> scale,
-    Tensor& output) {
-  (void)ctx;
-  ET_KERNEL_CHECK(
-      ctx,
-      validate_flash_attention_args(query, key, value, attn_mask),
-      InvalidArgument,
-      output);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      k_cache.sizes() == v_cache.sizes() &&
+          k_cache.scalar_type() == v_cache.scalar_type(),
+      "paged key and value caches must have the same shape and dtype");
 
-  ET_KERNEL_CHECK(
-      ctx,
-      resize_tensor(output, query.sizes()) == Error::Ok,
-      InvalidArgument,
-      output);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.dim() == 2 && block_table.scalar_type() == ScalarType::Long,
+      "block_table must be a 2D Long tensor");
 
-  auto q_seq_len = query.size(2);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.size(0) == batch_size,
+      "block_table must have one row per batch entry");
 
-  ET_SWITCH_FLOAT_TYPES(
-      query.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
-        // TODO we need to re-evaluate this for ARM CPUs
-        // And there can be many so instead of templatizing
-        // we might consider another appraoch
-        if (q_seq_len >= 768) {
-          cpu_flash_attention<CTYPE, 256, 512>(
-              output,
-              query,
-              key,
-              value,
-              dropout_p,
-              is_causal,
-              attn_mask,
-              scale);
-        } else if (q_seq_len >= 192) {
-          cpu_flash_attention<CTYPE, 64, 512>(
-              output,
-              query,
-              key,
-              value,
-              dropout_p,
-              is_causal,
-              attn_mask,
-              scale);
-        } else {
-          cpu_flash_attention<CTYPE, 32, 512>(
-              output,
-              query,
-              key,
-              value,
-              dropout_p,
-              is_causal,
-              attn_mask,
-              scale);
-        }
-      });
-  return output;
-}
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      kv_len <= block_table.size(1) * k_cache.size(1),
+      "start_pos + seq_len must fit in the blocks of block_table. "
+      "kv len: %" PRId64 ", blocks per sequence: %zd, block size: %zd",
+      kv_len,
+      block_table.size(1),
+      k_cache.size(1));
 
-/*
-  Input params
-  @param[in] q_projected Projected query with query weights.
-  Format [n_layers, batch size, seq_len, num heads, head dim]
-  @param[in] k_projected Projected query with key weights.
-  Format [n_layers, batch size, seq_len, num heads, head dim]
-  @param[in] v_projected Projected query with value weights.
-  Format [n_layers, batch size, seq_len, num heads, head dim]
-  @param[in] key_cache Cache of previous k_projected.
-  Format [n_layers, batch size, max_seq_len, num heads, head dim]
-  @param[in] key_cache Cache of previous v_projected.
-  Format [n_layers, batch size, max_seq_len, num heads, head dim]
-  ....
-  @param[in] start_pos: sequence position
-  @param[in] seq_len: Seq length. e.g. seq_len dim of q_projected.
-*/
-Tensor& custom_sdpa_out(
-    RuntimeContext& ctx,
-    const Tensor& q,
-    const Tensor& k,
-    const Tensor& v,
-    const int64_t start_pos,
-    const optional<Tensor>& attn_mask,
-    const double dropout_p,
-    const bool is_causal,
-    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
-    const optional<double> scale,
-    Tensor& output) {
-  ET_KERNEL_CHECK_MSG(
-      ctx,
-      !attn_mask.has_value() || !is_causal,
-      InvalidArgument,
-      output,
-      "attn_mask and is_causal cannot be set at the same time");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(k_cache.dim_order().data(), k_cache.dim()),
+      "paged key cache must be in contiguous dim order");
 
-  ET_CHECK_MSG(q.dim() == 4, "query must be a 4D tensor");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(v_cache.dim_order().data(), v_cache.dim()),
+      "paged value cache must be in contiguous dim order");
 
-  const int64_t seq_len = q.size(1);
-  auto q_seq_len = q.size(1);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(
+          block_table.dim_order().data(), block_table.dim()),
+      "block_table must be in contiguous dim order");
+
+  const int64_t num_blocks = k_cache.size(0);
+  const int64_t block_size = k_cache.size(1);
+  const int64_t* table_data = block_table.const_data_ptr<int64_t>();
+  for (int64_t b = 0; b < batch_size; ++b) {
+    for (int64_t i = 0; i * block_size < kv_len; ++i) {
+      const int64_t block = table_data[b * block_table.size(1) + i];
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          block >= 0 && block < num_blocks,
+          "block %" PRId64 " is out of range for a pool of %" PRId64 " blocks",
+          block,
+          num_blocks);
+    }
+  }
 
-  // Refactor the following into create_view util perhaps using
-  // TensorPtr
-  std::array<exec_aten::DimOrderType, util::kKVDim> sliced_key_dim_order{
-      0, 1, 2, 3};
-  std::array<exec_aten::SizesType, util::kKVDim> sliced_key_sizes;
-  sliced_key_sizes[0] = k.size(0);
-  sliced_key_sizes[1] = start_pos + seq_len; // key_cache.size(2);
-  sliced_key_sizes[2] = k.size(2);
-  sliced_key_sizes[3] = k.size(3);
-  std::array<exec_aten::StridesType, util::kKVDim> sliced_key_strides;
-  dim_order_to_stride_nocheck(
-      sliced_key_sizes.data(),
-      sliced_key_dim_order.data(),
-      util::kKVDim,
-      sliced_key_strides.data());
-  // since the cache is sliced, the batch stride needs to stay the same.
-  sliced_key_strides[0] = k.strides()[0];
-  void* key_cache_data = k.mutable_data_ptr();
-  TensorImpl k_impl = TensorImpl(
-      k.scalar_type(),
+  return true;
+}
+
+// Copies the first kv_len positions of every sequence out of a paged cache
+// into dst, which is laid out as [batch, kv_len, num heads, head dim].
+void gather_paged_cache(
+    const Tensor& cache,
+    const Tensor& block_table,
+    int64_t batch_size,
+    int64_t kv_len,
+    uint8_t* dst) {
+  const int64_t block_size = cache.size(1);
+  const int64_t max_blocks = block_table.size(1);
+  const size_t token_bytes =
+      cache.size(2) * cache.size(3) * cache.element_size();
+  const uint8_t* cache_data =
+      static_cast<const uint8_t*>(cache.const_data_ptr());
+  const int64_t* table_data = block_table.const_data_ptr<int64_t>();
+
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const int64_t* blocks = table_data + b * max_blocks;
+    for (int64_t pos = 0; pos < kv_len; pos += block_size) {
+      const int64_t run = std::min(block_size, kv_len - pos);
+      std::memcpy(
+          dst + (b * kv_len + pos) * token_bytes,
+          cache_data + blocks[pos / block_size] * block_size * token_bytes,
+          run * token_bytes);
+    }
+  }
+}
+
+bool validate_quantized_cache_params(
+    const Tensor& cache,
+    const Tensor& scales,
+    const Tensor& zero_points) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      cache.dim() == 4, "quantized cache must be a 4D tensor");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      cache.scalar_type() == ScalarType::Char,
+      "quantized cache must be int8");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      scales.dim() == 4 && zero_points.dim() == 4,
+      "scales and zero points must be 4D tensors");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      scales.scalar_type() == ScalarType::Float ||
+          scales.scalar_type() == ScalarType::Double,
+      "scales must be float or double");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      zero_points.scalar_type() == ScalarType::Char ||
+          zero_points.scalar_type() == ScalarType::Int ||
+          zero_points.scalar_type() == ScalarType::Long,
+      "zero points must be int8, int32 or int64");
+  for (const Tensor* qparams : {&scales, &zero_points}) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        qparams->size(0) == cache.size(0) &&
+            (qparams->size(1) == cache.size(1) || qparams->size(1) == 1) &&
+            qparams->size(2) == cache.size(2) && qparams->size(3) == 1,
+        "scales and zero points must be [batch, max_seq_len or 1, heads, 1]");
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        is_contiguous_dim_order(qparams->dim_order().data(), qparams->dim()),
+        "scales and zero points must be in contiguous dim order");
+  }
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(cache.dim_order().data(), cache.dim()),
+      "quantized cache must be in contiguous dim order");
+  return true;
+}
+
+// Reads count quantization parameters, stride elements apart, of the tokens
+// of a quantized cache.
+void load_qparams(
+    const Tensor& scales,
+    const Tensor& zero_points,
+    int64_t offset,
+    int64_t stride,
+    int64_t count,
+    float* scale_out,
+    int32_t* zero_point_out) {
+  if (scales.scalar_type() == ScalarType::Double) {
+    const double* data = scales.const_data_ptr<double>() + offset;
+    for (int64_t n = 0; n < count; ++n) {
+      scale_out[n] = static_cast<float>(data[n * stride]);
+    }
+  } else {
+    const float* data = scales.const_data_ptr<float>() + offset;
+    for (int64_t n = 0; n < count; ++n) {
+      scale_out[n] = data[n * stride];
+    }
+  }
+  switch (zero_points.scalar_type()) {
+    case ScalarType::Long: {
+      const int64_t* data = zero_points.const_data_ptr<int64_t>() + offset;
+      for (int64_t n = 0; n < count; ++n) {
+        zero_point_out[n] = static_cast<int32_t>(data[n * stride]);
+      }
+      break;
+    }
+    case ScalarType::Int: {
+      const int32_t* data = zero_points.const_data_ptr<int32_t>() + offset;
+      for (int64_t n = 0; n < count; ++n) {
+        zero_point_out[n] = data[n * stride];
+      }
+      break;
+    }
+    default: {
+      const int8_t* data = zero_points.const_data_ptr<int8_t>() + offset;
+      for (int64_t n = 0; n < count; ++n) {
+        zero_point_out[n] = data[n * stride];
+      }
+      break;
+    }
+  }
+}
+
+// Same as load_qparams, for writing count parameters.
+void store_qparams(
+    Tensor& scales,
+    Tensor& zero_points,
+    int64_t offset,
+    int64_t stride,
+    int64_t count,
+    const float* scale_in,
+    const int32_t* zero_point_in) {
+  if (scales.scalar_type() == ScalarType::Double) {
+    double* data = scales.mutable_data_ptr<double>() + offset;
+    for (int64_t n = 0; n < count; ++n) {
+      data[n * stride] = scale_in[n];
+    }
+  } else {
+    float* data = scales.mutable_data_ptr<float>() + offset;
+    for (int64_t n = 0; n < count; ++n) {
+      data[n * stride] = scale_in[n];
+    }
+  }
+  switch (zero_points.scalar_type()) {
+    case ScalarType::Long: {
+      int64_t* data = zero_points.mutable_data_ptr<int64_t>() + offset;
+      for (int64_t n = 0; n < count; ++n) {
+        data[n * stride] = zero_point_in[n];
+      }
+      break;
+    }
+    case ScalarType::Int: {
+      int32_t* data = zero_points.mutable_data_ptr<int32_t>() + offset;
+      for (int64_t n = 0; n < count; ++n) {
+        data[n * stride] = zero_point_in[n];
+      }
+      break;
+    }
+    default: {
+      int8_t* data = zero_points.mutable_data_ptr<int8_t>() + offset;
+      for (int64_t n = 0; n < count; ++n) {
+        data[n * stride] = static_cast<int8_t>(zero_point_in[n]);
+      }
+      break;
+    }
+  }
+}
+
+// Sum of a[d] * b[d] in int32. Written as a plain loop so that compilers turn
+// it into integer dot-product instructions (VNNI, SDOT) where the target has
+// them, and into widening multiply-adds elsewhere.
+inline int32_t dot_int8(const int8_t* a, const int8_t* b, int64_t size) {
+  int32_t sum = 0;
+  for (int64_t d = 0; d < size; ++d) {
+    sum += static_cast<int32_t>(a[d]) * static_cast<int32_t>(b[d]);
+  }
+  return sum;
+}
+
+/*
+  Quantizes the given positions of k, laid out as [batch, seq_len, heads,
+  head dim], into an int8 cache at start_pos, with one asymmetric scale and
+  zero point per token and head, like
+  quantized_decomposed.choose_qparams_per_token_asymmetric followed by
+  quantize_per_token.
+*/
+void quantize_to_cache(
+    const Tensor& k,
+    Tensor& cache,
+    Tensor& scales,
+    Tensor& zero_points,
+    int64_t start_pos) {
+  constexpr int32_t qmin = std::numeric_limits<int8_t>::min();
+  constexpr int32_t qmax = std::numeric_limits<int8_t>::max();
+  const int64_t batch_size = k.size(0);
+  const int64_t seq_len = k.size(1);
+  const int64_t num_heads = k.size(2);
+  const int64_t head_dim = k.size(3);
+  const float* k_data = k.const_data_ptr<float>();
+  int8_t* cache_data = cache.mutable_data_ptr<int8_t>();
+  const auto cache_strides = cache.strides();
+  const auto qparam_strides = scales.strides();
+
+  for (int64_t b = 0; b < batch_size; ++b) {
+    for (int64_t s = 0; s < seq_len; ++s) {
+      for (int64_t h = 0; h < num_heads; ++h) {
+        const float* src =
+            k_data + ((b * seq_len + s) * num_heads + h) * head_dim;
+        // The range always includes 0, so that it is exactly representable.
+        float min_val = 0, max_val = 0;
+        for (int64_t d = 0; d < head_dim; ++d) {
+          min_val = std::min(min_val, src[d]);
+          max_val = std::max(max_val, src[d]);
+        }
+        const float scale = std::max(
+            (max_val - min_val) / static_cast<float>(qmax - qmin),
+            std::numeric_limits<float>::epsilon());
+        const float descaled_min = min_val / scale;
+        const float descaled_max = max_val / scale;
+        // Pick the zero point from the end of the range with the smaller
+        // rounding error.
+        const float zero_point_from_min = qmin - descaled_min;
+        const float zero_point_from_max = qmax - descaled_max;
+        const float zero_point_float =
+            (qmin + descaled_min) + (qmax + descaled_max) > 0
+            ? zero_point_from_min
+            : zero_point_from_max;
+        const int32_t zero_point = static_cast<int32_t>(std::nearbyint(
+            std::min<float>(std::max<float>(zero_point_float, qmin), qmax)));
+
+        const float inv_scale = 1.0f / scale;
+        int8_t* dst = cache_data + b * cache_strides[0] +
+            (start_pos + s) * cache_strides[1] + h * cache_strides[2];
+        for (int64_t d = 0; d < head_dim; ++d) {
+          const float q = std::nearbyint(src[d] * inv_scale) + zero_point;
+          dst[d] = static_cast<int8_t>(
+              std::min<float>(std::max<float>(q, qmin), qmax));
+        }
+        store_qparams(
+            scales,
+            zero_points,
+            b * qparam_strides[0] + (start_pos + s) * qparam_strides[1] +
+                h * qparam_strides[2],
+            0,
+            1,
+            &scale,
+            &zero_point);
+      }
+    }
+  }
+}
+
+/*
+  Flash attention over an int8 KV cache with per-token (or per-head) scales
+  and zero points, laid out as [batch, kv_size, heads, head dim] with
+  parameters [batch, max_seq_len or 1, heads, 1]. Nothing is dequantized
+  ahead of time:
+  - Every row of q is quantized to symmetric int8, so that
+    q . k = q_scale * k_scale * (sum(q_int8 * k_int8) - k_zero_point *
+    sum(q_int8)), with the sum in int32.
+  - The softmax weights p of a block of keys are folded with the value
+    scales, so that p @ v = sum(p * v_scale * v_int8) -
+    sum(p * v_scale * v_zero_point), reading v as int8.
+  So the cache is read at a quarter of the bandwidth of a float one.
+*/
+void cpu_quantized_flash_attention(
+    Tensor& output,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& key_scales,
+    const Tensor& key_zero_points,
+    const Tensor& value,
+    const Tensor& value_scales,
+    const Tensor& value_zero_points,
+    const int64_t kvSize,
+    bool is_causal,
+    const optional<Tensor>& attn_mask,
+    const optional<double>& scale,
+    const int64_t start_pos) {
+  using Vec = vec::Vectorized<float>;
+  constexpr int64_t q_split_size = 32;
+  constexpr int64_t kv_split_size = 128;
+  const float scaling_factor =
+      static_cast<float>(util::calculate_scale(query, scale));
+
+  const int64_t batchSize = query.size(0);
+  const int64_t qSize = query.size(1);
+  const int64_t num_head = query.size(2);
+  const int64_t headSize = query.size(3);
+  const int64_t num_heads_kv = key.size(2);
+  ET_CHECK_MSG(
+      num_heads_kv <= num_head && num_head % num_heads_kv == 0,
+      "num query heads=%" PRId64 " must be a multiple of num kv heads=%" PRId64,
+      num_head,
+      num_heads_kv);
+  const int64_t num_reps = num_head / num_heads_kv;
+
+  const bool has_attn_mask = attn_mask.has_value() && attn_mask.value().numel();
+  if (has_attn_mask) {
+    ET_CHECK_MSG(
+        attn_mask.value().size(0) == qSize &&
+            attn_mask.value().size(1) == kvSize,
+        "attn_mask shape mismatch");
+  }
+
+  const int64_t qStrideB = query.strides()[0];
+  const int64_t qStrideM = query.strides()[1];
+  const int64_t qStrideH = query.strides()[2];
+  const int64_t kStrideB = key.strides()[0];
+  const int64_t kStrideN = key.strides()[1];
+  const int64_t kStrideH = key.strides()[2];
+  const int64_t vStrideB = value.strides()[0];
+  const int64_t vStrideN = value.strides()[1];
+  const int64_t vStrideH = value.strides()[2];
+  const int64_t oStrideB = output.strides()[0];
+  const int64_t oStrideM = output.strides()[1];
+  const int64_t oStrideH = output.strides()[2];
+  // Parameters shared by all tokens of a head have a seq stride of 0.
+  const int64_t ksStrideB = key_scales.strides()[0];
+  const int64_t ksStrideN =
+      key_scales.size(1) == 1 ? 0 : key_scales.strides()[1];
+  const int64_t ksStrideH = key_scales.strides()[2];
+  const int64_t vsStrideB = value_scales.strides()[0];
+  const int64_t vsStrideN =
+      value_scales.size(1) == 1 ? 0 : value_scales.strides()[1];
+  const int64_t vsStrideH = value_scales.strides()[2];
+  const int64_t mStrideM = has_attn_mask ? attn_mask.value().strides()[0] : 0;
+
+  const int64_t qSplitSize = std::min(q_split_size, qSize);
+  const int64_t kvSplitSize = std::min(kv_split_size, kvSize);
+  const int64_t qSlice = (qSize - 1) / qSplitSize + 1;
+#ifdef ET_USE_THREADPOOL
+  const int64_t num_thread =
+      ::executorch::extension::threadpool::get_threadpool()->get_thread_count();
+#else
+  const int64_t num_thread = 1;
+#endif
+
+  // Per thread temp buffers.
+  const int64_t float_size_per_thread =
+      /* qk      */ qSplitSize * kvSplitSize +
+      /* qk_max  */ qSplitSize +
+      /* qk_sum  */ qSplitSize +
+      /* q_scale */ qSplitSize +
+      /* dst     */ qSplitSize * headSize +
+      /* k_scale */ kvSplitSize +
+      /* v_scale */ kvSplitSize;
+  const int64_t int_size_per_thread =
+      /* q_sum  */ qSplitSize +
+      /* k_zp   */ kvSplitSize +
+      /* v_zp   */ kvSplitSize;
+  std::vector<float> float_buf(num_thread * float_size_per_thread);
+  std::vector<int32_t> int_buf(num_thread * int_size_per_thread);
+  std::vector<int8_t> q_int8_buf(num_thread * qSplitSize * headSize);
+
+  const float* q_data = query.const_data_ptr<float>();
+  const int8_t* k_data = key.const_data_ptr<int8_t>();
+  const int8_t* v_data = value.const_data_ptr<int8_t>();
+  const float* mask_data =
+      has_attn_mask ? attn_mask.value().const_data_ptr<float>() : nullptr;
+  float* out_data = output.mutable_data_ptr<float>();
+
+  auto compute_lambda = [&](int64_t begin, int64_t end) {
+    int64_t i = 0, j = 0, k = 0;
+    util::data_index_init(begin, i, batchSize, j, num_head, k, qSlice);
+    const int ompIdx = torch::executor::get_thread_num();
+    float* qk_data = float_buf.data() + ompIdx * float_size_per_thread;
+    float* qk_max_data = qk_data + qSplitSize * kvSplitSize;
+    float* qk_sum_data = qk_max_data + qSplitSize;
+    float* q_scale_data = qk_sum_data + qSplitSize;
+    float* dst_data = q_scale_data + qSplitSize;
+    float* k_scale_data = dst_data + qSplitSize * headSize;
+    float* v_scale_data = k_scale_data + kvSplitSize;
+    int32_t* q_sum_data = int_buf.data() + ompIdx * int_size_per_thread;
+    int32_t* k_zp_data = q_sum_data + qSplitSize;
+    int32_t* v_zp_data = k_zp_data + kvSplitSize;
+    int8_t* q_int8_data = q_int8_buf.data() + ompIdx * qSplitSize * headSize;
+
+    for (int64_t z = begin; z < end; z++) {
+      const int64_t m = k * qSplitSize;
+      const int64_t qBlockSize = std::min(qSplitSize, qSize - m);
+      const auto j_kv = j / num_reps;
+
+      // Quantize the rows of q, folding the softmax scale into theirs.
+      for (int64_t row = 0; row < qBlockSize; ++row) {
+        const float* q_row =
+            q_data + i * qStrideB + j * qStrideH + (m + row) * qStrideM;
+        float amax = 0;
+        for (int64_t d = 0; d < headSize; ++d) {
+          amax = std::max(amax, std::abs(q_row[d]));
+        }
+        const float q_scale = amax > 0 ? amax / 127 : 1;
+        const float inv_scale = 1 / q_scale;
+        int8_t* q_int8_row = q_int8_data + row * headSize;
+        int32_t q_sum = 0;
+        for (int64_t d = 0; d < headSize; ++d) {
+          q_int8_row[d] =
+              static_cast<int8_t>(std::nearbyint(q_row[d] * inv_scale));
+          q_sum += q_int8_row[d];
+        }
+        q_scale_data[row] = q_scale * scaling_factor;
+        q_sum_data[row] = q_sum;
+      }
+      fill_stub(
+          qk_max_data, -std::numeric_limits<float>::infinity(), qBlockSize);
+      fill_stub(qk_sum_data, 0.0f, qBlockSize);
+      fill_stub(dst_data, 0.0f, qBlockSize * headSize);
+
+      const int64_t num_keys =
+          is_causal ? std::min(m + start_pos + qBlockSize, kvSize) : kvSize;
+      for (int64_t n = 0; n < num_keys; n += kvSplitSize) {
+        const int64_t kvBlockSize = std::min(kvSplitSize, num_keys - n);
+        load_qparams(
+            key_scales,
+            key_zero_points,
+            i * ksStrideB + j_kv * ksStrideH + n * ksStrideN,
+            ksStrideN,
+            kvBlockSize,
+            k_scale_data,
+            k_zp_data);
+        load_qparams(
+            value_scales,
+            value_zero_points,
+            i * vsStrideB + j_kv * vsStrideH + n * vsStrideN,
+            vsStrideN,
+            kvBlockSize,
+            v_scale_data,
+            v_zp_data);
+        const int8_t* k_block =
+            k_data + i * kStrideB + j_kv * kStrideH + n * kStrideN;
+        const int8_t* v_block =
+            v_data + i * vStrideB + j_kv * vStrideH + n * vStrideN;
+
+        for (int64_t row = 0; row < qBlockSize; ++row) {
+          float* qk_row = qk_data + row * kvBlockSize;
+          // Keys after this row's position are masked out by causality.
+          const int64_t num_cols = is_causal
+              ? std::min(kvBlockSize, m + row + start_pos + 1 - n)
+              : kvBlockSize;
+          for (int64_t col = 0; col < num_cols; ++col) {
+            const int32_t acc = dot_int8(
+                q_int8_data + row * headSize,
+                k_block + col * kStrideN,
+                headSize) -
+                k_zp_data[col] * q_sum_data[row];
+            qk_row[col] = acc * q_scale_data[row] * k_scale_data[col];
+          }
+          if (num_cols < kvBlockSize) {
+            fill_stub(
+                qk_row + std::max<int64_t>(num_cols, 0),
+                -std::numeric_limits<float>::infinity(),
+                kvBlockSize - std::max<int64_t>(num_cols, 0));
+          }
+          if (has_attn_mask) {
+            vec::map2<float>(
+                [](Vec x, Vec y) { return x + y; },
+                qk_row,
+                qk_row,
+                mask_data + (m + row) * mStrideM + n,
+                kvBlockSize);
+          }
+
+          // Online softmax: rescale what was accumulated to the new max.
+          float tmp_max = vec::reduce_all<float>(
+              [](Vec& x, Vec& y) { return vec::maximum(x, y); },
+              qk_row,
+              kvBlockSize);
+          tmp_max = std::max(tmp_max, qk_max_data[row]);
+          if (tmp_max == -std::numeric_limits<float>::infinity()) {
+            // Every key so far is masked out.
+            continue;
+          }
+          float tmp_sum = tmp_max;
+          _exp_reduce_sum_fusion_kernel(qk_row, kvBlockSize, qk_row, tmp_sum);
+          const float exp_tmp = std::exp(qk_max_data[row] - tmp_max);
+          qk_sum_data[row] = tmp_sum + exp_tmp * qk_sum_data[row];
+          qk_max_data[row] = tmp_max;
+
+          // dst <- dst * exp_tmp + p @ v
+          float* dst_row = dst_data + row * headSize;
+          vec::map<float>(
+              [exp_tmp](Vec x) { return x * Vec(exp_tmp); },
+              dst_row,
+              dst_row,
+              headSize);
+          float zero_point_sum = 0;
+          for (int64_t col = 0; col < kvBlockSize; ++col) {
+            const float weight = qk_row[col] * v_scale_data[col];
+            if (weight == 0) {
+              continue;
+            }
+            zero_point_sum += weight * v_zp_data[col];
+            const int8_t* v_row = v_block + col * vStrideN;
+            for (int64_t d = 0; d < headSize; ++d) {
+              dst_row[d] += weight * v_row[d];
+            }
+          }
+          vec::map<float>(
+              [zero_point_sum](Vec x) { return x - Vec(zero_point_sum); },
+              dst_row,
+              dst_row,
+              headSize);
+        }
+      }
+      // dst <- dst / sum[row]
+      for (int64_t row = 0; row < qBlockSize; ++row) {
+        const float sum_reciprocal = 1 / qk_sum_data[row];
+        vec::map<float>(
+            [sum_reciprocal](Vec x) { return x * Vec(sum_reciprocal); },
+            out_data + i * oStrideB + j * oStrideH + (m + row) * oStrideM,
+            dst_data + row * headSize,
+            headSize);
+      }
+      // Move to the next query
+      util::data_index_step(i, batchSize, j, num_head, k, qSlice);
+    }
+  };
+  torch::executor::parallel_for(
+      0, batchSize * num_head * qSlice, 1, compute_lambda);
+}
+
+} // anonymous namespace
+
+Tensor& flash_attention_kernel_out(
+    RuntimeContext& ctx,
+    const Tensor& query,
+    const Tensor& key,
+    const Tensor& value,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  (void)ctx;
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_flash_attention_args(query, key, value, attn_mask),
+      InvalidArgument,
+      output);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, query.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  auto q_seq_len = query.size(2);
+
+  ET_SWITCH_FLOATHBF16_TYPES(
+      query.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
+        // TODO we need to re-evaluate this for ARM CPUs
+        // And there can be many so instead of templatizing
+        // we might consider another appraoch
+        if (q_seq_len >= 768) {
+          cpu_flash_attention<CTYPE, 256, 512>(
+              output,
+              query,
+              key,
+              value,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale);
+        } else if (q_seq_len >= 192) {
+          cpu_flash_attention<CTYPE, 64, 512>(
+              output,
+              query,
+              key,
+              value,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale);
+        } else {
+          cpu_flash_attention<CTYPE, 32, 512>(
+              output,
+              query,
+              key,
+              value,
+              dropout_p,
+              is_causal,
+              attn_mask,
+              scale);
+        }
+      });
+  return output;
+}
+
+/*
+  Input params
+  @param[in] q_projected Projected query with query weights.
+  Format [n_layers, batch size, seq_len, num heads, head dim]
+  @param[in] k_projected Projected query with key weights.
+  Format [n_layers, batch size, seq_len, num heads, head dim]
+  @param[in] v_projected Projected query with value weights.
+  Format [n_layers, batch size, seq_len, num heads, head dim]
+  @param[in] key_cache Cache of previous k_projected.
+  Format [n_layers, batch size, max_seq_len, num heads, head dim]
+  @param[in] key_cache Cache of previous v_projected.
+  Format [n_layers, batch size, max_seq_len, num heads, head dim]
+  ....
+  @param[in] start_pos: sequence position
+  @param[in] seq_len: Seq length. e.g. seq_len dim of q_projected.
+*/
+Tensor& custom_sdpa_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& k,
+    const Tensor& v,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !attn_mask.has_value() || !is_causal,
+      InvalidArgument,
+      output,
+      "attn_mask and is_causal cannot be set at the same time");
+
+  ET_CHECK_MSG(q.dim() == 4, "query must be a 4D tensor");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      q.scalar_type() == k.scalar_type() && q.scalar_type() == v.scalar_type(),
+      InvalidArgument,
+      output,
+      "query and the caches must have the same dtype");
+
+  const int64_t seq_len = q.size(1);
+
+  // Refactor the following into create_view util perhaps using
+  // TensorPtr
+  std::array<exec_aten::DimOrderType, util::kKVDim> sliced_key_dim_order{
+      0, 1, 2, 3};
+  std::array<exec_aten::SizesType, util::kKVDim> sliced_key_sizes;
+  sliced_key_sizes[0] = k.size(0);
+  sliced_key_sizes[1] = start_pos + seq_len; // key_cache.size(2);
+  sliced_key_sizes[2] = k.size(2);
+  sliced_key_sizes[3] = k.size(3);
+  std::array<exec_aten::StridesType, util::kKVDim> sliced_key_strides;
+  dim_order_to_stride_nocheck(
+      sliced_key_sizes.data(),
+      sliced_key_dim_order.data(),
+      util::kKVDim,
+      sliced_key_strides.data());
+  // since the cache is sliced, the batch stride needs to stay the same.
+  sliced_key_strides[0] = k.strides()[0];
+  void* key_cache_data = k.mutable_data_ptr();
+  TensorImpl k_impl = TensorImpl(
+      k.scalar_type(),
       util::kKVDim,
       sliced_key_sizes.data(),
       key_cache_data,
@@ -898,22 +1903,311 @@ Tensor& custom_sdpa_out(
   sliced_value_sizes[3] = v.size(3);
   std::array<exec_aten::StridesType, util::kKVDim> sliced_value_strides;
   dim_order_to_stride_nocheck(
-      sliced_value_sizes.data(),
-      sliced_value_dim_order.data(),
+      sliced_value_sizes.data(),
+      sliced_value_dim_order.data(),
+      util::kKVDim,
+      sliced_value_strides.data());
+  // since the cache is sliced, the batch stride needs to stay the same.
+  sliced_value_strides[0] = v.strides()[0];
+  void* value_cache_data = v.mutable_data_ptr();
+  TensorImpl value_impl = TensorImpl(
+      v.scalar_type(),
+      util::kKVDim,
+      sliced_value_sizes.data(),
+      value_cache_data,
+      sliced_value_dim_order.data(),
+      sliced_value_strides.data(),
+      TensorShapeDynamism::STATIC);
+  Tensor sliced_value_cache(&value_impl);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  flash_attention_seq_at_dim_1(
+      ctx,
+      output,
+      q,
+      sliced_key_cache,
+      sliced_value_cache,
+      dropout_p,
+      is_causal,
+      attn_mask,
+      scale,
+      start_pos);
+  return output;
+}
+/*
+  Input params
+  @param[in] q_projected Projected query with query weights.
+  Format [n_layers, batch size, seq_len, num heads, head dim]
+  @param[in] k_projected Projected query with key weights.
+  Format [n_layers, batch size, seq_len, num heads, head dim]
+  @param[in] v_projected Projected query with value weights.
+  Format [n_layers, batch size, seq_len, num heads, head dim]
+  @param[in] key_cache Cache of previous k_projected.
+  Format [n_layers, batch size, max_seq_len, num heads, head dim]
+  @param[in] key_cache Cache of previous v_projected.
+  Format [n_layers, batch size, max_seq_len, num heads, head dim]
+  ....
+  @param[in] start_pos: sequence position
+  @param[in] seq_len: Seq length. e.g. seq_len dim of q_projected.
+*/
+Tensor& sdpa_with_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t seq_len,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  (void)ctx;
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_cache_params(key_cache, value_cache, start_pos, seq_len),
+      InvalidArgument,
+      output);
+
+  ET_CHECK_MSG(q_projected.dim() == 4, "query must be a 4D tensor");
+
+  update_cache(k_projected, key_cache, start_pos, seq_len);
+  update_cache(v_projected, value_cache, start_pos, seq_len);
+
+  custom_sdpa_out(
+      ctx,
+      q_projected,
+      key_cache,
+      value_cache,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+
+  return output;
+}
+
+/*
+  Paged variant of custom_sdpa.
+  @param[in] q Query. Format [batch size, seq_len, num heads, head dim]
+  @param[in] key_cache Pool of key blocks.
+  Format [num_blocks, block_size, num kv heads, head dim]
+  @param[in] value_cache Pool of value blocks, same format as key_cache.
+  @param[in] block_table The blocks of each sequence in position order.
+  Format [batch size, max blocks per sequence], Long.
+  @param[in] start_pos: sequence position of the first query token.
+
+  The first start_pos + seq_len positions of every sequence are gathered by
+  block table into a contiguous scratch buffer that is then handed to the
+  flash attention kernel, so only the cache itself lives in blocks.
+*/
+Tensor& custom_sdpa_paged_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK_MSG(
+      ctx, q.dim() == 4, InvalidArgument, output, "query must be a 4D tensor");
+
+  const int64_t batch_size = q.size(0);
+  const int64_t kv_len = start_pos + q.size(1);
+  ET_KERNEL_CHECK(
+      ctx,
+      start_pos >= 0 &&
+          validate_paged_cache_params(
+              key_cache, value_cache, block_table, batch_size, kv_len),
+      InvalidArgument,
+      output);
+
+  std::array<exec_aten::DimOrderType, util::kKVDim> kv_dim_order{0, 1, 2, 3};
+  std::array<exec_aten::SizesType, util::kKVDim> kv_sizes{
+      static_cast<exec_aten::SizesType>(batch_size),
+      static_cast<exec_aten::SizesType>(kv_len),
+      key_cache.size(2),
+      key_cache.size(3)};
+  std::array<exec_aten::StridesType, util::kKVDim> kv_strides;
+  dim_order_to_stride_nocheck(
+      kv_sizes.data(), kv_dim_order.data(), util::kKVDim, kv_strides.data());
+
+  const size_t kv_bytes = batch_size * kv_len * key_cache.size(2) *
+      key_cache.size(3) * key_cache.element_size();
+  std::vector<uint8_t> key_data(kv_bytes);
+  std::vector<uint8_t> value_data(kv_bytes);
+  gather_paged_cache(
+      key_cache, block_table, batch_size, kv_len, key_data.data());
+  gather_paged_cache(
+      value_cache, block_table, batch_size, kv_len, value_data.data());
+
+  TensorImpl key_impl = TensorImpl(
+      key_cache.scalar_type(),
       util::kKVDim,
-      sliced_value_strides.data());
-  // since the cache is sliced, the batch stride needs to stay the same.
-  sliced_value_strides[0] = v.strides()[0];
-  void* value_cache_data = v.mutable_data_ptr();
+      kv_sizes.data(),
+      key_data.data(),
+      kv_dim_order.data(),
+      kv_strides.data(),
+      TensorShapeDynamism::STATIC);
   TensorImpl value_impl = TensorImpl(
-      v.scalar_type(),
+      value_cache.scalar_type(),
       util::kKVDim,
-      sliced_value_sizes.data(),
-      value_cache_data,
-      sliced_value_dim_order.data(),
-      sliced_value_strides.data(),
+      kv_sizes.data(),
+      value_data.data(),
+      kv_dim_order.data(),
+      kv_strides.data(),
       TensorShapeDynamism::STATIC);
-  Tensor sliced_value_cache(&value_impl);
+  Tensor key(&key_impl);
+  Tensor value(&value_impl);
+
+  return custom_sdpa_out(
+      ctx,
+      q,
+      key,
+      value,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+/*
+  Paged variant of sdpa_with_kv_cache: writes k_projected and v_projected to
+  the paged caches at start_pos, then runs custom_sdpa_paged over them.
+*/
+Tensor& sdpa_with_paged_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  update_cache_paged_out(
+      ctx, k_projected, key_cache, block_table, start_pos, output);
+  if (ctx.failure_state() != Error::Ok) {
+    return output;
+  }
+  update_cache_paged_out(
+      ctx, v_projected, value_cache, block_table, start_pos, output);
+  if (ctx.failure_state() != Error::Ok) {
+    return output;
+  }
+
+  return custom_sdpa_paged_out(
+      ctx,
+      q_projected,
+      key_cache,
+      value_cache,
+      block_table,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+/*
+  Variant of custom_sdpa over an int8 KV cache, as kept by QuantizedKVCache.
+  @param[in] q Query. Format [batch size, seq_len, num heads, head dim]
+  @param[in] key_cache Quantized cache of k_projected, int8.
+  Format [batch size, max_seq_len, num kv heads, head dim]
+  @param[in] value_cache Quantized cache of v_projected, same format.
+  @param[in] key_scales Scales of key_cache, float or double.
+  Format [batch size, max_seq_len, num kv heads, 1], or
+  [batch size, 1, num kv heads, 1] for one scale per head.
+  @param[in] key_zero_points Zero points of key_cache, same format, int8,
+  int32 or int64.
+  @param[in] value_scales, value_zero_points: Same for value_cache.
+  @param[in] start_pos: sequence position of the first query token.
+
+  The cache is dequantized on the fly inside the attention kernel, so the
+  first start_pos + seq_len positions are read as int8 and never copied to
+  float.
+*/
+Tensor& custom_quantized_sdpa_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const Tensor& key_scales,
+    const Tensor& key_zero_points,
+    const Tensor& value_scales,
+    const Tensor& value_zero_points,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  (void)dropout_p;
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !attn_mask.has_value() || !is_causal,
+      InvalidArgument,
+      output,
+      "attn_mask and is_causal cannot be set at the same time");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      q.dim() == 4 && q.scalar_type() == ScalarType::Float,
+      InvalidArgument,
+      output,
+      "query must be a 4D float tensor");
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_quantized_cache_params(key_cache, key_scales, key_zero_points) &&
+          validate_quantized_cache_params(
+              value_cache, value_scales, value_zero_points),
+      InvalidArgument,
+      output);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      key_cache.size(0) == q.size(0) && key_cache.size(3) == q.size(3) &&
+          value_cache.sizes() == key_cache.sizes(),
+      InvalidArgument,
+      output,
+      "key and value caches must match query in batch size and head dim");
+  const int64_t kv_len = start_pos + q.size(1);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      start_pos >= 0 && kv_len <= key_cache.size(1),
+      InvalidArgument,
+      output,
+      "start_pos + seq_len must be at most max_seq_len of the cache");
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      !attn_mask.has_value() ||
+          (attn_mask.value().dim() == 2 &&
+           attn_mask.value().scalar_type() == ScalarType::Float),
+      InvalidArgument,
+      output,
+      "Attention mask must be a 2D float tensor");
 
   ET_KERNEL_CHECK(
       ctx,
@@ -921,107 +2215,345 @@ Tensor& custom_sdpa_out(
       InvalidArgument,
       output);
 
-  // TODO(task): replace the template param selection logic
-  // with whatever apprpriately makes more sense for
-  ET_SWITCH_FLOAT_TYPES(q.scalar_type(), ctx, "flash_attention", CTYPE, [&] {
-    // TODO we need to re-evaluate this for ARM CPUs
-    // And there can be many so instead of templatizing
-    // we might consider another appraoch
-    if (q_seq_len >= 768) {
-      cpu_flash_attention<CTYPE, 256, 512>(
-          output,
-          q,
-          sliced_key_cache,
-          sliced_value_cache,
-          dropout_p,
-          is_causal,
-          attn_mask,
-          scale,
-          true, /* is_seq_at_dim_1 */
-          start_pos);
-    } else if (q_seq_len >= 192) {
-      cpu_flash_attention<CTYPE, 64, 512>(
-          output,
-          q,
-          sliced_key_cache,
-          sliced_value_cache,
-          dropout_p,
-          is_causal,
-          attn_mask,
-          scale,
-          true, /* is_seq_at_dim_1 */
-          start_pos);
-    } else {
-      cpu_flash_attention<CTYPE, 32, 512>(
-          output,
-          q,
-          sliced_key_cache,
-          sliced_value_cache,
-          dropout_p,
-          is_causal,
-          attn_mask,
-          scale,
-          true, /* is_seq_at_dim_1 */
-          start_pos);
-    }
-  });
+  cpu_quantized_flash_attention(
+      output,
+      q,
+      key_cache,
+      key_scales,
+      key_zero_points,
+      value_cache,
+      value_scales,
+      value_zero_points,
+      kv_len,
+      is_causal,
+      attn_mask,
+      scale,
+      start_pos);
   return output;
 }
+
 /*
-  Input params
-  @param[in] q_projected Projected query with query weights.
-  Format [n_layers, batch size, seq_len, num heads, head dim]
-  @param[in] k_projected Projected query with key weights.
-  Format [n_layers, batch size, seq_len, num heads, head dim]
-  @param[in] v_projected Projected query with value weights.
-  Format [n_layers, batch size, seq_len, num heads, head dim]
-  @param[in] key_cache Cache of previous k_projected.
-  Format [n_layers, batch size, max_seq_len, num heads, head dim]
-  @param[in] key_cache Cache of previous v_projected.
-  Format [n_layers, batch size, max_seq_len, num heads, head dim]
-  ....
-  @param[in] start_pos: sequence position
-  @param[in] seq_len: Seq length. e.g. seq_len dim of q_projected.
+  Quantized variant of sdpa_with_kv_cache: quantizes k_projected and
+  v_projected per token and head into the int8 caches at start_pos, with
+  their scales and zero points, then runs custom_quantized_sdpa over them.
 */
-Tensor& sdpa_with_kv_cache_out(
+Tensor& sdpa_with_quantized_kv_cache_out(
     KernelRuntimeContext& ctx,
     const Tensor& q_projected,
     const Tensor& k_projected,
     const Tensor& v_projected,
     Tensor& key_cache,
     Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& key_zero_points,
+    Tensor& value_scales,
+    Tensor& value_zero_points,
     const int64_t start_pos,
-    const int64_t seq_len,
     const optional<Tensor>& attn_mask,
     const double dropout_p,
     const bool is_causal,
     // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
     const optional<double> scale,
     Tensor& output) {
-  (void)ctx;
   ET_KERNEL_CHECK(
       ctx,
-      validate_cache_params(key_cache, value_cache, start_pos, seq_len),
+      validate_quantized_cache_params(key_cache, key_scales, key_zero_points) &&
+          validate_quantized_cache_params(
+              value_cache, value_scales, value_zero_points),
+      InvalidArgument,
+      output);
+  // Per-head parameters cannot take the ones of new tokens.
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      key_scales.size(1) == key_cache.size(1) &&
+          value_scales.size(1) == value_cache.size(1),
+      InvalidArgument,
+      output,
+      "scales and zero points must be per token to update the cache");
+  for (const Tensor* projected : {&k_projected, &v_projected}) {
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        projected->dim() == 4 &&
+            projected->scalar_type() == ScalarType::Float &&
+            is_contiguous_dim_order(
+                projected->dim_order().data(), projected->dim()) &&
+            projected->size(0) == key_cache.size(0) &&
+            projected->size(2) == key_cache.size(2) &&
+            projected->size(3) == key_cache.size(3),
+        InvalidArgument,
+        output,
+        "k and v must be contiguous float tensors matching the cache");
+  }
+  ET_KERNEL_CHECK(
+      ctx,
+      start_pos >= 0 && k_projected.size(1) == v_projected.size(1) &&
+          start_pos + k_projected.size(1) <= key_cache.size(1),
       InvalidArgument,
       output);
 
-  ET_CHECK_MSG(q_projected.dim() == 4, "query must be a 4D tensor");
-
-  update_cache(k_projected, key_cache, start_pos, seq_len);
-  update_cache(v_projected, value_cache, start_pos, seq_len);
+  quantize_to_cache(
+      k_projected, key_cache, key_scales, key_zero_points, start_pos);
+  quantize_to_cache(
+      v_projected, value_cache, value_scales, value_zero_points, start_pos);
 
-  custom_sdpa_out(
+  return custom_quantized_sdpa_out(
       ctx,
       q_projected,
       key_cache,
       value_cache,
+      key_scales,
+      key_zero_points,
+      value_scales,
+      value_zero_points,
       start_pos,
       attn_mask,
       dropout_p,
       is_causal,
       scale,
       output);
+}
+
+/*
+  Variant of custom_sdpa over a ring buffer cache, as written by
+  update_cache_ring, for sliding window attention with attention sinks.
+  @param[in] q Query. Format [batch size, seq_len, num heads, head dim]
+  @param[in] key_cache Ring buffer cache of k_projected.
+  Format [batch size, sink_size + window_size, num kv heads, head dim]
+  @param[in] value_cache Ring buffer cache of v_projected, same format.
+  @param[in] start_pos: sequence position of the first query token.
+  @param[in] sink_size: Number of leading positions the cache keeps for good.
+
+  Attention is causal. Until the sequence fills the cache this is
+  custom_sdpa. Afterwards every query attends to the sinks and to the
+  window, save for the later positions of its own chunk, so the window of
+  an earlier query of a chunk ends where the chunk ends. Keys keep the
+  rotary embedding of the position they were written at.
+*/
+Tensor& custom_sdpa_ring_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      q.dim() == 4 && key_cache.dim() == 4 &&
+          key_cache.sizes() == value_cache.sizes() &&
+          q.size(0) == key_cache.size(0) && q.size(3) == key_cache.size(3) &&
+          q.scalar_type() == key_cache.scalar_type() &&
+          q.scalar_type() == value_cache.scalar_type(),
+      InvalidArgument,
+      output,
+      "query and ring caches must be 4D tensors of matching shape and type");
+
+  const int64_t seq_len = q.size(1);
+  const int64_t max_seq_len = key_cache.size(1);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      start_pos >= 0 && sink_size >= 0 && sink_size < max_seq_len &&
+          seq_len <= max_seq_len - sink_size,
+      InvalidArgument,
+      output,
+      "seq_len must be at most the window of the ring cache");
+
+  const int64_t end = start_pos + seq_len;
+  if (end <= max_seq_len) {
+    return custom_sdpa_out(
+        ctx,
+        q,
+        key_cache,
+        value_cache,
+        start_pos,
+        {},
+        dropout_p,
+        true, /* is_causal */
+        scale,
+        output);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  // Every slot of the cache holds a position at most end - 1, which the
+  // mask hides from the queries before it.
+  const RingCacheMask ring_mask{sink_size, max_seq_len - sink_size, end};
+  flash_attention_seq_at_dim_1(
+      ctx,
+      output,
+      q,
+      key_cache,
+      value_cache,
+      dropout_p,
+      false, /* is_causal */
+      {},
+      scale,
+      start_pos,
+      &ring_mask);
+  return output;
+}
+
+/*
+  Ring buffer variant of sdpa_with_kv_cache: writes k_projected and
+  v_projected to the ring caches at start_pos, then runs custom_sdpa_ring
+  over them.
+*/
+Tensor& sdpa_with_ring_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  update_cache_ring_out(
+      ctx, k_projected, key_cache, start_pos, sink_size, output);
+  if (ctx.failure_state() != Error::Ok) {
+    return output;
+  }
+  update_cache_ring_out(
+      ctx, v_projected, value_cache, start_pos, sink_size, output);
+  if (ctx.failure_state() != Error::Ok) {
+    return output;
+  }
+
+  return custom_sdpa_ring_out(
+      ctx,
+      q_projected,
+      key_cache,
+      value_cache,
+      start_pos,
+      sink_size,
+      dropout_p,
+      scale,
+      output);
+}
+
+/*
+  Attention of decoder tokens to a cross-attention KV cache, which holds the
+  keys and values projected from the output of an encoder, e.g. of an image.
+  The cache is filled once after encoding instead of being recomputed or
+  written to at every decode step, so it is an input here.
+  @param[in] q Query. Format [batch size, seq_len, num heads, head dim]
+  @param[in] key_cache Format [batch size, encoder seq_len, num kv heads,
+  head dim]
+  @param[in] value_cache Same format as key_cache.
+  @param[in] attn_mask Optional Bool mask of whether each query attends to
+  each key. Format [seq_len, encoder seq_len], or [1, seq_len, encoder
+  seq_len], shared by the whole batch. Every query must attend to at least
+  one key.
+
+  Attention is not causal and reads the whole cache.
+*/
+Tensor& cross_attention_sdpa_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const optional<Tensor>& attn_mask,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      q.dim() == 4 && key_cache.dim() == 4 &&
+          key_cache.sizes() == value_cache.sizes() &&
+          q.size(0) == key_cache.size(0) && q.size(3) == key_cache.size(3) &&
+          q.scalar_type() == key_cache.scalar_type() &&
+          q.scalar_type() == value_cache.scalar_type(),
+      InvalidArgument,
+      output,
+      "query and caches must be 4D tensors of matching shape and type");
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_flash_attention_args(q, key_cache, value_cache, {}),
+      InvalidArgument,
+      output);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(output, q.sizes()) == Error::Ok,
+      InvalidArgument,
+      output);
+
+  if (!attn_mask.has_value()) {
+    flash_attention_seq_at_dim_1(
+        ctx,
+        output,
+        q,
+        key_cache,
+        value_cache,
+        0.0, /* dropout_p */
+        false, /* is_causal */
+        {},
+        scale,
+        0 /* start_pos */);
+    return output;
+  }
 
+  const Tensor& mask = attn_mask.value();
+  const int64_t seq_len = q.size(1);
+  const int64_t kv_len = key_cache.size(1);
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      mask.scalar_type() == ScalarType::Bool &&
+          (mask.dim() == 2 || (mask.dim() == 3 && mask.size(0) == 1)) &&
+          mask.size(mask.dim() - 2) == seq_len &&
+          mask.size(mask.dim() - 1) == kv_len &&
+          is_contiguous_dim_order(mask.dim_order().data(), mask.dim()),
+      InvalidArgument,
+      output,
+      "attn_mask must be a contiguous Bool [seq_len, encoder seq_len] mask");
+
+  // The flash attention kernel adds a mask of the query's type to the
+  // scores, so turn the masked out keys into -inf.
+  std::array<exec_aten::DimOrderType, 2> mask_dim_order{0, 1};
+  std::array<exec_aten::SizesType, 2> mask_sizes{
+      static_cast<exec_aten::SizesType>(seq_len),
+      static_cast<exec_aten::SizesType>(kv_len)};
+  std::array<exec_aten::StridesType, 2> mask_strides{
+      static_cast<exec_aten::StridesType>(kv_len), 1};
+  const bool* mask_data = mask.const_data_ptr<bool>();
+  ET_SWITCH_FLOATHBF16_TYPES(
+      q.scalar_type(), ctx, "cross_attention_sdpa.out", CTYPE, [&] {
+        std::vector<CTYPE> float_mask(seq_len * kv_len);
+        for (size_t i = 0; i < float_mask.size(); ++i) {
+          float_mask[i] = mask_data[i]
+              ? static_cast<CTYPE>(0)
+              : static_cast<CTYPE>(-std::numeric_limits<float>::infinity());
+        }
+        TensorImpl mask_impl = TensorImpl(
+            q.scalar_type(),
+            2,
+            mask_sizes.data(),
+            float_mask.data(),
+            mask_dim_order.data(),
+            mask_strides.data(),
+            TensorShapeDynamism::STATIC);
+        flash_attention_seq_at_dim_1(
+            ctx,
+            output,
+            q,
+            key_cache,
+            value_cache,
+            0.0, /* dropout_p */
+            false, /* is_causal */
+            Tensor(&mask_impl),
+            scale,
+            0 /* start_pos */);
+      });
   return output;
 }
 } // namespace native
@@ -1037,3 +2569,38 @@ EXECUTORCH_LIBRARY(
     llama,
     "custom_sdpa.out",
     torch::executor::native::custom_sdpa_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "custom_sdpa_paged.out",
+    torch::executor::native::custom_sdpa_paged_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "sdpa_with_paged_kv_cache.out",
+    torch::executor::native::sdpa_with_paged_kv_cache_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "custom_quantized_sdpa.out",
+    torch::executor::native::custom_quantized_sdpa_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "sdpa_with_quantized_kv_cache.out",
+    torch::executor::native::sdpa_with_quantized_kv_cache_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "custom_sdpa_ring.out",
+    torch::executor::native::custom_sdpa_ring_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "sdpa_with_ring_kv_cache.out",
+    torch::executor::native::sdpa_with_ring_kv_cache_out);
+
+EXECUTORCH_LIBRARY(
+    llama,
+    "cross_attention_sdpa.out",
+    torch::executor::native::cross_attention_sdpa_out);
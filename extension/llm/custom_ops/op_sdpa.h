@@ -44,6 +44,108 @@ Tensor& custom_sdpa_out(
     const optional<double> scale,
     Tensor& output);
 
+Tensor& custom_sdpa_paged_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
+Tensor& sdpa_with_paged_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
+Tensor& custom_quantized_sdpa_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const Tensor& key_scales,
+    const Tensor& key_zero_points,
+    const Tensor& value_scales,
+    const Tensor& value_zero_points,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
+Tensor& sdpa_with_quantized_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& key_zero_points,
+    Tensor& value_scales,
+    Tensor& value_zero_points,
+    const int64_t start_pos,
+    const optional<Tensor>& attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
+Tensor& custom_sdpa_ring_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
+Tensor& sdpa_with_ring_kv_cache_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
+Tensor& cross_attention_sdpa_out(
+    RuntimeContext& ctx,
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const optional<Tensor>& attn_mask,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output);
+
 Tensor& flash_attention_kernel_out(
     KernelRuntimeContext& ctx,
     const Tensor& query,
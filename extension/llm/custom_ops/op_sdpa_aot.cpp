@@ -147,6 +147,439 @@ at::Tensor update_cache_aten(
   return output;
 }
 
+Tensor& update_cache_paged_out_no_context(
+    const Tensor& value,
+    Tensor& cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::update_cache_paged_out(
+      context, value, cache, block_table, start_pos, output);
+}
+
+at::Tensor update_cache_paged_aten(
+    const at::Tensor& value,
+    at::Tensor& cache,
+    const at::Tensor& block_table,
+    const int64_t start_pos) {
+  auto output = at::empty({1});
+  WRAP_TO_ATEN(update_cache_paged_out_no_context, 4)
+  (value, cache, block_table, start_pos, output);
+  return output;
+}
+
+Tensor& custom_sdpa_paged_out_no_context(
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::custom_sdpa_paged_out(
+      context,
+      q,
+      key_cache,
+      value_cache,
+      block_table,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+at::Tensor custom_sdpa_paged_aten(
+    const at::Tensor& q,
+    const at::Tensor& key_cache,
+    const at::Tensor& value_cache,
+    const at::Tensor& block_table,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q);
+  WRAP_TO_ATEN(custom_sdpa_paged_out_no_context, 9)
+  (q,
+   key_cache,
+   value_cache,
+   block_table,
+   start_pos,
+   attn_mask,
+   dropout_p,
+   is_causal,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& sdpa_with_paged_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::sdpa_with_paged_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      block_table,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_paged_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    const at::Tensor& block_table,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_paged_kv_cache_out_no_context, 11)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   block_table,
+   start_pos,
+   attn_mask,
+   dropout_p,
+   is_causal,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& custom_quantized_sdpa_out_no_context(
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const Tensor& key_scales,
+    const Tensor& key_zero_points,
+    const Tensor& value_scales,
+    const Tensor& value_zero_points,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::custom_quantized_sdpa_out(
+      context,
+      q,
+      key_cache,
+      value_cache,
+      key_scales,
+      key_zero_points,
+      value_scales,
+      value_zero_points,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+at::Tensor custom_quantized_sdpa_aten(
+    const at::Tensor& q,
+    const at::Tensor& key_cache,
+    const at::Tensor& value_cache,
+    const at::Tensor& key_scales,
+    const at::Tensor& key_zero_points,
+    const at::Tensor& value_scales,
+    const at::Tensor& value_zero_points,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q);
+  WRAP_TO_ATEN(custom_quantized_sdpa_out_no_context, 12)
+  (q,
+   key_cache,
+   value_cache,
+   key_scales,
+   key_zero_points,
+   value_scales,
+   value_zero_points,
+   start_pos,
+   attn_mask,
+   dropout_p,
+   is_causal,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& sdpa_with_quantized_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    Tensor& key_scales,
+    Tensor& key_zero_points,
+    Tensor& value_scales,
+    Tensor& value_zero_points,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::sdpa_with_quantized_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      key_scales,
+      key_zero_points,
+      value_scales,
+      value_zero_points,
+      start_pos,
+      attn_mask,
+      dropout_p,
+      is_causal,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_quantized_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    at::Tensor& key_scales,
+    at::Tensor& key_zero_points,
+    at::Tensor& value_scales,
+    at::Tensor& value_zero_points,
+    const int64_t start_pos,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> attn_mask,
+    const double dropout_p,
+    const bool is_causal,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_quantized_kv_cache_out_no_context, 14)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   key_scales,
+   key_zero_points,
+   value_scales,
+   value_zero_points,
+   start_pos,
+   attn_mask,
+   dropout_p,
+   is_causal,
+   scale,
+   output);
+  return output;
+}
+
+
+Tensor& update_cache_ring_out_no_context(
+    const Tensor& value,
+    Tensor& cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::update_cache_ring_out(
+      context, value, cache, start_pos, sink_size, output);
+}
+
+at::Tensor update_cache_ring_aten(
+    const at::Tensor& value,
+    at::Tensor& cache,
+    const int64_t start_pos,
+    const int64_t sink_size) {
+  auto output = at::empty({1});
+  WRAP_TO_ATEN(update_cache_ring_out_no_context, 4)
+  (value, cache, start_pos, sink_size, output);
+  return output;
+}
+
+Tensor& custom_sdpa_ring_out_no_context(
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::custom_sdpa_ring_out(
+      context,
+      q,
+      key_cache,
+      value_cache,
+      start_pos,
+      sink_size,
+      dropout_p,
+      scale,
+      output);
+}
+
+at::Tensor custom_sdpa_ring_aten(
+    const at::Tensor& q,
+    const at::Tensor& key_cache,
+    const at::Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q);
+  WRAP_TO_ATEN(custom_sdpa_ring_out_no_context, 7)
+  (q, key_cache, value_cache, start_pos, sink_size, dropout_p, scale, output);
+  return output;
+}
+
+Tensor& sdpa_with_ring_kv_cache_out_no_context(
+    const Tensor& q_projected,
+    const Tensor& k_projected,
+    const Tensor& v_projected,
+    Tensor& key_cache,
+    Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  executorch::runtime::KernelRuntimeContext context{};
+  return torch::executor::native::sdpa_with_ring_kv_cache_out(
+      context,
+      q_projected,
+      k_projected,
+      v_projected,
+      key_cache,
+      value_cache,
+      start_pos,
+      sink_size,
+      dropout_p,
+      scale,
+      output);
+}
+
+at::Tensor sdpa_with_ring_kv_cache_aten(
+    const at::Tensor& q_projected,
+    const at::Tensor& k_projected,
+    const at::Tensor& v_projected,
+    at::Tensor& key_cache,
+    at::Tensor& value_cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    const double dropout_p,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q_projected);
+  WRAP_TO_ATEN(sdpa_with_ring_kv_cache_out_no_context, 9)
+  (q_projected,
+   k_projected,
+   v_projected,
+   key_cache,
+   value_cache,
+   start_pos,
+   sink_size,
+   dropout_p,
+   scale,
+   output);
+  return output;
+}
+
+Tensor& cross_attention_sdpa_out_no_context(
+    const Tensor& q,
+    const Tensor& key_cache,
+    const Tensor& value_cache,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<Tensor> attn_mask,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const optional<double> scale,
+    Tensor& output) {
+  exec_aten::RuntimeContext context{};
+  return torch::executor::native::cross_attention_sdpa_out(
+      context, q, key_cache, value_cache, attn_mask, scale, output);
+}
+
+at::Tensor cross_attention_sdpa_aten(
+    const at::Tensor& q,
+    const at::Tensor& key_cache,
+    const at::Tensor& value_cache,
+    // @lint-ignore CLANGTIDY facebook-hte-ConstantArgumentPassByValue
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<at::Tensor> attn_mask,
+    // @lint-ignore CLANGTIDY facebook-hte-ParameterMightThrowOnCopy
+    const std::optional<double> scale) {
+  auto output = at::empty_like(q);
+  WRAP_TO_ATEN(cross_attention_sdpa_out_no_context, 5)
+  (q, key_cache, value_cache, attn_mask, scale, output);
+  return output;
+}
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -174,6 +607,86 @@ TORCH_LIBRARY_FRAGMENT(llama, m) {
   m.def(
       "update_cache.out(Tensor value, Tensor(a!) cache, "
       "SymInt start_pos, *, Tensor(b!) out) -> Tensor(b!)");
+  m.def(
+      "update_cache_paged(Tensor value, Tensor(a!) cache, Tensor block_table, "
+      "SymInt start_pos) -> Tensor");
+  m.def(
+      "update_cache_paged.out(Tensor value, Tensor(a!) cache, Tensor block_table, "
+      "SymInt start_pos, *, Tensor(b!) out) -> Tensor(b!)");
+  m.def(
+      "custom_sdpa_paged(Tensor query, Tensor key_cache, Tensor value_cache, "
+      "Tensor block_table, SymInt start_pos, Tensor? attn_mask=None, "
+      "float drpout_p=0.0, bool is_causal=False, float? scale=None) -> Tensor");
+  m.def(
+      "custom_sdpa_paged.out(Tensor query, Tensor key_cache, Tensor value_cache, "
+      "Tensor block_table, SymInt start_pos, Tensor? attn_mask=None, "
+      "float drpout_p=0.0, bool is_causal=False, float? scale=None, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "sdpa_with_paged_kv_cache(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, Tensor block_table, "
+      "SymInt start_pos, Tensor? attn_mask=None, float drpout_p=0.0, "
+      "bool is_causal=False, float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_paged_kv_cache.out(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, Tensor block_table, "
+      "SymInt start_pos, Tensor? attn_mask=None, float drpout_p=0.0, "
+      "bool is_causal=False, float? scale=None, *, Tensor(c!) out) -> Tensor(c!)");
+  m.def(
+      "custom_quantized_sdpa(Tensor query, Tensor key_cache, Tensor value_cache, "
+      "Tensor key_scales, Tensor key_zero_points, Tensor value_scales, "
+      "Tensor value_zero_points, SymInt start_pos, Tensor? attn_mask=None, "
+      "float drpout_p=0.0, bool is_causal=False, float? scale=None) -> Tensor");
+  m.def(
+      "custom_quantized_sdpa.out(Tensor query, Tensor key_cache, Tensor value_cache, "
+      "Tensor key_scales, Tensor key_zero_points, Tensor value_scales, "
+      "Tensor value_zero_points, SymInt start_pos, Tensor? attn_mask=None, "
+      "float drpout_p=0.0, bool is_causal=False, float? scale=None, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "sdpa_with_quantized_kv_cache(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, Tensor(c!) key_scales, "
+      "Tensor(d!) key_zero_points, Tensor(e!) value_scales, "
+      "Tensor(f!) value_zero_points, SymInt start_pos, Tensor? attn_mask=None, "
+      "float drpout_p=0.0, bool is_causal=False, float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_quantized_kv_cache.out(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, Tensor(c!) key_scales, "
+      "Tensor(d!) key_zero_points, Tensor(e!) value_scales, "
+      "Tensor(f!) value_zero_points, SymInt start_pos, Tensor? attn_mask=None, "
+      "float drpout_p=0.0, bool is_causal=False, float? scale=None, *, "
+      "Tensor(g!) out) -> Tensor(g!)");
+  m.def(
+      "update_cache_ring(Tensor value, Tensor(a!) cache, SymInt start_pos, "
+      "int sink_size) -> Tensor");
+  m.def(
+      "update_cache_ring.out(Tensor value, Tensor(a!) cache, SymInt start_pos, "
+      "int sink_size, *, Tensor(b!) out) -> Tensor(b!)");
+  m.def(
+      "custom_sdpa_ring(Tensor query, Tensor key_cache, Tensor value_cache, "
+      "SymInt start_pos, int sink_size, float drpout_p=0.0, "
+      "float? scale=None) -> Tensor");
+  m.def(
+      "custom_sdpa_ring.out(Tensor query, Tensor key_cache, Tensor value_cache, "
+      "SymInt start_pos, int sink_size, float drpout_p=0.0, "
+      "float? scale=None, *, Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "sdpa_with_ring_kv_cache(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, SymInt start_pos, "
+      "int sink_size, float drpout_p=0.0, float? scale=None) -> Tensor");
+  m.def(
+      "sdpa_with_ring_kv_cache.out(Tensor query, Tensor key, Tensor value, "
+      "Tensor(a!) key_cache, Tensor(b!) value_cache, SymInt start_pos, "
+      "int sink_size, float drpout_p=0.0, float? scale=None, *, "
+      "Tensor(c!) out) -> Tensor(c!)");
+  m.def(
+      "cross_attention_sdpa(Tensor query, Tensor key_cache, "
+      "Tensor value_cache, Tensor? attn_mask=None, float? scale=None) "
+      "-> Tensor");
+  m.def(
+      "cross_attention_sdpa.out(Tensor query, Tensor key_cache, "
+      "Tensor value_cache, Tensor? attn_mask=None, float? scale=None, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
 }
 
 // TODO: Rename this file to op_custom_ops_aot.cpp
@@ -192,4 +705,62 @@ TORCH_LIBRARY_IMPL(llama, CompositeExplicitAutograd, m) {
   m.impl(
       "update_cache.out",
       WRAP_TO_ATEN(torch::executor::native::update_cache_out_no_context, 3));
+  m.impl(
+      "update_cache_paged", torch::executor::native::update_cache_paged_aten);
+  m.impl(
+      "update_cache_paged.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::update_cache_paged_out_no_context, 4));
+  m.impl("custom_sdpa_paged", torch::executor::native::custom_sdpa_paged_aten);
+  m.impl(
+      "custom_sdpa_paged.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::custom_sdpa_paged_out_no_context, 9));
+  m.impl(
+      "sdpa_with_paged_kv_cache",
+      torch::executor::native::sdpa_with_paged_kv_cache_aten);
+  m.impl(
+      "sdpa_with_paged_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_paged_kv_cache_out_no_context,
+          11));
+  m.impl(
+      "custom_quantized_sdpa",
+      torch::executor::native::custom_quantized_sdpa_aten);
+  m.impl(
+      "custom_quantized_sdpa.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::custom_quantized_sdpa_out_no_context, 12));
+  m.impl(
+      "sdpa_with_quantized_kv_cache",
+      torch::executor::native::sdpa_with_quantized_kv_cache_aten);
+  m.impl(
+      "sdpa_with_quantized_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_quantized_kv_cache_out_no_context,
+          14));
+  m.impl("update_cache_ring", torch::executor::native::update_cache_ring_aten);
+  m.impl(
+      "update_cache_ring.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::update_cache_ring_out_no_context, 4));
+  m.impl("custom_sdpa_ring", torch::executor::native::custom_sdpa_ring_aten);
+  m.impl(
+      "custom_sdpa_ring.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::custom_sdpa_ring_out_no_context, 7));
+  m.impl(
+      "sdpa_with_ring_kv_cache",
+      torch::executor::native::sdpa_with_ring_kv_cache_aten);
+  m.impl(
+      "sdpa_with_ring_kv_cache.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::sdpa_with_ring_kv_cache_out_no_context, 9));
+  m.impl(
+      "cross_attention_sdpa",
+      torch::executor::native::cross_attention_sdpa_aten);
+  m.impl(
+      "cross_attention_sdpa.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::cross_attention_sdpa_out_no_context, 5));
 }
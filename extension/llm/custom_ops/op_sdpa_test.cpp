@@ -6,9 +6,14 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <cmath>
 #include <limits>
+#include <vector>
 
 #include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/llm/custom_ops/test_util.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
 
 #include <executorch/kernels/test/TestUtil.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
@@ -17,6 +22,7 @@
 #include <gtest/gtest.h>
 
 using namespace ::testing;
+using executorch::extension::llm::testing::make_data;
 using executorch::runtime::testing::TensorFactory;
 
 exec_aten::Tensor op_scaled_dot_product_attention(
@@ -513,3 +519,275 @@ TEST(OpScaledDotProductAttentionTest, CorrectnessTest_51) {
       query, key, value, attn_mask, dropout_p, is_causal, scale, out);
   EXPECT_TENSOR_CLOSE(ret, ret_expected);
 }
+
+// A single query token over a long KV cache is split across threads. Checks
+// the combined chunks against attention computed in one pass, with the
+// masked out positions in the middle of a chunk and filling the last one.
+TEST(OpScaledDotProductAttentionTest, SplitKVDecodeMatchesReference) {
+  TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  ::executorch::extension::threadpool::ThreadPool threadpool(4);
+  ::executorch::extension::threadpool::ThreadPoolGuard guard(&threadpool);
+
+  constexpr int64_t kKVLen = 2000;
+  constexpr int64_t kDim = 8;
+  std::vector<float> q_data = make_data(kDim, 0.7f);
+  std::vector<float> k_data = make_data(kKVLen * kDim, 0.37f);
+  std::vector<float> v_data = make_data(kKVLen * kDim, 0.53f);
+  std::vector<float> mask_data(kKVLen, 0.0f);
+  for (int64_t n = 600; n < 700; ++n) {
+    mask_data[n] = -std::numeric_limits<float>::infinity();
+  }
+  for (int64_t n = 1500; n < kKVLen; ++n) {
+    mask_data[n] = -std::numeric_limits<float>::infinity();
+  }
+
+  // One head, so that even a single query token can use all threads.
+  exec_aten::Tensor query = tfFloat.make({1, 1, 1, kDim}, q_data);
+  exec_aten::Tensor key = tfFloat.make({1, 1, kKVLen, kDim}, k_data);
+  exec_aten::Tensor value = tfFloat.make({1, 1, kKVLen, kDim}, v_data);
+  exec_aten::optional<exec_aten::Tensor> attn_mask =
+      exec_aten::optional<exec_aten::Tensor>(
+          tfFloat.make({1, kKVLen}, mask_data));
+
+  std::vector<double> scores(kKVLen);
+  double max_score = -std::numeric_limits<double>::infinity();
+  for (int64_t n = 0; n < kKVLen; ++n) {
+    double dot = 0;
+    for (int64_t d = 0; d < kDim; ++d) {
+      dot += q_data[d] * k_data[n * kDim + d];
+    }
+    scores[n] = dot / std::sqrt(static_cast<double>(kDim)) + mask_data[n];
+    max_score = std::max(max_score, scores[n]);
+  }
+  std::vector<double> expected_data(kDim, 0.0);
+  double sum = 0;
+  for (int64_t n = 0; n < kKVLen; ++n) {
+    const double weight = std::exp(scores[n] - max_score);
+    sum += weight;
+    for (int64_t d = 0; d < kDim; ++d) {
+      expected_data[d] += weight * v_data[n * kDim + d];
+    }
+  }
+  std::vector<float> expected_float(kDim);
+  for (int64_t d = 0; d < kDim; ++d) {
+    expected_float[d] = expected_data[d] / sum;
+  }
+
+  exec_aten::Tensor out = tfFloat.zeros({1, 1, 1, kDim});
+  exec_aten::Tensor ret = op_scaled_dot_product_attention(
+      query, key, value, attn_mask, 0.0, /*is_causal=*/false, {}, out);
+  EXPECT_TENSOR_CLOSE(ret, tfFloat.make({1, 1, 1, kDim}, expected_float));
+}
+
+namespace {
+
+// Attention of query [batch, heads, q_len, dim] over key and value
+// [batch, kv_heads, kv_len, dim], where query head j reads kv head
+// j / (heads / kv_heads).
+std::vector<float> reference_gqa_attention(
+    const std::vector<float>& q,
+    const std::vector<float>& k,
+    const std::vector<float>& v,
+    int64_t batch,
+    int64_t heads,
+    int64_t kv_heads,
+    int64_t q_len,
+    int64_t kv_len,
+    int64_t dim,
+    bool is_causal) {
+  std::vector<float> out(batch * heads * q_len * dim);
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t h = 0; h < heads; ++h) {
+      const int64_t h_kv = h / (heads / kv_heads);
+      const float* k_head = k.data() + (b * kv_heads + h_kv) * kv_len * dim;
+      const float* v_head = v.data() + (b * kv_heads + h_kv) * kv_len * dim;
+      for (int64_t m = 0; m < q_len; ++m) {
+        const float* q_row = q.data() + ((b * heads + h) * q_len + m) * dim;
+        const int64_t num_keys = is_causal ? m + 1 : kv_len;
+        std::vector<double> scores(num_keys);
+        double max_score = -std::numeric_limits<double>::infinity();
+        for (int64_t n = 0; n < num_keys; ++n) {
+          double dot = 0;
+          for (int64_t d = 0; d < dim; ++d) {
+            dot += q_row[d] * k_head[n * dim + d];
+          }
+          scores[n] = dot / std::sqrt(static_cast<double>(dim));
+          max_score = std::max(max_score, scores[n]);
+        }
+        std::vector<double> acc(dim, 0.0);
+        double sum = 0;
+        for (int64_t n = 0; n < num_keys; ++n) {
+          const double weight = std::exp(scores[n] - max_score);
+          sum += weight;
+          for (int64_t d = 0; d < dim; ++d) {
+            acc[d] += weight * v_head[n * dim + d];
+          }
+        }
+        float* out_row = out.data() + ((b * heads + h) * q_len + m) * dim;
+        for (int64_t d = 0; d < dim; ++d) {
+          out_row[d] = acc[d] / sum;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+void expect_gqa_matches_reference(
+    int64_t batch,
+    int64_t heads,
+    int64_t kv_heads,
+    int64_t q_len,
+    int64_t kv_len,
+    bool is_causal) {
+  TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  constexpr int64_t kDim = 8;
+  std::vector<float> q_data = make_data(batch * heads * q_len * kDim, 0.7f);
+  std::vector<float> k_data =
+      make_data(batch * kv_heads * kv_len * kDim, 0.37f);
+  std::vector<float> v_data =
+      make_data(batch * kv_heads * kv_len * kDim, 0.53f);
+
+  exec_aten::Tensor query =
+      tfFloat.make({(int)batch, (int)heads, (int)q_len, kDim}, q_data);
+  exec_aten::Tensor key =
+      tfFloat.make({(int)batch, (int)kv_heads, (int)kv_len, kDim}, k_data);
+  exec_aten::Tensor value =
+      tfFloat.make({(int)batch, (int)kv_heads, (int)kv_len, kDim}, v_data);
+  exec_aten::Tensor out =
+      tfFloat.zeros({(int)batch, (int)heads, (int)q_len, kDim});
+  exec_aten::Tensor ret = op_scaled_dot_product_attention(
+      query, key, value, {}, 0.0, is_causal, {}, out);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      ret,
+      tfFloat.make(
+          {(int)batch, (int)heads, (int)q_len, kDim},
+          reference_gqa_attention(
+              q_data,
+              k_data,
+              v_data,
+              batch,
+              heads,
+              kv_heads,
+              q_len,
+              kv_len,
+              kDim,
+              is_causal)),
+      1e-5,
+      1e-6);
+}
+
+} // namespace
+
+// The query heads that share a kv head are computed together. Covers blocks
+// of several queries, which take one gemm per query head, and single query
+// tokens, whose heads share one gemm.
+TEST(OpScaledDotProductAttentionTest, GroupedQueryAttentionMatchesReference) {
+  ::executorch::extension::threadpool::ThreadPool threadpool(4);
+  ::executorch::extension::threadpool::ThreadPoolGuard guard(&threadpool);
+
+  // Two blocks of queries, causal.
+  expect_gqa_matches_reference(
+      /*batch=*/2,
+      /*heads=*/8,
+      /*kv_heads=*/2,
+      /*q_len=*/40,
+      /*kv_len=*/40,
+      /*is_causal=*/true);
+  // A single query token with a kv head per thread.
+  expect_gqa_matches_reference(
+      /*batch=*/1,
+      /*heads=*/8,
+      /*kv_heads=*/4,
+      /*q_len=*/1,
+      /*kv_len=*/600,
+      /*is_causal=*/false);
+  // A single query token with fewer kv heads than threads, split across the
+  // keys.
+  expect_gqa_matches_reference(
+      /*batch=*/1,
+      /*heads=*/6,
+      /*kv_heads=*/2,
+      /*q_len=*/1,
+      /*kv_len=*/1100,
+      /*is_causal=*/false);
+}
+
+namespace {
+
+// Runs attention on Half or BFloat16 inputs and checks it against attention
+// computed in double on the same, rounded, inputs, so that only the rounding
+// of the output, not an fp16 accumulation, is within the tolerance.
+template <exec_aten::ScalarType DTYPE>
+void expect_reduced_matches_reference(
+    int64_t heads,
+    int64_t kv_heads,
+    int64_t q_len,
+    int64_t kv_len,
+    bool is_causal) {
+  using CTYPE = typename TensorFactory<DTYPE>::ctype;
+  TensorFactory<DTYPE> tf;
+  constexpr int64_t kDim = 8;
+  auto make_rounded = [](size_t size, float step, std::vector<CTYPE>& out) {
+    std::vector<float> data = make_data(size, step);
+    out.resize(size);
+    for (size_t i = 0; i < size; ++i) {
+      out[i] = static_cast<CTYPE>(data[i]);
+      data[i] = static_cast<float>(out[i]);
+    }
+    return data;
+  };
+  std::vector<CTYPE> q_reduced, k_reduced, v_reduced;
+  std::vector<float> q_data =
+      make_rounded(heads * q_len * kDim, 0.7f, q_reduced);
+  std::vector<float> k_data =
+      make_rounded(kv_heads * kv_len * kDim, 0.37f, k_reduced);
+  std::vector<float> v_data =
+      make_rounded(kv_heads * kv_len * kDim, 0.53f, v_reduced);
+
+  std::vector<float> expected_float = reference_gqa_attention(
+      q_data,
+      k_data,
+      v_data,
+      /*batch=*/1,
+      heads,
+      kv_heads,
+      q_len,
+      kv_len,
+      kDim,
+      is_causal);
+  std::vector<CTYPE> expected(expected_float.begin(), expected_float.end());
+
+  exec_aten::Tensor query =
+      tf.make({1, (int)heads, (int)q_len, kDim}, q_reduced);
+  exec_aten::Tensor key =
+      tf.make({1, (int)kv_heads, (int)kv_len, kDim}, k_reduced);
+  exec_aten::Tensor value =
+      tf.make({1, (int)kv_heads, (int)kv_len, kDim}, v_reduced);
+  exec_aten::Tensor out = tf.zeros({1, (int)heads, (int)q_len, kDim});
+  exec_aten::Tensor ret = op_scaled_dot_product_attention(
+      query, key, value, {}, 0.0, is_causal, {}, out);
+  // One rounding of outputs in [-1, 1].
+  const double atol = DTYPE == exec_aten::ScalarType::Half ? 1e-3 : 8e-3;
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      ret, tf.make({1, (int)heads, (int)q_len, kDim}, expected), 0, atol);
+}
+
+} // namespace
+
+// Half and BFloat16 inputs, like a 16-bit KV cache, accumulate in float.
+TEST(OpScaledDotProductAttentionTest, ReducedPrecisionMatchesReference) {
+  ::executorch::extension::threadpool::ThreadPool threadpool(4);
+  ::executorch::extension::threadpool::ThreadPoolGuard guard(&threadpool);
+
+  // Long causal prefill, over several blocks of keys.
+  expect_reduced_matches_reference<exec_aten::ScalarType::Half>(
+      /*heads=*/4, /*kv_heads=*/2, /*q_len=*/1100, /*kv_len=*/1100, true);
+  expect_reduced_matches_reference<exec_aten::ScalarType::BFloat16>(
+      /*heads=*/4, /*kv_heads=*/2, /*q_len=*/1100, /*kv_len=*/1100, true);
+  // A single query token, split across the keys.
+  expect_reduced_matches_reference<exec_aten::ScalarType::Half>(
+      /*heads=*/2, /*kv_heads=*/1, /*q_len=*/1, /*kv_len=*/3000, false);
+  expect_reduced_matches_reference<exec_aten::ScalarType::BFloat16>(
+      /*heads=*/2, /*kv_heads=*/1, /*q_len=*/1, /*kv_len=*/3000, false);
+}
@@ -8,8 +8,12 @@
 
 #include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
 #include <executorch/extension/llm/custom_ops/op_tile_crop.h>
+#include <executorch/extension/parallel/thread_parallel.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace torch {
 namespace executor {
 namespace native {
@@ -41,34 +45,188 @@ void get_tile_crop_out_target_size(
   out_sizes[3] = tile_size;
 }
 
-template <typename CTYPE>
-void tile_crop_impl(const Tensor& in, int64_t tile_size, Tensor& out) {
-  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
-  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+// The minimum number of output elements that each parallel_for chunk
+// produces.
+constexpr int64_t kTileCropGrainSize = 32768;
 
-  const auto channels = in.size(0);
-  const auto height = in.size(1);
-  const auto width = in.size(2);
+void tile_crop_impl(const Tensor& in, int64_t tile_size, Tensor& out) {
+  const char* const in_data = static_cast<const char*>(in.const_data_ptr());
+  char* const out_data = static_cast<char*>(out.mutable_data_ptr());
 
-  const auto HdivS = height / tile_size;
-  const auto WdivS = width / tile_size;
+  const int64_t channels = in.size(0);
+  const int64_t height = in.size(1);
+  const int64_t width = in.size(2);
+  const size_t element_size = in.element_size();
 
-  size_t out_ix = 0;
-  for (size_t bH = 0; bH < HdivS; bH++) {
-    for (size_t bW = 0; bW < WdivS; bW++) {
-      for (size_t c = 0; c < channels; c++) {
-        for (size_t h = 0; h < tile_size; h++) {
-          for (size_t w = 0; w < tile_size; w++) {
-            size_t in_h = bH * tile_size + h;
-            size_t in_w = bW * tile_size + w;
-            size_t in_ix = c * height * width + in_h * width + in_w;
+  const int64_t HdivS = height / tile_size;
+  const int64_t WdivS = width / tile_size;
+  const int64_t num_tiles = HdivS * WdivS;
+  const int64_t tile_numel = channels * tile_size * tile_size;
+  if (num_tiles == 0 || tile_numel == 0) {
+    return;
+  }
 
-            out_data[out_ix++] = in_data[in_ix];
+  // Each row of a tile is a contiguous part of a row of the input.
+  const size_t row_nbytes = tile_size * element_size;
+  const int64_t grain_size =
+      std::max<int64_t>(1, kTileCropGrainSize / tile_numel);
+  executorch::extension::parallel_for(
+      0, num_tiles, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t tile = begin; tile < end; ++tile) {
+          const int64_t bH = tile / WdivS;
+          const int64_t bW = tile % WdivS;
+          char* dst = out_data + tile * tile_numel * element_size;
+          for (int64_t c = 0; c < channels; ++c) {
+            const char* src = in_data +
+                ((c * height + bH * tile_size) * width + bW * tile_size) *
+                    element_size;
+            for (int64_t h = 0; h < tile_size; ++h) {
+              std::memcpy(dst, src, row_nbytes);
+              dst += row_nbytes;
+              src += width * element_size;
+            }
           }
         }
-      }
+      });
+}
+
+bool check_resize_normalize_tile_crop_args(
+    const Tensor& image,
+    const Tensor& target_size,
+    const Tensor& canvas_size,
+    ArrayRef<double> mean,
+    ArrayRef<double> std,
+    int64_t tile_size,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(image, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(image, 3));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(image));
+  ET_LOG_AND_RETURN_IF_FALSE(tile_size > 0);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      target_size.scalar_type() == ScalarType::Long &&
+          target_size.numel() == 2,
+      "target_size must hold the height and width as int64");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      canvas_size.scalar_type() == ScalarType::Long &&
+          canvas_size.numel() == 2,
+      "canvas_size must hold the height and width as int64");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      mean.size() == std.size() &&
+          (mean.empty() || mean.size() == image.size(0)),
+      "mean and std must both be empty or have one value per channel");
+
+  const int64_t* target = target_size.const_data_ptr<int64_t>();
+  const int64_t* canvas = canvas_size.const_data_ptr<int64_t>();
+  for (size_t d = 0; d < 2; ++d) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        target[d] > 0 && target[d] <= canvas[d],
+        "target_size must be positive and fit in canvas_size");
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        canvas[d] % tile_size == 0,
+        "canvas_size must be a multiple of tile_size");
+  }
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      image.size(1) > 0 && image.size(2) > 0, "Cannot resize an empty image");
+  return true;
+}
+
+/**
+ * The input coordinate that output coordinate `dst_index` samples for
+ * bilinear interpolation with align_corners=False, as ATen's
+ * upsample_bilinear2d computes it when given an output size.
+ */
+template <typename CTYPE>
+struct LinearSample {
+  int64_t index0;
+  int64_t index1;
+  CTYPE lambda0;
+  CTYPE lambda1;
+
+  LinearSample(int64_t dst_index, int64_t input_size, CTYPE scale) {
+    CTYPE src_index = scale * (dst_index + static_cast<CTYPE>(0.5)) -
+        static_cast<CTYPE>(0.5);
+    if (src_index < 0) {
+      src_index = 0;
     }
+    index0 = std::min(static_cast<int64_t>(src_index), input_size - 1);
+    index1 = index0 + (index0 < input_size - 1 ? 1 : 0);
+    lambda1 = src_index - index0;
+    lambda0 = static_cast<CTYPE>(1) - lambda1;
   }
+};
+
+template <typename CTYPE>
+void resize_normalize_tile_crop_impl(
+    const Tensor& image,
+    const int64_t* target,
+    const int64_t* canvas,
+    ArrayRef<double> mean,
+    ArrayRef<double> std,
+    int64_t tile_size,
+    Tensor& out) {
+  const CTYPE* const in_data = image.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t channels = image.size(0);
+  const int64_t in_h = image.size(1);
+  const int64_t in_w = image.size(2);
+  const int64_t target_h = target[0];
+  const int64_t target_w = target[1];
+  const int64_t tiles_w = canvas[1] / tile_size;
+  const int64_t num_tiles = (canvas[0] / tile_size) * tiles_w;
+  const int64_t tile_plane = tile_size * tile_size;
+  if (num_tiles == 0 || channels == 0) {
+    return;
+  }
+
+  const CTYPE scale_h = static_cast<CTYPE>(in_h) / target_h;
+  const CTYPE scale_w = static_cast<CTYPE>(in_w) / target_w;
+
+  // Each chunk produces whole channels of tiles: resizes the rows of the
+  // image that the tile covers, pads the part of the tile beyond target_size
+  // with zeros, and normalizes, writing every output element once.
+  const int64_t grain_size =
+      std::max<int64_t>(1, kTileCropGrainSize / tile_plane);
+  executorch::extension::parallel_for(
+      0, num_tiles * channels, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t tile = i / channels;
+          const int64_t c = i % channels;
+          const int64_t y_begin = (tile / tiles_w) * tile_size;
+          const int64_t x_begin = (tile % tiles_w) * tile_size;
+          const CTYPE m = mean.empty() ? 0 : static_cast<CTYPE>(mean[c]);
+          const CTYPE s = std.empty() ? 1 : static_cast<CTYPE>(std[c]);
+          const CTYPE pad_value = (static_cast<CTYPE>(0) - m) / s;
+          // Columns [x_begin, x_end) of the tile are inside the image.
+          const int64_t x_end =
+              std::min(x_begin + tile_size, std::max(target_w, x_begin));
+          const CTYPE* plane = in_data + c * in_h * in_w;
+          CTYPE* dst = out_data + i * tile_plane;
+
+          for (int64_t y = y_begin; y < y_begin + tile_size; ++y) {
+            if (y >= target_h) {
+              std::fill(dst, dst + tile_size, pad_value);
+              dst += tile_size;
+              continue;
+            }
+            const LinearSample<CTYPE> row(y, in_h, scale_h);
+            const CTYPE* row0 = plane + row.index0 * in_w;
+            const CTYPE* row1 = plane + row.index1 * in_w;
+            for (int64_t x = x_begin; x < x_end; ++x) {
+              const LinearSample<CTYPE> col(x, in_w, scale_w);
+              const CTYPE value = row.lambda0 *
+                      (col.lambda0 * row0[col.index0] +
+                       col.lambda1 * row0[col.index1]) +
+                  row.lambda1 *
+                      (col.lambda0 * row1[col.index0] +
+                       col.lambda1 * row1[col.index1]);
+              *dst++ = (value - m) / s;
+            }
+            std::fill(dst, dst + (x_begin + tile_size - x_end), pad_value);
+            dst += x_begin + tile_size - x_end;
+          }
+        }
+      });
 }
 
 } // namespace
@@ -96,10 +254,48 @@ Tensor& tile_crop_out_impl(
       InvalidArgument,
       out);
 
-  constexpr auto name = "tile_crop.out";
+  tile_crop_impl(input, tile_size, out);
+
+  return out;
+}
+
+Tensor& resize_normalize_tile_crop_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& image, // NOLINT
+    const Tensor& target_size, // NOLINT
+    const Tensor& canvas_size, // NOLINT
+    ArrayRef<double> mean,
+    ArrayRef<double> std,
+    const int64_t tile_size, // NOLINT
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_resize_normalize_tile_crop_args(
+          image, target_size, canvas_size, mean, std, tile_size, out),
+      InvalidArgument,
+      out);
+
+  const int64_t* target = target_size.const_data_ptr<int64_t>();
+  const int64_t* canvas = canvas_size.const_data_ptr<int64_t>();
 
-  ET_SWITCH_ALL_TYPES(out.scalar_type(), ctx, name, CTYPE, [&]() {
-    tile_crop_impl<CTYPE>(input, tile_size, out);
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  Tensor::SizesType expected_out_size[4] = {
+      static_cast<Tensor::SizesType>(
+          (canvas[0] / tile_size) * (canvas[1] / tile_size)),
+      static_cast<Tensor::SizesType>(image.size(0)),
+      static_cast<Tensor::SizesType>(tile_size),
+      static_cast<Tensor::SizesType>(tile_size)};
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_out_size, 4}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  constexpr auto name = "resize_normalize_tile_crop.out";
+
+  ET_SWITCH_FLOAT_TYPES(out.scalar_type(), ctx, name, CTYPE, [&]() {
+    resize_normalize_tile_crop_impl<CTYPE>(
+        image, target, canvas, mean, std, tile_size, out);
   });
 
   return out;
@@ -113,3 +309,8 @@ EXECUTORCH_LIBRARY(
     preprocess,
     "tile_crop.out",
     torch::executor::native::tile_crop_out_impl);
+
+EXECUTORCH_LIBRARY(
+    preprocess,
+    "resize_normalize_tile_crop.out",
+    torch::executor::native::resize_normalize_tile_crop_out_impl);
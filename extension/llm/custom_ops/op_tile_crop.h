@@ -21,6 +21,22 @@ Tensor& tile_crop_out_impl(
     const int64_t tile_size,
     Tensor& out);
 
+/**
+ * Resizes `image` [C, H, W] to `target_size` with bilinear interpolation,
+ * pads it with zeros at the bottom and right to `canvas_size`, normalizes it
+ * with `mean` and `std` unless they are empty, and splits it into tiles like
+ * tile_crop, in a single pass over the output.
+ */
+Tensor& resize_normalize_tile_crop_out_impl(
+    KernelRuntimeContext& ctx,
+    const Tensor& image,
+    const Tensor& target_size,
+    const Tensor& canvas_size,
+    ArrayRef<double> mean,
+    ArrayRef<double> std,
+    const int64_t tile_size,
+    Tensor& out);
+
 } // namespace native
 } // namespace executor
 } // namespace torch
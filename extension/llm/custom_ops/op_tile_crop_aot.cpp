@@ -32,6 +32,37 @@ at::Tensor tile_crop_aten(const at::Tensor& input, int64_t tile_size) {
   return output;
 }
 
+Tensor& resize_normalize_tile_crop_out_no_context(
+    const Tensor& image,
+    const Tensor& target_size,
+    const Tensor& canvas_size,
+    ArrayRef<double> mean,
+    ArrayRef<double> std,
+    int64_t tile_size,
+    Tensor& out) {
+  exec_aten::RuntimeContext context{};
+  return resize_normalize_tile_crop_out_impl(
+      context, image, target_size, canvas_size, mean, std, tile_size, out);
+}
+
+at::Tensor resize_normalize_tile_crop_aten(
+    const at::Tensor& image,
+    const at::Tensor& target_size,
+    const at::Tensor& canvas_size,
+    at::ArrayRef<double> mean,
+    at::ArrayRef<double> std,
+    int64_t tile_size) {
+  const int64_t num_tiles = (canvas_size[0].item<int64_t>() / tile_size) *
+      (canvas_size[1].item<int64_t>() / tile_size);
+  auto output = at::empty(
+      {num_tiles, image.size(0), tile_size, tile_size}, image.options());
+
+  WRAP_TO_ATEN(
+      torch::executor::native::resize_normalize_tile_crop_out_no_context, 6)
+  (image, target_size, canvas_size, mean, std, tile_size, output);
+  return output;
+}
+
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -40,6 +71,13 @@ TORCH_LIBRARY(preprocess, m) {
   m.def("tile_crop(Tensor input, int tile_size) -> Tensor");
   m.def(
       "tile_crop.out(Tensor input, int tile_size, *, Tensor(a!) out) -> Tensor(a!)");
+  m.def(
+      "resize_normalize_tile_crop(Tensor image, Tensor target_size, "
+      "Tensor canvas_size, float[] mean, float[] std, int tile_size) -> Tensor");
+  m.def(
+      "resize_normalize_tile_crop.out(Tensor image, Tensor target_size, "
+      "Tensor canvas_size, float[] mean, float[] std, int tile_size, *, "
+      "Tensor(a!) out) -> Tensor(a!)");
 }
 
 TORCH_LIBRARY_IMPL(preprocess, CompositeExplicitAutograd, m) {
@@ -47,4 +85,12 @@ TORCH_LIBRARY_IMPL(preprocess, CompositeExplicitAutograd, m) {
   m.impl(
       "tile_crop.out",
       WRAP_TO_ATEN(torch::executor::native::tile_crop_out_no_context, 2));
+  m.impl(
+      "resize_normalize_tile_crop",
+      torch::executor::native::resize_normalize_tile_crop_aten);
+  m.impl(
+      "resize_normalize_tile_crop.out",
+      WRAP_TO_ATEN(
+          torch::executor::native::resize_normalize_tile_crop_out_no_context,
+          6));
 }
@@ -6,6 +6,7 @@
 
 import logging
 from pathlib import Path
+from typing import List
 
 import torch
 
@@ -36,3 +37,20 @@ def tile_crop(output: torch.Tensor, tile_size: int) -> torch.Tensor:
     s0 = ctx.create_unbacked_symint()
     torch._constrain_as_size(s0, 0, MAX_NUM_TILES)
     return torch.empty([s0, output.size(0), tile_size, tile_size])
+
+
+# Register meta kernel to prevent export tracing into the fused impl.
+@torch.library.register_fake("preprocess::resize_normalize_tile_crop")
+def resize_normalize_tile_crop(
+    image: torch.Tensor,
+    target_size: torch.Tensor,
+    canvas_size: torch.Tensor,
+    mean: List[float],
+    std: List[float],
+    tile_size: int,
+) -> torch.Tensor:
+    # The number of tiles depends on the values of canvas_size; see tile_crop.
+    ctx = torch._custom_ops.get_ctx()
+    s0 = ctx.create_unbacked_symint()
+    torch._constrain_as_size(s0, 0, MAX_NUM_TILES)
+    return torch.empty([s0, image.size(0), tile_size, tile_size])
@@ -105,3 +105,137 @@ TEST_F(OpTileCropOutTest, NegativeTileSizeDies) {
   Tensor out = tf.zeros(/*sizes=*/{9, 2, 4, 4});
   ET_EXPECT_KERNEL_FAILURE(context_, op_tile_crop_out(in, -3, out));
 }
+
+TEST_F(OpTileCropOutTest, MultipleChannels) {
+  TensorFactory<ScalarType::Float> tf;
+  Tensor out = tf.zeros(/*sizes=*/{2, 2, 2, 2});
+
+  // clang-format off
+  op_tile_crop_out(
+      tf.make(
+          {2, 2, 4}, { 0,  1,  2,  3,
+                       4,  5,  6,  7,
+
+                      10, 11, 12, 13,
+                      14, 15, 16, 17}),
+      2,
+      out);
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make(
+          {2, 2, 2, 2}, { 0,  1,  4,  5,
+                         10, 11, 14, 15,
+
+                          2,  3,  6,  7,
+                         12, 13, 16, 17}));
+  // clang-format on
+}
+
+class OpResizeNormalizeTileCropOutTest : public OperatorTest {
+ protected:
+  Tensor& op_resize_normalize_tile_crop_out(
+      const Tensor& image,
+      const Tensor& target_size,
+      const Tensor& canvas_size,
+      exec_aten::ArrayRef<double> mean,
+      exec_aten::ArrayRef<double> std,
+      int64_t tile_size,
+      Tensor& out) {
+    return torch::executor::native::resize_normalize_tile_crop_out_impl(
+        context_, image, target_size, canvas_size, mean, std, tile_size, out);
+  }
+};
+
+TEST_F(OpResizeNormalizeTileCropOutTest, PadAndNormalize) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  Tensor out = tf.zeros(/*sizes=*/{4, 1, 2, 2});
+  const double mean[] = {1.0};
+  const double std[] = {2.0};
+
+  op_resize_normalize_tile_crop_out(
+      tf.make({1, 2, 2}, {1, 2, 3, 4}),
+      tf_long.make({2}, {2, 2}),
+      tf_long.make({2}, {4, 4}),
+      mean,
+      std,
+      2,
+      out);
+
+  // The image fills the first tile; the others are padding, which is
+  // normalized too.
+  // clang-format off
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make(
+          {4, 1, 2, 2}, {   0,  0.5,    1,  1.5,
+                         -0.5, -0.5, -0.5, -0.5,
+                         -0.5, -0.5, -0.5, -0.5,
+                         -0.5, -0.5, -0.5, -0.5}));
+  // clang-format on
+}
+
+TEST_F(OpResizeNormalizeTileCropOutTest, BilinearUpsample) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  Tensor out = tf.zeros(/*sizes=*/{4, 1, 2, 2});
+
+  op_resize_normalize_tile_crop_out(
+      tf.make({1, 2, 2}, {1, 2, 3, 4}),
+      tf_long.make({2}, {4, 4}),
+      tf_long.make({2}, {4, 4}),
+      /*mean=*/{},
+      /*std=*/{},
+      2,
+      out);
+
+  // Matches upsample_bilinear2d with align_corners=False, which resizes the
+  // image to
+  //   1    1.25 1.75 2
+  //   1.5  1.75 2.25 2.5
+  //   2.5  2.75 3.25 3.5
+  //   3    3.25 3.75 4
+  // clang-format off
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make(
+          {4, 1, 2, 2}, {1,    1.25, 1.5,  1.75,
+                         1.75, 2,    2.25, 2.5,
+                         2.5,  2.75, 3,    3.25,
+                         3.25, 3.5,  3.75, 4}));
+  // clang-format on
+}
+
+TEST_F(OpResizeNormalizeTileCropOutTest, TargetLargerThanCanvasDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  Tensor out = tf.zeros(/*sizes=*/{1, 1, 2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_resize_normalize_tile_crop_out(
+          tf.ones({1, 2, 2}),
+          tf_long.make({2}, {4, 2}),
+          tf_long.make({2}, {2, 2}),
+          /*mean=*/{},
+          /*std=*/{},
+          2,
+          out));
+}
+
+TEST_F(OpResizeNormalizeTileCropOutTest, CanvasNotMultipleOfTileSizeDies) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_long;
+  Tensor out = tf.zeros(/*sizes=*/{1, 1, 2, 2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_resize_normalize_tile_crop_out(
+          tf.ones({1, 2, 2}),
+          tf_long.make({2}, {2, 2}),
+          tf_long.make({2}, {3, 2}),
+          /*mean=*/{},
+          /*std=*/{},
+          2,
+          out));
+}
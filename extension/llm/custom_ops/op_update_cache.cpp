@@ -14,6 +14,9 @@
 
 #include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace torch {
 namespace executor {
 
@@ -58,6 +61,127 @@ bool validate_cache_params(
 
   return true;
 }
+
+bool validate_paged_cache_params(
+    const Tensor& value,
+    const Tensor& cache,
+    const Tensor& block_table,
+    int64_t start_pos) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      value.dim() == 4, "value must be a 4D tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      cache.dim() == 4, "paged cache must be a 4D tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.dim() == 2, "block_table must be a 2D tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.scalar_type() == ScalarType::Long,
+      "block_table must be a Long tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      block_table.size(0) == value.size(0),
+      "block_table must have one row per batch entry");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      value.size(2) == cache.size(2) && value.size(3) == cache.size(3),
+      "value and paged cache must have the same number of heads and head dim");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      value.element_size() == cache.element_size(),
+      "value and paged cache must have the same data type size");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      start_pos >= 0 &&
+          start_pos + value.size(1) <= block_table.size(1) * cache.size(1),
+      "start_pos + seq_length must fit in the blocks of block_table. "
+      "start pos: %" PRId64 ", seq_length: %zd, "
+      "blocks per sequence: %zd, block size: %zd",
+      start_pos,
+      value.size(1),
+      block_table.size(1),
+      cache.size(1));
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(cache.dim_order().data(), cache.dim()),
+      "paged cache must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(value.dim_order().data(), value.dim()),
+      "value must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(
+          block_table.dim_order().data(), block_table.dim()),
+      "block_table must be in contiguous dim order");
+
+  // Check every block that is written to before touching the cache.
+  const int64_t num_blocks = cache.size(0);
+  const int64_t block_size = cache.size(1);
+  const int64_t* table_data = block_table.const_data_ptr<int64_t>();
+  for (int64_t b = 0; b < block_table.size(0); ++b) {
+    for (int64_t i = start_pos / block_size;
+         i * block_size < start_pos + value.size(1);
+         ++i) {
+      const int64_t block = table_data[b * block_table.size(1) + i];
+      ET_LOG_MSG_AND_RETURN_IF_FALSE(
+          block >= 0 && block < num_blocks,
+          "block %" PRId64 " is out of range for a pool of %" PRId64 " blocks",
+          block,
+          num_blocks);
+    }
+  }
+
+  return true;
+}
+
+bool validate_ring_cache_params(
+    const Tensor& value,
+    const Tensor& cache,
+    int64_t start_pos,
+    int64_t sink_size) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      value.dim() == 4, "value must be a 4D tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      cache.dim() == 4, "ring cache must be a 4D tensor");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      value.size(0) == cache.size(0) && value.size(2) == cache.size(2) &&
+          value.size(3) == cache.size(3),
+      "value and ring cache must have the same batch size, number of heads "
+      "and head dim");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      value.element_size() == cache.element_size(),
+      "value and ring cache must have the same data type size");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      sink_size >= 0 && sink_size < cache.size(1),
+      "sink_size must leave room for a window in the ring cache. "
+      "sink_size: %" PRId64 ", cache size: %zd",
+      sink_size,
+      cache.size(1));
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      start_pos >= 0 && value.size(1) <= cache.size(1) - sink_size,
+      "seq_length must be at most the window of the ring cache. "
+      "start pos: %" PRId64 ", seq_length: %zd, window size: %" PRId64,
+      start_pos,
+      value.size(1),
+      cache.size(1) - sink_size);
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(cache.dim_order().data(), cache.dim()),
+      "ring cache must be in contiguous dim order");
+
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      is_contiguous_dim_order(value.dim_order().data(), value.dim()),
+      "value must be in contiguous dim order");
+
+  return true;
+}
 } // anonymous namespace
 
 Tensor& update_cache_out(
@@ -127,6 +251,100 @@ Tensor& update_cache_out(
   // Noone uses output. Just a placeholder.
   return output;
 }
+
+Tensor& update_cache_paged_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_paged_cache_params(value, cache, block_table, start_pos),
+      InvalidArgument,
+      output);
+
+  const int64_t batch_size = value.size(0);
+  const int64_t seq_len = value.size(1);
+  const int64_t block_size = cache.size(1);
+  const int64_t max_blocks = block_table.size(1);
+  // Bytes of one token, i.e. all of its heads.
+  const size_t token_bytes =
+      value.size(2) * value.size(3) * value.element_size();
+
+  const uint8_t* value_data =
+      static_cast<const uint8_t*>(value.const_data_ptr());
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+  const int64_t* table_data = block_table.const_data_ptr<int64_t>();
+
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const int64_t* blocks = table_data + b * max_blocks;
+    const uint8_t* src = value_data + b * seq_len * token_bytes;
+    int64_t t = 0;
+    while (t < seq_len) {
+      // Copy the run of tokens that lands in the same block at once.
+      const int64_t pos = start_pos + t;
+      const int64_t block = blocks[pos / block_size];
+      const int64_t offset = pos % block_size;
+      const int64_t run = std::min(seq_len - t, block_size - offset);
+      std::memcpy(
+          cache_data + (block * block_size + offset) * token_bytes,
+          src + t * token_bytes,
+          run * token_bytes);
+      t += run;
+    }
+  }
+
+  // Noone uses output. Just a placeholder.
+  return output;
+}
+
+Tensor& update_cache_ring_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    Tensor& output) {
+  ET_KERNEL_CHECK(
+      ctx,
+      validate_ring_cache_params(value, cache, start_pos, sink_size),
+      InvalidArgument,
+      output);
+
+  const int64_t batch_size = value.size(0);
+  const int64_t seq_len = value.size(1);
+  const int64_t max_seq_len = cache.size(1);
+  const int64_t window_size = max_seq_len - sink_size;
+  // Bytes of one token, i.e. all of its heads.
+  const size_t token_bytes =
+      value.size(2) * value.size(3) * value.element_size();
+
+  const uint8_t* value_data =
+      static_cast<const uint8_t*>(value.const_data_ptr());
+  uint8_t* cache_data = static_cast<uint8_t*>(cache.mutable_data_ptr());
+
+  for (int64_t b = 0; b < batch_size; ++b) {
+    const uint8_t* src = value_data + b * seq_len * token_bytes;
+    uint8_t* dst = cache_data + b * max_seq_len * token_bytes;
+    int64_t t = 0;
+    while (t < seq_len) {
+      // Copy the run of tokens up to the sinks or the end of the ring at
+      // once.
+      const int64_t pos = start_pos + t;
+      const int64_t slot = ring_cache_slot(pos, sink_size, window_size);
+      const int64_t run = std::min(
+          seq_len - t, (pos < sink_size ? sink_size : max_seq_len) - slot);
+      std::memcpy(
+          dst + slot * token_bytes, src + t * token_bytes, run * token_bytes);
+      t += run;
+    }
+  }
+
+  // Noone uses output. Just a placeholder.
+  return output;
+}
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -141,3 +359,19 @@ EXECUTORCH_LIBRARY(
     llama,
     "update_cache.out",
     torch::executor::native::update_cache_out);
+
+// Paged variant of update_cache. The cache is a pool of fixed-size blocks,
+// [num_blocks, block_size, num heads, head dim], and row b of block_table
+// lists the blocks that hold the positions of sequence b in order.
+EXECUTORCH_LIBRARY(
+    llama,
+    "update_cache_paged.out",
+    torch::executor::native::update_cache_paged_out);
+
+// Ring buffer variant of update_cache for sliding window attention with
+// attention sinks, [batch, sink_size + window_size, num heads, head dim].
+// Positions past the cache wrap around into the window.
+EXECUTORCH_LIBRARY(
+    llama,
+    "update_cache_ring.out",
+    torch::executor::native::update_cache_ring_out);
@@ -21,6 +21,51 @@ Tensor& update_cache_out(
     Tensor& cache,
     const int64_t start_pos,
     Tensor& output);
+
+/**
+ * Writes value [batch, seq_len, num heads, head dim] to positions
+ * [start_pos, start_pos + seq_len) of a paged cache. The cache is a pool of
+ * blocks, [num_blocks, block_size, num heads, head dim], and position p of
+ * sequence b lives at offset p % block_size of block
+ * block_table[b][p / block_size].
+ */
+Tensor& update_cache_paged_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    const Tensor& block_table,
+    const int64_t start_pos,
+    Tensor& output);
+
+/**
+ * @return The slot of position pos of a sequence in a ring buffer cache of
+ * sink_size + window_size slots. The first sink_size positions, the
+ * attention sinks, keep their slots for good, and the later ones take turns
+ * in the window_size slots after them.
+ */
+inline int64_t ring_cache_slot(
+    int64_t pos,
+    int64_t sink_size,
+    int64_t window_size) {
+  return pos < sink_size ? pos : sink_size + (pos - sink_size) % window_size;
+}
+
+/**
+ * Writes value [batch, seq_len, num heads, head dim] to positions
+ * [start_pos, start_pos + seq_len) of a ring buffer cache, [batch,
+ * sink_size + window_size, num heads, head dim], at their ring_cache_slot().
+ * Each position past the cache overwrites the one window_size positions
+ * before it, so a sequence can grow indefinitely at a fixed size, keeping
+ * its sinks and its last window_size positions. seq_len must be at most
+ * window_size.
+ */
+Tensor& update_cache_ring_out(
+    RuntimeContext& ctx,
+    const Tensor& value,
+    Tensor& cache,
+    const int64_t start_pos,
+    const int64_t sink_size,
+    Tensor& output);
 } // namespace native
 } // namespace executor
 } // namespace torch
@@ -6,6 +6,7 @@
 
 # pyre-unsafe
 
+from typing import List
 
 import torch
 
@@ -67,3 +68,100 @@ def tile_crop(output: torch.Tensor, tile_size: int) -> torch.Tensor:
     s0 = ctx.create_unbacked_symint()
     torch._constrain_as_size(s0, 0, MAX_NUM_TILES)
     return torch.empty([s0, output.size(0), tile_size, tile_size])
+
+
+# Register and define resize_normalize_tile_crop and out variant: bilinear
+# resize to target_size, zero padding to canvas_size, normalization and
+# tile_crop in one op, so that the runtime makes a single pass over the image.
+preprocess_op_lib.define(
+    "resize_normalize_tile_crop(Tensor image, Tensor target_size, "
+    "Tensor canvas_size, float[] mean, float[] std, int tile_size) -> Tensor"
+)
+
+
+def _resize_normalize(
+    image: torch.Tensor,
+    target_size: torch.Tensor,
+    canvas_size: torch.Tensor,
+    mean: List[float],
+    std: List[float],
+) -> torch.Tensor:
+    target_h, target_w = (int(size) for size in target_size)
+    canvas_h, canvas_w = (int(size) for size in canvas_size)
+    image = torch.nn.functional.interpolate(
+        image.unsqueeze(0),
+        size=(target_h, target_w),
+        mode="bilinear",
+        align_corners=False,
+    ).squeeze(0)
+    image = torch.nn.functional.pad(
+        image, (0, canvas_w - target_w, 0, canvas_h - target_h)
+    )
+    if mean:
+        mean_t = torch.tensor(mean, dtype=image.dtype).view(-1, 1, 1)
+        std_t = torch.tensor(std, dtype=image.dtype).view(-1, 1, 1)
+        image = (image - mean_t) / std_t
+    return image
+
+
+@impl(
+    preprocess_op_lib,
+    "resize_normalize_tile_crop",
+    dispatch_key="CompositeExplicitAutograd",
+)
+def resize_normalize_tile_crop_impl(
+    image: torch.Tensor,
+    target_size: torch.Tensor,
+    canvas_size: torch.Tensor,
+    mean: List[float],
+    std: List[float],
+    tile_size: int,
+) -> torch.Tensor:
+    return tile_crop_impl(
+        _resize_normalize(image, target_size, canvas_size, mean, std), tile_size
+    )
+
+
+preprocess_op_lib.define(
+    "resize_normalize_tile_crop.out(Tensor image, Tensor target_size, "
+    "Tensor canvas_size, float[] mean, float[] std, int tile_size, *, "
+    "Tensor(a!) out) -> Tensor(a!)"
+)
+
+
+@impl(
+    preprocess_op_lib,
+    "resize_normalize_tile_crop.out",
+    dispatch_key="CompositeExplicitAutograd",
+)
+def resize_normalize_tile_crop_out_impl(
+    image: torch.Tensor,
+    target_size: torch.Tensor,
+    canvas_size: torch.Tensor,
+    mean: List[float],
+    std: List[float],
+    tile_size: int,
+    out: torch.Tensor,
+) -> torch.Tensor:
+    tiles = resize_normalize_tile_crop_impl(
+        image, target_size, canvas_size, mean, std, tile_size
+    )
+    out.resize_(tiles.shape).copy_(tiles)
+    return out
+
+
+# Register meta kernel to prevent export tracing into the fused impl.
+@torch.library.register_fake("preprocess::resize_normalize_tile_crop")
+def resize_normalize_tile_crop(
+    image: torch.Tensor,
+    target_size: torch.Tensor,
+    canvas_size: torch.Tensor,
+    mean: List[float],
+    std: List[float],
+    tile_size: int,
+) -> torch.Tensor:
+    # The number of tiles depends on the values of canvas_size; see tile_crop.
+    ctx = torch._custom_ops.get_ctx()
+    s0 = ctx.create_unbacked_symint()
+    torch._constrain_as_size(s0, 0, MAX_NUM_TILES)
+    return torch.empty([s0, image.size(0), tile_size, tile_size])
@@ -13,8 +13,10 @@
 #include <cmath>
 #include <cstdint>
 #include <memory>
+#include <type_traits>
 
 #include <executorch/extension/llm/custom_ops/spinquant/third-party/FFHT/fht.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 
 #include "fast_hadamard_transform_special.h"
 
@@ -102,6 +104,47 @@ void fast_hadamard_transform(T* vec, int log2_vec_size) {
   }
 }
 
+namespace internal {
+
+// Multiplies each of the num_columns columns of vec, an (N, num_columns)
+// row-major matrix, by an N x N Hadamard matrix with mult_strided, one of
+// the generated hadamard_mult_N_strided. For float, whole vectors of
+// adjacent columns go through it at once.
+template <int N, typename T, typename MultStrided>
+void hadamard_mult_columns(T* vec, int num_columns, MultStrided mult_strided) {
+  int ii = 0;
+  if constexpr (std::is_same_v<T, float>) {
+    using Vec = executorch::vec::Vectorized<float>;
+    for (; ii + Vec::size() <= num_columns; ii += Vec::size()) {
+      Vec block[N];
+      for (int jj = 0; jj < N; ++jj) {
+        block[jj] = Vec::loadu(&vec[jj * num_columns + ii]);
+      }
+      mult_strided(block, 1);
+      for (int jj = 0; jj < N; ++jj) {
+        block[jj].store(&vec[jj * num_columns + ii]);
+      }
+    }
+  }
+  for (; ii < num_columns; ++ii) {
+    mult_strided(&vec[ii], num_columns);
+  }
+}
+
+template <int N, typename T, typename MultStrided>
+void fast_hadamard_transform_special_impl(
+    T* vec,
+    int log2_vec_size,
+    MultStrided mult_strided) {
+  const int vec_size = (1 << log2_vec_size);
+  for (int ii = 0; ii < N; ++ii) {
+    fast_hadamard_transform(&vec[ii * vec_size], log2_vec_size);
+  }
+  hadamard_mult_columns<N>(vec, vec_size, mult_strided);
+}
+
+} // namespace internal
+
 // Compute a quantized fast Walsh-Hadamard transform of vec, which
 // must be of length (1 << log2_vec_size) and symmetrically quantized.
 //
@@ -117,23 +160,61 @@ void fast_hadamard_transform_symmetric_quantized_s16(
     int16_t* vec,
     int log2_vec_size);
 
-// Like fast_hadamard_transform, but vec must be of length 28 * (1 <<
-// log2_vec_size) and the transform is computed by interpreting vec as
-// a (28, 1 << log2_vec_size) matrix and performing 28 FHTs, followed
-// by (1 << log2_vec_size) multiplications by a particular Hadamard
-// matrix of size 28x28 (see special_hadamard_code_gen.py for the
-// exact matrix).
+// The sizes with a Hadamard matrix in fast_hadamard_transform_special.h,
+// in the order in which SpinQuant picks them for a row of special_size *
+// a power of two elements.
+constexpr int kHadamardSpecialSizes[] = {28, 40, 20, 12};
+
+// Like fast_hadamard_transform, but vec must be of length special_size *
+// (1 << log2_vec_size), for one of kHadamardSpecialSizes, and the
+// transform is computed by interpreting vec as a (special_size, 1 <<
+// log2_vec_size) matrix and performing special_size FHTs, followed by (1
+// << log2_vec_size) multiplications by a particular Hadamard matrix of
+// size special_size x special_size (see special_hadamard_code_gen.py for
+// the exact matrices).
 template <typename T>
-void fast_hadamard_transform_28N(T* vec, int log2_vec_size) {
-  const int vec_size = (1 << log2_vec_size);
-  for (int ii = 0; ii < 28; ++ii) {
-    fast_hadamard_transform(&vec[ii * vec_size], log2_vec_size);
-  }
-  for (int ii = 0; ii < vec_size; ++ii) {
-    hadamard_mult_28_strided(&vec[ii], vec_size);
+void fast_hadamard_transform_special(
+    T* vec,
+    int special_size,
+    int log2_vec_size) {
+  // The generated kernels are templates, so they are wrapped in generic
+  // lambdas to be instantiated for both T and vectors of T.
+  switch (special_size) {
+    case 12:
+      internal::fast_hadamard_transform_special_impl<12>(
+          vec, log2_vec_size, [](auto* x, int stride) {
+            hadamard_mult_12_strided(x, stride);
+          });
+      break;
+    case 20:
+      internal::fast_hadamard_transform_special_impl<20>(
+          vec, log2_vec_size, [](auto* x, int stride) {
+            hadamard_mult_20_strided(x, stride);
+          });
+      break;
+    case 28:
+      internal::fast_hadamard_transform_special_impl<28>(
+          vec, log2_vec_size, [](auto* x, int stride) {
+            hadamard_mult_28_strided(x, stride);
+          });
+      break;
+    case 40:
+      internal::fast_hadamard_transform_special_impl<40>(
+          vec, log2_vec_size, [](auto* x, int stride) {
+            hadamard_mult_40_strided(x, stride);
+          });
+      break;
+    default:
+      assert(false && "special_size has no Hadamard matrix");
   }
 }
 
+// fast_hadamard_transform_special with special_size 28.
+template <typename T>
+void fast_hadamard_transform_28N(T* vec, int log2_vec_size) {
+  fast_hadamard_transform_special(vec, 28, log2_vec_size);
+}
+
 // We don't need the quantization scale; see the function-level
 // comment on fast_hadamard_transform_symmetric_quantized_s16 for
 // details.
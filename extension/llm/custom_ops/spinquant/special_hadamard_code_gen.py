@@ -234,13 +234,16 @@ def strided_load_code_gen(N):
 def array_code_gen(arr, template):
     N = arr.shape[0]
     assert arr.shape[0] == arr.shape[1]
+    # The strided kernels are also instantiated with SIMD vector types,
+    # which have no unary operators, so their sums start with x[0] or
+    # T(0) - x[0].
+    binary_only = template is STRIDED_CPU_TEMPLATE
     out = []
     for i in range(N):
-        out.append(
-            f"out[{i}] = "
-            + " ".join([f"{'+' if arr[i, j] == 1 else '-'} x[{j}]" for j in range(N)])
-            + ";"
-        )
+        terms = [f"{'+' if arr[i, j] == 1 else '-'} x[{j}]" for j in range(N)]
+        if binary_only:
+            terms[0] = "x[0]" if arr[i, 0] == 1 else "T(0) - x[0]"
+        out.append(f"out[{i}] = " + " ".join(terms) + ";")
     return template.format(
         N=str(N), code="\n    ".join(out), strided_load_code=strided_load_code_gen(N)
     )
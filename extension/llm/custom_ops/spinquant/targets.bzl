@@ -1,4 +1,9 @@
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+load(
+    "@fbsource//xplat/executorch/kernels/optimized:lib_defs.bzl",
+    "get_vec_deps",
+    "get_vec_preprocessor_flags",
+)
 
 def define_common_targets():
     """Defines targets that should be shared between fbcode and xplat.
@@ -15,8 +20,10 @@ def define_common_targets():
         srcs = [
             "fast_hadamard_transform.cpp",
         ],
+        exported_preprocessor_flags = get_vec_preprocessor_flags(),
         exported_deps = [
             "//executorch/extension/llm/custom_ops/spinquant/third-party/FFHT:fht",
-        ],
+            "//executorch/kernels/optimized:libvec",
+        ] + get_vec_deps(),
         visibility = ["@EXECUTORCH_CLIENTS"],
     )
@@ -19,6 +19,7 @@
 #include <executorch/extension/llm/custom_ops/spinquant/test/fast_hadamard_transform_test_impl.h>
 
 using executorch::runtime::testing::fast_hadamard_transform_28N_with_transpose;
+using executorch::runtime::testing::fast_hadamard_transform_special_with_transpose;
 using executorch::runtime::testing::random_floats;
 using executorch::runtime::testing::reference_fht_impl;
 
@@ -57,6 +58,43 @@ TEST(FastHadamardTransform28NTest, Basic) {
   }
 }
 
+TEST(FastHadamardTransformSpecialTest, AllSpecialSizes) {
+  for (const int special_size : executorch::kHadamardSpecialSizes) {
+    // Fewer columns than fill a vector, and several vectors of them.
+    for (const int log2_vec_size : {0, 2, 5}) {
+      std::vector<float> data =
+          random_floats(special_size * (1 << log2_vec_size));
+
+      auto expected = data;
+      fast_hadamard_transform_special_with_transpose(
+          expected.data(), special_size, log2_vec_size);
+
+      auto actual = data;
+      executorch::fast_hadamard_transform_special(
+          actual.data(), special_size, log2_vec_size);
+
+      for (int ii = 0; ii < actual.size(); ++ii) {
+        EXPECT_FLOAT_EQ(actual[ii], expected[ii])
+            << "special_size: " << special_size
+            << ", log2_vec_size: " << log2_vec_size;
+      }
+    }
+  }
+}
+
+TEST(FastHadamardTransformSpecialTest, DoubleMatchesFloat) {
+  // double takes the scalar path for the special Hadamard matrix.
+  std::vector<float> data = random_floats(20 * 64);
+  std::vector<double> data_double(data.begin(), data.end());
+
+  executorch::fast_hadamard_transform_special(data.data(), 20, 6);
+  executorch::fast_hadamard_transform_special(data_double.data(), 20, 6);
+
+  for (int ii = 0; ii < data.size(); ++ii) {
+    EXPECT_NEAR(data[ii], data_double[ii], 1e-4);
+  }
+}
+
 namespace {
 constexpr int32_t qmin = -(1 << 15) + 1;
 constexpr int32_t qmax = -qmin;
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <memory>
 #include <vector>
 
@@ -17,31 +18,56 @@
 namespace executorch::runtime::testing {
 void reference_fht_impl(float* buf, int n);
 
-// Alternate implementation of fast_hadamard_transform_28N to mutation
-// test against. Benchmarking suggests this one is slower, which is
-// why it's in the test.
+// Alternate implementation of fast_hadamard_transform_special to
+// mutation test against. Benchmarking suggests this one is slower, which
+// is why it's in the test.
 template <typename T>
-void fast_hadamard_transform_28N_with_transpose(T* vec, int log2_vec_size) {
+void fast_hadamard_transform_special_with_transpose(
+    T* vec,
+    int special_size,
+    int log2_vec_size) {
   const int vec_size = (1 << log2_vec_size);
-  for (int ii = 0; ii < 28; ++ii) {
+  for (int ii = 0; ii < special_size; ++ii) {
     executorch::fast_hadamard_transform(&vec[ii * vec_size], log2_vec_size);
   }
-  std::unique_ptr<T[]> transposed = std::make_unique<T[]>(28 * vec_size);
-  for (int ii = 0; ii < 28; ++ii) {
+  std::unique_ptr<T[]> transposed =
+      std::make_unique<T[]>(special_size * vec_size);
+  for (int ii = 0; ii < special_size; ++ii) {
     for (int jj = 0; jj < vec_size; ++jj) {
-      transposed[jj * 28 + ii] = vec[ii * vec_size + jj];
+      transposed[jj * special_size + ii] = vec[ii * vec_size + jj];
     }
   }
   for (int ii = 0; ii < vec_size; ++ii) {
-    hadamard_mult_28(&transposed[ii * 28]);
+    T* row = &transposed[ii * special_size];
+    switch (special_size) {
+      case 12:
+        hadamard_mult_12(row);
+        break;
+      case 20:
+        hadamard_mult_20(row);
+        break;
+      case 28:
+        hadamard_mult_28(row);
+        break;
+      case 40:
+        hadamard_mult_40(row);
+        break;
+      default:
+        assert(false);
+    }
   }
   for (int jj = 0; jj < vec_size; ++jj) {
-    for (int ii = 0; ii < 28; ++ii) {
-      vec[ii * vec_size + jj] = transposed[jj * 28 + ii];
+    for (int ii = 0; ii < special_size; ++ii) {
+      vec[ii * vec_size + jj] = transposed[jj * special_size + ii];
     }
   }
 }
 
+template <typename T>
+void fast_hadamard_transform_28N_with_transpose(T* vec, int log2_vec_size) {
+  fast_hadamard_transform_special_with_transpose(vec, 28, log2_vec_size);
+}
+
 std::vector<float> random_floats(int howMany);
 
 } // namespace executorch::runtime::testing
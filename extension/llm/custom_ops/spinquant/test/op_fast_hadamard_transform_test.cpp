@@ -13,11 +13,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 using exec_aten::Tensor;
 
 using executorch::runtime::testing::fast_hadamard_transform_28N_with_transpose;
+using executorch::runtime::testing::fast_hadamard_transform_special_with_transpose;
 using executorch::runtime::testing::random_floats;
 using executorch::runtime::testing::reference_fht_impl;
 
@@ -27,6 +32,17 @@ Tensor& fast_hadamard_transform_nocontext(const Tensor& vec, Tensor& out) {
   return torch::executor::native::fast_hadamard_transform_out(
       context, vec, out);
 }
+
+Tensor& fast_hadamard_transform_quantize_per_token_nocontext(
+    const Tensor& vec,
+    Tensor& scales,
+    Tensor& zero_points,
+    Tensor& out) {
+  exec_aten::RuntimeContext context;
+  return torch::executor::native::
+      fast_hadamard_transform_quantize_per_token_out(
+          context, vec, scales, zero_points, out);
+}
 } // namespace
 
 TEST(OpFastHadamardTransformTest, EmptyInput) {
@@ -116,3 +132,112 @@ TEST(OpFastHadamardTransformTest, InvalidSize) {
   torch::executor::native::fast_hadamard_transform_out(context, mat, out);
   EXPECT_NE(context.failure_state(), executorch::runtime::Error::Ok);
 }
+
+TEST(OpFastHadamardTransformTest, SpecialSizesMultipleRows) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  // Enough rows that they are split across threads.
+  constexpr int kNumRows = 300;
+  // 20 * 2**N for N > 0 is 40 * 2**(N - 1), which takes precedence like
+  // it does in SpinQuant.
+  for (const auto [special_size, log_size] :
+       {std::pair{12, 4}, std::pair{20, 0}, std::pair{40, 4}}) {
+    const int row_length = special_size << log_size;
+    std::vector<float> data = random_floats(kNumRows * row_length);
+    auto mat = tfFloat.make({3, kNumRows / 3, row_length}, data);
+    auto out = tfFloat.zeros({3, kNumRows / 3, row_length});
+
+    auto result = fast_hadamard_transform_nocontext(mat, out);
+
+    std::vector<float> reference_result = data;
+    for (int ii = 0; ii < kNumRows; ++ii) {
+      fast_hadamard_transform_special_with_transpose(
+          &reference_result[ii * row_length], special_size, log_size);
+    }
+
+    const float* const result_data = result.const_data_ptr<float>();
+    for (int ii = 0; ii < data.size(); ++ii) {
+      EXPECT_FLOAT_EQ(result_data[ii], reference_result[ii])
+          << "special_size: " << special_size;
+    }
+  }
+}
+
+TEST(OpFastHadamardTransformTest, HalfInput) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Half> tfHalf;
+  constexpr int kTestLogSize = 3;
+  constexpr int kTestTotalSize = 28 << kTestLogSize;
+  std::vector<float> data = random_floats(2 * kTestTotalSize);
+  std::vector<exec_aten::Half> data_half(data.begin(), data.end());
+  auto mat = tfHalf.make({2, kTestTotalSize}, data_half);
+  auto out = tfHalf.zeros({2, kTestTotalSize});
+
+  auto result = fast_hadamard_transform_nocontext(mat, out);
+
+  std::vector<float> reference_result(data_half.begin(), data_half.end());
+  for (int ii = 0; ii < 2; ++ii) {
+    fast_hadamard_transform_28N_with_transpose(
+        &reference_result[ii * kTestTotalSize], kTestLogSize);
+  }
+
+  const exec_aten::Half* const result_data =
+      result.const_data_ptr<exec_aten::Half>();
+  for (int ii = 0; ii < data.size(); ++ii) {
+    EXPECT_NEAR(
+        static_cast<float>(result_data[ii]),
+        reference_result[ii],
+        1e-3 + 1e-3 * std::abs(reference_result[ii]));
+  }
+}
+
+TEST(OpFastHadamardTransformTest, QuantizePerToken) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Long> tfLong;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Char> tfChar;
+  constexpr int kNumRows = 4;
+  constexpr int kRowLength = 20 * 8;
+  std::vector<float> data = random_floats(kNumRows * kRowLength);
+  auto mat = tfFloat.make({2, 2, kRowLength}, data);
+  auto scales = tfFloat.zeros({2, 2, 1});
+  auto zero_points = tfLong.zeros({2, 2, 1});
+  auto out = tfChar.zeros({2, 2, kRowLength});
+
+  auto result = fast_hadamard_transform_quantize_per_token_nocontext(
+      mat, scales, zero_points, out);
+
+  auto transformed = tfFloat.zeros({2, 2, kRowLength});
+  fast_hadamard_transform_nocontext(mat, transformed);
+  const float* const transformed_data = transformed.const_data_ptr<float>();
+  const int8_t* const result_data = result.const_data_ptr<int8_t>();
+  for (int row = 0; row < kNumRows; ++row) {
+    const float* expected = transformed_data + row * kRowLength;
+    const auto [min_it, max_it] =
+        std::minmax_element(expected, expected + kRowLength);
+    const float scale = scales.const_data_ptr<float>()[row];
+    const int64_t zero_point = zero_points.const_data_ptr<int64_t>()[row];
+    EXPECT_FLOAT_EQ(
+        scale, (std::max(*max_it, 0.f) - std::min(*min_it, 0.f)) / 255);
+    EXPECT_GE(zero_point, -128);
+    EXPECT_LE(zero_point, 127);
+    for (int ii = 0; ii < kRowLength; ++ii) {
+      const float dequantized =
+          (result_data[row * kRowLength + ii] - zero_point) * scale;
+      // Within rounding of the scale, and of the zero point.
+      EXPECT_NEAR(dequantized, expected[ii], scale);
+    }
+  }
+}
+
+TEST(OpFastHadamardTransformTest, QuantizePerTokenInvalidScales) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Long> tfLong;
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Char> tfChar;
+  auto mat = tfFloat.zeros({2, 8});
+  auto scales = tfFloat.zeros({1, 1});
+  auto zero_points = tfLong.zeros({2, 1});
+  auto out = tfChar.zeros({2, 8});
+
+  exec_aten::RuntimeContext context;
+  torch::executor::native::fast_hadamard_transform_quantize_per_token_out(
+      context, mat, scales, zero_points, out);
+  EXPECT_NE(context.failure_state(), executorch::runtime::Error::Ok);
+}
@@ -21,12 +21,20 @@ def define_common_targets():
             srcs = [
                 "op_fallback.cpp",
                 "op_fast_hadamard_transform.cpp",
+                "op_gathered_linear.cpp",
+                "op_lora_linear.cpp",
+                "op_rms_norm.cpp",
+                "op_rope_update_cache.cpp",
                 "op_sdpa.cpp",
                 "op_update_cache.cpp",
             ],
             exported_headers = [
                 "op_fallback.h",
                 "op_fast_hadamard_transform.h",
+                "op_gathered_linear.h",
+                "op_lora_linear.h",
+                "op_rms_norm.h",
+                "op_rope_update_cache.h",
                 "op_sdpa.h",
                 "op_update_cache.h",
             ],
@@ -59,6 +67,10 @@ def define_common_targets():
             name = "custom_ops_aot_lib" + mkl_dep,
             srcs = [
                 "op_fast_hadamard_transform_aten.cpp",
+                "op_gathered_linear_aten.cpp",
+                "op_lora_linear_aten.cpp",
+                "op_rms_norm_aten.cpp",
+                "op_rope_update_cache_aten.cpp",
                 "op_sdpa_aot.cpp",
                 "op_tile_crop.cpp",
                 "op_tile_crop_aot.cpp",
@@ -92,12 +104,82 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "test_util",
+        srcs = [],
+        exported_headers = [
+            "test_util.h",
+        ],
+        visibility = [
+            "//executorch/extension/llm/custom_ops/...",
+        ],
+    )
+
     runtime.cxx_test(
         name = "op_sdpa_test",
         srcs = [
             "op_sdpa_test.cpp",
         ],
         visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_gathered_linear_test",
+        srcs = [
+            "op_gathered_linear_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_lora_linear_test",
+        srcs = [
+            "op_lora_linear_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_rms_norm_test",
+        srcs = [
+            "op_rms_norm_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_rope_update_cache_test",
+        srcs = [
+            "op_rope_update_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
         deps = [
             "//executorch/runtime/core/exec_aten:lib",
             "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
@@ -120,6 +202,66 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "op_paged_kv_cache_test",
+        srcs = [
+            "op_paged_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_ring_kv_cache_test",
+        srcs = [
+            "op_ring_kv_cache_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_cross_attention_sdpa_test",
+        srcs = [
+            "op_cross_attention_sdpa_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "op_quantized_sdpa_test",
+        srcs = [
+            "op_quantized_sdpa_test.cpp",
+        ],
+        visibility = ["//executorch/..."],
+        deps = [
+            "//executorch/runtime/core/exec_aten:lib",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/kernels/test:test_util",
+            ":custom_ops",
+            ":test_util",
+        ],
+    )
+
     ## For preprocess
     runtime.python_library(
         name = "preprocess_custom_ops_py",
@@ -156,6 +298,8 @@ def define_common_targets():
         exported_deps = [
             "//executorch/runtime/kernel:kernel_includes",
             "//executorch/extension/kernel_util:kernel_util",
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/extension/threadpool:threadpool",
         ],
         compiler_flags = ["-Wno-missing-prototypes", "-Wno-global-constructors"],
         visibility = [
@@ -32,3 +32,25 @@ class PreprocessTest(unittest.TestCase):
 
     def test_op_tile_crop_4x2(self):
         self._test_tile_crop(torch.ones(3, 896, 448), (8, 3, 224, 224))
+
+    def test_op_resize_normalize_tile_crop(self):
+        image = torch.rand(3, 300, 500)
+        target_size = torch.tensor([268, 448])
+        canvas_size = torch.tensor([448, 448])
+        mean = [0.5, 0.4, 0.3]
+        std = [0.2, 0.3, 0.4]
+
+        output = torch.ops.preprocess.resize_normalize_tile_crop.default(
+            image, target_size, canvas_size, mean, std, self.tile_size
+        )
+
+        resized = torch.nn.functional.interpolate(
+            image.unsqueeze(0), size=(268, 448), mode="bilinear", align_corners=False
+        ).squeeze(0)
+        padded = torch.nn.functional.pad(resized, (0, 0, 0, 448 - 268))
+        normalized = (padded - torch.tensor(mean).view(-1, 1, 1)) / torch.tensor(
+            std
+        ).view(-1, 1, 1)
+        expected = torch.ops.preprocess.tile_crop.default(normalized, self.tile_size)
+        self.assertEqual(output.shape, (4, 3, 224, 224))
+        torch.testing.assert_close(output, expected)
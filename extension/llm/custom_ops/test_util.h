@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+namespace testing {
+
+/**
+ * Returns `size` samples of a sine wave taken every `step` radians, to fill
+ * test inputs with values that are deterministic but not uniform.
+ */
+inline std::vector<float> make_data(size_t size, float step) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = std::sin(step * i);
+  }
+  return data;
+}
+
+} // namespace testing
+} // namespace llm
+} // namespace extension
+} // namespace executorch
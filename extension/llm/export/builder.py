@@ -82,6 +82,7 @@ class LLMEdgeManager:
         verbose: bool = False,
         metadata: Optional[dict] = None,
         dynamic_shapes: Optional[Any] = None,
+        max_prefill_chunk_size: Optional[int] = None,
     ):
         self.model = model
         # graph module returned from export()
@@ -101,6 +102,7 @@ class LLMEdgeManager:
         self.export_program = None
         self.output_dir = "."
         self.dynamic_shapes = dynamic_shapes
+        self.max_prefill_chunk_size = max_prefill_chunk_size
         self._saved_pte_filename = None
         self.args = args
         self.calibration_tasks = calibration_tasks
@@ -157,7 +159,12 @@ class LLMEdgeManager:
         if self.dynamic_shapes:
             return self.dynamic_shapes
 
-        dim = torch.export.Dim("token_dim", max=self.max_seq_len - 1)
+        max_token_len = self.max_seq_len - 1
+        if self.use_kv_cache and self.max_prefill_chunk_size:
+            # Longer prompts are prefilled in chunks, so memory planning only
+            # needs to cover one chunk.
+            max_token_len = min(max_token_len, self.max_prefill_chunk_size)
+        dim = torch.export.Dim("token_dim", max=max_token_len)
 
         if not self.use_kv_cache:
             # Only one input argument: tokens
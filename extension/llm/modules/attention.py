@@ -5,7 +5,7 @@
 # LICENSE file in the root directory of this source tree.
 
 import logging
-from typing import Optional
+from typing import List, Optional, Tuple
 
 import torch
 import torchtune.modules.attention as TorchTuneAttention
@@ -160,6 +160,10 @@ class MultiHeadAttention(nn.Module):
         # perform normal forward passes
         self.cache_enabled = False
 
+        # Keys and values to attend to instead of projecting them from y, as
+        # set by DecoderWithCrossAttentionKV for the duration of a forward.
+        self.cross_kv: Optional[Tuple[torch.Tensor, torch.Tensor]] = None
+
     def setup_cache(
         self, batch_size: int, dtype: torch.dtype, max_seq_len: int
     ) -> None:
@@ -262,25 +266,16 @@ class MultiHeadAttention(nn.Module):
         if self.q_norm is not None:
             q = self.q_norm(q)
 
+        if self.cross_kv is not None:
+            # The keys and values are already in the cross-attention KV
+            # cache, so attend to them directly. The op also takes the kv
+            # heads as they are instead of expanding them to the query heads.
+            k, v = self.cross_kv
+            output = torch.ops.llama.cross_attention_sdpa(q, k, v, mask)
+            return self.output_proj(output.view(b, s_x, -1))
+
         def calculate_kv(y):
-            # Update k and v shape, positional embeddings, and normalization
-            s_y = y.shape[1]
-            # k has shape [b, s_y, num_kv_heads * head_dim]
-            # v has shape [b, s_y, num_kv_heads * head_dim]
-            k = self.k_proj(y)
-            v = self.v_proj(y)
-
-            # Apply positional embeddings
-            # k: [b, s_y, n_kv, h_d]
-            k = k.view(b, s_y, -1, self.head_dim)
-            v = v.view(b, s_y, -1, self.head_dim)
-            if self.pos_embeddings is not None:
-                k = self.pos_embeddings(k, input_pos=input_pos)
-
-            # Normalize k
-            if self.k_norm is not None:
-                k = self.k_norm(k)
-            return k, v
+            return self.calculate_kv(y, input_pos=input_pos)
 
         def true_fn(y):
             kv_cache = self.kv_cache.clone()
@@ -314,6 +309,33 @@ class MultiHeadAttention(nn.Module):
         return self.output_proj(output)
 
 
+    def calculate_kv(
+        self, y: torch.Tensor, input_pos: Optional[torch.Tensor] = None
+    ) -> Tuple[torch.Tensor, torch.Tensor]:
+        """
+        Projects y to keys and values of shape [b x s_y x n_kv x h_d], with
+        positional embeddings and normalization applied to the keys.
+        """
+        # Update k and v shape, positional embeddings, and normalization
+        b, s_y, _ = y.shape
+        # k has shape [b, s_y, num_kv_heads * head_dim]
+        # v has shape [b, s_y, num_kv_heads * head_dim]
+        k = self.k_proj(y)
+        v = self.v_proj(y)
+
+        # Apply positional embeddings
+        # k: [b, s_y, n_kv, h_d]
+        k = k.view(b, s_y, -1, self.head_dim)
+        v = v.view(b, s_y, -1, self.head_dim)
+        if self.pos_embeddings is not None:
+            k = self.pos_embeddings(k, input_pos=input_pos)
+
+        # Normalize k
+        if self.k_norm is not None:
+            k = self.k_norm(k)
+        return k, v
+
+
 class SDPA(nn.Module):
     """
     TorchTune's SDPA which can be optimized and can be swapped
@@ -411,3 +433,117 @@ def replace_mha_with_inference_mha(module: torch.nn.Module) -> torch.nn.Module:
     """
     _replace_mha_with_inference_mha(module)
     return module
+
+
+def _cross_attention_modules(decoder: nn.Module) -> List[MultiHeadAttention]:
+    """
+    The cross-attention layers of decoder, which are the attention layers
+    that are not causal, in module order.
+    """
+    return [
+        module
+        for module in decoder.modules()
+        if isinstance(module, MultiHeadAttention) and not module.is_causal
+    ]
+
+
+class CrossAttentionKV(nn.Module):
+    """
+    Projects an encoder output to the keys and values of every
+    cross-attention layer of a decoder, as a method that fills the
+    cross-attention KV cache of the runner once per image, see
+    extension/llm/runner/cross_attention_cache.h. Export the decoder with
+    DecoderWithCrossAttentionKV to read the cache.
+
+    Args:
+        decoder (nn.Module): a decoder whose attention layers were replaced
+            with replace_mha_with_inference_mha().
+    """
+
+    def __init__(self, decoder: nn.Module) -> None:
+        super().__init__()
+        self.attns = nn.ModuleList(_cross_attention_modules(decoder))
+
+    def forward(self, encoder_input: torch.Tensor) -> Tuple[torch.Tensor, ...]:
+        """
+        Args:
+            encoder_input (torch.Tensor): the encoder output with shape
+                [b x s_e x d].
+
+        Returns:
+            Tuple[torch.Tensor, ...]: the keys and values of the layers, one
+            after the other, each with shape [b x s_e x n_kv x h_d].
+        """
+        kv = []
+        for attn in self.attns:
+            kv.extend(attn.calculate_kv(encoder_input))
+        return tuple(kv)
+
+
+class DecoderWithCrossAttentionKV(nn.Module):
+    """
+    Runs a decoder with the keys and values of its cross-attention layers
+    taken as inputs, as returned by CrossAttentionKV, instead of projecting
+    them from the encoder output at every step. The cross-attention layers
+    drop their own KV caches, which they no longer read.
+
+    Args:
+        decoder (nn.Module): a decoder whose attention layers were replaced
+            with replace_mha_with_inference_mha().
+    """
+
+    def __init__(self, decoder: nn.Module) -> None:
+        super().__init__()
+        from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+        self.decoder = decoder
+        # A plain list, so that the layers are not registered twice.
+        self._attns = _cross_attention_modules(decoder)
+        for attn in self._attns:
+            attn.kv_cache = None
+            attn._sdpa.kv_cache = None
+
+    def forward(
+        self,
+        tokens: torch.Tensor,
+        *,
+        mask: Optional[_MaskType] = None,
+        encoder_mask: Optional[torch.Tensor] = None,
+        input_pos: Optional[torch.Tensor] = None,
+        cross_kv: Tuple[torch.Tensor, ...] = (),
+    ) -> torch.Tensor:
+        """
+        Args:
+            tokens (torch.Tensor): input tensor with shape [b x s].
+            mask (Optional[_MaskType]): the self-attention mask.
+            encoder_mask (Optional[torch.Tensor]): the boolean
+                cross-attention mask with shape [1 x s x s_e].
+            input_pos (Optional[torch.Tensor]): the position ids of tokens.
+            cross_kv (Tuple[torch.Tensor, ...]): the keys and values of the
+                cross-attention layers, as returned by CrossAttentionKV. They
+                are the last inputs of the exported method.
+
+        Returns:
+            torch.Tensor: the output of the decoder.
+        """
+        assert len(cross_kv) == 2 * len(
+            self._attns
+        ), f"Expected keys and values for {len(self._attns)} cross-attention layers but got {len(cross_kv)} tensors"
+        for i, attn in enumerate(self._attns):
+            attn.cross_kv = (cross_kv[2 * i], cross_kv[2 * i + 1])
+        try:
+            # The cross-attention layers skip attention without an encoder
+            # input, so hand them one that the attention then ignores.
+            encoder_input = cross_kv[0].new_zeros(
+                (tokens.size(0), 1, self._attns[0].embed_dim)
+            )
+            return self.decoder(
+                tokens,
+                mask=mask,
+                encoder_input=encoder_input,
+                encoder_mask=encoder_mask,
+                input_pos=input_pos,
+            )
+        finally:
+            for attn in self._attns:
+                attn.cross_kv = None
@@ -242,3 +242,19 @@ class AttentionTest(unittest.TestCase):
         )  # Self attention with input pos.
 
         assert_close(et_res, tt_res)
+
+    def test_attention_cross_kv_eager(self):
+        from executorch.extension.llm.custom_ops import custom_ops  # noqa
+
+        # Attending to keys and values precomputed from y, as
+        # DecoderWithCrossAttentionKV does, must match projecting y.
+        y = torch.randn(1, 20, self.embed_dim)
+        mask = torch.rand(1, self.x.size(1), y.size(1)) > 0.5
+        mask[..., 0] = True
+        expected = self.et_mha(self.x, y, mask=mask)
+
+        self.et_mha.cross_kv = self.et_mha.calculate_kv(y)
+        et_res = self.et_mha(self.x, None, mask=mask)
+        self.et_mha.cross_kv = None
+
+        assert_close(et_res, expected)
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens for a changing batch of sequences with one decoder.
+
+#include <executorch/extension/llm/runner/batched_text_token_generator.h>
+
+#include <algorithm>
+
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+BatchedTextTokenGenerator::BatchedTextTokenGenerator(
+    Tokenizer* tokenizer,
+    TextDecoderRunner* text_decoder_runner,
+    int32_t max_batch_size,
+    int32_t max_seq_len,
+    std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+    Stats* stats,
+    int32_t prefill_chunk_size)
+    : tokenizer_(tokenizer),
+      streaming_decoder_(tokenizer, max_batch_size),
+      text_decoder_runner_(text_decoder_runner),
+      max_seq_len_(max_seq_len),
+      eos_ids_(std::move(eos_ids)),
+      prefill_chunk_size_(prefill_chunk_size),
+      stats_(stats) {
+  active_.reserve(max_batch_size);
+  // Hand out the lowest slots first.
+  for (int64_t slot = max_batch_size - 1; slot >= 0; --slot) {
+    free_slots_.push_back(slot);
+  }
+}
+
+Result<uint64_t> BatchedTextTokenGenerator::admit(
+    std::vector<uint64_t> prompt_tokens,
+    int32_t seq_len,
+    std::function<void(const std::string&)> token_callback,
+    std::function<void(int64_t)> finished_callback) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !prompt_tokens.empty(), InvalidArgument, "Prompt must not be empty");
+  ET_CHECK_OR_RETURN_ERROR(
+      seq_len <= max_seq_len_ &&
+          prompt_tokens.size() < static_cast<size_t>(seq_len),
+      InvalidArgument,
+      "Sequence length %" PRId32 " must be in (%zu, %" PRId32 "]",
+      seq_len,
+      prompt_tokens.size(),
+      max_seq_len_);
+  ET_CHECK_OR_RETURN_ERROR(
+      !free_slots_.empty(), InvalidState, "All KV cache slots are in use");
+
+  const int64_t slot = free_slots_.back();
+  free_slots_.pop_back();
+  streaming_decoder_.reset(slot);
+
+  Sequence seq;
+  seq.id = next_id_++;
+  seq.slot = slot;
+  seq.cur_token = prompt_tokens[0];
+  seq.prompt_tokens = std::move(prompt_tokens);
+  seq.next_prompt_index = 1;
+  seq.pos = 0;
+  seq.seq_len = seq_len;
+  seq.num_generated = 0;
+  seq.token_callback = std::move(token_callback);
+  seq.finished_callback = std::move(finished_callback);
+  active_.push_back(std::move(seq));
+  return active_.back().id;
+}
+
+Error BatchedTextTokenGenerator::retire(uint64_t id) {
+  for (size_t i = 0; i < active_.size(); ++i) {
+    if (active_[i].id == id) {
+      retire_at(i);
+      return Error::Ok;
+    }
+  }
+  return Error::NotFound;
+}
+
+void BatchedTextTokenGenerator::retire_at(size_t index) {
+  Sequence seq = std::move(active_[index]);
+  // The order of the batch doesn't matter, so fill the hole with the last
+  // sequence.
+  if (index != active_.size() - 1) {
+    active_[index] = std::move(active_.back());
+  }
+  active_.pop_back();
+  free_slots_.push_back(seq.slot);
+  streaming_decoder_.flush(text_, seq.slot);
+  if (!text_.empty()) {
+    seq.token_callback(text_);
+  }
+  if (seq.finished_callback) {
+    seq.finished_callback(seq.num_generated);
+  }
+}
+
+Result<int64_t> BatchedTextTokenGenerator::step() {
+  if (active_.empty()) {
+    return 0;
+  }
+
+  // With chunked prefill, a sequence joins the decoder call at the last token
+  // of its prompt.
+  batch_indices_.clear();
+  for (size_t i = 0; i < active_.size(); ++i) {
+    if (prefill_chunk_size_ <= 0 ||
+        active_[i].next_prompt_index >= active_[i].prompt_tokens.size()) {
+      batch_indices_.push_back(i);
+    }
+  }
+
+  int64_t num_generated = 0;
+  if (!batch_indices_.empty()) {
+    num_generated = ET_UNWRAP(decode());
+  }
+  if (prefill_chunk_size_ > 0) {
+    ET_CHECK_OK_OR_RETURN_ERROR(prefill_chunk());
+  }
+  return num_generated;
+}
+
+Result<int64_t> BatchedTextTokenGenerator::decode() {
+  const size_t batch_size = batch_indices_.size();
+  token_data_.resize(batch_size);
+  pos_data_.resize(batch_size);
+  slot_data_.resize(batch_size);
+  for (size_t b = 0; b < batch_size; ++b) {
+    const Sequence& seq = active_[batch_indices_[b]];
+    token_data_[b] = static_cast<int64_t>(seq.cur_token);
+    pos_data_[b] = seq.pos;
+    slot_data_[b] = seq.slot;
+  }
+
+  const auto batch = static_cast<executorch::aten::SizesType>(batch_size);
+  auto tokens = from_blob(
+      token_data_.data(), {batch, 1}, executorch::aten::ScalarType::Long);
+  auto start_pos =
+      from_blob(pos_data_.data(), {batch}, executorch::aten::ScalarType::Long);
+  auto cache_slots = from_blob(
+      slot_data_.data(), {batch}, executorch::aten::ScalarType::Long);
+
+  auto logits_res =
+      text_decoder_runner_->step_batch(tokens, start_pos, cache_slots);
+  ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
+  executorch::aten::Tensor& logits_tensor = logits_res.get();
+  ET_CHECK_OR_RETURN_ERROR(
+      logits_tensor.dim() >= 2 && logits_tensor.size(0) == batch,
+      InvalidState,
+      "Expected logits with %zu rows",
+      batch_size);
+
+  int64_t num_generated = 0;
+  // Walk the batch backwards, so that retire_at() only moves sequences that
+  // were already handled, or that are not in the batch, into the hole it
+  // leaves.
+  for (size_t b = batch_size; b-- > 0;) {
+    const size_t i = batch_indices_[b];
+    Sequence& seq = active_[i];
+    seq.pos++;
+
+    // The sequence is still in its prompt, so the logits are not needed.
+    if (seq.next_prompt_index < seq.prompt_tokens.size()) {
+      seq.cur_token = seq.prompt_tokens[seq.next_prompt_index++];
+      continue;
+    }
+
+    const uint64_t prev_token = seq.cur_token;
+    stats_->on_sampling_begin();
+    seq.cur_token = text_decoder_runner_->logits_to_token(logits_tensor, b);
+    stats_->on_sampling_end();
+    seq.num_generated++;
+    num_generated++;
+
+    ET_CHECK_OK_OR_RETURN_ERROR(streaming_decoder_.decode(
+        prev_token, seq.cur_token, text_, seq.slot));
+    if (!text_.empty()) {
+      seq.token_callback(text_);
+    }
+
+    if (eos_ids_->find(seq.cur_token) != eos_ids_->end() ||
+        seq.pos >= seq.seq_len - 1) {
+      retire_at(i);
+    }
+  }
+  return num_generated;
+}
+
+Error BatchedTextTokenGenerator::prefill_chunk() {
+  // Finish prompts in the order they were admitted.
+  Sequence* seq = nullptr;
+  for (Sequence& candidate : active_) {
+    if (candidate.next_prompt_index < candidate.prompt_tokens.size() &&
+        (seq == nullptr || candidate.id < seq->id)) {
+      seq = &candidate;
+    }
+  }
+  if (seq == nullptr) {
+    return Error::Ok;
+  }
+
+  // Run from cur_token up to, but not including, the last prompt token.
+  const size_t begin = seq->next_prompt_index - 1;
+  const size_t end = std::min(
+      begin + prefill_chunk_size_, seq->prompt_tokens.size() - 1);
+  const auto num_tokens = static_cast<executorch::aten::SizesType>(end - begin);
+  int64_t pos = seq->pos;
+  int64_t slot = seq->slot;
+  auto tokens = from_blob(
+      seq->prompt_tokens.data() + begin,
+      {1, num_tokens},
+      executorch::aten::ScalarType::Long);
+  auto start_pos = from_blob(&pos, {1}, executorch::aten::ScalarType::Long);
+  auto cache_slots = from_blob(&slot, {1}, executorch::aten::ScalarType::Long);
+
+  // Only the KV cache entries are needed, not the logits.
+  ET_CHECK_OK_OR_RETURN_ERROR(
+      text_decoder_runner_->step_batch(tokens, start_pos, cache_slots)
+          .error());
+  seq->pos += num_tokens;
+  seq->cur_token = seq->prompt_tokens[end];
+  seq->next_prompt_index = end + 1;
+  return Error::Ok;
+}
+
+Result<int64_t> BatchedTextTokenGenerator::generate() {
+  should_stop_ = false;
+  int64_t num_generated = 0;
+  while (!active_.empty() && !should_stop_) {
+    num_generated += ET_UNWRAP(step());
+  }
+  return num_generated;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
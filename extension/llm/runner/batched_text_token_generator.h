@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens for a changing batch of sequences with one decoder.
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/tokenizer/streaming_decoder.h>
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Continuous batching token generator. Every step() runs a single decoder
+ * call over all active sequences. Each sequence is at its own position and
+ * owns one row ("slot") of the KV cache. Sequences can be admitted and
+ * retired between steps, so a finished sequence frees its slot for a waiting
+ * one without draining the batch.
+ *
+ * The Module must be exported with a KV cache of max_batch_size rows and
+ * implement TextDecoderRunner::step_batch(). Prompt tokens go through the
+ * same decoder call, one per step, so admitting a sequence never stalls the
+ * sequences that are already decoding. Positions restart at 0 when a slot is
+ * reused, so stale cache entries past the current position are masked out by
+ * the model.
+ *
+ * Long prompts take one step per token that way. With a positive
+ * prefill_chunk_size, every step instead runs the decode call over the
+ * sequences that finished their prompt, followed by one chunk of up to
+ * prefill_chunk_size prompt tokens of the earliest admitted sequence that is
+ * still in its prompt. The chunk size bounds how much a prompt can delay the
+ * tokens of the other sequences. The last prompt token joins the decode call,
+ * which samples the first generated token. The Module must then also accept
+ * the [1, seq_length] tokens of one sequence in step_batch(), and only has to
+ * plan memory for prefill_chunk_size tokens.
+ *
+ * This class is not thread safe. Callbacks may admit() new sequences, but
+ * must not retire() any.
+ */
+class ET_EXPERIMENTAL BatchedTextTokenGenerator {
+ public:
+  BatchedTextTokenGenerator(
+      Tokenizer* tokenizer,
+      TextDecoderRunner* text_decoder_runner,
+      int32_t max_batch_size,
+      int32_t max_seq_len,
+      std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+      Stats* stats,
+      int32_t prefill_chunk_size = 0);
+
+  /**
+   * Adds a sequence to the batch. It is decoded from the next step() on.
+   * @param prompt_tokens The prompt tokens. Must not be empty.
+   * @param seq_len The total sequence length, including the prompt tokens.
+   * Must not exceed max_seq_len.
+   * @param token_callback What to do with the text of the tokens of this
+   * sequence. It is called after each token that completes a UTF-8
+   * character.
+   * @param finished_callback Optional. Called with the number of generated
+   * tokens when the sequence is retired.
+   * @return The id of the new sequence, or InvalidState if all of the cache
+   * slots are in use.
+   */
+  ::executorch::runtime::Result<uint64_t> admit(
+      std::vector<uint64_t> prompt_tokens,
+      int32_t seq_len,
+      std::function<void(const std::string&)> token_callback,
+      std::function<void(int64_t)> finished_callback = {});
+
+  /**
+   * Removes a sequence from the batch before it finishes, and frees its
+   * cache slot.
+   * @param id The id that admit() returned.
+   * @return NotFound if there is no active sequence with this id.
+   */
+  ::executorch::runtime::Error retire(uint64_t id);
+
+  /**
+   * Runs one decoder call over all active sequences and retires the ones
+   * that reached an EOS token or their sequence length. With chunked
+   * prefill, also runs one prompt chunk.
+   * @return How many tokens were generated.
+   */
+  ::executorch::runtime::Result<int64_t> step();
+
+  /**
+   * Calls step() until all sequences are finished or stop() is called.
+   * @return How many tokens were generated.
+   */
+  ::executorch::runtime::Result<int64_t> generate();
+
+  /**
+   * Stop the generation loop.
+   */
+  inline void stop() {
+    should_stop_ = true;
+  }
+
+  inline size_t num_active() const {
+    return active_.size();
+  }
+
+  inline bool has_free_slot() const {
+    return !free_slots_.empty();
+  }
+
+ private:
+  struct Sequence {
+    uint64_t id;
+    int64_t slot;
+    std::vector<uint64_t> prompt_tokens;
+    // The index of the next prompt token to feed to the decoder.
+    size_t next_prompt_index;
+    // The position of cur_token in the sequence.
+    int64_t pos;
+    int32_t seq_len;
+    // The next input token.
+    uint64_t cur_token;
+    int64_t num_generated;
+    std::function<void(const std::string&)> token_callback;
+    std::function<void(int64_t)> finished_callback;
+  };
+
+  void retire_at(size_t index);
+
+  // Runs the decoder call over the sequences in batch_indices_.
+  ::executorch::runtime::Result<int64_t> decode();
+
+  // Runs the next prompt chunk of the earliest admitted sequence that is
+  // still in its prompt, if any.
+  ::executorch::runtime::Error prefill_chunk();
+
+  Tokenizer* tokenizer_;
+  // Decodes the tokens of each cache slot.
+  StreamingDecoder streaming_decoder_;
+  // The text of the latest token, reused across sequences and steps.
+  std::string text_;
+  TextDecoderRunner* text_decoder_runner_;
+  int32_t max_seq_len_;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+  int32_t prefill_chunk_size_;
+
+  std::vector<Sequence> active_;
+  std::vector<int64_t> free_slots_;
+  uint64_t next_id_ = 0;
+
+  // The input buffers of the decoder, reused across steps.
+  std::vector<int64_t> token_data_;
+  std::vector<int64_t> pos_data_;
+  std::vector<int64_t> slot_data_;
+  // The indices in active_ of the sequences in the decoder call.
+  std::vector<size_t> batch_indices_;
+
+  // state machine
+  bool should_stop_ = false;
+
+  // stats
+  Stats* stats_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
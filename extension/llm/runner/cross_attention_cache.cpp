@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Keep the keys and values that the cross-attention layers of a decoder
+// project from the encoder output.
+
+#include <executorch/extension/llm/runner/cross_attention_cache.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+
+Error CrossAttentionCache::fill(const TensorPtr& encoder_output) {
+  ET_CHECK_OK_OR_RETURN_ERROR(clear());
+  const auto outputs =
+      ET_UNWRAP(module_->execute(fill_method_, encoder_output));
+  const auto method_meta = ET_UNWRAP(module_->method_meta(decoder_method_));
+  ET_CHECK_OR_RETURN_ERROR(
+      first_decoder_input_ + outputs.size() <= method_meta.num_inputs(),
+      InvalidArgument,
+      "%s takes %zu inputs, too few for the %zu outputs of %s from input %zu",
+      decoder_method_.c_str(),
+      method_meta.num_inputs(),
+      outputs.size(),
+      fill_method_.c_str(),
+      first_decoder_input_);
+
+  // The outputs live in the planned memory of fill_method, which its next
+  // execution overwrites, so keep copies that the decoder can read for as
+  // long as it generates.
+  std::vector<TensorPtr> entries;
+  entries.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    ET_CHECK_OR_RETURN_ERROR(
+        output.isTensor(),
+        InvalidState,
+        "Non Tensor Output returned from executing %s",
+        fill_method_.c_str());
+    entries.push_back(clone_tensor_ptr(output.toTensor()));
+  }
+  entries_ = std::move(entries);
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const auto error = module_->set_input(
+        decoder_method_, entries_[i], first_decoder_input_ + i);
+    if (error != Error::Ok) {
+      clear();
+      return error;
+    }
+  }
+  return Error::Ok;
+}
+
+Error CrossAttentionCache::clear() {
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    ET_CHECK_OK_OR_RETURN_ERROR(module_->set_input(
+        decoder_method_,
+        ::executorch::runtime::EValue(),
+        first_decoder_input_ + i));
+  }
+  entries_.clear();
+  return Error::Ok;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
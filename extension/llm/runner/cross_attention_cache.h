@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Keep the keys and values that the cross-attention layers of a decoder
+// project from the encoder output, so that they are computed once per image
+// rather than at every decode step.
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+class ET_EXPERIMENTAL CrossAttentionCache {
+ public:
+  /**
+   * @param module The Module with both methods. Must outlive the cache.
+   * @param fill_method The method that takes the encoder output and returns
+   * the keys and values of every cross-attention layer of the decoder, as
+   * exported from CrossAttentionKV of extension/llm/modules/attention.py.
+   * @param decoder_method The text decoder, which takes the outputs of
+   * fill_method, in the same order, as its last inputs.
+   * @param first_decoder_input The index of the first of these inputs.
+   */
+  CrossAttentionCache(
+      Module* module,
+      std::string fill_method,
+      std::string decoder_method,
+      size_t first_decoder_input)
+      : module_(module),
+        fill_method_(std::move(fill_method)),
+        decoder_method_(std::move(decoder_method)),
+        first_decoder_input_(first_decoder_input) {}
+
+  /**
+   * Runs fill_method on the encoder output, keeps a copy of its outputs,
+   * and sets them as the inputs of decoder_method, where they stay for
+   * every execution until the next fill() or clear(). The decoder reads
+   * them in place if it was exported without memory-planned inputs, and
+   * copies them at every execution otherwise.
+   * @param encoder_output The output of the encoder, e.g. of an image.
+   * @return The error status of running fill_method or setting the inputs.
+   */
+  ::executorch::runtime::Error fill(const TensorPtr& encoder_output);
+
+  /**
+   * Drops the kept keys and values. The decoder fails to execute until the
+   * next fill(), instead of reading freed memory.
+   */
+  ::executorch::runtime::Error clear();
+
+  /**
+   * @return Whether the cache holds the keys and values of an encoder
+   * output.
+   */
+  bool is_filled() const {
+    return !entries_.empty();
+  }
+
+  /**
+   * @return The kept keys and values, in the order of the outputs of
+   * fill_method.
+   */
+  const std::vector<TensorPtr>& entries() const {
+    return entries_;
+  }
+
+ private:
+  Module* module_;
+  std::string fill_method_;
+  std::string decoder_method_;
+  size_t first_decoder_input_;
+  std::vector<TensorPtr> entries_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
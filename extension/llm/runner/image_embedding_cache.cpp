@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Reuse the vision encoder output of an image across generate() calls.
+
+#include <executorch/extension/llm/runner/image_embedding_cache.h>
+
+#include <algorithm>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+namespace {
+
+// FNV-1a over the dimensions and the pixels, so that a lookup only compares
+// the pixels of entries that are likely to match.
+uint64_t hash_image(const Image& image) {
+  uint64_t hash = 14695981039346656037ull;
+  const auto mix = [&hash](uint8_t byte) {
+    hash = (hash ^ byte) * 1099511628211ull;
+  };
+  for (const int32_t dim : {image.width, image.height, image.channels}) {
+    for (size_t i = 0; i < sizeof(dim); ++i) {
+      mix(static_cast<uint8_t>(dim >> (8 * i)));
+    }
+  }
+  for (const uint8_t byte : image.data) {
+    mix(byte);
+  }
+  return hash;
+}
+
+} // namespace
+
+ImageEmbeddingCache::Entry* ImageEmbeddingCache::find(
+    const Image& image,
+    uint64_t hash) {
+  for (auto& entry : entries_) {
+    if (entry.hash == hash && entry.image.width == image.width &&
+        entry.image.height == image.height &&
+        entry.image.channels == image.channels &&
+        entry.image.data == image.data) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+TensorPtr ImageEmbeddingCache::get(const Image& image) {
+  if (entries_.empty()) {
+    return nullptr;
+  }
+  Entry* entry = find(image, hash_image(image));
+  if (entry == nullptr) {
+    return nullptr;
+  }
+  entry->last_used = ++clock_;
+  return entry->embeddings;
+}
+
+void ImageEmbeddingCache::put(const Image& image, TensorPtr embeddings) {
+  if (max_entries_ == 0 || !embeddings) {
+    return;
+  }
+  const uint64_t hash = hash_image(image);
+  if (Entry* entry = find(image, hash)) {
+    entry->embeddings = std::move(embeddings);
+    entry->last_used = ++clock_;
+    return;
+  }
+  if (entries_.size() >= max_entries_) {
+    entries_.erase(std::min_element(
+        entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+          return a.last_used < b.last_used;
+        }));
+  }
+  entries_.push_back({hash, image, std::move(embeddings), ++clock_});
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Reuse the vision encoder output of an image across generate() calls.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <executorch/extension/llm/runner/image.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+class ET_EXPERIMENTAL ImageEmbeddingCache {
+ public:
+  /**
+   * @param max_entries How many images to keep the embeddings of at most.
+   */
+  explicit ImageEmbeddingCache(size_t max_entries = 4)
+      : max_entries_(max_entries) {}
+
+  /**
+   * @param image The image to look up, compared by its pixels and dimensions.
+   * @return The embeddings stored for the image, or nullptr if there are
+   * none.
+   */
+  TensorPtr get(const Image& image);
+
+  /**
+   * Stores the embeddings of image, evicting the least recently used entry
+   * if the cache is full.
+   * @param image The encoded image.
+   * @param embeddings The output of the vision encoder for image. Must not
+   * alias memory that the encoder reuses, e.g. its planned output buffer.
+   */
+  void put(const Image& image, TensorPtr embeddings);
+
+  void clear() {
+    entries_.clear();
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    uint64_t hash;
+    Image image;
+    TensorPtr embeddings;
+    uint64_t last_used;
+  };
+
+  Entry* find(const Image& image, uint64_t hash);
+
+  size_t max_entries_;
+  std::vector<Entry> entries_;
+  uint64_t clock_ = 0;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -12,6 +12,7 @@
 
 #include <executorch/extension/llm/runner/image.h>
 #include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor.h>
 #include <executorch/runtime/platform/compiler.h>
 
 namespace executorch {
@@ -35,6 +36,32 @@ class ET_EXPERIMENTAL ImagePrefiller {
       Image& image,
       int64_t& start_pos) = 0;
 
+  /**
+   * Runs only the vision encoder on the given image, so that the caller can
+   * overlap it with other work or reuse its output. Unlike prefill(), this
+   * does not touch the KV cache.
+   * @param image The image input to the multimodal LLM.
+   * @return The image embeddings, in memory owned by the returned tensor.
+   */
+  virtual ::executorch::runtime::Result<TensorPtr> encode(Image& image) {
+    (void)image;
+    return ::executorch::runtime::Error::NotSupported;
+  }
+
+  /**
+   * Prefill an LLM Module with the image embeddings returned by encode().
+   * @param embeddings The image embeddings.
+   * @param start_pos The starting position in KV cache of the input in the LLM.
+   * It's passed as reference and will be updated inside this function.
+   * @return The logits of the LLM Module after prefill.
+   */
+  virtual ::executorch::runtime::Result<executorch::aten::Tensor>
+  prefill_embeddings(const TensorPtr& embeddings, int64_t& start_pos) {
+    (void)embeddings;
+    (void)start_pos;
+    return ::executorch::runtime::Error::NotSupported;
+  }
+
   virtual ::executorch::runtime::Error load() = 0;
   virtual bool is_method_loaded() = 0;
 
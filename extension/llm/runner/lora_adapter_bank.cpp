@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Attach LoRA adapters to a decoder at runtime.
+
+#include <executorch/extension/llm/runner/lora_adapter_bank.h>
+
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::aten::ScalarType;
+using ::executorch::aten::SizesType;
+using ::executorch::runtime::Error;
+
+namespace {
+
+std::vector<SizesType> to_sizes(
+    ::executorch::runtime::Span<const int32_t> sizes) {
+  return std::vector<SizesType>(sizes.begin(), sizes.end());
+}
+
+} // namespace
+
+LoRAAdapterBank::LoRAAdapterBank(
+    Module* module,
+    size_t first_input,
+    std::string method_name)
+    : module_(module),
+      first_input_(first_input),
+      method_name_(std::move(method_name)) {}
+
+Error LoRAAdapterBank::load() {
+  if (is_loaded()) {
+    return Error::Ok;
+  }
+  const auto method_meta = ET_UNWRAP(module_->method_meta(method_name_));
+  const size_t num_inputs = method_meta.num_inputs();
+  ET_CHECK_OR_RETURN_ERROR(
+      first_input_ < num_inputs,
+      InvalidArgument,
+      "Method %s has no input %zu",
+      method_name_.c_str(),
+      first_input_);
+
+  size_t index = first_input_;
+  const auto first_meta = ET_UNWRAP(method_meta.input_tensor_meta(index));
+  TensorPtr adapter_ids;
+  if (first_meta.scalar_type() == ScalarType::Long) {
+    ET_CHECK_OR_RETURN_ERROR(
+        first_meta.sizes().size() == 1,
+        InvalidProgram,
+        "Expected adapter_ids of [batch]");
+    adapter_ids = full(to_sizes(first_meta.sizes()), -1, ScalarType::Long);
+    ++index;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      index < num_inputs && (num_inputs - index) % 2 == 0,
+      InvalidProgram,
+      "Expected pairs of lora_a and lora_b after input %zu",
+      index);
+
+  std::vector<TensorPtr> weights;
+  size_t num_slots = 0;
+  for (; index < num_inputs; ++index) {
+    const auto meta = ET_UNWRAP(method_meta.input_tensor_meta(index));
+    ET_CHECK_OR_RETURN_ERROR(
+        !meta.sizes().empty() && meta.sizes()[0] > 0,
+        InvalidProgram,
+        "Expected input %zu to stack its adapter slots",
+        index);
+    const size_t slots = meta.sizes()[0];
+    ET_CHECK_OR_RETURN_ERROR(
+        weights.empty() || slots == num_slots,
+        InvalidProgram,
+        "Input %zu has %zu adapter slots, expected %zu",
+        index,
+        slots,
+        num_slots);
+    num_slots = slots;
+    weights.push_back(zeros(to_sizes(meta.sizes()), meta.scalar_type()));
+  }
+
+  if (adapter_ids) {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        module_->set_input(method_name_, adapter_ids, first_input_));
+  }
+  const size_t first_weight = first_input_ + (adapter_ids ? 1 : 0);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        module_->set_input(method_name_, weights[i], first_weight + i));
+  }
+  adapter_ids_ = std::move(adapter_ids);
+  weights_ = std::move(weights);
+  num_slots_ = num_slots;
+  return Error::Ok;
+}
+
+size_t LoRAAdapterBank::adapter_size() const {
+  size_t size = 0;
+  for (const auto& weight : weights_) {
+    size += weight->nbytes() / num_slots_;
+  }
+  return size;
+}
+
+Error LoRAAdapterBank::load_adapter(
+    size_t slot,
+    const void* data,
+    size_t size) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_loaded(), InvalidState, "The bank is not loaded");
+  ET_CHECK_OR_RETURN_ERROR(
+      slot < num_slots_,
+      InvalidArgument,
+      "Slot %zu out of range for %zu slots",
+      slot,
+      num_slots_);
+  ET_CHECK_OR_RETURN_ERROR(
+      size == adapter_size(),
+      InvalidArgument,
+      "Expected an adapter of %zu bytes, got %zu",
+      adapter_size(),
+      size);
+  const auto* src = static_cast<const uint8_t*>(data);
+  for (auto& weight : weights_) {
+    const size_t slot_size = weight->nbytes() / num_slots_;
+    std::memcpy(
+        weight->mutable_data_ptr<uint8_t>() + slot * slot_size,
+        src,
+        slot_size);
+    src += slot_size;
+  }
+  return Error::Ok;
+}
+
+Error LoRAAdapterBank::load_adapter(size_t slot, const std::string& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  ET_CHECK_OR_RETURN_ERROR(
+      file.is_open(), AccessFailed, "Could not open %s", path.c_str());
+  const auto size = static_cast<size_t>(file.tellg());
+  std::vector<uint8_t> data(size);
+  file.seekg(0);
+  ET_CHECK_OR_RETURN_ERROR(
+      file.read(reinterpret_cast<char*>(data.data()), size),
+      AccessFailed,
+      "Could not read %s",
+      path.c_str());
+  return load_adapter(slot, data.data(), data.size());
+}
+
+Error LoRAAdapterBank::unload_adapter(size_t slot) {
+  ET_CHECK_OR_RETURN_ERROR(
+      is_loaded(), InvalidState, "The bank is not loaded");
+  ET_CHECK_OR_RETURN_ERROR(
+      slot < num_slots_,
+      InvalidArgument,
+      "Slot %zu out of range for %zu slots",
+      slot,
+      num_slots_);
+  for (auto& weight : weights_) {
+    const size_t slot_size = weight->nbytes() / num_slots_;
+    std::memset(
+        weight->mutable_data_ptr<uint8_t>() + slot * slot_size, 0, slot_size);
+  }
+  return Error::Ok;
+}
+
+Error LoRAAdapterBank::select(const std::vector<int64_t>& slots) {
+  ET_CHECK_OR_RETURN_ERROR(
+      adapter_ids_, InvalidState, "The method takes no adapter_ids");
+  ET_CHECK_OR_RETURN_ERROR(
+      slots.size() == static_cast<size_t>(adapter_ids_->numel()),
+      InvalidArgument,
+      "Expected %zd slots, one per sequence, got %zu",
+      static_cast<ssize_t>(adapter_ids_->numel()),
+      slots.size());
+  for (const int64_t slot : slots) {
+    ET_CHECK_OR_RETURN_ERROR(
+        slot >= -1 && slot < static_cast<int64_t>(num_slots_),
+        InvalidArgument,
+        "Slot %" PRId64 " out of range for %zu slots",
+        slot,
+        num_slots_);
+  }
+  std::memcpy(
+      adapter_ids_->mutable_data_ptr<int64_t>(),
+      slots.data(),
+      slots.size() * sizeof(int64_t));
+  return Error::Ok;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Attach LoRA adapters to a decoder at runtime.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Holds the low-rank adapters of a decoder that was exported with
+ * examples/models/llama/source_transformation/lora.py's
+ * replace_linear_with_runtime_lora. Such a program keeps the base weights
+ * as constants and takes the LoRA weights as trailing inputs of the method,
+ * starting at first_input:
+ * - Optionally adapter_ids, a Long tensor [batch] that picks the adapter
+ *   slot of every sequence, -1 for none.
+ * - Then lora_a and lora_b of every adapted linear, [num_slots, rank, in
+ *   features] and [num_slots, out features, rank].
+ *
+ * The bank allocates these inputs once and binds them to the method, so an
+ * adapter is a copy into a slot rather than a new program. Several Modules
+ * created from one shared Program, each with its own bank, serve different
+ * adapters from one resident copy of the base weights, and a bank with
+ * several slots serves a batch that mixes adapters.
+ *
+ * The method's inputs should not be memory planned (alloc_graph_input=False
+ * on export), or the weights are copied into the planned inputs on every
+ * execution.
+ */
+class ET_EXPERIMENTAL LoRAAdapterBank {
+ public:
+  /**
+   * @param module The Module that runs the decoder. Must outlive the bank.
+   * @param first_input The index of the first adapter input of the method.
+   * @param method_name The decoder method.
+   */
+  explicit LoRAAdapterBank(
+      Module* module,
+      size_t first_input,
+      std::string method_name = "forward");
+
+  /**
+   * Allocates the adapter inputs from the method's metadata and binds them
+   * to the method. Every slot starts out as a zero adapter, and every
+   * sequence uses no adapter.
+   */
+  ::executorch::runtime::Error load();
+
+  bool is_loaded() const {
+    return !weights_.empty();
+  }
+
+  size_t num_slots() const {
+    return num_slots_;
+  }
+
+  /**
+   * @return The size in bytes of one adapter: the slot of every weight
+   * input, in order, as save_runtime_lora_adapter writes them.
+   */
+  size_t adapter_size() const;
+
+  /**
+   * Copies an adapter into slot.
+   * @param data adapter_size() bytes, the slot of every weight input in
+   * order.
+   */
+  ::executorch::runtime::Error
+  load_adapter(size_t slot, const void* data, size_t size);
+
+  /**
+   * Reads an adapter from a file written by save_runtime_lora_adapter into
+   * slot.
+   */
+  ::executorch::runtime::Error load_adapter(
+      size_t slot,
+      const std::string& path);
+
+  /**
+   * Zeroes slot, which then adds nothing to the base model.
+   */
+  ::executorch::runtime::Error unload_adapter(size_t slot);
+
+  /**
+   * Picks the adapter of every sequence of the batch.
+   * @param slots One slot per sequence, or -1 for the base model alone.
+   */
+  ::executorch::runtime::Error select(const std::vector<int64_t>& slots);
+
+ private:
+  Module* module_;
+  size_t first_input_;
+  std::string method_name_;
+  TensorPtr adapter_ids_;
+  std::vector<TensorPtr> weights_;
+  size_t num_slots_ = 0;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
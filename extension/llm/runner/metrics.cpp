@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Per-token latency histograms and phase breakdown for LLM runners.
+
+#include <executorch/extension/llm/runner/metrics.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <utility>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+namespace {
+
+constexpr double kQuantiles[] = {0.5, 0.9, 0.99};
+
+size_t highest_bit(uint64_t value) {
+  size_t bit = 0;
+  while (value >>= 1) {
+    ++bit;
+  }
+  return bit;
+}
+
+} // namespace
+
+size_t LatencyHistogram::bucket_index(uint64_t latency_us) {
+  if (latency_us < kSubBuckets) {
+    return latency_us;
+  }
+  // kSubBuckets is 2^2, so the two bits below the highest one pick the
+  // sub-bucket.
+  const size_t bit = highest_bit(latency_us);
+  const size_t sub = (latency_us >> (bit - 2)) & (kSubBuckets - 1);
+  return std::min((bit - 1) * kSubBuckets + sub, kNumBuckets - 1);
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+  if (index < kSubBuckets) {
+    return index + 1;
+  }
+  const size_t bit = index / kSubBuckets + 1;
+  const uint64_t sub = index % kSubBuckets;
+  return (kSubBuckets + sub + 1) << (bit - 2);
+}
+
+void LatencyHistogram::record(uint64_t latency_us) {
+  buckets_[bucket_index(latency_us)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(latency_us, std::memory_order_relaxed);
+  uint64_t max = max_.load(std::memory_order_relaxed);
+  while (latency_us > max &&
+         !max_.compare_exchange_weak(
+             max, latency_us, std::memory_order_relaxed)) {
+  }
+}
+
+uint64_t LatencyHistogram::percentile(double quantile) const {
+  const uint64_t total = count();
+  if (total == 0) {
+    return 0;
+  }
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(quantile * total)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(bucket_upper_bound(i) - 1, max());
+    }
+  }
+  return max();
+}
+
+void LatencyHistogram::reset() {
+  for (auto& bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  sum_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+}
+
+namespace {
+
+// The histograms of metrics with their names, for RunnerMetrics and const
+// RunnerMetrics alike.
+template <typename Metrics>
+auto histograms(Metrics& metrics) {
+  using Histogram = decltype(&metrics.prefill_us);
+  return std::array<std::pair<const char*, Histogram>, 7>{{
+      {"prefill_us", &metrics.prefill_us},
+      {"prefill_execute_us", &metrics.prefill_execute_us},
+      {"token_latency_us", &metrics.token_latency_us},
+      {"model_execute_us", &metrics.model_execute_us},
+      {"sampling_us", &metrics.sampling_us},
+      {"detokenize_us", &metrics.detokenize_us},
+      {"callback_us", &metrics.callback_us},
+  }};
+}
+
+} // namespace
+
+void RunnerMetrics::reset() {
+  for (auto& histogram : histograms(*this)) {
+    histogram.second->reset();
+  }
+  prompt_tokens.store(0, std::memory_order_relaxed);
+  generated_tokens.store(0, std::memory_order_relaxed);
+  kv_cache_positions.store(0, std::memory_order_relaxed);
+}
+
+std::string RunnerMetrics::to_json() const {
+  std::stringstream ss;
+  ss << "{";
+  for (const auto& histogram : histograms(*this)) {
+    const LatencyHistogram& h = *histogram.second;
+    ss << "\"" << histogram.first << "\":{\"count\":" << h.count()
+       << ",\"sum\":" << h.sum() << ",\"max\":" << h.max()
+       << ",\"p50\":" << h.percentile(0.5)
+       << ",\"p90\":" << h.percentile(0.9)
+       << ",\"p99\":" << h.percentile(0.99) << "},";
+  }
+  ss << "\"prompt_tokens\":" << prompt_tokens.load(std::memory_order_relaxed)
+     << ",\"generated_tokens\":"
+     << generated_tokens.load(std::memory_order_relaxed)
+     << ",\"kv_cache_positions\":"
+     << kv_cache_positions.load(std::memory_order_relaxed)
+     << ",\"kv_cache_capacity\":"
+     << kv_cache_capacity.load(std::memory_order_relaxed) << "}";
+  return ss.str();
+}
+
+std::string RunnerMetrics::to_prometheus(const std::string& prefix) const {
+  std::stringstream ss;
+  for (const auto& histogram : histograms(*this)) {
+    const LatencyHistogram& h = *histogram.second;
+    const std::string name = prefix + "_" + histogram.first;
+    ss << "# TYPE " << name << " summary\n";
+    for (const double quantile : kQuantiles) {
+      ss << name << "{quantile=\"" << quantile << "\"} "
+         << h.percentile(quantile) << "\n";
+    }
+    ss << name << "_sum " << h.sum() << "\n";
+    ss << name << "_count " << h.count() << "\n";
+  }
+  const auto counter = [&](const char* name, uint64_t value) {
+    ss << "# TYPE " << prefix << "_" << name << " counter\n"
+       << prefix << "_" << name << " " << value << "\n";
+  };
+  const auto gauge = [&](const char* name, int64_t value) {
+    ss << "# TYPE " << prefix << "_" << name << " gauge\n"
+       << prefix << "_" << name << " " << value << "\n";
+  };
+  counter("prompt_tokens_total", prompt_tokens.load(std::memory_order_relaxed));
+  counter(
+      "generated_tokens_total",
+      generated_tokens.load(std::memory_order_relaxed));
+  gauge(
+      "kv_cache_positions", kv_cache_positions.load(std::memory_order_relaxed));
+  gauge("kv_cache_capacity", kv_cache_capacity.load(std::memory_order_relaxed));
+  return ss.str();
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
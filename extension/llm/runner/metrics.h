@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Per-token latency histograms and phase breakdown for LLM runners.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * A histogram of latencies in microseconds that can be recorded into from
+ * any thread without locks. Buckets are log-linear: every power of two is
+ * split into four, so a percentile is within 25% of the recorded value.
+ */
+class ET_EXPERIMENTAL LatencyHistogram {
+ public:
+  static constexpr size_t kSubBuckets = 4;
+  // Covers latencies up to 2^40 microseconds, about 12 days.
+  static constexpr size_t kNumBuckets = 40 * kSubBuckets;
+
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  void record(uint64_t latency_us);
+
+  uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t sum() const {
+    return sum_.load(std::memory_order_relaxed);
+  }
+
+  uint64_t max() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @param quantile In [0, 1], e.g. 0.99 for p99.
+   * @return The upper bound of the bucket that holds the quantile, clamped to
+   * the largest recorded latency, or 0 if nothing was recorded.
+   */
+  uint64_t percentile(double quantile) const;
+
+  void reset();
+
+  static size_t bucket_index(uint64_t latency_us);
+  // The exclusive upper bound of the latencies in bucket index.
+  static uint64_t bucket_upper_bound(size_t index);
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * Telemetry of a runner, filled in by the TextPrefiller and
+ * TextTokenGenerator it is set on. Generating a token is split into running
+ * the model, sampling, detokenizing and the token callback, and
+ * token_latency_us covers all of them. Readers may export while a runner
+ * records, in which case the values are not a consistent snapshot, but each
+ * one is valid.
+ */
+struct ET_EXPERIMENTAL RunnerMetrics {
+  // Whole prefill() calls, and every forward that they run.
+  LatencyHistogram prefill_us;
+  LatencyHistogram prefill_execute_us;
+  // One per generated token.
+  LatencyHistogram token_latency_us;
+  LatencyHistogram model_execute_us;
+  LatencyHistogram sampling_us;
+  LatencyHistogram detokenize_us;
+  LatencyHistogram callback_us;
+
+  std::atomic<uint64_t> prompt_tokens{0};
+  std::atomic<uint64_t> generated_tokens{0};
+  // How many positions of the KV cache are filled, out of its capacity.
+  std::atomic<int64_t> kv_cache_positions{0};
+  std::atomic<int64_t> kv_cache_capacity{0};
+
+  void reset();
+
+  std::string to_json() const;
+
+  /**
+   * @param prefix The prefix of the metric names.
+   * @return The metrics in the Prometheus text exposition format, the
+   * histograms as summaries with their p50, p90 and p99.
+   */
+  std::string to_prometheus(
+      const std::string& prefix = "executorch_llm") const;
+};
+
+/**
+ * Records the time from its construction to its destruction into a
+ * histogram. Does not read the clock if the histogram is null, so that
+ * disabled metrics cost a branch.
+ */
+class ET_EXPERIMENTAL ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram* histogram)
+      : histogram_(histogram),
+        start_(
+            histogram != nullptr ? std::chrono::steady_clock::now()
+                                 : std::chrono::steady_clock::time_point()) {}
+
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+  ~ScopedLatency() {
+    if (histogram_ != nullptr) {
+      histogram_->record(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              std::chrono::steady_clock::now() - start_)
+              .count());
+    }
+  }
+
+ private:
+  LatencyHistogram* histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
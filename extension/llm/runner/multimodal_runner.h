@@ -19,7 +19,9 @@
 #include <type_traits>
 #include <unordered_map>
 
+#include <executorch/extension/llm/runner/cross_attention_cache.h>
 #include <executorch/extension/llm/runner/image.h>
+#include <executorch/extension/llm/runner/image_embedding_cache.h>
 #include <executorch/extension/llm/runner/image_prefiller.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
@@ -109,6 +111,56 @@ class ET_EXPERIMENTAL MultimodalRunner {
     text_token_generator_->stop();
   }
 
+  /**
+   * Sets how many images to keep the embeddings of across generate() calls,
+   * so that an image that is sent again in a later turn is not encoded
+   * again. 0 disables the cache.
+   * @param max_entries The number of images to cache at most.
+   */
+  inline void set_image_embedding_cache_size(size_t max_entries) {
+    image_embedding_cache_ = ImageEmbeddingCache(max_entries);
+  }
+
+  /**
+   * Sets the scope that the thread encoding images enters while the text
+   * prompt is prefilled, e.g. a ThreadPoolGuard from
+   * `threadpool::make_threadpool_scope()` to run the vision encoder on other
+   * cores than the text decoder.
+   * @param scope The scope to enter, or nullptr for none.
+   */
+  inline void set_image_encoder_scope(Module::ExecutionScope scope) {
+    image_encoder_scope_ = std::move(scope);
+  }
+
+  /**
+   * Sets whether generate() encodes the images on another thread while it
+   * prefills the text before them. Must be disabled if the image encoder
+   * shares its planned memory with the text decoder, see
+   * `Module::share_planned_memory()`.
+   * @param enabled Whether to overlap image encoding and text prefill.
+   */
+  inline void set_pipeline_image_encoding(bool enabled) {
+    pipeline_image_encoding_ = enabled;
+  }
+
+  /**
+   * Sets up a cross-attention KV cache, for models whose text decoder
+   * attends to the image embeddings in cross-attention layers instead of
+   * taking them as tokens, like Llama 3.2 Vision. The runner fills it once
+   * after encoding the images, and every decode step then reads the keys and
+   * values from it instead of projecting the image embeddings again.
+   * @param fill_method The method that returns the keys and values of every
+   * cross-attention layer for the image embeddings.
+   * @param first_decoder_input The index of the first input of the text
+   * decoder that takes them.
+   */
+  inline void set_cross_attention_cache(
+      const std::string& fill_method,
+      size_t first_decoder_input) {
+    cross_attention_cache_ = std::make_unique<CrossAttentionCache>(
+        module_.get(), fill_method, "forward", first_decoder_input);
+  }
+
   virtual ~MultimodalRunner() = default;
 
  protected:
@@ -127,6 +179,10 @@ class ET_EXPERIMENTAL MultimodalRunner {
   std::unique_ptr<TextDecoderRunner> text_decoder_runner_;
   std::unique_ptr<TextPrefiller> text_prefiller_;
   std::unique_ptr<ImagePrefiller> image_prefiller_;
+  ImageEmbeddingCache image_embedding_cache_;
+  std::unique_ptr<CrossAttentionCache> cross_attention_cache_;
+  Module::ExecutionScope image_encoder_scope_;
+  bool pipeline_image_encoding_ = true;
   std::unique_ptr<TextTokenGenerator> text_token_generator_;
   std::string tokenizer_path_;
   std::unique_ptr<Tokenizer> tokenizer_;
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Reuse the KV cache of a prompt prefix across generate() calls.
+
+#include <executorch/extension/llm/runner/prefix_cache.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+size_t common_prefix_length(
+    const std::vector<uint64_t>& a,
+    const std::vector<uint64_t>& b) {
+  const size_t size = std::min(a.size(), b.size());
+  return std::mismatch(a.begin(), a.begin() + size, b.begin()).first -
+      a.begin();
+}
+
+} // namespace
+
+PrefixCache::PrefixCache(
+    Module* module,
+    size_t max_entries,
+    std::string method_name)
+    : module_(module),
+      max_entries_(max_entries),
+      method_name_(std::move(method_name)) {}
+
+Result<size_t> PrefixCache::restore(const std::vector<uint64_t>& tokens) {
+  if (tokens.size() < 2) {
+    return 0;
+  }
+  Entry* best = nullptr;
+  size_t best_length = 0;
+  for (auto& entry : entries_) {
+    const size_t length = common_prefix_length(entry.tokens, tokens);
+    if (length > best_length) {
+      best = &entry;
+      best_length = length;
+    }
+  }
+  if (best == nullptr) {
+    return 0;
+  }
+
+  auto buffers = ET_UNWRAP(module_->planned_buffers(method_name_));
+  ET_CHECK_OR_RETURN_ERROR(
+      buffers.size() == best->buffers.size(),
+      InvalidState,
+      "Expected %zu planned buffers, got %zu",
+      best->buffers.size(),
+      buffers.size());
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        buffers[i].size() == best->buffers[i].size(),
+        InvalidState,
+        "Planned buffer %zu changed size",
+        i);
+    std::memcpy(
+        buffers[i].data(), best->buffers[i].data(), best->buffers[i].size());
+  }
+  best->last_used = ++clock_;
+  return std::min(best_length, tokens.size() - 1);
+}
+
+Error PrefixCache::store(const std::vector<uint64_t>& tokens) {
+  if (max_entries_ == 0 || tokens.empty()) {
+    return Error::Ok;
+  }
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    const size_t length = common_prefix_length(it->tokens, tokens);
+    if (length == tokens.size()) {
+      // An existing snapshot already covers all of the tokens.
+      it->last_used = ++clock_;
+      return Error::Ok;
+    }
+    if (length == it->tokens.size()) {
+      // The new snapshot covers all of the tokens of this one.
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (entries_.size() >= max_entries_) {
+    entries_.erase(std::min_element(
+        entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) {
+          return a.last_used < b.last_used;
+        }));
+  }
+
+  const auto buffers = ET_UNWRAP(module_->planned_buffers(method_name_));
+  Entry entry;
+  entry.tokens = tokens;
+  entry.buffers.reserve(buffers.size());
+  for (const auto& buffer : buffers) {
+    entry.buffers.emplace_back(buffer.begin(), buffer.end());
+  }
+  entry.last_used = ++clock_;
+  entries_.push_back(std::move(entry));
+  return Error::Ok;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Reuse the KV cache of a prompt prefix across generate() calls.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Saves the state of a decoder after its prompt was prefilled, and restores
+ * it when a later prompt starts with some of the same tokens, so that only
+ * the rest of the prompt has to be prefilled.
+ *
+ * The state is a copy of the memory-planned buffers of the method, which
+ * hold its KV caches. Restoring a snapshot of n tokens is valid for any
+ * prompt that shares its first m <= n tokens: the cache entries of those
+ * positions are the same, and the model overwrites or masks out the ones
+ * after them. So a lookup picks the snapshot with the longest common prefix
+ * rather than requiring an exact match.
+ *
+ * Each snapshot is as large as the planned memory of the method. The least
+ * recently used one is dropped when more than max_entries are stored. Only
+ * models that keep their KV cache in mutable buffers are supported.
+ */
+class ET_EXPERIMENTAL PrefixCache {
+ public:
+  /**
+   * @param module The Module that runs the decoder.
+   * @param max_entries How many snapshots to keep at most.
+   * @param method_name The decoder method.
+   */
+  explicit PrefixCache(
+      Module* module,
+      size_t max_entries = 1,
+      std::string method_name = "forward");
+
+  /**
+   * Copies the snapshot that shares the longest prefix with tokens into the
+   * method's buffers. At least one token is left to be prefilled, so that the
+   * caller still gets the logits of the last prompt token.
+   * @param tokens The prompt tokens.
+   * @return How many of the tokens are in the restored KV cache, 0 if no
+   * snapshot matched.
+   */
+  ::executorch::runtime::Result<size_t> restore(
+      const std::vector<uint64_t>& tokens);
+
+  /**
+   * Snapshots the method's buffers. Must be called right after the tokens
+   * were prefilled, starting at position 0.
+   * @param tokens The tokens that are in the KV cache.
+   */
+  ::executorch::runtime::Error store(const std::vector<uint64_t>& tokens);
+
+  void clear() {
+    entries_.clear();
+  }
+
+  size_t size() const {
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    std::vector<uint64_t> tokens;
+    std::vector<std::vector<uint8_t>> buffers;
+    uint64_t last_used;
+  };
+
+  Module* module_;
+  size_t max_entries_;
+  std::string method_name_;
+  std::vector<Entry> entries_;
+  uint64_t clock_ = 0;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens with speculative decoding.
+
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
+
+#include <algorithm>
+
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::Result;
+
+SpeculativeTokenGenerator::SpeculativeTokenGenerator(
+    Tokenizer* tokenizer,
+    TextDecoderRunner* text_decoder_runner,
+    TokenDrafter* drafter,
+    int32_t num_draft_tokens,
+    std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+    Stats* stats)
+    : tokenizer_(tokenizer),
+      streaming_decoder_(tokenizer),
+      text_decoder_runner_(text_decoder_runner),
+      drafter_(drafter),
+      num_draft_tokens_(num_draft_tokens),
+      eos_ids_(std::move(eos_ids)),
+      stats_(stats) {}
+
+Result<int64_t> SpeculativeTokenGenerator::generate(
+    std::vector<uint64_t> tokens,
+    int64_t start_pos,
+    int32_t seq_len,
+    std::function<void(const std::string&)> token_callback) {
+  ET_CHECK_MSG(
+      !tokens.empty(), "Token generation loop shouldn't take empty tokens");
+  int64_t pos = start_pos; // position of tokens.back() in the sequence
+  std::vector<uint64_t> token_data;
+
+  should_stop_ = false;
+  streaming_decoder_.reset();
+
+  while (pos < seq_len - 1) {
+    // Every step commits up to one token more than it drafts.
+    const int32_t max_draft_tokens =
+        std::min<int64_t>(num_draft_tokens_, seq_len - 2 - pos);
+    std::vector<uint64_t> draft;
+    if (max_draft_tokens > 0) {
+      draft = ET_UNWRAP(drafter_->draft(tokens, max_draft_tokens));
+      if (draft.size() > static_cast<size_t>(max_draft_tokens)) {
+        draft.resize(max_draft_tokens);
+      }
+    }
+
+    // Run the current token and the draft in one forward.
+    token_data.assign(1, tokens.back());
+    token_data.insert(token_data.end(), draft.begin(), draft.end());
+    const auto num_inputs =
+        static_cast<executorch::aten::SizesType>(token_data.size());
+    auto tokens_managed = from_blob(
+        token_data.data(), {1, num_inputs}, executorch::aten::ScalarType::Long);
+    auto start_pos_managed =
+        from_blob(&pos, {1}, executorch::aten::ScalarType::Long);
+
+    auto outputs = ET_UNWRAP(
+        text_decoder_runner_->step_outputs(tokens_managed, start_pos_managed));
+    const auto& logits_tensor = outputs[0].toTensor();
+    // A Module with a fused argmax returns one token id per position.
+    const auto row_size =
+        logits_tensor.scalar_type() == executorch::aten::ScalarType::Long
+        ? 1
+        : logits_tensor.size(logits_tensor.dim() - 1);
+    ET_CHECK_OR_RETURN_ERROR(
+        logits_tensor.numel() == num_inputs * row_size,
+        InvalidState,
+        "Expected the logits of all %d input positions",
+        static_cast<int>(num_inputs));
+
+    stats_->on_sampling_begin();
+    const auto samples = text_decoder_runner_->logits_to_tokens(logits_tensor);
+    stats_->on_sampling_end();
+
+    size_t num_accepted = 0;
+    while (num_accepted < draft.size() &&
+           samples[num_accepted] == draft[num_accepted]) {
+      num_accepted++;
+    }
+    num_drafted_tokens_ += draft.size();
+    num_accepted_tokens_ += num_accepted;
+    drafter_->on_target_outputs(outputs, num_accepted);
+
+    // Commit the accepted tokens and the one sampled after them. The KV cache
+    // entries of rejected tokens are overwritten by the next forward.
+    bool finished = false;
+    for (size_t i = 0; i <= num_accepted; ++i) {
+      const uint64_t prev_token = tokens.back();
+      const uint64_t cur_token = samples[i];
+      tokens.push_back(cur_token);
+      pos++;
+
+      // print the token as string, decode it with the Tokenizer object
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          streaming_decoder_.decode(prev_token, cur_token, text_));
+      if (!text_.empty()) {
+        token_callback(text_);
+      }
+
+      if (should_stop_) {
+        finished = true;
+        break;
+      }
+
+      // data-dependent terminating condition: we have n_eos_ number of EOS
+      if (eos_ids_->find(cur_token) != eos_ids_->end()) {
+        printf("\n");
+        ET_LOG(Info, "\nReached to the end of generation");
+        finished = true;
+        break;
+      }
+    }
+    if (finished) {
+      break;
+    }
+  }
+  streaming_decoder_.flush(text_);
+  if (!text_.empty()) {
+    token_callback(text_);
+  }
+  return pos - start_pos;
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Generate tokens with speculative decoding.
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <executorch/extension/llm/runner/stats.h>
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/runner/token_drafter.h>
+#include <executorch/extension/llm/tokenizer/streaming_decoder.h>
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Drop-in replacement for TextTokenGenerator that can commit several tokens
+ * per forward of the target model. Each step a TokenDrafter proposes up to
+ * num_draft_tokens tokens, and the target model runs the current token and
+ * the proposals in one multi-token forward, like parallel prefill does.
+ *
+ * The target token is sampled at every input position. Proposals are
+ * accepted while they equal those samples, and the sample after the last
+ * accepted one is committed as well, so every step commits at least one
+ * token and the output is distributed exactly like the target model's.
+ * Rejected tokens are rolled back by starting the next forward at the
+ * position after the last committed token, which overwrites their KV cache
+ * entries.
+ *
+ * The target model must have a KV cache, accept several tokens per forward,
+ * and return the logits of every input position.
+ */
+class ET_EXPERIMENTAL SpeculativeTokenGenerator {
+ public:
+  SpeculativeTokenGenerator(
+      Tokenizer* tokenizer,
+      TextDecoderRunner* text_decoder_runner,
+      TokenDrafter* drafter,
+      int32_t num_draft_tokens,
+      std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
+      Stats* stats);
+
+  /**
+   * Token generation loop.
+   * @param tokens prompt tokens as well as the first token generated by
+   * prefill.
+   * @param start_pos the start position of the new tokens, based on how many
+   * prompt tokens is prefilled.
+   * @param seq_len the total sequence length, including the prompt tokens, next
+   * token from prefill and new tokens.
+   * @param token_callback what to do with the text of the generated tokens.
+   * It is called after each token that completes a UTF-8 character.
+   * @return how many tokens are generated.
+   */
+  ::executorch::runtime::Result<int64_t> generate(
+      std::vector<uint64_t> tokens,
+      int64_t start_pos,
+      int32_t seq_len,
+      std::function<void(const std::string&)> token_callback);
+
+  /**
+   * Stop the generation loop.
+   */
+  inline void stop() {
+    should_stop_ = true;
+  }
+
+  /**
+   * How many proposed tokens were verified since construction.
+   */
+  inline int64_t num_drafted_tokens() const {
+    return num_drafted_tokens_;
+  }
+
+  /**
+   * How many proposed tokens were accepted since construction.
+   */
+  inline int64_t num_accepted_tokens() const {
+    return num_accepted_tokens_;
+  }
+
+ private:
+  Tokenizer* tokenizer_;
+  StreamingDecoder streaming_decoder_;
+  // The text of the latest token, reused across tokens.
+  std::string text_;
+  TextDecoderRunner* text_decoder_runner_;
+  TokenDrafter* drafter_;
+  int32_t num_draft_tokens_;
+  std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
+
+  int64_t num_drafted_tokens_ = 0;
+  int64_t num_accepted_tokens_ = 0;
+
+  // state machine
+  bool should_stop_ = false;
+
+  // stats
+  Stats* stats_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -22,6 +22,18 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "metrics",
+        exported_headers = ["metrics.h"],
+        srcs = ["metrics.cpp"],
+        visibility = [
+            "@EXECUTORCH_CLIENTS",
+        ],
+        exported_deps = [
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
     for aten in (True, False):
         aten_suffix = "_aten" if aten else ""
 
@@ -48,6 +60,7 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
             exported_deps = [
+                ":metrics",
                 ":text_decoder_runner" + aten_suffix,
                 "//executorch/extension/llm/tokenizer:tokenizer_header",
                 "//executorch/extension/module:module" + aten_suffix,
@@ -62,6 +75,7 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
             exported_deps = [
+                ":metrics",
                 ":text_decoder_runner" + aten_suffix,
                 "//executorch/extension/llm/tokenizer:tokenizer_header",
                 "//executorch/extension/module:module" + aten_suffix,
@@ -69,6 +83,75 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_library(
+            name = "batched_text_token_generator" + aten_suffix,
+            exported_headers = ["batched_text_token_generator.h"],
+            srcs = ["batched_text_token_generator.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":text_decoder_runner" + aten_suffix,
+                "//executorch/extension/llm/tokenizer:tokenizer_header",
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "token_drafter" + aten_suffix,
+            exported_headers = ["token_drafter.h"],
+            srcs = ["token_drafter.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":text_decoder_runner" + aten_suffix,
+                ":text_prefiller" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "speculative_token_generator" + aten_suffix,
+            exported_headers = ["speculative_token_generator.h"],
+            srcs = ["speculative_token_generator.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":text_decoder_runner" + aten_suffix,
+                ":token_drafter" + aten_suffix,
+                "//executorch/extension/llm/tokenizer:tokenizer_header",
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "prefix_cache" + aten_suffix,
+            exported_headers = ["prefix_cache.h"],
+            srcs = ["prefix_cache.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                "//executorch/extension/module:module" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "lora_adapter_bank" + aten_suffix,
+            exported_headers = ["lora_adapter_bank.h"],
+            srcs = ["lora_adapter_bank.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
         runtime.cxx_library(
             name = "image_prefiller" + aten_suffix,
             exported_headers = ["image_prefiller.h", "image.h"],
@@ -77,6 +160,33 @@ def define_common_targets():
             ],
             exported_deps = [
                 "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "image_embedding_cache" + aten_suffix,
+            exported_headers = ["image_embedding_cache.h"],
+            srcs = ["image_embedding_cache.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":image_prefiller" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "cross_attention_cache" + aten_suffix,
+            exported_headers = ["cross_attention_cache.h"],
+            srcs = ["cross_attention_cache.cpp"],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
             ],
         )
 
@@ -89,9 +199,16 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
             exported_deps = [
+                ":batched_text_token_generator" + aten_suffix,
+                ":cross_attention_cache" + aten_suffix,
+                ":image_embedding_cache" + aten_suffix,
                 ":image_prefiller" + aten_suffix,
+                ":lora_adapter_bank" + aten_suffix,
+                ":prefix_cache" + aten_suffix,
+                ":speculative_token_generator" + aten_suffix,
                 ":text_decoder_runner" + aten_suffix,
                 ":text_prefiller" + aten_suffix,
                 ":text_token_generator" + aten_suffix,
+                ":token_drafter" + aten_suffix,
             ],
         )
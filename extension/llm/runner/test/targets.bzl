@@ -0,0 +1,96 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_test(
+        name = "test_batched_text_token_generator",
+        srcs = [
+            "test_batched_text_token_generator.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:batched_text_token_generator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_speculative_token_generator",
+        srcs = [
+            "test_speculative_token_generator.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:speculative_token_generator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_text_decoder_runner",
+        srcs = [
+            "test_text_decoder_runner.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:text_decoder_runner",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_text_prefiller",
+        srcs = [
+            "test_text_prefiller.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:text_prefiller",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_metrics",
+        srcs = [
+            "test_metrics.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:metrics",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_image_embedding_cache",
+        srcs = [
+            "test_image_embedding_cache.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:image_embedding_cache",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "test_lora_adapter_bank",
+        srcs = [
+            "test_lora_adapter_bank.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:lora_adapter_bank",
+            "//executorch/kernels/portable:generated_lib",
+        ],
+        env = {
+            "RESOURCES_PATH": "$(location //executorch/extension/module/test:resources)/resources",
+        },
+    )
+
+    runtime.cxx_test(
+        name = "test_prefix_cache",
+        srcs = [
+            "test_prefix_cache.cpp",
+        ],
+        deps = [
+            "//executorch/extension/llm/runner:prefix_cache",
+            "//executorch/kernels/portable:generated_lib",
+        ],
+        env = {
+            "RESOURCES_PATH": "$(location //executorch/extension/module/test:resources)/resources",
+        },
+    )
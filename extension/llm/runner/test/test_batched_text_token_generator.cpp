@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/batched_text_token_generator.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::from_blob;
+using ::executorch::extension::TensorPtr;
+using ::executorch::extension::llm::BatchedTextTokenGenerator;
+using ::executorch::extension::llm::Stats;
+using ::executorch::extension::llm::TextDecoderRunner;
+using ::executorch::extension::llm::Tokenizer;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace {
+
+constexpr int32_t kVocabSize = 64;
+
+// The arguments of one decoder call.
+struct DecoderCall {
+  std::vector<int64_t> tokens;
+  std::vector<int64_t> positions;
+  std::vector<int64_t> slots;
+};
+
+// A decoder whose most likely next token is always its input token + 1.
+class FakeTextDecoderRunner : public TextDecoderRunner {
+ public:
+  FakeTextDecoderRunner()
+      : TextDecoderRunner(
+            /*module=*/nullptr,
+            /*use_kv_cache=*/true,
+            kVocabSize,
+            /*temperature=*/0.0f) {}
+
+  Result<executorch::aten::Tensor> step_batch(
+      TensorPtr& tokens,
+      TensorPtr& start_pos,
+      TensorPtr& cache_slots) override {
+    const auto batch_size = tokens->size(0);
+    const int64_t* token_data = tokens->const_data_ptr<int64_t>();
+    const int64_t* pos_data = start_pos->const_data_ptr<int64_t>();
+    const int64_t* slot_data = cache_slots->const_data_ptr<int64_t>();
+    calls.push_back(
+        {std::vector<int64_t>(token_data, token_data + tokens->numel()),
+         std::vector<int64_t>(pos_data, pos_data + batch_size),
+         std::vector<int64_t>(slot_data, slot_data + batch_size)});
+
+    logits_.assign(batch_size * kVocabSize, 0.0f);
+    for (int64_t b = 0; b < batch_size; ++b) {
+      logits_[b * kVocabSize + (token_data[b] + 1) % kVocabSize] = 1.0f;
+    }
+    logits_tensor_ = from_blob(logits_.data(), {batch_size, kVocabSize});
+    return *logits_tensor_;
+  }
+
+  std::vector<DecoderCall> calls;
+
+ private:
+  std::vector<float> logits_;
+  TensorPtr logits_tensor_;
+};
+
+class FakeTokenizer : public Tokenizer {
+ public:
+  Error load(const std::string&) override {
+    return Error::Ok;
+  }
+
+  Result<std::vector<uint64_t>> encode(const std::string&, int8_t, int8_t)
+      const override {
+    return std::vector<uint64_t>();
+  }
+
+  // Tokens 60 and 61 are the two bytes of U+00E9.
+  Result<std::string> decode(uint64_t, uint64_t token) const override {
+    if (token == 60 || token == 61) {
+      return std::string(1, token == 60 ? '\xC3' : '\xA9');
+    }
+    return std::to_string(token);
+  }
+};
+
+class BatchedTextTokenGeneratorTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  std::unique_ptr<BatchedTextTokenGenerator> make_generator(
+      int32_t max_batch_size,
+      std::unordered_set<uint64_t> eos_ids = {},
+      int32_t prefill_chunk_size = 0) {
+    return std::make_unique<BatchedTextTokenGenerator>(
+        &tokenizer_,
+        &decoder_,
+        max_batch_size,
+        /*max_seq_len=*/32,
+        std::make_unique<std::unordered_set<uint64_t>>(std::move(eos_ids)),
+        &stats_,
+        prefill_chunk_size);
+  }
+
+  FakeTokenizer tokenizer_;
+  FakeTextDecoderRunner decoder_;
+  Stats stats_;
+};
+
+} // namespace
+
+TEST_F(BatchedTextTokenGeneratorTest, SingleSequenceStopsAtSeqLen) {
+  auto generator = make_generator(/*max_batch_size=*/2);
+  std::vector<std::string> pieces;
+  int64_t finished_with = -1;
+  ASSERT_TRUE(generator
+                  ->admit(
+                      {1, 2, 3},
+                      /*seq_len=*/6,
+                      [&](const std::string& piece) {
+                        pieces.push_back(piece);
+                      },
+                      [&](int64_t num_generated) {
+                        finished_with = num_generated;
+                      })
+                  .ok());
+
+  Result<int64_t> num_generated = generator->generate();
+  ASSERT_TRUE(num_generated.ok());
+  EXPECT_EQ(num_generated.get(), 3);
+  EXPECT_EQ(finished_with, 3);
+  EXPECT_EQ(pieces, (std::vector<std::string>{"4", "5", "6"}));
+  EXPECT_EQ(generator->num_active(), 0);
+
+  // The prompt is fed one token per step, then the generated tokens follow.
+  ASSERT_EQ(decoder_.calls.size(), 5);
+  for (int64_t i = 0; i < 5; ++i) {
+    EXPECT_EQ(decoder_.calls[i].tokens, std::vector<int64_t>{i + 1});
+    EXPECT_EQ(decoder_.calls[i].positions, std::vector<int64_t>{i});
+    EXPECT_EQ(decoder_.calls[i].slots, std::vector<int64_t>{0});
+  }
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, DecodesSequencesTogether) {
+  auto generator = make_generator(/*max_batch_size=*/2);
+  std::vector<std::string> a_pieces;
+  std::vector<std::string> b_pieces;
+  ASSERT_TRUE(generator
+                  ->admit(
+                      {10},
+                      /*seq_len=*/3,
+                      [&](const std::string& piece) {
+                        a_pieces.push_back(piece);
+                      })
+                  .ok());
+  ASSERT_TRUE(generator
+                  ->admit(
+                      {20, 21},
+                      /*seq_len=*/4,
+                      [&](const std::string& piece) {
+                        b_pieces.push_back(piece);
+                      })
+                  .ok());
+  EXPECT_FALSE(generator->has_free_slot());
+
+  ASSERT_TRUE(generator->generate().ok());
+  EXPECT_EQ(a_pieces, (std::vector<std::string>{"11", "12"}));
+  EXPECT_EQ(b_pieces, (std::vector<std::string>{"22", "23"}));
+
+  // Both sequences share one decoder call per step, each at its own
+  // position, until the shorter one retires.
+  ASSERT_EQ(decoder_.calls.size(), 3);
+  EXPECT_EQ(decoder_.calls[0].tokens, (std::vector<int64_t>{10, 20}));
+  EXPECT_EQ(decoder_.calls[0].positions, (std::vector<int64_t>{0, 0}));
+  EXPECT_EQ(decoder_.calls[0].slots, (std::vector<int64_t>{0, 1}));
+  EXPECT_EQ(decoder_.calls[1].tokens, (std::vector<int64_t>{11, 21}));
+  EXPECT_EQ(decoder_.calls[1].positions, (std::vector<int64_t>{1, 1}));
+  EXPECT_EQ(decoder_.calls[2].tokens, (std::vector<int64_t>{22}));
+  EXPECT_EQ(decoder_.calls[2].positions, (std::vector<int64_t>{2}));
+  EXPECT_EQ(decoder_.calls[2].slots, (std::vector<int64_t>{1}));
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, FinishedSequenceFreesSlot) {
+  auto generator = make_generator(/*max_batch_size=*/1, /*eos_ids=*/{5});
+  std::vector<std::string> pieces;
+  auto on_token = [&](const std::string& piece) { pieces.push_back(piece); };
+
+  ASSERT_TRUE(generator->admit({3}, /*seq_len=*/16, on_token).ok());
+  Result<uint64_t> full = generator->admit({7}, /*seq_len=*/16, on_token);
+  EXPECT_EQ(full.error(), Error::InvalidState);
+
+  // The first sequence reaches EOS in its second step and frees its slot.
+  // The next sequence reuses it, starting over at position 0.
+  ASSERT_TRUE(generator->step().ok());
+  ASSERT_TRUE(generator->step().ok());
+  EXPECT_EQ(generator->num_active(), 0);
+  ASSERT_TRUE(generator->admit({40}, /*seq_len=*/3, on_token).ok());
+  ASSERT_TRUE(generator->generate().ok());
+
+  EXPECT_EQ(pieces, (std::vector<std::string>{"4", "5", "41", "42"}));
+  ASSERT_EQ(decoder_.calls.size(), 4);
+  EXPECT_EQ(decoder_.calls[2].tokens, std::vector<int64_t>{40});
+  EXPECT_EQ(decoder_.calls[2].positions, std::vector<int64_t>{0});
+  EXPECT_EQ(decoder_.calls[2].slots, std::vector<int64_t>{0});
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, RetireCancelsSequence) {
+  auto generator = make_generator(/*max_batch_size=*/2);
+  int64_t finished_with = -1;
+  Result<uint64_t> id = generator->admit(
+      {1},
+      /*seq_len=*/16,
+      [](const std::string&) {},
+      [&](int64_t num_generated) { finished_with = num_generated; });
+  ASSERT_TRUE(id.ok());
+
+  ASSERT_TRUE(generator->step().ok());
+  EXPECT_EQ(generator->retire(id.get()), Error::Ok);
+  EXPECT_EQ(finished_with, 1);
+  EXPECT_EQ(generator->retire(id.get()), Error::NotFound);
+  EXPECT_EQ(generator->num_active(), 0);
+
+  Result<int64_t> num_generated = generator->step();
+  ASSERT_TRUE(num_generated.ok());
+  EXPECT_EQ(num_generated.get(), 0);
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, RejectsInvalidSequences) {
+  auto generator = make_generator(/*max_batch_size=*/2);
+  auto on_token = [](const std::string&) {};
+  EXPECT_EQ(
+      generator->admit({}, /*seq_len=*/8, on_token).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      generator->admit({1, 2}, /*seq_len=*/2, on_token).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      generator->admit({1}, /*seq_len=*/33, on_token).error(),
+      Error::InvalidArgument);
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, ChunkedPrefillInterleavesWithDecode) {
+  auto generator = make_generator(
+      /*max_batch_size=*/2, /*eos_ids=*/{}, /*prefill_chunk_size=*/4);
+  std::vector<std::string> pieces_a;
+  std::vector<std::string> pieces_b;
+  ASSERT_TRUE(generator
+                  ->admit(
+                      {1},
+                      /*seq_len=*/6,
+                      [&](const std::string& piece) {
+                        pieces_a.push_back(piece);
+                      })
+                  .ok());
+  ASSERT_TRUE(generator
+                  ->admit(
+                      {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+                      /*seq_len=*/12,
+                      [&](const std::string& piece) {
+                        pieces_b.push_back(piece);
+                      })
+                  .ok());
+
+  Result<int64_t> num_generated = generator->generate();
+  ASSERT_TRUE(num_generated.ok());
+  EXPECT_EQ(num_generated.get(), 7);
+  EXPECT_EQ(pieces_a, (std::vector<std::string>{"2", "3", "4", "5", "6"}));
+  EXPECT_EQ(pieces_b, (std::vector<std::string>{"30", "31"}));
+
+  // Every step decodes the first sequence and runs at most one chunk of the
+  // second prompt. Its last prompt token joins the decode call.
+  ASSERT_EQ(decoder_.calls.size(), 8);
+  EXPECT_EQ(decoder_.calls[0].tokens, (std::vector<int64_t>{1}));
+  EXPECT_EQ(decoder_.calls[1].tokens, (std::vector<int64_t>{20, 21, 22, 23}));
+  EXPECT_EQ(decoder_.calls[1].positions, (std::vector<int64_t>{0}));
+  EXPECT_EQ(decoder_.calls[1].slots, (std::vector<int64_t>{1}));
+  EXPECT_EQ(decoder_.calls[2].tokens, (std::vector<int64_t>{2}));
+  EXPECT_EQ(decoder_.calls[3].tokens, (std::vector<int64_t>{24, 25, 26, 27}));
+  EXPECT_EQ(decoder_.calls[3].positions, (std::vector<int64_t>{4}));
+  EXPECT_EQ(decoder_.calls[4].tokens, (std::vector<int64_t>{3}));
+  EXPECT_EQ(decoder_.calls[5].tokens, (std::vector<int64_t>{28}));
+  EXPECT_EQ(decoder_.calls[5].positions, (std::vector<int64_t>{8}));
+  EXPECT_EQ(decoder_.calls[6].tokens, (std::vector<int64_t>{4, 29}));
+  EXPECT_EQ(decoder_.calls[6].positions, (std::vector<int64_t>{3, 9}));
+  EXPECT_EQ(generator->num_active(), 0);
+}
+
+TEST_F(BatchedTextTokenGeneratorTest, HoldsBackPartialCharactersPerSequence) {
+  auto generator = make_generator(/*max_batch_size=*/2);
+  std::vector<std::string> a_pieces;
+  std::vector<std::string> b_pieces;
+  ASSERT_TRUE(generator
+                  ->admit(
+                      {59},
+                      /*seq_len=*/4,
+                      [&](const std::string& piece) {
+                        a_pieces.push_back(piece);
+                      })
+                  .ok());
+  ASSERT_TRUE(generator
+                  ->admit(
+                      {58},
+                      /*seq_len=*/3,
+                      [&](const std::string& piece) {
+                        b_pieces.push_back(piece);
+                      })
+                  .ok());
+
+  ASSERT_TRUE(generator->generate().ok());
+  // The two bytes of one character arrive in one callback.
+  EXPECT_EQ(a_pieces, (std::vector<std::string>{"\xC3\xA9", "62"}));
+  // A sequence that ends in the middle of a character gets the rest of its
+  // bytes when it retires.
+  EXPECT_EQ(b_pieces, (std::vector<std::string>{"59", "\xC3"}));
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/image_embedding_cache.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::make_tensor_ptr;
+using ::executorch::extension::llm::Image;
+using ::executorch::extension::llm::ImageEmbeddingCache;
+
+namespace {
+
+Image make_image(uint8_t value, int32_t width = 2) {
+  Image image;
+  image.width = width;
+  image.height = 2;
+  image.channels = 3;
+  image.data.assign(3 * 2 * width, value);
+  return image;
+}
+
+} // namespace
+
+TEST(ImageEmbeddingCacheTest, ReturnsEmbeddingsOfSameImage) {
+  ImageEmbeddingCache cache(/*max_entries=*/2);
+  const auto embeddings = make_tensor_ptr({1, 2}, {1.0f, 2.0f});
+  cache.put(make_image(1), embeddings);
+
+  EXPECT_EQ(cache.get(make_image(1)), embeddings);
+  EXPECT_EQ(cache.get(make_image(2)), nullptr);
+  // Same pixels, but a different shape.
+  Image reshaped = make_image(1, /*width=*/3);
+  reshaped.data.resize(make_image(1).data.size());
+  EXPECT_EQ(cache.get(reshaped), nullptr);
+}
+
+TEST(ImageEmbeddingCacheTest, EvictsLeastRecentlyUsed) {
+  ImageEmbeddingCache cache(/*max_entries=*/2);
+  const auto first = make_tensor_ptr({1}, {1.0f});
+  const auto second = make_tensor_ptr({1}, {2.0f});
+  const auto third = make_tensor_ptr({1}, {3.0f});
+  cache.put(make_image(1), first);
+  cache.put(make_image(2), second);
+  EXPECT_EQ(cache.get(make_image(1)), first);
+
+  cache.put(make_image(3), third);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.get(make_image(1)), first);
+  EXPECT_EQ(cache.get(make_image(2)), nullptr);
+  EXPECT_EQ(cache.get(make_image(3)), third);
+
+  // Storing the same image again replaces its embeddings.
+  cache.put(make_image(3), second);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.get(make_image(3)), second);
+}
+
+TEST(ImageEmbeddingCacheTest, ZeroEntriesDisablesCache) {
+  ImageEmbeddingCache cache(/*max_entries=*/0);
+  cache.put(make_image(1), make_tensor_ptr({1}, {1.0f}));
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.get(make_image(1)), nullptr);
+}
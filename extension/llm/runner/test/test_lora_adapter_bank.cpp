@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/lora_adapter_bank.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::Module;
+using ::executorch::extension::llm::LoRAAdapterBank;
+using ::executorch::runtime::Error;
+
+// add.pte computes x + y of two [1] floats, which the bank sees as a single
+// pair of one-slot weight inputs without adapter_ids.
+class LoRAAdapterBankTest : public Test {
+ protected:
+  void SetUp() override {
+    module_ = std::make_unique<Module>(
+        std::getenv("RESOURCES_PATH") + std::string("/add.pte"));
+  }
+
+  float forward() {
+    auto outputs = module_->forward();
+    EXPECT_EQ(outputs.error(), Error::Ok);
+    return outputs->at(0).toTensor().const_data_ptr<float>()[0];
+  }
+
+  std::unique_ptr<Module> module_;
+};
+
+TEST_F(LoRAAdapterBankTest, BindsAdapterInputs) {
+  LoRAAdapterBank bank(module_.get(), /*first_input=*/0);
+  ASSERT_EQ(bank.load(), Error::Ok);
+  EXPECT_EQ(bank.num_slots(), 1);
+  EXPECT_EQ(bank.adapter_size(), 2 * sizeof(float));
+  EXPECT_EQ(forward(), 0.0f);
+
+  const float adapter[] = {3.0f, 4.0f};
+  ASSERT_EQ(bank.load_adapter(0, adapter, sizeof(adapter)), Error::Ok);
+  EXPECT_EQ(forward(), 7.0f);
+
+  ASSERT_EQ(bank.unload_adapter(0), Error::Ok);
+  EXPECT_EQ(forward(), 0.0f);
+}
+
+TEST_F(LoRAAdapterBankTest, RejectsInvalidAdapters) {
+  LoRAAdapterBank bank(module_.get(), /*first_input=*/0);
+  const float adapter[] = {3.0f, 4.0f};
+  EXPECT_EQ(
+      bank.load_adapter(0, adapter, sizeof(adapter)), Error::InvalidState);
+
+  ASSERT_EQ(bank.load(), Error::Ok);
+  EXPECT_EQ(
+      bank.load_adapter(1, adapter, sizeof(adapter)), Error::InvalidArgument);
+  EXPECT_EQ(
+      bank.load_adapter(0, adapter, sizeof(float)), Error::InvalidArgument);
+  EXPECT_EQ(bank.load_adapter(0, "/nonexistent"), Error::AccessFailed);
+  // The method takes no adapter_ids, so there is nothing to select.
+  EXPECT_EQ(bank.select({0}), Error::InvalidState);
+}
+
+TEST_F(LoRAAdapterBankTest, RejectsInvalidLayouts) {
+  // A single weight input is not a pair of lora_a and lora_b.
+  LoRAAdapterBank unpaired(module_.get(), /*first_input=*/1);
+  EXPECT_EQ(unpaired.load(), Error::InvalidProgram);
+
+  LoRAAdapterBank out_of_range(module_.get(), /*first_input=*/2);
+  EXPECT_EQ(out_of_range.load(), Error::InvalidArgument);
+}
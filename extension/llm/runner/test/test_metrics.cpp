@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/metrics.h>
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::llm::LatencyHistogram;
+using ::executorch::extension::llm::RunnerMetrics;
+using ::executorch::extension::llm::ScopedLatency;
+
+TEST(LatencyHistogramTest, BucketsCoverEveryLatency) {
+  for (uint64_t latency : {0ull, 1ull, 3ull, 4ull, 5ull, 7ull, 8ull, 1000ull,
+                           123456789ull}) {
+    const size_t index = LatencyHistogram::bucket_index(latency);
+    EXPECT_LT(latency, LatencyHistogram::bucket_upper_bound(index));
+    if (index > 0) {
+      EXPECT_GE(latency, LatencyHistogram::bucket_upper_bound(index - 1));
+    }
+  }
+  EXPECT_EQ(
+      LatencyHistogram::bucket_index(UINT64_MAX),
+      LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinBucketWidth) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.percentile(0.5), 0);
+  for (uint64_t latency = 1; latency <= 1000; ++latency) {
+    histogram.record(latency);
+  }
+  EXPECT_EQ(histogram.count(), 1000);
+  EXPECT_EQ(histogram.sum(), 500500);
+  EXPECT_EQ(histogram.max(), 1000);
+  const uint64_t p50 = histogram.percentile(0.5);
+  EXPECT_GE(p50, 500);
+  EXPECT_LE(p50, 625);
+  const uint64_t p99 = histogram.percentile(0.99);
+  EXPECT_GE(p99, 990);
+  EXPECT_LE(p99, 1000);
+
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0);
+  EXPECT_EQ(histogram.max(), 0);
+}
+
+TEST(LatencyHistogramTest, RecordsFromManyThreads) {
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&histogram, t]() {
+      for (int i = 0; i < 1000; ++i) {
+        histogram.record(t * 1000 + i);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(histogram.count(), 4000);
+  EXPECT_EQ(histogram.max(), 3999);
+}
+
+TEST(RunnerMetricsTest, ScopedLatencyRecordsOnlyIntoHistogram) {
+  RunnerMetrics metrics;
+  { ScopedLatency latency(&metrics.sampling_us); }
+  { ScopedLatency disabled(nullptr); }
+  EXPECT_EQ(metrics.sampling_us.count(), 1);
+}
+
+TEST(RunnerMetricsTest, ExportsJsonAndPrometheus) {
+  RunnerMetrics metrics;
+  metrics.token_latency_us.record(100);
+  metrics.generated_tokens = 1;
+  metrics.kv_cache_positions = 7;
+  metrics.kv_cache_capacity = 128;
+
+  const std::string json = metrics.to_json();
+  EXPECT_NE(
+      json.find("\"token_latency_us\":{\"count\":1,\"sum\":100,\"max\":100,"
+                "\"p50\":100,\"p90\":100,\"p99\":100}"),
+      std::string::npos);
+  EXPECT_NE(json.find("\"generated_tokens\":1"), std::string::npos);
+  EXPECT_NE(json.find("\"kv_cache_capacity\":128}"), std::string::npos);
+
+  const std::string text = metrics.to_prometheus("llm");
+  EXPECT_NE(
+      text.find("# TYPE llm_token_latency_us summary\n"), std::string::npos);
+  EXPECT_NE(
+      text.find("llm_token_latency_us{quantile=\"0.99\"} 100\n"),
+      std::string::npos);
+  EXPECT_NE(text.find("llm_token_latency_us_count 1\n"), std::string::npos);
+  EXPECT_NE(text.find("llm_generated_tokens_total 1\n"), std::string::npos);
+  EXPECT_NE(text.find("llm_kv_cache_positions 7\n"), std::string::npos);
+
+  metrics.reset();
+  EXPECT_EQ(metrics.token_latency_us.count(), 0);
+  // The capacity describes the model rather than a run.
+  EXPECT_EQ(metrics.kv_cache_capacity.load(), 128);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/prefix_cache.h>
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::Module;
+using ::executorch::extension::llm::PrefixCache;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+class PrefixCacheTest : public Test {
+ protected:
+  void SetUp() override {
+    module_ = std::make_unique<Module>(
+        std::getenv("RESOURCES_PATH") + std::string("/add.pte"));
+    auto buffers = module_->planned_buffers("forward");
+    ASSERT_EQ(buffers.error(), Error::Ok);
+    buffers_ = buffers.get();
+    size_t total_size = 0;
+    for (const auto& buffer : buffers_) {
+      total_size += buffer.size();
+    }
+    if (total_size == 0) {
+      GTEST_SKIP() << "The model has no planned memory";
+    }
+  }
+
+  // Stands in for prefilling: sets every byte of the planned memory.
+  void fill(uint8_t value) {
+    for (auto& buffer : buffers_) {
+      std::memset(buffer.data(), value, buffer.size());
+    }
+  }
+
+  bool is_filled_with(uint8_t value) const {
+    for (const auto& buffer : buffers_) {
+      for (const auto byte : buffer) {
+        if (byte != value) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  std::unique_ptr<Module> module_;
+  std::vector<executorch::runtime::Span<uint8_t>> buffers_;
+};
+
+TEST_F(PrefixCacheTest, RestoresLongestCommonPrefix) {
+  PrefixCache cache(module_.get(), /*max_entries=*/2);
+
+  fill(1);
+  ASSERT_EQ(cache.store({10, 11, 12}), Error::Ok);
+  fill(2);
+  ASSERT_EQ(cache.store({20, 21}), Error::Ok);
+  fill(0);
+
+  Result<size_t> restored = cache.restore({10, 11, 99, 100});
+  ASSERT_EQ(restored.error(), Error::Ok);
+  EXPECT_EQ(restored.get(), 2);
+  EXPECT_TRUE(is_filled_with(1));
+
+  Result<size_t> restored_other = cache.restore({20, 21, 22});
+  ASSERT_EQ(restored_other.error(), Error::Ok);
+  EXPECT_EQ(restored_other.get(), 2);
+  EXPECT_TRUE(is_filled_with(2));
+}
+
+TEST_F(PrefixCacheTest, LeavesOneTokenToPrefill) {
+  PrefixCache cache(module_.get());
+
+  fill(3);
+  ASSERT_EQ(cache.store({1, 2, 3}), Error::Ok);
+  fill(0);
+
+  Result<size_t> restored = cache.restore({1, 2, 3});
+  ASSERT_EQ(restored.error(), Error::Ok);
+  EXPECT_EQ(restored.get(), 2);
+  EXPECT_TRUE(is_filled_with(3));
+}
+
+TEST_F(PrefixCacheTest, NoMatchLeavesStateAlone) {
+  PrefixCache cache(module_.get());
+
+  fill(4);
+  ASSERT_EQ(cache.store({1, 2, 3}), Error::Ok);
+  fill(5);
+
+  Result<size_t> restored = cache.restore({7, 8, 9});
+  ASSERT_EQ(restored.error(), Error::Ok);
+  EXPECT_EQ(restored.get(), 0);
+  EXPECT_TRUE(is_filled_with(5));
+}
+
+TEST_F(PrefixCacheTest, EvictsLeastRecentlyUsed) {
+  PrefixCache cache(module_.get(), /*max_entries=*/2);
+
+  ASSERT_EQ(cache.store({1, 1}), Error::Ok);
+  ASSERT_EQ(cache.store({2, 2}), Error::Ok);
+  ASSERT_EQ(cache.restore({1, 1, 1}).get(), 2);
+  ASSERT_EQ(cache.store({3, 3}), Error::Ok);
+  EXPECT_EQ(cache.size(), 2);
+
+  EXPECT_EQ(cache.restore({1, 1, 1}).get(), 2);
+  EXPECT_EQ(cache.restore({2, 2, 2}).get(), 0);
+  EXPECT_EQ(cache.restore({3, 3, 3}).get(), 2);
+}
+
+TEST_F(PrefixCacheTest, LongerPrefixReplacesShorterOne) {
+  PrefixCache cache(module_.get(), /*max_entries=*/2);
+
+  ASSERT_EQ(cache.store({1, 2}), Error::Ok);
+  ASSERT_EQ(cache.store({1, 2, 3, 4}), Error::Ok);
+  EXPECT_EQ(cache.size(), 1);
+  // A prefix of a stored snapshot adds nothing.
+  ASSERT_EQ(cache.store({1, 2, 3}), Error::Ok);
+  EXPECT_EQ(cache.size(), 1);
+
+  EXPECT_EQ(cache.restore({1, 2, 3, 4, 5}).get(), 4);
+}
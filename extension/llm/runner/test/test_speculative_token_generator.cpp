@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/speculative_token_generator.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::from_blob;
+using ::executorch::extension::TensorPtr;
+using ::executorch::extension::llm::DraftModelDrafter;
+using ::executorch::extension::llm::MedusaDrafter;
+using ::executorch::extension::llm::NgramDrafter;
+using ::executorch::extension::llm::SpeculativeTokenGenerator;
+using ::executorch::extension::llm::Stats;
+using ::executorch::extension::llm::TextDecoderRunner;
+using ::executorch::extension::llm::TokenDrafter;
+using ::executorch::extension::llm::Tokenizer;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::EValue;
+using ::executorch::runtime::Result;
+
+namespace {
+
+constexpr int32_t kVocabSize = 64;
+
+// A decoder whose most likely next token is always its input token + 1.
+// Head i of its self-drafting heads predicts the input token + 1 + i.
+class FakeTextDecoderRunner : public TextDecoderRunner {
+ public:
+  explicit FakeTextDecoderRunner(int32_t num_heads = 0)
+      : TextDecoderRunner(
+            /*module=*/nullptr,
+            /*use_kv_cache=*/true,
+            kVocabSize,
+            /*temperature=*/0.0f),
+        num_heads_(num_heads) {}
+
+  bool is_method_loaded() override {
+    return true;
+  }
+
+  Result<executorch::aten::Tensor> step(
+      TensorPtr& tokens,
+      TensorPtr& start_pos) override {
+    return step_outputs(tokens, start_pos).get()[0].toTensor();
+  }
+
+  Result<std::vector<EValue>> step_outputs(
+      TensorPtr& tokens,
+      TensorPtr& start_pos) override {
+    const auto num_tokens = tokens->size(1);
+    const int64_t* token_data = tokens->const_data_ptr<int64_t>();
+    positions.push_back(start_pos->const_data_ptr<int64_t>()[0]);
+    num_inputs.push_back(num_tokens);
+
+    logits_.resize(num_heads_ + 1);
+    logits_tensors_.clear();
+    std::vector<EValue> outputs;
+    for (int32_t head = 0; head <= num_heads_; ++head) {
+      logits_[head].assign(num_tokens * kVocabSize, 0.0f);
+      for (int64_t t = 0; t < num_tokens; ++t) {
+        const int64_t next_token = (token_data[t] + 1 + head) % kVocabSize;
+        logits_[head][t * kVocabSize + next_token] = 1.0f;
+      }
+      logits_tensors_.push_back(
+          from_blob(logits_[head].data(), {1, num_tokens, kVocabSize}));
+      outputs.emplace_back(*logits_tensors_.back());
+    }
+    return outputs;
+  }
+
+  // The start position and number of tokens of every forward.
+  std::vector<int64_t> positions;
+  std::vector<int64_t> num_inputs;
+
+ private:
+  int32_t num_heads_;
+  std::vector<std::vector<float>> logits_;
+  std::vector<TensorPtr> logits_tensors_;
+};
+
+class FakeTokenizer : public Tokenizer {
+ public:
+  Error load(const std::string&) override {
+    return Error::Ok;
+  }
+
+  Result<std::vector<uint64_t>> encode(const std::string&, int8_t, int8_t)
+      const override {
+    return std::vector<uint64_t>();
+  }
+
+  Result<std::string> decode(uint64_t, uint64_t token) const override {
+    return std::to_string(token);
+  }
+};
+
+// Proposes the tokens that the fake decoder predicts, or wrong ones.
+class FixedDrafter : public TokenDrafter {
+ public:
+  explicit FixedDrafter(bool correct) : correct_(correct) {}
+
+  Result<std::vector<uint64_t>> draft(
+      const std::vector<uint64_t>& tokens,
+      int32_t max_tokens) override {
+    std::vector<uint64_t> result;
+    for (int32_t i = 1; i <= max_tokens; ++i) {
+      result.push_back(correct_ ? tokens.back() + i : 0);
+    }
+    return result;
+  }
+
+ private:
+  bool correct_;
+};
+
+class SpeculativeTokenGeneratorTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  std::vector<std::string> generate(
+      TextDecoderRunner* decoder,
+      TokenDrafter* drafter,
+      std::vector<uint64_t> tokens,
+      int32_t seq_len,
+      std::unordered_set<uint64_t> eos_ids = {}) {
+    generator_ = std::make_unique<SpeculativeTokenGenerator>(
+        &tokenizer_,
+        decoder,
+        drafter,
+        /*num_draft_tokens=*/3,
+        std::make_unique<std::unordered_set<uint64_t>>(std::move(eos_ids)),
+        &stats_);
+    std::vector<std::string> pieces;
+    const int64_t start_pos = tokens.size() - 1;
+    Result<int64_t> num_generated = generator_->generate(
+        std::move(tokens), start_pos, seq_len, [&](const std::string& piece) {
+          pieces.push_back(piece);
+        });
+    EXPECT_TRUE(num_generated.ok());
+    EXPECT_EQ(num_generated.get(), pieces.size());
+    return pieces;
+  }
+
+  FakeTokenizer tokenizer_;
+  Stats stats_;
+  std::unique_ptr<SpeculativeTokenGenerator> generator_;
+};
+
+} // namespace
+
+TEST_F(SpeculativeTokenGeneratorTest, AcceptsCorrectDrafts) {
+  FakeTextDecoderRunner decoder;
+  FixedDrafter drafter(/*correct=*/true);
+
+  std::vector<std::string> pieces =
+      generate(&decoder, &drafter, {1, 2}, /*seq_len=*/10);
+
+  EXPECT_EQ(
+      pieces,
+      (std::vector<std::string>{"3", "4", "5", "6", "7", "8", "9", "10"}));
+  // Four tokens per forward, instead of one.
+  EXPECT_EQ(decoder.positions, (std::vector<int64_t>{1, 5}));
+  EXPECT_EQ(decoder.num_inputs, (std::vector<int64_t>{4, 4}));
+  EXPECT_EQ(generator_->num_drafted_tokens(), 6);
+  EXPECT_EQ(generator_->num_accepted_tokens(), 6);
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, RejectedDraftsRollBack) {
+  FakeTextDecoderRunner decoder;
+  FixedDrafter drafter(/*correct=*/false);
+
+  std::vector<std::string> pieces =
+      generate(&decoder, &drafter, {1, 2}, /*seq_len=*/6);
+
+  // The output equals plain decoding, one token per forward, starting each
+  // forward right after the last committed token.
+  EXPECT_EQ(pieces, (std::vector<std::string>{"3", "4", "5", "6"}));
+  EXPECT_EQ(decoder.positions, (std::vector<int64_t>{1, 2, 3, 4}));
+  EXPECT_EQ(generator_->num_accepted_tokens(), 0);
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, StopsAtEosInsideDraft) {
+  FakeTextDecoderRunner decoder;
+  FixedDrafter drafter(/*correct=*/true);
+
+  std::vector<std::string> pieces = generate(
+      &decoder, &drafter, {1}, /*seq_len=*/16, /*eos_ids=*/{4});
+
+  EXPECT_EQ(pieces, (std::vector<std::string>{"2", "3", "4"}));
+  EXPECT_EQ(decoder.positions.size(), 1);
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, NgramDrafterLooksUpSuffix) {
+  NgramDrafter drafter(/*max_ngram_size=*/2);
+
+  Result<std::vector<uint64_t>> draft = drafter.draft({5, 1, 2, 3, 4, 1, 2}, 2);
+  ASSERT_TRUE(draft.ok());
+  EXPECT_EQ(draft.get(), (std::vector<uint64_t>{3, 4}));
+
+  // The latest occurrence of the shorter suffix wins when the longer one is
+  // not found.
+  Result<std::vector<uint64_t>> shorter_draft =
+      drafter.draft({7, 9, 8, 9, 6, 3, 9}, 3);
+  ASSERT_TRUE(shorter_draft.ok());
+  EXPECT_EQ(shorter_draft.get(), (std::vector<uint64_t>{6, 3, 9}));
+
+  Result<std::vector<uint64_t>> no_draft = drafter.draft({1, 2, 3}, 3);
+  ASSERT_TRUE(no_draft.ok());
+  EXPECT_TRUE(no_draft.get().empty());
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, DraftModelReusesItsCache) {
+  FakeTextDecoderRunner decoder;
+  FakeTextDecoderRunner draft_decoder;
+  DraftModelDrafter drafter(&draft_decoder, /*enable_parallel_prefill=*/true);
+
+  std::vector<std::string> pieces =
+      generate(&decoder, &drafter, {1, 2, 3}, /*seq_len=*/11);
+
+  EXPECT_EQ(
+      pieces,
+      (std::vector<std::string>{"4", "5", "6", "7", "8", "9", "10", "11"}));
+  EXPECT_EQ(decoder.positions, (std::vector<int64_t>{2, 6}));
+  // The draft model first prefills the prompt, then only runs the tokens it
+  // has not seen yet: the last accepted draft and the sampled token.
+  EXPECT_EQ(
+      draft_decoder.positions, (std::vector<int64_t>{0, 3, 4, 5, 7, 8}));
+  EXPECT_EQ(draft_decoder.num_inputs, (std::vector<int64_t>{3, 1, 1, 2, 1, 1}));
+}
+
+TEST_F(SpeculativeTokenGeneratorTest, MedusaDrafterUsesHeadOutputs) {
+  FakeTextDecoderRunner decoder(/*num_heads=*/3);
+  MedusaDrafter drafter;
+
+  std::vector<std::string> pieces =
+      generate(&decoder, &drafter, {1}, /*seq_len=*/10);
+
+  EXPECT_EQ(
+      pieces,
+      (std::vector<std::string>{"2", "3", "4", "5", "6", "7", "8", "9", "10"}));
+  // The heads have nothing to draft from before the first forward.
+  EXPECT_EQ(decoder.num_inputs, (std::vector<int64_t>{1, 4, 4}));
+  EXPECT_EQ(generator_->num_accepted_tokens(), 6);
+}
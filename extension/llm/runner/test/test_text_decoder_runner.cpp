@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::aten::ScalarType;
+using ::executorch::extension::from_blob;
+using ::executorch::extension::llm::TextDecoderRunner;
+
+namespace {
+
+constexpr int32_t kVocabSize = 8;
+
+class TextDecoderRunnerTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(TextDecoderRunnerTest, SamplesOnlyAllowedTokens) {
+  TextDecoderRunner runner(
+      /*module=*/nullptr,
+      /*use_kv_cache=*/true,
+      kVocabSize,
+      /*temperature=*/0.0f);
+  std::vector<float> logits = {0, 1, 2, 3, 4, 5, 6, 7};
+  auto tensor = from_blob(logits.data(), {1, 1, kVocabSize});
+  EXPECT_EQ(runner.logits_to_token(*tensor), 7);
+
+  runner.set_allowed_tokens({1, 4, 2});
+  EXPECT_EQ(runner.logits_to_token(*tensor), 4);
+
+  runner.set_allowed_tokens({});
+  EXPECT_EQ(runner.logits_to_token(*tensor), 7);
+}
+
+TEST_F(TextDecoderRunnerTest, SamplesWithTemperatureAmongAllowedTokens) {
+  TextDecoderRunner runner(
+      /*module=*/nullptr,
+      /*use_kv_cache=*/true,
+      kVocabSize,
+      /*temperature=*/1.0f);
+  std::vector<float> logits(kVocabSize, 0.0f);
+  logits[0] = 10.0f;
+  auto tensor = from_blob(logits.data(), {1, 1, kVocabSize});
+  runner.set_allowed_tokens({3, 5});
+  for (int i = 0; i < 100; ++i) {
+    const auto token = runner.logits_to_token(*tensor);
+    EXPECT_TRUE(token == 3 || token == 5);
+  }
+}
+
+TEST_F(TextDecoderRunnerTest, MapsVocabSubsetLogitsToTokens) {
+  TextDecoderRunner runner(
+      /*module=*/nullptr,
+      /*use_kv_cache=*/true,
+      kVocabSize,
+      /*temperature=*/0.0f);
+  runner.set_vocab_subset_input(true);
+  runner.set_allowed_tokens({6, 2, 5});
+  // The logits of tokens 6, 2 and 5, in that order.
+  std::vector<float> logits = {0.5f, 3.0f, 1.0f};
+  auto tensor = from_blob(logits.data(), {1, 1, 3});
+  EXPECT_EQ(runner.logits_to_token(*tensor), 2);
+
+  // A fused argmax returns the index into the allowed tokens.
+  int64_t index = 2;
+  auto index_tensor = from_blob(&index, {1, 1}, ScalarType::Long);
+  EXPECT_EQ(runner.logits_to_token(*index_tensor), 5);
+}
+
+} // namespace
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/llm/runner/text_prefiller.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using ::executorch::extension::from_blob;
+using ::executorch::extension::TensorPtr;
+using ::executorch::extension::llm::RunnerMetrics;
+using ::executorch::extension::llm::TextDecoderRunner;
+using ::executorch::extension::llm::TextPrefiller;
+using ::executorch::runtime::Result;
+
+namespace {
+
+constexpr int32_t kVocabSize = 64;
+
+// A decoder whose most likely next token is always its input token + 1.
+// With fused_argmax, it returns the id of that token instead of the logits.
+class FakeTextDecoderRunner : public TextDecoderRunner {
+ public:
+  explicit FakeTextDecoderRunner(bool fused_argmax = false)
+      : TextDecoderRunner(
+            /*module=*/nullptr,
+            /*use_kv_cache=*/true,
+            kVocabSize,
+            /*temperature=*/0.0f),
+        fused_argmax_(fused_argmax) {}
+
+  bool is_method_loaded() override {
+    return true;
+  }
+
+  Result<executorch::aten::Tensor> step(
+      TensorPtr& tokens,
+      TensorPtr& start_pos) override {
+    const auto num_tokens = tokens->size(1);
+    const int64_t* token_data = tokens->const_data_ptr<int64_t>();
+    positions.push_back(start_pos->const_data_ptr<int64_t>()[0]);
+    num_inputs.push_back(num_tokens);
+
+    if (fused_argmax_) {
+      next_token_ = (token_data[num_tokens - 1] + 1) % kVocabSize;
+      next_token_tensor_ = from_blob(
+          &next_token_, {1, 1}, executorch::aten::ScalarType::Long);
+      return *next_token_tensor_;
+    }
+
+    logits_.assign(num_tokens * kVocabSize, 0.0f);
+    for (int64_t t = 0; t < num_tokens; ++t) {
+      logits_[t * kVocabSize + (token_data[t] + 1) % kVocabSize] = 1.0f;
+    }
+    logits_tensor_ = from_blob(logits_.data(), {1, num_tokens, kVocabSize});
+    return *logits_tensor_;
+  }
+
+  // The start position and number of tokens of every forward.
+  std::vector<int64_t> positions;
+  std::vector<int64_t> num_inputs;
+
+ private:
+  bool fused_argmax_;
+  std::vector<float> logits_;
+  TensorPtr logits_tensor_;
+  int64_t next_token_ = 0;
+  TensorPtr next_token_tensor_;
+};
+
+class TextPrefillerTest : public Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+
+  FakeTextDecoderRunner decoder_;
+};
+
+} // namespace
+
+TEST_F(TextPrefillerTest, ParallelPrefillRunsWholePrompt) {
+  TextPrefiller prefiller(
+      &decoder_, /*use_kv_cache=*/true, /*enable_parallel_prefill=*/true);
+  std::vector<uint64_t> prompt = {1, 2, 3, 4, 5};
+  int64_t start_pos = 0;
+
+  Result<uint64_t> next_token = prefiller.prefill(prompt, start_pos);
+  ASSERT_TRUE(next_token.ok());
+  EXPECT_EQ(next_token.get(), 6);
+  EXPECT_EQ(start_pos, 5);
+  EXPECT_EQ(decoder_.num_inputs, (std::vector<int64_t>{5}));
+}
+
+TEST_F(TextPrefillerTest, ChunkedPrefillRunsChunksInOrder) {
+  TextPrefiller prefiller(
+      &decoder_,
+      /*use_kv_cache=*/true,
+      /*enable_parallel_prefill=*/true,
+      /*max_chunk_size=*/4);
+  std::vector<uint64_t> prompt = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  int64_t start_pos = 3;
+
+  Result<uint64_t> next_token = prefiller.prefill(prompt, start_pos);
+  ASSERT_TRUE(next_token.ok());
+  // The next token follows the last chunk.
+  EXPECT_EQ(next_token.get(), 11);
+  EXPECT_EQ(start_pos, 13);
+  EXPECT_EQ(decoder_.positions, (std::vector<int64_t>{3, 7, 11}));
+  EXPECT_EQ(decoder_.num_inputs, (std::vector<int64_t>{4, 4, 2}));
+}
+
+TEST_F(TextPrefillerTest, PrefillReadsTokenOfFusedArgmax) {
+  FakeTextDecoderRunner decoder(/*fused_argmax=*/true);
+  TextPrefiller prefiller(
+      &decoder, /*use_kv_cache=*/true, /*enable_parallel_prefill=*/true);
+  std::vector<uint64_t> prompt = {1, 2, 3};
+  int64_t start_pos = 0;
+
+  Result<uint64_t> next_token = prefiller.prefill(prompt, start_pos);
+  ASSERT_TRUE(next_token.ok());
+  EXPECT_EQ(next_token.get(), 4);
+}
+
+TEST_F(TextPrefillerTest, RecordsMetrics) {
+  TextPrefiller prefiller(
+      &decoder_,
+      /*use_kv_cache=*/true,
+      /*enable_parallel_prefill=*/true,
+      /*max_chunk_size=*/4);
+  RunnerMetrics metrics;
+  prefiller.set_metrics(&metrics);
+  std::vector<uint64_t> prompt = {1, 2, 3, 4, 5, 6};
+  int64_t start_pos = 2;
+
+  ASSERT_TRUE(prefiller.prefill(prompt, start_pos).ok());
+  EXPECT_EQ(metrics.prefill_us.count(), 1);
+  EXPECT_EQ(metrics.prefill_execute_us.count(), 2);
+  EXPECT_EQ(metrics.prompt_tokens.load(), 6);
+  EXPECT_EQ(metrics.kv_cache_positions.load(), 8);
+  EXPECT_EQ(metrics.token_latency_us.count(), 0);
+}
@@ -11,6 +11,7 @@
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 
 #include <ctime>
+#include <numeric>
 
 #include <executorch/extension/llm/runner/stats.h>
 
@@ -32,7 +33,29 @@ TextDecoderRunner::TextDecoderRunner(
           temperature,
           kTopp,
           static_cast<unsigned long long>(std::time(nullptr)))),
-      use_kv_cache_(use_kv_cache) {}
+      use_kv_cache_(use_kv_cache),
+      vocab_size_(vocab_size) {}
+
+std::vector<::executorch::runtime::EValue> TextDecoderRunner::decoder_inputs(
+    std::vector<::executorch::runtime::EValue> inputs) {
+  if (!vocab_subset_input_) {
+    return inputs;
+  }
+  std::vector<int64_t>* token_ids = &allowed_tokens_;
+  if (allowed_tokens_.empty()) {
+    if (all_tokens_.size() != static_cast<size_t>(vocab_size_)) {
+      all_tokens_.resize(vocab_size_);
+      std::iota(all_tokens_.begin(), all_tokens_.end(), 0);
+    }
+    token_ids = &all_tokens_;
+  }
+  token_ids_ = from_blob(
+      token_ids->data(),
+      {static_cast<executorch::aten::SizesType>(token_ids->size())},
+      executorch::aten::ScalarType::Long);
+  inputs.emplace_back(token_ids_);
+  return inputs;
+}
 
 // This function is functional, meaning it shouldn't modify any state of the
 // input. It should be safe to call multiple times with the same inputs. The
@@ -42,11 +65,11 @@ TextDecoderRunner::TextDecoderRunner(
     TensorPtr& start_pos) {
   // ET_LOG(Info, "Input token %" PRIu64, input_token);
   if (use_kv_cache_) {
-    auto outputs_res = module_->forward({tokens, start_pos});
+    auto outputs_res = module_->forward(decoder_inputs({tokens, start_pos}));
     ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+    // Extra outputs, like the logits of self-drafting heads, are ignored.
     ET_CHECK_MSG(
-        outputs_res.get().size() == 1,
-        "More then one output returned from executing LLM.");
+        !outputs_res.get().empty(), "No output returned from executing LLM.");
     ET_CHECK_MSG(
         outputs_res.get()[0].isTensor(),
         "Non Tensor Output returned from executing LLM");
@@ -56,11 +79,11 @@ TextDecoderRunner::TextDecoderRunner(
   } else { // no kv cache
     (void)start_pos; // unused
 
-    auto outputs_res = module_->forward(tokens);
+    auto outputs_res = module_->forward(decoder_inputs({tokens}));
     ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+    // Extra outputs, like the logits of self-drafting heads, are ignored.
     ET_CHECK_MSG(
-        outputs_res.get().size() == 1,
-        "More then one output returned from executing LLM.");
+        !outputs_res.get().empty(), "No output returned from executing LLM.");
     ET_CHECK_MSG(
         outputs_res.get()[0].isTensor(),
         "Non Tensor Output returned from executing LLM");
@@ -70,6 +93,50 @@ TextDecoderRunner::TextDecoderRunner(
   }
 }
 
+::executorch::runtime::Result<std::vector<::executorch::runtime::EValue>>
+TextDecoderRunner::step_outputs(TensorPtr& tokens, TensorPtr& start_pos) {
+  ET_CHECK_OR_RETURN_ERROR(
+      use_kv_cache_,
+      NotSupported,
+      "Multi-output decoding needs a model with a KV cache");
+
+  auto outputs_res = module_->forward(decoder_inputs({tokens, start_pos}));
+  ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+  ET_CHECK_MSG(
+      !outputs_res.get().empty(), "No output returned from executing LLM.");
+  ET_CHECK_MSG(
+      outputs_res.get()[0].isTensor(),
+      "Non Tensor Output returned from executing LLM");
+
+  return outputs_res.get();
+}
+
+::executorch::runtime::Result<exec_aten::Tensor> TextDecoderRunner::step_batch(
+    TensorPtr& tokens,
+    TensorPtr& start_pos,
+    TensorPtr& cache_slots) {
+  ET_CHECK_OR_RETURN_ERROR(
+      use_kv_cache_,
+      NotSupported,
+      "Batched decoding needs a model with a KV cache");
+  ET_CHECK_OR_RETURN_ERROR(
+      !vocab_subset_input_,
+      NotSupported,
+      "Batched decoding does not support a vocab subset input");
+
+  auto outputs_res = module_->forward({tokens, start_pos, cache_slots});
+  ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+  ET_CHECK_MSG(
+      outputs_res.get().size() == 1,
+      "More then one output returned from executing LLM.");
+  ET_CHECK_MSG(
+      outputs_res.get()[0].isTensor(),
+      "Non Tensor Output returned from executing LLM");
+
+  // Return the logits tensor
+  return outputs_res.get()[0].toTensor();
+}
+
 } // namespace llm
 } // namespace extension
 } // namespace executorch
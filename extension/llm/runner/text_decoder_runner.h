@@ -15,6 +15,8 @@
 #include <executorch/extension/tensor/tensor.h>
 #include <executorch/runtime/platform/compiler.h>
 #include <functional>
+#include <limits>
+#include <vector>
 
 namespace executorch {
 namespace extension {
@@ -41,6 +43,36 @@ class ET_EXPERIMENTAL TextDecoderRunner {
       TensorPtr& input,
       TensorPtr& start_pos);
 
+  /**
+   * Like step(), but returns all of the outputs of the Module instead of just
+   * the logits, for models with extra outputs such as the logits of
+   * self-drafting heads. The Module must have a KV cache.
+   * @param input The input to the LLM Module.
+   * @param start_pos The starting position in KV cache of the input in the LLM
+   * Module.
+   * @return The outputs of the LLM Module, the first of which is a tensor of
+   * logits. They are valid until the Module runs again.
+   */
+  virtual ::executorch::runtime::Result<
+      std::vector<::executorch::runtime::EValue>>
+  step_outputs(TensorPtr& input, TensorPtr& start_pos);
+
+  /**
+   * Run LLM text decoder on the next token of every sequence in a batch. The
+   * Module must have a KV cache with a row for each cache slot.
+   * @param tokens The [batch_size, 1] input tokens, or the [1, seq_length]
+   * consecutive prompt tokens of one sequence for chunked prefill.
+   * @param start_pos The [batch_size] positions of the first input token of
+   * each row in its sequence.
+   * @param cache_slots The [batch_size] KV cache rows of the sequences.
+   * @return The output of the LLM Module. This will be a tensor of logits
+   * with batch_size rows.
+   */
+  virtual ::executorch::runtime::Result<executorch::aten::Tensor> step_batch(
+      TensorPtr& tokens,
+      TensorPtr& start_pos,
+      TensorPtr& cache_slots);
+
   /**
    * Load the Module for text decode purpose.
    * @return The error code.
@@ -61,6 +93,31 @@ class ET_EXPERIMENTAL TextDecoderRunner {
     should_stop_ = true;
   }
 
+  /**
+   * Set whether the forward of the Module takes, after its other inputs, a
+   * [num_tokens] Long tensor of the ids of the tokens to compute the logits
+   * of, as exported with replace_output_with_vocab_subset() of
+   * examples/models/llama/source_transformation/prune_vocab.py. Its logits
+   * then have num_tokens entries, in the order of the ids, instead of
+   * vocab_size.
+   * @param enabled Whether the Module takes the token ids.
+   */
+  inline void set_vocab_subset_input(bool enabled) {
+    vocab_subset_input_ = enabled;
+  }
+
+  /**
+   * Restrict sampling to the given tokens, e.g. those that a grammar or a
+   * set of class labels allows next. With a vocab subset input, only the
+   * logits of these tokens are computed in the first place. Can be changed
+   * between steps, e.g. from the token callback of the generator. An empty
+   * list allows every token.
+   * @param allowed_tokens The ids of the allowed tokens, in [0, vocab_size).
+   */
+  inline void set_allowed_tokens(std::vector<int64_t> allowed_tokens) {
+    allowed_tokens_ = std::move(allowed_tokens);
+  }
+
   /**
    * Sample the next token from the logits tensor.
    * @param logits_tensor The logits tensor.
@@ -68,6 +125,64 @@ class ET_EXPERIMENTAL TextDecoderRunner {
    */
   inline int32_t logits_to_token(
       const executorch::aten::Tensor& logits_tensor) {
+    return logits_to_token(logits_tensor, 0);
+  }
+
+  /**
+   * Sample a token from the logits of every input position, for verifying
+   * several tokens with one forward.
+   * @param logits_tensor The [1, seq_length, vocab_size] logits tensor, or
+   * the [1, seq_length] token ids of a Module with a fused argmax.
+   * @return The token that follows each input position.
+   */
+  inline std::vector<uint64_t> logits_to_tokens(
+      const executorch::aten::Tensor& logits_tensor) {
+    std::vector<uint64_t> result;
+    if (logits_tensor.scalar_type() == executorch::aten::ScalarType::Long) {
+      // A fused argmax already picked the token of every position.
+      const int64_t* tokens = logits_tensor.const_data_ptr<int64_t>();
+      for (ssize_t i = 0; i < logits_tensor.numel(); ++i) {
+        result.push_back(subset_index_to_token(tokens[i]));
+      }
+      return result;
+    }
+    ET_SWITCH_THREE_TYPES(
+        Float,
+        Half,
+        BFloat16,
+        logits_tensor.scalar_type(),
+        unused,
+        "logits_to_tokens",
+        CTYPE,
+        [&]() {
+          auto* logits = logits_tensor.mutable_data_ptr<CTYPE>();
+          const auto vocab_size = logits_tensor.size(logits_tensor.dim() - 1);
+          const auto num_tokens = logits_tensor.numel() / vocab_size;
+          result.reserve(num_tokens);
+          for (int64_t i = 0; i < num_tokens; ++i) {
+            result.push_back(sample(logits + i * vocab_size));
+          }
+        });
+    return result;
+  }
+
+  /**
+   * Sample the next token of one sequence from a batched logits tensor.
+   * @param logits_tensor The logits tensor.
+   * @param batch_index The row of the sequence in the batch.
+   * @return The next token.
+   */
+  inline int32_t logits_to_token(
+      const executorch::aten::Tensor& logits_tensor,
+      int64_t batch_index) {
+    if (logits_tensor.scalar_type() == executorch::aten::ScalarType::Long) {
+      // The Module was exported with a fused argmax, so it returns the
+      // [batch, 1] or [batch, seq_length] ids of the most likely tokens
+      // instead of their logits. Take the last one of the row.
+      const auto row_size = logits_tensor.numel() / logits_tensor.size(0);
+      return subset_index_to_token(logits_tensor.const_data_ptr<int64_t>()
+                                       [batch_index * row_size + row_size - 1]);
+    }
     int32_t result = 0;
     ET_SWITCH_THREE_TYPES(
         Float,
@@ -86,21 +201,70 @@ class ET_EXPERIMENTAL TextDecoderRunner {
             auto num_tokens = logits_tensor.size(1);
             auto vocab_size = logits_tensor.size(2);
             auto* logits_last = logits;
-            logits_last += (num_tokens - 1) * vocab_size;
-            result = sampler_->sample(logits_last);
+            logits_last += (batch_index * num_tokens + num_tokens - 1) *
+                vocab_size;
+            result = sample(logits_last);
           } else {
-            result = sampler_->sample(logits);
+            auto vocab_size = logits_tensor.size(logits_tensor.dim() - 1);
+            result = sample(logits + batch_index * vocab_size);
           }
         });
     return result;
   }
 
  protected:
+  // The inputs of forward for the given ones, with the ids of the tokens to
+  // compute the logits of appended if the Module takes them.
+  std::vector<::executorch::runtime::EValue> decoder_inputs(
+      std::vector<::executorch::runtime::EValue> inputs);
+
+  // Maps an index into the logits of a vocab subset input to its token.
+  inline int64_t subset_index_to_token(int64_t index) const {
+    return vocab_subset_input_ && !allowed_tokens_.empty()
+        ? allowed_tokens_[index]
+        : index;
+  }
+
+  // Samples one row of logits among the allowed tokens.
+  template <typename CTYPE>
+  int32_t sample(CTYPE* logits) {
+    if (allowed_tokens_.empty()) {
+      return sampler_->sample(logits);
+    }
+    // Sample over the whole vocabulary with every other token masked out, so
+    // that temperature, top-k and top-p apply to the allowed tokens alone.
+    constexpr float kMasked = -std::numeric_limits<float>::infinity();
+    restricted_logits_.assign(vocab_size_, kMasked);
+    for (size_t i = 0; i < allowed_tokens_.size(); ++i) {
+      const int64_t token = allowed_tokens_[i];
+      restricted_logits_[token] =
+          static_cast<float>(logits[vocab_subset_input_ ? i : token]);
+    }
+    int32_t token = sampler_->sample(restricted_logits_.data());
+    if (restricted_logits_[token] == kMasked) {
+      // The sampler falls back to its last token on rounding errors.
+      token = allowed_tokens_[0];
+      for (const int64_t allowed : allowed_tokens_) {
+        if (restricted_logits_[allowed] > restricted_logits_[token]) {
+          token = allowed;
+        }
+      }
+    }
+    return token;
+  }
+
   // TODO: use shared_ptr for module
   Module* module_;
   std::unique_ptr<Sampler> sampler_;
   bool use_kv_cache_;
   bool should_stop_{false};
+  int32_t vocab_size_;
+  bool vocab_subset_input_{false};
+  std::vector<int64_t> allowed_tokens_;
+  // Every token id, for a vocab subset input when no tokens are restricted.
+  std::vector<int64_t> all_tokens_;
+  TensorPtr token_ids_;
+  std::vector<float> restricted_logits_;
 };
 
 } // namespace llm
@@ -11,6 +11,8 @@
 
 #include <executorch/extension/llm/runner/text_prefiller.h>
 
+#include <algorithm>
+
 namespace executorch {
 namespace extension {
 namespace llm {
@@ -18,15 +20,26 @@ namespace llm {
 TextPrefiller::TextPrefiller(
     TextDecoderRunner* text_decoder_runner,
     bool use_kv_cache,
-    bool enable_parallel_prefill)
+    bool enable_parallel_prefill,
+    int64_t max_chunk_size)
     : text_decoder_runner_(text_decoder_runner),
       use_kv_cache_(use_kv_cache),
-      enable_parallel_prefill_(enable_parallel_prefill) {}
+      enable_parallel_prefill_(enable_parallel_prefill),
+      max_chunk_size_(max_chunk_size) {}
+
+::executorch::runtime::Result<executorch::aten::Tensor> TextPrefiller::step(
+    TensorPtr& tokens,
+    TensorPtr& start_pos) {
+  ScopedLatency execute(
+      metrics_ != nullptr ? &metrics_->prefill_execute_us : nullptr);
+  return text_decoder_runner_->step(tokens, start_pos);
+}
 
 ::executorch::runtime::Result<uint64_t> TextPrefiller::prefill(
     std::vector<uint64_t>& prompt_tokens,
     int64_t& start_pos) {
   ET_CHECK_MSG(!prompt_tokens.empty(), "Prompt cannot be null");
+  ScopedLatency latency(metrics_ != nullptr ? &metrics_->prefill_us : nullptr);
   if (!text_decoder_runner_->is_method_loaded()) {
     ET_CHECK_OK_OR_RETURN_ERROR(text_decoder_runner_->load());
   }
@@ -35,25 +48,42 @@ TextPrefiller::TextPrefiller(
   int32_t num_prompt_tokens = prompt_tokens.size();
 
   // store the token
-  uint64_t cur_token;
+  uint64_t cur_token = 0;
   if (enable_parallel_prefill_ || !use_kv_cache_) {
-    // initialize tensor wrappers
-    auto tokens = from_blob(
-        prompt_tokens.data(),
-        {1, num_prompt_tokens},
-        exec_aten::ScalarType::Long);
-
-    auto start_pos_tensor =
-        from_blob(&start_pos, {1}, exec_aten::ScalarType::Long);
-
-    auto outputs_res = text_decoder_runner_->step(tokens, start_pos_tensor);
-
-    ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
-    ET_LOG(
-        Info, "Prefill token result numel(): %zu", outputs_res.get().numel());
-
-    start_pos += num_prompt_tokens;
-    cur_token = text_decoder_runner_->logits_to_token(outputs_res.get());
+    // Without a KV cache, every forward has to see the whole prompt.
+    const int32_t chunk_size = max_chunk_size_ > 0 && use_kv_cache_
+        ? std::min<int64_t>(max_chunk_size_, num_prompt_tokens)
+        : num_prompt_tokens;
+
+    // Every chunk reuses the memory planned for the Module, and its logits
+    // are overwritten by the next one, so only the last chunk's are sampled.
+    for (int32_t offset = 0; offset < num_prompt_tokens;
+         offset += chunk_size) {
+      const int32_t num_chunk_tokens =
+          std::min(chunk_size, num_prompt_tokens - offset);
+
+      // initialize tensor wrappers
+      auto tokens = from_blob(
+          prompt_tokens.data() + offset,
+          {1, num_chunk_tokens},
+          exec_aten::ScalarType::Long);
+
+      auto start_pos_tensor =
+          from_blob(&start_pos, {1}, exec_aten::ScalarType::Long);
+
+      auto outputs_res = step(tokens, start_pos_tensor);
+
+      ET_CHECK_OK_OR_RETURN_ERROR(outputs_res.error());
+      ET_LOG(
+          Info,
+          "Prefill token result numel(): %zu",
+          outputs_res.get().numel());
+
+      start_pos += num_chunk_tokens;
+      if (offset + num_chunk_tokens == num_prompt_tokens) {
+        cur_token = text_decoder_runner_->logits_to_token(outputs_res.get());
+      }
+    }
   } else { // sequential prefill
     int64_t pos = 0; // position in the sequence
     // NOLINTNEXTLINE(facebook-hte-ParameterUncheckedArrayBounds)
@@ -68,7 +98,7 @@ TextPrefiller::TextPrefiller(
     // run the first token and get back logits tensor. Assuming the first token
     // is bos so don't callback.
     auto logits_tensor =
-        ET_UNWRAP(text_decoder_runner_->step(tokens, start_pos_tensor));
+        ET_UNWRAP(step(tokens, start_pos_tensor));
 
     pos += 1; // start the loop from index 1
     start_pos += 1;
@@ -79,7 +109,7 @@ TextPrefiller::TextPrefiller(
       cur_token = prompt_tokens[pos];
 
       logits_tensor =
-          ET_UNWRAP(text_decoder_runner_->step(tokens, start_pos_tensor));
+          ET_UNWRAP(step(tokens, start_pos_tensor));
 
       pos++;
       start_pos++;
@@ -87,6 +117,11 @@ TextPrefiller::TextPrefiller(
 
     cur_token = text_decoder_runner_->logits_to_token(logits_tensor);
   }
+  if (metrics_ != nullptr) {
+    metrics_->prompt_tokens.fetch_add(
+        num_prompt_tokens, std::memory_order_relaxed);
+    metrics_->kv_cache_positions.store(start_pos, std::memory_order_relaxed);
+  }
   return cur_token;
 }
 
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <executorch/extension/llm/runner/metrics.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
 #include <functional>
@@ -21,10 +22,22 @@ namespace llm {
 
 class ET_EXPERIMENTAL TextPrefiller {
  public:
+  /**
+   * @param text_decoder_runner The decoder to prefill.
+   * @param use_kv_cache_ Whether the LLM Module has a KV cache.
+   * @param enable_parallel_prefill Whether to run several prompt tokens per
+   * forward.
+   * @param max_chunk_size The most prompt tokens to run per forward of
+   * parallel prefill. Longer prompts are run in chunks, one after the other,
+   * so the Module only has to plan memory for a chunk instead of the whole
+   * sequence. The whole prompt is run at once if this is not positive. Needs
+   * a KV cache.
+   */
   TextPrefiller(
       TextDecoderRunner* text_decoder_runner,
       bool use_kv_cache_,
-      bool enable_parallel_prefill);
+      bool enable_parallel_prefill,
+      int64_t max_chunk_size = -1);
   /**
    * Prefill an LLM Module with the given text input.
    * @param prompt_tokens The text prompt tokens to the LLM Module. Encoded by
@@ -37,10 +50,25 @@ class ET_EXPERIMENTAL TextPrefiller {
       std::vector<uint64_t>& prompt_tokens,
       int64_t& start_pos);
 
+  /**
+   * Record the latency of every prefill, and of the forwards it runs, into
+   * metrics. Nothing is recorded if it's null, which is the default.
+   * @param metrics The metrics to record into. Must outlive the prefiller.
+   */
+  void set_metrics(RunnerMetrics* metrics) {
+    metrics_ = metrics;
+  }
+
  private:
+  ::executorch::runtime::Result<executorch::aten::Tensor> step(
+      TensorPtr& tokens,
+      TensorPtr& start_pos);
+
   TextDecoderRunner* text_decoder_runner_;
   bool use_kv_cache_;
   bool enable_parallel_prefill_;
+  int64_t max_chunk_size_;
+  RunnerMetrics* metrics_ = nullptr;
 };
 
 } // namespace llm
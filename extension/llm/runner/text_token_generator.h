@@ -9,8 +9,10 @@
 // Generate tokens in a loop.
 #pragma once
 
+#include <executorch/extension/llm/runner/metrics.h>
 #include <executorch/extension/llm/runner/stats.h>
 #include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/tokenizer/streaming_decoder.h>
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
 #include <executorch/extension/tensor/tensor.h>
 
@@ -27,6 +29,7 @@ class ET_EXPERIMENTAL TextTokenGenerator {
       std::unique_ptr<std::unordered_set<uint64_t>>&& eos_ids,
       Stats* stats)
       : tokenizer_(tokenizer),
+        streaming_decoder_(tokenizer),
         text_decoder_runner_(text_decoder_runner),
         eos_ids_(std::move(eos_ids)),
         use_kv_cache_(use_kv_cache),
@@ -40,7 +43,8 @@ class ET_EXPERIMENTAL TextTokenGenerator {
    * prompt tokens is prefilled.
    * @param seq_len the total sequence length, including the prompt tokens, next
    * token from prefill and new tokens.
-   * @param token_callback what to do after a token is generated.
+   * @param token_callback what to do with the text of the generated tokens.
+   * It is called after each token that completes a UTF-8 character.
    * @return how many tokens are generated.
    */
   inline ::executorch::runtime::Result<int64_t> generate(
@@ -76,23 +80,35 @@ class ET_EXPERIMENTAL TextTokenGenerator {
         from_blob(&pos, {1}, executorch::aten::ScalarType::Long);
 
     should_stop_ = false;
+    streaming_decoder_.reset();
 
     // Generate our tokens
     while (pos < seq_len - 1) {
+      ScopedLatency token_latency(histogram(&RunnerMetrics::token_latency_us));
+
       // Run the model
-      auto logits_res =
-          text_decoder_runner_->step(tokens_managed, start_pos_managed);
+      auto logits_res = [&]() {
+        ScopedLatency execute(histogram(&RunnerMetrics::model_execute_us));
+        return text_decoder_runner_->step(tokens_managed, start_pos_managed);
+      }();
 
       ET_CHECK_OK_OR_RETURN_ERROR(logits_res.error());
       executorch::aten::Tensor& logits_tensor = logits_res.get();
 
       prev_token = cur_token;
 
-      stats_->on_sampling_begin();
-      cur_token = text_decoder_runner_->logits_to_token(logits_tensor);
-      stats_->on_sampling_end();
+      {
+        ScopedLatency sampling(histogram(&RunnerMetrics::sampling_us));
+        stats_->on_sampling_begin();
+        cur_token = text_decoder_runner_->logits_to_token(logits_tensor);
+        stats_->on_sampling_end();
+      }
 
       pos++;
+      if (metrics_ != nullptr) {
+        metrics_->generated_tokens.fetch_add(1, std::memory_order_relaxed);
+        metrics_->kv_cache_positions.store(pos, std::memory_order_relaxed);
+      }
 
       if (use_kv_cache_) {
         // update the token tensor. token_data will not be empty.
@@ -106,7 +122,15 @@ class ET_EXPERIMENTAL TextTokenGenerator {
       }
 
       // print the token as string, decode it with the Tokenizer object
-      token_callback(ET_UNWRAP(tokenizer_->decode(prev_token, cur_token)));
+      {
+        ScopedLatency detokenize(histogram(&RunnerMetrics::detokenize_us));
+        ET_CHECK_OK_OR_RETURN_ERROR(
+            streaming_decoder_.decode(prev_token, cur_token, text_));
+      }
+      if (!text_.empty()) {
+        ScopedLatency callback(histogram(&RunnerMetrics::callback_us));
+        token_callback(text_);
+      }
 
       if (should_stop_) {
         break;
@@ -119,6 +143,10 @@ class ET_EXPERIMENTAL TextTokenGenerator {
         break;
       }
     }
+    streaming_decoder_.flush(text_);
+    if (!text_.empty()) {
+      token_callback(text_);
+    }
     return pos - start_pos;
   }
 
@@ -129,8 +157,24 @@ class ET_EXPERIMENTAL TextTokenGenerator {
     should_stop_ = true;
   }
 
+  /**
+   * Record the latency of every generated token, and of its phases, into
+   * metrics. Nothing is recorded if it's null, which is the default.
+   * @param metrics The metrics to record into. Must outlive the generator.
+   */
+  inline void set_metrics(RunnerMetrics* metrics) {
+    metrics_ = metrics;
+  }
+
  private:
+  inline LatencyHistogram* histogram(LatencyHistogram RunnerMetrics::*member) {
+    return metrics_ != nullptr ? &(metrics_->*member) : nullptr;
+  }
+
   Tokenizer* tokenizer_;
+  StreamingDecoder streaming_decoder_;
+  // The text of the latest token, reused across tokens.
+  std::string text_;
   TextDecoderRunner* text_decoder_runner_;
   std::unique_ptr<std::unordered_set<uint64_t>> eos_ids_;
   bool use_kv_cache_;
@@ -140,6 +184,7 @@ class ET_EXPERIMENTAL TextTokenGenerator {
 
   // stats
   Stats* stats_;
+  RunnerMetrics* metrics_ = nullptr;
 };
 
 } // namespace llm
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Propose tokens for speculative decoding.
+
+#include <executorch/extension/llm/runner/token_drafter.h>
+
+#include <algorithm>
+
+#include <executorch/extension/tensor/tensor.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+using ::executorch::runtime::EValue;
+using ::executorch::runtime::Result;
+
+DraftModelDrafter::DraftModelDrafter(
+    TextDecoderRunner* draft_decoder_runner,
+    bool enable_parallel_prefill)
+    : draft_decoder_runner_(draft_decoder_runner),
+      prefiller_(
+          draft_decoder_runner,
+          /*use_kv_cache=*/true,
+          enable_parallel_prefill) {}
+
+Result<std::vector<uint64_t>> DraftModelDrafter::draft(
+    const std::vector<uint64_t>& tokens,
+    int32_t max_tokens) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !tokens.empty(), InvalidArgument, "Cannot draft for an empty sequence");
+  if (max_tokens <= 0) {
+    return std::vector<uint64_t>();
+  }
+
+  // Keep the cached positions that still match the sequence, but rerun at
+  // least the last token to get the logits that follow it.
+  const size_t max_cached =
+      std::min(cached_tokens_.size(), tokens.size() - 1);
+  const size_t num_cached = std::mismatch(
+                                cached_tokens_.begin(),
+                                cached_tokens_.begin() + max_cached,
+                                tokens.begin())
+                                .first -
+      cached_tokens_.begin();
+  cached_tokens_.resize(num_cached);
+
+  std::vector<uint64_t> pending(tokens.begin() + num_cached, tokens.end());
+  int64_t pos = num_cached;
+  uint64_t cur_token = ET_UNWRAP(prefiller_.prefill(pending, pos));
+  cached_tokens_.insert(cached_tokens_.end(), pending.begin(), pending.end());
+
+  std::vector<uint64_t> result = {cur_token};
+  auto tokens_managed =
+      from_blob(&cur_token, {1, 1}, executorch::aten::ScalarType::Long);
+  auto start_pos_managed =
+      from_blob(&pos, {1}, executorch::aten::ScalarType::Long);
+  while (result.size() < static_cast<size_t>(max_tokens)) {
+    auto logits_tensor = ET_UNWRAP(
+        draft_decoder_runner_->step(tokens_managed, start_pos_managed));
+    cached_tokens_.push_back(cur_token);
+    pos++;
+    cur_token = draft_decoder_runner_->logits_to_token(logits_tensor);
+    result.push_back(cur_token);
+  }
+  return result;
+}
+
+NgramDrafter::NgramDrafter(int32_t max_ngram_size, int32_t min_ngram_size)
+    : max_ngram_size_(max_ngram_size),
+      min_ngram_size_(std::max<int32_t>(1, min_ngram_size)) {}
+
+Result<std::vector<uint64_t>> NgramDrafter::draft(
+    const std::vector<uint64_t>& tokens,
+    int32_t max_tokens) {
+  const int64_t size = tokens.size();
+  if (max_tokens <= 0) {
+    return std::vector<uint64_t>();
+  }
+  for (int64_t n = std::min<int64_t>(max_ngram_size_, size - 1);
+       n >= min_ngram_size_;
+       --n) {
+    const auto suffix = tokens.end() - n;
+    // The latest occurrence is the most likely to continue the same way.
+    for (int64_t start = size - n - 1; start >= 0; --start) {
+      if (std::equal(suffix, tokens.end(), tokens.begin() + start)) {
+        const int64_t begin = start + n;
+        const int64_t end = std::min<int64_t>(begin + max_tokens, size);
+        return std::vector<uint64_t>(
+            tokens.begin() + begin, tokens.begin() + end);
+      }
+    }
+  }
+  return std::vector<uint64_t>();
+}
+
+Result<std::vector<uint64_t>> MedusaDrafter::draft(
+    const std::vector<uint64_t>& tokens,
+    int32_t max_tokens) {
+  (void)tokens;
+  std::vector<uint64_t> result = std::move(proposal_);
+  proposal_.clear();
+  if (result.size() > static_cast<size_t>(std::max<int32_t>(max_tokens, 0))) {
+    result.resize(std::max<int32_t>(max_tokens, 0));
+  }
+  return result;
+}
+
+void MedusaDrafter::on_target_outputs(
+    const std::vector<EValue>& outputs,
+    int64_t position) {
+  proposal_.clear();
+  for (size_t i = 1; i < outputs.size() && outputs[i].isTensor(); ++i) {
+    const auto& head_logits = outputs[i].toTensor();
+    const auto vocab_size = head_logits.size(head_logits.dim() - 1);
+    const auto num_rows = head_logits.numel() / vocab_size;
+    const int64_t row = num_rows == 1 ? 0 : position;
+    if (row >= num_rows) {
+      break;
+    }
+    uint64_t token = 0;
+    ET_SWITCH_THREE_TYPES(
+        Float,
+        Half,
+        BFloat16,
+        head_logits.scalar_type(),
+        unused,
+        "MedusaDrafter",
+        CTYPE,
+        [&]() {
+          const CTYPE* logits =
+              head_logits.const_data_ptr<CTYPE>() + row * vocab_size;
+          token = std::max_element(logits, logits + vocab_size) - logits;
+        });
+    proposal_.push_back(token);
+  }
+}
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
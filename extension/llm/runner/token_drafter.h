@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Propose tokens for speculative decoding.
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <executorch/extension/llm/runner/text_decoder_runner.h>
+#include <executorch/extension/llm/runner/text_prefiller.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Proposes the tokens that are likely to follow a sequence, for the target
+ * model of a SpeculativeTokenGenerator to verify with one forward.
+ */
+class ET_EXPERIMENTAL TokenDrafter {
+ public:
+  virtual ~TokenDrafter() = default;
+
+  /**
+   * @param tokens All tokens of the sequence so far.
+   * @param max_tokens How many tokens to propose at most.
+   * @return The proposed tokens, which may be fewer than max_tokens or none.
+   */
+  virtual ::executorch::runtime::Result<std::vector<uint64_t>> draft(
+      const std::vector<uint64_t>& tokens,
+      int32_t max_tokens) = 0;
+
+  /**
+   * Called with the outputs of every verification forward of the target
+   * model, which are only valid during the call.
+   * @param outputs The outputs of the target model.
+   * @param position The input position whose logits produced the last token
+   * that was committed.
+   */
+  virtual void on_target_outputs(
+      const std::vector<::executorch::runtime::EValue>& outputs,
+      int64_t position) {
+    (void)outputs;
+    (void)position;
+  }
+};
+
+/**
+ * Drafts with a smaller model that shares the tokenizer of the target model.
+ * Keeps track of which tokens are in the KV cache of the draft model, so
+ * after a rejection it only reruns the tokens that changed, starting at
+ * their position.
+ */
+class ET_EXPERIMENTAL DraftModelDrafter : public TokenDrafter {
+ public:
+  /**
+   * @param draft_decoder_runner Runs the draft model, which must have a KV
+   * cache.
+   * @param enable_parallel_prefill Whether the draft model accepts several
+   * tokens per forward, to catch up on the committed tokens at once.
+   */
+  DraftModelDrafter(
+      TextDecoderRunner* draft_decoder_runner,
+      bool enable_parallel_prefill);
+
+  ::executorch::runtime::Result<std::vector<uint64_t>> draft(
+      const std::vector<uint64_t>& tokens,
+      int32_t max_tokens) override;
+
+ private:
+  TextDecoderRunner* draft_decoder_runner_;
+  TextPrefiller prefiller_;
+  // The tokens at positions 0, 1, ... of the draft model's KV cache.
+  std::vector<uint64_t> cached_tokens_;
+};
+
+/**
+ * Self-drafting by prompt lookup: finds the latest earlier occurrence of the
+ * last tokens of the sequence and proposes the tokens that followed it. Costs
+ * no model calls, and does well when the output repeats its input, like in
+ * summaries, code edits and retrieval answers.
+ */
+class ET_EXPERIMENTAL NgramDrafter : public TokenDrafter {
+ public:
+  /**
+   * @param max_ngram_size The longest suffix to look up. Shorter ones are
+   * tried when it is not found, down to min_ngram_size.
+   * @param min_ngram_size The shortest suffix to look up.
+   */
+  explicit NgramDrafter(
+      int32_t max_ngram_size = 3,
+      int32_t min_ngram_size = 1);
+
+  ::executorch::runtime::Result<std::vector<uint64_t>> draft(
+      const std::vector<uint64_t>& tokens,
+      int32_t max_tokens) override;
+
+ private:
+  int32_t max_ngram_size_;
+  int32_t min_ngram_size_;
+};
+
+/**
+ * Self-drafting with Medusa-style heads. The target model returns the logits
+ * of its extra heads after the logits of the next token: where output 0
+ * holds the logits of the token after each input position, output i holds
+ * those of the token i + 1 positions after it, in the same
+ * [1, seq_length, vocab_size] or [1, vocab_size] shape. The draft is the most
+ * likely token of each head at the input position that produced the last
+ * committed token, so it comes for free with every verification.
+ */
+class ET_EXPERIMENTAL MedusaDrafter : public TokenDrafter {
+ public:
+  ::executorch::runtime::Result<std::vector<uint64_t>> draft(
+      const std::vector<uint64_t>& tokens,
+      int32_t max_tokens) override;
+
+  void on_target_outputs(
+      const std::vector<::executorch::runtime::EValue>& outputs,
+      int64_t position) override;
+
+ private:
+  // The proposal for the token after the last committed one.
+  std::vector<uint64_t> proposal_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
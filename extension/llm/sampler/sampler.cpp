@@ -33,161 +33,251 @@
  */
 
 #include <executorch/extension/llm/sampler/sampler.h>
+
 #include <algorithm>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 
 namespace executorch {
 namespace extension {
 namespace llm {
 
+namespace {
+
+using Vec = ::executorch::vec::Vectorized<float>;
+
+// The number of candidates to sort first during top-p truncation. Most of the
+// probability mass is usually in far fewer tokens than the vocabulary.
+constexpr size_t kTopPInitialSortSize = 64;
+
+unsigned int random_u32(unsigned long long* state) {
+  // xorshift rng: https://en.wikipedia.org/wiki/Xorshift#xorshift.2A
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return (*state * 0x2545F4914F6CDD1Dull) >> 32;
+}
+
+float random_f32(unsigned long long* state) { // random float32 in [0,1)
+  return (random_u32(state) >> 8) / 16777216.0f;
+}
+
+} // namespace
+
+Sampler::Sampler(
+    int vocab_size,
+    float temperature,
+    float topp,
+    unsigned long long rng_seed,
+    int32_t topk,
+    float minp)
+    : vocab_size_(vocab_size),
+      inv_temperature_(static_cast<bool>(temperature) ? 1.0f / temperature : 0),
+      topp_(topp),
+      topk_(topk),
+      minp_(minp),
+      rng_state_(rng_seed) {
+  if (inv_temperature_ != 0.0f) {
+    probs_.resize(vocab_size_);
+    candidates_.resize(vocab_size_);
+  }
+}
+
 // sampler stuff
 template <typename T>
-int32_t Sampler::sample_argmax(T* probabilities) {
+int32_t Sampler::sample_argmax(const T* logits) {
+  if constexpr (std::is_same_v<T, float>) {
+    // Find the max with SIMD, then the first token that has it.
+    const float max_val = ::executorch::vec::reduce_all<float>(
+        [](Vec x, Vec y) { return ::executorch::vec::maximum(x, y); },
+        logits,
+        vocab_size_);
+    const float* max_it = std::find(logits, logits + vocab_size_, max_val);
+    if (max_it != logits + vocab_size_) {
+      return max_it - logits;
+    }
+    // A NaN logit makes the max NaN, which no token compares equal to. Fall
+    // back to the scan below, which skips NaNs after the first token.
+  }
   // return the index that has the highest probability
   int max_i = 0;
-  T max_p = probabilities[0];
+  T max_p = logits[0];
   for (int i = 1; i < vocab_size_; i++) {
-    if (probabilities[i] > max_p) {
+    if (logits[i] > max_p) {
       max_i = i;
-      max_p = probabilities[i];
+      max_p = logits[i];
     }
   }
   return max_i;
 }
 
 template <typename T>
-int32_t Sampler::sample_mult(T* probabilities, float coin) {
-  // sample index from probabilities (they must sum to 1!)
+float Sampler::compute_weights(const T* logits) {
+  float* probs = probs_.data();
+  const int64_t n = vocab_size_;
+  const float inv_temperature = inv_temperature_;
+
+  // Apply the temperature while copying the logits to the workspace.
+  if constexpr (std::is_same_v<T, float>) {
+    ::executorch::vec::map<float>(
+        [inv_temperature](Vec x) { return x * Vec(inv_temperature); },
+        probs,
+        logits,
+        n);
+  } else {
+    for (int64_t i = 0; i < n; ++i) {
+      probs[i] = static_cast<float>(logits[i]) * inv_temperature;
+    }
+  }
+
+  // find max value (for numerical stability)
+  const float max_val = ::executorch::vec::reduce_all<float>(
+      [](Vec x, Vec y) { return ::executorch::vec::maximum(x, y); },
+      probs,
+      n);
+
+  // exp and sum. The weights are not normalized, the samplers scale their
+  // random number by the sum instead.
+  const Vec max_vec(max_val);
+  Vec sum_vec(0.0f);
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    const Vec weights = (Vec::loadu(probs + i) - max_vec).exp();
+    weights.store(probs + i);
+    sum_vec = sum_vec + weights;
+  }
+  float sum = ::executorch::vec::vec_reduce_all<float>(
+      [](Vec x, Vec y) { return x + y; }, sum_vec);
+  for (; i < n; ++i) {
+    probs[i] = std::exp(probs[i] - max_val);
+    sum += probs[i];
+  }
+  return sum;
+}
+
+int32_t Sampler::sample_mult(float total, float coin) {
+  // sample index from the weights, which sum to total
   // coin is a random number in [0, 1), usually from random_f32()
-  T cdf = 0.0;
+  const float* probs = probs_.data();
+  const float r = coin * total;
+  float cdf = 0.0f;
   for (int i = 0; i < vocab_size_; i++) {
-    cdf += probabilities[i];
-    if (coin < cdf) {
+    cdf += probs[i];
+    if (r < cdf) {
       return i;
     }
   }
   return vocab_size_ - 1; // in case of rounding errors
 }
 
-template <typename T>
-int32_t Sampler::sample_topp(T* probabilities, float coin) {
-  // top-p sampling (or "nucleus sampling") samples from the smallest set of
-  // tokens that exceed probability topp. This way we never sample tokens that
-  // have very low probabilities and are less likely to go "off the rails".
-  // coin is a random number in [0, 1), usually from random_f32()
-  int n = vocab_size_;
-  int n0 = 0;
-  // quicksort indices in descending order of probabilities
-  // values smaller than (1 - topp) / (n - 1) cannot be part of the result
-  // so for efficiency we crop these out as candidates before sorting
-  std::unique_ptr<ProbIndex<T>[]> probindex =
-      std::make_unique<ProbIndex<T>[]>(vocab_size_);
-
-  const float cutoff = (1.0f - topp_) / (n - 1);
-  for (int i = 0; i < n; i++) {
-    if (probabilities[i] >= cutoff) {
-      probindex[n0].index = i;
-      probindex[n0].prob = probabilities[i];
-      n0++;
+int32_t Sampler::sample_truncated(float total, float coin) {
+  const float* probs = probs_.data();
+  int32_t* candidates = candidates_.data();
+  const bool use_topk = topk_ > 0 && topk_ < vocab_size_;
+  const bool use_topp = topp_ > 0 && topp_ < 1;
+
+  // min-p is relative to the most likely token, whose weight is 1.
+  float threshold = minp_ > 0 ? minp_ : 0.0f;
+  if (use_topp && !use_topk && threshold == 0.0f && vocab_size_ > 1) {
+    // values smaller than (1 - topp) / (n - 1) cannot be part of the top-p
+    // result, so for efficiency we crop these out as candidates
+    threshold = (1.0f - topp_) * total / (vocab_size_ - 1);
+  }
+  // Always keep the most likely token.
+  threshold = std::min(threshold, 1.0f);
+
+  int32_t num_candidates = 0;
+  for (int32_t i = 0; i < vocab_size_; i++) {
+    if (probs[i] >= threshold) {
+      candidates[num_candidates++] = i;
     }
   }
 
-  auto compare = [](const ProbIndex<T>& a, const ProbIndex<T>& b) {
-    return a.prob > b.prob;
+  auto more_likely = [probs](int32_t a, int32_t b) {
+    return probs[a] > probs[b];
   };
-  std::sort(probindex.get(), probindex.get() + n0, compare);
-
-  // truncate the list where cumulative probability exceeds topp
-  T cumulative_prob = 0;
-  int last_idx = n0 - 1; // in case of rounding errors consider all elements
-  for (int i = 0; i < n0; i++) {
-    cumulative_prob += probindex[i].prob;
-    if (cumulative_prob > topp_) {
-      last_idx = i;
-      break; // we've exceeded topp by including last_idx
+  if (use_topk && num_candidates > topk_) {
+    std::nth_element(
+        candidates,
+        candidates + topk_ - 1,
+        candidates + num_candidates,
+        more_likely);
+    num_candidates = topk_;
+  }
+
+  float mass = 0.0f;
+  for (int32_t i = 0; i < num_candidates; i++) {
+    mass += probs[candidates[i]];
+  }
+
+  if (use_topp) {
+    // Sort the candidates in descending order of probability only as far as
+    // needed to exceed topp, doubling the sorted prefix each time.
+    const float target = topp_ * mass;
+    float cumulative = 0.0f;
+    int32_t last = num_candidates - 1; // in case of rounding errors
+    size_t sorted = 0;
+    bool found = false;
+    while (!found && sorted < static_cast<size_t>(num_candidates)) {
+      const size_t next = std::min<size_t>(
+          num_candidates, std::max(kTopPInitialSortSize, 2 * sorted));
+      std::partial_sort(
+          candidates + sorted,
+          candidates + next,
+          candidates + num_candidates,
+          more_likely);
+      for (; sorted < next; ++sorted) {
+        cumulative += probs[candidates[sorted]];
+        if (cumulative > target) {
+          last = sorted;
+          found = true;
+          break; // we've exceeded topp by including last
+        }
+      }
     }
+    num_candidates = last + 1;
+    mass = found ? cumulative : mass;
   }
 
   // sample from the truncated list
-  const T& r = coin * cumulative_prob;
-  T cdf = 0;
-  for (int i = 0; i <= last_idx; i++) {
-    cdf += probindex[i].prob;
+  const float r = coin * mass;
+  float cdf = 0.0f;
+  for (int32_t i = 0; i < num_candidates; i++) {
+    cdf += probs[candidates[i]];
     if (r < cdf) {
-      return probindex[i].index;
+      return candidates[i];
     }
   }
-  return probindex[last_idx].index; // in case of rounding errors
+  return candidates[num_candidates - 1]; // in case of rounding errors
 }
 
-Sampler::Sampler(
-    int vocab_size,
-    float temperature,
-    float topp,
-    unsigned long long rng_seed)
-    : vocab_size_(vocab_size),
-      inv_temperature_(static_cast<bool>(temperature) ? 1.0f / temperature : 0),
-      topp_(topp),
-      rng_state_(rng_seed) {}
-
 template <typename T>
-static void softmax(T* x, int size) {
-  // find max value (for numerical stability)
-  T max_val = x[0];
-  for (int i = 1; i < size; i++) {
-    if (x[i] > max_val) {
-      max_val = x[i];
-    }
-  }
-  // exp and sum
-  T sum = 0;
-  for (int i = 0; i < size; i++) {
-    x[i] = expf(x[i] - max_val);
-    sum += x[i];
+int32_t Sampler::sample(T* logits) {
+  // sample the token given the logits and some hyperparameters
+  if (inv_temperature_ == 0.0f) {
+    // greedy argmax sampling: take the token with the highest probability
+    return sample_argmax(logits);
   }
-  // normalize
-  for (int i = 0; i < size; i++) {
-    x[i] /= sum;
+  const float total = compute_weights(logits);
+  // flip a (float) coin (this is our source of entropy for sampling)
+  const float coin = random_f32(&rng_state_);
+  const bool truncate =
+      (topp_ > 0 && topp_ < 1) || (topk_ > 0 && topk_ < vocab_size_) ||
+      minp_ > 0;
+  if (!truncate) {
+    // simply sample from the predicted probability distribution
+    return sample_mult(total, coin);
   }
-}
-
-static unsigned int random_u32(unsigned long long* state) {
-  // xorshift rng: https://en.wikipedia.org/wiki/Xorshift#xorshift.2A
-  *state ^= *state >> 12;
-  *state ^= *state << 25;
-  *state ^= *state >> 27;
-  return (*state * 0x2545F4914F6CDD1Dull) >> 32;
-}
-
-static float random_f32(unsigned long long* state) { // random float32 in [0,1)
-  return (random_u32(state) >> 8) / 16777216.0f;
+  return sample_truncated(total, coin);
 }
 
 template <typename T>
-int32_t Sampler::sample(T* logits) {
-  // sample the token given the logits and some hyperparameters
-  int next;
-  if (inv_temperature_ == 0.0f) {
-    // greedy argmax sampling: take the token with the highest probability
-    next = sample_argmax(logits);
-  } else {
-    // apply the temperature to the logits
-    for (int q = 0; q < vocab_size_; q++) {
-      logits[q] *= inv_temperature_;
-    }
-    // apply softmax to the logits to get the probabilities for next token
-    softmax(logits, vocab_size_);
-    // flip a (float) coin (this is our source of entropy for sampling)
-    float coin = random_f32(&rng_state_);
-    // we sample from this distribution to get the next token
-    if (topp_ <= 0 || topp_ >= 1) {
-      // simply sample from the predicted probability distribution
-      next = sample_mult(logits, coin);
-    } else {
-      // top-p (nucleus) sampling, clamping the least likely tokens to zero
-      next = sample_topp(logits, coin);
-    }
+void Sampler::sample_batch(T* logits, int32_t batch_size, int32_t* tokens) {
+  for (int32_t b = 0; b < batch_size; ++b) {
+    tokens[b] = sample(logits + static_cast<int64_t>(b) * vocab_size_);
   }
-  return next;
 }
 
 template int32_t Sampler::sample<float>(float* logits);
@@ -195,6 +285,19 @@ template int32_t Sampler::sample<exec_aten::Half>(exec_aten::Half* logits);
 template int32_t Sampler::sample<exec_aten::BFloat16>(
     exec_aten::BFloat16* logits);
 
+template void Sampler::sample_batch<float>(
+    float* logits,
+    int32_t batch_size,
+    int32_t* tokens);
+template void Sampler::sample_batch<exec_aten::Half>(
+    exec_aten::Half* logits,
+    int32_t batch_size,
+    int32_t* tokens);
+template void Sampler::sample_batch<exec_aten::BFloat16>(
+    exec_aten::BFloat16* logits,
+    int32_t batch_size,
+    int32_t* tokens);
+
 } // namespace llm
 } // namespace extension
 } // namespace executorch
@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <vector>
 #ifdef USE_ATEN_LIB
 #include <torch/torch.h>
 #endif
@@ -32,31 +33,72 @@ struct ET_EXPERIMENTAL ProbIndex {
   int32_t index;
 }; // struct used when sorting probabilities during top-p sampling
 
+/**
+ * Samples the next token from the logits of an LLM. Greedy (argmax) when the
+ * temperature is 0. Otherwise samples from softmax(logits / temperature),
+ * optionally restricted to the topk most likely tokens, to the tokens whose
+ * probability is at least minp times that of the most likely one, and to the
+ * smallest set of the remaining tokens whose probability exceeds topp, in that
+ * order.
+ *
+ * All scratch memory is allocated at construction, and the logits are left
+ * unchanged. Not thread safe.
+ */
 class ET_EXPERIMENTAL Sampler {
  public:
+  /**
+   * @param vocab_size The number of logits per token.
+   * @param temperature The softmax temperature, or 0 for greedy sampling.
+   * @param topp Keep the smallest set of tokens whose probability exceeds
+   * topp. Disabled if not in (0, 1).
+   * @param rng_seed The seed of the random number generator.
+   * @param topk Keep the topk most likely tokens. Disabled if not positive.
+   * @param minp Keep the tokens whose probability is at least minp times that
+   * of the most likely token. Disabled if not positive.
+   */
   Sampler(
       int32_t vocab_size,
       float temperature,
       float topp,
-      unsigned long long rng_seed);
+      unsigned long long rng_seed,
+      int32_t topk = 0,
+      float minp = 0.0f);
 
   template <typename T>
   int32_t sample(T* logits);
 
- private:
+  /**
+   * Samples the next token of every row of a [batch_size, vocab_size] logits
+   * buffer, drawing one random number per row in order.
+   * @param logits The logits of the batch.
+   * @param batch_size The number of rows.
+   * @param tokens Receives the batch_size sampled tokens.
+   */
   template <typename T>
-  int32_t sample_topp(T* probabilities, float coin);
+  void sample_batch(T* logits, int32_t batch_size, int32_t* tokens);
+
+ private:
   template <typename T>
-  int32_t sample_mult(T* probabilities, float coin);
+  int32_t sample_argmax(const T* logits);
+  // Writes exp((logits - max) / temperature) to probs_, so the most likely
+  // token has weight 1, and returns the sum of the weights.
   template <typename T>
-  int32_t sample_argmax(T* probabilities);
+  float compute_weights(const T* logits);
+  int32_t sample_mult(float total, float coin);
+  int32_t sample_truncated(float total, float coin);
 
  private:
   int32_t vocab_size_;
   // reciprocal of temperature, or 0 if temperature == 0.
   float inv_temperature_;
   float topp_;
+  int32_t topk_;
+  float minp_;
   unsigned long long rng_state_;
+  // Unnormalized probabilities of the current row.
+  std::vector<float> probs_;
+  // Token ids of the candidates that survive truncation.
+  std::vector<int32_t> candidates_;
 };
 
 } // namespace llm
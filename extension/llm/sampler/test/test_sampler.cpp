@@ -8,6 +8,10 @@
 
 #include <executorch/extension/llm/sampler/sampler.h>
 
+#include <limits>
+#include <set>
+#include <vector>
+
 #include <gtest/gtest.h>
 #include <torch/torch.h>
 
@@ -39,3 +43,119 @@ TEST(SamplerTest, TestArgMaxWithFP16) {
   input[0][0][396] = 1.0f;
   EXPECT_EQ(sampler.sample(input.data_ptr<c10::Half>()), 396);
 }
+
+TEST(SamplerTest, TestArgMaxWithNaN) {
+  Sampler sampler{
+      /*vocab_size*/ 32000,
+      /*temperature*/ 0.0f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0};
+  std::vector<float> logits(32000, 0.0f);
+  logits[396] = 1.0f;
+  logits[1000] = std::numeric_limits<float>::quiet_NaN();
+  // The NaN is skipped instead of making the result out of range.
+  EXPECT_EQ(sampler.sample(logits.data()), 396);
+}
+
+TEST(SamplerTest, TestSamplingLeavesLogitsUnchanged) {
+  Sampler sampler{
+      /*vocab_size*/ 100,
+      /*temperature*/ 0.7f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0};
+  std::vector<float> logits(100);
+  for (int i = 0; i < 100; ++i) {
+    logits[i] = 0.01f * i;
+  }
+  std::vector<float> original = logits;
+  sampler.sample(logits.data());
+  EXPECT_EQ(logits, original);
+}
+
+TEST(SamplerTest, TestTopKOnlySamplesMostLikelyTokens) {
+  Sampler sampler{
+      /*vocab_size*/ 1000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 1.0f,
+      /*rng_seed*/ 42,
+      /*topk*/ 3};
+  std::vector<float> logits(1000, 0.0f);
+  logits[7] = 2.0f;
+  logits[300] = 2.5f;
+  logits[999] = 1.5f;
+  std::set<int32_t> seen;
+  for (int i = 0; i < 1000; ++i) {
+    seen.insert(sampler.sample(logits.data()));
+  }
+  EXPECT_EQ(seen, (std::set<int32_t>{7, 300, 999}));
+}
+
+TEST(SamplerTest, TestTopPOnlySamplesNucleus) {
+  Sampler sampler{
+      /*vocab_size*/ 1000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 0.5f,
+      /*rng_seed*/ 42};
+  // Tokens 10 and 20 hold about 88% of the probability, and token 10 alone
+  // about 65%.
+  std::vector<float> logits(1000, 0.0f);
+  logits[10] = 8.0f;
+  logits[20] = 7.0f;
+  std::set<int32_t> seen;
+  for (int i = 0; i < 1000; ++i) {
+    seen.insert(sampler.sample(logits.data()));
+  }
+  EXPECT_EQ(seen, (std::set<int32_t>{10}));
+}
+
+TEST(SamplerTest, TestMinPDropsUnlikelyTokens) {
+  Sampler sampler{
+      /*vocab_size*/ 1000,
+      /*temperature*/ 1.0f,
+      /*topp*/ 1.0f,
+      /*rng_seed*/ 42,
+      /*topk*/ 0,
+      /*minp*/ 0.1f};
+  // exp(-2) is above 0.1 and exp(-3) is below it.
+  std::vector<float> logits(1000, 0.0f);
+  logits[1] = 5.0f;
+  logits[2] = 3.0f;
+  logits[3] = 2.0f;
+  std::set<int32_t> seen;
+  for (int i = 0; i < 2000; ++i) {
+    seen.insert(sampler.sample(logits.data()));
+  }
+  EXPECT_EQ(seen, (std::set<int32_t>{1, 2}));
+}
+
+TEST(SamplerTest, TestSamplingFollowsTemperature) {
+  Sampler sampler{
+      /*vocab_size*/ 2,
+      /*temperature*/ 0.5f,
+      /*topp*/ 1.0f,
+      /*rng_seed*/ 42};
+  // With temperature 0.5 the probabilities are softmax([0, 1] * 2), so
+  // token 1 is sampled with probability 1 / (1 + exp(-2)) = 0.88.
+  std::vector<float> logits = {0.0f, 1.0f};
+  int count = 0;
+  constexpr int kNumSamples = 10000;
+  for (int i = 0; i < kNumSamples; ++i) {
+    count += sampler.sample(logits.data());
+  }
+  EXPECT_NEAR(static_cast<float>(count) / kNumSamples, 0.881f, 0.02f);
+}
+
+TEST(SamplerTest, TestSampleBatch) {
+  Sampler sampler{
+      /*vocab_size*/ 50,
+      /*temperature*/ 0.0f,
+      /*topp*/ 0.9f,
+      /*rng_seed*/ 0};
+  std::vector<float> logits(3 * 50, 0.0f);
+  logits[0 * 50 + 4] = 1.0f;
+  logits[1 * 50 + 49] = 1.0f;
+  logits[2 * 50 + 0] = 1.0f;
+  std::vector<int32_t> tokens(3);
+  sampler.sample_batch(logits.data(), 3, tokens.data());
+  EXPECT_EQ(tokens, (std::vector<int32_t>{4, 49, 0}));
+}
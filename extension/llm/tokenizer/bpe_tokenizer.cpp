@@ -39,7 +39,8 @@ BPETokenizer::BPETokenizer() : Tokenizer() {
  * vocabulary and scores. The format is: the first integer is the maximum
  * token length, followed by a list of (word_len, word) pairs. Here we
  * are reading all the vocabulary into memory and keep it sorted for fast
- * lookup.
+ * lookup. The file can also be a token table converted by token_table.py,
+ * which is memory-mapped and used in place instead.
  *
  * @param tokenizer_path The path to the tokenizer file.
  * @return Error
@@ -49,6 +50,9 @@ Error BPETokenizer::load(const std::string& tokenizer_path) {
     ET_LOG(Info, "Tokenizer already initialized");
     return Error::Ok;
   }
+  if (TokenTable::is_token_table(tokenizer_path)) {
+    return load_token_table(tokenizer_path);
+  }
   // read in the file
   FILE* file = fopen(tokenizer_path.c_str(), "rb");
   if (!file) {
@@ -117,7 +121,27 @@ Error BPETokenizer::load(const std::string& tokenizer_path) {
   return Error::Ok;
 }
 
+Error BPETokenizer::load_token_table(const std::string& tokenizer_path) {
+  auto token_table = ET_UNWRAP(TokenTable::load(tokenizer_path));
+  ET_CHECK_OR_RETURN_ERROR(
+      token_table.type() == TokenTable::Type::BPE,
+      InvalidArgument,
+      "%s is not a BPE token table",
+      tokenizer_path.c_str());
+  vocab_size_ = token_table.vocab_size();
+  bos_tok_ = token_table.bos_id();
+  eos_tok_ = token_table.eos_id();
+  max_token_length_ = token_table.max_token_length();
+  token_table_.emplace(std::move(token_table));
+
+  initialized_ = true;
+  return Error::Ok;
+}
+
 BPETokenizer::~BPETokenizer() {
+  if (!vocab_) {
+    return;
+  }
   for (int i = 0; i < vocab_size_; i++) {
     delete[] vocab_[i];
   }
@@ -133,8 +157,17 @@ BPETokenizer::~BPETokenizer() {
  */
 Result<std::string> BPETokenizer::decode(uint64_t prev_token, uint64_t token)
     const {
+  std::string res;
+  ET_CHECK_OK_OR_RETURN_ERROR(decode_into(prev_token, token, res));
+  return res;
+}
+
+Error BPETokenizer::decode_into(
+    uint64_t prev_token,
+    uint64_t token,
+    std::string& out) const {
   ET_CHECK_OK_OR_RETURN_ERROR(Tokenizer::decode_verify(token));
-  const char* piece = vocab_[token];
+  const char* piece = this->piece(token);
   // following BOS token, sentencepiece decoder strips any leading
   // whitespace
   if (prev_token == bos_tok_ && piece[0] == ' ') {
@@ -146,8 +179,8 @@ Result<std::string> BPETokenizer::decode(uint64_t prev_token, uint64_t token)
   if (sscanf(piece, "<0x%02hhX>", &byte_val) == 1) {
     piece = (char*)byte_pieces_ + byte_val * 2;
   }
-  std::string res(piece);
-  return res;
+  out += piece;
+  return Error::Ok;
 }
 
 static int32_t
@@ -160,6 +193,22 @@ str_lookup(const char* str, TokenIndex* sorted_vocab, int32_t vocab_size) {
   return res != nullptr ? res->id : -1;
 }
 
+int32_t BPETokenizer::lookup(const char* str) const {
+  if (token_table_) {
+    auto id = token_table_->find(str);
+    return id ? static_cast<int32_t>(*id) : -1;
+  }
+  return str_lookup(str, sorted_vocab_.get(), vocab_size_);
+}
+
+const char* BPETokenizer::piece(uint64_t token) const {
+  return token_table_ ? token_table_->c_str(token) : vocab_[token];
+}
+
+float BPETokenizer::score(int32_t id) const {
+  return token_table_ ? token_table_->score(id) : vocab_scores_[id];
+}
+
 /**
  * @brief Encode a string into a sequence of tokens.
  *
@@ -210,7 +259,7 @@ BPETokenizer::encode(const std::string& text, int8_t bos, int8_t eos) const {
   // doing
   const char* space = " ";
   if (text[0] != '\0') {
-    int dummy_prefix = str_lookup(space, sorted_vocab_.get(), vocab_size_);
+    int dummy_prefix = lookup(space);
     tokens.push_back(dummy_prefix);
   }
 
@@ -249,7 +298,7 @@ BPETokenizer::encode(const std::string& text, int8_t bos, int8_t eos) const {
     }
 
     // ok c+1 is not a continuation byte, so we've read in a full codepoint
-    int id = str_lookup(str_buffer, sorted_vocab_.get(), vocab_size_);
+    int id = lookup(str_buffer);
     if (id != -1) {
       // we found this codepoint in vocab, add it as a token
       tokens.push_back(id);
@@ -277,12 +326,12 @@ BPETokenizer::encode(const std::string& text, int8_t bos, int8_t eos) const {
           str_buffer,
           max_token_length_ * 2 + 3,
           "%s%s",
-          vocab_[tokens[i]],
-          vocab_[tokens[i + 1]]);
-      int id = str_lookup(str_buffer, sorted_vocab_.get(), vocab_size_);
-      if (id != -1 && vocab_scores_[id] > best_score) {
+          piece(tokens[i]),
+          piece(tokens[i + 1]));
+      int id = lookup(str_buffer);
+      if (id != -1 && score(id) > best_score) {
         // this merge pair exists in vocab! record its score and position
-        best_score = vocab_scores_[id];
+        best_score = score(id);
         best_id = id;
         best_idx = i;
       }
@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <executorch/extension/llm/tokenizer/token_table.h>
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
 #include <memory>
+#include <optional>
 
 namespace executorch {
 namespace extension {
@@ -36,7 +38,21 @@ class ET_EXPERIMENTAL BPETokenizer : public Tokenizer {
       uint64_t prev_token,
       uint64_t token) const override;
 
+  ::executorch::runtime::Error decode_into(
+      uint64_t prev_token,
+      uint64_t token,
+      std::string& out) const override;
+
  private:
+  ::executorch::runtime::Error load_token_table(
+      const std::string& tokenizer_path);
+  int32_t lookup(const char* str) const;
+  const char* piece(uint64_t token) const;
+  float score(int32_t id) const;
+
+  // Holds the vocabulary in place of the arrays below if the tokenizer was
+  // loaded from a token table.
+  std::optional<TokenTable> token_table_;
   std::unique_ptr<char*[]> vocab_ = nullptr;
   std::unique_ptr<float[]> vocab_scores_ = nullptr;
   std::unique_ptr<TokenIndex[]> sorted_vocab_ = nullptr;
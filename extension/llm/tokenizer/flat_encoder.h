@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// A read-only map from token bytes to ranks, for the lookups of BPE merges.
+#pragma once
+
+#include <executorch/runtime/platform/assert.h>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Open addressing hash table from byte strings to ranks. All keys live in one
+ * buffer and the slots only hold their offset, length and hash, so a lookup
+ * with a string_view neither allocates nor chases per-entry pointers the way
+ * std::unordered_map<std::string, uint64_t> does.
+ */
+class ET_EXPERIMENTAL FlatEncoder {
+ public:
+  FlatEncoder() = default;
+
+  explicit FlatEncoder(const std::unordered_map<std::string, uint64_t>& map) {
+    // Keep the load factor at most 1/2 so probe sequences stay short.
+    size_t capacity = 16;
+    while (capacity < 2 * map.size()) {
+      capacity *= 2;
+    }
+    slots_.resize(capacity);
+    mask_ = capacity - 1;
+
+    for (const auto& [key, value] : map) {
+      ET_CHECK_MSG(!key.empty(), "FlatEncoder keys must not be empty");
+      ET_CHECK_MSG(
+          keys_.size() + key.size() <= std::numeric_limits<uint32_t>::max(),
+          "FlatEncoder keys exceed 4GB");
+      const uint64_t hash = hash_bytes(key);
+      size_t index = hash & mask_;
+      while (slots_[index].length != 0) {
+        index = (index + 1) & mask_;
+      }
+      slots_[index] = {
+          static_cast<uint32_t>(keys_.size()),
+          static_cast<uint32_t>(key.size()),
+          static_cast<uint32_t>(hash >> 32),
+          value};
+      keys_.append(key);
+    }
+    size_ = map.size();
+  }
+
+  /**
+   * @return The value of key, or nullopt if it is not in the table.
+   */
+  std::optional<uint64_t> find(std::string_view key) const {
+    if (slots_.empty() || key.empty()) {
+      return std::nullopt;
+    }
+    const uint64_t hash = hash_bytes(key);
+    const uint32_t tag = hash >> 32;
+    for (size_t index = hash & mask_; slots_[index].length != 0;
+         index = (index + 1) & mask_) {
+      const Slot& slot = slots_[index];
+      if (slot.tag == tag && slot.length == key.size() &&
+          std::memcmp(keys_.data() + slot.offset, key.data(), key.size()) ==
+              0) {
+        return slot.value;
+      }
+    }
+    return std::nullopt;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  // An empty slot has length 0, since keys are never empty.
+  struct Slot {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    // The high bits of the hash, to skip most mismatching keys without
+    // comparing their bytes.
+    uint32_t tag = 0;
+    uint64_t value = 0;
+  };
+
+  // 64-bit FNV-1a.
+  static uint64_t hash_bytes(std::string_view bytes) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : bytes) {
+      hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  std::string keys_;
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+  size_t size_ = 0;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Decode generated tokens into text that never ends inside a UTF-8 character.
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/llm/tokenizer/tokenizer.h>
+#include <executorch/runtime/platform/assert.h>
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * Incremental detokenizer for one or more independent streams of tokens,
+ * e.g. the sequences of a batch. A token can end in the middle of a UTF-8
+ * code point, for instance a byte fallback token of an emoji, so the decoded
+ * bytes of such a token are held back and prepended to the text of the next
+ * token of the same stream. Every text handed out then consists of whole
+ * code points, unless the model generates malformed UTF-8, which is passed
+ * through as is.
+ *
+ * The text goes into a string that the caller owns and reuses, and the state
+ * of a stream is a few bytes in a flat array, so decoding does not allocate
+ * once the caller's string has grown to the longest token.
+ */
+class ET_EXPERIMENTAL StreamingDecoder {
+ public:
+  /**
+   * @param tokenizer The loaded tokenizer. Must outlive the decoder.
+   * @param num_streams How many streams are decoded independently.
+   */
+  explicit StreamingDecoder(const Tokenizer* tokenizer, size_t num_streams = 1)
+      : tokenizer_(tokenizer), pending_(num_streams) {}
+
+  size_t num_streams() const {
+    return pending_.size();
+  }
+
+  /**
+   * Decodes token, which follows prev_token in stream.
+   * @param text Overwritten with the complete code points decoded so far. It
+   * is empty if token ends in the middle of the first one.
+   */
+  ::executorch::runtime::Error decode(
+      uint64_t prev_token,
+      uint64_t token,
+      std::string& text,
+      size_t stream = 0) {
+    ET_CHECK_MSG(stream < pending_.size(), "Invalid stream %zu", stream);
+    Pending& pending = pending_[stream];
+    text.assign(pending.bytes, pending.size);
+    pending.size = 0;
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        tokenizer_->decode_into(prev_token, token, text));
+
+    const size_t end = complete_size(text);
+    pending.size = text.size() - end;
+    text.copy(pending.bytes, pending.size, end);
+    text.resize(end);
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  /**
+   * Decodes one token for each of several streams, as if by calling decode()
+   * for each i in order.
+   * @param streams The stream of each of tokens.
+   * @param texts Indexed by stream, of num_streams() strings. texts[streams[i]]
+   * is overwritten with the text of tokens[i]. The other ones are left as is.
+   */
+  ::executorch::runtime::Error decode_batch(
+      const std::vector<uint64_t>& prev_tokens,
+      const std::vector<uint64_t>& tokens,
+      const std::vector<size_t>& streams,
+      std::vector<std::string>& texts) {
+    ET_CHECK_OR_RETURN_ERROR(
+        prev_tokens.size() == tokens.size() && streams.size() == tokens.size(),
+        InvalidArgument,
+        "Expected as many previous tokens and streams as tokens");
+    ET_CHECK_OR_RETURN_ERROR(
+        texts.size() == pending_.size(),
+        InvalidArgument,
+        "Expected %zu texts, got %zu",
+        pending_.size(),
+        texts.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          decode(prev_tokens[i], tokens[i], texts[streams[i]], streams[i]));
+    }
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  /**
+   * Ends stream, e.g. when its sequence is finished, and starts it over.
+   * @param text Overwritten with the bytes that were held back, which are not
+   * valid UTF-8 on their own. Usually empty.
+   */
+  void flush(std::string& text, size_t stream = 0) {
+    ET_CHECK_MSG(stream < pending_.size(), "Invalid stream %zu", stream);
+    Pending& pending = pending_[stream];
+    text.assign(pending.bytes, pending.size);
+    pending.size = 0;
+  }
+
+  /**
+   * Starts stream over, dropping the bytes that were held back.
+   */
+  void reset(size_t stream = 0) {
+    ET_CHECK_MSG(stream < pending_.size(), "Invalid stream %zu", stream);
+    pending_[stream].size = 0;
+  }
+
+  /**
+   * @return The length of the longest prefix of text that does not end in an
+   * incomplete UTF-8 code point.
+   */
+  static size_t complete_size(const std::string& text) {
+    const size_t size = text.size();
+    // Find the lead byte of the last code point, which is at most 4 bytes
+    // long.
+    for (size_t i = size; i > 0 && size - i < 4;) {
+      const unsigned char c = text[--i];
+      if ((c & 0xC0) == 0x80) {
+        continue;
+      }
+      size_t length = 1;
+      if ((c & 0xE0) == 0xC0) {
+        length = 2;
+      } else if ((c & 0xF0) == 0xE0) {
+        length = 3;
+      } else if ((c & 0xF8) == 0xF0) {
+        length = 4;
+      }
+      return i + length > size ? i : size;
+    }
+    // Continuation bytes without a lead byte never become valid, so there
+    // is no point in holding them back.
+    return size;
+  }
+
+ private:
+  // The bytes of an incomplete code point: at most 3, since a 4th would
+  // complete it.
+  struct Pending {
+    char bytes[3];
+    uint8_t size = 0;
+  };
+
+  const Tokenizer* tokenizer_;
+  std::vector<Pending> pending_;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
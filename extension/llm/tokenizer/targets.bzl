@@ -10,6 +10,7 @@ def define_common_targets():
         name = "tokenizer_py_lib",
         srcs = [
             "__init__.py",
+            "token_table.py",
             "tokenizer.py",
             "utils.py",
         ],
@@ -44,9 +45,23 @@ def define_common_targets():
         ],
     )
 
+    runtime.python_binary(
+        name = "token_table_py",
+        main_module = "executorch.extension.llm.tokenizer.token_table",
+        visibility = [
+            "//executorch/examples/...",
+            "fbsource//xplat/executorch/examples/...",
+        ],
+        _is_external_target = True,
+        deps = [
+            ":tokenizer_py_lib",
+        ],
+    )
+
     runtime.cxx_library(
         name = "tokenizer_header",
         exported_headers = [
+            "streaming_decoder.h",
             "tokenizer.h",
         ],
         exported_deps = [
@@ -64,6 +79,7 @@ def define_common_targets():
         ],
         exported_headers = [
             "bpe_tokenizer.h",
+            "token_table.h",
         ],
         exported_deps = [
             ":tokenizer_header",
@@ -82,6 +98,8 @@ def define_common_targets():
         exported_headers = [
             "tiktoken.h",
             "base64.h",
+            "flat_encoder.h",
+            "token_table.h",
         ],
         exported_deps = [
             ":tokenizer_header",
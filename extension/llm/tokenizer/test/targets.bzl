@@ -17,6 +17,16 @@ def define_common_targets():
         ],
     )
 
+    runtime.python_test(
+        name = "test_token_table_py",
+        srcs = [
+            "test_token_table.py",
+        ],
+        deps = [
+            "//executorch/extension/llm/tokenizer:tokenizer_py_lib",
+        ],
+    )
+
     runtime.cxx_test(
         name = "test_bpe_tokenizer",
         srcs = [
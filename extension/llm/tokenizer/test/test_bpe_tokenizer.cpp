@@ -75,3 +75,35 @@ TEST_F(TokenizerExtensionTest, SafeToDestruct) {
   tokenizer_ = std::make_unique<BPETokenizer>();
   tokenizer_.reset();
 }
+
+TEST_F(TokenizerExtensionTest, TokenTableEncodesLikeBinaryArtifact) {
+#ifdef EXECUTORCH_FB_BUCK
+  const std::string resources =
+      facebook::xplat::testing::getPathForTestResource("resources");
+#else
+  const std::string resources = std::getenv("RESOURCES_PATH");
+#endif
+  Error res = tokenizer_->load(resources + "/test_bpe_small.bin");
+  EXPECT_EQ(res, Error::Ok);
+  auto table_tokenizer = std::make_unique<BPETokenizer>();
+  res = table_tokenizer->load(resources + "/test_bpe_small.ettok");
+  EXPECT_EQ(res, Error::Ok);
+  EXPECT_EQ(table_tokenizer->vocab_size(), tokenizer_->vocab_size());
+  EXPECT_EQ(table_tokenizer->bos_tok(), 1);
+  EXPECT_EQ(table_tokenizer->eos_tok(), 2);
+
+  for (const std::string& text :
+       {"hello world", "hold the door", "h\xc3\xa9"}) {
+    Result<std::vector<uint64_t>> expected = tokenizer_->encode(text, 1, 1);
+    Result<std::vector<uint64_t>> out = table_tokenizer->encode(text, 1, 1);
+    EXPECT_EQ(out.error(), Error::Ok);
+    EXPECT_EQ(out.get(), expected.get());
+    uint64_t prev = 0;
+    for (uint64_t token : out.get()) {
+      EXPECT_EQ(
+          table_tokenizer->decode(prev, token).get(),
+          tokenizer_->decode(prev, token).get());
+      prev = token;
+    }
+  }
+}
@@ -9,6 +9,8 @@
 #ifdef EXECUTORCH_FB_BUCK
 #include <TestResourceUtils/TestResourceUtils.h>
 #endif
+#include <executorch/extension/llm/tokenizer/flat_encoder.h>
+#include <executorch/extension/llm/tokenizer/streaming_decoder.h>
 #include <executorch/extension/llm/tokenizer/tiktoken.h>
 #include <executorch/runtime/platform/runtime.h>
 #include <gmock/gmock.h>
@@ -16,6 +18,8 @@
 #include <vector>
 
 using namespace ::testing;
+using ::executorch::extension::llm::FlatEncoder;
+using ::executorch::extension::llm::StreamingDecoder;
 using ::executorch::extension::llm::Tiktoken;
 using ::executorch::extension::llm::Tokenizer;
 using ::executorch::runtime::Error;
@@ -69,6 +73,14 @@ class TiktokenExtensionTest : public Test {
     modelPath_ = _get_resource_path("test_tiktoken_tokenizer.model");
   }
 
+  std::string decode_all(const std::vector<uint64_t>& tokens) {
+    std::string text;
+    for (uint64_t token : tokens) {
+      text += tokenizer_->decode(0, token).get();
+    }
+    return text;
+  }
+
   std::unique_ptr<Tokenizer> tokenizer_;
   std::string modelPath_;
 };
@@ -188,3 +200,171 @@ TEST_F(TiktokenExtensionTest, LoadTiktokenFileWithBPEFile) {
 
   EXPECT_EQ(res, Error::InvalidArgument);
 }
+
+TEST_F(TiktokenExtensionTest, LongPiecesRoundTrip) {
+  Error res = tokenizer_->load(modelPath_.c_str());
+  EXPECT_EQ(res, Error::Ok);
+  // Long enough for the heap-based merge, and encoded twice to go through the
+  // cache of pieces for the words that take several tokens.
+  const std::string text = std::string(1000, 'a') + " " +
+      std::string(100, 'x') + "yz antidisestablishmentarianism";
+  Result<std::vector<uint64_t>> out = tokenizer_->encode(text, 0, 0);
+  EXPECT_EQ(out.error(), Error::Ok);
+  EXPECT_EQ(decode_all(out.get()), text);
+
+  Result<std::vector<uint64_t>> again = tokenizer_->encode(text, 0, 0);
+  EXPECT_EQ(again.error(), Error::Ok);
+  EXPECT_EQ(again.get(), out.get());
+}
+
+TEST_F(TiktokenExtensionTest, ParallelEncodeMatchesSequential) {
+  Error res = tokenizer_->load(modelPath_.c_str());
+  EXPECT_EQ(res, Error::Ok);
+  // No piece crosses the start of a line, so each line encodes
+  // independently, however the text is split between threads.
+  const std::string line = "Hello world, it's 2024!\n  indented\tline\n";
+  std::string text;
+  while (text.size() < 1024 * 1024) {
+    text += line;
+  }
+  const size_t num_lines = text.size() / line.size();
+  Result<std::vector<uint64_t>> line_tokens = tokenizer_->encode(line, 0, 0);
+  EXPECT_EQ(line_tokens.error(), Error::Ok);
+
+  auto tiktoken = static_cast<Tiktoken*>(tokenizer_.get());
+  tiktoken->set_num_threads(1);
+  Result<std::vector<uint64_t>> sequential = tokenizer_->encode(text, 0, 0);
+  EXPECT_EQ(sequential.error(), Error::Ok);
+  tiktoken->set_num_threads(4);
+  Result<std::vector<uint64_t>> parallel = tokenizer_->encode(text, 0, 0);
+  EXPECT_EQ(parallel.error(), Error::Ok);
+
+  EXPECT_EQ(parallel.get(), sequential.get());
+  ASSERT_EQ(parallel.get().size(), num_lines * line_tokens.get().size());
+  for (size_t i = 0; i < parallel.get().size(); ++i) {
+    EXPECT_EQ(
+        parallel.get()[i], line_tokens.get()[i % line_tokens.get().size()]);
+  }
+}
+
+TEST_F(TiktokenExtensionTest, TokenTableEncodesLikeTextArtifact) {
+  Error res =
+      tokenizer_->load(_get_resource_path("test_tiktoken_small.model"));
+  EXPECT_EQ(res, Error::Ok);
+  auto table_tokenizer = std::make_unique<Tiktoken>(
+      _get_special_tokens(), kBOSTokenIndex, kEOSTokenIndex);
+  res = table_tokenizer->load(_get_resource_path("test_tiktoken_small.ettok"));
+  EXPECT_EQ(res, Error::Ok);
+  EXPECT_EQ(table_tokenizer->vocab_size(), tokenizer_->vocab_size());
+  EXPECT_EQ(table_tokenizer->bos_tok(), tokenizer_->bos_tok());
+
+  Result<std::vector<uint64_t>> hello =
+      table_tokenizer->encode("hello world", 1, 0);
+  EXPECT_EQ(hello.error(), Error::Ok);
+  EXPECT_EQ(hello.get(), (std::vector<uint64_t>{267, 259, 264}));
+
+  std::string hellos;
+  for (int i = 0; i < 30; ++i) {
+    hellos += "hello";
+  }
+  for (const std::string& text :
+       {std::string("hello world, hello  worlds\n\nhelo"),
+        std::string("<|begin_of_text|>hello<|eot_id|>"),
+        hellos}) {
+    Result<std::vector<uint64_t>> expected = tokenizer_->encode(text, 0, 0);
+    Result<std::vector<uint64_t>> out = table_tokenizer->encode(text, 0, 0);
+    EXPECT_EQ(out.error(), Error::Ok);
+    EXPECT_EQ(out.get(), expected.get());
+    for (uint64_t token : out.get()) {
+      EXPECT_EQ(
+          table_tokenizer->decode(0, token).get(),
+          tokenizer_->decode(0, token).get());
+    }
+  }
+}
+
+TEST_F(TiktokenExtensionTest, LoadBPETokenTableFails) {
+  Error res = tokenizer_->load(_get_resource_path("test_bpe_small.ettok"));
+  EXPECT_EQ(res, Error::InvalidArgument);
+}
+
+TEST_F(TiktokenExtensionTest, StreamingDecoderHoldsBackPartialCharacters) {
+  // The first 256 tokens of the small model are the single bytes.
+  Error res =
+      tokenizer_->load(_get_resource_path("test_tiktoken_small.model"));
+  EXPECT_EQ(res, Error::Ok);
+  StreamingDecoder decoder(tokenizer_.get());
+
+  // "a", then U+20AC and U+1F600 one byte at a time, then "b".
+  const std::vector<uint64_t> tokens = {
+      'a', 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x98, 0x80, 'b'};
+  std::vector<std::string> texts;
+  std::string text;
+  uint64_t prev_token = kBOSTokenIndex;
+  for (uint64_t token : tokens) {
+    EXPECT_EQ(decoder.decode(prev_token, token, text), Error::Ok);
+    texts.push_back(text);
+    prev_token = token;
+  }
+  EXPECT_EQ(
+      texts,
+      (std::vector<std::string>{
+          "a", "", "", "\xE2\x82\xAC", "", "", "", "\xF0\x9F\x98\x80", "b"}));
+
+  // Flushing hands out what is held back, valid or not.
+  EXPECT_EQ(decoder.decode(0, 0xC3, text), Error::Ok);
+  EXPECT_EQ(text, "");
+  decoder.flush(text);
+  EXPECT_EQ(text, "\xC3");
+  decoder.flush(text);
+  EXPECT_EQ(text, "");
+
+  // Malformed sequences are not held back forever.
+  EXPECT_EQ(decoder.decode(0, 0xE2, text), Error::Ok);
+  EXPECT_EQ(decoder.decode(0, 'c', text), Error::Ok);
+  EXPECT_EQ(text, "\xE2" "c");
+  EXPECT_EQ(decoder.decode(0, 0x80, text), Error::Ok);
+  EXPECT_EQ(text, "\x80");
+}
+
+TEST_F(TiktokenExtensionTest, StreamingDecoderBatchKeepsStreamsApart) {
+  Error res =
+      tokenizer_->load(_get_resource_path("test_tiktoken_small.model"));
+  EXPECT_EQ(res, Error::Ok);
+  StreamingDecoder decoder(tokenizer_.get(), /*num_streams=*/3);
+  std::vector<std::string> texts(3);
+
+  // Stream 2 gets U+00E9, stream 0 U+20AC, interleaved.
+  EXPECT_EQ(
+      decoder.decode_batch({0, 0}, {0xE2, 0xC3}, {0, 2}, texts), Error::Ok);
+  EXPECT_EQ(texts, (std::vector<std::string>{"", "", ""}));
+  EXPECT_EQ(
+      decoder.decode_batch({0, 0, 0}, {0xA9, 'x', 0x82}, {2, 1, 0}, texts),
+      Error::Ok);
+  EXPECT_EQ(texts, (std::vector<std::string>{"", "x", "\xC3\xA9"}));
+  EXPECT_EQ(decoder.decode_batch({0}, {0xAC}, {0}, texts), Error::Ok);
+  EXPECT_EQ(texts[0], "\xE2\x82\xAC");
+
+  std::vector<std::string> too_few_texts(1);
+  EXPECT_EQ(
+      decoder.decode_batch({0}, {'y'}, {0}, too_few_texts),
+      Error::InvalidArgument);
+}
+
+TEST(FlatEncoderTest, FindsEveryKey) {
+  std::unordered_map<std::string, uint64_t> map;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    map.emplace("key" + std::to_string(i), i);
+  }
+  map.emplace(std::string("\0\xff", 2), 1000);
+  FlatEncoder encoder(map);
+
+  EXPECT_EQ(encoder.size(), map.size());
+  for (const auto& [key, value] : map) {
+    EXPECT_EQ(encoder.find(key), value);
+  }
+  EXPECT_EQ(encoder.find("key"), std::nullopt);
+  EXPECT_EQ(encoder.find("key1000"), std::nullopt);
+  EXPECT_EQ(encoder.find(""), std::nullopt);
+  EXPECT_EQ(FlatEncoder().find("key0"), std::nullopt);
+}
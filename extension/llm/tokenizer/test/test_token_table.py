@@ -0,0 +1,98 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+
+import struct
+import tempfile
+import unittest
+
+from executorch.extension.llm.tokenizer.token_table import (
+    HEADER_FORMAT,
+    MAGIC,
+    NO_TOKEN,
+    TYPE_BPE,
+    TYPE_TIKTOKEN,
+    hash_bytes,
+    slot_of,
+    write_token_table,
+)
+
+
+def _read_table(path):
+    """Reads back a token table the way TokenTable does."""
+    with open(path, "rb") as f:
+        data = f.read()
+    header = struct.unpack_from(HEADER_FORMAT, data)
+    magic, _, table_type, vocab_size = header[:4]
+    num_buckets, num_slots, strings_size = header[7], header[8], header[10]
+    offset = struct.calcsize(HEADER_FORMAT)
+
+    def section(size):
+        nonlocal offset
+        start = offset
+        offset = (offset + size + 7) & ~7
+        return start
+
+    entries = struct.unpack_from(f"<{2 * vocab_size}I", data, section(8 * vocab_size))
+    scores = section(4 * vocab_size if table_type == TYPE_BPE else 0)
+    seeds = struct.unpack_from(f"<{num_buckets}I", data, section(4 * num_buckets))
+    slots = struct.unpack_from(f"<{num_slots}I", data, section(4 * num_slots))
+    strings = data[section(strings_size) :]
+
+    def token(token_id):
+        start, length = entries[2 * token_id], entries[2 * token_id + 1]
+        return strings[start : start + length]
+
+    def find(key):
+        h = hash_bytes(key)
+        token_id = slots[slot_of(h, seeds[(h >> 32) % num_buckets]) % num_slots]
+        return token_id if token_id != NO_TOKEN and token(token_id) == key else None
+
+    return magic, table_type, vocab_size, data, scores, token, find
+
+
+class TestTokenTable(unittest.TestCase):
+    def test_tiktoken_table(self):
+        tokens = [bytes([i]) for i in range(256)] + [b"he", b"llo", None, b"hello"]
+        with tempfile.NamedTemporaryFile() as output:
+            write_token_table(output.name, tokens, TYPE_TIKTOKEN)
+            magic, table_type, vocab_size, _, _, token, find = _read_table(
+                output.name
+            )
+        self.assertEqual(magic, MAGIC)
+        self.assertEqual(table_type, TYPE_TIKTOKEN)
+        self.assertEqual(vocab_size, len(tokens))
+        for token_id, expected in enumerate(tokens):
+            self.assertEqual(token(token_id), expected or b"")
+            if expected:
+                self.assertEqual(find(expected), token_id)
+        self.assertIsNone(find(b"hell"))
+        self.assertIsNone(find(b""))
+
+    def test_bpe_table(self):
+        tokens = [b"<unk>", b"<s>", b"</s>", b"<pad>", b"<pad>", b" hi"]
+        scores = [0.0, 1.0, 2.0, 3.0, 4.0, -5.5]
+        with tempfile.NamedTemporaryFile() as output:
+            write_token_table(
+                output.name,
+                tokens,
+                TYPE_BPE,
+                scores=scores,
+                bos_id=1,
+                eos_id=2,
+                max_token_length=5,
+            )
+            _, table_type, vocab_size, data, scores_offset, token, find = (
+                _read_table(output.name)
+            )
+        self.assertEqual(table_type, TYPE_BPE)
+        self.assertEqual(
+            list(struct.unpack_from(f"<{vocab_size}f", data, scores_offset)), scores
+        )
+        # Duplicates are stored once, and found as their first id.
+        self.assertEqual(token(4), b"<pad>")
+        self.assertEqual(find(b"<pad>"), 3)
+        self.assertEqual(find(b" hi"), 5)
@@ -28,8 +28,13 @@
 #include <executorch/extension/llm/tokenizer/base64.h>
 #include <executorch/extension/llm/tokenizer/tiktoken.h>
 #include <executorch/runtime/core/result.h>
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <limits>
+#include <list>
+#include <mutex>
+#include <thread>
 
 using ::executorch::runtime::Error;
 using ::executorch::runtime::Result;
@@ -124,10 +129,30 @@ static Result<Decoder> _build_decoder(const Encoder& encoder) {
   return decoder;
 }
 
+// Pieces at least this long keep their merge candidates in a heap, so each
+// merge costs O(log n) instead of an O(n) scan of the parts vector. The scan
+// stays faster for the short pieces that are the norm.
+static constexpr size_t kHeapMergeMinSize = 64;
+
+// Inputs are split to be encoded in parallel into parts of at least this
+// many bytes, so short prompts never pay for starting a thread.
+static constexpr size_t kMinParallelChunkSize = 64 * 1024;
+
+// Number of pieces whose tokens are remembered, and the longest piece that
+// is, to bound the memory held by the cache.
+static constexpr size_t kPieceCacheCapacity = 4096;
+static constexpr size_t kMaxCachedPieceSize = 256;
+
+// Ranks is a FlatEncoder or a TokenTable, whatever the artifact was.
+template <typename Ranks>
+static uint64_t _rank_of(std::string_view bytes, const Ranks& ranks) {
+  return ranks.find(bytes).value_or(_max_size());
+}
+
+template <typename Ranks>
 static std::vector<uint64_t> _byte_pair_merge(
-    const std::string& piece,
-    const std::unordered_map<std::string, uint64_t>& ranks,
-    std::function<uint64_t(uint64_t, uint64_t)> func) {
+    std::string_view piece,
+    const Ranks& ranks) {
   // This is a vector of (start, rank).
   // The rank is of the byte pair starting at position start.
   // The rank of the last item in the vector is not a valid value.
@@ -140,35 +165,26 @@ static std::vector<uint64_t> _byte_pair_merge(
   auto get_rank = [&piece, &ranks](
                       const std::vector<std::pair<uint64_t, uint64_t>>& parts,
                       uint64_t start_idx,
-                      uint64_t skip) -> std::optional<uint64_t> {
+                      uint64_t skip) -> uint64_t {
     if (start_idx + skip + 2 < parts.size()) {
       auto s = parts[start_idx].first;
       auto e = parts[start_idx + skip + 2].first;
-      auto key = piece.substr(s, e - s);
-      auto iter = ranks.find(key);
-      if (iter != ranks.end()) {
-        return iter->second;
-      }
+      return _rank_of(piece.substr(s, e - s), ranks);
     }
-    return std::nullopt;
+    return _max_size();
   };
 
   // We look up the ranks once in the beginning and iteratively update
   // them during each merge, which reduces the number of rank lookups.
   for (auto i = 0U; i < parts.size() - 2; ++i) {
-    auto rank = get_rank(parts, i, 0);
-    if (rank) {
-      // usize::MAX is a sentinel value and cannot be a valid rank
-      ET_CHECK_MSG(*rank != _max_size(), "rank is too large");
-      parts[i].second = *rank;
-    }
+    parts[i].second = get_rank(parts, i, 0);
   }
 
   // If you have n parts and m merges, this does O(mn) work.
-  // We could do something with a heap and do O(m log n) work.
   // It is important to consider that n is often small (<100), and as such
   // the cache-locality benefits outweigh the algorithmic complexity downsides
-  // of the `parts` vector data structure above.
+  // of the `parts` vector data structure above. Longer pieces go through
+  // _byte_pair_merge_with_heap() instead.
 
   // Note that we hash bytes, not token pairs. As long as we train BPE the way
   // we currently do, this is equivalent. An easy way to break this would be
@@ -198,19 +214,9 @@ static std::vector<uint64_t> _byte_pair_merge(
       // parts[i] and parts[i-1] before removing, which could thrash
       // the cache. Thus, we update the rank calculation by skipping over
       // parts[i + 1], by invoking `get_rank!` with `skip = 1`.
-      auto rank = get_rank(parts, i, 1);
-      if (rank) {
-        parts[i].second = *rank;
-      } else {
-        parts[i].second = _max_size();
-      }
+      parts[i].second = get_rank(parts, i, 1);
       if (i > 0) {
-        rank = get_rank(parts, i - 1, 1);
-        if (rank) {
-          parts[i - 1].second = *rank;
-        } else {
-          parts[i - 1].second = _max_size();
-        }
+        parts[i - 1].second = get_rank(parts, i - 1, 1);
       }
 
       parts.erase(parts.begin() + (i + 1));
@@ -223,37 +229,171 @@ static std::vector<uint64_t> _byte_pair_merge(
   for (auto i = 0U; i < parts.size() - 1; ++i) {
     auto s = parts[i].first;
     auto e = parts[i + 1].first;
-    out.push_back(func(s, e));
+    // TODO: what if the part is not a token? Should we return `unknown`?
+    out.push_back(ranks.find(piece.substr(s, e - s)).value_or(0));
   }
   return out;
 }
 
-static std::vector<uint64_t> _byte_pair_encode(
-    const std::string& piece,
-    const Encoder& encoder) {
-  if (piece.size() == 1) {
-    auto iter = encoder.find(piece);
-    if (iter != encoder.end()) {
-      return std::vector<uint64_t>({iter->second});
-    } else {
-      // TODO: is it possible?
-      return {};
+// Same merges as _byte_pair_merge(), but the parts form a linked list and the
+// candidate merges a min-heap of (rank, start), so ties still go to the
+// leftmost pair. Entries are not removed when a merge changes the pair they
+// describe; they are skipped when popped instead, which is safe because a
+// rank identifies the bytes of its token, so an entry is current iff the rank
+// of its start still equals its own.
+template <typename Ranks>
+static std::vector<uint64_t> _byte_pair_merge_with_heap(
+    std::string_view piece,
+    const Ranks& ranks) {
+  const size_t size = piece.size();
+  // The part that starts at byte i, if any, ends at next[i] and follows the
+  // one that starts at prev[i]. rank[i] is the rank of merging it with the
+  // part after it.
+  std::vector<size_t> next(size);
+  std::vector<size_t> prev(size + 1);
+  std::vector<uint64_t> rank(size, _max_size());
+  for (size_t i = 0; i < size; ++i) {
+    next[i] = i + 1;
+    prev[i + 1] = i;
+  }
+  auto get_rank = [&](size_t start) -> uint64_t {
+    const size_t mid = next[start];
+    if (mid >= size) {
+      return _max_size();
     }
+    return _rank_of(piece.substr(start, next[mid] - start), ranks);
+  };
+
+  using Candidate = std::pair<uint64_t, size_t>;
+  std::vector<Candidate> heap;
+  heap.reserve(size);
+  for (size_t i = 0; i + 1 < size; ++i) {
+    rank[i] = get_rank(i);
+    if (rank[i] != _max_size()) {
+      heap.emplace_back(rank[i], i);
+    }
+  }
+  auto later = std::greater<Candidate>();
+  std::make_heap(heap.begin(), heap.end(), later);
+  auto push = [&](size_t start) {
+    rank[start] = get_rank(start);
+    if (rank[start] != _max_size()) {
+      heap.emplace_back(rank[start], start);
+      std::push_heap(heap.begin(), heap.end(), later);
+    }
+  };
+
+  while (!heap.empty()) {
+    std::pop_heap(heap.begin(), heap.end(), later);
+    const auto [candidate_rank, start] = heap.back();
+    heap.pop_back();
+    if (rank[start] != candidate_rank) {
+      continue;
+    }
+    // Merge the part after start into it.
+    const size_t mid = next[start];
+    next[start] = next[mid];
+    prev[next[mid]] = start;
+    rank[mid] = _max_size();
+    push(start);
+    if (start > 0) {
+      push(prev[start]);
+    }
+  }
+
+  std::vector<uint64_t> out;
+  for (size_t start = 0; start < size; start = next[start]) {
+    out.push_back(
+        ranks.find(piece.substr(start, next[start] - start)).value_or(0));
   }
+  return out;
+}
+
+template <typename Ranks>
+static std::vector<uint64_t> _byte_pair_tokens(
+    std::string_view piece,
+    const Ranks& ranks) {
+  return piece.size() < kHeapMergeMinSize
+      ? _byte_pair_merge(piece, ranks)
+      : _byte_pair_merge_with_heap(piece, ranks);
+}
+
+static bool _is_ascii_letter(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
 
-  return _byte_pair_merge(
-      piece, encoder, [&piece, &encoder](uint64_t start, uint64_t stop) {
-        std::string key = piece.substr(start, stop - start);
-        auto iter = encoder.find(key);
-        if (iter != encoder.end()) {
-          return iter->second;
-        } else {
-          // TODO: what if key does not exist? Should we return `unknown`?
-          // assert(false); // ??
-          return uint64_t(0);
-        }
-      });
+// Splits text into about num_chunks parts that can be encoded independently.
+// Every alternative of the pattern either stops at a newline or cannot
+// contain one, and none that can match a newline continues with a letter,
+// so no piece spans a newline followed by an ASCII letter. The parts are cut
+// there only.
+static std::vector<re2::StringPiece> _split_into_chunks(
+    re2::StringPiece text,
+    size_t num_chunks) {
+  std::vector<re2::StringPiece> chunks;
+  const size_t target_size = text.size() / num_chunks;
+  size_t begin = 0;
+  for (size_t k = 1; k < num_chunks; ++k) {
+    size_t i = std::max(k * target_size, begin + 1);
+    while (i < text.size() &&
+           !(text[i - 1] == '\n' && _is_ascii_letter(text[i]))) {
+      ++i;
+    }
+    if (i >= text.size()) {
+      break;
+    }
+    chunks.emplace_back(text.data() + begin, i - begin);
+    begin = i;
+  }
+  chunks.emplace_back(text.data() + begin, text.size() - begin);
+  return chunks;
 }
+
+// Remembers the tokens of the most recently used pieces, since text keeps
+// repeating its words, and their merges are the costly part of encode().
+// Safe to use from several threads.
+class PieceCache {
+ public:
+  explicit PieceCache(size_t capacity) : capacity_(capacity) {}
+
+  // Appends the tokens of piece to tokens, if it is cached, and returns how
+  // many there are, or 0 if it is not.
+  size_t get(std::string_view piece, std::vector<uint64_t>& tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = index_.find(piece);
+    if (iter == index_.end()) {
+      return 0;
+    }
+    entries_.splice(entries_.begin(), entries_, iter->second);
+    const auto& piece_tokens = iter->second->second;
+    tokens.insert(tokens.end(), piece_tokens.begin(), piece_tokens.end());
+    return piece_tokens.size();
+  }
+
+  void put(std::string_view piece, const std::vector<uint64_t>& tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0 || index_.count(piece) != 0) {
+      return;
+    }
+    if (entries_.size() == capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    entries_.emplace_front(std::string(piece), tokens);
+    // The key views the string of the list node, which never moves.
+    index_.emplace(entries_.front().first, entries_.begin());
+  }
+
+ private:
+  using Entry = std::pair<std::string, std::vector<uint64_t>>;
+
+  const size_t capacity_;
+  std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+};
+
 // ------------------------------Util end------------------------------------
 // -------------------------private method start-------------------------------
 
@@ -295,25 +435,99 @@ Tiktoken::_split_with_allowed_special_token(
   return std::make_pair(std::nullopt, input);
 }
 
-void Tiktoken::_encode(
-    re2::StringPiece& input,
+std::optional<uint64_t> Tiktoken::_find_token(std::string_view piece) const {
+  return _token_table ? _token_table->find(piece) : _encoder.find(piece);
+}
+
+uint64_t Tiktoken::_byte_pair_encode(
+    std::string_view piece,
+    std::vector<uint64_t>& ret) const {
+  if (piece.size() == 1) {
+    // TODO: is it possible that a single byte is not a token?
+    auto token = _find_token(piece);
+    if (!token) {
+      return 0;
+    }
+    ret.push_back(*token);
+    return 1;
+  }
+
+  const bool cacheable = piece.size() <= kMaxCachedPieceSize;
+  if (cacheable) {
+    if (auto num_tokens = _piece_cache->get(piece, ret)) {
+      return num_tokens;
+    }
+  }
+  auto tokens = _token_table ? _byte_pair_tokens(piece, *_token_table)
+                            : _byte_pair_tokens(piece, _encoder);
+  if (cacheable) {
+    _piece_cache->put(piece, tokens);
+  }
+  ret.insert(ret.end(), tokens.begin(), tokens.end());
+  return tokens.size();
+}
+
+void Tiktoken::_encode_chunk(
+    re2::StringPiece input,
     std::vector<uint64_t>& ret,
     uint64_t& last_piece_token_len) const {
-  std::string piece;
-  assert(_regex);
-  while (re2::RE2::FindAndConsume(&input, *_regex, &piece)) {
-    auto iter = _encoder.find(piece);
-    if (iter != _encoder.end()) {
+  // Asking for $0 only lets RE2 find the pieces with its DFA, instead of the
+  // much slower engines that extract submatches. The pieces tile the input
+  // except for the bytes no alternative matches, so each piece is matched
+  // anchored where the last one ended, and searched for if that fails.
+  re2::StringPiece match;
+  size_t pos = 0;
+  while (pos < input.size()) {
+    if (!_regex->Match(
+            input, pos, input.size(), re2::RE2::ANCHOR_START, &match, 1) &&
+        !_regex->Match(
+            input, pos, input.size(), re2::RE2::UNANCHORED, &match, 1)) {
+      break;
+    }
+    pos = match.data() + match.size() - input.data();
+    const std::string_view piece(match.data(), match.size());
+    if (auto token = _find_token(piece)) {
       last_piece_token_len = 1;
-      ret.push_back(iter->second);
+      ret.push_back(*token);
       continue;
     }
-    auto tokens = _byte_pair_encode(piece, _encoder);
-    last_piece_token_len = tokens.size();
-    ret.insert(ret.end(), tokens.begin(), tokens.end());
+    last_piece_token_len = _byte_pair_encode(piece, ret);
   }
 }
 
+void Tiktoken::_encode(
+    re2::StringPiece& input,
+    std::vector<uint64_t>& ret,
+    uint64_t& last_piece_token_len) const {
+  assert(_regex);
+  const size_t num_chunks =
+      std::min(_num_threads, input.size() / kMinParallelChunkSize);
+  if (num_chunks <= 1) {
+    _encode_chunk(input, ret, last_piece_token_len);
+    return;
+  }
+
+  const auto chunks = _split_into_chunks(input, num_chunks);
+  std::vector<std::vector<uint64_t>> chunk_tokens(chunks.size());
+  std::vector<uint64_t> chunk_last_piece_token_len(
+      chunks.size(), last_piece_token_len);
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      _encode_chunk(
+          chunks[i], chunk_tokens[i], chunk_last_piece_token_len[i]);
+    });
+  }
+  _encode_chunk(chunks[0], ret, chunk_last_piece_token_len[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 1; i < chunks.size(); ++i) {
+    ret.insert(ret.end(), chunk_tokens[i].begin(), chunk_tokens[i].end());
+  }
+  last_piece_token_len = chunk_last_piece_token_len.back();
+}
+
 template <typename T>
 std::pair<std::vector<uint64_t>, uint64_t> Tiktoken::_encode_with_special_token(
     const std::string& text,
@@ -368,7 +582,9 @@ Tiktoken::Tiktoken(
     : Tokenizer(),
       _special_tokens(std::move(special_tokens)),
       _bos_token_index(bos_token_index),
-      _eos_token_index(eos_token_index) {
+      _eos_token_index(eos_token_index),
+      _piece_cache(std::make_unique<PieceCache>(kPieceCacheCapacity)),
+      _num_threads(std::max(1U, std::thread::hardware_concurrency())) {
   ET_CHECK_MSG(
       _bos_token_index < _special_tokens->size(),
       "invalid bos_token_index %zu",
@@ -379,11 +595,30 @@ Tiktoken::Tiktoken(
       _eos_token_index);
 }
 
-Error Tiktoken::load(const std::string& path) {
-  _encoder = ET_UNWRAP(_load_encoder(path));
-  _special_token_encoder = _build_special_token_encoder(_encoder.size());
+Tiktoken::~Tiktoken() = default;
 
-  _decoder = ET_UNWRAP(_build_decoder(_encoder));
+Error Tiktoken::load(const std::string& path) {
+  size_t num_base_tokens = 0;
+  if (TokenTable::is_token_table(path)) {
+    // Used in place, so there is nothing to build but the special tokens.
+    auto token_table = ET_UNWRAP(TokenTable::load(path));
+    ET_CHECK_OR_RETURN_ERROR(
+        token_table.type() == TokenTable::Type::Tiktoken,
+        InvalidArgument,
+        "%s is not a Tiktoken token table",
+        path.c_str());
+    num_base_tokens = token_table.vocab_size();
+    _token_table.emplace(std::move(token_table));
+    _encoder = FlatEncoder();
+    _decoder.clear();
+  } else {
+    auto encoder = ET_UNWRAP(_load_encoder(path));
+    num_base_tokens = encoder.size();
+    _decoder = ET_UNWRAP(_build_decoder(encoder));
+    _encoder = FlatEncoder(encoder);
+    _token_table.reset();
+  }
+  _special_token_encoder = _build_special_token_encoder(num_base_tokens);
   _special_token_decoder = ET_UNWRAP(_build_decoder(_special_token_encoder));
 
   _regex = _create_regex(_pattern);
@@ -397,7 +632,7 @@ Error Tiktoken::load(const std::string& path) {
   (void)_special_token_regex->ReverseProgramSize();
 
   // initialize vocab_size, bos_tok, eos_tok
-  vocab_size_ = _encoder.size() + _special_token_encoder.size();
+  vocab_size_ = num_base_tokens + _special_token_encoder.size();
   bos_tok_ = _special_token_encoder.at(_special_tokens->at(_bos_token_index));
   eos_tok_ = _special_token_encoder.at(_special_tokens->at(_eos_token_index));
 
@@ -421,25 +656,35 @@ Tiktoken::encode(const std::string& text, int8_t bos, int8_t eos) const {
 }
 
 Result<std::string> Tiktoken::decode(uint64_t prev, uint64_t cur) const {
-  (void)prev;
-  ET_CHECK_OK_OR_RETURN_ERROR(Tokenizer::decode_verify(cur));
   std::string ret;
+  ET_CHECK_OK_OR_RETURN_ERROR(decode_into(prev, cur, ret));
+  return ret;
+}
 
-  std::string token_bytes;
+Error Tiktoken::decode_into(uint64_t prev, uint64_t cur, std::string& out)
+    const {
+  (void)prev;
+  ET_CHECK_OK_OR_RETURN_ERROR(Tokenizer::decode_verify(cur));
+  if (_token_table && cur < _token_table->vocab_size()) {
+    out += _token_table->token(cur);
+    return Error::Ok;
+  }
   auto iter = _decoder.find(cur);
   if (iter != _decoder.end()) {
-    token_bytes = iter->second;
+    out += iter->second;
+    return Error::Ok;
+  }
+  iter = _special_token_decoder.find(cur);
+  if (iter != _special_token_decoder.end()) {
+    out += iter->second;
   } else {
-    iter = _special_token_decoder.find(cur);
-    if (iter != _special_token_decoder.end()) {
-      token_bytes = iter->second;
-    } else {
-      ET_CHECK_MSG(false, "unknown token: %" PRIu64, cur);
-    }
+    ET_CHECK_MSG(false, "unknown token: %" PRIu64, cur);
   }
-  ret += token_bytes;
+  return Error::Ok;
+}
 
-  return ret;
+void Tiktoken::set_num_threads(size_t num_threads) {
+  _num_threads = std::max<size_t>(1, num_threads);
 }
 // -------------------------public method end-------------------------------
 
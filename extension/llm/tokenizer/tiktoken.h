@@ -8,10 +8,13 @@
 
 #pragma once
 
+#include <executorch/extension/llm/tokenizer/flat_encoder.h>
+#include <executorch/extension/llm/tokenizer/token_table.h>
 #include <executorch/extension/llm/tokenizer/tokenizer.h>
 #include <re2/re2.h>
 #include <memory>
 #include <optional>
+#include <string_view>
 #include <unordered_map>
 
 namespace executorch {
@@ -22,6 +25,8 @@ using Encoder = std::unordered_map<std::string, uint64_t>;
 using Decoder = std::unordered_map<uint64_t, std::string>;
 using Re2UPtr = std::unique_ptr<re2::RE2>;
 
+class PieceCache;
+
 class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
  public:
   /**
@@ -34,6 +39,12 @@ class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
       size_t bos_token_index,
       size_t eos_token_index);
 
+  ~Tiktoken() override;
+
+  /**
+   * Loads a Tiktoken artifact, or a token table that token_table.py
+   * converted from one, which is memory-mapped and used without parsing.
+   */
   ::executorch::runtime::Error load(const std::string& tokenizer_path) override;
 
   ::executorch::runtime::Result<std::vector<uint64_t>>
@@ -43,6 +54,18 @@ class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
       uint64_t prev_token,
       uint64_t token) const override;
 
+  ::executorch::runtime::Error decode_into(
+      uint64_t prev_token,
+      uint64_t token,
+      std::string& out) const override;
+
+  /**
+   * Sets how many threads encode() may use. Long inputs are split at the
+   * start of lines, which no regex piece crosses, and the parts are encoded
+   * in parallel. Defaults to the number of hardware threads.
+   */
+  void set_num_threads(size_t num_threads);
+
  private:
   template <typename T>
   std::pair<std::optional<std::string>, re2::StringPiece>
@@ -55,6 +78,17 @@ class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
       std::vector<uint64_t>& ret,
       uint64_t& last_piece_token_len) const;
 
+  void _encode_chunk(
+      re2::StringPiece input,
+      std::vector<uint64_t>& ret,
+      uint64_t& last_piece_token_len) const;
+
+  std::optional<uint64_t> _find_token(std::string_view piece) const;
+
+  uint64_t _byte_pair_encode(
+      std::string_view piece,
+      std::vector<uint64_t>& ret) const;
+
   template <typename T>
   std::pair<std::vector<uint64_t>, uint64_t> _encode_with_special_token(
       const std::string& text,
@@ -68,13 +102,19 @@ class ET_EXPERIMENTAL Tiktoken : public Tokenizer {
   // Removed negative lookahead \s+(?!\S) since it's not supported by RE2.
   const std::string _pattern =
       R"((?i:'s|'t|'re|'ve|'m|'ll|'d)|[^\r\n\p{L}\p{N}]?\p{L}+|\p{N}{1,3}| ?[^\s\p{L}\p{N}]+[\r\n]*|\s*[\r\n]+|\s+)";
-  Encoder _encoder;
+  // The base tokens, from a token table if that is what was loaded.
+  FlatEncoder _encoder;
+  std::optional<TokenTable> _token_table;
   Encoder _special_token_encoder;
   Decoder _decoder;
   Decoder _special_token_decoder;
 
   Re2UPtr _regex;
   Re2UPtr _special_token_regex;
+
+  // The tokens of recently encoded pieces that are not a single token.
+  std::unique_ptr<PieceCache> _piece_cache;
+  size_t _num_threads;
 };
 
 } // namespace llm
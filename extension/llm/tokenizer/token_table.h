@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// A tokenizer vocabulary that is memory-mapped and used in place, without
+// parsing it. Written by token_table.py from a Tiktoken or BPE artifact.
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/log.h>
+#include <cinttypes>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <vector>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace executorch {
+namespace extension {
+namespace llm {
+
+/**
+ * The header of a token table file. The sections follow it in this order,
+ * each starting at a multiple of 8 bytes, with little-endian integers:
+ *
+ *   TokenTableEntry entries[vocab_size]   Where the bytes of each token id are.
+ *   float scores[vocab_size]              Merge scores, for BPE tables only.
+ *   uint32_t seeds[num_buckets]           Per-bucket seeds of the perfect hash.
+ *   uint32_t slots[num_slots]             Token id of each hash slot, or
+ *                                         kTokenTableNoToken.
+ *   char strings[strings_size]            The bytes of all tokens, in sorted
+ *                                         order, each followed by a NUL.
+ *
+ * A token's bytes hash to a bucket, and the bucket's seed to the only slot
+ * that can hold it, so a lookup costs one hash and one comparison.
+ */
+struct TokenTableHeader {
+  char magic[4];
+  uint32_t version;
+  // A TokenTable::Type.
+  uint32_t type;
+  uint32_t vocab_size;
+  // The BOS and EOS ids and the longest token, for BPE tables only.
+  uint32_t bos_id;
+  uint32_t eos_id;
+  uint32_t max_token_length;
+  uint32_t num_buckets;
+  uint32_t num_slots;
+  uint32_t reserved;
+  uint64_t strings_size;
+};
+static_assert(sizeof(TokenTableHeader) == 48, "Unexpected header size");
+
+struct TokenTableEntry {
+  // Offset of the bytes of the token in the strings section.
+  uint32_t offset;
+  // 0 when no token has this id.
+  uint32_t length;
+};
+
+constexpr char kTokenTableMagic[4] = {'E', 'T', 'T', 'K'};
+constexpr uint32_t kTokenTableVersion = 1;
+constexpr uint32_t kTokenTableNoToken = 0xFFFFFFFF;
+
+class ET_EXPERIMENTAL TokenTable {
+ public:
+  enum class Type : uint32_t {
+    // Token ids are the ranks of their merges.
+    Tiktoken = 0,
+    // The sentencepiece-style vocabulary of BPETokenizer, merged by score.
+    BPE = 1,
+  };
+
+  /**
+   * @return Whether the file at path starts like a token table, so that
+   * tokenizers can tell it from their other formats.
+   */
+  static bool is_token_table(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(kTokenTableMagic)];
+    return file.read(magic, sizeof(magic)) &&
+        std::memcmp(magic, kTokenTableMagic, sizeof(magic)) == 0;
+  }
+
+  /**
+   * Maps the token table at path into memory. Only its header is read here;
+   * the pages of the rest are loaded by the OS as tokens are looked up.
+   */
+  static ::executorch::runtime::Result<TokenTable> load(
+      const std::string& path) {
+    TokenTable table;
+    ET_CHECK_OK_OR_RETURN_ERROR(table.map(path));
+    ET_CHECK_OR_RETURN_ERROR(
+        table.size_ >= sizeof(TokenTableHeader),
+        InvalidArgument,
+        "Token table %s is too small",
+        path.c_str());
+    const auto* header = reinterpret_cast<const TokenTableHeader*>(table.data_);
+    ET_CHECK_OR_RETURN_ERROR(
+        std::memcmp(
+            header->magic, kTokenTableMagic, sizeof(kTokenTableMagic)) == 0,
+        InvalidArgument,
+        "%s is not a token table",
+        path.c_str());
+    ET_CHECK_OR_RETURN_ERROR(
+        header->version == kTokenTableVersion,
+        InvalidArgument,
+        "Unsupported token table version %" PRIu32,
+        header->version);
+    ET_CHECK_OR_RETURN_ERROR(
+        header->type <= static_cast<uint32_t>(Type::BPE),
+        InvalidArgument,
+        "Unknown token table type %" PRIu32,
+        header->type);
+    ET_CHECK_OR_RETURN_ERROR(
+        (header->num_buckets == 0) == (header->vocab_size == 0) &&
+            header->num_slots >= header->vocab_size,
+        InvalidArgument,
+        "Invalid hash index in token table %s",
+        path.c_str());
+
+    const bool has_scores = header->type == static_cast<uint32_t>(Type::BPE);
+    uint64_t offset = sizeof(TokenTableHeader);
+    auto section = [&](uint64_t size) {
+      const uint64_t start = offset;
+      offset = (offset + size + 7) & ~uint64_t(7);
+      return start;
+    };
+    const uint64_t entries_offset =
+        section(uint64_t(header->vocab_size) * sizeof(TokenTableEntry));
+    const uint64_t scores_offset =
+        section(has_scores ? uint64_t(header->vocab_size) * sizeof(float) : 0);
+    const uint64_t seeds_offset =
+        section(uint64_t(header->num_buckets) * sizeof(uint32_t));
+    const uint64_t slots_offset =
+        section(uint64_t(header->num_slots) * sizeof(uint32_t));
+    const uint64_t strings_offset = section(header->strings_size);
+    ET_CHECK_OR_RETURN_ERROR(
+        strings_offset + header->strings_size <= table.size_,
+        InvalidArgument,
+        "Token table %s is truncated",
+        path.c_str());
+
+    table.header_ = header;
+    table.entries_ = reinterpret_cast<const TokenTableEntry*>(
+        table.data_ + entries_offset);
+    table.scores_ = has_scores
+        ? reinterpret_cast<const float*>(table.data_ + scores_offset)
+        : nullptr;
+    table.seeds_ =
+        reinterpret_cast<const uint32_t*>(table.data_ + seeds_offset);
+    table.slots_ =
+        reinterpret_cast<const uint32_t*>(table.data_ + slots_offset);
+    table.strings_ = table.data_ + strings_offset;
+    return table;
+  }
+
+  TokenTable(TokenTable&& other) noexcept {
+    *this = std::move(other);
+  }
+
+  TokenTable& operator=(TokenTable&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data_ = other.data_;
+      size_ = other.size_;
+#ifdef _WIN32
+      buffer_ = std::move(other.buffer_);
+#endif
+      header_ = other.header_;
+      entries_ = other.entries_;
+      scores_ = other.scores_;
+      seeds_ = other.seeds_;
+      slots_ = other.slots_;
+      strings_ = other.strings_;
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  TokenTable(const TokenTable&) = delete;
+  TokenTable& operator=(const TokenTable&) = delete;
+
+  ~TokenTable() {
+    unmap();
+  }
+
+  Type type() const {
+    return static_cast<Type>(header_->type);
+  }
+
+  uint32_t vocab_size() const {
+    return header_->vocab_size;
+  }
+
+  uint32_t bos_id() const {
+    return header_->bos_id;
+  }
+
+  uint32_t eos_id() const {
+    return header_->eos_id;
+  }
+
+  uint32_t max_token_length() const {
+    return header_->max_token_length;
+  }
+
+  /**
+   * @return The id of the token with these bytes, or nullopt if there is
+   * none.
+   */
+  std::optional<uint64_t> find(std::string_view bytes) const {
+    if (header_->vocab_size == 0) {
+      return std::nullopt;
+    }
+    const uint64_t hash = hash_bytes(bytes);
+    const uint32_t seed = seeds_[(hash >> 32) % header_->num_buckets];
+    const uint32_t id = slots_[slot_of(hash, seed) % header_->num_slots];
+    if (id == kTokenTableNoToken || token(id) != bytes) {
+      return std::nullopt;
+    }
+    return id;
+  }
+
+  /**
+   * @return The bytes of token id, empty if no token has it.
+   */
+  std::string_view token(uint64_t id) const {
+    if (id >= header_->vocab_size) {
+      return {};
+    }
+    const TokenTableEntry& entry = entries_[id];
+    // Bounds are checked here rather than in load(), which would otherwise
+    // have to read every entry.
+    if (uint64_t(entry.offset) + entry.length >= header_->strings_size) {
+      return {};
+    }
+    return std::string_view(strings_ + entry.offset, entry.length);
+  }
+
+  /**
+   * @return The NUL-terminated bytes of token id, empty if no token has it.
+   */
+  const char* c_str(uint64_t id) const {
+    const std::string_view bytes = token(id);
+    return bytes.empty() ? "" : bytes.data();
+  }
+
+  /**
+   * @return The merge score of token id, for BPE tables.
+   */
+  float score(uint64_t id) const {
+    return scores_ != nullptr && id < header_->vocab_size ? scores_[id] : 0.0f;
+  }
+
+  // The hash functions shared with token_table.py, exposed for testing.
+
+  // 64-bit FNV-1a.
+  static uint64_t hash_bytes(std::string_view bytes) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : bytes) {
+      hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  // The finalizer of splitmix64, over the hash mixed with a bucket's seed.
+  static uint64_t slot_of(uint64_t hash, uint32_t seed) {
+    uint64_t x = hash ^ (uint64_t(seed) * 0x9E3779B97F4A7C15ull);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+  }
+
+ private:
+  TokenTable() = default;
+
+  ::executorch::runtime::Error map(const std::string& path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    ET_CHECK_OR_RETURN_ERROR(
+        file, InvalidArgument, "Failed to open %s", path.c_str());
+    buffer_.resize(file.tellg());
+    file.seekg(0);
+    ET_CHECK_OR_RETURN_ERROR(
+        file.read(buffer_.data(), buffer_.size()),
+        InvalidArgument,
+        "Failed to read %s",
+        path.c_str());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    ET_CHECK_OR_RETURN_ERROR(
+        fd >= 0, InvalidArgument, "Failed to open %s", path.c_str());
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size == 0) {
+      ::close(fd);
+      ET_LOG(Error, "Failed to get the size of %s", path.c_str());
+      return ::executorch::runtime::Error::InvalidArgument;
+    }
+    void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file is closed.
+    ::close(fd);
+    ET_CHECK_OR_RETURN_ERROR(
+        data != MAP_FAILED, AccessFailed, "Failed to map %s", path.c_str());
+    data_ = static_cast<const char*>(data);
+    size_ = st.st_size;
+#endif
+    return ::executorch::runtime::Error::Ok;
+  }
+
+  void unmap() {
+#ifndef _WIN32
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+#ifdef _WIN32
+  std::vector<char> buffer_;
+#endif
+  const TokenTableHeader* header_ = nullptr;
+  const TokenTableEntry* entries_ = nullptr;
+  const float* scores_ = nullptr;
+  const uint32_t* seeds_ = nullptr;
+  const uint32_t* slots_ = nullptr;
+  const char* strings_ = nullptr;
+};
+
+} // namespace llm
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,226 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+
+# Script to convert a Tiktoken or BPE tokenizer artifact into a token table,
+# which the C++ tokenizers memory-map and use without parsing. See
+# token_table.h for the layout.
+
+import argparse
+import base64
+import logging
+import struct
+from typing import List, Optional, Tuple
+
+MAGIC = b"ETTK"
+VERSION = 1
+TYPE_TIKTOKEN = 0
+TYPE_BPE = 1
+NO_TOKEN = 0xFFFFFFFF
+
+HEADER_FORMAT = "<4s9IQ"
+# Keys per bucket of the perfect hash, and slots per key.
+KEYS_PER_BUCKET = 4
+SLOTS_PER_KEY = 1.25
+
+_MASK = (1 << 64) - 1
+
+
+def hash_bytes(data: bytes) -> int:
+    """64-bit FNV-1a, as TokenTable::hash_bytes()."""
+    h = 14695981039346656037
+    for c in data:
+        h = ((h ^ c) * 1099511628211) & _MASK
+    return h
+
+
+def slot_of(h: int, seed: int) -> int:
+    """splitmix64 finalizer over a hash and a seed, as TokenTable::slot_of()."""
+    x = h ^ ((seed * 0x9E3779B97F4A7C15) & _MASK)
+    x = ((x ^ (x >> 30)) * 0xBF58476D1CE4E5B9) & _MASK
+    x = ((x ^ (x >> 27)) * 0x94D049BB133111EB) & _MASK
+    return x ^ (x >> 31)
+
+
+def load_tiktoken(path: str) -> List[Optional[bytes]]:
+    """Reads the "<base64 token> <rank>" lines of a Tiktoken artifact."""
+    ranks = {}
+    with open(path, "rb") as f:
+        for line in f:
+            if not line.strip():
+                continue
+            token, rank = line.split()
+            ranks[int(rank)] = base64.b64decode(token, validate=True)
+    if not ranks:
+        raise ValueError(f"{path} has no Tiktoken ranks")
+    tokens: List[Optional[bytes]] = [None] * (max(ranks) + 1)
+    for rank, token in ranks.items():
+        tokens[rank] = token
+    return tokens
+
+
+def load_bpe(path: str) -> Tuple[List[bytes], List[float], int, int, int]:
+    """Reads the artifact of tokenizer.py, the way BPETokenizer::load() does."""
+    with open(path, "rb") as f:
+        data = f.read()
+    vocab_size, bos_id, eos_id, max_token_length = struct.unpack_from("<4i", data)
+    offset = 16
+    tokens, scores = [], []
+    for _ in range(vocab_size):
+        if offset + 8 > len(data):
+            # Like BPETokenizer, pad a truncated vocabulary.
+            tokens.append(b"<pad>")
+            scores.append(0.0)
+            continue
+        score, length = struct.unpack_from("<fi", data, offset)
+        offset += 8
+        tokens.append(data[offset : offset + length])
+        scores.append(score)
+        offset += length
+    return tokens, scores, bos_id, eos_id, max_token_length
+
+
+def _build_perfect_hash(tokens: List[Optional[bytes]]) -> Tuple[List[int], List[int]]:
+    """
+    Hash and displace: every bucket of keys gets the first seed that sends all
+    of them to free slots, trying the largest buckets first.
+    """
+    # Lookups return the first id of a duplicate token, like bsearch in BPETokenizer
+    # would return one of them.
+    keys = {}
+    for token_id, token in enumerate(tokens):
+        if token and token not in keys:
+            keys[token] = token_id
+    num_buckets = max(1, -(-len(keys) // KEYS_PER_BUCKET))
+    num_slots = max(len(tokens), int(len(keys) * SLOTS_PER_KEY) + 1)
+
+    buckets: List[List[Tuple[int, int]]] = [[] for _ in range(num_buckets)]
+    for token, token_id in keys.items():
+        h = hash_bytes(token)
+        buckets[(h >> 32) % num_buckets].append((h, token_id))
+
+    seeds = [0] * num_buckets
+    slots = [NO_TOKEN] * num_slots
+    for bucket in sorted(range(num_buckets), key=lambda b: -len(buckets[b])):
+        entries = buckets[bucket]
+        if not entries:
+            break
+        seed = 0
+        while True:
+            candidate = [slot_of(h, seed) % num_slots for h, _ in entries]
+            if len(set(candidate)) == len(candidate) and all(
+                slots[s] == NO_TOKEN for s in candidate
+            ):
+                break
+            seed += 1
+        seeds[bucket] = seed
+        for s, (_, token_id) in zip(candidate, entries):
+            slots[s] = token_id
+    return seeds, slots
+
+
+def _align(data: bytearray) -> None:
+    data.extend(b"\0" * (-len(data) % 8))
+
+
+def write_token_table(
+    output_path: str,
+    tokens: List[Optional[bytes]],
+    table_type: int,
+    scores: Optional[List[float]] = None,
+    bos_id: int = 0,
+    eos_id: int = 0,
+    max_token_length: int = 0,
+) -> None:
+    """
+    Writes a token table.
+
+    :param tokens: The bytes of each token id, None for the ids without one.
+    :param table_type: TYPE_TIKTOKEN, where ids are merge ranks, or TYPE_BPE,
+        which merges by scores.
+    :param scores: The merge score of each token, for TYPE_BPE.
+    """
+    seeds, slots = _build_perfect_hash(tokens)
+
+    # The strings in sorted order, with their offsets by token id.
+    strings = bytearray()
+    offsets = {}
+    for token in sorted({t for t in tokens if t}):
+        offsets[token] = len(strings)
+        strings.extend(token + b"\0")
+
+    data = bytearray(
+        struct.pack(
+            HEADER_FORMAT,
+            MAGIC,
+            VERSION,
+            table_type,
+            len(tokens),
+            bos_id,
+            eos_id,
+            max_token_length,
+            len(seeds),
+            len(slots),
+            0,
+            len(strings),
+        )
+    )
+    for token in tokens:
+        data.extend(struct.pack("<2I", offsets.get(token, 0), len(token or b"")))
+    _align(data)
+    if table_type == TYPE_BPE:
+        assert scores is not None and len(scores) == len(tokens)
+        data.extend(struct.pack(f"<{len(scores)}f", *scores))
+        _align(data)
+    data.extend(struct.pack(f"<{len(seeds)}I", *seeds))
+    _align(data)
+    data.extend(struct.pack(f"<{len(slots)}I", *slots))
+    _align(data)
+    data.extend(strings)
+
+    with open(output_path, "wb") as f:
+        f.write(data)
+    logging.info(f"Wrote token table of {len(tokens)} tokens to {output_path}")
+
+
+def convert(tokenizer_path: str, output_path: str) -> None:
+    """Converts a Tiktoken artifact, or else a BPE one, into a token table."""
+    try:
+        tokens = load_tiktoken(tokenizer_path)
+    except (ValueError, UnicodeDecodeError):
+        tokens, scores, bos_id, eos_id, max_token_length = load_bpe(tokenizer_path)
+        write_token_table(
+            output_path,
+            tokens,
+            TYPE_BPE,
+            scores=scores,
+            bos_id=bos_id,
+            eos_id=eos_id,
+            max_token_length=max_token_length,
+        )
+        return
+    write_token_table(output_path, tokens, TYPE_TIKTOKEN)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "-t",
+        "--tokenizer-path",
+        type=str,
+        required=True,
+        help="path to a Tiktoken artifact, or to a BPE one written by tokenizer.py",
+    )
+    parser.add_argument(
+        "-o",
+        "--output-path",
+        type=str,
+        required=True,
+        help="output path of the token table",
+    )
+    args = parser.parse_args()
+    logging.basicConfig(level=logging.INFO)
+    convert(args.tokenizer_path, args.output_path)
@@ -52,6 +52,21 @@ class ET_EXPERIMENTAL Tokenizer {
       uint64_t prev_token,
       uint64_t token) const = 0;
 
+  /**
+   * Like decode(), but appends the bytes of token to out instead of returning
+   * a new string, so that a caller reusing out does not allocate per token.
+   * The bytes may end inside a UTF-8 code point; see StreamingDecoder.
+   */
+  virtual ::executorch::runtime::Error
+  decode_into(uint64_t prev_token, uint64_t token, std::string& out) const {
+    auto piece = decode(prev_token, token);
+    if (!piece.ok()) {
+      return piece.error();
+    }
+    out += piece.get();
+    return ::executorch::runtime::Error::Ok;
+  }
+
   // getters
   int32_t vocab_size() const {
     return vocab_size_;
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/malloc_kernel_cache.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <new>
+
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+Error MallocKernelCache::register_constant(const void* data, size_t nbytes) {
+  ET_CHECK_OR_RETURN_ERROR(
+      data != nullptr, InvalidArgument, "Constant data is null");
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Constants shared by several methods are registered once by each.
+  auto& registered_nbytes = constants_[data];
+  registered_nbytes = std::max(registered_nbytes, nbytes);
+  return Error::Ok;
+}
+
+bool MallocKernelCache::is_constant(const void* data) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return constants_.count(data) > 0;
+}
+
+size_t MallocKernelCache::num_entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto& it : entries_) {
+    count += it.second->ready ? 1 : 0;
+  }
+  return count;
+}
+
+size_t MallocKernelCache::entries_nbytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t nbytes = 0;
+  for (const auto& it : entries_) {
+    nbytes += it.second->ready ? it.second->nbytes : 0;
+  }
+  return nbytes;
+}
+
+Result<const void*> MallocKernelCache::get_or_create_impl(
+    const void* constant,
+    uint32_t tag,
+    size_t nbytes,
+    InitFunction init,
+    void* init_context) {
+  Entry* entry = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ET_CHECK_OR_RETURN_ERROR(
+        constants_.count(constant) > 0,
+        NotFound,
+        "%p is not a registered constant",
+        constant);
+    auto& slot = entries_[std::make_pair(constant, tag)];
+    if (slot == nullptr) {
+      slot.reset(new Entry(nbytes));
+    }
+    entry = slot.get();
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      entry->nbytes == nbytes,
+      InvalidArgument,
+      "Entry for %p with tag 0x%" PRIx32 " has %zu bytes, not %zu",
+      constant,
+      tag,
+      entry->nbytes,
+      nbytes);
+  if (entry->ready.load(std::memory_order_acquire)) {
+    return entry->data.get();
+  }
+
+  // Entries are never removed, so this can be used without holding mutex_.
+  std::lock_guard<std::mutex> entry_lock(entry->mutex);
+  if (!entry->ready.load(std::memory_order_relaxed)) {
+    std::unique_ptr<uint8_t[]> data(new (std::nothrow) uint8_t[nbytes]);
+    ET_CHECK_OR_RETURN_ERROR(
+        data != nullptr || nbytes == 0,
+        MemoryAllocationFailed,
+        "Failed to allocate %zu bytes for an entry",
+        nbytes);
+    // A failed entry is left empty, so that the next caller tries again.
+    Error err = init(init_context, data.get(), nbytes);
+    if (err != Error::Ok) {
+      return err;
+    }
+    entry->data = std::move(data);
+    entry->ready.store(true, std::memory_order_release);
+  }
+  return entry->data.get();
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <executorch/runtime/kernel/kernel_cache.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: A KernelCache that allocates its entries with malloc() and
+ * frees them when destroyed.
+ */
+class MallocKernelCache final : public executorch::runtime::KernelCache {
+ public:
+  MallocKernelCache() = default;
+
+  MallocKernelCache(const MallocKernelCache&) = delete;
+  MallocKernelCache& operator=(const MallocKernelCache&) = delete;
+  MallocKernelCache(MallocKernelCache&&) = delete;
+  MallocKernelCache& operator=(MallocKernelCache&&) = delete;
+
+  ET_NODISCARD executorch::runtime::Error register_constant(
+      const void* data,
+      size_t nbytes) override;
+
+  bool is_constant(const void* data) const override;
+
+  /// The number of entries that have been created.
+  size_t num_entries() const;
+
+  /// The total size of the entries that have been created, in bytes.
+  size_t entries_nbytes() const;
+
+ protected:
+  ET_NODISCARD executorch::runtime::Result<const void*> get_or_create_impl(
+      const void* constant,
+      uint32_t tag,
+      size_t nbytes,
+      InitFunction init,
+      void* init_context) override;
+
+ private:
+  struct Entry {
+    explicit Entry(size_t nbytes_) : nbytes(nbytes_) {}
+
+    const size_t nbytes;
+    // Held while creating the data, so that only one thread creates it.
+    std::mutex mutex;
+    std::unique_ptr<uint8_t[]> data;
+    std::atomic<bool> ready{false};
+  };
+
+  mutable std::mutex mutex_;
+  // The size of each registered constant, by its data.
+  std::unordered_map<const void*, size_t> constants_;
+  std::map<std::pair<const void*, uint32_t>, std::unique_ptr<Entry>> entries_;
+};
+
+} // namespace extension
+} // namespace executorch
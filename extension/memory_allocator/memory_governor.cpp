@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/memory_governor.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <unordered_set>
+#include <utility>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace extension {
+
+using runtime::Error;
+
+MemoryGovernor::ScopedUse::ScopedUse(
+    MemoryGovernor* governor,
+    ClientId client)
+    : governor_(governor), client_(client) {
+  if (governor_ != nullptr) {
+    governor_->set_in_use(client_, true);
+  }
+}
+
+MemoryGovernor::ScopedUse::ScopedUse(ScopedUse&& other) noexcept
+    : governor_(other.governor_), client_(other.client_) {
+  other.governor_ = nullptr;
+}
+
+MemoryGovernor::ScopedUse& MemoryGovernor::ScopedUse::operator=(
+    ScopedUse&& other) noexcept {
+  if (this != &other) {
+    if (governor_ != nullptr) {
+      governor_->set_in_use(client_, false);
+    }
+    governor_ = other.governor_;
+    client_ = other.client_;
+    other.governor_ = nullptr;
+  }
+  return *this;
+}
+
+MemoryGovernor::ScopedUse::~ScopedUse() {
+  if (governor_ != nullptr) {
+    governor_->set_in_use(client_, false);
+  }
+}
+
+MemoryGovernor::MemoryGovernor(Options options)
+    : budget_(options.budget), pressure_ratio_(options.pressure_ratio) {}
+
+MemoryGovernor& MemoryGovernor::global() {
+  // Never destroyed, so that Modules with static storage duration can still
+  // release their memory when they are destroyed.
+  static MemoryGovernor* governor = new MemoryGovernor();
+  return *governor;
+}
+
+void MemoryGovernor::set_budget(size_t budget) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  budget_ = budget;
+  if (budget_ > 0 && total_ > budget_) {
+    evict_until(budget_, /*except=*/0);
+  }
+}
+
+MemoryGovernor::ClientId MemoryGovernor::register_client(
+    std::string name,
+    EvictFunction evict) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const ClientId id = next_client_++;
+  Client& client = clients_[id];
+  client.name = std::move(name);
+  client.evict = std::move(evict);
+  client.last_used = ++use_count_;
+  return id;
+}
+
+void MemoryGovernor::unregister_client(ClientId client) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto it = clients_.find(client);
+  if (it == clients_.end()) {
+    return;
+  }
+  for (size_t i = 0; i < kNumCategories; ++i) {
+    by_category_[i] -= it->second.nbytes[i];
+  }
+  total_ -= it->second.total;
+  clients_.erase(it);
+}
+
+void MemoryGovernor::touch(ClientId client) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto it = clients_.find(client);
+  if (it != clients_.end()) {
+    it->second.last_used = ++use_count_;
+  }
+}
+
+void MemoryGovernor::set_in_use(ClientId client, bool in_use) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto it = clients_.find(client);
+  if (it == clients_.end()) {
+    return;
+  }
+  if (in_use) {
+    ++it->second.in_use;
+  } else if (it->second.in_use > 0) {
+    --it->second.in_use;
+  }
+  it->second.last_used = ++use_count_;
+}
+
+Error MemoryGovernor::reserve(
+    ClientId client,
+    Category category,
+    size_t nbytes) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  ET_CHECK_OR_RETURN_ERROR(
+      clients_.count(client) != 0,
+      InvalidArgument,
+      "Client %" PRIu64 " is not registered",
+      client);
+  if (budget_ > 0 && total_ + nbytes > budget_) {
+    bool fits = nbytes <= budget_ && evict_until(budget_ - nbytes, client);
+    if (!fits && nbytes <= budget_) {
+      notify_pressure(Pressure::Critical);
+      fits = total_ + nbytes <= budget_;
+    }
+    if (!fits) {
+      ET_LOG(
+          Error,
+          "Reserving %zu bytes for %s exceeds the budget: %zu of %zu bytes "
+          "in use",
+          nbytes,
+          clients_.at(client).name.c_str(),
+          total_,
+          budget_);
+      return Error::MemoryAllocationFailed;
+    }
+  }
+  // An evict function or pressure callback may have unregistered the client.
+  auto it = clients_.find(client);
+  ET_CHECK_OR_RETURN_ERROR(
+      it != clients_.end(),
+      InvalidArgument,
+      "Client %" PRIu64 " is not registered",
+      client);
+  const auto index = static_cast<size_t>(category);
+  it->second.nbytes[index] += nbytes;
+  it->second.total += nbytes;
+  it->second.last_used = ++use_count_;
+  by_category_[index] += nbytes;
+  total_ += nbytes;
+
+  if (budget_ > 0 && !under_pressure_ &&
+      total_ > static_cast<size_t>(budget_ * pressure_ratio_)) {
+    under_pressure_ = true;
+    notify_pressure(Pressure::Moderate);
+  }
+  return Error::Ok;
+}
+
+void MemoryGovernor::release(
+    ClientId client,
+    Category category,
+    size_t nbytes) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  auto it = clients_.find(client);
+  if (it == clients_.end()) {
+    return;
+  }
+  const auto index = static_cast<size_t>(category);
+  nbytes = std::min(nbytes, it->second.nbytes[index]);
+  it->second.nbytes[index] -= nbytes;
+  it->second.total -= nbytes;
+  by_category_[index] -= nbytes;
+  total_ -= nbytes;
+  if (total_ <= static_cast<size_t>(budget_ * pressure_ratio_)) {
+    under_pressure_ = false;
+  }
+}
+
+size_t MemoryGovernor::trim(size_t target) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const size_t before = total_;
+  evict_until(target, /*except=*/0);
+  return before > total_ ? before - total_ : 0;
+}
+
+bool MemoryGovernor::evict_until(size_t target, ClientId except) {
+  // Each client is evicted at most once, in case it can't give back all of
+  // its memory.
+  std::unordered_set<ClientId> evicted;
+  while (total_ > target) {
+    auto victim = clients_.end();
+    for (auto it = clients_.begin(); it != clients_.end(); ++it) {
+      const Client& client = it->second;
+      if (it->first == except || !client.evict || client.in_use > 0 ||
+          client.total == 0 || evicted.count(it->first) != 0) {
+        continue;
+      }
+      if (victim == clients_.end() ||
+          client.last_used < victim->second.last_used) {
+        victim = it;
+      }
+    }
+    if (victim == clients_.end()) {
+      return false;
+    }
+    evicted.insert(victim->first);
+    ++num_evictions_;
+    ET_LOG(
+        Info,
+        "Evicting %s to free %zu bytes",
+        victim->second.name.c_str(),
+        victim->second.total);
+    // Copied, since the client may unregister while it is evicted.
+    const EvictFunction evict = victim->second.evict;
+    evict();
+  }
+  return true;
+}
+
+void MemoryGovernor::notify_pressure(Pressure pressure) {
+  // Copied, since a callback may add or remove callbacks.
+  const auto callbacks = callbacks_;
+  for (const auto& callback : callbacks) {
+    callback.second(pressure);
+  }
+}
+
+size_t MemoryGovernor::add_pressure_callback(PressureCallback callback) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  const size_t id = next_callback_++;
+  callbacks_.emplace_back(id, std::move(callback));
+  return id;
+}
+
+void MemoryGovernor::remove_pressure_callback(size_t id) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  callbacks_.erase(
+      std::remove_if(
+          callbacks_.begin(),
+          callbacks_.end(),
+          [id](const auto& callback) { return callback.first == id; }),
+      callbacks_.end());
+}
+
+size_t MemoryGovernor::total() const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  return total_;
+}
+
+MemoryGovernor::Breakdown MemoryGovernor::breakdown() const {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  Breakdown breakdown;
+  breakdown.budget = budget_;
+  breakdown.total = total_;
+  breakdown.by_category = by_category_;
+  breakdown.num_evictions = num_evictions_;
+  breakdown.clients.reserve(clients_.size());
+  for (const auto& entry : clients_) {
+    ClientUsage usage;
+    usage.id = entry.first;
+    usage.name = entry.second.name;
+    usage.nbytes = entry.second.nbytes;
+    usage.evictable = static_cast<bool>(entry.second.evict);
+    usage.in_use = entry.second.in_use > 0;
+    breakdown.clients.push_back(std::move(usage));
+  }
+  std::sort(
+      breakdown.clients.begin(),
+      breakdown.clients.end(),
+      [this](const ClientUsage& a, const ClientUsage& b) {
+        return clients_.at(a.id).last_used < clients_.at(b.id).last_used;
+      });
+  return breakdown;
+}
+
+GovernedMemoryAllocator::GovernedMemoryAllocator(
+    std::unique_ptr<runtime::MemoryAllocator> allocator,
+    MemoryGovernor& governor,
+    MemoryGovernor::ClientId client,
+    MemoryGovernor::Category category)
+    : MemoryAllocator(0, nullptr),
+      allocator_(std::move(allocator)),
+      governor_(governor),
+      client_(client),
+      category_(category) {}
+
+GovernedMemoryAllocator::~GovernedMemoryAllocator() {
+  governor_.release(client_, category_, reserved_);
+}
+
+void* GovernedMemoryAllocator::allocate(size_t size, size_t alignment) {
+  if (governor_.reserve(client_, category_, size) != Error::Ok) {
+    return nullptr;
+  }
+  void* data = allocator_->allocate(size, alignment);
+  if (data == nullptr) {
+    governor_.release(client_, category_, size);
+    return nullptr;
+  }
+  reserved_ += size;
+  return data;
+}
+
+void GovernedMemoryAllocator::reset() {
+  allocator_->reset();
+  governor_.release(client_, category_, reserved_);
+  reserved_ = 0;
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: Accounts for the memory that the Modules, delegates and other
+ * clients of a process hold, against one budget, so that loading another
+ * model evicts idle ones instead of getting the process killed.
+ *
+ * Each client registers, then reserves memory before it allocates it and
+ * releases it when it frees it. A client that can give its memory back, like
+ * a Module that can unload its methods and load them again when needed,
+ * registers an evict function. When a reservation doesn't fit in the budget,
+ * the governor evicts the idle clients that were used least recently until
+ * it fits, then asks the pressure callbacks to free memory, and otherwise
+ * fails with Error::MemoryAllocationFailed.
+ *
+ * Evict functions and pressure callbacks are called on the thread that
+ * reserves, with the governor locked, so they may release memory but must
+ * not wait on a lock that is held while calling into the governor. The
+ * governor is thread-safe.
+ */
+class MemoryGovernor final {
+ public:
+  /// What the memory of a client is used for.
+  enum class Category : uint8_t {
+    /// The memory-planned buffers of methods.
+    PlannedMemory,
+    /// Memory that methods allocate when they load, like their values and
+    /// the state of their kernels.
+    Method,
+    /// Program data and constant tensors.
+    Constants,
+    /// Memory that delegates allocate internally, like workspaces and caches.
+    Delegate,
+    /// Anything else.
+    Other,
+  };
+  static constexpr size_t kNumCategories = 5;
+
+  /// How urgently a pressure callback should free memory.
+  enum class Pressure : uint8_t {
+    /// The usage crossed `pressure_ratio` of the budget. Free caches that are
+    /// cheap to rebuild.
+    Moderate,
+    /// A reservation doesn't fit even after evicting the idle clients. Free
+    /// everything that can be rebuilt.
+    Critical,
+  };
+
+  struct Options {
+    /// The most bytes that the clients may hold in total, or 0 for no limit,
+    /// in which case the governor only accounts for memory.
+    size_t budget = 0;
+    /// The fraction of the budget above which the pressure callbacks are
+    /// told of moderate pressure.
+    double pressure_ratio = 0.8;
+  };
+
+  using ClientId = uint64_t;
+
+  /// Gives back as much of a client's memory as it can, by releasing it.
+  using EvictFunction = std::function<void()>;
+
+  /// Frees memory under pressure, by releasing it.
+  using PressureCallback = std::function<void(Pressure pressure)>;
+
+  /// How much memory a client holds.
+  struct ClientUsage {
+    ClientId id = 0;
+    std::string name;
+    std::array<size_t, kNumCategories> nbytes{};
+    /// Whether the client registered an evict function.
+    bool evictable = false;
+    /// Whether the client is in use, and can't be evicted.
+    bool in_use = false;
+  };
+
+  /// How much memory all clients hold.
+  struct Breakdown {
+    size_t budget = 0;
+    size_t total = 0;
+    std::array<size_t, kNumCategories> by_category{};
+    /// Least recently used first, in the order they would be evicted.
+    std::vector<ClientUsage> clients;
+    /// How many times a client was evicted to make room.
+    size_t num_evictions = 0;
+  };
+
+  /**
+   * Marks a client as in use, so that it can't be evicted, until destroyed.
+   * Does nothing if constructed without a governor.
+   */
+  class ScopedUse final {
+   public:
+    ScopedUse() = default;
+    ScopedUse(MemoryGovernor* governor, ClientId client);
+    ScopedUse(ScopedUse&& other) noexcept;
+    ScopedUse& operator=(ScopedUse&& other) noexcept;
+    ScopedUse(const ScopedUse&) = delete;
+    ScopedUse& operator=(const ScopedUse&) = delete;
+    ~ScopedUse();
+
+   private:
+    MemoryGovernor* governor_ = nullptr;
+    ClientId client_ = 0;
+  };
+
+  MemoryGovernor() : MemoryGovernor(Options()) {}
+  explicit MemoryGovernor(Options options);
+
+  MemoryGovernor(const MemoryGovernor&) = delete;
+  MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+  MemoryGovernor(MemoryGovernor&&) = delete;
+  MemoryGovernor& operator=(MemoryGovernor&&) = delete;
+
+  /// The governor shared by the whole process, which has no budget until
+  /// set_budget() is called.
+  static MemoryGovernor& global();
+
+  /**
+   * Changes the budget, evicting idle clients if the usage is over it.
+   *
+   * @param[in] budget The new budget in bytes, or 0 for no limit.
+   */
+  void set_budget(size_t budget);
+
+  /**
+   * Registers a client.
+   *
+   * @param[in] name A name for the client in the breakdown.
+   * @param[in] evict Gives back the client's memory, or nullptr if the client
+   * can't be evicted.
+   *
+   * @returns The id to reserve and release memory with.
+   */
+  ClientId register_client(std::string name, EvictFunction evict = nullptr);
+
+  /**
+   * Unregisters a client, releasing all the memory it still holds. Later
+   * releases for the client are ignored.
+   */
+  void unregister_client(ClientId client);
+
+  /**
+   * Marks a client as used now, which makes it the last one to evict.
+   */
+  void touch(ClientId client);
+
+  /**
+   * Reserves memory for a client before it allocates it, evicting other
+   * clients and calling the pressure callbacks if it doesn't fit.
+   *
+   * @param[in] client The client.
+   * @param[in] category What the memory is for.
+   * @param[in] nbytes The size of the memory.
+   *
+   * @returns An Error to indicate success or failure.
+   * @retval Error::MemoryAllocationFailed The memory doesn't fit in the
+   *     budget.
+   * @retval Error::InvalidArgument The client is not registered.
+   */
+  ET_NODISCARD runtime::Error
+  reserve(ClientId client, Category category, size_t nbytes);
+
+  /**
+   * Releases memory that a client reserved, once it freed it.
+   */
+  void release(ClientId client, Category category, size_t nbytes);
+
+  /**
+   * Evicts idle clients, least recently used first, until the usage is at
+   * most `target`, e.g. when the operating system reports low memory.
+   *
+   * @returns The number of bytes released.
+   */
+  size_t trim(size_t target);
+
+  /**
+   * Adds a callback to free memory under pressure, e.g. the caches of a
+   * delegate.
+   *
+   * @returns An id to remove the callback with.
+   */
+  size_t add_pressure_callback(PressureCallback callback);
+
+  /// Removes a callback added by add_pressure_callback().
+  void remove_pressure_callback(size_t id);
+
+  /// The number of bytes that the clients hold in total.
+  size_t total() const;
+
+  /// How much memory each client holds.
+  Breakdown breakdown() const;
+
+ private:
+  struct Client {
+    std::string name;
+    EvictFunction evict;
+    std::array<size_t, kNumCategories> nbytes{};
+    size_t total = 0;
+    size_t in_use = 0;
+    // When the client was last used, as a value of use_count_.
+    uint64_t last_used = 0;
+  };
+
+  void set_in_use(ClientId client, bool in_use);
+
+  // Evicts idle clients other than `except`, least recently used first,
+  // until the usage is at most `target`. Returns whether it is.
+  bool evict_until(size_t target, ClientId except);
+
+  void notify_pressure(Pressure pressure);
+
+  // Recursive, so that evict functions and pressure callbacks can release
+  // memory.
+  mutable std::recursive_mutex mutex_;
+  size_t budget_;
+  const double pressure_ratio_;
+  size_t total_ = 0;
+  std::array<size_t, kNumCategories> by_category_{};
+  // Whether the moderate pressure callbacks have been called since the usage
+  // was last below the pressure threshold.
+  bool under_pressure_ = false;
+  size_t num_evictions_ = 0;
+  // Counts the uses of the clients, to order them by when they were last
+  // used.
+  uint64_t use_count_ = 0;
+  ClientId next_client_ = 1;
+  std::unordered_map<ClientId, Client> clients_;
+  size_t next_callback_ = 1;
+  std::vector<std::pair<size_t, PressureCallback>> callbacks_;
+};
+
+/**
+ * EXPERIMENTAL: A MemoryAllocator that reserves what it allocates from
+ * another allocator with a MemoryGovernor, and releases it on reset(), so
+ * that the allocator fails instead of exceeding the budget.
+ */
+class GovernedMemoryAllocator final : public runtime::MemoryAllocator {
+ public:
+  /**
+   * @param[in] allocator The allocator to allocate from, which must free its
+   * memory on reset().
+   * @param[in] governor The governor to reserve the memory with.
+   * @param[in] client The client to reserve the memory for.
+   * @param[in] category What the memory is for.
+   */
+  GovernedMemoryAllocator(
+      std::unique_ptr<runtime::MemoryAllocator> allocator,
+      MemoryGovernor& governor,
+      MemoryGovernor::ClientId client,
+      MemoryGovernor::Category category);
+
+  ~GovernedMemoryAllocator() override;
+
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override;
+
+  size_t used_size() const override {
+    return allocator_->used_size();
+  }
+
+  void reset() override;
+
+ private:
+  std::unique_ptr<runtime::MemoryAllocator> allocator_;
+  MemoryGovernor& governor_;
+  const MemoryGovernor::ClientId client_;
+  const MemoryGovernor::Category category_;
+  // The number of bytes reserved since the last reset().
+  size_t reserved_ = 0;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/page_memory.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#endif // defined(__linux__)
+
+#include <executorch/runtime/platform/log.h>
+
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+// The size of x86-64 and AArch64 (with 4KiB base pages) PMD-level huge pages,
+// which is what MAP_HUGETLB uses by default.
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+size_t round_up(size_t value, size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+Error apply_page_policy(void* data, size_t size, const PagePolicy& policy) {
+  if (policy.is_default() || size == 0) {
+    return Error::Ok;
+  }
+#if defined(__linux__)
+  if (policy.huge_pages != PagePolicy::HugePages::None) {
+#if defined(MADV_HUGEPAGE)
+    // Explicit huge pages come from mmap() flags, which can't be changed
+    // after the fact, so for existing mappings both modes mean the same thing.
+    if (::madvise(data, size, MADV_HUGEPAGE) != 0) {
+      // Transparent huge pages are best-effort: the kernel may not have them
+      // enabled, or may not support them for this kind of mapping.
+      ET_LOG(
+          Debug,
+          "Ignoring madvise(%p, %zu, MADV_HUGEPAGE) error: %s (%d)",
+          data,
+          size,
+          ::strerror(errno),
+          errno);
+    }
+#endif // defined(MADV_HUGEPAGE)
+  }
+  if (policy.numa_node >= 0) {
+    constexpr size_t kBitsPerWord = sizeof(unsigned long) * 8;
+    // Enough for the maximum number of nodes that Linux supports.
+    unsigned long node_mask[1024 / kBitsPerWord] = {};
+    ET_CHECK_OR_RETURN_ERROR(
+        static_cast<size_t>(policy.numa_node) <
+            sizeof(node_mask) / sizeof(node_mask[0]) * kBitsPerWord,
+        InvalidArgument,
+        "NUMA node %d out of range",
+        policy.numa_node);
+    node_mask[policy.numa_node / kBitsPerWord] |= 1UL
+        << (policy.numa_node % kBitsPerWord);
+    // Use the syscall directly to avoid a dependency on libnuma.
+    long err = ::syscall(
+        SYS_mbind,
+        data,
+        size,
+        MPOL_BIND,
+        node_mask,
+        sizeof(node_mask) * 8,
+        MPOL_MF_MOVE);
+    if (err != 0) {
+      ET_LOG(
+          Error,
+          "mbind(%p, %zu) to NUMA node %d failed: %s (%d)",
+          data,
+          size,
+          policy.numa_node,
+          ::strerror(errno),
+          errno);
+      return Error::AccessFailed;
+    }
+  }
+  return Error::Ok;
+#else // !defined(__linux__)
+  (void)data;
+  ET_LOG(Error, "Page policies are only supported on Linux");
+  return Error::NotSupported;
+#endif // !defined(__linux__)
+}
+
+void populate_pages(void* data, size_t size) {
+  if (data == nullptr || size == 0) {
+    return;
+  }
+  const long sysconf_page_size = ::sysconf(_SC_PAGESIZE);
+  const uintptr_t page_size =
+      sysconf_page_size > 0 ? sysconf_page_size : 4096;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(data);
+  const uintptr_t end = begin + size;
+#if defined(__linux__) && defined(MADV_POPULATE_WRITE)
+  // madvise() needs a page-aligned start.
+  const uintptr_t aligned_begin = begin / page_size * page_size;
+  if (::madvise(
+          reinterpret_cast<void*>(aligned_begin),
+          end - aligned_begin,
+          MADV_POPULATE_WRITE) == 0) {
+    return;
+  }
+  // Kernels before 5.14 don't know the advice; fall back to touching pages.
+  ET_LOG(
+      Debug,
+      "Ignoring madvise(%p, %zu, MADV_POPULATE_WRITE) error: %s (%d)",
+      data,
+      size,
+      ::strerror(errno),
+      errno);
+#endif // defined(__linux__) && defined(MADV_POPULATE_WRITE)
+  // Write back the first byte in each page, which faults the page in for
+  // writing without changing it.
+  for (uintptr_t address = begin; address < end;
+       address = (address / page_size + 1) * page_size) {
+    auto* byte = reinterpret_cast<volatile uint8_t*>(address);
+    *byte = *byte;
+  }
+}
+
+Result<PageBuffer> PageBuffer::allocate(size_t size, const PagePolicy& policy) {
+  if (size == 0) {
+    return PageBuffer(nullptr, 0, 0);
+  }
+
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+  size_t mapped_size = 0;
+  if (policy.huge_pages == PagePolicy::HugePages::Explicit) {
+#if defined(MAP_HUGETLB)
+    flags |= MAP_HUGETLB;
+    mapped_size = round_up(size, kHugePageSize);
+#else // !defined(MAP_HUGETLB)
+    ET_LOG(Error, "Explicit huge pages are not supported on this platform");
+    return Error::NotSupported;
+#endif // !defined(MAP_HUGETLB)
+  } else {
+    const long page_size = ::sysconf(_SC_PAGESIZE);
+    mapped_size = round_up(size, page_size > 0 ? page_size : 4096);
+  }
+
+  void* pages =
+      ::mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (pages == MAP_FAILED) {
+    ET_LOG(
+        Error,
+        "Failed to map %zu bytes%s: %s (%d)",
+        mapped_size,
+        policy.huge_pages == PagePolicy::HugePages::Explicit
+            ? " of explicit huge pages"
+            : "",
+        ::strerror(errno),
+        errno);
+    return Error::MemoryAllocationFailed;
+  }
+
+  // Apply the policy before touching the memory, so that the pages are
+  // faulted in with the right size and on the right node.
+  PagePolicy remaining_policy = policy;
+  if (policy.huge_pages == PagePolicy::HugePages::Explicit) {
+    // Already backed by huge pages.
+    remaining_policy.huge_pages = PagePolicy::HugePages::None;
+  }
+  Error err = apply_page_policy(pages, mapped_size, remaining_policy);
+  if (err != Error::Ok) {
+    ::munmap(pages, mapped_size);
+    return err;
+  }
+  return PageBuffer(static_cast<uint8_t*>(pages), size, mapped_size);
+}
+
+PageBuffer::~PageBuffer() {
+  if (data_ != nullptr) {
+    ::munmap(data_, mapped_size_);
+  }
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Describes how the pages backing a large allocation or mapping should be
+ * placed, to reduce TLB misses and cross-node memory traffic.
+ */
+struct PagePolicy {
+  /**
+   * Whether to back memory with huge pages.
+   */
+  enum class HugePages {
+    /// Use the default page size.
+    None,
+    /// Ask the kernel to use transparent huge pages with madvise(). Ignored if
+    /// they are not available.
+    Transparent,
+    /// Allocate from the explicitly reserved huge page pool with
+    /// MAP_HUGETLB. Only possible for anonymous memory; file mappings fall
+    /// back to Transparent.
+    Explicit,
+  };
+
+  /// Whether to back memory with huge pages.
+  HugePages huge_pages = HugePages::None;
+
+  /// The NUMA node to bind memory to, or -1 to use the default policy of the
+  /// calling thread.
+  int numa_node = -1;
+
+  /// Returns true if this is the default policy, which changes nothing.
+  bool is_default() const {
+    return huge_pages == HugePages::None && numa_node < 0;
+  }
+};
+
+/**
+ * Applies `policy` to the pages in `[data, data + size)`, which must be a
+ * page-aligned region of mapped memory. Pages that are already resident are
+ * migrated to the requested NUMA node if possible.
+ *
+ * @retval Error::Ok The policy was applied, or is the default policy.
+ * @retval Error::NotSupported The platform does not support the policy.
+ * @retval Error::AccessFailed The kernel rejected the policy.
+ */
+ET_NODISCARD executorch::runtime::Error
+apply_page_policy(void* data, size_t size, const PagePolicy& policy);
+
+/**
+ * Faults in the pages in `[data, data + size)` for writing, so that the
+ * first accesses to them don't stall on page faults, e.g. during the first
+ * execution of a method. Keeps the contents of the memory.
+ *
+ * Uses madvise(MADV_POPULATE_WRITE) where the kernel supports it, and
+ * otherwise writes back one byte of each page.
+ */
+void populate_pages(void* data, size_t size);
+
+/**
+ * An anonymous, zero-initialized memory mapping whose pages are placed
+ * according to a PagePolicy. Unmapped when destroyed.
+ */
+class PageBuffer final {
+ public:
+  /**
+   * Maps at least `size` bytes of memory. The size is rounded up to a
+   * multiple of the page size, or of the huge page size for explicit huge
+   * pages.
+   *
+   * @retval Error::MemoryAllocationFailed The memory could not be mapped,
+   *     e.g. because not enough explicit huge pages are reserved.
+   * @returns Other errors from apply_page_policy().
+   */
+  static executorch::runtime::Result<PageBuffer> allocate(
+      size_t size,
+      const PagePolicy& policy = PagePolicy());
+
+  PageBuffer(PageBuffer&& rhs) noexcept
+      : data_(rhs.data_), size_(rhs.size_), mapped_size_(rhs.mapped_size_) {
+    rhs.data_ = nullptr;
+    rhs.size_ = 0;
+    rhs.mapped_size_ = 0;
+  }
+
+  ~PageBuffer();
+
+  /// The start of the memory.
+  uint8_t* data() const {
+    return data_;
+  }
+
+  /// The requested size of the memory in bytes.
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  PageBuffer(uint8_t* data, size_t size, size_t mapped_size)
+      : data_(data), size_(size), mapped_size_(mapped_size) {}
+
+  PageBuffer(const PageBuffer&) = delete;
+  PageBuffer& operator=(const PageBuffer&) = delete;
+  PageBuffer& operator=(PageBuffer&&) = delete;
+
+  uint8_t* data_;
+  size_t size_;
+  size_t mapped_size_;
+};
+
+} // namespace extension
+} // namespace executorch
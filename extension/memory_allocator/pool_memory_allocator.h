@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <executorch/runtime/core/memory_allocator.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * Dynamically allocates memory using malloc(), but instead of freeing it on
+ * reset(), keeps the blocks in free lists by size class and hands them out
+ * again on later calls to allocate().
+ *
+ * Every request is rounded up to a power-of-two block size, so workloads that
+ * make similar sequences of allocations between resets, such as repeated
+ * executions of a method with dynamic shapes, stop calling malloc() once the
+ * pool has warmed up. The blocks are freed at destruction time, or by trim().
+ *
+ * Like MallocMemoryAllocator, this is not thread-safe.
+ */
+class PoolMemoryAllocator : public executorch::runtime::MemoryAllocator {
+ public:
+  /// Counters describing how the pool has been used.
+  struct Stats {
+    /// Calls to allocate() that returned memory.
+    size_t num_allocations = 0;
+    /// Calls to allocate() that were served from a free list.
+    size_t num_reused = 0;
+    /// Calls to malloc().
+    size_t num_malloc_calls = 0;
+    /// Bytes in blocks that are currently allocated.
+    size_t bytes_in_use = 0;
+    /// Bytes in all blocks owned by the pool, allocated or free.
+    size_t bytes_reserved = 0;
+  };
+
+  /// The smallest block size, in bytes. Smaller requests are rounded up.
+  static constexpr size_t kMinBlockSize = 64;
+
+  PoolMemoryAllocator() : MemoryAllocator(0, nullptr) {}
+
+  ~PoolMemoryAllocator() override {
+    reset();
+    trim();
+  }
+
+  /**
+   * Allocates 'size' bytes of memory, returning a pointer to the allocated
+   * region, or nullptr upon failure. Reuses a free block of the same size
+   * class if there is one.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    EXECUTORCH_TRACK_ALLOCATION(prof_id(), size);
+
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+
+    // The minimum alignment that malloc() is guaranteed to provide.
+    static constexpr size_t kMallocAlignment = alignof(std::max_align_t);
+    const size_t padding = alignment > kMallocAlignment ? alignment : 0;
+    // As in MallocMemoryAllocator, get higher alignments by allocating extra
+    // and aligning the returned pointer.
+    const size_t size_class = size <= SIZE_MAX - padding
+        ? size_class_for(size + padding)
+        : kNumSizeClasses;
+    if (size_class >= kNumSizeClasses) {
+      ET_LOG(Error, "Allocation of %zu bytes is too large", size);
+      return nullptr;
+    }
+    const size_t block_size = block_size_for(size_class);
+
+    void* block;
+    auto& free_list = free_lists_[size_class];
+    if (!free_list.empty()) {
+      block = free_list.back();
+      free_list.pop_back();
+      stats_.num_reused++;
+    } else {
+      block = std::malloc(block_size);
+      if (block == nullptr) {
+        ET_LOG(Error, "malloc(%zu) failed", block_size);
+        return nullptr;
+      }
+      stats_.num_malloc_calls++;
+      stats_.bytes_reserved += block_size;
+    }
+    in_use_.push_back({block, size_class});
+    stats_.num_allocations++;
+    stats_.bytes_in_use += block_size;
+    return alignPointer(block, alignment);
+  }
+
+  /// Returns the bytes in blocks that are currently allocated.
+  size_t used_size() const override {
+    return stats_.bytes_in_use;
+  }
+
+  /// Returns all allocated blocks to the free lists, without freeing them.
+  void reset() override {
+    for (const auto& block : in_use_) {
+      free_lists_[block.size_class].push_back(block.ptr);
+    }
+    in_use_.clear();
+    stats_.bytes_in_use = 0;
+  }
+
+  /// Frees all blocks in the free lists. Allocated blocks are not affected.
+  void trim() {
+    for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      for (void* ptr : free_lists_[size_class]) {
+        std::free(ptr);
+        stats_.bytes_reserved -= block_size_for(size_class);
+      }
+      free_lists_[size_class].clear();
+    }
+  }
+
+  /// Returns the usage counters of the pool.
+  const Stats& stats() const {
+    return stats_;
+  }
+
+  /// Zeroes the call counters, keeping the byte counts.
+  void reset_stats() {
+    stats_.num_allocations = 0;
+    stats_.num_reused = 0;
+    stats_.num_malloc_calls = 0;
+  }
+
+ private:
+  // Block sizes from kMinBlockSize up to 2^(kNumSizeClasses + 5).
+  static constexpr size_t kNumSizeClasses = sizeof(size_t) * 8 - 6;
+
+  struct Block {
+    void* ptr;
+    size_t size_class;
+  };
+
+  static size_t block_size_for(size_t size_class) {
+    return kMinBlockSize << size_class;
+  }
+
+  static size_t size_class_for(size_t size) {
+    size_t size_class = 0;
+    while (size_class < kNumSizeClasses && block_size_for(size_class) < size) {
+      size_class++;
+    }
+    return size_class;
+  }
+
+  std::array<std::vector<void*>, kNumSizeClasses> free_lists_;
+  std::vector<Block> in_use_;
+  Stats stats_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -20,3 +20,68 @@ def define_common_targets():
             "@EXECUTORCH_CLIENTS",
         ],
     )
+
+    runtime.cxx_library(
+        name = "pool_memory_allocator",
+        exported_headers = [
+            "pool_memory_allocator.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:memory_allocator",
+        ],
+        visibility = [
+            "//executorch/extension/memory_allocator/test/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "page_memory",
+        srcs = [
+            "page_memory.cpp",
+        ],
+        exported_headers = [
+            "page_memory.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:core",
+        ],
+        visibility = [
+            "//executorch/extension/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "malloc_kernel_cache",
+        srcs = [
+            "malloc_kernel_cache.cpp",
+        ],
+        exported_headers = [
+            "malloc_kernel_cache.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/kernel:kernel_runtime_context",
+        ],
+        visibility = [
+            "//executorch/extension/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "memory_governor",
+        srcs = [
+            "memory_governor.cpp",
+        ],
+        exported_headers = [
+            "memory_governor.h",
+        ],
+        exported_deps = [
+            "//executorch/runtime/core:memory_allocator",
+        ],
+        visibility = [
+            "//executorch/extension/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/malloc_kernel_cache.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::MallocKernelCache;
+using executorch::runtime::Error;
+
+class MallocKernelCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(MallocKernelCacheTest, CreatesEntryOnce) {
+  const float weight[4] = {1, 2, 3, 4};
+  MallocKernelCache cache;
+  ASSERT_EQ(cache.register_constant(weight, sizeof(weight)), Error::Ok);
+  EXPECT_TRUE(cache.is_constant(weight));
+
+  int calls = 0;
+  auto init = [&](void* data, size_t nbytes) {
+    ++calls;
+    std::memcpy(data, weight, nbytes);
+    return Error::Ok;
+  };
+  auto first = cache.get_or_create(weight, /*tag=*/1, sizeof(weight), init);
+  ASSERT_EQ(first.error(), Error::Ok);
+  auto second = cache.get_or_create(weight, /*tag=*/1, sizeof(weight), init);
+  ASSERT_EQ(second.error(), Error::Ok);
+
+  EXPECT_EQ(calls, 1);
+  EXPECT_EQ(first.get(), second.get());
+  EXPECT_EQ(std::memcmp(first.get(), weight, sizeof(weight)), 0);
+  EXPECT_EQ(cache.num_entries(), 1);
+  EXPECT_EQ(cache.entries_nbytes(), sizeof(weight));
+
+  // A different tag is a different entry.
+  auto other = cache.get_or_create(weight, /*tag=*/2, 8, init);
+  ASSERT_EQ(other.error(), Error::Ok);
+  EXPECT_NE(other.get(), first.get());
+  EXPECT_EQ(calls, 2);
+  EXPECT_EQ(cache.num_entries(), 2);
+}
+
+TEST_F(MallocKernelCacheTest, RejectsUnregisteredData) {
+  const float weight[4] = {};
+  const float activation[4] = {};
+  MallocKernelCache cache;
+  ASSERT_EQ(cache.register_constant(weight, sizeof(weight)), Error::Ok);
+
+  EXPECT_FALSE(cache.is_constant(activation));
+  // Only the start of a constant is a key.
+  EXPECT_FALSE(cache.is_constant(weight + 1));
+  bool called = false;
+  auto entry = cache.get_or_create(
+      activation, /*tag=*/0, sizeof(activation), [&](void*, size_t) {
+        called = true;
+        return Error::Ok;
+      });
+  EXPECT_EQ(entry.error(), Error::NotFound);
+  EXPECT_FALSE(called);
+  EXPECT_EQ(
+      cache.register_constant(nullptr, sizeof(weight)), Error::InvalidArgument);
+}
+
+TEST_F(MallocKernelCacheTest, RejectsMismatchedSize) {
+  const float weight[4] = {};
+  MallocKernelCache cache;
+  ASSERT_EQ(cache.register_constant(weight, sizeof(weight)), Error::Ok);
+  auto init = [](void*, size_t) { return Error::Ok; };
+
+  ASSERT_EQ(cache.get_or_create(weight, 0, 16, init).error(), Error::Ok);
+  EXPECT_EQ(
+      cache.get_or_create(weight, 0, 32, init).error(), Error::InvalidArgument);
+}
+
+TEST_F(MallocKernelCacheTest, RetriesFailedInit) {
+  const float weight[4] = {};
+  MallocKernelCache cache;
+  ASSERT_EQ(cache.register_constant(weight, sizeof(weight)), Error::Ok);
+
+  auto failed = cache.get_or_create(
+      weight, 0, 16, [](void*, size_t) { return Error::Internal; });
+  EXPECT_EQ(failed.error(), Error::Internal);
+  EXPECT_EQ(cache.num_entries(), 0);
+
+  auto retried = cache.get_or_create(
+      weight, 0, 16, [](void*, size_t) { return Error::Ok; });
+  EXPECT_EQ(retried.error(), Error::Ok);
+  EXPECT_EQ(cache.num_entries(), 1);
+}
+
+TEST_F(MallocKernelCacheTest, ConcurrentCallersShareOneEntry) {
+  const float weight[4] = {1, 2, 3, 4};
+  MallocKernelCache cache;
+  ASSERT_EQ(cache.register_constant(weight, sizeof(weight)), Error::Ok);
+
+  std::atomic<int> calls{0};
+  std::vector<const void*> entries(8);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    threads.emplace_back([&, i] {
+      auto entry = cache.get_or_create(
+          weight, 0, sizeof(weight), [&](void* data, size_t nbytes) {
+            ++calls;
+            std::memcpy(data, weight, nbytes);
+            return Error::Ok;
+          });
+      entries[i] = entry.ok() ? entry.get() : nullptr;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(calls, 1);
+  for (const void* entry : entries) {
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry, entries[0]);
+  }
+}
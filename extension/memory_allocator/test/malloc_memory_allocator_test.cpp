@@ -123,8 +123,10 @@ TEST_F(MallocMemoryAllocatorTest, ResetSucceeds) {
   auto p = allocator.allocate(16);
   EXPECT_NE(p, nullptr);
   EXPECT_ALIGNED(p, kDefaultAlignment);
+  EXPECT_EQ(allocator.used_size(), 16);
 
   allocator.reset();
+  EXPECT_EQ(allocator.used_size(), 0);
 
   // Continue to allocate successfully.
   p = allocator.allocate(16);
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/extension/memory_allocator/memory_governor.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::GovernedMemoryAllocator;
+using executorch::extension::MallocMemoryAllocator;
+using executorch::extension::MemoryGovernor;
+using executorch::runtime::Error;
+
+using Category = MemoryGovernor::Category;
+
+class MemoryGovernorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+
+  // Registers a client that releases all of its memory when evicted, and
+  // records the order of evictions in `evicted`.
+  MemoryGovernor::ClientId register_evictable(
+      MemoryGovernor& governor,
+      const std::string& name,
+      Category category,
+      size_t nbytes,
+      std::vector<std::string>& evicted) {
+    return governor.register_client(
+        name, [&governor, &evicted, name, category, nbytes, this]() {
+          evicted.push_back(name);
+          governor.release(ids_.at(name), category, nbytes);
+        });
+  }
+
+  std::unordered_map<std::string, MemoryGovernor::ClientId> ids_;
+};
+
+TEST_F(MemoryGovernorTest, AccountsByClientAndCategory) {
+  MemoryGovernor governor;
+  const auto a = governor.register_client("a");
+  const auto b = governor.register_client("b");
+
+  // Without a budget, every reservation fits.
+  ASSERT_EQ(governor.reserve(a, Category::PlannedMemory, 100), Error::Ok);
+  ASSERT_EQ(governor.reserve(a, Category::Constants, 50), Error::Ok);
+  ASSERT_EQ(governor.reserve(b, Category::Delegate, 30), Error::Ok);
+  EXPECT_EQ(governor.total(), 180);
+
+  auto breakdown = governor.breakdown();
+  EXPECT_EQ(breakdown.budget, 0);
+  EXPECT_EQ(breakdown.total, 180);
+  EXPECT_EQ(
+      breakdown.by_category[static_cast<size_t>(Category::PlannedMemory)], 100);
+  EXPECT_EQ(
+      breakdown.by_category[static_cast<size_t>(Category::Constants)], 50);
+  EXPECT_EQ(breakdown.by_category[static_cast<size_t>(Category::Delegate)], 30);
+  ASSERT_EQ(breakdown.clients.size(), 2);
+  // Least recently used first.
+  EXPECT_EQ(breakdown.clients[0].name, "a");
+  EXPECT_EQ(breakdown.clients[1].name, "b");
+  EXPECT_FALSE(breakdown.clients[0].evictable);
+
+  governor.release(a, Category::PlannedMemory, 100);
+  EXPECT_EQ(governor.total(), 80);
+
+  // Unregistering releases the rest, and later releases are ignored.
+  governor.unregister_client(a);
+  EXPECT_EQ(governor.total(), 30);
+  governor.release(a, Category::Constants, 50);
+  EXPECT_EQ(governor.total(), 30);
+  EXPECT_EQ(governor.breakdown().clients.size(), 1);
+
+  EXPECT_EQ(governor.reserve(a, Category::Other, 1), Error::InvalidArgument);
+}
+
+TEST_F(MemoryGovernorTest, EvictsLeastRecentlyUsedFirst) {
+  MemoryGovernor::Options options;
+  options.budget = 300;
+  MemoryGovernor governor(options);
+  std::vector<std::string> evicted;
+  for (const char* name : {"a", "b", "c"}) {
+    ids_[name] = register_evictable(
+        governor, name, Category::PlannedMemory, 100, evicted);
+    ASSERT_EQ(
+        governor.reserve(ids_[name], Category::PlannedMemory, 100), Error::Ok);
+  }
+  governor.touch(ids_["a"]);
+
+  // b is the least recently used client now.
+  const auto d = governor.register_client("d");
+  ASSERT_EQ(governor.reserve(d, Category::PlannedMemory, 100), Error::Ok);
+  EXPECT_EQ(evicted, std::vector<std::string>({"b"}));
+  EXPECT_EQ(governor.total(), 300);
+
+  ASSERT_EQ(governor.reserve(d, Category::PlannedMemory, 150), Error::Ok);
+  EXPECT_EQ(evicted, std::vector<std::string>({"b", "c", "a"}));
+  EXPECT_EQ(governor.total(), 250);
+  EXPECT_EQ(governor.breakdown().num_evictions, 3);
+
+  // Nothing is left to evict, and more than the budget never fits.
+  EXPECT_EQ(
+      governor.reserve(d, Category::PlannedMemory, 100),
+      Error::MemoryAllocationFailed);
+  EXPECT_EQ(
+      governor.reserve(d, Category::PlannedMemory, 301),
+      Error::MemoryAllocationFailed);
+  EXPECT_EQ(governor.total(), 250);
+}
+
+TEST_F(MemoryGovernorTest, DoesNotEvictClientsInUse) {
+  MemoryGovernor::Options options;
+  options.budget = 200;
+  MemoryGovernor governor(options);
+  std::vector<std::string> evicted;
+  ids_["a"] =
+      register_evictable(governor, "a", Category::PlannedMemory, 100, evicted);
+  ASSERT_EQ(
+      governor.reserve(ids_["a"], Category::PlannedMemory, 100), Error::Ok);
+  const auto b = governor.register_client("b");
+  ASSERT_EQ(governor.reserve(b, Category::Method, 100), Error::Ok);
+
+  {
+    MemoryGovernor::ScopedUse use(&governor, ids_["a"]);
+    EXPECT_TRUE(governor.breakdown().clients[1].in_use);
+    EXPECT_EQ(
+        governor.reserve(b, Category::Method, 50),
+        Error::MemoryAllocationFailed);
+    EXPECT_TRUE(evicted.empty());
+  }
+
+  ASSERT_EQ(governor.reserve(b, Category::Method, 50), Error::Ok);
+  EXPECT_EQ(evicted, std::vector<std::string>({"a"}));
+}
+
+TEST_F(MemoryGovernorTest, TrimsAndLowersBudget) {
+  MemoryGovernor governor;
+  std::vector<std::string> evicted;
+  for (const char* name : {"a", "b", "c"}) {
+    ids_[name] =
+        register_evictable(governor, name, Category::Delegate, 100, evicted);
+    ASSERT_EQ(governor.reserve(ids_[name], Category::Delegate, 100), Error::Ok);
+  }
+
+  EXPECT_EQ(governor.trim(250), 100);
+  EXPECT_EQ(evicted, std::vector<std::string>({"a"}));
+
+  governor.set_budget(100);
+  EXPECT_EQ(evicted, std::vector<std::string>({"a", "b"}));
+  EXPECT_EQ(governor.total(), 100);
+}
+
+TEST_F(MemoryGovernorTest, CallsPressureCallbacks) {
+  MemoryGovernor::Options options;
+  options.budget = 100;
+  options.pressure_ratio = 0.5;
+  MemoryGovernor governor(options);
+  const auto client = governor.register_client("client");
+  const auto cache = governor.register_client("cache");
+  ASSERT_EQ(governor.reserve(cache, Category::Delegate, 40), Error::Ok);
+
+  std::vector<MemoryGovernor::Pressure> pressures;
+  const auto id =
+      governor.add_pressure_callback([&](MemoryGovernor::Pressure pressure) {
+        pressures.push_back(pressure);
+        if (pressure == MemoryGovernor::Pressure::Critical) {
+          // Drop the cache.
+          governor.release(cache, Category::Delegate, 40);
+        }
+      });
+
+  ASSERT_EQ(governor.reserve(client, Category::Other, 20), Error::Ok);
+  EXPECT_EQ(
+      pressures,
+      std::vector<MemoryGovernor::Pressure>(
+          {MemoryGovernor::Pressure::Moderate}));
+  // Only once while the usage stays above the threshold.
+  ASSERT_EQ(governor.reserve(client, Category::Other, 10), Error::Ok);
+  EXPECT_EQ(pressures.size(), 1);
+
+  // Doesn't fit until the callback drops the cache, which takes the usage
+  // below the threshold before the reservation crosses it again.
+  ASSERT_EQ(governor.reserve(client, Category::Other, 60), Error::Ok);
+  ASSERT_EQ(pressures.size(), 3);
+  EXPECT_EQ(pressures[1], MemoryGovernor::Pressure::Critical);
+  EXPECT_EQ(pressures[2], MemoryGovernor::Pressure::Moderate);
+  EXPECT_EQ(governor.total(), 90);
+
+  governor.remove_pressure_callback(id);
+  EXPECT_EQ(
+      governor.reserve(client, Category::Other, 20),
+      Error::MemoryAllocationFailed);
+  EXPECT_EQ(pressures.size(), 3);
+}
+
+TEST_F(MemoryGovernorTest, GovernedMemoryAllocator) {
+  MemoryGovernor::Options options;
+  options.budget = 1024;
+  MemoryGovernor governor(options);
+  const auto client = governor.register_client("client");
+  {
+    GovernedMemoryAllocator allocator(
+        std::make_unique<MallocMemoryAllocator>(),
+        governor,
+        client,
+        Category::Method);
+    EXPECT_NE(allocator.allocate(512), nullptr);
+    EXPECT_NE(allocator.allocate(256), nullptr);
+    EXPECT_EQ(governor.total(), 768);
+    // Fails instead of exceeding the budget.
+    EXPECT_EQ(allocator.allocate(512), nullptr);
+    EXPECT_EQ(governor.total(), 768);
+
+    allocator.reset();
+    EXPECT_EQ(governor.total(), 0);
+    EXPECT_NE(allocator.allocate(1000), nullptr);
+    EXPECT_EQ(
+        governor.breakdown().by_category[static_cast<size_t>(Category::Method)],
+        1000);
+  }
+  // Destroying the allocator releases its memory.
+  EXPECT_EQ(governor.total(), 0);
+}
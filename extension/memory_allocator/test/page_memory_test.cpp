@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/page_memory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::PageBuffer;
+using executorch::extension::PagePolicy;
+using executorch::extension::populate_pages;
+using executorch::runtime::Error;
+
+class PageMemoryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(PageMemoryTest, DefaultPolicy) {
+  EXPECT_TRUE(PagePolicy().is_default());
+
+  auto buffer = PageBuffer::allocate(10000);
+  ASSERT_EQ(buffer.error(), Error::Ok);
+  EXPECT_EQ(buffer->size(), 10000);
+  ASSERT_NE(buffer->data(), nullptr);
+  // Anonymous mappings are zero-initialized.
+  for (size_t i = 0; i < buffer->size(); ++i) {
+    ASSERT_EQ(buffer->data()[i], 0);
+  }
+  std::memset(buffer->data(), 0xAB, buffer->size());
+}
+
+TEST_F(PageMemoryTest, EmptyBuffer) {
+  auto buffer = PageBuffer::allocate(0);
+  ASSERT_EQ(buffer.error(), Error::Ok);
+  EXPECT_EQ(buffer->size(), 0);
+  EXPECT_EQ(buffer->data(), nullptr);
+}
+
+TEST_F(PageMemoryTest, PopulatePagesKeepsContents) {
+  auto buffer = PageBuffer::allocate(3 * 4096 + 100);
+  ASSERT_EQ(buffer.error(), Error::Ok);
+  for (size_t i = 0; i < buffer->size(); ++i) {
+    buffer->data()[i] = static_cast<uint8_t>(i);
+  }
+  // Unaligned ranges are fine too.
+  populate_pages(buffer->data() + 1, buffer->size() - 1);
+  populate_pages(nullptr, 0);
+  for (size_t i = 0; i < buffer->size(); ++i) {
+    ASSERT_EQ(buffer->data()[i], static_cast<uint8_t>(i));
+  }
+}
+
+#if defined(__linux__)
+
+TEST_F(PageMemoryTest, TransparentHugePages) {
+  PagePolicy policy;
+  policy.huge_pages = PagePolicy::HugePages::Transparent;
+  EXPECT_FALSE(policy.is_default());
+
+  // Transparent huge pages are a hint, so this succeeds even if they are not
+  // enabled.
+  auto buffer = PageBuffer::allocate(4 * 1024 * 1024, policy);
+  ASSERT_EQ(buffer.error(), Error::Ok);
+  std::memset(buffer->data(), 0xAB, buffer->size());
+}
+
+TEST_F(PageMemoryTest, ExplicitHugePages) {
+  PagePolicy policy;
+  policy.huge_pages = PagePolicy::HugePages::Explicit;
+
+  // Depends on the system having reserved huge pages.
+  auto buffer = PageBuffer::allocate(100, policy);
+  if (buffer.ok()) {
+    EXPECT_EQ(buffer->size(), 100);
+    std::memset(buffer->data(), 0xAB, buffer->size());
+  } else {
+    EXPECT_EQ(buffer.error(), Error::MemoryAllocationFailed);
+  }
+}
+
+TEST_F(PageMemoryTest, NumaNode) {
+  PagePolicy policy;
+  policy.numa_node = 100000;
+  EXPECT_EQ(PageBuffer::allocate(100, policy).error(), Error::InvalidArgument);
+}
+
+#endif // defined(__linux__)
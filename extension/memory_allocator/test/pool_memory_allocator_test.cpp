@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/memory_allocator/pool_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::extension::PoolMemoryAllocator;
+
+class PoolMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(PoolMemoryAllocatorTest, ReusesBlocksAfterReset) {
+  PoolMemoryAllocator allocator;
+
+  void* a = allocator.allocate(100);
+  void* b = allocator.allocate(1000);
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_NE(a, b);
+  EXPECT_EQ(allocator.stats().num_malloc_calls, 2);
+  EXPECT_EQ(allocator.stats().bytes_in_use, 128 + 1024);
+  EXPECT_EQ(allocator.used_size(), 128 + 1024);
+
+  allocator.reset();
+  EXPECT_EQ(allocator.stats().bytes_in_use, 0);
+  EXPECT_EQ(allocator.used_size(), 0);
+  EXPECT_EQ(allocator.stats().bytes_reserved, 128 + 1024);
+
+  // Requests in the same size classes get the same blocks back.
+  EXPECT_EQ(allocator.allocate(1020), b);
+  EXPECT_EQ(allocator.allocate(65), a);
+  EXPECT_EQ(allocator.stats().num_malloc_calls, 2);
+  EXPECT_EQ(allocator.stats().num_reused, 2);
+  EXPECT_EQ(allocator.stats().num_allocations, 4);
+
+  // A different size class needs a new block.
+  EXPECT_NE(allocator.allocate(10000), nullptr);
+  EXPECT_EQ(allocator.stats().num_malloc_calls, 3);
+}
+
+TEST_F(PoolMemoryAllocatorTest, SteadyStateDoesNotMalloc) {
+  PoolMemoryAllocator allocator;
+
+  for (size_t iteration = 0; iteration < 5; ++iteration) {
+    allocator.reset_stats();
+    for (size_t size = 16; size <= 4096; size *= 2) {
+      // Varying sizes that stay within the same size classes.
+      auto p = static_cast<uint8_t*>(allocator.allocate(size - iteration));
+      ASSERT_NE(p, nullptr);
+      // The whole allocation must be writable.
+      std::memset(p, 0x55, size - iteration);
+    }
+    allocator.reset();
+    if (iteration > 0) {
+      EXPECT_EQ(allocator.stats().num_malloc_calls, 0);
+    }
+  }
+}
+
+TEST_F(PoolMemoryAllocatorTest, AlignmentAndErrors) {
+  PoolMemoryAllocator allocator;
+
+  EXPECT_EQ(allocator.allocate(8, /*alignment=*/3), nullptr);
+
+  for (size_t alignment : {1, 8, 64, 256, 4096}) {
+    auto p = allocator.allocate(100, alignment);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0);
+  }
+
+  EXPECT_EQ(allocator.allocate(SIZE_MAX), nullptr);
+}
+
+TEST_F(PoolMemoryAllocatorTest, TrimFreesUnusedBlocks) {
+  PoolMemoryAllocator allocator;
+
+  ASSERT_NE(allocator.allocate(100), nullptr);
+  allocator.reset();
+  void* in_use = allocator.allocate(1000);
+  ASSERT_NE(in_use, nullptr);
+
+  allocator.trim();
+  EXPECT_EQ(allocator.stats().bytes_reserved, 1024);
+  EXPECT_EQ(allocator.stats().bytes_in_use, 1024);
+
+  // The trimmed block is gone, so the next allocation in its class mallocs.
+  allocator.reset_stats();
+  EXPECT_NE(allocator.allocate(100), nullptr);
+  EXPECT_EQ(allocator.stats().num_malloc_calls, 1);
+}
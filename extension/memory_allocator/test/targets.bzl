@@ -15,3 +15,44 @@ def define_common_targets():
             "//executorch/extension/memory_allocator:malloc_memory_allocator",
         ],
     )
+
+    runtime.cxx_test(
+        name = "pool_memory_allocator_test",
+        srcs = [
+            "pool_memory_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:pool_memory_allocator",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "page_memory_test",
+        srcs = [
+            "page_memory_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:page_memory",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "malloc_kernel_cache_test",
+        srcs = [
+            "malloc_kernel_cache_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:malloc_kernel_cache",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "memory_governor_test",
+        srcs = [
+            "memory_governor_test.cpp",
+        ],
+        deps = [
+            "//executorch/extension/memory_allocator:malloc_memory_allocator",
+            "//executorch/extension/memory_allocator:memory_governor",
+        ],
+    )
@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/dynamic_batcher.h>
+
+#include <cstring>
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+// Allocates a tensor as large as the largest tensor described by `info`.
+TensorPtr make_batch_buffer(const runtime::TensorInfo& info) {
+  return make_tensor_ptr(
+      std::vector<executorch::aten::SizesType>(
+          info.sizes().begin(), info.sizes().end()),
+      std::vector<uint8_t>(info.nbytes()),
+      info.scalar_type());
+}
+
+} // namespace
+
+runtime::Result<std::unique_ptr<DynamicBatcher>> DynamicBatcher::create(
+    Module& module,
+    Options options) {
+  const auto method_meta = ET_UNWRAP(module.method_meta(options.method_name));
+  std::unique_ptr<DynamicBatcher> batcher(
+      new DynamicBatcher(module, std::move(options)));
+
+  size_t max_batch_size = SIZE_MAX;
+  for (size_t i = 0; i < method_meta.num_inputs(); ++i) {
+    auto tag = ET_UNWRAP(method_meta.input_tag(i));
+    ET_CHECK_OR_RETURN_ERROR(
+        tag == runtime::Tag::Tensor,
+        NotSupported,
+        "input %zu is not a tensor",
+        i);
+    const auto info = ET_UNWRAP(method_meta.input_tensor_meta(i));
+    if (batcher->options_.has_batch_dim) {
+      ET_CHECK_OR_RETURN_ERROR(
+          !info.sizes().empty(),
+          NotSupported,
+          "input %zu has no batch dimension",
+          i);
+      max_batch_size = std::min(max_batch_size, size_t(info.sizes()[0]));
+    }
+    batcher->inputs_.push_back(make_batch_buffer(info));
+    batcher->input_sizes_.emplace_back(
+        info.sizes().begin(), info.sizes().end());
+  }
+  for (size_t i = 0; i < method_meta.num_outputs(); ++i) {
+    auto tag = ET_UNWRAP(method_meta.output_tag(i));
+    ET_CHECK_OR_RETURN_ERROR(
+        tag == runtime::Tag::Tensor,
+        NotSupported,
+        "output %zu is not a tensor",
+        i);
+    const auto info = ET_UNWRAP(method_meta.output_tensor_meta(i));
+    ET_CHECK_OR_RETURN_ERROR(
+        !batcher->options_.has_batch_dim || !info.sizes().empty(),
+        NotSupported,
+        "output %zu has no batch dimension",
+        i);
+    batcher->outputs_.push_back(make_batch_buffer(info));
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      !batcher->inputs_.empty(), NotSupported, "method has no inputs");
+
+  const auto& requested_size = batcher->options_.max_batch_size;
+  ET_CHECK_OR_RETURN_ERROR(
+      !batcher->options_.has_batch_dim || requested_size <= max_batch_size,
+      InvalidArgument,
+      "max_batch_size %zu is larger than the method's %zu",
+      requested_size,
+      max_batch_size);
+  batcher->max_batch_size_ =
+      requested_size > 0 ? requested_size : max_batch_size;
+
+  std::vector<runtime::EValue> input_values;
+  for (const auto& input : batcher->inputs_) {
+    input_values.emplace_back(*input);
+  }
+  std::vector<runtime::EValue> output_values;
+  for (const auto& output : batcher->outputs_) {
+    output_values.emplace_back(*output);
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(module.bind(
+      batcher->options_.method_name, input_values, output_values));
+
+  batcher->worker_ = std::thread(&DynamicBatcher::run, batcher.get());
+  return batcher;
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  queued_.notify_one();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+std::future<runtime::Result<std::vector<TensorPtr>>> DynamicBatcher::submit(
+    std::vector<TensorPtr> inputs) {
+  Request request;
+  auto future = request.promise.get_future();
+  auto batch_size = validate(inputs);
+  if (!batch_size.ok()) {
+    request.promise.set_value(batch_size.error());
+    return future;
+  }
+  request.inputs = std::move(inputs);
+  request.batch_size = *batch_size;
+  request.arrival = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_batch_size_ += request.batch_size;
+    queue_.push_back(std::move(request));
+  }
+  queued_.notify_one();
+  return future;
+}
+
+runtime::Result<size_t> DynamicBatcher::validate(
+    const std::vector<TensorPtr>& inputs) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      inputs.size() == inputs_.size(),
+      InvalidArgument,
+      "input size: %zu does not match method input size: %zu",
+      inputs.size(),
+      inputs_.size());
+  size_t batch_size = 0;
+  // Without a batch dimension, every dimension must match, and every request
+  // counts as one.
+  const size_t first_dim = options_.has_batch_dim ? 1 : 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        inputs[i] != nullptr, InvalidArgument, "input %zu is null", i);
+    const auto& input = *inputs[i];
+    const auto& sizes = input_sizes_[i];
+    ET_CHECK_OR_RETURN_ERROR(
+        input.scalar_type() == inputs_[i]->scalar_type(),
+        InvalidArgument,
+        "input %zu scalar type: %d does not match method input: %d",
+        i,
+        static_cast<int>(input.scalar_type()),
+        static_cast<int>(inputs_[i]->scalar_type()));
+    ET_CHECK_OR_RETURN_ERROR(
+        size_t(input.dim()) == sizes.size(),
+        InvalidArgument,
+        "input %zu has %zu dimensions, expected %zu",
+        i,
+        size_t(input.dim()),
+        sizes.size());
+    for (size_t d = first_dim; d < sizes.size(); ++d) {
+      ET_CHECK_OR_RETURN_ERROR(
+          input.size(d) == sizes[d],
+          InvalidArgument,
+          "input %zu has size %zd in dimension %zu, expected %zd",
+          i,
+          ssize_t(input.size(d)),
+          d,
+          ssize_t(sizes[d]));
+    }
+    if (!options_.has_batch_dim) {
+      batch_size = 1;
+      continue;
+    }
+    if (i == 0) {
+      batch_size = input.size(0);
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        size_t(input.size(0)) == batch_size,
+        InvalidArgument,
+        "input %zu has batch size %zd, but input 0 has %zu",
+        i,
+        ssize_t(input.size(0)),
+        batch_size);
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      batch_size > 0 && batch_size <= max_batch_size_,
+      InvalidArgument,
+      "batch size %zu is not in [1, %zu]",
+      batch_size,
+      max_batch_size_);
+  return batch_size;
+}
+
+runtime::Error DynamicBatcher::execute(
+    const std::vector<Request>& batch,
+    size_t batch_size) {
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    auto sizes = input_sizes_[i];
+    sizes[0] = batch_size;
+    ET_CHECK_OK_OR_RETURN_ERROR(resize_tensor_ptr(inputs_[i], sizes));
+    auto* data = static_cast<uint8_t*>(inputs_[i]->mutable_data_ptr());
+    for (const auto& request : batch) {
+      const auto& input = *request.inputs[i];
+      std::memcpy(data, input.const_data_ptr(), input.nbytes());
+      data += input.nbytes();
+    }
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(module_.execute_bound(options_.method_name));
+  for (size_t i = 0; i < outputs_.size(); ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        size_t(outputs_[i]->size(0)) == batch_size,
+        InvalidState,
+        "output %zu has batch size %zd, expected %zu",
+        i,
+        ssize_t(outputs_[i]->size(0)),
+        batch_size);
+  }
+  return runtime::Error::Ok;
+}
+
+runtime::Result<std::vector<TensorPtr>> DynamicBatcher::execute_unbatched(
+    const Request& request) {
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    const auto& input = *request.inputs[i];
+    std::memcpy(
+        inputs_[i]->mutable_data_ptr(), input.const_data_ptr(), input.nbytes());
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(module_.execute_bound(options_.method_name));
+  std::vector<TensorPtr> outputs;
+  outputs.reserve(outputs_.size());
+  for (const auto& output : outputs_) {
+    outputs.push_back(clone_tensor_ptr(output));
+  }
+  return outputs;
+}
+
+void DynamicBatcher::run() {
+  std::vector<Request> batch;
+  while (true) {
+    size_t batch_size = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      queued_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      // Give other requests until the deadline of the oldest one to fill up
+      // the batch. Requests without a batch dimension don't wait for others,
+      // since they are executed one at a time anyway.
+      if (options_.has_batch_dim) {
+        queued_.wait_until(
+            lock, queue_.front().arrival + options_.max_delay, [this] {
+              return stopping_ || queued_batch_size_ >= max_batch_size_;
+            });
+      }
+      while (!queue_.empty() &&
+             batch_size + queue_.front().batch_size <= max_batch_size_) {
+        batch_size += queue_.front().batch_size;
+        queued_batch_size_ -= queue_.front().batch_size;
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+
+    if (!options_.has_batch_dim) {
+      for (auto& request : batch) {
+        request.promise.set_value(execute_unbatched(request));
+      }
+      batch.clear();
+      continue;
+    }
+
+    const auto error = execute(batch, batch_size);
+    size_t offset = 0;
+    for (auto& request : batch) {
+      if (error != runtime::Error::Ok) {
+        request.promise.set_value(error);
+        continue;
+      }
+      std::vector<TensorPtr> outputs;
+      outputs.reserve(outputs_.size());
+      for (const auto& output : outputs_) {
+        // The batch buffers are reused, so each request gets a copy of its
+        // rows.
+        outputs.push_back(clone_tensor_ptr(
+            narrow_tensor_ptr(output, 0, offset, request.batch_size)));
+      }
+      offset += request.batch_size;
+      request.promise.set_value(std::move(outputs));
+    }
+    batch.clear();
+  }
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor_ptr.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: Coalesces concurrent requests to a method into single
+ * executions, for models exported with a dynamic batch dimension.
+ *
+ * Every input and output of the method must be a tensor whose first dimension
+ * is the batch dimension. Requests are queued, and a worker thread executes
+ * them together once either `max_batch_size` rows are queued, or the oldest
+ * request has waited for `max_delay`. The requests' inputs are concatenated
+ * along the batch dimension into buffers that are allocated once and bound to
+ * the method with Module::bind(), so inputs that the method does not
+ * memory-plan are used in place. Each request's rows of the outputs are then
+ * copied into tensors that it owns.
+ *
+ * Methods exported without a batch dimension can be batched with
+ * `has_batch_dim` set to false. Their requests are then executed one at a
+ * time, but back to back from the same bound buffers, which saves each
+ * execution the setup that delegates redo for new buffers, e.g. XNNPACK's.
+ *
+ * The batcher executes the method from its worker thread, so the Module must
+ * not be used otherwise, and must outlive the batcher.
+ */
+class DynamicBatcher final {
+ public:
+  struct Options {
+    /// The name of the method to execute.
+    std::string method_name = "forward";
+    /// The maximum number of rows to execute together, or 0 to use the upper
+    /// bound of the batch dimension of the method's inputs.
+    size_t max_batch_size = 0;
+    /// How long the oldest request waits for others to join its batch.
+    std::chrono::microseconds max_delay{1000};
+    /// Whether the first dimension of every input and output is the batch
+    /// dimension. If false, every request has the shapes of the method's
+    /// inputs, and up to `max_batch_size` queued requests, or all of them if
+    /// it is 0, are executed one after another without waiting for others.
+    bool has_batch_dim = true;
+  };
+
+  /**
+   * Loads the method if needed, allocates the batch buffers, and starts the
+   * worker thread.
+   *
+   * @param[in] module The Module to execute the method of.
+   * @param[in] options How to batch requests.
+   *
+   * @returns A new batcher, or an error if the method can't be batched.
+   * @retval Error::NotSupported An input or output of the method is not a
+   *     tensor with at least one dimension, or not a tensor if
+   *     `has_batch_dim` is false.
+   * @retval Error::InvalidArgument `max_batch_size` is larger than the method
+   *     supports.
+   */
+  ET_NODISCARD static runtime::Result<std::unique_ptr<DynamicBatcher>> create(
+      Module& module,
+      Options options);
+
+  /// Creates a batcher for the "forward" method with the default options.
+  ET_NODISCARD static runtime::Result<std::unique_ptr<DynamicBatcher>> create(
+      Module& module) {
+    return create(module, Options());
+  }
+
+  DynamicBatcher(const DynamicBatcher&) = delete;
+  DynamicBatcher& operator=(const DynamicBatcher&) = delete;
+  DynamicBatcher(DynamicBatcher&&) = delete;
+  DynamicBatcher& operator=(DynamicBatcher&&) = delete;
+
+  /// Executes the requests that are still queued, then stops the worker.
+  ~DynamicBatcher();
+
+  /**
+   * Queues a request. Thread-safe.
+   *
+   * @param[in] inputs One tensor per method input. All of them must have the
+   * same batch size, at most max_batch_size(), and otherwise the sizes and
+   * scalar types of the method's inputs. Without a batch dimension, they must
+   * have the sizes of the method's inputs.
+   *
+   * @returns A future for the request's rows of the method's outputs, or for
+   * an error if the request is invalid or its batch failed to execute.
+   */
+  std::future<runtime::Result<std::vector<TensorPtr>>> submit(
+      std::vector<TensorPtr> inputs);
+
+  /// The maximum number of rows executed together, or of requests executed
+  /// back to back without a batch dimension.
+  size_t max_batch_size() const {
+    return max_batch_size_;
+  }
+
+ private:
+  struct Request {
+    std::vector<TensorPtr> inputs;
+    size_t batch_size;
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<runtime::Result<std::vector<TensorPtr>>> promise;
+  };
+
+  DynamicBatcher(Module& module, Options options)
+      : module_(module), options_(std::move(options)) {}
+
+  runtime::Result<size_t> validate(const std::vector<TensorPtr>& inputs) const;
+  runtime::Error execute(const std::vector<Request>& batch, size_t batch_size);
+  runtime::Result<std::vector<TensorPtr>> execute_unbatched(
+      const Request& request);
+  void run();
+
+  Module& module_;
+  const Options options_;
+  size_t max_batch_size_ = 0;
+  // Buffers for the batched inputs and outputs, bound to the method, and the
+  // largest sizes of the inputs.
+  std::vector<TensorPtr> inputs_;
+  std::vector<TensorPtr> outputs_;
+  std::vector<std::vector<executorch::aten::SizesType>> input_sizes_;
+
+  std::mutex mutex_;
+  std::condition_variable queued_;
+  std::deque<Request> queue_;
+  // The total batch size of the requests in queue_.
+  size_t queued_batch_size_ = 0;
+  bool stopping_ = false;
+  std::thread worker_;
+};
+
+} // namespace extension
+} // namespace executorch
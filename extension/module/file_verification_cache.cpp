@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/file_verification_cache.h>
+
+#include <sys/stat.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace executorch {
+namespace extension {
+
+FileVerificationCache::FileVerificationCache(
+    std::string cache_path,
+    std::string program_path)
+    : cache_path_(std::move(cache_path)),
+      program_path_(std::move(program_path)) {}
+
+uint64_t FileVerificationCache::hash(const void* data, size_t size) {
+  // FNV-1a over 8-byte words, which is fast enough to be a small fraction of
+  // the cost of verifying the same data.
+  constexpr uint64_t kPrime = 0x100000001b3;
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  uint64_t result = 0xcbf29ce484222325 ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    result = (result ^ word) * kPrime;
+    result ^= result >> 29;
+  }
+  for (; i < size; ++i) {
+    result = (result ^ bytes[i]) * kPrime;
+  }
+  return result;
+}
+
+std::string FileVerificationCache::record(const void* data, size_t size)
+    const {
+  struct stat st;
+  if (::stat(program_path_.c_str(), &st) != 0) {
+    ET_LOG(
+        Error,
+        "Can't stat program file %s for the verification cache",
+        program_path_.c_str());
+    return "";
+  }
+  char prefix[96];
+  std::snprintf(
+      prefix,
+      sizeof(prefix),
+      "%016" PRIx64 " %zu %lld %lld ",
+      hash(data, size),
+      size,
+      static_cast<long long>(st.st_size),
+      static_cast<long long>(st.st_mtime));
+  return prefix + program_path_;
+}
+
+bool FileVerificationCache::contains(const void* data, size_t size) {
+  const std::string key = record(data, size);
+  if (key.empty()) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::ifstream file(cache_path_);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void FileVerificationCache::insert(const void* data, size_t size) {
+  const std::string key = record(data, size);
+  if (key.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::ofstream file(cache_path_, std::ios::app);
+  file << key << '\n';
+  if (!file) {
+    ET_LOG(Error, "Failed to write verification cache %s", cache_path_.c_str());
+  }
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <executorch/runtime/executor/verification_cache.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A VerificationCache that records the program files that passed
+ * verification in a file, so that loads of an unchanged program file in later
+ * processes skip verification.
+ *
+ * Records are keyed on the path, size and modification time of the program
+ * file, and on a hash of its program data. The hash is not cryptographic:
+ * anyone who can write to the cache file can make loads trust a corrupt
+ * program, so keep it somewhere only the application can write to.
+ */
+class FileVerificationCache final : public runtime::VerificationCache {
+ public:
+  /**
+   * @param[in] cache_path The path of the file that holds the records. It is
+   *     created when the first record is inserted.
+   * @param[in] program_path The path of the program file whose data the cache
+   *     is asked about.
+   */
+  FileVerificationCache(std::string cache_path, std::string program_path);
+
+  bool contains(const void* data, size_t size) override;
+
+  void insert(const void* data, size_t size) override;
+
+  /// Returns a 64-bit hash of `size` bytes at `data`.
+  static uint64_t hash(const void* data, size_t size);
+
+ private:
+  /// Returns the record for the program data, or an empty string if the
+  /// program file can't be inspected.
+  std::string record(const void* data, size_t size) const;
+
+  const std::string cache_path_;
+  const std::string program_path_;
+  std::mutex mutex_;
+};
+
+} // namespace extension
+} // namespace executorch
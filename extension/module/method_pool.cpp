@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/method_pool.h>
+
+#include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+namespace executorch {
+namespace extension {
+
+runtime::Result<std::unique_ptr<MethodPool>> MethodPool::load(
+    std::shared_ptr<runtime::Program> program,
+    const std::string& method_name,
+    size_t num_instances) {
+  ET_CHECK_OR_RETURN_ERROR(
+      program != nullptr, InvalidArgument, "Program must not be null");
+  ET_CHECK_OR_RETURN_ERROR(
+      num_instances > 0, InvalidArgument, "Pool must have at least 1 instance");
+  runtime::runtime_init();
+
+  std::unique_ptr<MethodPool> pool(
+      new MethodPool(std::move(program), method_name));
+  pool->instances_.reserve(num_instances);
+  pool->free_indices_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; ++i) {
+    pool->instances_.emplace_back();
+    ET_CHECK_OK_OR_RETURN_ERROR(pool->load_instance(pool->instances_.back()));
+    // Push in reverse so instance 0 is handed out first.
+    pool->free_indices_.push_back(num_instances - 1 - i);
+  }
+  return pool;
+}
+
+runtime::Error MethodPool::load_instance(Instance& instance) {
+  const auto method_meta =
+      ET_UNWRAP(program_->method_meta(method_name_.c_str()));
+  const auto num_planned_buffers = method_meta.num_memory_planned_buffers();
+  instance.planned_buffers.reserve(num_planned_buffers);
+  instance.planned_spans.reserve(num_planned_buffers);
+
+  for (size_t index = 0; index < num_planned_buffers; ++index) {
+    const auto buffer_size =
+        ET_UNWRAP(method_meta.memory_planned_buffer_size(index));
+    instance.planned_buffers.emplace_back(buffer_size);
+    instance.planned_spans.emplace_back(
+        instance.planned_buffers.back().data(), buffer_size);
+  }
+  instance.method_allocator = std::make_unique<MallocMemoryAllocator>();
+  instance.temp_allocator = std::make_unique<MallocMemoryAllocator>();
+  instance.planned_memory =
+      std::make_unique<runtime::HierarchicalAllocator>(runtime::Span(
+          instance.planned_spans.data(), instance.planned_spans.size()));
+  instance.memory_manager = std::make_unique<runtime::MemoryManager>(
+      instance.method_allocator.get(),
+      instance.planned_memory.get(),
+      instance.temp_allocator.get());
+
+  auto method =
+      program_->load_method(method_name_.c_str(), instance.memory_manager.get());
+  if (!method.ok()) {
+    return method.error();
+  }
+  instance.method = std::make_unique<runtime::Method>(std::move(*method));
+  return runtime::Error::Ok;
+}
+
+MethodPool::Lease MethodPool::acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  available_.wait(lock, [this] { return !free_indices_.empty(); });
+  const auto index = free_indices_.back();
+  free_indices_.pop_back();
+  return Lease(this, index);
+}
+
+std::optional<MethodPool::Lease> MethodPool::try_acquire() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_indices_.empty()) {
+    return std::nullopt;
+  }
+  const auto index = free_indices_.back();
+  free_indices_.pop_back();
+  return Lease(this, index);
+}
+
+void MethodPool::release(size_t index) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_indices_.push_back(index);
+  }
+  available_.notify_one();
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <executorch/runtime/executor/program.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: A fixed set of executable instances of one method, for serving
+ * concurrent requests from a single loaded program.
+ *
+ * All instances share the Program, and with it the constant segment and the
+ * processed delegate data, but each instance owns its memory-planned buffers
+ * and allocators, so different instances can execute concurrently on
+ * different threads. A single instance must only be used by one thread at a
+ * time; acquire() hands each one out exclusively.
+ */
+class MethodPool final {
+ public:
+  /**
+   * Exclusive access to one instance of the pool. The instance is returned to
+   * the pool when the lease is destroyed. The pool owns the instance, so the
+   * lease, and any reference to its Method, must not outlive the pool.
+   */
+  class Lease final {
+   public:
+    Lease(Lease&& rhs) noexcept : pool_(rhs.pool_), index_(rhs.index_) {
+      rhs.pool_ = nullptr;
+    }
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    Lease& operator=(Lease&&) = delete;
+
+    ~Lease() {
+      if (pool_ != nullptr) {
+        pool_->release(index_);
+      }
+    }
+
+    /// The leased Method.
+    runtime::Method& method() const {
+      return *pool_->instances_[index_].method;
+    }
+
+    runtime::Method* operator->() const {
+      return &method();
+    }
+
+    runtime::Method& operator*() const {
+      return method();
+    }
+
+   private:
+    friend class MethodPool;
+    Lease(MethodPool* pool, size_t index) : pool_(pool), index_(index) {}
+
+    MethodPool* pool_;
+    size_t index_;
+  };
+
+  /**
+   * Loads `num_instances` instances of a method.
+   *
+   * @param[in] program The program to load the method from. The pool shares
+   * ownership of it, so the program stays alive until both the pool and the
+   * caller's other references to it are gone.
+   * @param[in] method_name The name of the method to load.
+   * @param[in] num_instances The number of instances to create. Must be
+   * greater than zero.
+   *
+   * @returns A new pool, or an error if any of the instances failed to load.
+   */
+  ET_NODISCARD static runtime::Result<std::unique_ptr<MethodPool>> load(
+      std::shared_ptr<runtime::Program> program,
+      const std::string& method_name,
+      size_t num_instances);
+
+  MethodPool(const MethodPool&) = delete;
+  MethodPool& operator=(const MethodPool&) = delete;
+  MethodPool(MethodPool&&) = delete;
+  MethodPool& operator=(MethodPool&&) = delete;
+
+  /**
+   * Waits until an instance is free and checks it out.
+   *
+   * @returns A lease for the instance.
+   */
+  Lease acquire();
+
+  /**
+   * Checks out an instance if one is free, without waiting.
+   *
+   * @returns A lease for the instance, or nullopt if all instances are in use.
+   */
+  std::optional<Lease> try_acquire();
+
+  /// The total number of instances in the pool.
+  size_t size() const {
+    return instances_.size();
+  }
+
+  /// The name of the method the pool holds instances of.
+  const std::string& method_name() const {
+    return method_name_;
+  }
+
+ private:
+  struct Instance {
+    std::vector<std::vector<uint8_t>> planned_buffers;
+    std::vector<runtime::Span<uint8_t>> planned_spans;
+    std::unique_ptr<runtime::MemoryAllocator> method_allocator;
+    std::unique_ptr<runtime::MemoryAllocator> temp_allocator;
+    std::unique_ptr<runtime::HierarchicalAllocator> planned_memory;
+    std::unique_ptr<runtime::MemoryManager> memory_manager;
+    std::unique_ptr<runtime::Method> method;
+  };
+
+  MethodPool(std::shared_ptr<runtime::Program> program, std::string method_name)
+      : program_(std::move(program)), method_name_(std::move(method_name)) {}
+
+  runtime::Error load_instance(Instance& instance);
+  void release(size_t index);
+
+  std::shared_ptr<runtime::Program> program_;
+  std::string method_name_;
+  std::vector<Instance> instances_;
+
+  std::mutex mutex_;
+  std::condition_variable available_;
+  // Indices into instances_ that are not checked out, used as a stack so the
+  // most recently used instance, whose memory is likely still cached, is
+  // handed out next.
+  std::vector<size_t> free_indices_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -8,9 +8,19 @@
 
 #include <executorch/extension/module/module.h>
 
-#include <executorch/extension/data_loader/file_data_loader.h>
+#include <algorithm>
+#include <condition_variable>
+#include <numeric>
+#include <mutex>
+#include <thread>
+
 #include <executorch/extension/data_loader/mmap_data_loader.h>
+#include <executorch/extension/data_loader/shared_file_data_loader.h>
+#include <executorch/extension/flat_tensor/flat_tensor_data_map.h>
+#include <executorch/extension/memory_allocator/malloc_kernel_cache.h>
 #include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/extension/module/file_verification_cache.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/platform/runtime.h>
 
 /**
@@ -48,6 +58,20 @@ Module::Module(
   runtime::runtime_init();
 }
 
+Module::Module(
+    const std::string& file_path,
+    const std::string& data_map_path,
+    const LoadMode load_mode,
+    std::unique_ptr<runtime::EventTracer> event_tracer)
+    : file_path_(file_path),
+      data_map_path_(data_map_path),
+      load_mode_(load_mode),
+      memory_allocator_(std::make_unique<MallocMemoryAllocator>()),
+      temp_allocator_(std::make_unique<MallocMemoryAllocator>()),
+      event_tracer_(std::move(event_tracer)) {
+  runtime::runtime_init();
+}
+
 Module::Module(
     std::unique_ptr<runtime::DataLoader> data_loader,
     std::unique_ptr<runtime::MemoryAllocator> memory_allocator,
@@ -80,37 +104,111 @@ Module::Module(
   runtime::runtime_init();
 }
 
+runtime::Result<std::unique_ptr<runtime::DataLoader>> Module::make_data_loader(
+    const std::string& path) const {
+  std::unique_ptr<runtime::DataLoader> data_loader;
+  switch (load_mode_) {
+    case LoadMode::File:
+      data_loader = ET_UNWRAP_UNIQUE(SharedFileDataLoader::from(path.c_str()));
+      break;
+    case LoadMode::Mmap:
+      data_loader = ET_UNWRAP_UNIQUE(MmapDataLoader::from(
+          path.c_str(), MmapDataLoader::MlockConfig::NoMlock, page_policy_));
+      break;
+    case LoadMode::MmapUseMlock:
+      data_loader = ET_UNWRAP_UNIQUE(MmapDataLoader::from(
+          path.c_str(), MmapDataLoader::MlockConfig::UseMlock, page_policy_));
+      break;
+    case LoadMode::MmapUseMlockIgnoreErrors:
+      data_loader = ET_UNWRAP_UNIQUE(MmapDataLoader::from(
+          path.c_str(),
+          MmapDataLoader::MlockConfig::UseMlockIgnoreErrors,
+          page_policy_));
+      break;
+  }
+  return data_loader;
+}
+
 runtime::Error Module::load(const runtime::Program::Verification verification) {
   if (!is_loaded()) {
     if (!data_loader_) {
-      switch (load_mode_) {
-        case LoadMode::File:
-          data_loader_ =
-              ET_UNWRAP_UNIQUE(FileDataLoader::from(file_path_.c_str()));
-          break;
-        case LoadMode::Mmap:
-          data_loader_ = ET_UNWRAP_UNIQUE(MmapDataLoader::from(
-              file_path_.c_str(), MmapDataLoader::MlockConfig::NoMlock));
-          break;
-        case LoadMode::MmapUseMlock:
-          data_loader_ =
-              ET_UNWRAP_UNIQUE(MmapDataLoader::from(file_path_.c_str()));
-          break;
-        case LoadMode::MmapUseMlockIgnoreErrors:
-          data_loader_ = ET_UNWRAP_UNIQUE(MmapDataLoader::from(
-              file_path_.c_str(),
-              MmapDataLoader::MlockConfig::UseMlockIgnoreErrors));
-          break;
+      data_loader_ = ET_UNWRAP(make_data_loader(file_path_));
+    }
+    if (!data_map_path_.empty() && !data_map_) {
+      data_map_loader_ = ET_UNWRAP(make_data_loader(data_map_path_));
+      data_map_ = ET_UNWRAP_UNIQUE(
+          FlatTensorDataMap::load(data_map_loader_.get()));
+    }
+    size_t constants_nbytes = 0;
+    if (memory_governor_) {
+      constants_nbytes = ET_UNWRAP(data_loader_->size());
+      if (data_map_loader_) {
+        constants_nbytes += ET_UNWRAP(data_map_loader_->size());
+      }
+      ET_CHECK_OK_OR_RETURN_ERROR(memory_governor_->reserve(
+          memory_client_,
+          MemoryGovernor::Category::Constants,
+          constants_nbytes));
+    }
+    auto program = runtime::Program::load(
+        data_loader_.get(),
+        verification,
+        runtime::Program::ConstantLoading::Eager,
+        verification_runner_,
+        verification_cache_.get());
+    if (!program.ok()) {
+      if (memory_governor_) {
+        memory_governor_->release(
+            memory_client_,
+            MemoryGovernor::Category::Constants,
+            constants_nbytes);
       }
-    };
-    auto program = ET_UNWRAP_UNIQUE(
-        runtime::Program::load(data_loader_.get(), verification));
+      return program.error();
+    }
     program_ = std::shared_ptr<runtime::Program>(
-        program.release(), [](runtime::Program* pointer) { delete pointer; });
+        new runtime::Program(std::move(*program)),
+        [](runtime::Program* pointer) { delete pointer; });
   }
   return runtime::Error::Ok;
 }
 
+runtime::Error Module::set_memory_governor(
+    MemoryGovernor* governor,
+    bool evictable) {
+  ET_CHECK_OR_RETURN_ERROR(
+      !(is_loaded() && data_loader_) && methods_.empty() &&
+          async_loads_.empty(),
+      InvalidState,
+      "The memory governor must be set before loading");
+  if (memory_governor_) {
+    memory_governor_->unregister_client(memory_client_);
+  }
+  memory_governor_ = governor;
+  if (memory_governor_) {
+    MemoryGovernor::EvictFunction evict;
+    if (evictable) {
+      evict = [this]() { evict_methods(); };
+    }
+    memory_client_ = memory_governor_->register_client(
+        file_path_.empty() ? "module" : file_path_, std::move(evict));
+  }
+  return runtime::Error::Ok;
+}
+
+void Module::evict_methods() {
+  // Destroying the methods releases their memory from the governor.
+  methods_.clear();
+}
+
+void Module::set_verification_cache_path(const std::string& cache_path) {
+  if (cache_path.empty() || file_path_.empty()) {
+    verification_cache_ = nullptr;
+    return;
+  }
+  verification_cache_ =
+      std::make_unique<FileVerificationCache>(cache_path, file_path_);
+}
+
 runtime::Result<std::unordered_set<std::string>> Module::method_names() {
   ET_CHECK_OK_OR_RETURN_ERROR(load());
   const auto method_count = program_->num_methods();
@@ -126,49 +224,416 @@ runtime::Result<std::unordered_set<std::string>> Module::method_names() {
 runtime::Error Module::load_method(
     const std::string& method_name,
     torch::executor::EventTracer* event_tracer) {
+  const auto memory_use = use_memory();
   if (!is_method_loaded(method_name)) {
     ET_CHECK_OK_OR_RETURN_ERROR(load());
+    if (ET_UNWRAP(take_async_loaded_method(method_name))) {
+      return runtime::Error::Ok;
+    }
+    const auto scope = enter_execution_scope();
+    auto method_holder = ET_UNWRAP(make_method_holder(
+        method_name,
+        event_tracer ? event_tracer : this->event_tracer(),
+        /*own_allocators=*/false));
+    methods_.emplace(method_name, std::move(method_holder));
+  }
+  return runtime::Error::Ok;
+}
+
+runtime::Result<Module::MethodHolder> Module::make_method_holder(
+    const std::string& method_name,
+    runtime::EventTracer* event_tracer,
+    bool own_allocators) {
+  MethodHolder method_holder;
+  auto* memory_allocator = memory_allocator_.get();
+  auto* temp_allocator = temp_allocator_.get();
+  if (memory_governor_) {
+    method_holder.method_allocator = std::make_unique<GovernedMemoryAllocator>(
+        std::make_unique<MallocMemoryAllocator>(),
+        *memory_governor_,
+        memory_client_,
+        MemoryGovernor::Category::Method);
+    method_holder.temp_allocator = std::make_unique<MallocMemoryAllocator>();
+    memory_allocator = method_holder.method_allocator.get();
+    temp_allocator = method_holder.temp_allocator.get();
+  } else if (own_allocators) {
+    method_holder.method_allocator = std::make_unique<MallocMemoryAllocator>();
+    method_holder.temp_allocator = std::make_unique<MallocMemoryAllocator>();
+    memory_allocator = method_holder.method_allocator.get();
+    temp_allocator = method_holder.temp_allocator.get();
+  }
+  const auto method_metadata =
+      ET_UNWRAP(program_->method_meta(method_name.c_str()));
+  const auto planned_buffersCount =
+      method_metadata.num_memory_planned_buffers();
+  std::vector<size_t> buffer_sizes;
+  buffer_sizes.reserve(planned_buffersCount);
+  for (auto index = 0; index < planned_buffersCount; ++index) {
+    buffer_sizes.push_back(
+        method_metadata.memory_planned_buffer_size(index).get());
+  }
+
+  const auto shared = shared_planned_buffers_.find(method_name);
+  if (shared != shared_planned_buffers_.end()) {
+    method_holder.planned_buffers = shared->second;
+  } else {
+    method_holder.planned_buffers =
+        ET_UNWRAP(allocate_planned_buffers(buffer_sizes));
+  }
+  method_holder.planned_spans.reserve(planned_buffersCount);
+  for (auto index = 0; index < planned_buffersCount; ++index) {
+    method_holder.planned_spans.emplace_back(
+        method_holder.planned_buffers->data[index], buffer_sizes[index]);
+  }
+  method_holder.planned_memory =
+      std::make_unique<runtime::HierarchicalAllocator>(runtime::Span(
+          method_holder.planned_spans.data(),
+          method_holder.planned_spans.size()));
+  method_holder.memory_manager = std::make_unique<runtime::MemoryManager>(
+      memory_allocator, method_holder.planned_memory.get(), temp_allocator);
+  method_holder.method = ET_UNWRAP_UNIQUE(program_->load_method(
+      method_name.c_str(),
+      method_holder.memory_manager.get(),
+      event_tracer,
+      data_map_.get(),
+      init_runner_));
+  if (kernel_cache_enabled_) {
+    method_holder.kernel_cache = std::make_unique<MallocKernelCache>();
+    ET_CHECK_OK_OR_RETURN_ERROR(method_holder.method->set_kernel_cache(
+        method_holder.kernel_cache.get()));
+  }
+  method_holder.inputs.resize(method_holder.method->inputs_size());
+  return method_holder;
+}
+
+struct Module::AsyncLoad {
+  enum class State {
+    // Not started yet.
+    Pending,
+    // Loading in the background.
+    Loading,
+    // Loaded in the background, successfully or with `error`.
+    Loaded,
+    // Moved into methods_, failed, or left to the caller or to ~Module().
+    Taken,
+  };
+
+  struct Entry {
+    std::string method_name;
+    State state = State::Pending;
+    runtime::Error error = runtime::Error::Ok;
+    MethodHolder holder;
+  };
+
+  // In order of priority.
+  std::vector<Entry> entries;
+  runtime::ParallelRunner* runner = nullptr;
+  LoadCallback callback;
+  std::mutex mutex;
+  std::condition_variable loaded;
+  std::thread thread;
+};
+
+Module::~Module() {
+  // Only wait for the methods that are already loading.
+  for (auto& async_load : async_loads_) {
+    {
+      std::lock_guard<std::mutex> lock(async_load->mutex);
+      for (auto& entry : async_load->entries) {
+        if (entry.state == AsyncLoad::State::Pending) {
+          entry.state = AsyncLoad::State::Taken;
+        }
+      }
+    }
+    async_load->thread.join();
+  }
+  // Waits for an eviction in progress, and prevents later ones.
+  if (memory_governor_) {
+    memory_governor_->unregister_client(memory_client_);
+  }
+}
+
+runtime::Error Module::load_async(
+    const std::vector<std::string>& method_names,
+    runtime::ParallelRunner* runner,
+    LoadCallback callback) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+
+  auto async_load = std::make_unique<AsyncLoad>();
+  std::unordered_set<std::string> listed;
+  for (const auto& method_name : method_names) {
+    ET_CHECK_OR_RETURN_ERROR(
+        listed.insert(method_name).second,
+        InvalidArgument,
+        "Method %s is listed twice",
+        method_name.c_str());
+    ET_CHECK_OR_RETURN_ERROR(
+        program_->method_meta(method_name.c_str()).ok(),
+        InvalidArgument,
+        "Method %s is not in the program",
+        method_name.c_str());
+    ET_CHECK_OR_RETURN_ERROR(
+        !is_async_loading(method_name),
+        InvalidState,
+        "Method %s is already loading in the background",
+        method_name.c_str());
+    if (!is_method_loaded(method_name)) {
+      AsyncLoad::Entry entry;
+      entry.method_name = method_name;
+      async_load->entries.push_back(std::move(entry));
+    }
+  }
+  if (async_load->entries.empty()) {
+    return runtime::Error::Ok;
+  }
+  async_load->runner = runner;
+  async_load->callback = std::move(callback);
+  auto* pointer = async_load.get();
+  async_load->thread =
+      std::thread([this, pointer] { run_async_load(*pointer); });
+  async_loads_.push_back(std::move(async_load));
+  return runtime::Error::Ok;
+}
+
+void Module::run_async_load(AsyncLoad& async_load) {
+  // Each call loads the first method that is still pending, so the methods
+  // start in order of priority however the runner schedules the calls.
+  auto load_next = [this, &async_load]() {
+    AsyncLoad::Entry* entry = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(async_load.mutex);
+      for (auto& candidate : async_load.entries) {
+        if (candidate.state == AsyncLoad::State::Pending) {
+          candidate.state = AsyncLoad::State::Loading;
+          entry = &candidate;
+          break;
+        }
+      }
+    }
+    if (entry == nullptr) {
+      return;
+    }
+    const auto scope = enter_execution_scope();
+    auto method_holder = make_method_holder(
+        entry->method_name,
+        /*event_tracer=*/nullptr,
+        /*own_allocators=*/true);
+    const auto error = method_holder.error();
+    {
+      std::lock_guard<std::mutex> lock(async_load.mutex);
+      if (method_holder.ok()) {
+        entry->holder = std::move(*method_holder);
+      }
+      entry->error = error;
+      entry->state = AsyncLoad::State::Loaded;
+    }
+    async_load.loaded.notify_all();
+    if (async_load.callback) {
+      async_load.callback(entry->method_name, error);
+    }
+  };
+
+  const auto num_methods = async_load.entries.size();
+  if (async_load.runner == nullptr) {
+    for (size_t index = 0; index < num_methods; ++index) {
+      load_next();
+    }
+    return;
+  }
+  async_load.runner->run(
+      [](void* context, size_t /*task_index*/) {
+        (*static_cast<decltype(load_next)*>(context))();
+      },
+      &load_next,
+      num_methods);
+}
+
+bool Module::is_async_loading(const std::string& method_name) {
+  for (auto& async_load : async_loads_) {
+    std::lock_guard<std::mutex> lock(async_load->mutex);
+    for (const auto& entry : async_load->entries) {
+      if (entry.method_name == method_name &&
+          entry.state != AsyncLoad::State::Taken) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+runtime::Result<bool> Module::take_async_loaded_method(
+    const std::string& method_name) {
+  for (auto& async_load : async_loads_) {
+    std::unique_lock<std::mutex> lock(async_load->mutex);
+    for (auto& entry : async_load->entries) {
+      if (entry.method_name != method_name ||
+          entry.state == AsyncLoad::State::Taken) {
+        continue;
+      }
+      if (entry.state == AsyncLoad::State::Pending) {
+        entry.state = AsyncLoad::State::Taken;
+        return false;
+      }
+      async_load->loaded.wait(lock, [&entry] {
+        return entry.state == AsyncLoad::State::Loaded;
+      });
+      entry.state = AsyncLoad::State::Taken;
+      // A failed load is retried by the next call that needs the method.
+      ET_CHECK_OK_OR_RETURN_ERROR(entry.error);
+      methods_.emplace(method_name, std::move(entry.holder));
+      return true;
+    }
+  }
+  return false;
+}
+
+runtime::Result<std::shared_ptr<Module::PlannedBuffers>>
+Module::allocate_planned_buffers(const std::vector<size_t>& buffer_sizes) {
+  auto planned_buffers = std::make_shared<PlannedBuffers>();
+  if (memory_governor_) {
+    const size_t nbytes =
+        std::accumulate(buffer_sizes.begin(), buffer_sizes.end(), size_t{0});
+    ET_CHECK_OK_OR_RETURN_ERROR(memory_governor_->reserve(
+        memory_client_, MemoryGovernor::Category::PlannedMemory, nbytes));
+    planned_buffers->governor = memory_governor_;
+    planned_buffers->client = memory_client_;
+    planned_buffers->nbytes = nbytes;
+  }
+  planned_buffers->data.reserve(buffer_sizes.size());
+  if (page_policy_.is_default()) {
+    planned_buffers->buffers.reserve(buffer_sizes.size());
+    for (const auto buffer_size : buffer_sizes) {
+      planned_buffers->buffers.emplace_back(buffer_size);
+      planned_buffers->data.push_back(planned_buffers->buffers.back().data());
+    }
+  } else {
+    planned_buffers->page_buffers.reserve(buffer_sizes.size());
+    for (const auto buffer_size : buffer_sizes) {
+      planned_buffers->page_buffers.emplace_back(
+          ET_UNWRAP(PageBuffer::allocate(buffer_size, page_policy_)));
+      planned_buffers->data.push_back(
+          planned_buffers->page_buffers.back().data());
+    }
+  }
+  return planned_buffers;
+}
 
-    MethodHolder method_holder;
+runtime::Error Module::share_planned_memory(
+    const std::vector<std::string>& method_names) {
+  ET_CHECK_OK_OR_RETURN_ERROR(load());
+
+  std::vector<size_t> buffer_sizes;
+  for (const auto& method_name : method_names) {
+    ET_CHECK_OR_RETURN_ERROR(
+        !is_method_loaded(method_name) && !is_async_loading(method_name),
+        InvalidState,
+        "Method %s is already loaded",
+        method_name.c_str());
+    ET_CHECK_OR_RETURN_ERROR(
+        shared_planned_buffers_.count(method_name) == 0,
+        InvalidState,
+        "Method %s already shares planned memory",
+        method_name.c_str());
     const auto method_metadata =
         ET_UNWRAP(program_->method_meta(method_name.c_str()));
-    const auto planned_buffersCount =
+    const auto planned_buffers_count =
         method_metadata.num_memory_planned_buffers();
-    method_holder.planned_buffers.reserve(planned_buffersCount);
-    method_holder.planned_spans.reserve(planned_buffersCount);
-
-    for (auto index = 0; index < planned_buffersCount; ++index) {
+    if (buffer_sizes.size() < planned_buffers_count) {
+      buffer_sizes.resize(planned_buffers_count);
+    }
+    for (size_t index = 0; index < planned_buffers_count; ++index) {
       const auto buffer_size =
-          method_metadata.memory_planned_buffer_size(index).get();
-      method_holder.planned_buffers.emplace_back(buffer_size);
-      method_holder.planned_spans.emplace_back(
-          method_holder.planned_buffers.back().data(), buffer_size);
-    }
-    method_holder.planned_memory =
-        std::make_unique<runtime::HierarchicalAllocator>(runtime::Span(
-            method_holder.planned_spans.data(),
-            method_holder.planned_spans.size()));
-    method_holder.memory_manager = std::make_unique<runtime::MemoryManager>(
-        memory_allocator_.get(),
-        method_holder.planned_memory.get(),
-        temp_allocator_.get());
-    method_holder.method = ET_UNWRAP_UNIQUE(program_->load_method(
-        method_name.c_str(),
-        method_holder.memory_manager.get(),
-        event_tracer ? event_tracer : this->event_tracer()));
-    method_holder.inputs.resize(method_holder.method->inputs_size());
-    methods_.emplace(method_name, std::move(method_holder));
+          ET_UNWRAP(method_metadata.memory_planned_buffer_size(index));
+      buffer_sizes[index] = std::max<size_t>(buffer_sizes[index], buffer_size);
+    }
+  }
+
+  auto planned_buffers = ET_UNWRAP(allocate_planned_buffers(buffer_sizes));
+  for (const auto& method_name : method_names) {
+    shared_planned_buffers_.emplace(method_name, planned_buffers);
   }
   return runtime::Error::Ok;
 }
 
 runtime::Result<runtime::MethodMeta> Module::method_meta(
     const std::string& method_name) {
+  const auto memory_use = use_memory();
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
   return methods_.at(method_name).method->method_meta();
 }
 
-runtime::Result<std::vector<runtime::EValue>> Module::execute(
+runtime::Result<std::vector<runtime::Span<uint8_t>>> Module::planned_buffers(
+    const std::string& method_name) {
+  const auto memory_use = use_memory();
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  return methods_.at(method_name).planned_spans;
+}
+
+runtime::Result<Module::WarmupStats> Module::warmup(
+    const std::string& method_name,
+    const WarmupOptions& options) {
+  const auto memory_use = use_memory();
+  using Clock = std::chrono::steady_clock;
+  WarmupStats stats;
+  auto start = Clock::now();
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  stats.load_time = Clock::now() - start;
+  auto& method_holder = methods_.at(method_name);
+
+  if (options.populate_planned_memory) {
+    start = Clock::now();
+    for (const auto& span : method_holder.planned_spans) {
+      populate_pages(span.data(), span.size());
+    }
+    stats.populate_time = Clock::now() - start;
+  }
+
+  std::vector<std::vector<uint8_t>> saved_state;
+  if (options.preserve_state) {
+    saved_state.reserve(method_holder.planned_spans.size());
+    for (const auto& span : method_holder.planned_spans) {
+      saved_state.emplace_back(span.begin(), span.end());
+    }
+  }
+  const auto previous_inputs = method_holder.inputs;
+  // Executing without inputs uses the ones set before.
+  const std::vector<std::vector<runtime::EValue>> no_inputs(1);
+  const auto& input_sets = options.inputs.empty() ? no_inputs : options.inputs;
+
+  auto error = runtime::Error::Ok;
+  stats.execution_times.reserve(input_sets.size() * options.num_executions);
+  for (size_t i = 0; i < input_sets.size() && error == runtime::Error::Ok;
+       ++i) {
+    for (size_t j = 0; j < options.num_executions; ++j) {
+      start = Clock::now();
+      error = execute(method_name, input_sets[i]).error();
+      stats.execution_times.push_back(Clock::now() - start);
+      if (error != runtime::Error::Ok) {
+        break;
+      }
+    }
+  }
+
+  // Leave the inputs and state as they were, even if an execution failed.
+  method_holder.inputs = previous_inputs;
+  for (size_t i = 0; i < saved_state.size(); ++i) {
+    std::copy(
+        saved_state[i].begin(),
+        saved_state[i].end(),
+        method_holder.planned_spans[i].begin());
+  }
+  if (error != runtime::Error::Ok) {
+    return error;
+  }
+  return stats;
+}
+
+runtime::Result<Module::WarmupStats> Module::warmup(
+    const std::string& method_name) {
+  return warmup(method_name, WarmupOptions());
+}
+
+runtime::Error Module::prepare_execution(
     const std::string& method_name,
     const std::vector<runtime::EValue>& input_values) {
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
@@ -184,8 +649,17 @@ runtime::Result<std::vector<runtime::EValue>> Module::execute(
     ET_CHECK_OR_RETURN_ERROR(
         !inputs[i].isNone(), InvalidArgument, "input %zu is none", i);
   }
-  ET_CHECK_OK_OR_RETURN_ERROR(method->set_inputs(
-      exec_aten::ArrayRef<runtime::EValue>(inputs.data(), inputs.size())));
+  return method->set_inputs(
+      exec_aten::ArrayRef<runtime::EValue>(inputs.data(), inputs.size()));
+}
+
+runtime::Result<std::vector<runtime::EValue>> Module::execute(
+    const std::string& method_name,
+    const std::vector<runtime::EValue>& input_values) {
+  const auto memory_use = use_memory();
+  const auto scope = enter_execution_scope();
+  ET_CHECK_OK_OR_RETURN_ERROR(prepare_execution(method_name, input_values));
+  auto& method = methods_.at(method_name).method;
   ET_CHECK_OK_OR_RETURN_ERROR(method->execute());
 
   const auto outputs_size = method->outputs_size();
@@ -196,10 +670,59 @@ runtime::Result<std::vector<runtime::EValue>> Module::execute(
   return outputs;
 }
 
+std::future<runtime::Result<std::vector<runtime::EValue>>>
+Module::execute_async(
+    const std::string& method_name,
+    const std::vector<runtime::EValue>& input_values) {
+  struct AsyncExecution {
+    runtime::Method* method;
+    std::promise<runtime::Result<std::vector<runtime::EValue>>> promise;
+    // Keeps the method loaded until it finishes executing.
+    MemoryGovernor::ScopedUse memory_use;
+  };
+  auto* execution = new AsyncExecution();
+  execution->memory_use = use_memory();
+  auto future = execution->promise.get_future();
+  // Only covers the part of the execution that runs on the calling thread.
+  const auto scope = enter_execution_scope();
+
+  auto error = prepare_execution(method_name, input_values);
+  if (error == runtime::Error::Ok) {
+    execution->method = methods_.at(method_name).method.get();
+    // On success the callback takes ownership of `execution`, and may already
+    // have run by the time execute_async() returns.
+    error = execution->method->execute_async(
+        [](void* context, runtime::Error execution_error) {
+          std::unique_ptr<AsyncExecution> execution(
+              static_cast<AsyncExecution*>(context));
+          if (execution_error != runtime::Error::Ok) {
+            execution->promise.set_value(execution_error);
+            return;
+          }
+          const auto outputs_size = execution->method->outputs_size();
+          std::vector<runtime::EValue> outputs(outputs_size);
+          const auto outputs_error =
+              execution->method->get_outputs(outputs.data(), outputs_size);
+          if (outputs_error != runtime::Error::Ok) {
+            execution->promise.set_value(outputs_error);
+            return;
+          }
+          execution->promise.set_value(std::move(outputs));
+        },
+        execution);
+  }
+  if (error != runtime::Error::Ok) {
+    execution->promise.set_value(error);
+    delete execution;
+  }
+  return future;
+}
+
 runtime::Error Module::set_input(
     const std::string& method_name,
     const runtime::EValue& input_value,
     size_t input_index) {
+  const auto memory_use = use_memory();
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
   methods_.at(method_name).inputs.at(input_index) = input_value;
   return runtime::Error::Ok;
@@ -208,6 +731,7 @@ runtime::Error Module::set_input(
 runtime::Error Module::set_inputs(
     const std::string& method_name,
     const std::vector<runtime::EValue>& input_values) {
+  const auto memory_use = use_memory();
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
   auto& inputs = methods_.at(method_name).inputs;
   ET_CHECK_OR_RETURN_ERROR(
@@ -224,6 +748,7 @@ runtime::Error Module::set_output(
     const std::string& method_name,
     runtime::EValue output_value,
     size_t output_index) {
+  const auto memory_use = use_memory();
   ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
   auto& method = methods_.at(method_name).method;
   ET_CHECK_OR_RETURN_ERROR(
@@ -236,5 +761,174 @@ runtime::Error Module::set_output(
       output_tensor.mutable_data_ptr(), output_tensor.nbytes(), output_index);
 }
 
+runtime::Error Module::set_outputs(
+    const std::string& method_name,
+    const std::vector<runtime::EValue>& output_values) {
+  const auto memory_use = use_memory();
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method = methods_.at(method_name).method;
+  ET_CHECK_OR_RETURN_ERROR(
+      output_values.size() == method->outputs_size(),
+      InvalidArgument,
+      "output size: %zu does not match method output size: %zu",
+      output_values.size(),
+      method->outputs_size());
+  std::vector<runtime::Span<uint8_t>> buffers(output_values.size());
+  for (size_t i = 0; i < output_values.size(); ++i) {
+    if (output_values[i].isNone()) {
+      continue;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        output_values[i].isTensor(),
+        InvalidArgument,
+        "output %zu type: %zu is not tensor",
+        i,
+        (size_t)output_values[i].tag);
+    const auto& output_tensor = output_values[i].toTensor();
+    buffers[i] = runtime::Span<uint8_t>(
+        static_cast<uint8_t*>(output_tensor.mutable_data_ptr()),
+        output_tensor.nbytes());
+  }
+  return method->set_output_data_ptrs(
+      runtime::Span<const runtime::Span<uint8_t>>(
+          buffers.data(), buffers.size()));
+}
+
+runtime::Error Module::bind(
+    const std::string& method_name,
+    const std::vector<runtime::EValue>& input_values,
+    const std::vector<runtime::EValue>& output_values) {
+  const auto memory_use = use_memory();
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& holder = methods_.at(method_name);
+  auto& method = holder.method;
+  holder.bound = false;
+
+  ET_CHECK_OR_RETURN_ERROR(
+      output_values.size() == method->outputs_size(),
+      InvalidArgument,
+      "output size: %zu does not match method output size: %zu",
+      output_values.size(),
+      method->outputs_size());
+  // Validates the inputs, and checks their number.
+  ET_CHECK_OK_OR_RETURN_ERROR(method->set_inputs(
+      exec_aten::ArrayRef<runtime::EValue>(
+          input_values.data(), input_values.size())));
+
+  std::vector<size_t> tensor_inputs;
+  for (size_t i = 0; i < input_values.size(); ++i) {
+    if (input_values[i].isTensor()) {
+      tensor_inputs.push_back(i);
+    }
+  }
+
+  const auto method_meta = method->method_meta();
+  std::vector<bool> copied_outputs(output_values.size());
+  for (size_t i = 0; i < output_values.size(); ++i) {
+    const auto& output = method->get_output(i);
+    ET_CHECK_OR_RETURN_ERROR(
+        output_values[i].isTensor() && output.isTensor(),
+        InvalidArgument,
+        "output %zu is not a tensor",
+        i);
+    const auto& bound_tensor = output_values[i].toTensor();
+    const auto& output_tensor = output.toTensor();
+    ET_CHECK_OR_RETURN_ERROR(
+        bound_tensor.scalar_type() == output_tensor.scalar_type(),
+        InvalidArgument,
+        "output %zu scalar type: %d does not match method output: %d",
+        i,
+        static_cast<int>(bound_tensor.scalar_type()),
+        static_cast<int>(output_tensor.scalar_type()));
+    ET_CHECK_OR_RETURN_ERROR(
+        bound_tensor.nbytes() >= output_tensor.nbytes(),
+        InvalidArgument,
+        "output %zu size: %zu is smaller than method output size: %zu",
+        i,
+        bound_tensor.nbytes(),
+        output_tensor.nbytes());
+    const auto tensor_meta = method_meta.output_tensor_meta(i);
+    ET_CHECK_OK_OR_RETURN_ERROR(tensor_meta.error());
+    if (tensor_meta->is_memory_planned()) {
+      copied_outputs[i] = true;
+    } else {
+      ET_CHECK_OK_OR_RETURN_ERROR(method->set_output_data_ptr(
+          bound_tensor.mutable_data_ptr(), bound_tensor.nbytes(), i));
+    }
+  }
+
+  holder.bound_inputs = input_values;
+  holder.bound_outputs = output_values;
+  holder.bound_tensor_inputs = std::move(tensor_inputs);
+  holder.copied_outputs = std::move(copied_outputs);
+  holder.bound = true;
+  return runtime::Error::Ok;
+}
+
+runtime::Error Module::set_delegate_options(
+    const std::string& method_name,
+    const std::string& backend_id,
+    const std::vector<runtime::BackendOption>& options) {
+  const auto memory_use = use_memory();
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method = methods_.at(method_name).method;
+  return method->set_delegate_options(
+      backend_id.c_str(),
+      runtime::Span<const runtime::BackendOption>(
+          options.data(), options.size()));
+}
+
+runtime::Result<std::vector<runtime::BackendOption>>
+Module::get_delegate_options(
+    const std::string& method_name,
+    const std::string& backend_id,
+    const std::vector<const char*>& keys) {
+  const auto memory_use = use_memory();
+  ET_CHECK_OK_OR_RETURN_ERROR(load_method(method_name));
+  auto& method = methods_.at(method_name).method;
+  std::vector<runtime::BackendOption> options;
+  options.reserve(keys.size());
+  for (const char* key : keys) {
+    options.emplace_back(key);
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(method->get_delegate_options(
+      backend_id.c_str(),
+      runtime::Span<runtime::BackendOption>(options.data(), options.size())));
+  return options;
+}
+
+runtime::Error Module::execute_bound(const std::string& method_name) {
+  const auto memory_use = use_memory();
+  auto it = methods_.find(method_name);
+  ET_CHECK_OR_RETURN_ERROR(
+      it != methods_.end() && it->second.bound,
+      InvalidState,
+      "no values are bound to method %s",
+      method_name.c_str());
+  auto& holder = it->second;
+  auto& method = holder.method;
+  const auto scope = enter_execution_scope();
+
+  for (const auto input_index : holder.bound_tensor_inputs) {
+    ET_CHECK_OK_OR_RETURN_ERROR(
+        method->set_input(holder.bound_inputs[input_index], input_index));
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(method->execute());
+
+  for (size_t i = 0; i < holder.bound_outputs.size(); ++i) {
+    const auto& output_tensor = method->get_output(i).toTensor();
+    const auto& bound_tensor = holder.bound_outputs[i].toTensor();
+    if (bound_tensor.sizes() != output_tensor.sizes()) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          runtime::resize_tensor(bound_tensor, output_tensor.sizes()));
+    }
+    if (holder.copied_outputs[i]) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          runtime::internal::copy_tensor_data(bound_tensor, output_tensor));
+    }
+  }
+  return runtime::Error::Ok;
+}
+
 } // namespace extension
 } // namespace executorch
@@ -8,13 +8,19 @@
 
 #pragma once
 
+#include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#include <executorch/extension/memory_allocator/memory_governor.h>
+#include <executorch/extension/memory_allocator/page_memory.h>
 #include <executorch/runtime/executor/program.h>
+#include <executorch/runtime/kernel/kernel_cache.h>
 
 namespace executorch {
 namespace extension {
@@ -28,7 +34,8 @@ class Module {
    * Enum to define loading behavior.
    */
   enum class LoadMode {
-    /// Load the whole file as a buffer.
+    /// Load the whole file as a buffer, shared with the other Modules that
+    /// load the same file this way.
     File,
     /// Use mmap to load pages into memory.
     Mmap,
@@ -51,6 +58,25 @@ class Module {
       const LoadMode load_mode = LoadMode::MmapUseMlock,
       std::unique_ptr<runtime::EventTracer> event_tracer = nullptr);
 
+  /**
+   * Constructs an instance by loading a program from a file, and the tensors
+   * that it stores externally from a FlatTensor (.ptd) data file.
+   *
+   * The data file is loaded the same way as the program, so with one of the
+   * mmap modes the weights are shared read-only with every other program and
+   * process that maps the same file.
+   *
+   * @param[in] file_path The path to the ExecuTorch program file to load.
+   * @param[in] data_map_path The path to the FlatTensor data file to load.
+   * @param[in] load_mode The loading mode to use.
+   * @param[in] event_tracer A EventTracer used for tracking and logging events.
+   */
+  explicit Module(
+      const std::string& file_path,
+      const std::string& data_map_path,
+      const LoadMode load_mode = LoadMode::MmapUseMlock,
+      std::unique_ptr<runtime::EventTracer> event_tracer = nullptr);
+
   /**
    * Constructs an instance with the provided data loader and memory allocator.
    *
@@ -86,6 +112,7 @@ class Module {
   Module& operator=(const Module&) = delete;
   Module(Module&&) = delete;
   Module& operator=(Module&&) = delete;
+  ~Module();
 
   /**
    * Loads the program if needed.
@@ -159,13 +186,190 @@ class Module {
     return load_method("forward", event_tracer);
   }
 
+  /**
+   * EXPERIMENTAL: A function that load_async() calls on the background thread
+   * as each method finishes loading there, with the error of the load.
+   */
+  using LoadCallback = std::function<
+      void(const std::string& method_name, runtime::Error error)>;
+
+  /**
+   * EXPERIMENTAL: Loads the program if needed, then starts loading methods in
+   * the background and returns, so that the caller can use the first methods
+   * while the others still initialize their delegates.
+   *
+   * The methods start loading in the order given, so list them by priority.
+   * A call that needs one of them, like load_method() or execute(), waits
+   * only for that method, and loads it on the calling thread if it hasn't
+   * started loading yet. It also returns the error if the method failed to
+   * load in the background.
+   *
+   * Methods loaded in the background allocate from their own allocators
+   * rather than from the Module's, which aren't thread-safe, and don't log to
+   * the Module's event tracer. The Module's settings, like its page policy,
+   * must not change until they are loaded.
+   *
+   * @param[in] method_names The methods to load, by priority. Methods that are
+   * already loaded are skipped.
+   * @param[in] runner The runner to load the methods on concurrently, or
+   * nullptr to load them one by one. Runs on one threadpool are serialized,
+   * so use a ThreadPoolParallelRunner on a threadpool other than the one the
+   * methods execute on. Must outlive the load.
+   * @param[in] callback Called as each method loads in the background, or
+   * nullptr.
+   *
+   * @returns An Error to indicate whether the loading started.
+   * @retval Error::InvalidArgument A method is not in the program, or is
+   *     listed twice.
+   * @retval Error::InvalidState A method is already loading in the
+   *     background.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error load_async(
+      const std::vector<std::string>& method_names,
+      runtime::ParallelRunner* runner = nullptr,
+      LoadCallback callback = nullptr);
+
+  /**
+   * Sets how to place the pages of memory that the Module allocates from now
+   * on, e.g. to back it with huge pages or bind it to a NUMA node. Applies to
+   * the memory-planned buffers of methods loaded afterwards, and, if called
+   * before the program is loaded, to the segments mapped by the data loader
+   * for the `Mmap*` load modes.
+   *
+   * @param[in] page_policy The policy to use.
+   */
+  inline void set_page_policy(const PagePolicy& page_policy) {
+    page_policy_ = page_policy;
+  }
+
+  /**
+   * Speeds up Program::Verification::InternalConsistency for the program that
+   * the Module loads from now on by verifying its methods concurrently.
+   *
+   * @param[in] runner The runner to verify the methods on, e.g. a
+   * ThreadPoolParallelRunner, or nullptr to verify them one by one. Must
+   * outlive the load.
+   */
+  inline void set_verification_runner(runtime::ParallelRunner* runner) {
+    verification_runner_ = runner;
+  }
+
+  /**
+   * EXPERIMENTAL: Speeds up loading methods with many delegates by
+   * initializing the delegates of each method that loads from now on
+   * concurrently. See the `init_runner` of Program::load_method().
+   *
+   * @param[in] runner The runner to initialize the delegates on, e.g. a
+   * ThreadPoolParallelRunner, or nullptr to initialize them one by one. Must
+   * not be the runner of load_async(), and must outlive the loads.
+   */
+  inline void set_init_runner(runtime::ParallelRunner* runner) {
+    init_runner_ = runner;
+  }
+
+  /**
+   * Makes the Module skip Program::Verification::InternalConsistency for a
+   * program file that passed it before, in this or an earlier process, and
+   * that has not changed since. Only applies to Modules constructed from a
+   * file path.
+   *
+   * @param[in] cache_path The path of the file that records the verified
+   * program files; see FileVerificationCache. An empty path disables the
+   * cache.
+   */
+  void set_verification_cache_path(const std::string& cache_path);
+
+  /**
+   * A function that the Module calls on the calling thread before it loads or
+   * executes a method, and whose result it releases afterwards. Lets callers
+   * set up thread-local state for the duration, e.g. a ThreadPoolGuard from
+   * `threadpool::make_threadpool_scope()` to run the methods on a threadpool
+   * that is restricted to some cores.
+   */
+  using ExecutionScope = std::function<std::shared_ptr<void>()>;
+
+  /**
+   * Sets the scope that the Module enters around loading and executing
+   * methods. Methods that capture state at load time, like XNNPACK delegates
+   * capture their threadpool, keep the state they captured when loaded.
+   *
+   * @param[in] execution_scope The scope to enter, or nullptr for none.
+   */
+  inline void set_execution_scope(ExecutionScope execution_scope) {
+    execution_scope_ = std::move(execution_scope);
+  }
+
+  /**
+   * EXPERIMENTAL: Sets whether methods loaded from now on give their kernels
+   * a cache for data derived from constant tensors, like weights packed for
+   * the optimized linear and matmul kernels. Each method's cache lives as
+   * long as the method, and trades the memory of the derived copies for not
+   * deriving them on every execution.
+   *
+   * @param[in] enabled Whether to cache derived data.
+   */
+  inline void set_kernel_cache_enabled(bool enabled) {
+    kernel_cache_enabled_ = enabled;
+  }
+
+  /**
+   * EXPERIMENTAL: Accounts for the memory of the Module with a MemoryGovernor,
+   * e.g. MemoryGovernor::global(), so that the Modules of a process share one
+   * budget. The Module reserves its program data when it loads the program,
+   * and the memory-planned buffers and allocations of each method when it
+   * loads the method, and fails with Error::MemoryAllocationFailed if they
+   * don't fit. Methods loaded with a governor allocate from allocators of
+   * their own, so that unloading them frees their memory.
+   *
+   * If `evictable`, the governor may unload the methods of the Module to make
+   * room for other clients while no call to the Module is in progress, least
+   * recently used Modules first. They load again when next used, but without
+   * their memory-planned state, like KV caches, their inputs set with
+   * set_input(), or their values bound with bind(). Memory-planned buffers
+   * shared with share_planned_memory() stay allocated.
+   *
+   * @param[in] governor The governor to account with, which must outlive the
+   * Module, or nullptr for none.
+   * @param[in] evictable Whether the governor may unload the methods.
+   *
+   * @returns An Error to indicate success or failure.
+   * @retval Error::InvalidState The Module already loaded its program or a
+   *     method.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error set_memory_governor(
+      MemoryGovernor* governor,
+      bool evictable = true);
+
+  /**
+   * Declares that the given methods never run at the same time, so that they
+   * can share one set of memory-planned buffers instead of each allocating
+   * its own. Each shared buffer is as large as the largest buffer with the
+   * same memory id across the methods. Must be called before any of the
+   * methods is loaded.
+   *
+   * Executing one of the methods overwrites the planned memory of the others,
+   * so none of them may be executing, even asynchronously, while another one
+   * runs, and their inputs, outputs, and memory-planned state such as mutable
+   * buffers do not persist across executions of the other methods.
+   *
+   * @param[in] method_names The names of the methods to share memory between.
+   *
+   * @returns An Error to indicate success or failure.
+   * @retval Error::InvalidState One of the methods is already loaded or
+   *     already shares memory with another group of methods.
+   */
+  ET_NODISCARD
+  runtime::Error share_planned_memory(
+      const std::vector<std::string>& method_names);
+
   /**
    * Checks if a specific method is loaded.
    *
    * @param[in] method_name The name of the method to check.
    *
    * @returns true if the method specified by method_name is loaded, false
-   * otherwise.
+   * otherwise. Methods that load_async() loads count as loaded once a call has
+   * waited for them. Methods that a MemoryGovernor evicted are not loaded.
    */
   inline bool is_method_loaded(const std::string& method_name) const {
     return methods_.count(method_name);
@@ -183,6 +387,86 @@ class Module {
   runtime::Result<runtime::MethodMeta> method_meta(
       const std::string& method_name);
 
+  /**
+   * Get the memory-planned buffers of a method, one per memory id. They hold
+   * the method's mutable buffers, like KV caches, between executions, so
+   * copying them out and back in saves and restores the method's state.
+   * Loads the program and method if needed.
+   *
+   * @param[in] method_name The name of the method to get the buffers of.
+   *
+   * @returns The buffers, which stay valid as long as the method is loaded,
+   * or an error if the program or method failed to load.
+   */
+  runtime::Result<std::vector<runtime::Span<uint8_t>>> planned_buffers(
+      const std::string& method_name);
+
+  /**
+   * EXPERIMENTAL: How warmup() prepares a method.
+   */
+  struct WarmupOptions {
+    /// Whether to fault in the pages of the method's memory-planned buffers
+    /// before executing it, so that the first execution doesn't stall on
+    /// page faults. See populate_pages().
+    bool populate_planned_memory = true;
+    /// The sets of inputs to execute the method with, e.g. one per
+    /// representative shape of inputs with dynamic shapes, so that kernels
+    /// and delegates prepare for each. If empty, the method executes with the
+    /// inputs set before, e.g. with set_inputs().
+    std::vector<std::vector<runtime::EValue>> inputs;
+    /// How many times to execute the method with each set of inputs.
+    size_t num_executions = 1;
+    /// Whether to restore the memory-planned buffers afterwards, so that the
+    /// executions don't change the method's state, like KV caches. Costs a
+    /// copy of the buffers while warming up.
+    bool preserve_state = false;
+  };
+
+  /**
+   * EXPERIMENTAL: How long each phase of warmup() took.
+   */
+  struct WarmupStats {
+    /// Loading the program and method, if they weren't loaded yet.
+    std::chrono::nanoseconds load_time{0};
+    /// Faulting in the memory-planned buffers.
+    std::chrono::nanoseconds populate_time{0};
+    /// Each execution, in order. The first ones usually include one-time
+    /// work, like delegates preparing their graphs or kernels packing
+    /// weights.
+    std::vector<std::chrono::nanoseconds> execution_times;
+  };
+
+  /**
+   * EXPERIMENTAL: Prepares a method for serving, so that the first real
+   * execution runs as fast as later ones: loads the program and method if
+   * needed, faults in its memory-planned buffers, and executes it with
+   * representative inputs to prime its kernels and delegates.
+   *
+   * The inputs set before stay set, but the executions change the method's
+   * memory-planned state unless `preserve_state` is set.
+   *
+   * @param[in] method_name The name of the method to warm up.
+   * @param[in] options How to warm up the method.
+   *
+   * @returns How long each phase took, or the error of the first phase that
+   * failed.
+   */
+  ET_EXPERIMENTAL runtime::Result<WarmupStats> warmup(
+      const std::string& method_name,
+      const WarmupOptions& options);
+
+  /**
+   * EXPERIMENTAL: Warms up a method with the default WarmupOptions, which
+   * execute it once with the inputs set before.
+   *
+   * @param[in] method_name The name of the method to warm up.
+   *
+   * @returns How long each phase took, or the error of the first phase that
+   * failed.
+   */
+  ET_EXPERIMENTAL runtime::Result<WarmupStats> warmup(
+      const std::string& method_name);
+
   /**
    * Execute a specific method with the given input values and retrieve the
    * output values. Loads the program and method before executing if needed.
@@ -199,6 +483,31 @@ class Module {
       const std::string& method_name,
       const std::vector<runtime::EValue>& input_values);
 
+  /**
+   * EXPERIMENTAL: Start executing a specific method with the given input values
+   * and return a future for the output values. Loads the program and method
+   * before executing if needed.
+   *
+   * The call returns once the method is waiting on a delegate that executes
+   * asynchronously (see `runtime::Method::execute_async()`), so the caller can
+   * do other work while an accelerator runs. If no delegate of the method
+   * supports asynchronous execution, the returned future is already ready.
+   *
+   * The method must not be executed again, and the Module must not be
+   * destroyed, until the future is ready.
+   *
+   * @param[in] method_name The name of the method to execute.
+   * @param[in] input_values A vector of input values to be passed to the
+   * method.
+   *
+   * @returns A future for a Result object containing either a vector of output
+   *          values from the method or an error to indicate failure.
+   */
+  ET_EXPERIMENTAL std::future<runtime::Result<std::vector<runtime::EValue>>>
+  execute_async(
+      const std::string& method_name,
+      const std::vector<runtime::EValue>& input_values);
+
   /**
    * Execute a specific method with a single input value.
    * Loads the program and method before executing if needed.
@@ -411,6 +720,143 @@ class Module {
     return set_output("forward", std::move(output_value), output_index);
   }
 
+  /**
+   * Sets the output tensors for all outputs of a specific method at once.
+   * Either all of them are set, or, on failure, none of them.
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] output_values One EValue per method output, containing the
+   * Tensor to set as that output, or None to leave it unchanged, e.g. if it is
+   * memory-planned.
+   *
+   * @returns An Error to indicate success or failure.
+   *
+   * @note Only Tensor outputs are currently supported for setting.
+   */
+  ET_NODISCARD
+  runtime::Error set_outputs(
+      const std::string& method_name,
+      const std::vector<runtime::EValue>& output_values);
+
+  /**
+   * Sets the output tensors for all outputs of the "forward" method at once.
+   *
+   * @param[in] output_values One EValue per method output, containing the
+   * Tensor to set as that output, or None to leave it unchanged.
+   *
+   * @returns An Error to indicate success or failure.
+   *
+   * @note Only Tensor outputs are currently supported for setting.
+   */
+  ET_NODISCARD
+  inline runtime::Error set_outputs(
+      const std::vector<runtime::EValue>& output_values) {
+    return set_outputs("forward", output_values);
+  }
+
+  /**
+   * Binds caller-owned values to all inputs and outputs of a specific method,
+   * so that it can be executed repeatedly with execute_bound() without
+   * allocating or copying vectors of EValues. The values are validated once,
+   * here, and scalar inputs are not checked again.
+   *
+   * Tensor inputs and outputs that are not memory-planned share the caller's
+   * data. Memory-planned inputs are copied in before each execution, and
+   * memory-planned outputs are copied out after it, since their storage
+   * belongs to the plan.
+   *
+   * The caller may update the data of the bound tensors, and the shapes of
+   * tensor inputs with dynamic shapes, between executions. The bound outputs
+   * are resized to match the method's outputs after each execution. All bound
+   * tensors must stay valid while the method may be executed with
+   * execute_bound().
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] input_values The values to bind to the method inputs.
+   * @param[in] output_values The Tensors to bind to the method outputs, whose
+   * data must be large enough for the largest outputs of the method.
+   *
+   * @returns An Error to indicate success or failure.
+   *
+   * @note Only Tensor outputs are currently supported for binding.
+   */
+  ET_NODISCARD
+  runtime::Error bind(
+      const std::string& method_name,
+      const std::vector<runtime::EValue>& input_values,
+      const std::vector<runtime::EValue>& output_values);
+
+  /**
+   * Binds caller-owned values to all inputs and outputs of the "forward"
+   * method. See bind() above.
+   *
+   * @param[in] input_values The values to bind to the method inputs.
+   * @param[in] output_values The Tensors to bind to the method outputs.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  inline runtime::Error bind(
+      const std::vector<runtime::EValue>& input_values,
+      const std::vector<runtime::EValue>& output_values) {
+    return bind("forward", input_values, output_values);
+  }
+
+  /**
+   * Executes a specific method with the values bound by bind(), writing its
+   * results to the bound outputs. Does not allocate memory.
+   *
+   * @param[in] method_name The name of the method to execute.
+   *
+   * @returns An Error to indicate success or failure.
+   * @retval Error::InvalidState No values are bound to the method.
+   */
+  ET_NODISCARD
+  runtime::Error execute_bound(const std::string& method_name);
+
+  /**
+   * Executes the "forward" method with the values bound by bind().
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD
+  inline runtime::Error execute_bound() {
+    return execute_bound("forward");
+  }
+
+  /**
+   * EXPERIMENTAL: Changes runtime options, such as the number of threads, of
+   * the delegates of a specific method that run on a backend. Loads the method
+   * if it isn't loaded yet. See Method::set_delegate_options().
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] backend_id The id of the backend, as in the program.
+   * @param[in] options The options to set.
+   *
+   * @returns An Error to indicate success or failure.
+   * @retval Error::NotFound No delegate of the method runs on the backend.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD runtime::Error set_delegate_options(
+      const std::string& method_name,
+      const std::string& backend_id,
+      const std::vector<runtime::BackendOption>& options);
+
+  /**
+   * EXPERIMENTAL: Reads runtime options of the delegates of a specific method
+   * that run on a backend. See Method::get_delegate_options().
+   *
+   * @param[in] method_name The name of the method.
+   * @param[in] backend_id The id of the backend, as in the program.
+   * @param[in] keys The keys of the options to get.
+   *
+   * @returns The options, in the order of `keys`, or an error.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD
+  runtime::Result<std::vector<runtime::BackendOption>> get_delegate_options(
+      const std::string& method_name,
+      const std::string& backend_id,
+      const std::vector<const char*>& keys);
+
   /**
    * Retrieves the EventTracer instance being used by the Module.
    * EventTracer is used for tracking and logging events during the execution
@@ -424,23 +870,126 @@ class Module {
   }
 
  private:
+  // Owns the memory-planned buffers of one method, or of a group of methods
+  // that share planned memory.
+  struct PlannedBuffers {
+    ~PlannedBuffers() {
+      if (governor != nullptr) {
+        governor->release(
+            client, MemoryGovernor::Category::PlannedMemory, nbytes);
+      }
+    }
+
+    std::vector<std::vector<uint8_t>> buffers;
+    // Used instead of buffers if the Module has a non-default page policy.
+    std::vector<PageBuffer> page_buffers;
+    // The start of the buffer for each memory id.
+    std::vector<uint8_t*> data;
+    // The governor that the buffers are reserved with, if any.
+    MemoryGovernor* governor = nullptr;
+    MemoryGovernor::ClientId client = 0;
+    size_t nbytes = 0;
+  };
+
   struct MethodHolder {
-    std::vector<std::vector<uint8_t>> planned_buffers;
+    // Used instead of the Module's allocators by methods loaded in the
+    // background.
+    std::unique_ptr<runtime::MemoryAllocator> method_allocator;
+    std::unique_ptr<runtime::MemoryAllocator> temp_allocator;
+    std::shared_ptr<PlannedBuffers> planned_buffers;
     std::vector<runtime::Span<uint8_t>> planned_spans;
     std::unique_ptr<runtime::HierarchicalAllocator> planned_memory;
     std::unique_ptr<runtime::MemoryManager> memory_manager;
+    // Declared before method, which refers to it until it is destroyed.
+    std::unique_ptr<runtime::KernelCache> kernel_cache;
     std::unique_ptr<runtime::Method> method;
     std::vector<runtime::EValue> inputs;
+    // Caller-owned values bound by bind().
+    bool bound = false;
+    std::vector<runtime::EValue> bound_inputs;
+    std::vector<runtime::EValue> bound_outputs;
+    // The indices of the bound inputs that are tensors, which have to be set
+    // again before each execution in case the caller changed their shapes.
+    std::vector<size_t> bound_tensor_inputs;
+    // Whether each bound output is memory-planned, so its data has to be
+    // copied out after each execution.
+    std::vector<bool> copied_outputs;
   };
 
+  // The methods of a load_async() call, shared with its background thread.
+  struct AsyncLoad;
+
+  runtime::Result<std::shared_ptr<PlannedBuffers>> allocate_planned_buffers(
+      const std::vector<size_t>& buffer_sizes);
+
+  // Loads a method. With own_allocators, or a memory governor, allocates from
+  // allocators of its own instead of the Module's, so that it can load on
+  // another thread, or be unloaded to free its memory.
+  runtime::Result<MethodHolder> make_method_holder(
+      const std::string& method_name,
+      runtime::EventTracer* event_tracer,
+      bool own_allocators);
+
+  // Loads the methods of an async load that are still pending, one per call.
+  void run_async_load(AsyncLoad& async_load);
+
+  // Whether the method is part of an async load and not yet taken from it.
+  bool is_async_loading(const std::string& method_name);
+
+  // Waits for the method if it loads in the background, and moves it into
+  // methods_. Returns false if the method doesn't load in the background, or
+  // hasn't started yet and is now left to the caller.
+  runtime::Result<bool> take_async_loaded_method(
+      const std::string& method_name);
+
+  // Marks the Module as in use, so that the memory governor doesn't unload
+  // its methods, until the result is destroyed.
+  MemoryGovernor::ScopedUse use_memory() {
+    return MemoryGovernor::ScopedUse(memory_governor_, memory_client_);
+  }
+
+  // Unloads the methods, for the memory governor to free their memory.
+  void evict_methods();
+
+  // Enters the execution scope, if any, until the result is released.
+  std::shared_ptr<void> enter_execution_scope() const {
+    return execution_scope_ ? execution_scope_() : nullptr;
+  }
+
+  // Creates a data loader for the file at `path` according to load_mode_.
+  runtime::Result<std::unique_ptr<runtime::DataLoader>> make_data_loader(
+      const std::string& path) const;
+
+  // Loads the method if needed and sets its inputs for an execution.
+  runtime::Error prepare_execution(
+      const std::string& method_name,
+      const std::vector<runtime::EValue>& input_values);
+
  private:
   std::string file_path_;
+  std::string data_map_path_;
   LoadMode load_mode_{LoadMode::MmapUseMlock};
   std::shared_ptr<runtime::Program> program_;
   std::unique_ptr<runtime::DataLoader> data_loader_;
+  // Declared before data_map_, which reads through it until it is destroyed.
+  std::unique_ptr<runtime::DataLoader> data_map_loader_;
+  std::unique_ptr<runtime::NamedDataMap> data_map_;
   std::unique_ptr<runtime::MemoryAllocator> memory_allocator_;
   std::unique_ptr<runtime::MemoryAllocator> temp_allocator_;
   std::unique_ptr<runtime::EventTracer> event_tracer_;
+  PagePolicy page_policy_;
+  ExecutionScope execution_scope_;
+  bool kernel_cache_enabled_ = false;
+  runtime::ParallelRunner* verification_runner_ = nullptr;
+  runtime::ParallelRunner* init_runner_ = nullptr;
+  std::unique_ptr<runtime::VerificationCache> verification_cache_;
+  MemoryGovernor* memory_governor_ = nullptr;
+  MemoryGovernor::ClientId memory_client_ = 0;
+  std::unordered_map<std::string, std::shared_ptr<PlannedBuffers>>
+      shared_planned_buffers_;
+  // Declared after the program, which the methods it holds use until they
+  // are destroyed.
+  std::vector<std::unique_ptr<AsyncLoad>> async_loads_;
 
  protected:
   std::unordered_map<std::string, MethodHolder> methods_;
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/reloadable_module.h>
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+// Warms up the method with zeroed inputs, if all of them are tensors, and
+// otherwise only faults in its planned memory.
+runtime::Error warm_up_with_zeros(
+    Module& module,
+    const std::string& method_name) {
+  const auto method_meta = ET_UNWRAP(module.method_meta(method_name));
+  std::vector<TensorPtr> tensors;
+  std::vector<runtime::EValue> inputs;
+  tensors.reserve(method_meta.num_inputs());
+  Module::WarmupOptions options;
+  for (size_t i = 0; i < method_meta.num_inputs(); ++i) {
+    if (ET_UNWRAP(method_meta.input_tag(i)) != runtime::Tag::Tensor) {
+      options.num_executions = 0;
+      break;
+    }
+    const auto info = ET_UNWRAP(method_meta.input_tensor_meta(i));
+    tensors.push_back(make_tensor_ptr(
+        std::vector<executorch::aten::SizesType>(
+            info.sizes().begin(), info.sizes().end()),
+        std::vector<uint8_t>(info.nbytes()),
+        info.scalar_type()));
+    inputs.emplace_back(*tensors.back());
+  }
+  options.inputs.push_back(std::move(inputs));
+  return module.warmup(method_name, options).error();
+}
+
+} // namespace
+
+runtime::Result<std::unique_ptr<ReloadableModule>> ReloadableModule::create(
+    std::unique_ptr<Module> module,
+    Options options) {
+  ET_CHECK_OR_RETURN_ERROR(
+      module != nullptr, InvalidArgument, "module is null");
+  std::unique_ptr<ReloadableModule> reloadable(
+      new ReloadableModule(std::move(options)));
+  ET_CHECK_OK_OR_RETURN_ERROR(reloadable->prepare(*module));
+  reloadable->active_ = std::make_shared<Version>();
+  reloadable->active_->module = std::move(module);
+  reloadable->active_->number = 0;
+  return reloadable;
+}
+
+runtime::Error ReloadableModule::reload(std::unique_ptr<Module> module) {
+  ET_CHECK_OR_RETURN_ERROR(
+      module != nullptr, InvalidArgument, "module is null");
+  std::lock_guard<std::mutex> reload_lock(reload_mutex_);
+  ET_CHECK_OK_OR_RETURN_ERROR(prepare(*module));
+
+  auto version = std::make_shared<Version>();
+  version->module = std::move(module);
+  version->number = active_version()->number + 1;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_.swap(version);
+  }
+  // `version` now holds the old version, which is destroyed here unless
+  // requests still execute on it, in which case the last of them destroys it.
+  return runtime::Error::Ok;
+}
+
+runtime::Result<std::vector<TensorPtr>> ReloadableModule::execute(
+    const std::string& method_name,
+    const std::vector<runtime::EValue>& input_values) {
+  const auto version = active_version();
+  std::lock_guard<std::mutex> lock(version->mutex);
+  const auto outputs =
+      ET_UNWRAP(version->module->execute(method_name, input_values));
+  std::vector<TensorPtr> result;
+  result.reserve(outputs.size());
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        outputs[i].isTensor(),
+        NotSupported,
+        "output %zu of method %s is not a tensor",
+        i,
+        method_name.c_str());
+    result.push_back(clone_tensor_ptr(outputs[i].toTensor()));
+  }
+  return result;
+}
+
+uint64_t ReloadableModule::version() const {
+  return active_version()->number;
+}
+
+runtime::Error ReloadableModule::prepare(Module& module) const {
+  ET_CHECK_OK_OR_RETURN_ERROR(module.load());
+  for (const auto& method_name : options_.method_names) {
+    ET_CHECK_OK_OR_RETURN_ERROR(module.load_method(method_name));
+  }
+  if (options_.warmup) {
+    return options_.warmup(module);
+  }
+  for (const auto& method_name : options_.method_names) {
+    ET_CHECK_OK_OR_RETURN_ERROR(warm_up_with_zeros(module, method_name));
+  }
+  return runtime::Error::Ok;
+}
+
+std::shared_ptr<ReloadableModule::Version> ReloadableModule::active_version()
+    const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return active_;
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor_ptr.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: Serves requests from the active version of a model, which
+ * can be replaced by a new version without pausing the requests, e.g. to
+ * roll out an updated .pte file.
+ *
+ * reload() loads the program and methods of the new version and warms them
+ * up while requests keep executing on the active version, and only then
+ * makes the new version active. Requests that started on the old version
+ * finish on it, and its memory is released as soon as the last of them
+ * returns. If the new version fails to load or warm up, the active version
+ * stays.
+ *
+ * A Module executes one method at a time, so the requests to one version are
+ * serialized, while a request to the new version doesn't wait for requests
+ * to the old one.
+ */
+class ReloadableModule final {
+ public:
+  /**
+   * A function that prepares a new version before it becomes active, e.g. by
+   * executing its methods with representative inputs so that delegates and
+   * caches are ready for the first request.
+   */
+  using Warmup = std::function<runtime::Error(Module& module)>;
+
+  struct Options {
+    /// The methods to load before a version becomes active.
+    std::vector<std::string> method_names = {"forward"};
+    /// Called once the methods are loaded, or nullptr to warm up each of the
+    /// methods with Module::warmup(), executing it once with zeroed inputs
+    /// if all of its inputs are tensors.
+    Warmup warmup;
+  };
+
+  /**
+   * Loads and warms up the first version.
+   *
+   * @param[in] module The first version.
+   * @param[in] options How to prepare each version.
+   *
+   * @returns A new ReloadableModule, or the error of loading or warming up
+   * the first version.
+   */
+  static runtime::Result<std::unique_ptr<ReloadableModule>> create(
+      std::unique_ptr<Module> module,
+      Options options);
+
+  ReloadableModule(const ReloadableModule&) = delete;
+  ReloadableModule& operator=(const ReloadableModule&) = delete;
+  ReloadableModule(ReloadableModule&&) = delete;
+  ReloadableModule& operator=(ReloadableModule&&) = delete;
+
+  /**
+   * Loads and warms up a new version, then makes it active. Returns once the
+   * new version is active, so call it from a background thread; requests
+   * keep executing on the active version in the meantime. Reloads are
+   * serialized.
+   *
+   * @param[in] module The new version.
+   *
+   * @returns An Error to indicate success or failure. On failure, the active
+   * version stays.
+   */
+  runtime::Error reload(std::unique_ptr<Module> module);
+
+  /**
+   * Executes a method of the active version.
+   *
+   * @param[in] method_name The name of the method to execute.
+   * @param[in] input_values The inputs of the method.
+   *
+   * @returns Copies of the outputs, which all have to be tensors, since the
+   * memory of the method may be overwritten by the next request, or freed
+   * once a new version is active.
+   */
+  runtime::Result<std::vector<TensorPtr>> execute(
+      const std::string& method_name,
+      const std::vector<runtime::EValue>& input_values = {});
+
+  /**
+   * The number of the active version, which starts at 0 for the version
+   * passed to create() and counts up with each successful reload().
+   */
+  uint64_t version() const;
+
+ private:
+  struct Version {
+    std::unique_ptr<Module> module;
+    uint64_t number;
+    // Serializes the executions of the module.
+    std::mutex mutex;
+  };
+
+  explicit ReloadableModule(Options options) : options_(std::move(options)) {}
+
+  // Loads the methods of the module and warms them up.
+  runtime::Error prepare(Module& module) const;
+
+  std::shared_ptr<Version> active_version() const;
+
+  const Options options_;
+  // Serializes reloads.
+  std::mutex reload_mutex_;
+  // Guards active_, and is only held to swap or copy it.
+  mutable std::mutex mutex_;
+  std::shared_ptr<Version> active_;
+};
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/streaming_session.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace executorch {
+namespace extension {
+
+namespace {
+
+// Allocates a zeroed tensor as large as the largest tensor described by
+// `info`.
+TensorPtr make_buffer(const runtime::TensorInfo& info) {
+  return make_tensor_ptr(
+      std::vector<executorch::aten::SizesType>(
+          info.sizes().begin(), info.sizes().end()),
+      std::vector<uint8_t>(info.nbytes()),
+      info.scalar_type());
+}
+
+} // namespace
+
+runtime::Result<std::unique_ptr<StreamingSession>> StreamingSession::create(
+    Module& module,
+    Options options) {
+  const auto method_meta = ET_UNWRAP(module.method_meta(options.method_name));
+  std::unique_ptr<StreamingSession> session(
+      new StreamingSession(module, std::move(options)));
+  const auto& opts = session->options_;
+  const size_t num_inputs = method_meta.num_inputs();
+  const size_t num_outputs = method_meta.num_outputs();
+  ET_CHECK_OR_RETURN_ERROR(
+      opts.chunk_input < num_inputs,
+      InvalidArgument,
+      "chunk input %zu is out of range, the method has %zu inputs",
+      opts.chunk_input,
+      num_inputs);
+
+  // The state that uses each input and output, or -1.
+  std::vector<int> input_states(num_inputs, -1);
+  std::vector<int> output_states(num_outputs, -1);
+  for (size_t s = 0; s < opts.states.size(); ++s) {
+    const auto& state = opts.states[s];
+    ET_CHECK_OR_RETURN_ERROR(
+        state.input_index < num_inputs && state.output_index < num_outputs,
+        InvalidArgument,
+        "state %zu refers to input %zu or output %zu, out of %zu and %zu",
+        s,
+        state.input_index,
+        state.output_index,
+        num_inputs,
+        num_outputs);
+    ET_CHECK_OR_RETURN_ERROR(
+        state.input_index != opts.chunk_input &&
+            input_states[state.input_index] < 0 &&
+            output_states[state.output_index] < 0,
+        InvalidArgument,
+        "state %zu shares input %zu or output %zu",
+        s,
+        state.input_index,
+        state.output_index);
+    input_states[state.input_index] = s;
+    output_states[state.output_index] = s;
+  }
+  std::vector<TensorPtr> constants(num_inputs);
+  for (const auto& constant : opts.constant_inputs) {
+    ET_CHECK_OR_RETURN_ERROR(
+        constant.first < num_inputs && constant.first != opts.chunk_input &&
+            input_states[constant.first] < 0 && !constants[constant.first],
+        InvalidArgument,
+        "constant input %zu is out of range, or not the only value of the "
+        "input",
+        constant.first);
+    ET_CHECK_OR_RETURN_ERROR(
+        constant.second != nullptr,
+        InvalidArgument,
+        "constant input %zu is null",
+        constant.first);
+    constants[constant.first] = constant.second;
+  }
+
+  for (size_t i = 0; i < num_inputs; ++i) {
+    auto tag = ET_UNWRAP(method_meta.input_tag(i));
+    ET_CHECK_OR_RETURN_ERROR(
+        tag == runtime::Tag::Tensor,
+        NotSupported,
+        "input %zu is not a tensor",
+        i);
+    ET_CHECK_OR_RETURN_ERROR(
+        i == opts.chunk_input || input_states[i] >= 0 || constants[i],
+        InvalidArgument,
+        "input %zu is neither the chunk, a state nor a constant",
+        i);
+  }
+  for (size_t i = 0; i < num_outputs; ++i) {
+    auto tag = ET_UNWRAP(method_meta.output_tag(i));
+    ET_CHECK_OR_RETURN_ERROR(
+        tag == runtime::Tag::Tensor,
+        NotSupported,
+        "output %zu is not a tensor",
+        i);
+    if (output_states[i] < 0) {
+      session->outputs_.push_back(
+          make_buffer(ET_UNWRAP(method_meta.output_tensor_meta(i))));
+    } else {
+      session->outputs_.push_back(nullptr);
+    }
+  }
+
+  // The frames of the window have to be contiguous for chunks to be copied
+  // into it frame by frame.
+  const auto chunk_info =
+      ET_UNWRAP(method_meta.input_tensor_meta(opts.chunk_input));
+  const auto chunk_sizes = chunk_info.sizes();
+  ET_CHECK_OR_RETURN_ERROR(
+      opts.time_dim < chunk_sizes.size(),
+      InvalidArgument,
+      "time dimension %zu is out of range, the chunk input has %zu",
+      opts.time_dim,
+      chunk_sizes.size());
+  for (size_t d = 0; d < opts.time_dim; ++d) {
+    ET_CHECK_OR_RETURN_ERROR(
+        chunk_sizes[d] == 1,
+        NotSupported,
+        "chunk input has size %zd in dimension %zu, before the time dimension",
+        ssize_t(chunk_sizes[d]),
+        d);
+  }
+  session->window_frames_ = chunk_sizes[opts.time_dim];
+  ET_CHECK_OR_RETURN_ERROR(
+      opts.lookahead_frames < session->window_frames_,
+      InvalidArgument,
+      "lookahead of %zu frames leaves no frames of the %zu in the window",
+      opts.lookahead_frames,
+      session->window_frames_);
+  session->chunk_frames_ = session->window_frames_ - opts.lookahead_frames;
+  session->frame_nbytes_ = chunk_info.nbytes() / session->window_frames_;
+  session->window_ = make_buffer(chunk_info);
+  session->chunk_sizes_.assign(chunk_sizes.begin(), chunk_sizes.end());
+  session->chunk_sizes_[opts.time_dim] = session->chunk_frames_;
+  // A step() queues at most a chunk while less than a window is queued.
+  session->pending_.resize(
+      (session->window_frames_ + session->chunk_frames_ - 1) *
+      session->frame_nbytes_);
+
+  for (size_t s = 0; s < opts.states.size(); ++s) {
+    const auto& state = opts.states[s];
+    const auto input_info =
+        ET_UNWRAP(method_meta.input_tensor_meta(state.input_index));
+    const auto output_info =
+        ET_UNWRAP(method_meta.output_tensor_meta(state.output_index));
+    ET_CHECK_OR_RETURN_ERROR(
+        input_info.scalar_type() == output_info.scalar_type() &&
+            input_info.nbytes() == output_info.nbytes(),
+        InvalidArgument,
+        "state %zu: input %zu and output %zu differ in scalar type or size",
+        s,
+        state.input_index,
+        state.output_index);
+    for (auto& buffers : session->states_) {
+      buffers.push_back(make_buffer(input_info));
+    }
+    session->state_sizes_.emplace_back(
+        input_info.sizes().begin(), input_info.sizes().end());
+  }
+
+  // Binding b reads the states from states_[b] and writes them to the other
+  // buffers, which the next execution reads with the other binding.
+  for (size_t b = 0; b < session->bindings_.size(); ++b) {
+    auto& binding = session->bindings_[b];
+    for (size_t i = 0; i < num_inputs; ++i) {
+      if (i == opts.chunk_input) {
+        binding.inputs.emplace_back(*session->window_);
+      } else if (input_states[i] >= 0) {
+        binding.inputs.emplace_back(*session->states_[b][input_states[i]]);
+      } else {
+        binding.inputs.emplace_back(*constants[i]);
+      }
+    }
+    for (size_t i = 0; i < num_outputs; ++i) {
+      const auto& output = output_states[i] >= 0
+          ? session->states_[1 - b][output_states[i]]
+          : session->outputs_[i];
+      binding.outputs.emplace_back(*output);
+      binding.output_tensors.push_back(output);
+    }
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(module.bind(
+      opts.method_name,
+      session->bindings_[0].inputs,
+      session->bindings_[0].outputs));
+  session->bound_ = 0;
+  return session;
+}
+
+runtime::Result<std::vector<TensorPtr>> StreamingSession::step(
+    const TensorPtr& chunk) {
+  ET_CHECK_OR_RETURN_ERROR(
+      chunk != nullptr, InvalidArgument, "chunk is null");
+  ET_CHECK_OR_RETURN_ERROR(
+      chunk->scalar_type() == window_->scalar_type(),
+      InvalidArgument,
+      "chunk scalar type: %d does not match method input: %d",
+      static_cast<int>(chunk->scalar_type()),
+      static_cast<int>(window_->scalar_type()));
+  ET_CHECK_OR_RETURN_ERROR(
+      size_t(chunk->dim()) == chunk_sizes_.size(),
+      InvalidArgument,
+      "chunk has %zu dimensions, expected %zu",
+      size_t(chunk->dim()),
+      chunk_sizes_.size());
+  for (size_t d = 0; d < chunk_sizes_.size(); ++d) {
+    ET_CHECK_OR_RETURN_ERROR(
+        chunk->size(d) == chunk_sizes_[d],
+        InvalidArgument,
+        "chunk has size %zd in dimension %zu, expected %zd",
+        ssize_t(chunk->size(d)),
+        d,
+        ssize_t(chunk_sizes_[d]));
+  }
+
+  std::memcpy(
+      pending_.data() + pending_frames_ * frame_nbytes_,
+      chunk->const_data_ptr(),
+      chunk->nbytes());
+  pending_frames_ += chunk_frames_;
+  if (pending_frames_ < window_frames_) {
+    return std::vector<TensorPtr>();
+  }
+  return execute(window_frames_);
+}
+
+runtime::Result<std::vector<TensorPtr>> StreamingSession::flush() {
+  if (pending_frames_ == 0) {
+    return std::vector<TensorPtr>();
+  }
+  return execute(pending_frames_);
+}
+
+runtime::Error StreamingSession::reset() {
+  pending_frames_ = 0;
+  current_ = 0;
+  for (auto& buffers : states_) {
+    for (size_t s = 0; s < buffers.size(); ++s) {
+      ET_CHECK_OK_OR_RETURN_ERROR(
+          resize_tensor_ptr(buffers[s], state_sizes_[s]));
+      std::memset(buffers[s]->mutable_data_ptr(), 0, buffers[s]->nbytes());
+    }
+  }
+  return runtime::Error::Ok;
+}
+
+runtime::Result<std::vector<TensorPtr>> StreamingSession::execute(
+    size_t frames) {
+  auto* window = static_cast<uint8_t*>(window_->mutable_data_ptr());
+  std::memcpy(window, pending_.data(), frames * frame_nbytes_);
+  std::memset(
+      window + frames * frame_nbytes_,
+      0,
+      (window_frames_ - frames) * frame_nbytes_);
+
+  // Binding the other buffers only sets pointers, it doesn't copy data.
+  if (bound_ != static_cast<int>(current_)) {
+    const auto& binding = bindings_[current_];
+    ET_CHECK_OK_OR_RETURN_ERROR(module_.bind(
+        options_.method_name, binding.inputs, binding.outputs));
+    bound_ = current_;
+  }
+  ET_CHECK_OK_OR_RETURN_ERROR(module_.execute_bound(options_.method_name));
+  auto outputs = bindings_[current_].output_tensors;
+  if (!options_.states.empty()) {
+    current_ = 1 - current_;
+  }
+
+  // Keep the lookahead, which is the start of the next window.
+  const size_t consumed = std::min(chunk_frames_, pending_frames_);
+  pending_frames_ -= consumed;
+  std::memmove(
+      pending_.data(),
+      pending_.data() + consumed * frame_nbytes_,
+      pending_frames_ * frame_nbytes_);
+  return outputs;
+}
+
+} // namespace extension
+} // namespace executorch
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor_ptr.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * EXPERIMENTAL: Runs a method over a stream of fixed-size chunks, e.g. of
+ * audio frames, carrying the method's state from one execution to the next,
+ * like the transcriber of a streaming Emformer RNN-T.
+ *
+ * The method takes a window of frames along `time_dim` of its chunk input:
+ * the frames of the current chunk followed by `lookahead_frames` frames of
+ * the next one, which it may look at but doesn't consume. The session
+ * queues the chunks passed to step() and executes the method as soon as a
+ * whole window is available, so every step() does work proportional to one
+ * chunk, and the first output is delayed by the lookahead only.
+ *
+ * Each state is a pair of a method input and a method output, where the
+ * output of one execution becomes the input of the next. The session keeps
+ * two buffers per state and alternates which one the method reads and which
+ * one it writes, so the state stays in the session's memory instead of
+ * being shuttled through the caller. All buffers are bound to the method
+ * with Module::bind(), so a method exported without memory-planned inputs
+ * and outputs reads and writes them in place, without any copies.
+ *
+ * The Module must not execute the method otherwise while a session is in
+ * use, and must outlive the session.
+ */
+class StreamingSession final {
+ public:
+  /// A method input that receives the method output of the previous
+  /// execution.
+  struct State {
+    size_t input_index;
+    size_t output_index;
+  };
+
+  struct Options {
+    /// The name of the method to execute.
+    std::string method_name = "forward";
+    /// The index of the input that takes the window of frames.
+    size_t chunk_input = 0;
+    /// The dimension of the chunk input along which frames are ordered. The
+    /// dimensions before it must have size 1.
+    size_t time_dim = 1;
+    /// The number of frames at the end of the window that belong to the next
+    /// chunk. The chunk size is the window size minus the lookahead.
+    size_t lookahead_frames = 0;
+    /// The states carried between executions. They start as zeros.
+    std::vector<State> states;
+    /// The values of the remaining inputs, by index, which stay the same for
+    /// every execution, e.g. the length of the window.
+    std::vector<std::pair<size_t, TensorPtr>> constant_inputs;
+  };
+
+  /**
+   * Loads the method if needed, allocates the window and the state buffers,
+   * and binds them to the method.
+   *
+   * @param[in] module The Module to execute the method of.
+   * @param[in] options How to feed the method.
+   *
+   * @returns A new session, or an error if the method can't be streamed.
+   * @retval Error::NotSupported An input or output of the method is not a
+   *     tensor, or the frames of the chunk input are not contiguous.
+   * @retval Error::InvalidArgument The options don't match the method, e.g.
+   *     the lookahead leaves no frames for the chunk, an input is not the
+   *     chunk, a state or a constant, or the input and output of a state
+   *     differ in type or size.
+   */
+  ET_NODISCARD static runtime::Result<std::unique_ptr<StreamingSession>>
+  create(Module& module, Options options);
+
+  StreamingSession(const StreamingSession&) = delete;
+  StreamingSession& operator=(const StreamingSession&) = delete;
+  StreamingSession(StreamingSession&&) = delete;
+  StreamingSession& operator=(StreamingSession&&) = delete;
+
+  /**
+   * Queues a chunk, and executes the method if a whole window is queued.
+   *
+   * @param[in] chunk chunk_frames() frames, with the scalar type of the
+   * chunk input and its sizes in every other dimension.
+   *
+   * @returns The outputs of the method, or no outputs while the lookahead of
+   * the first chunk is still missing. The outputs are overwritten by the
+   * next execution, so they have to be copied to be kept.
+   */
+  runtime::Result<std::vector<TensorPtr>> step(const TensorPtr& chunk);
+
+  /**
+   * Executes the method on the queued frames that haven't been consumed
+   * yet, padding the window with zeros, e.g. at the end of the stream.
+   * Consumes at most one chunk, so has to be called until pending_frames()
+   * is zero to drain the queue.
+   *
+   * @returns The outputs of the method, or no outputs if no frames are
+   * queued.
+   */
+  runtime::Result<std::vector<TensorPtr>> flush();
+
+  /**
+   * Drops the queued frames and sets the states back to zeros, to start a
+   * new stream.
+   *
+   * @returns An Error to indicate success or failure.
+   */
+  ET_NODISCARD runtime::Error reset();
+
+  /// The number of frames that step() takes.
+  size_t chunk_frames() const {
+    return chunk_frames_;
+  }
+
+  /// The number of queued frames that haven't been consumed yet.
+  size_t pending_frames() const {
+    return pending_frames_;
+  }
+
+ private:
+  // The values bound to the method while one of the two buffers of every
+  // state is its input.
+  struct Binding {
+    std::vector<runtime::EValue> inputs;
+    std::vector<runtime::EValue> outputs;
+    std::vector<TensorPtr> output_tensors;
+  };
+
+  StreamingSession(Module& module, Options options)
+      : module_(module), options_(std::move(options)) {}
+
+  runtime::Result<std::vector<TensorPtr>> execute(size_t frames);
+
+  Module& module_;
+  const Options options_;
+  size_t window_frames_ = 0;
+  size_t chunk_frames_ = 0;
+  size_t frame_nbytes_ = 0;
+  // The input that the window is copied to, and the expected sizes of every
+  // chunk.
+  TensorPtr window_;
+  std::vector<executorch::aten::SizesType> chunk_sizes_;
+  // The queued frames, of which the first pending_frames_ are valid.
+  std::vector<uint8_t> pending_;
+  size_t pending_frames_ = 0;
+  // The two buffers of every state, their initial sizes, and the outputs
+  // that are not states.
+  std::array<std::vector<TensorPtr>, 2> states_;
+  std::vector<std::vector<executorch::aten::SizesType>> state_sizes_;
+  std::vector<TensorPtr> outputs_;
+  // The binding that reads states_[i] is bindings_[i].
+  std::array<Binding, 2> bindings_;
+  // The index of the buffers that hold the current states.
+  size_t current_ = 0;
+  // The index of the binding that is bound to the method, or -1 if none.
+  int bound_ = -1;
+};
+
+} // namespace extension
+} // namespace executorch
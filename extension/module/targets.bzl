@@ -13,20 +13,80 @@ def define_common_targets():
         runtime.cxx_library(
             name = "module" + aten_suffix,
             srcs = [
+                "file_verification_cache.cpp",
+                "method_pool.cpp",
                 "module.cpp",
             ],
             exported_headers = [
+                "file_verification_cache.h",
+                "method_pool.h",
                 "module.h",
             ],
             visibility = [
                 "@EXECUTORCH_CLIENTS",
             ],
             deps = [
+                "//executorch/extension/memory_allocator:malloc_kernel_cache",
                 "//executorch/extension/memory_allocator:malloc_memory_allocator",
-                "//executorch/extension/data_loader:file_data_loader",
                 "//executorch/extension/data_loader:mmap_data_loader",
+                "//executorch/extension/data_loader:shared_file_data_loader",
+                "//executorch/extension/flat_tensor:flat_tensor_data_map",
             ],
             exported_deps = [
+                "//executorch/extension/memory_allocator:memory_governor",
+                "//executorch/extension/memory_allocator:page_memory",
                 "//executorch/runtime/executor:program" + aten_suffix,
+                "//executorch/runtime/kernel:kernel_runtime_context" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "dynamic_batcher" + aten_suffix,
+            srcs = [
+                "dynamic_batcher.cpp",
+            ],
+            exported_headers = [
+                "dynamic_batcher.h",
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "reloadable_module" + aten_suffix,
+            srcs = [
+                "reloadable_module.cpp",
+            ],
+            exported_headers = [
+                "reloadable_module.h",
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "streaming_session" + aten_suffix,
+            srcs = [
+                "streaming_session.cpp",
+            ],
+            exported_headers = [
+                "streaming_session.h",
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":module" + aten_suffix,
+                "//executorch/extension/tensor:tensor" + aten_suffix,
             ],
         )
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/dynamic_batcher.h>
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/tensor/tensor.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::runtime;
+
+class DynamicBatcherTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    module_ = std::make_unique<Module>(
+        std::getenv("RESOURCES_PATH") + std::string("/add.pte"));
+    ASSERT_EQ(module_->load(), Error::Ok);
+  }
+
+  std::unique_ptr<Module> module_;
+};
+
+TEST_F(DynamicBatcherTest, ConcurrentRequests) {
+  // The inputs of add.pte have a static batch size of 1, so every request is
+  // executed on its own, but still through the batch buffers.
+  auto batcher = DynamicBatcher::create(*module_);
+  ASSERT_EQ(batcher.error(), Error::Ok);
+  EXPECT_EQ((*batcher)->max_batch_size(), 1);
+
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  std::vector<float> results(kNumThreads);
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i] {
+      const auto value = static_cast<float>(i);
+      auto result = (*batcher)
+                        ->submit(
+                            {make_tensor_ptr({1}, {value}),
+                             make_tensor_ptr({1}, {value})})
+                        .get();
+      ASSERT_EQ(result.error(), Error::Ok);
+      ASSERT_EQ(result->size(), 1);
+      EXPECT_EQ(result->at(0)->size(0), 1);
+      results[i] = result->at(0)->const_data_ptr<float>()[0];
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_EQ(results[i], 2 * i);
+  }
+}
+
+TEST_F(DynamicBatcherTest, CreateInvalidOptions) {
+  DynamicBatcher::Options options;
+  options.max_batch_size = 2;
+  EXPECT_EQ(
+      DynamicBatcher::create(*module_, options).error(),
+      Error::InvalidArgument);
+
+  options.max_batch_size = 0;
+  options.method_name = "backward";
+  EXPECT_NE(DynamicBatcher::create(*module_, options).error(), Error::Ok);
+}
+
+TEST_F(DynamicBatcherTest, SubmitInvalidInputs) {
+  auto batcher = DynamicBatcher::create(*module_);
+  ASSERT_EQ(batcher.error(), Error::Ok);
+
+  // Wrong number of inputs.
+  EXPECT_EQ(
+      (*batcher)->submit({make_tensor_ptr({1}, {1.f})}).get().error(),
+      Error::InvalidArgument);
+  // Too many rows.
+  EXPECT_EQ(
+      (*batcher)
+          ->submit(
+              {make_tensor_ptr({2}, {1.f, 2.f}),
+               make_tensor_ptr({2}, {1.f, 2.f})})
+          .get()
+          .error(),
+      Error::InvalidArgument);
+  // Wrong number of dimensions.
+  EXPECT_EQ(
+      (*batcher)
+          ->submit(
+              {make_tensor_ptr({1, 1}, {1.f}), make_tensor_ptr({1, 1}, {1.f})})
+          .get()
+          .error(),
+      Error::InvalidArgument);
+  // Wrong scalar type.
+  EXPECT_EQ(
+      (*batcher)
+          ->submit({make_tensor_ptr({1}, {1}), make_tensor_ptr({1}, {1})})
+          .get()
+          .error(),
+      Error::InvalidArgument);
+
+  // The batcher still works after rejecting requests.
+  auto result =
+      (*batcher)
+          ->submit({make_tensor_ptr({1}, {2.f}), make_tensor_ptr({1}, {3.f})})
+          .get();
+  ASSERT_EQ(result.error(), Error::Ok);
+  EXPECT_EQ(result->at(0)->const_data_ptr<float>()[0], 5.f);
+}
+
+TEST_F(DynamicBatcherTest, RequestsWithoutBatchDim) {
+  DynamicBatcher::Options options;
+  options.has_batch_dim = false;
+  options.max_batch_size = 4;
+  auto batcher = DynamicBatcher::create(*module_, options);
+  ASSERT_EQ(batcher.error(), Error::Ok);
+  EXPECT_EQ((*batcher)->max_batch_size(), 4);
+
+  std::vector<std::future<Result<std::vector<TensorPtr>>>> futures;
+  for (int i = 0; i < 8; ++i) {
+    const auto value = static_cast<float>(i);
+    futures.push_back((*batcher)->submit(
+        {make_tensor_ptr({1}, {value}), make_tensor_ptr({1}, {1.f})}));
+  }
+  for (int i = 0; i < 8; ++i) {
+    auto result = futures[i].get();
+    ASSERT_EQ(result.error(), Error::Ok);
+    ASSERT_EQ(result->size(), 1);
+    EXPECT_EQ(result->at(0)->const_data_ptr<float>()[0], i + 1.f);
+  }
+
+  // Every dimension must match the method's inputs.
+  EXPECT_EQ(
+      (*batcher)
+          ->submit(
+              {make_tensor_ptr({2}, {1.f, 2.f}),
+               make_tensor_ptr({2}, {1.f, 2.f})})
+          .get()
+          .error(),
+      Error::InvalidArgument);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/method_pool.h>
+
+#include <array>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::runtime;
+
+class MethodPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    module_ = std::make_unique<Module>(
+        std::getenv("RESOURCES_PATH") + std::string("/add.pte"));
+    ASSERT_EQ(module_->load(), Error::Ok);
+  }
+
+  std::unique_ptr<Module> module_;
+};
+
+TEST_F(MethodPoolTest, LoadCreatesInstances) {
+  auto pool = MethodPool::load(module_->program(), "forward", 3);
+  ASSERT_EQ(pool.error(), Error::Ok);
+  EXPECT_EQ((*pool)->size(), 3);
+  EXPECT_EQ((*pool)->method_name(), "forward");
+}
+
+TEST_F(MethodPoolTest, LoadInvalidArguments) {
+  EXPECT_NE(MethodPool::load(nullptr, "forward", 1).error(), Error::Ok);
+  EXPECT_NE(
+      MethodPool::load(module_->program(), "forward", 0).error(), Error::Ok);
+  EXPECT_NE(
+      MethodPool::load(module_->program(), "backward", 1).error(), Error::Ok);
+}
+
+TEST_F(MethodPoolTest, InstancesAreDistinctAndReturned) {
+  auto loaded = MethodPool::load(module_->program(), "forward", 2);
+  ASSERT_EQ(loaded.error(), Error::Ok);
+  auto pool = std::move(*loaded);
+
+  {
+    auto first = pool->acquire();
+    auto second = pool->try_acquire();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_NE(&first.method(), &second->method());
+
+    // Both instances are checked out.
+    EXPECT_FALSE(pool->try_acquire().has_value());
+  }
+  // Destroying the leases returned both instances.
+  auto first = pool->try_acquire();
+  auto second = pool->try_acquire();
+  EXPECT_TRUE(first.has_value());
+  EXPECT_TRUE(second.has_value());
+}
+
+TEST_F(MethodPoolTest, ConcurrentExecution) {
+  auto loaded = MethodPool::load(module_->program(), "forward", 2);
+  ASSERT_EQ(loaded.error(), Error::Ok);
+  auto pool = std::move(*loaded);
+
+  auto run = [&pool](float value) {
+    for (int i = 0; i < 10; ++i) {
+      auto lease = pool->acquire();
+      auto tensor = make_tensor_ptr({value});
+      const std::vector<EValue> inputs{tensor, tensor};
+      ASSERT_EQ(
+          lease->set_inputs(ArrayRef<EValue>(inputs.data(), inputs.size())),
+          Error::Ok);
+      ASSERT_EQ(lease->execute(), Error::Ok);
+      const auto data =
+          lease->get_output(0).toTensor().const_data_ptr<float>();
+      EXPECT_NEAR(data[0], 2 * value, 1e-5);
+    }
+  };
+
+  std::array<std::thread, 4> threads = {
+      std::thread(run, 1.f),
+      std::thread(run, 2.f),
+      std::thread(run, 3.f),
+      std::thread(run, 4.f),
+  };
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
@@ -9,11 +9,14 @@
 #include <executorch/extension/module/module.h>
 
 #include <array>
+#include <filesystem>
+#include <fstream>
 #include <thread>
 
 #include <gtest/gtest.h>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
+#include <executorch/extension/module/file_verification_cache.h>
 #include <executorch/extension/tensor/tensor.h>
 
 using namespace ::executorch::extension;
@@ -23,12 +26,15 @@ class ModuleTest : public ::testing::Test {
  protected:
   static void SetUpTestSuite() {
     model_path_ = std::getenv("RESOURCES_PATH") + std::string("/add.pte");
+    multi_entry_model_path_ = std::getenv("ET_MODULE_MULTI_ENTRY_PATH");
   }
 
   static std::string model_path_;
+  static std::string multi_entry_model_path_;
 };
 
 std::string ModuleTest::model_path_;
+std::string ModuleTest::multi_entry_model_path_;
 
 TEST_F(ModuleTest, TestLoad) {
   Module module(model_path_);
@@ -55,6 +61,197 @@ TEST_F(ModuleTest, TestLoadCorruptedFile) {
   EXPECT_FALSE(module.is_loaded());
 }
 
+namespace {
+size_t count_lines(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  size_t count = 0;
+  while (std::getline(file, line)) {
+    ++count;
+  }
+  return count;
+}
+} // namespace
+
+TEST_F(ModuleTest, TestFileVerificationCache) {
+  const auto cache_path =
+      (std::filesystem::temp_directory_path() / "file_verification_cache_test")
+          .string();
+  std::filesystem::remove(cache_path);
+  const std::string data = "program data";
+
+  FileVerificationCache cache(cache_path, model_path_);
+  EXPECT_FALSE(cache.contains(data.data(), data.size()));
+  cache.insert(data.data(), data.size());
+  EXPECT_TRUE(cache.contains(data.data(), data.size()));
+
+  // Other data, or the same data of another file, are not in the cache.
+  const std::string other_data = "program datA";
+  EXPECT_FALSE(cache.contains(other_data.data(), other_data.size()));
+  FileVerificationCache other_cache(cache_path, "/dev/null");
+  EXPECT_FALSE(other_cache.contains(data.data(), data.size()));
+
+  // Files that can't be inspected are never in the cache.
+  FileVerificationCache missing_cache(cache_path, "/path/to/nonexistent.pte");
+  missing_cache.insert(data.data(), data.size());
+  EXPECT_FALSE(missing_cache.contains(data.data(), data.size()));
+  EXPECT_EQ(count_lines(cache_path), 1);
+
+  std::filesystem::remove(cache_path);
+}
+
+TEST_F(ModuleTest, TestLoadWithVerificationCache) {
+  const auto cache_path =
+      (std::filesystem::temp_directory_path() / "module_verification_cache")
+          .string();
+  std::filesystem::remove(cache_path);
+
+  for (int i = 0; i < 2; ++i) {
+    Module module(model_path_);
+    module.set_verification_cache_path(cache_path);
+    EXPECT_EQ(
+        module.load(Program::Verification::InternalConsistency), Error::Ok);
+    EXPECT_TRUE(module.is_loaded());
+    // The first load records the file, and the second one finds it.
+    EXPECT_EQ(count_lines(cache_path), 1);
+  }
+
+  std::filesystem::remove(cache_path);
+}
+
+TEST_F(ModuleTest, TestSharePlannedMemory) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.share_planned_memory({"forward"}), Error::Ok);
+  EXPECT_FALSE(module.is_method_loaded("forward"));
+
+  auto tensor = make_tensor_ptr({2.f});
+  const auto result = module.forward({tensor, tensor});
+  ASSERT_EQ(result.error(), Error::Ok);
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 4, 1e-5);
+
+  // The method is already loaded.
+  EXPECT_EQ(module.share_planned_memory({"forward"}), Error::InvalidState);
+}
+
+TEST_F(ModuleTest, TestSharePlannedMemoryBetweenMethods) {
+  Module module(multi_entry_model_path_);
+
+  ASSERT_EQ(module.share_planned_memory({"forward", "forward2"}), Error::Ok);
+
+  const auto forward_buffers = module.planned_buffers("forward");
+  const auto forward2_buffers = module.planned_buffers("forward2");
+  ASSERT_EQ(forward_buffers.error(), Error::Ok);
+  ASSERT_EQ(forward2_buffers.error(), Error::Ok);
+  ASSERT_FALSE(forward_buffers->empty());
+  ASSERT_EQ(forward_buffers->size(), forward2_buffers->size());
+  for (size_t i = 0; i < forward_buffers->size(); ++i) {
+    EXPECT_EQ(forward_buffers->at(i).data(), forward2_buffers->at(i).data());
+  }
+
+  // The methods take turns on the shared memory, so read each output before
+  // running the other method.
+  auto tensor = make_tensor_ptr({2, 2}, {1.f, 1.f, 1.f, 1.f});
+  for (int i = 0; i < 2; ++i) {
+    const auto forward = module.execute("forward", tensor);
+    ASSERT_EQ(forward.error(), Error::Ok);
+    EXPECT_NEAR(forward->at(0).toTensor().const_data_ptr<float>()[3], 4, 1e-5);
+
+    const auto forward2 = module.execute("forward2", tensor);
+    ASSERT_EQ(forward2.error(), Error::Ok);
+    EXPECT_NEAR(
+        forward2->at(0).toTensor().const_data_ptr<float>()[3], 6, 1e-5);
+  }
+
+  // A method can belong to only one group.
+  EXPECT_EQ(module.share_planned_memory({"forward2"}), Error::InvalidState);
+}
+
+TEST_F(ModuleTest, TestSharePlannedMemoryInvalidMethods) {
+  Module module(model_path_);
+
+  EXPECT_NE(module.share_planned_memory({"backward"}), Error::Ok);
+  EXPECT_FALSE(module.is_method_loaded("forward"));
+
+  ASSERT_EQ(module.share_planned_memory({"forward"}), Error::Ok);
+  EXPECT_EQ(module.share_planned_memory({"forward"}), Error::InvalidState);
+}
+
+TEST_F(ModuleTest, TestPagePolicy) {
+  Module module(model_path_);
+  PagePolicy policy;
+  policy.huge_pages = PagePolicy::HugePages::Transparent;
+  module.set_page_policy(policy);
+
+  auto tensor = make_tensor_ptr({2.f});
+  const auto result = module.forward({tensor, tensor});
+  ASSERT_EQ(result.error(), Error::Ok);
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 4, 1e-5);
+}
+
+TEST_F(ModuleTest, TestExecutionScope) {
+  Module module(model_path_);
+  int num_entered = 0;
+  int num_active = 0;
+  module.set_execution_scope([&]() -> std::shared_ptr<void> {
+    num_entered++;
+    num_active++;
+    return std::shared_ptr<void>(nullptr, [&](void*) { num_active--; });
+  });
+
+  auto tensor = make_tensor_ptr({2.f});
+  const auto result = module.forward({tensor, tensor});
+  ASSERT_EQ(result.error(), Error::Ok);
+  // Entered for loading the method and for executing it.
+  EXPECT_EQ(num_entered, 2);
+  EXPECT_EQ(num_active, 0);
+
+  ASSERT_EQ(module.forward({tensor, tensor}).error(), Error::Ok);
+  EXPECT_EQ(num_entered, 3);
+  EXPECT_EQ(num_active, 0);
+
+  module.set_execution_scope(nullptr);
+  ASSERT_EQ(module.forward({tensor, tensor}).error(), Error::Ok);
+  EXPECT_EQ(num_entered, 3);
+}
+
+TEST_F(ModuleTest, TestMemoryGovernor) {
+  MemoryGovernor governor;
+  Module first(model_path_);
+  Module second(model_path_);
+  ASSERT_EQ(first.set_memory_governor(&governor), Error::Ok);
+  ASSERT_EQ(second.set_memory_governor(&governor), Error::Ok);
+
+  auto tensor = make_tensor_ptr({2.f});
+  ASSERT_EQ(first.forward({tensor, tensor}).error(), Error::Ok);
+  const size_t module_nbytes = governor.total();
+  EXPECT_GT(module_nbytes, 0);
+  const auto breakdown = governor.breakdown();
+  ASSERT_EQ(breakdown.clients.size(), 2);
+  EXPECT_GT(
+      breakdown.by_category[static_cast<size_t>(
+          MemoryGovernor::Category::Constants)],
+      0);
+
+  // Loading the second Module evicts the methods of the first, which is
+  // idle, to fit in the budget.
+  governor.set_budget(2 * module_nbytes - 1);
+  ASSERT_EQ(second.forward({tensor, tensor}).error(), Error::Ok);
+  EXPECT_FALSE(first.is_method_loaded("forward"));
+  EXPECT_TRUE(second.is_method_loaded("forward"));
+  EXPECT_EQ(governor.breakdown().num_evictions, 1);
+  EXPECT_LE(governor.total(), governor.breakdown().budget);
+
+  // The first Module loads its method again when used.
+  const auto result = first.forward({tensor, tensor});
+  ASSERT_EQ(result.error(), Error::Ok);
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 4, 1e-5);
+  EXPECT_FALSE(second.is_method_loaded("forward"));
+
+  // Too late once loaded.
+  EXPECT_EQ(first.set_memory_governor(nullptr), Error::InvalidState);
+}
+
 TEST_F(ModuleTest, TestMethodNames) {
   Module module(model_path_);
 
@@ -120,6 +317,21 @@ TEST_F(ModuleTest, TestNonExistentMethodMeta) {
   EXPECT_NE(meta.error(), Error::Ok);
 }
 
+TEST_F(ModuleTest, TestPlannedBuffers) {
+  Module module(model_path_);
+
+  const auto buffers = module.planned_buffers("forward");
+  ASSERT_EQ(buffers.error(), Error::Ok);
+  const auto meta = module.method_meta("forward");
+  ASSERT_EQ(meta.error(), Error::Ok);
+  ASSERT_EQ(buffers->size(), meta->num_memory_planned_buffers());
+  for (size_t i = 0; i < buffers->size(); ++i) {
+    EXPECT_EQ(buffers->at(i).size(), meta->memory_planned_buffer_size(i).get());
+  }
+
+  EXPECT_NE(module.planned_buffers("backward").error(), Error::Ok);
+}
+
 TEST_F(ModuleTest, TestExecute) {
   Module module(model_path_);
   auto tensor = make_tensor_ptr({1.f});
@@ -135,6 +347,26 @@ TEST_F(ModuleTest, TestExecute) {
   EXPECT_NEAR(data[0], 2, 1e-5);
 }
 
+TEST_F(ModuleTest, TestExecuteAsync) {
+  Module module(model_path_);
+  auto tensor = make_tensor_ptr({1.f});
+
+  auto future = module.execute_async("forward", {tensor, tensor});
+  const auto result = future.get();
+  EXPECT_EQ(result.error(), Error::Ok);
+
+  const auto data = result->at(0).toTensor().const_data_ptr<float>();
+
+  EXPECT_NEAR(data[0], 2, 1e-5);
+}
+
+TEST_F(ModuleTest, TestExecuteAsyncNonExistentMethod) {
+  Module module(model_path_);
+
+  const auto result = module.execute_async("backward", {}).get();
+  EXPECT_NE(result.error(), Error::Ok);
+}
+
 TEST_F(ModuleTest, TestExecutePreload) {
   Module module(model_path_);
 
@@ -435,3 +667,151 @@ TEST_F(ModuleTest, TestSetOutputInvalidType) {
 
   EXPECT_NE(module.set_output(EValue()), Error::Ok);
 }
+
+TEST_F(ModuleTest, TestSetOutputs) {
+  Module module(model_path_);
+
+  // The output of this model is memory-planned, so it can only be left
+  // unchanged.
+  EXPECT_EQ(module.set_outputs({EValue()}), Error::Ok);
+  EXPECT_NE(module.set_outputs({empty({1})}), Error::Ok);
+
+  // Wrong number of outputs.
+  EXPECT_NE(module.set_outputs({}), Error::Ok);
+  // Non-tensor output.
+  EXPECT_NE(module.set_outputs({EValue(true)}), Error::Ok);
+
+  auto tensor = make_tensor_ptr({1.f});
+  const auto result = module.forward({tensor, tensor});
+  ASSERT_EQ(result.error(), Error::Ok);
+  EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 2, 1e-5);
+}
+
+TEST_F(ModuleTest, TestBindAndExecuteBound) {
+  Module module(model_path_);
+
+  auto input = make_tensor_ptr({1.f});
+  auto output = empty({1});
+
+  ASSERT_EQ(module.bind({input, input}, {output}), Error::Ok);
+  ASSERT_EQ(module.execute_bound(), Error::Ok);
+  EXPECT_NEAR(output->const_data_ptr<float>()[0], 2, 1e-5);
+
+  // Updates to the bound input's data are seen by the next execution.
+  input->mutable_data_ptr<float>()[0] = 3.f;
+  ASSERT_EQ(module.execute_bound(), Error::Ok);
+  EXPECT_NEAR(output->const_data_ptr<float>()[0], 6, 1e-5);
+}
+
+TEST_F(ModuleTest, TestExecuteBoundWithoutBind) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.execute_bound(), Error::InvalidState);
+
+  EXPECT_EQ(module.load_forward(), Error::Ok);
+  EXPECT_EQ(module.execute_bound(), Error::InvalidState);
+}
+
+TEST_F(ModuleTest, TestBindInvalidValues) {
+  Module module(model_path_);
+
+  auto input = make_tensor_ptr({1.f});
+  auto output = empty({1});
+
+  // Wrong number of inputs or outputs.
+  EXPECT_NE(module.bind({input}, {output}), Error::Ok);
+  EXPECT_NE(module.bind({input, input}, {}), Error::Ok);
+  // Non-tensor output.
+  EXPECT_NE(module.bind({input, input}, {EValue()}), Error::Ok);
+  // Output too small.
+  EXPECT_NE(module.bind({input, input}, {empty({0})}), Error::Ok);
+
+  // A failed bind leaves nothing bound.
+  EXPECT_EQ(module.execute_bound(), Error::InvalidState);
+}
+
+namespace {
+// Runs each task on a thread of its own.
+class ThreadParallelRunner final : public ParallelRunner {
+ public:
+  void run(TaskFunction fn, void* context, size_t num_tasks) override {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_tasks; ++i) {
+      threads.emplace_back(fn, context, i);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+};
+} // namespace
+
+TEST_F(ModuleTest, TestLoadAsync) {
+  for (const bool use_runner : {false, true}) {
+    Module module(model_path_);
+    ThreadParallelRunner runner;
+    std::promise<Error> loaded;
+
+    ASSERT_EQ(
+        module.load_async(
+            {"forward"},
+            use_runner ? &runner : nullptr,
+            [&loaded](const std::string& method_name, Error error) {
+              EXPECT_EQ(method_name, "forward");
+              loaded.set_value(error);
+            }),
+        Error::Ok);
+    EXPECT_TRUE(module.is_loaded());
+    EXPECT_EQ(loaded.get_future().get(), Error::Ok);
+    EXPECT_FALSE(module.is_method_loaded("forward"));
+
+    auto tensor = make_tensor_ptr({1.f});
+    const auto result = module.forward({tensor, tensor});
+    ASSERT_EQ(result.error(), Error::Ok);
+    EXPECT_NEAR(result->at(0).toTensor().const_data_ptr<float>()[0], 2, 1e-5);
+    EXPECT_TRUE(module.is_method_loaded("forward"));
+  }
+}
+
+TEST_F(ModuleTest, TestLoadAsyncInvalidMethods) {
+  Module module(model_path_);
+
+  EXPECT_EQ(module.load_async({"backward"}), Error::InvalidArgument);
+  EXPECT_EQ(module.load_async({"forward", "forward"}), Error::InvalidArgument);
+
+  // The caller may load a method that is still pending itself, or wait for
+  // it, but may not start loading it again.
+  ASSERT_EQ(module.load_async({"forward"}), Error::Ok);
+  EXPECT_EQ(module.load_async({"forward"}), Error::InvalidState);
+  EXPECT_EQ(module.share_planned_memory({"forward"}), Error::InvalidState);
+  EXPECT_EQ(module.load_forward(), Error::Ok);
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+
+  // Loaded methods are skipped.
+  EXPECT_EQ(module.load_async({"forward"}), Error::Ok);
+}
+
+TEST_F(ModuleTest, TestWarmup) {
+  Module module(model_path_);
+  auto small = make_tensor_ptr({1.f});
+  auto other = make_tensor_ptr({2.f});
+
+  Module::WarmupOptions options;
+  options.inputs = {{small, small}, {other, other}};
+  options.num_executions = 2;
+  options.preserve_state = true;
+  const auto stats = module.warmup("forward", options);
+  ASSERT_EQ(stats.error(), Error::Ok);
+  EXPECT_TRUE(module.is_method_loaded("forward"));
+  EXPECT_EQ(stats->execution_times.size(), 4);
+
+  // The warmup inputs don't stay set, so there is nothing to execute with.
+  EXPECT_EQ(module.warmup("forward").error(), Error::InvalidArgument);
+  EXPECT_NE(module.warmup("backward").error(), Error::Ok);
+
+  EXPECT_EQ(module.set_inputs("forward", {small, other}), Error::Ok);
+  EXPECT_EQ(module.warmup("forward").error(), Error::Ok);
+  const auto outputs = module.forward();
+  ASSERT_EQ(outputs.error(), Error::Ok);
+  EXPECT_NEAR(outputs->at(0).toTensor().const_data_ptr<float>()[0], 3, 1e-5);
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/reloadable_module.h>
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/tensor/tensor.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::runtime;
+
+class ReloadableModuleTest : public ::testing::Test {
+ protected:
+  static std::unique_ptr<Module> make_module() {
+    return std::make_unique<Module>(
+        std::getenv("RESOURCES_PATH") + std::string("/add.pte"));
+  }
+};
+
+TEST_F(ReloadableModuleTest, ExecutesActiveVersion) {
+  auto reloadable =
+      ReloadableModule::create(make_module(), ReloadableModule::Options());
+  ASSERT_EQ(reloadable.error(), Error::Ok);
+  EXPECT_EQ((*reloadable)->version(), 0);
+
+  auto tensor = make_tensor_ptr({1.f});
+  auto outputs = (*reloadable)->execute("forward", {tensor, tensor});
+  ASSERT_EQ(outputs.error(), Error::Ok);
+  ASSERT_EQ(outputs->size(), 1);
+  EXPECT_NEAR(outputs->at(0)->const_data_ptr<float>()[0], 2, 1e-5);
+
+  ASSERT_EQ((*reloadable)->reload(make_module()), Error::Ok);
+  EXPECT_EQ((*reloadable)->version(), 1);
+
+  // The outputs of the old version are copies, so they outlive it.
+  EXPECT_NEAR(outputs->at(0)->const_data_ptr<float>()[0], 2, 1e-5);
+  auto other = make_tensor_ptr({2.f});
+  auto new_outputs = (*reloadable)->execute("forward", {other, other});
+  ASSERT_EQ(new_outputs.error(), Error::Ok);
+  EXPECT_NEAR(new_outputs->at(0)->const_data_ptr<float>()[0], 4, 1e-5);
+}
+
+TEST_F(ReloadableModuleTest, FailedReloadKeepsActiveVersion) {
+  auto reloadable =
+      ReloadableModule::create(make_module(), ReloadableModule::Options());
+  ASSERT_EQ(reloadable.error(), Error::Ok);
+
+  EXPECT_NE(
+      (*reloadable)
+          ->reload(std::make_unique<Module>("/path/to/nonexistent/file.pte")),
+      Error::Ok);
+  EXPECT_EQ((*reloadable)->reload(nullptr), Error::InvalidArgument);
+  EXPECT_EQ((*reloadable)->version(), 0);
+
+  auto tensor = make_tensor_ptr({1.f});
+  EXPECT_EQ(
+      (*reloadable)->execute("forward", {tensor, tensor}).error(), Error::Ok);
+}
+
+TEST_F(ReloadableModuleTest, CustomWarmup) {
+  ReloadableModule::Options options;
+  size_t num_warmups = 0;
+  options.warmup = [&num_warmups](Module& module) {
+    num_warmups++;
+    EXPECT_TRUE(module.is_method_loaded("forward"));
+    return num_warmups < 3 ? Error::Ok : Error::Internal;
+  };
+  auto reloadable = ReloadableModule::create(make_module(), options);
+  ASSERT_EQ(reloadable.error(), Error::Ok);
+
+  EXPECT_EQ((*reloadable)->reload(make_module()), Error::Ok);
+  // A failed warmup leaves the active version in place.
+  EXPECT_EQ((*reloadable)->reload(make_module()), Error::Internal);
+  EXPECT_EQ((*reloadable)->version(), 1);
+  EXPECT_EQ(num_warmups, 3);
+}
+
+TEST_F(ReloadableModuleTest, ReloadWhileExecuting) {
+  auto reloadable =
+      ReloadableModule::create(make_module(), ReloadableModule::Options());
+  ASSERT_EQ(reloadable.error(), Error::Ok);
+
+  std::thread reloader([&reloadable] {
+    for (int i = 0; i < 5; ++i) {
+      EXPECT_EQ((*reloadable)->reload(make_module()), Error::Ok);
+    }
+  });
+  for (int i = 0; i < 50; ++i) {
+    const auto value = static_cast<float>(i);
+    auto tensor = make_tensor_ptr({value});
+    auto outputs = (*reloadable)->execute("forward", {tensor, tensor});
+    ASSERT_EQ(outputs.error(), Error::Ok);
+    EXPECT_NEAR(outputs->at(0)->const_data_ptr<float>()[0], 2 * value, 1e-5);
+  }
+  reloader.join();
+  EXPECT_EQ((*reloadable)->version(), 5);
+}
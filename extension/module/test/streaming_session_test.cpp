@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/module/streaming_session.h>
+
+#include <gtest/gtest.h>
+
+#include <executorch/extension/tensor/tensor.h>
+
+using namespace ::executorch::extension;
+using namespace ::executorch::runtime;
+
+class StreamingSessionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    module_ = std::make_unique<Module>(
+        std::getenv("RESOURCES_PATH") + std::string("/add.pte"));
+    ASSERT_EQ(module_->load(), Error::Ok);
+  }
+
+  // add.pte adds two tensors of size 1, so a session that feeds its output
+  // back as its second input sums up the stream.
+  StreamingSession::Options running_sum_options() const {
+    StreamingSession::Options options;
+    options.time_dim = 0;
+    options.states = {{/*input_index=*/1, /*output_index=*/0}};
+    return options;
+  }
+
+  std::unique_ptr<Module> module_;
+};
+
+TEST_F(StreamingSessionTest, CarriesStateAcrossSteps) {
+  auto session = StreamingSession::create(*module_, running_sum_options());
+  ASSERT_EQ(session.error(), Error::Ok);
+  EXPECT_EQ((*session)->chunk_frames(), 1);
+
+  float sum = 0;
+  for (int i = 1; i <= 5; ++i) {
+    const auto value = static_cast<float>(i);
+    sum += value;
+    auto outputs = (*session)->step(make_tensor_ptr({1}, {value}));
+    ASSERT_EQ(outputs.error(), Error::Ok);
+    ASSERT_EQ(outputs->size(), 1);
+    EXPECT_EQ(outputs->at(0)->const_data_ptr<float>()[0], sum);
+    EXPECT_EQ((*session)->pending_frames(), 0);
+  }
+
+  // Nothing is left to flush, and a new stream starts from zero.
+  auto flushed = (*session)->flush();
+  ASSERT_EQ(flushed.error(), Error::Ok);
+  EXPECT_TRUE(flushed->empty());
+  ASSERT_EQ((*session)->reset(), Error::Ok);
+  auto outputs = (*session)->step(make_tensor_ptr({1}, {7.f}));
+  ASSERT_EQ(outputs.error(), Error::Ok);
+  EXPECT_EQ(outputs->at(0)->const_data_ptr<float>()[0], 7);
+}
+
+TEST_F(StreamingSessionTest, ConstantInputs) {
+  StreamingSession::Options options;
+  options.time_dim = 0;
+  options.constant_inputs = {{1, make_tensor_ptr({1}, {10.f})}};
+  auto session = StreamingSession::create(*module_, options);
+  ASSERT_EQ(session.error(), Error::Ok);
+
+  for (int i = 0; i < 3; ++i) {
+    const auto value = static_cast<float>(i);
+    auto outputs = (*session)->step(make_tensor_ptr({1}, {value}));
+    ASSERT_EQ(outputs.error(), Error::Ok);
+    ASSERT_EQ(outputs->size(), 1);
+    EXPECT_EQ(outputs->at(0)->const_data_ptr<float>()[0], value + 10);
+  }
+}
+
+TEST_F(StreamingSessionTest, CreateInvalidOptions) {
+  // The second input has no value.
+  StreamingSession::Options options;
+  options.time_dim = 0;
+  EXPECT_EQ(
+      StreamingSession::create(*module_, options).error(),
+      Error::InvalidArgument);
+
+  // The lookahead leaves no frames for the chunk.
+  options = running_sum_options();
+  options.lookahead_frames = 1;
+  EXPECT_EQ(
+      StreamingSession::create(*module_, options).error(),
+      Error::InvalidArgument);
+
+  // The time dimension is out of range.
+  options = running_sum_options();
+  options.time_dim = 1;
+  EXPECT_EQ(
+      StreamingSession::create(*module_, options).error(),
+      Error::InvalidArgument);
+
+  // The input is both a state and a constant.
+  options = running_sum_options();
+  options.constant_inputs = {{1, make_tensor_ptr({1}, {1.f})}};
+  EXPECT_EQ(
+      StreamingSession::create(*module_, options).error(),
+      Error::InvalidArgument);
+
+  options = running_sum_options();
+  options.method_name = "backward";
+  EXPECT_NE(StreamingSession::create(*module_, options).error(), Error::Ok);
+}
+
+TEST_F(StreamingSessionTest, StepInvalidChunk) {
+  auto session = StreamingSession::create(*module_, running_sum_options());
+  ASSERT_EQ(session.error(), Error::Ok);
+
+  EXPECT_EQ((*session)->step(nullptr).error(), Error::InvalidArgument);
+  EXPECT_EQ(
+      (*session)->step(make_tensor_ptr({2}, {1.f, 2.f})).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      (*session)->step(make_tensor_ptr({1, 1}, {1.f})).error(),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      (*session)->step(make_tensor_ptr({1}, std::vector<int32_t>{1})).error(),
+      Error::InvalidArgument);
+}
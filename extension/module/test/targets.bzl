@@ -18,15 +18,23 @@ def define_common_targets():
         runtime.cxx_test(
             name = "test" + aten_suffix,
             srcs = [
+                "dynamic_batcher_test.cpp",
+                "method_pool_test.cpp",
                 "module_test.cpp",
+                "reloadable_module_test.cpp",
+                "streaming_session_test.cpp",
             ],
             deps = [
                 "//executorch/kernels/portable:generated_lib" + aten_suffix,
                 "//executorch/extension/data_loader:file_data_loader",
+                "//executorch/extension/module:dynamic_batcher" + aten_suffix,
                 "//executorch/extension/module:module" + aten_suffix,
+                "//executorch/extension/module:reloadable_module" + aten_suffix,
+                "//executorch/extension/module:streaming_session" + aten_suffix,
                 "//executorch/extension/tensor:tensor" + aten_suffix,
             ],
             env = {
+                "ET_MODULE_MULTI_ENTRY_PATH": "$(location fbcode//executorch/test/models:exported_programs[ModuleMultipleEntry.pte])",
                 "RESOURCES_PATH": "$(location :resources)/resources",
             },
             platforms = [CXX, ANDROID],  # Cannot bundle resources on Apple platform.
@@ -40,4 +48,7 @@ def define_common_targets():
         srcs = native.glob([
             "resources/**",
         ]),
+        visibility = [
+            "//executorch/extension/llm/runner/test/...",
+        ],
     )
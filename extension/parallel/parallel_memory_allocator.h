@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/assert.h>
+
+namespace executorch {
+namespace extension {
+
+/**
+ * A MemoryAllocator that can be used from several parallel_for() workers at
+ * once, for example as the temp allocator of a Method whose kernels allocate
+ * scratch memory inside their parallel_for() callbacks.
+ *
+ * The buffer is split into `num_slices` equal slices followed by an optional
+ * overflow region. Each allocation bumps the pointer of the slice selected by
+ * get_thread_num(), which parallel_for() sets to a value that is unique among
+ * the callbacks running at the same time, so slices need no synchronization.
+ * When the selected slice is full, or the thread number has no slice, the
+ * allocation comes from the overflow region, which is shared by all threads
+ * and uses an atomic bump pointer.
+ *
+ * `num_slices` should be at least the number of threads in the threadpool,
+ * since that bounds the number of tasks that parallel_for() creates.
+ *
+ * reset() is not thread-safe, and must only be called when no other thread is
+ * allocating, e.g. between kernels.
+ */
+class ParallelMemoryAllocator : public executorch::runtime::MemoryAllocator {
+ public:
+  /**
+   * Constructs a new allocator over the provided buffer.
+   *
+   * @param[in] size The size in bytes of the buffer at `base_address`.
+   * @param[in] base_address The buffer to allocate from. Does not take
+   *     ownership of this buffer, so it must be valid for the lifetime of the
+   *     ParallelMemoryAllocator.
+   * @param[in] num_slices The number of per-thread slices. Must be greater
+   *     than zero.
+   * @param[in] overflow_size The number of bytes at the end of the buffer to
+   *     share between all threads. Must not be larger than `size`.
+   */
+  ParallelMemoryAllocator(
+      uint32_t size,
+      uint8_t* base_address,
+      size_t num_slices,
+      uint32_t overflow_size = 0)
+      : MemoryAllocator(size, base_address),
+        slices_(num_slices),
+        overflow_begin_(base_address + size - overflow_size),
+        overflow_end_(base_address + size),
+        overflow_cur_(overflow_begin_) {
+    ET_CHECK_MSG(num_slices > 0, "num_slices must be greater than zero");
+    ET_CHECK_MSG(
+        overflow_size <= size,
+        "overflow_size %" PRIu32 " > size %" PRIu32,
+        overflow_size,
+        size);
+    const size_t slice_size = (size - overflow_size) / num_slices;
+    for (size_t i = 0; i < num_slices; ++i) {
+      slices_[i].begin = base_address + i * slice_size;
+      slices_[i].end = slices_[i].begin + slice_size;
+      slices_[i].cur = slices_[i].begin;
+    }
+  }
+
+  /**
+   * Allocates `size` bytes from the calling thread's slice, or from the
+   * overflow region if the slice does not have enough space left.
+   */
+  void* allocate(size_t size, size_t alignment = kDefaultAlignment) override {
+    if (!isPowerOf2(alignment)) {
+      ET_LOG(Error, "Alignment %zu is not a power of 2", alignment);
+      return nullptr;
+    }
+
+    const int64_t thread_num = get_thread_num();
+    if (thread_num >= 0 && static_cast<size_t>(thread_num) < slices_.size()) {
+      Slice& slice = slices_[thread_num];
+      uint8_t* start = alignPointer(slice.cur, alignment);
+      if (start + size <= slice.end) {
+        EXECUTORCH_TRACK_ALLOCATION(prof_id(), start + size - slice.cur);
+        slice.cur = start + size;
+        return start;
+      }
+    }
+
+    uint8_t* cur = overflow_cur_.load(std::memory_order_relaxed);
+    uint8_t* start;
+    do {
+      start = alignPointer(cur, alignment);
+      if (start + size > overflow_end_) {
+        ET_LOG(
+            Error,
+            "Memory allocation failed: %zuB requested on thread %" PRId64
+            ", %zuB available in overflow",
+            size,
+            thread_num,
+            static_cast<size_t>(overflow_end_ - cur));
+        return nullptr;
+      }
+    } while (!overflow_cur_.compare_exchange_weak(
+        cur, start + size, std::memory_order_relaxed));
+    EXECUTORCH_TRACK_ALLOCATION(prof_id(), start + size - cur);
+    return start;
+  }
+
+  /// Frees all allocations in all slices and in the overflow region.
+  void reset() override {
+    for (auto& slice : slices_) {
+      slice.cur = slice.begin;
+    }
+    overflow_cur_.store(overflow_begin_, std::memory_order_relaxed);
+  }
+
+  /// The number of per-thread slices.
+  size_t num_slices() const {
+    return slices_.size();
+  }
+
+ private:
+  // Aligned to a typical cache line so that threads bumping neighboring slices
+  // don't contend for the same line.
+  struct alignas(64) Slice {
+    uint8_t* begin;
+    uint8_t* end;
+    uint8_t* cur;
+  };
+
+  std::vector<Slice> slices_;
+  uint8_t* const overflow_begin_;
+  uint8_t* const overflow_end_;
+  std::atomic<uint8_t*> overflow_cur_;
+};
+
+} // namespace extension
+} // namespace executorch
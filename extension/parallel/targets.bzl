@@ -16,12 +16,16 @@ def define_common_targets():
                 "thread_parallel.cpp",
             ],
             exported_headers = [
+                "parallel_memory_allocator.h",
                 "thread_parallel.h",
             ],
             visibility = [
                 "//executorch/...",
                 "@EXECUTORCH_CLIENTS",
             ],
+            exported_deps = [
+                "//executorch/runtime/core:memory_allocator",
+            ],
             deps = [
                 "//executorch/extension/threadpool:threadpool",
                 "//executorch/runtime/core:core",
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/parallel/parallel_memory_allocator.h>
+
+#include <array>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <executorch/runtime/platform/runtime.h>
+
+using namespace ::testing;
+using ::executorch::extension::ParallelMemoryAllocator;
+using ::executorch::extension::set_thread_num;
+
+class ParallelMemoryAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    executorch::runtime::runtime_init();
+    set_thread_num(0);
+  }
+
+  void TearDown() override {
+    set_thread_num(0);
+  }
+
+  alignas(64) std::array<uint8_t, 1024> buffer_;
+};
+
+TEST_F(ParallelMemoryAllocatorTest, AllocatesFromThreadSlice) {
+  // Four slices of 64 bytes, followed by 768 bytes of overflow.
+  ParallelMemoryAllocator allocator(
+      buffer_.size(), buffer_.data(), /*num_slices=*/4, /*overflow_size=*/768);
+  EXPECT_EQ(allocator.num_slices(), 4);
+
+  for (int64_t thread_num = 0; thread_num < 4; ++thread_num) {
+    set_thread_num(thread_num);
+    auto p = static_cast<uint8_t*>(allocator.allocate(16));
+    EXPECT_EQ(p, buffer_.data() + thread_num * 64);
+    p = static_cast<uint8_t*>(allocator.allocate(16));
+    EXPECT_EQ(p, buffer_.data() + thread_num * 64 + 16);
+  }
+}
+
+TEST_F(ParallelMemoryAllocatorTest, OverflowsIntoSharedRegion) {
+  ParallelMemoryAllocator allocator(
+      buffer_.size(), buffer_.data(), /*num_slices=*/4, /*overflow_size=*/768);
+  uint8_t* overflow = buffer_.data() + 256;
+
+  // Too large for the slice.
+  EXPECT_EQ(allocator.allocate(100), overflow);
+  // The slice is still available for small allocations.
+  EXPECT_EQ(allocator.allocate(8), buffer_.data());
+
+  // A thread number without a slice uses the overflow region.
+  set_thread_num(7);
+  auto p = static_cast<uint8_t*>(allocator.allocate(8));
+  EXPECT_GE(p, overflow + 100);
+
+  // Requests larger than the overflow region fail.
+  EXPECT_EQ(allocator.allocate(1024), nullptr);
+
+  // Reset frees everything.
+  allocator.reset();
+  set_thread_num(0);
+  EXPECT_EQ(allocator.allocate(100), overflow);
+  EXPECT_EQ(allocator.allocate(8), buffer_.data());
+}
+
+TEST_F(ParallelMemoryAllocatorTest, BadAlignmentFails) {
+  ParallelMemoryAllocator allocator(
+      buffer_.size(), buffer_.data(), /*num_slices=*/2);
+  EXPECT_EQ(allocator.allocate(8, /*alignment=*/3), nullptr);
+
+  auto p = allocator.allocate(8, /*alignment=*/32);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 32, 0);
+}
+
+TEST_F(ParallelMemoryAllocatorTest, ConcurrentAllocationsDoNotOverlap) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kNumAllocations = 16;
+  // Each thread's slice only fits half of its allocations, so the rest come
+  // from the shared overflow region.
+  ParallelMemoryAllocator allocator(
+      buffer_.size(),
+      buffer_.data(),
+      kNumThreads,
+      /*overflow_size=*/buffer_.size() / 2);
+
+  std::array<std::array<uint8_t*, kNumAllocations>, kNumThreads> allocations;
+  std::array<std::thread, kNumThreads> threads;
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    threads[t] = std::thread([&, t]() {
+      set_thread_num(t);
+      for (size_t i = 0; i < kNumAllocations; ++i) {
+        auto p = static_cast<uint8_t*>(allocator.allocate(8));
+        ASSERT_NE(p, nullptr);
+        std::fill(p, p + 8, static_cast<uint8_t>(t * kNumAllocations + i));
+        allocations[t][i] = p;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t t = 0; t < kNumThreads; ++t) {
+    for (size_t i = 0; i < kNumAllocations; ++i) {
+      const auto expected = static_cast<uint8_t>(t * kNumAllocations + i);
+      for (size_t b = 0; b < 8; ++b) {
+        EXPECT_EQ(allocations[t][i][b], expected);
+      }
+    }
+  }
+}
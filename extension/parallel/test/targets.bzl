@@ -12,6 +12,18 @@ def define_common_targets():
         srcs = [
             "thread_parallel_test.cpp",
         ],
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/runtime/platform:platform",
+        ],
+    )
+
+    runtime.cxx_test(
+        name = "parallel_memory_allocator_test",
+        srcs = [
+            "parallel_memory_allocator_test.cpp",
+        ],
         deps = [
             "//executorch/extension/parallel:thread_parallel",
             "//executorch/runtime/platform:platform",
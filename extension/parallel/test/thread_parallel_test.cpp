@@ -9,12 +9,18 @@
 #include <gtest/gtest.h>
 
 #include <array>
+#include <atomic>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
 #include <executorch/runtime/platform/platform.h>
 
 using namespace ::testing;
+using ::executorch::extension::get_thread_num;
 using ::executorch::extension::parallel_for;
 
 class ParallelTest : public ::testing::Test {
@@ -191,3 +197,148 @@ TEST_F(ParallelTest, TestChunkSizeTooLarge) {
     EXPECT_EQ(data_[i], i);
   }
 }
+
+TEST_F(ParallelTest, TestThreadNumInRange) {
+  const int64_t num_threads = ::executorch::extension::threadpool::
+                                  get_threadpool()
+                                      ->get_thread_count();
+  std::atomic<bool> in_range{true};
+  EXPECT_TRUE(parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+    const int64_t thread_num = get_thread_num();
+    if (thread_num < 0 || thread_num >= num_threads) {
+      in_range = false;
+    }
+  }));
+  EXPECT_TRUE(in_range);
+}
+
+TEST_F(ParallelTest, TestConcurrentCallers) {
+  constexpr int kNumCallers = 4;
+  constexpr int64_t kSize = 1000;
+  std::vector<std::vector<int>> data(kNumCallers, std::vector<int>(kSize));
+  std::vector<std::thread> callers;
+  for (int c = 0; c < kNumCallers; ++c) {
+    callers.emplace_back([&data, c] {
+      EXPECT_TRUE(parallel_for(0, kSize, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          data[c][i]++;
+        }
+      }));
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  for (const auto& caller_data : data) {
+    for (int value : caller_data) {
+      EXPECT_EQ(value, 1);
+    }
+  }
+}
+
+TEST_F(ParallelTest, TestNested) {
+  constexpr int64_t kOuter = 8;
+  constexpr int64_t kInner = 100;
+  std::vector<std::atomic<int>> counts(kOuter * kInner);
+  EXPECT_TRUE(parallel_for(0, kOuter, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t outer_thread_num = get_thread_num();
+      EXPECT_TRUE(parallel_for(0, kInner, 1, [&](int64_t b, int64_t e) {
+        for (int64_t j = b; j < e; ++j) {
+          counts[i * kInner + j]++;
+        }
+      }));
+      // The inner call restores the thread number of the outer one.
+      EXPECT_EQ(get_thread_num(), outer_thread_num);
+    }
+  }));
+  for (const auto& count : counts) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST_F(ParallelTest, TestUsesSelectedThreadPool) {
+  using ::executorch::extension::threadpool::get_threadpool;
+  using ::executorch::extension::threadpool::ThreadPool;
+  using ::executorch::extension::threadpool::ThreadPoolGuard;
+
+  ThreadPool threadpool(2);
+  ThreadPoolGuard guard(&threadpool);
+  std::atomic<bool> in_range{true};
+  std::atomic<bool> uses_threadpool{true};
+  EXPECT_TRUE(parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+    if (get_thread_num() >= 2) {
+      in_range = false;
+    }
+    // Holds on worker threads too, so nested calls use the same threadpool.
+    if (get_threadpool() != &threadpool) {
+      uses_threadpool = false;
+    }
+  }));
+  EXPECT_TRUE(in_range);
+  EXPECT_TRUE(uses_threadpool);
+}
+
+TEST_F(ParallelTest, TestShrinkingThreadPool) {
+  using ::executorch::extension::threadpool::ThreadPool;
+  using ::executorch::extension::threadpool::ThreadPoolGuard;
+
+  // Alternate between threadpools of different sizes, so that the workers
+  // grow for the large one and the extra ones exit for the small one.
+  ThreadPool large_threadpool(8);
+  ThreadPool small_threadpool(2);
+  for (int i = 0; i < 10; ++i) {
+    for (ThreadPool* threadpool : {&large_threadpool, &small_threadpool}) {
+      ThreadPoolGuard guard(threadpool);
+      const int64_t num_threads = threadpool->get_thread_count();
+      std::vector<std::atomic<int>> counts(1000);
+      std::atomic<bool> in_range{true};
+      EXPECT_TRUE(parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) {
+        if (get_thread_num() >= num_threads) {
+          in_range = false;
+        }
+        for (int64_t j = begin; j < end; ++j) {
+          counts[j]++;
+        }
+      }));
+      EXPECT_TRUE(in_range);
+      for (const auto& count : counts) {
+        EXPECT_EQ(count.load(), 1);
+      }
+    }
+  }
+}
+
+TEST_F(ParallelTest, TestWorkerWaitPolicy) {
+  using ::executorch::extension::get_worker_wait_policy;
+  using ::executorch::extension::HotWorkersGuard;
+  using ::executorch::extension::set_worker_wait_policy;
+  using ::executorch::extension::WorkerWaitPolicy;
+
+  const WorkerWaitPolicy original = get_worker_wait_policy();
+  WorkerWaitPolicy policy;
+  policy.spin_duration = std::chrono::microseconds(50);
+  policy.yield_duration = std::chrono::microseconds(100);
+  set_worker_wait_policy(policy);
+  EXPECT_EQ(get_worker_wait_policy().spin_duration, policy.spin_duration);
+  EXPECT_EQ(get_worker_wait_policy().yield_duration, policy.yield_duration);
+
+  auto run_many = [this]() {
+    for (int i = 0; i < 100; ++i) {
+      data_.fill(0);
+      EXPECT_TRUE(parallel_for(0, 10, 1, [this](int64_t begin, int64_t end) {
+        this->RunTask(begin, end);
+      }));
+      for (int64_t j = 0; j < 10; ++j) {
+        EXPECT_EQ(data_[j], j);
+      }
+    }
+  };
+  run_many();
+  {
+    HotWorkersGuard hot;
+    run_many();
+  }
+  set_worker_wait_policy(original);
+  run_many();
+}
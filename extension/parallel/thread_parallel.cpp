@@ -6,26 +6,333 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include <tuple>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <executorch/extension/parallel/thread_parallel.h>
 #include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/platform/assert.h>
 
+#if !(defined(WIN32))
+#include <pthread.h>
+#endif
+
 namespace executorch {
 namespace extension {
 
 namespace {
 thread_local int64_t thread_num_ = 0;
-}
 
-using namespace ::executorch::extension::threadpool;
+using ::executorch::extension::threadpool::get_threadpool;
+using ::executorch::extension::threadpool::NoThreadPoolGuard;
+using ::executorch::extension::threadpool::ThreadPool;
+using ::executorch::extension::threadpool::ThreadPoolGuard;
 
 inline int64_t divup(int64_t x, int64_t y) {
   return (x + y - 1) / y;
 }
 
+std::atomic<int64_t> spin_duration_us{0};
+std::atomic<int64_t> yield_duration_us{0};
+std::atomic<int64_t> num_hot_workers_guards{0};
+
+// Tells the core that this is a spin-wait loop.
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * Waits for `ready()` to return true without blocking, for as long as the
+ * worker wait policy allows. Returns false if the caller should block.
+ */
+template <typename Ready>
+bool spin_until(const Ready& ready) {
+  using Clock = std::chrono::steady_clock;
+  const std::chrono::microseconds spin_duration(
+      spin_duration_us.load(std::memory_order_relaxed));
+  const std::chrono::microseconds yield_duration(
+      yield_duration_us.load(std::memory_order_relaxed));
+  const auto spin_end = Clock::now() + spin_duration;
+  const auto yield_end = spin_end + yield_duration;
+  while (!ready()) {
+    if (num_hot_workers_guards.load(std::memory_order_relaxed) > 0) {
+      cpu_relax();
+      continue;
+    }
+    const auto now = Clock::now();
+    if (now < spin_end) {
+      cpu_relax();
+    } else if (now < yield_end) {
+      std::this_thread::yield();
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * The state of one parallel_for() call. Lives on the stack of the calling
+ * thread, which does not return until no worker refers to it anymore.
+ */
+struct Job {
+  // The threadpool that was selected for the caller, whose cores the workers
+  // run on while they work on the job.
+  ThreadPool* const threadpool;
+  // The number of threads of `threadpool`, which bounds the number of workers
+  // while the job is open.
+  const int64_t threadpool_size;
+  const std::function<void(int64_t, int64_t)>& f;
+  const int64_t end;
+  const int64_t grain_size;
+  // The most threads that may work on the job, including the caller. Bounds
+  // the values that get_thread_num() returns while running it.
+  const int64_t max_threads;
+  // The first work item that no thread has claimed yet.
+  std::atomic<int64_t> next;
+  // The number of threads that have joined the job, including the caller.
+  // Guarded by Scheduler::mutex.
+  int64_t num_threads = 1;
+  // The number of workers that are still running chunks of the job. Only
+  // modified while holding Scheduler::mutex, but atomic so that the caller
+  // can spin on it.
+  std::atomic<int64_t> num_active_workers{0};
+
+  Job(ThreadPool* threadpool_,
+      int64_t threadpool_size_,
+      const std::function<void(int64_t, int64_t)>& f_,
+      int64_t begin,
+      int64_t end_,
+      int64_t grain_size_,
+      int64_t max_threads_)
+      : threadpool(threadpool_),
+        threadpool_size(threadpool_size_),
+        f(f_),
+        end(end_),
+        grain_size(grain_size_),
+        max_threads(max_threads_),
+        next(begin) {}
+
+  /**
+   * Claims and runs chunks until all work items are claimed. Chunks start
+   * large and shrink as the job nears its end (guided self-scheduling), so
+   * that threads that join late or run slow chunks still finish at about the
+   * same time, without paying per-chunk overhead for every grain_size items.
+   */
+  void run_chunks(int64_t thread_num) {
+    // Nested calls run on the same thread, so restore the number of the
+    // enclosing job's thread afterwards.
+    const int64_t prev_thread_num = get_thread_num();
+    set_thread_num(thread_num);
+    int64_t start = next.load(std::memory_order_relaxed);
+    while (start < end) {
+      const int64_t remaining = end - start;
+      const int64_t chunk_size = std::min(
+          remaining, std::max(grain_size, remaining / (2 * max_threads)));
+      if (next.compare_exchange_weak(
+              start, start + chunk_size, std::memory_order_relaxed)) {
+        f(start, start + chunk_size);
+        start = next.load(std::memory_order_relaxed);
+      }
+    }
+    set_thread_num(prev_thread_num);
+  }
+
+  bool has_unclaimed_work() const {
+    return next.load(std::memory_order_relaxed) < end &&
+        num_threads < max_threads;
+  }
+};
+
+/**
+ * Runs the jobs of all concurrent parallel_for() callers on one set of worker
+ * threads. Each caller works on its own job too, and idle workers join the
+ * open jobs round-robin to share them out between callers. Since a caller
+ * only ever waits for chunks that other threads are already running, nested
+ * parallel_for() calls from inside a chunk can't deadlock.
+ *
+ * Together with the caller, the workers never outnumber the threads of the
+ * largest threadpool among the open jobs, so that they don't compete for more
+ * cores than the threadpool was given. When the threadpools shrink, e.g. with
+ * ThreadPool::_unsafe_reset_threadpool(), the extra workers exit.
+ */
+class Scheduler final {
+ public:
+  void run(Job& job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(&job);
+      num_jobs_ = jobs_.size();
+      max_workers_ = 0;
+      for (const Job* open_job : jobs_) {
+        max_workers_ = std::max(max_workers_, open_job->threadpool_size - 1);
+      }
+      start_workers(job.max_threads - 1);
+    }
+    work_available_.notify_all();
+
+    job.run_chunks(/*thread_num=*/0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    remove_job(&job);
+    if (job.num_active_workers == 0) {
+      return;
+    }
+    lock.unlock();
+    // The last chunks are usually about to finish, so spin before blocking.
+    if (spin_until([&job] { return job.num_active_workers == 0; })) {
+      return;
+    }
+    lock.lock();
+    job_finished_.wait(lock, [&job] { return job.num_active_workers == 0; });
+  }
+
+ private:
+  // Grows the set of workers to at least num_workers threads. Workers only
+  // exit in work(), once there are more than max_workers_ of them. Must hold
+  // mutex_.
+  void start_workers(int64_t num_workers) {
+    while (num_workers_ < num_workers) {
+      num_workers_++;
+      std::thread([this] {
+        // Threads inherit the affinity of their creator, which may be
+        // restricted to the cores of its threadpool.
+        threadpool::set_thread_affinity({});
+        work();
+      }).detach();
+    }
+  }
+
+  // Must hold mutex_.
+  bool has_extra_workers() const {
+    return num_workers_ > max_workers_;
+  }
+
+  // Must hold mutex_.
+  void remove_job(Job* job) {
+    auto it = std::find(jobs_.begin(), jobs_.end(), job);
+    if (it != jobs_.end()) {
+      jobs_.erase(it);
+      num_jobs_ = jobs_.size();
+    }
+  }
+
+  // Waits until there are jobs or too many workers, following the wait
+  // policy. Must hold mutex_.
+  void wait_for_jobs(std::unique_lock<std::mutex>& lock) {
+    if (!jobs_.empty() || has_extra_workers()) {
+      return;
+    }
+    lock.unlock();
+    spin_until([this] { return num_jobs_.load() > 0; });
+    lock.lock();
+    work_available_.wait(
+        lock, [this] { return !jobs_.empty() || has_extra_workers(); });
+  }
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    size_t next_job = 0;
+    while (true) {
+      wait_for_jobs(lock);
+      if (has_extra_workers()) {
+        num_workers_--;
+        return;
+      }
+      Job* job = jobs_[next_job++ % jobs_.size()];
+      if (!job->has_unclaimed_work()) {
+        remove_job(job);
+        continue;
+      }
+      const int64_t thread_num = job->num_threads++;
+      job->num_active_workers++;
+      lock.unlock();
+      {
+        // Also makes nested calls from the job use its threadpool.
+        ThreadPoolGuard guard(job->threadpool);
+        job->run_chunks(thread_num);
+      }
+      lock.lock();
+      remove_job(job);
+      if (--job->num_active_workers == 0) {
+        job_finished_.notify_all();
+      }
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable job_finished_;
+  // Jobs that may still have unclaimed work.
+  std::vector<Job*> jobs_;
+  // The size of jobs_, for workers to spin on without holding mutex_.
+  std::atomic<size_t> num_jobs_{0};
+  // The number of worker threads that are running.
+  int64_t num_workers_ = 0;
+  // The most worker threads that the open jobs can use.
+  int64_t max_workers_ = 0;
+};
+
+#if !(defined(WIN32))
+// As with the threadpool, a forked child inherits the scheduler but not its
+// worker threads, so the child leaks it and starts a new one.
+bool leak_forked_scheduler = false;
+
+void child_atfork() {
+  leak_forked_scheduler = true;
+}
+#endif
+
+Scheduler& get_scheduler() {
+  // Never destroyed, so that workers blocked on it at exit don't outlive it.
+  static Scheduler* scheduler = new Scheduler();
+#if !(defined(WIN32))
+  // @lint-ignore CLANGTIDY facebook-hte-std::once_flag
+  static std::once_flag flag;
+  // @lint-ignore CLANGTIDY facebook-hte-std::call_once
+  std::call_once(
+      flag, []() { pthread_atfork(nullptr, nullptr, child_atfork); });
+  if ET_UNLIKELY (leak_forked_scheduler) {
+    leak_forked_scheduler = false;
+    scheduler = new Scheduler();
+  }
+#endif
+  return *scheduler;
+}
+
+} // namespace
+
+void set_worker_wait_policy(const WorkerWaitPolicy& policy) {
+  spin_duration_us = policy.spin_duration.count();
+  yield_duration_us = policy.yield_duration.count();
+}
+
+WorkerWaitPolicy get_worker_wait_policy() {
+  WorkerWaitPolicy policy;
+  policy.spin_duration = std::chrono::microseconds(spin_duration_us.load());
+  policy.yield_duration = std::chrono::microseconds(yield_duration_us.load());
+  return policy;
+}
+
+HotWorkersGuard::HotWorkersGuard() {
+  num_hot_workers_guards++;
+}
+
+HotWorkersGuard::~HotWorkersGuard() {
+  num_hot_workers_guards--;
+}
+
 int64_t get_thread_num() {
   return thread_num_;
 }
@@ -34,20 +341,6 @@ void set_thread_num(int64_t thread_num) {
   thread_num_ = thread_num;
 }
 
-inline std::tuple<int64_t, int64_t>
-calc_num_tasks_and_chunk_size(int64_t begin, int64_t end, int64_t grain_size) {
-  if ((end - begin) < grain_size) {
-    return std::make_tuple(1, std::max((int64_t)0, end - begin));
-  }
-  // Choose number of tasks based on grain size and number of threads.
-  int64_t chunk_size =
-      divup((end - begin), get_threadpool()->get_thread_count());
-  // Make sure each task is at least grain_size size.
-  chunk_size = std::max(grain_size, chunk_size);
-  int64_t num_tasks = divup((end - begin), chunk_size);
-  return std::make_tuple(num_tasks, chunk_size);
-}
-
 bool parallel_for(
     const int64_t begin,
     const int64_t end,
@@ -56,22 +349,27 @@ bool parallel_for(
   ET_LOG_AND_RETURN_IF_FALSE(begin >= 0 && end >= 0);
   ET_LOG_AND_RETURN_IF_FALSE(end >= begin);
   ET_LOG_AND_RETURN_IF_FALSE(grain_size > 0);
-  int64_t num_tasks = 0, chunk_size = 0;
-  std::tie(num_tasks, chunk_size) =
-      calc_num_tasks_and_chunk_size(begin, end, grain_size);
-
-  auto task = [f, begin, end, chunk_size](size_t task_id) {
-    set_thread_num(task_id);
-    int64_t local_start = begin + static_cast<int64_t>(task_id) * chunk_size;
-    if (local_start < end) {
-      int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
-      f(local_start, local_end);
-    }
-  };
+  if (begin == end) {
+    return true;
+  }
+
+  ThreadPool* const threadpool =
+      NoThreadPoolGuard::is_enabled() ? nullptr : get_threadpool();
+  const int64_t threadpool_size = threadpool == nullptr
+      ? 1
+      : static_cast<int64_t>(threadpool->get_thread_count());
+  const int64_t max_threads =
+      std::min(threadpool_size, divup(end - begin, grain_size));
+  if (max_threads <= 1) {
+    const int64_t prev_thread_num = get_thread_num();
+    set_thread_num(0);
+    f(begin, end);
+    set_thread_num(prev_thread_num);
+    return true;
+  }
 
-  // Per protocol from threadpool (pthreadpool), when this returns, all tasks
-  // are executed, so this is synchronous.
-  get_threadpool()->run(task, num_tasks);
+  Job job(threadpool, threadpool_size, f, begin, end, grain_size, max_threads);
+  get_scheduler().run(job);
   return true;
 }
 
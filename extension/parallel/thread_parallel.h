@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 
@@ -25,6 +26,17 @@ namespace extension {
  *   void f(int64_t begin, int64_t end)
  * Returns true if all work items are processed successfully, false otherwise
  *
+ * Calls from different threads run concurrently, sharing the worker threads
+ * between them, and f may itself call parallel_for. The calling thread always
+ * works on its own call, and chunks get smaller towards the end of the range
+ * to balance the load. While f runs, get_thread_num() returns a number in
+ * [0, get_threadpool()->get_thread_count()) that no other thread working on
+ * the same call has, e.g. to index per-thread scratch buffers.
+ *
+ * Runs on the threadpool selected for the calling thread with a
+ * ThreadPoolGuard, if any, and on its cores. The worker threads are sized to
+ * that threadpool, and follow it when it is reset to fewer threads.
+ *
  * Warning: parallel_for does NOT copy thread local states from the current
  * thread to the worker threads. Users need to protect the access to captured
  * data if they mutate them in f.
@@ -35,6 +47,45 @@ bool parallel_for(
     const int64_t grain_size,
     const std::function<void(int64_t, int64_t)>& f);
 
+/**
+ * How the worker threads of parallel_for wait for work once they run out of
+ * it. Waking up a blocked worker takes tens of microseconds, which adds up
+ * when a workload makes many short parallel_for calls in a row, like the
+ * kernels of one LLM decoding step.
+ */
+struct WorkerWaitPolicy {
+  /// How long to spin on a core before yielding.
+  std::chrono::microseconds spin_duration{0};
+  /// How long to keep yielding the core to other threads before blocking.
+  std::chrono::microseconds yield_duration{0};
+};
+
+/**
+ * Sets how the worker threads of parallel_for, and callers waiting for the
+ * last chunks of their calls, wait. By default they block right away. Only
+ * affects waits that start afterwards.
+ */
+void set_worker_wait_policy(const WorkerWaitPolicy& policy);
+
+/// Returns the policy set by set_worker_wait_policy().
+WorkerWaitPolicy get_worker_wait_policy();
+
+/**
+ * Keeps the worker threads of parallel_for spinning instead of blocking while
+ * any instance exists, regardless of the wait policy, e.g. for the duration
+ * of a generation loop. The workers burn their cores until then, so keep the
+ * scope tight. Workers that are already blocked stay blocked until the next
+ * parallel_for call wakes them.
+ */
+class HotWorkersGuard final {
+ public:
+  HotWorkersGuard();
+  ~HotWorkersGuard();
+
+  HotWorkersGuard(const HotWorkersGuard&) = delete;
+  HotWorkersGuard& operator=(const HotWorkersGuard&) = delete;
+};
+
 int64_t get_thread_num();
 
 void set_thread_num(int64_t thread_num);
@@ -37,7 +37,9 @@ from executorch.extension.pybindings._portable_lib import (  # noqa: F401
     # Disable "imported but unused" (F401) checks.
     _create_profile_block,  # noqa: F401
     _dump_profile_results,  # noqa: F401
+    _get_fallback_kernel_indices,  # noqa: F401
     _get_operator_names,  # noqa: F401
+    _get_registry_fingerprint,  # noqa: F401
     _load_bundled_program_from_buffer,  # noqa: F401
     _load_for_executorch,  # noqa: F401
     _load_for_executorch_from_buffer,  # noqa: F401
@@ -7,11 +7,17 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
+#include <exception>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <stdexcept>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <pybind11/iostream.h>
 #include <pybind11/pybind11.h>
@@ -23,6 +29,7 @@
 #include <executorch/extension/data_loader/buffer_data_loader.h>
 #include <executorch/extension/data_loader/mmap_data_loader.h>
 #include <executorch/extension/memory_allocator/malloc_memory_allocator.h>
+#include <executorch/extension/module/method_pool.h>
 #include <executorch/runtime/core/data_loader.h>
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 #include <executorch/runtime/executor/method.h>
@@ -37,9 +44,12 @@
 #include <ATen/Tensor.h>
 #include <ATen/core/functional.h>
 #include <c10/core/ScalarTypeToTypeMeta.h>
+#include <torch/csrc/autograd/python_variable.h>
 #include <torch/csrc/utils/pybind.h>
 #include <torch/python.h>
 
+#include <executorch/extension/aten_util/tensor_conversion_cache.h>
+
 #ifndef USE_ATEN_LIB
 #include <c10/core/impl/LocalDispatchKeySet.h>
 #include <executorch/extension/aten_util/aten_bridge.h>
@@ -85,13 +95,16 @@ namespace py = pybind11;
 using executorch::bundled_program::verify_method_outputs;
 using ::executorch::extension::BufferDataLoader;
 using ::executorch::extension::MallocMemoryAllocator;
+using ::executorch::extension::MethodPool;
 using ::executorch::extension::MmapDataLoader;
+using ::executorch::extension::TensorConversionCache;
 using ::executorch::runtime::ArrayRef;
 using ::executorch::runtime::DataLoader;
 using ::executorch::runtime::Error;
 using ::executorch::runtime::EValue;
 using ::executorch::runtime::EventTracerDebugLogLevel;
 using ::executorch::runtime::get_registered_kernels;
+using ::executorch::runtime::get_registry_fingerprint;
 using ::executorch::runtime::HierarchicalAllocator;
 using ::executorch::runtime::Kernel;
 using ::executorch::runtime::MemoryAllocator;
@@ -163,6 +176,93 @@ void setup_output_storage(
   }
 }
 
+/// Returns the scalar type of the elements of a buffer, given the struct
+/// module format and item size reported by the buffer protocol.
+at::ScalarType buffer_scalar_type(const std::string& format, ssize_t itemsize) {
+  // Native byte order is the only one supported, with or without alignment.
+  std::string code = format;
+  if (!code.empty() && (code[0] == '@' || code[0] == '=' || code[0] == '<')) {
+    code = code.substr(1);
+  }
+  if (code.size() == 1) {
+    switch (code[0]) {
+      case '?':
+        return at::ScalarType::Bool;
+      case 'e':
+        return at::ScalarType::Half;
+      case 'f':
+        return at::ScalarType::Float;
+      case 'd':
+        return at::ScalarType::Double;
+      case 'B':
+      case 'c':
+        return at::ScalarType::Byte;
+      case 'b':
+      case 'h':
+      case 'i':
+      case 'l':
+      case 'q':
+        switch (itemsize) {
+          case 1:
+            return at::ScalarType::Char;
+          case 2:
+            return at::ScalarType::Short;
+          case 4:
+            return at::ScalarType::Int;
+          case 8:
+            return at::ScalarType::Long;
+        }
+        break;
+    }
+  }
+  throw std::runtime_error(
+      "Unsupported buffer format '" + format + "' with item size " +
+      std::to_string(itemsize));
+}
+
+/// Returns a torch.Tensor that shares memory with `input` if it supports
+/// DLPack or the buffer protocol, like NumPy arrays, memoryviews and the CPU
+/// arrays of other frameworks. Returns None for any other object. Buffers are
+/// added to `buffers`, which must outlive the returned tensor.
+py::object as_torch_tensor(
+    const py::object& input,
+    std::vector<py::buffer_info>& buffers) {
+  const bool is_buffer = py::isinstance<py::buffer>(input);
+  if (py::hasattr(input, "__dlpack__")) {
+    try {
+      return py::module_::import("torch").attr("from_dlpack")(input);
+    } catch (const py::error_already_set&) {
+      // For example, NumPy can't export read-only arrays through DLPack. Use
+      // the buffer protocol instead, if the object supports it.
+      if (!is_buffer) {
+        throw;
+      }
+    }
+  }
+  if (!is_buffer) {
+    return py::none();
+  }
+  buffers.push_back(py::reinterpret_borrow<py::buffer>(input).request());
+  const py::buffer_info& info = buffers.back();
+  std::vector<int64_t> strides;
+  strides.reserve(info.ndim);
+  for (const auto stride : info.strides) {
+    // Strides are in bytes, torch strides are in elements.
+    if (stride % info.itemsize != 0) {
+      throw std::runtime_error(
+          "Buffer stride " + std::to_string(stride) +
+          " is not a multiple of its item size " +
+          std::to_string(info.itemsize));
+    }
+    strides.push_back(stride / info.itemsize);
+  }
+  return py::cast(at::from_blob(
+      info.ptr,
+      std::vector<int64_t>(info.shape.begin(), info.shape.end()),
+      strides,
+      at::TensorOptions(buffer_scalar_type(info.format, info.itemsize))));
+}
+
 class Module final {
  public:
   explicit Module(
@@ -181,7 +281,7 @@ class Module final {
         program.error(),
         "loading program failed with error: 0x%" PRIx32,
         static_cast<uint32_t>(program.error()));
-    program_ = std::make_unique<Program>(std::move(program.get()));
+    program_ = std::make_shared<Program>(std::move(program.get()));
 
     // Figure out the size of each non_const layer we need to support every
     // method in the program. Map will be easier to use than a list because we
@@ -277,7 +377,7 @@ class Module final {
     if (output_storages) {
       setup_output_storage(method, *output_storages);
     }
-    Error execute_status = method.execute();
+    Error execute_status = execute(method);
     THROW_IF_ERROR(
         execute_status,
         "method->execute() failed with error 0x%" PRIx32,
@@ -286,6 +386,112 @@ class Module final {
     return get_outputs(method_name);
   }
 
+  /// Executes the method with its current inputs. Releases the GIL while the
+  /// method runs, so callers must hold execution_mutex().
+  Error execute(Method& method) {
+    py::gil_scoped_release release;
+    return method.execute();
+  }
+
+  /// Serializes executions of the module, since all of its methods share the
+  /// same planned memory. Only lock it while the GIL is released: the thread
+  /// that holds it may need the GIL to finish.
+  std::mutex& execution_mutex() {
+    return execution_mutex_;
+  }
+
+  /// Returns the buffers that hold the outputs of the method that are neither
+  /// memory planned nor non-tensors, which get empty buffers. The buffers are
+  /// allocated on first use and reused by every execution of the method, so
+  /// that outputs returned without a copy stay valid until the next one.
+  std::vector<Span<uint8_t>> output_storages(const std::string& method_name) {
+    auto it = output_storages_.find(method_name);
+    if (it == output_storages_.end()) {
+      it = output_storages_
+               .emplace(
+                   method_name,
+                   make_output_storages(get_method(method_name)))
+               .first;
+    }
+    std::vector<Span<uint8_t>> spans;
+    spans.reserve(it->second.size());
+    for (auto& storage : it->second) {
+      spans.emplace_back(storage.data(), storage.size());
+    }
+    return spans;
+  }
+
+  /// Returns the buffers that inputs of the method which can't be aliased
+  /// are converted into. Callers must hold execution_mutex() while they use
+  /// the buffers, since the previous execution may still read them.
+  TensorConversionCache& input_conversions(const std::string& method_name) {
+    return input_conversions_[method_name];
+  }
+
+  /// Allocates a buffer for each output of the method that is neither memory
+  /// planned nor a non-tensor, which get empty buffers.
+  static std::vector<std::vector<uint8_t>> make_output_storages(
+      const Method& method) {
+    const auto num_outputs = method.outputs_size();
+    std::vector<std::vector<uint8_t>> output_storages;
+    output_storages.reserve(num_outputs);
+    auto meta = method.method_meta();
+    for (size_t i = 0; i < num_outputs; ++i) {
+      auto output_type = meta.output_tag(i);
+      THROW_IF_ERROR(
+          output_type.error(), "Failed to get output type for output %zu", i);
+      if (output_type.get() != Tag::Tensor) {
+        // Skip allocating storage for non-tensor outputs.
+        output_storages.emplace_back();
+        continue;
+      }
+      const auto& output_tensor_meta =
+          method.method_meta().output_tensor_meta(i);
+      THROW_IF_ERROR(
+          output_tensor_meta.error(),
+          "Failed to get output tensor meta for output %zu",
+          i);
+      if (output_tensor_meta.get().is_memory_planned()) {
+        // Skip allocating storage for planned memory outputs.
+        output_storages.emplace_back();
+        continue;
+      }
+      // Allocate storage for the output tensor.
+      const size_t output_size = output_tensor_meta.get().nbytes();
+      output_storages.emplace_back(output_size);
+    }
+    return output_storages;
+  }
+
+  /// Returns a pool of at least `num_instances` instances of the method, for
+  /// executing it on several threads at once. The instances have their own
+  /// planned memory, so they can run alongside each other and alongside the
+  /// method returned by get_method(), but they do not trace events to the
+  /// ETDump. Must be called with the GIL held.
+  ///
+  /// The module caches the pool for later calls, and replaces the cached pool
+  /// when a later call asks for more instances. The caller shares ownership
+  /// of the returned pool, so a replaced pool, and the program it holds, stay
+  /// alive until the last caller releases it.
+  std::shared_ptr<MethodPool> method_pool(
+      const std::string& method_name,
+      size_t num_instances) {
+    get_method(method_name); // Throws if there is no such method.
+    auto& pool = method_pools_[method_name];
+    if (!pool || pool->size() < num_instances) {
+      // Batches that are still running keep using the old pool.
+      auto result = MethodPool::load(program_, method_name, num_instances);
+      THROW_IF_ERROR(
+          result.error(),
+          "loading %zu instances of method %s failed with error 0x%" PRIx32,
+          num_instances,
+          method_name.c_str(),
+          static_cast<uint32_t>(result.error()));
+      pool = std::move(result.get());
+    }
+    return pool;
+  }
+
   std::vector<EValue> get_outputs(const std::string& method_name) {
     auto& method = methods_[method_name];
     std::vector<EValue> result(method->outputs_size());
@@ -388,11 +594,18 @@ class Module final {
 
   std::unique_ptr<Memory> memory_;
   std::unique_ptr<DataLoader> loader_; // program_ points to this.
-  std::unique_ptr<const Program> program_; // methods_ entries points to this.
+  std::shared_ptr<Program> program_; // methods_ entries points to this.
   std::unordered_map<std::string, std::unique_ptr<Method>> methods_;
+  std::unordered_map<std::string, std::shared_ptr<MethodPool>> method_pools_;
   std::unique_ptr<ETDumpGen> event_tracer_;
   std::unique_ptr<uint8_t[]> debug_buffer_;
   size_t debug_buffer_size_;
+  // Storage for the outputs of each method that are not memory planned.
+  std::unordered_map<std::string, std::vector<std::vector<uint8_t>>>
+      output_storages_;
+  // Buffers for the inputs of each method that have to be converted.
+  std::unordered_map<std::string, TensorConversionCache> input_conversions_;
+  std::mutex execution_mutex_;
 };
 
 inline std::unique_ptr<Module> load_module_from_buffer(
@@ -589,6 +802,311 @@ struct PyMethodMeta final {
   torch::executor::MethodMeta meta_;
 };
 
+/// The inputs of one execution of a method, converted from Python objects.
+/// Owns everything that the EValues refer to. Must be destroyed with the GIL
+/// held.
+class MethodInputs final {
+ public:
+  /// Tensors are aliased if they are laid out as the method expects. Given
+  /// the method's meta, others are copied into the buffers of `conversions`,
+  /// which must not be used by another execution until this one is done.
+  /// Without it, they are copied into new contiguous tensors.
+  explicit MethodInputs(
+      const py::sequence& inputs,
+      const torch::executor::MethodMeta* meta = nullptr,
+      TensorConversionCache* conversions = nullptr) {
+    const auto inputs_size = py::len(inputs);
+    evalues_.reserve(inputs_size);
+    buffers_.reserve(inputs_size);
+    at_tensors_.reserve(inputs_size);
+#ifndef USE_ATEN_LIB
+    // We store pointers to these vector elements so important to reserve so
+    // that we don't lose those on a vector resize. Don't need to do this for
+    // the others since they are vectors of vectors, and we don't store a
+    // pointer to the root level vector data.
+    tensor_impls_.reserve(inputs_size);
+#endif
+
+    // Convert python objects into EValues.
+    for (size_t i = 0; i < inputs_size; ++i) {
+      py::object python_input = inputs[i];
+      if (!THPVariable_Check(python_input.ptr())) {
+        py::object tensor = as_torch_tensor(python_input, buffers_);
+        if (!tensor.is_none()) {
+          converted_.push_back(tensor);
+          python_input = tensor;
+        }
+      }
+      const std::string& type_str = py::str(python_input.get_type());
+      if (THPVariable_Check(python_input.ptr())) {
+        auto at_tensor = python_input.cast<at::Tensor>();
+        // The dim order that the method expects for this input, contiguous
+        // unless the method says otherwise.
+        std::vector<torch::executor::Tensor::DimOrderType> dim_order(
+            at_tensor.dim());
+        std::iota(dim_order.begin(), dim_order.end(), 0);
+        auto tensor_meta = meta != nullptr && i < meta->num_inputs()
+            ? meta->input_tensor_meta(i)
+            : Result<torch::executor::TensorInfo>(Error::NotFound);
+        if (tensor_meta.ok() && conversions != nullptr &&
+            tensor_meta->dim_order().size() == dim_order.size()) {
+          dim_order.assign(
+              tensor_meta->dim_order().begin(), tensor_meta->dim_order().end());
+          at_tensor = conversions->convert(
+              i,
+              at_tensor,
+              static_cast<c10::ScalarType>(tensor_meta->scalar_type()),
+              {dim_order.data(), dim_order.size()});
+        } else if (!at_tensor.is_contiguous()) {
+          at_tensor = at_tensor.contiguous();
+        }
+        at_tensors_.push_back(at_tensor);
+
+#ifdef USE_ATEN_LIB
+        EValue evalue(at_tensor);
+#else
+        // convert at::Tensor to torch::executor::Tensor
+        auto type =
+            torch_to_executorch_scalar_type(at_tensor.options().dtype());
+        size_t dim = at_tensor.dim();
+        // cant directly alias at::Tensor sizes and strides due to int64 vs
+        // int32 typing conflict
+        sizes_.emplace_back(at_tensor.sizes().begin(), at_tensor.sizes().end());
+        strides_.emplace_back(
+            at_tensor.strides().begin(), at_tensor.strides().end());
+
+        dim_orders_.push_back(std::move(dim_order));
+        tensor_impls_.emplace_back(
+            type,
+            dim,
+            sizes_.back().data(),
+            nullptr,
+            dim_orders_.back().data(),
+            strides_.back().data());
+
+        torch::executor::Tensor temp =
+            torch::executor::Tensor(&tensor_impls_.back());
+        alias_etensor_to_attensor(at_tensor, temp);
+        EValue evalue(temp);
+#endif
+
+        evalues_.push_back(evalue);
+      } else if (py::isinstance<py::none>(python_input)) {
+        evalues_.push_back(EValue());
+      } else if (py::isinstance<py::bool_>(python_input)) {
+        evalues_.push_back(EValue(py::cast<bool>(python_input)));
+      } else if (py::isinstance<py::int_>(python_input)) {
+        evalues_.push_back(EValue(py::cast<int64_t>(python_input)));
+      } else {
+        ET_ASSERT_UNREACHABLE_MSG("Unsupported pytype: %s", type_str.c_str());
+      }
+    }
+  }
+
+  MethodInputs(const MethodInputs&) = delete;
+  MethodInputs& operator=(const MethodInputs&) = delete;
+  MethodInputs(MethodInputs&&) = delete;
+  MethodInputs& operator=(MethodInputs&&) = delete;
+
+  const std::vector<EValue>& evalues() const {
+    return evalues_;
+  }
+
+ private:
+  std::vector<EValue> evalues_;
+  // Keep the tensors viewed or copied from the inputs alive until the method
+  // has run.
+  std::vector<py::buffer_info> buffers_;
+  std::vector<py::object> converted_;
+  std::vector<at::Tensor> at_tensors_;
+#ifndef USE_ATEN_LIB // Portable mode
+  // So the ETensors and their metadata stay in scope for
+  // Module->run_method.
+  std::vector<torch::executor::TensorImpl> tensor_impls_;
+  std::vector<std::vector<torch::executor::Tensor::SizesType>> sizes_;
+  std::vector<std::vector<torch::executor::Tensor::StridesType>> strides_;
+  std::vector<std::vector<torch::executor::Tensor::DimOrderType>> dim_orders_;
+#endif
+};
+
+/// Converts an output of a method that is not a tensor to a Python object.
+py::object scalar_to_py(const EValue& v) {
+  if (Tag::None == v.tag) {
+    return py::none();
+  } else if (Tag::Int == v.tag) {
+    return py::cast(v.toInt());
+  } else if (Tag::Double == v.tag) {
+    return py::cast(v.toDouble());
+  } else if (Tag::Bool == v.tag) {
+    return py::cast(v.toBool());
+  } else if (Tag::String == v.tag) {
+    return py::cast(std::string(v.toString().data()));
+  }
+  ET_ASSERT_UNREACHABLE_MSG("Invalid model output type");
+}
+
+/// Returns an at::Tensor that aliases a tensor output of a method.
+at::Tensor output_as_at_tensor(const EValue& v) {
+#ifdef USE_ATEN_LIB
+  return v.toTensor();
+#else
+  return alias_attensor_to_etensor(v.toTensor());
+#endif
+}
+
+/// Splits a batch whose tensors are stacked along a new first dimension into
+/// the inputs of each sample. Every sample gets one element of each tensor
+/// along that dimension, and the same value for each input that is not a
+/// tensor. Buffers are added
+/// to `buffers`, which must outlive the returned inputs.
+std::vector<std::unique_ptr<MethodInputs>> split_stacked_batch(
+    const py::sequence& batch,
+    std::vector<py::buffer_info>& buffers) {
+  const size_t num_inputs = py::len(batch);
+  std::vector<py::object> inputs;
+  std::vector<std::vector<at::Tensor>> slices(num_inputs);
+  int64_t batch_size = -1;
+  for (size_t i = 0; i < num_inputs; ++i) {
+    py::object input = batch[i];
+    if (!THPVariable_Check(input.ptr())) {
+      py::object tensor = as_torch_tensor(input, buffers);
+      if (!tensor.is_none()) {
+        input = tensor;
+      }
+    }
+    if (THPVariable_Check(input.ptr())) {
+      const auto tensor = input.cast<at::Tensor>();
+      if (tensor.dim() == 0 ||
+          (batch_size >= 0 && tensor.size(0) != batch_size)) {
+        throw std::invalid_argument(
+            "Tensors of a stacked batch must have the same first dimension");
+      }
+      batch_size = tensor.size(0);
+      slices[i] = tensor.unbind(0);
+    }
+    inputs.push_back(std::move(input));
+  }
+  if (batch_size <= 0) {
+    throw std::invalid_argument("A stacked batch must have a tensor input");
+  }
+
+  std::vector<std::unique_ptr<MethodInputs>> samples;
+  samples.reserve(batch_size);
+  for (int64_t sample = 0; sample < batch_size; ++sample) {
+    py::list sample_inputs;
+    for (size_t i = 0; i < num_inputs; ++i) {
+      sample_inputs.append(
+          slices[i].empty() ? inputs[i] : py::cast(slices[i][sample]));
+    }
+    samples.push_back(std::make_unique<MethodInputs>(sample_inputs));
+  }
+  return samples;
+}
+
+/// The outputs of one sample of a batch, copied out of the memory of the
+/// method so that they outlive its next execution.
+struct BatchOutputs final {
+  // The outputs that are not tensors. The entries of tensor outputs are None.
+  std::vector<EValue> values;
+  // Copies of the tensor outputs. The entries of other outputs are undefined.
+  std::vector<at::Tensor> tensors;
+};
+
+/// Executes one instance of the method of `pool` on samples of the batch until
+/// none are left, claiming them one at a time through `next_sample`. Runs
+/// without the GIL.
+void run_batch_worker(
+    MethodPool& pool,
+    const std::vector<std::unique_ptr<MethodInputs>>& samples,
+    std::vector<BatchOutputs>& outputs,
+    std::atomic<size_t>& next_sample,
+    const std::atomic<bool>& failed) {
+#ifdef USE_ATEN_LIB
+  // See [TLS handling] in Module::run_method, the guard is thread local.
+  c10::impl::ExcludeDispatchKeyGuard no_autograd(c10::autograd_dispatch_keyset);
+#endif
+  auto lease = pool.acquire();
+  Method& method = lease.method();
+  auto output_storages = Module::make_output_storages(method);
+  std::vector<Span<uint8_t>> output_spans;
+  for (auto& storage : output_storages) {
+    output_spans.emplace_back(storage.data(), storage.size());
+  }
+  setup_output_storage(method, output_spans);
+
+  for (size_t i = next_sample++; i < samples.size() && !failed;
+       i = next_sample++) {
+    const auto& inputs = samples[i]->evalues();
+    Error status =
+        method.set_inputs(ArrayRef<EValue>(inputs.data(), inputs.size()));
+    THROW_IF_ERROR(
+        status,
+        "method->set_inputs() for sample %zu failed with error 0x%" PRIx32,
+        i,
+        static_cast<uint32_t>(status));
+    status = method.execute();
+    THROW_IF_ERROR(
+        status,
+        "method->execute() for sample %zu failed with error 0x%" PRIx32,
+        i,
+        static_cast<uint32_t>(status));
+
+    auto& sample_outputs = outputs[i];
+    sample_outputs.values.resize(method.outputs_size());
+    sample_outputs.tensors.resize(method.outputs_size());
+    status = method.get_outputs(
+        sample_outputs.values.data(), sample_outputs.values.size());
+    THROW_IF_ERROR(
+        status,
+        "method->get_outputs() for sample %zu failed with error 0x%" PRIx32,
+        i,
+        static_cast<uint32_t>(status));
+    for (size_t j = 0; j < sample_outputs.values.size(); ++j) {
+      if (sample_outputs.values[j].isTensor()) {
+        // The next sample overwrites the memory of the outputs.
+        sample_outputs.tensors[j] =
+            output_as_at_tensor(sample_outputs.values[j]).clone();
+        sample_outputs.values[j] = EValue();
+      }
+    }
+  }
+}
+
+/// Executes the method of `pool` on every sample of a batch, on `num_threads`
+/// threads that each use their own instance of the method. Must be called
+/// without the GIL. Rethrows the first error of any thread.
+void run_batch(
+    MethodPool& pool,
+    const std::vector<std::unique_ptr<MethodInputs>>& samples,
+    std::vector<BatchOutputs>& outputs,
+    size_t num_threads) {
+  std::atomic<size_t> next_sample{0};
+  std::atomic<bool> failed{false};
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&]() {
+      try {
+        run_batch_worker(pool, samples, outputs, next_sample, failed);
+      } catch (...) {
+        failed = true;
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 struct PyModule final {
   explicit PyModule(
       const py::bytes& buffer,
@@ -669,103 +1187,97 @@ struct PyModule final {
       const std::string& method_name,
       const py::sequence& inputs,
       bool clone_outputs = true) {
-    const auto inputs_size = py::len(inputs);
-    std::vector<EValue> cpp_inputs;
-    cpp_inputs.reserve(inputs_size);
-
-#ifndef USE_ATEN_LIB // Portable mode
-    // So the ETensors and their metadata stay in scope for
-    // Module->run_method.
-    std::vector<torch::executor::TensorImpl> input_tensors;
-    std::vector<std::vector<torch::executor::Tensor::SizesType>> input_sizes;
-    std::vector<std::vector<torch::executor::Tensor::StridesType>>
-        input_strides;
-    std::vector<std::vector<torch::executor::Tensor::DimOrderType>>
-        input_dim_order;
-    // We store pointers to these vector elements so important to reserve so
-    // that we don't lose those on a vector resize. Don't need to do this for
-    // the others since they are vectors of vectors, and we don't store a
-    // pointer to the root level vector data.
-    input_tensors.reserve(inputs_size);
-#endif
-
-    // Convert python objects into EValues.
-    for (size_t i = 0; i < inputs_size; ++i) {
-      auto python_input = inputs[i];
-      const std::string& type_str = py::str(python_input.get_type());
-      if (type_str == "<class 'torch.Tensor'>") {
-        auto at_tensor = python_input.cast<at::Tensor>();
-        // alias_etensor_to_attensor will assert on this later, so to better
-        // propogate up to python we check early and throw an exception.
-        if (!at_tensor.is_contiguous()) {
-          auto error_msg = "Input " + std::to_string(i) + "for method " +
-              method_name + " is not contiguous.";
-          throw std::runtime_error(error_msg);
-        }
-
-#ifdef USE_ATEN_LIB
-        EValue evalue(at_tensor);
-#else
-        // convert at::Tensor to torch::executor::Tensor
-        auto type =
-            torch_to_executorch_scalar_type(at_tensor.options().dtype());
-        size_t dim = at_tensor.dim();
-        // cant directly alias at::Tensor sizes and strides due to int64 vs
-        // int32 typing conflict
-        input_sizes.emplace_back(
-            at_tensor.sizes().begin(), at_tensor.sizes().end());
-        input_strides.emplace_back(
-            at_tensor.strides().begin(), at_tensor.strides().end());
+    // Lock first, since the inputs may be converted into buffers that the
+    // previous execution reads.
+    const auto lock = lock_execution();
+    const auto meta = module_->get_method(method_name).method_meta();
+    MethodInputs cpp_inputs(
+        inputs, &meta, &module_->input_conversions(method_name));
+    auto outputs = module_->run_method(
+        method_name,
+        cpp_inputs.evalues(),
+        module_->output_storages(method_name));
 
-        // Only works for MemoryFormat::Contiguous inputs
-        std::vector<torch::executor::Tensor::DimOrderType> dim_order;
-        for (size_t cur_dim = 0; cur_dim < dim; cur_dim++) {
-          dim_order.push_back(cur_dim);
-        }
-        input_dim_order.push_back(std::move(dim_order));
-        input_tensors.emplace_back(
-            type,
-            dim,
-            input_sizes.back().data(),
-            nullptr,
-            input_dim_order.back().data(),
-            input_strides.back().data());
+    // Retrieve outputs
+    return get_outputs_as_py_list(outputs, clone_outputs);
+  }
 
-        torch::executor::Tensor temp =
-            torch::executor::Tensor(&input_tensors.back());
-        alias_etensor_to_attensor(at_tensor, temp);
-        EValue evalue(temp);
-#endif
+  py::list forward(const py::sequence& inputs, bool clone_outputs = true) {
+    return run_method("forward", inputs, clone_outputs);
+  }
 
-        cpp_inputs.push_back(evalue);
-      } else if (py::isinstance<py::none>(python_input)) {
-        cpp_inputs.push_back(EValue());
-      } else if (py::isinstance<py::bool_>(python_input)) {
-        cpp_inputs.push_back(EValue(py::cast<bool>(python_input)));
-      } else if (py::isinstance<py::int_>(python_input)) {
-        cpp_inputs.push_back(EValue(py::cast<int64_t>(python_input)));
-      } else {
-        ET_ASSERT_UNREACHABLE_MSG("Unsupported pytype: %s", type_str.c_str());
+  /// Executes the method on every sample of a batch, on up to `num_threads`
+  /// threads without holding the GIL, and returns the outputs of every sample.
+  /// `batch` is either a sequence with the inputs of each sample, or with
+  /// `stacked` the inputs of all samples stacked along a new first dimension
+  /// of each tensor, in which case the tensor outputs are stacked the same way.
+  py::list run_method_batch(
+      const std::string& method_name,
+      const py::sequence& batch,
+      size_t num_threads = 0,
+      bool stacked = false) {
+    std::vector<py::buffer_info> buffers;
+    std::vector<std::unique_ptr<MethodInputs>> samples;
+    if (stacked) {
+      samples = split_stacked_batch(batch, buffers);
+    } else {
+      for (const auto& sample : batch) {
+        samples.push_back(
+            std::make_unique<MethodInputs>(sample.cast<py::sequence>()));
       }
     }
+    if (samples.empty()) {
+      return py::list();
+    }
+    if (num_threads == 0) {
+      num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, samples.size());
 
-    const auto& method = module_->get_method(method_name);
-    const auto num_outputs = method.outputs_size();
-    output_storages_ = make_output_storages(method);
-    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
-    for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
+    const auto pool = module_->method_pool(method_name, num_threads);
+    std::vector<BatchOutputs> outputs(samples.size());
+    {
+      py::gil_scoped_release release;
+      run_batch(*pool, samples, outputs, num_threads);
     }
-    auto outputs =
-        module_->run_method(method_name, cpp_inputs, output_storage_spans);
 
-    // Retrieve outputs
-    return get_outputs_as_py_list(outputs, clone_outputs);
+    if (!stacked) {
+      py::list result;
+      for (const auto& sample_outputs : outputs) {
+        py::list list(sample_outputs.values.size());
+        for (size_t i = 0; i < sample_outputs.values.size(); ++i) {
+          list[i] = sample_outputs.tensors[i].defined()
+              ? py::cast(sample_outputs.tensors[i])
+              : scalar_to_py(sample_outputs.values[i]);
+        }
+        result.append(list);
+      }
+      return result;
+    }
+    // Stack the tensor outputs of the samples. The other outputs are the same
+    // for every sample, so take those of the first one.
+    const auto& first = outputs.front();
+    py::list result(first.values.size());
+    for (size_t i = 0; i < first.values.size(); ++i) {
+      if (!first.tensors[i].defined()) {
+        result[i] = scalar_to_py(first.values[i]);
+        continue;
+      }
+      std::vector<at::Tensor> tensors;
+      tensors.reserve(outputs.size());
+      for (const auto& sample_outputs : outputs) {
+        tensors.push_back(sample_outputs.tensors[i]);
+      }
+      result[i] = py::cast(at::stack(tensors));
+    }
+    return result;
   }
 
-  py::list forward(const py::sequence& inputs, bool clone_outputs = true) {
-    return run_method("forward", inputs, clone_outputs);
+  py::list forward_batch(
+      const py::sequence& batch,
+      size_t num_threads = 0,
+      bool stacked = false) {
+    return run_method_batch("forward", batch, num_threads, stacked);
   }
 
   py::list forward_single_input(
@@ -814,6 +1326,7 @@ struct PyModule final {
       const std::string method_name,
       size_t testset_idx) {
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
+    const auto lock = lock_execution();
     Error status = executorch::bundled_program::load_bundled_input(
         module_->get_method(method_name), bundled_program_ptr, testset_idx);
     THROW_IF_ERROR(
@@ -829,6 +1342,7 @@ struct PyModule final {
       double rtol = 1e-5,
       double atol = 1e-8) {
     const void* bundled_program_ptr = m.get_bundled_program_ptr();
+    const auto lock = lock_execution();
     auto& method = module_->get_method(method_name);
     Error status = executorch::bundled_program::load_bundled_input(
         method, bundled_program_ptr, testset_idx);
@@ -836,7 +1350,7 @@ struct PyModule final {
         status,
         "load_bundled_input failed with status 0x%" PRIx32,
         static_cast<uint32_t>(status));
-    py::list outputs = plan_execute(method_name);
+    py::list outputs = plan_execute_locked(method_name);
     status = executorch::bundled_program::verify_method_outputs(
         method, bundled_program_ptr, testset_idx, rtol, atol);
     THROW_IF_ERROR(
@@ -849,23 +1363,8 @@ struct PyModule final {
   py::list plan_execute(
       const std::string method_name,
       bool clone_outputs = true) {
-    auto& method = module_->get_method(method_name);
-    // Need to pre-allocate space for outputs just like in run_method.
-    const auto num_outputs = method.outputs_size();
-    output_storages_ = make_output_storages(method);
-    std::vector<Span<uint8_t>> output_storage_spans(num_outputs);
-    for (int i = 0; i < output_storages_.size(); ++i) {
-      output_storage_spans[i] =
-          Span<uint8_t>(output_storages_[i].data(), output_storages_[i].size());
-    }
-    setup_output_storage(method, output_storage_spans);
-    auto status = method.execute();
-    THROW_IF_ERROR(
-        status,
-        "executing execution plan for method 'forward' failed with error: 0x%" PRIx32,
-        static_cast<uint32_t>(status));
-    const auto outputs = module_->get_outputs(method_name);
-    return get_outputs_as_py_list(outputs, clone_outputs);
+    const auto lock = lock_execution();
+    return plan_execute_locked(method_name, clone_outputs);
   }
 
   py::list get_outputs_as_py_list(
@@ -875,34 +1374,24 @@ struct PyModule final {
     py::list list(outputs_size);
     for (size_t i = 0; i < outputs_size; ++i) {
       auto& v = outputs[i];
-      if (Tag::None == v.tag) {
-        list[i] = py::none();
-      } else if (Tag::Int == v.tag) {
-        list[i] = py::cast(v.toInt());
-      } else if (Tag::Double == v.tag) {
-        list[i] = py::cast(v.toDouble());
-      } else if (Tag::Bool == v.tag) {
-        list[i] = py::cast(v.toBool());
-      } else if (Tag::String == v.tag) {
-        list[i] = py::cast(std::string(v.toString().data()));
-      } else if (Tag::Tensor == v.tag) {
-#ifdef USE_ATEN_LIB
-        // Clone so the outputs in python do not share a lifetime with the
-        // module object
-        if (clone_outputs) {
-          list[i] = py::cast(v.toTensor().clone());
-        } else {
-          list[i] = py::cast(v.toTensor());
-        }
-#else
+      if (Tag::Tensor == v.tag) {
+        const at::Tensor tensor = output_as_at_tensor(v);
         if (clone_outputs) {
-          list[i] = py::cast(alias_attensor_to_etensor(v.toTensor()).clone());
+          // Clone so the outputs in python do not share a lifetime with the
+          // module object
+          list[i] = py::cast(tensor.clone());
         } else {
-          list[i] = py::cast(alias_attensor_to_etensor(v.toTensor()));
+          // A view of the module's memory, which the view keeps alive. The
+          // next execution of the module overwrites its contents.
+          list[i] = py::cast(at::from_blob(
+              tensor.mutable_data_ptr(),
+              tensor.sizes(),
+              tensor.strides(),
+              [module = module_](void*) {},
+              tensor.options()));
         }
-#endif
       } else {
-        ET_ASSERT_UNREACHABLE_MSG("Invalid model output type");
+        list[i] = scalar_to_py(v);
       }
     }
     return list;
@@ -919,42 +1408,27 @@ struct PyModule final {
 
  private:
   std::shared_ptr<Module> module_;
-  // Need to keep-alive output storages until they can be compared in case of
-  // bundled programs.
-  std::vector<std::vector<uint8_t>> output_storages_;
 
-  std::vector<std::vector<uint8_t>> make_output_storages(const Method& method) {
-    const auto num_outputs = method.outputs_size();
-    // Create a buffer for each output tensor. Memory planned outputs and non
-    // tensor outputs get an empty buffer in this list which is ignored later.
-    std::vector<std::vector<uint8_t>> output_storages;
-    output_storages_.reserve(num_outputs);
-    auto meta = method.method_meta();
-    for (size_t i = 0; i < num_outputs; ++i) {
-      auto output_type = meta.output_tag(i);
-      THROW_IF_ERROR(
-          output_type.error(), "Failed to get output type for output %zu", i);
-      if (output_type.get() != Tag::Tensor) {
-        // Skip allocating storage for non-tensor outputs.
-        output_storages.emplace_back();
-        continue;
-      }
-      const auto& output_tensor_meta =
-          method.method_meta().output_tensor_meta(i);
-      THROW_IF_ERROR(
-          output_tensor_meta.error(),
-          "Failed to get output tensor meta for output %zu",
-          i);
-      if (output_tensor_meta.get().is_memory_planned()) {
-        // Skip allocating storage for planned memory outputs.
-        output_storages.emplace_back();
-        continue;
-      }
-      // Allocate storage for the output tensor.
-      const size_t output_size = output_tensor_meta.get().nbytes();
-      output_storages.emplace_back(output_size);
-    }
-    return output_storages;
+  // Acquires the lock that serializes executions of the module. The GIL is
+  // released while waiting for it, since its holder may need the GIL.
+  std::unique_lock<std::mutex> lock_execution() {
+    py::gil_scoped_release release;
+    return std::unique_lock<std::mutex>(module_->execution_mutex());
+  }
+
+  py::list plan_execute_locked(
+      const std::string& method_name,
+      bool clone_outputs = true) {
+    auto& method = module_->get_method(method_name);
+    // Need to pre-allocate space for outputs just like in run_method.
+    setup_output_storage(method, module_->output_storages(method_name));
+    auto status = module_->execute(method);
+    THROW_IF_ERROR(
+        status,
+        "executing execution plan for method 'forward' failed with error: 0x%" PRIx32,
+        static_cast<uint32_t>(status));
+    const auto outputs = module_->get_outputs(method_name);
+    return get_outputs_as_py_list(outputs, clone_outputs);
   }
 };
 
@@ -973,6 +1447,33 @@ py::list get_operator_names() {
   return res;
 }
 
+// Maps the name of every operator whose only kernel is a fallback kernel to
+// the index of that kernel in the registry. Operators with specialized kernels
+// are left out, since their kernel depends on the tensors they are called with.
+py::dict get_fallback_kernel_indices() {
+  Span<const Kernel> kernels = get_registered_kernels();
+  std::unordered_map<std::string, int32_t> indices;
+  std::unordered_set<std::string> specialized;
+  for (size_t i = 0; i < kernels.size(); ++i) {
+    const Kernel& k = kernels[i];
+    if (k.name_ == nullptr) {
+      continue;
+    }
+    if (k.kernel_key_.is_fallback()) {
+      indices.emplace(k.name_, static_cast<int32_t>(i));
+    } else {
+      specialized.emplace(k.name_);
+    }
+  }
+  py::dict res;
+  for (const auto& entry : indices) {
+    if (specialized.count(entry.first) == 0) {
+      res[py::cast(entry.first)] = entry.second;
+    }
+  }
+  return res;
+}
+
 } // namespace
 
 PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
@@ -1027,6 +1528,8 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
       },
       call_guard);
   m.def("_get_operator_names", &get_operator_names);
+  m.def("_get_registry_fingerprint", &get_registry_fingerprint);
+  m.def("_get_fallback_kernel_indices", &get_fallback_kernel_indices);
   m.def("_create_profile_block", &create_profile_block, call_guard);
   m.def(
       "_reset_profile_results",
@@ -1069,6 +1572,21 @@ PYBIND11_MODULE(EXECUTORCH_PYTHON_MODULE_NAME, m) {
           py::arg("inputs") = py::list(),
           py::arg("clone_outputs") = true,
           call_guard)
+      // No call_guard: the redirected streams are not safe to write to from
+      // several threads at once, so batches log to the process's stderr.
+      .def(
+          "run_method_batch",
+          &PyModule::run_method_batch,
+          py::arg("method_name"),
+          py::arg("batch"),
+          py::arg("num_threads") = 0,
+          py::arg("stacked") = false)
+      .def(
+          "forward_batch",
+          &PyModule::forward_batch,
+          py::arg("batch"),
+          py::arg("num_threads") = 0,
+          py::arg("stacked") = false)
       .def("has_etdump", &PyModule::has_etdump, call_guard)
       .def(
           "write_etdump_result_to_file",
@@ -27,6 +27,19 @@ class Verification(Enum):
 class ExecuTorchModule:
     """ExecuTorchModule is a Python wrapper around a C++ ExecuTorch program.
 
+    Tensor inputs may be torch Tensors, or any object that supports DLPack or
+    the buffer protocol, such as NumPy arrays, which are used without a copy.
+    Non-contiguous inputs are copied to contiguous ones.
+
+    By default, tensor outputs are copied. With ``clone_outputs=False`` they
+    are instead views of the module's memory, which they keep alive: their
+    contents are overwritten by the next execution of the module. Either way,
+    outputs can be exported without a copy, e.g. with ``Tensor.numpy()`` or
+    ``torch.utils.dlpack.to_dlpack()``.
+
+    Methods release the GIL while they execute. Executions of the same module
+    from several threads are serialized.
+
     .. warning::
 
         This API is experimental and subject to change without notice.
@@ -48,6 +61,36 @@ class ExecuTorchModule:
         clone_outputs: bool = True,
     ) -> List[Any]: ...
     # pyre-ignore[3]: "Any" in return type annotations.
+    def run_method_batch(
+        self,
+        method_name: str,
+        batch: Sequence[Any],  # pyre-ignore[2]: "Any" in parameter type annotations.
+        num_threads: int = 0,
+        stacked: bool = False,
+    ) -> List[Any]:
+        """Executes the method on every sample of ``batch``, on up to
+        ``num_threads`` threads (by default one per CPU) that each use their own
+        instance of the method, and returns the outputs of all samples at once.
+        The GIL is released until every sample has run.
+
+        ``batch`` is a sequence with the inputs of each sample, and the result a
+        list with the outputs of each sample. With ``stacked=True``, ``batch``
+        holds the inputs of all samples instead, stacked along a new first
+        dimension of each tensor: every sample gets one element of each tensor
+        along that dimension, and the same value for the other inputs. The
+        tensor outputs of the samples are then stacked the same way.
+
+        Tensor outputs are always copied. Batches do not record ETDump events.
+        """
+        ...
+    # pyre-ignore[3]: "Any" in return type annotations.
+    def forward_batch(
+        self,
+        batch: Sequence[Any],  # pyre-ignore[2]: "Any" in parameter type annotations.
+        num_threads: int = 0,
+        stacked: bool = False,
+    ) -> List[Any]: ...
+    # pyre-ignore[3]: "Any" in return type annotations.
     def plan_execute(self) -> List[Any]: ...
     # Bundled program methods.
     def load_bundled_input(
@@ -220,6 +263,28 @@ def _get_operator_names() -> List[str]:
     """
     ...
 
+@experimental("This API is experimental and subject to change without notice.")
+def _get_registry_fingerprint() -> int:
+    """Returns the fingerprint of the kernels registered in this runtime.
+
+    .. warning::
+
+        This API is experimental and subject to change without notice.
+    """
+    ...
+
+@experimental("This API is experimental and subject to change without notice.")
+def _get_fallback_kernel_indices() -> Dict[str, int]:
+    """Maps operator names to the registry index of their fallback kernel.
+
+    Operators that also have specialized kernels are not included.
+
+    .. warning::
+
+        This API is experimental and subject to change without notice.
+    """
+    ...
+
 @experimental("This API is experimental and subject to change without notice.")
 def _create_profile_block(name: str) -> None:
     """
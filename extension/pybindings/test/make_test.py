@@ -382,6 +382,99 @@ def make_test(  # noqa: C901
 
                 tester.assertEqual(str(expected), str(executorch_output))
 
+        def test_buffer_and_dlpack_inputs(tester) -> None:
+            exported_program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(exported_program.buffer)
+            expected = inputs[0] + inputs[1]
+
+            # NumPy arrays are viewed through DLPack, or through the buffer
+            # protocol if they are read-only, which DLPack can't express.
+            x = inputs[0].numpy()
+            y = inputs[1].numpy().copy()
+            y.setflags(write=False)
+            executorch_output = executorch_module.forward((x, y))[0]
+            tester.assertTrue(torch.allclose(expected, executorch_output))
+
+            # memoryviews only implement the buffer protocol.
+            executorch_output = executorch_module.forward(
+                (memoryview(x), memoryview(y))
+            )[0]
+            tester.assertTrue(torch.allclose(expected, executorch_output))
+
+        def test_non_contiguous_input(tester) -> None:
+            exported_program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(exported_program.buffer)
+
+            x = torch.arange(8, dtype=torch.float32).reshape(2, 4)[:, ::2]
+            tester.assertFalse(x.is_contiguous())
+            executorch_output = executorch_module.forward((x, inputs[1]))[0]
+            tester.assertTrue(torch.allclose(x + inputs[1], executorch_output))
+
+            # Later calls copy into the same conversion buffer, which must not
+            # keep the values of earlier ones.
+            executorch_output = executorch_module.forward((x * 3, inputs[1]))[0]
+            tester.assertTrue(torch.allclose(x * 3 + inputs[1], executorch_output))
+
+            # Transposed inputs are dense, but not in the dim order that the
+            # method expects, so they are copied as well.
+            y = inputs[1].t().contiguous().t()
+            tester.assertFalse(y.is_contiguous())
+            executorch_output = executorch_module.forward((inputs[0], y))[0]
+            tester.assertTrue(torch.allclose(inputs[0] + y, executorch_output))
+
+        def test_output_views(tester) -> None:
+            exported_program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(exported_program.buffer)
+
+            view = executorch_module.forward(inputs, clone_outputs=False)[0]
+            tester.assertTrue(torch.allclose(inputs[0] + inputs[1], view))
+
+            # The next execution overwrites the contents of the view.
+            executorch_module.forward((inputs[0] * 2, inputs[1]))
+            tester.assertTrue(torch.allclose(inputs[0] * 2 + inputs[1], view))
+
+            # The view keeps the memory of the module alive.
+            del executorch_module
+            tester.assertTrue(torch.allclose(inputs[0] * 2 + inputs[1], view))
+
+        def test_concurrent_execution(tester) -> None:
+            from concurrent.futures import ThreadPoolExecutor
+
+            exported_program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(exported_program.buffer)
+
+            # Executions release the GIL, but must still not overlap.
+            def run(i):
+                return executorch_module.forward((inputs[0] * i, inputs[1]))[0]
+
+            with ThreadPoolExecutor(max_workers=4) as pool:
+                outputs = list(pool.map(run, range(16)))
+            for i, output in enumerate(outputs):
+                tester.assertTrue(torch.allclose(inputs[0] * i + inputs[1], output))
+
+        def test_batch(tester) -> None:
+            exported_program, inputs = create_program(ModuleAdd())
+            executorch_module = load_fn(exported_program.buffer)
+
+            batch = [(inputs[0] * i, inputs[1]) for i in range(8)]
+            outputs = executorch_module.forward_batch(batch, num_threads=3)
+            tester.assertEqual(len(outputs), len(batch))
+            for i, output in enumerate(outputs):
+                tester.assertTrue(torch.allclose(inputs[0] * i + inputs[1], output[0]))
+
+            # A stacked batch gives each sample one element of each tensor, and
+            # stacks the outputs the same way.
+            x = torch.stack([inputs[0] * i for i in range(8)])
+            y = torch.stack([inputs[1]] * 8)
+            output = executorch_module.run_method_batch(
+                "forward", (x, y), stacked=True
+            )[0]
+            tester.assertTrue(torch.allclose(x + y, output))
+
+            tester.assertEqual(executorch_module.forward_batch([]), [])
+            with tester.assertRaises(ValueError):
+                executorch_module.forward_batch((x, y[:4]), stacked=True)
+
         ######### RUN TEST CASES #########
         test_e2e(tester)
         test_multiple_entry(tester)
@@ -394,5 +487,10 @@ def make_test(  # noqa: C901
         test_method_meta(tester)
         test_bad_name(tester)
         test_verification_config(tester)
+        test_buffer_and_dlpack_inputs(tester)
+        test_non_contiguous_input(tester)
+        test_output_views(tester)
+        test_concurrent_execution(tester)
+        test_batch(tester)
 
     return wrapper
@@ -8,14 +8,20 @@
 
 #include <executorch/extension/runner_util/inputs.h>
 
+#include <new>
+#include <utility>
+
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/method_meta.h>
 #include <executorch/runtime/platform/log.h>
 
+using executorch::runtime::DataLoader;
 using executorch::runtime::Error;
+using executorch::runtime::FreeableBuffer;
 using executorch::runtime::Method;
 using executorch::runtime::MethodMeta;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
 using executorch::runtime::Tag;
 using executorch::runtime::TensorInfo;
 
@@ -60,5 +66,126 @@ Result<BufferCleanup> prepare_input_tensors(Method& method) {
   return BufferCleanup({inputs, num_allocated});
 }
 
+Error set_input_buffers(Method& method, Span<const Span<uint8_t>> buffers) {
+  MethodMeta method_meta = method.method_meta();
+  size_t num_inputs = method_meta.num_inputs();
+  ET_CHECK_OR_RETURN_ERROR(
+      buffers.size() == num_inputs,
+      InvalidArgument,
+      "Expected %zu input buffers, got %zu",
+      num_inputs,
+      buffers.size());
+  for (size_t i = 0; i < num_inputs; i++) {
+    auto tag = method_meta.input_tag(i);
+    if (!tag.ok()) {
+      return tag.error();
+    }
+    if (tag.get() != Tag::Tensor) {
+      ET_LOG(Debug, "Skipping non-tensor input %zu", i);
+      continue;
+    }
+    Result<TensorInfo> tensor_meta = method_meta.input_tensor_meta(i);
+    if (!tensor_meta.ok()) {
+      return tensor_meta.error();
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        buffers[i].size() == tensor_meta->nbytes(),
+        InvalidArgument,
+        "Buffer of input %zu has %zu bytes, expected %zu",
+        i,
+        buffers[i].size(),
+        tensor_meta->nbytes());
+    Error err = internal::set_input_data(
+        method, tensor_meta.get(), i, buffers[i].data());
+    if (err != Error::Ok) {
+      ET_LOG(Error, "Failed to set input %zu: 0x%" PRIx32, i, (uint32_t)err);
+      return err;
+    }
+  }
+  return Error::Ok;
+}
+
+Result<LoadedInputs> load_input_tensors(
+    Method& method,
+    Span<DataLoader* const> loaders) {
+  MethodMeta method_meta = method.method_meta();
+  size_t num_inputs = method_meta.num_inputs();
+  ET_CHECK_OR_RETURN_ERROR(
+      loaders.size() == num_inputs,
+      InvalidArgument,
+      "Expected %zu input loaders, got %zu",
+      num_inputs,
+      loaders.size());
+  size_t num_loaded = 0;
+  FreeableBuffer* loaded =
+      (FreeableBuffer*)malloc(num_inputs * sizeof(FreeableBuffer));
+  if (loaded == nullptr && num_inputs > 0) {
+    return Error::MemoryAllocationFailed;
+  }
+  // Frees what was loaded so far when returning an error.
+  auto fail = [&](Error err) -> Result<LoadedInputs> {
+    LoadedInputs cleanup(loaded, num_loaded);
+    return err;
+  };
+  for (size_t i = 0; i < num_inputs; i++) {
+    auto tag = method_meta.input_tag(i);
+    if (!tag.ok()) {
+      return fail(tag.error());
+    }
+    if (tag.get() != Tag::Tensor) {
+      ET_LOG(Debug, "Skipping non-tensor input %zu", i);
+      continue;
+    }
+    Result<TensorInfo> tensor_meta = method_meta.input_tensor_meta(i);
+    if (!tensor_meta.ok()) {
+      return fail(tensor_meta.error());
+    }
+    DataLoader* loader = loaders[i];
+    if (loader == nullptr) {
+      ET_LOG(Error, "Missing loader for input %zu", i);
+      return fail(Error::InvalidArgument);
+    }
+    const size_t nbytes = tensor_meta->nbytes();
+    Result<size_t> size = loader->size();
+    if (!size.ok()) {
+      return fail(size.error());
+    }
+    if (size.get() != nbytes) {
+      ET_LOG(
+          Error,
+          "Data of input %zu has %zu bytes, expected %zu",
+          i,
+          size.get(),
+          nbytes);
+      return fail(Error::InvalidArgument);
+    }
+    Result<FreeableBuffer> data = loader->load(
+        /*offset=*/0,
+        nbytes,
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::External));
+    if (!data.ok()) {
+      ET_LOG(
+          Error,
+          "Failed to load input %zu: 0x%" PRIx32,
+          i,
+          (uint32_t)data.error());
+      return fail(data.error());
+    }
+    // The Method does not write to its inputs through this pointer unless the
+    // model mutates them; see the header.
+    Error err = internal::set_input_data(
+        method, tensor_meta.get(), i, const_cast<void*>(data->data()));
+    if (err != Error::Ok) {
+      ET_LOG(Error, "Failed to set input %zu: 0x%" PRIx32, i, (uint32_t)err);
+      return fail(err);
+    }
+    if (!tensor_meta->is_memory_planned()) {
+      // The input points at the loaded data, so keep it alive.
+      new (&loaded[num_loaded++]) FreeableBuffer(std::move(data.get()));
+    }
+  }
+  return LoadedInputs(loaded, num_loaded);
+}
+
 } // namespace extension
 } // namespace executorch
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <executorch/runtime/core/data_loader.h>
+#include <executorch/runtime/core/freeable_buffer.h>
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/method_meta.h>
@@ -64,6 +66,91 @@ class BufferCleanup final {
 executorch::runtime::Result<BufferCleanup> prepare_input_tensors(
     executorch::runtime::Method& method);
 
+/**
+ * Sets the tensor inputs of the provided Method to caller-owned data, without
+ * copying it where the Method allows.
+ *
+ * Inputs that the Method does not memory-plan, as when the model was exported
+ * with `MemoryPlanningPass(alloc_graph_input=False)`, point directly at their
+ * buffers. Those buffers must stay alive until `method->execute()` returns.
+ * Memory-planned inputs have storage of their own, so their buffers are
+ * copied into it.
+ *
+ * @param[in] method The Method whose inputs to set.
+ * @param[in] buffers One buffer per input of the Method, in order. The buffer
+ *     of a tensor input must hold exactly as many bytes as the input's
+ *     `TensorInfo::nbytes()`. The buffers of non-tensor inputs are ignored.
+ *
+ * @returns Error::Ok on success, non-Ok on failure.
+ */
+executorch::runtime::Error set_input_buffers(
+    executorch::runtime::Method& method,
+    executorch::runtime::Span<const executorch::runtime::Span<uint8_t>>
+        buffers);
+
+/**
+ * RAII helper that frees a set of FreeableBuffers when destroyed. Movable.
+ */
+class LoadedInputs final {
+ public:
+  /**
+   * Takes ownership of `buffers`, which must have been allocated with
+   * `malloc()`, and of the `size` FreeableBuffers constructed in it.
+   */
+  LoadedInputs(executorch::runtime::FreeableBuffer* buffers, size_t size)
+      : buffers_(buffers), size_(size) {}
+
+  /**
+   * Move ctor. Takes ownership of the data previously owned by `rhs`, leaving
+   * `rhs` with an empty list of buffers.
+   */
+  LoadedInputs(LoadedInputs&& rhs) noexcept
+      : buffers_(rhs.buffers_), size_(rhs.size_) {
+    rhs.buffers_ = nullptr;
+    rhs.size_ = 0;
+  }
+
+  ~LoadedInputs() {
+    for (size_t i = 0; i < size_; ++i) {
+      buffers_[i].~FreeableBuffer();
+    }
+    free(buffers_);
+  }
+
+ private:
+  // Delete other rule-of-five methods.
+  LoadedInputs(const LoadedInputs&) = delete;
+  LoadedInputs& operator=(const LoadedInputs&) = delete;
+  LoadedInputs& operator=(LoadedInputs&&) noexcept = delete;
+
+  executorch::runtime::FreeableBuffer* buffers_;
+  size_t size_;
+};
+
+/**
+ * Loads the tensor inputs of the provided Method from data loaders, one per
+ * input, without copying the data where the Method allows.
+ *
+ * Each loader must hold exactly the `TensorInfo::nbytes()` of its input. The
+ * inputs that are not memory-planned point directly at the loaded data: with
+ * an MmapDataLoader, an input file is mapped and its pages are read as the
+ * Method uses them, instead of being copied into a separate buffer. The
+ * Method must then not write to those inputs, since mapped files may be
+ * read-only. Memory-planned inputs are copied into their own storage, and
+ * their loaded data is freed right away.
+ *
+ * @param[in] method The Method whose inputs to set.
+ * @param[in] loaders One loader per input of the Method, in order. The loaders
+ *     of non-tensor inputs are ignored, and may be null.
+ *
+ * @returns On success, an object that owns the loaded data that inputs point
+ *     to. It must remain alive when calling `method->execute()`.
+ * @returns An error on failure.
+ */
+executorch::runtime::Result<LoadedInputs> load_input_tensors(
+    executorch::runtime::Method& method,
+    executorch::runtime::Span<executorch::runtime::DataLoader* const> loaders);
+
 namespace internal {
 /**
  * INTERNAL-ONLY: Creates a Tensor using the provided shape and buffer,
@@ -74,6 +161,16 @@ executorch::runtime::Error fill_and_set_input(
     executorch::runtime::TensorInfo& tensor_meta,
     size_t input_index,
     void* data_ptr);
+
+/**
+ * INTERNAL-ONLY: Creates a Tensor using the provided shape and buffer, and
+ * sets the input at `input_index` to it.
+ */
+executorch::runtime::Error set_input_data(
+    executorch::runtime::Method& method,
+    executorch::runtime::TensorInfo& tensor_meta,
+    size_t input_index,
+    void* data_ptr);
 } // namespace internal
 
 } // namespace extension
@@ -39,6 +39,21 @@ Error fill_and_set_input(
   return method.set_input(t, input_index);
 }
 
+Error set_input_data(
+    Method& method,
+    TensorInfo& tensor_meta,
+    size_t input_index,
+    void* data_ptr) {
+  std::vector<int64_t> sizes;
+  for (auto s : tensor_meta.sizes()) {
+    sizes.push_back(s);
+  }
+  at::Tensor t = at::from_blob(
+      data_ptr, sizes, at::TensorOptions(tensor_meta.scalar_type()));
+
+  return method.set_input(t, input_index);
+}
+
 } // namespace internal
 } // namespace extension
 } // namespace executorch
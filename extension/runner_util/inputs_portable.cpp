@@ -72,6 +72,21 @@ Error fill_and_set_input(
   return method.set_input(t, input_index);
 }
 
+Error set_input_data(
+    Method& method,
+    TensorInfo& tensor_meta,
+    size_t input_index,
+    void* data_ptr) {
+  // As in fill_and_set_input(), the TensorImpl is only read by set_input().
+  TensorImpl impl = TensorImpl(
+      tensor_meta.scalar_type(),
+      /*dim=*/tensor_meta.sizes().size(),
+      const_cast<TensorImpl::SizesType*>(tensor_meta.sizes().data()),
+      data_ptr,
+      const_cast<TensorImpl::DimOrderType*>(tensor_meta.dim_order().data()));
+  return method.set_input(Tensor(&impl), input_index);
+}
+
 } // namespace internal
 } // namespace extension
 } // namespace executorch
@@ -8,6 +8,7 @@
 
 #include <executorch/extension/runner_util/inputs.h>
 
+#include <executorch/extension/data_loader/buffer_data_loader.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/span.h>
@@ -21,8 +22,13 @@ using namespace ::testing;
 using exec_aten::ScalarType;
 using exec_aten::Tensor;
 using executorch::extension::BufferCleanup;
+using executorch::extension::BufferDataLoader;
 using executorch::extension::FileDataLoader;
+using executorch::extension::load_input_tensors;
+using executorch::extension::LoadedInputs;
 using executorch::extension::prepare_input_tensors;
+using executorch::extension::set_input_buffers;
+using executorch::runtime::DataLoader;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::MemoryAllocator;
@@ -100,6 +106,63 @@ TEST_F(InputsTest, Smoke) {
   // the pointers.
 }
 
+TEST_F(InputsTest, SetInputBuffers) {
+  // ModuleAdd computes x + y * alpha for [2, 2] tensors x and y, and a double
+  // alpha whose buffer is ignored.
+  float x[4] = {1.0, 2.0, 3.0, 4.0};
+  float y[4] = {10.0, 20.0, 30.0, 40.0};
+  Span<uint8_t> buffers[3] = {
+      {reinterpret_cast<uint8_t*>(x), sizeof(x)},
+      {reinterpret_cast<uint8_t*>(y), sizeof(y)},
+      {}};
+  ASSERT_EQ(method_->inputs_size(), 3);
+  Error err = set_input_buffers(*method_, {buffers, 3});
+  ASSERT_EQ(err, Error::Ok);
+
+  ASSERT_EQ(method_->execute(), Error::Ok);
+  Tensor output = method_->get_output(0).toTensor();
+  ASSERT_EQ(output.numel(), 4);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(output.const_data_ptr<float>()[i], x[i] + y[i]);
+  }
+}
+
+TEST_F(InputsTest, SetInputBuffersWrongSizeFails) {
+  float x[4] = {};
+  float y[2] = {};
+  Span<uint8_t> buffers[3] = {
+      {reinterpret_cast<uint8_t*>(x), sizeof(x)},
+      {reinterpret_cast<uint8_t*>(y), sizeof(y)},
+      {}};
+  EXPECT_EQ(set_input_buffers(*method_, {buffers, 3}), Error::InvalidArgument);
+  // One buffer per input is required.
+  EXPECT_EQ(set_input_buffers(*method_, {buffers, 2}), Error::InvalidArgument);
+}
+
+TEST_F(InputsTest, LoadInputTensors) {
+  const float x[4] = {1.0, 2.0, 3.0, 4.0};
+  const float y[4] = {5.0, 6.0, 7.0, 8.0};
+  BufferDataLoader x_loader(x, sizeof(x));
+  BufferDataLoader y_loader(y, sizeof(y));
+  DataLoader* loaders[3] = {&x_loader, &y_loader, nullptr};
+  Result<LoadedInputs> inputs = load_input_tensors(*method_, {loaders, 3});
+  ASSERT_EQ(inputs.error(), Error::Ok);
+
+  ASSERT_EQ(method_->execute(), Error::Ok);
+  Tensor output = method_->get_output(0).toTensor();
+  ASSERT_EQ(output.numel(), 4);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(output.const_data_ptr<float>()[i], x[i] + y[i]);
+  }
+
+  // A loader that doesn't hold exactly one input's worth of data fails.
+  BufferDataLoader short_loader(x, sizeof(x) - 1);
+  loaders[1] = &short_loader;
+  EXPECT_EQ(
+      load_input_tensors(*method_, {loaders, 3}).error(),
+      Error::InvalidArgument);
+}
+
 TEST(BufferCleanupTest, Smoke) {
   // Returns the size of the buffer at index `i`.
   auto test_buffer_size = [](size_t i) {
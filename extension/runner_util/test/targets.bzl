@@ -24,6 +24,7 @@ def define_common_targets(is_fbcode = False):
                     "//executorch/runtime/executor/test:managed_memory_manager",
                     "//executorch/runtime/executor:program",
                     "//executorch/kernels/portable:generated_lib",
+                    "//executorch/extension/data_loader:buffer_data_loader",
                     "//executorch/extension/data_loader:file_data_loader",
                 ],
                 env = {
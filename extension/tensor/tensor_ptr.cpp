@@ -52,6 +52,45 @@ struct Storage final {
   }
 };
 #endif // USE_ATEN_LIB
+
+std::vector<exec_aten::DimOrderType> dim_order_of(
+    const exec_aten::Tensor& tensor) {
+  std::vector<exec_aten::DimOrderType> dim_order(tensor.dim());
+  ET_CHECK_MSG(
+      runtime::get_dim_order(tensor, dim_order.data(), dim_order.size()) ==
+          runtime::Error::Ok,
+      "Failed to get the dim order of the tensor.");
+  return dim_order;
+}
+
+exec_aten::TensorShapeDynamism get_shape_dynamism(
+    const exec_aten::Tensor& tensor) {
+#ifndef USE_ATEN_LIB
+  return tensor.shape_dynamism();
+#else // USE_ATEN_LIB
+  (void)tensor;
+  return exec_aten::TensorShapeDynamism::DYNAMIC_BOUND;
+#endif // USE_ATEN_LIB
+}
+
+// Makes a TensorPtr over the data of `tensor` starting at `byte_offset`,
+// which keeps `tensor` alive.
+TensorPtr make_view(
+    const TensorPtr& tensor,
+    std::vector<exec_aten::SizesType> sizes,
+    std::vector<exec_aten::DimOrderType> dim_order,
+    size_t byte_offset) {
+  auto data = static_cast<uint8_t*>(tensor->mutable_data_ptr());
+  return make_tensor_ptr(
+      std::move(sizes),
+      data == nullptr ? nullptr : data + byte_offset,
+      std::move(dim_order),
+      {},
+      tensor->scalar_type(),
+      get_shape_dynamism(*tensor),
+      // The view owns a reference to the original, which owns the data.
+      [owner = tensor](void*) {});
+}
 } // namespace
 
 TensorPtr make_tensor_ptr(
@@ -183,6 +222,107 @@ TensorPtr clone_tensor_ptr(const exec_aten::Tensor& tensor) {
             dynamism);
 }
 
+TensorPtr reshape_tensor_ptr(
+    const TensorPtr& tensor,
+    std::vector<exec_aten::SizesType> sizes) {
+  const auto dim_order = dim_order_of(*tensor);
+  for (size_t i = 0; i < dim_order.size(); ++i) {
+    ET_CHECK_MSG(
+        dim_order[i] == i,
+        "Only tensors with the default dim order can be reshaped.");
+  }
+  ssize_t inferred_dim = -1;
+  ssize_t numel = 1;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] == -1) {
+      ET_CHECK_MSG(inferred_dim == -1, "Only one size can be inferred.");
+      inferred_dim = i;
+    } else {
+      ET_CHECK_MSG(sizes[i] >= 0, "Invalid size %zd.", ssize_t(sizes[i]));
+      numel *= sizes[i];
+    }
+  }
+  if (inferred_dim >= 0) {
+    ET_CHECK_MSG(
+        numel > 0 && tensor->numel() % numel == 0,
+        "Can't infer a size to view %zd elements.",
+        ssize_t(tensor->numel()));
+    sizes[inferred_dim] = tensor->numel() / numel;
+    numel = tensor->numel();
+  }
+  ET_CHECK_MSG(
+      numel == tensor->numel(),
+      "Can't view %zd elements with sizes of %zd elements.",
+      ssize_t(tensor->numel()),
+      numel);
+  return make_view(tensor, std::move(sizes), {}, 0);
+}
+
+TensorPtr narrow_tensor_ptr(
+    const TensorPtr& tensor,
+    size_t dim,
+    exec_aten::SizesType start,
+    exec_aten::SizesType length) {
+  ET_CHECK_MSG(dim < size_t(tensor->dim()), "Invalid dimension %zu.", dim);
+  ET_CHECK_MSG(
+      start >= 0 && length >= 0 && start + length <= tensor->size(dim),
+      "Range [%zd, %zd) is out of bounds for size %zd.",
+      ssize_t(start),
+      ssize_t(start + length),
+      ssize_t(tensor->size(dim)));
+  auto dim_order = dim_order_of(*tensor);
+  // Dimensions before `dim` in the dim order have larger strides, so if any
+  // of them has more than one index, the view would skip over memory.
+  for (const auto outer_dim : dim_order) {
+    if (outer_dim == dim) {
+      break;
+    }
+    ET_CHECK_MSG(
+        tensor->size(outer_dim) == 1 || length == tensor->size(dim),
+        "Dimension %zu can't be narrowed without copying, since dimension %zu "
+        "is outside of it and has size %zd.",
+        dim,
+        size_t(outer_dim),
+        ssize_t(tensor->size(outer_dim)));
+  }
+  std::vector<exec_aten::SizesType> sizes(
+      tensor->sizes().begin(), tensor->sizes().end());
+  sizes[dim] = length;
+  const size_t byte_offset =
+      size_t(start) * tensor->strides()[dim] * tensor->element_size();
+  return make_view(tensor, std::move(sizes), std::move(dim_order), byte_offset);
+}
+
+TensorPtr permute_tensor_ptr(
+    const TensorPtr& tensor,
+    const std::vector<size_t>& dims) {
+  const size_t dim = tensor->dim();
+  ET_CHECK_MSG(
+      dims.size() == dim,
+      "Permutation has %zu dimensions, but the tensor has %zu.",
+      dims.size(),
+      dim);
+  // The position of each original dimension in the view.
+  std::vector<exec_aten::DimOrderType> inverse(dim, dim);
+  for (size_t i = 0; i < dim; ++i) {
+    ET_CHECK_MSG(
+        dims[i] < dim && inverse[dims[i]] == dim,
+        "Invalid permutation of %zu dimensions.",
+        dim);
+    inverse[dims[i]] = i;
+  }
+  std::vector<exec_aten::SizesType> sizes(dim);
+  for (size_t i = 0; i < dim; ++i) {
+    sizes[i] = tensor->size(dims[i]);
+  }
+  // Keep the dimensions in the same memory order, under their new indices.
+  auto dim_order = dim_order_of(*tensor);
+  for (auto& d : dim_order) {
+    d = inverse[d];
+  }
+  return make_view(tensor, std::move(sizes), std::move(dim_order), 0);
+}
+
 runtime::Error resize_tensor_ptr(
     TensorPtr& tensor,
     const std::vector<exec_aten::SizesType>& sizes) {
@@ -362,6 +362,79 @@ inline TensorPtr clone_tensor_ptr(const TensorPtr& tensor) {
   return clone_tensor_ptr(*tensor);
 }
 
+/**
+ * Creates a TensorPtr that views the data of the given TensorPtr with new
+ * sizes, without copying it. The view keeps the original TensorPtr alive.
+ *
+ * The tensor must have the default, contiguous dim order, since otherwise
+ * reshaping would reorder its elements.
+ *
+ * @param tensor The TensorPtr to view.
+ * @param sizes The sizes of the view, which must have the same number of
+ * elements as the tensor. At most one size may be -1, to infer it from the
+ * others.
+ * @return A TensorPtr that shares the data of the original.
+ */
+TensorPtr reshape_tensor_ptr(
+    const TensorPtr& tensor,
+    std::vector<executorch::aten::SizesType> sizes);
+
+/**
+ * Creates a TensorPtr that views the elements `[start, start + length)` of
+ * dimension `dim` of the given TensorPtr, without copying them. The view
+ * keeps the original TensorPtr alive.
+ *
+ * Tensors in ExecuTorch can't have arbitrary strides, so the elements of the
+ * view must be contiguous in memory: all dimensions outside of `dim` in the
+ * dim order, e.g. the batch dimensions of a contiguous tensor, must have
+ * size 1, unless `dim` is the outermost dimension.
+ *
+ * @param tensor The TensorPtr to view.
+ * @param dim The dimension to narrow.
+ * @param start The first index of the view in `dim`.
+ * @param length The number of indices of the view in `dim`.
+ * @return A TensorPtr that shares the data of the original.
+ */
+TensorPtr narrow_tensor_ptr(
+    const TensorPtr& tensor,
+    size_t dim,
+    executorch::aten::SizesType start,
+    executorch::aten::SizesType length);
+
+/**
+ * Creates a TensorPtr that views the elements `[start, end)` of dimension
+ * `dim` of the given TensorPtr, without copying them. Equivalent to
+ * `narrow_tensor_ptr(tensor, dim, start, end - start)`.
+ *
+ * @param tensor The TensorPtr to view.
+ * @param dim The dimension to slice.
+ * @param start The first index of the view in `dim`.
+ * @param end The index past the last index of the view in `dim`.
+ * @return A TensorPtr that shares the data of the original.
+ */
+inline TensorPtr slice_tensor_ptr(
+    const TensorPtr& tensor,
+    size_t dim,
+    executorch::aten::SizesType start,
+    executorch::aten::SizesType end) {
+  return narrow_tensor_ptr(tensor, dim, start, end - start);
+}
+
+/**
+ * Creates a TensorPtr that views the given TensorPtr with its dimensions
+ * reordered, without copying its data. Dimension `i` of the view is
+ * dimension `dims[i]` of the original, and the view's dim order is chosen so
+ * that every element stays in place. The view keeps the original TensorPtr
+ * alive.
+ *
+ * @param tensor The TensorPtr to view.
+ * @param dims A permutation of the tensor's dimensions.
+ * @return A TensorPtr that shares the data of the original.
+ */
+TensorPtr permute_tensor_ptr(
+    const TensorPtr& tensor,
+    const std::vector<size_t>& dims);
+
 /**
  * Resizes the Tensor managed by the provided TensorPtr to the new sizes.
  *
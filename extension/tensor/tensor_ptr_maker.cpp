@@ -113,6 +113,26 @@ TensorPtr empty_strided(
       dynamism);
 }
 
+TensorPtr empty_with_allocator(
+    runtime::DeviceAllocator& allocator,
+    std::vector<exec_aten::SizesType> sizes,
+    exec_aten::ScalarType type,
+    exec_aten::TensorShapeDynamism dynamism) {
+  const auto nbytes = exec_aten::compute_numel(sizes.data(), sizes.size()) *
+      exec_aten::elementSize(type);
+  void* data = allocator.allocate(nbytes);
+  ET_CHECK_MSG(
+      data != nullptr || nbytes == 0,
+      "Failed to allocate %zu bytes for the tensor",
+      static_cast<size_t>(nbytes));
+  return make_tensor_ptr(
+      std::move(sizes),
+      data,
+      type,
+      dynamism,
+      [allocator = &allocator](void* ptr) { allocator->free(ptr); });
+}
+
 TensorPtr full_strided(
     std::vector<exec_aten::SizesType> sizes,
     std::vector<exec_aten::StridesType> strides,
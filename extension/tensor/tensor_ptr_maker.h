@@ -9,6 +9,7 @@
 #pragma once
 
 #include <executorch/extension/tensor/tensor_ptr.h>
+#include <executorch/runtime/core/device_allocator.h>
 
 namespace executorch {
 namespace extension {
@@ -349,6 +350,28 @@ inline TensorPtr empty(
   return empty_strided(std::move(sizes), {}, type, dynamism);
 }
 
+/**
+ * Creates an empty TensorPtr with the specified sizes and properties, whose
+ * data is allocated with a DeviceAllocator, e.g. one that a backend registered
+ * so that the tensor can be passed to its delegates without copies.
+ *
+ * This function allocates memory for the tensor elements but does not
+ * initialize them with any specific values. The memory is returned to the
+ * allocator when the tensor is destroyed.
+ *
+ * @param allocator The allocator of the tensor data. Must outlive the tensor.
+ * @param sizes A vector specifying the size of each dimension.
+ * @param type The scalar type of the tensor elements.
+ * @param dynamism Specifies whether the tensor's shape is static or dynamic.
+ * @return A TensorPtr instance managing the newly created Tensor.
+ */
+TensorPtr empty_with_allocator(
+    executorch::runtime::DeviceAllocator& allocator,
+    std::vector<executorch::aten::SizesType> sizes,
+    executorch::aten::ScalarType type = executorch::aten::ScalarType::Float,
+    executorch::aten::TensorShapeDynamism dynamism =
+        executorch::aten::TensorShapeDynamism::DYNAMIC_BOUND);
+
 /**
  * Creates a TensorPtr filled with the specified value.
  *
@@ -205,6 +205,42 @@ TEST_F(TensorPtrMakerTest, CreateEmpty) {
   EXPECT_EQ(tensor4->scalar_type(), exec_aten::ScalarType::Double);
 }
 
+TEST_F(TensorPtrMakerTest, CreateEmptyWithAllocator) {
+  class CountingAllocator : public DeviceAllocator {
+   public:
+    void* allocate(size_t size, size_t alignment) override {
+      EXPECT_EQ(alignment, kDefaultAlignment);
+      ++allocations;
+      return new uint8_t[size];
+    }
+
+    void free(void* ptr) override {
+      ++frees;
+      delete[] static_cast<uint8_t*>(ptr);
+    }
+
+    int allocations = 0;
+    int frees = 0;
+  };
+  CountingAllocator allocator;
+
+  {
+    auto tensor =
+        empty_with_allocator(allocator, {4, 5}, exec_aten::ScalarType::Int);
+    EXPECT_EQ(tensor->dim(), 2);
+    EXPECT_EQ(tensor->size(0), 4);
+    EXPECT_EQ(tensor->size(1), 5);
+    EXPECT_EQ(tensor->scalar_type(), exec_aten::ScalarType::Int);
+    EXPECT_EQ(allocator.allocations, 1);
+    EXPECT_EQ(allocator.frees, 0);
+
+    // The data is writable from the host.
+    tensor->mutable_data_ptr<int32_t>()[19] = 42;
+    EXPECT_EQ(tensor->const_data_ptr<int32_t>()[19], 42);
+  }
+  EXPECT_EQ(allocator.frees, 1);
+}
+
 TEST_F(TensorPtrMakerTest, CreateFull) {
   auto tensor = full({4, 5}, 7);
   EXPECT_EQ(tensor->dim(), 2);
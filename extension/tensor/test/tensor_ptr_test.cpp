@@ -811,3 +811,95 @@ TEST_F(TensorPtrTest, TensorDataCastingInvalidCast) {
       },
       "");
 }
+
+TEST_F(TensorPtrTest, ReshapeTensorPtrSharesData) {
+  auto tensor = make_tensor_ptr({2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  auto view = reshape_tensor_ptr(tensor, {3, -1});
+
+  EXPECT_EQ(view->dim(), 2);
+  EXPECT_EQ(view->size(0), 3);
+  EXPECT_EQ(view->size(1), 2);
+  EXPECT_EQ(view->strides()[0], 2);
+  EXPECT_EQ(view->strides()[1], 1);
+  EXPECT_EQ(view->const_data_ptr(), tensor->const_data_ptr());
+
+  ET_EXPECT_DEATH({ auto _ = reshape_tensor_ptr(tensor, {4, 2}); }, "");
+  ET_EXPECT_DEATH({ auto _ = reshape_tensor_ptr(tensor, {-1, -1}); }, "");
+}
+
+TEST_F(TensorPtrTest, TensorPtrViewKeepsOwnerAlive) {
+  bool deleted = false;
+  float data[4] = {1.f, 2.f, 3.f, 4.f};
+  auto tensor = make_tensor_ptr(
+      {4},
+      data,
+      exec_aten::ScalarType::Float,
+      exec_aten::TensorShapeDynamism::STATIC,
+      [&deleted](void*) { deleted = true; });
+  auto view = narrow_tensor_ptr(tensor, 0, 1, 2);
+  tensor.reset();
+
+  EXPECT_FALSE(deleted);
+  EXPECT_EQ(view->const_data_ptr<float>()[0], 2.f);
+  view.reset();
+  EXPECT_TRUE(deleted);
+}
+
+TEST_F(TensorPtrTest, NarrowTensorPtrOuterDimension) {
+  auto tensor = make_tensor_ptr({3, 2}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  auto view = narrow_tensor_ptr(tensor, 0, 1, 2);
+
+  EXPECT_EQ(view->size(0), 2);
+  EXPECT_EQ(view->size(1), 2);
+  EXPECT_EQ(view->const_data_ptr<float>(), tensor->const_data_ptr<float>() + 2);
+  EXPECT_EQ(view->const_data_ptr<float>()[0], 3.f);
+  EXPECT_EQ(view->const_data_ptr<float>()[3], 6.f);
+
+  auto slice = slice_tensor_ptr(tensor, 0, 2, 3);
+  EXPECT_EQ(slice->size(0), 1);
+  EXPECT_EQ(slice->const_data_ptr<float>()[0], 5.f);
+
+  ET_EXPECT_DEATH({ auto _ = narrow_tensor_ptr(tensor, 0, 2, 2); }, "");
+  ET_EXPECT_DEATH({ auto _ = narrow_tensor_ptr(tensor, 2, 0, 1); }, "");
+}
+
+TEST_F(TensorPtrTest, NarrowTensorPtrInnerDimension) {
+  auto tensor = make_tensor_ptr({1, 4}, {1.f, 2.f, 3.f, 4.f});
+  // The outer dimension has size 1, so the inner one can be narrowed.
+  auto view = narrow_tensor_ptr(tensor, 1, 1, 2);
+  EXPECT_EQ(view->size(0), 1);
+  EXPECT_EQ(view->size(1), 2);
+  EXPECT_EQ(view->const_data_ptr<float>()[0], 2.f);
+  EXPECT_EQ(view->const_data_ptr<float>()[1], 3.f);
+
+  // Narrowing the columns of a matrix would need strides that skip memory.
+  auto matrix = make_tensor_ptr({2, 2}, {1.f, 2.f, 3.f, 4.f});
+  ET_EXPECT_DEATH({ auto _ = narrow_tensor_ptr(matrix, 1, 0, 1); }, "");
+  // Unless the whole dimension is kept.
+  EXPECT_EQ(narrow_tensor_ptr(matrix, 1, 0, 2)->numel(), 4);
+}
+
+TEST_F(TensorPtrTest, PermuteTensorPtr) {
+  auto tensor = make_tensor_ptr({2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f});
+  auto view = permute_tensor_ptr(tensor, {1, 0});
+
+  EXPECT_EQ(view->size(0), 3);
+  EXPECT_EQ(view->size(1), 2);
+  // Elements stay in place, so the strides are permuted too.
+  EXPECT_EQ(view->strides()[0], 1);
+  EXPECT_EQ(view->strides()[1], 3);
+  EXPECT_EQ(view->const_data_ptr(), tensor->const_data_ptr());
+#ifndef USE_ATEN_LIB
+  EXPECT_EQ(view->dim_order()[0], 1);
+  EXPECT_EQ(view->dim_order()[1], 0);
+#endif // USE_ATEN_LIB
+
+  // Permuting back gives the original layout.
+  auto original = permute_tensor_ptr(view, {1, 0});
+  EXPECT_EQ(original->size(0), 2);
+  EXPECT_EQ(original->strides()[0], 3);
+  EXPECT_EQ(original->strides()[1], 1);
+
+  ET_EXPECT_DEATH({ auto _ = permute_tensor_ptr(tensor, {0, 0}); }, "");
+  ET_EXPECT_DEATH({ auto _ = permute_tensor_ptr(tensor, {0}); }, "");
+}
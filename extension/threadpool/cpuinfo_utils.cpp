@@ -26,8 +26,8 @@ namespace executorch::extension::cpuinfo {
 #define RIVISION_MASK UINT32_C(0xFFFFFFF0)
 
 namespace {
-bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
-  switch (uarch_info->uarch) {
+bool is_non_performant_uarch(enum cpuinfo_uarch uarch, uint32_t midr) {
+  switch (uarch) {
     case cpuinfo_uarch_cortex_a55:
     case cpuinfo_uarch_cortex_a53:
     case cpuinfo_uarch_cortex_a510:
@@ -43,13 +43,35 @@ bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
     // A520 is not yet updated in cpuinfo
     // Hence decode it separately.
 #if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
-  if ((uarch_info->midr & RIVISION_MASK) == CPUINFO_ARM_MIDR_CORTEX_A520) {
+  if ((midr & RIVISION_MASK) == CPUINFO_ARM_MIDR_CORTEX_A520) {
     return true;
   }
+#else
+  (void)midr;
 #endif
   return false;
 }
 
+bool is_non_performant_core(const struct cpuinfo_uarch_info* uarch_info) {
+#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+  return is_non_performant_uarch(uarch_info->uarch, uarch_info->midr);
+#else
+  return is_non_performant_uarch(uarch_info->uarch, 0);
+#endif
+}
+
+bool is_non_performant_midr(uint32_t midr) {
+  switch (midr & RIVISION_MASK) {
+    case CPUINFO_ARM_MIDR_CORTEX_A520:
+    case CPUINFO_ARM_MIDR_CORTEX_A53:
+    case CPUINFO_ARM_MIDR_CORTEX_A55:
+    case CPUINFO_ARM_MIDR_CORTEX_A57:
+      return true;
+    default:
+      return false;
+  }
+}
+
 std::vector<uint32_t>* get_static_cpu_midr_vector() {
   static std::vector<uint32_t> cpu_midrs;
   return &cpu_midrs;
@@ -104,33 +126,65 @@ bool populate_available_cpu_mids() {
   return true;
 }
 
-uint32_t _get_num_performant_cores() {
+// Returns the MIDRs of the processors, read from sysfs the first time, or an
+// empty vector if they can't be read.
+std::vector<uint32_t>* get_cpu_midrs() {
   // @lint-ignore CLANGTIDY facebook-hte-std::once_flag
   static std::once_flag flag;
   // @lint-ignore CLANGTIDY facebook-hte-std::call_once
   std::call_once(flag, []() { populate_available_cpu_mids(); });
-  std::vector<uint32_t>* cpu_midrs = get_static_cpu_midr_vector();
+  return get_static_cpu_midr_vector();
+}
+
+uint32_t _get_num_performant_cores() {
+  std::vector<uint32_t>* cpu_midrs = get_cpu_midrs();
   uint32_t num_possible_cores = cpuinfo_get_processors_count();
   if (num_possible_cores != cpu_midrs->size()) {
     ET_LOG(Info, "CPU info and manual query on # of cpus dont match.");
     return 0;
   }
   for (int32_t i = 0; i < cpu_midrs->size(); ++i) {
-    uint32_t masked_midr = (*cpu_midrs)[i] & RIVISION_MASK;
-    switch (masked_midr) {
-      case CPUINFO_ARM_MIDR_CORTEX_A520:
-      case CPUINFO_ARM_MIDR_CORTEX_A53:
-      case CPUINFO_ARM_MIDR_CORTEX_A55:
-      case CPUINFO_ARM_MIDR_CORTEX_A57:
-        num_possible_cores--;
-        break;
-      default:
-        break;
+    if (is_non_performant_midr((*cpu_midrs)[i])) {
+      num_possible_cores--;
     }
   }
   return num_possible_cores;
 }
 
+// Returns the OS IDs of the processors that are (or are not) performant.
+std::vector<uint32_t> get_core_ids(bool performant) {
+  ET_CHECK_MSG(cpuinfo_initialize(), "cpuinfo cannot be initialized.");
+  const uint32_t num_processors = cpuinfo_get_processors_count();
+  const bool use_uarch = cpuinfo_get_uarchs_count() > 1;
+  // As in get_num_performant_cores(), fall back to the MIDRs when all cores
+  // are reported to have the same microarchitecture.
+  std::vector<uint32_t>* cpu_midrs = use_uarch ? nullptr : get_cpu_midrs();
+
+  std::vector<uint32_t> core_ids;
+  for (uint32_t i = 0; i < num_processors; ++i) {
+    const struct cpuinfo_processor* processor = cpuinfo_get_processor(i);
+    bool non_performant = false;
+    if (use_uarch) {
+#if CPUINFO_ARCH_ARM || CPUINFO_ARCH_ARM64
+      non_performant = is_non_performant_uarch(
+          processor->core->uarch, processor->core->midr);
+#else
+      non_performant = is_non_performant_uarch(processor->core->uarch, 0);
+#endif
+    } else if (cpu_midrs->size() == num_processors) {
+      non_performant = is_non_performant_midr((*cpu_midrs)[i]);
+    }
+    if (non_performant != performant) {
+#if defined(__linux__)
+      core_ids.push_back(static_cast<uint32_t>(processor->linux_id));
+#else
+      core_ids.push_back(i);
+#endif
+    }
+  }
+  return core_ids;
+}
+
 } // namespace
 
 uint32_t get_num_performant_cores() {
@@ -170,4 +224,12 @@ uint32_t get_num_performant_cores() {
   }
 }
 
+std::vector<uint32_t> get_performant_core_ids() {
+  return get_core_ids(/*performant=*/true);
+}
+
+std::vector<uint32_t> get_efficient_core_ids() {
+  return get_core_ids(/*performant=*/false);
+}
+
 } // namespace executorch::extension::cpuinfo
@@ -8,12 +8,29 @@
 
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include <cpuinfo.h>
 
 namespace executorch::extension::cpuinfo {
 
 uint32_t get_num_performant_cores();
 
+/**
+ * Returns the IDs, as numbered by the OS, of the processors on the big cores;
+ * e.g. to pass to the ThreadPool constructor for latency-critical models. If
+ * the cores can't be told apart, returns all processors.
+ */
+std::vector<uint32_t> get_performant_core_ids();
+
+/**
+ * Returns the IDs, as numbered by the OS, of the processors on the little
+ * cores; e.g. to pass to the ThreadPool constructor for background models.
+ * Empty if there are none, or if the cores can't be told apart.
+ */
+std::vector<uint32_t> get_efficient_core_ids();
+
 } // namespace executorch::extension::cpuinfo
 
 namespace torch::executorch::cpuinfo { // DEPRECATED
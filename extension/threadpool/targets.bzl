@@ -16,6 +16,7 @@ def define_common_targets():
     _THREADPOOL_HEADERS = [
         "threadpool.h",
         "threadpool_guard.h",
+        "threadpool_parallel_runner.h",
     ] + (["fb/threadpool_use_n_threads.h"] if not runtime.is_oss else [])
 
     runtime.cxx_library(
@@ -28,6 +29,7 @@ def define_common_targets():
         exported_deps = [
             third_party_dep("pthreadpool"),
             third_party_dep("cpuinfo"),
+            "//executorch/runtime/executor:parallel_runner",
         ],
         exported_preprocessor_flags = [
             "-DET_USE_THREADPOOL",
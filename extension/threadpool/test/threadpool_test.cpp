@@ -8,11 +8,18 @@
 
 #include <executorch/extension/threadpool/threadpool.h>
 
+#include <atomic>
 #include <mutex>
 #include <numeric>
 #include <random>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 #include <executorch/extension/threadpool/threadpool_guard.h>
+#include <executorch/extension/threadpool/threadpool_parallel_runner.h>
 
 #include <gtest/gtest.h>
 
@@ -192,3 +199,104 @@ TEST(TestNoThreadPoolGuard, TestRunWithGuard) {
   }
   ASSERT_EQ(inner, 6);
 }
+
+TEST(ThreadPoolParallelRunnerTest, RunsEveryTaskOnce) {
+  ::executorch::extension::threadpool::ThreadPoolParallelRunner runner;
+  std::vector<int32_t> counts(37, 0);
+
+  runner.run(
+      [](void* context, size_t task_index) {
+        (*static_cast<std::vector<int32_t>*>(context))[task_index] += 1;
+      },
+      &counts,
+      counts.size());
+
+  EXPECT_EQ(counts, std::vector<int32_t>(counts.size(), 1));
+}
+
+TEST(ThreadPoolGuardTest, SelectsThreadPool) {
+  using ::executorch::extension::threadpool::get_threadpool;
+  using ::executorch::extension::threadpool::ThreadPool;
+  using ::executorch::extension::threadpool::ThreadPoolGuard;
+
+  ThreadPool* const global = get_threadpool();
+  ThreadPool outer(2);
+  ThreadPool inner(3);
+  {
+    ThreadPoolGuard outer_guard(&outer);
+    EXPECT_EQ(get_threadpool(), &outer);
+    EXPECT_EQ(ThreadPoolGuard::current(), &outer);
+    {
+      ThreadPoolGuard inner_guard(&inner);
+      EXPECT_EQ(get_threadpool(), &inner);
+      EXPECT_EQ(get_threadpool()->get_thread_count(), 3);
+    }
+    EXPECT_EQ(get_threadpool(), &outer);
+
+    // Other threads are not affected.
+    ThreadPool* other_thread_threadpool = nullptr;
+    std::thread([&]() {
+      other_thread_threadpool = get_threadpool();
+    }).join();
+    EXPECT_EQ(other_thread_threadpool, global);
+  }
+  EXPECT_EQ(get_threadpool(), global);
+  EXPECT_EQ(ThreadPoolGuard::current(), nullptr);
+}
+
+TEST(ThreadPoolGuardTest, MakeThreadPoolScope) {
+  using ::executorch::extension::threadpool::get_threadpool;
+  using ::executorch::extension::threadpool::make_threadpool_scope;
+  using ::executorch::extension::threadpool::ThreadPool;
+
+  ThreadPool* const global = get_threadpool();
+  ThreadPool threadpool(2);
+  auto scope_factory = make_threadpool_scope(&threadpool);
+  {
+    auto scope = scope_factory();
+    EXPECT_EQ(get_threadpool(), &threadpool);
+  }
+  EXPECT_EQ(get_threadpool(), global);
+}
+
+#if defined(__linux__)
+TEST(ThreadPoolTest, CoreIdsRestrictThreads) {
+  using ::executorch::extension::threadpool::ThreadPool;
+  using ::executorch::extension::threadpool::ThreadPoolGuard;
+
+  cpu_set_t original;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(original), &original), 0);
+  int first_cpu = 0;
+  while (!CPU_ISSET(first_cpu, &original)) {
+    first_cpu++;
+  }
+
+  ThreadPool threadpool(2, {static_cast<uint32_t>(first_cpu)});
+  EXPECT_EQ(threadpool.get_thread_count(), 2);
+  EXPECT_EQ(
+      threadpool.core_ids(),
+      std::vector<uint32_t>{static_cast<uint32_t>(first_cpu)});
+
+  // Creating the pool leaves the affinity of the calling thread alone.
+  cpu_set_t current;
+  ASSERT_EQ(sched_getaffinity(0, sizeof(current), &current), 0);
+  EXPECT_TRUE(CPU_EQUAL(&current, &original));
+
+  std::atomic<int32_t> num_off_core{0};
+  {
+    ThreadPoolGuard guard(&threadpool);
+    threadpool.run(
+        [&](size_t) {
+          if (sched_getcpu() != first_cpu) {
+            num_off_core++;
+          }
+        },
+        16);
+  }
+  EXPECT_EQ(num_off_core, 0);
+
+  // The guard restores the affinity of the calling thread.
+  ASSERT_EQ(sched_getaffinity(0, sizeof(current), &current), 0);
+  EXPECT_TRUE(CPU_EQUAL(&current, &original));
+}
+#endif // defined(__linux__)
@@ -10,7 +10,13 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cinttypes>
 #include <memory>
+#include <thread>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 #include <executorch/extension/threadpool/threadpool_guard.h>
 #include <executorch/runtime/platform/assert.h>
@@ -34,8 +40,98 @@ void child_atfork() {
 } // namespace
 #endif
 
-ThreadPool::ThreadPool(size_t thread_count)
-    : threadpool_(pthreadpool_create(thread_count), pthreadpool_destroy) {}
+namespace {
+
+#if defined(__linux__)
+// The affinity of the process when it first used a threadpool, which threads
+// go back to when they leave a threadpool with core IDs.
+const cpu_set_t& get_default_affinity() {
+  static const cpu_set_t default_affinity = []() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        CPU_SET(cpu, &set);
+      }
+    }
+    return set;
+  }();
+  return default_affinity;
+}
+#endif
+
+// The threadpool selected by the innermost ThreadPoolGuard on this thread.
+thread_local ThreadPool* current_threadpool = nullptr;
+// The core IDs that the innermost guard restricted this thread to, if any.
+thread_local const std::vector<uint32_t>* current_core_ids = nullptr;
+
+} // namespace
+
+bool set_thread_affinity(const std::vector<uint32_t>& core_ids) {
+#if defined(__linux__)
+  cpu_set_t set = get_default_affinity();
+  if (!core_ids.empty()) {
+    CPU_ZERO(&set);
+    for (const uint32_t core_id : core_ids) {
+      if (core_id >= CPU_SETSIZE) {
+        ET_LOG(Error, "Core ID %" PRIu32 " out of range", core_id);
+        return false;
+      }
+      CPU_SET(core_id, &set);
+    }
+  }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    ET_LOG(Error, "Failed to set the affinity of the calling thread");
+    return false;
+  }
+  return true;
+#else // !defined(__linux__)
+  return core_ids.empty();
+#endif // !defined(__linux__)
+}
+
+ThreadPool::ThreadPool(size_t thread_count, std::vector<uint32_t> core_ids)
+    : threadpool_(
+          pthreadpool_create(
+              thread_count == 0 ? core_ids.size() : thread_count),
+          pthreadpool_destroy),
+      core_ids_(std::move(core_ids)) {
+  if (core_ids_.empty() || !threadpool_) {
+    return;
+  }
+  // pthreadpool has no affinity API, so run one task per thread that sets the
+  // thread's affinity. None of the tasks finishes until all have started,
+  // which guarantees that each runs on a different thread.
+  const size_t num_threads = pthreadpool_get_threads_count(threadpool_.get());
+  struct Context final {
+    const std::vector<uint32_t>& core_ids;
+    const size_t num_threads;
+    std::atomic<size_t> num_started;
+    std::atomic<bool> failed;
+  } context{core_ids_, num_threads, {0}, {false}};
+  pthreadpool_parallelize_1d(
+      threadpool_.get(),
+      [](void* const context, const size_t /*item*/) {
+        auto* ctx = reinterpret_cast<Context*>(context);
+        if (!set_thread_affinity(ctx->core_ids)) {
+          ctx->failed = true;
+        }
+        ctx->num_started++;
+        while (ctx->num_started.load() < ctx->num_threads) {
+          std::this_thread::yield();
+        }
+      },
+      &context,
+      num_threads,
+      0u);
+  // The calling thread took part, so it has to get its affinity back.
+  set_thread_affinity(
+      current_core_ids != nullptr ? *current_core_ids
+                                  : std::vector<uint32_t>());
+  if (context.failed) {
+    ET_LOG(Error, "Failed to restrict the threadpool to the given cores");
+  }
+}
 
 size_t ThreadPool::get_thread_count() const {
   std::lock_guard<std::mutex> lock{mutex_};
@@ -95,7 +191,33 @@ void ThreadPool::run(
 
 // get_threadpool is not thread safe due to leak_corrupted_threadpool
 // Make this part threadsafe: TODO(kimishpatel)
+ThreadPoolGuard::ThreadPoolGuard(ThreadPool* threadpool)
+    : prev_threadpool_(current_threadpool), prev_core_ids_(current_core_ids) {
+  current_threadpool = threadpool;
+  if (threadpool != nullptr && !threadpool->core_ids().empty()) {
+    set_thread_affinity(threadpool->core_ids());
+    current_core_ids = &threadpool->core_ids();
+    changed_affinity_ = true;
+  }
+}
+
+ThreadPoolGuard::~ThreadPoolGuard() {
+  if (changed_affinity_) {
+    set_thread_affinity(
+        prev_core_ids_ != nullptr ? *prev_core_ids_ : std::vector<uint32_t>());
+    current_core_ids = prev_core_ids_;
+  }
+  current_threadpool = prev_threadpool_;
+}
+
+ThreadPool* ThreadPoolGuard::current() {
+  return current_threadpool;
+}
+
 ThreadPool* get_threadpool() {
+  if (current_threadpool != nullptr) {
+    return current_threadpool;
+  }
   ET_CHECK_MSG(cpuinfo_initialize(), "cpuinfo initialization failed");
   int num_threads = cpuinfo_get_processors_count();
   /*
@@ -8,9 +8,11 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <pthreadpool.h>
 
@@ -18,7 +20,21 @@ namespace executorch::extension::threadpool {
 
 class ThreadPool final {
  public:
-  explicit ThreadPool(size_t thread_count = 0);
+  /**
+   * Creates a threadpool.
+   *
+   * @param[in] thread_count The number of threads, including the calling
+   *     thread, that run tasks. If 0, one per core in `core_ids`, or one per
+   *     processor if `core_ids` is empty.
+   * @param[in] core_ids The processors, as numbered by the OS, that the
+   *     threads of the pool may run on; e.g. the big cores from
+   *     `cpuinfo::get_performant_core_ids()`. If empty, they may run on any
+   *     processor. Threads that run work for the pool on behalf of a caller,
+   *     the caller included, are restricted to these cores while they do.
+   */
+  explicit ThreadPool(
+      size_t thread_count = 0,
+      std::vector<uint32_t> core_ids = {});
   ~ThreadPool() = default;
 
   // Make threadpool non copyable
@@ -34,6 +50,14 @@ class ThreadPool final {
 
   size_t get_thread_count() const;
 
+  /**
+   * The processors that the threads of the pool may run on, or empty if they
+   * may run on any processor.
+   */
+  const std::vector<uint32_t>& core_ids() const {
+    return core_ids_;
+  }
+
   /**
    * INTERNAL: Resets the threadpool by creating a new threadpool with requested
    * # of threads. This is not a thread safe call. When calling this method,
@@ -65,13 +89,26 @@ class ThreadPool final {
   // which case this mutex will be useful. Otherwise remove it.
   mutable std::mutex mutex_;
   std::unique_ptr<pthreadpool, decltype(&pthreadpool_destroy)> threadpool_;
+  const std::vector<uint32_t> core_ids_;
 };
 
 /**
- * Returns the singleton instance of ThreadPool for ATen/TH multithreading.
+ * Returns the ThreadPool for ATen/TH multithreading: the one selected for the
+ * calling thread by a ThreadPoolGuard (see threadpool_guard.h), or the
+ * singleton instance otherwise.
  */
 ThreadPool* get_threadpool();
 
+/**
+ * Restricts the calling thread to the processors in `core_ids`, as numbered by
+ * the OS, or lets it run on all the processors that the process could run on
+ * when it started if `core_ids` is empty.
+ *
+ * @returns true on success, false if the platform does not support thread
+ *     affinity or the OS rejected the request.
+ */
+bool set_thread_affinity(const std::vector<uint32_t>& core_ids);
+
 /**
  * Returns the underlying pthreadpool instance used by the implementation of
  * ThreadPool returned by `get_threadpool()`. Only for use in external libraries
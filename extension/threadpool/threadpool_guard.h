@@ -8,8 +8,15 @@
 
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace executorch::extension::threadpool {
 
+class ThreadPool;
+
 // A RAII, thread local (!) guard that enables or disables guard upon
 // construction, and sets it back to the original value upon destruction.
 struct NoThreadPoolGuard {
@@ -27,6 +34,42 @@ struct NoThreadPoolGuard {
   const bool prev_mode_;
 };
 
+// A RAII, thread local (!) guard that makes get_threadpool() and
+// get_pthreadpool() return `threadpool` on the calling thread, and restricts
+// the calling thread to the cores of `threadpool` if it has any. Restores the
+// previous threadpool upon destruction, along with the affinity of the
+// enclosing guard, or the default affinity if there is none.
+//
+// Backends that capture the pthreadpool when a method is loaded, like
+// XNNPACK, keep using the threadpool that was selected at that time.
+struct ThreadPoolGuard {
+  explicit ThreadPoolGuard(ThreadPool* threadpool);
+  ~ThreadPoolGuard();
+
+  ThreadPoolGuard(const ThreadPoolGuard&) = delete;
+  ThreadPoolGuard& operator=(const ThreadPoolGuard&) = delete;
+
+  // The threadpool selected for the calling thread, or nullptr if none is.
+  static ThreadPool* current();
+
+ private:
+  ThreadPool* const prev_threadpool_;
+  const std::vector<uint32_t>* prev_core_ids_;
+  bool changed_affinity_ = false;
+};
+
+/**
+ * Returns a function that creates a ThreadPoolGuard for `threadpool` and
+ * returns it type-erased, e.g. to pass to `Module::set_execution_scope()` so
+ * that a Module loads and executes its methods on `threadpool`.
+ */
+inline std::function<std::shared_ptr<void>()> make_threadpool_scope(
+    ThreadPool* threadpool) {
+  return [threadpool]() -> std::shared_ptr<void> {
+    return std::make_shared<ThreadPoolGuard>(threadpool);
+  };
+}
+
 } // namespace executorch::extension::threadpool
 
 namespace torch::executorch::threadpool { // DEPRECATED
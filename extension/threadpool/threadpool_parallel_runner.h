@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/runtime/executor/parallel_runner.h>
+
+namespace executorch::extension::threadpool {
+
+/**
+ * A ParallelRunner that dispatches tasks onto an ExecuTorch ThreadPool. Pass
+ * one to `Method::set_parallel_runner()` to let independent instructions of the
+ * Method run on multiple cores.
+ *
+ * Tasks run under a NoThreadPoolGuard, so kernels that themselves use the
+ * threadpool will run single-threaded inside a parallel wave instead of
+ * deadlocking on it.
+ */
+class ThreadPoolParallelRunner final : public runtime::ParallelRunner {
+ public:
+  explicit ThreadPoolParallelRunner(ThreadPool* threadpool = get_threadpool())
+      : threadpool_(threadpool) {}
+
+  void run(TaskFunction fn, void* context, size_t num_tasks) override {
+    threadpool_->run(
+        [fn, context](size_t task_index) { fn(context, task_index); },
+        num_tasks);
+  }
+
+ private:
+  ThreadPool* threadpool_;
+};
+
+} // namespace executorch::extension::threadpool
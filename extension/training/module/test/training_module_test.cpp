@@ -105,3 +105,62 @@ TEST_F(TrainingModuleTest, NonTrainingModuleTest) {
   auto res = mod.execute_forward_backward("forward", inputs);
   ASSERT_EQ(res.error(), Error::InvalidArgument);
 }
+
+TEST_F(TrainingModuleTest, AccumulateGradientsTest) {
+  const char* path = std::getenv("ET_MODULE_SIMPLE_TRAIN_PATH");
+  executorch::runtime::Result<torch::executor::util::FileDataLoader>
+      loader_res = torch::executor::util::FileDataLoader::from(path);
+  ASSERT_EQ(loader_res.error(), Error::Ok);
+  auto loader = std::make_unique<torch::executor::util::FileDataLoader>(
+      std::move(loader_res.get()));
+
+  auto mod = executorch::extension::training::TrainingModule(std::move(loader));
+
+  // Nothing has been accumulated yet.
+  ASSERT_EQ(
+      mod.named_accumulated_gradients("forward").error(),
+      Error::InvalidArgument);
+
+  TensorFactory<ScalarType::Float> tf;
+  Tensor input = tf.make({3}, {1.0, 1.0, 1.0});
+  Tensor label = tf.make({3}, {1.0, 0.0, 0.0});
+
+  std::vector<executorch::runtime::EValue> inputs;
+  inputs.push_back(input);
+  inputs.push_back(label);
+
+  // Averaging two micro-batches with the same input gives the gradients of
+  // one of them.
+  for (int i = 0; i < 2; ++i) {
+    auto res = mod.accumulate_forward_backward("forward", inputs, 0.5f);
+    ASSERT_EQ(res.error(), Error::Ok);
+    ASSERT_EQ(res.get().size(), 1);
+  }
+
+  auto grad_res = mod.named_gradients("forward");
+  ASSERT_EQ(grad_res.error(), Error::Ok);
+  auto& grad = grad_res.get();
+  auto accumulated_res = mod.named_accumulated_gradients("forward");
+  ASSERT_EQ(accumulated_res.error(), Error::Ok);
+  auto& accumulated = accumulated_res.get();
+  ASSERT_EQ(accumulated.size(), 2);
+  for (const auto& named_gradient : grad) {
+    const auto it = accumulated.find(named_gradient.first);
+    ASSERT_NE(it, accumulated.end());
+    ASSERT_EQ(it->second.scalar_type(), ScalarType::Float);
+    ASSERT_EQ(it->second.numel(), named_gradient.second.numel());
+    for (ssize_t i = 0; i < it->second.numel(); ++i) {
+      EXPECT_NEAR(
+          it->second.const_data_ptr<float>()[i],
+          named_gradient.second.const_data_ptr<float>()[i],
+          1e-6);
+    }
+  }
+
+  mod.zero_accumulated_gradients("forward");
+  for (const auto& named_gradient : accumulated) {
+    for (ssize_t i = 0; i < named_gradient.second.numel(); ++i) {
+      EXPECT_EQ(named_gradient.second.const_data_ptr<float>()[i], 0.0f);
+    }
+  }
+}
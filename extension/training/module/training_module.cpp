@@ -8,6 +8,10 @@
 
 #include <executorch/extension/training/module/training_module.h>
 
+#include <algorithm>
+
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
 namespace executorch {
 namespace extension {
 namespace training {
@@ -84,6 +88,84 @@ TrainingModule::execute_forward_backward(
   return user_outputs;
 }
 
+runtime::Result<std::vector<runtime::EValue>>
+TrainingModule::accumulate_forward_backward(
+    const std::string& method_name,
+    const std::vector<runtime::EValue>& input,
+    float scale) {
+  auto outputs = execute_forward_backward(method_name, input);
+  if (!outputs.ok()) {
+    return outputs.error();
+  }
+  const auto& gradients_map = method_named_gradients_.at(method_name);
+
+  auto accumulated_it = method_accumulated_gradients_.find(method_name);
+  if (accumulated_it == method_accumulated_gradients_.end()) {
+    // Allocate all of the accumulated gradients of the method at once, since
+    // they live until the module is destroyed.
+    AccumulatedGradients accumulated;
+    accumulated.size = 0;
+    for (const auto& named_gradient : gradients_map) {
+      accumulated.size += named_gradient.second.numel();
+    }
+    // Value-initialized, so the gradients start at zero.
+    accumulated.data = std::make_unique<float[]>(accumulated.size);
+    accumulated.tensors.reserve(gradients_map.size());
+    float* next = accumulated.data.get();
+    for (const auto& named_gradient : gradients_map) {
+      const auto& gradient = named_gradient.second;
+      accumulated.tensors.push_back(make_tensor_ptr(
+          std::vector<exec_aten::SizesType>(
+              gradient.sizes().begin(), gradient.sizes().end()),
+          next,
+          exec_aten::ScalarType::Float,
+          exec_aten::TensorShapeDynamism::STATIC));
+      accumulated.named_gradients.insert(
+          {named_gradient.first, *accumulated.tensors.back()});
+      next += gradient.numel();
+    }
+    accumulated_it =
+        method_accumulated_gradients_
+            .emplace(method_name, std::move(accumulated))
+            .first;
+  }
+
+  for (const auto& named_gradient : gradients_map) {
+    const auto& gradient = named_gradient.second;
+    auto& accumulated =
+        accumulated_it->second.named_gradients.at(named_gradient.first);
+    ET_CHECK_OR_RETURN_ERROR(
+        gradient.numel() == accumulated.numel(),
+        InvalidState,
+        "Gradient of %.*s changed size from %zd to %zd elements",
+        static_cast<int>(named_gradient.first.size()),
+        named_gradient.first.data(),
+        static_cast<ssize_t>(accumulated.numel()),
+        static_cast<ssize_t>(gradient.numel()));
+    ET_CHECK_OR_RETURN_ERROR(
+        executorch::runtime::isFloatingType(gradient.scalar_type()),
+        InvalidArgument,
+        "Gradient of %.*s has non-floating point dtype %d",
+        static_cast<int>(named_gradient.first.size()),
+        named_gradient.first.data(),
+        static_cast<int>(gradient.scalar_type()));
+    float* out = accumulated.mutable_data_ptr<float>();
+    const size_t numel = gradient.numel();
+    ET_SWITCH_FLOATHBF16_TYPES(
+        gradient.scalar_type(),
+        nullptr,
+        "accumulate_forward_backward",
+        CTYPE,
+        [&]() {
+          const CTYPE* in = gradient.const_data_ptr<CTYPE>();
+          for (size_t i = 0; i < numel; ++i) {
+            out[i] += scale * static_cast<float>(in[i]);
+          }
+        });
+  }
+  return outputs;
+}
+
 runtime::Result<const std::map<exec_aten::string_view, exec_aten::Tensor>>
 TrainingModule::named_parameters(const std::string& method_name) {
   std::map<exec_aten::string_view, exec_aten::Tensor> named_parameters;
@@ -134,6 +216,28 @@ TrainingModule::named_gradients(const std::string& method_name) {
   return method_named_gradients_.at(method_name);
 }
 
+runtime::Result<const std::map<exec_aten::string_view, exec_aten::Tensor>>
+TrainingModule::named_accumulated_gradients(const std::string& method_name) {
+  const auto accumulated_it = method_accumulated_gradients_.find(method_name);
+  if (accumulated_it == method_accumulated_gradients_.end()) {
+    ET_LOG(
+        Error,
+        "No accumulated gradients found for method %s",
+        method_name.c_str());
+    return executorch::runtime::Error::InvalidArgument;
+  }
+  return accumulated_it->second.named_gradients;
+}
+
+void TrainingModule::zero_accumulated_gradients(
+    const std::string& method_name) {
+  const auto accumulated_it = method_accumulated_gradients_.find(method_name);
+  if (accumulated_it != method_accumulated_gradients_.end()) {
+    auto& accumulated = accumulated_it->second;
+    std::fill_n(accumulated.data.get(), accumulated.size, 0.0f);
+  }
+}
+
 } // namespace training
 } // namespace extension
 } // namespace executorch
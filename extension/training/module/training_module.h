@@ -15,6 +15,7 @@
 #include <vector>
 
 #include <executorch/extension/module/module.h>
+#include <executorch/extension/tensor/tensor_ptr.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/executor/program.h>
 
@@ -92,11 +93,73 @@ class ET_EXPERIMENTAL TrainingModule final
       const std::map<executorch::aten::string_view, executorch::aten::Tensor>>
   named_gradients(const std::string& method_name);
 
+  /**
+   * Execute a joint graph method like execute_forward_backward(), and add its
+   * gradients, multiplied by `scale`, to the accumulated gradients of the
+   * method. Running this on several micro-batches before an optimizer step
+   * trains with their combined batch size, while only the activations of one
+   * micro-batch are live at a time.
+   *
+   * The accumulated gradients are fp32 tensors, whatever the dtype of the
+   * gradients of the method. They are allocated in a single buffer on the
+   * first call for the method, and start at zero.
+   *
+   * @param[in] method_name The name of the joint graph method to execute.
+   * @param[in] input A vector of input values to be passed to the method.
+   * @param[in] scale The factor applied to the gradients before adding them,
+   * e.g. one over the number of micro-batches to average them.
+   *
+   * @returns A Result object containing the output values from the method or an
+   * error to indicate failure.
+   */
+  ET_EXPERIMENTAL runtime::Result<std::vector<runtime::EValue>>
+  accumulate_forward_backward(
+      const std::string& method_name,
+      const std::vector<runtime::EValue>& input,
+      float scale = 1.0f);
+
+  /**
+   * Retrieve the accumulated gradients for a joint graph method.
+   *
+   * @param[in] method_name The name of the joint graph method to get the
+   * accumulated gradients for.
+   *
+   * @returns A Result object containing a map of the fully qualified name to
+   * the accumulated gradient of that parameter, which the optimizers accept in
+   * place of the gradients of the method, or an error if the method has not
+   * accumulated gradients yet.
+   */
+  ET_EXPERIMENTAL
+  runtime::Result<
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>>
+  named_accumulated_gradients(const std::string& method_name);
+
+  /**
+   * Reset the accumulated gradients for a joint graph method to zero, usually
+   * after an optimizer step. Does nothing if the method has not accumulated
+   * gradients yet.
+   *
+   * @param[in] method_name The name of the joint graph method to reset the
+   * accumulated gradients of.
+   */
+  ET_EXPERIMENTAL void zero_accumulated_gradients(
+      const std::string& method_name);
+
  private:
+  struct AccumulatedGradients {
+    std::unique_ptr<float[]> data;
+    size_t size;
+    std::vector<TensorPtr> tensors;
+    std::map<executorch::aten::string_view, executorch::aten::Tensor>
+        named_gradients;
+  };
+
   std::unordered_map<
       std::string,
       std::map<executorch::aten::string_view, executorch::aten::Tensor>>
       method_named_gradients_;
+  std::unordered_map<std::string, AccumulatedGradients>
+      method_accumulated_gradients_;
 };
 
 } // namespace training
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/adam.h>
+
+#include <cmath>
+
+#include <executorch/runtime/core/error.h>
+
+using ::executorch::extension::training::optimizer::internal::Chunk;
+using ::executorch::extension::training::optimizer::internal::ParamGroupState;
+using ::executorch::runtime::Error;
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+bool AdamParamGroup::has_options() const {
+  return options_ != nullptr;
+}
+
+AdamOptions& AdamParamGroup::options() {
+  return *options_.get();
+}
+
+const AdamOptions& AdamParamGroup::options() const {
+  return *options_.get();
+}
+
+void AdamParamGroup::set_options(std::unique_ptr<AdamOptions> options) {
+  options_ = std::move(options);
+}
+
+const std::map<exec_aten::string_view, exec_aten::Tensor>&
+AdamParamGroup::named_parameters() const {
+  return named_parameters_;
+}
+
+void Adam::add_param_group(const AdamParamGroup& param_group) {
+  AdamParamGroup param_group_(param_group.named_parameters());
+  if (!param_group.has_options()) {
+    param_group_.set_options(defaults_->clone());
+  } else {
+    param_group_.set_options(param_group.options().clone());
+  }
+  param_groups_.emplace_back(std::move(param_group_));
+  states_.emplace_back();
+}
+
+Error Adam::step(const std::map<exec_aten::string_view, exec_aten::Tensor>&
+                     named_gradients) {
+  for (size_t group_index = 0; group_index < param_groups_.size();
+       ++group_index) {
+    auto& group = param_groups_[group_index];
+    const auto& options = group.options();
+    const double lr = options.lr();
+    const double beta1 = options.beta1();
+    const double beta2 = options.beta2();
+    const float eps = options.eps();
+    const float weight_decay = options.weight_decay();
+    const bool decoupled_weight_decay = options.decoupled_weight_decay();
+
+    auto& state = states_[group_index];
+    if (state == nullptr) {
+      // The running averages of the gradients and of their squares.
+      state = ET_UNWRAP(ParamGroupState::create(group.named_parameters(), 2));
+    }
+    const auto updates =
+        ET_UNWRAP(internal::find_updates(*state, named_gradients));
+    for (const auto& update : updates) {
+      ++update.param->step;
+    }
+
+    internal::for_each_chunk(updates, [&](const Chunk& chunk) {
+      float* p = chunk.weights;
+      const float* grad = chunk.grads;
+      float* exp_avg = chunk.buffers[0];
+      float* exp_avg_sq = chunk.buffers[1];
+      // Correct the bias of the averages towards their initial zeros.
+      const double bias_correction1 = 1 - std::pow(beta1, chunk.step);
+      const double bias_correction2 = 1 - std::pow(beta2, chunk.step);
+      const float step_size = lr / bias_correction1;
+      const float inv_sqrt_bias_correction2 = 1 / std::sqrt(bias_correction2);
+      const float decay = decoupled_weight_decay ? 1 - lr * weight_decay : 1;
+      const float grad_decay = decoupled_weight_decay ? 0 : weight_decay;
+      const float b1 = beta1;
+      const float b2 = beta2;
+      for (size_t i = 0; i < chunk.size; ++i) {
+        const float d_p = grad[i] + grad_decay * p[i];
+        exp_avg[i] = b1 * exp_avg[i] + (1 - b1) * d_p;
+        exp_avg_sq[i] = b2 * exp_avg_sq[i] + (1 - b2) * d_p * d_p;
+        const float denom =
+            std::sqrt(exp_avg_sq[i]) * inv_sqrt_bias_correction2 + eps;
+        p[i] = p[i] * decay - step_size * exp_avg[i] / denom;
+      }
+    });
+  }
+  return Error::Ok;
+}
+
+Adam::~Adam() = default;
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
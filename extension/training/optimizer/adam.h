@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Adam and AdamW optimizers to perform on-device training. These use running
+ * averages of the gradients and of their squares, calculated in the backwards
+ * pass of the loss function, to update the parameters with a step size that
+ * adapts to each parameter.
+ *
+ * This is similar to the PyTorch implementation of the Adam and AdamW
+ * optimizers, but without the dependency on ATen Tensors and autograd.
+ */
+#pragma once
+
+#include <executorch/extension/training/optimizer/param_group_state.h>
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+
+/**
+ * Adam optimizer options. This contains options for performing training on a
+ * param group, such as the learning rate.
+ */
+class ET_EXPERIMENTAL AdamOptions {
+ public:
+  /**
+   * Constructs a new Adam optimizer options.
+   *
+   * This is used for customizing the Adam optimizer for a given group of
+   * parameters.
+   *
+   * @param[in] lr The learning rate. This is the factor applied to the
+   *   normalized running average of the gradients to update the parameters.
+   * @param[in] beta1 The decay rate of the running average of the gradients.
+   * @param[in] beta2 The decay rate of the running average of the squared
+   *   gradients.
+   * @param[in] eps A small value added to the denominator of the update, to
+   *   keep it from dividing by zero.
+   * @param[in] weight_decay The weight decay value. This is used as a
+   *   regularization technique to pull the weights towards zero at each step.
+   * @param[in] decoupled_weight_decay Whether to decay the weights directly,
+   *   like AdamW, rather than to add the decay to the gradient, like Adam.
+   */
+  explicit AdamOptions(
+      double lr = 1e-3,
+      double beta1 = 0.9,
+      double beta2 = 0.999,
+      double eps = 1e-8,
+      double weight_decay = 0,
+      bool decoupled_weight_decay = false)
+      : lr_(lr),
+        beta1_(beta1),
+        beta2_(beta2),
+        eps_(eps),
+        weight_decay_(weight_decay),
+        decoupled_weight_decay_(decoupled_weight_decay) {}
+
+  /**
+   * Returns the options of the AdamW optimizer, i.e. Adam with decoupled
+   * weight decay, which defaults to 1e-2 like in PyTorch.
+   */
+  static AdamOptions adamw(
+      double lr = 1e-3,
+      double beta1 = 0.9,
+      double beta2 = 0.999,
+      double eps = 1e-8,
+      double weight_decay = 1e-2) {
+    return AdamOptions(lr, beta1, beta2, eps, weight_decay, true);
+  }
+
+  std::unique_ptr<AdamOptions> clone() const {
+    return std::make_unique<AdamOptions>(
+        static_cast<const AdamOptions&>(*this));
+  }
+
+  double lr() const {
+    return lr_;
+  }
+
+  double beta1() const {
+    return beta1_;
+  }
+
+  double beta2() const {
+    return beta2_;
+  }
+
+  double eps() const {
+    return eps_;
+  }
+
+  double weight_decay() const {
+    return weight_decay_;
+  }
+
+  bool decoupled_weight_decay() const {
+    return decoupled_weight_decay_;
+  }
+
+ private:
+  double lr_;
+  double beta1_;
+  double beta2_;
+  double eps_;
+  double weight_decay_;
+  bool decoupled_weight_decay_;
+};
+
+/**
+ * Adam optimizer param group. This contains the parameters and
+ * the AdamOptions associated to it.
+ */
+class ET_EXPERIMENTAL AdamParamGroup {
+ public:
+  // NOTE: In order to store `AdamParamGroup` in a `std::vector`, it has
+  // to be copy-constructible.
+  AdamParamGroup(const AdamParamGroup& param_group)
+      : named_parameters_(param_group.named_parameters()),
+        options_(
+            param_group.has_options() ? param_group.options().clone()
+                                      : nullptr) {}
+  AdamParamGroup& operator=(const AdamParamGroup& param_group) {
+    this->named_parameters_ = param_group.named_parameters_;
+    this->options_ =
+        param_group.has_options() ? param_group.options().clone() : nullptr;
+    return *this;
+  }
+
+  /**
+   * Constructs an Adam param group.
+   *
+   * @param[in] named_parameters The parameters to be optimized and their fully
+   * qualified names.
+   */
+  /* implicit */ AdamParamGroup(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_parameters)
+      : named_parameters_(named_parameters) {}
+  AdamParamGroup(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_parameters,
+      std::unique_ptr<AdamOptions> options)
+      : named_parameters_(named_parameters), options_(std::move(options)) {}
+
+  bool has_options() const;
+  AdamOptions& options();
+  const AdamOptions& options() const;
+  void set_options(std::unique_ptr<AdamOptions> options);
+  const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+  named_parameters() const;
+
+ private:
+  std::map<executorch::aten::string_view, executorch::aten::Tensor>
+      named_parameters_;
+  std::unique_ptr<AdamOptions> options_;
+};
+
+/**
+ * Adam optimizer class. This is responsible for performing the optimization
+ * step. Use AdamOptions::adamw() for the AdamW optimizer.
+ *
+ * Parameters may be fp32, fp16 or bf16 tensors. The optimizer keeps an fp32
+ * master copy of the parameters that are not fp32, and updates them through
+ * it. Gradients must have the dtype of their parameter, or be fp32.
+ */
+class ET_EXPERIMENTAL Adam {
+ public:
+  explicit Adam(
+      const std::vector<AdamParamGroup>& param_groups,
+      AdamOptions defaults)
+      : defaults_(std::make_unique<AdamOptions>(defaults)) {
+    for (const auto& param_group : param_groups) {
+      add_param_group(param_group);
+    }
+  }
+
+  explicit Adam(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_parameters,
+      AdamOptions defaults)
+      : Adam({AdamParamGroup(named_parameters)}, defaults) {}
+
+  // Adds the given param_group to the optimizer's param_group list.
+  void add_param_group(const AdamParamGroup& param_group);
+
+  ~Adam();
+
+  /**
+   * Performs the optimization step. Updates all parameters of a param group
+   * in one fused pass, split between the threads of the threadpool if there
+   * is one. The gradients are not modified.
+   *
+   * @param[in] named_gradients The gradients of the tensors specified by the
+   * fully qualified name.
+   */
+  ::executorch::runtime::Error step(
+      const std::map<executorch::aten::string_view, executorch::aten::Tensor>&
+          named_gradients);
+
+ private:
+  std::vector<AdamParamGroup> param_groups_;
+  // The running averages and master weights of each param group, allocated
+  // on its first step.
+  std::vector<std::unique_ptr<internal::ParamGroupState>> states_;
+  std::unique_ptr<AdamOptions> defaults_;
+};
+
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
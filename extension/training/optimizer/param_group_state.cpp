@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/param_group_state.h>
+
+#include <algorithm>
+
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::Result;
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+namespace internal {
+
+namespace {
+
+// The minimum number of elements that each parallel_for chunk updates.
+constexpr int64_t kGrainSize = 16384;
+
+// The number of elements that are converted to and from fp32 at a time, which
+// bounds the size of the conversion buffers on the stack.
+constexpr size_t kBlockSize = 1024;
+
+bool is_supported_type(ScalarType type) {
+  return type == ScalarType::Float || type == ScalarType::Half ||
+      type == ScalarType::BFloat16;
+}
+
+template <typename T>
+void convert_to_float(const void* data, size_t begin, size_t n, float* out) {
+  const T* in = static_cast<const T*>(data) + begin;
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = static_cast<float>(in[i]);
+  }
+}
+
+template <typename T>
+void convert_from_float(const float* in, size_t n, void* data, size_t begin) {
+  T* out = static_cast<T*>(data) + begin;
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = static_cast<T>(in[i]);
+  }
+}
+
+// Converts elements [begin, begin + n) of a tensor to fp32.
+void load(const Tensor& tensor, size_t begin, size_t n, float* out) {
+  switch (tensor.scalar_type()) {
+    case ScalarType::Half:
+      convert_to_float<exec_aten::Half>(
+          tensor.const_data_ptr(), begin, n, out);
+      break;
+    case ScalarType::BFloat16:
+      convert_to_float<exec_aten::BFloat16>(
+          tensor.const_data_ptr(), begin, n, out);
+      break;
+    default:
+      convert_to_float<float>(tensor.const_data_ptr(), begin, n, out);
+      break;
+  }
+}
+
+// Rounds fp32 values into elements [begin, begin + n) of a tensor.
+void store(const float* in, size_t n, const Tensor& tensor, size_t begin) {
+  switch (tensor.scalar_type()) {
+    case ScalarType::Half:
+      convert_from_float<exec_aten::Half>(
+          in, n, tensor.mutable_data_ptr(), begin);
+      break;
+    case ScalarType::BFloat16:
+      convert_from_float<exec_aten::BFloat16>(
+          in, n, tensor.mutable_data_ptr(), begin);
+      break;
+    default:
+      convert_from_float<float>(in, n, tensor.mutable_data_ptr(), begin);
+      break;
+  }
+}
+
+// Updates elements [begin, end) of one parameter.
+void update_range(
+    const ParamUpdate& update,
+    size_t begin,
+    size_t end,
+    const std::function<void(const Chunk&)>& f) {
+  const auto& param = *update.param;
+  const bool fp32_grad = update.grad.scalar_type() == ScalarType::Float;
+  if (param.master == nullptr && fp32_grad) {
+    // Nothing to convert, so update the whole range at once.
+    Chunk chunk{
+        param.tensor.mutable_data_ptr<float>() + begin,
+        update.grad.const_data_ptr<float>() + begin,
+        {},
+        end - begin,
+        param.step};
+    for (size_t i = 0; i < ParamGroupState::kMaxBuffers; ++i) {
+      chunk.buffers[i] =
+          param.buffers[i] == nullptr ? nullptr : param.buffers[i] + begin;
+    }
+    f(chunk);
+    return;
+  }
+
+  float grads[kBlockSize];
+  for (size_t block = begin; block < end; block += kBlockSize) {
+    const size_t n = std::min(kBlockSize, end - block);
+    Chunk chunk{
+        param.master == nullptr
+            ? param.tensor.mutable_data_ptr<float>() + block
+            : param.master + block,
+        grads,
+        {},
+        n,
+        param.step};
+    for (size_t i = 0; i < ParamGroupState::kMaxBuffers; ++i) {
+      chunk.buffers[i] =
+          param.buffers[i] == nullptr ? nullptr : param.buffers[i] + block;
+    }
+    if (fp32_grad) {
+      chunk.grads = update.grad.const_data_ptr<float>() + block;
+    } else {
+      load(update.grad, block, n, grads);
+    }
+    f(chunk);
+    if (param.master != nullptr) {
+      store(chunk.weights, n, param.tensor, block);
+    }
+  }
+}
+
+} // namespace
+
+Result<std::unique_ptr<ParamGroupState>> ParamGroupState::create(
+    const std::map<exec_aten::string_view, exec_aten::Tensor>&
+        named_parameters,
+    size_t num_buffers) {
+  ET_CHECK_OR_RETURN_ERROR(
+      num_buffers <= kMaxBuffers,
+      InvalidArgument,
+      "%zu state buffers requested, at most %zu are supported",
+      num_buffers,
+      kMaxBuffers);
+
+  size_t arena_size = 0;
+  for (const auto& named_parameter : named_parameters) {
+    const auto& tensor = named_parameter.second;
+    ET_CHECK_OR_RETURN_ERROR(
+        is_supported_type(tensor.scalar_type()),
+        InvalidArgument,
+        "Parameter %.*s has unsupported dtype %d",
+        static_cast<int>(named_parameter.first.size()),
+        named_parameter.first.data(),
+        static_cast<int>(tensor.scalar_type()));
+    const bool needs_master = tensor.scalar_type() != ScalarType::Float;
+    arena_size += tensor.numel() * (num_buffers + (needs_master ? 1 : 0));
+  }
+
+  std::unique_ptr<ParamGroupState> state(new ParamGroupState());
+  // Value-initialized, so the buffers start at zero.
+  state->arena_ = std::make_unique<float[]>(arena_size);
+  state->params_.reserve(named_parameters.size());
+  float* next = state->arena_.get();
+  for (const auto& named_parameter : named_parameters) {
+    const auto& tensor = named_parameter.second;
+    const size_t numel = tensor.numel();
+    Param param{named_parameter.first, tensor, nullptr, {}, 0};
+    if (tensor.scalar_type() != ScalarType::Float) {
+      param.master = next;
+      next += numel;
+      load(tensor, 0, numel, param.master);
+    }
+    for (size_t i = 0; i < num_buffers; ++i) {
+      param.buffers[i] = next;
+      next += numel;
+    }
+    state->params_.push_back(param);
+  }
+  return state;
+}
+
+Result<std::vector<ParamUpdate>> find_updates(
+    ParamGroupState& state,
+    const std::map<exec_aten::string_view, exec_aten::Tensor>&
+        named_gradients) {
+  std::vector<ParamUpdate> updates;
+  for (auto& param : state.params()) {
+    // if param name and gradient name match, the parameter is updated
+    const auto named_gradient = named_gradients.find(param.name);
+    if (named_gradient == named_gradients.end()) {
+      continue;
+    }
+    const auto& grad = named_gradient->second;
+    ET_CHECK_OR_RETURN_ERROR(
+        grad.numel() == param.tensor.numel(),
+        InvalidArgument,
+        "Gradient of %.*s has %zd elements, but the parameter has %zd",
+        static_cast<int>(param.name.size()),
+        param.name.data(),
+        static_cast<ssize_t>(grad.numel()),
+        static_cast<ssize_t>(param.tensor.numel()));
+    ET_CHECK_OR_RETURN_ERROR(
+        grad.scalar_type() == param.tensor.scalar_type() ||
+            grad.scalar_type() == ScalarType::Float,
+        InvalidArgument,
+        "Gradient of %.*s has dtype %d, but the parameter has dtype %d",
+        static_cast<int>(param.name.size()),
+        param.name.data(),
+        static_cast<int>(grad.scalar_type()),
+        static_cast<int>(param.tensor.scalar_type()));
+    updates.push_back({&param, grad});
+  }
+  return updates;
+}
+
+void for_each_chunk(
+    const std::vector<ParamUpdate>& updates,
+    const std::function<void(const Chunk&)>& update) {
+  // The element ranges of the parameters, end to end, so that small
+  // parameters share a chunk and large ones are split between threads.
+  std::vector<int64_t> ends;
+  ends.reserve(updates.size());
+  int64_t total = 0;
+  for (const auto& u : updates) {
+    total += u.param->tensor.numel();
+    ends.push_back(total);
+  }
+
+  const auto update_elements = [&](int64_t begin, int64_t end) {
+    // The first parameter that ends after begin.
+    size_t i = std::upper_bound(ends.begin(), ends.end(), begin) - ends.begin();
+    for (; i < updates.size() && begin < end; ++i) {
+      const int64_t param_begin = ends[i] - updates[i].param->tensor.numel();
+      const int64_t range_end = std::min(end, ends[i]);
+      update_range(
+          updates[i], begin - param_begin, range_end - param_begin, update);
+      begin = range_end;
+    }
+  };
+#ifdef ET_USE_THREADPOOL
+  executorch::extension::parallel_for(0, total, kGrainSize, update_elements);
+#else
+  (void)kGrainSize;
+  update_elements(0, total);
+#endif
+}
+
+} // namespace internal
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
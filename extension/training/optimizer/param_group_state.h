@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * State and update loop shared by the optimizers. Not part of the public API.
+ */
+#pragma once
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/result.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace executorch {
+namespace extension {
+namespace training {
+namespace optimizer {
+namespace internal {
+
+/**
+ * The state of the parameters of one param group, such as momentum buffers.
+ * All of it lives in a single fp32 arena that is allocated once, rather than
+ * in an allocation per parameter.
+ *
+ * Parameters that are not fp32, i.e. fp16 or bf16, also get an fp32 master
+ * copy in the arena. The optimizer updates the master copy and rounds it into
+ * the parameter, so that updates smaller than the precision of the parameter
+ * still add up over steps.
+ */
+class ParamGroupState final {
+ public:
+  /// The maximum number of state buffers of each parameter.
+  static constexpr size_t kMaxBuffers = 2;
+
+  /// The state of one parameter.
+  struct Param {
+    exec_aten::string_view name;
+    exec_aten::Tensor tensor;
+    /// The fp32 master copy of the parameter, or nullptr if it is fp32.
+    float* master;
+    /// The state buffers, with one value per element, or nullptr if unused.
+    float* buffers[kMaxBuffers];
+    /// The number of steps that have updated the parameter.
+    int64_t step;
+  };
+
+  /**
+   * Allocates the state of the parameters of a param group.
+   *
+   * @param[in] named_parameters The parameters of the group, which must be
+   * fp32, fp16 or bf16 tensors.
+   * @param[in] num_buffers The number of state buffers of each parameter, at
+   * most kMaxBuffers. The buffers are zero-initialized.
+   *
+   * @returns The state, or an error if a parameter is not supported.
+   */
+  static runtime::Result<std::unique_ptr<ParamGroupState>> create(
+      const std::map<exec_aten::string_view, exec_aten::Tensor>&
+          named_parameters,
+      size_t num_buffers);
+
+  ParamGroupState(const ParamGroupState&) = delete;
+  ParamGroupState& operator=(const ParamGroupState&) = delete;
+
+  std::vector<Param>& params() {
+    return params_;
+  }
+
+ private:
+  ParamGroupState() = default;
+
+  std::unique_ptr<float[]> arena_;
+  std::vector<Param> params_;
+};
+
+/// A parameter to update in a step, and its gradient.
+struct ParamUpdate {
+  ParamGroupState::Param* param;
+  exec_aten::Tensor grad;
+};
+
+/**
+ * Finds the parameters of a param group that have a gradient.
+ *
+ * @param[in] state The state of the param group.
+ * @param[in] named_gradients The gradients of the step, by the fully qualified
+ * names of their parameters. Each must have as many elements as its parameter,
+ * and either the same dtype or fp32.
+ *
+ * @returns The parameters to update, or an error if a gradient does not match
+ * its parameter.
+ */
+runtime::Result<std::vector<ParamUpdate>> find_updates(
+    ParamGroupState& state,
+    const std::map<exec_aten::string_view, exec_aten::Tensor>&
+        named_gradients);
+
+/// A contiguous range of elements of one parameter, as fp32 arrays.
+struct Chunk {
+  /// The weights to update: the master copy or the fp32 parameter.
+  float* weights;
+  const float* grads;
+  float* buffers[ParamGroupState::kMaxBuffers];
+  size_t size;
+  /// The number of the step for the parameter, starting at 1.
+  int64_t step;
+};
+
+/**
+ * Calls `update` on the elements of all of the parameters in `updates`, in
+ * one parallel pass over chunks of their elements. Gradients that are not
+ * fp32 are converted for each chunk, and parameters with a master copy are
+ * rounded from it after each chunk.
+ */
+void for_each_chunk(
+    const std::vector<ParamUpdate>& updates,
+    const std::function<void(const Chunk&)>& update);
+
+} // namespace internal
+} // namespace optimizer
+} // namespace training
+} // namespace extension
+} // namespace executorch
@@ -10,8 +10,8 @@
 
 #include <executorch/runtime/core/error.h>
 
-using exec_aten::Tensor;
-using exec_aten::TensorImpl;
+using ::executorch::extension::training::optimizer::internal::Chunk;
+using ::executorch::extension::training::optimizer::internal::ParamGroupState;
 using ::executorch::runtime::Error;
 
 namespace executorch {
@@ -19,37 +19,6 @@ namespace extension {
 namespace training {
 namespace optimizer {
 
-namespace {
-void add_out_hack(
-    const Tensor& a,
-    const Tensor& b,
-    const double alpha,
-    Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto b_ptr = b.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i] + b_ptr[i] * alpha;
-  }
-}
-
-void mul_out_hack(const Tensor& a, const double alpha, Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i] * alpha;
-  }
-}
-
-void clone_out_hack(const Tensor& a, Tensor& out) {
-  auto a_ptr = a.const_data_ptr<float>();
-  auto out_ptr = out.mutable_data_ptr<float>();
-  for (size_t i = 0; i < a.numel(); ++i) {
-    out_ptr[i] = a_ptr[i];
-  }
-}
-} // namespace
-
 bool SGDParamGroup::has_options() const {
   return options_ != nullptr;
 }
@@ -79,89 +48,57 @@ void SGD::add_param_group(const SGDParamGroup& param_group) {
     param_group_.set_options(param_group.options().clone());
   }
   param_groups_.emplace_back(std::move(param_group_));
+  states_.emplace_back();
 }
 
 Error SGD::step(const std::map<exec_aten::string_view, exec_aten::Tensor>&
                     named_gradients) {
-  for (auto& group : param_groups_) {
+  for (size_t group_index = 0; group_index < param_groups_.size();
+       ++group_index) {
+    auto& group = param_groups_[group_index];
     auto& options = static_cast<SGDOptions&>(group.options());
-    auto weight_decay = options.weight_decay();
-    auto momentum = options.momentum();
-    auto dampening = options.dampening();
-    auto nesterov = options.nesterov();
+    const float lr = options.lr();
+    const float weight_decay = options.weight_decay();
+    const float momentum = options.momentum();
+    const float dampening = options.dampening();
+    const bool nesterov = options.nesterov();
+
+    auto& state = states_[group_index];
+    if (state == nullptr) {
+      // One momentum buffer per parameter, if momentum is used.
+      state = ET_UNWRAP(ParamGroupState::create(
+          group.named_parameters(), momentum != 0 ? 1 : 0));
+    }
+    const auto updates =
+        ET_UNWRAP(internal::find_updates(*state, named_gradients));
+    for (const auto& update : updates) {
+      ++update.param->step;
+    }
 
-    for (auto param_iter = group.named_parameters().begin();
-         param_iter != group.named_parameters().end();
-         ++param_iter) {
-      // if param name and gradient name match, run the optimizer step
-      const auto& named_gradient = named_gradients.find(param_iter->first);
-      if (named_gradient != named_gradients.end()) {
-        auto d_p = named_gradient->second;
-        auto p = param_iter->second;
+    internal::for_each_chunk(updates, [&](const Chunk& chunk) {
+      float* p = chunk.weights;
+      const float* grad = chunk.grads;
+      float* buf = chunk.buffers[0];
+      // The momentum buffer starts out as the first gradient.
+      const bool first_step = chunk.step == 1;
+      for (size_t i = 0; i < chunk.size; ++i) {
+        float d_p = grad[i];
         if (weight_decay != 0) {
-          // uses weight_decay specified and adds it to the gradient
-          add_out_hack(d_p, p, weight_decay, d_p);
+          d_p += weight_decay * p[i];
         }
         if (momentum != 0) {
-          Tensor buf(nullptr);
-          auto param_state = state_.find(p.unsafeGetTensorImpl());
-          // look for the momentum buffer for the given parameter. this is the
-          // momentum as of the previous epoch
-          if (param_state == state_.end()) {
-            // create a new momentum buffer if it doesn't exist. this memory
-            // needs to be freed when the optimizer is destroyed
-            void* buf_ptr = malloc(d_p.nbytes());
-
-#ifdef USE_ATEN_LIB
-            std::vector<int64_t> sizes(d_p.sizes().begin(), d_p.sizes().end());
-            buf = torch::from_blob(buf_ptr, sizes, d_p.scalar_type());
-#else
-            TensorImpl* buf_impl = new TensorImpl(
-                d_p.scalar_type(),
-                d_p.sizes().size(),
-                const_cast<TensorImpl::SizesType*>(d_p.sizes().data()),
-                buf_ptr,
-                const_cast<TensorImpl::DimOrderType*>(d_p.dim_order().data()));
-            buf = Tensor(buf_impl);
-#endif
-            clone_out_hack(d_p, buf);
-
-            // save the state of the momentum buffer to be reused in later
-            // epochs
-            auto state = std::make_unique<SGDParamState>(buf);
-            state_[p.unsafeGetTensorImpl()] = std::move(state);
-          } else {
-            buf = static_cast<SGDParamState&>(*param_state->second)
-                      .momentum_buffer();
-
-            // update the momentum buffer and apply dampening
-            mul_out_hack(buf, momentum, buf);
-            add_out_hack(buf, d_p, 1 - dampening, buf);
-          }
-          if (nesterov) {
-            // apply nesterov momentum
-            add_out_hack(d_p, buf, momentum, d_p);
-          } else {
-            d_p = buf;
-          }
+          buf[i] = first_step ? d_p : momentum * buf[i] + (1 - dampening) * d_p;
+          d_p = nesterov ? d_p + momentum * buf[i] : buf[i];
         }
         // update the parameter using the gradient and learning rate
-        add_out_hack(p, d_p, -1 * options.lr(), p);
+        p[i] -= lr * d_p;
       }
-    }
+    });
   }
   return Error::Ok;
 }
 
-SGD::~SGD() {
-  for (const auto& state_kv : state_) {
-    auto state_tensor = static_cast<SGDParamState&>(*state_kv.second);
-    free(state_tensor.momentum_buffer().unsafeGetTensorImpl()->mutable_data());
-#ifndef USE_ATEN_LIB
-    delete state_tensor.momentum_buffer().unsafeGetTensorImpl();
-#endif
-  }
-}
+SGD::~SGD() = default;
 
 } // namespace optimizer
 } // namespace training
@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <executorch/extension/training/optimizer/param_group_state.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <map>
@@ -176,6 +177,10 @@ class ET_EXPERIMENTAL SGDParamGroup {
 /**
  * SGD optimizer class. This is responsible for performing the optimization
  * step.
+ *
+ * Parameters may be fp32, fp16 or bf16 tensors. The optimizer keeps an fp32
+ * master copy of the parameters that are not fp32, and updates them through
+ * it. Gradients must have the dtype of their parameter, or be fp32.
  */
 class ET_EXPERIMENTAL SGD {
  public:
@@ -200,7 +205,9 @@ class ET_EXPERIMENTAL SGD {
   ~SGD();
 
   /**
-   * Performs the optimization step.
+   * Performs the optimization step. Updates all parameters of a param group
+   * in one fused pass, split between the threads of the threadpool if there
+   * is one. The gradients are not modified.
    *
    * @param[in] named_gradients The gradients of the tensors specified by the
    * fully qualified name.
@@ -211,7 +218,9 @@ class ET_EXPERIMENTAL SGD {
 
  private:
   std::vector<SGDParamGroup> param_groups_;
-  std::unordered_map<void*, std::unique_ptr<SGDParamState>> state_;
+  // The momentum buffers and master weights of each param group, allocated on
+  // its first step.
+  std::vector<std::unique_ptr<internal::ParamGroupState>> states_;
   std::unique_ptr<SGDOptions> defaults_;
 };
 
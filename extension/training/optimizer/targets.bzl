@@ -24,6 +24,26 @@ def define_common_targets():
         #         "//executorch/kernels/portable:generated_lib_headers",
         #     ]
 
+        runtime.cxx_library(
+            name = "param_group_state" + aten_suffix,
+            srcs = [
+                "param_group_state.cpp",
+            ],
+            exported_headers = [
+                "param_group_state.h",
+            ],
+            deps = [
+                "//executorch/extension/parallel:thread_parallel" + aten_suffix,
+            ],
+            exported_deps = [
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+            visibility = [
+                "//executorch/extension/training/...",
+            ],
+        )
+
         runtime.cxx_library(
             name = "sgd" + aten_suffix,
             srcs = [
@@ -33,6 +53,7 @@ def define_common_targets():
                 "sgd.h",
             ],
             exported_deps = [
+                ":param_group_state" + aten_suffix,
                 "//executorch/runtime/core:core",
                 "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
             ],  # + kernel_deps,
@@ -40,3 +61,21 @@ def define_common_targets():
                 "@EXECUTORCH_CLIENTS",
             ],
         )
+
+        runtime.cxx_library(
+            name = "adam" + aten_suffix,
+            srcs = [
+                "adam.cpp",
+            ],
+            exported_headers = [
+                "adam.h",
+            ],
+            exported_deps = [
+                ":param_group_state" + aten_suffix,
+                "//executorch/runtime/core:core",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+            visibility = [
+                "@EXECUTORCH_CLIENTS",
+            ],
+        )
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/training/optimizer/adam.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using ::executorch::extension::training::optimizer::Adam;
+using ::executorch::extension::training::optimizer::AdamOptions;
+using ::executorch::runtime::Error;
+using ::executorch::runtime::testing::TensorFactory;
+
+namespace {
+
+// Runs `steps` steps of Adam on a single value with a constant gradient.
+double reference_adam(
+    double p,
+    double grad,
+    int steps,
+    const AdamOptions& options) {
+  double exp_avg = 0;
+  double exp_avg_sq = 0;
+  for (int step = 1; step <= steps; ++step) {
+    double d_p = grad;
+    if (options.decoupled_weight_decay()) {
+      p *= 1 - options.lr() * options.weight_decay();
+    } else {
+      d_p += options.weight_decay() * p;
+    }
+    exp_avg = options.beta1() * exp_avg + (1 - options.beta1()) * d_p;
+    exp_avg_sq =
+        options.beta2() * exp_avg_sq + (1 - options.beta2()) * d_p * d_p;
+    const double bias_correction1 = 1 - std::pow(options.beta1(), step);
+    const double bias_correction2 = 1 - std::pow(options.beta2(), step);
+    p -= options.lr() / bias_correction1 * exp_avg /
+        (std::sqrt(exp_avg_sq / bias_correction2) + options.eps());
+  }
+  return p;
+}
+
+} // namespace
+
+class AdamOptimizerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    torch::executor::runtime_init();
+  }
+};
+
+TEST_F(AdamOptimizerTest, AdamOptionsDefaultValuesTest) {
+  AdamOptions options;
+
+  EXPECT_EQ(options.lr(), 1e-3);
+  EXPECT_EQ(options.beta1(), 0.9);
+  EXPECT_EQ(options.beta2(), 0.999);
+  EXPECT_EQ(options.eps(), 1e-8);
+  EXPECT_EQ(options.weight_decay(), 0);
+  EXPECT_FALSE(options.decoupled_weight_decay());
+
+  AdamOptions adamw = AdamOptions::adamw();
+  EXPECT_EQ(adamw.weight_decay(), 1e-2);
+  EXPECT_TRUE(adamw.decoupled_weight_decay());
+}
+
+TEST_F(AdamOptimizerTest, AdamOptimizerMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_parameters;
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_gradients;
+
+  named_parameters.insert({"param1", tf.make({1}, {1.0})});
+  named_parameters.insert({"param2", tf.make({1}, {2.0})});
+  named_gradients.insert({"param1", tf.make({1}, {-1})});
+  named_gradients.insert({"param2", tf.make({1}, {0.5})});
+
+  const AdamOptions options(0.01, 0.9, 0.999, 1e-8, 0.1);
+  Adam optimizer(named_parameters, options);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+  }
+
+  EXPECT_NEAR(
+      named_parameters.at("param1").const_data_ptr<float>()[0],
+      reference_adam(1.0, -1, 10, options),
+      1e-5);
+  EXPECT_NEAR(
+      named_parameters.at("param2").const_data_ptr<float>()[0],
+      reference_adam(2.0, 0.5, 10, options),
+      1e-5);
+}
+
+TEST_F(AdamOptimizerTest, AdamWOptimizerMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_parameters;
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_gradients;
+
+  named_parameters.insert({"param1", tf.make({1}, {1.0})});
+  named_gradients.insert({"param1", tf.make({1}, {-1})});
+
+  const AdamOptions options = AdamOptions::adamw(0.01, 0.9, 0.999, 1e-8, 0.5);
+  Adam optimizer(named_parameters, options);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+  }
+
+  EXPECT_NEAR(
+      named_parameters.at("param1").const_data_ptr<float>()[0],
+      reference_adam(1.0, -1, 10, options),
+      1e-5);
+}
+
+TEST_F(AdamOptimizerTest, AdamOptimizerBFloat16UsesMasterWeights) {
+  TensorFactory<ScalarType::BFloat16> tf;
+  TensorFactory<ScalarType::Float> tf_float;
+
+  // Large enough to be converted in several blocks.
+  constexpr int kNumel = 3000;
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_parameters;
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_gradients;
+
+  named_parameters.insert({"param1", tf.full({kNumel}, 1.0)});
+  // fp32 gradients of bf16 parameters are allowed too.
+  named_gradients.insert({"param1", tf_float.full({kNumel}, -1.0)});
+
+  // Each update is smaller than the precision of bf16 around 1, so it would
+  // be lost without the fp32 master weights.
+  const AdamOptions options(1e-3);
+  Adam optimizer(named_parameters, options);
+  for (int i = 0; i < 20; ++i) {
+    EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+  }
+
+  const double expected = reference_adam(1.0, -1, 20, options);
+  auto p1 = named_parameters.at("param1").const_data_ptr<exec_aten::BFloat16>();
+  for (int i = 0; i < kNumel; ++i) {
+    // bf16 has 8 bits of precision.
+    EXPECT_NEAR(static_cast<float>(p1[i]), expected, 1e-2);
+  }
+  EXPECT_GT(static_cast<float>(p1[0]), 1.0);
+}
@@ -112,3 +112,82 @@ TEST_F(SGDOptimizerTest, SGDOptimizerComplex) {
   EXPECT_NEAR(p1[0], 0.540303, 0.1);
   EXPECT_NEAR(p2[0], 0.620909, 0.1);
 }
+
+TEST_F(SGDOptimizerTest, SGDOptimizerMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Large enough to be split into several chunks.
+  constexpr int kNumel = 5000;
+  std::vector<float> param_data(kNumel);
+  std::vector<float> grad_data(kNumel);
+  for (int i = 0; i < kNumel; ++i) {
+    param_data[i] = 0.001f * (i % 100);
+    grad_data[i] = 0.01f * (i % 7) - 0.03f;
+  }
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_parameters;
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_gradients;
+  named_parameters.insert({"param1", tf.make({kNumel}, param_data)});
+  named_parameters.insert({"param2", tf.make({2}, {1.0, 2.0})});
+  named_gradients.insert({"param1", tf.make({kNumel}, grad_data)});
+  named_gradients.insert({"param2", tf.make({2}, {-1, 1})});
+
+  const double lr = 0.1;
+  const double momentum = 0.9;
+  const double dampening = 0.1;
+  const double weight_decay = 0.01;
+  SGD optimizer(
+      named_parameters,
+      SGDOptions{lr, momentum, dampening, weight_decay, true});
+
+  std::vector<double> expected(param_data.begin(), param_data.end());
+  std::vector<double> buf(kNumel);
+  for (int step = 0; step < 3; ++step) {
+    EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+    for (int i = 0; i < kNumel; ++i) {
+      double d_p = grad_data[i] + weight_decay * expected[i];
+      buf[i] = step == 0 ? d_p : momentum * buf[i] + (1 - dampening) * d_p;
+      expected[i] -= lr * (d_p + momentum * buf[i]);
+    }
+  }
+
+  // The gradients are not modified.
+  EXPECT_EQ(
+      named_gradients.at("param1").const_data_ptr<float>()[1], grad_data[1]);
+  auto p1 = named_parameters.at("param1").const_data_ptr<float>();
+  for (int i = 0; i < kNumel; ++i) {
+    EXPECT_NEAR(p1[i], expected[i], 1e-5);
+  }
+}
+
+TEST_F(SGDOptimizerTest, SGDOptimizerHalfUsesMasterWeights) {
+  TensorFactory<ScalarType::Half> tf;
+
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_parameters;
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_gradients;
+
+  named_parameters.insert({"param1", tf.make({1}, {exec_aten::Half(1.0f)})});
+  named_gradients.insert({"param1", tf.make({1}, {exec_aten::Half(-1.0f)})});
+
+  // Each update is smaller than the precision of fp16 around 1, so it would
+  // be lost without the fp32 master weights.
+  SGD optimizer(named_parameters, SGDOptions{1e-4});
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(optimizer.step(named_gradients), Error::Ok);
+  }
+
+  auto p1 = named_parameters.at("param1").const_data_ptr<exec_aten::Half>();
+  EXPECT_NEAR(static_cast<float>(p1[0]), 1.01, 1e-3);
+}
+
+TEST_F(SGDOptimizerTest, SGDOptimizerRejectsMismatchedGradient) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_parameters;
+  std::map<exec_aten::string_view, exec_aten::Tensor> named_gradients;
+
+  named_parameters.insert({"param1", tf.make({2}, {1, 2})});
+  named_gradients.insert({"param1", tf.make({1}, {-1})});
+
+  SGD optimizer(named_parameters, SGDOptions{0.1});
+  EXPECT_EQ(optimizer.step(named_gradients), Error::InvalidArgument);
+}
@@ -0,0 +1,115 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+"""Compares the JSON results of two runs of the kernel benchmarks.
+
+Usage:
+    python compare_benchmarks.py baseline.json results.json [--threshold 0.1]
+
+Both files are written by a Google Benchmark binary such as op_benchmark with
+--benchmark_out=<file> --benchmark_out_format=json. Prints the change in real
+time of every benchmark that both runs have, and exits with status 1 if any of
+them got slower than the baseline by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+from dataclasses import dataclass
+from typing import Dict, List, Optional
+
+# Factors that convert a Google Benchmark time_unit to nanoseconds.
+_TIME_UNIT_TO_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+@dataclass
+class Comparison:
+    name: str
+    baseline_ns: float
+    current_ns: float
+
+    @property
+    def change(self) -> float:
+        """Relative change of the time: 0.1 means 10% slower than baseline."""
+        return self.current_ns / self.baseline_ns - 1.0
+
+
+def load_times(results: Dict) -> Dict[str, float]:
+    """Returns the real time in nanoseconds of each benchmark in `results`.
+
+    With --benchmark_repetitions, uses the median of the repetitions rather
+    than any single one of them.
+    """
+    times: Dict[str, float] = {}
+    medians: Dict[str, float] = {}
+    for benchmark in results.get("benchmarks", []):
+        if benchmark.get("error_occurred"):
+            continue
+        time_ns = benchmark["real_time"] * _TIME_UNIT_TO_NS[benchmark["time_unit"]]
+        name = benchmark.get("run_name", benchmark["name"])
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                medians[name] = time_ns
+        else:
+            times.setdefault(name, time_ns)
+    times.update(medians)
+    return times
+
+
+def compare(baseline: Dict, current: Dict) -> List[Comparison]:
+    """Compares the benchmarks that both `baseline` and `current` ran."""
+    baseline_times = load_times(baseline)
+    current_times = load_times(current)
+    return [
+        Comparison(name, baseline_times[name], current_times[name])
+        for name in baseline_times
+        if name in current_times and baseline_times[name] > 0
+    ]
+
+
+def find_regressions(
+    comparisons: List[Comparison], threshold: float
+) -> List[Comparison]:
+    return [c for c in comparisons if c.change > threshold]
+
+
+def main(argv: Optional[List[str]] = None) -> int:
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("baseline", help="JSON results of the baseline run.")
+    parser.add_argument("current", help="JSON results to compare with it.")
+    parser.add_argument(
+        "--threshold",
+        type=float,
+        default=0.1,
+        help="Largest relative slowdown that is not a regression.",
+    )
+    args = parser.parse_args(argv)
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.current) as f:
+        current = json.load(f)
+
+    comparisons = compare(baseline, current)
+    if not comparisons:
+        print("The runs have no benchmarks in common.")
+        return 1
+    width = max(len(c.name) for c in comparisons)
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  Change")
+    for c in comparisons:
+        print(
+            f"{c.name:<{width}}  {c.baseline_ns / 1e3:>10.1f}us"
+            f"  {c.current_ns / 1e3:>10.1f}us  {c.change:+.1%}"
+        )
+
+    regressions = find_regressions(comparisons, args.threshold)
+    for c in regressions:
+        print(f"REGRESSION: {c.name} is {c.change:.1%} slower", file=sys.stderr)
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
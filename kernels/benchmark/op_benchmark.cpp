@@ -0,0 +1,827 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * @file
+ *
+ * Micro-benchmarks of the portable, optimized, quantized and custom kernels,
+ * on the shapes that Llama, MobileNet V2 and ViT run them with.
+ *
+ * Each benchmark is named <op>/<library>/<case>/<dtype>/threads:<n>, so that
+ * --benchmark_filter can select e.g. all the libraries that implement an op
+ * for a given case. Kernels of the optimized, quantized and custom libraries
+ * run on a threadpool of <n> threads; portable kernels are single threaded
+ * and only run with one.
+ *
+ * To compare against a baseline, write the results with
+ * --benchmark_out=<file> --benchmark_out_format=json and pass both files to
+ * compare_benchmarks.py.
+ */
+
+#include <executorch/extension/llm/custom_ops/op_rms_norm.h>
+#include <executorch/extension/llm/custom_ops/op_sdpa.h>
+#include <executorch/extension/threadpool/threadpool.h>
+#include <executorch/extension/threadpool/threadpool_guard.h>
+#include <executorch/kernels/optimized/NativeFunctions.h> // Declares the optimized operators
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/portable/NativeFunctions.h> // Declares the portable operators
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the quantized operators
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+#include <executorch/runtime/kernel/kernel_runtime_context.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using exec_aten::ArrayRef;
+using exec_aten::optional;
+using exec_aten::Scalar;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::extension::threadpool::ThreadPool;
+using executorch::extension::threadpool::ThreadPoolGuard;
+using executorch::runtime::Error;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::testing::TensorFactory;
+using executorch::runtime::toString;
+
+namespace native = torch::executor::native;
+
+using native::MathAccuracy;
+using native::MathKernel;
+
+namespace {
+
+using Sizes = std::vector<int32_t>;
+
+//
+// The shapes of the benchmarks, from the models that they are named after:
+// - Llama 3.2 1B: dim 2048, FFN dim 8192, 32 heads and 8 KV heads of 64,
+//   a 128 token prefill followed by decoding one token at a time.
+// - stories110M, a Llama with a vocabulary of 32000 and dim 768.
+// - MobileNet V2 on 224x224 images.
+// - ViT-B/16 on 224x224 images: 197 tokens, dim 768, MLP dim 3072, 12 heads.
+//
+
+struct UnaryCase {
+  const char* name;
+  Sizes input;
+};
+
+struct BinaryCase {
+  const char* name;
+  Sizes a;
+  Sizes b;
+};
+
+// Inputs of add: elementwise residual connections, and bias broadcasts.
+const BinaryCase kAddCases[] = {
+    {"mobilenet_v2_residual_56x56", {1, 24, 56, 56}, {1, 24, 56, 56}},
+    {"mobilenet_v2_residual_14x14", {1, 96, 14, 14}, {1, 96, 14, 14}},
+    {"vit_b16_residual", {1, 197, 768}, {1, 197, 768}},
+    {"vit_b16_bias", {1, 197, 768}, {768}},
+    {"llama3_1b_prefill_residual", {1, 128, 2048}, {1, 128, 2048}},
+};
+
+// Inputs of mm: activations [M, K] and weights [K, N]. Pointwise convolutions
+// of MobileNet are matrix multiplications over the pixels.
+const BinaryCase kMmCases[] = {
+    {"llama3_1b_decode_wq", {1, 2048}, {2048, 2048}},
+    {"llama3_1b_decode_w1", {1, 2048}, {2048, 8192}},
+    {"llama3_1b_prefill_wq", {32, 2048}, {2048, 2048}},
+    {"mobilenet_v2_expand_56x56", {3136, 24}, {24, 144}},
+    {"vit_b16_wq", {197, 768}, {768, 768}},
+};
+
+// Inputs of linear: activations [M, K] and weights [N, K].
+const BinaryCase kLinearCases[] = {
+    {"llama3_1b_decode_wq", {1, 2048}, {2048, 2048}},
+    {"llama3_1b_decode_w1", {1, 2048}, {8192, 2048}},
+    {"llama3_1b_prefill_wq", {32, 2048}, {2048, 2048}},
+};
+
+// Inputs of bmm: the attention scores and the attention-weighted values.
+const BinaryCase kBmmCases[] = {
+    {"vit_b16_attn_scores", {12, 197, 64}, {12, 64, 197}},
+    {"vit_b16_attn_values", {12, 197, 197}, {12, 197, 64}},
+    {"llama3_1b_prefill_attn_scores", {32, 128, 64}, {32, 64, 128}},
+};
+
+const UnaryCase kGeluCases[] = {
+    {"vit_b16_mlp", {1, 197, 3072}},
+};
+
+// The exp of softmax over the attention scores.
+const UnaryCase kExpCases[] = {
+    {"vit_b16_attn", {12, 197, 197}},
+};
+
+// The sigmoid of the SiLU of the FFN.
+const UnaryCase kSigmoidCases[] = {
+    {"llama3_1b_prefill_ffn", {1, 128, 8192}},
+};
+
+// log_softmax over the last dimension.
+const UnaryCase kLogSoftmaxCases[] = {
+    {"vit_b16_attn", {12, 197, 197}},
+    {"stories110m_logits", {1, 32000}},
+};
+
+// Layer norms and RMS norms over the last dimension.
+const UnaryCase kLayerNormCases[] = {
+    {"vit_b16", {1, 197, 768}},
+};
+
+const UnaryCase kRmsNormCases[] = {
+    {"llama3_1b_decode", {1, 1, 2048}},
+    {"llama3_1b_prefill", {1, 128, 2048}},
+};
+
+const UnaryCase kQuantizeCases[] = {
+    {"mobilenet_v2_expand_56x56", {1, 144, 56, 56}},
+    {"vit_b16_mlp", {1, 197, 3072}},
+};
+
+// Embedding tables [vocab, dim] and the number of tokens to look up.
+const BinaryCase kEmbeddingCases[] = {
+    {"stories110m_prefill", {32000, 768}, {128}},
+};
+
+// Queries [1, S, H, D] and KV caches [1, max_context, H_kv, D] of
+// custom_sdpa, which attends to the first start_pos + S positions.
+struct SdpaCase {
+  const char* name;
+  Sizes q;
+  Sizes kv;
+  int64_t start_pos;
+};
+
+const SdpaCase kSdpaCases[] = {
+    {"llama3_1b_decode_ctx1024", {1, 1, 32, 64}, {1, 1024, 8, 64}, 1023},
+    {"llama3_1b_prefill", {1, 128, 32, 64}, {1, 128, 8, 64}, 0},
+};
+
+const ScalarType kFloatTypes[] = {ScalarType::Float, ScalarType::Half};
+
+// Threadpool sizes of the kernels that use one.
+const size_t kNumThreads[] = {1, 2, 4};
+
+/**
+ * Creates tensors that live as long as it does, filled with small values
+ * rather than zeros so that no kernel takes a shortcut.
+ */
+class TensorMaker {
+ public:
+  Tensor make(ScalarType dtype, const Sizes& sizes) {
+    switch (dtype) {
+      case ScalarType::Float:
+        return make_filled(tf_float_, sizes);
+      case ScalarType::Half:
+        return make_filled(tf_half_, sizes);
+      case ScalarType::Char:
+        return make_filled(tf_char_, sizes);
+      default:
+        break;
+    }
+    ET_CHECK_MSG(false, "Unsupported dtype %s", toString(dtype));
+    return tf_float_.zeros(sizes);
+  }
+
+  /// Float values spread evenly over [lo, hi].
+  Tensor make_linspace(const Sizes& sizes, float lo, float hi) {
+    std::vector<float> data(numel(sizes));
+    const double step = data.size() > 1 ? (hi - lo) / (data.size() - 1.0) : 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<float>(lo + step * i);
+    }
+    return tf_float_.make(sizes, data);
+  }
+
+  /// Indices into the first dimension of a table of size `num_rows`.
+  Tensor make_indices(const Sizes& sizes, int64_t num_rows) {
+    std::vector<int64_t> data(numel(sizes));
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<int64_t>(i * 7919) % num_rows;
+    }
+    return tf_long_.make(sizes, data);
+  }
+
+  static size_t numel(const Sizes& sizes) {
+    size_t numel = 1;
+    for (int32_t size : sizes) {
+      numel *= size;
+    }
+    return numel;
+  }
+
+ private:
+  template <ScalarType DTYPE>
+  static Tensor make_filled(TensorFactory<DTYPE>& tf, const Sizes& sizes) {
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+    std::vector<CTYPE> data(numel(sizes));
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<CTYPE>(static_cast<int>(i % 17) - 8);
+      if (DTYPE != ScalarType::Char) {
+        data[i] = static_cast<CTYPE>(static_cast<float>(data[i]) / 8.0f);
+      }
+    }
+    return tf.make(sizes, data);
+  }
+
+  TensorFactory<ScalarType::Float> tf_float_;
+  TensorFactory<ScalarType::Half> tf_half_;
+  TensorFactory<ScalarType::Char> tf_char_;
+  TensorFactory<ScalarType::Long> tf_long_;
+};
+
+/// Returns a threadpool of `num_threads` threads, created on first use.
+ThreadPool* get_threadpool(size_t num_threads) {
+  static std::map<size_t, std::unique_ptr<ThreadPool>> threadpools;
+  std::unique_ptr<ThreadPool>& threadpool = threadpools[num_threads];
+  if (!threadpool) {
+    threadpool = std::make_unique<ThreadPool>(num_threads);
+  }
+  return threadpool.get();
+}
+
+/**
+ * Times `run`, which calls a kernel with `ctx`, on a threadpool of
+ * `num_threads` threads. The benchmark fails if the kernel does.
+ */
+void run_kernel(
+    benchmark::State& state,
+    size_t num_threads,
+    KernelRuntimeContext& ctx,
+    const std::function<void()>& run) {
+  ThreadPoolGuard guard(get_threadpool(num_threads));
+  // Also warms up the caches and the threadpool.
+  run();
+  if (ctx.failure_state() != Error::Ok) {
+    state.SkipWithError("The kernel failed");
+    return;
+  }
+  for (auto _ : state) {
+    run();
+    benchmark::ClobberMemory();
+  }
+}
+
+void set_bytes_processed(benchmark::State& state, const Tensor& out) {
+  state.SetBytesProcessed(
+      static_cast<int64_t>(state.iterations()) * out.nbytes());
+}
+
+void set_flops(benchmark::State& state, double flops) {
+  state.counters["FLOPS"] =
+      benchmark::Counter(flops, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/**
+ * Reports the largest error of the Float `out` against `reference` applied to
+ * `in`, in units in the last place of the reference, so that the speed of
+ * approximations can be weighed against their accuracy.
+ */
+void set_max_ulp_error(
+    benchmark::State& state,
+    const Tensor& in,
+    const Tensor& out,
+    double (*reference)(double)) {
+  const float* in_data = in.const_data_ptr<float>();
+  const float* out_data = out.const_data_ptr<float>();
+  double max_error = 0;
+  for (ssize_t i = 0; i < in.numel(); ++i) {
+    const double expected = reference(in_data[i]);
+    const float rounded = std::fabs(static_cast<float>(expected));
+    const double ulp = std::nextafter(rounded, INFINITY) - rounded;
+    max_error = std::max(max_error, std::fabs(out_data[i] - expected) / ulp);
+  }
+  state.counters["max_ulp"] = max_error;
+}
+
+/// Sets the MathAccuracy of a kernel of the optimized library while in scope.
+class MathAccuracyGuard {
+ public:
+  MathAccuracyGuard(MathKernel kernel, MathAccuracy accuracy)
+      : kernel_(kernel), previous_(native::get_math_accuracy(kernel)) {
+    native::set_math_accuracy(kernel, accuracy);
+  }
+
+  ~MathAccuracyGuard() {
+    native::set_math_accuracy(kernel_, previous_);
+  }
+
+ private:
+  const MathKernel kernel_;
+  const MathAccuracy previous_;
+};
+
+std::string benchmark_name(
+    const char* op,
+    const char* library,
+    const char* case_name,
+    ScalarType dtype,
+    size_t num_threads) {
+  return std::string(op) + "/" + library + "/" + case_name + "/" +
+      toString(dtype) + "/threads:" + std::to_string(num_threads);
+}
+
+//
+// Each register_* function registers the benchmarks of one op for all of its
+// cases and dtypes, for the libraries that implement it.
+//
+
+template <typename Fn>
+void register_benchmark(
+    const char* op,
+    const char* library,
+    const char* case_name,
+    ScalarType dtype,
+    Fn fn) {
+  // Portable kernels never use the threadpool.
+  const bool multithreaded = strcmp(library, "portable") != 0;
+  for (size_t num_threads : kNumThreads) {
+    if (!multithreaded && num_threads != 1) {
+      break;
+    }
+    benchmark::RegisterBenchmark(
+        benchmark_name(op, library, case_name, dtype, num_threads).c_str(),
+        [fn, num_threads](benchmark::State& state) { fn(state, num_threads); })
+        ->Unit(benchmark::kMicrosecond);
+  }
+}
+
+void register_add() {
+  using AddFn = Tensor& (*)(KernelRuntimeContext&,
+                            const Tensor&,
+                            const Tensor&,
+                            const Scalar&,
+                            Tensor&);
+  const std::pair<const char*, AddFn> kLibraries[] = {
+      {"portable", native::add_out},
+      {"optimized", native::opt_add_out},
+  };
+  for (const auto& [library, add] : kLibraries) {
+    for (const BinaryCase& c : kAddCases) {
+      for (ScalarType dtype : kFloatTypes) {
+        register_benchmark(
+            "add",
+            library,
+            c.name,
+            dtype,
+            [c, dtype, add = add](benchmark::State& state, size_t threads) {
+              TensorMaker maker;
+              Tensor a = maker.make(dtype, c.a);
+              Tensor b = maker.make(dtype, c.b);
+              Tensor out = maker.make(dtype, c.a);
+              KernelRuntimeContext ctx;
+              run_kernel(state, threads, ctx, [&]() {
+                add(ctx, a, b, /*alpha=*/1, out);
+              });
+              set_bytes_processed(state, out);
+            });
+      }
+    }
+  }
+}
+
+template <typename MatmulFn>
+void register_matmul(
+    const char* op,
+    const std::pair<const char*, MatmulFn>* libraries,
+    size_t num_libraries,
+    ArrayRef<BinaryCase> cases) {
+  for (size_t i = 0; i < num_libraries; ++i) {
+    const auto& [library, matmul] = libraries[i];
+    for (const BinaryCase& c : cases) {
+      for (ScalarType dtype : kFloatTypes) {
+        register_benchmark(
+            op,
+            library,
+            c.name,
+            dtype,
+            [c, dtype, matmul = matmul](
+                benchmark::State& state, size_t threads) {
+              TensorMaker maker;
+              Tensor a = maker.make(dtype, c.a);
+              Tensor b = maker.make(dtype, c.b);
+              // [..., M, K] x [..., K, N] = [..., M, N]
+              Sizes out_sizes = c.a;
+              out_sizes.back() = c.b.back();
+              Tensor out = maker.make(dtype, out_sizes);
+              KernelRuntimeContext ctx;
+              run_kernel(
+                  state, threads, ctx, [&]() { matmul(ctx, a, b, out); });
+              set_flops(
+                  state, 2.0 * TensorMaker::numel(out_sizes) * c.a.back());
+            });
+      }
+    }
+  }
+}
+
+void register_mm_and_bmm() {
+  using MatmulFn =
+      Tensor& (*)(KernelRuntimeContext&, const Tensor&, const Tensor&, Tensor&);
+  const std::pair<const char*, MatmulFn> kMmLibraries[] = {
+      {"portable", native::mm_out},
+      {"optimized", native::opt_mm_out},
+  };
+  register_matmul("mm", kMmLibraries, 2, kMmCases);
+  const std::pair<const char*, MatmulFn> kBmmLibraries[] = {
+      {"portable", native::bmm_out},
+      {"optimized", native::opt_bmm_out},
+  };
+  register_matmul("bmm", kBmmLibraries, 2, kBmmCases);
+}
+
+void register_linear() {
+  for (const BinaryCase& c : kLinearCases) {
+    // [M, K] x [N, K]^T = [M, N]
+    Sizes out_sizes = {c.a[0], c.b[0]};
+    const double flops = 2.0 * c.a[0] * c.a[1] * c.b[0];
+    for (ScalarType dtype : kFloatTypes) {
+      register_benchmark(
+          "linear",
+          "optimized",
+          c.name,
+          dtype,
+          [c, dtype, out_sizes, flops](
+              benchmark::State& state, size_t threads) {
+            TensorMaker maker;
+            Tensor in = maker.make(dtype, c.a);
+            Tensor weight = maker.make(dtype, c.b);
+            Tensor out = maker.make(dtype, out_sizes);
+            KernelRuntimeContext ctx;
+            run_kernel(state, threads, ctx, [&]() {
+              native::opt_linear_out(ctx, in, weight, /*bias=*/{}, out);
+            });
+            set_flops(state, flops);
+          });
+    }
+    // Int8 weights with a scale per output channel.
+    register_benchmark(
+        "linear",
+        "quantized",
+        c.name,
+        ScalarType::Char,
+        [c, out_sizes, flops](benchmark::State& state, size_t threads) {
+          TensorMaker maker;
+          Tensor in = maker.make(ScalarType::Float, c.a);
+          Tensor weight = maker.make(ScalarType::Char, c.b);
+          Tensor scales = maker.make(ScalarType::Float, {c.b[0]});
+          Tensor out = maker.make(ScalarType::Float, out_sizes);
+          KernelRuntimeContext ctx;
+          run_kernel(state, threads, ctx, [&]() {
+            native::quantized_mixed_linear_out(
+                ctx, in, weight, scales, /*opt_weight_zero_points=*/{}, {}, out);
+          });
+          set_flops(state, flops);
+        });
+  }
+}
+
+using UnaryFn = Tensor& (*)(KernelRuntimeContext&, const Tensor&, Tensor&);
+
+struct MathLibrary {
+  const char* name;
+  UnaryFn fn;
+  // Only affects the optimized kernels.
+  MathAccuracy accuracy;
+};
+
+/**
+ * Registers the benchmarks of an elementwise math op on Float inputs that span
+ * [-8, 8]. Each also reports its max_ulp error against `reference`.
+ */
+template <size_t N>
+void register_math(
+    const char* op,
+    MathKernel math_kernel,
+    const UnaryCase (&cases)[N],
+    const std::vector<MathLibrary>& libraries,
+    double (*reference)(double)) {
+  for (const MathLibrary& library : libraries) {
+    for (const UnaryCase& c : cases) {
+      register_benchmark(
+          op,
+          library.name,
+          c.name,
+          ScalarType::Float,
+          [c, math_kernel, library, reference](
+              benchmark::State& state, size_t threads) {
+            MathAccuracyGuard guard(math_kernel, library.accuracy);
+            TensorMaker maker;
+            Tensor in = maker.make_linspace(c.input, -8.0f, 8.0f);
+            Tensor out = maker.make(ScalarType::Float, c.input);
+            KernelRuntimeContext ctx;
+            run_kernel(
+                state, threads, ctx, [&]() { library.fn(ctx, in, out); });
+            set_bytes_processed(state, out);
+            set_max_ulp_error(state, in, out, reference);
+          });
+    }
+  }
+}
+
+void register_activations() {
+  // The optimized kernels run with both accuracies; optimized_fast uses the
+  // polynomial approximations of kernels/optimized/vec/fast_math.h.
+  register_math(
+      "exp",
+      MathKernel::kExp,
+      kExpCases,
+      {
+          {"portable", native::exp_out, MathAccuracy::kPrecise},
+          {"optimized", native::opt_exp_out, MathAccuracy::kPrecise},
+          {"optimized_fast", native::opt_exp_out, MathAccuracy::kFast},
+      },
+      [](double x) { return std::exp(x); });
+
+  register_math(
+      "sigmoid",
+      MathKernel::kSigmoid,
+      kSigmoidCases,
+      {
+          {"portable", native::sigmoid_out, MathAccuracy::kPrecise},
+          {"optimized", native::opt_sigmoid_out, MathAccuracy::kPrecise},
+          {"optimized_fast", native::opt_sigmoid_out, MathAccuracy::kFast},
+      },
+      [](double x) { return 1 / (1 + std::exp(-x)); });
+
+  const UnaryFn portable_gelu =
+      [](KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) -> Tensor& {
+    return native::gelu_out(ctx, in, "tanh", out);
+  };
+  const UnaryFn optimized_gelu =
+      [](KernelRuntimeContext& ctx, const Tensor& in, Tensor& out) -> Tensor& {
+    return native::opt_gelu_out(ctx, in, "tanh", out);
+  };
+  register_math(
+      "gelu",
+      MathKernel::kGelu,
+      kGeluCases,
+      {
+          {"portable", portable_gelu, MathAccuracy::kPrecise},
+          {"optimized", optimized_gelu, MathAccuracy::kPrecise},
+          {"optimized_fast", optimized_gelu, MathAccuracy::kFast},
+      },
+      [](double x) {
+        const double inner = M_SQRT2 * M_2_SQRTPI * 0.5 *
+            (x + 0.044715 * x * x * x);
+        return 0.5 * x * (1 + std::tanh(inner));
+      });
+
+  using LogSoftmaxFn = Tensor& (*)(KernelRuntimeContext&,
+                                   const Tensor&,
+                                   int64_t,
+                                   bool,
+                                   Tensor&);
+  const std::pair<const char*, LogSoftmaxFn> kLogSoftmaxLibraries[] = {
+      {"portable", native::log_softmax_out},
+      {"optimized", native::opt_log_softmax_out},
+  };
+  for (const auto& [library, log_softmax] : kLogSoftmaxLibraries) {
+    for (const UnaryCase& c : kLogSoftmaxCases) {
+      register_benchmark(
+          "log_softmax",
+          library,
+          c.name,
+          ScalarType::Float,
+          [c, log_softmax = log_softmax](
+              benchmark::State& state, size_t threads) {
+            TensorMaker maker;
+            Tensor in = maker.make(ScalarType::Float, c.input);
+            Tensor out = maker.make(ScalarType::Float, c.input);
+            KernelRuntimeContext ctx;
+            run_kernel(state, threads, ctx, [&]() {
+              log_softmax(ctx, in, /*dim=*/-1, /*half_to_float=*/false, out);
+            });
+            set_bytes_processed(state, out);
+          });
+    }
+  }
+}
+
+void register_norms() {
+  using LayerNormFn = std::tuple<Tensor&, Tensor&, Tensor&> (*)(
+      KernelRuntimeContext&,
+      const Tensor&,
+      ArrayRef<int64_t>,
+      const optional<Tensor>&,
+      const optional<Tensor>&,
+      double,
+      Tensor&,
+      Tensor&,
+      Tensor&);
+  const std::pair<const char*, LayerNormFn> kLayerNormLibraries[] = {
+      {"portable", native::native_layer_norm_out},
+      {"optimized", native::opt_native_layer_norm_out},
+  };
+  for (const auto& [library, layer_norm] : kLayerNormLibraries) {
+    for (const UnaryCase& c : kLayerNormCases) {
+      register_benchmark(
+          "native_layer_norm",
+          library,
+          c.name,
+          ScalarType::Float,
+          [c, layer_norm = layer_norm](
+              benchmark::State& state, size_t threads) {
+            TensorMaker maker;
+            Tensor in = maker.make(ScalarType::Float, c.input);
+            Tensor weight = maker.make(ScalarType::Float, {c.input.back()});
+            Tensor bias = maker.make(ScalarType::Float, {c.input.back()});
+            Tensor out = maker.make(ScalarType::Float, c.input);
+            Sizes stat_sizes = c.input;
+            stat_sizes.back() = 1;
+            Tensor mean = maker.make(ScalarType::Float, stat_sizes);
+            Tensor rstd = maker.make(ScalarType::Float, stat_sizes);
+            const int64_t normalized_shape = c.input.back();
+            KernelRuntimeContext ctx;
+            run_kernel(state, threads, ctx, [&]() {
+              layer_norm(
+                  ctx,
+                  in,
+                  ArrayRef<int64_t>(normalized_shape),
+                  weight,
+                  bias,
+                  /*eps=*/1e-5,
+                  out,
+                  mean,
+                  rstd);
+            });
+            set_bytes_processed(state, out);
+          });
+    }
+  }
+
+  for (const UnaryCase& c : kRmsNormCases) {
+    register_benchmark(
+        "rms_norm",
+        "custom",
+        c.name,
+        ScalarType::Float,
+        [c](benchmark::State& state, size_t threads) {
+          TensorMaker maker;
+          Tensor in = maker.make(ScalarType::Float, c.input);
+          Tensor weight = maker.make(ScalarType::Float, {c.input.back()});
+          Tensor out = maker.make(ScalarType::Float, c.input);
+          const int64_t normalized_shape = c.input.back();
+          KernelRuntimeContext ctx;
+          run_kernel(state, threads, ctx, [&]() {
+            native::rms_norm_out(
+                ctx,
+                in,
+                ArrayRef<int64_t>(normalized_shape),
+                weight,
+                /*eps=*/1e-5,
+                out);
+          });
+          set_bytes_processed(state, out);
+        });
+  }
+}
+
+void register_quantized() {
+  // Symmetric int8 quantization of activations.
+  constexpr double kScale = 0.05;
+  for (const UnaryCase& c : kQuantizeCases) {
+    register_benchmark(
+        "quantize_per_tensor",
+        "quantized",
+        c.name,
+        ScalarType::Float,
+        [c](benchmark::State& state, size_t threads) {
+          TensorMaker maker;
+          Tensor in = maker.make(ScalarType::Float, c.input);
+          Tensor out = maker.make(ScalarType::Char, c.input);
+          KernelRuntimeContext ctx;
+          run_kernel(state, threads, ctx, [&]() {
+            native::quantize_per_tensor_out(
+                ctx, in, kScale, 0, -128, 127, ScalarType::Char, out);
+          });
+          set_bytes_processed(state, out);
+        });
+    register_benchmark(
+        "dequantize_per_tensor",
+        "quantized",
+        c.name,
+        ScalarType::Char,
+        [c](benchmark::State& state, size_t threads) {
+          TensorMaker maker;
+          Tensor in = maker.make(ScalarType::Char, c.input);
+          Tensor out = maker.make(ScalarType::Float, c.input);
+          KernelRuntimeContext ctx;
+          run_kernel(state, threads, ctx, [&]() {
+            native::dequantize_per_tensor_out(
+                ctx,
+                in,
+                kScale,
+                0,
+                -128,
+                127,
+                ScalarType::Char,
+                ScalarType::Float,
+                out);
+          });
+          set_bytes_processed(state, out);
+        });
+  }
+
+  for (const BinaryCase& c : kEmbeddingCases) {
+    // c.a is the table and c.b the indices.
+    register_benchmark(
+        "embedding_byte",
+        "quantized",
+        c.name,
+        ScalarType::Char,
+        [c](benchmark::State& state, size_t threads) {
+          TensorMaker maker;
+          Tensor weight = maker.make(ScalarType::Char, c.a);
+          Tensor scales = maker.make(ScalarType::Float, {c.a[0]});
+          Tensor indices = maker.make_indices(c.b, c.a[0]);
+          Tensor out = maker.make(ScalarType::Float, {c.b[0], c.a[1]});
+          KernelRuntimeContext ctx;
+          run_kernel(state, threads, ctx, [&]() {
+            native::quantized_embedding_byte_out(
+                ctx, weight, scales, /*opt_weight_zero_points=*/{}, -128, 127,
+                indices, out);
+          });
+          set_bytes_processed(state, out);
+        });
+  }
+}
+
+void register_sdpa() {
+  for (const SdpaCase& c : kSdpaCases) {
+    register_benchmark(
+        "sdpa",
+        "custom",
+        c.name,
+        ScalarType::Float,
+        [c](benchmark::State& state, size_t threads) {
+          TensorMaker maker;
+          Tensor q = maker.make(ScalarType::Float, c.q);
+          Tensor k = maker.make(ScalarType::Float, c.kv);
+          Tensor v = maker.make(ScalarType::Float, c.kv);
+          Tensor out = maker.make(ScalarType::Float, c.q);
+          KernelRuntimeContext ctx;
+          run_kernel(state, threads, ctx, [&]() {
+            native::custom_sdpa_out(
+                ctx,
+                q,
+                k,
+                v,
+                c.start_pos,
+                /*attn_mask=*/{},
+                /*dropout_p=*/0.0,
+                /*is_causal=*/true,
+                /*scale=*/{},
+                out);
+          });
+          // q @ k^T and the weighted sum of v, over all the attended positions.
+          const int64_t seq_len = c.q[1];
+          const int64_t num_heads = c.q[2];
+          const int64_t head_dim = c.q[3];
+          set_flops(
+              state,
+              4.0 * num_heads * seq_len * (c.start_pos + seq_len) * head_dim);
+        });
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  executorch::runtime::runtime_init();
+  register_add();
+  register_mm_and_bmm();
+  register_linear();
+  register_activations();
+  register_norms();
+  register_quantized();
+  register_sdpa();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
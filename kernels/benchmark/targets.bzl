@@ -0,0 +1,30 @@
+load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+
+def define_common_targets():
+    """Defines targets that should be shared between fbcode and xplat.
+
+    The directory containing this targets.bzl file should also contain both
+    TARGETS and BUCK files that call this function.
+    """
+
+    runtime.cxx_binary(
+        name = "op_benchmark",
+        srcs = [
+            "op_benchmark.cpp",
+        ],
+        define_static_target = False,
+        deps = [
+            "//executorch/extension/llm/custom_ops:custom_ops",
+            "//executorch/extension/threadpool:threadpool",
+            "//executorch/kernels/optimized:generated_lib_headers",
+            "//executorch/kernels/optimized:optimized_operators",
+            "//executorch/kernels/optimized/cpu:vec_kernels",
+            "//executorch/kernels/portable:generated_lib_headers",
+            "//executorch/kernels/portable:operators",
+            "//executorch/kernels/quantized:generated_lib_headers",
+            "//executorch/kernels/quantized:quantized_operators",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+            "//executorch/runtime/platform:platform",
+            "//third-party/benchmark:benchmark",
+        ],
+    )
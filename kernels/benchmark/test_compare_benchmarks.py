@@ -0,0 +1,70 @@
+# Copyright (c) Meta Platforms, Inc. and affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+
+import unittest
+
+from executorch.kernels.benchmark.compare_benchmarks import (
+    compare,
+    find_regressions,
+    load_times,
+)
+
+
+def _run(name, real_time, time_unit="us", **kwargs):
+    return {
+        "name": name,
+        "run_name": name,
+        "run_type": "iteration",
+        "real_time": real_time,
+        "time_unit": time_unit,
+        **kwargs,
+    }
+
+
+class TestCompareBenchmarks(unittest.TestCase):
+    def test_load_times_converts_units(self):
+        times = load_times(
+            {"benchmarks": [_run("a", 2.0, "us"), _run("b", 3.0, "ms")]}
+        )
+        self.assertEqual(times, {"a": 2e3, "b": 3e6})
+
+    def test_load_times_prefers_median_and_skips_errors(self):
+        results = {
+            "benchmarks": [
+                _run("a", 1.0),
+                _run("a", 5.0),
+                _run(
+                    "a_median",
+                    3.0,
+                    run_name="a",
+                    run_type="aggregate",
+                    aggregate_name="median",
+                ),
+                _run(
+                    "a_mean",
+                    4.0,
+                    run_name="a",
+                    run_type="aggregate",
+                    aggregate_name="mean",
+                ),
+                _run("failed", 1.0, error_occurred=True),
+            ]
+        }
+        self.assertEqual(load_times(results), {"a": 3e3})
+
+    def test_find_regressions(self):
+        baseline = {"benchmarks": [_run("a", 100.0), _run("b", 100.0)]}
+        current = {
+            "benchmarks": [_run("a", 105.0), _run("b", 120.0), _run("c", 1.0)]
+        }
+        comparisons = compare(baseline, current)
+        # Only the benchmarks that both runs have are compared.
+        self.assertEqual([c.name for c in comparisons], ["a", "b"])
+        self.assertAlmostEqual(comparisons[1].change, 0.2)
+
+        regressions = find_regressions(comparisons, threshold=0.1)
+        self.assertEqual([c.name for c in regressions], ["b"])
+        self.assertEqual(find_regressions(comparisons, threshold=0.25), [])
@@ -8,12 +8,23 @@
 
 #include <executorch/kernels/optimized/blas/BlasKernel.h>
 
+#include <executorch/kernels/optimized/vec/vec_half.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
 #ifdef __aarch64__
 #include <arm_neon.h>
 #include <cpuinfo.h>
 #endif
 
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
 using torch::executor::BFloat16;
+using torch::executor::Half;
 
 namespace executorch {
 namespace cpublas {
@@ -115,11 +126,31 @@ static ET_INLINE void dot_with_fp32_arith_main_inner_loop_no_bfdot(
       vget_high_u16(temp_vec2));
 }
 
-template <bool useBfdot>
+static ET_INLINE void dot_with_fp32_arith_main_inner_loop_no_bfdot(
+    const Half* vec1,
+    const Half* vec2,
+    float32x4_t sum[kF32RegistersPerIteration],
+    int registerPairIndex) {
+  const float16x8_t temp_vec1 = vld1q_f16(reinterpret_cast<const float16_t*>(
+      &vec1[registerPairIndex * 2 * kF32ElementsPerRegister]));
+  const float16x8_t temp_vec2 = vld1q_f16(reinterpret_cast<const float16_t*>(
+      &vec2[registerPairIndex * 2 * kF32ElementsPerRegister]));
+
+  sum[2 * registerPairIndex] = f32_fma(
+      sum[2 * registerPairIndex],
+      vcvt_f32_f16(vget_low_f16(temp_vec1)),
+      vcvt_f32_f16(vget_low_f16(temp_vec2)));
+  sum[2 * registerPairIndex + 1] = f32_fma(
+      sum[2 * registerPairIndex + 1],
+      vcvt_high_f32_f16(temp_vec1),
+      vcvt_high_f32_f16(temp_vec2));
+}
+
+template <bool useBfdot, typename T>
 ET_TARGET_ARM_BF16_ATTRIBUTE static ET_INLINE void
 dot_with_fp32_arith_main_inner_loop(
-    const BFloat16* vec1,
-    const BFloat16* vec2,
+    const T* vec1,
+    const T* vec2,
     float32x4_t sum[kF32RegistersPerIteration],
     int registerPairIndex) {
   if constexpr (useBfdot) {
@@ -143,6 +174,19 @@ static ET_INLINE void dot_with_fp32_arith_vectorized_tail_inner_loop(
   *tailSum = f32_fma_bf16(*tailSum, temp_vec1, temp_vec2);
 }
 
+static ET_INLINE void dot_with_fp32_arith_vectorized_tail_inner_loop(
+    const Half* vec1,
+    const Half* vec2,
+    float32x4_t* tailSum,
+    int idx) {
+  const auto temp_vec1 =
+      vld1_f16(reinterpret_cast<const float16_t*>(&vec1[idx]));
+  const auto temp_vec2 =
+      vld1_f16(reinterpret_cast<const float16_t*>(&vec2[idx]));
+  *tailSum =
+      f32_fma(*tailSum, vcvt_f32_f16(temp_vec1), vcvt_f32_f16(temp_vec2));
+}
+
 namespace {
 template <int n>
 struct ForcedUnrollTargetBFloat16 {
@@ -193,7 +237,7 @@ dot_with_fp32_arith(const T* vec1, const T* vec2, int64_t len) {
 
   // Second-tier tail fixup: handle all workloads.
   for (int j = len_aligned_4; j < len; ++j) {
-    reducedSum += vec1[j] * vec2[j];
+    reducedSum += static_cast<float>(vec1[j]) * static_cast<float>(vec2[j]);
   }
   return reducedSum;
 }
@@ -208,7 +252,553 @@ float bf16_dot_with_fp32_arith(
     return dot_with_fp32_arith<BFloat16, false>(vec1, vec2, len);
   }
 }
+
+float fp16_dot_with_fp32_arith(
+    const Half* vec1,
+    const Half* vec2,
+    int64_t len) {
+  return dot_with_fp32_arith<Half, false>(vec1, vec2, len);
+}
 #endif // __aarch64__
+
+namespace {
+
+// Micro-kernels compute c += a @ b for one kMR x kNR tile of column-major c,
+// where a holds kc columns of kMR packed rows and b holds kc rows of kNR
+// packed columns. Their accumulators fill most of the vector registers.
+
+template <typename T, int64_t MR, int64_t NR>
+struct GenericMicroKernel {
+  static constexpr int64_t kMR = MR;
+  static constexpr int64_t kNR = NR;
+
+  static void run(int64_t kc, const T* a, const T* b, T* c, int64_t ldc) {
+    T acc[NR][MR] = {};
+    for (int64_t p = 0; p < kc; ++p) {
+      for (int64_t j = 0; j < NR; ++j) {
+        const T b_pj = b[j];
+        for (int64_t i = 0; i < MR; ++i) {
+          acc[j][i] += a[i] * b_pj;
+        }
+      }
+      a += MR;
+      b += NR;
+    }
+    for (int64_t j = 0; j < NR; ++j) {
+      for (int64_t i = 0; i < MR; ++i) {
+        c[j * ldc + i] += acc[j][i];
+      }
+    }
+  }
+};
+
+#if defined(__AVX512F__)
+struct Float32MicroKernel {
+  static constexpr int64_t kMR = 32;
+  static constexpr int64_t kNR = 8;
+
+  static void
+  run(int64_t kc, const float* a, const float* b, float* c, int64_t ldc) {
+    __m512 acc[kNR][2];
+    for (int64_t j = 0; j < kNR; ++j) {
+      acc[j][0] = _mm512_setzero_ps();
+      acc[j][1] = _mm512_setzero_ps();
+    }
+    for (int64_t p = 0; p < kc; ++p) {
+      const __m512 a0 = _mm512_loadu_ps(a);
+      const __m512 a1 = _mm512_loadu_ps(a + 16);
+      utils::ForcedUnroll<kNR>{}([&](auto j) ET_INLINE_ATTRIBUTE {
+        const __m512 b_pj = _mm512_set1_ps(b[j]);
+        acc[j][0] = _mm512_fmadd_ps(a0, b_pj, acc[j][0]);
+        acc[j][1] = _mm512_fmadd_ps(a1, b_pj, acc[j][1]);
+      });
+      a += kMR;
+      b += kNR;
+    }
+    for (int64_t j = 0; j < kNR; ++j) {
+      float* c_j = c + j * ldc;
+      _mm512_storeu_ps(c_j, _mm512_add_ps(_mm512_loadu_ps(c_j), acc[j][0]));
+      _mm512_storeu_ps(
+          c_j + 16, _mm512_add_ps(_mm512_loadu_ps(c_j + 16), acc[j][1]));
+    }
+  }
+};
+#elif defined(__AVX2__) && defined(__FMA__)
+struct Float32MicroKernel {
+  static constexpr int64_t kMR = 16;
+  static constexpr int64_t kNR = 6;
+
+  static void
+  run(int64_t kc, const float* a, const float* b, float* c, int64_t ldc) {
+    __m256 acc[kNR][2];
+    for (int64_t j = 0; j < kNR; ++j) {
+      acc[j][0] = _mm256_setzero_ps();
+      acc[j][1] = _mm256_setzero_ps();
+    }
+    for (int64_t p = 0; p < kc; ++p) {
+      const __m256 a0 = _mm256_loadu_ps(a);
+      const __m256 a1 = _mm256_loadu_ps(a + 8);
+      utils::ForcedUnroll<kNR>{}([&](auto j) ET_INLINE_ATTRIBUTE {
+        const __m256 b_pj = _mm256_broadcast_ss(b + j);
+        acc[j][0] = _mm256_fmadd_ps(a0, b_pj, acc[j][0]);
+        acc[j][1] = _mm256_fmadd_ps(a1, b_pj, acc[j][1]);
+      });
+      a += kMR;
+      b += kNR;
+    }
+    for (int64_t j = 0; j < kNR; ++j) {
+      float* c_j = c + j * ldc;
+      _mm256_storeu_ps(c_j, _mm256_add_ps(_mm256_loadu_ps(c_j), acc[j][0]));
+      _mm256_storeu_ps(
+          c_j + 8, _mm256_add_ps(_mm256_loadu_ps(c_j + 8), acc[j][1]));
+    }
+  }
+};
+#elif defined(__aarch64__)
+struct Float32MicroKernel {
+  static constexpr int64_t kMR = 8;
+  static constexpr int64_t kNR = 8;
+
+  static void
+  run(int64_t kc, const float* a, const float* b, float* c, int64_t ldc) {
+    float32x4_t acc[kNR][2];
+    for (int64_t j = 0; j < kNR; ++j) {
+      acc[j][0] = vdupq_n_f32(0);
+      acc[j][1] = vdupq_n_f32(0);
+    }
+    for (int64_t p = 0; p < kc; ++p) {
+      const float32x4_t a0 = vld1q_f32(a);
+      const float32x4_t a1 = vld1q_f32(a + 4);
+      const float32x4_t b0 = vld1q_f32(b);
+      const float32x4_t b1 = vld1q_f32(b + 4);
+      // The lane must be a constant expression, so spell out the columns.
+#define ET_GEMM_FMA_COLUMN(j, b_p, lane)                     \
+  acc[j][0] = vfmaq_laneq_f32(acc[j][0], a0, b_p, lane); \
+  acc[j][1] = vfmaq_laneq_f32(acc[j][1], a1, b_p, lane)
+      ET_GEMM_FMA_COLUMN(0, b0, 0);
+      ET_GEMM_FMA_COLUMN(1, b0, 1);
+      ET_GEMM_FMA_COLUMN(2, b0, 2);
+      ET_GEMM_FMA_COLUMN(3, b0, 3);
+      ET_GEMM_FMA_COLUMN(4, b1, 0);
+      ET_GEMM_FMA_COLUMN(5, b1, 1);
+      ET_GEMM_FMA_COLUMN(6, b1, 2);
+      ET_GEMM_FMA_COLUMN(7, b1, 3);
+#undef ET_GEMM_FMA_COLUMN
+      a += kMR;
+      b += kNR;
+    }
+    for (int64_t j = 0; j < kNR; ++j) {
+      float* c_j = c + j * ldc;
+      vst1q_f32(c_j, vaddq_f32(vld1q_f32(c_j), acc[j][0]));
+      vst1q_f32(c_j + 4, vaddq_f32(vld1q_f32(c_j + 4), acc[j][1]));
+    }
+  }
+};
+#else
+using Float32MicroKernel = GenericMicroKernel<float, 8, 4>;
+#endif
+
+using Float64MicroKernel = GenericMicroKernel<double, 8, 4>;
+
+constexpr int64_t round_up(int64_t x, int64_t multiple) {
+  return (x + multiple - 1) / multiple * multiple;
+}
+
+// The depth of the packed panels, sized so that a kMR x kKC panel of a stays
+// in L1 while the micro-kernel sweeps over a panel of b.
+constexpr int64_t kKC = 256;
+
+/**
+ * Widens n elements of src, src_stride apart, into dst, dst_stride apart.
+ * Contiguous runs of Half and BFloat16 are converted in bulk.
+ */
+template <typename scalar_t, typename acc_t>
+void widen(
+    const scalar_t* src,
+    int64_t src_stride,
+    acc_t* dst,
+    int64_t dst_stride,
+    int64_t n) {
+  if (src_stride == 1 && dst_stride == 1) {
+    vec::convert(src, dst, n);
+  } else if (src_stride == 1 && !std::is_same<scalar_t, acc_t>::value) {
+    acc_t buffer[kKC];
+    for (int64_t i = 0; i < n; i += kKC) {
+      const int64_t len = std::min(kKC, n - i);
+      vec::convert(src + i, buffer, len);
+      for (int64_t j = 0; j < len; ++j) {
+        dst[(i + j) * dst_stride] = buffer[j];
+      }
+    }
+  } else {
+    for (int64_t i = 0; i < n; ++i) {
+      dst[i * dst_stride] = static_cast<acc_t>(src[i * src_stride]);
+    }
+  }
+}
+
+/**
+ * Packs rows [i, i + mc) and columns [l, l + kc) of a, whose element (i, l)
+ * is at a[i * row_stride + l * col_stride], into consecutive panels of MR
+ * rows, each stored column by column. Rows past mc are zero-filled.
+ */
+template <int64_t MR, typename scalar_t, typename acc_t>
+void pack_a(
+    int64_t mc,
+    int64_t kc,
+    const scalar_t* a,
+    int64_t row_stride,
+    int64_t col_stride,
+    acc_t* packed) {
+  for (int64_t ir = 0; ir < mc; ir += MR) {
+    const int64_t mr = std::min(MR, mc - ir);
+    const scalar_t* a_ir = a + ir * row_stride;
+    // Read along whichever direction is contiguous.
+    if (row_stride == 1) {
+      for (int64_t l = 0; l < kc; ++l) {
+        widen(a_ir + l * col_stride, 1, packed + l * MR, 1, mr);
+      }
+    } else {
+      for (int64_t i = 0; i < mr; ++i) {
+        widen(a_ir + i * row_stride, col_stride, packed + i, MR, kc);
+      }
+    }
+    if (mr < MR) {
+      for (int64_t l = 0; l < kc; ++l) {
+        std::fill(packed + l * MR + mr, packed + (l + 1) * MR, acc_t(0));
+      }
+    }
+    packed += kc * MR;
+  }
+}
+
+/**
+ * Packs rows [l, l + kc) and columns [j, j + nc) of b, whose element (l, j)
+ * is at b[l * row_stride + j * col_stride], into consecutive panels of NR
+ * columns, each stored row by row. Columns past nc are zero-filled.
+ */
+template <int64_t NR, typename scalar_t, typename acc_t>
+void pack_b(
+    int64_t kc,
+    int64_t nc,
+    const scalar_t* b,
+    int64_t row_stride,
+    int64_t col_stride,
+    acc_t* packed) {
+  for (int64_t jr = 0; jr < nc; jr += NR) {
+    const int64_t nr = std::min(NR, nc - jr);
+    const scalar_t* b_jr = b + jr * col_stride;
+    if (col_stride == 1) {
+      for (int64_t l = 0; l < kc; ++l) {
+        widen(b_jr + l * row_stride, 1, packed + l * NR, 1, nr);
+      }
+    } else {
+      for (int64_t j = 0; j < nr; ++j) {
+        widen(b_jr + j * col_stride, row_stride, packed + j, NR, kc);
+      }
+    }
+    if (nr < NR) {
+      for (int64_t l = 0; l < kc; ++l) {
+        std::fill(packed + l * NR + nr, packed + (l + 1) * NR, acc_t(0));
+      }
+    }
+    packed += kc * NR;
+  }
+}
+
+// Each task computes one kMC x kNC block of c, small enough for its packed
+// panels to stay in L2.
+template <typename MicroKernel>
+struct PanelSizes {
+  static constexpr int64_t kMC = round_up(128, MicroKernel::kMR);
+  static constexpr int64_t kNC = MicroKernel::kNR * 32;
+};
+
+// A prepacked op(a) holds the panels that gemm_packed_impl() would pack, for
+// each block of kMC rows and then for each block of kKC columns. Every block
+// but the last in each direction is full, so the panels of the block at (ic,
+// pc) start after ic rows of k columns, and pc columns of this block's rows.
+template <typename MicroKernel>
+int64_t prepacked_a_offset(int64_t ic, int64_t pc, int64_t k, int64_t mc) {
+  return ic * k + pc * round_up(mc, MicroKernel::kMR);
+}
+
+template <typename MicroKernel>
+int64_t prepacked_a_size(int64_t m, int64_t k) {
+  return round_up(m, MicroKernel::kMR) * k;
+}
+
+// The packed panels and the accumulator of one thread's blocks. Allocated on
+// the first call on each thread and reused by later ones, so that a call
+// doesn't allocate and zero hundreds of KB per task.
+template <typename MicroKernel, typename acc_t>
+struct PanelScratch {
+  static constexpr int64_t kMC = PanelSizes<MicroKernel>::kMC;
+  static constexpr int64_t kNC = PanelSizes<MicroKernel>::kNC;
+
+  std::vector<acc_t> packed_a = std::vector<acc_t>(kMC * kKC);
+  std::vector<acc_t> packed_b = std::vector<acc_t>(kKC * kNC);
+  // Accumulates a block across all of k before it is scaled into c, so that
+  // narrow types are only rounded once.
+  std::vector<acc_t> acc = std::vector<acc_t>(kMC * kNC);
+
+  static PanelScratch& get() {
+    thread_local PanelScratch scratch;
+    return scratch;
+  }
+};
+
+template <typename MicroKernel, typename scalar_t, typename acc_t>
+void prepack_a_impl(
+    bool transa,
+    int64_t m,
+    int64_t k,
+    const scalar_t* a,
+    int64_t lda,
+    acc_t* packed) {
+  constexpr int64_t kMC = PanelSizes<MicroKernel>::kMC;
+  const int64_t a_row_stride = transa ? lda : 1;
+  const int64_t a_col_stride = transa ? 1 : lda;
+  for (int64_t ic = 0; ic < m; ic += kMC) {
+    const int64_t mc = std::min(kMC, m - ic);
+    for (int64_t pc = 0; pc < k; pc += kKC) {
+      pack_a<MicroKernel::kMR>(
+          mc,
+          std::min(kKC, k - pc),
+          a + ic * a_row_stride + pc * a_col_stride,
+          a_row_stride,
+          a_col_stride,
+          packed + prepacked_a_offset<MicroKernel>(ic, pc, k, mc));
+    }
+  }
+}
+
+template <typename MicroKernel, typename scalar_t, typename acc_t>
+void gemm_packed_impl(
+    bool transa,
+    bool transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    acc_t alpha,
+    const scalar_t* a,
+    int64_t lda,
+    const scalar_t* b,
+    int64_t ldb,
+    acc_t beta,
+    scalar_t* c,
+    int64_t ldc,
+    const acc_t* prepacked_a) {
+  constexpr int64_t kMR = MicroKernel::kMR;
+  constexpr int64_t kNR = MicroKernel::kNR;
+  constexpr int64_t kMC = PanelSizes<MicroKernel>::kMC;
+  constexpr int64_t kNC = PanelSizes<MicroKernel>::kNC;
+
+  // op(a)(i, l) and op(b)(l, j) in terms of the column-major inputs.
+  const int64_t a_row_stride = transa ? lda : 1;
+  const int64_t a_col_stride = transa ? 1 : lda;
+  const int64_t b_row_stride = transb ? ldb : 1;
+  const int64_t b_col_stride = transb ? 1 : ldb;
+
+  const int64_t m_blocks = utils::divup(m, kMC);
+  const int64_t n_blocks = utils::divup(n, kNC);
+  executorch::extension::parallel_for(
+      0, m_blocks * n_blocks, 1, [&](int64_t begin, int64_t end) {
+        auto& scratch = PanelScratch<MicroKernel, acc_t>::get();
+        std::vector<acc_t>& packed_a = scratch.packed_a;
+        std::vector<acc_t>& packed_b = scratch.packed_b;
+        std::vector<acc_t>& acc = scratch.acc;
+        for (int64_t block = begin; block < end; ++block) {
+          const int64_t ic = (block / n_blocks) * kMC;
+          const int64_t jc = (block % n_blocks) * kNC;
+          const int64_t mc = std::min(kMC, m - ic);
+          const int64_t nc = std::min(kNC, n - jc);
+          const int64_t mc_padded = round_up(mc, kMR);
+          const int64_t nc_padded = round_up(nc, kNR);
+          std::fill(acc.begin(), acc.begin() + mc_padded * nc_padded, 0);
+
+          for (int64_t pc = 0; pc < k; pc += kKC) {
+            const int64_t kc = std::min(kKC, k - pc);
+            const acc_t* panels_a = prepacked_a == nullptr
+                ? packed_a.data()
+                : prepacked_a + prepacked_a_offset<MicroKernel>(ic, pc, k, mc);
+            if (prepacked_a == nullptr) {
+              pack_a<kMR>(
+                  mc,
+                  kc,
+                  a + ic * a_row_stride + pc * a_col_stride,
+                  a_row_stride,
+                  a_col_stride,
+                  packed_a.data());
+            }
+            pack_b<kNR>(
+                kc,
+                nc,
+                b + pc * b_row_stride + jc * b_col_stride,
+                b_row_stride,
+                b_col_stride,
+                packed_b.data());
+            for (int64_t jr = 0; jr < nc_padded; jr += kNR) {
+              for (int64_t ir = 0; ir < mc_padded; ir += kMR) {
+                MicroKernel::run(
+                    kc,
+                    panels_a + ir * kc,
+                    packed_b.data() + jr * kc,
+                    acc.data() + jr * mc_padded + ir,
+                    mc_padded);
+              }
+            }
+          }
+
+          for (int64_t j = 0; j < nc; ++j) {
+            acc_t* acc_j = acc.data() + j * mc_padded;
+            scalar_t* c_j = c + (jc + j) * ldc + ic;
+            // As in BLAS, c is not read if beta is zero, so it may hold NaNs.
+            if (beta == acc_t(0)) {
+              for (int64_t i = 0; i < mc; ++i) {
+                acc_j[i] = alpha * acc_j[i];
+              }
+            } else {
+              acc_t c_acc[kMC];
+              widen(c_j, 1, c_acc, 1, mc);
+              for (int64_t i = 0; i < mc; ++i) {
+                acc_j[i] = alpha * acc_j[i] + beta * c_acc[i];
+              }
+            }
+            vec::convert(acc_j, c_j, mc);
+          }
+        }
+      });
+}
+
+} // namespace
+
+// clang-format off
+void gemm_packed(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    double alpha,
+    const double *a, int64_t lda,
+    const double *b, int64_t ldb,
+    double beta,
+    double *c, int64_t ldc,
+    const void *packed_a) {
+  gemm_packed_impl<Float64MicroKernel>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+      static_cast<const double*>(packed_a));
+}
+
+void gemm_packed(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const float *a, int64_t lda,
+    const float *b, int64_t ldb,
+    float beta,
+    float *c, int64_t ldc,
+    const void *packed_a) {
+  gemm_packed_impl<Float32MicroKernel>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+      static_cast<const float*>(packed_a));
+}
+
+void gemm_packed(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const Half *a, int64_t lda,
+    const Half *b, int64_t ldb,
+    float beta,
+    Half *c, int64_t ldc,
+    const void *packed_a) {
+  gemm_packed_impl<Float32MicroKernel>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+      static_cast<const float*>(packed_a));
+}
+
+void gemm_packed(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const BFloat16 *a, int64_t lda,
+    const BFloat16 *b, int64_t ldb,
+    float beta,
+    BFloat16 *c, int64_t ldc,
+    const void *packed_a) {
+  gemm_packed_impl<Float32MicroKernel>(
+      transa, transb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+      static_cast<const float*>(packed_a));
+}
+// clang-format on
+
+template <>
+size_t prepacked_a_nbytes<double>(int64_t m, int64_t k) {
+  return prepacked_a_size<Float64MicroKernel>(m, k) * sizeof(double);
+}
+
+template <>
+size_t prepacked_a_nbytes<float>(int64_t m, int64_t k) {
+  return prepacked_a_size<Float32MicroKernel>(m, k) * sizeof(float);
+}
+
+template <>
+size_t prepacked_a_nbytes<Half>(int64_t m, int64_t k) {
+  return prepacked_a_nbytes<float>(m, k);
+}
+
+template <>
+size_t prepacked_a_nbytes<BFloat16>(int64_t m, int64_t k) {
+  return prepacked_a_nbytes<float>(m, k);
+}
+
+template <>
+void prepack_a(
+    bool transa,
+    int64_t m,
+    int64_t k,
+    const double* a,
+    int64_t lda,
+    void* packed) {
+  prepack_a_impl<Float64MicroKernel>(
+      transa, m, k, a, lda, static_cast<double*>(packed));
+}
+
+template <>
+void prepack_a(
+    bool transa,
+    int64_t m,
+    int64_t k,
+    const float* a,
+    int64_t lda,
+    void* packed) {
+  prepack_a_impl<Float32MicroKernel>(
+      transa, m, k, a, lda, static_cast<float*>(packed));
+}
+
+template <>
+void prepack_a(
+    bool transa,
+    int64_t m,
+    int64_t k,
+    const Half* a,
+    int64_t lda,
+    void* packed) {
+  prepack_a_impl<Float32MicroKernel>(
+      transa, m, k, a, lda, static_cast<float*>(packed));
+}
+
+template <>
+void prepack_a(
+    bool transa,
+    int64_t m,
+    int64_t k,
+    const BFloat16* a,
+    int64_t lda,
+    void* packed) {
+  prepack_a_impl<Float32MicroKernel>(
+      transa, m, k, a, lda, static_cast<float*>(packed));
+}
+
 } // namespace internal
 } // namespace cpublas
 } // namespace executorch
@@ -13,12 +13,99 @@
 
 #include <executorch/extension/parallel/thread_parallel.h>
 #include <executorch/runtime/core/portable_type/bfloat16.h>
+#include <executorch/runtime/core/portable_type/half.h>
 
 #include <array>
 
 namespace executorch {
 namespace cpublas {
 
+namespace internal {
+/**
+ * Whether a gemm of this shape is large enough for gemm_packed() to pay for
+ * its packing. Matrix-vector products are left to the unpacked kernels,
+ * which stream through the matrix once anyway.
+ */
+inline bool use_packed_gemm(int64_t m, int64_t n, int64_t k) {
+  return m >= 8 && n >= 8 && k >= 8 && m * n * k >= 32 * 32 * 32;
+}
+
+// clang-format off
+/**
+ * Computes c = alpha * (op(a) @ op(b)) + beta * c for column-major matrices,
+ * where op() transposes its argument if the matching trans flag is set.
+ *
+ * Copies cache-sized blocks of a and b into contiguous panels that a
+ * register-blocked micro-kernel streams through, and computes the blocks of
+ * c in parallel. Half and BFloat16 inputs are widened to float while packing,
+ * so they accumulate in float.
+ *
+ * If `packed_a` is not null, it holds op(a) as packed by prepack_a(), and a is
+ * not read.
+ */
+void gemm_packed(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    double alpha,
+    const double *a, int64_t lda,
+    const double *b, int64_t ldb,
+    double beta,
+    double *c, int64_t ldc,
+    const void *packed_a = nullptr);
+
+void gemm_packed(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const float *a, int64_t lda,
+    const float *b, int64_t ldb,
+    float beta,
+    float *c, int64_t ldc,
+    const void *packed_a = nullptr);
+
+void gemm_packed(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const torch::executor::Half *a, int64_t lda,
+    const torch::executor::Half *b, int64_t ldb,
+    float beta,
+    torch::executor::Half *c, int64_t ldc,
+    const void *packed_a = nullptr);
+
+void gemm_packed(
+    bool transa, bool transb,
+    int64_t m, int64_t n, int64_t k,
+    float alpha,
+    const torch::executor::BFloat16 *a, int64_t lda,
+    const torch::executor::BFloat16 *b, int64_t ldb,
+    float beta,
+    torch::executor::BFloat16 *c, int64_t ldc,
+    const void *packed_a = nullptr);
+// clang-format on
+
+/**
+ * The size in bytes of an m x k op(a) packed by prepack_a(). Defined for
+ * double, float, Half and BFloat16.
+ */
+template <typename scalar_t>
+size_t prepacked_a_nbytes(int64_t m, int64_t k);
+
+/**
+ * Packs all of op(a) into `packed`, which must be prepacked_a_nbytes(m, k)
+ * bytes long and aligned for float, in the layout that gemm_packed() packs
+ * one block at a time.
+ */
+template <typename scalar_t>
+void prepack_a(
+    bool transa,
+    int64_t m,
+    int64_t k,
+    const scalar_t* a,
+    int64_t lda,
+    void* packed);
+} // namespace internal
+
 template <typename scalar_t, typename opmath_t>
 void scale_(int64_t m, int64_t n, opmath_t alpha, scalar_t* a, int64_t lda) {
   if (alpha == opmath_t(1)) {
@@ -161,16 +248,20 @@ void gemm_transa_(
 #ifdef __aarch64__
 namespace internal {
 float bf16_dot_with_fp32_arith(const torch::executor::BFloat16* vec1, const torch::executor::BFloat16* vec2, int64_t len);
+float fp16_dot_with_fp32_arith(const torch::executor::Half* vec1, const torch::executor::Half* vec2, int64_t len);
 } // namespace internal
 
-template <>
-inline void gemm_transa_<torch::executor::BFloat16, torch::executor::BFloat16>(
+// gemm_transa_() for 16-bit floats, with each dot product accumulated in
+// float by `dot`.
+template <typename scalar_t, typename Dot>
+inline void gemm_transa_with_fp32_dot_(
     int64_t m, int64_t n, int64_t k,
-    torch::executor::BFloat16 alpha,
-    const torch::executor::BFloat16 *a, int64_t lda,
-    const torch::executor::BFloat16 *b, int64_t ldb,
-    torch::executor::BFloat16 beta,
-    torch::executor::BFloat16 *c, int64_t ldc) {
+    scalar_t alpha,
+    const scalar_t *a, int64_t lda,
+    const scalar_t *b, int64_t ldb,
+    scalar_t beta,
+    scalar_t *c, int64_t ldc,
+    const Dot& dot_fn) {
   // c = alpha * (a.T @ b) + beta * c
   if (alpha == 1 && beta == 0) {
     executorch::extension::parallel_for(0, m, 1, [&](int64_t begin, int64_t end) {
@@ -178,7 +269,7 @@ inline void gemm_transa_<torch::executor::BFloat16, torch::executor::BFloat16>(
       for (int i = begin; i < end; ++i) {
         const auto *b_ = b;
         for (int j = 0; j < n; ++j) {
-          const auto dot = internal::bf16_dot_with_fp32_arith(a_, b_, k);
+          const auto dot = dot_fn(a_, b_, k);
           b_ += ldb;
           c[j*ldc+i] = dot;
         }
@@ -192,7 +283,7 @@ inline void gemm_transa_<torch::executor::BFloat16, torch::executor::BFloat16>(
     for (int i = begin; i < end; ++i) {
       const auto *b_ = b;
       for (int j = 0; j < n; ++j) {
-        const auto dot = internal::bf16_dot_with_fp32_arith(a_, b_, k);
+        const auto dot = dot_fn(a_, b_, k);
         b_ += ldb;
         if (beta == 0) {
           c[j*ldc+i] = alpha*dot;
@@ -204,6 +295,32 @@ inline void gemm_transa_<torch::executor::BFloat16, torch::executor::BFloat16>(
     }
   });
 }
+
+template <>
+inline void gemm_transa_<torch::executor::BFloat16, torch::executor::BFloat16>(
+    int64_t m, int64_t n, int64_t k,
+    torch::executor::BFloat16 alpha,
+    const torch::executor::BFloat16 *a, int64_t lda,
+    const torch::executor::BFloat16 *b, int64_t ldb,
+    torch::executor::BFloat16 beta,
+    torch::executor::BFloat16 *c, int64_t ldc) {
+  gemm_transa_with_fp32_dot_(
+      m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+      internal::bf16_dot_with_fp32_arith);
+}
+
+template <>
+inline void gemm_transa_<torch::executor::Half, torch::executor::Half>(
+    int64_t m, int64_t n, int64_t k,
+    torch::executor::Half alpha,
+    const torch::executor::Half *a, int64_t lda,
+    const torch::executor::Half *b, int64_t ldb,
+    torch::executor::Half beta,
+    torch::executor::Half *c, int64_t ldc) {
+  gemm_transa_with_fp32_dot_(
+      m, n, k, alpha, a, lda, b, ldb, beta, c, ldc,
+      internal::fp16_dot_with_fp32_arith);
+}
 #endif
 
 // clang-format on
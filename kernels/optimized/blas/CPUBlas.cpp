@@ -197,5 +197,80 @@ void gemm(
 }
 // clang-format on
 
+template <typename scalar_t>
+bool can_gemm_prepacked_a(int64_t m, int64_t n, int64_t k) {
+#ifdef ET_BUILD_WITH_BLAS
+  // gemm() hands these to the external BLAS, which does its own packing.
+  if (std::is_same<scalar_t, double>::value ||
+      std::is_same<scalar_t, float>::value) {
+    return false;
+  }
+#endif
+  return internal::use_packed_gemm(m, n, k);
+}
+
+template <typename scalar_t>
+size_t gemm_packed_a_nbytes(int64_t m, int64_t k) {
+  return internal::prepacked_a_nbytes<scalar_t>(m, k);
+}
+
+// clang-format off
+template <typename scalar_t>
+void pack_gemm_a(
+    TransposeType transa,
+    int64_t m, int64_t k,
+    const scalar_t *a, int64_t lda,
+    void *packed_a) {
+  internal::prepack_a(
+      transa != TransposeType::NoTranspose, m, k, a, lda, packed_a);
+}
+
+template <typename scalar_t>
+void gemm_prepacked_a(
+    TransposeType transb,
+    int64_t m, int64_t n, int64_t k,
+    scalar_t alpha,
+    const void *packed_a,
+    const scalar_t *b, int64_t ldb,
+    scalar_t beta,
+    scalar_t *c, int64_t ldc) {
+  using acc_type = std::conditional_t<
+      std::is_same<scalar_t, double>::value, double, float>;
+  internal::gemm_packed(
+      /*transa=*/false, transb != TransposeType::NoTranspose,
+      m, n, k,
+      static_cast<acc_type>(alpha),
+      /*a=*/static_cast<const scalar_t*>(nullptr), /*lda=*/m,
+      b, ldb,
+      static_cast<acc_type>(beta),
+      c, ldc,
+      packed_a);
+}
+
+#define ET_INSTANTIATE_GEMM_PREPACKED_A(scalar_t)                     \
+  template bool can_gemm_prepacked_a<scalar_t>(                       \
+      int64_t m, int64_t n, int64_t k);                               \
+  template size_t gemm_packed_a_nbytes<scalar_t>(int64_t m, int64_t k); \
+  template void pack_gemm_a<scalar_t>(                                \
+      TransposeType transa,                                           \
+      int64_t m, int64_t k,                                           \
+      const scalar_t *a, int64_t lda,                                 \
+      void *packed_a);                                                \
+  template void gemm_prepacked_a<scalar_t>(                           \
+      TransposeType transb,                                           \
+      int64_t m, int64_t n, int64_t k,                                \
+      scalar_t alpha,                                                 \
+      const void *packed_a,                                           \
+      const scalar_t *b, int64_t ldb,                                 \
+      scalar_t beta,                                                  \
+      scalar_t *c, int64_t ldc);
+
+ET_INSTANTIATE_GEMM_PREPACKED_A(double)
+ET_INSTANTIATE_GEMM_PREPACKED_A(float)
+ET_INSTANTIATE_GEMM_PREPACKED_A(Half)
+ET_INSTANTIATE_GEMM_PREPACKED_A(BFloat16)
+#undef ET_INSTANTIATE_GEMM_PREPACKED_A
+// clang-format on
+
 } // namespace cpublas
 } // namespace executorch
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <type_traits>
 
@@ -53,6 +54,19 @@ void gemm_impl(
     const scalar_t *b, int64_t ldb,
     opmath_t beta,
     scalar_t *c, int64_t ldc) {
+  if constexpr (!std::is_integral<scalar_t>::value) {
+    if (internal::use_packed_gemm(m, n, k)) {
+      return internal::gemm_packed(
+          transa != TransposeType::NoTranspose,
+          transb != TransposeType::NoTranspose,
+          m, n, k,
+          alpha,
+          a, lda,
+          b, ldb,
+          beta,
+          c, ldc);
+    }
+  }
   if (transa == TransposeType::NoTranspose &&
       transb == TransposeType::NoTranspose) {
     return gemm_notrans_(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
@@ -113,6 +127,52 @@ void gemm(
     exec_aten::BFloat16 *c, int64_t ldc);
 // clang-format on
 
+/**
+ * EXPERIMENTAL: gemm() with a first operand that was packed ahead of time.
+ *
+ * For large enough shapes, gemm() copies blocks of op(a) into the layout its
+ * micro-kernel reads before multiplying them. When a is constant, like the
+ * weight of a linear layer, pack_gemm_a() can make that copy once, and every
+ * gemm_prepacked_a() call then reads it directly. Defined for double, float,
+ * Half and BFloat16.
+ *
+ * Returns whether gemm_prepacked_a() supports this shape. If not, use gemm().
+ */
+template <typename scalar_t>
+bool can_gemm_prepacked_a(int64_t m, int64_t n, int64_t k);
+
+/// The size in bytes of an m x k op(a) packed by pack_gemm_a().
+template <typename scalar_t>
+size_t gemm_packed_a_nbytes(int64_t m, int64_t k);
+
+/**
+ * Packs op(a) for gemm_prepacked_a(). `packed_a` must be
+ * gemm_packed_a_nbytes(m, k) bytes long and aligned for float.
+ */
+// clang-format off
+template <typename scalar_t>
+void pack_gemm_a(
+    TransposeType transa,
+    int64_t m, int64_t k,
+    const scalar_t *a, int64_t lda,
+    void *packed_a);
+
+/**
+ * Computes c = alpha * (op(a) @ op(b)) + beta * c like gemm(), with op(a)
+ * packed by pack_gemm_a(). Only for shapes where can_gemm_prepacked_a() is
+ * true.
+ */
+template <typename scalar_t>
+void gemm_prepacked_a(
+    TransposeType transb,
+    int64_t m, int64_t n, int64_t k,
+    scalar_t alpha,
+    const void *packed_a,
+    const scalar_t *b, int64_t ldb,
+    scalar_t beta,
+    scalar_t *c, int64_t ldc);
+// clang-format on
+
 // clang-format off
 template <typename T,
           typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
@@ -138,5 +198,69 @@ void gemm(
 }
 // clang-format on
 
+namespace internal {
+/**
+ * The number of columns of c that each unit of work of gemm_batched()
+ * computes: enough of them for the unit to be worth a task, rounded to a
+ * multiple of 16, and all n if the gemm is smaller than that.
+ */
+inline int64_t batched_gemm_tile_n(int64_t m, int64_t n, int64_t k) {
+  constexpr int64_t kMinTileWork = 64 * 64 * 64;
+  constexpr int64_t kTileMultiple = 16;
+  const int64_t columns = (kMinTileWork + std::max<int64_t>(1, m * k) - 1) /
+      std::max<int64_t>(1, m * k);
+  const int64_t tile_n =
+      (columns + kTileMultiple - 1) / kTileMultiple * kTileMultiple;
+  return std::max<int64_t>(1, std::min(tile_n, n));
+}
+} // namespace internal
+
+/**
+ * EXPERIMENTAL: Computes batch_size independent gemms,
+ * c_i = alpha * (op(a_i) @ op(b_i)) + beta * c_i, where a_i = a + i * stride_a
+ * and likewise for b and c, like a strided batched gemm in other BLAS
+ * libraries.
+ *
+ * The batch entries, and tiles of the columns of each of their c, are
+ * computed in parallel, so that many small gemms, like the per-head products
+ * of attention, keep all the threads busy where each one of them could not.
+ * Defined for the types gemm() is.
+ */
+// clang-format off
+template <typename scalar_t>
+void gemm_batched(
+    TransposeType transa, TransposeType transb,
+    int64_t batch_size,
+    int64_t m, int64_t n, int64_t k,
+    const scalar_t alpha,
+    const scalar_t *a, int64_t lda, int64_t stride_a,
+    const scalar_t *b, int64_t ldb, int64_t stride_b,
+    const scalar_t beta,
+    scalar_t *c, int64_t ldc, int64_t stride_c) {
+  if (batch_size <= 0 || m <= 0 || n <= 0) {
+    return;
+  }
+  const int64_t tile_n = internal::batched_gemm_tile_n(m, n, k);
+  const int64_t num_tiles = (n + tile_n - 1) / tile_n;
+  // Column j of op(b).
+  const int64_t b_col_stride = transb == TransposeType::NoTranspose ? ldb : 1;
+  executorch::extension::parallel_for(
+      0, batch_size * num_tiles, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t unit = begin; unit < end; ++unit) {
+          const int64_t i = unit / num_tiles;
+          const int64_t j = (unit % num_tiles) * tile_n;
+          gemm(
+              transa, transb,
+              m, std::min(tile_n, n - j), k,
+              alpha,
+              a + i * stride_a, lda,
+              b + i * stride_b + j * b_col_stride, ldb,
+              beta,
+              c + i * stride_c + j * ldc, ldc);
+        }
+      });
+}
+// clang-format on
+
 } // namespace cpublas
 } // namespace executorch
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Shared by the optimized argmax and argmin kernels.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <tuple>
+#include <type_traits>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// The minimum number of elements that each parallel_for chunk reduces.
+constexpr int64_t kArgReduceGrainSize = 32768;
+
+enum class ArgReduce {
+  Max,
+  Min,
+};
+
+template <typename CTYPE>
+inline bool arg_reduce_is_nan(CTYPE value) {
+  if constexpr (std::is_floating_point<CTYPE>::value) {
+    return std::isnan(value);
+  } else {
+    return false;
+  }
+}
+
+/**
+ * Whether `value` replaces `acc` as the result of the reduction. Like the
+ * portable kernels, NaN beats every other value, and of equal values the
+ * first one wins.
+ */
+template <ArgReduce kReduce, typename CTYPE>
+inline bool arg_reduce_replaces(CTYPE value, CTYPE acc) {
+  if (arg_reduce_is_nan(acc)) {
+    return false;
+  }
+  if (arg_reduce_is_nan(value)) {
+    return true;
+  }
+  return kReduce == ArgReduce::Max ? value > acc : value < acc;
+}
+
+/**
+ * Returns the largest or smallest of `size` contiguous values, or NaN if any
+ * of them is NaN.
+ */
+template <ArgReduce kReduce, typename CTYPE>
+CTYPE arg_reduce_extremum(const CTYPE* data, int64_t size) {
+  if constexpr (std::is_floating_point<CTYPE>::value) {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    return executorch::vec::reduce_all<CTYPE>(
+        [](Vec a, Vec b) {
+          return kReduce == ArgReduce::Max ? executorch::vec::maximum(a, b)
+                                           : executorch::vec::minimum(a, b);
+        },
+        data,
+        size);
+  } else {
+    CTYPE result = data[0];
+    for (int64_t i = 1; i < size; ++i) {
+      result = kReduce == ArgReduce::Max ? std::max(result, data[i])
+                                         : std::min(result, data[i]);
+    }
+    return result;
+  }
+}
+
+/**
+ * Returns the index of the first of `size` contiguous values that equals
+ * `target`, or that is NaN if `target` is NaN. One of them must match.
+ */
+template <typename CTYPE>
+int64_t arg_reduce_find(const CTYPE* data, int64_t size, CTYPE target) {
+  constexpr int64_t kBlockSize = 64;
+  const bool find_nan = arg_reduce_is_nan(target);
+  for (int64_t begin = 0; begin < size; begin += kBlockSize) {
+    const int64_t end = std::min(begin + kBlockSize, size);
+    // Check the whole block without an early exit, which vectorizes, and only
+    // look for the match in the block that has it.
+    bool found = false;
+    if (find_nan) {
+      for (int64_t i = begin; i < end; ++i) {
+        found |= data[i] != data[i];
+      }
+    } else {
+      for (int64_t i = begin; i < end; ++i) {
+        found |= data[i] == target;
+      }
+    }
+    if (found) {
+      for (int64_t i = begin; i < end; ++i) {
+        if (find_nan ? data[i] != data[i] : data[i] == target) {
+          return i;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Returns the index of the result of reducing `size` contiguous values, in
+ * two vectorized passes: one for the extremum, and one to find its first
+ * occurrence.
+ */
+template <ArgReduce kReduce, typename CTYPE>
+int64_t arg_reduce_contiguous(const CTYPE* data, int64_t size) {
+  return arg_reduce_find(
+      data, size, arg_reduce_extremum<kReduce, CTYPE>(data, size));
+}
+
+/**
+ * Like arg_reduce_contiguous(), but splits long rows, like the logits of an
+ * LLM, into chunks that are reduced across the threadpool.
+ */
+template <ArgReduce kReduce, typename CTYPE>
+int64_t parallel_arg_reduce_contiguous(const CTYPE* data, int64_t size) {
+  constexpr int64_t kMaxChunks = 64;
+  const int64_t chunk_size = std::max(
+      kArgReduceGrainSize, (size + kMaxChunks - 1) / kMaxChunks);
+  const int64_t num_chunks = (size + chunk_size - 1) / chunk_size;
+  if (num_chunks <= 1) {
+    return arg_reduce_contiguous<kReduce, CTYPE>(data, size);
+  }
+  std::array<int64_t, kMaxChunks> chunk_results;
+  executorch::extension::parallel_for(
+      0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t chunk = begin; chunk < end; ++chunk) {
+          const int64_t offset = chunk * chunk_size;
+          chunk_results[chunk] = offset +
+              arg_reduce_contiguous<kReduce, CTYPE>(
+                                     data + offset,
+                                     std::min(chunk_size, size - offset));
+        }
+      });
+  // Combine the chunks in order, so that the first of equal values wins.
+  int64_t result = chunk_results[0];
+  for (int64_t chunk = 1; chunk < num_chunks; ++chunk) {
+    const int64_t index = chunk_results[chunk];
+    if (arg_reduce_replaces<kReduce>(data[index], data[result])) {
+      result = index;
+    }
+  }
+  return result;
+}
+
+/**
+ * Reduces a dim whose elements are `inner_size` > 1 apart, by processing
+ * blocks of adjacent rows together so that every inner loop reads contiguous
+ * memory, instead of walking each row with the stride of the dim.
+ */
+template <ArgReduce kReduce, typename CTYPE>
+void arg_reduce_strided(
+    const CTYPE* in_data,
+    int64_t* out_data,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size) {
+  constexpr int64_t kBlockSize = 64;
+  const int64_t num_blocks = (inner_size + kBlockSize - 1) / kBlockSize;
+  const int64_t grain_size = std::max<int64_t>(
+      1, kArgReduceGrainSize / std::max<int64_t>(1, dim_size * kBlockSize));
+  executorch::extension::parallel_for(
+      0, outer_size * num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+        CTYPE acc[kBlockSize];
+        for (int64_t unit = begin; unit < end; ++unit) {
+          const int64_t outer = unit / num_blocks;
+          const int64_t inner_begin = (unit % num_blocks) * kBlockSize;
+          const int64_t block = std::min(kBlockSize, inner_size - inner_begin);
+          const CTYPE* in_block =
+              in_data + outer * dim_size * inner_size + inner_begin;
+          int64_t* out_block = out_data + outer * inner_size + inner_begin;
+          for (int64_t j = 0; j < block; ++j) {
+            acc[j] = in_block[j];
+            out_block[j] = 0;
+          }
+          for (int64_t d = 1; d < dim_size; ++d) {
+            const CTYPE* row = in_block + d * inner_size;
+            for (int64_t j = 0; j < block; ++j) {
+              if (arg_reduce_replaces<kReduce>(row[j], acc[j])) {
+                acc[j] = row[j];
+                out_block[j] = d;
+              }
+            }
+          }
+        }
+      });
+}
+
+/**
+ * Writes the index of the largest or smallest value of `in` along `dim`, or
+ * over all of `in` if `dim` is empty, to `out`, whose shape and dim order the
+ * caller has checked.
+ */
+template <ArgReduce kReduce, typename CTYPE>
+void arg_reduce(
+    const exec_aten::Tensor& in,
+    exec_aten::optional<int64_t> dim,
+    exec_aten::Tensor& out) {
+  int64_t* out_data = out.mutable_data_ptr<int64_t>();
+
+  if (in.numel() == 0 || !tensor_is_default_dim_order(in)) {
+    // Walk the dims with their strides, like the portable kernel.
+    for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
+      out_data[out_ix] = std::get<1>(reduce_over_dim<CTYPE>(
+          [](CTYPE v, long ix, CTYPE acc_val, long acc_ix) {
+            if (arg_reduce_replaces<kReduce>(v, acc_val)) {
+              acc_val = v;
+              acc_ix = ix;
+            }
+            return std::tuple<CTYPE, long>{acc_val, acc_ix};
+          },
+          in,
+          dim,
+          out_ix));
+    }
+    return;
+  }
+
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  if (!dim.has_value() || in.dim() == 0) {
+    out_data[0] =
+        parallel_arg_reduce_contiguous<kReduce, CTYPE>(in_data, in.numel());
+    return;
+  }
+
+  const int64_t d = dim.value() < 0 ? dim.value() + in.dim() : dim.value();
+  const int64_t dim_size = in.size(d);
+  const int64_t outer_size = getLeadingDims(in, d);
+  const int64_t inner_size = getTrailingDims(in, d);
+  if (inner_size > 1) {
+    arg_reduce_strided<kReduce, CTYPE>(
+        in_data, out_data, outer_size, dim_size, inner_size);
+  } else if (outer_size == 1) {
+    out_data[0] =
+        parallel_arg_reduce_contiguous<kReduce, CTYPE>(in_data, dim_size);
+  } else {
+    const int64_t grain_size = std::max<int64_t>(
+        1, kArgReduceGrainSize / std::max<int64_t>(1, dim_size));
+    executorch::extension::parallel_for(
+        0, outer_size, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; ++row) {
+            out_data[row] = arg_reduce_contiguous<kReduce, CTYPE>(
+                in_data + row * dim_size, dim_size);
+          }
+        });
+  }
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
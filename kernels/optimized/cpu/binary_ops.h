@@ -8,8 +8,13 @@
 
 #pragma once
 
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
+#include <algorithm>
+
 namespace torch {
 namespace executor {
 namespace internal {
@@ -45,6 +50,9 @@ enum class ElementwiseOptimizedPath {
   kBroadcastNdByNdReverseArguments,
   kBroadcastLastDim,
   kBroadcastLastDimReverseArguments,
+  // Any other broadcast between inputs of the same dtype. See
+  // broadcasting_map_nd().
+  kBroadcastNd,
 };
 
 namespace internal {
@@ -160,13 +168,49 @@ ElementwiseOptimizedPath inline select_optimized_path(
       a_type == ScalarType::BFloat16) {
     return ElementwiseOptimizedPath::kNone;
   }
+  if (!is_contiguous_dim_order(a.dim_order().data(), a.dim()) ||
+      !is_contiguous_dim_order(b.dim_order().data(), b.dim()) ||
+      !is_contiguous_dim_order(out.dim_order().data(), out.dim())) {
+    // The specialized paths walk the data in memory order, which is the
+    // logical order of the elements only in the default dim order, or when
+    // all tensors share their sizes and dim order, e.g. all channels last.
+    // broadcasting_map_nd() follows the dim orders, so it takes the rest.
+    if (a.sizes().equals(b.sizes()) && a.sizes().equals(out.sizes()) &&
+        a.dim_order().equals(b.dim_order()) &&
+        a.dim_order().equals(out.dim_order())) {
+      return ElementwiseOptimizedPath::kTreatAs1d;
+    }
+    return ElementwiseOptimizedPath::kBroadcastNd;
+  }
   if (a.sizes().equals(b.sizes()) ||
       (a.numel() == b.numel() &&
        (a.numel() == out.numel() ||
         internal::sizes_match_ignoring_leading_1s(a.sizes(), b.sizes())))) {
     return ElementwiseOptimizedPath::kTreatAs1d;
   }
-  return internal::select_broadcast_optimized_path(a, b);
+  ElementwiseOptimizedPath path =
+      internal::select_broadcast_optimized_path(a, b);
+  if (path == ElementwiseOptimizedPath::kNone) {
+    return ElementwiseOptimizedPath::kBroadcastNd;
+  }
+  return path;
+}
+
+/**
+ * Whether a, b and out all have the same Half or BFloat16 dtype, and a and b
+ * have the same sizes and all three the same dim order, so that an elementwise
+ * op can walk them in memory order with vec::map2_reduced_float() once out is
+ * resized to a's sizes.
+ */
+inline bool can_map_reduced_float_1d(
+    const Tensor& a,
+    const Tensor& b,
+    const Tensor& out) {
+  const ScalarType out_type = out.scalar_type();
+  return (out_type == ScalarType::Half || out_type == ScalarType::BFloat16) &&
+      a.scalar_type() == out_type && b.scalar_type() == out_type &&
+      a.sizes().equals(b.sizes()) && a.dim_order().equals(b.dim_order()) &&
+      a.dim_order().equals(out.dim_order());
 }
 
 std::array<int32_t, 3> inline get_normalized_tensor_size(
@@ -190,5 +234,218 @@ std::array<int32_t, 3> inline get_normalized_tensor_size(
   return normalized_tensor_size;
 }
 
+namespace internal {
+
+// The minimum number of output elements that each parallel_for chunk of a
+// broadcasting op computes.
+constexpr int64_t kBroadcastGrainSize = 32768;
+
+/**
+ * The iteration space of a broadcasting binary op: the output shape in the
+ * memory order of the output, without dims of size 1, with adjacent dims
+ * merged wherever both inputs can step through them with a single stride.
+ * Strides are in elements and are 0 along the dims that an input is broadcast
+ * over. The innermost dim is last.
+ */
+struct BroadcastShape {
+  int64_t sizes[kTensorDimensionLimit];
+  int64_t a_strides[kTensorDimensionLimit];
+  int64_t b_strides[kTensorDimensionLimit];
+  size_t dim;
+};
+
+/// Computes the BroadcastShape of `a` and `b` broadcast to the (already
+/// resized) `out`.
+inline BroadcastShape collapse_broadcast_shape(
+    const Tensor& a,
+    const Tensor& b,
+    const Tensor& out) {
+  BroadcastShape shape{};
+  const ssize_t a_offset = out.dim() - a.dim();
+  const ssize_t b_offset = out.dim() - b.dim();
+  const auto out_dim_order = out.dim_order();
+  // Walk from the innermost dim of out in memory out, so each dim can be
+  // merged into the one inside it.
+  for (ssize_t k = out.dim() - 1; k >= 0; --k) {
+    const ssize_t i = out_dim_order[k];
+    const int64_t size = out.size(i);
+    if (size == 1) {
+      continue;
+    }
+    const ssize_t a_dim = i - a_offset;
+    const ssize_t b_dim = i - b_offset;
+    const int64_t a_stride =
+        (a_dim < 0 || a.size(a_dim) == 1) ? 0 : a.strides()[a_dim];
+    const int64_t b_stride =
+        (b_dim < 0 || b.size(b_dim) == 1) ? 0 : b.strides()[b_dim];
+    if (shape.dim > 0) {
+      const size_t inner = shape.dim - 1;
+      if (a_stride == shape.a_strides[inner] * shape.sizes[inner] &&
+          b_stride == shape.b_strides[inner] * shape.sizes[inner]) {
+        shape.sizes[inner] *= size;
+        continue;
+      }
+    }
+    shape.sizes[shape.dim] = size;
+    shape.a_strides[shape.dim] = a_stride;
+    shape.b_strides[shape.dim] = b_stride;
+    shape.dim++;
+  }
+  if (shape.dim == 0) {
+    // A single element.
+    shape.sizes[0] = 1;
+    shape.a_strides[0] = 0;
+    shape.b_strides[0] = 0;
+    shape.dim = 1;
+  }
+  std::reverse(shape.sizes, shape.sizes + shape.dim);
+  std::reverse(shape.a_strides, shape.a_strides + shape.dim);
+  std::reverse(shape.b_strides, shape.b_strides + shape.dim);
+  return shape;
+}
+
+/**
+ * Calls `row_fn(out_offset, a_offset, b_offset)` for each row of the
+ * innermost dim of `shape`, in parallel across the outer dims. Offsets are in
+ * elements.
+ */
+template <typename Fn>
+inline void for_each_broadcast_row(
+    const BroadcastShape& shape,
+    const Fn& row_fn) {
+  const ssize_t last_outer_dim = static_cast<ssize_t>(shape.dim) - 2;
+  const int64_t inner_size = shape.sizes[shape.dim - 1];
+  int64_t rows = 1;
+  for (ssize_t d = 0; d <= last_outer_dim; ++d) {
+    rows *= shape.sizes[d];
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      1, kBroadcastGrainSize / std::max<int64_t>(1, inner_size));
+  ::executorch::extension::parallel_for(
+      0, rows, grain_size, [&](int64_t begin, int64_t end) {
+        // Find the input offsets of the first row, then step through the
+        // rest like an odometer.
+        int64_t index[kTensorDimensionLimit];
+        int64_t a_offset = 0;
+        int64_t b_offset = 0;
+        int64_t remaining = begin;
+        for (ssize_t d = last_outer_dim; d >= 0; --d) {
+          index[d] = remaining % shape.sizes[d];
+          remaining /= shape.sizes[d];
+          a_offset += index[d] * shape.a_strides[d];
+          b_offset += index[d] * shape.b_strides[d];
+        }
+        for (int64_t row = begin; row < end; ++row) {
+          row_fn(row * inner_size, a_offset, b_offset);
+          for (ssize_t d = last_outer_dim; d >= 0; --d) {
+            a_offset += shape.a_strides[d];
+            b_offset += shape.b_strides[d];
+            if (++index[d] < shape.sizes[d]) {
+              break;
+            }
+            a_offset -= shape.a_strides[d] * shape.sizes[d];
+            b_offset -= shape.b_strides[d] * shape.sizes[d];
+            index[d] = 0;
+          }
+        }
+      });
+}
+
+} // namespace internal
+
+/**
+ * Computes `out = vec_fun(a, b)` with broadcasting, for inputs and output of
+ * the same dtype in any dim order. `out` must already have the
+ * broadcast shape. Walks the collapsed iteration space of
+ * internal::collapse_broadcast_shape(), vectorizing along its innermost dim,
+ * where each input is either contiguous or a single broadcast value. Inputs
+ * whose dim order differs from that of `out` may step through the innermost
+ * dim with a larger stride, in which case the rows are computed one element at
+ * a time.
+ */
+template <typename CTYPE, typename Op>
+inline void broadcasting_map_nd(
+    const Op& vec_fun,
+    const Tensor& a,
+    const Tensor& b,
+    Tensor& out) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const internal::BroadcastShape shape =
+      internal::collapse_broadcast_shape(a, b, out);
+  const int64_t inner_size = shape.sizes[shape.dim - 1];
+  const int64_t a_stride = shape.a_strides[shape.dim - 1];
+  const int64_t b_stride = shape.b_strides[shape.dim - 1];
+  const bool a_is_broadcast = a_stride == 0;
+  const bool b_is_broadcast = b_stride == 0;
+  const CTYPE* const a_data = a.const_data_ptr<CTYPE>();
+  const CTYPE* const b_data = b.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+  internal::for_each_broadcast_row(
+      shape, [&](int64_t out_offset, int64_t a_offset, int64_t b_offset) {
+        const CTYPE* a_row = a_data + a_offset;
+        const CTYPE* b_row = b_data + b_offset;
+        CTYPE* out_row = out_data + out_offset;
+        if (a_stride > 1 || b_stride > 1) {
+          for (int64_t i = 0; i < inner_size; ++i) {
+            vec_fun(Vec(a_row[i * a_stride]), Vec(b_row[i * b_stride]))
+                .store(&out_row[i], 1);
+          }
+        } else if (!a_is_broadcast && !b_is_broadcast) {
+          executorch::vec::map2<CTYPE>(
+              vec_fun, out_row, a_row, b_row, inner_size);
+        } else if (!a_is_broadcast) {
+          const Vec b_vec(*b_row);
+          executorch::vec::map<CTYPE>(
+              [&vec_fun, b_vec](Vec x) { return vec_fun(x, b_vec); },
+              out_row,
+              a_row,
+              inner_size);
+        } else if (!b_is_broadcast) {
+          const Vec a_vec(*a_row);
+          executorch::vec::map<CTYPE>(
+              [&vec_fun, a_vec](Vec y) { return vec_fun(a_vec, y); },
+              out_row,
+              b_row,
+              inner_size);
+        } else {
+          CTYPE value;
+          vec_fun(Vec(*a_row), Vec(*b_row)).store(&value, 1);
+          std::fill(out_row, out_row + inner_size, value);
+        }
+      });
+}
+
+/**
+ * Computes `out = compute_fun(a, b)` with broadcasting, one element at a
+ * time, for any mix of dtypes. A faster drop-in for the portable
+ * apply_binary_elementwise_fn(): it walks the collapsed iteration space of
+ * internal::collapse_broadcast_shape() instead of recomputing the input
+ * indexes of every element, and runs in parallel.
+ */
+template <typename CTYPE_A, typename CTYPE_B, typename CTYPE_OUT, typename Op>
+inline void apply_broadcasting_binary_fn(
+    const Op& compute_fun,
+    const Tensor& a,
+    const Tensor& b,
+    const Tensor& out) {
+  const internal::BroadcastShape shape =
+      internal::collapse_broadcast_shape(a, b, out);
+  const int64_t inner_size = shape.sizes[shape.dim - 1];
+  const int64_t a_stride = shape.a_strides[shape.dim - 1];
+  const int64_t b_stride = shape.b_strides[shape.dim - 1];
+  const CTYPE_A* const a_data = a.const_data_ptr<CTYPE_A>();
+  const CTYPE_B* const b_data = b.const_data_ptr<CTYPE_B>();
+  CTYPE_OUT* const out_data = out.mutable_data_ptr<CTYPE_OUT>();
+  internal::for_each_broadcast_row(
+      shape, [&](int64_t out_offset, int64_t a_offset, int64_t b_offset) {
+        const CTYPE_A* a_row = a_data + a_offset;
+        const CTYPE_B* b_row = b_data + b_offset;
+        CTYPE_OUT* out_row = out_data + out_offset;
+        for (int64_t i = 0; i < inner_size; ++i) {
+          out_row[i] = compute_fun(a_row[i * a_stride], b_row[i * b_stride]);
+        }
+      });
+}
+
 } // namespace executor
 } // namespace torch
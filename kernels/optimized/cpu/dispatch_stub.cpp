@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/dispatch_stub.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include <cpuinfo.h>
+
+#include <executorch/runtime/platform/log.h>
+
+namespace torch {
+namespace executor {
+
+namespace {
+
+// Returns the capability that ET_CPU_CAPABILITY names, or NUM_OPTIONS if it
+// is not set or not recognized.
+CPUCapability get_capability_from_env() {
+  const char* env = std::getenv("ET_CPU_CAPABILITY");
+  if (env == nullptr || *env == '\0') {
+    return CPUCapability::NUM_OPTIONS;
+  }
+  if (std::strcmp(env, "default") == 0) {
+    return CPUCapability::DEFAULT;
+  }
+  if (std::strcmp(env, "avx2") == 0) {
+    return CPUCapability::AVX2;
+  }
+  if (std::strcmp(env, "avx512") == 0) {
+    return CPUCapability::AVX512;
+  }
+  ET_LOG(Error, "Ignoring unknown ET_CPU_CAPABILITY '%s'", env);
+  return CPUCapability::NUM_OPTIONS;
+}
+
+} // namespace
+
+namespace internal {
+
+CPUCapability compute_cpu_capability() {
+  if (!cpuinfo_initialize()) {
+    ET_LOG(Error, "cpuinfo initialization failed");
+    return CPUCapability::DEFAULT;
+  }
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+  if (cpuinfo_has_x86_avx512f() && cpuinfo_has_x86_avx512dq() &&
+      cpuinfo_has_x86_avx512vl() && cpuinfo_has_x86_avx512bw() &&
+      cpuinfo_has_x86_fma3()) {
+    return CPUCapability::AVX512;
+  }
+  if (cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3()) {
+    return CPUCapability::AVX2;
+  }
+#endif
+  return CPUCapability::DEFAULT;
+}
+
+} // namespace internal
+
+CPUCapability get_cpu_capability() {
+  static const CPUCapability capability = [] {
+    CPUCapability detected = internal::compute_cpu_capability();
+    return std::min(detected, get_capability_from_env());
+  }();
+  return capability;
+}
+
+const char* cpu_capability_name(CPUCapability capability) {
+  switch (capability) {
+    case CPUCapability::DEFAULT:
+      return "DEFAULT";
+    case CPUCapability::AVX2:
+      return "AVX2";
+    case CPUCapability::AVX512:
+      return "AVX512";
+    case CPUCapability::NUM_OPTIONS:
+      break;
+  }
+  return "UNKNOWN";
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @file
+ * Runtime selection between versions of a kernel that were compiled for
+ * different instruction sets, so that a single binary can use the widest
+ * vector ISA that the CPU it runs on supports.
+ *
+ * A multiversioned kernel source file is compiled once per CPUCapability,
+ * with `-DCPU_CAPABILITY=<name> -DCPU_CAPABILITY_<name>` and the compiler
+ * flags of that ISA. The vec library puts everything in the CPU_CAPABILITY
+ * inline namespace, so the copies don't collide at link time. Each copy adds
+ * its version of a function to a DispatchStub with ET_REGISTER_DISPATCH, and
+ * callers call the stub, which picks the best version on first use.
+ *
+ * Code in multiversioned files runs only after its capability was detected,
+ * so they should keep everything in an anonymous namespace and avoid
+ * including headers with inline functions that are also used elsewhere,
+ * which the linker might otherwise resolve to their AVX copies.
+ *
+ * Usage:
+ *
+ *   // kernel.h
+ *   using my_fn = void (*)(const float*, float*, int64_t);
+ *   ET_DECLARE_DISPATCH(my_fn, my_stub);
+ *
+ *   // kernel.cpp, compiled once.
+ *   ET_DEFINE_DISPATCH(my_stub);
+ *
+ *   // kernel_impl.cpp, compiled once per capability.
+ *   namespace {
+ *   void my_kernel(const float* in, float* out, int64_t n) { ... }
+ *   } // namespace
+ *   ET_REGISTER_DISPATCH(my_stub, &my_kernel);
+ *
+ *   // Caller.
+ *   my_stub(in, out, n);
+ */
+
+namespace torch {
+namespace executor {
+
+/// Instruction sets that kernels can be compiled for, from least to most
+/// capable.
+enum class CPUCapability : uint8_t {
+  DEFAULT = 0,
+  // AVX2 and FMA.
+  AVX2,
+  // AVX512F, AVX512DQ, AVX512VL and AVX512BW.
+  AVX512,
+  NUM_OPTIONS,
+};
+
+/**
+ * Returns the most capable instruction set that this CPU supports, detected
+ * with cpuinfo on first call. Setting the environment variable
+ * ET_CPU_CAPABILITY to "default", "avx2" or "avx512" lowers it, e.g. to test
+ * or benchmark the other versions of a kernel.
+ */
+CPUCapability get_cpu_capability();
+
+/// Returns the name of `capability`, e.g. "AVX2".
+const char* cpu_capability_name(CPUCapability capability);
+
+namespace internal {
+/// Detects the capability of this CPU. Exposed for testing.
+CPUCapability compute_cpu_capability();
+} // namespace internal
+
+/**
+ * Holds the versions of a kernel that were compiled into this binary, and
+ * calls the best one for this CPU. Must be a global, so that the
+ * constant-initialized stub is ready before any static initializer registers
+ * into it.
+ */
+template <typename FnPtr>
+class DispatchStub;
+
+template <typename Ret, typename... Args>
+class DispatchStub<Ret (*)(Args...)> final {
+ public:
+  using FnPtr = Ret (*)(Args...);
+
+  constexpr DispatchStub() = default;
+
+  DispatchStub(const DispatchStub&) = delete;
+  DispatchStub& operator=(const DispatchStub&) = delete;
+
+  /// Calls the version of the kernel for get_cpu_capability().
+  Ret operator()(Args... args) {
+    FnPtr fn = cached_.load(std::memory_order_acquire);
+    if (fn == nullptr) {
+      fn = choose(get_cpu_capability());
+      cached_.store(fn, std::memory_order_release);
+    }
+    return (*fn)(std::forward<Args>(args)...);
+  }
+
+  /**
+   * Returns the most capable registered version that `capability` can run,
+   * which is always at least the DEFAULT version.
+   */
+  FnPtr choose(CPUCapability capability) const {
+    for (int i = static_cast<int>(capability); i > 0; --i) {
+      if (fns_[i] != nullptr) {
+        return fns_[i];
+      }
+    }
+    // The DEFAULT version is always compiled in, so a missing one is a build
+    // error rather than something to handle at runtime.
+    return fns_[static_cast<int>(CPUCapability::DEFAULT)];
+  }
+
+  /// Registers the version of the kernel for `capability`. Called by
+  /// ET_REGISTER_DISPATCH during static initialization.
+  void set(CPUCapability capability, FnPtr fn) {
+    fns_[static_cast<int>(capability)] = fn;
+    cached_.store(nullptr, std::memory_order_release);
+  }
+
+ private:
+  FnPtr fns_[static_cast<int>(CPUCapability::NUM_OPTIONS)] = {};
+  std::atomic<FnPtr> cached_{nullptr};
+};
+
+namespace internal {
+
+template <typename Stub, typename FnPtr>
+struct DispatchRegistrar final {
+  DispatchRegistrar(Stub& stub, CPUCapability capability, FnPtr fn) {
+    stub.set(capability, fn);
+  }
+};
+
+} // namespace internal
+
+} // namespace executor
+} // namespace torch
+
+// The capability that the current file is compiled for.
+#if defined(CPU_CAPABILITY_AVX512)
+#define ET_COMPILED_CPU_CAPABILITY \
+  ::torch::executor::CPUCapability::AVX512
+#elif defined(CPU_CAPABILITY_AVX2)
+#define ET_COMPILED_CPU_CAPABILITY \
+  ::torch::executor::CPUCapability::AVX2
+#else
+#define ET_COMPILED_CPU_CAPABILITY \
+  ::torch::executor::CPUCapability::DEFAULT
+#endif
+
+/// Declares a stub named `name` for kernels of type `fn_type`.
+#define ET_DECLARE_DISPATCH(fn_type, name) \
+  extern ::torch::executor::DispatchStub<fn_type> name
+
+/// Defines the stub declared by ET_DECLARE_DISPATCH, in one file that is not
+/// multiversioned.
+#define ET_DEFINE_DISPATCH(name) decltype(name) name
+
+#define ET_DISPATCH_CONCAT_IMPL(a, b) a##b
+#define ET_DISPATCH_CONCAT(a, b) ET_DISPATCH_CONCAT_IMPL(a, b)
+
+/// Registers `fn` as the version of the stub `name` for the capability that
+/// the current file is compiled for.
+#define ET_REGISTER_DISPATCH(name, fn)                           \
+  static ::torch::executor::internal::DispatchRegistrar< \
+      decltype(name),                                            \
+      decltype(name)::FnPtr>                                     \
+      ET_DISPATCH_CONCAT(name##_registrar_, __LINE__)(           \
+          name, ET_COMPILED_CPU_CAPABILITY, fn)
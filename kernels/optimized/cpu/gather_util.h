@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Shared by the optimized embedding, index_select and gather kernels.
+
+#include <algorithm>
+#include <cstring>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// The minimum number of bytes that each parallel_for chunk copies.
+constexpr int64_t kGatherGrainBytes = 32768;
+
+// How many rows ahead of the one being copied to prefetch.
+constexpr int64_t kGatherPrefetchDistance = 4;
+
+inline void gather_prefetch(const void* addr) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(addr, /*rw=*/0, /*locality=*/1);
+#else
+  (void)addr;
+#endif
+}
+
+/**
+ * Copies rows [begin, end) of `dst` from the rows of `src` that `src_row`
+ * maps them to. With a constant `kRowBytes`, the copy of each row compiles
+ * to a few loads and stores instead of a call to memcpy.
+ */
+template <size_t kRowBytes, typename SrcRowFn>
+void gather_row_range(
+    char* dst,
+    const char* src,
+    size_t row_bytes,
+    int64_t begin,
+    int64_t end,
+    const SrcRowFn& src_row) {
+  const size_t nbytes = kRowBytes != 0 ? kRowBytes : row_bytes;
+  // Rows that are only a few bytes share cache lines, which the hardware
+  // prefetcher covers well enough.
+  const bool prefetch = nbytes >= 64;
+  for (int64_t i = begin; i < end; ++i) {
+    if (prefetch && i + kGatherPrefetchDistance < end) {
+      gather_prefetch(src + src_row(i + kGatherPrefetchDistance) * nbytes);
+    }
+    std::memcpy(dst + i * nbytes, src + src_row(i) * nbytes, nbytes);
+  }
+}
+
+/**
+ * Copies `num_rows` rows of `row_bytes` bytes into the contiguous `dst`, where
+ * row i comes from row `src_row(i)` of the contiguous `src`. The rows are
+ * split across the threadpool, and the source rows are prefetched a few rows
+ * ahead, since they are usually scattered, e.g. across an embedding table.
+ *
+ * `src_row` must be valid for every row; callers check their indices first.
+ */
+template <typename SrcRowFn>
+void gather_rows(
+    char* dst,
+    const char* src,
+    size_t row_bytes,
+    int64_t num_rows,
+    const SrcRowFn& src_row) {
+  if (num_rows <= 0 || row_bytes == 0) {
+    return;
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      1, kGatherGrainBytes / static_cast<int64_t>(row_bytes));
+  executorch::extension::parallel_for(
+      0, num_rows, grain_size, [&](int64_t begin, int64_t end) {
+        switch (row_bytes) {
+          case 1:
+            gather_row_range<1>(dst, src, row_bytes, begin, end, src_row);
+            break;
+          case 2:
+            gather_row_range<2>(dst, src, row_bytes, begin, end, src_row);
+            break;
+          case 4:
+            gather_row_range<4>(dst, src, row_bytes, begin, end, src_row);
+            break;
+          case 8:
+            gather_row_range<8>(dst, src, row_bytes, begin, end, src_row);
+            break;
+          case 16:
+            gather_row_range<16>(dst, src, row_bytes, begin, end, src_row);
+            break;
+          default:
+            gather_row_range<0>(dst, src, row_bytes, begin, end, src_row);
+            break;
+        }
+      });
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/cpu/binary_ops.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -35,7 +36,7 @@ template <
 struct AddInner<true, CTYPE_A, CTYPE_B, CTYPE_IN, CTYPE_OUT> {
   static void
   run(const Tensor& a, const Tensor& b, CTYPE_IN alpha_val, Tensor& out) {
-    apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
+    apply_broadcasting_binary_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
         // NOLINTNEXTLINE(facebook-hte-ConstantArgumentPassByValue)
         [alpha_val](const CTYPE_A val_a, const CTYPE_B val_b) {
           CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
@@ -115,6 +116,41 @@ Tensor& opt_add_out(
     return opt_add_out(ctx, b, a, alpha, out);
   }
 
+  if (can_map_reduced_float_1d(a, b, out)) {
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        resize_tensor(out, a.sizes()) == Error::Ok,
+        InvalidArgument,
+        out,
+        "Failed to resize output tensor.");
+
+    ET_SWITCH_TWO_TYPES(Half, BFloat16, a_type, ctx, "add.out", CTYPE, [&]() {
+      float alpha_val;
+      ET_KERNEL_CHECK(
+          ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
+#ifdef ET_VEC_NATIVE_FP16_ARITHMETIC
+      // Without alpha, the sum is rounded once either way.
+      if (std::is_same_v<CTYPE, exec_aten::Half> && alpha_val == 1.0f) {
+        executorch::vec::map2_fp16(
+            [](float16x8_t x, float16x8_t y) { return vaddq_f16(x, y); },
+            out.mutable_data_ptr<exec_aten::Half>(),
+            a.const_data_ptr<exec_aten::Half>(),
+            b.const_data_ptr<exec_aten::Half>(),
+            out.numel());
+        return;
+      }
+#endif // ET_VEC_NATIVE_FP16_ARITHMETIC
+      using Vec = executorch::vec::Vectorized<float>;
+      executorch::vec::map2_reduced_float<CTYPE>(
+          [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
+          out.mutable_data_ptr<CTYPE>(),
+          a.const_data_ptr<CTYPE>(),
+          b.const_data_ptr<CTYPE>(),
+          out.numel());
+    });
+    return out;
+  }
+
   auto selected_optimized_path = select_optimized_path(a, b, out);
   if (selected_optimized_path == ElementwiseOptimizedPath::kTreatAs1d) {
     // Resize for dynamic shape
@@ -131,15 +167,29 @@ Tensor& opt_add_out(
       ET_KERNEL_CHECK(
           ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
 
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
+      if constexpr (has_vec_kernels_v<CTYPE>) {
+        vec_binary_stub(
+            VecBinaryOp::kAdd,
+            a_type,
+            a.const_data_ptr(),
+            b.const_data_ptr(),
+            alpha_val,
+            out.mutable_data_ptr(),
+            out.numel());
+      } else {
+        using Vec = executorch::vec::Vectorized<CTYPE>;
+        executorch::vec::map2<CTYPE>(
+            [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            out.numel());
+      }
     });
-  } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
+  } else if (
+      selected_optimized_path == ElementwiseOptimizedPath::kBroadcast2dBy1d ||
+      selected_optimized_path ==
+          ElementwiseOptimizedPath::kBroadcast2dBy1dReverseArguments) {
     const Tensor* lhs;
     const Tensor* rhs;
     if (selected_optimized_path ==
@@ -147,10 +197,6 @@ Tensor& opt_add_out(
       lhs = &b;
       rhs = &a;
     } else {
-      // Catch failure to update logic when adding new broadcasting possibility.
-      ET_DCHECK(
-          selected_optimized_path ==
-          ElementwiseOptimizedPath::kBroadcast2dBy1d);
       lhs = &a;
       rhs = &b;
     }
@@ -175,6 +221,24 @@ Tensor& opt_add_out(
           lhs->sizes()[lhs->dim() - 2],
           lhs->sizes()[lhs->dim() - 1]);
     });
+  } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_to_broadcast_target_size(a, b, out) == Error::Ok,
+        InvalidArgument,
+        out);
+    ET_SWITCH_REALB_TYPES(out_type, ctx, "add.out", CTYPE, [&]() {
+      CTYPE alpha_val;
+      ET_KERNEL_CHECK(
+          ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
+
+      using Vec = executorch::vec::Vectorized<CTYPE>;
+      broadcasting_map_nd<CTYPE>(
+          [alpha_val](Vec x, Vec y) { return x + Vec(alpha_val) * y; },
+          a,
+          b,
+          out);
+    });
   } else {
     ScalarType common_type =
         promoteTypes(a_type, b_type, /*half_to_float*/ true);
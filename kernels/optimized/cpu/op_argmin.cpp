@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/arg_reduce_util.h>
+#include <executorch/kernels/portable/cpu/util/reduce_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using exec_aten::optional;
+using exec_aten::Tensor;
+
+/**
+ * Returns the indices of the minimum values of `in` along `dim`, or of the
+ * minimum of all of `in` if `dim` is empty.
+ *
+ * argmin.out(Tensor self, int? dim=None, bool keepdim=False, *,
+ *     Tensor(a!) out) -> Tensor(a!)
+ */
+Tensor& opt_argmin_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    optional<int64_t> dim,
+    bool keepdim,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_argmin_argmax_args(in, dim, keepdim, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_reduction_out(in, dim, keepdim, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_SWITCH_REAL_TYPES(in.scalar_type(), ctx, "argmin.out", CTYPE, [&] {
+    arg_reduce<ArgReduce::Min, CTYPE>(in, dim, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
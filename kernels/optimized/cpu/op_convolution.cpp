@@ -0,0 +1,912 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/dtype_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using executorch::cpublas::TransposeType;
+
+namespace {
+
+// The minimum number of multiply-adds that each parallel_for chunk computes.
+constexpr int64_t kConvGrainSize = 32768;
+
+// The number of output tiles whose Winograd transforms are multiplied by the
+// transformed weight in a single gemm.
+constexpr int64_t kWinogradTileBlock = 32;
+
+// Identifies Winograd-transformed weights in a KernelCache. The low byte holds
+// the size of the output tile, since each size transforms differently.
+constexpr uint32_t kWinogradWeightTag = 0x57490000; // "WI"
+
+/**
+ * The shape of a 2D convolution. A 1D convolution is a 2D convolution with a
+ * height of 1. Offsets are in elements, for (batch, channel, y, x).
+ */
+struct Conv2dParams {
+  int64_t batches;
+  int64_t in_channels;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_channels;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t kernel_h;
+  int64_t kernel_w;
+  int64_t stride_h;
+  int64_t stride_w;
+  int64_t pad_h;
+  int64_t pad_w;
+  int64_t dilation_h;
+  int64_t dilation_w;
+  int64_t groups;
+  // Whether in and out are NHWC instead of NCHW.
+  bool channels_last;
+  int64_t in_strides[4];
+  int64_t out_strides[4];
+};
+
+void set_strides(
+    int64_t channels,
+    int64_t h,
+    int64_t w,
+    bool channels_last,
+    int64_t* strides) {
+  strides[0] = channels * h * w;
+  if (channels_last) {
+    strides[1] = 1;
+    strides[2] = w * channels;
+    strides[3] = channels;
+  } else {
+    strides[1] = h * w;
+    strides[2] = w;
+    strides[3] = 1;
+  }
+}
+
+Conv2dParams get_conv2d_params(
+    const Tensor& in,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    const Tensor& out) {
+  Conv2dParams p;
+  p.batches = in.size(0);
+  p.in_channels = in.size(1);
+  p.out_channels = out.size(1);
+  p.groups = groups;
+  if (in.dim() == 4) {
+    p.in_h = in.size(2);
+    p.in_w = in.size(3);
+    p.out_h = out.size(2);
+    p.out_w = out.size(3);
+    p.kernel_h = weight.size(2);
+    p.kernel_w = weight.size(3);
+    p.stride_h = val_at(stride, 0);
+    p.stride_w = val_at(stride, 1);
+    p.pad_h = val_at(padding, 0, /*default_value=*/0);
+    p.pad_w = val_at(padding, 1, /*default_value=*/0);
+    p.dilation_h = val_at(dilation, 0);
+    p.dilation_w = val_at(dilation, 1);
+    p.channels_last =
+        is_channels_last_dim_order(in.dim_order().data(), in.dim());
+  } else {
+    p.in_h = 1;
+    p.in_w = in.size(2);
+    p.out_h = 1;
+    p.out_w = out.size(2);
+    p.kernel_h = 1;
+    p.kernel_w = weight.size(2);
+    p.stride_h = 1;
+    p.stride_w = val_at(stride, 0);
+    p.pad_h = 0;
+    p.pad_w = val_at(padding, 0, /*default_value=*/0);
+    p.dilation_h = 1;
+    p.dilation_w = val_at(dilation, 0);
+    p.channels_last = false;
+  }
+  set_strides(p.in_channels, p.in_h, p.in_w, p.channels_last, p.in_strides);
+  set_strides(
+      p.out_channels, p.out_h, p.out_w, p.channels_last, p.out_strides);
+  return p;
+}
+
+/**
+ * Returns the data of `weight` as a contiguous (dim 0, dim 1, kernel_h,
+ * kernel_w) array, copying it into `storage` if it is channels last.
+ */
+template <typename CTYPE>
+const CTYPE* get_contiguous_weight(
+    const Tensor& weight,
+    std::vector<CTYPE>& storage) {
+  const CTYPE* data = weight.const_data_ptr<CTYPE>();
+  if (weight.dim() != 4 ||
+      is_contiguous_dim_order(weight.dim_order().data(), weight.dim())) {
+    return data;
+  }
+  const int64_t d0 = weight.size(0);
+  const int64_t d1 = weight.size(1);
+  const int64_t h = weight.size(2);
+  const int64_t w = weight.size(3);
+  storage.resize(weight.numel());
+  CTYPE* dst = storage.data();
+  for (int64_t i = 0; i < d0; ++i) {
+    for (int64_t j = 0; j < d1; ++j) {
+      for (int64_t y = 0; y < h; ++y) {
+        for (int64_t x = 0; x < w; ++x) {
+          *dst++ = data[((i * h + y) * w + x) * d1 + j];
+        }
+      }
+    }
+  }
+  return storage.data();
+}
+
+/// Sets every output element to the bias of its channel, or to zero.
+template <typename CTYPE>
+void fill_with_bias(const Conv2dParams& p, const CTYPE* bias, CTYPE* out) {
+  const int64_t* s = p.out_strides;
+  for (int64_t n = 0; n < p.batches; ++n) {
+    for (int64_t c = 0; c < p.out_channels; ++c) {
+      const CTYPE value = bias != nullptr ? bias[c] : static_cast<CTYPE>(0);
+      for (int64_t y = 0; y < p.out_h; ++y) {
+        for (int64_t x = 0; x < p.out_w; ++x) {
+          out[n * s[0] + c * s[1] + y * s[2] + x * s[3]] = value;
+        }
+      }
+    }
+  }
+}
+
+template <typename CTYPE>
+void gemm_accumulate(
+    TransposeType transa,
+    TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const CTYPE* a,
+    int64_t lda,
+    const CTYPE* b,
+    int64_t ldb,
+    CTYPE* c,
+    int64_t ldc) {
+  executorch::cpublas::gemm(
+      transa,
+      transb,
+      m,
+      n,
+      k,
+      static_cast<CTYPE>(1),
+      a,
+      lda,
+      b,
+      ldb,
+      static_cast<CTYPE>(1),
+      c,
+      ldc);
+}
+
+/**
+ * Copies the input patch of every output pixel of `group` into a row of
+ * `col`, which is (out_h * out_w) x (in_channels_per_group * kernel_h *
+ * kernel_w), so that the convolution becomes a gemm of col and the weight.
+ * `in` points at a single batch.
+ */
+template <typename CTYPE>
+void im2row(
+    const Conv2dParams& p,
+    const CTYPE* in,
+    int64_t group,
+    CTYPE* col) {
+  const int64_t in_c_per_group = p.in_channels / p.groups;
+  const int64_t row_size = in_c_per_group * p.kernel_h * p.kernel_w;
+  const int64_t* s = p.in_strides;
+  executorch::extension::parallel_for(
+      0,
+      p.out_h * p.out_w,
+      std::max<int64_t>(1, kConvGrainSize / row_size),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t pixel = begin; pixel < end; ++pixel) {
+          const int64_t out_y = pixel / p.out_w;
+          const int64_t out_x = pixel % p.out_w;
+          CTYPE* row = col + pixel * row_size;
+          for (int64_t ic = 0; ic < in_c_per_group; ++ic) {
+            const CTYPE* in_c = in + (group * in_c_per_group + ic) * s[1];
+            for (int64_t ky = 0; ky < p.kernel_h; ++ky) {
+              CTYPE* dst = row + (ic * p.kernel_h + ky) * p.kernel_w;
+              const int64_t in_y =
+                  out_y * p.stride_h - p.pad_h + ky * p.dilation_h;
+              if (in_y < 0 || in_y >= p.in_h) {
+                std::fill(dst, dst + p.kernel_w, static_cast<CTYPE>(0));
+                continue;
+              }
+              for (int64_t kx = 0; kx < p.kernel_w; ++kx) {
+                const int64_t in_x =
+                    out_x * p.stride_w - p.pad_w + kx * p.dilation_w;
+                dst[kx] = in_x >= 0 && in_x < p.in_w
+                    ? in_c[in_y * s[2] + in_x * s[3]]
+                    : static_cast<CTYPE>(0);
+              }
+            }
+          }
+        }
+      });
+}
+
+/**
+ * Adds the convolution of `in` and `weight` to `out`, as one gemm per batch
+ * and group. 1x1 convolutions with a stride of 1 and no padding multiply the
+ * input directly.
+ */
+template <typename CTYPE>
+void conv_im2col_gemm(
+    const Conv2dParams& p,
+    const CTYPE* in,
+    const CTYPE* weight,
+    CTYPE* out) {
+  const int64_t in_c_per_group = p.in_channels / p.groups;
+  const int64_t out_c_per_group = p.out_channels / p.groups;
+  const int64_t patch_size = in_c_per_group * p.kernel_h * p.kernel_w;
+  const int64_t out_pixels = p.out_h * p.out_w;
+  const bool is_pointwise = p.kernel_h == 1 && p.kernel_w == 1 &&
+      p.stride_h == 1 && p.stride_w == 1 && p.pad_h == 0 && p.pad_w == 0;
+
+  std::vector<CTYPE> col;
+  if (!is_pointwise) {
+    col.resize(out_pixels * patch_size);
+  }
+  for (int64_t n = 0; n < p.batches; ++n) {
+    const CTYPE* in_n = in + n * p.in_strides[0];
+    for (int64_t g = 0; g < p.groups; ++g) {
+      const CTYPE* weight_g = weight + g * out_c_per_group * patch_size;
+      CTYPE* out_g =
+          out + n * p.out_strides[0] + g * out_c_per_group * p.out_strides[1];
+      // The patches, either as rows of col or read in place.
+      const CTYPE* patches = col.data();
+      int64_t ld_patches = patch_size;
+      bool patches_are_rows = true;
+      if (is_pointwise) {
+        patches = in_n + g * in_c_per_group * p.in_strides[1];
+        ld_patches = p.channels_last ? p.in_channels : out_pixels;
+        patches_are_rows = p.channels_last;
+      } else {
+        im2row(p, in_n, g, col.data());
+      }
+      if (p.channels_last) {
+        // out_g is out_c_per_group x out_pixels in column-major order.
+        gemm_accumulate(
+            TransposeType::Transpose,
+            TransposeType::NoTranspose,
+            out_c_per_group,
+            out_pixels,
+            patch_size,
+            weight_g,
+            patch_size,
+            patches,
+            ld_patches,
+            out_g,
+            p.out_channels);
+      } else {
+        // out_g is out_pixels x out_c_per_group in column-major order.
+        gemm_accumulate(
+            patches_are_rows ? TransposeType::Transpose
+                             : TransposeType::NoTranspose,
+            TransposeType::NoTranspose,
+            out_pixels,
+            out_c_per_group,
+            patch_size,
+            patches,
+            ld_patches,
+            weight_g,
+            patch_size,
+            out_g,
+            out_pixels);
+      }
+    }
+  }
+}
+
+/**
+ * Adds the transposed convolution of `in` and `weight` to `out`: a gemm per
+ * batch and group computes the contribution of every input pixel to each
+ * (output channel, ky, kx), which is then scattered into the output.
+ */
+template <typename CTYPE>
+void conv_transposed_gemm(
+    const Conv2dParams& p,
+    const CTYPE* in,
+    const CTYPE* weight,
+    CTYPE* out) {
+  const int64_t in_c_per_group = p.in_channels / p.groups;
+  const int64_t out_c_per_group = p.out_channels / p.groups;
+  const int64_t kernel_size = p.kernel_h * p.kernel_w;
+  const int64_t col_rows = out_c_per_group * kernel_size;
+  const int64_t in_pixels = p.in_h * p.in_w;
+  const int64_t* s = p.out_strides;
+
+  // col is in_pixels x col_rows in column-major order.
+  std::vector<CTYPE> col(col_rows * in_pixels);
+  for (int64_t n = 0; n < p.batches; ++n) {
+    const CTYPE* in_n = in + n * p.in_strides[0];
+    for (int64_t g = 0; g < p.groups; ++g) {
+      executorch::cpublas::gemm(
+          p.channels_last ? TransposeType::Transpose
+                          : TransposeType::NoTranspose,
+          TransposeType::Transpose,
+          in_pixels,
+          col_rows,
+          in_c_per_group,
+          static_cast<CTYPE>(1),
+          in_n + g * in_c_per_group * p.in_strides[1],
+          p.channels_last ? p.in_channels : in_pixels,
+          weight + g * in_c_per_group * col_rows,
+          col_rows,
+          static_cast<CTYPE>(0),
+          col.data(),
+          in_pixels);
+
+      // Every chunk writes to different output channels.
+      executorch::extension::parallel_for(
+          0,
+          out_c_per_group,
+          std::max<int64_t>(1, kConvGrainSize / (kernel_size * in_pixels)),
+          [&](int64_t begin, int64_t end) {
+            for (int64_t oc = begin; oc < end; ++oc) {
+              CTYPE* out_c =
+                  out + n * s[0] + (g * out_c_per_group + oc) * s[1];
+              for (int64_t ky = 0; ky < p.kernel_h; ++ky) {
+                for (int64_t kx = 0; kx < p.kernel_w; ++kx) {
+                  const CTYPE* src = col.data() +
+                      ((oc * p.kernel_h + ky) * p.kernel_w + kx) * in_pixels;
+                  for (int64_t in_y = 0; in_y < p.in_h; ++in_y) {
+                    const int64_t out_y =
+                        in_y * p.stride_h - p.pad_h + ky * p.dilation_h;
+                    if (out_y < 0 || out_y >= p.out_h) {
+                      continue;
+                    }
+                    for (int64_t in_x = 0; in_x < p.in_w; ++in_x) {
+                      const int64_t out_x =
+                          in_x * p.stride_w - p.pad_w + kx * p.dilation_w;
+                      if (out_x >= 0 && out_x < p.out_w) {
+                        out_c[out_y * s[2] + out_x * s[3]] +=
+                            src[in_y * p.in_w + in_x];
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          });
+    }
+  }
+}
+
+/**
+ * Computes a depthwise convolution, where every group has a single input
+ * channel, directly, vectorized along the output rows. For NCHW float
+ * tensors.
+ */
+void conv_depthwise(
+    const Conv2dParams& p,
+    const float* in,
+    const float* weight,
+    const float* bias,
+    float* out) {
+  using Vec = executorch::vec::Vectorized<float>;
+  const int64_t multiplier = p.out_channels / p.in_channels;
+  const int64_t kernel_size = p.kernel_h * p.kernel_w;
+  executorch::extension::parallel_for(
+      0,
+      p.batches * p.out_channels,
+      std::max<int64_t>(
+          1, kConvGrainSize / (p.out_h * p.out_w * kernel_size)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t n = i / p.out_channels;
+          const int64_t oc = i % p.out_channels;
+          const float* in_c = in + n * p.in_strides[0] +
+              (oc / multiplier) * p.in_strides[1];
+          const float* w = weight + oc * kernel_size;
+          float* out_c = out + n * p.out_strides[0] + oc * p.out_strides[1];
+          const float initial = bias != nullptr ? bias[oc] : 0.0f;
+          for (int64_t out_y = 0; out_y < p.out_h; ++out_y) {
+            float* out_row = out_c + out_y * p.out_w;
+            std::fill(out_row, out_row + p.out_w, initial);
+            for (int64_t ky = 0; ky < p.kernel_h; ++ky) {
+              const int64_t in_y =
+                  out_y * p.stride_h - p.pad_h + ky * p.dilation_h;
+              if (in_y < 0 || in_y >= p.in_h) {
+                continue;
+              }
+              const float* in_row = in_c + in_y * p.in_w;
+              for (int64_t kx = 0; kx < p.kernel_w; ++kx) {
+                const float wv = w[ky * p.kernel_w + kx];
+                // in_x = out_x * stride_w + offset, for out_x in
+                // [x_begin, x_end).
+                const int64_t offset = kx * p.dilation_w - p.pad_w;
+                const int64_t x_begin = offset >= 0
+                    ? 0
+                    : (-offset + p.stride_w - 1) / p.stride_w;
+                const int64_t x_end = offset >= p.in_w
+                    ? 0
+                    : std::min(p.out_w, (p.in_w - 1 - offset) / p.stride_w + 1);
+                int64_t out_x = x_begin;
+                if (p.stride_w == 1) {
+                  const Vec wv_vec(wv);
+                  for (; out_x + Vec::size() <= x_end; out_x += Vec::size()) {
+                    const Vec acc = executorch::vec::fmadd(
+                        wv_vec,
+                        Vec::loadu(in_row + out_x + offset),
+                        Vec::loadu(out_row + out_x));
+                    acc.store(out_row + out_x);
+                  }
+                }
+                for (; out_x < x_end; ++out_x) {
+                  out_row[out_x] += wv * in_row[out_x * p.stride_w + offset];
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+/**
+ * The transforms of the Winograd algorithm F(kOut x kOut, 3 x 3), which
+ * computes a kOut x kOut output tile from a kTile x kTile input tile with
+ * kTile^2 multiplies per channel pair instead of kOut^2 * 9.
+ */
+struct WinogradF2x3 {
+  static constexpr int64_t kOut = 2;
+  static constexpr int64_t kTile = 4;
+  static constexpr float kBT[kTile][kTile] = {
+      {1, 0, -1, 0},
+      {0, 1, 1, 0},
+      {0, -1, 1, 0},
+      {0, 1, 0, -1},
+  };
+  static constexpr float kG[kTile][3] = {
+      {1, 0, 0},
+      {0.5f, 0.5f, 0.5f},
+      {0.5f, -0.5f, 0.5f},
+      {0, 0, 1},
+  };
+  static constexpr float kAT[kOut][kTile] = {
+      {1, 1, 1, 0},
+      {0, 1, -1, -1},
+  };
+};
+
+struct WinogradF4x3 {
+  static constexpr int64_t kOut = 4;
+  static constexpr int64_t kTile = 6;
+  static constexpr float kBT[kTile][kTile] = {
+      {4, 0, -5, 0, 1, 0},
+      {0, -4, -4, 1, 1, 0},
+      {0, 4, -4, -1, 1, 0},
+      {0, -2, -1, 2, 1, 0},
+      {0, 2, -1, -2, 1, 0},
+      {0, 4, 0, -5, 0, 1},
+  };
+  static constexpr float kG[kTile][3] = {
+      {1.0f / 4, 0, 0},
+      {-1.0f / 6, -1.0f / 6, -1.0f / 6},
+      {-1.0f / 6, 1.0f / 6, -1.0f / 6},
+      {1.0f / 24, 1.0f / 12, 1.0f / 6},
+      {1.0f / 24, -1.0f / 12, 1.0f / 6},
+      {0, 0, 1},
+  };
+  static constexpr float kAT[kOut][kTile] = {
+      {1, 1, 1, 1, 1, 0},
+      {0, 1, -1, 2, -2, 0},
+      {0, 1, 1, 4, 4, 0},
+      {0, 1, -1, 8, -8, 1},
+  };
+};
+
+/// Computes u = G g G^T for a 3 x 3 kernel g.
+template <typename W>
+void winograd_transform_weight(const float* g, float u[W::kTile][W::kTile]) {
+  float tmp[W::kTile][3];
+  for (int64_t i = 0; i < W::kTile; ++i) {
+    for (int64_t j = 0; j < 3; ++j) {
+      tmp[i][j] = W::kG[i][0] * g[j] + W::kG[i][1] * g[3 + j] +
+          W::kG[i][2] * g[6 + j];
+    }
+  }
+  for (int64_t i = 0; i < W::kTile; ++i) {
+    for (int64_t j = 0; j < W::kTile; ++j) {
+      u[i][j] = tmp[i][0] * W::kG[j][0] + tmp[i][1] * W::kG[j][1] +
+          tmp[i][2] * W::kG[j][2];
+    }
+  }
+}
+
+/// Computes v = B^T d B.
+template <typename W>
+void winograd_transform_input(
+    const float d[W::kTile][W::kTile],
+    float v[W::kTile][W::kTile]) {
+  float tmp[W::kTile][W::kTile];
+  for (int64_t i = 0; i < W::kTile; ++i) {
+    for (int64_t j = 0; j < W::kTile; ++j) {
+      float sum = 0;
+      for (int64_t k = 0; k < W::kTile; ++k) {
+        sum += W::kBT[i][k] * d[k][j];
+      }
+      tmp[i][j] = sum;
+    }
+  }
+  for (int64_t i = 0; i < W::kTile; ++i) {
+    for (int64_t j = 0; j < W::kTile; ++j) {
+      float sum = 0;
+      for (int64_t k = 0; k < W::kTile; ++k) {
+        sum += tmp[i][k] * W::kBT[j][k];
+      }
+      v[i][j] = sum;
+    }
+  }
+}
+
+/// Computes y = A^T m A.
+template <typename W>
+void winograd_transform_output(
+    const float m[W::kTile][W::kTile],
+    float y[W::kOut][W::kOut]) {
+  float tmp[W::kOut][W::kTile];
+  for (int64_t i = 0; i < W::kOut; ++i) {
+    for (int64_t j = 0; j < W::kTile; ++j) {
+      float sum = 0;
+      for (int64_t k = 0; k < W::kTile; ++k) {
+        sum += W::kAT[i][k] * m[k][j];
+      }
+      tmp[i][j] = sum;
+    }
+  }
+  for (int64_t i = 0; i < W::kOut; ++i) {
+    for (int64_t j = 0; j < W::kOut; ++j) {
+      float sum = 0;
+      for (int64_t k = 0; k < W::kTile; ++k) {
+        sum += tmp[i][k] * W::kAT[j][k];
+      }
+      y[i][j] = sum;
+    }
+  }
+}
+
+/**
+ * Writes the transformed weight to `u`, as kTile^2 matrices of out_channels
+ * x in_channels.
+ */
+template <typename W>
+void winograd_transform_weights(
+    const Conv2dParams& p,
+    const float* weight,
+    float* u) {
+  constexpr int64_t kArea = W::kTile * W::kTile;
+  const int64_t ic_count = p.in_channels;
+  const int64_t oc_count = p.out_channels;
+  executorch::extension::parallel_for(
+      0,
+      oc_count,
+      std::max<int64_t>(1, kConvGrainSize / (ic_count * kArea * 3)),
+      [&](int64_t begin, int64_t end) {
+        float tile[W::kTile][W::kTile];
+        for (int64_t oc = begin; oc < end; ++oc) {
+          for (int64_t ic = 0; ic < ic_count; ++ic) {
+            winograd_transform_weight<W>(
+                weight + (oc * ic_count + ic) * 9, tile);
+            for (int64_t e = 0; e < kArea; ++e) {
+              u[(e * oc_count + oc) * ic_count + ic] =
+                  tile[e / W::kTile][e % W::kTile];
+            }
+          }
+        }
+      });
+}
+
+/**
+ * Computes a 3x3 convolution with a stride and dilation of 1 with the
+ * Winograd algorithm, for NCHW float tensors without groups. Each block of
+ * tiles turns into kTile^2 gemms of (tiles x in_channels) @ (in_channels x
+ * out_channels).
+ */
+template <typename W>
+void conv_winograd(
+    KernelRuntimeContext& ctx,
+    const Conv2dParams& p,
+    const float* in,
+    const Tensor& weight_tensor,
+    const float* weight,
+    const float* bias,
+    float* out) {
+  constexpr int64_t kTile = W::kTile;
+  constexpr int64_t kOut = W::kOut;
+  constexpr int64_t kArea = kTile * kTile;
+  const int64_t ic_count = p.in_channels;
+  const int64_t oc_count = p.out_channels;
+  const size_t u_numel = kArea * oc_count * ic_count;
+
+  // The weight is usually a constant, so it only has to be transformed once.
+  const float* u = nullptr;
+  std::vector<float> u_storage;
+  auto* cache = ctx.kernel_cache();
+  const void* weight_key = weight_tensor.const_data_ptr();
+  if (cache != nullptr && cache->is_constant(weight_key)) {
+    auto cached = cache->get_or_create(
+        weight_key,
+        kWinogradWeightTag | static_cast<uint32_t>(kOut),
+        u_numel * sizeof(float),
+        [&](void* data, size_t) {
+          winograd_transform_weights<W>(p, weight, static_cast<float*>(data));
+          return Error::Ok;
+        });
+    // If the entry can't be created, fall back to transforming it here.
+    if (cached.ok()) {
+      u = static_cast<const float*>(cached.get());
+    }
+  }
+  if (u == nullptr) {
+    u_storage.resize(u_numel);
+    winograd_transform_weights<W>(p, weight, u_storage.data());
+    u = u_storage.data();
+  }
+
+  const int64_t tiles_h = (p.out_h + kOut - 1) / kOut;
+  const int64_t tiles_w = (p.out_w + kOut - 1) / kOut;
+  const int64_t tiles = tiles_h * tiles_w;
+  const int64_t blocks_per_batch =
+      (tiles + kWinogradTileBlock - 1) / kWinogradTileBlock;
+  executorch::extension::parallel_for(
+      0,
+      p.batches * blocks_per_batch,
+      1,
+      [&](int64_t begin, int64_t end) {
+        // The transformed input and output of a block, as kArea matrices of
+        // (tile, channel) in column-major order.
+        std::vector<float> v(kArea * ic_count * kWinogradTileBlock);
+        std::vector<float> m(kArea * oc_count * kWinogradTileBlock);
+        for (int64_t block = begin; block < end; ++block) {
+          const int64_t n = block / blocks_per_batch;
+          const int64_t first_tile =
+              (block % blocks_per_batch) * kWinogradTileBlock;
+          const int64_t block_tiles =
+              std::min(kWinogradTileBlock, tiles - first_tile);
+
+          for (int64_t ic = 0; ic < ic_count; ++ic) {
+            const float* in_c =
+                in + n * p.in_strides[0] + ic * p.in_strides[1];
+            for (int64_t t = 0; t < block_tiles; ++t) {
+              const int64_t y0 = ((first_tile + t) / tiles_w) * kOut - p.pad_h;
+              const int64_t x0 = ((first_tile + t) % tiles_w) * kOut - p.pad_w;
+              float d[kTile][kTile];
+              for (int64_t i = 0; i < kTile; ++i) {
+                const int64_t y = y0 + i;
+                for (int64_t j = 0; j < kTile; ++j) {
+                  const int64_t x = x0 + j;
+                  d[i][j] = y >= 0 && y < p.in_h && x >= 0 && x < p.in_w
+                      ? in_c[y * p.in_w + x]
+                      : 0.0f;
+                }
+              }
+              float tile[kTile][kTile];
+              winograd_transform_input<W>(d, tile);
+              for (int64_t e = 0; e < kArea; ++e) {
+                v[(e * ic_count + ic) * block_tiles + t] =
+                    tile[e / kTile][e % kTile];
+              }
+            }
+          }
+
+          for (int64_t e = 0; e < kArea; ++e) {
+            executorch::cpublas::gemm(
+                TransposeType::NoTranspose,
+                TransposeType::NoTranspose,
+                block_tiles,
+                oc_count,
+                ic_count,
+                1.0f,
+                v.data() + e * ic_count * block_tiles,
+                block_tiles,
+                u + e * oc_count * ic_count,
+                ic_count,
+                0.0f,
+                m.data() + e * oc_count * block_tiles,
+                block_tiles);
+          }
+
+          for (int64_t oc = 0; oc < oc_count; ++oc) {
+            float* out_c = out + n * p.out_strides[0] + oc * p.out_strides[1];
+            const float initial = bias != nullptr ? bias[oc] : 0.0f;
+            for (int64_t t = 0; t < block_tiles; ++t) {
+              float tile[kTile][kTile];
+              for (int64_t e = 0; e < kArea; ++e) {
+                tile[e / kTile][e % kTile] =
+                    m[(e * oc_count + oc) * block_tiles + t];
+              }
+              float y[kOut][kOut];
+              winograd_transform_output<W>(tile, y);
+              const int64_t y0 = ((first_tile + t) / tiles_w) * kOut;
+              const int64_t x0 = ((first_tile + t) % tiles_w) * kOut;
+              for (int64_t i = 0; i < kOut && y0 + i < p.out_h; ++i) {
+                for (int64_t j = 0; j < kOut && x0 + j < p.out_w; ++j) {
+                  out_c[(y0 + i) * p.out_w + x0 + j] = y[i][j] + initial;
+                }
+              }
+            }
+          }
+        }
+      });
+}
+
+bool can_use_winograd(const Conv2dParams& p, bool transposed) {
+  // Below 8 channels the transforms cost more than the multiplies saved.
+  return !transposed && !p.channels_last && p.groups == 1 &&
+      p.kernel_h == 3 && p.kernel_w == 3 && p.stride_h == 1 &&
+      p.stride_w == 1 && p.dilation_h == 1 && p.dilation_w == 1 &&
+      p.in_channels >= 8 && p.out_channels >= 8;
+}
+
+bool can_use_depthwise(const Conv2dParams& p, bool transposed) {
+  return !transposed && !p.channels_last && p.groups > 1 &&
+      p.groups == p.in_channels;
+}
+
+template <typename CTYPE, const char* op_name>
+void convolution(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    const Conv2dParams& p,
+    bool transposed,
+    Tensor& out) {
+  std::vector<CTYPE> bias_values;
+  if (bias.has_value()) {
+    const auto load_bias =
+        utils::internal::get_load_to_common_fn<CTYPE, op_name>(
+            bias.value(), utils::SupportedTensorDtypes::REALHBF16);
+    const char* bias_data =
+        reinterpret_cast<const char*>(bias.value().const_data_ptr());
+    const size_t bias_element_size = bias.value().element_size();
+    bias_values.resize(p.out_channels);
+    for (int64_t c = 0; c < p.out_channels; ++c) {
+      bias_values[c] = load_bias(bias_data + c * bias_element_size);
+    }
+  }
+  const CTYPE* bias_data = bias.has_value() ? bias_values.data() : nullptr;
+
+  std::vector<CTYPE> weight_storage;
+  const CTYPE* weight_data =
+      get_contiguous_weight<CTYPE>(weight, weight_storage);
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  if constexpr (std::is_same<CTYPE, float>::value) {
+    if (can_use_winograd(p, transposed)) {
+      // Larger tiles save more multiplies, but waste more on small outputs.
+      if (p.out_h >= 8 && p.out_w >= 8) {
+        conv_winograd<WinogradF4x3>(
+            ctx, p, in_data, weight, weight_data, bias_data, out_data);
+      } else {
+        conv_winograd<WinogradF2x3>(
+            ctx, p, in_data, weight, weight_data, bias_data, out_data);
+      }
+      return;
+    }
+    if (can_use_depthwise(p, transposed)) {
+      conv_depthwise(p, in_data, weight_data, bias_data, out_data);
+      return;
+    }
+  }
+
+  fill_with_bias(p, bias_data, out_data);
+  if (transposed) {
+    conv_transposed_gemm(p, in_data, weight_data, out_data);
+  } else {
+    conv_im2col_gemm(p, in_data, weight_data, out_data);
+  }
+}
+
+} // namespace
+
+Tensor& opt_convolution_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const exec_aten::optional<Tensor>& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    bool transposed,
+    IntArrayRef output_padding,
+    int64_t groups,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_convolution_args(
+          in,
+          weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          transposed,
+          output_padding,
+          groups,
+          out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  size_t output_ndim = 0;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  get_convolution_out_target_size(
+      in,
+      weight,
+      stride,
+      padding,
+      dilation,
+      transposed,
+      output_padding,
+      groups,
+      output_sizes,
+      &output_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      output_size_is_valid({output_sizes, output_ndim}, in.dim() - 2),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  const Conv2dParams p =
+      get_conv2d_params(in, weight, stride, padding, dilation, groups, out);
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char name[] = "convolution.out";
+
+  ET_SWITCH_REALH_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    convolution<CTYPE, name>(ctx, in, weight, bias, p, transposed, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <array>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/dtype_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+// The minimum number of elements that each parallel_for chunk sums.
+constexpr int64_t kCumsumGrainSize = 32768;
+
+/**
+ * The layout of dense tensors with the same sizes and dim order around the
+ * cumsum dim, as `outer_size` rows of `dim_size` elements that are
+ * `inner_size` apart.
+ */
+struct CumsumDims {
+  CumsumDims(const Tensor& t, int64_t dim)
+      : dim_size(t.dim() == 0 ? 1 : t.size(dim)),
+        inner_size(t.dim() == 0 ? 1 : t.strides()[dim]),
+        outer_size(t.numel() / (dim_size * inner_size)) {}
+
+  int64_t dim_size;
+  int64_t inner_size;
+  int64_t outer_size;
+};
+
+/**
+ * Computes the prefix sums of one long contiguous row, like the probabilities
+ * that a sampler draws from, in blocks across the threadpool: each block is
+ * summed on its own, then the total of the blocks before it is added to it.
+ */
+template <typename CTYPE>
+void parallel_cumsum_contiguous(const CTYPE* in, CTYPE* out, int64_t size) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  constexpr int64_t kMaxBlocks = 64;
+  const int64_t block_size =
+      std::max(kCumsumGrainSize, (size + kMaxBlocks - 1) / kMaxBlocks);
+  const int64_t num_blocks = (size + block_size - 1) / block_size;
+
+  executorch::extension::parallel_for(
+      0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; ++block) {
+          const int64_t offset = block * block_size;
+          const int64_t block_end = std::min(offset + block_size, size);
+          CTYPE acc = 0;
+          for (int64_t i = offset; i < block_end; ++i) {
+            acc += in[i];
+            out[i] = acc;
+          }
+        }
+      });
+
+  std::array<CTYPE, kMaxBlocks> carries;
+  carries[0] = 0;
+  for (int64_t block = 1; block < num_blocks; ++block) {
+    carries[block] = carries[block - 1] + out[block * block_size - 1];
+  }
+
+  executorch::extension::parallel_for(
+      1, num_blocks, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; ++block) {
+          const int64_t offset = block * block_size;
+          const Vec carry(carries[block]);
+          executorch::vec::map<CTYPE>(
+              [carry](Vec x) { return x + carry; },
+              out + offset,
+              out + offset,
+              std::min(block_size, size - offset));
+        }
+      });
+}
+
+/**
+ * Cumsum of a tensor into one of the same dtype. Rows along a contiguous dim
+ * are split across the threadpool, or in blocks if there is only one. Along
+ * other dims, each step adds a contiguous run of `inner_size` elements to the
+ * previous one, which vectorizes.
+ */
+template <typename CTYPE>
+void cumsum_same_type(const Tensor& self, int64_t dim, Tensor& out) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  const CTYPE* in_data = self.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+  const CumsumDims dims(self, dim);
+
+  if (dims.inner_size == 1) {
+    if (dims.outer_size == 1 && dims.dim_size >= 2 * kCumsumGrainSize) {
+      parallel_cumsum_contiguous(in_data, out_data, dims.dim_size);
+      return;
+    }
+    const int64_t grain_size = std::max<int64_t>(
+        1, kCumsumGrainSize / std::max<int64_t>(1, dims.dim_size));
+    executorch::extension::parallel_for(
+        0, dims.outer_size, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; ++row) {
+            const CTYPE* in = in_data + row * dims.dim_size;
+            CTYPE* out = out_data + row * dims.dim_size;
+            CTYPE acc = 0;
+            for (int64_t i = 0; i < dims.dim_size; ++i) {
+              acc += in[i];
+              out[i] = acc;
+            }
+          }
+        });
+    return;
+  }
+
+  const int64_t row_size = dims.dim_size * dims.inner_size;
+  const int64_t grain_size =
+      std::max<int64_t>(1, kCumsumGrainSize / std::max<int64_t>(1, row_size));
+  executorch::extension::parallel_for(
+      0, dims.outer_size, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t outer = begin; outer < end; ++outer) {
+          const CTYPE* in = in_data + outer * row_size;
+          CTYPE* out = out_data + outer * row_size;
+          std::copy(in, in + dims.inner_size, out);
+          for (int64_t d = 1; d < dims.dim_size; ++d) {
+            const int64_t offset = d * dims.inner_size;
+            executorch::vec::map2<CTYPE>(
+                [](Vec x, Vec prev) { return x + prev; },
+                out + offset,
+                in + offset,
+                out + offset - dims.inner_size,
+                dims.inner_size);
+          }
+        }
+      });
+}
+
+/**
+ * Cumsum of a tensor into one of another dtype, converting each element as
+ * it is loaded, like the portable kernel.
+ */
+template <typename CTYPE_OUT, typename LoadFn = CTYPE_OUT (*)(const void*)>
+void cumsum_converting(
+    const Tensor& self,
+    LoadFn load_self,
+    int64_t dim,
+    Tensor& out) {
+  const char* const in_data =
+      reinterpret_cast<const char*>(self.const_data_ptr());
+  CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
+  const size_t element_size = self.element_size();
+  const CumsumDims dims(self, dim);
+
+  for (int64_t outer = 0; outer < dims.outer_size; ++outer) {
+    const int64_t start = outer * dims.dim_size * dims.inner_size;
+    for (int64_t i = 0; i < dims.inner_size; ++i) {
+      out_data[start + i] = load_self(&in_data[(start + i) * element_size]);
+    }
+    for (int64_t d = 1; d < dims.dim_size; ++d) {
+      const int64_t base = start + d * dims.inner_size;
+      for (int64_t i = 0; i < dims.inner_size; ++i) {
+        out_data[base + i] = load_self(&in_data[(base + i) * element_size]) +
+            out_data[base - dims.inner_size + i];
+      }
+    }
+  }
+}
+
+} // namespace
+
+/**
+ * Returns the cumulative sum of elements of input in the dimension dim.
+ * If dtype is specified, the input tensor is casted to dtype before the
+ * operation is performed. This is useful for preventing data type overflows.
+ *
+ * cumsum.out(Tensor self, int dim, *, ScalarType? dtype=None,
+ *     Tensor(a!) out) -> Tensor(a!)
+ */
+Tensor& opt_cumsum_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& self,
+    int64_t dim,
+    optional<ScalarType> enforced_dtype,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_cumsum_args(self, dim, enforced_dtype, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(self, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, resize_tensor(out, self.sizes()) == Error::Ok, InvalidArgument, out);
+
+  if (self.numel() == 0) {
+    return out;
+  }
+
+  dim = (self.dim() == 0) ? 0 : dim < 0 ? dim + self.dim() : dim;
+
+  // @lint-ignore CLANGTIDY facebook-hte-CArray
+  static constexpr const char op_name[] = "cumsum.out";
+
+  if (self.scalar_type() == out.scalar_type() &&
+      isRealType(out.scalar_type())) {
+    ET_SWITCH_REAL_TYPES(out.scalar_type(), ctx, op_name, CTYPE, [&] {
+      cumsum_same_type<CTYPE>(self, dim, out);
+    });
+    return out;
+  }
+
+  ET_SWITCH_REALHBBF16_TYPES(out.scalar_type(), ctx, op_name, CTYPE_OUT, [&] {
+    const auto load_self =
+        utils::internal::get_load_to_common_fn<CTYPE_OUT, op_name>(
+            self, utils::SupportedTensorDtypes::REALHBBF16);
+    cumsum_converting<CTYPE_OUT>(self, load_self, dim, out);
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/cpu/binary_ops.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -111,15 +112,29 @@ Tensor& opt_div_out(
         "Failed to resize output tensor.");
 
     ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "div.out", CTYPE, [&]() {
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [](Vec x, Vec y) { return x / y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
+      if constexpr (has_vec_kernels_v<CTYPE>) {
+        vec_binary_stub(
+            VecBinaryOp::kDiv,
+            out_type,
+            a.const_data_ptr(),
+            b.const_data_ptr(),
+            /*alpha=*/1,
+            out.mutable_data_ptr(),
+            out.numel());
+      } else {
+        using Vec = executorch::vec::Vectorized<CTYPE>;
+        executorch::vec::map2<CTYPE>(
+            [](Vec x, Vec y) { return x / y; },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            out.numel());
+      }
     });
-  } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
+  } else if (
+      selected_optimized_path == ElementwiseOptimizedPath::kBroadcast2dBy1d ||
+      selected_optimized_path ==
+          ElementwiseOptimizedPath::kBroadcast2dBy1dReverseArguments) {
     const Tensor* lhs;
     const Tensor* rhs;
     if (selected_optimized_path ==
@@ -127,10 +142,6 @@ Tensor& opt_div_out(
       lhs = &b;
       rhs = &a;
     } else {
-      // Catch failure to update logic when subing new broadcasting possibility.
-      ET_DCHECK(
-          selected_optimized_path ==
-          ElementwiseOptimizedPath::kBroadcast2dBy1d);
       lhs = &a;
       rhs = &b;
     }
@@ -162,6 +173,19 @@ Tensor& opt_div_out(
             lhs->sizes()[lhs->dim() - 1]);
       }
     });
+  } else if (
+      selected_optimized_path != ElementwiseOptimizedPath::kNone &&
+      isFloatingType(out_type)) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_to_broadcast_target_size(a, b, out) == Error::Ok,
+        InvalidArgument,
+        out);
+    ET_SWITCH_FLOAT_TYPES(out_type, ctx, "div.out", CTYPE, [&]() {
+      using Vec = executorch::vec::Vectorized<CTYPE>;
+      broadcasting_map_nd<CTYPE>(
+          [](Vec x, Vec y) { return x / y; }, a, b, out);
+    });
   } else {
     ScalarType common_type = get_compute_type(a_type, b_type);
     ET_KERNEL_CHECK(ctx, canCast(common_type, out_type), InvalidArgument, out);
@@ -176,7 +200,7 @@ Tensor& opt_div_out(
       ET_SWITCH_REALB_TYPES(b_type, ctx, "div.out", CTYPE_B, [&]() {
         ET_SWITCH_REALB_TYPES(common_type, ctx, "div.out", CTYPE_IN, [&]() {
           ET_SWITCH_REALB_TYPES(out_type, ctx, "div.out", CTYPE_OUT, [&]() {
-            apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
+            apply_broadcasting_binary_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
                 [](const CTYPE_A val_a, const CTYPE_B val_b) {
                   CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
                   CTYPE_IN b_casted = static_cast<CTYPE_IN>(val_b);
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/gather_util.h>
+#include <executorch/kernels/portable/cpu/util/kernel_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+/**
+ * Checks all of the indices before copying any rows, so that the rows can be
+ * copied in parallel. Returns false after logging the first bad index.
+ */
+template <typename CTYPE>
+bool check_embedding_indices(const Tensor& weight, const Tensor& indices) {
+  const CTYPE* indices_ptr = indices.const_data_ptr<CTYPE>();
+  const ssize_t weight_height = weight.size(0);
+  for (ssize_t i = 0; i < indices.numel(); ++i) {
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        indices_ptr[i] < weight_height,
+        "indices_ptr[%zd] %ld >= weight.size(0) %zd",
+        i,
+        static_cast<long>(indices_ptr[i]),
+        weight_height);
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        indices_ptr[i] >= 0,
+        "indices_ptr[%zd] %ld < 0",
+        i,
+        static_cast<long>(indices_ptr[i]));
+  }
+  return true;
+}
+
+} // namespace
+
+/**
+ * Looks up the rows of `weight` at `indices`. The rows are copied across the
+ * threadpool, with the upcoming rows prefetched, which matters for the long
+ * prompts of LLMs, whose rows are scattered across a large table.
+ *
+ * embedding.out(Tensor weight, Tensor indices, int padding_idx=-1, bool
+ * scale_grad_by_freq=False, bool sparse=False, *, Tensor(a!) out) ->
+ * Tensor(a!)
+ */
+Tensor& opt_embedding_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& weight,
+    const Tensor& indices,
+    int64_t padding_idx,
+    bool scale_grad_by_freq,
+    bool sparse,
+    Tensor& out) {
+  (void)padding_idx;
+  (void)scale_grad_by_freq;
+  (void)sparse;
+
+  ET_KERNEL_CHECK(
+      ctx, check_embedding_args(weight, indices, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_embedding_output(weight, indices, out) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      out.size(out.dim() - 1) == weight.size(1),
+      InvalidArgument,
+      out,
+      "out.size(%zd) %zd != weight.size(1) %zd",
+      out.dim() - 1,
+      out.size(1),
+      weight.size(1));
+
+  ET_KERNEL_CHECK(
+      ctx,
+      tensors_have_same_dim_order(weight, indices, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensor_is_default_dim_order(weight), InvalidArgument, out);
+
+  ScalarType ix_type = indices.scalar_type();
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      ix_type == ScalarType::Long || ix_type == ScalarType::Int,
+      InvalidArgument,
+      out,
+      "Expected indices tensor to have Long or Int scalar types");
+
+  ET_SWITCH_TWO_TYPES(
+      Long, Int, ix_type, ctx, "embedding.out", CTYPE, [&]() {
+        ET_KERNEL_CHECK(
+            ctx,
+            check_embedding_indices<CTYPE>(weight, indices),
+            InvalidArgument, );
+        const CTYPE* indices_ptr = indices.const_data_ptr<CTYPE>();
+        gather_rows(
+            out.mutable_data_ptr<char>(),
+            weight.const_data_ptr<char>(),
+            weight.size(1) * weight.element_size(),
+            indices.numel(),
+            [indices_ptr](int64_t i) {
+              return static_cast<int64_t>(indices_ptr[i]);
+            });
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
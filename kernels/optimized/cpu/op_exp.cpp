@@ -8,6 +8,7 @@
 
 #include <cmath>
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
@@ -34,9 +35,20 @@ void exp_data(
     const CTYPE_IN* in_data,
     const size_t numel,
     CTYPE_OUT* out_data) {
-  using Vec = executorch::vec::Vectorized<CTYPE_IN>;
-  executorch::vec::map<CTYPE_IN>(
-      [](Vec x) { return x.exp(); }, out_data, in_data, numel);
+  if constexpr (has_vec_kernels_v<CTYPE_IN>) {
+    vec_unary_stub(
+        get_math_accuracy(MathKernel::kExp) == MathAccuracy::kFast
+            ? VecUnaryOp::kFastExp
+            : VecUnaryOp::kExp,
+        CppTypeToScalarType<CTYPE_IN>::value,
+        in_data,
+        out_data,
+        numel);
+  } else {
+    using Vec = executorch::vec::Vectorized<CTYPE_IN>;
+    executorch::vec::map<CTYPE_IN>(
+        [](Vec x) { return x.exp(); }, out_data, in_data, numel);
+  }
 }
 
 /**
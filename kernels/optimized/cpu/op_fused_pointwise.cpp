@@ -0,0 +1,317 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/op_fused_pointwise.h>
+
+#include <executorch/extension/kernel_util/make_boxed_from_unboxed_functor.h>
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <functional>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+// The number of vectors that each instruction processes before moving on to
+// the next one, to spread the cost of decoding it.
+constexpr int64_t kTileVectors = 4;
+
+// The minimum number of output elements that each parallel_for chunk computes.
+constexpr int64_t kGrainSize = 32768;
+
+struct Instruction {
+  PointwiseOpcode opcode;
+  int64_t arg0;
+  int64_t arg1;
+};
+
+bool is_binary(PointwiseOpcode opcode) {
+  return opcode == PointwiseOpcode::kAdd || opcode == PointwiseOpcode::kSub ||
+      opcode == PointwiseOpcode::kMul || opcode == PointwiseOpcode::kDiv;
+}
+
+bool is_unary(PointwiseOpcode opcode) {
+  return opcode == PointwiseOpcode::kNeg || opcode == PointwiseOpcode::kExp ||
+      opcode == PointwiseOpcode::kSigmoid ||
+      opcode == PointwiseOpcode::kRelu || opcode == PointwiseOpcode::kTanh;
+}
+
+// Decodes and validates `program` into `instructions`, returning false if it
+// is invalid.
+bool decode_program(
+    IntArrayRef program,
+    size_t num_inputs,
+    size_t num_constants,
+    Instruction* instructions,
+    size_t* size_out) {
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      program.size() % 3 == 0,
+      "program size %zu is not a multiple of 3",
+      program.size());
+  const size_t size = program.size() / 3;
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      size > 0 && size <= kMaxPointwiseInstructions,
+      "program has %zu instructions, must have 1 to %zu",
+      size,
+      kMaxPointwiseInstructions);
+  for (size_t i = 0; i < size; ++i) {
+    const int64_t opcode = program[3 * i];
+    const int64_t arg0 = program[3 * i + 1];
+    const int64_t arg1 = program[3 * i + 2];
+    const auto op = static_cast<PointwiseOpcode>(opcode);
+    bool valid;
+    if (op == PointwiseOpcode::kInput) {
+      valid = arg0 >= 0 && arg0 < num_inputs;
+    } else if (op == PointwiseOpcode::kConstant) {
+      valid = arg0 >= 0 && arg0 < num_constants;
+    } else if (is_binary(op)) {
+      valid = arg0 >= 0 && arg0 < i && arg1 >= 0 && arg1 < i;
+    } else if (is_unary(op)) {
+      valid = arg0 >= 0 && arg0 < i;
+    } else {
+      valid = false;
+    }
+    ET_LOG_MSG_AND_RETURN_IF_FALSE(
+        valid,
+        "invalid instruction %zu: (%" PRId64 ", %" PRId64 ", %" PRId64 ")",
+        i,
+        opcode,
+        arg0,
+        arg1);
+    instructions[i] = Instruction{op, arg0, arg1};
+  }
+  *size_out = size;
+  return true;
+}
+
+template <typename CTYPE>
+class PointwiseProgram final {
+ public:
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  static constexpr int64_t kTileSize = kTileVectors * Vec::size();
+  // One register per instruction.
+  using Registers = Vec[kMaxPointwiseInstructions][kTileVectors];
+
+  PointwiseProgram(
+      const Instruction* instructions,
+      size_t size,
+      TensorList inputs,
+      ArrayRef<double> constants,
+      Tensor& out)
+      : instructions_(instructions),
+        size_(size),
+        inputs_(inputs),
+        constants_(constants),
+        out_data_(out.mutable_data_ptr<CTYPE>()) {}
+
+  // Computes the output elements [begin, begin + count), where count is at
+  // most kTileSize, and is kTileSize if kFullTile.
+  template <bool kFullTile>
+  void run_tile(int64_t begin, int64_t count, Registers& regs) const {
+    for (size_t i = 0; i < size_; ++i) {
+      const Instruction& inst = instructions_[i];
+      Vec* r = regs[i];
+      switch (inst.opcode) {
+        case PointwiseOpcode::kInput: {
+          const Tensor& input = inputs_[inst.arg0];
+          const CTYPE* data = input.const_data_ptr<CTYPE>();
+          if (input.numel() == 1) {
+            std::fill(r, r + kTileVectors, Vec(data[0]));
+          } else {
+            load<kFullTile>(data + begin, count, r);
+          }
+          break;
+        }
+        case PointwiseOpcode::kConstant:
+          std::fill(
+              r,
+              r + kTileVectors,
+              Vec(static_cast<CTYPE>(constants_[inst.arg0])));
+          break;
+        case PointwiseOpcode::kAdd:
+          apply(r, regs[inst.arg0], regs[inst.arg1], std::plus<Vec>());
+          break;
+        case PointwiseOpcode::kSub:
+          apply(r, regs[inst.arg0], regs[inst.arg1], std::minus<Vec>());
+          break;
+        case PointwiseOpcode::kMul:
+          apply(r, regs[inst.arg0], regs[inst.arg1], std::multiplies<Vec>());
+          break;
+        case PointwiseOpcode::kDiv:
+          apply(r, regs[inst.arg0], regs[inst.arg1], std::divides<Vec>());
+          break;
+        case PointwiseOpcode::kNeg:
+          apply(r, regs[inst.arg0], [](Vec x) { return x.neg(); });
+          break;
+        case PointwiseOpcode::kExp:
+          apply(r, regs[inst.arg0], [](Vec x) { return x.exp(); });
+          break;
+        case PointwiseOpcode::kSigmoid:
+          apply(r, regs[inst.arg0], [](Vec x) {
+            return (x.neg().exp() + Vec(static_cast<CTYPE>(1))).reciprocal();
+          });
+          break;
+        case PointwiseOpcode::kRelu:
+          apply(r, regs[inst.arg0], [](Vec x) {
+            return executorch::vec::maximum(x, Vec(static_cast<CTYPE>(0)));
+          });
+          break;
+        case PointwiseOpcode::kTanh:
+          apply(r, regs[inst.arg0], [](Vec x) { return x.tanh(); });
+          break;
+      }
+    }
+    store<kFullTile>(regs[size_ - 1], out_data_ + begin, count);
+  }
+
+ private:
+  template <bool kFullTile>
+  static void load(const CTYPE* data, int64_t count, Vec* r) {
+    for (int64_t j = 0; j < kTileVectors; ++j) {
+      const int64_t offset = j * Vec::size();
+      if (kFullTile) {
+        r[j] = Vec::loadu(data + offset);
+      } else if (offset < count) {
+        r[j] = Vec::loadu(
+            data + offset, std::min<int64_t>(Vec::size(), count - offset));
+      } else {
+        r[j] = Vec(static_cast<CTYPE>(0));
+      }
+    }
+  }
+
+  template <bool kFullTile>
+  static void store(const Vec* r, CTYPE* data, int64_t count) {
+    for (int64_t j = 0; j < kTileVectors; ++j) {
+      const int64_t offset = j * Vec::size();
+      if (kFullTile) {
+        r[j].store(data + offset);
+      } else if (offset < count) {
+        r[j].store(
+            data + offset, std::min<int64_t>(Vec::size(), count - offset));
+      }
+    }
+  }
+
+  template <typename Op>
+  static void apply(Vec* r, const Vec* a, const Op& op) {
+    for (int64_t j = 0; j < kTileVectors; ++j) {
+      r[j] = op(a[j]);
+    }
+  }
+
+  template <typename Op>
+  static void apply(Vec* r, const Vec* a, const Vec* b, const Op& op) {
+    for (int64_t j = 0; j < kTileVectors; ++j) {
+      r[j] = op(a[j], b[j]);
+    }
+  }
+
+  const Instruction* instructions_;
+  size_t size_;
+  TensorList inputs_;
+  ArrayRef<double> constants_;
+  CTYPE* out_data_;
+};
+
+template <typename CTYPE>
+void run_program(
+    const Instruction* instructions,
+    size_t size,
+    TensorList inputs,
+    ArrayRef<double> constants,
+    Tensor& out) {
+  const PointwiseProgram<CTYPE> program(
+      instructions, size, inputs, constants, out);
+  constexpr int64_t kTileSize = PointwiseProgram<CTYPE>::kTileSize;
+  const int64_t numel = out.numel();
+  const int64_t num_full_tiles = numel / kTileSize;
+  executorch::extension::parallel_for(
+      0,
+      num_full_tiles,
+      std::max<int64_t>(1, kGrainSize / kTileSize),
+      [&](int64_t begin, int64_t end) {
+        typename PointwiseProgram<CTYPE>::Registers regs;
+        for (int64_t tile = begin; tile < end; ++tile) {
+          program.template run_tile</*kFullTile=*/true>(
+              tile * kTileSize, kTileSize, regs);
+        }
+      });
+  const int64_t tail_begin = num_full_tiles * kTileSize;
+  if (tail_begin < numel) {
+    typename PointwiseProgram<CTYPE>::Registers regs;
+    program.template run_tile</*kFullTile=*/false>(
+        tail_begin, numel - tail_begin, regs);
+  }
+}
+
+} // namespace
+
+Tensor& fused_pointwise_out(
+    KernelRuntimeContext& ctx,
+    TensorList inputs,
+    IntArrayRef program,
+    ArrayRef<double> constants,
+    Tensor& out) {
+  Instruction instructions[kMaxPointwiseInstructions];
+  size_t size = 0;
+  ET_KERNEL_CHECK(
+      ctx,
+      decode_program(
+          program, inputs.size(), constants.size(), instructions, &size),
+      InvalidArgument,
+      out);
+
+  // The output has the shape of the largest input.
+  const Tensor* largest = nullptr;
+  for (const Tensor& input : inputs) {
+    ET_KERNEL_CHECK(
+        ctx, tensors_have_same_dtype(input, out), InvalidArgument, out);
+    if (largest == nullptr || input.numel() > largest->numel()) {
+      largest = &input;
+    }
+  }
+  ET_KERNEL_CHECK(ctx, largest != nullptr, InvalidArgument, out);
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, largest->sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+  for (const Tensor& input : inputs) {
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        input.numel() == 1 || tensors_have_same_shape(input, out),
+        InvalidArgument,
+        out,
+        "Inputs must have the shape of the output or a single element");
+  }
+
+  ET_SWITCH_FLOAT_TYPES(
+      out.scalar_type(), ctx, "fused_pointwise.out", CTYPE, [&]() {
+        run_program<CTYPE>(instructions, size, inputs, constants, out);
+      });
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
+
+EXECUTORCH_LIBRARY(
+    fused_ops,
+    "pointwise.out",
+    torch::executor::native::fused_pointwise_out);
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * The opcodes of the programs that fused_pointwise_out() runs. Must stay in
+ * sync with exir/passes/fused_pointwise_ops_registry.py.
+ */
+enum class PointwiseOpcode : int64_t {
+  /// r = inputs[arg0]
+  kInput = 0,
+  /// r = constants[arg0]
+  kConstant = 1,
+  /// r = regs[arg0] <op> regs[arg1]
+  kAdd = 2,
+  kSub = 3,
+  kMul = 4,
+  kDiv = 5,
+  /// r = <op>(regs[arg0])
+  kNeg = 6,
+  kExp = 7,
+  kSigmoid = 8,
+  kRelu = 9,
+  kTanh = 10,
+};
+
+/// The maximum number of instructions in a fused pointwise program.
+constexpr size_t kMaxPointwiseInstructions = 32;
+
+/**
+ * Computes a chain of pointwise ops in a single pass over memory, instead of
+ * one pass per op.
+ *
+ * `program` is a flat list of (opcode, arg0, arg1) instructions, see
+ * PointwiseOpcode. Instruction i writes register i and may only read the
+ * registers of earlier instructions; the last register is the output. Unused
+ * args are 0.
+ *
+ * All inputs and `out` must have the same floating point dtype. Inputs either
+ * have the shape of `out`, or a single element that is broadcast.
+ */
+Tensor& fused_pointwise_out(
+    KernelRuntimeContext& ctx,
+    TensorList inputs,
+    IntArrayRef program,
+    ArrayRef<double> constants,
+    Tensor& out);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/kernels/optimized/cpu/gather_util.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+
+namespace {
+
+/**
+ * Whether the gather can walk `in`, `index` and `out` by offsets: all three
+ * are dense with the default dim order, and the dims of `index` after `dim`
+ * match those of `in`, so that each run of those dims is contiguous in both.
+ * The dims before `dim` may still be smaller in `index` than in `in`.
+ */
+bool can_gather_by_offsets(
+    const Tensor& in,
+    const Tensor& index,
+    const Tensor& out,
+    int64_t dim) {
+  if (in.dim() == 0 || in.dim() != index.dim() ||
+      !tensor_is_default_dim_order(in) ||
+      !tensor_is_default_dim_order(index) ||
+      !tensor_is_default_dim_order(out)) {
+    return false;
+  }
+  for (size_t d = dim + 1; d < in.dim(); ++d) {
+    if (index.size(d) != in.size(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Gathers one block of the dims from `dim` on for each combination of the
+ * dims before it, which are split across the threadpool. Within a block, the
+ * offsets into `in` only depend on the index and the position in the run of
+ * the dims after `dim`.
+ */
+template <typename CTYPE>
+void gather_by_offsets(
+    const Tensor& in,
+    const Tensor& index,
+    Tensor& out,
+    int64_t dim) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* index_data = index.const_data_ptr<int64_t>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  const int64_t inner_size = getTrailingDims(index, dim);
+  const int64_t block_size = index.size(dim) * inner_size;
+  const int64_t num_blocks = getLeadingDims(index, dim);
+  const int64_t in_dim_stride = in.strides()[dim];
+  const int64_t block_bytes = block_size * static_cast<int64_t>(sizeof(CTYPE));
+  const int64_t grain_size = std::max<int64_t>(
+      1, kGatherGrainBytes / std::max<int64_t>(1, block_bytes));
+
+  executorch::extension::parallel_for(
+      0, num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; ++block) {
+          // The offset into `in` of the block's coordinates before `dim`.
+          int64_t in_base = 0;
+          int64_t remaining = block;
+          for (int64_t d = dim - 1; d >= 0; --d) {
+            const int64_t coord = remaining % index.size(d);
+            remaining /= index.size(d);
+            in_base += coord * in.strides()[d];
+          }
+          const int64_t* block_index = index_data + block * block_size;
+          CTYPE* block_out = out_data + block * block_size;
+          for (int64_t j = 0; j < block_size; j += inner_size) {
+            for (int64_t i = 0; i < inner_size; ++i) {
+              block_out[j + i] =
+                  in_data[in_base + block_index[j + i] * in_dim_stride + i];
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void gather_by_coordinates(
+    const Tensor& in,
+    const Tensor& index,
+    Tensor& out,
+    int64_t dim) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  const int64_t* index_data = index.const_data_ptr<int64_t>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+
+  if (index.dim() == 0) {
+    out_data[0] = in_data[index_data[0]];
+    return;
+  }
+
+  for (size_t ix = 0; ix < index.numel(); ++ix) {
+    size_t ix_coord[kTensorDimensionLimit];
+    indexToCoordinate(index, ix, ix_coord);
+
+    size_t in_coord[kTensorDimensionLimit];
+    for (size_t i = 0; i < out.dim(); ++i) {
+      if (i == dim) {
+        in_coord[i] = index_data[ix];
+      } else {
+        in_coord[i] = ix_coord[i];
+      }
+    }
+
+    size_t in_ix = coordinateToIndex(in, in_coord);
+    size_t out_ix = coordinateToIndex(out, ix_coord);
+
+    out_data[out_ix] = in_data[in_ix];
+  }
+}
+
+} // namespace
+
+/**
+ * Gathers the elements of `in` along `dim` at `index`. Dense tensors with the
+ * default dim order are walked by offsets instead of converting each element
+ * index to coordinates and back, with the dims before `dim` split across the
+ * threadpool. Other layouts use the algorithm of the portable kernel.
+ *
+ * gather.out(Tensor self, int dim, Tensor index, *, bool sparse_grad=False,
+ *     Tensor(a!) out) -> Tensor(a!)
+ */
+Tensor& opt_gather_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    bool sparse_grad,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_gather_args(in, dim, index, sparse_grad, out),
+      InvalidArgument,
+      out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, index.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (index.numel() == 0) {
+    return out;
+  }
+
+  constexpr auto name = "gather.out";
+
+  ET_SWITCH_REALHB_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
+    if (can_gather_by_offsets(in, index, out, dim)) {
+      gather_by_offsets<CTYPE>(in, index, out, dim);
+    } else {
+      gather_by_coordinates<CTYPE>(in, index, out, dim);
+    }
+  });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
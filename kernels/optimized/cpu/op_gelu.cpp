@@ -13,6 +13,7 @@
 
 #include <cmath>
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
 
@@ -46,6 +47,20 @@ void gelu(
   CTYPE* out_data = output.mutable_data_ptr<CTYPE>();
   size_t lim = input.numel();
 
+  if constexpr (has_vec_kernels_v<CTYPE>) {
+    const bool is_tanh = approximate == "tanh";
+    if (get_math_accuracy(MathKernel::kGelu) == MathAccuracy::kFast &&
+        (is_tanh || approximate == "none")) {
+      vec_unary_stub(
+          is_tanh ? VecUnaryOp::kFastGeluTanh : VecUnaryOp::kFastGelu,
+          CppTypeToScalarType<CTYPE>::value,
+          in_data,
+          out_data,
+          lim);
+      return;
+    }
+  }
+
   // TODO: Add fast path for tanh using sleef's tanh
   if (approximate == "tanh") {
     // 0.5 * x * (1 + Tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cmath>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+using ScalarType = exec_aten::ScalarType;
+using string_view = exec_aten::string_view;
+
+namespace {
+
+// The minimum number of elements that each parallel_for chunk computes.
+constexpr int64_t kGeluBackwardGrainSize = 32768;
+
+/**
+ * Computes the gradient of gelu(`input`) from `grad_output`, overwriting
+ * `grad_input`. Uses the same formulas as ATen's GeluBackwardKernelImpl.
+ *
+ * Assumes that the tensors are contiguous, are the same shape, and have the
+ * same dtype.
+ */
+template <typename CTYPE>
+void gelu_backward(
+    const Tensor& grad_output,
+    const Tensor& input,
+    bool approximate_tanh,
+    Tensor& grad_input) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  const CTYPE* grad_output_data = grad_output.const_data_ptr<CTYPE>();
+  const CTYPE* input_data = input.const_data_ptr<CTYPE>();
+  CTYPE* grad_input_data = grad_input.mutable_data_ptr<CTYPE>();
+
+  executorch::extension::parallel_for(
+      0,
+      input.numel(),
+      kGeluBackwardGrainSize,
+      [&](int64_t begin, int64_t end) {
+        if (approximate_tanh) {
+          // d/dx 0.5 * x * (1 + tanh(inner)), where
+          // inner = sqrt(2 / pi) * (x + 0.044715 * x^3)
+          const Vec kBeta(M_SQRT2 * M_2_SQRTPI * 0.5);
+          const Vec kKappa(0.044715);
+          const Vec kThreeKappa(3 * 0.044715);
+          const Vec kHalf(0.5);
+          const Vec kOne(1);
+          executorch::vec::map2<CTYPE>(
+              [=](Vec dy, Vec x) {
+                const Vec x_sq = x * x;
+                const Vec inner = kBeta * (x + kKappa * x_sq * x);
+                const Vec tanh_inner = inner.tanh();
+                const Vec inner_derivative =
+                    kBeta * (kOne + kThreeKappa * x_sq);
+                const Vec tanh_derivative = kOne - tanh_inner * tanh_inner;
+                return dy *
+                    (kHalf * (kOne + tanh_inner) +
+                     kHalf * x * tanh_derivative * inner_derivative);
+              },
+              grad_input_data + begin,
+              grad_output_data + begin,
+              input_data + begin,
+              end - begin);
+        } else {
+          // d/dx x * cdf(x) = cdf(x) + x * pdf(x)
+          const Vec kAlpha(M_SQRT1_2);
+          const Vec kBeta(M_2_SQRTPI * M_SQRT1_2 * 0.5);
+          const Vec kMinusHalf(-0.5);
+          const Vec kHalf(0.5);
+          const Vec kOne(1);
+          executorch::vec::map2<CTYPE>(
+              [=](Vec dy, Vec x) {
+                const Vec cdf = kHalf * (kOne + (x * kAlpha).erf());
+                const Vec pdf = kBeta * (kMinusHalf * x * x).exp();
+                return dy * (cdf + x * pdf);
+              },
+              grad_input_data + begin,
+              grad_output_data + begin,
+              input_data + begin,
+              end - begin);
+        }
+      });
+}
+
+} // namespace
+
+/**
+ * Computes the gradient of the element-wise Gelu of `self`, overwriting
+ * `grad_input`.
+ *
+ * Asserts that all tensors have the same dtype and shape.
+ *
+ * gelu_backward.grad_input(Tensor grad_output, Tensor self, *,
+ *     str approximate='none', Tensor(a!) grad_input) -> Tensor(a!)
+ */
+Tensor& opt_gelu_backward_out(
+    KernelRuntimeContext& context,
+    const Tensor& grad_output,
+    const Tensor& self,
+    string_view approximate,
+    Tensor& grad_input) {
+  ET_KERNEL_CHECK(
+      context,
+      tensors_have_same_shape_and_dtype(grad_output, self),
+      InvalidArgument,
+      grad_input);
+
+  ET_KERNEL_CHECK(
+      context,
+      tensors_have_same_dim_order(grad_output, self, grad_input),
+      InvalidArgument,
+      grad_input);
+
+  ET_KERNEL_CHECK(
+      context,
+      resize_tensor(grad_input, self.sizes()) == Error::Ok,
+      InvalidArgument,
+      grad_input);
+
+  ET_KERNEL_CHECK(
+      context,
+      tensors_have_same_dtype(self, grad_input),
+      InvalidArgument,
+      grad_input);
+
+  ET_KERNEL_CHECK_MSG(
+      context,
+      approximate == "tanh" || approximate == "none",
+      InvalidArgument,
+      grad_input,
+      "Invalid approximation format: %.*s for gelu_backward",
+      static_cast<int>(approximate.length()),
+      approximate.data());
+
+  ET_SWITCH_FLOAT_TYPES(
+      self.scalar_type(), context, "gelu_backward.grad_input", CTYPE, [&]() {
+        gelu_backward<CTYPE>(
+            grad_output, self, approximate == "tanh", grad_input);
+      });
+
+  return grad_input;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
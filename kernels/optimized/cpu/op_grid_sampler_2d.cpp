@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// The minimum number of output elements that each parallel_for chunk
+// computes.
+constexpr int64_t kGridSamplerGrainSize = 16384;
+
+// Must match at::native::GridSamplerInterpolation and
+// at::native::GridSamplerPadding.
+enum class GridSamplerInterpolation : int64_t {
+  Bilinear = 0,
+  Nearest = 1,
+  Bicubic = 2,
+};
+
+enum class GridSamplerPadding : int64_t {
+  Zeros = 0,
+  Border = 1,
+  Reflection = 2,
+};
+
+bool check_grid_sampler_2d_args(
+    const Tensor& in,
+    const Tensor& grid,
+    int64_t interpolation_mode,
+    int64_t padding_mode,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, grid, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(in, 4));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(grid, 4));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(out, 4));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dim_order(in, out));
+  ET_LOG_AND_RETURN_IF_FALSE(in.size(2) > 0 && in.size(3) > 0);
+  ET_LOG_AND_RETURN_IF_FALSE(grid.size(0) == in.size(0));
+  ET_LOG_AND_RETURN_IF_FALSE(grid.size(3) == 2);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      interpolation_mode ==
+              static_cast<int64_t>(GridSamplerInterpolation::Bilinear) ||
+          interpolation_mode ==
+              static_cast<int64_t>(GridSamplerInterpolation::Nearest),
+      "Unsupported interpolation mode %" PRId64,
+      interpolation_mode);
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      padding_mode >= static_cast<int64_t>(GridSamplerPadding::Zeros) &&
+          padding_mode <= static_cast<int64_t>(GridSamplerPadding::Reflection),
+      "Unsupported padding mode %" PRId64,
+      padding_mode);
+  return true;
+}
+
+// Maps a grid coordinate in [-1, 1] to an input pixel coordinate.
+template <typename T>
+T grid_sampler_unnormalize(T coord, int64_t size, bool align_corners) {
+  if (align_corners) {
+    return ((coord + 1) / 2) * (size - 1);
+  }
+  return ((coord + 1) * size - 1) / 2;
+}
+
+template <typename T>
+T clip_coordinates(T in, int64_t clip_limit) {
+  return std::min(
+      static_cast<T>(clip_limit - 1), std::max(in, static_cast<T>(0)));
+}
+
+// Reflects `in` into [twice_low / 2, twice_high / 2].
+template <typename T>
+T reflect_coordinates(T in, int64_t twice_low, int64_t twice_high) {
+  if (twice_low == twice_high) {
+    return static_cast<T>(0);
+  }
+  const T min = static_cast<T>(twice_low) / 2;
+  const T span = static_cast<T>(twice_high - twice_low) / 2;
+  in = std::fabs(in - min);
+  const T extra = std::fmod(in, span);
+  const int64_t flips = static_cast<int64_t>(std::floor(in / span));
+  return flips % 2 == 0 ? extra + min : span - extra + min;
+}
+
+// Keeps non-finite and huge coordinates from overflowing when they are
+// converted to indices. They end up out of bounds instead.
+template <typename T>
+T safe_downgrade_to_int_range(T x) {
+  if (!std::isfinite(x) || x > INT_MAX - 1 || x < INT_MIN) {
+    return static_cast<T>(-100);
+  }
+  return x;
+}
+
+template <typename T>
+T compute_source_index(
+    T coord,
+    int64_t size,
+    GridSamplerPadding padding_mode,
+    bool align_corners) {
+  coord = grid_sampler_unnormalize(coord, size, align_corners);
+  if (padding_mode == GridSamplerPadding::Border) {
+    coord = clip_coordinates(coord, size);
+  } else if (padding_mode == GridSamplerPadding::Reflection) {
+    coord = align_corners ? reflect_coordinates(coord, 0, 2 * (size - 1))
+                          : reflect_coordinates(coord, -1, 2 * size - 1);
+    coord = clip_coordinates(coord, size);
+  }
+  return safe_downgrade_to_int_range(coord);
+}
+
+inline bool within_bounds_2d(int64_t h, int64_t w, int64_t H, int64_t W) {
+  return h >= 0 && h < H && w >= 0 && w < W;
+}
+
+template <typename CTYPE>
+void grid_sampler_2d(
+    const Tensor& in,
+    const Tensor& grid,
+    GridSamplerInterpolation interpolation_mode,
+    GridSamplerPadding padding_mode,
+    bool align_corners,
+    Tensor& out) {
+  const int64_t channels = in.size(1);
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const int64_t out_h = out.size(2);
+  const int64_t out_w = out.size(3);
+
+  const auto in_strides = in.strides();
+  const auto grid_strides = grid.strides();
+  const auto out_strides = out.strides();
+
+  const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
+  const CTYPE* const grid_data = grid.const_data_ptr<CTYPE>();
+  CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
+
+  // Each output location computes its source pixels and weights once and
+  // then reuses them for every channel.
+  executorch::extension::parallel_for(
+      0,
+      out.size(0) * out_h,
+      std::max<int64_t>(1, kGridSamplerGrainSize / (out_w * channels)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t n = i / out_h;
+          const int64_t h = i % out_h;
+          const CTYPE* in_n = in_data + n * in_strides[0];
+          for (int64_t w = 0; w < out_w; ++w) {
+            const CTYPE* g = grid_data + n * grid_strides[0] +
+                h * grid_strides[1] + w * grid_strides[2];
+            const CTYPE ix = compute_source_index<CTYPE>(
+                g[0], in_w, padding_mode, align_corners);
+            const CTYPE iy = compute_source_index<CTYPE>(
+                g[grid_strides[3]], in_h, padding_mode, align_corners);
+            CTYPE* dst = out_data + n * out_strides[0] + h * out_strides[2] +
+                w * out_strides[3];
+
+            if (interpolation_mode == GridSamplerInterpolation::Nearest) {
+              const int64_t x = static_cast<int64_t>(std::nearbyint(ix));
+              const int64_t y = static_cast<int64_t>(std::nearbyint(iy));
+              if (!within_bounds_2d(y, x, in_h, in_w)) {
+                for (int64_t c = 0; c < channels; ++c) {
+                  dst[c * out_strides[1]] = 0;
+                }
+                continue;
+              }
+              const CTYPE* src = in_n + y * in_strides[2] + x * in_strides[3];
+              for (int64_t c = 0; c < channels; ++c) {
+                dst[c * out_strides[1]] = src[c * in_strides[1]];
+              }
+              continue;
+            }
+
+            const int64_t x0 = static_cast<int64_t>(std::floor(ix));
+            const int64_t y0 = static_cast<int64_t>(std::floor(iy));
+            const CTYPE dx = ix - x0;
+            const CTYPE dy = iy - y0;
+            // Corners outside of the input contribute zero, so only the
+            // valid ones are kept for the channel loop.
+            const int64_t corner_x[4] = {x0, x0 + 1, x0, x0 + 1};
+            const int64_t corner_y[4] = {y0, y0, y0 + 1, y0 + 1};
+            const CTYPE corner_weight[4] = {
+                (1 - dx) * (1 - dy), dx * (1 - dy), (1 - dx) * dy, dx * dy};
+            int64_t offsets[4];
+            CTYPE weights[4];
+            int num_corners = 0;
+            for (int k = 0; k < 4; ++k) {
+              if (within_bounds_2d(corner_y[k], corner_x[k], in_h, in_w)) {
+                offsets[num_corners] =
+                    corner_y[k] * in_strides[2] + corner_x[k] * in_strides[3];
+                weights[num_corners] = corner_weight[k];
+                ++num_corners;
+              }
+            }
+            for (int64_t c = 0; c < channels; ++c) {
+              const CTYPE* src = in_n + c * in_strides[1];
+              CTYPE sum = 0;
+              for (int k = 0; k < num_corners; ++k) {
+                sum += src[offsets[k]] * weights[k];
+              }
+              dst[c * out_strides[1]] = sum;
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_grid_sampler_2d_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& grid,
+    int64_t interpolation_mode,
+    int64_t padding_mode,
+    bool align_corners,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_grid_sampler_2d_args(
+          in, grid, interpolation_mode, padding_mode, out),
+      InvalidArgument,
+      out);
+
+  const Tensor::SizesType out_sizes[4] = {
+      static_cast<Tensor::SizesType>(in.size(0)),
+      static_cast<Tensor::SizesType>(in.size(1)),
+      static_cast<Tensor::SizesType>(grid.size(1)),
+      static_cast<Tensor::SizesType>(grid.size(2))};
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_tensor(out, {out_sizes, 4}) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  if (out.numel() == 0) {
+    return out;
+  }
+
+  ET_SWITCH_FLOAT_TYPES(
+      in.scalar_type(), ctx, "grid_sampler_2d.out", CTYPE, [&]() {
+        grid_sampler_2d<CTYPE>(
+            in,
+            grid,
+            static_cast<GridSamplerInterpolation>(interpolation_mode),
+            static_cast<GridSamplerPadding>(padding_mode),
+            align_corners,
+            out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstring>
+
+#include <executorch/kernels/optimized/cpu/gather_util.h>
+#include <executorch/kernels/portable/cpu/util/index_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+/**
+ * Selects the slices of `in` along `dim` at `index`. Each selected slice is a
+ * contiguous run of the dims after `dim`, so it is copied as one row. The
+ * rows of all of the leading dims are split across the threadpool together.
+ *
+ * index_select.out(Tensor self, int dim, Tensor index, *, Tensor(a!) out) ->
+ * Tensor(a!)
+ */
+Tensor& opt_index_select_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    int64_t dim,
+    const Tensor& index,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx, check_index_select_args(in, dim, index, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
+
+  ET_KERNEL_CHECK(ctx, tensor_is_default_dim_order(in), InvalidArgument, out);
+
+  if (dim < 0) {
+    dim += nonzero_dim(in);
+  }
+
+  size_t expected_ndim = 0;
+  Tensor::SizesType expected_size[kTensorDimensionLimit];
+  get_index_select_out_target_size(
+      in, dim, index, expected_size, &expected_ndim);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {expected_size, expected_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  if (in.dim() == 0) {
+    std::memcpy(out.mutable_data_ptr(), in.const_data_ptr(), in.nbytes());
+    return out;
+  }
+
+  const int64_t leading_dims = getLeadingDims(in, dim);
+  const int64_t trailing_dims = getTrailingDims(in, dim);
+  if (leading_dims == 0 || trailing_dims == 0) {
+    return out;
+  }
+
+  const int64_t out_dim_length = out.size(dim);
+  const int64_t in_dim_length = in.size(dim);
+
+  ET_SWITCH_TWO_TYPES(
+      Long, Int, index.scalar_type(), ctx, "index_select.out", CTYPE, [&]() {
+        const CTYPE* const index_arr = index.const_data_ptr<CTYPE>();
+        gather_rows(
+            out.mutable_data_ptr<char>(),
+            in.const_data_ptr<char>(),
+            trailing_dims * in.element_size(),
+            leading_dims * out_dim_length,
+            [index_arr, in_dim_length, out_dim_length](int64_t row) {
+              const int64_t leading = row / out_dim_length;
+              const int64_t j = row - leading * out_dim_length;
+              return leading * in_dim_length +
+                  static_cast<int64_t>(index_arr[j]);
+            });
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -6,9 +6,11 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <executorch/kernels/optimized/cpu/binary_ops.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
+#include <executorch/kernels/portable/cpu/util/broadcast_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 #include <executorch/runtime/platform/assert.h>
 
@@ -26,10 +28,8 @@ Tensor& opt_le_tensor_out(
     Tensor& out) {
   (void)ctx;
 
-  ET_KERNEL_CHECK(ctx, tensors_have_same_shape(a, b), InvalidArgument, out);
-
   // Resize for dynamic shape
-  auto error = resize_tensor(out, a.sizes());
+  auto error = resize_to_broadcast_target_size(a, b, out);
   ET_KERNEL_CHECK_MSG(
       ctx,
       error == Error::Ok,
@@ -41,7 +41,8 @@ Tensor& opt_le_tensor_out(
   ScalarType b_type = b.scalar_type();
   ScalarType out_type = out.scalar_type();
 
-  if (a_type == b_type && a_type == out_type) {
+  auto selected_optimized_path = select_optimized_path(a, b, out);
+  if (selected_optimized_path == ElementwiseOptimizedPath::kTreatAs1d) {
     ET_SWITCH_REAL_TYPES_AND(
         Bool, out_type, ctx, "le.Tensor_out", CTYPE, [&]() {
           using Vec = executorch::vec::Vectorized<CTYPE>;
@@ -52,6 +53,13 @@ Tensor& opt_le_tensor_out(
               b.const_data_ptr<CTYPE>(),
               a.numel());
         });
+  } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
+    ET_SWITCH_REAL_TYPES_AND(
+        Bool, out_type, ctx, "le.Tensor_out", CTYPE, [&]() {
+          using Vec = executorch::vec::Vectorized<CTYPE>;
+          broadcasting_map_nd<CTYPE>(
+              [](Vec x, Vec y) { return x.le(y); }, a, b, out);
+        });
   } else {
     ET_SWITCH_REAL_TYPES_AND(
         Bool, a_type, ctx, "le.Tensor_out", CTYPE_A, [&]() {
@@ -64,15 +72,15 @@ Tensor& opt_le_tensor_out(
                     promoteTypes(a_type, b_type));
                 ET_SWITCH_REAL_TYPES_AND(
                     Bool, out_type, ctx, "le.Tensor_out", CTYPE_OUT, [&]() {
-                      const size_t n = a.numel();
-                      const CTYPE_A* a_data = a.const_data_ptr<CTYPE_A>();
-                      const CTYPE_B* b_data = b.const_data_ptr<CTYPE_B>();
-                      CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
-                      for (auto i = 0; i < n; ++i) {
-                        out_data[i] = static_cast<CTYPE_OUT>(
-                            static_cast<CTYPE_IN>(a_data[i]) <=
-                            static_cast<CTYPE_IN>(b_data[i]));
-                      }
+                      apply_broadcasting_binary_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
+                          [](const CTYPE_A val_a, const CTYPE_B val_b) {
+                            return static_cast<CTYPE_OUT>(
+                                static_cast<CTYPE_IN>(val_a) <=
+                                static_cast<CTYPE_IN>(val_b));
+                          },
+                          a,
+                          b,
+                          out);
                     });
               });
         });
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/cpu/prepacked_gemm.h>
 #include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -56,18 +57,19 @@ Tensor& opt_linear_out(
         size_t k = in.sizes()[in.dim() - 1];
         size_t m = mat2.size(0);
 
-        executorch::cpublas::gemm(
+        // The weight is usually a constant, so it only has to be packed
+        // once.
+        internal::gemm_with_prepacked_a<CTYPE>(
+            ctx,
             executorch::cpublas::TransposeType::Transpose,
             executorch::cpublas::TransposeType::NoTranspose,
             m,
             n,
             k,
-            static_cast<CTYPE>(1),
-            mat2.const_data_ptr<CTYPE>(),
+            mat2,
             k,
             in.const_data_ptr<CTYPE>(),
             k,
-            static_cast<CTYPE>(0),
             out.mutable_data_ptr<CTYPE>(),
             m);
       });
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/kernels/optimized/cpu/prepacked_gemm.h>
 #include <executorch/kernels/portable/cpu/util/matmul_ops_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
@@ -46,19 +47,19 @@ Tensor& opt_mm_out(
         // gemm expects column-major inputs and produces column-major
         // output. So, we take advantage of the identity (A @ B).t()
         // = B.t() @ A.t() here; row-major B is B.t() from gemm's
-        // column-major perspective, etc.
-        executorch::cpublas::gemm(
+        // column-major perspective, etc. When mat2 is a constant, like a
+        // weight, it only has to be packed once.
+        internal::gemm_with_prepacked_a<CTYPE>(
+            ctx,
             executorch::cpublas::TransposeType::NoTranspose,
             executorch::cpublas::TransposeType::NoTranspose,
             m,
             n,
             k,
-            static_cast<CTYPE>(1),
-            mat2.const_data_ptr<CTYPE>(),
+            mat2,
             m,
             in.const_data_ptr<CTYPE>(),
             k,
-            static_cast<CTYPE>(0),
             out.mutable_data_ptr<CTYPE>(),
             m);
       });
@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/cpu/binary_ops.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -39,7 +40,7 @@ template <
     typename CTYPE_OUT>
 struct MulInner<true, CTYPE_A, CTYPE_B, CTYPE_IN, CTYPE_OUT> {
   static void run(const Tensor& a, const Tensor& b, Tensor& out) {
-    apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
+    apply_broadcasting_binary_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
         // NOLINTNEXTLINE(facebook-hte-ConstantArgumentPassByValue)
         [](const CTYPE_A val_a, const CTYPE_B val_b) {
           CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
@@ -120,6 +121,20 @@ Tensor& handle_broadcast_mul(
     return handle_last_dim_broadcast(ctx, a, b, out, selected_optimized_path);
   }
 
+  if (selected_optimized_path == ElementwiseOptimizedPath::kBroadcastNd) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_to_broadcast_target_size(a, b, out) == Error::Ok,
+        InvalidArgument,
+        out);
+    ET_SWITCH_REALB_TYPES(out.scalar_type(), ctx, "mul.out", CTYPE, [&]() {
+      using Vec = executorch::vec::Vectorized<CTYPE>;
+      broadcasting_map_nd<CTYPE>(
+          [](Vec x, Vec y) { return x * y; }, a, b, out);
+    });
+    return out;
+  }
+
   ScalarType out_type = out.scalar_type();
   const Tensor* lhs;
   const Tensor* rhs;
@@ -217,6 +232,37 @@ Tensor& opt_mul_out(
     return opt_mul_out(ctx, b, a, out);
   }
 
+  if (can_map_reduced_float_1d(a, b, out)) {
+    ET_KERNEL_CHECK_MSG(
+        ctx,
+        resize_tensor(out, a.sizes()) == Error::Ok,
+        InvalidArgument,
+        out,
+        "Failed to resize output tensor.");
+
+    ET_SWITCH_TWO_TYPES(Half, BFloat16, a_type, ctx, "mul.out", CTYPE, [&]() {
+#ifdef ET_VEC_NATIVE_FP16_ARITHMETIC
+      if (std::is_same_v<CTYPE, exec_aten::Half>) {
+        executorch::vec::map2_fp16(
+            [](float16x8_t x, float16x8_t y) { return vmulq_f16(x, y); },
+            out.mutable_data_ptr<exec_aten::Half>(),
+            a.const_data_ptr<exec_aten::Half>(),
+            b.const_data_ptr<exec_aten::Half>(),
+            out.numel());
+        return;
+      }
+#endif // ET_VEC_NATIVE_FP16_ARITHMETIC
+      using Vec = executorch::vec::Vectorized<float>;
+      executorch::vec::map2_reduced_float<CTYPE>(
+          [](Vec x, Vec y) { return x * y; },
+          out.mutable_data_ptr<CTYPE>(),
+          a.const_data_ptr<CTYPE>(),
+          b.const_data_ptr<CTYPE>(),
+          out.numel());
+    });
+    return out;
+  }
+
   auto selected_optimized_path = select_optimized_path(a, b, out);
   if (selected_optimized_path == ElementwiseOptimizedPath::kTreatAs1d) {
     // Resize for dynamic shape
@@ -229,13 +275,24 @@ Tensor& opt_mul_out(
         "Failed to resize output tensor.");
 
     ET_SWITCH_REALB_TYPES(out_type, ctx, "mul.out", CTYPE, [&]() {
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [](Vec x, Vec y) { return x * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
+      if constexpr (has_vec_kernels_v<CTYPE>) {
+        vec_binary_stub(
+            VecBinaryOp::kMul,
+            out_type,
+            a.const_data_ptr(),
+            b.const_data_ptr(),
+            /*alpha=*/1,
+            out.mutable_data_ptr(),
+            out.numel());
+      } else {
+        using Vec = executorch::vec::Vectorized<CTYPE>;
+        executorch::vec::map2<CTYPE>(
+            [](Vec x, Vec y) { return x * y; },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            out.numel());
+      }
     });
   } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
     return handle_broadcast_mul(ctx, a, b, out, selected_optimized_path);
@@ -256,7 +313,7 @@ Tensor& opt_mul_out(
             promote_types<CTYPE_A, CTYPE_B, /*half_to_float*/ true>::type;
         ET_DCHECK(CppTypeToScalarType<CTYPE_IN>::value == common_type);
         ET_SWITCH_REALHBBF16_TYPES(out_type, ctx, "mul.out", CTYPE_OUT, [&]() {
-          apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
+          apply_broadcasting_binary_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
               [](const CTYPE_A val_a, const CTYPE_B val_b) {
                 CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
                 CTYPE_IN b_casted = static_cast<CTYPE_IN>(val_b);
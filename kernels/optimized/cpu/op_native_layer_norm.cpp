@@ -7,9 +7,11 @@
  */
 
 #include <executorch/runtime/kernel/kernel_includes.h>
+#include <algorithm>
 #include <cmath>
 #include <tuple>
 
+#include <executorch/extension/parallel/thread_parallel.h>
 #include <executorch/kernels/optimized/cpu/moments_utils.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
@@ -23,6 +25,10 @@ using Tensor = exec_aten::Tensor;
 
 namespace {
 
+// The minimum number of input elements that each parallel_for chunk
+// normalizes.
+constexpr int64_t kLayerNormGrainSize = 32768;
+
 template <typename CTYPE>
 void layer_norm(
     const Tensor& input,
@@ -71,42 +77,66 @@ void layer_norm(
     beta_data = nullptr;
   }
 
-  const bool gamma_null = gamma_data == nullptr;
-  const bool beta_null = beta_data == nullptr;
-
-  for (size_t i = 0; i < M; ++i) {
-    const CTYPE* src_ptr = input_data + i * N;
-    CTYPE* dst_ptr = out_data + i * N;
-
-    CTYPE mean_val;
-    CTYPE rstd_val;
-    std::tie(mean_val, rstd_val) = RowwiseMoments(src_ptr, N);
-    rstd_val = CTYPE(1) / std::sqrt(rstd_val + eps);
-
-    const CTYPE scale = rstd_val;
-    const CTYPE offset = -rstd_val * mean_val;
-
-    if (gamma_null || beta_null) {
-      for (size_t j = 0; j < N; ++j) {
-        const CTYPE gamma_v = gamma_null ? CTYPE(1) : gamma_data[j];
-        const CTYPE beta_v = beta_null ? CTYPE(0) : beta_data[j];
-        dst_ptr[j] = (src_ptr[j] * scale + offset) * gamma_v + beta_v;
-      }
-    } else {
-      executorch::vec::map3<CTYPE>(
-          [scale, offset](Vec x, Vec gamma, Vec beta) {
-            return (x * Vec(scale) + Vec(offset)) * gamma + beta;
-          },
-          dst_ptr,
-          src_ptr,
-          gamma_data,
-          beta_data,
-          N);
-    }
-
-    mean_data[i] = mean_val;
-    rstd_data[i] = rstd_val;
-  }
+  // Each row is normalized independently, so split the rows across threads.
+  // Rows are small in most models, so give each thread enough of them to
+  // amortize the cost of scheduling it.
+  const int64_t grain_size =
+      std::max<int64_t>(1, kLayerNormGrainSize / static_cast<int64_t>(N));
+  executorch::extension::parallel_for(
+      0, M, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const CTYPE* src_ptr = input_data + i * N;
+          CTYPE* dst_ptr = out_data + i * N;
+
+          // A single vectorized Welford pass computes both moments.
+          CTYPE mean_val;
+          CTYPE rstd_val;
+          std::tie(mean_val, rstd_val) = RowwiseMoments(src_ptr, N);
+          rstd_val = CTYPE(1) / std::sqrt(rstd_val + eps);
+
+          const CTYPE scale = rstd_val;
+          const CTYPE offset = -rstd_val * mean_val;
+
+          if (gamma_data != nullptr && beta_data != nullptr) {
+            executorch::vec::map3<CTYPE>(
+                [scale, offset](Vec x, Vec gamma, Vec beta) {
+                  return (x * Vec(scale) + Vec(offset)) * gamma + beta;
+                },
+                dst_ptr,
+                src_ptr,
+                gamma_data,
+                beta_data,
+                N);
+          } else if (gamma_data != nullptr) {
+            executorch::vec::map2<CTYPE>(
+                [scale, offset](Vec x, Vec gamma) {
+                  return (x * Vec(scale) + Vec(offset)) * gamma;
+                },
+                dst_ptr,
+                src_ptr,
+                gamma_data,
+                N);
+          } else if (beta_data != nullptr) {
+            executorch::vec::map2<CTYPE>(
+                [scale, offset](Vec x, Vec beta) {
+                  return x * Vec(scale) + Vec(offset) + beta;
+                },
+                dst_ptr,
+                src_ptr,
+                beta_data,
+                N);
+          } else {
+            executorch::vec::map<CTYPE>(
+                [scale, offset](Vec x) { return x * Vec(scale) + Vec(offset); },
+                dst_ptr,
+                src_ptr,
+                N);
+          }
+
+          mean_data[i] = mean_val;
+          rstd_data[i] = rstd_val;
+        }
+      });
 }
 
 } // namespace
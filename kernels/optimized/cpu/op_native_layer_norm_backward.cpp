@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+#include <algorithm>
+#include <tuple>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// The minimum number of input elements that each parallel_for chunk
+// processes.
+constexpr int64_t kLayerNormBackwardGrainSize = 32768;
+
+bool check_layer_norm_backward_args(
+    const Tensor& grad_out,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const exec_aten::optional<Tensor>& weight,
+    exec_aten::ArrayRef<bool> output_mask,
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    Tensor& grad_bias) {
+  const size_t ndim = normalized_shape.size();
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      ndim >= 1 && ndim <= static_cast<size_t>(input.dim()),
+      "Expected normalized_shape to have between 1 and input.dim() dims");
+  ET_LOG_AND_RETURN_IF_FALSE(output_mask.size() == 3);
+  for (size_t d = 0; d < ndim; ++d) {
+    ET_LOG_AND_RETURN_IF_FALSE(
+        input.size(input.dim() - ndim + d) == normalized_shape[d]);
+  }
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_shape_and_dtype(grad_out, input));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, mean, rstd));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(grad_out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(input));
+  const int64_t M = getLeadingDims(input, input.dim() - ndim);
+  ET_LOG_AND_RETURN_IF_FALSE(mean.numel() == M && rstd.numel() == M);
+  if (weight.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, weight.value()));
+    ET_LOG_AND_RETURN_IF_FALSE(
+        static_cast<size_t>(weight.value().numel()) ==
+            getTrailingDims(input, input.dim() - ndim - 1));
+  }
+  if (output_mask[0]) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, grad_input));
+    ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(grad_input));
+  }
+  if (output_mask[1]) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, grad_weight));
+  }
+  if (output_mask[2]) {
+    ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(input, grad_bias));
+  }
+  return true;
+}
+
+template <typename CTYPE>
+void layer_norm_backward(
+    const Tensor& grad_out,
+    const Tensor& input,
+    size_t normalized_ndim,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const exec_aten::optional<Tensor>& weight,
+    exec_aten::ArrayRef<bool> output_mask,
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    Tensor& grad_bias) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  const int64_t axis = input.dim() - normalized_ndim;
+  const int64_t M = getLeadingDims(input, axis);
+  const int64_t N = getTrailingDims(input, axis - 1);
+
+  const CTYPE* dy_data = grad_out.const_data_ptr<CTYPE>();
+  const CTYPE* x_data = input.const_data_ptr<CTYPE>();
+  const CTYPE* mean_data = mean.const_data_ptr<CTYPE>();
+  const CTYPE* rstd_data = rstd.const_data_ptr<CTYPE>();
+  const CTYPE* gamma_data =
+      weight.has_value() ? weight.value().const_data_ptr<CTYPE>() : nullptr;
+
+  if (output_mask[0] && N > 0) {
+    CTYPE* dx_data = grad_input.mutable_data_ptr<CTYPE>();
+    const CTYPE scale = CTYPE(1) / static_cast<CTYPE>(N);
+    // Each row depends only on its own elements, so split the rows across
+    // threads.
+    const int64_t grain_size =
+        std::max<int64_t>(1, kLayerNormBackwardGrainSize / N);
+    executorch::extension::parallel_for(
+        0, M, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; ++i) {
+            const CTYPE* dy_row = dy_data + i * N;
+            const CTYPE* x_row = x_data + i * N;
+            CTYPE* dx_row = dx_data + i * N;
+            const CTYPE a = rstd_data[i];
+            // ds = sum(dy * gamma * x) and db = sum(dy * gamma).
+            CTYPE ds;
+            CTYPE db;
+            if (gamma_data != nullptr) {
+              ds = executorch::vec::map3_reduce_all<CTYPE>(
+                  [](Vec dy, Vec gamma, Vec x) { return dy * gamma * x; },
+                  [](Vec lhs, Vec rhs) { return lhs + rhs; },
+                  dy_row,
+                  gamma_data,
+                  x_row,
+                  N);
+              db = executorch::vec::map2_reduce_all<CTYPE>(
+                  [](Vec dy, Vec gamma) { return dy * gamma; },
+                  [](Vec lhs, Vec rhs) { return lhs + rhs; },
+                  dy_row,
+                  gamma_data,
+                  N);
+            } else {
+              ds = executorch::vec::map2_reduce_all<CTYPE>(
+                  [](Vec dy, Vec x) { return dy * x; },
+                  [](Vec lhs, Vec rhs) { return lhs + rhs; },
+                  dy_row,
+                  x_row,
+                  N);
+              db = executorch::vec::reduce_all<CTYPE>(
+                  [](Vec lhs, Vec rhs) { return lhs + rhs; }, dy_row, N);
+            }
+            const CTYPE b = (db * mean_data[i] - ds) * a * a * a * scale;
+            const CTYPE c = -b * mean_data[i] - db * a * scale;
+            // dx = a * dy * gamma + b * x + c
+            if (gamma_data != nullptr) {
+              executorch::vec::map3<CTYPE>(
+                  [a, b, c](Vec dy, Vec gamma, Vec x) {
+                    return Vec(a) * dy * gamma + Vec(b) * x + Vec(c);
+                  },
+                  dx_row,
+                  dy_row,
+                  gamma_data,
+                  x_row,
+                  N);
+            } else {
+              executorch::vec::map2<CTYPE>(
+                  [a, b, c](Vec dy, Vec x) {
+                    return Vec(a) * dy + Vec(b) * x + Vec(c);
+                  },
+                  dx_row,
+                  dy_row,
+                  x_row,
+                  N);
+            }
+          }
+        });
+  }
+
+  const bool compute_grad_weight = output_mask[1] && gamma_data != nullptr;
+  const bool compute_grad_bias = output_mask[2];
+  if (!compute_grad_weight && !compute_grad_bias) {
+    return;
+  }
+  CTYPE* dgamma_data =
+      compute_grad_weight ? grad_weight.mutable_data_ptr<CTYPE>() : nullptr;
+  CTYPE* dbeta_data =
+      compute_grad_bias ? grad_bias.mutable_data_ptr<CTYPE>() : nullptr;
+  // The weight and bias gradients reduce over the rows, so split the columns
+  // across threads instead, which needs no per-thread partial sums. Every
+  // thread still walks the rows in order, so each one reads contiguous
+  // slices of them.
+  const int64_t grain_size = std::max<int64_t>(
+      Vec::size(), kLayerNormBackwardGrainSize / std::max<int64_t>(1, M));
+  executorch::extension::parallel_for(
+      0, N, grain_size, [&](int64_t begin, int64_t end) {
+        const int64_t n = end - begin;
+        if (dgamma_data != nullptr) {
+          std::fill(dgamma_data + begin, dgamma_data + end, CTYPE(0));
+        }
+        if (dbeta_data != nullptr) {
+          std::fill(dbeta_data + begin, dbeta_data + end, CTYPE(0));
+        }
+        for (int64_t i = 0; i < M; ++i) {
+          const CTYPE* dy_row = dy_data + i * N + begin;
+          const CTYPE* x_row = x_data + i * N + begin;
+          if (dgamma_data != nullptr) {
+            // dgamma += dy * (x - mean) * rstd
+            const CTYPE a = rstd_data[i];
+            const CTYPE offset = -mean_data[i] * a;
+            executorch::vec::map3<CTYPE>(
+                [a, offset](Vec acc, Vec dy, Vec x) {
+                  return acc + dy * (x * Vec(a) + Vec(offset));
+                },
+                dgamma_data + begin,
+                dgamma_data + begin,
+                dy_row,
+                x_row,
+                n);
+          }
+          if (dbeta_data != nullptr) {
+            executorch::vec::map2<CTYPE>(
+                [](Vec acc, Vec dy) { return acc + dy; },
+                dbeta_data + begin,
+                dbeta_data + begin,
+                dy_row,
+                n);
+          }
+        }
+      });
+}
+
+} // namespace
+
+/**
+ * Computes the gradients of native_layer_norm with respect to its input,
+ * weight and bias, for the outputs selected by `output_mask`. The outputs that
+ * are not selected are left untouched.
+ *
+ * native_layer_norm_backward.out(Tensor grad_out, Tensor input,
+ *     SymInt[] normalized_shape, Tensor mean, Tensor rstd, Tensor? weight,
+ *     Tensor? bias, bool[3] output_mask, *, Tensor(a!) out0, Tensor(b!) out1,
+ *     Tensor(c!) out2) -> (Tensor(a!), Tensor(b!), Tensor(c!))
+ */
+std::tuple<Tensor&, Tensor&, Tensor&> opt_native_layer_norm_backward_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& grad_out,
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const exec_aten::optional<Tensor>& weight,
+    const exec_aten::optional<Tensor>& bias,
+    exec_aten::ArrayRef<bool> output_mask,
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    Tensor& grad_bias) {
+  (void)bias;
+
+  std::tuple<Tensor&, Tensor&, Tensor&> ret_val(
+      grad_input, grad_weight, grad_bias);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      check_layer_norm_backward_args(
+          grad_out,
+          input,
+          normalized_shape,
+          mean,
+          rstd,
+          weight,
+          output_mask,
+          grad_input,
+          grad_weight,
+          grad_bias),
+      InvalidArgument,
+      ret_val);
+
+  if (output_mask[0]) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_tensor(grad_input, input.sizes()) == Error::Ok,
+        InvalidArgument,
+        ret_val);
+  }
+  const exec_aten::ArrayRef<exec_aten::SizesType> normalized_sizes(
+      input.sizes().data() + input.dim() - normalized_shape.size(),
+      normalized_shape.size());
+  if (output_mask[1] && weight.has_value()) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_tensor(grad_weight, normalized_sizes) == Error::Ok,
+        InvalidArgument,
+        ret_val);
+  }
+  if (output_mask[2]) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_tensor(grad_bias, normalized_sizes) == Error::Ok,
+        InvalidArgument,
+        ret_val);
+  }
+
+  ET_SWITCH_FLOAT_TYPES(
+      input.scalar_type(), ctx, "native_layer_norm_backward.out", CTYPE, [&]() {
+        layer_norm_backward<CTYPE>(
+            grad_out,
+            input,
+            normalized_shape.size(),
+            mean,
+            rstd,
+            weight,
+            output_mask,
+            grad_input,
+            grad_weight,
+            grad_bias);
+      });
+
+  return ret_val;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -8,6 +8,7 @@
 
 #include <cmath>
 
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
@@ -33,15 +34,26 @@ void sigmoid_data(
     const CTYPE_IN* in_data,
     const size_t numel,
     CTYPE_OUT* out_data) {
-  using Vec = executorch::vec::Vectorized<CTYPE_IN>;
-  executorch::vec::map<CTYPE_IN>(
-      [](Vec x) {
-        auto one_plus_exp = x.neg().exp() + Vec(static_cast<CTYPE_IN>(1.0));
-        return one_plus_exp.reciprocal();
-      },
-      out_data,
-      in_data,
-      numel);
+  if constexpr (has_vec_kernels_v<CTYPE_IN>) {
+    vec_unary_stub(
+        get_math_accuracy(MathKernel::kSigmoid) == MathAccuracy::kFast
+            ? VecUnaryOp::kFastSigmoid
+            : VecUnaryOp::kSigmoid,
+        CppTypeToScalarType<CTYPE_IN>::value,
+        in_data,
+        out_data,
+        numel);
+  } else {
+    using Vec = executorch::vec::Vectorized<CTYPE_IN>;
+    executorch::vec::map<CTYPE_IN>(
+        [](Vec x) {
+          auto one_plus_exp = x.neg().exp() + Vec(static_cast<CTYPE_IN>(1.0));
+          return one_plus_exp.reciprocal();
+        },
+        out_data,
+        in_data,
+        numel);
+  }
 }
 
 template <
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// The minimum number of elements that each parallel_for chunk computes.
+constexpr int64_t kSoftmaxGrainSize = 32768;
+
+/**
+ * Computes softmax over `size` contiguous elements. The vectorized version
+ * fuses subtracting the max, exponentiating and summing into one pass that
+ * writes the exponentials to `out`, and then scales them in place.
+ */
+template <typename CTYPE>
+void softmax_contiguous(const CTYPE* in, CTYPE* out, int64_t size) {
+  if constexpr (std::is_floating_point<CTYPE>::value) {
+    using Vec = executorch::vec::Vectorized<CTYPE>;
+    const CTYPE max_in = executorch::vec::reduce_all<CTYPE>(
+        [](Vec a, Vec b) { return executorch::vec::maximum(a, b); }, in, size);
+    const Vec max_vec(max_in);
+    Vec sum_vec(0);
+    int64_t d = 0;
+    for (; d + Vec::size() <= size; d += Vec::size()) {
+      const Vec e = (Vec::loadu(in + d) - max_vec).exp();
+      e.store(out + d);
+      sum_vec = sum_vec + e;
+    }
+    CTYPE sum = executorch::vec::vec_reduce_all<CTYPE>(
+        [](Vec a, Vec b) { return a + b; }, sum_vec);
+    for (; d < size; ++d) {
+      out[d] = std::exp(in[d] - max_in);
+      sum += out[d];
+    }
+    const Vec scale(CTYPE(1) / sum);
+    executorch::vec::map<CTYPE>(
+        [scale](Vec x) { return x * scale; }, out, out, size);
+  } else {
+    // Reduced-precision types compute like the portable kernel.
+    CTYPE max_in = in[0];
+    for (int64_t d = 1; d < size; ++d) {
+      max_in = std::max(in[d], max_in);
+    }
+    CTYPE sum = 0;
+    for (int64_t d = 0; d < size; ++d) {
+      out[d] = std::exp(in[d] - max_in);
+      sum = sum + out[d];
+    }
+    for (int64_t d = 0; d < size; ++d) {
+      out[d] = out[d] / sum;
+    }
+  }
+}
+
+/**
+ * Computes softmax over a dim whose elements are `inner_size` > 1 apart, by
+ * processing blocks of adjacent rows together so that every inner loop reads
+ * and writes contiguous memory.
+ */
+template <typename CTYPE>
+void softmax_strided(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t inner_size) {
+  constexpr int64_t kBlockSize = 64;
+  const int64_t num_blocks = (inner_size + kBlockSize - 1) / kBlockSize;
+  const int64_t grain_size = std::max<int64_t>(
+      1, kSoftmaxGrainSize / std::max<int64_t>(1, dim_size * kBlockSize));
+  executorch::extension::parallel_for(
+      0, outer_size * num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+        CTYPE max_in[kBlockSize];
+        CTYPE sum[kBlockSize];
+        for (int64_t unit = begin; unit < end; ++unit) {
+          const int64_t outer = unit / num_blocks;
+          const int64_t inner_begin = (unit % num_blocks) * kBlockSize;
+          const int64_t block = std::min(kBlockSize, inner_size - inner_begin);
+          const int64_t offset = outer * dim_size * inner_size + inner_begin;
+          const CTYPE* in_block = in_data + offset;
+          CTYPE* out_block = out_data + offset;
+
+          for (int64_t j = 0; j < block; ++j) {
+            max_in[j] = in_block[j];
+            sum[j] = 0;
+          }
+          for (int64_t d = 1; d < dim_size; ++d) {
+            for (int64_t j = 0; j < block; ++j) {
+              max_in[j] = std::max(in_block[d * inner_size + j], max_in[j]);
+            }
+          }
+          for (int64_t d = 0; d < dim_size; ++d) {
+            for (int64_t j = 0; j < block; ++j) {
+              const int64_t index = d * inner_size + j;
+              out_block[index] = std::exp(in_block[index] - max_in[j]);
+              sum[j] = sum[j] + out_block[index];
+            }
+          }
+          for (int64_t d = 0; d < dim_size; ++d) {
+            for (int64_t j = 0; j < block; ++j) {
+              const int64_t index = d * inner_size + j;
+              out_block[index] = out_block[index] / sum[j];
+            }
+          }
+        }
+      });
+}
+
+template <typename CTYPE>
+void softmax(const Tensor& in, int64_t dim, Tensor& out) {
+  const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+  CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+  if (in.numel() == 0) {
+    return;
+  }
+  if (in.dim() == 0) {
+    out_data[0] = 1;
+    return;
+  }
+
+  // `in` and `out` are dense with the same dim order, so whatever the order,
+  // the rows are `dim_size` elements that are `inner_size` apart.
+  const int64_t dim_size = in.size(dim);
+  const int64_t inner_size = in.strides()[dim];
+  const int64_t outer_size = in.numel() / (dim_size * inner_size);
+  if (inner_size > 1) {
+    softmax_strided(in_data, out_data, outer_size, dim_size, inner_size);
+    return;
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      1, kSoftmaxGrainSize / std::max<int64_t>(1, dim_size));
+  executorch::extension::parallel_for(
+      0, outer_size, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          softmax_contiguous(
+              in_data + row * dim_size, out_data + row * dim_size, dim_size);
+        }
+      });
+}
+
+} // namespace
+
+/**
+ * Applies softmax along `dim`.
+ *
+ * _softmax.out(Tensor self, int dim, bool half_to_float, *, Tensor(a!) out)
+ *     -> Tensor(a!)
+ */
+Tensor& opt_softmax_out(
+    KernelRuntimeContext& context,
+    const Tensor& self,
+    int64_t dim,
+    bool half_to_float,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      context,
+      check_softmax_args(self, dim, half_to_float, out),
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      context,
+      resize_tensor(out, self.sizes()) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  ET_KERNEL_CHECK(
+      context, tensors_have_same_dim_order(self, out), InvalidArgument, out);
+
+  dim = dim < 0 ? dim + nonzero_dim(self) : dim;
+
+  ET_SWITCH_FLOATH_TYPES(
+      self.scalar_type(), context, "_softmax.out", CTYPE, [&]() {
+        softmax<CTYPE>(self, dim, out);
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/cpu/softmax_backward_util.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+/**
+ * grad_input = output * (grad_output - sum(grad_output * output, dim)), the
+ * gradient of softmax along `dim` given its `output`.
+ */
+template <typename CTYPE>
+void softmax_backward_data(
+    const Tensor& grad_output,
+    const Tensor& output,
+    int64_t dim,
+    Tensor& grad_input) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  const CTYPE* grad_output_data = grad_output.const_data_ptr<CTYPE>();
+  const CTYPE* output_data = output.const_data_ptr<CTYPE>();
+  CTYPE* grad_input_data = grad_input.mutable_data_ptr<CTYPE>();
+
+  const SoftmaxBackwardDims dims(output, dim);
+  if (dims.inner_size == 1) {
+    // The reduced dim is contiguous, so vectorize along it.
+    parallel_for_softmax_rows(dims, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        const int64_t offset = row * dims.dim_size;
+        const CTYPE dot = executorch::vec::map2_reduce_all<CTYPE>(
+            [](Vec dy, Vec y) { return dy * y; },
+            [](Vec a, Vec b) { return a + b; },
+            grad_output_data + offset,
+            output_data + offset,
+            dims.dim_size);
+        executorch::vec::map2<CTYPE>(
+            [dot](Vec dy, Vec y) { return y * (dy - Vec(dot)); },
+            grad_input_data + offset,
+            grad_output_data + offset,
+            output_data + offset,
+            dims.dim_size);
+      }
+    });
+    return;
+  }
+
+  parallel_for_softmax_rows(dims, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      const int64_t offset = dims.row_offset(row);
+      const CTYPE* dy = grad_output_data + offset;
+      const CTYPE* y = output_data + offset;
+      CTYPE* dx = grad_input_data + offset;
+      CTYPE dot = 0;
+      for (int64_t d = 0; d < dims.dim_size; ++d) {
+        dot += dy[d * dims.inner_size] * y[d * dims.inner_size];
+      }
+      for (int64_t d = 0; d < dims.dim_size; ++d) {
+        const int64_t index = d * dims.inner_size;
+        dx[index] = y[index] * (dy[index] - dot);
+      }
+    }
+  });
+}
+
+} // namespace
+
+/**
+ * Computes the gradient of softmax along `dim`, given the gradient of and the
+ * value of its output.
+ *
+ * _softmax_backward_data.out(Tensor grad_output, Tensor output, int dim,
+ *     ScalarType input_dtype, *, Tensor(a!) grad_input) -> Tensor(a!)
+ */
+Tensor& opt_softmax_backward_data_out(
+    KernelRuntimeContext& context,
+    const Tensor& grad_output,
+    const Tensor& output,
+    int64_t dim,
+    ScalarType input_dtype,
+    Tensor& grad_input) {
+  ET_KERNEL_CHECK(
+      context,
+      check_softmax_backward_data_args(
+          grad_output, output, dim, input_dtype, grad_input),
+      InvalidArgument,
+      grad_input);
+
+  ET_KERNEL_CHECK(
+      context,
+      resize_tensor(grad_input, output.sizes()) == Error::Ok,
+      InvalidArgument,
+      grad_input);
+
+  dim = dim < 0 ? dim + nonzero_dim(output) : dim;
+
+  ET_SWITCH_FLOAT_TYPES(
+      output.scalar_type(),
+      context,
+      "_softmax_backward_data.out",
+      CTYPE,
+      [&]() {
+        softmax_backward_data<CTYPE>(grad_output, output, dim, grad_input);
+      });
+
+  return grad_input;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
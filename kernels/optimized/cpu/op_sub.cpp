@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/optimized/cpu/binary_ops.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 #include <executorch/kernels/portable/cpu/scalar_utils.h>
@@ -36,7 +37,7 @@ template <
 struct SubInner<true, CTYPE_A, CTYPE_B, CTYPE_IN, CTYPE_OUT> {
   static void
   run(const Tensor& a, const Tensor& b, CTYPE_IN alpha_val, Tensor& out) {
-    apply_binary_elementwise_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
+    apply_broadcasting_binary_fn<CTYPE_A, CTYPE_B, CTYPE_OUT>(
         // NOLINTNEXTLINE(facebook-hte-ConstantArgumentPassByValue)
         [alpha_val](const CTYPE_A val_a, const CTYPE_B val_b) {
           CTYPE_IN a_casted = static_cast<CTYPE_IN>(val_a);
@@ -154,15 +155,29 @@ Tensor& opt_sub_out(
       ET_KERNEL_CHECK(
           ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
 
-      using Vec = executorch::vec::Vectorized<CTYPE>;
-      executorch::vec::map2<CTYPE>(
-          [alpha_val](Vec x, Vec y) { return x - Vec(alpha_val) * y; },
-          out.mutable_data_ptr<CTYPE>(),
-          a.const_data_ptr<CTYPE>(),
-          b.const_data_ptr<CTYPE>(),
-          out.numel());
+      if constexpr (has_vec_kernels_v<CTYPE>) {
+        vec_binary_stub(
+            VecBinaryOp::kSub,
+            a_type,
+            a.const_data_ptr(),
+            b.const_data_ptr(),
+            alpha_val,
+            out.mutable_data_ptr(),
+            out.numel());
+      } else {
+        using Vec = executorch::vec::Vectorized<CTYPE>;
+        executorch::vec::map2<CTYPE>(
+            [alpha_val](Vec x, Vec y) { return x - Vec(alpha_val) * y; },
+            out.mutable_data_ptr<CTYPE>(),
+            a.const_data_ptr<CTYPE>(),
+            b.const_data_ptr<CTYPE>(),
+            out.numel());
+      }
     });
-  } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
+  } else if (
+      selected_optimized_path == ElementwiseOptimizedPath::kBroadcast2dBy1d ||
+      selected_optimized_path ==
+          ElementwiseOptimizedPath::kBroadcast2dBy1dReverseArguments) {
     const Tensor* lhs;
     const Tensor* rhs;
     if (selected_optimized_path ==
@@ -170,10 +185,6 @@ Tensor& opt_sub_out(
       lhs = &b;
       rhs = &a;
     } else {
-      // Catch failure to update logic when subing new broadcasting possibility.
-      ET_DCHECK(
-          selected_optimized_path ==
-          ElementwiseOptimizedPath::kBroadcast2dBy1d);
       lhs = &a;
       rhs = &b;
     }
@@ -209,6 +220,24 @@ Tensor& opt_sub_out(
             lhs->sizes()[lhs->dim() - 1]);
       }
     });
+  } else if (selected_optimized_path != ElementwiseOptimizedPath::kNone) {
+    ET_KERNEL_CHECK(
+        ctx,
+        resize_to_broadcast_target_size(a, b, out) == Error::Ok,
+        InvalidArgument,
+        out);
+    ET_SWITCH_REAL_TYPES(out_type, ctx, "sub.out", CTYPE, [&]() {
+      CTYPE alpha_val;
+      ET_KERNEL_CHECK(
+          ctx, utils::extract_scalar(alpha, &alpha_val), InvalidArgument, );
+
+      using Vec = executorch::vec::Vectorized<CTYPE>;
+      broadcasting_map_nd<CTYPE>(
+          [alpha_val](Vec x, Vec y) { return x - Vec(alpha_val) * y; },
+          a,
+          b,
+          out);
+    });
   } else {
     ScalarType common_type =
         promoteTypes(a_type, b_type, /*half_to_float*/ true);
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// The minimum number of output elements that each parallel_for chunk
+// computes.
+constexpr int64_t kUpsampleGrainSize = 32768;
+
+// The two input elements that an output element interpolates between along
+// one dim, and their weights.
+template <typename T>
+struct LinearIndex {
+  int64_t index0;
+  int64_t index1;
+  T lambda0;
+  T lambda1;
+};
+
+/**
+ * Computes the input indices and weights of every output element along a
+ * dim, so that the inner loops only do loads and multiply-adds.
+ */
+template <typename T>
+std::vector<LinearIndex<T>> compute_linear_indices(
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners,
+    double scale) {
+  std::vector<LinearIndex<T>> indices(output_size);
+  const T ratio = area_pixel_compute_scale<T>(
+      input_size, output_size, align_corners, scale);
+  for (int64_t i = 0; i < output_size; ++i) {
+    LinearIndex<T>& index = indices[i];
+    if (input_size == output_size) {
+      index = {i, i, static_cast<T>(1), static_cast<T>(0)};
+      continue;
+    }
+    const T real_index =
+        area_pixel_compute_source_index<T>(ratio, i, align_corners);
+    index.index0 = std::min(
+        static_cast<int64_t>(std::floor(real_index)), input_size - 1);
+    index.index1 = index.index0 + (index.index0 < input_size - 1 ? 1 : 0);
+    index.lambda1 = std::min(
+        std::max(real_index - index.index0, static_cast<T>(0)),
+        static_cast<T>(1));
+    index.lambda0 = static_cast<T>(1) - index.lambda1;
+  }
+  return indices;
+}
+
+template <typename CTYPE>
+void upsample_bilinear2d_nchw(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t planes,
+    int64_t in_h,
+    int64_t in_w,
+    const std::vector<LinearIndex<CTYPE>>& h_indices,
+    const std::vector<LinearIndex<CTYPE>>& w_indices) {
+  const int64_t out_h = h_indices.size();
+  const int64_t out_w = w_indices.size();
+  executorch::extension::parallel_for(
+      0,
+      planes * out_h,
+      std::max<int64_t>(1, kUpsampleGrainSize / out_w),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t plane = i / out_h;
+          const LinearIndex<CTYPE>& h = h_indices[i % out_h];
+          const CTYPE* row0 = in_data + (plane * in_h + h.index0) * in_w;
+          const CTYPE* row1 = in_data + (plane * in_h + h.index1) * in_w;
+          CTYPE* dst = out_data + i * out_w;
+          for (int64_t j = 0; j < out_w; ++j) {
+            const LinearIndex<CTYPE>& w = w_indices[j];
+            dst[j] = h.lambda0 *
+                    (w.lambda0 * row0[w.index0] + w.lambda1 * row0[w.index1]) +
+                h.lambda1 *
+                    (w.lambda0 * row1[w.index0] + w.lambda1 * row1[w.index1]);
+          }
+        }
+      });
+}
+
+/**
+ * In channels last layout the channels of each pixel are contiguous, so
+ * every output pixel is a weighted sum of four contiguous input vectors.
+ */
+template <typename CTYPE>
+void upsample_bilinear2d_nhwc(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t batches,
+    int64_t channels,
+    int64_t in_h,
+    int64_t in_w,
+    const std::vector<LinearIndex<CTYPE>>& h_indices,
+    const std::vector<LinearIndex<CTYPE>>& w_indices) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+
+  const int64_t out_h = h_indices.size();
+  const int64_t out_w = w_indices.size();
+  executorch::extension::parallel_for(
+      0,
+      batches * out_h,
+      std::max<int64_t>(1, kUpsampleGrainSize / (out_w * channels)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t n = i / out_h;
+          const LinearIndex<CTYPE>& h = h_indices[i % out_h];
+          const CTYPE* row0 =
+              in_data + (n * in_h + h.index0) * in_w * channels;
+          const CTYPE* row1 =
+              in_data + (n * in_h + h.index1) * in_w * channels;
+          for (int64_t j = 0; j < out_w; ++j) {
+            const LinearIndex<CTYPE>& w = w_indices[j];
+            const CTYPE* p00 = row0 + w.index0 * channels;
+            const CTYPE* p01 = row0 + w.index1 * channels;
+            const CTYPE* p10 = row1 + w.index0 * channels;
+            const CTYPE* p11 = row1 + w.index1 * channels;
+            CTYPE* dst = out_data + (i * out_w + j) * channels;
+
+            const Vec h0(h.lambda0);
+            const Vec h1(h.lambda1);
+            const Vec w0(w.lambda0);
+            const Vec w1(w.lambda1);
+            int64_t c = 0;
+            for (; c + Vec::size() <= channels; c += Vec::size()) {
+              const Vec top =
+                  w0 * Vec::loadu(p00 + c) + w1 * Vec::loadu(p01 + c);
+              const Vec bottom =
+                  w0 * Vec::loadu(p10 + c) + w1 * Vec::loadu(p11 + c);
+              (h0 * top + h1 * bottom).store(dst + c);
+            }
+            for (; c < channels; ++c) {
+              dst[c] = h.lambda0 * (w.lambda0 * p00[c] + w.lambda1 * p01[c]) +
+                  h.lambda1 * (w.lambda0 * p10[c] + w.lambda1 * p11[c]);
+            }
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_upsample_bilinear2d_vec_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t> output_size,
+    bool align_corners,
+    const exec_aten::OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_2d_common_args(in, output_size, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  double scale_h;
+  double scale_w;
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_upsample_2d(
+          in, output_size, scale_factors, scale_h, scale_w, out) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  const int64_t batches = in.size(0);
+  const int64_t channels = in.size(1);
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const bool channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim());
+
+  ET_SWITCH_FLOAT_TYPES(
+      in.scalar_type(), ctx, "upsample_bilinear2d.vec_out", CTYPE, [&]() {
+        const auto h_indices = compute_linear_indices<CTYPE>(
+            in_h, out.size(2), align_corners, scale_h);
+        const auto w_indices = compute_linear_indices<CTYPE>(
+            in_w, out.size(3), align_corners, scale_w);
+        const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+        if (channels_last) {
+          upsample_bilinear2d_nhwc(
+              in_data,
+              out_data,
+              batches,
+              channels,
+              in_h,
+              in_w,
+              h_indices,
+              w_indices);
+        } else {
+          upsample_bilinear2d_nchw(
+              in_data,
+              out_data,
+              batches * channels,
+              in_h,
+              in_w,
+              h_indices,
+              w_indices);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
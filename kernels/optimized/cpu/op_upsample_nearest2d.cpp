@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+// The minimum number of output elements that each parallel_for chunk
+// computes.
+constexpr int64_t kUpsampleGrainSize = 32768;
+
+std::vector<int64_t> compute_nearest_indices(
+    int64_t input_size,
+    int64_t output_size,
+    double scale) {
+  std::vector<int64_t> indices(output_size);
+  for (int64_t i = 0; i < output_size; ++i) {
+    indices[i] = nearest_idx(i, input_size, output_size, scale);
+  }
+  return indices;
+}
+
+template <typename CTYPE>
+void upsample_nearest2d_nchw(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t planes,
+    int64_t in_h,
+    int64_t in_w,
+    const std::vector<int64_t>& h_indices,
+    const std::vector<int64_t>& w_indices) {
+  const int64_t out_h = h_indices.size();
+  const int64_t out_w = w_indices.size();
+  executorch::extension::parallel_for(
+      0,
+      planes * out_h,
+      std::max<int64_t>(1, kUpsampleGrainSize / out_w),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t plane = i / out_h;
+          const int64_t h = i % out_h;
+          CTYPE* dst = out_data + i * out_w;
+          // When upscaling, consecutive output rows often read the same input
+          // row, so copy the row that was just computed instead.
+          if (i > begin && h > 0 && h_indices[h] == h_indices[h - 1]) {
+            std::memcpy(dst, dst - out_w, out_w * sizeof(CTYPE));
+            continue;
+          }
+          const CTYPE* src = in_data + (plane * in_h + h_indices[h]) * in_w;
+          for (int64_t j = 0; j < out_w; ++j) {
+            dst[j] = src[w_indices[j]];
+          }
+        }
+      });
+}
+
+/**
+ * In channels last layout every output pixel is a copy of the contiguous
+ * channels of one input pixel.
+ */
+template <typename CTYPE>
+void upsample_nearest2d_nhwc(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    int64_t batches,
+    int64_t channels,
+    int64_t in_h,
+    int64_t in_w,
+    const std::vector<int64_t>& h_indices,
+    const std::vector<int64_t>& w_indices) {
+  const int64_t out_h = h_indices.size();
+  const int64_t out_w = w_indices.size();
+  const size_t pixel_bytes = channels * sizeof(CTYPE);
+  executorch::extension::parallel_for(
+      0,
+      batches * out_h,
+      std::max<int64_t>(1, kUpsampleGrainSize / (out_w * channels)),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const int64_t n = i / out_h;
+          const int64_t h = i % out_h;
+          CTYPE* dst = out_data + i * out_w * channels;
+          if (i > begin && h > 0 && h_indices[h] == h_indices[h - 1]) {
+            std::memcpy(
+                dst, dst - out_w * channels, out_w * channels * sizeof(CTYPE));
+            continue;
+          }
+          const CTYPE* src =
+              in_data + (n * in_h + h_indices[h]) * in_w * channels;
+          for (int64_t j = 0; j < out_w; ++j) {
+            std::memcpy(
+                dst + j * channels, src + w_indices[j] * channels, pixel_bytes);
+          }
+        }
+      });
+}
+
+} // namespace
+
+Tensor& opt_upsample_nearest2d_vec_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t> output_size,
+    const exec_aten::OptionalArrayRef<double> scale_factors,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_upsample_2d_common_args(in, output_size, scale_factors, out),
+      InvalidArgument,
+      out);
+
+  double scale_h;
+  double scale_w;
+  ET_KERNEL_CHECK_MSG(
+      ctx,
+      resize_upsample_2d(
+          in, output_size, scale_factors, scale_h, scale_w, out) == Error::Ok,
+      InvalidArgument,
+      out,
+      "Failed to resize output tensor");
+
+  if (in.numel() == 0) {
+    return out;
+  }
+
+  const int64_t batches = in.size(0);
+  const int64_t channels = in.size(1);
+  const int64_t in_h = in.size(2);
+  const int64_t in_w = in.size(3);
+  const auto h_indices = compute_nearest_indices(in_h, out.size(2), scale_h);
+  const auto w_indices = compute_nearest_indices(in_w, out.size(3), scale_w);
+  const bool channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim());
+
+  ET_SWITCH_REALHBBF16_TYPES(
+      in.scalar_type(), ctx, "upsample_nearest2d.vec_out", CTYPE, [&]() {
+        const CTYPE* in_data = in.const_data_ptr<CTYPE>();
+        CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+        if (channels_last) {
+          upsample_nearest2d_nhwc(
+              in_data,
+              out_data,
+              batches,
+              channels,
+              in_h,
+              in_w,
+              h_indices,
+              w_indices);
+        } else {
+          upsample_nearest2d_nchw(
+              in_data,
+              out_data,
+              batches * channels,
+              in_h,
+              in_w,
+              h_indices,
+              w_indices);
+        }
+      });
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
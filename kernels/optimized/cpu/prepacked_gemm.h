@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/blas/CPUBlas.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace internal {
+
+// Identifies op(a) packed by cpublas::pack_gemm_a() in a KernelCache. The low
+// byte holds the scalar type and the next bit whether a is transposed, since
+// the same constant packs differently for each.
+constexpr uint32_t kPrepackedGemmATag = 0x47450000; // "GE"
+
+/**
+ * Computes out = op(a) @ op(b) like cpublas::gemm() with alpha 1 and beta 0,
+ * where `a` is the data of `a_tensor`.
+ *
+ * If `a_tensor` is a constant of the method and the method has a kernel
+ * cache, op(a) is packed into the cache the first time, and read from there
+ * on every later call instead of being packed again.
+ */
+template <typename CTYPE>
+void gemm_with_prepacked_a(
+    KernelRuntimeContext& ctx,
+    executorch::cpublas::TransposeType transa,
+    executorch::cpublas::TransposeType transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const Tensor& a_tensor,
+    int64_t lda,
+    const CTYPE* b,
+    int64_t ldb,
+    CTYPE* c,
+    int64_t ldc) {
+  const CTYPE* a = a_tensor.const_data_ptr<CTYPE>();
+  constexpr bool kHasPackedKernel = std::is_floating_point<CTYPE>::value ||
+      std::is_same<CTYPE, exec_aten::Half>::value ||
+      std::is_same<CTYPE, exec_aten::BFloat16>::value;
+  if constexpr (kHasPackedKernel) {
+    auto* cache = ctx.kernel_cache();
+    if (cache != nullptr && cache->is_constant(a) &&
+        executorch::cpublas::can_gemm_prepacked_a<CTYPE>(m, n, k)) {
+      const uint32_t tag = kPrepackedGemmATag |
+          (transa != executorch::cpublas::TransposeType::NoTranspose ? 0x100
+                                                                     : 0) |
+          static_cast<uint32_t>(a_tensor.scalar_type());
+      auto packed_a = cache->get_or_create(
+          a,
+          tag,
+          executorch::cpublas::gemm_packed_a_nbytes<CTYPE>(m, k),
+          [&](void* data, size_t) {
+            executorch::cpublas::pack_gemm_a(transa, m, k, a, lda, data);
+            return Error::Ok;
+          });
+      // If the entry can't be created, fall back to packing as we go.
+      if (packed_a.ok()) {
+        executorch::cpublas::gemm_prepacked_a(
+            transb,
+            m,
+            n,
+            k,
+            static_cast<CTYPE>(1),
+            packed_a.get(),
+            b,
+            ldb,
+            static_cast<CTYPE>(0),
+            c,
+            ldc);
+        return;
+      }
+    }
+  }
+  executorch::cpublas::gemm(
+      transa,
+      transb,
+      m,
+      n,
+      k,
+      static_cast<CTYPE>(1),
+      a,
+      lda,
+      b,
+      ldb,
+      static_cast<CTYPE>(0),
+      c,
+      ldc);
+}
+
+} // namespace internal
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Shared by the optimized _softmax_backward_data and
+// _log_softmax_backward_data kernels.
+
+#include <algorithm>
+
+#include <executorch/extension/parallel/thread_parallel.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+// The minimum number of elements that each parallel_for chunk computes.
+constexpr int64_t kSoftmaxBackwardGrainSize = 32768;
+
+/**
+ * The layout of a contiguous tensor around the softmax dim, as rows of
+ * `dim_size` elements that are `inner_size` apart.
+ */
+struct SoftmaxBackwardDims {
+  SoftmaxBackwardDims(const exec_aten::Tensor& t, int64_t dim)
+      : dim_size(t.dim() == 0 ? 1 : t.size(dim)),
+        inner_size(1),
+        num_rows(1) {
+    for (int64_t i = 0; i < t.dim(); ++i) {
+      if (i < dim) {
+        num_rows *= t.size(i);
+      } else if (i > dim) {
+        inner_size *= t.size(i);
+      }
+    }
+    num_rows *= inner_size;
+  }
+
+  // The offset of the first element of a row.
+  int64_t row_offset(int64_t row) const {
+    const int64_t outer = row / inner_size;
+    const int64_t inner = row % inner_size;
+    return outer * dim_size * inner_size + inner;
+  }
+
+  int64_t dim_size;
+  int64_t inner_size;
+  int64_t num_rows;
+};
+
+/**
+ * Calls `f(begin, end)` on ranges of the rows of `dims`, split across the
+ * threadpool.
+ */
+template <typename Func>
+inline void parallel_for_softmax_rows(
+    const SoftmaxBackwardDims& dims,
+    const Func& f) {
+  const int64_t grain_size = std::max<int64_t>(
+      1, kSoftmaxBackwardGrainSize / std::max<int64_t>(1, dims.dim_size));
+  executorch::extension::parallel_for(0, dims.num_rows, grain_size, f);
+}
+
+inline bool check_softmax_backward_data_args(
+    const exec_aten::Tensor& grad_output,
+    const exec_aten::Tensor& output,
+    int64_t dim,
+    exec_aten::ScalarType input_dtype,
+    exec_aten::Tensor& grad_input) {
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_shape_and_dtype(grad_output, output));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(output, grad_input));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      input_dtype == output.scalar_type(),
+      "half to float conversion is not supported on CPU");
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_has_dim(output, dim));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(grad_output));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(output));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_dim_order(grad_input));
+  return true;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -1,4 +1,6 @@
+load("@fbsource//xplat/executorch/backends/xnnpack/third-party:third_party_libs.bzl", "third_party_dep")
 load("@fbsource//xplat/executorch/build:runtime_wrapper.bzl", "runtime")
+load("@fbsource//xplat/executorch/kernels/optimized:lib_defs.bzl", "get_vec_preprocessor_flags")
 load("@fbsource//xplat/executorch/kernels/optimized:op_registration_util.bzl", "define_op_target", "is_op_disabled", "op_target")
 
 _OPTIMIZED_ATEN_OPS = (
@@ -6,44 +8,124 @@ _OPTIMIZED_ATEN_OPS = (
         name = "op_add",
         deps = [
             ":binary_ops",
+            ":vec_kernels",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_argmax",
+        deps = [
+            ":arg_reduce_util",
+        ],
+    ),
+    op_target(
+        name = "op_argmin",
+        deps = [
+            ":arg_reduce_util",
+        ],
+    ),
     op_target(
         name = "op_bmm",
         deps = [
             "//executorch/kernels/optimized:libblas",
         ],
     ),
+    op_target(
+        name = "op_convolution",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/kernels/portable/cpu/util:dtype_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+            "//executorch/runtime/core/exec_aten/util:tensor_util",
+        ],
+    ),
+    op_target(
+        name = "op_cumsum",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/portable/cpu/util:dtype_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
     op_target(
         name = "op_div",
         deps = [
             ":binary_ops",
+            ":vec_kernels",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
-    op_target(name = "op_exp"),
-    op_target(name = "op_sigmoid"),
+    op_target(
+        name = "op_embedding",
+        deps = [
+            ":gather_util",
+            "//executorch/kernels/portable/cpu/util:kernel_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_exp",
+        deps = [
+            ":vec_kernels",
+        ],
+    ),
+    op_target(
+        name = "op_sigmoid",
+        deps = [
+            ":vec_kernels",
+        ],
+    ),
+    op_target(
+        name = "op_gather",
+        deps = [
+            ":gather_util",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
     op_target(
         name = "op_gelu",
-        deps = select({
+        deps = [
+            ":vec_kernels",
+        ] + select({
             "DEFAULT": [],
             "ovr_config//cpu:arm64": [
                 "fbsource//third-party/sleef:sleef_arm",
             ],
         }),
     ),
+    op_target(
+        name = "op_gelu_backward",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+        ],
+    ),
+    op_target(
+        name = "op_grid_sampler_2d",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+        ],
+    ),
+    op_target(
+        name = "op_index_select",
+        deps = [
+            ":gather_util",
+            "//executorch/kernels/portable/cpu/util:index_util",
+        ],
+    ),
     op_target(
         name = "op_le",
         deps = [
+            ":binary_ops",
             "//executorch/kernels/portable/cpu:scalar_utils",
+            "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
     op_target(
         name = "op_linear",
         deps = [
+            ":prepacked_gemm",
             "//executorch/kernels/optimized:libblas",
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
         ],
@@ -60,9 +142,16 @@ _OPTIMIZED_ATEN_OPS = (
             ],
         }),
     ),
+    op_target(
+        name = "op_log_softmax_backward_data",
+        deps = [
+            ":softmax_backward_util",
+        ],
+    ),
     op_target(
         name = "op_mm",
         deps = [
+            ":prepacked_gemm",
             "//executorch/kernels/optimized:libblas",
             "//executorch/kernels/portable/cpu/util:matmul_ops_util",
         ],
@@ -71,6 +160,7 @@ _OPTIMIZED_ATEN_OPS = (
         name = "op_mul",
         deps = [
             ":binary_ops",
+            ":vec_kernels",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
             "//executorch/runtime/core/exec_aten/util:tensor_util",
@@ -80,20 +170,102 @@ _OPTIMIZED_ATEN_OPS = (
         name = "op_native_layer_norm",
         deps = [
             ":moments_utils",
+            "//executorch/extension/parallel:thread_parallel",
             "//executorch/kernels/portable/cpu/util:normalization_ops_util",
         ],
     ),
+    op_target(
+        name = "op_native_layer_norm_backward",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+        ],
+    ),
     op_target(name = "op_neg"),
+    op_target(
+        name = "op_softmax",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/portable/cpu/util:activation_ops_util",
+        ],
+    ),
+    op_target(
+        name = "op_softmax_backward_data",
+        deps = [
+            ":softmax_backward_util",
+        ],
+    ),
     op_target(
         name = "op_sub",
         deps = [
             ":binary_ops",
+            ":vec_kernels",
             "//executorch/kernels/portable/cpu:scalar_utils",
             "//executorch/kernels/portable/cpu/util:broadcast_util",
         ],
     ),
+    op_target(
+        name = "op_upsample_bilinear2d",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
+    op_target(
+        name = "op_upsample_nearest2d",
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/portable/cpu/util:upsample_util",
+        ],
+    ),
 )
 
+# The flags that each CPUCapability version of a multiversioned kernel is
+# compiled with. See dispatch_stub.h.
+_X86_CPU_CAPABILITY_FLAGS = {
+    "AVX2": ["-mavx2", "-mfma", "-mf16c"],
+    "AVX512": ["-mavx512f", "-mavx512dq", "-mavx512vl", "-mavx512bw", "-mfma", "-mf16c"],
+}
+
+def _define_multiversioned_library(name, srcs, deps):
+    """Defines `name` as `srcs` compiled once per CPUCapability.
+
+    The DEFAULT version is always built. The x86 versions need sleef for the
+    vec library, so they are only built where it's available.
+    """
+    capabilities = ["DEFAULT"]
+    if not runtime.is_oss:
+        capabilities += _X86_CPU_CAPABILITY_FLAGS.keys()
+
+    for capability in capabilities:
+        is_x86_version = capability != "DEFAULT"
+        runtime.cxx_library(
+            name = "{}_{}".format(name, capability),
+            srcs = srcs,
+            # Each version is compiled in its own vec CPU_CAPABILITY namespace.
+            preprocessor_flags = [
+                "-DCPU_CAPABILITY={}".format(capability),
+            ] + (["-DCPU_CAPABILITY_{}".format(capability)] if is_x86_version else []),
+            compiler_flags = select({
+                "DEFAULT": [],
+                "ovr_config//cpu:x86_64": _X86_CPU_CAPABILITY_FLAGS[capability],
+            }) if is_x86_version else [],
+            deps = deps + (["fbsource//third-party/sleef:sleef"] if is_x86_version else []),
+            visibility = ["//executorch/kernels/optimized/cpu/..."],
+            # link_whole is necessary because each version registers itself
+            # via a static initializer.
+            # @lint-ignore BUCKLINT link_whole
+            link_whole = True,
+        )
+
+    return [":{}_DEFAULT".format(name)] + select({
+        "DEFAULT": [],
+        "ovr_config//cpu:x86_64": [
+            ":{}_{}".format(name, capability)
+            for capability in capabilities
+            if capability != "DEFAULT"
+        ],
+    })
+
 def define_common_targets():
     """Defines targets that should be shared between fbcode and xplat.
 
@@ -110,11 +282,115 @@ def define_common_targets():
     aten_op_targets = [":{}".format(op["name"]) for op in enabled_ops]
     all_op_targets = aten_op_targets
 
+    runtime.cxx_library(
+        name = "arg_reduce_util",
+        exported_headers = ["arg_reduce_util.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/kernels/portable/cpu/util:reduce_util",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+    )
+
     runtime.cxx_library(
         name = "binary_ops",
         exported_headers = ["binary_ops.h"],
         visibility = ["//executorch/kernels/optimized/cpu/..."],
-        exported_deps = ["//executorch/runtime/core:core"],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/runtime/core:core",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "dispatch_stub",
+        srcs = ["dispatch_stub.cpp"],
+        exported_headers = ["dispatch_stub.h"],
+        visibility = [
+            "//executorch/kernels/optimized/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        deps = [
+            "//executorch/runtime/platform:platform",
+            third_party_dep("cpuinfo"),
+        ],
+    )
+
+    vec_kernels_versions = _define_multiversioned_library(
+        name = "vec_kernels_impl",
+        srcs = ["vec_kernels_impl.cpp"],
+        deps = [
+            ":vec_kernels_header",
+            "//executorch/kernels/optimized:libvec",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "vec_kernels_header",
+        exported_headers = ["vec_kernels.h"],
+        visibility = [
+            "//executorch/kernels/benchmark/...",
+            "//executorch/kernels/optimized/...",
+        ],
+        exported_deps = [
+            ":dispatch_stub",
+            "//executorch/runtime/core/exec_aten:lib",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "vec_kernels",
+        srcs = ["vec_kernels.cpp"],
+        visibility = [
+            "//executorch/kernels/benchmark/...",
+            "//executorch/kernels/optimized/...",
+        ],
+        exported_deps = [":vec_kernels_header"],
+        deps = vec_kernels_versions,
+    )
+
+    runtime.cxx_library(
+        name = "gather_util",
+        exported_headers = ["gather_util.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "prepacked_gemm",
+        exported_headers = ["prepacked_gemm.h"],
+        visibility = ["//executorch/kernels/optimized/cpu/..."],
+        exported_deps = [
+            "//executorch/kernels/optimized:libblas",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "op_fused_pointwise",
+        srcs = ["op_fused_pointwise.cpp"],
+        exported_headers = ["op_fused_pointwise.h"],
+        preprocessor_flags = get_vec_preprocessor_flags(),
+        exported_deps = [
+            "//executorch/extension/kernel_util:kernel_util",
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/kernels/optimized:libvec",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+        # EXECUTORCH_LIBRARY registers the kernel from a static initializer.
+        compiler_flags = ["-Wno-global-constructors"],
+        visibility = [
+            "//executorch/kernels/optimized/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+        # @lint-ignore BUCKLINT link_whole
+        link_whole = True,
     )
 
     runtime.cxx_library(
@@ -124,6 +400,17 @@ def define_common_targets():
         exported_deps = all_op_targets,
     )
 
+    runtime.cxx_library(
+        name = "softmax_backward_util",
+        srcs = [],
+        exported_headers = ["softmax_backward_util.h"],
+        visibility = ["//executorch/kernels/optimized/..."],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
+    )
+
     runtime.cxx_library(
         name = "moments_utils",
         srcs = [],
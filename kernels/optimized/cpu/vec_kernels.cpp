@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+
+#include <atomic>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+namespace {
+
+#ifdef ET_USE_FAST_MATH
+constexpr uint8_t kDefaultMathAccuracy =
+    static_cast<uint8_t>(MathAccuracy::kFast);
+#else
+constexpr uint8_t kDefaultMathAccuracy =
+    static_cast<uint8_t>(MathAccuracy::kPrecise);
+#endif
+
+// Indexed by MathKernel.
+std::atomic<uint8_t> math_accuracies[] = {
+    kDefaultMathAccuracy,
+    kDefaultMathAccuracy,
+    kDefaultMathAccuracy,
+};
+
+} // namespace
+
+void set_math_accuracy(MathKernel kernel, MathAccuracy accuracy) {
+  math_accuracies[static_cast<size_t>(kernel)].store(
+      static_cast<uint8_t>(accuracy), std::memory_order_relaxed);
+}
+
+MathAccuracy get_math_accuracy(MathKernel kernel) {
+  return static_cast<MathAccuracy>(
+      math_accuracies[static_cast<size_t>(kernel)].load(
+          std::memory_order_relaxed));
+}
+
+// The versions of these kernels are registered by vec_kernels_impl.cpp, which
+// is compiled once per CPUCapability.
+ET_DEFINE_DISPATCH(vec_unary_stub);
+ET_DEFINE_DISPATCH(vec_binary_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
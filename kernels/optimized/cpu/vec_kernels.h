@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include <executorch/kernels/optimized/cpu/dispatch_stub.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+/**
+ * Hot elementwise loops of the optimized kernels, compiled once per
+ * CPUCapability and selected at runtime, so that a binary built for the
+ * baseline ISA still uses AVX2 or AVX-512 where the CPU has them. See
+ * dispatch_stub.h.
+ */
+
+/// Returns true if the vec kernels support the C++ type CTYPE.
+template <typename CTYPE>
+constexpr bool has_vec_kernels_v =
+    std::is_same_v<CTYPE, float> || std::is_same_v<CTYPE, double>;
+
+enum class VecUnaryOp : uint8_t {
+  kExp,
+  kSigmoid,
+  // The polynomial approximations of vec/fast_math.h, which are within a few
+  // ulp. They only differ from the precise ops for Float, in versions whose
+  // vec library has vector instructions; otherwise they compute the precise
+  // version.
+  kFastExp,
+  kFastSigmoid,
+  // x * Phi(x), where Phi is the CDF of the standard normal distribution.
+  kFastGelu,
+  // gelu with approximate='tanh'.
+  kFastGeluTanh,
+};
+
+enum class VecBinaryOp : uint8_t {
+  // a + alpha * b
+  kAdd,
+  // a - alpha * b
+  kSub,
+  // a * b
+  kMul,
+  // a / b
+  kDiv,
+};
+
+/**
+ * Computes `out[i] = op(in[i])` for `numel` contiguous elements of `dtype`,
+ * which must be Float or Double.
+ */
+using vec_unary_fn = void (*)(
+    VecUnaryOp op,
+    exec_aten::ScalarType dtype,
+    const void* in,
+    void* out,
+    int64_t numel);
+
+/**
+ * Computes `out[i] = op(a[i], b[i])` for `numel` contiguous elements of
+ * `dtype`, which must be Float or Double. `alpha` is only used by kAdd and
+ * kSub.
+ */
+using vec_binary_fn = void (*)(
+    VecBinaryOp op,
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    double alpha,
+    void* out,
+    int64_t numel);
+
+/**
+ * The accuracy of the transcendental math of the optimized kernels. kFast
+ * uses polynomial approximations that are within a few ulp, and are faster
+ * than the precise versions, especially where those are the scalar std::
+ * functions. See vec/fast_math.h for their errors.
+ */
+enum class MathAccuracy : uint8_t {
+  kPrecise,
+  kFast,
+};
+
+/// The kernels whose MathAccuracy can be selected.
+enum class MathKernel : uint8_t {
+  kExp,
+  kSigmoid,
+  kGelu,
+};
+
+/**
+ * Sets the accuracy that `kernel` uses for Float from now on. The default is
+ * kPrecise, or kFast when building with ET_USE_FAST_MATH defined.
+ */
+void set_math_accuracy(MathKernel kernel, MathAccuracy accuracy);
+
+/// Returns the accuracy that `kernel` uses for Float.
+MathAccuracy get_math_accuracy(MathKernel kernel);
+
+ET_DECLARE_DISPATCH(vec_unary_fn, vec_unary_stub);
+ET_DECLARE_DISPATCH(vec_binary_fn, vec_binary_stub);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
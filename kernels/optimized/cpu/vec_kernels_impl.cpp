@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+// Compiled once per CPUCapability, each time registering its versions of the
+// kernels declared in vec_kernels.h. See dispatch_stub.h.
+
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/kernels/optimized/vec/fast_math.h>
+#include <executorch/kernels/optimized/vec/functional.h>
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#include <cmath>
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace {
+
+using executorch::vec::Vectorized;
+
+template <typename CTYPE>
+Vectorized<CTYPE> sigmoid(Vectorized<CTYPE> x) {
+  using Vec = Vectorized<CTYPE>;
+  auto one_plus_exp = x.neg().exp() + Vec(static_cast<CTYPE>(1.0));
+  return one_plus_exp.reciprocal();
+}
+
+// The polynomial approximations only exist for float, and are only faster
+// where they are vectorized; otherwise these fall back to the precise
+// versions.
+using executorch::vec::kHasVectorizedFastMath;
+
+template <typename CTYPE>
+Vectorized<CTYPE> fast_exp(Vectorized<CTYPE> x) {
+  return x.exp();
+}
+
+Vectorized<float> fast_exp(Vectorized<float> x) {
+  if constexpr (kHasVectorizedFastMath) {
+    return executorch::vec::exp_fast(x);
+  }
+  return x.exp();
+}
+
+template <typename CTYPE>
+Vectorized<CTYPE> fast_sigmoid(Vectorized<CTYPE> x) {
+  return sigmoid(x);
+}
+
+Vectorized<float> fast_sigmoid(Vectorized<float> x) {
+  if constexpr (kHasVectorizedFastMath) {
+    return executorch::vec::sigmoid_fast(x);
+  }
+  return sigmoid(x);
+}
+
+// 0.5 * x * (1 + erf(x / sqrt(2)))
+template <typename CTYPE>
+Vectorized<CTYPE> fast_gelu(Vectorized<CTYPE> x) {
+  using Vec = Vectorized<CTYPE>;
+  const Vec kHalf(static_cast<CTYPE>(0.5));
+  const Vec kSqrt1_2(static_cast<CTYPE>(M_SQRT1_2));
+  return kHalf * x * (Vec(static_cast<CTYPE>(1)) + (x * kSqrt1_2).erf());
+}
+
+Vectorized<float> fast_gelu(Vectorized<float> x) {
+  using Vec = Vectorized<float>;
+  if constexpr (!kHasVectorizedFastMath) {
+    return fast_gelu<float>(x);
+  }
+  const Vec kHalf(0.5f);
+  const Vec kSqrt1_2(static_cast<float>(M_SQRT1_2));
+  return kHalf * x * (Vec(1.0f) + executorch::vec::erf_fast(x * kSqrt1_2));
+}
+
+// 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3)))
+template <typename CTYPE>
+Vectorized<CTYPE> gelu_tanh_inner(Vectorized<CTYPE> x) {
+  using Vec = Vectorized<CTYPE>;
+  const Vec kBeta(static_cast<CTYPE>(M_SQRT2 * M_2_SQRTPI * 0.5));
+  const Vec kKappa(static_cast<CTYPE>(0.044715));
+  return kBeta * fmadd(kKappa * x * x, x, x);
+}
+
+template <typename CTYPE>
+Vectorized<CTYPE> fast_gelu_tanh(Vectorized<CTYPE> x) {
+  using Vec = Vectorized<CTYPE>;
+  const Vec kHalf(static_cast<CTYPE>(0.5));
+  return kHalf * x * (Vec(static_cast<CTYPE>(1)) + gelu_tanh_inner(x).tanh());
+}
+
+// 0.5 * (1 + tanh(y)) is sigmoid(2 * y).
+Vectorized<float> fast_gelu_tanh(Vectorized<float> x) {
+  using Vec = Vectorized<float>;
+  if constexpr (!kHasVectorizedFastMath) {
+    return fast_gelu_tanh<float>(x);
+  }
+  return x * executorch::vec::sigmoid_fast(Vec(2.0f) * gelu_tanh_inner(x));
+}
+
+template <typename CTYPE>
+void vec_unary_impl(
+    VecUnaryOp op,
+    const CTYPE* in,
+    CTYPE* out,
+    int64_t numel) {
+  using Vec = Vectorized<CTYPE>;
+  switch (op) {
+    case VecUnaryOp::kExp:
+      executorch::vec::map<CTYPE>(
+          [](Vec x) { return x.exp(); }, out, in, numel);
+      break;
+    case VecUnaryOp::kSigmoid:
+      executorch::vec::map<CTYPE>(
+          [](Vec x) { return sigmoid(x); }, out, in, numel);
+      break;
+    case VecUnaryOp::kFastExp:
+      executorch::vec::map<CTYPE>(
+          [](Vec x) { return fast_exp(x); }, out, in, numel);
+      break;
+    case VecUnaryOp::kFastSigmoid:
+      executorch::vec::map<CTYPE>(
+          [](Vec x) { return fast_sigmoid(x); }, out, in, numel);
+      break;
+    case VecUnaryOp::kFastGelu:
+      executorch::vec::map<CTYPE>(
+          [](Vec x) { return fast_gelu(x); }, out, in, numel);
+      break;
+    case VecUnaryOp::kFastGeluTanh:
+      executorch::vec::map<CTYPE>(
+          [](Vec x) { return fast_gelu_tanh(x); }, out, in, numel);
+      break;
+  }
+}
+
+void vec_unary(
+    VecUnaryOp op,
+    exec_aten::ScalarType dtype,
+    const void* in,
+    void* out,
+    int64_t numel) {
+  if (dtype == exec_aten::ScalarType::Float) {
+    vec_unary_impl(
+        op, static_cast<const float*>(in), static_cast<float*>(out), numel);
+  } else if (dtype == exec_aten::ScalarType::Double) {
+    vec_unary_impl(
+        op, static_cast<const double*>(in), static_cast<double*>(out), numel);
+  }
+}
+
+template <typename CTYPE>
+void vec_binary_impl(
+    VecBinaryOp op,
+    const CTYPE* a,
+    const CTYPE* b,
+    CTYPE alpha,
+    CTYPE* out,
+    int64_t numel) {
+  using Vec = executorch::vec::Vectorized<CTYPE>;
+  switch (op) {
+    case VecBinaryOp::kAdd:
+      executorch::vec::map2<CTYPE>(
+          [alpha](Vec x, Vec y) { return x + Vec(alpha) * y; },
+          out,
+          a,
+          b,
+          numel);
+      break;
+    case VecBinaryOp::kSub:
+      executorch::vec::map2<CTYPE>(
+          [alpha](Vec x, Vec y) { return x - Vec(alpha) * y; },
+          out,
+          a,
+          b,
+          numel);
+      break;
+    case VecBinaryOp::kMul:
+      executorch::vec::map2<CTYPE>(
+          [](Vec x, Vec y) { return x * y; }, out, a, b, numel);
+      break;
+    case VecBinaryOp::kDiv:
+      executorch::vec::map2<CTYPE>(
+          [](Vec x, Vec y) { return x / y; }, out, a, b, numel);
+      break;
+  }
+}
+
+void vec_binary(
+    VecBinaryOp op,
+    exec_aten::ScalarType dtype,
+    const void* a,
+    const void* b,
+    double alpha,
+    void* out,
+    int64_t numel) {
+  if (dtype == exec_aten::ScalarType::Float) {
+    vec_binary_impl(
+        op,
+        static_cast<const float*>(a),
+        static_cast<const float*>(b),
+        static_cast<float>(alpha),
+        static_cast<float*>(out),
+        numel);
+  } else if (dtype == exec_aten::ScalarType::Double) {
+    vec_binary_impl(
+        op,
+        static_cast<const double*>(a),
+        static_cast<const double*>(b),
+        alpha,
+        static_cast<double*>(out),
+        numel);
+  }
+}
+
+} // namespace
+
+ET_REGISTER_DISPATCH(vec_unary_stub, &vec_unary);
+ET_REGISTER_DISPATCH(vec_binary_stub, &vec_binary);
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -128,6 +128,10 @@ def define_libs(is_fbcode=False):
             "vec/**/*.h",
         ]),
         header_namespace = "executorch/kernels/optimized",
+        exported_deps = [
+            # vec_half.h converts Half and BFloat16
+            "//executorch/runtime/core/portable_type:scalar_type",
+        ],
         visibility = [
             "//executorch/...",
             "@EXECUTORCH_CLIENTS",
@@ -231,6 +235,7 @@ def define_libs(is_fbcode=False):
             exported_deps = [
                 "//executorch/extension/parallel:thread_parallel",
                 "//executorch/kernels/optimized:libutils",
+                "//executorch/kernels/optimized:libvec",
                 "//executorch/runtime/core/exec_aten:lib",
             ],
             **get_apple_framework_deps_kwargs(is_fbcode),
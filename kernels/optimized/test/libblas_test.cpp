@@ -11,6 +11,9 @@
 #include <executorch/kernels/optimized/blas/CPUBlas.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 #define TEST_FORALL_SUPPORTED_CTYPES(_, N) \
@@ -76,3 +79,255 @@ void test_matmul_ones() {
 TEST(BlasTest, MatmulOnes) {
   TEST_FORALL_SUPPORTED_CTYPES(test_matmul_ones, 25);
 }
+
+namespace {
+
+// Computes c = alpha * (op(a) @ op(b)) + beta * c in double precision, for
+// column-major matrices.
+template <typename T>
+std::vector<double> reference_gemm(
+    bool transa,
+    bool transb,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    double alpha,
+    const std::vector<T>& a,
+    int64_t lda,
+    const std::vector<T>& b,
+    int64_t ldb,
+    double beta,
+    const std::vector<T>& c,
+    int64_t ldc) {
+  std::vector<double> out(c.begin(), c.end());
+  for (int64_t j = 0; j < n; ++j) {
+    for (int64_t i = 0; i < m; ++i) {
+      double dot = 0;
+      for (int64_t l = 0; l < k; ++l) {
+        const double a_il =
+            static_cast<double>(transa ? a[i * lda + l] : a[l * lda + i]);
+        const double b_lj =
+            static_cast<double>(transb ? b[l * ldb + j] : b[j * ldb + l]);
+        dot += a_il * b_lj;
+      }
+      out[j * ldc + i] =
+          alpha * dot + beta * static_cast<double>(c[j * ldc + i]);
+    }
+  }
+  return out;
+}
+
+template <class CTYPE>
+void test_matmul_matches_reference(double tolerance) {
+  using executorch::cpublas::TransposeType;
+
+  // Large enough to take the packed path, with edges that don't fill the
+  // register tiles and a depth that spans several packed panels.
+  constexpr int64_t m = 77;
+  constexpr int64_t n = 45;
+  constexpr int64_t k = 300;
+  for (const bool transa : {false, true}) {
+    for (const bool transb : {false, true}) {
+      const int64_t lda = (transa ? k : m) + 3;
+      const int64_t ldb = (transb ? n : k) + 1;
+      const int64_t ldc = m + 2;
+      std::vector<CTYPE> a(lda * (transa ? m : k));
+      std::vector<CTYPE> b(ldb * (transb ? k : n));
+      std::vector<CTYPE> c(ldc * n);
+      // Small integers, which are exact in every type.
+      for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = static_cast<CTYPE>(static_cast<int>(i % 7) - 3);
+      }
+      for (size_t i = 0; i < b.size(); ++i) {
+        b[i] = static_cast<CTYPE>(static_cast<int>(i % 5) - 2);
+      }
+      for (size_t i = 0; i < c.size(); ++i) {
+        c[i] = static_cast<CTYPE>(static_cast<int>(i % 3));
+      }
+      const auto expected = reference_gemm(
+          transa, transb, m, n, k, 0.5, a, lda, b, ldb, 2.0, c, ldc);
+
+      // clang-format off
+      executorch::cpublas::gemm(
+          transa ? TransposeType::Transpose : TransposeType::NoTranspose,
+          transb ? TransposeType::Transpose : TransposeType::NoTranspose,
+          m, n, k,
+          static_cast<CTYPE>(0.5),
+          a.data(), lda,
+          b.data(), ldb,
+          static_cast<CTYPE>(2),
+          c.data(), ldc);
+      // clang-format on
+
+      for (int64_t j = 0; j < n; ++j) {
+        for (int64_t i = 0; i < m; ++i) {
+          const double expected_ij = expected[j * ldc + i];
+          EXPECT_NEAR(
+              static_cast<double>(c[j * ldc + i]),
+              expected_ij,
+              tolerance * std::max(1.0, std::abs(expected_ij)))
+              << "transa=" << transa << " transb=" << transb << " i=" << i
+              << " j=" << j;
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST(BlasTest, MatmulMatchesReference) {
+  test_matmul_matches_reference<double>(1e-12);
+  test_matmul_matches_reference<float>(1e-5);
+  // The results are rounded once, after accumulating in float.
+  test_matmul_matches_reference<exec_aten::Half>(1e-3);
+  test_matmul_matches_reference<exec_aten::BFloat16>(1e-2);
+}
+
+TEST(BlasTest, MatmulIgnoresOutputWhenBetaIsZero) {
+  using executorch::cpublas::TransposeType;
+
+  constexpr int64_t N = 40;
+  std::vector<float> a(N * N, 1.0f);
+  std::vector<float> b(N * N, 1.0f);
+  std::vector<float> c(N * N, std::numeric_limits<float>::quiet_NaN());
+
+  // clang-format off
+  executorch::cpublas::gemm(
+      TransposeType::NoTranspose, TransposeType::NoTranspose,
+      N, N, N,
+      1.0f,
+      a.data(), N,
+      b.data(), N,
+      0.0f,
+      c.data(), N);
+  // clang-format on
+
+  EXPECT_TRUE(check_all_equal_to(c, static_cast<float>(N)));
+}
+
+template <class CTYPE>
+void test_matmul_prepacked_a_matches_gemm() {
+  using executorch::cpublas::TransposeType;
+
+  constexpr int64_t m = 70;
+  constexpr int64_t n = 33;
+  constexpr int64_t k = 281;
+  ASSERT_TRUE(executorch::cpublas::can_gemm_prepacked_a<CTYPE>(m, n, k));
+  for (const bool transa : {false, true}) {
+    const int64_t lda = transa ? k : m;
+    std::vector<CTYPE> a(lda * (transa ? m : k));
+    std::vector<CTYPE> b(k * n);
+    for (size_t i = 0; i < a.size(); ++i) {
+      a[i] = static_cast<CTYPE>(static_cast<int>(i % 7) - 3);
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      b[i] = static_cast<CTYPE>(static_cast<int>(i % 5) - 2);
+    }
+    const auto transa_type =
+        transa ? TransposeType::Transpose : TransposeType::NoTranspose;
+
+    // clang-format off
+    std::vector<CTYPE> expected(m * n);
+    executorch::cpublas::gemm(
+        transa_type, TransposeType::NoTranspose,
+        m, n, k,
+        static_cast<CTYPE>(1),
+        a.data(), lda,
+        b.data(), k,
+        static_cast<CTYPE>(0),
+        expected.data(), m);
+
+    std::vector<float> packed_a(
+        executorch::cpublas::gemm_packed_a_nbytes<CTYPE>(m, k) / sizeof(float) +
+        1);
+    executorch::cpublas::pack_gemm_a(
+        transa_type, m, k, a.data(), lda, packed_a.data());
+    std::vector<CTYPE> actual(m * n);
+    executorch::cpublas::gemm_prepacked_a(
+        TransposeType::NoTranspose,
+        m, n, k,
+        static_cast<CTYPE>(1),
+        packed_a.data(),
+        b.data(), k,
+        static_cast<CTYPE>(0),
+        actual.data(), m);
+    // clang-format on
+
+    for (size_t i = 0; i < actual.size(); ++i) {
+      EXPECT_EQ(
+          static_cast<float>(actual[i]), static_cast<float>(expected[i]))
+          << "transa=" << transa << " i=" << i;
+    }
+  }
+}
+
+TEST(BlasTest, MatmulPrepackedAMatchesGemm) {
+  test_matmul_prepacked_a_matches_gemm<float>();
+  test_matmul_prepacked_a_matches_gemm<exec_aten::Half>();
+  test_matmul_prepacked_a_matches_gemm<exec_aten::BFloat16>();
+}
+
+template <class CTYPE>
+void test_gemm_batched_matches_gemm() {
+  using executorch::cpublas::TransposeType;
+
+  constexpr int64_t batch_size = 3;
+  // Small entries, and ones whose columns are split into tiles.
+  for (const int64_t m : {5, 64}) {
+    constexpr int64_t n = 150;
+    const int64_t k = m;
+    for (const bool transb : {false, true}) {
+      const int64_t ldb = transb ? n : k;
+      const int64_t stride_a = m * k;
+      const int64_t stride_b = k * n;
+      const int64_t stride_c = m * n;
+      std::vector<CTYPE> a(batch_size * stride_a);
+      std::vector<CTYPE> b(batch_size * stride_b);
+      for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = static_cast<CTYPE>(static_cast<int>(i % 7) - 3);
+      }
+      for (size_t i = 0; i < b.size(); ++i) {
+        b[i] = static_cast<CTYPE>(static_cast<int>(i % 5) - 2);
+      }
+      const auto transb_type =
+          transb ? TransposeType::Transpose : TransposeType::NoTranspose;
+
+      // clang-format off
+      std::vector<CTYPE> expected(batch_size * stride_c);
+      for (int64_t i = 0; i < batch_size; ++i) {
+        executorch::cpublas::gemm(
+            TransposeType::NoTranspose, transb_type,
+            m, n, k,
+            static_cast<CTYPE>(1),
+            a.data() + i * stride_a, m,
+            b.data() + i * stride_b, ldb,
+            static_cast<CTYPE>(0),
+            expected.data() + i * stride_c, m);
+      }
+      std::vector<CTYPE> actual(batch_size * stride_c);
+      executorch::cpublas::gemm_batched(
+          TransposeType::NoTranspose, transb_type,
+          batch_size,
+          m, n, k,
+          static_cast<CTYPE>(1),
+          a.data(), m, stride_a,
+          b.data(), ldb, stride_b,
+          static_cast<CTYPE>(0),
+          actual.data(), m, stride_c);
+      // clang-format on
+
+      for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_EQ(
+            static_cast<float>(actual[i]), static_cast<float>(expected[i]))
+            << "m=" << m << " transb=" << transb << " i=" << i;
+      }
+    }
+  }
+}
+
+TEST(BlasTest, GemmBatchedMatchesGemm) {
+  test_gemm_batched_matches_gemm<float>();
+  test_gemm_batched_matches_gemm<int32_t>();
+  test_gemm_batched_matches_gemm<exec_aten::BFloat16>();
+}
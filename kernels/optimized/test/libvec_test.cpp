@@ -8,9 +8,13 @@
 
 #include <gtest/gtest.h>
 
+#include <executorch/kernels/optimized/vec/fast_math.h>
 #include <executorch/kernels/optimized/vec/functional.h>
 #include <executorch/kernels/optimized/vec/vec.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 #define TEST_FORALL_SUPPORTED_CTYPES(_) \
@@ -72,3 +76,302 @@ void test_load_and_add() {
 TEST(VecFloatTest, LoadAndAdd) {
   TEST_FORALL_SUPPORTED_CTYPES(test_load_and_add);
 }
+
+template <typename T>
+void test_partial_load_and_store() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  constexpr size_t kVecSize = static_cast<size_t>(Vec::size());
+
+  std::vector<T> in(kVecSize);
+  fill_monotonic(in, 1);
+
+  for (size_t count = 0; count <= kVecSize; ++count) {
+    // Elements past `count` are loaded as zero, and are not stored.
+    std::vector<T> out(kVecSize, static_cast<T>(-1));
+    Vec::loadu(in.data(), count).store(out.data());
+    for (size_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(out[i], i < count ? in[i] : static_cast<T>(0));
+    }
+
+    std::fill(out.begin(), out.end(), static_cast<T>(-1));
+    Vec::loadu(in.data()).store(out.data(), count);
+    for (size_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(out[i], i < count ? in[i] : static_cast<T>(-1));
+    }
+  }
+}
+
+TEST(VecFloatTest, PartialLoadAndStore) {
+  TEST_FORALL_SUPPORTED_CTYPES(test_partial_load_and_store);
+}
+
+template <typename T>
+void test_set() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  constexpr size_t kVecSize = static_cast<size_t>(Vec::size());
+
+  for (size_t count = 0; count <= kVecSize; ++count) {
+    std::vector<T> out(kVecSize);
+    Vec::set(Vec(static_cast<T>(1)), Vec(static_cast<T>(2)), count)
+        .store(out.data());
+    for (size_t i = 0; i < kVecSize; ++i) {
+      EXPECT_EQ(out[i], static_cast<T>(i < count ? 2 : 1));
+    }
+  }
+}
+
+TEST(VecFloatTest, Set) {
+  TEST_FORALL_SUPPORTED_CTYPES(test_set);
+}
+
+template <typename T>
+void test_maximum_propagates_nan() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  constexpr size_t kVecSize = static_cast<size_t>(Vec::size());
+
+  std::vector<T> a(kVecSize);
+  fill_monotonic(a);
+  std::vector<T> b(kVecSize);
+  fill_monotonic(b, kVecSize, -1);
+  b[1] = std::numeric_limits<T>::quiet_NaN();
+
+  std::vector<T> out(kVecSize);
+  executorch::vec::maximum(Vec::loadu(a.data()), Vec::loadu(b.data()))
+      .store(out.data());
+  for (size_t i = 0; i < kVecSize; ++i) {
+    if (i == 1) {
+      EXPECT_TRUE(std::isnan(out[i]));
+    } else {
+      EXPECT_EQ(out[i], std::max(a[i], b[i]));
+    }
+  }
+}
+
+TEST(VecFloatTest, MaximumPropagatesNaN) {
+  test_maximum_propagates_nan<float>();
+  test_maximum_propagates_nan<double>();
+}
+
+template <typename T>
+void test_reduce_all() {
+  using Vec = executorch::vec::Vectorized<T>;
+
+  // Covers a partial and several full vectors.
+  std::vector<T> in(3 * Vec::size() + 3);
+  fill_monotonic(in);
+
+  const T sum = executorch::vec::reduce_all<T>(
+      [](Vec& x, Vec& y) { return x + y; }, in.data(), in.size());
+  EXPECT_EQ(sum, static_cast<T>(in.size() * (in.size() - 1) / 2));
+}
+
+TEST(VecFloatTest, ReduceAll) {
+  TEST_FORALL_SUPPORTED_CTYPES(test_reduce_all);
+}
+
+template <typename T>
+void test_convert_reduced_float() {
+  // Every bit pattern, plus a tail that the vector loops don't cover.
+  std::vector<T> in(65536 + 3);
+  for (size_t i = 0; i < in.size(); ++i) {
+    in[i].x = static_cast<uint16_t>(i);
+  }
+  std::vector<float> widened(in.size());
+  executorch::vec::convert(in.data(), widened.data(), in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    const float expected = static_cast<float>(in[i]);
+    if (std::isnan(expected)) {
+      EXPECT_TRUE(std::isnan(widened[i])) << i;
+    } else {
+      EXPECT_EQ(widened[i], expected) << i;
+    }
+  }
+
+  // Ties, overflow, subnormals, signed zeros and NaN.
+  std::vector<float> values = {
+      0.0f,
+      -0.0f,
+      1.0f + 1.0f / 2048,
+      1.0f + 3.0f / 2048,
+      1.0f + 1.0f / 256,
+      65504.0f,
+      65520.0f,
+      1e-7f,
+      -1e-40f,
+      3.4e38f,
+      std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::quiet_NaN(),
+  };
+  for (int i = 0; i < 100; ++i) {
+    values.push_back(std::ldexp(1.0f + i / 128.0f, i - 50) * (i % 2 ? -1 : 1));
+  }
+  std::vector<T> narrowed(values.size());
+  executorch::vec::convert(values.data(), narrowed.data(), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    const T expected = static_cast<T>(values[i]);
+    if (std::isnan(values[i])) {
+      EXPECT_TRUE(std::isnan(static_cast<float>(narrowed[i]))) << i;
+    } else {
+      EXPECT_EQ(narrowed[i].x, expected.x) << i;
+    }
+  }
+}
+
+TEST(VecFloatTest, ConvertReducedFloat) {
+  test_convert_reduced_float<executorch::runtime::etensor::Half>();
+  test_convert_reduced_float<executorch::runtime::etensor::BFloat16>();
+}
+
+template <typename T>
+void test_map2_reduced_float() {
+  using Vec = executorch::vec::Vectorized<float>;
+
+  // Covers more than one block, and a partial one.
+  std::vector<T> a(2 * executorch::vec::kReducedFloatBlockSize + 5);
+  std::vector<T> b(a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    a[i] = static_cast<T>(0.37f * i - 100);
+    b[i] = static_cast<T>(1.7f - 0.011f * i);
+  }
+  std::vector<T> out(a.size());
+  executorch::vec::map2_reduced_float<T>(
+      [](Vec x, Vec y) { return x + Vec(0.5f) * y; },
+      out.data(),
+      a.data(),
+      b.data(),
+      out.size());
+  for (size_t i = 0; i < out.size(); ++i) {
+    // Computed in float and rounded once.
+    const T expected = static_cast<T>(
+        static_cast<float>(a[i]) + 0.5f * static_cast<float>(b[i]));
+    EXPECT_EQ(out[i].x, expected.x) << i;
+  }
+}
+
+TEST(VecFloatTest, Map2ReducedFloat) {
+  test_map2_reduced_float<executorch::runtime::etensor::Half>();
+  test_map2_reduced_float<executorch::runtime::etensor::BFloat16>();
+}
+
+namespace {
+
+// The distance from `actual` to `expected` in units of the spacing of floats
+// around `expected`.
+double ulp_error(float actual, double expected) {
+  const float rounded = static_cast<float>(expected);
+  const float next = std::nextafter(
+      std::fabs(rounded), std::numeric_limits<float>::infinity());
+  return std::fabs(actual - expected) / (next - std::fabs(rounded));
+}
+
+template <typename Fast, typename Reference>
+void expect_within_ulp(
+    const char* name,
+    Fast fast,
+    Reference reference,
+    float lo,
+    float hi,
+    double max_ulp) {
+  using Vec = executorch::vec::Vectorized<float>;
+  // Steps through about a million floats of [lo, hi].
+  std::vector<float> in;
+  const double step = (static_cast<double>(hi) - lo) / (1 << 20);
+  for (double x = lo; x <= hi; x += step) {
+    in.push_back(static_cast<float>(x));
+  }
+  std::vector<float> out(in.size());
+  executorch::vec::map<float>(fast, out.data(), in.data(), in.size());
+  double worst = 0;
+  float worst_x = 0;
+  for (size_t i = 0; i < in.size(); ++i) {
+    const double error = ulp_error(out[i], reference(in[i]));
+    if (!(error <= worst)) {
+      worst = error;
+      worst_x = in[i];
+    }
+  }
+  EXPECT_LE(worst, max_ulp) << name << " at " << worst_x;
+}
+
+} // namespace
+
+TEST(VecFloatTest, FastMathWithinUlpBounds) {
+  using Vec = executorch::vec::Vectorized<float>;
+  expect_within_ulp(
+      "exp",
+      [](Vec x) { return executorch::vec::exp_fast(x); },
+      [](double x) { return std::exp(x); },
+      -103.0f,
+      88.0f,
+      1.5);
+  expect_within_ulp(
+      "tanh",
+      [](Vec x) { return executorch::vec::tanh_fast(x); },
+      [](double x) { return std::tanh(x); },
+      -10.0f,
+      10.0f,
+      2.0);
+  expect_within_ulp(
+      "sigmoid",
+      [](Vec x) { return executorch::vec::sigmoid_fast(x); },
+      [](double x) { return 1 / (1 + std::exp(-x)); },
+      -100.0f,
+      30.0f,
+      3.0);
+  expect_within_ulp(
+      "erf",
+      [](Vec x) { return executorch::vec::erf_fast(x); },
+      [](double x) { return std::erf(x); },
+      -5.0f,
+      5.0f,
+      3.5);
+}
+
+TEST(VecFloatTest, FastMathSpecialValues) {
+  using Vec = executorch::vec::Vectorized<float>;
+  constexpr float kInf = std::numeric_limits<float>::infinity();
+  const std::vector<float> in = {
+      std::numeric_limits<float>::quiet_NaN(), kInf, -kInf, 0.0f, 200.0f,
+      -200.0f};
+  auto apply = [&in](Vec (*fn)(const Vec&)) {
+    std::vector<float> out(in.size());
+    executorch::vec::map<float>(
+        [fn](Vec x) { return fn(x); }, out.data(), in.data(), in.size());
+    return out;
+  };
+
+  const std::vector<float> exp_out = apply(executorch::vec::exp_fast);
+  EXPECT_TRUE(std::isnan(exp_out[0]));
+  EXPECT_EQ(exp_out[1], kInf);
+  EXPECT_EQ(exp_out[2], 0.0f);
+  EXPECT_EQ(exp_out[3], 1.0f);
+  EXPECT_EQ(exp_out[4], kInf);
+  EXPECT_EQ(exp_out[5], 0.0f);
+
+  const std::vector<float> tanh_out = apply(executorch::vec::tanh_fast);
+  EXPECT_TRUE(std::isnan(tanh_out[0]));
+  EXPECT_EQ(tanh_out[1], 1.0f);
+  EXPECT_EQ(tanh_out[2], -1.0f);
+  EXPECT_EQ(tanh_out[3], 0.0f);
+  EXPECT_EQ(tanh_out[4], 1.0f);
+  EXPECT_EQ(tanh_out[5], -1.0f);
+
+  const std::vector<float> sigmoid_out = apply(executorch::vec::sigmoid_fast);
+  EXPECT_TRUE(std::isnan(sigmoid_out[0]));
+  EXPECT_EQ(sigmoid_out[1], 1.0f);
+  EXPECT_EQ(sigmoid_out[2], 0.0f);
+  EXPECT_EQ(sigmoid_out[3], 0.5f);
+  EXPECT_EQ(sigmoid_out[4], 1.0f);
+  EXPECT_EQ(sigmoid_out[5], 0.0f);
+
+  const std::vector<float> erf_out = apply(executorch::vec::erf_fast);
+  EXPECT_TRUE(std::isnan(erf_out[0]));
+  EXPECT_EQ(erf_out[1], 1.0f);
+  EXPECT_EQ(erf_out[2], -1.0f);
+  EXPECT_EQ(erf_out[3], 0.0f);
+  EXPECT_EQ(erf_out[4], 1.0f);
+  EXPECT_EQ(erf_out[5], -1.0f);
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/kernels/optimized/cpu/op_fused_pointwise.h>
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using exec_aten::ArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::native::fused_pointwise_out;
+using torch::executor::native::PointwiseOpcode;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+
+class OpFusedPointwiseTest : public OperatorTest {
+ protected:
+  Tensor& op_fused_pointwise_out(
+      const std::vector<Tensor>& inputs,
+      const std::vector<int64_t>& program,
+      const std::vector<double>& constants,
+      Tensor& out) {
+    return fused_pointwise_out(
+        context_,
+        exec_aten::TensorList(inputs.data(), inputs.size()),
+        ArrayRef<int64_t>(program.data(), program.size()),
+        ArrayRef<double>(constants.data(), constants.size()),
+        out);
+  }
+
+  static int64_t op(PointwiseOpcode opcode) {
+    return static_cast<int64_t>(opcode);
+  }
+
+  // Computes relu(x * w + c0) - sigmoid(tanh(x / y)), with w a single element.
+  template <ScalarType DTYPE>
+  void test_against_reference(int32_t numel) {
+    using CTYPE = typename TensorFactory<DTYPE>::ctype;
+    TensorFactory<DTYPE> tf;
+    std::vector<CTYPE> x_data(numel);
+    std::vector<CTYPE> y_data(numel);
+    std::vector<CTYPE> expected_data(numel);
+    const CTYPE w = 1.5;
+    const CTYPE c0 = -0.25;
+    for (int32_t i = 0; i < numel; ++i) {
+      x_data[i] = static_cast<CTYPE>(i % 17 - 8) / 4;
+      y_data[i] = static_cast<CTYPE>(i % 5 + 1) / 2;
+      const CTYPE left = std::max<CTYPE>(x_data[i] * w + c0, 0);
+      const CTYPE right = 1 / (1 + std::exp(-std::tanh(x_data[i] / y_data[i])));
+      expected_data[i] = left - right;
+    }
+
+    const std::vector<Tensor> inputs = {
+        tf.make({numel}, x_data), tf.make({numel}, y_data), tf.make({1}, {w})};
+    const std::vector<int64_t> program = {
+        op(PointwiseOpcode::kInput),    0, 0, // r0 = x
+        op(PointwiseOpcode::kInput),    1, 0, // r1 = y
+        op(PointwiseOpcode::kInput),    2, 0, // r2 = w
+        op(PointwiseOpcode::kConstant), 0, 0, // r3 = c0
+        op(PointwiseOpcode::kMul),      0, 2, // r4 = r0 * r2
+        op(PointwiseOpcode::kAdd),      4, 3, // r5 = r4 + r3
+        op(PointwiseOpcode::kRelu),     5, 0, // r6 = relu(r5)
+        op(PointwiseOpcode::kDiv),      0, 1, // r7 = r0 / r1
+        op(PointwiseOpcode::kTanh),     7, 0, // r8 = tanh(r7)
+        op(PointwiseOpcode::kSigmoid),  8, 0, // r9 = sigmoid(r8)
+        op(PointwiseOpcode::kSub),      6, 9, // r10 = r6 - r9
+    };
+    Tensor out = tf.zeros({numel});
+    Tensor& ret = op_fused_pointwise_out(inputs, program, {c0}, out);
+
+    EXPECT_TENSOR_EQ(ret, out);
+    EXPECT_TENSOR_CLOSE(out, tf.make({numel}, expected_data));
+  }
+};
+
+} // namespace
+
+TEST_F(OpFusedPointwiseTest, FloatMatchesReference) {
+  // Sizes that are smaller than, equal to, and not a multiple of a tile, and
+  // large enough to run in parallel.
+  for (int32_t numel : {1, 7, 64, 100, 65537}) {
+    SCOPED_TRACE(numel);
+    test_against_reference<ScalarType::Float>(numel);
+  }
+}
+
+TEST_F(OpFusedPointwiseTest, DoubleMatchesReference) {
+  for (int32_t numel : {3, 129}) {
+    SCOPED_TRACE(numel);
+    test_against_reference<ScalarType::Double>(numel);
+  }
+}
+
+TEST_F(OpFusedPointwiseTest, NegExpOfMultiDimInput) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<Tensor> inputs = {tf.make({2, 2}, {0, 1, -1, 2})};
+  const std::vector<int64_t> program = {
+      op(PointwiseOpcode::kInput), 0, 0,
+      op(PointwiseOpcode::kNeg),   0, 0,
+      op(PointwiseOpcode::kExp),   1, 0,
+  };
+  Tensor out = tf.zeros({2, 2});
+  op_fused_pointwise_out(inputs, program, {}, out);
+  EXPECT_TENSOR_CLOSE(
+      out,
+      tf.make(
+          {2, 2},
+          {1, std::exp(-1.0f), std::exp(1.0f), std::exp(-2.0f)}));
+}
+
+TEST_F(OpFusedPointwiseTest, RejectsReadOfLaterRegister) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<Tensor> inputs = {tf.ones({4})};
+  const std::vector<int64_t> program = {
+      op(PointwiseOpcode::kInput), 0, 0,
+      op(PointwiseOpcode::kAdd),   0, 1,
+  };
+  Tensor out = tf.zeros({4});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_fused_pointwise_out(inputs, program, {}, out));
+}
+
+TEST_F(OpFusedPointwiseTest, RejectsUnknownOpcode) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<Tensor> inputs = {tf.ones({4})};
+  const std::vector<int64_t> program = {
+      op(PointwiseOpcode::kInput), 0, 0, 100, 0, 0};
+  Tensor out = tf.zeros({4});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_fused_pointwise_out(inputs, program, {}, out));
+}
+
+TEST_F(OpFusedPointwiseTest, RejectsMismatchedDtype) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+  const std::vector<Tensor> inputs = {tf.ones({4})};
+  const std::vector<int64_t> program = {op(PointwiseOpcode::kInput), 0, 0};
+  Tensor out = tf_double.zeros({4});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_fused_pointwise_out(inputs, program, {}, out));
+}
+
+TEST_F(OpFusedPointwiseTest, RejectsBroadcastOfNonScalarInput) {
+  TensorFactory<ScalarType::Float> tf;
+  const std::vector<Tensor> inputs = {tf.ones({2, 3}), tf.ones({3})};
+  const std::vector<int64_t> program = {
+      op(PointwiseOpcode::kInput), 0, 0,
+      op(PointwiseOpcode::kInput), 1, 0,
+      op(PointwiseOpcode::kMul),   0, 1,
+  };
+  Tensor out = tf.zeros({2, 3});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_fused_pointwise_out(inputs, program, {}, out));
+}
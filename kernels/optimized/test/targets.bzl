@@ -41,3 +41,12 @@ def define_common_targets():
     _lib_test_bin("libvec_test_bin")
     _lib_test_bin("moments_utils_test_bin", in_cpu = True)
     _lib_test_bin("libblas_test_bin")
+    _lib_test_bin("vec_kernels_test_bin", in_cpu = True)
+    _lib_test_bin(
+        "op_fused_pointwise_test_bin",
+        extra_deps = [
+            "//executorch/kernels/test:test_util",
+            "//executorch/runtime/core/exec_aten/testing_util:tensor_util",
+        ],
+        in_cpu = True,
+    )
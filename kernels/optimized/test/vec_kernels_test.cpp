@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <executorch/kernels/optimized/cpu/dispatch_stub.h>
+#include <executorch/kernels/optimized/cpu/vec_kernels.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <cmath>
+#include <vector>
+
+using torch::executor::CPUCapability;
+using torch::executor::DispatchStub;
+using torch::executor::get_cpu_capability;
+using torch::executor::native::get_math_accuracy;
+using torch::executor::native::MathAccuracy;
+using torch::executor::native::MathKernel;
+using torch::executor::native::set_math_accuracy;
+using torch::executor::native::vec_binary_stub;
+using torch::executor::native::vec_unary_stub;
+using torch::executor::native::VecBinaryOp;
+using torch::executor::native::VecUnaryOp;
+
+namespace {
+
+using test_fn = int (*)();
+
+int default_version() {
+  return 0;
+}
+
+int avx2_version() {
+  return 2;
+}
+
+DispatchStub<test_fn> test_stub;
+
+// Returns the capabilities that this CPU can run.
+std::vector<CPUCapability> runnable_capabilities() {
+  std::vector<CPUCapability> capabilities;
+  for (int i = 0; i <= static_cast<int>(get_cpu_capability()); ++i) {
+    capabilities.push_back(static_cast<CPUCapability>(i));
+  }
+  return capabilities;
+}
+
+class DispatchStubTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Detecting the capability may log.
+    executorch::runtime::runtime_init();
+  }
+};
+
+class VecKernelsTest : public DispatchStubTest {};
+
+} // namespace
+
+TEST_F(DispatchStubTest, ChoosesMostCapableRegisteredVersion) {
+  test_stub.set(CPUCapability::DEFAULT, &default_version);
+  EXPECT_EQ(test_stub.choose(CPUCapability::AVX512), &default_version);
+
+  test_stub.set(CPUCapability::AVX2, &avx2_version);
+  EXPECT_EQ(test_stub.choose(CPUCapability::DEFAULT), &default_version);
+  EXPECT_EQ(test_stub.choose(CPUCapability::AVX2), &avx2_version);
+  EXPECT_EQ(test_stub.choose(CPUCapability::AVX512), &avx2_version);
+
+  EXPECT_EQ(test_stub(), test_stub.choose(get_cpu_capability())());
+}
+
+TEST_F(DispatchStubTest, CapabilityIsAtMostDetected) {
+  EXPECT_LE(
+      get_cpu_capability(), torch::executor::internal::compute_cpu_capability());
+}
+
+TEST_F(VecKernelsTest, EveryRunnableVersionMatchesReference) {
+  constexpr int64_t kNumel = 67;
+  std::vector<float> a(kNumel);
+  std::vector<float> b(kNumel);
+  for (int64_t i = 0; i < kNumel; ++i) {
+    a[i] = static_cast<float>(i - kNumel / 2) / 8;
+    b[i] = static_cast<float>(i % 7 + 1) / 4;
+  }
+
+  for (CPUCapability capability : runnable_capabilities()) {
+    SCOPED_TRACE(torch::executor::cpu_capability_name(capability));
+    std::vector<float> out(kNumel);
+
+    vec_binary_stub.choose(capability)(
+        VecBinaryOp::kAdd,
+        exec_aten::ScalarType::Float,
+        a.data(),
+        b.data(),
+        /*alpha=*/2,
+        out.data(),
+        kNumel);
+    for (int64_t i = 0; i < kNumel; ++i) {
+      EXPECT_FLOAT_EQ(out[i], a[i] + 2 * b[i]);
+    }
+
+    vec_binary_stub.choose(capability)(
+        VecBinaryOp::kDiv,
+        exec_aten::ScalarType::Float,
+        a.data(),
+        b.data(),
+        /*alpha=*/1,
+        out.data(),
+        kNumel);
+    for (int64_t i = 0; i < kNumel; ++i) {
+      EXPECT_FLOAT_EQ(out[i], a[i] / b[i]);
+    }
+
+    vec_unary_stub.choose(capability)(
+        VecUnaryOp::kSigmoid,
+        exec_aten::ScalarType::Float,
+        a.data(),
+        out.data(),
+        kNumel);
+    for (int64_t i = 0; i < kNumel; ++i) {
+      EXPECT_NEAR(out[i], 1 / (1 + std::exp(-a[i])), 1e-6);
+    }
+  }
+}
+
+TEST_F(VecKernelsTest, SupportsDouble) {
+  std::vector<double> a = {-1.5, 0, 0.25, 3};
+  std::vector<double> out(a.size());
+  vec_unary_stub(
+      VecUnaryOp::kExp,
+      exec_aten::ScalarType::Double,
+      a.data(),
+      out.data(),
+      a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_NEAR(out[i], std::exp(a[i]), 1e-12);
+  }
+}
+
+TEST_F(VecKernelsTest, FastOpsMatchReference) {
+  constexpr int64_t kNumel = 203;
+  std::vector<float> in(kNumel);
+  for (int64_t i = 0; i < kNumel; ++i) {
+    in[i] = static_cast<float>(i - kNumel / 2) / 10;
+  }
+
+  for (CPUCapability capability : runnable_capabilities()) {
+    SCOPED_TRACE(torch::executor::cpu_capability_name(capability));
+    std::vector<float> out(kNumel);
+
+    vec_unary_stub.choose(capability)(
+        VecUnaryOp::kFastExp,
+        exec_aten::ScalarType::Float,
+        in.data(),
+        out.data(),
+        kNumel);
+    for (int64_t i = 0; i < kNumel; ++i) {
+      EXPECT_FLOAT_EQ(out[i], std::exp(in[i]));
+    }
+
+    vec_unary_stub.choose(capability)(
+        VecUnaryOp::kFastSigmoid,
+        exec_aten::ScalarType::Float,
+        in.data(),
+        out.data(),
+        kNumel);
+    for (int64_t i = 0; i < kNumel; ++i) {
+      EXPECT_FLOAT_EQ(out[i], 1 / (1 + std::exp(-in[i])));
+    }
+
+    vec_unary_stub.choose(capability)(
+        VecUnaryOp::kFastGelu,
+        exec_aten::ScalarType::Float,
+        in.data(),
+        out.data(),
+        kNumel);
+    for (int64_t i = 0; i < kNumel; ++i) {
+      const double x = in[i];
+      EXPECT_NEAR(out[i], 0.5 * x * (1 + std::erf(x * M_SQRT1_2)), 1e-6);
+    }
+
+    vec_unary_stub.choose(capability)(
+        VecUnaryOp::kFastGeluTanh,
+        exec_aten::ScalarType::Float,
+        in.data(),
+        out.data(),
+        kNumel);
+    for (int64_t i = 0; i < kNumel; ++i) {
+      const double x = in[i];
+      const double inner =
+          M_SQRT2 * M_2_SQRTPI * 0.5 * (x + 0.044715 * x * x * x);
+      EXPECT_NEAR(out[i], 0.5 * x * (1 + std::tanh(inner)), 1e-6);
+    }
+  }
+}
+
+TEST_F(VecKernelsTest, FastOpsComputePreciseDouble) {
+  std::vector<double> a = {-1.5, 0, 0.25, 3};
+  std::vector<double> out(a.size());
+  vec_unary_stub(
+      VecUnaryOp::kFastGelu,
+      exec_aten::ScalarType::Double,
+      a.data(),
+      out.data(),
+      a.size());
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_NEAR(out[i], 0.5 * a[i] * (1 + std::erf(a[i] * M_SQRT1_2)), 1e-12);
+  }
+}
+
+TEST_F(VecKernelsTest, MathAccuracyIsSetPerKernel) {
+  const MathAccuracy exp_accuracy = get_math_accuracy(MathKernel::kExp);
+  const MathAccuracy gelu_accuracy = get_math_accuracy(MathKernel::kGelu);
+
+  set_math_accuracy(MathKernel::kExp, MathAccuracy::kFast);
+  set_math_accuracy(MathKernel::kGelu, MathAccuracy::kPrecise);
+  EXPECT_EQ(get_math_accuracy(MathKernel::kExp), MathAccuracy::kFast);
+  EXPECT_EQ(get_math_accuracy(MathKernel::kGelu), MathAccuracy::kPrecise);
+
+  set_math_accuracy(MathKernel::kExp, MathAccuracy::kPrecise);
+  EXPECT_EQ(get_math_accuracy(MathKernel::kExp), MathAccuracy::kPrecise);
+
+  set_math_accuracy(MathKernel::kExp, exp_accuracy);
+  set_math_accuracy(MathKernel::kGelu, gelu_accuracy);
+}
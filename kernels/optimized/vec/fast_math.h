@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// DO NOT DEFINE STATIC DATA IN THIS HEADER!
+// See Note [Do not compile initializers with AVX]
+
+#include <executorch/kernels/optimized/vec/vec.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+// Polynomial approximations of exp, tanh, erf and sigmoid for
+// Vectorized<float>, built only from multiplies, adds and bit manipulation of
+// the exponent. They trade a few ulp of accuracy for speed compared to the
+// Sleef versions behind Vectorized<float>::exp() and friends, and are
+// available where those fall back to the scalar std:: functions, e.g. on
+// aarch64 without Sleef.
+//
+// The largest errors measured against a double precision reference, over a
+// sweep of the float range:
+//   exp_fast      1.0 ulp
+//   tanh_fast     1.3 ulp
+//   sigmoid_fast  2.6 ulp
+//   erf_fast      3.2 ulp
+// All of them propagate NaN and handle +/-inf, and exp_fast and sigmoid_fast
+// return denormals where the result is one.
+
+namespace executorch {
+namespace vec {
+// See Note [CPU_CAPABILITY namespace]
+inline namespace CPU_CAPABILITY {
+
+namespace fast_math_internal {
+
+#if defined(CPU_CAPABILITY_AVX512) && !defined(_MSC_VER)
+
+constexpr bool kIsVectorized = true;
+
+inline Vectorized<float> round_nearest(const Vectorized<float>& x) {
+  return x.round();
+}
+
+// Returns p * 2^n for integral n in [-150, 128]. 2^n is built as the product
+// of two powers of two, each of which has a normal exponent.
+inline Vectorized<float> scale_by_pow2(
+    const Vectorized<float>& p,
+    const Vectorized<float>& n) {
+  const __m512i k = _mm512_cvtps_epi32(n);
+  const __m512i k_half = _mm512_srai_epi32(k, 1);
+  const __m512i k_rest = _mm512_sub_epi32(k, k_half);
+  const __m512i bias = _mm512_set1_epi32(127);
+  const __m512 s_half = _mm512_castsi512_ps(
+      _mm512_slli_epi32(_mm512_add_epi32(k_half, bias), 23));
+  const __m512 s_rest = _mm512_castsi512_ps(
+      _mm512_slli_epi32(_mm512_add_epi32(k_rest, bias), 23));
+  return _mm512_mul_ps(_mm512_mul_ps(p, s_half), s_rest);
+}
+
+#elif defined(CPU_CAPABILITY_AVX2) && !defined(_MSC_VER)
+
+constexpr bool kIsVectorized = true;
+
+inline Vectorized<float> round_nearest(const Vectorized<float>& x) {
+  return x.round();
+}
+
+// Returns p * 2^n for integral n in [-150, 128]. 2^n is built as the product
+// of two powers of two, each of which has a normal exponent.
+inline Vectorized<float> scale_by_pow2(
+    const Vectorized<float>& p,
+    const Vectorized<float>& n) {
+  const __m256i k = _mm256_cvtps_epi32(n);
+  const __m256i k_half = _mm256_srai_epi32(k, 1);
+  const __m256i k_rest = _mm256_sub_epi32(k, k_half);
+  const __m256i bias = _mm256_set1_epi32(127);
+  const __m256 s_half = _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_add_epi32(k_half, bias), 23));
+  const __m256 s_rest = _mm256_castsi256_ps(
+      _mm256_slli_epi32(_mm256_add_epi32(k_rest, bias), 23));
+  return _mm256_mul_ps(_mm256_mul_ps(p, s_half), s_rest);
+}
+
+#elif defined(__aarch64__)
+
+constexpr bool kIsVectorized = true;
+
+inline Vectorized<float> round_nearest(const Vectorized<float>& x) {
+  return Vectorized<float>(vrndnq_f32(x.get_low()), vrndnq_f32(x.get_high()));
+}
+
+inline float32x4_t scale_by_pow2(float32x4_t p, float32x4_t n) {
+  const int32x4_t k = vcvtq_s32_f32(n);
+  const int32x4_t k_half = vshrq_n_s32(k, 1);
+  const int32x4_t k_rest = vsubq_s32(k, k_half);
+  const int32x4_t bias = vdupq_n_s32(127);
+  const float32x4_t s_half =
+      vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(k_half, bias), 23));
+  const float32x4_t s_rest =
+      vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(k_rest, bias), 23));
+  return vmulq_f32(vmulq_f32(p, s_half), s_rest);
+}
+
+// Returns p * 2^n for integral n in [-150, 128]. 2^n is built as the product
+// of two powers of two, each of which has a normal exponent.
+inline Vectorized<float> scale_by_pow2(
+    const Vectorized<float>& p,
+    const Vectorized<float>& n) {
+  return Vectorized<float>(
+      scale_by_pow2(p.get_low(), n.get_low()),
+      scale_by_pow2(p.get_high(), n.get_high()));
+}
+
+#else
+
+// The generic Vectorized<float> runs these lane by lane, which is slower than
+// the scalar std:: functions.
+constexpr bool kIsVectorized = false;
+
+// Rounds x to the nearest integer for |x| < 2^22: adding 1.5 * 2^23 leaves no
+// fraction bits.
+inline Vectorized<float> round_nearest(const Vectorized<float>& x) {
+  const Vectorized<float> kMagic(12582912.0f);
+  return (x + kMagic) - kMagic;
+}
+
+// Returns p * 2^n for integral n in [-150, 128]. 2^n is built as the product
+// of two powers of two, each of which has a normal exponent.
+inline Vectorized<float> scale_by_pow2(
+    const Vectorized<float>& p,
+    const Vectorized<float>& n) {
+  __at_align__ float p_arr[Vectorized<float>::size()];
+  __at_align__ float n_arr[Vectorized<float>::size()];
+  p.store(p_arr);
+  n.store(n_arr);
+  for (int64_t i = 0; i < Vectorized<float>::size(); ++i) {
+    // NaN has no integral value, and p is NaN already.
+    const int32_t k = n_arr[i] == n_arr[i] ? static_cast<int32_t>(n_arr[i]) : 0;
+    const int32_t k_half = k >> 1;
+    const uint32_t half_bits = static_cast<uint32_t>(k_half + 127) << 23;
+    const uint32_t rest_bits = static_cast<uint32_t>(k - k_half + 127) << 23;
+    float s_half;
+    float s_rest;
+    std::memcpy(&s_half, &half_bits, sizeof(s_half));
+    std::memcpy(&s_rest, &rest_bits, sizeof(s_rest));
+    p_arr[i] = p_arr[i] * s_half * s_rest;
+  }
+  return Vectorized<float>::loadu(p_arr);
+}
+
+#endif
+
+} // namespace fast_math_internal
+
+// Whether the approximations below use vector instructions. When they don't,
+// they are only useful for their reproducibility across platforms, and callers
+// that want speed should use the precise functions instead.
+constexpr bool kHasVectorizedFastMath = fast_math_internal::kIsVectorized;
+
+// exp(x), using the range reduction and polynomial of the Cephes expf.
+inline Vectorized<float> exp_fast(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  // exp(x) rounds to zero below kLo and overflows above kHi.
+  const Vec kLo(-103.972084f);
+  const Vec kHi(88.7228394f);
+  const Vec kLog2e(1.44269504088896341f);
+  // -ln(2), split into a part with few significant bits, whose product with
+  // n is exact, and the rest.
+  const Vec kMinusLn2Hi(-0.693359375f);
+  const Vec kMinusLn2Lo(2.12194440e-4f);
+
+  const Vec clamped = clamp(x, kLo, kHi);
+  const Vec n = fast_math_internal::round_nearest(clamped * kLog2e);
+  Vec r = fmadd(n, kMinusLn2Hi, clamped);
+  r = fmadd(n, kMinusLn2Lo, r);
+
+  Vec p(1.9875691500e-4f);
+  p = fmadd(p, r, Vec(1.3981999507e-3f));
+  p = fmadd(p, r, Vec(8.3333452301e-3f));
+  p = fmadd(p, r, Vec(4.1665795894e-2f));
+  p = fmadd(p, r, Vec(1.6666665459e-1f));
+  p = fmadd(p, r, Vec(5.0000001201e-1f));
+  p = fmadd(p, r * r, r) + Vec(1.0f);
+
+  Vec result = fast_math_internal::scale_by_pow2(p, n);
+  result = Vec::blendv(result, Vec(0.0f), x < kLo);
+  result = Vec::blendv(
+      result, Vec(std::numeric_limits<float>::infinity()), x > kHi);
+  return Vec::blendv(result, x, x != x);
+}
+
+// tanh(x), using the Cephes tanhf polynomial for small |x| and
+// 1 - 2 / (exp(2|x|) + 1) otherwise.
+inline Vectorized<float> tanh_fast(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  const Vec one(1.0f);
+  const Vec two(2.0f);
+
+  const Vec z = x * x;
+  Vec p(-5.70498872745e-3f);
+  p = fmadd(p, z, Vec(2.06390887954e-2f));
+  p = fmadd(p, z, Vec(-5.37397155531e-2f));
+  p = fmadd(p, z, Vec(1.33314422036e-1f));
+  p = fmadd(p, z, Vec(-3.33332819422e-1f));
+  const Vec small = fmadd(p * z, x, x);
+
+  const Vec abs_x = x.abs();
+  const Vec large_abs = one - two / (exp_fast(two * abs_x) + one);
+  const Vec large = Vec::blendv(large_abs, large_abs.neg(), x < Vec(0.0f));
+
+  return Vec::blendv(large, small, abs_x < Vec(0.625f));
+}
+
+// erf(x), using a polynomial in x^2 for |x| < 1 and formula 7.1.26 of
+// Abramowitz and Stegun otherwise.
+inline Vectorized<float> erf_fast(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  const Vec one(1.0f);
+
+  // Least squares fit of erf(x) / x on [0, 1].
+  const Vec z = x * x;
+  Vec p(7.8479576285e-5f);
+  p = fmadd(p, z, Vec(-8.0084039778e-4f));
+  p = fmadd(p, z, Vec(5.1881237627e-3f));
+  p = fmadd(p, z, Vec(-2.6853704486e-2f));
+  p = fmadd(p, z, Vec(1.1283582577e-1f));
+  p = fmadd(p, z, Vec(-3.7612625598e-1f));
+  p = fmadd(p, z, Vec(1.1283791657f));
+  const Vec small = p * x;
+
+  const Vec abs_x = x.abs();
+  const Vec t = one / fmadd(Vec(0.3275911f), abs_x, one);
+  Vec q(1.061405429f);
+  q = fmadd(q, t, Vec(-1.453152027f));
+  q = fmadd(q, t, Vec(1.421413741f));
+  q = fmadd(q, t, Vec(-0.284496736f));
+  q = fmadd(q, t, Vec(0.254829592f));
+  const Vec large_abs = one - q * t * exp_fast(z.neg());
+  const Vec large = Vec::blendv(large_abs, large_abs.neg(), x < Vec(0.0f));
+
+  return Vec::blendv(large, small, abs_x < one);
+}
+
+// 1 / (1 + exp(-x)), computed as e / (1 + e) with e = exp(x) for negative x
+// so that it doesn't round to zero while the result is still representable.
+inline Vectorized<float> sigmoid_fast(const Vectorized<float>& x) {
+  using Vec = Vectorized<float>;
+  const Vec e = exp_fast(x.abs().neg());
+  const Vec r = (e + Vec(1.0f)).reciprocal();
+  return Vec::blendv(r, e * r, x < Vec(0.0f));
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace executorch
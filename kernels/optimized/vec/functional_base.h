@@ -13,6 +13,8 @@
 
 #include <executorch/kernels/optimized/vec/vec.h>
 
+#include <algorithm>
+
 namespace executorch {
 namespace vec {
 
@@ -325,6 +327,47 @@ inline void map4(
   }
 }
 
+// The number of elements map_reduced_float() and map2_reduced_float() widen
+// at a time. Their float buffers stay in L1.
+constexpr int64_t kReducedFloatBlockSize = 512;
+
+// map() for Half and BFloat16 data: widens blocks of the input to float with
+// convert(), applies vec_fun to Vectorized<float>, and rounds the results back
+// once.
+template <typename scalar_t, typename Op>
+inline void map_reduced_float(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    int64_t size) {
+  __at_align__ float buffer[kReducedFloatBlockSize];
+  for (int64_t d = 0; d < size; d += kReducedFloatBlockSize) {
+    const int64_t n = std::min(kReducedFloatBlockSize, size - d);
+    convert(input_data + d, buffer, n);
+    map<float>(vec_fun, buffer, buffer, n);
+    convert(buffer, output_data + d, n);
+  }
+}
+
+// map2() for Half and BFloat16 data. See map_reduced_float().
+template <typename scalar_t, typename Op>
+inline void map2_reduced_float(
+    const Op& vec_fun,
+    scalar_t* output_data,
+    const scalar_t* input_data,
+    const scalar_t* input_data2,
+    int64_t size) {
+  __at_align__ float buffer[kReducedFloatBlockSize];
+  __at_align__ float buffer2[kReducedFloatBlockSize];
+  for (int64_t d = 0; d < size; d += kReducedFloatBlockSize) {
+    const int64_t n = std::min(kReducedFloatBlockSize, size - d);
+    convert(input_data + d, buffer, n);
+    convert(input_data2 + d, buffer2, n);
+    map2<float>(vec_fun, buffer, buffer, buffer2, n);
+    convert(buffer, output_data + d, n);
+  }
+}
+
 
 // This function implements broadcasting binary operation on two tensors
 // where lhs tensor is treated to be of shape [outer_size, broadcast_size, inner_size]
@@ -8,7 +8,13 @@
 
 #pragma once
 
+#if defined(CPU_CAPABILITY_AVX512)
+#include <executorch/kernels/optimized/vec/vec512/vec512.h>
+#else
 #include <executorch/kernels/optimized/vec/vec256/vec256.h>
+#endif
+
+#include <executorch/kernels/optimized/vec/vec_half.h>
 
 namespace executorch {
 namespace vec {
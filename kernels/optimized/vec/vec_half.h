@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Bulk conversions between float and the reduced floating point types, so
+// that kernels can widen Half and BFloat16 data a block at a time and compute
+// on Vectorized<float>, instead of converting element by element in software.
+// Also maps Half data with native fp16 arithmetic where the target has it.
+//
+// The x86 paths depend on the instruction sets the translation unit is
+// compiled for (F16C, AVX2, AVX-512F) rather than on CPU_CAPABILITY, so that
+// libraries built without the vec dispatch flags, like cpublas, use them too.
+
+#include <executorch/kernels/optimized/vec/intrinsics.h>
+#include <executorch/kernels/optimized/vec/vec_base.h>
+#include <executorch/runtime/core/portable_type/bfloat16.h>
+#include <executorch/runtime/core/portable_type/half.h>
+
+#if defined(__F16C__) || defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+// Whether float16x8_t arithmetic (ARMv8.2-A FP16) is available. Rounding once
+// to fp16 after an exact product or sum matches computing in float and
+// rounding the result, so kernels may use it for single operations.
+#if defined(__aarch64__) && defined(__ARM_FEATURE_FP16_VECTOR_ARITHMETIC)
+#define ET_VEC_NATIVE_FP16_ARITHMETIC 1
+#endif
+
+namespace executorch {
+namespace vec {
+
+// See Note [CPU_CAPABILITY namespace]
+inline namespace CPU_CAPABILITY {
+
+using ::executorch::runtime::etensor::BFloat16;
+using ::executorch::runtime::etensor::Half;
+
+template <>
+inline void convert(const Half* src, float* dst, int64_t n) {
+  int64_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m256i h =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(h));
+  }
+#endif
+#if defined(__F16C__)
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+#elif defined(__aarch64__)
+  for (; i + 8 <= n; i += 8) {
+    float16x8_t h = vld1q_f16(reinterpret_cast<const float16_t*>(src + i));
+    vst1q_f32(dst + i, vcvt_f32_f16(vget_low_f16(h)));
+    vst1q_f32(dst + i + 4, vcvt_high_f32_f16(h));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, Half* dst, int64_t n) {
+  int64_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m256i h = _mm512_cvtps_ph(
+        _mm512_loadu_ps(src + i),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), h);
+  }
+#endif
+#if defined(__F16C__)
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm256_cvtps_ph(
+        _mm256_loadu_ps(src + i),
+        _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+  }
+#elif defined(__aarch64__)
+  for (; i + 8 <= n; i += 8) {
+    float16x8_t h = vcvt_high_f16_f32(
+        vcvt_f16_f32(vld1q_f32(src + i)), vld1q_f32(src + i + 4));
+    vst1q_f16(reinterpret_cast<float16_t*>(dst + i), h);
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = static_cast<Half>(src[i]);
+  }
+}
+
+// BFloat16 is the upper half of a float, so widening is a shift. Narrowing
+// rounds to nearest even and maps NaNs to 0x7FC0, as
+// internal::round_to_nearest_even() does.
+
+template <>
+inline void convert(const BFloat16* src, float* dst, int64_t n) {
+  int64_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m512i w = _mm512_cvtepu16_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)));
+    _mm512_storeu_ps(
+        dst + i, _mm512_castsi512_ps(_mm512_slli_epi32(w, 16)));
+  }
+#endif
+#if defined(__AVX2__)
+  for (; i + 8 <= n; i += 8) {
+    __m256i w = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(
+        dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(w, 16)));
+  }
+#elif defined(__aarch64__)
+  for (; i + 8 <= n; i += 8) {
+    uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+    vst1q_f32(
+        dst + i, vreinterpretq_f32_u32(vshll_n_u16(vget_low_u16(b), 16)));
+    vst1q_f32(dst + i + 4, vreinterpretq_f32_u32(vshll_high_n_u16(b, 16)));
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+namespace internal {
+#if defined(__AVX512F__)
+inline __m256i bf16_round_to_nearest_even(__m512 v) {
+  const __m512i bits = _mm512_castps_si512(v);
+  const __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+  __m512i rounded = _mm512_add_epi32(
+      bits, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF)));
+  const __mmask16 is_nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+  rounded =
+      _mm512_mask_mov_epi32(rounded, is_nan, _mm512_set1_epi32(0x7FC00000));
+  return _mm512_cvtepi32_epi16(_mm512_srli_epi32(rounded, 16));
+}
+#endif
+#if defined(__AVX2__)
+inline __m128i bf16_round_to_nearest_even(__m256 v) {
+  const __m256i bits = _mm256_castps_si256(v);
+  const __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+  __m256i rounded = _mm256_add_epi32(
+      bits, _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF)));
+  const __m256i is_nan =
+      _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+  rounded =
+      _mm256_blendv_epi8(rounded, _mm256_set1_epi32(0x7FC00000), is_nan);
+  rounded = _mm256_srli_epi32(rounded, 16);
+  // packus works within 128-bit lanes; gather the two lanes' results into the
+  // low half.
+  const __m256i packed = _mm256_permute4x64_epi64(
+      _mm256_packus_epi32(rounded, rounded), 0xD8);
+  return _mm256_castsi256_si128(packed);
+}
+#elif defined(__aarch64__)
+inline uint16x4_t bf16_round_to_nearest_even(float32x4_t v) {
+  const uint32x4_t bits = vreinterpretq_u32_f32(v);
+  const uint32x4_t lsb = vandq_u32(vshrq_n_u32(bits, 16), vdupq_n_u32(1));
+  uint32x4_t rounded = vaddq_u32(bits, vaddq_u32(lsb, vdupq_n_u32(0x7FFF)));
+  rounded = vbslq_u32(vceqq_f32(v, v), rounded, vdupq_n_u32(0x7FC00000));
+  return vshrn_n_u32(rounded, 16);
+}
+#endif
+} // namespace internal
+
+template <>
+inline void convert(const float* src, BFloat16* dst, int64_t n) {
+  int64_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(dst + i),
+        internal::bf16_round_to_nearest_even(_mm512_loadu_ps(src + i)));
+  }
+#endif
+#if defined(__AVX2__)
+  for (; i + 8 <= n; i += 8) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i),
+        internal::bf16_round_to_nearest_even(_mm256_loadu_ps(src + i)));
+  }
+#elif defined(__aarch64__)
+  for (; i + 8 <= n; i += 8) {
+    uint16x8_t b = vcombine_u16(
+        internal::bf16_round_to_nearest_even(vld1q_f32(src + i)),
+        internal::bf16_round_to_nearest_even(vld1q_f32(src + i + 4)));
+    vst1q_u16(reinterpret_cast<uint16_t*>(dst + i), b);
+  }
+#endif
+  for (; i < n; ++i) {
+    dst[i] = static_cast<BFloat16>(src[i]);
+  }
+}
+
+#ifdef ET_VEC_NATIVE_FP16_ARITHMETIC
+// map2() over Half data with float16x8_t arithmetic. Only use it for ops whose
+// results must match computing in float; see ET_VEC_NATIVE_FP16_ARITHMETIC.
+template <typename Op>
+inline void map2_fp16(
+    const Op& vec_fun,
+    Half* output_data,
+    const Half* input_data,
+    const Half* input_data2,
+    int64_t size) {
+  auto* out = reinterpret_cast<float16_t*>(output_data);
+  const auto* in = reinterpret_cast<const float16_t*>(input_data);
+  const auto* in2 = reinterpret_cast<const float16_t*>(input_data2);
+  int64_t d = 0;
+  for (; d + 8 <= size; d += 8) {
+    vst1q_f16(out + d, vec_fun(vld1q_f16(in + d), vld1q_f16(in2 + d)));
+  }
+  if (d < size) {
+    float16_t buffer[8] = {};
+    float16_t buffer2[8] = {};
+    std::memcpy(buffer, in + d, (size - d) * sizeof(float16_t));
+    std::memcpy(buffer2, in2 + d, (size - d) * sizeof(float16_t));
+    vst1q_f16(buffer, vec_fun(vld1q_f16(buffer), vld1q_f16(buffer2)));
+    std::memcpy(out + d, buffer, (size - d) * sizeof(float16_t));
+  }
+}
+#endif // ET_VEC_NATIVE_FP16_ARITHMETIC
+
+} // namespace CPU_CAPABILITY
+
+} // namespace vec
+} // namespace executorch
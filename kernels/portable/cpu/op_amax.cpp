@@ -45,14 +45,20 @@ Tensor& amax_out(
   ET_SWITCH_REAL_TYPES_AND(
       Bool, in.scalar_type(), ctx, "amax.out", CTYPE, [&]() {
         CTYPE* out_data = out.mutable_data_ptr<CTYPE>();
+        const auto reduce_fun = [](CTYPE v, CTYPE max_v) {
+          return std::isnan(v) || v > max_v ? v : max_v;
+        };
+        if (map_reduce_over_contiguous_dim_list<CTYPE, CTYPE>(
+                [](CTYPE v) { return v; },
+                reduce_fun,
+                in,
+                dim_list,
+                out_data)) {
+          return;
+        }
         for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
-          out_data[out_ix] = reduce_over_dim_list<CTYPE>(
-              [](CTYPE v, CTYPE max_v) {
-                return std::isnan(v) || v > max_v ? v : max_v;
-              },
-              in,
-              dim_list,
-              out_ix);
+          out_data[out_ix] =
+              reduce_over_dim_list<CTYPE>(reduce_fun, in, dim_list, out_ix);
         }
       });
 
@@ -18,6 +18,16 @@ namespace native {
 
 using Tensor = exec_aten::Tensor;
 
+namespace {
+// Whether copying `src` into `dst` would write every element onto itself, as
+// when the write-back of a mutable buffer finds that the update was already
+// done in place. Stateful models then don't move the whole buffer every step.
+bool is_copy_onto_itself(const Tensor& src, const Tensor& dst) {
+  return src.const_data_ptr() == dst.const_data_ptr() &&
+      src.scalar_type() == dst.scalar_type() && src.numel() == dst.numel();
+}
+} // namespace
+
 // copy.out(const Tensor& in, const Tensor& src, bool non_blocking, Tensor(a!)
 // out) -> Tensor(a!), see caffe2/aten/src/ATen/native/Copy.cpp
 // TODO: We actually shouldn't see this op with the proper functionalization,
@@ -43,6 +53,10 @@ Tensor& copy_out(
   ET_KERNEL_CHECK(
       ctx, tensors_have_same_dim_order(in, out), InvalidArgument, out);
 
+  if (is_copy_onto_itself(src, out)) {
+    return out;
+  }
+
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "copy.out";
 
@@ -76,6 +90,10 @@ Tensor& copy_(
   ET_KERNEL_CHECK(
       ctx, tensors_have_same_dim_order(in, src), InvalidArgument, in);
 
+  if (is_copy_onto_itself(src, in)) {
+    return in;
+  }
+
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   static constexpr const char op_name[] = "copy_";
 
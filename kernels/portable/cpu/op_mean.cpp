@@ -48,15 +48,22 @@ Tensor& mean_dim_out(
     ET_SWITCH_FLOATH_TYPES(out.scalar_type(), ctx, "mean.out", CTYPE_OUT, [&] {
       CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
       const size_t num = get_reduced_dim_product(in, dim_list);
+      const auto map_fun = [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); };
+      const auto reduce_fun = [](CTYPE_OUT outv, CTYPE_OUT acc) {
+        return acc + outv;
+      };
+      if (map_reduce_over_contiguous_dim_list<CTYPE_IN, CTYPE_OUT>(
+              map_fun, reduce_fun, in, dim_list, out_data)) {
+        for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
+          out_data[out_ix] = out_data[out_ix] / static_cast<float>(num);
+        }
+        return;
+      }
       for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
         CTYPE_OUT sum = 0;
         if (in.numel() > 0) {
           sum = map_reduce_over_dim_list<CTYPE_IN, CTYPE_OUT>(
-              [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); },
-              [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
-              in,
-              dim_list,
-              out_ix);
+              map_fun, reduce_fun, in, dim_list, out_ix);
         }
         out_data[out_ix] = sum / static_cast<float>(num);
       }
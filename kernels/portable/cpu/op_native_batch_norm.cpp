@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <tuple>
 
@@ -21,6 +22,53 @@ namespace native {
 using Tensor = exec_aten::Tensor;
 using SizesType = exec_aten::SizesType;
 
+namespace {
+
+/**
+ * Normalizes channels last data, where the channels are the innermost dim in
+ * memory. Works through blocks of channels so that their parameters stay on
+ * the stack while all the pixels stream through. `stats(c)` returns the mean
+ * and the inverse standard deviation of channel `c`.
+ */
+template <typename CTYPE, typename StatsFn>
+void batch_norm_channels_last(
+    const CTYPE* in_data,
+    CTYPE* out_data,
+    size_t num_pixels,
+    size_t C,
+    const StatsFn& stats,
+    const exec_aten::optional<Tensor>& weight,
+    const exec_aten::optional<Tensor>& bias) {
+  constexpr size_t kBlockSize = 64;
+  CTYPE mean[kBlockSize];
+  CTYPE invstd[kBlockSize];
+  CTYPE weight_val[kBlockSize];
+  CTYPE bias_val[kBlockSize];
+  for (size_t c0 = 0; c0 < C; c0 += kBlockSize) {
+    const size_t block_size = std::min(kBlockSize, C - c0);
+    for (size_t c = 0; c < block_size; ++c) {
+      std::tie(mean[c], invstd[c]) = stats(c0 + c);
+      weight_val[c] = 1;
+      if (weight.has_value()) {
+        weight_val[c] = weight.value().const_data_ptr<CTYPE>()[c0 + c];
+      }
+      bias_val[c] = 0;
+      if (bias.has_value()) {
+        bias_val[c] = bias.value().const_data_ptr<CTYPE>()[c0 + c];
+      }
+    }
+    for (size_t p = 0; p < num_pixels; ++p) {
+      const CTYPE* x = in_data + p * C + c0;
+      CTYPE* y = out_data + p * C + c0;
+      for (size_t c = 0; c < block_size; ++c) {
+        y[c] = (x[c] - mean[c]) * invstd[c] * weight_val[c] + bias_val[c];
+      }
+    }
+  }
+}
+
+} // namespace
+
 std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
     KernelRuntimeContext& ctx,
     const Tensor& in,
@@ -68,39 +116,23 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
       InvalidArgument,
       ret_val);
 
-  // For now, only support the contiguous dim order
+  // The parameter and stats tensors are 1-D, so only the layout of in and out
+  // matters.
   ET_KERNEL_CHECK(
       ctx,
-      is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
+      tensor_is_default_or_channels_last_dim_order(in),
       InvalidArgument,
       ret_val);
 
   ET_KERNEL_CHECK(
-      ctx,
-      tensors_have_same_dim_order(in, out, mean_out, invstd_out),
-      InvalidArgument,
-      ret_val);
-
-  if (weight.has_value()) {
-    ET_KERNEL_CHECK(
-        ctx,
-        tensors_have_same_dim_order(in, weight.value()),
-        InvalidArgument,
-        ret_val);
-  }
-
-  if (bias.has_value()) {
-    ET_KERNEL_CHECK(
-        ctx,
-        tensors_have_same_dim_order(in, bias.value()),
-        InvalidArgument,
-        ret_val);
-  }
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, ret_val);
 
   size_t C_dim = in.dim() >= 1 ? 1 : 0;
   size_t C = in.size(C_dim);
   size_t outer = getLeadingDims(in, C_dim);
   size_t inner = getTrailingDims(in, C_dim);
+  const bool channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim());
 
   constexpr auto name = "native_batch_norm_legit_no_training.out";
 
@@ -111,6 +143,22 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_training_out(
     const CTYPE* const mean_data = running_mean.const_data_ptr<CTYPE>();
     const CTYPE* const var_data = running_var.const_data_ptr<CTYPE>();
 
+    if (channels_last) {
+      batch_norm_channels_last<CTYPE>(
+          in_data,
+          out_data,
+          outer * inner,
+          C,
+          [&](size_t c) {
+            return std::make_tuple(
+                mean_data[c],
+                static_cast<CTYPE>(1.0 / std::sqrt(var_data[c] + eps)));
+          },
+          weight,
+          bias);
+      return;
+    }
+
     for (size_t i = 0; i < outer; ++i) {
       for (size_t c = 0; c < C; ++c) {
         CTYPE mean = mean_data[c];
@@ -206,33 +254,16 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_stats_out(
       InvalidArgument,
       ret_val);
 
+  // The parameter and stats tensors are 1-D, so only the layout of in and out
+  // matters.
   ET_KERNEL_CHECK(
       ctx,
-      is_contiguous_dim_order(in.dim_order().data(), in.dim_order().size()),
+      tensor_is_default_or_channels_last_dim_order(in),
       InvalidArgument,
       ret_val);
 
   ET_KERNEL_CHECK(
-      ctx,
-      tensors_have_same_dim_order(in, out, mean_out, invstd_out),
-      InvalidArgument,
-      ret_val);
-
-  if (weight.has_value()) {
-    ET_KERNEL_CHECK(
-        ctx,
-        tensors_have_same_dim_order(in, weight.value()),
-        InvalidArgument,
-        ret_val);
-  }
-
-  if (bias.has_value()) {
-    ET_KERNEL_CHECK(
-        ctx,
-        tensors_have_same_dim_order(in, bias.value()),
-        InvalidArgument,
-        ret_val);
-  }
+      ctx, tensors_have_same_dim_order(in, out), InvalidArgument, ret_val);
 
   ET_KERNEL_CHECK(ctx, in.dim() >= 2, InvalidArgument, ret_val);
 
@@ -240,6 +271,8 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_stats_out(
   size_t C = in.size(1);
   size_t inner = getTrailingDims(in, 1);
   size_t elements_per_channel = N * inner;
+  const bool channels_last =
+      is_channels_last_dim_order(in.dim_order().data(), in.dim());
 
   ET_KERNEL_CHECK(
       ctx,
@@ -268,16 +301,26 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_stats_out(
     CTYPE* invstd_data = invstd_out.mutable_data_ptr<CTYPE>();
 
     // Compute sum and sum of squares for each channel
-    for (size_t b = 0; b < N; ++b) {
-      const CTYPE* b_in_data = in_data + b * C * inner;
-      for (size_t c = 0; c < C; ++c) {
-        const CTYPE* x = b_in_data + c * inner;
+    if (channels_last) {
+      for (size_t p = 0; p < elements_per_channel; ++p) {
+        const CTYPE* x = in_data + p * C;
+        for (size_t c = 0; c < C; ++c) {
+          mean_data[c] += x[c];
+          invstd_data[c] += x[c] * x[c];
+        }
+      }
+    } else {
+      for (size_t b = 0; b < N; ++b) {
+        const CTYPE* b_in_data = in_data + b * C * inner;
+        for (size_t c = 0; c < C; ++c) {
+          const CTYPE* x = b_in_data + c * inner;
 
-        CTYPE sum = reduce_add(x, inner);
-        CTYPE sq_sum = vec_powerf(x, inner);
+          CTYPE sum = reduce_add(x, inner);
+          CTYPE sq_sum = vec_powerf(x, inner);
 
-        mean_data[c] += sum;
-        invstd_data[c] += sq_sum;
+          mean_data[c] += sum;
+          invstd_data[c] += sq_sum;
+        }
       }
     }
 
@@ -291,6 +334,20 @@ std::tuple<Tensor&, Tensor&, Tensor&> _native_batch_norm_legit_no_stats_out(
       invstd_data[c] = invstd;
     }
 
+    if (channels_last) {
+      batch_norm_channels_last<CTYPE>(
+          in_data,
+          out_data,
+          elements_per_channel,
+          C,
+          [&](size_t c) {
+            return std::make_tuple(mean_data[c], invstd_data[c]);
+          },
+          weight,
+          bias);
+      return;
+    }
+
     for (size_t i = 0; i < N; ++i) {
       for (size_t c = 0; c < C; ++c) {
         CTYPE mean = mean_data[c];
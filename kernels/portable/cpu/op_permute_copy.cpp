@@ -7,6 +7,7 @@
  */
 
 #include <executorch/kernels/portable/cpu/util/copy_ops_util.h>
+#include <executorch/kernels/portable/cpu/util/transpose_util.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
 namespace torch {
@@ -14,28 +15,10 @@ namespace executor {
 namespace native {
 
 using SizesType = exec_aten::SizesType;
+using StridesType = exec_aten::StridesType;
 using Tensor = exec_aten::Tensor;
 using IntArrayRef = exec_aten::ArrayRef<int64_t>;
 
-namespace {
-
-void increment_coordinate_permuted(
-    const Tensor& tensor,
-    size_t* const coordinate,
-    IntArrayRef dims) {
-  for (int i = dims.size() - 1; i >= 0; i--) {
-    size_t d = dims[i] >= 0 ? dims[i] : dims[i] + tensor.dim();
-    coordinate[d]++;
-    if (coordinate[d] == tensor.size(d)) {
-      coordinate[d] = 0;
-    } else {
-      return;
-    }
-  }
-}
-
-} // namespace
-
 Tensor& permute_copy_out(
     KernelRuntimeContext& ctx,
     const Tensor& in,
@@ -59,23 +42,26 @@ Tensor& permute_copy_out(
       InvalidArgument,
       out);
 
-  const auto in_type = out.scalar_type();
+  // Reading the input through the permuted sizes and strides visits its
+  // elements in the order of the output.
+  StridesType permuted_strides[kTensorDimensionLimit];
+  SizesType permuted_sizes[kTensorDimensionLimit];
+  for (size_t i = 0; i < dims.size(); ++i) {
+    const size_t d = dims[i] >= 0 ? dims[i] : dims[i] + in.dim();
+    permuted_sizes[i] = in.size(d);
+    permuted_strides[i] = in.strides()[d];
+  }
 
-  size_t in_coord[kTensorDimensionLimit] = {0};
-  size_t trailing_dims_memo[kTensorDimensionLimit];
-  executorch::runtime::memoizeTrailingDims(in, trailing_dims_memo);
+  const auto in_type = out.scalar_type();
 
   // in and out must be the same dtype
   ET_SWITCH_ALL_TYPES(in_type, ctx, "permute_copy.out", CTYPE, [&] {
-    const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
-    CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
-
-    for (size_t i = 0; i < out.numel(); ++i) {
-      out_data[i] =
-          in_data[executorch::runtime::coordinateToIndexWithTrailingDimsMemo(
-              in, in_coord, trailing_dims_memo)];
-      increment_coordinate_permuted(in, in_coord, dims);
-    }
+    strided_copy(
+        in.const_data_ptr<CTYPE>(),
+        permuted_sizes,
+        permuted_strides,
+        dims.size(),
+        out.mutable_data_ptr<CTYPE>());
   });
 
   return out;
@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include <executorch/kernels/portable/cpu/util/activation_ops_util.h>
@@ -19,6 +20,64 @@ namespace native {
 
 using Tensor = exec_aten::Tensor;
 
+namespace {
+
+/**
+ * Computes softmax over a dimension with a stride larger than 1, by
+ * processing blocks of adjacent softmax slices together so that every inner
+ * loop reads and writes contiguous memory, instead of walking each slice with
+ * the stride of the dimension. Each slice is reduced in the same order as
+ * apply_over_dim() would, so the results are identical.
+ */
+template <typename CTYPE>
+void softmax_over_strided_dim(
+    const CTYPE* const in_data,
+    CTYPE* const out_data,
+    const size_t outer_size,
+    const size_t size,
+    const size_t stride) {
+  constexpr size_t kBlockSize = 64;
+  CTYPE max_in[kBlockSize];
+  CTYPE temp_sum[kBlockSize];
+  for (size_t outer_idx = 0; outer_idx < outer_size; ++outer_idx) {
+    const size_t outer = outer_idx * size * stride;
+    for (size_t inner_begin = 0; inner_begin < stride;
+         inner_begin += kBlockSize) {
+      const size_t block = std::min(kBlockSize, stride - inner_begin);
+      const CTYPE* const in_block = in_data + outer + inner_begin;
+      CTYPE* const out_block = out_data + outer + inner_begin;
+
+      for (size_t j = 0; j < block; ++j) {
+        max_in[j] = in_block[j];
+      }
+      for (size_t i = 1; i < size; ++i) {
+        for (size_t j = 0; j < block; ++j) {
+          max_in[j] = std::max(in_block[i * stride + j], max_in[j]);
+        }
+      }
+
+      for (size_t j = 0; j < block; ++j) {
+        temp_sum[j] = 0;
+      }
+      for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < block; ++j) {
+          const CTYPE e = std::exp(in_block[i * stride + j] - max_in[j]);
+          temp_sum[j] = temp_sum[j] + e;
+        }
+      }
+
+      for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < block; ++j) {
+          out_block[i * stride + j] =
+              std::exp(in_block[i * stride + j] - max_in[j]) / temp_sum[j];
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
 Tensor& softmax_out(
     KernelRuntimeContext& ctx,
     const Tensor& in,
@@ -46,6 +105,16 @@ Tensor& softmax_out(
     const CTYPE* const in_data = in.const_data_ptr<CTYPE>();
     CTYPE* const out_data = out.mutable_data_ptr<CTYPE>();
 
+    if (in.dim() > 0 && in.numel() > 0 && in.strides()[dim] > 1) {
+      softmax_over_strided_dim(
+          in_data,
+          out_data,
+          getLeadingDims(in, dim),
+          in.size(dim),
+          in.strides()[dim]);
+      return;
+    }
+
     apply_over_dim(
         [in_data, out_data](
             const size_t size, const size_t stride, const size_t base) {
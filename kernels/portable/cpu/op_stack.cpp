@@ -55,6 +55,30 @@ Tensor& stack_out(
   const size_t ninputs = tensors.size();
 
   const auto out_type = out.scalar_type();
+
+  // Without dtype conversions, each block of each input is a single memcpy.
+  bool all_same_dtype = true;
+  for (size_t j = 0; j < ninputs; ++j) {
+    if (tensors[j].scalar_type() != out_type) {
+      all_same_dtype = false;
+      break;
+    }
+  }
+  if (all_same_dtype) {
+    ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "stack.out", CTYPE, [&] {
+      CTYPE* out_ptr = out.mutable_data_ptr<CTYPE>();
+      for (size_t i = 0; i < outer; ++i) {
+        for (size_t j = 0; j < ninputs; ++j) {
+          const CTYPE* const in_ptr =
+              tensors[j].const_data_ptr<CTYPE>() + i * inner;
+          std::memcpy(out_ptr, in_ptr, inner * sizeof(CTYPE));
+          out_ptr += inner;
+        }
+      }
+    });
+    return out;
+  }
+
   ET_SWITCH_REAL_TYPES_AND(Bool, out_type, ctx, "stack.out", CTYPE_OUT, [&] {
     CTYPE_OUT* out_ptr = out.mutable_data_ptr<CTYPE_OUT>();
     for (size_t i = 0; i < outer; ++i) {
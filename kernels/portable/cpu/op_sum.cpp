@@ -48,15 +48,21 @@ Tensor& sum_dim_out(
         ET_SWITCH_REAL_TYPES_AND(
             Bool, out.scalar_type(), ctx, "sum.IntList_out", CTYPE_OUT, [&] {
               CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
+              const auto map_fun = [](CTYPE_IN v) {
+                return static_cast<CTYPE_OUT>(v);
+              };
+              const auto reduce_fun = [](CTYPE_OUT outv, CTYPE_OUT acc) {
+                return acc + outv;
+              };
+              if (map_reduce_over_contiguous_dim_list<CTYPE_IN, CTYPE_OUT>(
+                      map_fun, reduce_fun, in, dim_list, out_data)) {
+                return;
+              }
               for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
                 CTYPE_OUT sum = 0;
                 if (in.numel() > 0) {
                   sum = map_reduce_over_dim_list<CTYPE_IN, CTYPE_OUT>(
-                      [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); },
-                      [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
-                      in,
-                      dim_list,
-                      out_ix);
+                      map_fun, reduce_fun, in, dim_list, out_ix);
                 }
                 out_data[out_ix] = sum;
               }
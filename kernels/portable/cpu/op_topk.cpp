@@ -6,6 +6,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <tuple>
 
@@ -50,6 +51,98 @@ bool get_topk_target_size(
   return true;
 }
 
+// The heap-based selection is used when k is small relative to the size of
+// the reduced dim. It only needs temp memory for k elements.
+bool use_heap_select(int64_t k, size_t dim_size) {
+  return k * 64 <= dim_size;
+}
+
+// Contiguous rows are scanned in blocks of this size, and a block is skipped
+// when none of its elements beats the current k-th best value.
+constexpr size_t kSelectBlockSize = 16;
+
+/**
+ * Returns true if `x` should be ranked before `y`. NaN is treated as larger
+ * than every other value. The expression is branch-free so that the blocked
+ * pre-filter in heap_select_topk() can be vectorized.
+ */
+template <bool kLargest, typename CTYPE>
+inline bool ranks_before(const CTYPE& x, const CTYPE& y) {
+  const bool x_nan = x != x;
+  const bool y_nan = y != y;
+  if (kLargest) {
+    return (x_nan & !y_nan) | (x > y);
+  } else {
+    return (!x_nan & y_nan) | (x < y);
+  }
+}
+
+/**
+ * Selects the k best of the dim_size values that start at `in_data` with the
+ * given stride, and writes them to `values_data` and `indices_data` in ranked
+ * order. Ties are broken in favor of the lower index.
+ *
+ * `heap` holds the k best elements seen so far with the worst one at the
+ * front, so most elements only need to be compared against heap[0].
+ */
+template <bool kLargest, typename CTYPE, typename elem_t>
+void heap_select_topk(
+    const CTYPE* in_data,
+    size_t dim_size,
+    size_t dim_stride,
+    int64_t k,
+    CTYPE* values_data,
+    long* indices_data,
+    elem_t* heap) {
+  const auto elem_ranks_before = [](const elem_t& x, const elem_t& y) {
+    return ranks_before<kLargest>(x.first, y.first) ||
+        (!ranks_before<kLargest>(y.first, x.first) && x.second < y.second);
+  };
+
+  for (int64_t i = 0; i < k; ++i) {
+    heap[i].first = in_data[i * dim_stride];
+    heap[i].second = i;
+  }
+  std::make_heap(heap, heap + k, elem_ranks_before);
+
+  // Later elements have larger indices, so they only replace the current
+  // worst element if their value ranks strictly before it.
+  const auto push = [&](size_t i) {
+    const CTYPE x = in_data[i * dim_stride];
+    if (ranks_before<kLargest>(x, heap[0].first)) {
+      std::pop_heap(heap, heap + k, elem_ranks_before);
+      heap[k - 1].first = x;
+      heap[k - 1].second = i;
+      std::push_heap(heap, heap + k, elem_ranks_before);
+    }
+  };
+
+  size_t i = k;
+  if (dim_stride == 1) {
+    for (; i + kSelectBlockSize <= dim_size; i += kSelectBlockSize) {
+      const CTYPE threshold = heap[0].first;
+      bool any = false;
+      for (size_t j = 0; j < kSelectBlockSize; ++j) {
+        any |= ranks_before<kLargest>(in_data[i + j], threshold);
+      }
+      if (any) {
+        for (size_t j = 0; j < kSelectBlockSize; ++j) {
+          push(i + j);
+        }
+      }
+    }
+  }
+  for (; i < dim_size; ++i) {
+    push(i);
+  }
+
+  std::sort_heap(heap, heap + k, elem_ranks_before);
+  for (int64_t j = 0; j < k; ++j) {
+    values_data[j * dim_stride] = heap[j].first;
+    indices_data[j * dim_stride] = heap[j].second;
+  }
+}
+
 template <typename CTYPE, typename elem_t = std::pair<CTYPE, int64_t>>
 void perform_topk(
     const Tensor& in,
@@ -82,7 +175,7 @@ void perform_topk(
   const size_t outer_stride_in = dim_size * dim_stride;
   const size_t outer_stride_out = k * dim_stride;
 
-  bool use_partial_sort = k * 64 <= dim_size;
+  const bool use_heap = use_heap_select(k, dim_size);
 
   // Loop through all outer dimensions
   for (size_t outer_idx = 0; outer_idx < outer_size; ++outer_idx) {
@@ -93,6 +186,29 @@ void perform_topk(
       size_t base_in = outer_in + inner_idx;
       size_t base_out = outer_out + inner_idx;
 
+      if (use_heap) {
+        if (largest) {
+          heap_select_topk<true>(
+              in_data + base_in,
+              dim_size,
+              dim_stride,
+              k,
+              values_data + base_out,
+              indices_data + base_out,
+              queue);
+        } else {
+          heap_select_topk<false>(
+              in_data + base_in,
+              dim_size,
+              dim_stride,
+              k,
+              values_data + base_out,
+              indices_data + base_out,
+              queue);
+        }
+        continue;
+      }
+
       // Populate the queue with the values from the input tensor
       for (size_t i = 0; i < dim_size; ++i) {
         size_t in_ix = base_in + i * dim_stride;
@@ -101,69 +217,45 @@ void perform_topk(
       }
 
       // Perform topk on the queue
-      if (use_partial_sort) {
-        if (largest) {
-          std::partial_sort(
+      if (largest) {
+        std::nth_element(
+            queue,
+            queue + k - 1,
+            queue + dim_size,
+            [](const elem_t& x, const elem_t& y) -> bool {
+              return (
+                  (std::isnan(x.first) && !std::isnan(y.first)) ||
+                  (x.first > y.first));
+            });
+        if (sorted) {
+          std::sort(
               queue,
-              queue + k,
-              queue + dim_size,
+              queue + k - 1,
               [](const elem_t& x, const elem_t& y) -> bool {
                 return (
                     (std::isnan(x.first) && !std::isnan(y.first)) ||
                     (x.first > y.first));
               });
-        } else {
-          std::partial_sort(
-              queue,
-              queue + k,
-              queue + dim_size,
-              [](const elem_t& x, const elem_t& y) -> bool {
-                return (
-                    (!std::isnan(x.first) && std::isnan(y.first)) ||
-                    (x.first < y.first));
-              });
         }
       } else {
-        if (largest) {
-          std::nth_element(
-              queue,
-              queue + k - 1,
-              queue + dim_size,
-              [](const elem_t& x, const elem_t& y) -> bool {
-                return (
-                    (std::isnan(x.first) && !std::isnan(y.first)) ||
-                    (x.first > y.first));
-              });
-          if (sorted) {
-            std::sort(
-                queue,
-                queue + k - 1,
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return (
-                      (std::isnan(x.first) && !std::isnan(y.first)) ||
-                      (x.first > y.first));
-                });
-          }
-        } else {
-          std::nth_element(
+        std::nth_element(
+            queue,
+            queue + k - 1,
+            queue + dim_size,
+            [](const elem_t& x, const elem_t& y) -> bool {
+              return (
+                  (!std::isnan(x.first) && std::isnan(y.first)) ||
+                  (x.first < y.first));
+            });
+        if (sorted) {
+          std::sort(
               queue,
               queue + k - 1,
-              queue + dim_size,
               [](const elem_t& x, const elem_t& y) -> bool {
                 return (
                     (!std::isnan(x.first) && std::isnan(y.first)) ||
                     (x.first < y.first));
               });
-          if (sorted) {
-            std::sort(
-                queue,
-                queue + k - 1,
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return (
-                      (!std::isnan(x.first) && std::isnan(y.first)) ||
-                      (x.first < y.first));
-                });
-          }
         }
       }
 
@@ -230,7 +322,9 @@ std::tuple<Tensor&, Tensor&> topk_values(
 
   ET_SWITCH_REALH_TYPES(in.scalar_type(), ctx, name, CTYPE, [&]() {
     using elem_t = std::pair<CTYPE, int64_t>;
-    size_t temp_mem_size = nonempty_size(in, dim) * sizeof(elem_t);
+    const size_t dim_size = nonempty_size(in, dim);
+    const size_t queue_size = use_heap_select(k, dim_size) ? k : dim_size;
+    size_t temp_mem_size = queue_size * sizeof(elem_t);
 
     elem_t* queue = (elem_t*)allocate_temp_memory(ctx, temp_mem_size);
     if (queue == nullptr) {
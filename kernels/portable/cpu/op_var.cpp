@@ -30,6 +30,36 @@ void compute_variance(
     for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
       out_data[out_ix] = NAN;
     }
+    return;
+  }
+
+  size_t outer_size = 0;
+  size_t reduce_size = 0;
+  size_t inner_size = 0;
+  if (get_contiguous_reduction_shape(
+          in, dim_list, &outer_size, &reduce_size, &inner_size) &&
+      inner_size == 1) {
+    // Each output element reduces one contiguous row of `in`.
+    const CTYPE_IN* in_data = in.const_data_ptr<CTYPE_IN>();
+    for (size_t out_ix = 0; out_ix < outer_size; ++out_ix) {
+      const CTYPE_IN* row = in_data + out_ix * reduce_size;
+      CTYPE_OUT sum = map_reduce_contiguous<CTYPE_IN, CTYPE_OUT>(
+          [](CTYPE_IN v) { return static_cast<CTYPE_OUT>(v); },
+          [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
+          row,
+          reduce_size);
+      CTYPE_OUT mean = sum / num;
+      CTYPE_OUT sum2 = map_reduce_contiguous<CTYPE_IN, CTYPE_OUT>(
+          [mean](CTYPE_IN v) {
+            return (
+                (static_cast<CTYPE_OUT>(v) - mean) *
+                (static_cast<CTYPE_OUT>(v) - mean));
+          },
+          [](CTYPE_OUT outv, CTYPE_OUT acc) { return acc + outv; },
+          row,
+          reduce_size);
+      out_data[out_ix] = sum2 / denominator;
+    }
   } else {
     for (size_t out_ix = 0; out_ix < out.numel(); ++out_ix) {
       CTYPE_OUT sum = map_reduce_over_dim_list<CTYPE_IN, CTYPE_OUT>(
@@ -26,6 +26,11 @@ inline constexpr bool should_include_kernel_dtype(
 
 namespace torch {
 namespace executor {
+// Must be a constant expression: ET_INTERNAL_SWITCH_CASE uses it to discard
+// the cases of dtypes that were not selected for the operator.
+#define ET_INTERNAL_SELECTIVE_BUILD_INCLUDES(enum_type) \
+  should_include_kernel_dtype(et_switch_name, enum_type)
+
 #define ET_INTERNAL_CHECK_SELECTIVE_BUILD(enum_type)               \
   do {                                                             \
     if (!should_include_kernel_dtype(et_switch_name, enum_type)) { \
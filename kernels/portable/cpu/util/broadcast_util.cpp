@@ -280,6 +280,22 @@ void delinearize_index(
   delinearize_index(linear_index, t.sizes(), out_indexes, out_indexes_len);
 }
 
+void delinearize_index_in_dim_order(
+    size_t data_index,
+    const Tensor& t,
+    size_t* out_indexes,
+    const size_t out_indexes_len) {
+  ET_CHECK(t.dim() <= out_indexes_len);
+  const auto dim_order = t.dim_order();
+  for (auto i = 0; i < t.dim(); ++i) {
+    // The last dim in the dim order is the one that moves fastest in memory.
+    auto dim = dim_order[t.dim() - 1 - i];
+    auto dim_size = t.size(dim);
+    out_indexes[dim] = data_index % dim_size;
+    data_index /= dim_size;
+  }
+}
+
 size_t linearize_access_indexes(
     ArrayRef<size_t> indexes_broadcast_to,
     ssize_t broadcast_to_ndim,
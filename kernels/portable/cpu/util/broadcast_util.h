@@ -235,6 +235,24 @@ void delinearize_index(
     size_t* out_indexes,
     const size_t out_indexes_len);
 
+/**
+ * Delinearize an offset into the data of a tensor to per-dimension indexes.
+ * Unlike delinearize_index(), this follows the dim order of the tensor, so it
+ * also maps offsets into channels last tensors to the right indexes. For
+ * tensors in the default dim order the two are the same.
+ *
+ * @param[in] data_index The offset into the data of t, in elements
+ * @param[in] t The tensor object
+ * @param[out] out_indexes The per-dimension indexes
+ * @param[in] out_indexes_len The maximum size of the out_indexes array
+ * @returns void
+ */
+void delinearize_index_in_dim_order(
+    size_t data_index,
+    const Tensor& t,
+    size_t* out_indexes,
+    const size_t out_indexes_len);
+
 /**
  * Return the linear index for broatcast_from tensor, given the indexes and
  * number of dimensions of broadcast_to tensor, and the shape and strides
@@ -295,7 +313,8 @@ inline void apply_binary_elementwise_fn(
 
     if (any_is_broadcasted) {
       size_t out_indexes[kTensorDimensionLimit];
-      delinearize_index(i, out, out_indexes, kTensorDimensionLimit);
+      delinearize_index_in_dim_order(
+          i, out, out_indexes, kTensorDimensionLimit);
 
       if (a_is_broadcasted) {
         a_linear_index = linearize_access_indexes(out_indexes, out.dim(), a);
@@ -344,7 +363,8 @@ inline void apply_ternary_elementwise_fn(
 
     if (any_is_broadcasted) {
       size_t out_indexes[kTensorDimensionLimit];
-      delinearize_index(i, out, out_indexes, kTensorDimensionLimit);
+      delinearize_index_in_dim_order(
+          i, out, out_indexes, kTensorDimensionLimit);
 
       if (a_is_broadcasted) {
         a_linear_index = linearize_access_indexes(out_indexes, out.dim(), a);
@@ -126,7 +126,8 @@ inline void apply_bitensor_elementwise_fn(
 
     if (any_is_broadcasted) {
       size_t out_indexes[kTensorDimensionLimit];
-      delinearize_index(i, out, out_indexes, kTensorDimensionLimit);
+      delinearize_index_in_dim_order(
+          i, out, out_indexes, kTensorDimensionLimit);
 
       if (a_is_broadcasted) {
         a_linear_index = linearize_access_indexes(out_indexes, out.dim(), a);
@@ -217,7 +218,8 @@ inline void apply_tritensor_elementwise_fn(
 
     if (any_is_broadcasted) {
       size_t out_indexes[kTensorDimensionLimit];
-      delinearize_index(i, out, out_indexes, kTensorDimensionLimit);
+      delinearize_index_in_dim_order(
+          i, out, out_indexes, kTensorDimensionLimit);
 
       if (a_is_broadcasted) {
         a_linear_index = linearize_access_indexes(out_indexes, out.dim(), a);
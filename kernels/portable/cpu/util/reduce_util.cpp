@@ -10,6 +10,7 @@
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
 #include <executorch/runtime/platform/assert.h>
+#include <algorithm>
 #include <cstring>
 
 namespace torch {
@@ -215,6 +216,59 @@ size_t get_init_index(
   return init_ix;
 }
 
+bool get_contiguous_reduction_shape(
+    const Tensor& in,
+    const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
+    size_t* outer_size,
+    size_t* reduce_size,
+    size_t* inner_size) {
+  // Check the strides directly, since tensor_is_contiguous() logs when it
+  // fails.
+  const auto sizes = in.sizes();
+  const auto strides = in.strides();
+  size_t expected_stride = 1;
+  for (ssize_t d = in.dim() - 1; d >= 0; --d) {
+    if (sizes[d] != 1 && static_cast<size_t>(strides[d]) != expected_stride) {
+      return false;
+    }
+    expected_stride *= sizes[d];
+  }
+
+  if (!dim_list.has_value() || dim_list.value().size() == 0 || in.dim() == 0) {
+    *outer_size = 1;
+    *reduce_size = in.numel();
+    *inner_size = 1;
+    return true;
+  }
+
+  bool is_in_dim_list[kTensorDimensionLimit];
+  memset(is_in_dim_list, false, sizeof(is_in_dim_list));
+  ssize_t first_dim = in.dim();
+  ssize_t last_dim = -1;
+  for (const auto& d : dim_list.value()) {
+    const ssize_t non_neg_d = _normalize_non_neg_d(d, in.dim());
+    is_in_dim_list[non_neg_d] = true;
+    first_dim = std::min(first_dim, non_neg_d);
+    last_dim = std::max(last_dim, non_neg_d);
+  }
+  *outer_size = 1;
+  *reduce_size = 1;
+  *inner_size = 1;
+  for (ssize_t d = 0; d < in.dim(); ++d) {
+    if (d < first_dim) {
+      *outer_size *= sizes[d];
+    } else if (d > last_dim) {
+      *inner_size *= sizes[d];
+    } else if (is_in_dim_list[d] || sizes[d] == 1) {
+      *reduce_size *= sizes[d];
+    } else {
+      // A dimension that is kept lies between two reduced dimensions.
+      return false;
+    }
+  }
+  return true;
+}
+
 //
 // Resize out tensor of reduction op
 //
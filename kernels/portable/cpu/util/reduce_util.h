@@ -10,6 +10,7 @@
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+#include <algorithm>
 #include <cstring>
 #include <tuple>
 
@@ -179,6 +180,19 @@ size_t get_init_index(
     const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
     const size_t out_ix);
 
+/**
+ * Returns true if `in` is contiguous and the dimensions in `dim_list` are
+ * adjacent, so that reducing `in` over them is the same as reducing a
+ * contiguous [outer_size, reduce_size, inner_size] tensor over its middle
+ * dimension. A null or empty `dim_list` reduces over every dimension.
+ */
+bool get_contiguous_reduction_shape(
+    const exec_aten::Tensor& in,
+    const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
+    size_t* outer_size,
+    size_t* reduce_size,
+    size_t* inner_size);
+
 //
 // Iteration Functions
 //
@@ -549,6 +563,110 @@ CTYPE reduce_over_dim_list(
       [](CTYPE v) { return v; }, reduce_fun, in, dim_list, out_ix);
 }
 
+/**
+ * Reduces the `size` contiguous elements at `in_data`, first applying the map
+ * `map_fun` to each element, with the signature `CTYPE_OUT map_fun(CTYPE_IN
+ * v)`, and then reducing with `reduce_fun`, with the signature `CTYPE_OUT
+ * reduce_fun(CTYPE_OUT v, CTYPE_OUT acc)`. `size` must be nonzero.
+ *
+ * The elements are split across independent accumulators that are combined
+ * pairwise at the end, which lets the compiler vectorize the loop and, for
+ * floating point sums, keeps the rounding error from growing linearly with
+ * `size`. `reduce_fun` must therefore be associative and commutative.
+ */
+template <
+    typename CTYPE_IN,
+    typename CTYPE_OUT,
+    typename MapOp,
+    typename ReduceOp>
+CTYPE_OUT map_reduce_contiguous(
+    const MapOp& map_fun,
+    const ReduceOp& reduce_fun,
+    const CTYPE_IN* in_data,
+    const size_t size) {
+  constexpr size_t kNumAccumulators = 8;
+  CTYPE_OUT acc[kNumAccumulators];
+  const size_t num_acc = std::min(kNumAccumulators, size);
+  for (size_t j = 0; j < num_acc; ++j) {
+    acc[j] = map_fun(in_data[j]);
+  }
+  size_t i = num_acc;
+  for (; i + kNumAccumulators <= size; i += kNumAccumulators) {
+    for (size_t j = 0; j < kNumAccumulators; ++j) {
+      acc[j] = reduce_fun(map_fun(in_data[i + j]), acc[j]);
+    }
+  }
+  for (; i < size; ++i) {
+    acc[0] = reduce_fun(map_fun(in_data[i]), acc[0]);
+  }
+  for (size_t width = num_acc; width > 1;) {
+    const size_t half = (width + 1) / 2;
+    for (size_t j = half; j < width; ++j) {
+      acc[j - half] = reduce_fun(acc[j], acc[j - half]);
+    }
+    width = half;
+  }
+  return acc[0];
+}
+
+/**
+ * Computes the same values as calling map_reduce_over_dim_list() for every
+ * output index and storing them in `out_data`, when
+ * get_contiguous_reduction_shape() accepts `in` and `dim_list`. Reductions
+ * over the innermost dimensions use map_reduce_contiguous() for each output
+ * element; other reductions accumulate whole contiguous rows of `in` into
+ * `out_data` at a time instead of walking `in` with the reduction stride.
+ *
+ * Returns false without writing to `out_data` if the reduction isn't
+ * contiguous or `in` is empty, in which case callers should fall back to
+ * map_reduce_over_dim_list(). `reduce_fun` must be associative and
+ * commutative.
+ */
+template <
+    typename CTYPE_IN,
+    typename CTYPE_OUT,
+    typename MapOp,
+    typename ReduceOp>
+bool map_reduce_over_contiguous_dim_list(
+    const MapOp& map_fun,
+    const ReduceOp& reduce_fun,
+    const exec_aten::Tensor& in,
+    const exec_aten::optional<exec_aten::ArrayRef<int64_t>>& dim_list,
+    CTYPE_OUT* out_data) {
+  size_t outer_size = 0;
+  size_t reduce_size = 0;
+  size_t inner_size = 0;
+  if (in.numel() == 0 ||
+      !get_contiguous_reduction_shape(
+          in, dim_list, &outer_size, &reduce_size, &inner_size)) {
+    return false;
+  }
+  const CTYPE_IN* const in_data = in.const_data_ptr<CTYPE_IN>();
+  if (inner_size == 1) {
+    for (size_t outer_ix = 0; outer_ix < outer_size; ++outer_ix) {
+      out_data[outer_ix] = map_reduce_contiguous<CTYPE_IN, CTYPE_OUT>(
+          map_fun, reduce_fun, in_data + outer_ix * reduce_size, reduce_size);
+    }
+    return true;
+  }
+  for (size_t outer_ix = 0; outer_ix < outer_size; ++outer_ix) {
+    const CTYPE_IN* const in_block =
+        in_data + outer_ix * reduce_size * inner_size;
+    CTYPE_OUT* const out_row = out_data + outer_ix * inner_size;
+    for (size_t inner_ix = 0; inner_ix < inner_size; ++inner_ix) {
+      out_row[inner_ix] = map_fun(in_block[inner_ix]);
+    }
+    for (size_t reduce_ix = 1; reduce_ix < reduce_size; ++reduce_ix) {
+      const CTYPE_IN* const in_row = in_block + reduce_ix * inner_size;
+      for (size_t inner_ix = 0; inner_ix < inner_size; ++inner_ix) {
+        out_row[inner_ix] =
+            reduce_fun(map_fun(in_row[inner_ix]), out_row[inner_ix]);
+      }
+    }
+  }
+  return true;
+}
+
 //
 // Compute reduced out tensor size and dim
 //
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using exec_aten::optional;
@@ -22,7 +24,10 @@ using exec_aten::Tensor;
 using executorch::runtime::testing::TensorFactory;
 using torch::executor::apply_over_dim;
 using torch::executor::apply_over_dim_list;
+using torch::executor::get_contiguous_reduction_shape;
 using torch::executor::get_out_numel;
+using torch::executor::map_reduce_over_contiguous_dim_list;
+using torch::executor::map_reduce_over_dim_list;
 
 void _apply_over_dim(const Tensor& in, const optional<int64_t>& dim) {
   int64_t* in_data = in.mutable_data_ptr<int64_t>();
@@ -581,3 +586,93 @@ TEST(ReduceUtilTest, ApplyOverDimListInvalid) {
   ET_EXPECT_DEATH(
       apply_over_dim_list([](size_t in_ix) { return; }, in, dim_list, 0), "");
 }
+
+TEST(ReduceUtilTest, GetContiguousReductionShape) {
+  TensorFactory<ScalarType::Long> tf;
+  Tensor in = tf.zeros({2, 4, 5, 3});
+  size_t outer = 0;
+  size_t reduce = 0;
+  size_t inner = 0;
+
+  EXPECT_TRUE(get_contiguous_reduction_shape(in, {}, &outer, &reduce, &inner));
+  EXPECT_EQ(outer, 1);
+  EXPECT_EQ(reduce, 120);
+  EXPECT_EQ(inner, 1);
+
+  int64_t dims_12[2] = {1, -2};
+  EXPECT_TRUE(get_contiguous_reduction_shape(
+      in, ArrayRef<int64_t>{dims_12, 2}, &outer, &reduce, &inner));
+  EXPECT_EQ(outer, 2);
+  EXPECT_EQ(reduce, 20);
+  EXPECT_EQ(inner, 3);
+
+  int64_t dims_3[1] = {3};
+  EXPECT_TRUE(get_contiguous_reduction_shape(
+      in, ArrayRef<int64_t>{dims_3, 1}, &outer, &reduce, &inner));
+  EXPECT_EQ(outer, 40);
+  EXPECT_EQ(reduce, 3);
+  EXPECT_EQ(inner, 1);
+
+  // A kept dimension between two reduced ones.
+  int64_t dims_02[2] = {0, 2};
+  EXPECT_FALSE(get_contiguous_reduction_shape(
+      in, ArrayRef<int64_t>{dims_02, 2}, &outer, &reduce, &inner));
+
+  // Unless it has a single element.
+  Tensor in_with_unit_dim = tf.zeros({2, 1, 5, 3});
+  EXPECT_TRUE(get_contiguous_reduction_shape(
+      in_with_unit_dim,
+      ArrayRef<int64_t>{dims_02, 2},
+      &outer,
+      &reduce,
+      &inner));
+  EXPECT_EQ(outer, 1);
+  EXPECT_EQ(reduce, 10);
+  EXPECT_EQ(inner, 3);
+}
+
+TEST(ReduceUtilTest, MapReduceOverContiguousDimListMatchesDimList) {
+  TensorFactory<ScalarType::Long> tf;
+  std::vector<int64_t> in_data(2 * 4 * 5 * 19);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = (i * 37) % 101;
+  }
+  Tensor in = tf.make({2, 4, 5, 19}, in_data);
+  const auto map_fun = [](int64_t v) { return v * v; };
+  const auto reduce_fun = [](int64_t v, int64_t acc) { return acc + v; };
+
+  int64_t dims_all[4] = {0, 1, 2, 3};
+  int64_t dims_0[1] = {0};
+  int64_t dims_12[2] = {1, 2};
+  int64_t dims_23[2] = {2, 3};
+  int64_t dims_3[1] = {-1};
+  const std::vector<ArrayRef<int64_t>> dim_lists = {
+      ArrayRef<int64_t>{dims_all, 4},
+      ArrayRef<int64_t>{dims_0, 1},
+      ArrayRef<int64_t>{dims_12, 2},
+      ArrayRef<int64_t>{dims_23, 2},
+      ArrayRef<int64_t>{dims_3, 1},
+  };
+  for (const auto& dims : dim_lists) {
+    const optional<ArrayRef<int64_t>> dim_list(dims);
+    const size_t out_numel = get_out_numel(in, dim_list);
+    std::vector<int64_t> expected(out_numel);
+    for (size_t out_ix = 0; out_ix < out_numel; ++out_ix) {
+      expected[out_ix] = map_reduce_over_dim_list<int64_t, int64_t>(
+          map_fun, reduce_fun, in, dim_list, out_ix);
+    }
+    std::vector<int64_t> actual(out_numel, -1);
+    EXPECT_TRUE((map_reduce_over_contiguous_dim_list<int64_t, int64_t>(
+        map_fun, reduce_fun, in, dim_list, actual.data())));
+    EXPECT_EQ(actual, expected);
+  }
+
+  int64_t dims_13[2] = {1, 3};
+  std::vector<int64_t> unused(2 * 5);
+  EXPECT_FALSE((map_reduce_over_contiguous_dim_list<int64_t, int64_t>(
+      map_fun,
+      reduce_fun,
+      in,
+      optional<ArrayRef<int64_t>>(ArrayRef<int64_t>{dims_13, 2}),
+      unused.data())));
+}
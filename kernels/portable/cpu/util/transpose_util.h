@@ -33,49 +33,82 @@ void transpose_tensors(
     int64_t dim1,
     Tensor& out);
 
-namespace {
 /**
- * Increments an N dimensional index like x[0,0,0] to x[0, 0, 1] to x[0, 0, 2]
- * to x[0, 1, 0] to x[0, 1, 1] etc...
+ * Copies the elements of a strided view of `in_data` into the contiguous
+ * buffer `out_data`. The view has `dim` dimensions with the given sizes, and
+ * the element at index [i0, i1, ...] of the view is read from
+ * in_data[i0 * strides[0] + i1 * strides[1] + ...].
  *
- * @param index An array of the same size as sizes. This stores the "counter"
- * being incremented.
- *
- * @param new_sizes The output tensor dimensions. Allows us to compute the
- * offset into the input tensor.
- *
- * @param non_one_indices A list of indices into index that contain non-1
- * dimension values. This allows us to eliminate an O(dim) factor from the
- * runtime in case many dimensions have a value of 1.
- *
- * @param new_strides Strides corresponding to new_sizes.
- *
- * @param offset The computed offset to index into the input tensor's memory
- * array.
+ * Dimensions of size 1 are skipped, and adjacent dimensions that are also
+ * adjacent in the input are merged, so that a view that preserves the
+ * trailing dimensions of its input is copied with one memcpy per row.
  */
-inline void increment_index_and_offset(
-    size_t* index,
-    const SizesType* new_sizes,
-    const StridesType* new_strides,
-    const ArrayRef<size_t> non_one_indices,
-    size_t& offset) {
-  for (size_t j = non_one_indices.size(); j > 0; --j) {
-    const size_t i = non_one_indices[j - 1];
-
-    index[i]++;
-    // Impossible to happen at i = 0 due to precondition check before this
-    // function is called
-    offset += new_strides[i];
-    if (index[i] == new_sizes[i]) {
-      offset -= new_sizes[i] * new_strides[i];
-      index[i] = 0;
-    } else {
+template <typename T>
+void strided_copy(
+    const T* in_data,
+    const SizesType* sizes,
+    const StridesType* strides,
+    size_t dim,
+    T* out_data) {
+  size_t merged_sizes[kTensorDimensionLimit];
+  size_t merged_strides[kTensorDimensionLimit];
+  size_t merged_dim = 0;
+  for (size_t i = 0; i < dim; ++i) {
+    if (sizes[i] == 0) {
       return;
     }
+    if (sizes[i] == 1) {
+      continue;
+    }
+    const size_t size = sizes[i];
+    const size_t stride = strides[i];
+    if (merged_dim > 0 && merged_strides[merged_dim - 1] == size * stride) {
+      merged_sizes[merged_dim - 1] *= size;
+      merged_strides[merged_dim - 1] = stride;
+    } else {
+      merged_sizes[merged_dim] = size;
+      merged_strides[merged_dim] = stride;
+      ++merged_dim;
+    }
+  }
+
+  if (merged_dim == 0) {
+    out_data[0] = in_data[0];
+    return;
   }
-}
 
-} // namespace
+  const size_t inner_size = merged_sizes[merged_dim - 1];
+  const size_t inner_stride = merged_strides[merged_dim - 1];
+  const size_t outer_dim = merged_dim - 1;
+  size_t outer_numel = 1;
+  for (size_t i = 0; i < outer_dim; ++i) {
+    outer_numel *= merged_sizes[i];
+  }
+
+  size_t index[kTensorDimensionLimit] = {0};
+  size_t in_offset = 0;
+  for (size_t outer = 0; outer < outer_numel; ++outer) {
+    const T* in_row = in_data + in_offset;
+    T* out_row = out_data + outer * inner_size;
+    if (inner_stride == 1) {
+      memcpy(out_row, in_row, inner_size * sizeof(T));
+    } else {
+      for (size_t j = 0; j < inner_size; ++j) {
+        out_row[j] = in_row[j * inner_stride];
+      }
+    }
+    // Advance to the next row of the view, innermost dimension first.
+    for (size_t j = outer_dim; j > 0; --j) {
+      const size_t i = j - 1;
+      in_offset += merged_strides[i];
+      if (++index[i] < merged_sizes[i]) {
+        break;
+      }
+      in_offset -= merged_sizes[i] * merged_strides[i];
+      index[i] = 0;
+    }
+  }
+}
 
 template <typename T>
 void transpose_tensors(
@@ -87,9 +120,6 @@ void transpose_tensors(
   auto data_a = a.const_data_ptr<T>();
   auto data_out = out.mutable_data_ptr<T>();
 
-  size_t out_index[kTensorDimensionLimit];
-  memset(out_index, 0, sizeof(out_index));
-
   StridesType new_strides[kTensorDimensionLimit];
   SizesType new_sizes[kTensorDimensionLimit];
 
@@ -104,35 +134,7 @@ void transpose_tensors(
     std::swap(new_strides[dim1], new_strides[dim0]);
   }
 
-  // non_1_dim_indices stores the indices of the dimensions that have a value
-  // greater than 1. Dimensions can only have a value of 1 or larger.
-  //
-  // This list is stored in the increasing order of the output (not input)
-  // dimension. i.e. lower index of non-1 output dimension first). This
-  // allows us to loop over only the non-1 indices (and skip the ones that
-  // have a value of 1 since they don't contribute to any meaningful computation
-  // in terms of increasing the number of elements to be copied).
-  //
-  // We loop over these non-1 indices in the reverse order since we want to
-  // process the last output dimension first (to be able to walk the input
-  // tensor in output tensor order.
-  size_t non_1_dim_indices[kTensorDimensionLimit];
-  size_t num_non_1_dim_indices = 0;
-  for (size_t cur_dim = 0; cur_dim < dim; cur_dim++) {
-    if (new_sizes[cur_dim] != 1) {
-      non_1_dim_indices[num_non_1_dim_indices++] = cur_dim;
-    }
-  }
-
-  ArrayRef<size_t> indices(non_1_dim_indices, num_non_1_dim_indices);
-
-  // Loop over and copy input elements into output
-  size_t a_offset = 0;
-  for (ssize_t out_offset = 0; out_offset < a.numel(); out_offset++) {
-    data_out[out_offset] = data_a[a_offset];
-    increment_index_and_offset(
-        out_index, new_sizes, new_strides, indices, a_offset);
-  }
+  strided_copy(data_a, new_sizes, new_strides, dim, data_out);
 }
 
 inline bool check_t_copy_args(const Tensor& in, Tensor& out) {
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/portable/cpu/util/upsample_util.h>
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+
+namespace torch {
+namespace executor {
+
+bool check_upsample_2d_common_args(
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t>& output_size,
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, out));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(in, 4));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(out, 4));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_default_or_channels_last_dim_order(in));
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dim_order(in, out));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      output_size.has_value() ^ scale_factors.has_value(),
+      "Exactly one of output_size and scale_factors must be set");
+  if (output_size.has_value()) {
+    ET_LOG_AND_RETURN_IF_FALSE(output_size.value().size() == 2);
+    ET_LOG_AND_RETURN_IF_FALSE(
+        output_size.value()[0] > 0 && output_size.value()[1] > 0);
+  } else {
+    ET_LOG_AND_RETURN_IF_FALSE(scale_factors.value().size() == 2);
+    ET_LOG_AND_RETURN_IF_FALSE(
+        scale_factors.value()[0] > 0 && scale_factors.value()[1] > 0);
+  }
+  return true;
+}
+
+Error resize_upsample_2d(
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t>& output_size,
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    double& scale_h,
+    double& scale_w,
+    Tensor& out) {
+  Tensor::SizesType target_size[kTensorDimensionLimit];
+  target_size[0] = in.size(0);
+  target_size[1] = in.size(1);
+
+  if (output_size.has_value()) {
+    target_size[2] = output_size.value()[0];
+    target_size[3] = output_size.value()[1];
+    scale_h = -1;
+    scale_w = -1;
+  } else {
+    scale_h = scale_factors.value()[0];
+    scale_w = scale_factors.value()[1];
+    target_size[2] = static_cast<Tensor::SizesType>(in.size(2) * scale_h);
+    target_size[3] = static_cast<Tensor::SizesType>(in.size(3) * scale_w);
+  }
+
+  ET_CHECK_OR_RETURN_ERROR(
+      target_size[2] > 0 && target_size[3] > 0,
+      InvalidArgument,
+      "Upsampled output size must be non-empty");
+
+  return resize_tensor(out, {target_size, 4});
+}
+
+} // namespace executor
+} // namespace torch
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+
+/**
+ * Checks the arguments of the upsample_*2d.vec ops. Exactly one of
+ * output_size and scale_factors must be set, and `in` and `out` must be 4D
+ * tensors with the same dtype and dim order.
+ */
+bool check_upsample_2d_common_args(
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t>& output_size,
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    Tensor& out);
+
+/**
+ * Resizes `out` to the output shape of an upsample_*2d.vec op. Sets scale_h
+ * and scale_w to the user provided scale factors, or to -1 when the output
+ * size was given instead.
+ */
+Error resize_upsample_2d(
+    const Tensor& in,
+    const exec_aten::OptionalArrayRef<int64_t>& output_size,
+    const exec_aten::OptionalArrayRef<double>& scale_factors,
+    double& scale_h,
+    double& scale_w,
+    Tensor& out);
+
+/**
+ * Returns the distance between input samples per output sample. A positive
+ * `scale` is the user provided output/input ratio.
+ */
+template <typename T>
+inline T compute_scales_value(
+    double scale,
+    int64_t input_size,
+    int64_t output_size) {
+  return scale > 0 ? static_cast<T>(1.0 / scale)
+                   : static_cast<T>(input_size) / output_size;
+}
+
+template <typename T>
+inline T area_pixel_compute_scale(
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners,
+    double scale) {
+  if (align_corners) {
+    return output_size > 1 ? static_cast<T>(input_size - 1) / (output_size - 1)
+                           : static_cast<T>(0);
+  }
+  return compute_scales_value<T>(scale, input_size, output_size);
+}
+
+/**
+ * Returns the input coordinate of output element `dst_index` for linear
+ * interpolation, matching ATen.
+ */
+template <typename T>
+inline T area_pixel_compute_source_index(
+    T scale,
+    int64_t dst_index,
+    bool align_corners) {
+  if (align_corners) {
+    return scale * dst_index;
+  }
+  const T src_index =
+      scale * (dst_index + static_cast<T>(0.5)) - static_cast<T>(0.5);
+  return src_index < 0 ? static_cast<T>(0) : src_index;
+}
+
+/**
+ * Returns the input index that output element `output_index` copies for
+ * nearest neighbor interpolation, matching ATen.
+ */
+inline int64_t nearest_idx(
+    int64_t output_index,
+    int64_t input_size,
+    int64_t output_size,
+    double scale) {
+  if (output_size == input_size) {
+    return output_index;
+  } else if (output_size == 2 * input_size) {
+    return output_index >> 1;
+  }
+  const float ratio =
+      compute_scales_value<float>(scale, input_size, output_size);
+  return std::min(
+      static_cast<int64_t>(std::floor(output_index * ratio)), input_size - 1);
+}
+
+} // namespace executor
+} // namespace torch
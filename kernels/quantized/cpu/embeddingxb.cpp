@@ -12,6 +12,17 @@
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
+#include <type_traits>
+
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 namespace torch {
 namespace executor {
@@ -162,6 +173,206 @@ void check_embedding_xbit_args(
   }
 }
 
+// The number of values that unpack_values() and dequantize_values() process
+// at a time.
+constexpr int32_t kUnpackChunkSize = 128;
+
+// The minimum number of output elements that each parallel_for chunk
+// gathers.
+constexpr int64_t kEmbeddingGrainSize = 16384;
+
+/**
+ * Unpacks the `count` values packed in `w_data`, where `count` is a multiple
+ * of the number of values per byte, into `q` as signed integers, like
+ * weight_value().
+ */
+void unpack_values(
+    const uint8_t* w_data,
+    int32_t count,
+    int32_t weight_nbit,
+    int8_t* q) {
+  const int32_t values_per_byte = 8 / weight_nbit;
+  const int32_t num_bytes = count / values_per_byte;
+  int32_t i = 0;
+  if (weight_nbit == 4) {
+    // The high nibble of each byte holds the even value.
+#if defined(__aarch64__) || defined(__ARM_NEON)
+    const uint8x16_t low_mask = vdupq_n_u8(0x0F);
+    const int8x16_t offset = vdupq_n_s8(8);
+    for (; i + 16 <= num_bytes; i += 16) {
+      const uint8x16_t packed = vld1q_u8(w_data + i);
+      const uint8x16x2_t values =
+          vzipq_u8(vshrq_n_u8(packed, 4), vandq_u8(packed, low_mask));
+      vst1q_s8(
+          q + 2 * i, vsubq_s8(vreinterpretq_s8_u8(values.val[0]), offset));
+      vst1q_s8(
+          q + 2 * i + 16,
+          vsubq_s8(vreinterpretq_s8_u8(values.val[1]), offset));
+    }
+#elif defined(__AVX2__)
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i offset = _mm_set1_epi8(8);
+    for (; i + 16 <= num_bytes; i += 16) {
+      const __m128i packed =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(w_data + i));
+      const __m128i high =
+          _mm_and_si128(_mm_srli_epi16(packed, 4), low_mask);
+      const __m128i low = _mm_and_si128(packed, low_mask);
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(q + 2 * i),
+          _mm_sub_epi8(_mm_unpacklo_epi8(high, low), offset));
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i*>(q + 2 * i + 16),
+          _mm_sub_epi8(_mm_unpackhi_epi8(high, low), offset));
+    }
+#endif
+    for (; i < num_bytes; ++i) {
+      q[2 * i] = static_cast<int8_t>((w_data[i] >> 4) - 8);
+      q[2 * i + 1] = static_cast<int8_t>((w_data[i] & 0x0F) - 8);
+    }
+  } else {
+    ET_DCHECK(weight_nbit == 2);
+    // The lowest two bits of each byte hold the first value.
+#if defined(__aarch64__) || defined(__ARM_NEON)
+    const uint8x16_t mask = vdupq_n_u8(3);
+    const int8x16_t offset = vdupq_n_s8(2);
+    for (; i + 16 <= num_bytes; i += 16) {
+      const uint8x16_t packed = vld1q_u8(w_data + i);
+      const uint8x16x2_t v01 = vzipq_u8(
+          vandq_u8(packed, mask), vandq_u8(vshrq_n_u8(packed, 2), mask));
+      const uint8x16x2_t v23 = vzipq_u8(
+          vandq_u8(vshrq_n_u8(packed, 4), mask), vshrq_n_u8(packed, 6));
+      const uint16x8x2_t low = vzipq_u16(
+          vreinterpretq_u16_u8(v01.val[0]), vreinterpretq_u16_u8(v23.val[0]));
+      const uint16x8x2_t high = vzipq_u16(
+          vreinterpretq_u16_u8(v01.val[1]), vreinterpretq_u16_u8(v23.val[1]));
+      const uint16x8_t parts[4] = {
+          low.val[0], low.val[1], high.val[0], high.val[1]};
+      for (int32_t j = 0; j < 4; ++j) {
+        vst1q_s8(
+            q + 4 * i + 16 * j,
+            vsubq_s8(vreinterpretq_s8_u16(parts[j]), offset));
+      }
+    }
+#elif defined(__AVX2__)
+    const __m128i mask = _mm_set1_epi8(3);
+    const __m128i offset = _mm_set1_epi8(2);
+    for (; i + 16 <= num_bytes; i += 16) {
+      const __m128i packed =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(w_data + i));
+      const __m128i v0 = _mm_and_si128(packed, mask);
+      const __m128i v1 = _mm_and_si128(_mm_srli_epi16(packed, 2), mask);
+      const __m128i v2 = _mm_and_si128(_mm_srli_epi16(packed, 4), mask);
+      const __m128i v3 = _mm_and_si128(_mm_srli_epi16(packed, 6), mask);
+      const __m128i v01_low = _mm_unpacklo_epi8(v0, v1);
+      const __m128i v01_high = _mm_unpackhi_epi8(v0, v1);
+      const __m128i v23_low = _mm_unpacklo_epi8(v2, v3);
+      const __m128i v23_high = _mm_unpackhi_epi8(v2, v3);
+      const __m128i parts[4] = {
+          _mm_unpacklo_epi16(v01_low, v23_low),
+          _mm_unpackhi_epi16(v01_low, v23_low),
+          _mm_unpacklo_epi16(v01_high, v23_high),
+          _mm_unpackhi_epi16(v01_high, v23_high)};
+      for (int32_t j = 0; j < 4; ++j) {
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(q + 4 * i + 16 * j),
+            _mm_sub_epi8(parts[j], offset));
+      }
+    }
+#endif
+    for (; i < num_bytes; ++i) {
+      const uint8_t packed = w_data[i];
+      q[4 * i] = static_cast<int8_t>((packed & 3) - 2);
+      q[4 * i + 1] = static_cast<int8_t>(((packed >> 2) & 3) - 2);
+      q[4 * i + 2] = static_cast<int8_t>(((packed >> 4) & 3) - 2);
+      q[4 * i + 3] = static_cast<int8_t>((packed >> 6) - 2);
+    }
+  }
+}
+
+/// Computes out[i] = (q[i] - zp) * scale for the `count` values of q.
+template <typename CTYPE_OUT>
+void dequantize_values(
+    const int8_t* q,
+    int32_t count,
+    float scale,
+    float zp,
+    CTYPE_OUT* out) {
+  int32_t i = 0;
+  if constexpr (std::is_same<CTYPE_OUT, float>::value) {
+#if defined(__aarch64__) || defined(__ARM_NEON)
+    const float32x4_t scale_vec = vdupq_n_f32(scale);
+    const float32x4_t zp_vec = vdupq_n_f32(zp);
+    for (; i + 8 <= count; i += 8) {
+      const int16x8_t values = vmovl_s8(vld1_s8(q + i));
+      const float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(values)));
+      const float32x4_t high =
+          vcvtq_f32_s32(vmovl_s16(vget_high_s16(values)));
+      vst1q_f32(out + i, vmulq_f32(vsubq_f32(low, zp_vec), scale_vec));
+      vst1q_f32(out + i + 4, vmulq_f32(vsubq_f32(high, zp_vec), scale_vec));
+    }
+#elif defined(__AVX2__)
+    const __m256 scale_vec = _mm256_set1_ps(scale);
+    const __m256 zp_vec = _mm256_set1_ps(zp);
+    for (; i + 8 <= count; i += 8) {
+      const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(q + i))));
+      _mm256_storeu_ps(
+          out + i, _mm256_mul_ps(_mm256_sub_ps(values, zp_vec), scale_vec));
+    }
+#endif
+  }
+  for (; i < count; ++i) {
+    out[i] = static_cast<CTYPE_OUT>((static_cast<float>(q[i]) - zp) * scale);
+  }
+}
+
+/**
+ * Dequantizes the embedding at `w_data` into `out_data`, with `group_size`
+ * values per scale and zero point.
+ */
+template <typename CTYPE_PARAMS, typename CTYPE_OUT>
+void dequantize_embedding(
+    const uint8_t* w_data,
+    int32_t embedding_dim,
+    int32_t group_size,
+    const CTYPE_PARAMS* scale_ptr,
+    const CTYPE_PARAMS* zero_points_ptr,
+    int32_t weight_nbit,
+    CTYPE_OUT* out_data) {
+  const int32_t values_per_byte = 8 / weight_nbit;
+  if (group_size % values_per_byte != 0) {
+    // Groups start in the middle of bytes, so unpack one value at a time.
+    for (int32_t j = 0; j < embedding_dim; ++j) {
+      const int32_t group_id = j / group_size;
+      const float zp = zero_points_ptr != nullptr
+          ? static_cast<float>(zero_points_ptr[group_id])
+          : 0.0f;
+      out_data[j] = static_cast<CTYPE_OUT>(
+          (static_cast<float>(weight_value(w_data, j, weight_nbit)) - zp) *
+          static_cast<float>(scale_ptr[group_id]));
+    }
+    return;
+  }
+
+  int8_t q[kUnpackChunkSize];
+  for (int32_t group_start = 0; group_start < embedding_dim;
+       group_start += group_size) {
+    const int32_t group_id = group_start / group_size;
+    const float scale = static_cast<float>(scale_ptr[group_id]);
+    const float zp = zero_points_ptr != nullptr
+        ? static_cast<float>(zero_points_ptr[group_id])
+        : 0.0f;
+    for (int32_t j = group_start; j < group_start + group_size;
+         j += kUnpackChunkSize) {
+      const int32_t count =
+          std::min(kUnpackChunkSize, group_start + group_size - j);
+      unpack_values(w_data + j / values_per_byte, count, weight_nbit, q);
+      dequantize_values(q, count, scale, zp, out_data + j);
+    }
+  }
+}
+
 /**
  * Retrieves the embeddings specified by indices, dequantizes them, and stores
  * them in out. Weight will always be uint8
@@ -184,6 +395,8 @@ void embedding_xbit_per_channel(
 
   CTYPE_OUT* out_data = out.mutable_data_ptr<CTYPE_OUT>();
   const int64_t* indices_ptr = indices.const_data_ptr<int64_t>();
+  const uint8_t* weight_data = weight.const_data_ptr<uint8_t>();
+  const int64_t packed_dim = weight.size(1);
 
   const CTYPE_PARAMS* scales = weight_scales.const_data_ptr<CTYPE_PARAMS>();
   const CTYPE_PARAMS* zero_points = nullptr;
@@ -191,33 +404,31 @@ void embedding_xbit_per_channel(
     zero_points = opt_weight_zero_points.value().const_data_ptr<CTYPE_PARAMS>();
   }
 
-  for (int i = 0; i < indices.numel(); i++) {
-    int64_t index = indices_ptr[i];
-    // If using groupwise embedding
-    int32_t qparams_index = index * num_groups_per_channel;
-    CTYPE_PARAMS zp = 0.0;
-    const CTYPE_PARAMS* scale_ptr = scales + qparams_index;
-    const CTYPE_PARAMS* zero_points_ptr = nullptr;
-    if (opt_weight_zero_points.has_value()) {
-      zero_points_ptr = zero_points + qparams_index;
-    }
-
-    const uint8_t* w_data =
-        weight.const_data_ptr<uint8_t>() + weight.size(1) * index;
-
-    for (int j = 0; j < embedding_dim; ++j) {
-      int32_t group_id = j / group_size;
-      const CTYPE_PARAMS scale = scale_ptr[group_id];
-      if (opt_weight_zero_points.has_value()) {
-        zp = zero_points_ptr[group_id];
-      }
-      out_data[j] = static_cast<CTYPE_OUT>(
-          (static_cast<float>(weight_value(w_data, j, weight_nbit)) -
-           static_cast<float>(zp)) *
-          static_cast<float>(scale));
+  // Every embedding is written to its own row of out.
+  const auto gather = [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      int64_t index = indices_ptr[i];
+      // If using groupwise embedding
+      int64_t qparams_index = index * num_groups_per_channel;
+      dequantize_embedding(
+          weight_data + packed_dim * index,
+          embedding_dim,
+          group_size,
+          scales + qparams_index,
+          zero_points != nullptr ? zero_points + qparams_index : nullptr,
+          weight_nbit,
+          out_data + i * embedding_dim);
     }
-    out_data += embedding_dim;
-  }
+  };
+#ifdef ET_USE_THREADPOOL
+  executorch::extension::parallel_for(
+      0,
+      indices.numel(),
+      std::max<int64_t>(1, kEmbeddingGrainSize / embedding_dim),
+      gather);
+#else
+  gather(0, indices.numel());
+#endif
 }
 
 void resize_out_tensor(
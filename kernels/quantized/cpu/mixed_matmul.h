@@ -0,0 +1,389 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Kernels for the float x int8 matrix multiplications of the mixed_linear and
+// mixed_mm ops. They stream the int8 weights directly into float vector
+// registers, so that each weight byte is loaded once per block of activation
+// rows instead of being widened on every use, and split the output columns
+// across the threadpool when one is available.
+//
+// The int8 x int8 kernels of the mixed_linear_dynamic op instead quantize the
+// activations to int8 per row and multiply in the integer domain, with VNNI
+// or AVX2 on x86 where the target supports them.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace torch {
+namespace executor {
+namespace native {
+namespace mixed_matmul {
+
+// The number of activation rows that share each load of a weight row.
+constexpr int64_t kRowBlock = 4;
+
+// The number of output columns that mixed_mm accumulates at a time.
+constexpr int64_t kColBlock = 64;
+
+// The minimum number of multiply-adds that each parallel_for chunk performs.
+constexpr int64_t kGrainSize = 32768;
+
+template <typename Func>
+inline void parallel_for_columns(int64_t end, int64_t grain, const Func& f) {
+#ifdef ET_USE_THREADPOOL
+  executorch::extension::parallel_for(0, end, std::max<int64_t>(1, grain), f);
+#else
+  f(0, end);
+#endif
+}
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+inline float horizontal_sum(float32x4_t v) {
+  const float32x2_t r = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpadd_f32(r, r), 0);
+}
+#elif defined(__AVX2__) && defined(__FMA__)
+inline float horizontal_sum(__m256 v) {
+  __m128 r =
+      _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+  r = _mm_add_ss(r, _mm_movehdup_ps(r));
+  return _mm_cvtss_f32(r);
+}
+#endif
+
+/**
+ * Sets sums[r] to the dot product of x[r][0:len] and w[0:len] for each of the
+ * kRows activation rows in `x`, where row r starts at x + r * x_stride.
+ */
+template <int64_t kRows>
+inline void dot_rows(
+    const float* x,
+    int64_t x_stride,
+    const int8_t* w,
+    int64_t len,
+    float* sums) {
+  int64_t k = 0;
+#if defined(__aarch64__) || defined(__ARM_NEON)
+  float32x4_t acc[kRows][2];
+  for (int64_t r = 0; r < kRows; ++r) {
+    acc[r][0] = vdupq_n_f32(0);
+    acc[r][1] = vdupq_n_f32(0);
+  }
+  for (; k + 8 <= len; k += 8) {
+    const int16x8_t w16 = vmovl_s8(vld1_s8(w + k));
+    const float32x4_t w_lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(w16)));
+    const float32x4_t w_hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(w16)));
+    for (int64_t r = 0; r < kRows; ++r) {
+      const float* x_row = x + r * x_stride + k;
+      acc[r][0] = vmlaq_f32(acc[r][0], vld1q_f32(x_row), w_lo);
+      acc[r][1] = vmlaq_f32(acc[r][1], vld1q_f32(x_row + 4), w_hi);
+    }
+  }
+  for (int64_t r = 0; r < kRows; ++r) {
+    sums[r] = horizontal_sum(vaddq_f32(acc[r][0], acc[r][1]));
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  __m256 acc[kRows];
+  for (int64_t r = 0; r < kRows; ++r) {
+    acc[r] = _mm256_setzero_ps();
+  }
+  for (; k + 8 <= len; k += 8) {
+    const __m256 w_f = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w + k))));
+    for (int64_t r = 0; r < kRows; ++r) {
+      acc[r] =
+          _mm256_fmadd_ps(_mm256_loadu_ps(x + r * x_stride + k), w_f, acc[r]);
+    }
+  }
+  for (int64_t r = 0; r < kRows; ++r) {
+    sums[r] = horizontal_sum(acc[r]);
+  }
+#else
+  for (int64_t r = 0; r < kRows; ++r) {
+    sums[r] = 0;
+  }
+#endif
+  for (; k < len; ++k) {
+    const float w_k = static_cast<float>(w[k]);
+    for (int64_t r = 0; r < kRows; ++r) {
+      sums[r] += x[r * x_stride + k] * w_k;
+    }
+  }
+}
+
+/**
+ * Computes acc[0:len] += a * w[0:len].
+ */
+inline void axpy(float* acc, float a, const int8_t* w, int64_t len) {
+  int64_t j = 0;
+#if defined(__aarch64__) || defined(__ARM_NEON)
+  const float32x4_t a_v = vdupq_n_f32(a);
+  for (; j + 8 <= len; j += 8) {
+    const int16x8_t w16 = vmovl_s8(vld1_s8(w + j));
+    const float32x4_t w_lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(w16)));
+    const float32x4_t w_hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(w16)));
+    vst1q_f32(acc + j, vmlaq_f32(vld1q_f32(acc + j), w_lo, a_v));
+    vst1q_f32(acc + j + 4, vmlaq_f32(vld1q_f32(acc + j + 4), w_hi, a_v));
+  }
+#elif defined(__AVX2__) && defined(__FMA__)
+  const __m256 a_v = _mm256_set1_ps(a);
+  for (; j + 8 <= len; j += 8) {
+    const __m256 w_f = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i*>(w + j))));
+    _mm256_storeu_ps(
+        acc + j, _mm256_fmadd_ps(w_f, a_v, _mm256_loadu_ps(acc + j)));
+  }
+#endif
+  for (; j < len; ++j) {
+    acc[j] += a * static_cast<float>(w[j]);
+  }
+}
+
+/**
+ * Computes the rows [i, i + kRows) of mixed_linear for output column j.
+ */
+template <int64_t kRows, typename T, typename V>
+inline void linear_rows(
+    T* z,
+    const float* x,
+    const int8_t* y,
+    const V* s,
+    int64_t i,
+    int64_t j,
+    int64_t n,
+    int64_t p,
+    int64_t g) {
+  const int64_t n_over_g = (n + g - 1) / g;
+  float sum[kRows] = {};
+  for (int64_t k = 0; k < n; k += g) {
+    // The last group may have fewer than g elements.
+    float psum[kRows];
+    dot_rows<kRows>(x + i * n + k, n, y + j * n + k, std::min(g, n - k), psum);
+    const float scale = static_cast<float>(s[j * n_over_g + k / g]);
+    for (int64_t r = 0; r < kRows; ++r) {
+      sum[r] += psum[r] * scale;
+    }
+  }
+  for (int64_t r = 0; r < kRows; ++r) {
+    z[(i + r) * p + j] = static_cast<T>(sum[r]);
+  }
+}
+
+/**
+ * Same as vec_quantized_matmul_transb_int8() for float activations:
+ * x: m * n, y: p * n, z: m * p, s: p * groups
+ * z[i][j] = sum(x[i][k] * y[j][k] * s[j][k/g])
+ */
+template <typename T, typename V>
+void quantized_matmul_transb_int8(
+    T* z,
+    const float* x,
+    const int8_t* y,
+    const V* s,
+    int64_t m,
+    int64_t n,
+    int64_t p,
+    int64_t g) {
+  // Every task keeps its weight rows in cache while it walks over all of the
+  // activation rows.
+  parallel_for_columns(
+      p,
+      kGrainSize / std::max<int64_t>(1, m * n),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t j = begin; j < end; ++j) {
+          int64_t i = 0;
+          for (; i + kRowBlock <= m; i += kRowBlock) {
+            linear_rows<kRowBlock>(z, x, y, s, i, j, n, p, g);
+          }
+          for (; i < m; ++i) {
+            linear_rows<1>(z, x, y, s, i, j, n, p, g);
+          }
+        }
+      });
+}
+
+/**
+ * Same as vec_quantized_matmul_int8() for float activations:
+ * x: m * n, y: n * p, z: m * p, s: n
+ * z[i][j] = sum(x[i][k] * y[k][j] * s[k])
+ */
+template <typename T>
+void quantized_matmul_int8(
+    T* z,
+    const float* x,
+    const int8_t* y,
+    const float* s,
+    int64_t m,
+    int64_t n,
+    int64_t p) {
+  const int64_t num_col_blocks = (p + kColBlock - 1) / kColBlock;
+  parallel_for_columns(
+      num_col_blocks,
+      kGrainSize / std::max<int64_t>(1, m * n * kColBlock),
+      [&](int64_t begin, int64_t end) {
+        float acc[kColBlock];
+        for (int64_t b = begin; b < end; ++b) {
+          const int64_t j = b * kColBlock;
+          const int64_t cols = std::min(kColBlock, p - j);
+          for (int64_t i = 0; i < m; ++i) {
+            std::fill(acc, acc + cols, 0.0f);
+            for (int64_t k = 0; k < n; ++k) {
+              axpy(acc, x[i * n + k] * s[k], y + k * p + j, cols);
+            }
+            for (int64_t c = 0; c < cols; ++c) {
+              z[i * p + j + c] = static_cast<T>(acc[c]);
+            }
+          }
+        }
+      });
+}
+
+/**
+ * Quantizes x[0:n] symmetrically to q[0:n], in [-127, 127], and returns the
+ * scale such that x[k] is about q[k] * scale.
+ */
+inline float quantize_row_int8(const float* x, int64_t n, int8_t* q) {
+  float amax = 0;
+  for (int64_t k = 0; k < n; ++k) {
+    amax = std::max(amax, std::fabs(x[k]));
+  }
+  const float scale = amax / 127;
+  const float inv_scale = amax == 0 ? 0 : 127 / amax;
+  for (int64_t k = 0; k < n; ++k) {
+    q[k] = static_cast<int8_t>(std::nearbyint(x[k] * inv_scale));
+  }
+  return scale;
+}
+
+#if defined(__AVX2__) && !defined(__aarch64__) && !defined(__ARM_NEON)
+inline int32_t horizontal_sum(__m256i v) {
+  __m128i r = _mm_add_epi32(
+      _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+  r = _mm_add_epi32(r, _mm_unpackhi_epi64(r, r));
+  r = _mm_add_epi32(r, _mm_shuffle_epi32(r, 1));
+  return _mm_cvtsi128_si32(r);
+}
+#endif
+
+/**
+ * Returns the dot product of x[0:len] and w[0:len]. Every x[k] must be in
+ * [-127, 127], as produced by quantize_row_int8().
+ */
+inline int32_t dot_int8(const int8_t* x, const int8_t* w, int64_t len) {
+  int64_t k = 0;
+  int32_t sum = 0;
+  // Arm has no vector path yet, since sdot and i8mm are untested; it uses the
+  // scalar loop below.
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+  // vpdpbusd multiplies unsigned by signed bytes, so multiply |w| by x with
+  // the sign of w. x is never -128, so negating it can't overflow, and
+  // |-128| is 128 as an unsigned byte.
+  __m512i acc = _mm512_setzero_si512();
+  for (; k + 64 <= len; k += 64) {
+    const __m512i x_v = _mm512_loadu_si512(x + k);
+    const __m512i w_v = _mm512_loadu_si512(w + k);
+    const __m512i x_signed = _mm512_mask_sub_epi8(
+        x_v, _mm512_movepi8_mask(w_v), _mm512_setzero_si512(), x_v);
+    acc = _mm512_dpbusd_epi32(acc, _mm512_abs_epi8(w_v), x_signed);
+  }
+  sum = _mm512_reduce_add_epi32(acc);
+#elif defined(__AVX2__)
+  // Same sign trick as above, for vpdpbusd or vpmaddubsw. The pairwise int16
+  // sums of vpmaddubsw are at most 2 * 128 * 127, so they can't saturate.
+  __m256i acc = _mm256_setzero_si256();
+  for (; k + 32 <= len; k += 32) {
+    const __m256i x_v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + k));
+    const __m256i w_v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + k));
+    const __m256i w_abs = _mm256_sign_epi8(w_v, w_v);
+    const __m256i x_signed = _mm256_sign_epi8(x_v, w_v);
+#if defined(__AVXVNNI__)
+    acc = _mm256_dpbusd_avx_epi32(acc, w_abs, x_signed);
+#else
+    acc = _mm256_add_epi32(
+        acc,
+        _mm256_madd_epi16(
+            _mm256_maddubs_epi16(w_abs, x_signed), _mm256_set1_epi16(1)));
+#endif
+  }
+  sum = horizontal_sum(acc);
+#endif
+  for (; k < len; ++k) {
+    sum += static_cast<int32_t>(x[k]) * w[k];
+  }
+  return sum;
+}
+
+/**
+ * Same as quantized_matmul_transb_int8(), but quantizes each row of x to int8
+ * first, and accumulates each group of each dot product in int32:
+ * x: m * n, y: p * n, z: m * p, s: p * groups
+ * z[i][j] = sum(xq[i][k] * y[j][k] * s[j][k/g]) * x_scales[i]
+ *
+ * xq and x_scales are scratch space for the quantized rows of x and their
+ * scales, and must hold m * n and m elements.
+ */
+template <typename T>
+void quantized_matmul_transb_int8_dynamic(
+    T* z,
+    const float* x,
+    const int8_t* y,
+    const float* s,
+    int8_t* xq,
+    float* x_scales,
+    int64_t m,
+    int64_t n,
+    int64_t p,
+    int64_t g) {
+  for (int64_t i = 0; i < m; ++i) {
+    x_scales[i] = quantize_row_int8(x + i * n, n, xq + i * n);
+  }
+  const int64_t n_over_g = (n + g - 1) / g;
+  // Every task keeps its weight rows in cache while it walks over all of the
+  // activation rows.
+  parallel_for_columns(
+      p,
+      kGrainSize / std::max<int64_t>(1, m * n),
+      [&](int64_t begin, int64_t end) {
+        for (int64_t j = begin; j < end; ++j) {
+          const int8_t* y_j = y + j * n;
+          const float* s_j = s + j * n_over_g;
+          for (int64_t i = 0; i < m; ++i) {
+            const int8_t* xq_i = xq + i * n;
+            float sum = 0;
+            for (int64_t k = 0; k < n; k += g) {
+              // The last group may have fewer than g elements.
+              sum += static_cast<float>(
+                         dot_int8(xq_i + k, y_j + k, std::min(g, n - k))) *
+                  s_j[k / g];
+            }
+            z[i * p + j] = static_cast<T>(sum * x_scales[i]);
+          }
+        }
+      });
+}
+
+} // namespace mixed_matmul
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -11,8 +11,15 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cmath>
+
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
 #if defined(__aarch64__) || defined(__ARM_NEON)
 #include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
 #endif
 
 /**
@@ -68,92 +75,124 @@ void check_dequantize_per_tensor_args(
       quant_max);
 }
 
-/**
- * Useful to reduce a tensor `in` over a given dimension `dim` using the
- * reduce function `fn`, which should have the following signature:
- * void fn(const size_t size, const size_t stride, const size_t base_ix)
- * where `size` and `stride` are the size and stride of the dimension being
- * reduced and `base_ix` is the index of the first element of the reduction.
- */
-template <typename Fn>
-void apply_over_unpacked_dim(
-    const Fn& fn,
-    const exec_aten::Tensor& in,
-    const int64_t& dim) {
-  if (in.numel() == 0) {
-    return;
-  }
+// The minimum number of elements that each parallel_for chunk converts.
+constexpr int64_t kDequantizeGrainSize = 32768;
 
-  ET_CHECK_MSG(in.dim() > 0, "Input tensor must have at least one dimension");
-  ET_CHECK_VALID_DIM(dim, in.dim());
-
-  const size_t d = ET_NORMALIZE_IX(dim, in.dim());
-  const size_t dim_size = in.size(d);
-  const size_t outer_size = getLeadingDims(in, d);
-  const size_t inner_size = getTrailingDims(in, d);
-  // Loop through all outer dimensions
-  for (size_t outer_idx = 0; outer_idx < outer_size; ++outer_idx) {
-    // Loop through dim
-    for (size_t unpacked_dim_idx = 0; unpacked_dim_idx < dim_size;
-         ++unpacked_dim_idx) {
-      fn(inner_size, outer_idx, unpacked_dim_idx);
-    }
-  }
+template <typename Func>
+void parallel_for_each_chunk(int64_t end, int64_t grain, const Func& f) {
+#ifdef ET_USE_THREADPOOL
+  executorch::extension::parallel_for(0, end, std::max<int64_t>(1, grain), f);
+#else
+  f(0, end);
+#endif
+}
+
+#if defined(__aarch64__) || defined(__ARM_NEON)
+inline int32x4x2_t load_as_int32x8(const int8_t* in) {
+  const int16x8_t v = vmovl_s8(vld1_s8(in));
+  return {{vmovl_s16(vget_low_s16(v)), vmovl_s16(vget_high_s16(v))}};
+}
+
+inline int32x4x2_t load_as_int32x8(const uint8_t* in) {
+  const int16x8_t v = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(in)));
+  return {{vmovl_s16(vget_low_s16(v)), vmovl_s16(vget_high_s16(v))}};
 }
 
+inline int32x4x2_t load_as_int32x8(const int16_t* in) {
+  const int16x8_t v = vld1q_s16(in);
+  return {{vmovl_s16(vget_low_s16(v)), vmovl_s16(vget_high_s16(v))}};
+}
+#elif defined(__AVX2__)
+inline __m256i load_as_int32x8(const int8_t* in) {
+  return _mm256_cvtepi8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)));
+}
+
+inline __m256i load_as_int32x8(const uint8_t* in) {
+  return _mm256_cvtepu8_epi32(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)));
+}
+
+inline __m256i load_as_int32x8(const int16_t* in) {
+  return _mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+}
+#endif
+
+/**
+ * Computes out[i] = (in[i] - zero_point) * scale for i < numel, with the same
+ * rounding as the scalar loops of dequantize_per_tensor_out().
+ */
+template <typename T>
 void dequantize_optimized(
-    const int8_t* in,
-    const double scale,
-    const int64_t zero_point,
+    const T* in,
+    const float scale,
+    const int32_t zero_point,
     float* out,
-    int64_t quant_min,
-    int64_t quant_max,
     size_t numel) {
-  ET_CHECK_MSG(
-      zero_point >= quant_min,
-      "zero_point must be %" PRId64 " <= quant_min %" PRId64,
-      zero_point,
-      quant_min);
-  ET_CHECK_MSG(
-      zero_point <= quant_max,
-      "zero_point must be %" PRId64 " >= quant_max %" PRId64,
-      zero_point,
-      quant_max);
   size_t i = 0;
 #if defined(__aarch64__) || defined(__ARM_NEON)
-  int8x8_t zero_point_vec = vdup_n_s8(zero_point);
-  float32x4_t scales = vdupq_n_f32(static_cast<float>(scale));
-  constexpr int32_t kVecSize = 16;
-  const size_t num_vecs = numel / kVecSize;
-  const int8_t* in_copy = in;
-  float* out_copy = out;
-  for (; i < num_vecs; i++) {
-    int8x16_t in_vec = vld1q_s8(in_copy);
-    int16x8_t sub_vec_0_7 = vsubl_s8(vget_low_s8(in_vec), zero_point_vec);
-    int32x4_t sub_vec_0_3 = vmovl_s16(vget_low_s16(sub_vec_0_7));
-    int32x4_t sub_vec_4_7 = vmovl_s16(vget_high_s16(sub_vec_0_7));
-    float32x4_t out_vec_0_3 = vmulq_f32(vcvtq_f32_s32(sub_vec_0_3), scales);
-    float32x4_t out_vec_4_7 = vmulq_f32(vcvtq_f32_s32(sub_vec_4_7), scales);
-
-    int16x8_t sub_vec_8_15 = vsubl_s8(vget_high_s8(in_vec), zero_point_vec);
-    int32x4_t sub_vec_8_11 = vmovl_s16(vget_low_s16(sub_vec_8_15));
-    int32x4_t sub_vec_12_15 = vmovl_s16(vget_high_s16(sub_vec_8_15));
-    float32x4_t out_vec_8_11 = vmulq_f32(vcvtq_f32_s32(sub_vec_8_11), scales);
-    float32x4_t out_vec_12_15 = vmulq_f32(vcvtq_f32_s32(sub_vec_12_15), scales);
-    vst1q_f32(out_copy + 0, out_vec_0_3);
-    vst1q_f32(out_copy + 4, out_vec_4_7);
-    vst1q_f32(out_copy + 8, out_vec_8_11);
-    vst1q_f32(out_copy + 12, out_vec_12_15);
-    in_copy += kVecSize;
-    out_copy += kVecSize;
+  const int32x4_t zero_point_vec = vdupq_n_s32(zero_point);
+  const float32x4_t scale_vec = vdupq_n_f32(scale);
+  for (; i + 8 <= numel; i += 8) {
+    const int32x4x2_t in_vec = load_as_int32x8(in + i);
+    vst1q_f32(
+        out + i,
+        vmulq_f32(
+            vcvtq_f32_s32(vsubq_s32(in_vec.val[0], zero_point_vec)),
+            scale_vec));
+    vst1q_f32(
+        out + i + 4,
+        vmulq_f32(
+            vcvtq_f32_s32(vsubq_s32(in_vec.val[1], zero_point_vec)),
+            scale_vec));
+  }
+#elif defined(__AVX2__)
+  const __m256i zero_point_vec = _mm256_set1_epi32(zero_point);
+  const __m256 scale_vec = _mm256_set1_ps(scale);
+  for (; i + 8 <= numel; i += 8) {
+    const __m256i in_vec = load_as_int32x8(in + i);
+    _mm256_storeu_ps(
+        out + i,
+        _mm256_mul_ps(
+            _mm256_cvtepi32_ps(_mm256_sub_epi32(in_vec, zero_point_vec)),
+            scale_vec));
   }
-  i = i * kVecSize;
 #endif
   for (; i < numel; i++) {
-    out[i] = (in[i] - zero_point) * scale;
+    out[i] = (static_cast<int32_t>(in[i]) - zero_point) * scale;
   }
 }
 
+/**
+ * Returns true if dequantize_optimized() supports converting `in_dtype` to
+ * `out_dtype`.
+ */
+bool is_optimized_dequantize_type(ScalarType in_dtype, ScalarType out_dtype) {
+  return out_dtype == ScalarType::Float &&
+      (in_dtype == ScalarType::Char || in_dtype == ScalarType::Byte ||
+       in_dtype == ScalarType::Short);
+}
+
+/**
+ * Runs dequantize_optimized() over all of `in`, in parallel when a threadpool
+ * is available.
+ */
+template <typename T>
+void dequantize_per_tensor_optimized(
+    const Tensor& in,
+    float scale,
+    int32_t zero_point,
+    Tensor& out) {
+  const T* in_data = in.const_data_ptr<T>();
+  float* out_data = out.mutable_data_ptr<float>();
+  parallel_for_each_chunk(
+      in.numel(), kDequantizeGrainSize, [&](int64_t begin, int64_t end) {
+        dequantize_optimized<T>(
+            in_data + begin, scale, zero_point, out_data + begin, end - begin);
+      });
+}
+
 float get_scale(const Tensor& scale, size_t channel_ix) {
   ET_CHECK_MSG(
       (scale.scalar_type() == ScalarType::Double) ||
@@ -178,13 +217,15 @@ bool can_use_optimized_dequantize_per_channel(
   is_contiguous = executorch::runtime::is_contiguous_dim_order(
       in.dim_order().data(), in.dim());
 #endif
-  if (!is_contiguous || (in_dtype != ScalarType::Char) ||
-      (out_dtype.has_value() && out_dtype.value() != ScalarType::Float)) {
+  const ScalarType float_dtype =
+      out_dtype.has_value() ? out_dtype.value() : ScalarType::Float;
+  if (!is_contiguous || !is_optimized_dequantize_type(in_dtype, float_dtype)) {
     return false;
   }
   return true;
 }
 
+template <typename T>
 void dequantize_per_channel_optimized(
     const Tensor& in,
     const Tensor& scales,
@@ -192,57 +233,72 @@ void dequantize_per_channel_optimized(
     Tensor& out,
     int64_t axis,
     int64_t quant_min,
-    int64_t quant_max,
-    ScalarType in_dtype,
-    exec_aten::optional<ScalarType>& out_dtype) {
-  check_dequantize_per_tensor_args(
-      in, quant_min, quant_max, in_dtype, out_dtype, out);
-  ET_CHECK_MSG(
-      in_dtype == ScalarType::Char,
-      "in.scalar_type() %" PRId8 " is not supported:",
-      static_cast<int8_t>(in.scalar_type()));
-  if (out_dtype.has_value()) {
-    ET_CHECK_MSG(
-        out_dtype.value() == ScalarType::Float,
-        "Only float output is supported");
-  }
-  const int8_t* in_data = in.const_data_ptr<int8_t>();
+    int64_t quant_max) {
+  const T* in_data = in.const_data_ptr<T>();
   float* out_data = out.mutable_data_ptr<float>();
   const int64_t* zero_points_data = nullptr;
   if (opt_zero_points.has_value()) {
     zero_points_data = opt_zero_points.value().const_data_ptr<int64_t>();
   }
-  const StridesType axis_stride = in.strides()[axis];
-  const StridesType outer_stride = in.size(axis) * axis_stride;
-  apply_over_unpacked_dim(
-      [in_data,
-       out_data,
-       &scales,
-       zero_points_data,
-       axis_stride,
-       outer_stride,
-       quant_min,
-       quant_max](
-          SizesType numel, SizesType outer_idx, SizesType unpacked_dim_idx) {
-        const int8_t* in_data_local =
-            in_data + outer_idx * outer_stride + unpacked_dim_idx * axis_stride;
-        const double scale = get_scale(scales, unpacked_dim_idx);
-        const int64_t zero_point = zero_points_data != nullptr
-            ? zero_points_data[unpacked_dim_idx]
-            : 0;
-        float* out_data_local = out_data + outer_idx * outer_stride +
-            unpacked_dim_idx * axis_stride;
-        dequantize_optimized(
-            in_data_local,
-            scale,
-            zero_point,
-            out_data_local,
-            quant_min,
-            quant_max,
-            numel);
-      },
-      in,
-      axis);
+  const int64_t dim_size = in.size(axis);
+  for (int64_t channel_ix = 0; channel_ix < dim_size; ++channel_ix) {
+    const int64_t zero_point =
+        zero_points_data != nullptr ? zero_points_data[channel_ix] : 0;
+    ET_CHECK_MSG(
+        zero_point >= quant_min,
+        "zero_point must be %" PRId64 " <= quant_min %" PRId64,
+        zero_point,
+        quant_min);
+    ET_CHECK_MSG(
+        zero_point <= quant_max,
+        "zero_point must be %" PRId64 " >= quant_max %" PRId64,
+        zero_point,
+        quant_max);
+  }
+  const auto zero_point_at = [zero_points_data](int64_t channel_ix) {
+    return zero_points_data != nullptr
+        ? static_cast<int32_t>(zero_points_data[channel_ix])
+        : 0;
+  };
+
+  const int64_t inner_size = getTrailingDims(in, axis);
+  if (inner_size == 1) {
+    // Every row along the last dimension sees every channel's scale.
+    const int64_t num_rows = getLeadingDims(in, axis);
+    parallel_for_each_chunk(
+        num_rows,
+        kDequantizeGrainSize / std::max<int64_t>(1, dim_size),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; ++row) {
+            const T* in_row = in_data + row * dim_size;
+            float* out_row = out_data + row * dim_size;
+            for (int64_t c = 0; c < dim_size; ++c) {
+              out_row[c] =
+                  (static_cast<int32_t>(in_row[c]) - zero_point_at(c)) *
+                  get_scale(scales, c);
+            }
+          }
+        });
+    return;
+  }
+
+  // Each of the getLeadingDims() * dim_size blocks of inner_size contiguous
+  // elements shares one scale and zero point.
+  const int64_t num_blocks = getLeadingDims(in, axis) * dim_size;
+  parallel_for_each_chunk(
+      num_blocks,
+      kDequantizeGrainSize / inner_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; ++block) {
+          const int64_t channel_ix = block % dim_size;
+          dequantize_optimized<T>(
+              in_data + block * inner_size,
+              get_scale(scales, channel_ix),
+              zero_point_at(channel_ix),
+              out_data + block * inner_size,
+              inner_size);
+        }
+      });
 }
 
 } // namespace
@@ -273,6 +329,22 @@ Tensor& dequantize_per_tensor_out(
   check_dequantize_per_tensor_args(
       input, quant_min, quant_max, dtype, out_dtype, out);
 
+  if (is_optimized_dequantize_type(input.scalar_type(), out.scalar_type())) {
+    const float float_scale = static_cast<float>(scale);
+    const int32_t int_zero_point = static_cast<int32_t>(zero_point);
+    if (input.scalar_type() == ScalarType::Char) {
+      dequantize_per_tensor_optimized<int8_t>(
+          input, float_scale, int_zero_point, out);
+    } else if (input.scalar_type() == ScalarType::Byte) {
+      dequantize_per_tensor_optimized<uint8_t>(
+          input, float_scale, int_zero_point, out);
+    } else {
+      dequantize_per_tensor_optimized<int16_t>(
+          input, float_scale, int_zero_point, out);
+    }
+    return out;
+  }
+
   // calculate the dequantized output, cast scale to float to match fbgemm
   // behavior
 #define DEQUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)                        \
@@ -399,16 +471,16 @@ Tensor& dequantize_per_channel_out(
       input, quant_min, quant_max, dtype, out_dtype, out);
 
   if (can_use_optimized_dequantize_per_channel(input, dtype, out_dtype)) {
-    dequantize_per_channel_optimized(
-        input,
-        scale,
-        opt_zero_points,
-        out,
-        axis,
-        quant_min,
-        quant_max,
-        dtype,
-        out_dtype);
+    if (dtype == ScalarType::Char) {
+      dequantize_per_channel_optimized<int8_t>(
+          input, scale, opt_zero_points, out, axis, quant_min, quant_max);
+    } else if (dtype == ScalarType::Byte) {
+      dequantize_per_channel_optimized<uint8_t>(
+          input, scale, opt_zero_points, out, axis, quant_min, quant_max);
+    } else {
+      dequantize_per_channel_optimized<int16_t>(
+          input, scale, opt_zero_points, out, axis, quant_min, quant_max);
+    }
     return out;
   }
 
@@ -7,8 +7,11 @@
  */
 
 #include <executorch/kernels/portable/cpu/vec_ops.h>
+#include <executorch/kernels/quantized/cpu/mixed_matmul.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
+#include <type_traits>
+
 namespace torch {
 namespace executor {
 namespace native {
@@ -94,6 +97,18 @@ Tensor& quantized_mixed_linear_out(
         g = (n + weight_scales.size(1) - 1) / weight_scales.size(1);
       };
 
+      if constexpr (std::is_same_v<CTYPE, float>) {
+        mixed_matmul::quantized_matmul_transb_int8(
+            out.mutable_data_ptr<CTYPE_OUT>(),
+            in.const_data_ptr<float>(),
+            weight.const_data_ptr<int8_t>(),
+            weight_scales.const_data_ptr<float>(),
+            m,
+            n,
+            p,
+            g);
+        return;
+      }
       // FIXME: this currently ignores dtype
       vec_quantized_matmul_transb_int8<
           CTYPE_OUT, // T *z
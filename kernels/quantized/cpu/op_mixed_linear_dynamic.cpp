@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/cpu/mixed_matmul.h>
+#include <executorch/runtime/kernel/kernel_includes.h>
+
+namespace torch {
+namespace executor {
+namespace native {
+
+using Tensor = exec_aten::Tensor;
+
+namespace {
+
+bool check_quantized_mixed_linear_dynamic_args(
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const exec_aten::optional<Tensor>& opt_weight_zero_points,
+    Tensor& out) {
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(in, 2));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(weight, 2));
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensor_is_rank(weight_scales, 1) || tensor_is_rank(weight_scales, 2));
+  ET_LOG_AND_RETURN_IF_FALSE(tensor_is_rank(out, 2));
+
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_size_at_dims(in, 1, weight, 1));
+  ET_LOG_AND_RETURN_IF_FALSE(
+      tensors_have_same_size_at_dims(weight_scales, 0, weight, 0));
+
+  ET_LOG_AND_RETURN_IF_FALSE(tensors_have_same_dtype(in, weight_scales, out));
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      weight.scalar_type() == ScalarType::Char, "weight dtype must be int8");
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      in.scalar_type() == ScalarType::Float, "input dtype must be Float");
+
+  // Support for non-null zero points is not implemented yet.
+  ET_LOG_MSG_AND_RETURN_IF_FALSE(
+      !opt_weight_zero_points.has_value(), "zero points not supported yet.");
+  return true;
+}
+
+} // namespace
+
+Tensor& quantized_mixed_linear_dynamic_out(
+    KernelRuntimeContext& ctx,
+    const Tensor& in,
+    const Tensor& weight,
+    const Tensor& weight_scales,
+    const exec_aten::optional<Tensor>& opt_weight_zero_points,
+    Tensor& out) {
+  ET_KERNEL_CHECK(
+      ctx,
+      check_quantized_mixed_linear_dynamic_args(
+          in, weight, weight_scales, opt_weight_zero_points, out),
+      InvalidArgument,
+      out);
+
+  size_t output_ndim = 2;
+  exec_aten::SizesType output_sizes[kTensorDimensionLimit];
+  output_sizes[0] = in.size(0);
+  output_sizes[1] = weight.size(0);
+
+  ET_KERNEL_CHECK(
+      ctx,
+      resize_tensor(out, {output_sizes, output_ndim}) == Error::Ok,
+      InvalidArgument,
+      out);
+
+  const int64_t m = in.size(0);
+  const int64_t n = in.size(1);
+  const int64_t p = weight.size(0);
+  int64_t g = n;
+  if (weight_scales.dim() == 2) {
+    g = (n + weight_scales.size(1) - 1) / weight_scales.size(1);
+  }
+
+  // Scratch space for the activations quantized to int8, and their scales.
+  Result<void*> x_scales = ctx.allocate_temp(m * sizeof(float));
+  ET_KERNEL_CHECK(ctx, x_scales.ok(), MemoryAllocationFailed, out);
+  Result<void*> xq = ctx.allocate_temp(m * n, /*alignment=*/64);
+  ET_KERNEL_CHECK(ctx, xq.ok(), MemoryAllocationFailed, out);
+
+  mixed_matmul::quantized_matmul_transb_int8_dynamic(
+      out.mutable_data_ptr<float>(),
+      in.const_data_ptr<float>(),
+      weight.const_data_ptr<int8_t>(),
+      weight_scales.const_data_ptr<float>(),
+      static_cast<int8_t*>(xq.get()),
+      static_cast<float*>(x_scales.get()),
+      m,
+      n,
+      p,
+      g);
+
+  return out;
+}
+
+} // namespace native
+} // namespace executor
+} // namespace torch
@@ -7,8 +7,11 @@
  */
 
 #include <executorch/kernels/portable/cpu/vec_ops.h>
+#include <executorch/kernels/quantized/cpu/mixed_matmul.h>
 #include <executorch/runtime/kernel/kernel_includes.h>
 
+#include <type_traits>
+
 namespace torch {
 namespace executor {
 namespace native {
@@ -74,6 +77,17 @@ Tensor& quantized_mixed_mm_out(
     size_t n = in.size(1);
     size_t p = weight.size(1);
 
+    if constexpr (std::is_same_v<CTYPE, float>) {
+      mixed_matmul::quantized_matmul_int8(
+          out.mutable_data_ptr<float>(),
+          in.const_data_ptr<float>(),
+          weight.const_data_ptr<int8_t>(),
+          weight_scales.const_data_ptr<float>(),
+          m,
+          n,
+          p);
+      return;
+    }
     vec_quantized_matmul_int8<CTYPE>(
         out.mutable_data_ptr<CTYPE>(),
         in.const_data_ptr<CTYPE>(),
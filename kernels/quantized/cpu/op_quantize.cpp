@@ -12,6 +12,16 @@
 #include <cinttypes>
 #include <cmath>
 
+#ifdef ET_USE_THREADPOOL
+#include <executorch/extension/parallel/thread_parallel.h>
+#endif
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 /**
  * For an input tensor, use the scale and zero_point arguments to quantize it.
  */
@@ -105,6 +115,210 @@ T quantize_val(
   return static_cast<T>(qvalue);
 }
 
+namespace {
+
+// The minimum number of elements that each parallel_for chunk converts.
+constexpr int64_t kQuantizeGrainSize = 32768;
+
+template <typename Func>
+void parallel_for_each_chunk(int64_t end, int64_t grain, const Func& f) {
+#ifdef ET_USE_THREADPOOL
+  executorch::extension::parallel_for(0, end, std::max<int64_t>(1, grain), f);
+#else
+  f(0, end);
+#endif
+}
+
+#if defined(__aarch64__)
+// vcvtnq_s32_f32 rounds to nearest even like std::nearbyint, but is only
+// available from ARMv8.
+inline void store_int32x8(int32x4_t lo, int32x4_t hi, int8_t* out) {
+  vst1_s8(out, vqmovn_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))));
+}
+
+inline void store_int32x8(int32x4_t lo, int32x4_t hi, uint8_t* out) {
+  vst1_u8(out, vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))));
+}
+
+inline void store_int32x8(int32x4_t lo, int32x4_t hi, int16_t* out) {
+  vst1q_s16(out, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+}
+#elif defined(__AVX2__)
+inline __m128i pack_int32x8(__m256i v) {
+  return _mm_packs_epi32(
+      _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+inline void store_int32x8(__m256i v, int8_t* out) {
+  const __m128i v16 = pack_int32x8(v);
+  _mm_storel_epi64(
+      reinterpret_cast<__m128i*>(out), _mm_packs_epi16(v16, v16));
+}
+
+inline void store_int32x8(__m256i v, uint8_t* out) {
+  const __m128i v16 = pack_int32x8(v);
+  _mm_storel_epi64(
+      reinterpret_cast<__m128i*>(out), _mm_packus_epi16(v16, v16));
+}
+
+inline void store_int32x8(__m256i v, int16_t* out) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), pack_int32x8(v));
+}
+#endif
+
+/**
+ * Computes out[i] = quantize_val<T, float>(scale, zero_point, in[i],
+ * quant_min, quant_max) for i < numel.
+ */
+template <typename T>
+void quantize_optimized(
+    const float* in,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    T* out,
+    size_t numel) {
+  size_t i = 0;
+#if defined(__aarch64__) || defined(__AVX2__)
+  const float inv_scale = 1.0f / static_cast<float>(scale);
+  // Clamping before rounding gives the same result as clamping after, since
+  // the bounds are integers, and keeps the conversion to int32 in range.
+  const float min_value = static_cast<float>(quant_min - zero_point);
+  const float max_value = static_cast<float>(quant_max - zero_point);
+#endif
+#if defined(__aarch64__)
+  const float32x4_t inv_scale_vec = vdupq_n_f32(inv_scale);
+  const float32x4_t min_vec = vdupq_n_f32(min_value);
+  const float32x4_t max_vec = vdupq_n_f32(max_value);
+  const int32x4_t zero_point_vec =
+      vdupq_n_s32(static_cast<int32_t>(zero_point));
+  const auto quantize = [&](float32x4_t v) {
+    v = vminq_f32(vmaxq_f32(vmulq_f32(v, inv_scale_vec), min_vec), max_vec);
+    return vaddq_s32(vcvtnq_s32_f32(v), zero_point_vec);
+  };
+  for (; i + 8 <= numel; i += 8) {
+    store_int32x8(
+        quantize(vld1q_f32(in + i)), quantize(vld1q_f32(in + i + 4)), out + i);
+  }
+#elif defined(__AVX2__)
+  const __m256 inv_scale_vec = _mm256_set1_ps(inv_scale);
+  const __m256 min_vec = _mm256_set1_ps(min_value);
+  const __m256 max_vec = _mm256_set1_ps(max_value);
+  const __m256i zero_point_vec =
+      _mm256_set1_epi32(static_cast<int32_t>(zero_point));
+  for (; i + 8 <= numel; i += 8) {
+    __m256 v = _mm256_mul_ps(_mm256_loadu_ps(in + i), inv_scale_vec);
+    v = _mm256_min_ps(_mm256_max_ps(v, min_vec), max_vec);
+    // Converts with the default round-to-nearest-even mode, like
+    // std::nearbyint.
+    store_int32x8(
+        _mm256_add_epi32(_mm256_cvtps_epi32(v), zero_point_vec), out + i);
+  }
+#endif
+  for (; i < numel; i++) {
+    out[i] = quantize_val<T, float>(
+        scale, zero_point, in[i], quant_min, quant_max);
+  }
+}
+
+/**
+ * Returns true if quantize_optimized() supports converting `in_dtype` to
+ * `out_dtype`.
+ */
+bool is_optimized_quantize_type(ScalarType in_dtype, ScalarType out_dtype) {
+  return in_dtype == ScalarType::Float &&
+      (out_dtype == ScalarType::Char || out_dtype == ScalarType::Byte ||
+       out_dtype == ScalarType::Short);
+}
+
+template <typename T>
+void quantize_per_tensor_optimized(
+    const Tensor& in,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  const float* in_data = in.const_data_ptr<float>();
+  T* out_data = out.mutable_data_ptr<T>();
+  parallel_for_each_chunk(
+      in.numel(), kQuantizeGrainSize, [&](int64_t begin, int64_t end) {
+        quantize_optimized<T>(
+            in_data + begin,
+            scale,
+            zero_point,
+            quant_min,
+            quant_max,
+            out_data + begin,
+            end - begin);
+      });
+}
+
+template <typename T>
+void quantize_per_channel_optimized(
+    const Tensor& in,
+    const double* scale_data,
+    const int64_t* zero_point_data,
+    int64_t axis,
+    int64_t quant_min,
+    int64_t quant_max,
+    Tensor& out) {
+  const float* in_data = in.const_data_ptr<float>();
+  T* out_data = out.mutable_data_ptr<T>();
+  const int64_t dim_size = in.size(axis);
+  const int64_t inner_size = getTrailingDims(in, axis);
+  if (inner_size == 1) {
+    // Every row along the last dimension sees every channel's scale.
+    parallel_for_each_chunk(
+        getLeadingDims(in, axis),
+        kQuantizeGrainSize / std::max<int64_t>(1, dim_size),
+        [&](int64_t begin, int64_t end) {
+          for (int64_t row = begin; row < end; ++row) {
+            for (int64_t c = 0; c < dim_size; ++c) {
+              out_data[row * dim_size + c] = quantize_val<T, float>(
+                  scale_data[c],
+                  zero_point_data[c],
+                  in_data[row * dim_size + c],
+                  quant_min,
+                  quant_max);
+            }
+          }
+        });
+    return;
+  }
+
+  // Each of the getLeadingDims() * dim_size blocks of inner_size contiguous
+  // elements shares one scale and zero point.
+  parallel_for_each_chunk(
+      getLeadingDims(in, axis) * dim_size,
+      kQuantizeGrainSize / inner_size,
+      [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end; ++block) {
+          const int64_t channel_ix = block % dim_size;
+          quantize_optimized<T>(
+              in_data + block * inner_size,
+              scale_data[channel_ix],
+              zero_point_data[channel_ix],
+              quant_min,
+              quant_max,
+              out_data + block * inner_size,
+              inner_size);
+        }
+      });
+}
+
+bool is_contiguous(const Tensor& in) {
+#ifdef USE_ATEN_LIB
+  return in.is_contiguous();
+#else
+  return executorch::runtime::is_contiguous_dim_order(
+      in.dim_order().data(), in.dim());
+#endif
+}
+
+} // namespace
+
 Tensor& quantize_per_tensor_out(
     const Tensor& input,
     double scale,
@@ -120,6 +334,20 @@ Tensor& quantize_per_tensor_out(
 
   check_quantize_per_tensor_args(input, quant_min, quant_max, dtype, out);
 
+  if (is_optimized_quantize_type(input.scalar_type(), out.scalar_type())) {
+    if (dtype == ScalarType::Char) {
+      quantize_per_tensor_optimized<int8_t>(
+          input, scale, zero_point, quant_min, quant_max, out);
+    } else if (dtype == ScalarType::Byte) {
+      quantize_per_tensor_optimized<uint8_t>(
+          input, scale, zero_point, quant_min, quant_max, out);
+    } else {
+      quantize_per_tensor_optimized<int16_t>(
+          input, scale, zero_point, quant_min, quant_max, out);
+    }
+    return out;
+  }
+
   // calculate the quantized input
 #define QUANTIZE_IMPL(IN_CTYPE, OUT_CTYPE, out_dtype)                          \
   case ScalarType::out_dtype: {                                                \
@@ -293,6 +521,21 @@ Tensor& quantize_per_channel_out(
   const double* scale_data = scale.const_data_ptr<double>();
   const int64_t* zero_point_data = zero_point.const_data_ptr<int64_t>();
 
+  if (is_contiguous(input) &&
+      is_optimized_quantize_type(input.scalar_type(), out.scalar_type())) {
+    if (dtype == ScalarType::Char) {
+      quantize_per_channel_optimized<int8_t>(
+          input, scale_data, zero_point_data, axis, quant_min, quant_max, out);
+    } else if (dtype == ScalarType::Byte) {
+      quantize_per_channel_optimized<uint8_t>(
+          input, scale_data, zero_point_data, axis, quant_min, quant_max, out);
+    } else {
+      quantize_per_channel_optimized<int16_t>(
+          input, scale_data, zero_point_data, axis, quant_min, quant_max, out);
+    }
+    return out;
+  }
+
   exec_aten::optional<exec_aten::ArrayRef<int64_t>> optional_dim_list{
       exec_aten::ArrayRef<int64_t>{dims, size_t(input.dim() - 1)}};
 
@@ -14,9 +14,11 @@ _QUANT_OPS = (
     op_target(
         name = "op_dequantize",
         deps = [
+            "//executorch/extension/parallel:thread_parallel",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
         _aten_mode_deps = [
+            "//executorch/extension/parallel:thread_parallel_aten",
             "//executorch/kernels/portable/cpu/util:reduce_util_aten",
         ],
     ),
@@ -41,20 +43,41 @@ _QUANT_OPS = (
         name = "op_mixed_mm",
         deps = [
             "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/quantized/cpu:mixed_matmul",
+        ],
+        _aten_mode_deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/quantized/cpu:mixed_matmul_aten",
         ],
     ),
     op_target(
         name = "op_mixed_linear",
         deps = [
             "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/quantized/cpu:mixed_matmul",
+        ],
+        _aten_mode_deps = [
+            "//executorch/kernels/portable/cpu:vec_ops",
+            "//executorch/kernels/quantized/cpu:mixed_matmul_aten",
+        ],
+    ),
+    op_target(
+        name = "op_mixed_linear_dynamic",
+        deps = [
+            "//executorch/kernels/quantized/cpu:mixed_matmul",
+        ],
+        _aten_mode_deps = [
+            "//executorch/kernels/quantized/cpu:mixed_matmul_aten",
         ],
     ),
     op_target(
         name = "op_quantize",
         deps = [
+            "//executorch/extension/parallel:thread_parallel",
             "//executorch/kernels/portable/cpu/util:reduce_util",
         ],
         _aten_mode_deps = [
+            "//executorch/extension/parallel:thread_parallel_aten",
             "//executorch/kernels/portable/cpu/util:reduce_util_aten",
         ],
     ),
@@ -83,7 +106,10 @@ def define_common_targets():
         visibility = [
             "//executorch/kernels/quantized/...",
         ],
-        deps = ["//executorch/runtime/kernel:kernel_includes"],
+        deps = [
+            "//executorch/extension/parallel:thread_parallel",
+            "//executorch/runtime/kernel:kernel_includes",
+        ],
     )
 
     runtime.cxx_library(
@@ -93,7 +119,34 @@ def define_common_targets():
         visibility = [
             "//executorch/kernels/quantized/...",
         ],
-        deps = ["//executorch/runtime/kernel:kernel_includes_aten"],
+        deps = [
+            "//executorch/extension/parallel:thread_parallel_aten",
+            "//executorch/runtime/kernel:kernel_includes_aten",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "mixed_matmul",
+        srcs = [],
+        exported_headers = ["mixed_matmul.h"],
+        visibility = [
+            "//executorch/kernels/quantized/...",
+        ],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel",
+        ],
+    )
+
+    runtime.cxx_library(
+        name = "mixed_matmul_aten",
+        srcs = [],
+        exported_headers = ["mixed_matmul.h"],
+        visibility = [
+            "//executorch/kernels/quantized/...",
+        ],
+        exported_deps = [
+            "//executorch/extension/parallel:thread_parallel_aten",
+        ],
     )
 
     runtime.cxx_library(
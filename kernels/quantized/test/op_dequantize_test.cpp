@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -229,3 +230,85 @@ TEST(OpDequantizeOutTest, DequantizePerChannel) {
   test_per_channel_dtype<ScalarType::Byte>();
   test_per_channel_dtype<ScalarType::Char>();
 }
+
+namespace {
+
+/// Checks dequantize_per_tensor_out and dequantize_per_channel_out against
+/// the scalar formula, with sizes that are not a multiple of the vector width.
+template <ScalarType DTYPE>
+void test_against_reference(int64_t quant_min, int64_t quant_max) {
+  using CTYPE = typename TensorFactory<DTYPE>::ctype;
+  TensorFactory<DTYPE> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+  TensorFactory<ScalarType::Float> tfo;
+
+  const std::vector<int32_t> sizes = {3, 5, 21};
+  const int32_t numel = 3 * 5 * 21;
+  std::vector<CTYPE> input_data(numel);
+  for (int32_t i = 0; i < numel; ++i) {
+    input_data[i] =
+        static_cast<CTYPE>(quant_min + (i * 37) % (quant_max - quant_min + 1));
+  }
+  Tensor input = tf.make(sizes, input_data);
+
+  // Per tensor.
+  {
+    const double scale = 0.1;
+    const int64_t zero_point = (quant_min + quant_max) / 2 + 3;
+    std::vector<float> expected_data(numel);
+    for (int32_t i = 0; i < numel; ++i) {
+      expected_data[i] = (input_data[i] - static_cast<int32_t>(zero_point)) *
+          static_cast<float>(scale);
+    }
+    Tensor out = tfo.zeros(sizes);
+    dequantize_per_tensor_out(
+        input,
+        scale,
+        zero_point,
+        quant_min,
+        quant_max,
+        DTYPE,
+        optional<ScalarType>(),
+        out);
+    EXPECT_TENSOR_EQ(out, tfo.make(sizes, expected_data));
+  }
+
+  // Per channel, along an inner and the last dimension.
+  for (int64_t axis : {1, 2}) {
+    const int32_t channels = sizes[axis];
+    std::vector<double> scales(channels);
+    std::vector<int64_t> zero_points(channels);
+    for (int32_t c = 0; c < channels; ++c) {
+      scales[c] = 0.1 * (c % 3 + 1);
+      zero_points[c] = quant_min + (c * 7) % (quant_max - quant_min + 1);
+    }
+    std::vector<float> expected_data(numel);
+    for (int32_t i = 0; i < numel; ++i) {
+      const int32_t c = axis == 1 ? (i / 21) % 5 : i % 21;
+      expected_data[i] = (input_data[i] - zero_points[c]) *
+          static_cast<float>(scales[c]);
+    }
+    Tensor out = tfo.zeros(sizes);
+    dequantize_per_channel_out(
+        input,
+        tf_double.make({channels}, scales),
+        tf_long.make({channels}, zero_points),
+        axis,
+        quant_min,
+        quant_max,
+        DTYPE,
+        optional<ScalarType>(),
+        out);
+    EXPECT_TENSOR_EQ(out, tfo.make(sizes, expected_data));
+  }
+}
+
+} // namespace
+
+TEST(OpDequantizeOutTest, LargeTensorMatchesReference) {
+  et_pal_init();
+  test_against_reference<ScalarType::Char>(-128, 127);
+  test_against_reference<ScalarType::Byte>(0, 255);
+  test_against_reference<ScalarType::Short>(-300, 300);
+}
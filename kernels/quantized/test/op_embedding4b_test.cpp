@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -26,6 +27,79 @@ using torch::executor::native::quantized_embedding_4bit_out;
 
 using torch::executor::testing::TensorFactory;
 
+namespace {
+
+// Gathers many embeddings of a large table and compares them to a
+// dequantization of it computed here.
+void test_against_reference(
+    int32_t num_embeddings,
+    int32_t packed_dim,
+    int32_t num_groups,
+    bool with_zero_points) {
+  TensorFactory<ScalarType::Byte> tfb;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  const int32_t embedding_dim = packed_dim * 2;
+  const int32_t group_size = embedding_dim / num_groups;
+  std::vector<uint8_t> qweight_data(num_embeddings * packed_dim);
+  for (size_t i = 0; i < qweight_data.size(); ++i) {
+    qweight_data[i] = static_cast<uint8_t>((i * 37 + 11) % 256);
+  }
+  std::vector<float> scales_data(num_embeddings * num_groups);
+  std::vector<float> zero_points_data(num_embeddings * num_groups, 0);
+  for (size_t i = 0; i < scales_data.size(); ++i) {
+    scales_data[i] = 0.25f * static_cast<float>(i % 7 + 1);
+    if (with_zero_points) {
+      zero_points_data[i] = static_cast<float>(static_cast<int32_t>(i % 5) - 2);
+    }
+  }
+  std::vector<int64_t> indices_data;
+  for (int32_t i = 0; i < 3 * num_embeddings; ++i) {
+    indices_data.push_back((i * 5 + 3) % num_embeddings);
+  }
+
+  std::vector<float> expected_data;
+  for (int64_t row : indices_data) {
+    for (int32_t j = 0; j < embedding_dim; ++j) {
+      const uint8_t packed = qweight_data[row * packed_dim + j / 2];
+      // The high nibble holds the even value.
+      const int32_t q = (j % 2 == 0 ? packed >> 4 : packed & 0x0F) - 8;
+      const int32_t qparams_index = row * num_groups + j / group_size;
+      expected_data.push_back(
+          (static_cast<float>(q) - zero_points_data[qparams_index]) *
+          scales_data[qparams_index]);
+    }
+  }
+
+  Tensor qweight = tfb.make({num_embeddings, packed_dim}, qweight_data);
+  const std::vector<int32_t> qparams_sizes = num_groups == 1
+      ? std::vector<int32_t>{num_embeddings}
+      : std::vector<int32_t>{num_embeddings, num_groups};
+  Tensor weight_scales = tf.make(qparams_sizes, scales_data);
+  optional<Tensor> weight_zero_points;
+  if (with_zero_points) {
+    weight_zero_points = tf.make(qparams_sizes, zero_points_data);
+  }
+  const int32_t num_indices = indices_data.size();
+  Tensor indices = tfl.make({num_indices}, indices_data);
+  Tensor out = tf.zeros({num_indices, embedding_dim});
+
+  quantized_embedding_4bit_out(
+      qweight,
+      weight_scales,
+      weight_zero_points,
+      -8,
+      7,
+      indices,
+      out);
+
+  EXPECT_TENSOR_EQ(
+      out, tf.make({num_indices, embedding_dim}, expected_data));
+}
+
+} // namespace
+
 TEST(OpQuantizedEmbedding4bTest, TestGroupWiseQuantizedEmbedding) {
   et_pal_init();
   TensorFactory<ScalarType::Byte> tfb;
@@ -154,3 +228,13 @@ TEST(OpQuantizedEmbedding4bTest, TestGroupWiseQuantizedEmbeddingDeath2) {
           out),
       "");
 }
+
+TEST(OpQuantizedEmbedding4bTest, TestLargeTableMatchesReference) {
+  et_pal_init();
+  // Per channel, with rows longer than a vector.
+  test_against_reference(40, 100, 1, true);
+  // Groupwise, without zero points.
+  test_against_reference(64, 48, 6, false);
+  // Groups that start in the middle of a byte.
+  test_against_reference(9, 3, 6, true);
+}
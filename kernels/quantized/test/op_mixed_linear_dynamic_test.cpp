@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/quantized/NativeFunctions.h> // Declares the quantized operator
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+#include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::MemoryAllocator;
+using torch::executor::native::quantized_mixed_linear_dynamic_out;
+using torch::executor::testing::TensorFactory;
+
+class OpQuantizedMixedLinearDynamicTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // Since these tests cause ET_LOG to be called, the PAL must be initialized
+    // first.
+    torch::executor::runtime_init();
+  }
+
+  // Backs the temp allocations of the op, which quantizes the activations
+  // into them.
+  std::vector<uint8_t> temp_buffer_ = std::vector<uint8_t>(64 * 1024);
+  MemoryAllocator temp_allocator_{
+      static_cast<uint32_t>(temp_buffer_.size()),
+      temp_buffer_.data()};
+  KernelRuntimeContext context_{nullptr, &temp_allocator_};
+};
+
+TEST_F(OpQuantizedMixedLinearDynamicTest, ExactlyQuantizableInput) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  // Every input is a multiple of the row's max / 127, so quantizing the
+  // activations loses nothing.
+  Tensor input = tf.make(
+      /*sizes=*/{2, 3},
+      /*data=*/{1.27, -0.5, 0.25, 0.0, 2.54, -1.0});
+  Tensor weight = tf_char.make(
+      /*sizes=*/{2, 3},
+      /*data=*/{5, 3, 1, -128, 2, 127});
+  Tensor weight_scales = tf.make(
+      /*sizes=*/{2},
+      /*data=*/{0.2, 0.4});
+  Tensor out = tf.zeros({2, 2});
+
+  // 0.2 * (1.27 * 5 - 0.5 * 3 + 0.25 * 1) = 1.02
+  // 0.4 * (1.27 * -128 - 0.5 * 2 + 0.25 * 127) = -52.724
+  // 0.2 * (2.54 * 3 - 1.0 * 1) = 1.324
+  // 0.4 * (2.54 * 2 - 1.0 * 127) = -48.768
+  Tensor expected = tf.make({2, 2}, {1.02, -52.724, 1.324, -48.768});
+
+  quantized_mixed_linear_dynamic_out(
+      context_, input, weight, weight_scales, {}, out);
+
+  EXPECT_EQ(context_.failure_state(), torch::executor::Error::Ok);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-4, 1e-4);
+}
+
+TEST_F(OpQuantizedMixedLinearDynamicTest, LargeGroupedMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  // Long enough for the vector loops, with tails, and a zero row whose scale
+  // is zero.
+  const int32_t m = 5;
+  const int32_t n = 301;
+  const int32_t p = 37;
+  const int32_t num_groups = 4;
+  const int32_t g = (n + num_groups - 1) / num_groups;
+
+  std::vector<float> input_data(m * n);
+  std::vector<int8_t> weight_data(p * n);
+  std::vector<float> scales_data(p * num_groups);
+  for (int32_t i = 0; i < m * n; ++i) {
+    input_data[i] = i / n == 2 ? 0.0f : static_cast<float>(i % 29 - 14) / 7;
+  }
+  for (int32_t i = 0; i < p * n; ++i) {
+    weight_data[i] = static_cast<int8_t>((i * 37) % 256 - 128);
+  }
+  for (int32_t i = 0; i < p * num_groups; ++i) {
+    scales_data[i] = static_cast<float>(i % 7 + 1) / 64;
+  }
+
+  // Quantizes the activations the same way as the op, and accumulates in
+  // double.
+  std::vector<float> expected_data(m * p);
+  for (int32_t i = 0; i < m; ++i) {
+    const float* x = input_data.data() + i * n;
+    float amax = 0;
+    for (int32_t k = 0; k < n; ++k) {
+      amax = std::max(amax, std::fabs(x[k]));
+    }
+    const float inv_scale = amax == 0 ? 0 : 127 / amax;
+    for (int32_t j = 0; j < p; ++j) {
+      double sum = 0;
+      for (int32_t k = 0; k < n; ++k) {
+        sum += std::nearbyint(x[k] * inv_scale) * weight_data[j * n + k] *
+            scales_data[j * num_groups + k / g];
+      }
+      expected_data[i * p + j] = static_cast<float>(sum * (amax / 127));
+    }
+  }
+
+  Tensor input = tf.make({m, n}, input_data);
+  Tensor weight = tf_char.make({p, n}, weight_data);
+  Tensor weight_scales = tf.make({p, num_groups}, scales_data);
+  Tensor out = tf.zeros({m, p});
+
+  quantized_mixed_linear_dynamic_out(
+      context_, input, weight, weight_scales, {}, out);
+
+  EXPECT_EQ(context_.failure_state(), torch::executor::Error::Ok);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, tf.make({m, p}, expected_data), 1e-4, 1e-4);
+}
+
+TEST_F(OpQuantizedMixedLinearDynamicTest, FailsWithoutTempMemory) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  Tensor input = tf.ones({1, 3});
+  Tensor weight = tf_char.ones({2, 3});
+  Tensor weight_scales = tf.ones({2});
+  Tensor out = tf.zeros({1, 2});
+
+  KernelRuntimeContext context{};
+  quantized_mixed_linear_dynamic_out(
+      context, input, weight, weight_scales, {}, out);
+
+  EXPECT_EQ(
+      context.failure_state(), torch::executor::Error::MemoryAllocationFailed);
+}
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::optional;
 using exec_aten::ScalarType;
@@ -140,3 +142,51 @@ TEST_F(OpQuantizedMixedDtypeLinearTest, HalfInputHalfOutput_Partials) {
   test_dtype_partials<ScalarType::Half, ScalarType::Half>();
 }
 #endif
+
+TEST_F(OpQuantizedMixedDtypeLinearTest, LargeGroupedMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  // m is not a multiple of the row block, and neither n nor the group size
+  // are multiples of the vector width.
+  const int32_t m = 6;
+  const int32_t n = 77;
+  const int32_t p = 37;
+  const int32_t num_groups = 4;
+  const int32_t g = (n + num_groups - 1) / num_groups;
+
+  std::vector<float> input_data(m * n);
+  std::vector<int8_t> weight_data(p * n);
+  std::vector<float> scales_data(p * num_groups);
+  for (int32_t i = 0; i < m * n; ++i) {
+    input_data[i] = static_cast<float>(i % 13 - 6) / 8;
+  }
+  for (int32_t i = 0; i < p * n; ++i) {
+    weight_data[i] = static_cast<int8_t>((i * 37) % 255 - 127);
+  }
+  for (int32_t i = 0; i < p * num_groups; ++i) {
+    scales_data[i] = static_cast<float>(i % 7 + 1) / 64;
+  }
+
+  std::vector<float> expected_data(m * p);
+  for (int32_t i = 0; i < m; ++i) {
+    for (int32_t j = 0; j < p; ++j) {
+      double sum = 0;
+      for (int32_t k = 0; k < n; ++k) {
+        sum += static_cast<double>(input_data[i * n + k]) *
+            weight_data[j * n + k] * scales_data[j * num_groups + k / g];
+      }
+      expected_data[i * p + j] = static_cast<float>(sum);
+    }
+  }
+
+  Tensor input = tf.make({m, n}, input_data);
+  Tensor weight = tf_char.make({p, n}, weight_data);
+  Tensor weight_scales = tf.make({p, num_groups}, scales_data);
+  Tensor out = tf.zeros({m, p});
+
+  KernelRuntimeContext ctx{};
+  quantized_mixed_linear_out(ctx, input, weight, weight_scales, {}, {}, out);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, tf.make({m, p}, expected_data), 1e-4, 1e-4);
+}
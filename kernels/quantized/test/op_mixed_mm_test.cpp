@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::optional;
 using exec_aten::ScalarType;
@@ -69,3 +71,49 @@ TEST_F(OpQuantizedMixedMMTest, FloatInput) {
 TEST_F(OpQuantizedMixedMMTest, HalfInput) {
   test_dtype<ScalarType::Half>();
 }
+
+TEST_F(OpQuantizedMixedMMTest, LargeMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Char> tf_char;
+
+  // p spans more than one column block and is not a multiple of the vector
+  // width.
+  const int32_t m = 3;
+  const int32_t n = 45;
+  const int32_t p = 133;
+
+  std::vector<float> input_data(m * n);
+  std::vector<int8_t> weight_data(n * p);
+  std::vector<float> scales_data(n);
+  for (int32_t i = 0; i < m * n; ++i) {
+    input_data[i] = static_cast<float>(i % 11 - 5) / 8;
+  }
+  for (int32_t i = 0; i < n * p; ++i) {
+    weight_data[i] = static_cast<int8_t>((i * 41) % 255 - 127);
+  }
+  for (int32_t i = 0; i < n; ++i) {
+    scales_data[i] = static_cast<float>(i % 5 + 1) / 64;
+  }
+
+  std::vector<float> expected_data(m * p);
+  for (int32_t i = 0; i < m; ++i) {
+    for (int32_t j = 0; j < p; ++j) {
+      double sum = 0;
+      for (int32_t k = 0; k < n; ++k) {
+        sum += static_cast<double>(input_data[i * n + k]) *
+            weight_data[k * p + j] * scales_data[k];
+      }
+      expected_data[i * p + j] = static_cast<float>(sum);
+    }
+  }
+
+  Tensor input = tf.make({m, n}, input_data);
+  Tensor weight = tf_char.make({n, p}, weight_data);
+  Tensor weight_scales = tf.make({n}, scales_data);
+  Tensor out = tf.zeros({m, p});
+
+  KernelRuntimeContext ctx{};
+  quantized_mixed_mm_out(ctx, input, weight, weight_scales, {}, out);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, tf.make({m, p}, expected_data), 1e-4, 1e-4);
+}
@@ -14,7 +14,9 @@
 #include <executorch/test/utils/DeathTest.h>
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <limits>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -141,3 +143,82 @@ TEST(OpQuantizeOutTest, QuantizePerChannel) {
 
   EXPECT_TENSOR_EQ(out, expected);
 }
+
+namespace {
+
+/// Checks quantize_per_tensor_out and quantize_per_channel_out against the
+/// scalar formula on inputs that include rounding ties and out of range
+/// values, with sizes that are not a multiple of the vector width.
+template <ScalarType DTYPE>
+void test_against_reference(int64_t quant_min, int64_t quant_max) {
+  using CTYPE = typename TensorFactory<DTYPE>::ctype;
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+  TensorFactory<ScalarType::Long> tf_long;
+  TensorFactory<DTYPE> tfo;
+
+  const std::vector<int32_t> sizes = {3, 5, 21};
+  const int32_t numel = 3 * 5 * 21;
+  std::vector<float> input_data(numel);
+  for (int32_t i = 0; i < numel; ++i) {
+    // Multiples of 0.25, so that the scale of 0.5 hits exact ties.
+    input_data[i] = static_cast<float>(i % 301 - 150) * 0.25f;
+  }
+  const auto reference = [&](float value, double scale, int64_t zero_point) {
+    const float inv_scale = 1.0f / static_cast<float>(scale);
+    int64_t q = zero_point + static_cast<int64_t>(std::nearbyint(
+                                 static_cast<float>(inv_scale * value)));
+    q = std::min(std::max(q, quant_min), quant_max);
+    return static_cast<CTYPE>(q);
+  };
+  Tensor input = tf.make(sizes, input_data);
+
+  // Per tensor.
+  {
+    const double scale = 0.5;
+    const int64_t zero_point = (quant_min + quant_max) / 2 + 3;
+    std::vector<CTYPE> expected_data(numel);
+    for (int32_t i = 0; i < numel; ++i) {
+      expected_data[i] = reference(input_data[i], scale, zero_point);
+    }
+    Tensor out = tfo.zeros(sizes);
+    quantize_per_tensor_out(
+        input, scale, zero_point, quant_min, quant_max, DTYPE, out);
+    EXPECT_TENSOR_EQ(out, tfo.make(sizes, expected_data));
+  }
+
+  // Per channel, along an inner and the last dimension.
+  for (int64_t axis : {1, 2}) {
+    const int32_t channels = sizes[axis];
+    std::vector<double> scales(channels);
+    std::vector<int64_t> zero_points(channels);
+    for (int32_t c = 0; c < channels; ++c) {
+      scales[c] = 0.5 * (c % 3 + 1);
+      zero_points[c] = quant_min + (c * 7) % (quant_max - quant_min + 1);
+    }
+    std::vector<CTYPE> expected_data(numel);
+    for (int32_t i = 0; i < numel; ++i) {
+      const int32_t c = axis == 1 ? (i / 21) % 5 : i % 21;
+      expected_data[i] = reference(input_data[i], scales[c], zero_points[c]);
+    }
+    Tensor out = tfo.zeros(sizes);
+    quantize_per_channel_out(
+        input,
+        tf_double.make({channels}, scales),
+        tf_long.make({channels}, zero_points),
+        axis,
+        quant_min,
+        quant_max,
+        DTYPE,
+        out);
+    EXPECT_TENSOR_EQ(out, tfo.make(sizes, expected_data));
+  }
+}
+
+} // namespace
+
+TEST(OpQuantizeOutTest, LargeTensorMatchesReference) {
+  test_against_reference<ScalarType::Char>(-128, 127);
+  test_against_reference<ScalarType::Byte>(0, 255);
+  test_against_reference<ScalarType::Short>(-40, 40);
+}
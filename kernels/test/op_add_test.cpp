@@ -205,6 +205,29 @@ TEST_F(OpAddOutKernelTest, BroadcastDimSizeIsOneAB) {
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
 
+TEST_F(OpAddOutKernelTest, OutAliasesSelf) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Memory planning may make out share the storage of self, so the kernel
+  // must not need self again after writing to out. Use enough elements to
+  // exercise the vectorized paths, and broadcast the other operand.
+  std::vector<float> x_data(3 * 40);
+  std::vector<float> y_data(40);
+  std::vector<float> expected_data(3 * 40);
+  for (size_t i = 0; i < y_data.size(); ++i) {
+    y_data[i] = 0.5f * i;
+  }
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = 2.0f * i - 7.0f;
+    expected_data[i] = x_data[i] + 2.0f * y_data[i % 40];
+  }
+  Tensor x = tf.make({3, 40}, x_data);
+  Tensor y = tf.make({1, 40}, y_data);
+
+  op_add_out(x, y, 2, x);
+  EXPECT_TENSOR_CLOSE(x, tf.make({3, 40}, expected_data));
+}
+
 TEST_F(OpAddOutKernelTest, BroadcastDimSizeMissingAB) {
   TensorFactory<ScalarType::Float> tf;
 
@@ -301,6 +324,36 @@ TEST_F(OpAddOutKernelTest, BroadcastSupported) {
   EXPECT_TENSOR_EQ(out, tf.ones({5, 2, 3, 4}));
 }
 
+TEST_F(OpAddOutKernelTest, BroadcastBothInputsAcrossMultipleDims) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor a = tf.make({2, 1, 3}, {1, 2, 3, 4, 5, 6});
+  Tensor b = tf.make({1, 2, 1}, {10, 20});
+  Tensor out = tf.zeros({2, 2, 3});
+
+  op_add_out(a, b, /*alpha=*/2, out);
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make({2, 2, 3}, {21, 22, 23, 41, 42, 43, 24, 25, 26, 44, 45, 46}));
+}
+
+TEST_F(OpAddOutKernelTest, BroadcastMixedDtypes) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Int> tf_int;
+
+  // E.g. an additive attention mask shared across batches and heads.
+  Tensor a = tf.make({2, 2, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+  Tensor b = tf_int.make({2, 1}, {100, 200});
+  Tensor out = tf.zeros({2, 2, 3});
+
+  op_add_out(a, b, /*alpha=*/1, out);
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make(
+          {2, 2, 3},
+          {101, 102, 103, 204, 205, 206, 107, 108, 109, 210, 211, 212}));
+}
+
 TEST_F(OpAddOutKernelTest, BroadcastOneElementTensor) {
   TensorFactory<ScalarType::Float> tf;
   Tensor x = tf.make({1}, {1.75});
@@ -15,6 +15,9 @@
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using exec_aten::optional;
@@ -108,3 +111,30 @@ TEST_F(OpArgmaxTest, SanityCheckNullDim) {
   EXPECT_TENSOR_EQ(out, expected);
   // clang-format on
 }
+
+TEST_F(OpArgmaxTest, LongRowReturnsFirstMaximum) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // As long as an LLM's logits, so that it may be split across threads, with
+  // ties that fall in different parts.
+  const int32_t size = 128256;
+  std::vector<float> logits(size);
+  for (int32_t i = 0; i < size; ++i) {
+    logits[i] = static_cast<float>(i % 1000) / 100;
+  }
+  logits[70001] = 20;
+  logits[120000] = 20;
+
+  Tensor out = tfl.zeros({1});
+  op_argmax_out(tf.make({1, size}, logits), 1, false, out);
+  EXPECT_TENSOR_EQ(out, tfl.make({1}, {70001}));
+
+  // NaN beats every other value.
+  logits[90000] = NAN;
+  logits[100000] = NAN;
+  Tensor null_dim_out = tfl.zeros({});
+  op_argmax_out(
+      tf.make({1, size}, logits), optional<int64_t>(), false, null_dim_out);
+  EXPECT_TENSOR_EQ(null_dim_out, tfl.make({}, {90000}));
+}
@@ -15,6 +15,8 @@
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using exec_aten::optional;
@@ -108,3 +110,22 @@ TEST_F(OpArgminTest, SanityCheckNullDim) {
   EXPECT_TENSOR_EQ(out, expected);
   // clang-format on
 }
+
+TEST_F(OpArgminTest, LongRowReturnsFirstMinimum) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Long enough that it may be split across threads, with ties that fall in
+  // different parts.
+  const int32_t size = 128256;
+  std::vector<float> values(size);
+  for (int32_t i = 0; i < size; ++i) {
+    values[i] = static_cast<float>(i % 1000) / 100;
+  }
+  values[70001] = -20;
+  values[120000] = -20;
+
+  Tensor out = tfl.zeros({1});
+  op_argmin_out(tf.make({1, size}, values), 1, false, out);
+  EXPECT_TENSOR_EQ(out, tfl.make({1}, {70001}));
+}
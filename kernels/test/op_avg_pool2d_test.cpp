@@ -13,6 +13,9 @@
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
 
+#include <cmath>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 using namespace ::testing;
@@ -1049,3 +1052,35 @@ TEST_F(OpAvgPool2DOutTest, SanityCheck4DCeilModeNoIncludePadding) {
       out);
   EXPECT_TENSOR_CLOSE(out, out_expected);
 }
+
+TEST_F(OpAvgPool2DOutTest, ChannelsLastMatchesContiguous) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+
+  std::vector<float> self_data(2 * 3 * 7 * 6);
+  for (size_t i = 0; i < self_data.size(); ++i) {
+    self_data[i] = std::cos(0.3f * i);
+  }
+  exec_aten::Tensor self = tfFloat.make({2, 3, 7, 6}, self_data);
+  int64_t kernel_size_data[2] = {3, 2};
+  exec_aten::ArrayRef<int64_t> kernel_size(kernel_size_data, 2);
+  int64_t stride_data[2] = {2, 1};
+  exec_aten::ArrayRef<int64_t> stride(stride_data, 2);
+  int64_t padding_data[2] = {1, 1};
+  exec_aten::ArrayRef<int64_t> padding(padding_data, 2);
+
+  exec_aten::Tensor out = tfFloat.zeros({2, 3, 4, 7});
+  op_avg_pool2d_out(
+      self, kernel_size, stride, padding, false, true, {}, out);
+
+  exec_aten::Tensor out_cl = tfFloat.full_channels_last({2, 3, 4, 7}, 0);
+  op_avg_pool2d_out(
+      tfFloat.channels_last_like(self),
+      kernel_size,
+      stride,
+      padding,
+      false,
+      true,
+      {},
+      out_cl);
+  EXPECT_TENSOR_CLOSE(out_cl, tfFloat.channels_last_like(out));
+}
@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using exec_aten::optional;
@@ -137,6 +139,136 @@ class OpConvOutTest : public OperatorTest {
         out);
     EXPECT_TENSOR_CLOSE(out, expected);
   }
+
+  // Compares a 2D NCHW float convolution against a direct computation of it,
+  // on inputs large enough to take the specialized paths of optimized
+  // kernels.
+  void test_against_reference(
+      int32_t batches,
+      int32_t in_channels,
+      int32_t in_h,
+      int32_t in_w,
+      int32_t out_channels,
+      int32_t kernel_h,
+      int32_t kernel_w,
+      const int64_t (&stride)[2],
+      const int64_t (&padding)[2],
+      const int64_t (&dilation)[2],
+      int64_t groups,
+      bool transposed) {
+    TensorFactory<ScalarType::Float> tf;
+    const int32_t in_c_per_group = in_channels / groups;
+    const int32_t out_c_per_group = out_channels / groups;
+    int32_t out_h;
+    int32_t out_w;
+    if (transposed) {
+      out_h = (in_h - 1) * stride[0] - 2 * padding[0] +
+          dilation[0] * (kernel_h - 1) + 1;
+      out_w = (in_w - 1) * stride[1] - 2 * padding[1] +
+          dilation[1] * (kernel_w - 1) + 1;
+    } else {
+      out_h = (in_h + 2 * padding[0] - dilation[0] * (kernel_h - 1) - 1) /
+              stride[0] +
+          1;
+      out_w = (in_w + 2 * padding[1] - dilation[1] * (kernel_w - 1) - 1) /
+              stride[1] +
+          1;
+    }
+
+    std::vector<float> in_data(batches * in_channels * in_h * in_w);
+    for (size_t i = 0; i < in_data.size(); ++i) {
+      in_data[i] = static_cast<float>(static_cast<int32_t>(i * 7 % 23) - 11) /
+          11.0f;
+    }
+    const std::vector<int32_t> weight_sizes = transposed
+        ? std::vector<int32_t>{in_channels, out_c_per_group, kernel_h, kernel_w}
+        : std::vector<int32_t>{
+              out_channels, in_c_per_group, kernel_h, kernel_w};
+    std::vector<float> weight_data(
+        weight_sizes[0] * weight_sizes[1] * kernel_h * kernel_w);
+    for (size_t i = 0; i < weight_data.size(); ++i) {
+      weight_data[i] =
+          static_cast<float>(static_cast<int32_t>(i * 5 % 17) - 8) / 8.0f;
+    }
+    std::vector<float> bias_data(out_channels);
+    for (int32_t c = 0; c < out_channels; ++c) {
+      bias_data[c] = static_cast<float>(c % 3) - 1.0f;
+    }
+
+    std::vector<double> expected_data(
+        batches * out_channels * out_h * out_w, 0.0);
+    for (int32_t n = 0; n < batches; ++n) {
+      for (int32_t ic = 0; ic < in_channels; ++ic) {
+        const int32_t g = ic / in_c_per_group;
+        for (int32_t ocg = 0; ocg < out_c_per_group; ++ocg) {
+          const int32_t oc = g * out_c_per_group + ocg;
+          const float* w = transposed
+              ? &weight_data[(ic * out_c_per_group + ocg) * kernel_h * kernel_w]
+              : &weight_data
+                    [(oc * in_c_per_group + ic % in_c_per_group) * kernel_h *
+                     kernel_w];
+          for (int32_t ky = 0; ky < kernel_h; ++ky) {
+            for (int32_t kx = 0; kx < kernel_w; ++kx) {
+              for (int32_t y = 0; y < (transposed ? in_h : out_h); ++y) {
+                for (int32_t x = 0; x < (transposed ? in_w : out_w); ++x) {
+                  const int64_t oy = y * stride[0] - padding[0] + ky * dilation[0];
+                  const int64_t ox = x * stride[1] - padding[1] + kx * dilation[1];
+                  int64_t in_y = oy;
+                  int64_t in_x = ox;
+                  int64_t out_y = y;
+                  int64_t out_x = x;
+                  if (transposed) {
+                    in_y = y;
+                    in_x = x;
+                    out_y = oy;
+                    out_x = ox;
+                  }
+                  if (in_y < 0 || in_y >= in_h || in_x < 0 || in_x >= in_w ||
+                      out_y < 0 || out_y >= out_h || out_x < 0 ||
+                      out_x >= out_w) {
+                    continue;
+                  }
+                  expected_data[((n * out_channels + oc) * out_h + out_y) *
+                                    out_w +
+                                out_x] += w[ky * kernel_w + kx] *
+                      in_data[((n * in_channels + ic) * in_h + in_y) * in_w +
+                              in_x];
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+    std::vector<float> expected_float(expected_data.size());
+    for (size_t i = 0; i < expected_data.size(); ++i) {
+      const int32_t oc = (i / (out_h * out_w)) % out_channels;
+      expected_float[i] = static_cast<float>(expected_data[i]) + bias_data[oc];
+    }
+
+    Tensor input = tf.make({batches, in_channels, in_h, in_w}, in_data);
+    Tensor weight = tf.make(weight_sizes, weight_data);
+    optional<Tensor> bias(tf.make({out_channels}, bias_data));
+    Tensor out = tf.zeros({batches, out_channels, out_h, out_w});
+    int64_t output_padding[] = {0, 0};
+
+    op_convolution_out(
+        input,
+        weight,
+        bias,
+        stride,
+        padding,
+        dilation,
+        transposed,
+        output_padding,
+        groups,
+        out);
+    EXPECT_TENSOR_CLOSE_WITH_TOL(
+        out,
+        tf.make({batches, out_channels, out_h, out_w}, expected_float),
+        1e-4,
+        1e-4);
+  }
 };
 
 class OpConvCorrectnessTest : public OpConvOutTest {};
@@ -728,3 +860,35 @@ TEST_F(OpConvCorrectnessTest, InvalidOutputPadding) {
           groups,
           out));
 }
+
+TEST_F(OpConvCorrectnessTest, 3x3MatchesReference) {
+  // Large enough for the Winograd paths of optimized kernels, with outputs
+  // that are not a multiple of their tile size.
+  test_against_reference(
+      2, 8, 11, 13, 9, 3, 3, {1, 1}, {1, 1}, {1, 1}, 1, false);
+  test_against_reference(
+      1, 16, 6, 7, 8, 3, 3, {1, 1}, {0, 1}, {1, 1}, 1, false);
+  test_against_reference(
+      1, 3, 9, 9, 4, 3, 3, {1, 1}, {1, 1}, {1, 1}, 1, false);
+}
+
+TEST_F(OpConvCorrectnessTest, DepthwiseMatchesReference) {
+  test_against_reference(
+      2, 6, 19, 21, 12, 3, 3, {1, 1}, {1, 1}, {1, 1}, 6, false);
+  test_against_reference(
+      1, 4, 17, 12, 4, 5, 3, {2, 3}, {2, 0}, {1, 2}, 4, false);
+}
+
+TEST_F(OpConvCorrectnessTest, GroupedDilatedMatchesReference) {
+  test_against_reference(
+      2, 6, 12, 10, 4, 3, 2, {1, 2}, {2, 1}, {2, 1}, 2, false);
+  test_against_reference(
+      1, 8, 7, 9, 16, 1, 1, {1, 1}, {0, 0}, {1, 1}, 1, false);
+}
+
+TEST_F(OpConvCorrectnessTest, TransposedMatchesReference) {
+  test_against_reference(
+      2, 6, 5, 7, 4, 3, 3, {2, 2}, {1, 0}, {1, 2}, 2, true);
+  test_against_reference(
+      1, 8, 6, 6, 8, 2, 2, {1, 1}, {0, 0}, {1, 1}, 1, true);
+}
@@ -282,3 +282,12 @@ TEST_F(OpCopyInplaceTest, BroadCastSrcSupported) {
   Tensor expected = tf.make(/*sizes=*/{2, 2}, /*data=*/{3, 3, 3, 3});
   EXPECT_TENSOR_EQ(in, expected);
 }
+
+TEST_F(OpCopyInplaceTest, SrcAliasesSelf) {
+  TensorFactory<ScalarType::Int> tf;
+  Tensor in = tf.make(/*sizes=*/{2, 2}, /*data=*/{1, 2, 3, 4});
+  bool non_blocking = false;
+  op_copy_(in, in, non_blocking);
+  Tensor expected = tf.make(/*sizes=*/{2, 2}, /*data=*/{1, 2, 3, 4});
+  EXPECT_TENSOR_EQ(in, expected);
+}
@@ -15,6 +15,7 @@
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
 #include <gtest/gtest.h>
 #include <cmath>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -286,3 +287,22 @@ TEST_F(OpCumSumOutTest, DynamicShapeUnbound) {
   Tensor ret = op_cumsum_out(x, 1, ScalarType::Float, out);
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
+
+TEST_F(OpCumSumOutTest, LongRowMatchesSequentialSum) {
+  TensorFactory<ScalarType::Long> tf;
+
+  // Long enough that the sums may be computed in blocks across threads.
+  const int32_t size = 200003;
+  std::vector<int64_t> x_data(size);
+  std::vector<int64_t> expected_data(size);
+  int64_t sum = 0;
+  for (int32_t i = 0; i < size; ++i) {
+    x_data[i] = i % 7 - 3;
+    sum += x_data[i];
+    expected_data[i] = sum;
+  }
+
+  Tensor out = tf.zeros({1, size});
+  op_cumsum_out(tf.make({1, size}, x_data), /*dim=*/1, ScalarType::Long, out);
+  EXPECT_TENSOR_EQ(out, tf.make({1, size}, expected_data));
+}
@@ -16,6 +16,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using exec_aten::ScalarType;
@@ -461,3 +463,36 @@ TEST_F(OpEmbeddingOutTest, DynamicShapeUnbound) {
   test_dynamic_shape(
       {1, 1, 1}, torch::executor::TensorShapeDynamism::DYNAMIC_UNBOUND);
 }
+
+TEST_F(OpEmbeddingOutTest, ManyIndicesMatchRowLookups) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tfl;
+
+  // Enough rows that they may be copied in chunks across threads.
+  const int32_t num_rows = 37;
+  const int32_t row_size = 96;
+  const int32_t num_indices = 2000;
+  std::vector<float> weight_data(num_rows * row_size);
+  for (size_t i = 0; i < weight_data.size(); ++i) {
+    weight_data[i] = static_cast<float>(i);
+  }
+  std::vector<int64_t> indices_data(num_indices);
+  std::vector<float> expected_data;
+  expected_data.reserve(num_indices * row_size);
+  for (int32_t i = 0; i < num_indices; ++i) {
+    indices_data[i] = (i * 7) % num_rows;
+    for (int32_t j = 0; j < row_size; ++j) {
+      expected_data.push_back(weight_data[indices_data[i] * row_size + j]);
+    }
+  }
+
+  Tensor out = tf.zeros({2, num_indices / 2, row_size});
+  op_embedding_out(
+      tf.make({num_rows, row_size}, weight_data),
+      tfl.make({2, num_indices / 2}, indices_data),
+      /*padding_idx=*/-1,
+      /*scale_grad_by_freq=*/false,
+      /*sparse=*/false,
+      out);
+  EXPECT_TENSOR_EQ(out, tf.make({2, num_indices / 2, row_size}, expected_data));
+}
@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <cmath>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::Scalar;
@@ -377,3 +378,61 @@ TEST_F(OpGatherOutTest, InvalidOneDimInputAndZeroDimIndex) {
   ET_EXPECT_KERNEL_FAILURE(
       context_, op_gather_out(self, 0, index, sparse_grad, out));
 }
+
+TEST_F(OpGatherOutTest, LargeInputsMatchElementLookups) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Long> tf_index;
+
+  const int32_t rows = 300;
+  const int32_t cols = 40;
+  std::vector<float> self_data(rows * cols);
+  for (size_t i = 0; i < self_data.size(); ++i) {
+    self_data[i] = static_cast<float>(i);
+  }
+  Tensor self = tf.make({rows, cols}, self_data);
+
+  // Along the last dim, with fewer rows in index than in self.
+  {
+    const int32_t index_rows = rows - 7;
+    const int32_t index_cols = 2 * cols;
+    std::vector<int64_t> index_data(index_rows * index_cols);
+    std::vector<float> expected_data(index_data.size());
+    for (int32_t i = 0; i < index_rows; ++i) {
+      for (int32_t j = 0; j < index_cols; ++j) {
+        const int64_t ix = (i + j * 3) % cols;
+        index_data[i * index_cols + j] = ix;
+        expected_data[i * index_cols + j] = self_data[i * cols + ix];
+      }
+    }
+    Tensor out = tf.zeros({index_rows, index_cols});
+    op_gather_out(
+        self,
+        /*dim=*/1,
+        tf_index.make({index_rows, index_cols}, index_data),
+        /*sparse_grad=*/false,
+        out);
+    EXPECT_TENSOR_EQ(out, tf.make({index_rows, index_cols}, expected_data));
+  }
+
+  // Along the first dim.
+  {
+    const int32_t index_rows = 100;
+    std::vector<int64_t> index_data(index_rows * cols);
+    std::vector<float> expected_data(index_data.size());
+    for (int32_t i = 0; i < index_rows; ++i) {
+      for (int32_t j = 0; j < cols; ++j) {
+        const int64_t ix = (i * 11 + j) % rows;
+        index_data[i * cols + j] = ix;
+        expected_data[i * cols + j] = self_data[ix * cols + j];
+      }
+    }
+    Tensor out = tf.zeros({index_rows, cols});
+    op_gather_out(
+        self,
+        /*dim=*/0,
+        tf_index.make({index_rows, cols}, index_data),
+        /*sparse_grad=*/false,
+        out);
+    EXPECT_TENSOR_EQ(out, tf.make({index_rows, cols}, expected_data));
+  }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::string_view;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpGeluBackwardTest : public OperatorTest {
+ protected:
+  Tensor& op_gelu_backward_out(
+      const Tensor& grad_output,
+      const Tensor& self,
+      string_view approximate,
+      Tensor& grad_input) {
+    return torch::executor::aten::gelu_backward_outf(
+        context_, grad_output, self, approximate, grad_input);
+  }
+
+  template <ScalarType DTYPE>
+  void test_gelu_backward(string_view approximate, const Tensor& expected) {
+    TensorFactory<DTYPE> tf;
+
+    Tensor grad_output = tf.make({2, 3}, {1, 2, -1, 0.5, 1, 1});
+    Tensor self = tf.make({2, 3}, {-2, -0.5, 0, 0.5, 1, 3});
+    Tensor grad_input = tf.zeros({2, 3});
+
+    op_gelu_backward_out(grad_output, self, approximate, grad_input);
+
+    EXPECT_TENSOR_CLOSE_WITH_TOL(grad_input, expected, 1e-5, 1e-6);
+  }
+};
+
+TEST_F(OpGeluBackwardTest, FloatNone) {
+  TensorFactory<ScalarType::Float> tf;
+  test_gelu_backward<ScalarType::Float>(
+      "none",
+      tf.make(
+          {2, 3},
+          {-0.085232, 0.26501, -0.5, 0.433748, 1.083315, 1.011946}));
+}
+
+TEST_F(OpGeluBackwardTest, FloatTanh) {
+  TensorFactory<ScalarType::Float> tf;
+  test_gelu_backward<ScalarType::Float>(
+      "tanh",
+      tf.make(
+          {2, 3},
+          {-0.086099, 0.26526, -0.5, 0.433685, 1.082964, 1.011584}));
+}
+
+TEST_F(OpGeluBackwardTest, DoubleNone) {
+  TensorFactory<ScalarType::Double> tf;
+  test_gelu_backward<ScalarType::Double>(
+      "none",
+      tf.make(
+          {2, 3},
+          {-0.085232, 0.26501, -0.5, 0.433748, 1.083315, 1.011946}));
+}
+
+TEST_F(OpGeluBackwardTest, LargeInputMatchesScalarFormula) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Not a multiple of the vector size, to cover the tail.
+  constexpr int kNumel = 1003;
+  std::vector<float> grad_output_data(kNumel);
+  std::vector<float> self_data(kNumel);
+  std::vector<float> expected_data(kNumel);
+  for (int i = 0; i < kNumel; ++i) {
+    const float x = (i - kNumel / 2) * 0.01f;
+    const float dy = 1.0f + (i % 5) * 0.25f;
+    self_data[i] = x;
+    grad_output_data[i] = dy;
+    const float cdf = 0.5f * (1.0f + std::erf(x * M_SQRT1_2));
+    const float pdf = std::exp(-0.5f * x * x) * M_2_SQRTPI * M_SQRT1_2 * 0.5f;
+    expected_data[i] = dy * (cdf + x * pdf);
+  }
+  Tensor grad_output = tf.make({kNumel}, grad_output_data);
+  Tensor self = tf.make({kNumel}, self_data);
+  Tensor grad_input = tf.zeros({kNumel});
+
+  op_gelu_backward_out(grad_output, self, "none", grad_input);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      grad_input, tf.make({kNumel}, expected_data), 1e-5, 1e-6);
+}
+
+TEST_F(OpGeluBackwardTest, InvalidApproximationDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_output = tf.ones({2});
+  Tensor self = tf.ones({2});
+  Tensor grad_input = tf.zeros({2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_gelu_backward_out(grad_output, self, "erf", grad_input));
+}
+
+TEST_F(OpGeluBackwardTest, MismatchedShapesDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_output = tf.ones({3});
+  Tensor self = tf.ones({2});
+  Tensor grad_input = tf.zeros({2});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_gelu_backward_out(grad_output, self, "none", grad_input));
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+namespace {
+constexpr int64_t kBilinear = 0;
+constexpr int64_t kNearest = 1;
+constexpr int64_t kBicubic = 2;
+
+constexpr int64_t kZeros = 0;
+constexpr int64_t kBorder = 1;
+constexpr int64_t kReflection = 2;
+} // namespace
+
+class OpGridSampler2dTest : public OperatorTest {
+ protected:
+  Tensor& op_grid_sampler_2d_out(
+      const Tensor& in,
+      const Tensor& grid,
+      int64_t interpolation_mode,
+      int64_t padding_mode,
+      bool align_corners,
+      Tensor& out) {
+    return torch::executor::aten::grid_sampler_2d_outf(
+        context_,
+        in,
+        grid,
+        interpolation_mode,
+        padding_mode,
+        align_corners,
+        out);
+  }
+};
+
+TEST_F(OpGridSampler2dTest, IdentityGridAlignCorners) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 3}, {1, 2, 3, 4, 5, 6});
+  // The (x, y) coordinates of every input pixel.
+  // clang-format off
+  Tensor grid = tf.make({1, 2, 3, 2}, {
+      -1, -1,   0, -1,   1, -1,
+      -1,  1,   0,  1,   1,  1,
+  });
+  // clang-format on
+  Tensor out = tf.zeros({1, 1, 2, 3});
+
+  op_grid_sampler_2d_out(in, grid, kBilinear, kZeros, true, out);
+
+  EXPECT_TENSOR_CLOSE(out, in);
+}
+
+TEST_F(OpGridSampler2dTest, BilinearPaddingModes) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  // The center of the input and its two outer corners.
+  Tensor grid = tf.make({1, 1, 3, 2}, {0, 0, -1, -1, 1, 1});
+  Tensor out = tf.zeros({1, 1, 1, 3});
+
+  op_grid_sampler_2d_out(in, grid, kBilinear, kZeros, false, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 1, 3}, {2.5, 0.25, 1.0}));
+
+  op_grid_sampler_2d_out(in, grid, kBilinear, kBorder, false, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 1, 3}, {2.5, 1.0, 4.0}));
+
+  op_grid_sampler_2d_out(in, grid, kBilinear, kReflection, false, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 1, 3}, {2.5, 1.0, 4.0}));
+}
+
+TEST_F(OpGridSampler2dTest, Nearest) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  Tensor grid = tf.make({1, 1, 3, 2}, {0.2, -0.6, 1.5, 0, -0.5, 0.5});
+  Tensor out = tf.zeros({1, 1, 1, 3});
+
+  op_grid_sampler_2d_out(in, grid, kNearest, kZeros, false, out);
+
+  // The second point is out of bounds.
+  EXPECT_TENSOR_EQ(out, tf.make({1, 1, 1, 3}, {2, 0, 3}));
+}
+
+TEST_F(OpGridSampler2dTest, ChannelsLastMatchesContiguous) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::vector<float> in_data(2 * 3 * 4 * 5);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = std::cos(0.3f * i);
+  }
+  std::vector<float> grid_data(2 * 3 * 6 * 2);
+  for (size_t i = 0; i < grid_data.size(); ++i) {
+    grid_data[i] = 1.2f * std::sin(0.7f * i);
+  }
+  Tensor in = tf.make({2, 3, 4, 5}, in_data);
+  Tensor grid = tf.make({2, 3, 6, 2}, grid_data);
+
+  Tensor out = tf.zeros({2, 3, 3, 6});
+  op_grid_sampler_2d_out(in, grid, kBilinear, kReflection, true, out);
+
+  Tensor out_cl = tf.full_channels_last({2, 3, 3, 6}, 0);
+  op_grid_sampler_2d_out(
+      tf.channels_last_like(in), grid, kBilinear, kReflection, true, out_cl);
+
+  EXPECT_TENSOR_CLOSE(out_cl, tf.channels_last_like(out));
+}
+
+TEST_F(OpGridSampler2dTest, BicubicUnsupported) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen kernel supports bicubic interpolation";
+  }
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.ones({1, 1, 2, 2});
+  Tensor grid = tf.zeros({1, 1, 1, 2});
+  Tensor out = tf.zeros({1, 1, 1, 1});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_, op_grid_sampler_2d_out(in, grid, kBicubic, kZeros, false, out));
+}
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 #include <sys/types.h>
+#include <vector>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
@@ -519,3 +520,41 @@ TEST_F(OpIndexSelectOutTest, DynamicShapeUnbound) {
   test_dynamic_shape(
       {1, 1, 1}, torch::executor::TensorShapeDynamism::DYNAMIC_UNBOUND);
 }
+
+TEST_F(OpIndexSelectOutTest, ManyRowsMatchSliceLookups) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Int> tfi;
+
+  // Selects along the middle dim, so that each selected slice is a row of
+  // `inner` elements within each of the `outer` leading slices.
+  const int32_t outer = 3;
+  const int32_t dim_size = 50;
+  const int32_t inner = 33;
+  const int32_t num_indices = 700;
+  std::vector<float> in_data(outer * dim_size * inner);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>(i);
+  }
+  std::vector<int32_t> index_data(num_indices);
+  for (int32_t i = 0; i < num_indices; ++i) {
+    index_data[i] = (i * 13) % dim_size;
+  }
+  std::vector<float> expected_data;
+  expected_data.reserve(outer * num_indices * inner);
+  for (int32_t o = 0; o < outer; ++o) {
+    for (int32_t i = 0; i < num_indices; ++i) {
+      for (int32_t j = 0; j < inner; ++j) {
+        expected_data.push_back(
+            in_data[(o * dim_size + index_data[i]) * inner + j]);
+      }
+    }
+  }
+
+  Tensor out = tf.zeros({outer, num_indices, inner});
+  op_index_select_out(
+      tf.make({outer, dim_size, inner}, in_data),
+      /*dim=*/1,
+      tfi.make({num_indices}, index_data),
+      out);
+  EXPECT_TENSOR_EQ(out, tf.make({outer, num_indices, inner}, expected_data));
+}
@@ -134,6 +134,39 @@ TEST_F(OpLeTensorOutTest, AllDtypesSupported) {
 #undef TEST_ENTRY
 }
 
+TEST_F(OpLeTensorOutTest, BroadcastSupported) {
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Bool> tf_bool;
+
+  Tensor a = tf.make({2, 1, 3}, {1, 2, 3, 4, 5, 6});
+  Tensor b = tf.make({2, 1}, {2, 5});
+  Tensor out = tf_bool.zeros({2, 2, 3});
+
+  // A Bool output, and then one of the same dtype as the inputs.
+  op_le_tensor_out(a, b, out);
+  EXPECT_TENSOR_EQ(
+      out,
+      tf_bool.make(
+          {2, 2, 3},
+          {true,
+           true,
+           false,
+           true,
+           true,
+           true,
+           false,
+           false,
+           false,
+           true,
+           true,
+           false}));
+
+  Tensor float_out = tf.zeros({2, 2, 3});
+  op_le_tensor_out(a, b, float_out);
+  EXPECT_TENSOR_EQ(
+      float_out, tf.make({2, 2, 3}, {1, 1, 0, 1, 1, 1, 0, 0, 0, 1, 1, 0}));
+}
+
 TEST_F(OpLeTensorOutTest, MismatchedInShapesDies) {
   if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
     GTEST_SKIP() << "ATen kernel can handle mismatched shapes";
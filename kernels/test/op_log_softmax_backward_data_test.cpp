@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpLogSoftmaxBackwardDataTest : public OperatorTest {
+ protected:
+  Tensor& op_log_softmax_backward_data_out(
+      const Tensor& grad_output,
+      const Tensor& output,
+      int64_t dim,
+      ScalarType input_dtype,
+      Tensor& out) {
+    return torch::executor::aten::_log_softmax_backward_data_outf(
+        context_, grad_output, output, dim, input_dtype, out);
+  }
+};
+
+TEST_F(OpLogSoftmaxBackwardDataTest, LastDim) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_output = tf.make({2, 3}, {0.1, -0.2, 0.3, 1, 0, -1});
+  // log_softmax([[1, 2, 3], [0, -1, 0.5]], dim=1)
+  Tensor output = tf.make(
+      {2, 3},
+      {-2.407606, -1.407606, -0.407606, -1.104131, -2.104131, -0.604131});
+  Tensor out = tf.zeros({2, 3});
+
+  op_log_softmax_backward_data_out(
+      grad_output, output, 1, ScalarType::Float, out);
+
+  Tensor expected =
+      tf.make({2, 3}, {0.081994, -0.248946, 0.166952, 1, 0, -1});
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-4, 1e-5);
+}
+
+TEST_F(OpLogSoftmaxBackwardDataTest, OuterDim) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_output = tf.make({2, 3}, {0.1, -0.2, 0.3, 1, 0, -1});
+  // log_softmax([[1, 2, 3], [0, -1, 0.5]], dim=0)
+  Tensor output = tf.make(
+      {2, 3},
+      {-0.313262, -0.048587, -0.07889, -1.313262, -3.048587, -2.57889});
+  Tensor out = tf.zeros({2, 3});
+
+  op_log_softmax_backward_data_out(
+      grad_output, output, -2, ScalarType::Float, out);
+
+  Tensor expected = tf.make(
+      {2, 3}, {-0.704164, -0.009485, 0.946899, 0.704165, 0.009485, -0.946899});
+  EXPECT_TENSOR_CLOSE_WITH_TOL(out, expected, 1e-4, 1e-5);
+}
+
+TEST_F(OpLogSoftmaxBackwardDataTest, InvalidDimDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_output = tf.ones({2, 3});
+  Tensor output = tf.ones({2, 3});
+  Tensor out = tf.zeros({2, 3});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_log_softmax_backward_data_out(
+          grad_output, output, 2, ScalarType::Float, out));
+}
@@ -13,6 +13,7 @@
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
 #include <algorithm>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -460,6 +461,33 @@ TEST_F(OpMulOutTest, BroadcastLastDimTest) {
   test_broadcast_last_dim<ScalarType::BFloat16>();
 }
 
+TEST_F(OpMulOutTest, BroadcastChannelsLastMatchesContiguous) {
+  TensorFactory<ScalarType::Float> tf;
+
+  std::vector<float> a_data(2 * 3 * 4 * 5);
+  for (size_t i = 0; i < a_data.size(); ++i) {
+    a_data[i] = 0.5f * i;
+  }
+  Tensor a = tf.make({2, 3, 4, 5}, a_data);
+  // Per-channel scales, as in a squeeze-and-excitation block, and a
+  // per-pixel mask.
+  Tensor b = tf.make({2, 3, 1, 1}, {1, 2, 3, 4, 5, 6});
+  std::vector<float> mask_data(2 * 4 * 5);
+  for (size_t i = 0; i < mask_data.size(); ++i) {
+    mask_data[i] = i % 3;
+  }
+  Tensor mask = tf.make({2, 1, 4, 5}, mask_data);
+
+  for (const Tensor& other : {b, mask}) {
+    Tensor out = tf.zeros({2, 3, 4, 5});
+    op_mul_out(a, other, out);
+
+    Tensor out_cl = tf.full_channels_last({2, 3, 4, 5}, 0);
+    op_mul_out(tf.channels_last_like(a), tf.channels_last_like(other), out_cl);
+    EXPECT_TENSOR_EQ(out_cl, tf.channels_last_like(out));
+  }
+}
+
 // Broadcast tensor a and b's size to a new size c.
 TEST_F(OpMulOutTest, BroadcastAB2CTest) {
   TensorFactory<ScalarType::Int> tf_a;
@@ -13,6 +13,9 @@
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
 #include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
 
+#include <cmath>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 using namespace ::testing;
@@ -1084,3 +1087,102 @@ TEST_F(OpNativeBatchNormLegitNoStatsOutTest, SampleAtomicTest4D) {
   EXPECT_TENSOR_CLOSE(out1, out1_expected);
   EXPECT_TENSOR_CLOSE(out2, out2_expected);
 }
+
+TEST_F(OpNativeBatchNormLegitNoTrainingOutTest, ChannelsLastMatchesContiguous) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+
+  // More channels than the kernel normalizes per block.
+  constexpr int kChannels = 70;
+  std::vector<float> input_data(2 * kChannels * 3 * 2);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = std::cos(0.3f * i);
+  }
+  std::vector<float> mean_data(kChannels);
+  std::vector<float> var_data(kChannels);
+  std::vector<float> weight_data(kChannels);
+  std::vector<float> bias_data(kChannels);
+  for (size_t c = 0; c < kChannels; ++c) {
+    mean_data[c] = 0.01f * c;
+    var_data[c] = 0.5f + 0.02f * c;
+    weight_data[c] = 1.0f - 0.005f * c;
+    bias_data[c] = 0.1f * std::sin(0.5f * c);
+  }
+  exec_aten::Tensor input = tfFloat.make({2, kChannels, 3, 2}, input_data);
+  exec_aten::optional<exec_aten::Tensor> weight =
+      exec_aten::optional<exec_aten::Tensor>(
+          tfFloat.make({kChannels}, weight_data));
+  exec_aten::optional<exec_aten::Tensor> bias =
+      exec_aten::optional<exec_aten::Tensor>(
+          tfFloat.make({kChannels}, bias_data));
+  exec_aten::Tensor running_mean = tfFloat.make({kChannels}, mean_data);
+  exec_aten::Tensor running_var = tfFloat.make({kChannels}, var_data);
+
+  exec_aten::Tensor out0 = tfFloat.zeros({2, kChannels, 3, 2});
+  exec_aten::Tensor out1 = tfFloat.zeros({0});
+  exec_aten::Tensor out2 = tfFloat.zeros({0});
+  op_native_batch_norm_legit_no_training_out(
+      input,
+      weight,
+      bias,
+      running_mean,
+      running_var,
+      1e-3,
+      1e-5,
+      out0,
+      out1,
+      out2);
+
+  exec_aten::Tensor out0_cl =
+      tfFloat.full_channels_last({2, kChannels, 3, 2}, 0);
+  op_native_batch_norm_legit_no_training_out(
+      tfFloat.channels_last_like(input),
+      weight,
+      bias,
+      running_mean,
+      running_var,
+      1e-3,
+      1e-5,
+      out0_cl,
+      out1,
+      out2);
+  EXPECT_TENSOR_CLOSE(out0_cl, tfFloat.channels_last_like(out0));
+}
+
+TEST_F(OpNativeBatchNormLegitNoStatsOutTest, ChannelsLastMatchesContiguous) {
+  torch::executor::testing::TensorFactory<exec_aten::ScalarType::Float> tfFloat;
+
+  std::vector<float> input_data(2 * 3 * 4 * 5);
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = std::cos(0.3f * i);
+  }
+  exec_aten::Tensor input = tfFloat.make({2, 3, 4, 5}, input_data);
+  exec_aten::optional<exec_aten::Tensor> weight =
+      exec_aten::optional<exec_aten::Tensor>(
+          tfFloat.make({3}, {1.1, 0.7, 0.3}));
+  exec_aten::optional<exec_aten::Tensor> bias =
+      exec_aten::optional<exec_aten::Tensor>(
+          tfFloat.make({3}, {1.7, 2.2, 3.3}));
+
+  exec_aten::Tensor out0 = tfFloat.zeros({2, 3, 4, 5});
+  exec_aten::Tensor out1 = tfFloat.zeros({3});
+  exec_aten::Tensor out2 = tfFloat.zeros({3});
+  op_native_batch_norm_legit_no_stats_out(
+      input, weight, bias, true, 1e-3, 1e-5, out0, out1, out2);
+
+  exec_aten::Tensor out0_cl = tfFloat.full_channels_last({2, 3, 4, 5}, 0);
+  exec_aten::Tensor out1_cl = tfFloat.zeros({3});
+  exec_aten::Tensor out2_cl = tfFloat.zeros({3});
+  op_native_batch_norm_legit_no_stats_out(
+      tfFloat.channels_last_like(input),
+      weight,
+      bias,
+      true,
+      1e-3,
+      1e-5,
+      out0_cl,
+      out1_cl,
+      out2_cl);
+  EXPECT_TENSOR_CLOSE(out0_cl, tfFloat.channels_last_like(out0));
+  EXPECT_TENSOR_CLOSE(out1_cl, out1);
+  EXPECT_TENSOR_CLOSE(out2_cl, out2);
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <tuple>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::IntArrayRef;
+using exec_aten::nullopt;
+using exec_aten::optional;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpNativeLayerNormBackwardTest : public OperatorTest {
+ protected:
+  ::std::tuple<Tensor&, Tensor&, Tensor&> op_native_layer_norm_backward_out(
+      const Tensor& grad_out,
+      const Tensor& input,
+      IntArrayRef normalized_shape,
+      const Tensor& mean,
+      const Tensor& rstd,
+      const optional<Tensor>& weight,
+      const optional<Tensor>& bias,
+      std::array<bool, 3> output_mask,
+      Tensor& out0,
+      Tensor& out1,
+      Tensor& out2) {
+    return torch::executor::aten::native_layer_norm_backward_outf(
+        context_,
+        grad_out,
+        input,
+        normalized_shape,
+        mean,
+        rstd,
+        weight,
+        bias,
+        ArrayRef<bool>(output_mask.data(), output_mask.size()),
+        out0,
+        out1,
+        out2);
+  }
+};
+
+TEST_F(OpNativeLayerNormBackwardTest, WithWeight) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_out = tf.make({2, 3}, {0.5, -1, 2, 1, 1, -0.5});
+  Tensor input = tf.make({2, 3}, {1, 2, 4, -1, 0, 3});
+  // native_layer_norm(input, [3], eps=1e-5)
+  Tensor mean = tf.make({2, 1}, {2.333333, 0.666667});
+  Tensor rstd = tf.make({2, 1}, {0.801781, 0.588347});
+  Tensor weight = tf.make({3}, {1, 2, 3});
+  Tensor bias = tf.zeros({3});
+  int64_t normalized_shape[] = {3};
+
+  Tensor grad_input = tf.zeros({2, 3});
+  Tensor grad_weight = tf.zeros({3});
+  Tensor grad_bias = tf.zeros({3});
+  op_native_layer_norm_backward_out(
+      grad_out,
+      input,
+      normalized_shape,
+      mean,
+      rstd,
+      weight,
+      bias,
+      {true, true, true},
+      grad_input,
+      grad_weight,
+      grad_bias);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      grad_input,
+      tf.make(
+          {2, 3},
+          {1.489007, -2.233537, 0.744529, -0.441258, 0.588348, -0.14709}),
+      1e-4,
+      1e-5);
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      grad_weight, tf.make({3}, {-1.5151, -0.124971, 1.986199}), 1e-4, 1e-5);
+  EXPECT_TENSOR_CLOSE(grad_bias, tf.make({3}, {1.5, 0, 1.5}));
+}
+
+TEST_F(OpNativeLayerNormBackwardTest, WithoutWeightInputGradOnly) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_out = tf.make({2, 3}, {0.5, -1, 2, 1, 1, -0.5});
+  Tensor input = tf.make({2, 3}, {1, 2, 4, -1, 0, 3});
+  Tensor mean = tf.make({2, 1}, {2.333333, 0.666667});
+  Tensor rstd = tf.make({2, 1}, {0.801781, 0.588347});
+  int64_t normalized_shape[] = {3};
+
+  Tensor grad_input = tf.zeros({2, 3});
+  // Not computed, so left untouched.
+  Tensor grad_weight = tf.ones({3});
+  Tensor grad_bias = tf.ones({3});
+  op_native_layer_norm_backward_out(
+      grad_out,
+      input,
+      normalized_shape,
+      mean,
+      rstd,
+      nullopt,
+      nullopt,
+      {true, false, false},
+      grad_input,
+      grad_weight,
+      grad_bias);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      grad_input,
+      tf.make(
+          {2, 3},
+          {0.687237, -1.030863, 0.343626, -0.101828, 0.135773, -0.033945}),
+      1e-4,
+      1e-5);
+  EXPECT_TENSOR_EQ(grad_weight, tf.ones({3}));
+  EXPECT_TENSOR_EQ(grad_bias, tf.ones({3}));
+}
+
+TEST_F(OpNativeLayerNormBackwardTest, MismatchedMeanDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_out = tf.ones({2, 3});
+  Tensor input = tf.ones({2, 3});
+  Tensor mean = tf.zeros({3, 1});
+  Tensor rstd = tf.ones({3, 1});
+  int64_t normalized_shape[] = {3};
+
+  Tensor grad_input = tf.zeros({2, 3});
+  Tensor grad_weight = tf.zeros({3});
+  Tensor grad_bias = tf.zeros({3});
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_native_layer_norm_backward_out(
+          grad_out,
+          input,
+          normalized_shape,
+          mean,
+          rstd,
+          nullopt,
+          nullopt,
+          {true, true, true},
+          grad_input,
+          grad_weight,
+          grad_bias));
+}
@@ -301,6 +301,33 @@ TEST_F(OpPermuteCopyTest, FiveDPermute) {
   // clang-format on
 }
 
+TEST_F(OpPermuteCopyTest, PermutePreservingTrailingDims) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Dims 2 and 3 keep their position, so each output row is a contiguous run
+  // of the input.
+  const std::vector<int32_t> sizes = {2, 3, 4, 5};
+  const std::vector<int64_t> new_dim = {1, 0, 2, 3};
+  std::vector<float> in_data(2 * 3 * 4 * 5);
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>(i);
+  }
+  std::vector<float> expected_data;
+  for (int32_t b = 0; b < 3; ++b) {
+    for (int32_t a = 0; a < 2; ++a) {
+      for (int32_t i = 0; i < 4 * 5; ++i) {
+        expected_data.push_back(in_data[(a * 3 + b) * 4 * 5 + i]);
+      }
+    }
+  }
+
+  Tensor in = tf.make(sizes, in_data);
+  Tensor out = tf.zeros({3, 2, 4, 5});
+  op_permute_copy_out(
+      in, ArrayRef<int64_t>(new_dim.data(), new_dim.size()), out);
+  EXPECT_TENSOR_EQ(out, tf.make({3, 2, 4, 5}, expected_data));
+}
+
 TEST_F(OpPermuteCopyTest, AllDimensionsSizeOne) {
   TensorFactory<ScalarType::Int> tf;
 
@@ -104,6 +104,18 @@ TEST_F(OpReluTest, ByteTensors) {
           {1, 2, 0, 3, 0, 5}));
 }
 
+TEST_F(OpReluTest, OutAliasesInput) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Memory planning may make out share the storage of the input.
+  const std::vector<int32_t> sizes = {3, 2};
+  Tensor in = tf.make(sizes, /*data=*/{-1, 2, 0, 3, -4, 5});
+
+  op_relu_out(in, in);
+
+  EXPECT_TENSOR_EQ(in, tf.make(sizes, /*data=*/{0, 2, 0, 3, 0, 5}));
+}
+
 TEST_F(OpReluTest, CharTensors) {
   test_relu_execution_ints<ScalarType::Char>();
 }
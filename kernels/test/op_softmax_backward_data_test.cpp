@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpSoftmaxBackwardDataTest : public OperatorTest {
+ protected:
+  Tensor& op_softmax_backward_data_out(
+      const Tensor& grad_output,
+      const Tensor& output,
+      int64_t dim,
+      ScalarType input_dtype,
+      Tensor& grad_input) {
+    return torch::executor::aten::_softmax_backward_data_outf(
+        context_, grad_output, output, dim, input_dtype, grad_input);
+  }
+};
+
+TEST_F(OpSoftmaxBackwardDataTest, LastDim) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_output = tf.make({2, 3}, {0.1, -0.2, 0.3, 1, 0, -1});
+  // softmax([[1, 2, 3], [0, -1, 0.5]], dim=1)
+  Tensor output = tf.make(
+      {2, 3}, {0.090031, 0.244728, 0.665241, 0.331499, 0.121952, 0.546549});
+  Tensor grad_input = tf.zeros({2, 3});
+
+  op_softmax_backward_data_out(
+      grad_output, output, -1, ScalarType::Float, grad_input);
+
+  Tensor expected = tf.make(
+      {2, 3}, {-0.005369, -0.088011, 0.09338, 0.402788, 0.026226, -0.429014});
+  EXPECT_TENSOR_CLOSE_WITH_TOL(grad_input, expected, 1e-4, 1e-6);
+}
+
+TEST_F(OpSoftmaxBackwardDataTest, OuterDim) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_output = tf.make({2, 3}, {0.1, -0.2, 0.3, 1, 0, -1});
+  // softmax([[1, 2, 3], [0, -1, 0.5]], dim=0)
+  Tensor output = tf.make(
+      {2, 3}, {0.731059, 0.952574, 0.924142, 0.268941, 0.047426, 0.075858});
+  Tensor grad_input = tf.zeros({2, 3});
+
+  op_softmax_backward_data_out(
+      grad_output, output, 0, ScalarType::Float, grad_input);
+
+  Tensor expected = tf.make(
+      {2, 3}, {-0.176951, -0.009035, 0.091135, 0.176951, 0.009035, -0.091135});
+  EXPECT_TENSOR_CLOSE_WITH_TOL(grad_input, expected, 1e-4, 1e-6);
+}
+
+TEST_F(OpSoftmaxBackwardDataTest, LongRowsMatchScalarFormula) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Rows that are not a multiple of the vector size, to cover the tail.
+  constexpr int kRows = 4;
+  constexpr int kDimSize = 37;
+  std::vector<float> grad_output_data(kRows * kDimSize);
+  std::vector<float> output_data(kRows * kDimSize);
+  std::vector<float> expected_data(kRows * kDimSize);
+  for (int row = 0; row < kRows; ++row) {
+    float dot = 0;
+    for (int d = 0; d < kDimSize; ++d) {
+      const int i = row * kDimSize + d;
+      grad_output_data[i] = (i % 7) * 0.1f - 0.3f;
+      output_data[i] = 1.0f / kDimSize + (d % 3 - 1) * 0.001f;
+      dot += grad_output_data[i] * output_data[i];
+    }
+    for (int d = 0; d < kDimSize; ++d) {
+      const int i = row * kDimSize + d;
+      expected_data[i] = output_data[i] * (grad_output_data[i] - dot);
+    }
+  }
+  Tensor grad_output = tf.make({kRows, kDimSize}, grad_output_data);
+  Tensor output = tf.make({kRows, kDimSize}, output_data);
+  Tensor grad_input = tf.zeros({kRows, kDimSize});
+
+  op_softmax_backward_data_out(
+      grad_output, output, 1, ScalarType::Float, grad_input);
+
+  EXPECT_TENSOR_CLOSE_WITH_TOL(
+      grad_input, tf.make({kRows, kDimSize}, expected_data), 1e-5, 1e-6);
+}
+
+TEST_F(OpSoftmaxBackwardDataTest, MismatchedDtypeDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor grad_output = tf.ones({2, 3});
+  Tensor output = tf.ones({2, 3});
+  Tensor grad_input = tf.zeros({2, 3});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_softmax_backward_data_out(
+          grad_output, output, 1, ScalarType::Half, grad_input));
+}
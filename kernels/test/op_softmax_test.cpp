@@ -16,6 +16,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using exec_aten::ScalarType;
@@ -319,3 +323,71 @@ TEST_F(OpSoftmaxOutTest, DynamicShapeUnbound) {
   Tensor ret = op_softmax_out(x, 1, false, out);
   EXPECT_TENSOR_CLOSE(out, expected_result);
 }
+
+TEST_F(OpSoftmaxOutTest, InnerDimLargerThanBlockMatchesReference) {
+  TensorFactory<ScalarType::Float> tf;
+  // Softmax over dim 1, whose stride of 70 spans more than one block of
+  // slices.
+  const int32_t outer = 2;
+  const int32_t size = 3;
+  const int32_t inner = 70;
+  std::vector<float> x_data(outer * size * inner);
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = static_cast<float>(i % 13) / 4 - 1;
+  }
+  std::vector<float> expected_data(x_data.size());
+  for (int32_t o = 0; o < outer; ++o) {
+    for (int32_t k = 0; k < inner; ++k) {
+      const float* x_slice = x_data.data() + o * size * inner + k;
+      float* expected_slice = expected_data.data() + o * size * inner + k;
+      float max_x = x_slice[0];
+      for (int32_t i = 1; i < size; ++i) {
+        max_x = std::max(max_x, x_slice[i * inner]);
+      }
+      float sum = 0;
+      for (int32_t i = 0; i < size; ++i) {
+        sum += std::exp(x_slice[i * inner] - max_x);
+      }
+      for (int32_t i = 0; i < size; ++i) {
+        expected_slice[i * inner] = std::exp(x_slice[i * inner] - max_x) / sum;
+      }
+    }
+  }
+
+  Tensor x = tf.make({outer, size, inner}, x_data);
+  Tensor out = tf.zeros({outer, size, inner});
+  op_softmax_out(x, /*dim=*/1, /*half_to_float=*/false, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({outer, size, inner}, expected_data));
+}
+
+TEST_F(OpSoftmaxOutTest, LongContiguousRowsMatchReference) {
+  TensorFactory<ScalarType::Float> tf;
+  // Rows as long as an LLM's logits, whose length isn't a multiple of the
+  // vector width.
+  const int32_t rows = 2;
+  const int32_t size = 100003;
+  std::vector<float> x_data(rows * size);
+  for (size_t i = 0; i < x_data.size(); ++i) {
+    x_data[i] = static_cast<float>(i % 17) / 2 - 4;
+  }
+  std::vector<float> expected_data(x_data.size());
+  for (int32_t r = 0; r < rows; ++r) {
+    const float* x_row = x_data.data() + r * size;
+    float max_x = x_row[0];
+    for (int32_t i = 1; i < size; ++i) {
+      max_x = std::max(max_x, x_row[i]);
+    }
+    double sum = 0;
+    for (int32_t i = 0; i < size; ++i) {
+      sum += std::exp(static_cast<double>(x_row[i] - max_x));
+    }
+    for (int32_t i = 0; i < size; ++i) {
+      expected_data[r * size + i] = std::exp(x_row[i] - max_x) / sum;
+    }
+  }
+
+  Tensor x = tf.make({rows, size}, x_data);
+  Tensor out = tf.zeros({rows, size});
+  op_softmax_out(x, /*dim=*/1, /*half_to_float=*/false, out);
+  EXPECT_TENSOR_CLOSE(out, tf.make({rows, size}, expected_data));
+}
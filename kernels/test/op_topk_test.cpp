@@ -15,6 +15,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <vector>
+
 using namespace ::testing;
 using exec_aten::IntArrayRef;
 using exec_aten::ScalarType;
@@ -136,3 +139,63 @@ TEST_F(OpTopkValuesTest, SmokeTest) {
   EXPECT_TENSOR_CLOSE(values, values_expected);
   EXPECT_TENSOR_EQ(indices, indices_expected);
 }
+
+TEST_F(OpTopkValuesTest, SmallKOfLargeDimMatchesReference) {
+  TensorFactory<ScalarType::Float> tfFloat;
+  TensorFactory<ScalarType::Long> tfLong;
+
+  // Large enough relative to k to use the heap selection. The values in each
+  // row are distinct, since the order of ties is unspecified.
+  constexpr int64_t kRows = 3;
+  constexpr int64_t kSize = 1000;
+  const int64_t k = 5;
+  std::vector<float> data(kRows * kSize);
+  for (int64_t i = 0; i < kRows * kSize; ++i) {
+    data[i] = static_cast<float>((i * 7919) % 1009) - 504.0f;
+  }
+
+  for (bool largest : {true, false}) {
+    for (int64_t dim : {0, 1}) {
+      // dim 0 reduces over the rows of the transposed data, which exercises
+      // the strided path.
+      const std::vector<int32_t> sizes = dim == 1
+          ? std::vector<int32_t>{kRows, kSize}
+          : std::vector<int32_t>{kSize, kRows};
+      std::vector<float> in_data(kRows * kSize);
+      for (int64_t r = 0; r < kRows; ++r) {
+        for (int64_t i = 0; i < kSize; ++i) {
+          const int64_t ix = dim == 1 ? r * kSize + i : i * kRows + r;
+          in_data[ix] = data[r * kSize + i];
+        }
+      }
+      Tensor input = tfFloat.make(sizes, in_data);
+
+      std::vector<int32_t> out_sizes = sizes;
+      out_sizes[dim] = k;
+      std::vector<float> expected_values(kRows * k);
+      std::vector<int64_t> expected_indices(kRows * k);
+      for (int64_t r = 0; r < kRows; ++r) {
+        std::vector<int64_t> order(kSize);
+        for (int64_t i = 0; i < kSize; ++i) {
+          order[i] = i;
+        }
+        const float* row = data.data() + r * kSize;
+        std::stable_sort(
+            order.begin(), order.end(), [&](int64_t a, int64_t b) {
+              return largest ? row[a] > row[b] : row[a] < row[b];
+            });
+        for (int64_t j = 0; j < k; ++j) {
+          const int64_t ix = dim == 1 ? r * k + j : j * kRows + r;
+          expected_values[ix] = row[order[j]];
+          expected_indices[ix] = order[j];
+        }
+      }
+
+      Tensor values = tfFloat.zeros(out_sizes);
+      Tensor indices = tfLong.zeros(out_sizes);
+      op_topk_values(input, k, dim, largest, true, values, indices);
+      EXPECT_TENSOR_EQ(values, tfFloat.make(out_sizes, expected_values));
+      EXPECT_TENSOR_EQ(indices, tfLong.make(out_sizes, expected_indices));
+    }
+  }
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::OptionalArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpUpsampleBilinear2dTest : public OperatorTest {
+ protected:
+  Tensor& op_upsample_bilinear2d_vec_out(
+      const Tensor& in,
+      const OptionalArrayRef<int64_t> output_size,
+      bool align_corners,
+      const OptionalArrayRef<double> scale_factors,
+      Tensor& out) {
+    return torch::executor::aten::upsample_bilinear2d_outf(
+        context_, in, output_size, align_corners, scale_factors, out);
+  }
+};
+
+TEST_F(OpUpsampleBilinear2dTest, UpsampleBy2) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  Tensor out = tf.zeros({1, 1, 4, 4});
+  const int64_t output_size[] = {4, 4};
+
+  op_upsample_bilinear2d_vec_out(
+      in, ArrayRef<int64_t>(output_size), false, exec_aten::nullopt, out);
+
+  // clang-format off
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 4, 4}, {
+      1.0, 1.25, 1.75, 2.0,
+      1.5, 1.75, 2.25, 2.5,
+      2.5, 2.75, 3.25, 3.5,
+      3.0, 3.25, 3.75, 4.0,
+  }));
+  // clang-format on
+}
+
+TEST_F(OpUpsampleBilinear2dTest, AlignCorners) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  Tensor out = tf.zeros({1, 1, 3, 3});
+  const int64_t output_size[] = {3, 3};
+
+  op_upsample_bilinear2d_vec_out(
+      in, ArrayRef<int64_t>(output_size), true, exec_aten::nullopt, out);
+
+  EXPECT_TENSOR_CLOSE(
+      out, tf.make({1, 1, 3, 3}, {1, 1.5, 2, 2, 2.5, 3, 3, 3.5, 4}));
+}
+
+TEST_F(OpUpsampleBilinear2dTest, ScaleFactors) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  Tensor out = tf.zeros({1, 1, 4, 3});
+  const double scale_factors[] = {2.0, 1.5};
+
+  op_upsample_bilinear2d_vec_out(
+      in, exec_aten::nullopt, false, ArrayRef<double>(scale_factors), out);
+
+  // clang-format off
+  EXPECT_TENSOR_CLOSE(out, tf.make({1, 1, 4, 3}, {
+      1.0, 1.5, 2.0,
+      1.5, 2.0, 2.5,
+      2.5, 3.0, 3.5,
+      3.0, 3.5, 4.0,
+  }));
+  // clang-format on
+}
+
+TEST_F(OpUpsampleBilinear2dTest, SameSizeIsCopy) {
+  TensorFactory<ScalarType::Double> tf;
+
+  Tensor in = tf.make({1, 2, 2, 3}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+  Tensor out = tf.zeros({1, 2, 2, 3});
+  const int64_t output_size[] = {2, 3};
+
+  op_upsample_bilinear2d_vec_out(
+      in, ArrayRef<int64_t>(output_size), false, exec_aten::nullopt, out);
+
+  EXPECT_TENSOR_EQ(out, in);
+}
+
+TEST_F(OpUpsampleBilinear2dTest, ChannelsLastMatchesContiguous) {
+  TensorFactory<ScalarType::Float> tf;
+
+  // Enough channels for the vectorized loop and its tail.
+  const std::vector<int32_t> sizes = {2, 19, 5, 7};
+  std::vector<float> data(2 * 19 * 5 * 7);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = std::sin(0.1f * i);
+  }
+  Tensor in = tf.make(sizes, data);
+  Tensor out = tf.zeros({2, 19, 9, 13});
+  const int64_t output_size[] = {9, 13};
+  op_upsample_bilinear2d_vec_out(
+      in, ArrayRef<int64_t>(output_size), false, exec_aten::nullopt, out);
+
+  Tensor in_cl = tf.channels_last_like(in);
+  Tensor out_cl = tf.full_channels_last({2, 19, 9, 13}, 0);
+  op_upsample_bilinear2d_vec_out(
+      in_cl, ArrayRef<int64_t>(output_size), false, exec_aten::nullopt, out_cl);
+
+  EXPECT_TENSOR_CLOSE(out_cl, tf.channels_last_like(out));
+}
+
+TEST_F(OpUpsampleBilinear2dTest, BothSizeAndScalesDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.ones({1, 1, 2, 2});
+  Tensor out = tf.zeros({1, 1, 4, 4});
+  const int64_t output_size[] = {4, 4};
+  const double scale_factors[] = {2.0, 2.0};
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_upsample_bilinear2d_vec_out(
+          in,
+          ArrayRef<int64_t>(output_size),
+          false,
+          ArrayRef<double>(scale_factors),
+          out));
+}
+
+TEST_F(OpUpsampleBilinear2dTest, MismatchedDtypeDies) {
+  if (torch::executor::testing::SupportedFeatures::get()->is_aten) {
+    GTEST_SKIP() << "ATen kernel can handle mismatched dtypes";
+  }
+  TensorFactory<ScalarType::Float> tf;
+  TensorFactory<ScalarType::Double> tf_double;
+
+  Tensor in = tf.ones({1, 1, 2, 2});
+  Tensor out = tf_double.zeros({1, 1, 4, 4});
+  const int64_t output_size[] = {4, 4};
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_upsample_bilinear2d_vec_out(
+          in, ArrayRef<int64_t>(output_size), false, exec_aten::nullopt, out));
+}
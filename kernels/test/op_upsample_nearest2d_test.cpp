@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/kernels/test/FunctionHeaderWrapper.h> // Declares the operator
+#include <executorch/kernels/test/TestUtil.h>
+#include <executorch/kernels/test/supported_features.h>
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_factory.h>
+#include <executorch/runtime/core/exec_aten/testing_util/tensor_util.h>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace ::testing;
+using exec_aten::ArrayRef;
+using exec_aten::OptionalArrayRef;
+using exec_aten::ScalarType;
+using exec_aten::Tensor;
+using torch::executor::testing::TensorFactory;
+
+class OpUpsampleNearest2dTest : public OperatorTest {
+ protected:
+  Tensor& op_upsample_nearest2d_vec_out(
+      const Tensor& in,
+      const OptionalArrayRef<int64_t> output_size,
+      const OptionalArrayRef<double> scale_factors,
+      Tensor& out) {
+    return torch::executor::aten::upsample_nearest2d_outf(
+        context_, in, output_size, scale_factors, out);
+  }
+};
+
+TEST_F(OpUpsampleNearest2dTest, UpsampleBy2) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 1, 2, 2}, {1, 2, 3, 4});
+  Tensor out = tf.zeros({1, 1, 4, 4});
+  const int64_t output_size[] = {4, 4};
+
+  op_upsample_nearest2d_vec_out(
+      in, ArrayRef<int64_t>(output_size), exec_aten::nullopt, out);
+
+  // clang-format off
+  EXPECT_TENSOR_EQ(out, tf.make({1, 1, 4, 4}, {
+      1, 1, 2, 2,
+      1, 1, 2, 2,
+      3, 3, 4, 4,
+      3, 3, 4, 4,
+  }));
+  // clang-format on
+}
+
+TEST_F(OpUpsampleNearest2dTest, NonIntegerRatio) {
+  TensorFactory<ScalarType::Int> tf;
+
+  Tensor in = tf.make({1, 1, 2, 3}, {1, 2, 3, 4, 5, 6});
+  Tensor out = tf.zeros({1, 1, 3, 5});
+  const int64_t output_size[] = {3, 5};
+
+  op_upsample_nearest2d_vec_out(
+      in, ArrayRef<int64_t>(output_size), exec_aten::nullopt, out);
+
+  // clang-format off
+  EXPECT_TENSOR_EQ(out, tf.make({1, 1, 3, 5}, {
+      1, 1, 2, 2, 3,
+      1, 1, 2, 2, 3,
+      4, 4, 5, 5, 6,
+  }));
+  // clang-format on
+}
+
+TEST_F(OpUpsampleNearest2dTest, Downsample) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make(
+      {1, 1, 4, 4}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16});
+  Tensor out = tf.zeros({1, 1, 2, 2});
+  const int64_t output_size[] = {2, 2};
+
+  op_upsample_nearest2d_vec_out(
+      in, ArrayRef<int64_t>(output_size), exec_aten::nullopt, out);
+
+  EXPECT_TENSOR_EQ(out, tf.make({1, 1, 2, 2}, {1, 3, 9, 11}));
+}
+
+TEST_F(OpUpsampleNearest2dTest, ScaleFactors) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.make({1, 2, 1, 2}, {1, 2, 3, 4});
+  Tensor out = tf.zeros({1, 2, 2, 4});
+  const double scale_factors[] = {2.0, 2.0};
+
+  op_upsample_nearest2d_vec_out(
+      in, exec_aten::nullopt, ArrayRef<double>(scale_factors), out);
+
+  EXPECT_TENSOR_EQ(
+      out,
+      tf.make({1, 2, 2, 4}, {1, 1, 2, 2, 1, 1, 2, 2, 3, 3, 4, 4, 3, 3, 4, 4}));
+}
+
+TEST_F(OpUpsampleNearest2dTest, ChannelsLastMatchesContiguous) {
+  TensorFactory<ScalarType::Float> tf;
+
+  const std::vector<int32_t> sizes = {2, 5, 3, 4};
+  std::vector<float> data(2 * 5 * 3 * 4);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = i;
+  }
+  Tensor in = tf.make(sizes, data);
+  Tensor out = tf.zeros({2, 5, 7, 9});
+  const int64_t output_size[] = {7, 9};
+  op_upsample_nearest2d_vec_out(
+      in, ArrayRef<int64_t>(output_size), exec_aten::nullopt, out);
+
+  Tensor in_cl = tf.channels_last_like(in);
+  Tensor out_cl = tf.full_channels_last({2, 5, 7, 9}, 0);
+  op_upsample_nearest2d_vec_out(
+      in_cl, ArrayRef<int64_t>(output_size), exec_aten::nullopt, out_cl);
+
+  EXPECT_TENSOR_EQ(out_cl, tf.channels_last_like(out));
+}
+
+TEST_F(OpUpsampleNearest2dTest, MissingSizeAndScalesDies) {
+  TensorFactory<ScalarType::Float> tf;
+
+  Tensor in = tf.ones({1, 1, 2, 2});
+  Tensor out = tf.zeros({1, 1, 4, 4});
+
+  ET_EXPECT_KERNEL_FAILURE(
+      context_,
+      op_upsample_nearest2d_vec_out(
+          in, exec_aten::nullopt, exec_aten::nullopt, out));
+}
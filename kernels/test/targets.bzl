@@ -208,8 +208,8 @@ def define_common_targets():
     _common_op_test("op_amin_test", ["aten", "portable"])
     _common_op_test("op_any_test", ["aten", "portable"])
     _common_op_test("op_arange_test", ["aten", "portable"])
-    _common_op_test("op_argmax_test", ["aten", "portable"])
-    _common_op_test("op_argmin_test", ["aten", "portable"])
+    _common_op_test("op_argmax_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_argmin_test", ["aten", "portable", "optimized"])
     _common_op_test("op_as_strided_copy_test", ["aten", "portable"])
     _common_op_test("op_asin_test", ["aten", "portable"])
     _common_op_test("op_asinh_test", ["aten", "portable"])
@@ -228,16 +228,16 @@ def define_common_targets():
     _common_op_test("op_clamp_test", ["aten", "portable"])
     _common_op_test("op_clone_test", ["aten", "portable"])
     _common_op_test("op_constant_pad_nd_test", ["aten", "portable"])
-    _common_op_test("op_convolution_test", ["aten", "portable"])
+    _common_op_test("op_convolution_test", ["aten", "portable", "optimized"])
     _common_op_test("op_convolution_backward_test", ["aten", "portable"])
     _common_op_test("op_copy_test", ["aten", "portable"])
     _common_op_test("op_cos_test", ["aten", "portable"])
     _common_op_test("op_cosh_test", ["aten", "portable"])
-    _common_op_test("op_cumsum_test", ["aten", "portable"])
+    _common_op_test("op_cumsum_test", ["aten", "portable", "optimized"])
     _common_op_test("op_detach_copy_test", ["aten", "portable"])
     _common_op_test("op_diagonal_copy_test", ["aten", "portable"])
     _common_op_test("op_div_test", ["aten", "portable", "optimized"])
-    _common_op_test("op_embedding_test", ["aten", "portable"])
+    _common_op_test("op_embedding_test", ["aten", "portable", "optimized"])
     _common_op_test("op_empty_test", ["aten", "portable"])
     _common_op_test("op_eq_test", ["aten", "portable"])
     _common_op_test("op_erf_test", ["aten", "portable"])
@@ -251,14 +251,16 @@ def define_common_targets():
     _common_op_test("op_fmod_test", ["aten", "portable"])
     _common_op_test("op_full_like_test", ["aten", "portable"])
     _common_op_test("op_full_test", ["aten", "portable"])
-    _common_op_test("op_gather_test", ["aten", "portable"])
+    _common_op_test("op_gather_test", ["aten", "portable", "optimized"])
     _common_op_test("op_ge_test", ["aten", "portable"])
     _common_op_test("op_gelu_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_gelu_backward_test", ["aten", "optimized"])
     _common_op_test("op_glu_test", ["aten", "portable"])
+    _common_op_test("op_grid_sampler_2d_test", ["aten", "optimized"])
     _common_op_test("op_gt_test", ["aten", "portable"])
     _common_op_test("op_hardtanh_test", ["aten", "portable"])
     _common_op_test("op_index_put_test", ["aten", "portable"])
-    _common_op_test("op_index_select_test", ["aten", "portable"])
+    _common_op_test("op_index_select_test", ["aten", "portable", "optimized"])
     _common_op_test("op_index_test", ["aten", "portable"])
     _common_op_test("op_isinf_test", ["aten", "portable"])
     _common_op_test("op_isnan_test", ["aten", "portable"])
@@ -267,6 +269,7 @@ def define_common_targets():
     _common_op_test("op_lift_fresh_copy_test", ["aten", "portable"])
     _common_op_test("op_linear_test", ["aten", "optimized"])
     _common_op_test("op_log_softmax_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_log_softmax_backward_data_test", ["aten", "optimized"])
     _common_op_test("op_log_test", ["aten", "portable"])
     _common_op_test("op_log10_test", ["aten", "portable"])
     _common_op_test("op_log1p_test", ["aten", "portable"])
@@ -292,6 +295,7 @@ def define_common_targets():
     _common_op_test("op_native_batch_norm_test", ["aten", "portable"])
     _common_op_test("op_native_group_norm_test", ["aten", "portable"])
     _common_op_test("op_native_layer_norm_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_native_layer_norm_backward_test", ["aten", "optimized"])
     _common_op_test("op_ne_test", ["aten", "portable"])
     _common_op_test("op_neg_test", ["aten", "portable", "optimized"])
     _common_op_test("op_nonzero_test", ["aten", "portable"])
@@ -328,7 +332,8 @@ def define_common_targets():
     _common_op_test("op_sinh_test", ["aten", "portable"])
     _common_op_test("op_slice_scatter_test", ["aten", "portable"])
     _common_op_test("op_slice_copy_test", ["aten", "portable"])
-    _common_op_test("op_softmax_test", ["aten", "portable"])
+    _common_op_test("op_softmax_test", ["aten", "portable", "optimized"])
+    _common_op_test("op_softmax_backward_data_test", ["aten", "optimized"])
     _common_op_test("op_split_copy_test", ["aten", "portable"])
     _common_op_test("op_split_with_sizes_copy_test", ["aten", "portable"])
     _common_op_test("op_sqrt_test", ["aten", "portable"])
@@ -346,6 +351,8 @@ def define_common_targets():
     _common_op_test("op_trunc_test", ["aten", "portable"])
     _common_op_test("op_unbind_copy_test", ["aten", "portable"])
     _common_op_test("op_unsqueeze_copy_test", ["aten", "portable"])
+    _common_op_test("op_upsample_bilinear2d_test", ["aten", "optimized"])
+    _common_op_test("op_upsample_nearest2d_test", ["aten", "optimized"])
     _common_op_test("op_var_test", ["aten", "portable"])
     _common_op_test("op_view_copy_test", ["aten", "portable"])
     _common_op_test("op_where_test", ["aten", "portable"])
@@ -22,10 +22,12 @@ class BackendExecutionContext final {
   BackendExecutionContext(
       EventTracer* event_tracer = nullptr,
       MemoryAllocator* temp_allocator = nullptr,
-      const char* method_name = nullptr)
+      const char* method_name = nullptr,
+      bool followed_by_same_backend = false)
       : event_tracer_(event_tracer),
         temp_allocator_(temp_allocator),
-        method_name_(method_name) {}
+        method_name_(method_name),
+        followed_by_same_backend_(followed_by_same_backend) {}
 
   /**
    * Returns a pointer to an instance of EventTracer to do profiling/debugging
@@ -62,10 +64,21 @@ class BackendExecutionContext final {
     return method_name_;
   }
 
+  /**
+   * Returns true if the runtime calls a delegate of the same backend right
+   * after this call, before anything else can read the outputs of this call.
+   * A backend that queues work on a device may then return without waiting
+   * for the work to finish, as long as the next call waits for it.
+   */
+  bool is_followed_by_same_backend() const {
+    return followed_by_same_backend_;
+  }
+
  private:
   EventTracer* event_tracer_ = nullptr;
   MemoryAllocator* temp_allocator_ = nullptr;
   const char* method_name_ = nullptr;
+  bool followed_by_same_backend_ = false;
 };
 
 } // namespace runtime
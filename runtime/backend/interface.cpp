@@ -8,6 +8,8 @@
 
 #include <executorch/runtime/backend/interface.h>
 
+#include <executorch/runtime/core/exec_aten/util/tensor_util.h>
+
 namespace executorch {
 namespace runtime {
 
@@ -16,6 +18,71 @@ BackendInterface::~BackendInterface() {}
 
 namespace {
 
+/// Copies the value of a carried output into the input it feeds.
+Error copy_carried_value(const EValue& from, EValue& to) {
+  if (!from.isTensor()) {
+    ET_CHECK_OR_RETURN_ERROR(
+        !to.isTensor(), InvalidArgument, "Carried value changed type");
+    to = from;
+    return Error::Ok;
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      to.isTensor(), InvalidArgument, "Carried value changed type");
+  const exec_aten::Tensor& src = from.toTensor();
+  exec_aten::Tensor dst = to.toTensor();
+  ET_CHECK_OR_RETURN_ERROR(
+      src.scalar_type() == dst.scalar_type(),
+      InvalidArgument,
+      "Carried tensor changed dtype");
+  Error err = resize_tensor(dst, src.sizes());
+  if (err != Error::Ok) {
+    return err;
+  }
+  if (src.nbytes() > 0) {
+    std::memcpy(dst.mutable_data_ptr(), src.const_data_ptr(), src.nbytes());
+  }
+  return Error::Ok;
+}
+
+/// Returns true if the loop predicate output says to run another iteration.
+bool loop_continues(const EValue& predicate) {
+  if (predicate.isBool()) {
+    return predicate.toBool();
+  }
+  return predicate.toTensor().const_data_ptr<bool>()[0];
+}
+
+} // namespace
+
+Error BackendInterface::execute_loop(
+    BackendExecutionContext& context,
+    DelegateHandle* handle,
+    EValue** args,
+    const DelegateLoop& loop) const {
+  EValue** outputs = args + loop.num_inputs;
+  for (int64_t i = 0; i < loop.max_iterations; ++i) {
+    if (i > 0) {
+      for (size_t j = 0; j < loop.num_carried; ++j) {
+        Error err = copy_carried_value(*outputs[j], *args[j]);
+        if (err != Error::Ok) {
+          return err;
+        }
+      }
+    }
+    Error err = execute(context, handle, args);
+    if (err != Error::Ok) {
+      return err;
+    }
+    if (loop.predicate_output >= 0 &&
+        !loop_continues(*outputs[loop.predicate_output])) {
+      break;
+    }
+  }
+  return Error::Ok;
+}
+
+namespace {
+
 // The max number of backends that can be registered globally.
 constexpr size_t kMaxRegisteredBackends = 16;
 
@@ -55,5 +122,29 @@ Error register_backend(const Backend& backend) {
   return Error::Ok;
 }
 
+Error set_backend_options(
+    const char* backend_name,
+    Span<const BackendOption> options) {
+  BackendInterface* backend = get_backend_class(backend_name);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend != nullptr,
+      NotFound,
+      "Backend %s is not registered.",
+      backend_name);
+  return backend->set_option(nullptr, options);
+}
+
+Error get_backend_options(
+    const char* backend_name,
+    Span<BackendOption> options) {
+  BackendInterface* backend = get_backend_class(backend_name);
+  ET_CHECK_OR_RETURN_ERROR(
+      backend != nullptr,
+      NotFound,
+      "Backend %s is not registered.",
+      backend_name);
+  return backend->get_option(nullptr, options);
+}
+
 } // namespace runtime
 } // namespace executorch
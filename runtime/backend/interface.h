@@ -12,12 +12,14 @@
 
 #include <executorch/runtime/backend/backend_execution_context.h>
 #include <executorch/runtime/backend/backend_init_context.h>
+#include <executorch/runtime/backend/options.h>
 #include <executorch/runtime/core/array_ref.h>
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/core/freeable_buffer.h>
 #include <executorch/runtime/core/memory_allocator.h>
 #include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
 #include <executorch/runtime/platform/compiler.h>
 
 namespace executorch {
@@ -39,6 +41,34 @@ struct CompileSpec {
  */
 using DelegateHandle = void;
 
+/**
+ * EXPERIMENTAL: The function a backend calls to report that an asynchronous
+ * execution started by `BackendInterface::execute_async()` has finished.
+ *
+ * @param[in] context The `callback_context` passed to `execute_async()`.
+ * @param[in] error Error::Ok if the execution succeeded and the outputs are
+ *     ready, or the reason it failed.
+ */
+using DelegateCompletionCallback = void (*)(void* context, Error error);
+
+/**
+ * EXPERIMENTAL: Describes a delegate call that runs the delegate repeatedly,
+ * as the body of a loop; see `BackendInterface::execute_loop()`.
+ */
+struct DelegateLoop {
+  /// The number of inputs at the start of `args`. The outputs follow them.
+  size_t num_inputs;
+  /// The number of carried values: after each iteration, output `i` becomes
+  /// input `i` of the next one, for `i < num_carried`.
+  size_t num_carried;
+  /// The maximum number of iterations. Always at least one.
+  int64_t max_iterations;
+  /// The position among the outputs of a Bool, or of a one-element Bool
+  /// tensor, that is false after the last iteration; or -1 to always run
+  /// `max_iterations` iterations.
+  int32_t predicate_output;
+};
+
 class BackendInterface {
  public:
   virtual ~BackendInterface() = 0;
@@ -98,6 +128,110 @@ class BackendInterface {
       DelegateHandle* handle,
       EValue** args) const = 0;
 
+  /**
+   * EXPERIMENTAL: Starts executing the given method's handle, possibly
+   * returning before the execution has finished. Backends that submit work to
+   * an accelerator and learn about its completion later (e.g. through a fence)
+   * can implement this so that the runtime doesn't have to block a thread while
+   * the accelerator runs.
+   *
+   * `context` and the memory it hands out are valid until `callback` is called.
+   * The backend must not touch `args` after calling `callback`.
+   *
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @param[in] args The method’s inputs and outputs.
+   * @param[in] callback The function to call when the execution finishes.
+   * @param[in] callback_context The value to pass as the first argument to
+   *     `callback`.
+   *
+   * @retval Error::Ok if the execution was started. The backend must then call
+   *     `callback(callback_context, result)` exactly once, from any thread,
+   *     once the outputs in `args` are ready or the execution failed. It may do
+   *     so before this method returns.
+   * @retval Error::NotSupported if the backend does not support asynchronous
+   *     execution, in which case the runtime calls `execute()` instead. This is
+   *     the default behavior.
+   * @retval Other errors if the execution could not be started. `callback` must
+   *     not be called in this case.
+   */
+  ET_NODISCARD virtual Error execute_async(
+      ET_UNUSED BackendExecutionContext& context,
+      ET_UNUSED DelegateHandle* handle,
+      ET_UNUSED EValue** args,
+      ET_UNUSED DelegateCompletionCallback callback,
+      ET_UNUSED void* callback_context) const {
+    return Error::NotSupported;
+  }
+
+  /**
+   * EXPERIMENTAL: Runs the given method's handle as the body of a loop, as
+   * described by `loop`, and returns when the loop is done. When it returns,
+   * the outputs in `args` hold the values of the last iteration.
+   *
+   * The default implementation calls `execute()` once per iteration and copies
+   * the carried outputs into the carried inputs between iterations, which
+   * saves the runtime a round trip per iteration. Backends that can keep the
+   * carried values on their device, or run the whole loop there, should
+   * override it.
+   *
+   * The carried inputs belong to the loop, and may be overwritten.
+   *
+   * @param[in] handle An opaque handle returned by `init()`.
+   * @param[in] args The method’s inputs and outputs.
+   * @param[in] loop How many inputs there are, which of them are carried, and
+   *     when the loop stops.
+   * @retval Error::Ok if successful.
+   */
+  ET_NODISCARD virtual Error execute_loop(
+      BackendExecutionContext& context,
+      DelegateHandle* handle,
+      EValue** args,
+      const DelegateLoop& loop) const;
+
+  /**
+   * EXPERIMENTAL: Changes runtime options, such as the number of threads or a
+   * performance mode, after `init()`.
+   *
+   * The runtime doesn't call this while `handle` executes; callers changing
+   * the options of the whole backend must make sure none of its delegates
+   * execute either.
+   *
+   * @param[in] handle A handle returned by `init()` to change the options of
+   *     that delegate instance, or nullptr to change the options of the backend
+   *     itself, such as the defaults of the delegates it initializes later.
+   * @param[in] options The options to set. Their keys are backend-specific.
+   *
+   * @retval Error::Ok if all options were set.
+   * @retval Error::NotSupported if the backend does not know one of the keys.
+   *     This is the default behavior.
+   * @retval Error::InvalidArgument if a value has the wrong type or is out of
+   *     range.
+   */
+  ET_NODISCARD virtual Error set_option(
+      ET_UNUSED DelegateHandle* handle,
+      ET_UNUSED Span<const BackendOption> options) const {
+    return Error::NotSupported;
+  }
+
+  /**
+   * EXPERIMENTAL: Reads runtime options set with `set_option()`, or their
+   * defaults.
+   *
+   * @param[in] handle A handle returned by `init()`, or nullptr for the
+   *     options of the backend itself.
+   * @param[in,out] options The options to get, whose values the backend sets.
+   *     String values point to memory owned by the backend.
+   *
+   * @retval Error::Ok if all options were read.
+   * @retval Error::NotSupported if the backend does not know one of the keys.
+   *     This is the default behavior.
+   */
+  ET_NODISCARD virtual Error get_option(
+      ET_UNUSED DelegateHandle* handle,
+      ET_UNUSED Span<BackendOption> options) const {
+    return Error::NotSupported;
+  }
+
   /**
    * Responsible for destroying a handle, if it's required for some backend.
    * It may be needed for some backends. For example, resources associated with
@@ -139,6 +273,31 @@ struct Backend {
  */
 ET_NODISCARD Error register_backend(const Backend& backend);
 
+/**
+ * EXPERIMENTAL: Changes runtime options of a registered backend as a whole;
+ * see `BackendInterface::set_option()`. To change the options of the delegates
+ * of a loaded method, use `Method::set_delegate_options()`.
+ *
+ * @param[in] backend_name The name the backend was registered with.
+ * @param[in] options The options to set.
+ * @retval Error::NotFound if no backend is registered with the name.
+ * @retval Other errors from `BackendInterface::set_option()`.
+ */
+ET_NODISCARD Error
+set_backend_options(const char* backend_name, Span<const BackendOption> options);
+
+/**
+ * EXPERIMENTAL: Reads runtime options of a registered backend as a whole; see
+ * `BackendInterface::get_option()`.
+ *
+ * @param[in] backend_name The name the backend was registered with.
+ * @param[in,out] options The options to get.
+ * @retval Error::NotFound if no backend is registered with the name.
+ * @retval Other errors from `BackendInterface::get_option()`.
+ */
+ET_NODISCARD Error
+get_backend_options(const char* backend_name, Span<BackendOption> options);
+
 } // namespace runtime
 } // namespace executorch
 
@@ -147,8 +306,11 @@ namespace executor {
 // TODO(T197294990): Remove these deprecated aliases once all users have moved
 // to the new `::executorch` namespaces.
 using ::executorch::runtime::Backend;
+using ::executorch::runtime::BackendOption;
 using ::executorch::runtime::CompileSpec;
+using ::executorch::runtime::DelegateCompletionCallback;
 using ::executorch::runtime::DelegateHandle;
+using ::executorch::runtime::DelegateLoop;
 using ::executorch::runtime::get_backend_class;
 using ::executorch::runtime::register_backend;
 using ::executorch::runtime::SizedBuffer;
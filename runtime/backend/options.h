@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include <executorch/runtime/platform/assert.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * EXPERIMENTAL: A runtime option of a backend or delegate: a key and a typed
+ * value. See `BackendInterface::set_option()`.
+ *
+ * Keys and string values are not copied, and must outlive the call they are
+ * passed to.
+ */
+class BackendOption final {
+ public:
+  enum class Type : uint8_t {
+    /// No value. Options to get start out like this.
+    None,
+    Bool,
+    Int,
+    String,
+  };
+
+  /// An option without a value, to pass to `get_option()`.
+  explicit BackendOption(const char* key) : key_(key), type_(Type::None) {}
+
+  BackendOption(const char* key, bool value) : key_(key) {
+    set(value);
+  }
+
+  BackendOption(const char* key, int64_t value) : key_(key) {
+    set(value);
+  }
+
+  BackendOption(const char* key, int value)
+      : BackendOption(key, static_cast<int64_t>(value)) {}
+
+  BackendOption(const char* key, const char* value) : key_(key) {
+    set(value);
+  }
+
+  const char* key() const {
+    return key_;
+  }
+
+  Type type() const {
+    return type_;
+  }
+
+  bool isBool() const {
+    return type_ == Type::Bool;
+  }
+
+  bool isInt() const {
+    return type_ == Type::Int;
+  }
+
+  bool isString() const {
+    return type_ == Type::String;
+  }
+
+  bool toBool() const {
+    ET_CHECK_MSG(isBool(), "Option %s is not a bool", key_);
+    return bool_value_;
+  }
+
+  int64_t toInt() const {
+    ET_CHECK_MSG(isInt(), "Option %s is not an int", key_);
+    return int_value_;
+  }
+
+  const char* toString() const {
+    ET_CHECK_MSG(isString(), "Option %s is not a string", key_);
+    return string_value_;
+  }
+
+  void set(bool value) {
+    type_ = Type::Bool;
+    bool_value_ = value;
+  }
+
+  void set(int64_t value) {
+    type_ = Type::Int;
+    int_value_ = value;
+  }
+
+  void set(const char* value) {
+    type_ = Type::String;
+    string_value_ = value;
+  }
+
+ private:
+  const char* key_;
+  Type type_;
+  union {
+    bool bool_value_;
+    int64_t int_value_;
+    const char* string_value_;
+  };
+};
+
+} // namespace runtime
+} // namespace executorch
@@ -18,6 +18,7 @@ def define_common_targets():
                 "backend_execution_context.h",
                 "backend_init_context.h",
                 "interface.h",
+                "options.h",
             ],
             preprocessor_flags = ["-DUSE_ATEN_LIB"] if aten_mode else [],
             visibility = [
@@ -26,8 +27,13 @@ def define_common_targets():
             ],
             exported_deps = [
                 "//executorch/runtime/core:core",
+                "//executorch/runtime/core:device_allocator",
                 "//executorch/runtime/core:evalue" + aten_suffix,
                 "//executorch/runtime/core:event_tracer" + aten_suffix,
                 "//executorch/runtime/core:memory_allocator",
+                "//executorch/runtime/core:named_data_map" + aten_suffix,
+            ],
+            deps = [
+                "//executorch/runtime/core/exec_aten/util:tensor_util" + aten_suffix,
             ],
         )
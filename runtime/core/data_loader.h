@@ -12,6 +12,7 @@
 
 #include <executorch/runtime/core/freeable_buffer.h>
 #include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
 #include <executorch/runtime/platform/compiler.h>
 
 namespace executorch {
@@ -48,6 +49,11 @@ class DataLoader {
        * Data used for initializing mutable tensors.
        */
       Mutable,
+      /**
+       * Data of tensors that are stored outside of the program, e.g. in a
+       * FlatTensor file.
+       */
+      External,
     };
 
     /// Type of the segment.
@@ -62,6 +68,17 @@ class DataLoader {
     /// types.
     const char* descriptor;
 
+    /// If nonzero, the segment is stored compressed, in this many bytes
+    /// starting at `compressed_offset` in the data source. The offset and size
+    /// passed to load() are then relative to the uncompressed data of the
+    /// segment. Only loaders whose supports_compressed_segments() returns true
+    /// are asked to load compressed segments.
+    size_t compressed_size = 0;
+
+    /// The byte offset in the data source of the compressed segment. Unused if
+    /// `compressed_size` is zero.
+    size_t compressed_offset = 0;
+
     SegmentInfo() = default;
 
     explicit SegmentInfo(
@@ -73,6 +90,21 @@ class DataLoader {
           descriptor(descriptor) {}
   };
 
+  /**
+   * One read of a batch passed to load_into_batch().
+   */
+  struct LoadIntoRequest {
+    /// The byte offset in the data source to start loading from.
+    size_t offset;
+    /// The number of bytes to load.
+    size_t size;
+    /// Information about the segment being loaded.
+    SegmentInfo segment_info;
+    /// The buffer to load data into. Must point to at least `size` bytes of
+    /// memory.
+    void* buffer;
+  };
+
   virtual ~DataLoader() = default;
 
   /**
@@ -119,6 +151,100 @@ class DataLoader {
     return Error::NotImplemented;
   }
 
+  /**
+   * Loads several ranges of the underlying data source into the provided
+   * buffers. Implementations may issue the reads concurrently and complete
+   * them in any order, so the buffers must not overlap.
+   *
+   * NOTE: This must be thread-safe. If this call modifies common state, the
+   * implementation must do its own locking.
+   *
+   * @param requests The reads to perform.
+   *
+   * @returns Error::Ok if every read was successful, or the error of a failed
+   *     read otherwise. On failure, the contents of all buffers are undefined.
+   */
+  ET_NODISCARD virtual Error load_into_batch(
+      Span<const LoadIntoRequest> requests) const {
+    // Loaders without a way to overlap reads perform them one at a time.
+    for (const auto& request : requests) {
+      Error err = load_into(
+          request.offset, request.size, request.segment_info, request.buffer);
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+    return Error::Ok;
+  }
+
+  /**
+   * Starts the reads of load_into_batch() without waiting for them, e.g. as
+   * DMA transfers from external flash, so that the caller can compute while
+   * they run. The caller must pass the same requests to
+   * wait_for_load_into_batch() before touching the buffers, and keep the
+   * requests and the buffers alive until then. Several batches may be in
+   * flight at once, as long as their buffers don't overlap.
+   *
+   * NOTE: This must be thread-safe. If this call modifies common state, the
+   * implementation must do its own locking.
+   *
+   * @param requests The reads to start.
+   *
+   * @returns Error::Ok if the reads were started. Errors of the reads
+   *     themselves may be reported by either call.
+   */
+  ET_NODISCARD virtual Error start_load_into_batch(
+      Span<const LoadIntoRequest> requests) const {
+    // Loaders without asynchronous reads finish them before returning.
+    return load_into_batch(requests);
+  }
+
+  /**
+   * Waits for the reads started by start_load_into_batch() with `requests`.
+   *
+   * @param requests The requests passed to start_load_into_batch().
+   *
+   * @returns Error::Ok if every read was successful, or the error of a failed
+   *     read otherwise. On failure, the contents of all buffers are undefined.
+   */
+  ET_NODISCARD virtual Error wait_for_load_into_batch(
+      Span<const LoadIntoRequest> requests) const {
+    (void)requests;
+    return Error::Ok;
+  }
+
+  /**
+   * Hints that data in the given range will be loaded soon, so that the loader
+   * can start reading it in the background. Must not block on the read. Errors
+   * are not reported: an ignored or failed hint only means that the later
+   * load() is not sped up.
+   *
+   * NOTE: This must be thread-safe. If this call modifies common state, the
+   * implementation must do its own locking.
+   *
+   * @param offset The byte offset in the data source of the data.
+   * @param size The number of bytes that will be loaded.
+   * @param segment_info Information about the segment that will be loaded.
+   */
+  virtual void prefetch(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info) const {
+    // Loaders that can't read ahead ignore the hint.
+    (void)offset;
+    (void)size;
+    (void)segment_info;
+  }
+
+  /**
+   * Returns true if the loader can load the data of compressed segments, whose
+   * SegmentInfo has a nonzero `compressed_size`. See
+   * extension/data_loader/decompressing_data_loader.h.
+   */
+  virtual bool supports_compressed_segments() const {
+    return false;
+  }
+
   /**
    * Returns the length of the underlying data source, typically the file size.
    */
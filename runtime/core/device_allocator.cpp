@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/core/device_allocator.h>
+
+#include <cstring>
+
+namespace executorch {
+namespace runtime {
+
+// Pure-virtual dtors still need an implementation.
+DeviceAllocator::~DeviceAllocator() {}
+
+namespace {
+
+// The max number of device allocators that can be registered globally.
+constexpr size_t kMaxRegisteredDeviceAllocators = 16;
+
+struct RegisteredDeviceAllocator {
+  const char* name;
+  DeviceAllocator* allocator;
+};
+
+/// Global table of registered device allocators.
+RegisteredDeviceAllocator
+    registered_device_allocators[kMaxRegisteredDeviceAllocators];
+
+/// The number of device allocators registered in the table.
+size_t num_registered_device_allocators = 0;
+
+} // namespace
+
+DeviceAllocator* get_device_allocator(const char* name) {
+  for (size_t i = 0; i < num_registered_device_allocators; i++) {
+    const RegisteredDeviceAllocator& entry = registered_device_allocators[i];
+    if (strcmp(entry.name, name) == 0) {
+      return entry.allocator;
+    }
+  }
+  return nullptr;
+}
+
+Error register_device_allocator(const char* name, DeviceAllocator* allocator) {
+  if (name == nullptr || allocator == nullptr) {
+    return Error::InvalidArgument;
+  }
+  if (num_registered_device_allocators >= kMaxRegisteredDeviceAllocators) {
+    return Error::Internal;
+  }
+
+  // Check if the name already exists in the table
+  if (get_device_allocator(name) != nullptr) {
+    return Error::InvalidArgument;
+  }
+
+  registered_device_allocators[num_registered_device_allocators++] = {
+      name, allocator};
+  return Error::Ok;
+}
+
+} // namespace runtime
+} // namespace executorch
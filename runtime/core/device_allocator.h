@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Allocates host-accessible memory that a delegate can also access directly,
+ * such as ION/dmabuf or rpcmem buffers shared with an accelerator. A backend
+ * that recognizes its own memory in the inputs and outputs of a delegate call
+ * can hand it to the device instead of copying from and to host buffers.
+ *
+ * Backends register an implementation with register_device_allocator(),
+ * usually under the name that they register their BackendInterface with, and
+ * clients look it up with get_device_allocator() to allocate the inputs and
+ * outputs of a method, e.g. with extension/tensor's empty_with_allocator().
+ *
+ * Implementations must be thread-safe.
+ */
+class DeviceAllocator {
+ public:
+  /**
+   * Default alignment of memory returned by allocate(), which matches
+   * MemoryAllocator::kDefaultAlignment.
+   */
+  static constexpr size_t kDefaultAlignment = alignof(void*);
+
+  virtual ~DeviceAllocator() = 0;
+
+  /**
+   * Allocates `size` bytes of memory.
+   *
+   * @param[in] size The number of bytes to allocate.
+   * @param[in] alignment The alignment of the returned pointer. Must be a power
+   *     of 2.
+   *
+   * @returns A pointer to the memory, which the host can read and write, or
+   *     nullptr if the memory could not be allocated.
+   */
+  virtual void* allocate(size_t size, size_t alignment = kDefaultAlignment) = 0;
+
+  /**
+   * Frees memory returned by allocate() of this allocator.
+   */
+  virtual void free(void* ptr) = 0;
+
+  /**
+   * Returns the file descriptor that shares the memory at `ptr` with drivers
+   * or other processes, for allocators backed by dmabuf and the like.
+   *
+   * @retval Error::NotSupported if the memory has no file descriptor.
+   */
+  virtual Result<int> get_fd(ET_UNUSED void* ptr) {
+    return Error::NotSupported;
+  }
+};
+
+/**
+ * Registers a device allocator under a name, so that clients can find it with
+ * get_device_allocator(). The allocator must outlive every use of it.
+ *
+ * @param[in] name The name of the allocator, usually that of the backend.
+ * @param[in] allocator The allocator to register.
+ *
+ * @retval Error::InvalidArgument if an allocator is already registered with
+ *     the name.
+ * @retval Error::Internal if the table of allocators is full.
+ */
+ET_NODISCARD Error
+register_device_allocator(const char* name, DeviceAllocator* allocator);
+
+/**
+ * Returns the device allocator registered under `name`, or nullptr if there is
+ * none.
+ */
+DeviceAllocator* get_device_allocator(const char* name);
+
+} // namespace runtime
+} // namespace executorch
@@ -79,6 +79,10 @@ enum class Error : error_code_t {
   /// Error caused by the contents of a program.
   InvalidProgram = 0x23,
 
+  /// Error caused by the contents of external data, e.g. a tensor whose
+  /// layout does not match the program that uses it.
+  InvalidExternalData = 0x24,
+
   /*
    * Delegate errors.
    */
@@ -13,19 +13,20 @@ namespace runtime {
 template <>
 exec_aten::ArrayRef<exec_aten::optional<exec_aten::Tensor>>
 BoxedEvalueList<exec_aten::optional<exec_aten::Tensor>>::get() const {
-  for (typename exec_aten::ArrayRef<
-           exec_aten::optional<exec_aten::Tensor>>::size_type i = 0;
-       i < wrapped_vals_.size();
-       i++) {
-    if (wrapped_vals_[i] == nullptr) {
-      unwrapped_vals_[i] = exec_aten::nullopt;
-    } else {
-      unwrapped_vals_[i] =
-          wrapped_vals_[i]->to<exec_aten::optional<exec_aten::Tensor>>();
+  if (!unwrapped_) {
+    for (uint32_t i = 0; i < size_; i++) {
+      if (wrapped_vals_[i] == nullptr) {
+        unwrapped_vals_[i] = exec_aten::nullopt;
+      } else {
+        unwrapped_vals_[i] =
+            wrapped_vals_[i]->to<exec_aten::optional<exec_aten::Tensor>>();
+      }
     }
+    unwrapped_ = internal::boxed_list_caches_unwrapped<
+        exec_aten::optional<exec_aten::Tensor>>::value;
   }
   return exec_aten::ArrayRef<exec_aten::optional<exec_aten::Tensor>>{
-      unwrapped_vals_, wrapped_vals_.size()};
+      unwrapped_vals_, size_};
 }
 } // namespace runtime
 } // namespace executorch
@@ -40,6 +40,28 @@ struct evalue_to_ref_overload_return<executorch::aten::Tensor> {
   using type = executorch::aten::Tensor&;
 };
 
+// Whether a BoxedEvalueList<T> may keep its unwrapped values across calls to
+// get(). A portable Tensor is only a pointer to its TensorImpl, and a value
+// keeps its TensorImpl for the life of the Method; at::Tensors are replaced
+// wholesale when inputs are set, and scalars change with every execution.
+template <typename T>
+struct boxed_list_caches_unwrapped {
+  static constexpr bool value = false;
+};
+
+#ifndef USE_ATEN_LIB
+template <>
+struct boxed_list_caches_unwrapped<executorch::aten::Tensor> {
+  static constexpr bool value = true;
+};
+
+template <>
+struct boxed_list_caches_unwrapped<
+    executorch::aten::optional<executorch::aten::Tensor>> {
+  static constexpr bool value = true;
+};
+#endif
+
 } // namespace internal
 
 /*
@@ -51,6 +73,10 @@ struct evalue_to_ref_overload_return<executorch::aten::Tensor> {
  * element 2 changes (in the case of tensor this means the TensorImpl* stored in
  * the tensor changes). To solve this instead they must be created dynamically
  * whenever they are used.
+ *
+ * The exception is lists of portable Tensors, whose elements only change if
+ * their values are replaced, which the runtime does not do: those are
+ * unwrapped on the first get(), and later calls return the same list.
  */
 template <typename T>
 class BoxedEvalueList {
@@ -63,17 +89,25 @@ class BoxedEvalueList {
    * unwrapped vals.
    */
   BoxedEvalueList(EValue** wrapped_vals, T* unwrapped_vals, int size)
-      : wrapped_vals_(wrapped_vals, size), unwrapped_vals_(unwrapped_vals) {}
+      : wrapped_vals_(wrapped_vals),
+        unwrapped_vals_(unwrapped_vals),
+        size_(static_cast<uint32_t>(size)) {}
   /*
    * Constructs and returns the list of T specified by the EValue pointers
    */
   executorch::aten::ArrayRef<T> get() const;
 
  private:
-  // Source of truth for the list
-  executorch::aten::ArrayRef<EValue*> wrapped_vals_;
+  // Source of truth for the list. Stored as a pointer and a 32-bit size
+  // rather than an ArrayRef, so that the unwrapped_ flag fits in the same
+  // space and EValue does not grow.
+  EValue** wrapped_vals_ = nullptr;
   // Same size as wrapped_vals
-  mutable T* unwrapped_vals_;
+  mutable T* unwrapped_vals_ = nullptr;
+  uint32_t size_ = 0;
+  // Whether unwrapped_vals_ holds the list; see
+  // internal::boxed_list_caches_unwrapped.
+  mutable bool unwrapped_ = false;
 };
 
 template <>
@@ -541,13 +575,14 @@ EVALUE_DEFINE_TO(
 
 template <typename T>
 executorch::aten::ArrayRef<T> BoxedEvalueList<T>::get() const {
-  for (typename executorch::aten::ArrayRef<T>::size_type i = 0;
-       i < wrapped_vals_.size();
-       i++) {
-    ET_CHECK(wrapped_vals_[i] != nullptr);
-    unwrapped_vals_[i] = wrapped_vals_[i]->template to<T>();
+  if (!unwrapped_) {
+    for (uint32_t i = 0; i < size_; i++) {
+      ET_CHECK(wrapped_vals_[i] != nullptr);
+      unwrapped_vals_[i] = wrapped_vals_[i]->template to<T>();
+    }
+    unwrapped_ = internal::boxed_list_caches_unwrapped<T>::value;
   }
-  return executorch::aten::ArrayRef<T>{unwrapped_vals_, wrapped_vals_.size()};
+  return executorch::aten::ArrayRef<T>{unwrapped_vals_, size_};
 }
 
 } // namespace runtime
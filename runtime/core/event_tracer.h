@@ -7,6 +7,7 @@
  */
 
 #include <executorch/runtime/core/array_ref.h>
+#include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/platform/platform.h>
 #include <stdlib.h>
@@ -105,6 +106,39 @@ struct EventTracerEntry {
   /// executorch/exir/backend/utils.py.
   DelegateDebugIdType delegate_event_id_type;
 };
+
+/**
+ * A source of hardware performance counters, e.g. CPU cycles, retired
+ * instructions or cache misses. An EventTracer that supports counters reads
+ * them when a profiling event starts and ends, and records the difference
+ * along with the timestamps of the event.
+ */
+class CounterSource {
+ public:
+  /// The maximum number of counters that a CounterSource may provide.
+  static constexpr size_t kMaxCounters = 8;
+
+  /**
+   * Return the number of counters that read_counters() reads, which is at
+   * most kMaxCounters.
+   */
+  virtual size_t num_counters() const = 0;
+
+  /**
+   * Return a human readable name for the counter at the given index, e.g.
+   * "cycles". The returned string must outlive this object.
+   */
+  virtual const char* counter_name(size_t index) const = 0;
+
+  /**
+   * Read the current values of all the counters into values[0] to
+   * values[num_counters() - 1]. This is called twice for every profiling
+   * event, so it should be cheap.
+   */
+  virtual void read_counters(uint64_t* values) = 0;
+
+  virtual ~CounterSource() {}
+};
 /**
  * EventTracer is a class that users can inherit and implement to
  * log/serialize/stream etc. the profiling and debugging events that are
@@ -127,6 +161,36 @@ class EventTracer {
    */
   virtual void create_event_block(const char* name) = 0;
 
+  /**
+   * Drop the events that the calling thread logged since its last call to
+   * create_event_block(), including the block itself. Method uses this to
+   * keep only the executions that it was asked to keep, e.g. those slower
+   * than a threshold. Event tracers that cannot drop events keep them.
+   *
+   * @retval Error::Ok if the events were dropped.
+   * @retval Error::NotSupported if the events were kept.
+   */
+  virtual Error discard_event_block() {
+    return Error::NotSupported;
+  }
+
+  /**
+   * Record the values of the counters of counter_source with every profiling
+   * event that starts after this call. Pass nullptr to stop recording
+   * counters. Call this before create_event_block(), since the counters that
+   * are recorded may be a property of the event block.
+   *
+   * @param[in] counter_source The counters to record, which must outlive its
+   * use by this object.
+   *
+   * @retval Error::Ok if the counters will be recorded.
+   * @retval Error::NotSupported if this event tracer cannot record counters.
+   */
+  virtual Error set_counter_source(CounterSource* counter_source) {
+    (void)counter_source;
+    return Error::NotSupported;
+  }
+
   /**
    * Start the profiling of the event identified by name and debug_handle.
    * The user can pass in a chain_id and debug_handle to this call, or leave
@@ -498,6 +562,7 @@ namespace executor {
 // to the new `::executorch` namespaces.
 using ::executorch::runtime::AllocatorID;
 using ::executorch::runtime::ChainID;
+using ::executorch::runtime::CounterSource;
 using ::executorch::runtime::DebugHandle;
 using ::executorch::runtime::DelegateDebugIdType;
 using ::executorch::runtime::EventTracer;
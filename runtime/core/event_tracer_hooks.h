@@ -179,6 +179,21 @@ inline void event_tracer_create_event_block(
 #endif
 }
 
+/**
+ * Drop the events logged since the last event block was created, if the
+ * event tracer supports it.
+ */
+inline void event_tracer_discard_event_block(EventTracer* event_tracer) {
+#ifdef ET_EVENT_TRACER_ENABLED
+  if (event_tracer) {
+    // Tracers that cannot drop events keep them, which is harmless.
+    (void)event_tracer->discard_event_block();
+  }
+#else //! ET_EVENT_TRACER_ENABLED
+  (void)event_tracer;
+#endif
+}
+
 /**
  * Explicitly mark the beginning of a new profiling event. This returns
  * an instance of an EventTracerEntry object that the user needs to keep
@@ -315,6 +330,7 @@ namespace internal {
 // to the new `::executorch` namespaces.
 using ::executorch::runtime::internal::event_tracer_begin_profiling_event;
 using ::executorch::runtime::internal::event_tracer_create_event_block;
+using ::executorch::runtime::internal::event_tracer_discard_event_block;
 using ::executorch::runtime::internal::event_tracer_end_profiling_event;
 using ::executorch::runtime::internal::event_tracer_log_evalue;
 using ::executorch::runtime::internal::event_tracer_log_evalue_output;
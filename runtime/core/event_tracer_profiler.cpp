@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/core/event_tracer_profiler.h>
+
+#include <executorch/runtime/platform/log.h>
+#include <executorch/runtime/platform/profiler.h>
+
+namespace executorch {
+namespace runtime {
+
+namespace {
+
+// The maximum number of nested events that can be in progress at once. The
+// profiling macros are scoped, so events end in the reverse order that they
+// began in.
+constexpr size_t kMaxOpenEvents = 16;
+
+struct OpenEvent {
+  uint32_t token;
+  EventTracerEntry entry;
+};
+
+EventTracer* profiling_event_tracer = nullptr;
+OpenEvent open_events[kMaxOpenEvents];
+uint32_t next_token = 0;
+
+void create_block(void* context, const char* name) {
+  static_cast<EventTracer*>(context)->create_event_block(name);
+}
+
+uint32_t begin_profiling(
+    void* context,
+    const char* name,
+    int32_t chain_idx,
+    uint32_t instruction_idx) {
+  // The profiler state uses the same defaults as kUnsetChainId and
+  // kUnsetDebugHandle for events outside of an instruction.
+  EventTracerEntry entry = static_cast<EventTracer*>(context)->start_profiling(
+      name, chain_idx, instruction_idx);
+  uint32_t token = next_token++;
+  if (next_token == kDroppedProfilingToken) {
+    next_token = 0;
+  }
+  open_events[token % kMaxOpenEvents] = {token, entry};
+  return token;
+}
+
+void end_profiling(void* context, uint32_t token_id) {
+  if (token_id == kDroppedProfilingToken) {
+    return;
+  }
+  const OpenEvent& event = open_events[token_id % kMaxOpenEvents];
+  if (event.token != token_id) {
+    ET_LOG(
+        Error,
+        "Dropping profiling event %u, more than %zu events are nested",
+        static_cast<unsigned>(token_id),
+        kMaxOpenEvents);
+    return;
+  }
+  static_cast<EventTracer*>(context)->end_profiling(event.entry);
+}
+
+profiler_backend_t event_tracer_backend = {
+    nullptr,
+    create_block,
+    begin_profiling,
+    end_profiling,
+};
+
+} // namespace
+
+void set_profiling_event_tracer(EventTracer* event_tracer) {
+  profiling_event_tracer = event_tracer;
+  event_tracer_backend.context = event_tracer;
+  set_profiler_backend(
+      event_tracer != nullptr ? &event_tracer_backend : nullptr);
+}
+
+EventTracer* get_profiling_event_tracer() {
+  return profiling_event_tracer;
+}
+
+} // namespace runtime
+} // namespace executorch
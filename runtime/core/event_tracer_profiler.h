@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/event_tracer.h>
+
+/**
+ * @file
+ *
+ * Sends the events of the profiling macros in runtime/platform/profiler.h, like
+ * EXECUTORCH_SCOPE_PROF() and EXECUTORCH_PROFILE_CREATE_BLOCK(), to an
+ * EventTracer instead of the statically allocated profiling buffer. This lets
+ * kernels and backends that use the macros share the profiling surface of the
+ * rest of the runtime, e.g. the wraparound buffer of ETDumpRingBuffer, and
+ * avoids sizing the buffer with MAX_PROFILE_EVENTS.
+ *
+ * The macros only log events in builds with PROFILING_ENABLED.
+ */
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Sends the events of the profiling macros to `event_tracer`, which must stay
+ * valid until it is replaced, or back to the profiling buffer if it is null.
+ * Memory allocations that the macros track stay in the profiling buffer.
+ *
+ * Like the profiling buffer, this is not thread-safe: only one thread at a
+ * time may log events with the macros. An EventTracer that requires an event
+ * block before its first event, like ETDumpGen, must have one created first.
+ *
+ * Do not pass the EventTracer of a Method that also logs its own events with
+ * the macros, or the events of the Method are logged twice.
+ */
+void set_profiling_event_tracer(EventTracer* event_tracer);
+
+/**
+ * Returns the EventTracer passed to set_profiling_event_tracer(), or nullptr
+ * if the events go to the profiling buffer.
+ */
+EventTracer* get_profiling_event_tracer();
+
+} // namespace runtime
+} // namespace executorch
+
+namespace torch {
+namespace executor {
+// TODO(T197294990): Remove these deprecated aliases once all users have moved
+// to the new `::executorch` namespaces.
+using ::executorch::runtime::get_profiling_event_tracer;
+using ::executorch::runtime::set_profiling_event_tracer;
+} // namespace executor
+} // namespace torch
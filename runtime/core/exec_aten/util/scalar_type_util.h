@@ -880,12 +880,18 @@ struct promote_types {
 //
 
 #ifdef ET_INTERNAL_CHECK_SELECTIVE_BUILD
-#define ET_INTERNAL_SWITCH_CASE(enum_type, CTYPE_ALIAS, ...)         \
-  case enum_type: {                                                  \
-    ET_INTERNAL_CHECK_SELECTIVE_BUILD(enum_type);                    \
-    using CTYPE_ALIAS =                                              \
-        ::executorch::runtime::ScalarTypeToCppType<enum_type>::type; \
-    return __VA_ARGS__();                                            \
+// The selection is evaluated at compile time, so the body of a case whose
+// dtype was not selected for the operator is never instantiated and adds
+// nothing to the binary. Reaching such a case at runtime aborts.
+#define ET_INTERNAL_SWITCH_CASE(enum_type, CTYPE_ALIAS, ...)           \
+  case enum_type: {                                                    \
+    if constexpr (ET_INTERNAL_SELECTIVE_BUILD_INCLUDES(enum_type)) {   \
+      using CTYPE_ALIAS =                                              \
+          ::executorch::runtime::ScalarTypeToCppType<enum_type>::type; \
+      return __VA_ARGS__();                                            \
+    } else {                                                           \
+      ET_INTERNAL_CHECK_SELECTIVE_BUILD(enum_type);                    \
+    }                                                                  \
   }
 #else
 #define ET_INTERNAL_SWITCH_CASE(enum_type, CTYPE_ALIAS, ...)         \
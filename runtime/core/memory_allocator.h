@@ -150,6 +150,13 @@ class MemoryAllocator {
     return size_;
   }
 
+  // Returns the number of bytes allocated since the last reset(), including
+  // the padding for alignment. Since allocations are only freed all at once,
+  // this is also the high-water mark since the last reset().
+  virtual size_t used_size() const {
+    return static_cast<size_t>(cur_ - begin_);
+  }
+
   // Resets the current pointer to the base address. It does nothing to
   // the contents.
   virtual void reset() {
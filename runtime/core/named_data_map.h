@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/tensor_layout.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Interface to access the data of tensors that are stored outside of the
+ * Program, keyed by their fully qualified names, e.g. "linear.weight".
+ *
+ * A Program that was exported with external constants finds their data in a
+ * NamedDataMap passed to Program::load_method(). Implementations are
+ * typically backed by a DataLoader, so that several Programs, or several
+ * processes, can share the same read-only data.
+ *
+ * NOTE: This interface is experimental and may change without notice.
+ */
+class NamedDataMap {
+ public:
+  virtual ~NamedDataMap() = default;
+
+  /**
+   * Get the layout of the tensor with the given key.
+   *
+   * @param[in] key The fully qualified name of the tensor.
+   * @returns The layout of the tensor, which is valid as long as the
+   *     NamedDataMap, or NotFound if there is no tensor with this key.
+   */
+  ET_NODISCARD virtual Result<TensorLayout> get_metadata(
+      const char* key) const = 0;
+
+  /**
+   * Get the data of the tensor with the given key, without copying it if the
+   * underlying storage allows.
+   *
+   * @param[in] key The fully qualified name of the tensor.
+   * @returns A FreeableBuffer that holds the read-only data of the tensor, or
+   *     NotFound if there is no tensor with this key.
+   */
+  ET_NODISCARD virtual Result<FreeableBuffer> get_data(
+      const char* key) const = 0;
+
+  /**
+   * Copy the data of the tensor with the given key into a buffer that the
+   * caller owns, e.g. to initialize a mutable tensor.
+   *
+   * @param[in] key The fully qualified name of the tensor.
+   * @param[out] buffer The buffer to copy the data into.
+   * @param[in] size The size of `buffer` in bytes. Must be at least the size
+   *     of the tensor's data.
+   * @returns The number of bytes copied, or an error.
+   */
+  ET_NODISCARD virtual Result<size_t>
+  load_data_into(const char* key, void* buffer, size_t size) const = 0;
+
+  /**
+   * Get the number of keys in the NamedDataMap.
+   */
+  ET_NODISCARD virtual Result<size_t> get_num_keys() const = 0;
+
+  /**
+   * Get the key at the given index.
+   *
+   * @param[in] index The index of the key, in [0, get_num_keys()).
+   * @returns The key, which is valid as long as the NamedDataMap, or
+   *     InvalidArgument if the index is out of range.
+   */
+  ET_NODISCARD virtual Result<const char*> get_key(size_t index) const = 0;
+};
+
+} // namespace runtime
+} // namespace executorch
@@ -70,6 +70,21 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_library(
+        name = "device_allocator",
+        srcs = ["device_allocator.cpp"],
+        exported_headers = [
+            "device_allocator.h",
+        ],
+        exported_deps = [
+            ":core",
+        ],
+        visibility = [
+            "//executorch/...",
+            "@EXECUTORCH_CLIENTS",
+        ],
+    )
+
     for aten_mode in (True, False):
         aten_suffix = ("_aten" if aten_mode else "")
         runtime.cxx_library(
@@ -91,10 +106,12 @@ def define_common_targets():
 
         runtime.cxx_library(
             name = "event_tracer" + aten_suffix,
+            srcs = ["event_tracer_profiler.cpp"],
             exported_headers = [
                 "event_tracer.h",
                 "event_tracer_hooks.h",
                 "event_tracer_hooks_delegate.h",
+                "event_tracer_profiler.h",
             ],
             visibility = [
                 "//executorch/...",
@@ -107,6 +124,36 @@ def define_common_targets():
             ],
         )
 
+        runtime.cxx_library(
+            name = "tensor_layout" + aten_suffix,
+            srcs = ["tensor_layout.cpp"],
+            exported_headers = ["tensor_layout.h"],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":core",
+                "//executorch/runtime/core/exec_aten:lib" + aten_suffix,
+            ],
+            deps = [
+                "//executorch/runtime/core/exec_aten/util:scalar_type_util" + aten_suffix,
+            ],
+        )
+
+        runtime.cxx_library(
+            name = "named_data_map" + aten_suffix,
+            exported_headers = ["named_data_map.h"],
+            visibility = [
+                "//executorch/...",
+                "@EXECUTORCH_CLIENTS",
+            ],
+            exported_deps = [
+                ":core",
+                ":tensor_layout" + aten_suffix,
+            ],
+        )
+
     runtime.cxx_library(
         name = "tag",
         exported_headers = [
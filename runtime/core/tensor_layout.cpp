@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/core/tensor_layout.h>
+
+#include <cinttypes>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
+
+namespace executorch {
+namespace runtime {
+
+/* static */ Result<TensorLayout> TensorLayout::create(
+    Span<const int32_t> sizes,
+    Span<const uint8_t> dim_order,
+    executorch::aten::ScalarType scalar_type) {
+  ET_CHECK_OR_RETURN_ERROR(
+      isValid(scalar_type),
+      InvalidArgument,
+      "Invalid ScalarType %" PRId8,
+      static_cast<int8_t>(scalar_type));
+  ET_CHECK_OR_RETURN_ERROR(
+      dim_order.size() == sizes.size(),
+      InvalidArgument,
+      "dim_order size %zu != sizes size %zu",
+      dim_order.size(),
+      sizes.size());
+
+  // Every dimension must appear exactly once in the dim order.
+  uint64_t seen_dims = 0;
+  for (size_t i = 0; i < dim_order.size(); ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        dim_order[i] < sizes.size() && dim_order[i] < 64 &&
+            (seen_dims & (uint64_t(1) << dim_order[i])) == 0,
+        InvalidArgument,
+        "Invalid dim_order entry %" PRIu8 " at index %zu",
+        dim_order[i],
+        i);
+    seen_dims |= uint64_t(1) << dim_order[i];
+  }
+
+  size_t nbytes = elementSize(scalar_type);
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        sizes[i] >= 0,
+        InvalidArgument,
+        "Negative size %" PRId32 " at index %zu",
+        sizes[i],
+        i);
+    nbytes *= static_cast<size_t>(sizes[i]);
+  }
+  return TensorLayout(sizes, dim_order, scalar_type, nbytes);
+}
+
+} // namespace runtime
+} // namespace executorch
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/core/span.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * Describes the shape and memory layout of the data of a tensor, without the
+ * data itself. The sizes and dim order are not owned, and must outlive the
+ * TensorLayout.
+ */
+class TensorLayout final {
+ public:
+  TensorLayout() = delete;
+
+  /**
+   * Creates a TensorLayout from the given parameters.
+   *
+   * @param[in] sizes The sizes of the tensor. Must outlive the TensorLayout.
+   * @param[in] dim_order The dim order of the tensor. Must outlive the
+   *     TensorLayout, and have as many entries as `sizes`, each of which is a
+   *     distinct index into `sizes`.
+   * @param[in] scalar_type The scalar type of the tensor.
+   * @returns A new TensorLayout, or InvalidArgument if the parameters are
+   *     inconsistent.
+   */
+  static Result<TensorLayout> create(
+      Span<const int32_t> sizes,
+      Span<const uint8_t> dim_order,
+      executorch::aten::ScalarType scalar_type);
+
+  /// Returns the sizes of the tensor.
+  Span<const int32_t> sizes() const {
+    return sizes_;
+  }
+
+  /// Returns the dim order of the tensor.
+  Span<const uint8_t> dim_order() const {
+    return dim_order_;
+  }
+
+  /// Returns the scalar type of the tensor.
+  executorch::aten::ScalarType scalar_type() const {
+    return scalar_type_;
+  }
+
+  /// Returns the size of the tensor's data in bytes.
+  size_t nbytes() const {
+    return nbytes_;
+  }
+
+ private:
+  TensorLayout(
+      Span<const int32_t> sizes,
+      Span<const uint8_t> dim_order,
+      executorch::aten::ScalarType scalar_type,
+      size_t nbytes)
+      : sizes_(sizes),
+        dim_order_(dim_order),
+        scalar_type_(scalar_type),
+        nbytes_(nbytes) {}
+
+  Span<const int32_t> sizes_;
+  Span<const uint8_t> dim_order_;
+  executorch::aten::ScalarType scalar_type_;
+  size_t nbytes_;
+};
+
+} // namespace runtime
+} // namespace executorch
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/core/device_allocator.h>
+
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::runtime::DeviceAllocator;
+using executorch::runtime::Error;
+using executorch::runtime::get_device_allocator;
+using executorch::runtime::register_device_allocator;
+
+class MallocDeviceAllocator : public DeviceAllocator {
+ public:
+  void* allocate(size_t size, size_t alignment) override {
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, size) != 0) {
+      return nullptr;
+    }
+    return ptr;
+  }
+
+  void free(void* ptr) override {
+    std::free(ptr);
+  }
+};
+
+TEST(DeviceAllocatorTest, RegisterAndGet) {
+  static MallocDeviceAllocator allocator;
+  EXPECT_EQ(get_device_allocator("RegisterAndGet"), nullptr);
+
+  EXPECT_EQ(register_device_allocator("RegisterAndGet", &allocator), Error::Ok);
+  EXPECT_EQ(get_device_allocator("RegisterAndGet"), &allocator);
+
+  // A name can only be registered once.
+  static MallocDeviceAllocator other_allocator;
+  EXPECT_EQ(
+      register_device_allocator("RegisterAndGet", &other_allocator),
+      Error::InvalidArgument);
+  EXPECT_EQ(get_device_allocator("RegisterAndGet"), &allocator);
+}
+
+TEST(DeviceAllocatorTest, RegisterNullFails) {
+  static MallocDeviceAllocator allocator;
+  EXPECT_EQ(
+      register_device_allocator("RegisterNullFails", nullptr),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      register_device_allocator(nullptr, &allocator), Error::InvalidArgument);
+  EXPECT_EQ(get_device_allocator("RegisterNullFails"), nullptr);
+}
+
+TEST(DeviceAllocatorTest, AllocateAndFree) {
+  MallocDeviceAllocator allocator;
+  void* ptr = allocator.allocate(64, 32);
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % 32, 0);
+  allocator.free(ptr);
+
+  // Allocators without file descriptors do not need to implement get_fd().
+  EXPECT_EQ(allocator.get_fd(ptr).error(), Error::NotSupported);
+}
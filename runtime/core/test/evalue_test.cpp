@@ -207,6 +207,27 @@ TEST_F(EValueTest, BoxedEvalueList) {
   EXPECT_EQ(unwrapped[2], 3);
 }
 
+TEST_F(EValueTest, BoxedEvalueListOfTensors) {
+  TensorFactory<ScalarType::Float> tf;
+  EValue values[2] = {EValue(tf.ones({2})), EValue(tf.zeros({3}))};
+  EValue* values_p[2] = {&values[0], &values[1]};
+  // Must be initialized because BoxedEvalueList will use operator=() on each
+  // entry.
+  exec_aten::Tensor storage[2] = {tf.ones({1}), tf.ones({1})};
+  BoxedEvalueList<exec_aten::Tensor> x{values_p, storage, 2};
+  auto unwrapped = x.get();
+  EXPECT_EQ(unwrapped.size(), 2);
+  EXPECT_EQ(unwrapped.data(), storage);
+  EXPECT_EQ(unwrapped[0].numel(), 2);
+  EXPECT_EQ(unwrapped[1].numel(), 3);
+  // Later calls see the same tensors, whether or not they unwrap them again.
+  auto again = x.get();
+  EXPECT_EQ(again.data(), storage);
+  EXPECT_EQ(
+      again[1].unsafeGetTensorImpl(),
+      values[1].toTensor().unsafeGetTensorImpl());
+}
+
 TEST_F(EValueTest, toOptionalTensorList) {
   // create list, empty evalue ctor gets tag::None
   EValue values[2] = {EValue(), EValue()};
@@ -15,6 +15,8 @@
 #define ET_EVENT_TRACER_ENABLED
 #include <executorch/runtime/core/event_tracer_hooks.h>
 #include <executorch/runtime/core/event_tracer_hooks_delegate.h>
+#include <executorch/runtime/core/event_tracer_profiler.h>
+#include <executorch/runtime/platform/profiler.h>
 
 using exec_aten::Tensor;
 using executorch::runtime::AllocatorID;
@@ -325,3 +327,25 @@ TEST(TestEventTracer, EventTracerProfileOpControl) {
     }
   }
 }
+
+TEST(TestEventTracer, ProfilingEventTracer) {
+  using executorch::runtime::begin_profiling;
+  using executorch::runtime::end_profiling;
+  using executorch::runtime::get_profiling_event_tracer;
+  using executorch::runtime::kDroppedProfilingToken;
+  using executorch::runtime::set_profiling_event_tracer;
+
+  DummyEventTracer dummy;
+  set_profiling_event_tracer(&dummy);
+  EXPECT_EQ(get_profiling_event_tracer(), &dummy);
+
+  // The events of the profiler go to the EventTracer.
+  uint32_t token = begin_profiling("ExampleProfilerEvent");
+  EXPECT_NE(token, kDroppedProfilingToken);
+  EXPECT_EQ(strcmp(dummy.get_event_name(), "ExampleProfilerEvent"), 0);
+  end_profiling(token);
+  EXPECT_EQ(strcmp(dummy.get_event_name(), ""), 0);
+
+  set_profiling_event_tracer(nullptr);
+  EXPECT_EQ(get_profiling_event_tracer(), nullptr);
+}
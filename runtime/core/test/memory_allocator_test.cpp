@@ -51,6 +51,21 @@ TEST_F(MemoryAllocatorTest, MemoryAllocator) {
   ASSERT_NE(nullptr, allocator.allocate(16));
 }
 
+TEST_F(MemoryAllocatorTest, UsedSize) {
+  constexpr size_t mem_size = 64;
+  alignas(MemoryAllocator::kDefaultAlignment) uint8_t mem_pool[mem_size];
+  MemoryAllocator allocator(mem_size, mem_pool);
+  EXPECT_EQ(allocator.used_size(), 0);
+
+  // The second allocation is padded to the default alignment.
+  ASSERT_NE(nullptr, allocator.allocate(7, 1));
+  ASSERT_NE(nullptr, allocator.allocate(8));
+  EXPECT_EQ(allocator.used_size(), MemoryAllocator::kDefaultAlignment + 8);
+
+  allocator.reset();
+  EXPECT_EQ(allocator.used_size(), 0);
+}
+
 TEST_F(MemoryAllocatorTest, MemoryAllocatorAlignment) {
   constexpr size_t arr_size = 6;
   size_t allocation[arr_size] = {7, 6, 3, 76, 4, 1};
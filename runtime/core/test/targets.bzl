@@ -45,6 +45,16 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "device_allocator_test",
+        srcs = [
+            "device_allocator_test.cpp",
+        ],
+        deps = [
+            "//executorch/runtime/core:device_allocator",
+        ],
+    )
+
     runtime.cxx_test(
         name = "array_ref_test",
         srcs = ["array_ref_test.cpp"],
@@ -73,6 +83,14 @@ def define_common_targets():
         ],
     )
 
+    runtime.cxx_test(
+        name = "tensor_layout_test",
+        srcs = ["tensor_layout_test.cpp"],
+        deps = [
+            "//executorch/runtime/core:tensor_layout",
+        ],
+    )
+
     runtime.cxx_test(
         name = "tensor_shape_dynamism_test_aten",
         srcs = ["tensor_shape_dynamism_test_aten.cpp"],
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <executorch/runtime/core/tensor_layout.h>
+#include <executorch/runtime/platform/runtime.h>
+
+#include <gtest/gtest.h>
+
+using namespace ::testing;
+using executorch::aten::ScalarType;
+using executorch::runtime::Error;
+using executorch::runtime::Result;
+using executorch::runtime::Span;
+using executorch::runtime::TensorLayout;
+
+class TensorLayoutTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    executorch::runtime::runtime_init();
+  }
+};
+
+TEST_F(TensorLayoutTest, Create) {
+  int32_t sizes[] = {1, 2, 3};
+  uint8_t dim_order[] = {0, 2, 1};
+  Result<TensorLayout> layout =
+      TensorLayout::create(sizes, dim_order, ScalarType::Float);
+  ASSERT_EQ(layout.error(), Error::Ok);
+
+  EXPECT_EQ(layout->scalar_type(), ScalarType::Float);
+  EXPECT_EQ(layout->nbytes(), 1 * 2 * 3 * sizeof(float));
+  ASSERT_EQ(layout->sizes().size(), 3);
+  ASSERT_EQ(layout->dim_order().size(), 3);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(layout->sizes()[i], sizes[i]);
+    EXPECT_EQ(layout->dim_order()[i], dim_order[i]);
+  }
+}
+
+TEST_F(TensorLayoutTest, CreateScalar) {
+  Result<TensorLayout> layout =
+      TensorLayout::create({}, {}, ScalarType::Double);
+  ASSERT_EQ(layout.error(), Error::Ok);
+  EXPECT_EQ(layout->nbytes(), sizeof(double));
+}
+
+TEST_F(TensorLayoutTest, CreateWithInvalidDimOrderFails) {
+  int32_t sizes[] = {2, 3};
+
+  // Too few entries.
+  uint8_t short_dim_order[] = {0};
+  EXPECT_EQ(
+      TensorLayout::create(sizes, short_dim_order, ScalarType::Float).error(),
+      Error::InvalidArgument);
+
+  // Repeated dimension.
+  uint8_t repeated_dim_order[] = {1, 1};
+  EXPECT_EQ(
+      TensorLayout::create(sizes, repeated_dim_order, ScalarType::Float)
+          .error(),
+      Error::InvalidArgument);
+
+  // Out of range dimension.
+  uint8_t out_of_range_dim_order[] = {0, 2};
+  EXPECT_EQ(
+      TensorLayout::create(sizes, out_of_range_dim_order, ScalarType::Float)
+          .error(),
+      Error::InvalidArgument);
+}
+
+TEST_F(TensorLayoutTest, CreateWithNegativeSizeFails) {
+  int32_t sizes[] = {2, -3};
+  uint8_t dim_order[] = {0, 1};
+  EXPECT_EQ(
+      TensorLayout::create(sizes, dim_order, ScalarType::Float).error(),
+      Error::InvalidArgument);
+}
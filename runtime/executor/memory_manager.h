@@ -10,6 +10,7 @@
 
 #include <executorch/runtime/core/hierarchical_allocator.h>
 #include <executorch/runtime/core/memory_allocator.h>
+#include <executorch/runtime/core/span.h>
 
 namespace executorch {
 namespace runtime {
@@ -48,14 +49,21 @@ class MemoryManager final {
    *     uses it. May be `nullptr` if the Method does not use kernels or
    *     delegates that allocate temporary data. This allocator will be reset
    *     after every kernel or delegate call during execution.
+   * @param[in] constant_scratch The memory to load the data of constant
+   *     tensors into right before the instructions that use them, if the
+   *     Program was loaded with Program::ConstantLoading::Streamed; ignored
+   *     otherwise. Typically fast on-chip SRAM. Must outlive the Method that
+   *     uses it.
    */
   explicit MemoryManager(
       MemoryAllocator* method_allocator,
       HierarchicalAllocator* planned_memory = nullptr,
-      MemoryAllocator* temp_allocator = nullptr)
+      MemoryAllocator* temp_allocator = nullptr,
+      Span<uint8_t> constant_scratch = {})
       : method_allocator_(method_allocator),
         planned_memory_(planned_memory),
-        temp_allocator_(temp_allocator) {
+        temp_allocator_(temp_allocator),
+        constant_scratch_(constant_scratch) {
     ET_CHECK_MSG(
         method_allocator != temp_allocator,
         "method allocator cannot be the same as temp allocator");
@@ -105,10 +113,19 @@ class MemoryManager final {
     return temp_allocator_;
   }
 
+  /**
+   * Returns the memory to stream the data of constant tensors through. Empty
+   * if none was provided.
+   */
+  Span<uint8_t> constant_scratch() const {
+    return constant_scratch_;
+  }
+
  private:
   MemoryAllocator* method_allocator_;
   HierarchicalAllocator* planned_memory_;
   MemoryAllocator* temp_allocator_;
+  Span<uint8_t> constant_scratch_;
 };
 
 } // namespace runtime
@@ -11,6 +11,7 @@
 #include <cinttypes> // @donotremove
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include <executorch/runtime/backend/interface.h>
 #include <executorch/runtime/core/event_tracer_hooks.h>
@@ -32,6 +33,28 @@ namespace runtime {
 
 using internal::PlatformMemoryAllocator;
 
+/**
+ * Which of the lowerings of a delegate with alternatives runs, and how fast
+ * each of them ran.
+ */
+struct DelegateSelection {
+  /// Indices into Method::delegates_ of the lowerings that loaded, in order of
+  /// preference.
+  size_t* members;
+  /// Moving average of the execution time of each member in ticks, 0 until
+  /// measured, or kFailed after it failed.
+  et_timestamp_t* latency_ticks;
+  size_t n_members;
+  /// The position in members of the lowering that runs.
+  size_t active;
+  /// The position in members of the lowering that was tried last.
+  size_t last_trial;
+  /// Executions since the last trial.
+  size_t executions;
+
+  static constexpr et_timestamp_t kFailed = ~et_timestamp_t(0);
+};
+
 /**
  * Runtime state for a backend delegate.
  */
@@ -48,7 +71,8 @@ class BackendDelegate final {
    * @param[in] program The serialized program to load from.
    * @param[in] backend_init_context The context pointer to pass to the
    *     backend's init() method.
-   * @param[out] out The BackendDelegate to initialize.
+   * @param[out] out The BackendDelegate to initialize. It can be destroyed
+   *     even if the initialization fails, and is not loaded() then.
    *
    * @returns Error::Ok if the initialization succeeded, or an error otherwise.
    */
@@ -57,10 +81,17 @@ class BackendDelegate final {
       const Program* program,
       BackendInitContext& backend_init_context,
       BackendDelegate* out) {
+    new (&out->segment_) FreeableBuffer();
+    out->backend_ = nullptr;
+    out->handle_ = nullptr;
+    out->backend_id_ = nullptr;
+    out->selection_ = nullptr;
+
     // Look up the backend.
     ET_CHECK_OR_RETURN_ERROR(
         delegate.id() != nullptr, InvalidProgram, "Missing backend id");
     const char* backend_id = delegate.id()->c_str();
+    out->backend_id_ = backend_id;
     BackendInterface* backend = get_backend_class(backend_id);
     ET_CHECK_OR_RETURN_ERROR(
         backend != nullptr,
@@ -90,10 +121,9 @@ class BackendDelegate final {
     }
     size_t num_compile_specs = delegate.compile_specs()->size();
 
-    out->backend_ = backend;
-    out->handle_ = nullptr;
     // Pass a pointer to this buffer to the backend. It's safe for the backend
     // to point its handle to this object, since it will outlive the backend.
+    out->segment_.~FreeableBuffer();
     new (&out->segment_) FreeableBuffer(std::move(processed_data.get()));
 
     // Initialize the delegate.
@@ -110,6 +140,7 @@ class BackendDelegate final {
       out->segment_.Free();
       return handle.error();
     }
+    out->backend_ = backend;
     out->handle_ = handle.get();
     return Error::Ok;
   }
@@ -122,11 +153,151 @@ class BackendDelegate final {
 
   Error Execute(
       BackendExecutionContext& backend_execution_context,
-      EValue** args) const {
+      EValue** args,
+      const DelegateLoop* loop = nullptr) const {
     EXECUTORCH_SCOPE_PROF("delegate_execute");
+    if (loop != nullptr) {
+      return backend_->execute_loop(
+          backend_execution_context, handle_, args, *loop);
+    }
     return backend_->execute(backend_execution_context, handle_, args);
   }
 
+  Error ExecuteAsync(
+      BackendExecutionContext& backend_execution_context,
+      EValue** args,
+      DelegateCompletionCallback callback,
+      void* callback_context) const {
+    return backend_->execute_async(
+        backend_execution_context, handle_, args, callback, callback_context);
+  }
+
+  /**
+   * Returns the delegate that runs in place of this one: the selected one of
+   * its alternatives if it has any, or this one.
+   *
+   * @param[in] delegates The delegates of the Method, which the alternatives
+   *     are among.
+   */
+  const BackendDelegate& Selected(const BackendDelegate* delegates) const {
+    if (selection_ == nullptr) {
+      return *this;
+    }
+    return delegates[selection_->members[selection_->active]];
+  }
+
+  /**
+   * Executes the selected delegate like Execute(), measuring how long it takes
+   * if this delegate has alternatives. Every `trial_interval` executions, if
+   * that is not 0, runs the next alternative in turn instead, and selects the
+   * fastest of the ones measured so far. If the selected delegate fails, runs
+   * the others in order of preference, and selects the first that succeeds.
+   *
+   * Not thread-safe: executions of the same delegate must not overlap.
+   */
+  Error ExecuteSelected(
+      const BackendDelegate* delegates,
+      size_t trial_interval,
+      BackendExecutionContext& backend_execution_context,
+      EValue** args,
+      const DelegateLoop* loop) const {
+    if (selection_ == nullptr || selection_->n_members == 1) {
+      return Selected(delegates).Execute(backend_execution_context, args, loop);
+    }
+    DelegateSelection& selection = *selection_;
+    size_t position = selection.active;
+    if (trial_interval != 0 && ++selection.executions >= trial_interval) {
+      selection.executions = 0;
+      position = (selection.last_trial + 1) % selection.n_members;
+      if (position == selection.active) {
+        position = (position + 1) % selection.n_members;
+      }
+      selection.last_trial = position;
+    }
+
+    et_timestamp_t start = et_pal_current_ticks();
+    Error err = delegates[selection.members[position]].Execute(
+        backend_execution_context, args, loop);
+    if (err == Error::Ok) {
+      et_timestamp_t ticks = et_pal_current_ticks() - start;
+      et_timestamp_t& latency = selection.latency_ticks[position];
+      // Weigh the last execution by 1/4, to follow changes like thermal
+      // throttling without jumping on a single slow run.
+      if (latency == 0 || latency == DelegateSelection::kFailed) {
+        latency = ticks;
+      } else {
+        latency = latency - latency / 4 + ticks / 4;
+      }
+      if (latency == 0) {
+        // 0 means unmeasured.
+        latency = 1;
+      }
+      for (size_t i = 0; i < selection.n_members; ++i) {
+        const et_timestamp_t other = selection.latency_ticks[i];
+        if (other != 0 && other < selection.latency_ticks[selection.active]) {
+          selection.active = i;
+        }
+      }
+      return err;
+    }
+
+    selection.latency_ticks[position] = DelegateSelection::kFailed;
+    // A failed loop may have overwritten its carried inputs.
+    if (loop != nullptr) {
+      return err;
+    }
+    for (size_t i = 0; i < selection.n_members; ++i) {
+      if (i == position ||
+          selection.latency_ticks[i] == DelegateSelection::kFailed) {
+        continue;
+      }
+      const BackendDelegate& fallback = delegates[selection.members[i]];
+      ET_LOG(
+          Info,
+          "Falling back from %s to %s after error 0x%" PRIx32,
+          delegates[selection.members[position]].backend_id_,
+          fallback.backend_id_,
+          static_cast<uint32_t>(err));
+      err = fallback.Execute(backend_execution_context, args, loop);
+      if (err == Error::Ok) {
+        selection.active = i;
+        return err;
+      }
+      selection.latency_ticks[i] = DelegateSelection::kFailed;
+    }
+    return err;
+  }
+
+  Error SetOptions(Span<const BackendOption> options) const {
+    return backend_->set_option(handle_, options);
+  }
+
+  Error GetOptions(Span<BackendOption> options) const {
+    return backend_->get_option(handle_, options);
+  }
+
+  const BackendInterface* backend() const {
+    return backend_;
+  }
+
+  /// Whether Init() succeeded. Alternatives may fail to load.
+  bool loaded() const {
+    return backend_ != nullptr;
+  }
+
+  /// Whether more than one lowering of this delegate loaded.
+  bool HasAlternatives() const {
+    return selection_ != nullptr && selection_->n_members > 1;
+  }
+
+  /**
+   * Makes this delegate run one of the lowerings of `selection` in its place.
+   * See ExecuteSelected().
+   */
+  void SetSelection(DelegateSelection* selection) {
+    selection_ = selection;
+  }
+
  private:
   // Not constructible.
   BackendDelegate() = delete;
@@ -205,6 +376,107 @@ class BackendDelegate final {
   FreeableBuffer segment_;
   const BackendInterface* backend_;
   DelegateHandle* handle_;
+  const char* backend_id_;
+  /// Set if this delegate has alternatives.
+  DelegateSelection* selection_;
+};
+
+/**
+ * Pre-decoded form of a serialized instruction. Built once during
+ * Method::init() so that execution can dispatch without walking the
+ * flatbuffer tables, and so that all indices can be validated up front.
+ */
+/**
+ * The constant tensors of an instruction whose data is only in memory while
+ * the instruction runs; see Program::ConstantLoading::Streamed.
+ */
+struct StreamedConstants {
+  /// The tensors to point at their data before the instruction runs.
+  EValue** values;
+  size_t n_values;
+  /// The reads of their data into each half of the constant scratch.
+  DataLoader::LoadIntoRequest* loads[2];
+  /// The constants of the instruction that usually runs next, to load while
+  /// this one runs.
+  const StreamedConstants* next;
+};
+
+/**
+ * Which constants each half of the constant scratch holds.
+ */
+struct ConstantStream {
+  /// The constants loaded, or being loaded, into each half, or null.
+  const StreamedConstants* resident[2];
+  /// Whether the loads into each half were started but not waited for.
+  bool in_flight[2];
+};
+
+struct DecodedInstruction {
+  enum class Type : uint8_t {
+    KernelCall,
+    DelegateCall,
+    JumpFalseCall,
+    MoveCall,
+    FreeCall,
+  };
+
+  struct KernelCall {
+    union {
+      /// The resolved kernel to call, if bound_args is null.
+      OpFunction function;
+      /// The resolved kernel to call with bound_args, if it is set.
+      decltype(BoundOpFunction::function) bound_function;
+    };
+    /// The arguments of the call, unpacked by the kernel's OpBindFunction, or
+    /// null if the kernel unpacks the EValues of args on every call.
+    const void* bound_args;
+    /// Index into the plan's operators table; only used for error reporting.
+    int32_t op_index;
+
+    void call(KernelRuntimeContext& context, EValue** args) const {
+      if (bound_args != nullptr) {
+        bound_function(context, bound_args);
+      } else {
+        function(context, args);
+      }
+    }
+  };
+
+  struct JumpFalseCall {
+    /// The condition to check before falling through to the next instruction.
+    EValue* cond_value;
+    /// The instruction index to jump to if the condition is false.
+    size_t destination_instruction;
+  };
+
+  struct MoveCall {
+    EValue* move_from;
+    EValue* move_to;
+  };
+
+  struct DelegateCall {
+    /// Index into Method::delegates_.
+    size_t delegate_index;
+    /// How to run the delegate as a loop, or nullptr to run it once.
+    const DelegateLoop* loop;
+  };
+
+  Type type;
+
+  /// List of parameters for a kernel or delegate call. Empty for other types.
+  InstructionArgs args;
+
+  /// The constants to load before a kernel or delegate call, or null.
+  const StreamedConstants* streamed_constants;
+
+  union {
+    KernelCall kernel_call;
+    DelegateCall delegate_call;
+    JumpFalseCall jump_false_call;
+    MoveCall move_call;
+    /// The tensor to release the data of.
+    EValue* free_value;
+  };
 };
 
 /**
@@ -214,10 +486,14 @@ struct Chain {
   /// Pointer to the associated flatbuffer chain.
   const executorch_flatbuffer::Chain* s_chain_;
 
-  /// Each entry is a list of parameters for a kernel or delegate call.
-  Span<InstructionArgs> argument_lists_;
-  /// Each instruction will have one kernel (not for delegate).
-  OpFunction* kernels_;
+  /// The pre-decoded instructions of the chain, in execution order.
+  Span<DecodedInstruction> instructions_;
+
+  /// Instruction indices grouped into waves of independent instructions, and
+  /// the end offset of each wave in schedule_. Both are empty unless a
+  /// parallel schedule was built and the chain can use one.
+  Span<uint32_t> schedule_;
+  Span<uint32_t> wave_ends_;
 };
 
 namespace {
@@ -284,9 +560,350 @@ Result<bool> parse_cond_value(const EValue& cond_value) {
   return true;
 }
 
+/**
+ * A value, and the memory-planned storage backing it, that an instruction may
+ * read or write. Used to find instructions that can run concurrently.
+ */
+struct InstructionAccess {
+  size_t value_index;
+  /// The serialized (one-based) memory id of the planned storage, or zero if
+  /// the value has no memory-planned storage.
+  uint32_t memory_id;
+  /// Byte range of the planned storage within its memory id.
+  size_t begin;
+  size_t end;
+};
+
+bool accesses_conflict(const InstructionAccess& a, const InstructionAccess& b) {
+  if (a.value_index == b.value_index) {
+    return true;
+  }
+  // The memory plan reuses storage between values with disjoint lifetimes, so
+  // distinct values may still alias.
+  return a.memory_id != 0 && a.memory_id == b.memory_id && a.begin < b.end &&
+      b.begin < a.end;
+}
+
+/**
+ * Records the access to the value at `value_index`, using the serialized
+ * tensor metadata rather than runtime state so that the result doesn't depend
+ * on dynamic shapes or freed data. Writes to `out` unless it is null. Returns
+ * the number of accesses recorded.
+ */
+size_t record_value_access(
+    const flatbuffers::Vector<flatbuffers::Offset<executorch_flatbuffer::EValue>>*
+        s_values,
+    int64_t value_index,
+    InstructionAccess* out) {
+  if (value_index < 0 || value_index >= s_values->size()) {
+    // Not a real value, for example the -1 used for None in optional lists.
+    return 0;
+  }
+  if (out != nullptr) {
+    *out = InstructionAccess{static_cast<size_t>(value_index), 0, 0, 0};
+    const auto s_value = s_values->Get(value_index);
+    if (s_value->val_type() == executorch_flatbuffer::KernelTypes::Tensor) {
+      const auto s_tensor = s_value->val_as_Tensor();
+      const auto allocation_info = s_tensor->allocation_info();
+      if (allocation_info != nullptr) {
+        size_t nbytes = elementSize(
+            static_cast<exec_aten::ScalarType>(s_tensor->scalar_type()));
+        if (s_tensor->sizes() != nullptr) {
+          for (int32_t size : *s_tensor->sizes()) {
+            nbytes *= static_cast<size_t>(size);
+          }
+        }
+        const size_t offset = allocation_info->memory_offset_low() |
+            (static_cast<uint64_t>(allocation_info->memory_offset_high())
+             << 32);
+        out->memory_id = allocation_info->memory_id();
+        out->begin = offset;
+        out->end = offset + nbytes;
+      }
+    }
+  }
+  return 1;
+}
+
+/**
+ * Records the accesses to the values referenced by the items of a serialized
+ * list. Writes to `out` unless it is null. Returns the number of accesses
+ * recorded.
+ */
+template <typename T>
+size_t record_list_accesses(
+    const flatbuffers::Vector<flatbuffers::Offset<executorch_flatbuffer::EValue>>*
+        s_values,
+    const flatbuffers::Vector<T>* items,
+    InstructionAccess* out) {
+  size_t count = 0;
+  if (items != nullptr) {
+    for (T item : *items) {
+      count += record_value_access(
+          s_values, item, out == nullptr ? nullptr : out + count);
+    }
+  }
+  return count;
+}
+
+/**
+ * Records all accesses made by a serialized kernel or delegate call, expanding
+ * the lists that reference other values into their items, since ops like
+ * sym_size write the Ints of an IntList. Writes to `out` unless it is null.
+ * Returns the number of accesses recorded.
+ */
+size_t record_instruction_accesses(
+    const flatbuffers::Vector<flatbuffers::Offset<executorch_flatbuffer::EValue>>*
+        s_values,
+    const executorch_flatbuffer::Instruction* instruction,
+    InstructionAccess* out) {
+  const flatbuffers::Vector<int32_t>* arg_idxs =
+      instruction->instr_args_type() ==
+          executorch_flatbuffer::InstructionArguments::KernelCall
+      ? instruction->instr_args_as_KernelCall()->args()
+      : instruction->instr_args_as_DelegateCall()->args();
+  size_t count = 0;
+  for (int32_t arg_idx : *arg_idxs) {
+    count += record_value_access(
+        s_values, arg_idx, out == nullptr ? nullptr : out + count);
+    const auto s_value = s_values->Get(arg_idx);
+    InstructionAccess* list_out = out == nullptr ? nullptr : out + count;
+    switch (s_value->val_type()) {
+      case executorch_flatbuffer::KernelTypes::IntList:
+        count += record_list_accesses(
+            s_values, s_value->val_as_IntList()->items(), list_out);
+        break;
+      case executorch_flatbuffer::KernelTypes::TensorList:
+        count += record_list_accesses(
+            s_values, s_value->val_as_TensorList()->items(), list_out);
+        break;
+      case executorch_flatbuffer::KernelTypes::OptionalTensorList:
+        count += record_list_accesses(
+            s_values, s_value->val_as_OptionalTensorList()->items(), list_out);
+        break;
+      default:
+        // Other lists hold their items inline.
+        break;
+    }
+  }
+  return count;
+}
+
+/**
+ * Returns the serialized tensor of `s_value` if it is memory-planned and has
+ * initial data, which is how mutable buffers are serialized. Returns nullptr
+ * otherwise.
+ */
+const executorch_flatbuffer::Tensor* get_state_tensor(
+    const executorch_flatbuffer::EValue* s_value) {
+  if (s_value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+    return nullptr;
+  }
+  const auto s_tensor = s_value->val_as_Tensor();
+  if (s_tensor->data_buffer_idx() == 0 ||
+      s_tensor->allocation_info() == nullptr) {
+    return nullptr;
+  }
+  return s_tensor;
+}
+
+/**
+ * Returns true if delegate `index` has alternatives, or is one, so that the
+ * Method can load without it.
+ */
+bool has_alternative_lowerings(
+    const flatbuffers::Vector<
+        flatbuffers::Offset<executorch_flatbuffer::BackendDelegate>>* delegates,
+    size_t index) {
+  for (size_t i = 0; i < delegates->size(); ++i) {
+    const auto* alternatives = delegates->Get(i)->alternatives();
+    if (alternatives == nullptr || alternatives->size() == 0) {
+      continue;
+    }
+    if (i == index) {
+      return true;
+    }
+    for (int32_t alternative : *alternatives) {
+      if (alternative >= 0 && static_cast<size_t>(alternative) == index) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+/// The alignment of the data of each streamed constant in the constant
+/// scratch, which matches the default alignment of the constant segment.
+constexpr size_t kStreamedConstantAlignment = 16;
+
+size_t align_streamed_constant(size_t offset) {
+  return (offset + kStreamedConstantAlignment - 1) &
+      ~(kStreamedConstantAlignment - 1);
+}
+
+/**
+ * Marks the values of `plan` whose data is streamed through the constant
+ * scratch: constant tensors that are arguments of kernel or delegate calls,
+ * directly or in tensor lists, but that are not outputs of the plan or
+ * operands of other instructions, which may read them at any time. Indices
+ * that are out of range are skipped here and rejected when the instructions
+ * are decoded.
+ */
+Result<bool*> find_streamed_constants(
+    const executorch_flatbuffer::ExecutionPlan* plan,
+    MemoryAllocator* allocator) {
+  const auto s_values = plan->values();
+  const auto chains = plan->chains();
+  ET_CHECK_OR_RETURN_ERROR(
+      s_values != nullptr && chains != nullptr,
+      InvalidProgram,
+      "Missing values or chains");
+  const size_t n_value = s_values->size();
+  bool* streamed = allocator->allocateList<bool>(n_value);
+  if (streamed == nullptr && n_value > 0) {
+    return Error::MemoryAllocationFailed;
+  }
+  for (size_t i = 0; i < n_value; ++i) {
+    streamed[i] = false;
+  }
+
+  // Marks or unmarks a value if it is a constant tensor.
+  auto set_tensor = [&](int32_t index, bool value) {
+    if (index < 0 || static_cast<size_t>(index) >= n_value) {
+      return;
+    }
+    const auto s_value = s_values->Get(index);
+    if (s_value != nullptr && s_value->val() != nullptr &&
+        s_value->val_type() == executorch_flatbuffer::KernelTypes::Tensor &&
+        deserialization::isConstantTensor(s_value->val_as_Tensor())) {
+      streamed[index] = value;
+    }
+  };
+  // Likewise for the items of a tensor list.
+  auto set = [&](int32_t index, bool value) {
+    set_tensor(index, value);
+    if (index < 0 || static_cast<size_t>(index) >= n_value) {
+      return;
+    }
+    const auto s_value = s_values->Get(index);
+    if (s_value == nullptr || s_value->val() == nullptr) {
+      return;
+    }
+    const flatbuffers::Vector<int32_t>* items = nullptr;
+    if (s_value->val_type() == executorch_flatbuffer::KernelTypes::TensorList) {
+      items = s_value->val_as_TensorList()->items();
+    } else if (
+        s_value->val_type() ==
+        executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+      items = s_value->val_as_OptionalTensorList()->items();
+    }
+    if (items != nullptr) {
+      for (int32_t item : *items) {
+        set_tensor(item, value);
+      }
+    }
+  };
+
+  // Mark the arguments of all calls first, then unmark the values that are
+  // used in other ways.
+  for (int pass = 0; pass < 2; ++pass) {
+    const bool mark = pass == 0;
+    for (size_t i = 0; i < chains->size(); ++i) {
+      const auto s_chain = chains->Get(i);
+      if (s_chain == nullptr || s_chain->instructions() == nullptr) {
+        continue;
+      }
+      for (const auto instruction : *s_chain->instructions()) {
+        if (instruction == nullptr || instruction->instr_args() == nullptr) {
+          continue;
+        }
+        switch (instruction->instr_args_type()) {
+          case executorch_flatbuffer::InstructionArguments::KernelCall:
+          case executorch_flatbuffer::InstructionArguments::DelegateCall: {
+            if (!mark) {
+              break;
+            }
+            const flatbuffers::Vector<int32_t>* arg_idxs =
+                instruction->instr_args_type() ==
+                    executorch_flatbuffer::InstructionArguments::KernelCall
+                ? instruction->instr_args_as_KernelCall()->args()
+                : instruction->instr_args_as_DelegateCall()->args();
+            if (arg_idxs != nullptr) {
+              for (int32_t arg_idx : *arg_idxs) {
+                set(arg_idx, true);
+              }
+            }
+          } break;
+          case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
+            if (!mark) {
+              set(instruction->instr_args_as_JumpFalseCall()
+                      ->cond_value_index(),
+                  false);
+            }
+          } break;
+          case executorch_flatbuffer::InstructionArguments::MoveCall: {
+            if (!mark) {
+              const auto move_call = instruction->instr_args_as_MoveCall();
+              set(move_call->move_from(), false);
+              set(move_call->move_to(), false);
+            }
+          } break;
+          default:
+            break;
+        }
+      }
+    }
+  }
+  if (plan->outputs() != nullptr) {
+    for (int32_t output : *plan->outputs()) {
+      set(output, false);
+    }
+  }
+  return streamed;
+}
+
+/**
+ * Calls fn(index) for the index of each streamed constant among `args`,
+ * including the items of tensor lists, possibly more than once.
+ */
+template <typename Fn>
+void for_each_streamed_constant(
+    const flatbuffers::Vector<flatbuffers::Offset<executorch_flatbuffer::EValue>>*
+        s_values,
+    const bool* streamed_constants,
+    const EValue* values,
+    InstructionArgs args,
+    Fn fn) {
+  for (size_t i = 0; i < args.size(); ++i) {
+    const size_t index = static_cast<size_t>(args[i] - values);
+    if (streamed_constants[index]) {
+      fn(index);
+      continue;
+    }
+    const auto s_value = s_values->Get(index);
+    const flatbuffers::Vector<int32_t>* items = nullptr;
+    if (s_value->val_type() == executorch_flatbuffer::KernelTypes::TensorList) {
+      items = s_value->val_as_TensorList()->items();
+    } else if (
+        s_value->val_type() ==
+        executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+      items = s_value->val_as_OptionalTensorList()->items();
+    }
+    if (items == nullptr) {
+      continue;
+    }
+    for (int32_t item : *items) {
+      // Parsing the list checked that its items are in range; -1 is None.
+      if (item >= 0 && streamed_constants[item]) {
+        fn(static_cast<size_t>(item));
+      }
+    }
+  }
+}
+
 } // namespace
 
-Error Method::parse_values() {
+Error Method::parse_values(const bool* streamed_constants) {
   auto flatbuffer_values = serialization_plan_->values();
   ET_CHECK_OR_RETURN_ERROR(
       flatbuffer_values != nullptr, InvalidProgram, "Missing values");
@@ -301,6 +918,92 @@ Error Method::parse_values() {
   // safe for errors to return without updating any state.
   n_value_ = 0;
 
+  // When the Program loads constants lazily, this Method owns the data of the
+  // constant tensors it uses, and likewise for external constants, except
+  // for the constants it streams, which have no data until they are used.
+  // The initial data of mutable tensors is read in one batch after all values
+  // are parsed, so that the loader can overlap the reads.
+  const bool lazy_constants = program_->has_lazy_constants();
+  size_t n_constant_data = 0;
+  size_t n_mutable_load = 0;
+  size_t n_tensor = 0;
+  for (size_t i = 0; i < n_value; ++i) {
+    auto serialization_value = flatbuffer_values->Get(i);
+    if (serialization_value != nullptr &&
+        serialization_value->val_type() ==
+            executorch_flatbuffer::KernelTypes::Tensor &&
+        serialization_value->val() != nullptr) {
+      n_tensor++;
+      const auto s_tensor = serialization_value->val_as_Tensor();
+      const bool streamed =
+          streamed_constants != nullptr && streamed_constants[i];
+      if ((lazy_constants && !streamed &&
+           deserialization::isConstantTensor(s_tensor)) ||
+          deserialization::isExternalConstantTensor(s_tensor)) {
+        n_constant_data++;
+      } else if (deserialization::hasMutableInitialData(s_tensor)) {
+        n_mutable_load++;
+      }
+    }
+  }
+
+  size_t next_constant_data = 0;
+  if (n_constant_data > 0) {
+    constant_data_ =
+        memory_manager_->method_allocator()->allocateList<FreeableBuffer>(
+            n_constant_data);
+    if (constant_data_ == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+    for (size_t i = 0; i < n_constant_data; ++i) {
+      new (&constant_data_[i]) FreeableBuffer();
+    }
+    n_constant_data_ = n_constant_data;
+  }
+
+  // A single load gains nothing from batching, so only allocate requests for
+  // more than one.
+  DataLoader::LoadIntoRequest* mutable_loads = nullptr;
+  size_t next_mutable_load = 0;
+  if (n_mutable_load > 1) {
+    mutable_loads = memory_manager_->method_allocator()
+                        ->allocateList<DataLoader::LoadIntoRequest>(
+                            n_mutable_load);
+    if (mutable_loads == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
+  }
+
+  // Construct all TensorImpls in one array, so that the metadata of tensors
+  // used together is close together.
+  auto tensor_impls = deserialization::allocateTensorImpls(
+      memory_manager_->method_allocator(), n_tensor);
+  if (!tensor_impls.ok()) {
+    return tensor_impls.error();
+  }
+  size_t next_tensor_impl = 0;
+
+  // Likewise for their sizes and strides, sharing the strides of tensors with
+  // the same shape. The arena finds those in temp memory, which init()
+  // releases after parsing.
+  deserialization::TensorMetadataArena metadata_arena(
+      temp_allocator_, n_tensor);
+  if (n_tensor > 0) {
+    for (size_t i = 0; i < n_value; ++i) {
+      auto serialization_value = flatbuffer_values->Get(i);
+      if (serialization_value != nullptr &&
+          serialization_value->val_type() ==
+              executorch_flatbuffer::KernelTypes::Tensor &&
+          serialization_value->val() != nullptr) {
+        metadata_arena.reserve(serialization_value->val_as_Tensor());
+      }
+    }
+    Error err = metadata_arena.allocate(memory_manager_->method_allocator());
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
   for (size_t i = 0; i < n_value; ++i) {
     auto serialization_value = flatbuffer_values->Get(i);
     // Ensure that the `val_as_X()` calls will return non-null pointers.
@@ -382,8 +1085,34 @@ Error Method::parse_values() {
         new (&values_[i]) EValue(fb_str->c_str(), fb_str->size());
       } break;
       case executorch_flatbuffer::KernelTypes::Tensor: {
+        const auto s_tensor = serialization_value->val_as_Tensor();
+        const bool streamed =
+            streamed_constants != nullptr && streamed_constants[i];
+        FreeableBuffer* constant_data = nullptr;
+        if (n_constant_data_ > 0 &&
+            ((lazy_constants && !streamed &&
+              deserialization::isConstantTensor(s_tensor)) ||
+             deserialization::isExternalConstantTensor(s_tensor))) {
+          constant_data = &constant_data_[next_constant_data++];
+        }
+        DataLoader::LoadIntoRequest* mutable_load = nullptr;
+        if (mutable_loads != nullptr &&
+            deserialization::hasMutableInitialData(s_tensor)) {
+          mutable_load = &mutable_loads[next_mutable_load++];
+        }
+        exec_aten::TensorImpl* tensor_impl = nullptr;
+        if (tensor_impls.get() != nullptr) {
+          tensor_impl = &tensor_impls.get()[next_tensor_impl++];
+        }
         auto t = deserialization::parseTensor(
-            program_, memory_manager_, serialization_value->val_as_Tensor());
+            program_,
+            memory_manager_,
+            s_tensor,
+            constant_data,
+            mutable_load,
+            tensor_impl,
+            named_data_map_,
+            &metadata_arena);
         if (!t.ok()) {
           ET_LOG(
               Error,
@@ -447,6 +1176,19 @@ Error Method::parse_values() {
     // to clean up an uninitialized entry.
     n_value_ = i + 1;
   }
+
+  if (mutable_loads != nullptr) {
+    Error err = program_->load_subsegments_into(
+        Span<const DataLoader::LoadIntoRequest>(
+            mutable_loads, next_mutable_load));
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Failed to load mutable tensor data: 0x%" PRIx32,
+          static_cast<uint32_t>(err));
+      return err;
+    }
+  }
   return Error::Ok;
 }
 
@@ -487,12 +1229,34 @@ Error populate_operator_name(
 
   return Error::Ok;
 }
+
+/**
+ * Detaches the EventTracer of a Method for the rest of an execution that is
+ * not traced, and attaches it again when the execution ends.
+ */
+class UntracedExecutionScope final {
+ public:
+  UntracedExecutionScope(EventTracer** event_tracer, bool traced)
+      : event_tracer_(event_tracer), saved_event_tracer_(*event_tracer) {
+    if (!traced) {
+      *event_tracer_ = nullptr;
+    }
+  }
+
+  ~UntracedExecutionScope() {
+    *event_tracer_ = saved_event_tracer_;
+  }
+
+ private:
+  EventTracer** event_tracer_;
+  EventTracer* saved_event_tracer_;
+};
 } // namespace
 
 Error Method::resolve_operator(
     int32_t op_index,
-    OpFunction* kernels,
-    size_t kernel_index,
+    OpFunction* kernel,
+    OpBindFunction* bind,
     InstructionArgs args,
     size_t n_args) {
   // TODO(T153505381, T153506819) Investigate optimizing this function for both
@@ -509,6 +1273,21 @@ Error Method::resolve_operator(
       op_index);
   const auto& op = ops->Get(op_index);
 
+  // Use the kernel resolved ahead of time if the program was prepared for the
+  // exact set of kernels registered in this process.
+  const auto resolution = serialization_plan_->kernel_resolution();
+  if (resolution != nullptr && resolution->kernel_indices() != nullptr &&
+      op_index < resolution->kernel_indices()->size() &&
+      resolution->registry_fingerprint() == get_registry_fingerprint()) {
+    const int32_t kernel_index = resolution->kernel_indices()->Get(op_index);
+    const Span<const Kernel> kernels = get_registered_kernels();
+    if (kernel_index >= 0 && kernel_index < kernels.size()) {
+      *kernel = kernels[kernel_index].op_;
+      *bind = kernels[kernel_index].bind_;
+      return Error::Ok;
+    }
+  }
+
   Error err = populate_operator_name(op, kTempBufferSizeForName, operator_name);
   if (err != Error::Ok) {
     return err;
@@ -548,13 +1327,14 @@ Error Method::resolve_operator(
   }
 
   // Find a kernel with the matching name and tensor meta.
-  Result<OpFunction> op_function =
-      get_op_function_from_registry(operator_name, {meta, count});
-  if (!op_function.ok()) {
+  Result<const Kernel*> registered_kernel =
+      get_kernel_from_registry(operator_name, {meta, count});
+  if (!registered_kernel.ok()) {
     ET_LOG(Error, "Missing operator: [%d] %s", op_index, operator_name);
-    return op_function.error();
+    return registered_kernel.error();
   }
-  kernels[kernel_index] = op_function.get();
+  *kernel = registered_kernel.get()->op_;
+  *bind = registered_kernel.get()->bind_;
   return Error::Ok;
 }
 
@@ -562,7 +1342,9 @@ Result<Method> Method::load(
     executorch_flatbuffer::ExecutionPlan* s_plan,
     const Program* program,
     MemoryManager* memory_manager,
-    EventTracer* event_tracer) {
+    EventTracer* event_tracer,
+    const NamedDataMap* named_data_map,
+    ParallelRunner* init_runner) {
   MemoryAllocator* temp_allocator = memory_manager->temp_allocator();
   if (temp_allocator == nullptr) {
     PlatformMemoryAllocator* platform_allocator =
@@ -574,9 +1356,10 @@ Result<Method> Method::load(
     new (platform_allocator) PlatformMemoryAllocator();
     temp_allocator = platform_allocator;
   }
-  Method method(program, memory_manager, event_tracer, temp_allocator);
+  Method method(
+      program, memory_manager, event_tracer, temp_allocator, named_data_map);
 
-  Error err = method.init(s_plan);
+  Error err = method.init(s_plan, init_runner);
   if (err != Error::Ok) {
     return err;
   } else {
@@ -585,7 +1368,65 @@ Result<Method> Method::load(
   }
 }
 
-Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
+Error Method::init_delegates_concurrently(
+    ParallelRunner* runner,
+    const NamedDataMap* delegate_data_map) {
+  const auto delegates = serialization_plan_->delegates();
+  const size_t n_delegate = delegates->size();
+  auto method_allocator = memory_manager_->method_allocator();
+  delegate_allocators_ =
+      method_allocator->allocateList<PlatformMemoryAllocator>(n_delegate);
+  Error* errors = method_allocator->allocateList<Error>(n_delegate);
+  if (delegate_allocators_ == nullptr || errors == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  for (size_t i = 0; i < n_delegate; ++i) {
+    new (&delegate_allocators_[i]) PlatformMemoryAllocator();
+  }
+  n_delegate_allocators_ = n_delegate;
+
+  struct InitContext {
+    Method* method;
+    const NamedDataMap* delegate_data_map;
+    Error* errors;
+  };
+  InitContext context{this, delegate_data_map, errors};
+  runner->run(
+      [](void* ctx, size_t delegate_index) {
+        auto* init_context = static_cast<InitContext*>(ctx);
+        Method* method = init_context->method;
+        BackendInitContext backend_init_context(
+            &method->delegate_allocators_[delegate_index],
+            /*method_name=*/method->serialization_plan_->name()->c_str(),
+            init_context->delegate_data_map);
+        init_context->errors[delegate_index] = BackendDelegate::Init(
+            *method->serialization_plan_->delegates()->Get(delegate_index),
+            method->program_,
+            backend_init_context,
+            &method->delegates_[delegate_index]);
+      },
+      &context,
+      n_delegate);
+  // Init() leaves every entry valid even if it fails, so ~Method() cleans them
+  // all up.
+  n_delegate_ = n_delegate;
+
+  // Fail like the sequential initialization would, at the first delegate that
+  // failed and has no alternatives.
+  for (size_t i = 0; i < n_delegate; ++i) {
+    if (errors[i] != Error::Ok) {
+      if (!has_alternative_lowerings(delegates, i)) {
+        return errors[i];
+      }
+      ET_LOG(Info, "Delegate %zu did not load; trying its alternatives", i);
+    }
+  }
+  return Error::Ok;
+}
+
+Error Method::init(
+    executorch_flatbuffer::ExecutionPlan* s_plan,
+    ParallelRunner* init_runner) {
   EXECUTORCH_SCOPE_PROF("Method::init");
   internal::EventTracerProfileMethodScope event_tracer_profile_scope =
       internal::EventTracerProfileMethodScope(event_tracer_, "Method::init");
@@ -600,9 +1441,24 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
   serialization_plan_ = s_plan;
   auto method_allocator = memory_manager_->method_allocator();
 
+  // Find the constants to stream before parsing, so that their data is never
+  // loaded at init.
+  const bool* streamed_constants = nullptr;
+  if (program_->has_streamed_constants()) {
+    auto streamed = find_streamed_constants(s_plan, method_allocator);
+    if (!streamed.ok()) {
+      return streamed.error();
+    }
+    streamed_constants = streamed.get();
+  }
+
   {
     // Parse the elements of the values_ array.
-    Error err = parse_values();
+    Error err = parse_values(streamed_constants);
+    // Release the scratch space of parse_values().
+    if (temp_allocator_ != nullptr) {
+      temp_allocator_->reset();
+    }
     if (err != Error::Ok) {
       return err;
     }
@@ -624,33 +1480,98 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
     // makes it safe for errors to return without updating any state.
     n_delegate_ = 0;
 
-    for (size_t i = 0; i < n_delegate; ++i) {
-      const auto& delegate = *delegates->Get(i);
-      BackendInitContext backend_init_context(
-          method_allocator,
-          /*method_name=*/serialization_plan_->name()->c_str());
-      Error err = BackendDelegate::Init(
-          delegate, program_, backend_init_context, &delegates_[i]);
+    // Delegates look up shared data in the program's named data, or else in
+    // the data that the caller passed for external tensors.
+    const NamedDataMap* delegate_data_map = program_->get_named_data_map();
+    if (delegate_data_map == nullptr) {
+      delegate_data_map = named_data_map_;
+    }
+    if (init_runner != nullptr && n_delegate > 0) {
+      Error err = init_delegates_concurrently(init_runner, delegate_data_map);
       if (err != Error::Ok) {
         return err;
       }
-      // ~Method() will try to clean up n_delegate_ entries in the delegates_
-      // array. Only increment this once we know the entry is valid, so that
-      // we don't try to clean up an uninitialized entry.
-      n_delegate_ = i + 1;
+    } else {
+      for (size_t i = 0; i < n_delegate; ++i) {
+        const auto& delegate = *delegates->Get(i);
+        BackendInitContext backend_init_context(
+            method_allocator,
+            /*method_name=*/serialization_plan_->name()->c_str(),
+            delegate_data_map);
+        Error err = BackendDelegate::Init(
+            delegate, program_, backend_init_context, &delegates_[i]);
+        // ~Method() will try to clean up n_delegate_ entries in the delegates_
+        // array. Init() leaves the entry valid even if it fails.
+        n_delegate_ = i + 1;
+        if (err != Error::Ok) {
+          if (!has_alternative_lowerings(delegates, i)) {
+            return err;
+          }
+          ET_LOG(
+              Info, "Delegate %zu did not load; trying its alternatives", i);
+        }
+      }
     }
-  }
 
-  {
-    // Load chains
-    const auto chains = serialization_plan_->chains();
-    ET_CHECK_OR_RETURN_ERROR(
-        chains != nullptr && chains->size() > 0, InvalidProgram, "No chains");
-    n_chains_ = chains->size();
-    chains_ = method_allocator->allocateList<Chain>(n_chains_);
-    if (chains_ == nullptr) {
-      return Error::MemoryAllocationFailed;
-    }
+    // Delegates with alternatives run the first of them that loaded, until
+    // they measure which is fastest.
+    for (size_t i = 0; i < n_delegate; ++i) {
+      const auto* alternatives = delegates->Get(i)->alternatives();
+      if (alternatives == nullptr || alternatives->size() == 0) {
+        continue;
+      }
+      const size_t n_lowerings = alternatives->size() + 1;
+      auto* selection = method_allocator->allocateInstance<DelegateSelection>();
+      size_t* members = method_allocator->allocateList<size_t>(n_lowerings);
+      et_timestamp_t* latency_ticks =
+          method_allocator->allocateList<et_timestamp_t>(n_lowerings);
+      if (selection == nullptr || members == nullptr ||
+          latency_ticks == nullptr) {
+        return Error::MemoryAllocationFailed;
+      }
+      size_t n_members = 0;
+      for (size_t j = 0; j < n_lowerings; ++j) {
+        const int32_t index = j == 0 ? static_cast<int32_t>(i)
+                                     : alternatives->Get(j - 1);
+        ET_CHECK_OR_RETURN_ERROR(
+            index >= 0 && static_cast<size_t>(index) < n_delegate &&
+                (j == 0 || static_cast<size_t>(index) != i),
+            InvalidProgram,
+            "Invalid alternative %" PRId32 " of delegate %zu",
+            index,
+            i);
+        if (delegates_[index].loaded()) {
+          members[n_members] = index;
+          latency_ticks[n_members] = 0;
+          n_members++;
+        }
+      }
+      ET_CHECK_OR_RETURN_ERROR(
+          n_members > 0,
+          NotFound,
+          "None of the %zu lowerings of delegate %zu loaded",
+          n_lowerings,
+          i);
+      selection->members = members;
+      selection->latency_ticks = latency_ticks;
+      selection->n_members = n_members;
+      selection->active = 0;
+      selection->last_trial = 0;
+      selection->executions = 0;
+      delegates_[i].SetSelection(selection);
+    }
+  }
+
+  {
+    // Load chains
+    const auto chains = serialization_plan_->chains();
+    ET_CHECK_OR_RETURN_ERROR(
+        chains != nullptr && chains->size() > 0, InvalidProgram, "No chains");
+    n_chains_ = chains->size();
+    chains_ = method_allocator->allocateList<Chain>(n_chains_);
+    if (chains_ == nullptr) {
+      return Error::MemoryAllocationFailed;
+    }
 
     // Try resolving all operators before failing, to make it easier to debug
     // multiple problems at once.
@@ -665,21 +1586,15 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
           "Missing instructions in chain %zu",
           i);
       auto num_instructions = s_instructions->size();
-      auto chain_instruction_kernels =
-          method_allocator->allocateList<OpFunction>(num_instructions);
-      if (chain_instruction_kernels == nullptr) {
-        return Error::MemoryAllocationFailed;
-      }
-      auto chain_instruction_arg_lists =
-          method_allocator->allocateList<InstructionArgs>(num_instructions);
-      if (chain_instruction_arg_lists == nullptr) {
+      auto chain_instructions =
+          method_allocator->allocateList<DecodedInstruction>(num_instructions);
+      if (chain_instructions == nullptr) {
         return Error::MemoryAllocationFailed;
       }
 
-      // Set up the argument lists ahead of time and store pointers to them to
-      // use when the instructions are called
-      for (size_t instr_idx = 0; instr_idx < s_instructions->size();
-           ++instr_idx) {
+      // Decode the instructions ahead of time so that execution never needs
+      // to look at the serialized representation.
+      for (size_t instr_idx = 0; instr_idx < num_instructions; ++instr_idx) {
         const auto instruction = s_instructions->Get(instr_idx);
         // Ensure that the `instr_args_as_X()` calls will return non-null.
         ET_CHECK_OR_RETURN_ERROR(
@@ -688,10 +1603,13 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
             "Null instruction at index %zu",
             instr_idx);
 
+        DecodedInstruction& decoded = chain_instructions[instr_idx];
+        decoded.args = InstructionArgs();
+        decoded.streamed_constants = nullptr;
         switch (instruction->instr_args_type()) {
           case executorch_flatbuffer::InstructionArguments::KernelCall: {
-            const auto arg_idxs =
-                instruction->instr_args_as_KernelCall()->args();
+            const auto kernel_call = instruction->instr_args_as_KernelCall();
+            const auto arg_idxs = kernel_call->args();
             ET_CHECK_OR_RETURN_ERROR(
                 arg_idxs != nullptr, InvalidProgram, "KernelCall args missing");
             auto res = gen_instruction_arguments(
@@ -703,13 +1621,30 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
             if (!res.ok()) {
               return res.error();
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+            decoded.type = DecodedInstruction::Type::KernelCall;
+            decoded.args = res.get();
+            decoded.kernel_call.function = nullptr;
+            decoded.kernel_call.bound_args = nullptr;
+            decoded.kernel_call.op_index = kernel_call->op_index();
+            OpBindFunction bind = nullptr;
             auto err = resolve_operator(
-                instruction->instr_args_as_KernelCall()->op_index(),
-                chain_instruction_kernels,
-                instr_idx,
+                kernel_call->op_index(),
+                &decoded.kernel_call.function,
+                &bind,
                 res.get(),
                 arg_idxs->size());
+            if (err == Error::Ok && bind != nullptr) {
+              // Unpack the arguments once, instead of on every call.
+              Result<BoundOpFunction> bound =
+                  bind(method_allocator, res.get().data(), arg_idxs->size());
+              if (bound.ok() && bound->bound_args != nullptr) {
+                decoded.kernel_call.bound_function = bound->function;
+                decoded.kernel_call.bound_args = bound->bound_args;
+              } else if (
+                  bound.error() == Error::MemoryAllocationFailed) {
+                return bound.error();
+              }
+            }
             if (err == Error::OperatorMissing) {
               num_instructions_missing_op++;
             } else if (err == Error::MemoryAllocationFailed) {
@@ -719,12 +1654,29 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
             }
           } break;
           case executorch_flatbuffer::InstructionArguments::DelegateCall: {
-            const auto arg_idxs =
-                instruction->instr_args_as_DelegateCall()->args();
+            const auto delegate_call =
+                instruction->instr_args_as_DelegateCall();
+            const auto arg_idxs = delegate_call->args();
             ET_CHECK_OR_RETURN_ERROR(
                 arg_idxs != nullptr,
                 InvalidProgram,
                 "DelegateCall args missing");
+            auto delegate_idx = delegate_call->delegate_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                delegate_idx >= 0 && delegate_idx < n_delegate_,
+                InvalidProgram,
+                "DELEGATE_CALL index %" PRId32
+                " negative or >= num delegates %zu at instruction %zu",
+                delegate_idx,
+                n_delegate_,
+                instr_idx);
+            ET_CHECK_OR_RETURN_ERROR(
+                delegates_[delegate_idx].Selected(delegates_).loaded(),
+                InvalidProgram,
+                "DELEGATE_CALL to alternative %" PRId32
+                " that did not load at instruction %zu",
+                delegate_idx,
+                instr_idx);
             auto res = gen_instruction_arguments(
                 method_allocator,
                 n_value_,
@@ -734,30 +1686,101 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
             if (!res.ok()) {
               return res.error();
             }
-            chain_instruction_arg_lists[instr_idx] = res.get();
+            decoded.type = DecodedInstruction::Type::DelegateCall;
+            decoded.args = res.get();
+            decoded.delegate_call.delegate_index =
+                static_cast<size_t>(delegate_idx);
+            decoded.delegate_call.loop = nullptr;
+            if (const auto* s_loop = delegate_call->loop()) {
+              // Negative counts wrap around and fail the checks too.
+              const size_t num_args = arg_idxs->size();
+              const size_t num_inputs = s_loop->num_inputs();
+              const size_t num_carried = s_loop->num_carried();
+              ET_CHECK_OR_RETURN_ERROR(
+                  num_inputs <= num_args && num_carried <= num_inputs &&
+                      num_carried <= num_args - num_inputs &&
+                      s_loop->max_iterations() > 0 &&
+                      s_loop->predicate_output() >= -1 &&
+                      s_loop->predicate_output() <
+                          static_cast<int64_t>(num_args - num_inputs),
+                  InvalidProgram,
+                  "Invalid DelegateLoop at instruction %zu",
+                  instr_idx);
+              auto* loop = method_allocator->allocateInstance<DelegateLoop>();
+              if (loop == nullptr) {
+                return Error::MemoryAllocationFailed;
+              }
+              loop->num_inputs = num_inputs;
+              loop->num_carried = num_carried;
+              loop->max_iterations = s_loop->max_iterations();
+              loop->predicate_output = s_loop->predicate_output();
+              decoded.delegate_call.loop = loop;
+            }
           } break;
           case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
-            // Validate the index at load time so we can trust it during
+            // Validate the indices at load time so we can trust them during
             // execution.
-            auto index =
-                instruction->instr_args_as_JumpFalseCall()->cond_value_index();
+            const auto jf_call = instruction->instr_args_as_JumpFalseCall();
+            auto index = jf_call->cond_value_index();
             ET_CHECK_OR_RETURN_ERROR(
                 index >= 0 && index < n_value_,
                 InvalidProgram,
                 "Index %d negative or >= %zu",
                 index,
                 n_value_);
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+            auto destination = jf_call->destination_instruction();
+            ET_CHECK_OR_RETURN_ERROR(
+                destination >= 0 &&
+                    static_cast<size_t>(destination) <= num_instructions,
+                InvalidProgram,
+                "Jump destination %d negative or > %zu",
+                destination,
+                (size_t)num_instructions);
+            decoded.type = DecodedInstruction::Type::JumpFalseCall;
+            decoded.jump_false_call.cond_value = &values_[index];
+            decoded.jump_false_call.destination_instruction =
+                static_cast<size_t>(destination);
           } break;
-          default: {
-            chain_instruction_arg_lists[instr_idx] = InstructionArgs();
+          case executorch_flatbuffer::InstructionArguments::MoveCall: {
+            const auto move_call = instruction->instr_args_as_MoveCall();
+            auto move_from = move_call->move_from();
+            auto move_to = move_call->move_to();
+            ET_CHECK_OR_RETURN_ERROR(
+                move_from >= 0 && move_from < n_value_ && move_to >= 0 &&
+                    move_to < n_value_,
+                InvalidProgram,
+                "MoveCall indices %d, %d negative or >= %zu",
+                move_from,
+                move_to,
+                n_value_);
+            decoded.type = DecodedInstruction::Type::MoveCall;
+            decoded.move_call.move_from = &values_[move_from];
+            decoded.move_call.move_to = &values_[move_to];
           } break;
+          case executorch_flatbuffer::InstructionArguments::FreeCall: {
+            auto index = instruction->instr_args_as_FreeCall()->value_index();
+            ET_CHECK_OR_RETURN_ERROR(
+                index >= 0 && index < n_value_ && values_[index].isTensor(),
+                InvalidProgram,
+                "FreeCall index %d negative, >= %zu, or not a tensor",
+                index,
+                n_value_);
+            decoded.type = DecodedInstruction::Type::FreeCall;
+            decoded.free_value = &values_[index];
+          } break;
+          default: {
+            ET_LOG(
+                Error,
+                "Unknown instruction %hhu at index %zu",
+                static_cast<uint8_t>(instruction->instr_args_type()),
+                instr_idx);
+            return Error::InvalidProgram;
+          }
         }
       }
       chains_[i] = Chain{
           s_chain,
-          Span<InstructionArgs>(chain_instruction_arg_lists, num_instructions),
-          chain_instruction_kernels,
+          Span<DecodedInstruction>(chain_instructions, num_instructions),
       };
     }
     ET_CHECK_OR_RETURN_ERROR(
@@ -771,6 +1794,13 @@ Error Method::init(executorch_flatbuffer::ExecutionPlan* s_plan) {
     }
   }
 
+  if (streamed_constants != nullptr) {
+    Error err = init_constant_stream(streamed_constants);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
   step_state_ = StepState{0, 0};
 
   init_state_ = InitializationState::Initialized;
@@ -986,6 +2016,269 @@ Method::set_output_data_ptr(void* buffer, size_t size, size_t output_idx) {
   return internal::set_tensor_data(t, buffer, size);
 }
 
+ET_NODISCARD Error
+Method::set_output_data_ptrs(Span<const Span<uint8_t>> buffers) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Outputs can not be retrieved until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      buffers.size() == outputs_size(),
+      InvalidArgument,
+      "Got %zu buffers for %zu outputs",
+      buffers.size(),
+      outputs_size());
+
+  // Check every buffer before setting any, so that a failure leaves all
+  // outputs as they were.
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    if (buffers[i].data() == nullptr) {
+      continue;
+    }
+    const auto& output = get_value(get_output_index(i));
+    ET_CHECK_OR_RETURN_ERROR(
+        output.isTensor(),
+        InvalidArgument,
+        "output %zu type: %zu is not tensor",
+        i,
+        (size_t)output.tag);
+    auto tensor_meta = this->method_meta().output_tensor_meta(i);
+    if (tensor_meta->is_memory_planned()) {
+      ET_LOG(
+          Error,
+          "Output %zu is memory planned, or is a constant. Cannot override "
+          "the existing data pointer.",
+          i);
+      return Error::InvalidState;
+    }
+    ET_CHECK_OR_RETURN_ERROR(
+        output.toTensor().nbytes() <= buffers[i].size(),
+        InvalidArgument,
+        "output %zu buffer size: %zu is smaller then expected tensor size: %zu",
+        i,
+        buffers[i].size(),
+        output.toTensor().nbytes());
+  }
+
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    if (buffers[i].data() == nullptr) {
+      continue;
+    }
+    ET_CHECK_OK_OR_RETURN_ERROR(internal::set_tensor_data(
+        mutable_value(get_output_index(i)).toTensor(),
+        buffers[i].data(),
+        buffers[i].size()));
+  }
+  return Error::Ok;
+}
+
+Error Method::init_constant_stream(const bool* streamed_constants) {
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto s_values = serialization_plan_->values();
+
+  // Split the scratch into two aligned halves, so that the constants of one
+  // instruction can load while those of another are in use.
+  const Span<uint8_t> scratch = memory_manager_->constant_scratch();
+  const uintptr_t scratch_begin = reinterpret_cast<uintptr_t>(scratch.data());
+  const uintptr_t aligned_begin = align_streamed_constant(scratch_begin);
+  const size_t aligned_size = scratch_begin + scratch.size() > aligned_begin
+      ? scratch_begin + scratch.size() - aligned_begin
+      : 0;
+  const size_t half_size =
+      (aligned_size / 2) & ~(kStreamedConstantAlignment - 1);
+  uint8_t* const halves[2] = {
+      reinterpret_cast<uint8_t*>(aligned_begin),
+      reinterpret_cast<uint8_t*>(aligned_begin + half_size)};
+
+  StreamedConstants* first = nullptr;
+  StreamedConstants* last = nullptr;
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    auto& instructions = chains_[chain_idx].instructions_;
+    for (size_t instr_idx = 0; instr_idx < instructions.size(); ++instr_idx) {
+      DecodedInstruction& decoded = instructions[instr_idx];
+      if (decoded.type != DecodedInstruction::Type::KernelCall &&
+          decoded.type != DecodedInstruction::Type::DelegateCall) {
+        continue;
+      }
+      size_t max_n_values = 0;
+      for_each_streamed_constant(
+          s_values, streamed_constants, values_, decoded.args, [&](size_t) {
+            max_n_values++;
+          });
+      if (max_n_values == 0) {
+        continue;
+      }
+
+      auto* constants =
+          method_allocator->allocateInstance<StreamedConstants>();
+      EValue** values = method_allocator->allocateList<EValue*>(max_n_values);
+      if (constants == nullptr || values == nullptr) {
+        return Error::MemoryAllocationFailed;
+      }
+      // The same constant may be passed more than once, but is loaded once.
+      // Empty constants have nothing to load.
+      size_t n_values = 0;
+      for_each_streamed_constant(
+          s_values,
+          streamed_constants,
+          values_,
+          decoded.args,
+          [&](size_t index) {
+            if (values_[index].toTensor().nbytes() == 0) {
+              return;
+            }
+            for (size_t i = 0; i < n_values; ++i) {
+              if (values[i] == &values_[index]) {
+                return;
+              }
+            }
+            values[n_values++] = &values_[index];
+          });
+      if (n_values == 0) {
+        continue;
+      }
+      for (auto& loads : constants->loads) {
+        loads = method_allocator->allocateList<DataLoader::LoadIntoRequest>(
+            n_values);
+        if (loads == nullptr) {
+          return Error::MemoryAllocationFailed;
+        }
+      }
+
+      // Lay the constants out the same way in both halves.
+      size_t nbytes = 0;
+      for (size_t i = 0; i < n_values; ++i) {
+        const size_t index = static_cast<size_t>(values[i] - values_);
+        const size_t buffer_index =
+            s_values->Get(index)->val_as_Tensor()->data_buffer_idx();
+        const size_t tensor_nbytes = values[i]->toTensor().nbytes();
+        for (size_t half = 0; half < 2; ++half) {
+          Error err = program_->get_constant_data_request(
+              buffer_index,
+              tensor_nbytes,
+              halves[half] + nbytes,
+              &constants->loads[half][i]);
+          if (err != Error::Ok) {
+            return err;
+          }
+        }
+        nbytes = align_streamed_constant(nbytes + tensor_nbytes);
+      }
+      ET_CHECK_OR_RETURN_ERROR(
+          nbytes <= half_size,
+          MemoryAllocationFailed,
+          "Constants of instruction %zu:%zu need %zu bytes, more than half of "
+          "the %zu-byte constant scratch",
+          chain_idx,
+          instr_idx,
+          nbytes,
+          scratch.size());
+
+      constants->values = values;
+      constants->n_values = n_values;
+      constants->next = nullptr;
+      decoded.streamed_constants = constants;
+      // Chains run in order, and the first instruction runs again after the
+      // last one.
+      if (last != nullptr) {
+        last->next = constants;
+      } else {
+        first = constants;
+      }
+      last = constants;
+    }
+  }
+  if (first == nullptr) {
+    return Error::Ok;
+  }
+  last->next = first;
+
+  constant_stream_ = method_allocator->allocateInstance<ConstantStream>();
+  if (constant_stream_ == nullptr) {
+    return Error::MemoryAllocationFailed;
+  }
+  for (size_t half = 0; half < 2; ++half) {
+    constant_stream_->resident[half] = nullptr;
+    constant_stream_->in_flight[half] = false;
+  }
+  return Error::Ok;
+}
+
+Error Method::start_streamed_loads(
+    size_t half,
+    const StreamedConstants& constants) {
+  ConstantStream& stream = *constant_stream_;
+  if (stream.in_flight[half]) {
+    // The loads were for another instruction, and are discarded anyway.
+    (void)wait_for_streamed_loads(half);
+  }
+  stream.resident[half] = &constants;
+  Error err = program_->start_loads_into(
+      {constants.loads[half], constants.n_values});
+  if (err != Error::Ok) {
+    stream.resident[half] = nullptr;
+    return err;
+  }
+  stream.in_flight[half] = true;
+  return Error::Ok;
+}
+
+Error Method::wait_for_streamed_loads(size_t half) {
+  ConstantStream& stream = *constant_stream_;
+  const StreamedConstants& constants = *stream.resident[half];
+  stream.in_flight[half] = false;
+  Error err = program_->wait_for_loads_into(
+      {constants.loads[half], constants.n_values});
+  if (err != Error::Ok) {
+    stream.resident[half] = nullptr;
+  }
+  return err;
+}
+
+Error Method::bind_streamed_constants(const StreamedConstants& constants) {
+  ConstantStream& stream = *constant_stream_;
+  // The constants are usually already loading into one of the halves.
+  size_t half = stream.resident[1] == &constants ? 1 : 0;
+  if (stream.resident[half] != &constants) {
+    // Prefer the half that isn't busy with loads for another instruction.
+    half = stream.in_flight[0] ? 1 : 0;
+    Error err = start_streamed_loads(half, constants);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  if (stream.in_flight[half]) {
+    Error err = wait_for_streamed_loads(half);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+
+  // Load the constants of the next instruction while this one runs. If that
+  // fails, the next instruction tries again before it runs.
+  const StreamedConstants* next = constants.next;
+  if (next != &constants && stream.resident[1 - half] != next) {
+    (void)start_streamed_loads(1 - half, *next);
+  }
+
+  for (size_t i = 0; i < constants.n_values; ++i) {
+    const DataLoader::LoadIntoRequest& load = constants.loads[half][i];
+    Error err = internal::set_tensor_data(
+        constants.values[i]->toTensor(), load.buffer, load.size);
+    if (err != Error::Ok) {
+      return err;
+    }
+  }
+  return Error::Ok;
+}
+
+void Method::unbind_streamed_constants(const StreamedConstants& constants) {
+  // The data may be overwritten as soon as the next instruction starts.
+  for (size_t i = 0; i < constants.n_values; ++i) {
+    internal::reset_data_ptr(constants.values[i]->toTensor());
+  }
+}
+
 ET_NODISCARD Error Method::get_outputs(EValue* output_evalues, size_t length) {
   ET_CHECK_OR_RETURN_ERROR(
       initialized(),
@@ -1030,38 +2323,52 @@ ET_NODISCARD Error Method::get_inputs(EValue* input_evalues, size_t length) {
   return Error::Ok;
 }
 
-Error Method::execute_instruction() {
+Error Method::execute_instruction(size_t next_instr_idx) {
   auto& chain = chains_[step_state_.chain_idx];
-  auto instructions = chain.s_chain_->instructions();
 
   ET_CHECK_OR_RETURN_ERROR(
-      step_state_.instr_idx < instructions->size(),
+      step_state_.instr_idx < chain.instructions_.size(),
       Internal,
       "Instr index %zu >= chain[%zu] instr count %zu",
       step_state_.instr_idx,
       step_state_.chain_idx,
-      (size_t)instructions->size());
+      chain.instructions_.size());
 
-  auto instruction = instructions->Get(step_state_.instr_idx);
+  const DecodedInstruction& instruction =
+      chain.instructions_[step_state_.instr_idx];
   size_t next_instr_idx = step_state_.instr_idx + 1;
   Error err = Error::Ok;
 
-  switch (instruction->instr_args_type()) {
-    case executorch_flatbuffer::InstructionArguments::KernelCall: {
+  if (instruction.streamed_constants != nullptr) {
+    err = bind_streamed_constants(*instruction.streamed_constants);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Loading constants failed at instruction %zu:%zu: 0x%" PRIx32,
+          step_state_.chain_idx,
+          step_state_.instr_idx,
+          static_cast<uint32_t>(err));
+      return err;
+    }
+  }
+
+  switch (instruction.type) {
+    case DecodedInstruction::Type::KernelCall: {
       EXECUTORCH_SCOPE_PROF("OPERATOR_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "OPERATOR_CALL");
       // TODO(T147221312): Also expose tensor resizer via the context.
-      KernelRuntimeContext context(event_tracer_, temp_allocator_);
-      auto args = chain.argument_lists_[step_state_.instr_idx];
-      chain.kernels_[step_state_.instr_idx](context, args.data());
+      KernelRuntimeContext context(
+          event_tracer_, temp_allocator_, kernel_cache_);
+      auto args = instruction.args;
+      instruction.kernel_call.call(context, args.data());
       // We reset the temp_allocator after the switch statement
       err = context.failure_state();
       if (err != Error::Ok) {
-        // We know that instr_args_as_KernelCall is non-null because it was
-        // checked at init time.
-        auto op_index = instruction->instr_args_as_KernelCall()->op_index();
-        auto op = serialization_plan_->operators()->Get(op_index);
+        // We know that op_index is valid because it was checked when resolving
+        // the operator at init time.
+        auto op = serialization_plan_->operators()->Get(
+            instruction.kernel_call.op_index);
         ET_LOG(
             Error,
             "KernelCall failed at instruction %zu:%zu in operator %s.%s: 0x%x",
@@ -1082,29 +2389,41 @@ Error Method::execute_instruction() {
         // little slow. Do the same for DelegateCall errors.
       }
     } break;
-    case executorch_flatbuffer::InstructionArguments::DelegateCall: {
+    case DecodedInstruction::Type::DelegateCall: {
       EXECUTORCH_SCOPE_PROF("DELEGATE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "DELEGATE_CALL");
-      // We know that instr_args_as_DelegateCall is non-null because it was
-      // checked at init time.
-      auto delegate_idx =
-          instruction->instr_args_as_DelegateCall()->delegate_index();
-      ET_CHECK_OR_RETURN_ERROR(
-          delegate_idx < n_delegate_,
-          Internal,
-          "DELEGATE_CALL index %" PRIu32
-          " >= num delegates %zu at instruction %zu",
-          delegate_idx,
-          n_delegate_,
-          step_state_.instr_idx);
+      // We know that delegate_index is in range because it was checked at init
+      // time.
+      const BackendDelegate& delegate =
+          delegates_[instruction.delegate_call.delegate_index];
+      // Let the backend defer waiting for its device to the next call when
+      // that call is its own, unless the delegate calls are being profiled.
+      // Delegates with alternatives may switch backends on any call.
+      bool followed_by_same_backend = false;
+      if (event_tracer_ == nullptr && !delegate.HasAlternatives() &&
+          next_instr_idx < chain.instructions_.size()) {
+        const DecodedInstruction& next_instruction =
+            chain.instructions_[next_instr_idx];
+        if (next_instruction.type == DecodedInstruction::Type::DelegateCall) {
+          const BackendDelegate& next_delegate =
+              delegates_[next_instruction.delegate_call.delegate_index];
+          followed_by_same_backend = !next_delegate.HasAlternatives() &&
+              next_delegate.Selected(delegates_).backend() ==
+                  delegate.Selected(delegates_).backend();
+        }
+      }
       BackendExecutionContext backend_execution_context(
           /*event_tracer=*/event_tracer_,
           /*temp_allocator=*/temp_allocator_,
-          /*method_name=*/serialization_plan_->name()->c_str());
-      err = delegates_[delegate_idx].Execute(
+          /*method_name=*/serialization_plan_->name()->c_str(),
+          /*followed_by_same_backend=*/followed_by_same_backend);
+      err = delegate.ExecuteSelected(
+          delegates_,
+          delegate_trial_interval_,
           backend_execution_context,
-          chain.argument_lists_[step_state_.instr_idx].data());
+          instruction.args.data(),
+          instruction.delegate_call.loop);
       if (err != Error::Ok) {
         ET_LOG(
             Error,
@@ -1119,61 +2438,62 @@ Error Method::execute_instruction() {
       // log everything. This will be changed in the future when the inputs and
       // ouputs are separate lists.
 #ifdef ET_EVENT_TRACER_ENABLED
-      for (size_t i = 0;
-           i < chain.argument_lists_[step_state_.instr_idx].size();
-           i++) {
-        EValue* arg = chain.argument_lists_[step_state_.instr_idx].data()[i];
+      for (size_t i = 0; i < instruction.args.size(); i++) {
+        EValue* arg = instruction.args.data()[i];
         internal::event_tracer_log_evalue(event_tracer_, *arg);
       }
 #endif
     } break;
-    case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
+    case DecodedInstruction::Type::JumpFalseCall: {
       EXECUTORCH_SCOPE_PROF("JF_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "JF_CALL");
-      // We know that instr_args_as_JumpFalseCall is non-null because it was
-      // checked at init time.
-      auto jf_call = instruction->instr_args_as_JumpFalseCall();
-      // We know that index is a valid values_ index because it was checked at
-      // init time.
-      auto index = jf_call->cond_value_index();
-      Result<bool> jf_result = parse_cond_value(values_[index]);
+      // We know that the cond value and destination are valid because they
+      // were checked at init time.
+      const auto& jf_call = instruction.jump_false_call;
+      Result<bool> jf_result = parse_cond_value(*jf_call.cond_value);
       if (jf_result.ok()) {
         if (!jf_result.get()) {
-          next_instr_idx = jf_call->destination_instruction();
+          next_instr_idx = jf_call.destination_instruction;
         }
       } else {
         err = jf_result.error();
       }
     } break;
-    case executorch_flatbuffer::InstructionArguments::MoveCall: {
+    case DecodedInstruction::Type::MoveCall: {
       EXECUTORCH_SCOPE_PROF("MOVE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "MOVE_CALL");
-      // We know that instr_args_as_MoveCall is non-null because it was checked
-      // at init time.
-      auto move_call = instruction->instr_args_as_MoveCall();
-      mutable_value(move_call->move_to()) = get_value(move_call->move_from());
+      *instruction.move_call.move_to = *instruction.move_call.move_from;
     } break;
-    case executorch_flatbuffer::InstructionArguments::FreeCall: {
+    case DecodedInstruction::Type::FreeCall: {
       EXECUTORCH_SCOPE_PROF("FREE_CALL");
       internal::EventTracerProfileOpScope event_tracer_op_scope =
           internal::EventTracerProfileOpScope(event_tracer_, "FREE_CALL");
-      // We know that instr_args_as_FreeCall is non-null because it was checked
-      // at init time.
-      auto free_call = instruction->instr_args_as_FreeCall();
-      auto t = values_[free_call->value_index()].toTensor();
+      auto t = instruction.free_value->toTensor();
       internal::reset_data_ptr(t);
     } break;
     default:
       ET_LOG(
           Error,
-          "Unknown instruction: %hhu",
-          static_cast<uint8_t>(instruction->instr_args_type()));
-      err = Error::InvalidProgram;
+          "Unknown instruction type: %hhu",
+          static_cast<uint8_t>(instruction.type));
+      err = Error::Internal;
+  }
+  if (instruction.streamed_constants != nullptr) {
+    unbind_streamed_constants(*instruction.streamed_constants);
   }
   // Reset the temp allocator for every instruction.
   if (temp_allocator_ != nullptr) {
+    if (temp_allocator_id_ != 0 && event_tracer_ != nullptr) {
+      // Log how much temp memory the instruction needed, including that of
+      // delegates, which allocate from it as well.
+      const size_t used_size = temp_allocator_->used_size();
+      if (used_size > 0) {
+        internal::event_tracer_track_allocation(
+            event_tracer_, temp_allocator_id_, used_size);
+      }
+    }
     temp_allocator_->reset();
   }
   if (err == Error::Ok) {
@@ -1182,6 +2502,361 @@ Error Method::execute_instruction() {
   return err;
 }
 
+Error Method::execute_parallel_instruction(size_t chain_idx, size_t instr_idx)
+    const {
+  const DecodedInstruction& instruction =
+      chains_[chain_idx].instructions_[instr_idx];
+  Error err = Error::Ok;
+  // Instructions in the same wave run concurrently, so they can't share the
+  // temp allocator or the event tracer.
+  switch (instruction.type) {
+    case DecodedInstruction::Type::KernelCall: {
+      KernelRuntimeContext context(
+          /*event_tracer=*/nullptr,
+          /*temp_allocator=*/nullptr,
+          kernel_cache_);
+      instruction.kernel_call.call(context, instruction.args.data());
+      err = context.failure_state();
+      if (err != Error::Ok) {
+        auto op = serialization_plan_->operators()->Get(
+            instruction.kernel_call.op_index);
+        ET_LOG(
+            Error,
+            "KernelCall failed at instruction %zu:%zu in operator %s.%s: 0x%x",
+            chain_idx,
+            instr_idx,
+            op->name()->c_str(),
+            op->overload()->c_str(),
+            (unsigned int)err);
+      }
+    } break;
+    case DecodedInstruction::Type::DelegateCall: {
+      BackendExecutionContext backend_execution_context(
+          /*event_tracer=*/nullptr,
+          /*temp_allocator=*/nullptr,
+          /*method_name=*/serialization_plan_->name()->c_str());
+      // Delegates with alternatives stay on the selected one here, since
+      // measuring needs executions of the same delegate not to overlap.
+      const BackendDelegate& delegate =
+          delegates_[instruction.delegate_call.delegate_index].Selected(
+              delegates_);
+      err = delegate.Execute(
+          backend_execution_context,
+          instruction.args.data(),
+          instruction.delegate_call.loop);
+      if (err != Error::Ok) {
+        ET_LOG(
+            Error,
+            "CALL_DELEGATE execute failed at instruction %zu:%zu: 0x%" PRIx32,
+            chain_idx,
+            instr_idx,
+            static_cast<uint32_t>(err));
+      }
+    } break;
+    default:
+      // Only kernel and delegate calls share a wave with other instructions.
+      ET_LOG(
+          Error,
+          "Instruction %zu:%zu of type %hhu cannot run in parallel",
+          chain_idx,
+          instr_idx,
+          static_cast<uint8_t>(instruction.type));
+      err = Error::Internal;
+  }
+  return err;
+}
+
+Error Method::execute_chain_in_waves() {
+  const Chain& chain = chains_[step_state_.chain_idx];
+
+  struct WaveContext {
+    const Method* method;
+    size_t chain_idx;
+    const uint32_t* instructions;
+    Error* errors;
+  };
+
+  size_t wave_begin = 0;
+  for (size_t wave = 0; wave < chain.wave_ends_.size(); ++wave) {
+    const size_t wave_end = chain.wave_ends_[wave];
+    const size_t wave_size = wave_end - wave_begin;
+    if (wave_size == 1) {
+      // Run lone instructions on the calling thread, with the temp allocator.
+      // Only a lone instruction in the next wave is known to run right after.
+      step_state_.instr_idx = chain.schedule_[wave_begin];
+      const size_t next_instr_idx = wave + 1 < chain.wave_ends_.size() &&
+              chain.wave_ends_[wave + 1] - wave_end == 1
+          ? chain.schedule_[wave_end]
+          : chain.instructions_.size();
+      Error err = execute_instruction(next_instr_idx);
+      if (err != Error::Ok) {
+        return err;
+      }
+    } else {
+      WaveContext context{
+          this,
+          step_state_.chain_idx,
+          &chain.schedule_[wave_begin],
+          task_errors_,
+      };
+      parallel_runner_->run(
+          [](void* ctx, size_t task_index) {
+            auto* wave_context = static_cast<WaveContext*>(ctx);
+            wave_context->errors[task_index] =
+                wave_context->method->execute_parallel_instruction(
+                    wave_context->chain_idx,
+                    wave_context->instructions[task_index]);
+          },
+          &context,
+          wave_size);
+      for (size_t i = 0; i < wave_size; ++i) {
+        if (task_errors_[i] != Error::Ok) {
+          return task_errors_[i];
+        }
+      }
+    }
+    wave_begin = wave_end;
+  }
+  step_state_.instr_idx = chain.instructions_.size();
+  return Error::Ok;
+}
+
+Error Method::build_parallel_schedule() {
+  auto method_allocator = memory_manager_->method_allocator();
+  const auto s_values = serialization_plan_->values();
+  size_t max_wave_size = 1;
+
+  // The analysis needs scratch space, which comes from the optional temp
+  // allocator and is released after each chain. Without one, it stays in the
+  // method allocator.
+  MemoryAllocator* scratch_allocator =
+      temp_allocator_ != nullptr ? temp_allocator_ : method_allocator;
+  auto release_scratch = [&]() {
+    if (temp_allocator_ != nullptr) {
+      temp_allocator_->reset();
+    }
+  };
+  // Leaves every chain sequential, so that a failed build has no effect.
+  auto fail = [&](Error err) {
+    release_scratch();
+    for (size_t i = 0; i < n_chains_; ++i) {
+      chains_[i].schedule_ = Span<uint32_t>();
+      chains_[i].wave_ends_ = Span<uint32_t>();
+    }
+    return err;
+  };
+
+  for (size_t chain_idx = 0; chain_idx < n_chains_; ++chain_idx) {
+    Chain& chain = chains_[chain_idx];
+    const size_t n = chain.instructions_.size();
+    if (n < 2) {
+      continue;
+    }
+    // Control flow makes the set of executed instructions data dependent, so
+    // keep those chains sequential.
+    bool has_control_flow = false;
+    for (size_t i = 0; i < n; ++i) {
+      if (chain.instructions_[i].type ==
+          DecodedInstruction::Type::JumpFalseCall) {
+        has_control_flow = true;
+        break;
+      }
+    }
+    if (has_control_flow) {
+      continue;
+    }
+
+    // Scratch space for the analysis; released at the end of each chain.
+    const auto s_instructions = chain.s_chain_->instructions();
+    size_t* access_offsets = scratch_allocator->allocateList<size_t>(n + 1);
+    uint32_t* levels = scratch_allocator->allocateList<uint32_t>(n);
+    if (access_offsets == nullptr || levels == nullptr) {
+      return fail(Error::MemoryAllocationFailed);
+    }
+    access_offsets[0] = 0;
+    for (size_t i = 0; i < n; ++i) {
+      const auto type = chain.instructions_[i].type;
+      const bool is_call = type == DecodedInstruction::Type::KernelCall ||
+          type == DecodedInstruction::Type::DelegateCall;
+      access_offsets[i + 1] = access_offsets[i] +
+          (is_call ? record_instruction_accesses(
+                         s_values, s_instructions->Get(i), nullptr)
+                   : 0);
+    }
+    InstructionAccess* accesses =
+        scratch_allocator->allocateList<InstructionAccess>(access_offsets[n]);
+    if (accesses == nullptr && access_offsets[n] > 0) {
+      return fail(Error::MemoryAllocationFailed);
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (access_offsets[i + 1] > access_offsets[i]) {
+        record_instruction_accesses(
+            s_values, s_instructions->Get(i), &accesses[access_offsets[i]]);
+      }
+    }
+
+    // Assign each instruction to the earliest wave that comes after every
+    // earlier instruction it conflicts with. Moves and frees act as barriers.
+    uint32_t max_level = 0;
+    uint32_t min_level = 0;
+    size_t first_after_barrier = 0;
+    for (size_t j = 0; j < n; ++j) {
+      const auto type = chain.instructions_[j].type;
+      uint32_t level = min_level;
+      if (type == DecodedInstruction::Type::MoveCall ||
+          type == DecodedInstruction::Type::FreeCall) {
+        level = j == 0 ? 0 : max_level + 1;
+        min_level = level + 1;
+        first_after_barrier = j + 1;
+      } else {
+        for (size_t i = j; i-- > first_after_barrier;) {
+          if (levels[i] < level) {
+            // Can't raise the level any further.
+            continue;
+          }
+          bool conflict = false;
+          for (size_t a = access_offsets[i];
+               !conflict && a < access_offsets[i + 1];
+               ++a) {
+            for (size_t b = access_offsets[j]; b < access_offsets[j + 1]; ++b) {
+              if (accesses_conflict(accesses[a], accesses[b])) {
+                conflict = true;
+                break;
+              }
+            }
+          }
+          if (conflict) {
+            level = levels[i] + 1;
+          }
+        }
+      }
+      levels[j] = level;
+      max_level = level > max_level ? level : max_level;
+    }
+
+    const size_t num_waves = max_level + 1;
+    if (num_waves < n) {
+      uint32_t* schedule = method_allocator->allocateList<uint32_t>(n);
+      uint32_t* wave_ends = method_allocator->allocateList<uint32_t>(num_waves);
+      uint32_t* cursors =
+          scratch_allocator->allocateList<uint32_t>(num_waves);
+      if (schedule == nullptr || wave_ends == nullptr || cursors == nullptr) {
+        return fail(Error::MemoryAllocationFailed);
+      }
+      // Counting sort by level, keeping program order within each wave.
+      for (size_t w = 0; w < num_waves; ++w) {
+        wave_ends[w] = 0;
+      }
+      for (size_t j = 0; j < n; ++j) {
+        wave_ends[levels[j]]++;
+      }
+      uint32_t end = 0;
+      for (size_t w = 0; w < num_waves; ++w) {
+        const uint32_t wave_size = wave_ends[w];
+        max_wave_size = wave_size > max_wave_size ? wave_size : max_wave_size;
+        cursors[w] = end;
+        end += wave_size;
+        wave_ends[w] = end;
+      }
+      for (size_t j = 0; j < n; ++j) {
+        schedule[cursors[levels[j]]++] = static_cast<uint32_t>(j);
+      }
+      chain.schedule_ = Span<uint32_t>(schedule, n);
+      chain.wave_ends_ = Span<uint32_t>(wave_ends, num_waves);
+    }
+    release_scratch();
+  }
+
+  task_errors_ = method_allocator->allocateList<Error>(max_wave_size);
+  if (task_errors_ == nullptr) {
+    return fail(Error::MemoryAllocationFailed);
+  }
+  return Error::Ok;
+}
+
+Error Method::set_parallel_runner(ParallelRunner* runner) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Parallel runner can not be set until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0,
+      InvalidState,
+      "Parallel runner can not be set mid execution.");
+  if (runner != nullptr) {
+    ET_CHECK_OR_RETURN_ERROR(
+        event_tracer_ == nullptr,
+        NotSupported,
+        "Parallel execution does not support an EventTracer.");
+    ET_CHECK_OR_RETURN_ERROR(
+        constant_stream_ == nullptr,
+        NotSupported,
+        "Parallel execution does not support streamed constants.");
+    if (task_errors_ == nullptr) {
+      Error err = build_parallel_schedule();
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+  parallel_runner_ = runner;
+  return Error::Ok;
+}
+
+Error Method::set_delegate_options(
+    const char* backend_id,
+    Span<const BackendOption> options) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot set delegate options of an uninitialized method");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0 &&
+          async_callback_ == nullptr,
+      InvalidState,
+      "Cannot set delegate options mid execution");
+  bool found = false;
+  for (size_t i = 0; i < n_delegate_; ++i) {
+    const auto* s_id = serialization_plan_->delegates()->Get(i)->id();
+    if (!delegates_[i].loaded() ||
+        std::strcmp(s_id->c_str(), backend_id) != 0) {
+      continue;
+    }
+    found = true;
+    Error err = delegates_[i].SetOptions(options);
+    if (err != Error::Ok) {
+      ET_LOG(
+          Error,
+          "Setting options of delegate %zu on %s failed: 0x%" PRIx32,
+          i,
+          backend_id,
+          static_cast<uint32_t>(err));
+      return err;
+    }
+  }
+  ET_CHECK_OR_RETURN_ERROR(
+      found, NotFound, "No delegate of the method runs on %s", backend_id);
+  return Error::Ok;
+}
+
+Error Method::get_delegate_options(
+    const char* backend_id,
+    Span<BackendOption> options) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot get delegate options of an uninitialized method");
+  for (size_t i = 0; i < n_delegate_; ++i) {
+    const auto* s_id = serialization_plan_->delegates()->Get(i)->id();
+    if (delegates_[i].loaded() &&
+        std::strcmp(s_id->c_str(), backend_id) == 0) {
+      return delegates_[i].GetOptions(options);
+    }
+  }
+  ET_LOG(Error, "No delegate of the method runs on %s", backend_id);
+  return Error::NotFound;
+}
+
 Error Method::reset_execution() {
   ET_CHECK_OR_RETURN_ERROR(
       step_state_.chain_idx == n_chains_,
@@ -1195,6 +2870,138 @@ Error Method::experimental_reset_execution() {
   return reset_execution(); // @lint-ignore CLANGTIDY facebook-hte-Deprecated
 }
 
+size_t Method::state_nbytes() const {
+  if (!initialized()) {
+    return 0;
+  }
+  const auto s_values = serialization_plan_->values();
+  size_t nbytes = 0;
+  for (size_t i = 0; i < n_value_; ++i) {
+    if (get_state_tensor(s_values->Get(i)) != nullptr) {
+      nbytes += values_[i].toTensor().nbytes();
+    }
+  }
+  return nbytes;
+}
+
+Error Method::save_state(Span<uint8_t> buffer) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot save the state of an uninitialized method");
+  const size_t nbytes = state_nbytes();
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer.size() == nbytes,
+      InvalidArgument,
+      "State buffer size %zu does not match state size %zu",
+      buffer.size(),
+      nbytes);
+  const auto s_values = serialization_plan_->values();
+  uint8_t* data = buffer.data();
+  for (size_t i = 0; i < n_value_; ++i) {
+    if (get_state_tensor(s_values->Get(i)) != nullptr) {
+      const auto& tensor = values_[i].toTensor();
+      std::memcpy(data, tensor.const_data_ptr(), tensor.nbytes());
+      data += tensor.nbytes();
+    }
+  }
+  return Error::Ok;
+}
+
+Error Method::restore_state(Span<const uint8_t> buffer) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot restore the state of an uninitialized method");
+  ET_CHECK_OR_RETURN_ERROR(
+      async_callback_ == nullptr,
+      InvalidState,
+      "Cannot restore the state of a method during asynchronous execution");
+  const size_t nbytes = state_nbytes();
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer.size() == nbytes,
+      InvalidArgument,
+      "State buffer size %zu does not match state size %zu",
+      buffer.size(),
+      nbytes);
+  const auto s_values = serialization_plan_->values();
+  const uint8_t* data = buffer.data();
+  for (size_t i = 0; i < n_value_; ++i) {
+    if (get_state_tensor(s_values->Get(i)) != nullptr) {
+      auto& tensor = values_[i].toTensor();
+      std::memcpy(tensor.mutable_data_ptr(), data, tensor.nbytes());
+      data += tensor.nbytes();
+    }
+  }
+  return Error::Ok;
+}
+
+Error Method::reset_state() {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot reset the state of an uninitialized method");
+  ET_CHECK_OR_RETURN_ERROR(
+      async_callback_ == nullptr,
+      InvalidState,
+      "Cannot reset the state of a method during asynchronous execution");
+  const auto s_values = serialization_plan_->values();
+  for (size_t i = 0; i < n_value_; ++i) {
+    const auto s_tensor = get_state_tensor(s_values->Get(i));
+    if (s_tensor != nullptr) {
+      auto& tensor = values_[i].toTensor();
+      Error err = program_->load_mutable_subsegment_into(
+          /*mutable_data_segments_index=*/0,
+          s_tensor->data_buffer_idx(),
+          tensor.nbytes(),
+          tensor.mutable_data_ptr());
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+  return Error::Ok;
+}
+
+Error Method::set_kernel_cache(KernelCache* cache) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "Cannot set the kernel cache of an uninitialized method");
+  ET_CHECK_OR_RETURN_ERROR(
+      async_callback_ == nullptr,
+      InvalidState,
+      "Cannot set the kernel cache of a method during asynchronous execution");
+  if (cache != nullptr) {
+    const auto s_values = serialization_plan_->values();
+    for (size_t i = 0; i < n_value_; ++i) {
+      const auto s_value = s_values->Get(i);
+      if (s_value->val_type() != executorch_flatbuffer::KernelTypes::Tensor) {
+        continue;
+      }
+      // Constants have serialized data but no memory plan.
+      const auto s_tensor = s_value->val_as_Tensor();
+      if (s_tensor->data_buffer_idx() == 0 ||
+          s_tensor->allocation_info() != nullptr) {
+        continue;
+      }
+      // Streamed constants have no data between the instructions that use
+      // them, so they can't be cached.
+      const auto& tensor = values_[i].toTensor();
+      if (tensor.const_data_ptr() == nullptr) {
+        continue;
+      }
+      Error err = cache->register_constant(
+          tensor.const_data_ptr(), tensor.nbytes());
+      if (err != Error::Ok) {
+        return err;
+      }
+    }
+  }
+  kernel_cache_ = cache;
+  return Error::Ok;
+}
+
 // Log all the outputs of this method to the event tracer.
 void Method::log_outputs() {
 #ifdef ET_EVENT_TRACER_ENABLED
@@ -1219,6 +3026,8 @@ Error Method::step() {
           static_cast<int32_t>(step_state_.chain_idx),
           static_cast<uint32_t>(step_state_.instr_idx));
   EXECUTORCH_SCOPE_PROF("Method::step");
+  // step() does not create an event block to register the temp allocator in.
+  temp_allocator_id_ = 0;
   EventTracerEntry event_tracer_entry =
       internal::event_tracer_begin_profiling_event(
           event_tracer_, "Method::step");
@@ -1232,8 +3041,7 @@ Error Method::step() {
     return Error::EndOfMethod;
   }
 
-  auto num_instructions =
-      chains_[step_state_.chain_idx].s_chain_->instructions()->size();
+  auto num_instructions = chains_[step_state_.chain_idx].instructions_.size();
 
   // Special case chains with no instructions. These appear for example in a
   // model that just returns the input/a constant.
@@ -1242,7 +3050,7 @@ Error Method::step() {
     return Error::Ok;
   }
 
-  auto status = execute_instruction();
+  auto status = execute_instruction(step_state_.instr_idx + 1);
   if (status != Error::Ok) {
     return status;
   }
@@ -1262,7 +3070,19 @@ Error Method::experimental_step() {
 }
 
 Error Method::execute() {
+  const bool traced = event_tracer_sampling_period_ != 0 &&
+      num_executions_++ % event_tracer_sampling_period_ == 0;
+  UntracedExecutionScope untraced_execution_scope(&event_tracer_, traced);
+  const bool discard_fast_execution =
+      event_tracer_ != nullptr && event_tracer_min_duration_ticks_ != 0;
+  const et_timestamp_t start_time =
+      discard_fast_execution ? et_pal_current_ticks() : 0;
+
   internal::event_tracer_create_event_block(event_tracer_, "Execute");
+  // Allocators must be registered before the first event of the block.
+  temp_allocator_id_ = temp_allocator_ != nullptr
+      ? internal::event_tracer_track_allocator(event_tracer_, "temp_allocator")
+      : 0;
   EventTracerEntry event_tracer_entry =
       internal::event_tracer_begin_profiling_event(
           event_tracer_, "Method::execute");
@@ -1276,17 +3096,23 @@ Error Method::execute() {
   // branch and run many in parallel or out of order.
   for (step_state_.chain_idx = 0; step_state_.chain_idx < n_chains_;
        ++step_state_.chain_idx) {
-    Chain& chain = chains_[step_state_.chain_idx];
-    auto instructions = chain.s_chain_->instructions();
-    ET_CHECK_OR_RETURN_ERROR(
-        instructions != nullptr,
-        Internal,
-        "chain %zu has no instructions field",
-        step_state_.chain_idx);
+    if (parallel_runner_ != nullptr &&
+        !chains_[step_state_.chain_idx].wave_ends_.empty()) {
+      auto status = execute_chain_in_waves();
+      if (status != Error::Ok) {
+        return status;
+      }
+      continue;
+    }
+
+    // The instructions were decoded and validated at init time, so this loop
+    // doesn't need to touch the serialized plan.
+    const size_t num_instructions =
+        chains_[step_state_.chain_idx].instructions_.size();
 
     // Loop over instructions
     step_state_.instr_idx = 0;
-    while (step_state_.instr_idx < chain.s_chain_->instructions()->size()) {
+    while (step_state_.instr_idx < num_instructions) {
       EXECUTORCH_PROFILE_INSTRUCTION_SCOPE(
           static_cast<int32_t>(step_state_.chain_idx),
           static_cast<uint32_t>(step_state_.instr_idx));
@@ -1295,7 +3121,7 @@ Error Method::execute() {
               event_tracer_,
               static_cast<ChainID>(step_state_.chain_idx),
               static_cast<DebugHandle>(step_state_.instr_idx));
-      auto status = execute_instruction();
+      auto status = execute_instruction(step_state_.instr_idx + 1);
       if (status != Error::Ok) {
         return status;
       }
@@ -1303,12 +3129,124 @@ Error Method::execute() {
   }
   internal::event_tracer_end_profiling_event(event_tracer_, event_tracer_entry);
   log_outputs();
+  if (discard_fast_execution &&
+      et_pal_current_ticks() - start_time < event_tracer_min_duration_ticks_) {
+    // Too fast to be worth keeping.
+    internal::event_tracer_discard_event_block(event_tracer_);
+  }
 
   // TODO(jakeszwe, dbort): Decide on calling execute back to back without
   // going through the reset api first.
   return reset_execution(); // @lint-ignore CLANGTIDY facebook-hte-Deprecated
 }
 
+Error Method::execute_async(
+    ExecutionCallback callback,
+    void* callback_context) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      NotSupported,
+      "Cannot execute until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      callback != nullptr, InvalidArgument, "Callback must not be null.");
+  ET_CHECK_OR_RETURN_ERROR(
+      event_tracer_ == nullptr,
+      NotSupported,
+      "Asynchronous execution does not support an EventTracer.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.chain_idx == 0 && step_state_.instr_idx == 0,
+      InvalidState,
+      "Cannot start execution mid execution.");
+
+  async_callback_ = callback;
+  async_callback_context_ = callback_context;
+  continue_async_execution();
+  return Error::Ok;
+}
+
+void Method::continue_async_execution() {
+  while (step_state_.chain_idx < n_chains_) {
+    const Chain& chain = chains_[step_state_.chain_idx];
+    if (step_state_.instr_idx >= chain.instructions_.size()) {
+      step_state_.chain_idx += 1;
+      step_state_.instr_idx = 0;
+      continue;
+    }
+
+    const DecodedInstruction& instruction =
+        chain.instructions_[step_state_.instr_idx];
+    // Loops run synchronously, inside their backend, and so do calls whose
+    // streamed constants must be released when they finish.
+    if (instruction.type == DecodedInstruction::Type::DelegateCall &&
+        instruction.delegate_call.loop == nullptr &&
+        instruction.streamed_constants == nullptr) {
+      BackendExecutionContext backend_execution_context(
+          /*event_tracer=*/nullptr,
+          /*temp_allocator=*/temp_allocator_,
+          /*method_name=*/serialization_plan_->name()->c_str());
+      const BackendDelegate& delegate =
+          delegates_[instruction.delegate_call.delegate_index].Selected(
+              delegates_);
+      Error err = delegate.ExecuteAsync(
+          backend_execution_context,
+          instruction.args.data(),
+          &Method::on_async_delegate_complete,
+          this);
+      if (err == Error::Ok) {
+        // The backend owns the rest of this execution now, and may already
+        // have finished it on another thread. Don't touch `this` again.
+        return;
+      }
+      if (err != Error::NotSupported) {
+        ET_LOG(
+            Error,
+            "CALL_DELEGATE execute_async failed at instruction %zu: 0x%" PRIx32,
+            step_state_.instr_idx,
+            static_cast<uint32_t>(err));
+        finish_async_execution(err);
+        return;
+      }
+      // The backend can only run synchronously; fall through.
+    }
+
+    Error err = execute_instruction(step_state_.instr_idx + 1);
+    if (err != Error::Ok) {
+      finish_async_execution(err);
+      return;
+    }
+  }
+  finish_async_execution(Error::Ok);
+}
+
+void Method::on_async_delegate_complete(void* method, Error error) {
+  auto* self = static_cast<Method*>(method);
+  if (self->temp_allocator_ != nullptr) {
+    self->temp_allocator_->reset();
+  }
+  if (error != Error::Ok) {
+    ET_LOG(
+        Error,
+        "CALL_DELEGATE async execution failed at instruction %zu: 0x%" PRIx32,
+        self->step_state_.instr_idx,
+        static_cast<uint32_t>(error));
+    self->finish_async_execution(error);
+    return;
+  }
+  self->step_state_.instr_idx += 1;
+  self->continue_async_execution();
+}
+
+void Method::finish_async_execution(Error error) {
+  ExecutionCallback callback = async_callback_;
+  void* callback_context = async_callback_context_;
+  async_callback_ = nullptr;
+  async_callback_context_ = nullptr;
+  // Start the next execution from the beginning whether or not this one
+  // failed, so that the Method can run again like after execute().
+  step_state_ = StepState{0, 0};
+  callback(callback_context, error);
+}
+
 MethodMeta Method::method_meta() const {
   auto name = serialization_plan_->name()->c_str();
   auto method_meta = program_->method_meta(name);
@@ -1370,7 +3308,57 @@ EventTracer* Method::get_event_tracer() {
   return event_tracer_;
 }
 
+Error Method::set_event_tracer(EventTracer* event_tracer) {
+  ET_CHECK_OR_RETURN_ERROR(
+      initialized(),
+      InvalidState,
+      "EventTracer can not be set until method has been initialized.");
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0 &&
+          async_callback_ == nullptr,
+      InvalidState,
+      "EventTracer can not be set mid execution.");
+  ET_CHECK_OR_RETURN_ERROR(
+      event_tracer == nullptr || parallel_runner_ == nullptr,
+      NotSupported,
+      "Parallel execution does not support an EventTracer.");
+  event_tracer_ = event_tracer;
+  return Error::Ok;
+}
+
+Error Method::set_event_tracer_sampling(
+    uint32_t period,
+    et_timestamp_t min_duration_ticks) {
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0 &&
+          async_callback_ == nullptr,
+      InvalidState,
+      "EventTracer sampling can not be set mid execution.");
+  event_tracer_sampling_period_ = period;
+  event_tracer_min_duration_ticks_ = min_duration_ticks;
+  num_executions_ = 0;
+  return Error::Ok;
+}
+
+Error Method::set_delegate_trial_interval(size_t num_executions) {
+  ET_CHECK_OR_RETURN_ERROR(
+      step_state_.instr_idx == 0 && step_state_.chain_idx == 0 &&
+          async_callback_ == nullptr,
+      InvalidState,
+      "Delegate trials can not be set up mid execution.");
+  delegate_trial_interval_ = num_executions;
+  return Error::Ok;
+}
+
 Method::~Method() {
+  // Let loads into the constant scratch finish before the caller reuses it.
+  if (constant_stream_ != nullptr) {
+    for (size_t half = 0; half < 2; ++half) {
+      if (constant_stream_->in_flight[half]) {
+        (void)wait_for_streamed_loads(half);
+      }
+    }
+  }
   // Destroy the values. It's necessary in ATen mode, where the refcount of
   // Tensors needs to be decremented properly.
   if (values_ != nullptr) {
@@ -1384,6 +3372,20 @@ Method::~Method() {
       delegates_[i].~BackendDelegate();
     }
   }
+  // Free the runtime memory of delegates that were initialized concurrently,
+  // after the delegates.
+  if (delegate_allocators_ != nullptr) {
+    for (size_t i = 0; i < n_delegate_allocators_; i++) {
+      delegate_allocators_[i].~PlatformMemoryAllocator();
+    }
+  }
+  // Release the data of lazily-loaded constants, after the values that point
+  // into it.
+  if (constant_data_ != nullptr) {
+    for (size_t i = 0; i < n_constant_data_; i++) {
+      constant_data_[i].~FreeableBuffer();
+    }
+  }
   // All other fields are trivially destructible.
 }
 } // namespace runtime
@@ -8,12 +8,16 @@
 
 #pragma once
 
+#include <executorch/runtime/backend/options.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/named_data_map.h>
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method_meta.h>
+#include <executorch/runtime/executor/parallel_runner.h>
 #include <executorch/runtime/platform/compiler.h>
 
 // Forward declare flatbuffer types. This is a public header and must not
@@ -33,8 +37,17 @@ class Program;
 // Forward declare internal types.
 class BackendDelegate;
 struct Chain;
+struct ConstantStream;
+class KernelCache;
 class KernelRuntimeContext;
+namespace internal {
+class PlatformMemoryAllocator;
+} // namespace internal
+struct StreamedConstants;
 using OpFunction = void (*)(KernelRuntimeContext&, EValue**);
+struct BoundOpFunction;
+using OpBindFunction =
+    Result<BoundOpFunction> (*)(MemoryAllocator*, EValue**, size_t);
 /// A list of pointers into the master values table that together compose the
 /// argument list for a single instruction
 using InstructionArgs = Span<EValue*>;
@@ -45,6 +58,16 @@ using InstructionArgs = Span<EValue*>;
  */
 class Method final {
  public:
+  /**
+   * EXPERIMENTAL: The function called when an execution started by
+   * `execute_async()` finishes.
+   *
+   * @param[in] context The `callback_context` passed to `execute_async()`.
+   * @param[in] error Error::Ok if the execution succeeded and the outputs are
+   *     ready, or the reason it failed.
+   */
+  using ExecutionCallback = void (*)(void* context, Error error);
+
   /**
    * Move ctor. Takes ownership of resources previously owned by `rhs`,
    * and leaves `rhs` in an uninitialized state.
@@ -54,21 +77,41 @@ class Method final {
         program_(rhs.program_),
         memory_manager_(rhs.memory_manager_),
         temp_allocator_(rhs.temp_allocator_),
+        named_data_map_(rhs.named_data_map_),
         serialization_plan_(rhs.serialization_plan_),
         event_tracer_(rhs.event_tracer_),
+        event_tracer_sampling_period_(rhs.event_tracer_sampling_period_),
+        event_tracer_min_duration_ticks_(rhs.event_tracer_min_duration_ticks_),
+        num_executions_(rhs.num_executions_),
+        delegate_trial_interval_(rhs.delegate_trial_interval_),
+        temp_allocator_id_(rhs.temp_allocator_id_),
+        kernel_cache_(rhs.kernel_cache_),
         n_value_(rhs.n_value_),
         values_(rhs.values_),
+        n_constant_data_(rhs.n_constant_data_),
+        constant_data_(rhs.constant_data_),
         n_delegate_(rhs.n_delegate_),
         delegates_(rhs.delegates_),
+        n_delegate_allocators_(rhs.n_delegate_allocators_),
+        delegate_allocators_(rhs.delegate_allocators_),
         n_chains_(rhs.n_chains_),
         chains_(rhs.chains_),
+        parallel_runner_(rhs.parallel_runner_),
+        task_errors_(rhs.task_errors_),
+        constant_stream_(rhs.constant_stream_),
+        async_callback_(rhs.async_callback_),
+        async_callback_context_(rhs.async_callback_context_),
         init_state_(rhs.init_state_) {
     // Required: clear out fields that the dtor looks at, so that we don't free
     // anything twice.
     rhs.n_value_ = 0;
     rhs.values_ = nullptr;
+    rhs.n_constant_data_ = 0;
+    rhs.constant_data_ = nullptr;
     rhs.n_delegate_ = 0;
     rhs.delegates_ = nullptr;
+    rhs.n_delegate_allocators_ = 0;
+    rhs.delegate_allocators_ = nullptr;
 
     // Helpful: Try to ensure that any other interactions with the old object
     // result in failures.
@@ -78,8 +121,14 @@ class Method final {
     rhs.memory_manager_ = nullptr;
     rhs.serialization_plan_ = nullptr;
     rhs.event_tracer_ = nullptr;
+    rhs.kernel_cache_ = nullptr;
     rhs.n_chains_ = 0;
     rhs.chains_ = nullptr;
+    rhs.parallel_runner_ = nullptr;
+    rhs.task_errors_ = nullptr;
+    rhs.constant_stream_ = nullptr;
+    rhs.async_callback_ = nullptr;
+    rhs.async_callback_context_ = nullptr;
   }
 
   /**
@@ -139,6 +188,21 @@ class Method final {
   ET_NODISCARD Error
   set_output_data_ptr(void* buffer, size_t size, size_t output_idx);
 
+  /**
+   * Sets the data buffers of all method outputs at once, as if by calling
+   * set_output_data_ptr() for each of them. Either all buffers are set, or,
+   * on failure, none of them.
+   *
+   * @param[in] buffers One buffer per output. An empty buffer with a null data
+   *     pointer leaves the corresponding output unchanged, e.g. for outputs
+   *     that are memory-planned or are not tensors. Every other buffer must
+   *     be at least as large as the nbytes of its tensor, and the tensor must
+   *     not have had a buffer allocated by the memory plan.
+   *
+   * @returns Error::Ok on success, non-Ok on failure.
+   */
+  ET_NODISCARD Error set_output_data_ptrs(Span<const Span<uint8_t>> buffers);
+
   /**
    * Copies the method's outputs into the provided array.
    *
@@ -184,6 +248,33 @@ class Method final {
    */
   ET_NODISCARD Error execute();
 
+  /**
+   * EXPERIMENTAL: Starts executing the method, returning as soon as execution
+   * is waiting on a delegate that runs asynchronously.
+   *
+   * Instructions run on the calling thread until a delegate call is reached
+   * whose backend implements `BackendInterface::execute_async()`. This method
+   * then returns, and execution continues on whichever thread the backend
+   * reports completion from. Delegates that do not support asynchronous
+   * execution run synchronously, so if no delegate in the method supports it,
+   * `callback` is called before this method returns.
+   *
+   * The Method must not be used, moved or destroyed until `callback` has been
+   * called. The callback may destroy the Method or start a new execution.
+   *
+   * @param[in] callback The function to call when the execution finishes.
+   * @param[in] callback_context The value to pass as the first argument to
+   *     `callback`.
+   *
+   * @retval Error::Ok if execution started. `callback` will be called exactly
+   *     once with the result of the execution.
+   * @retval Error::NotSupported if the Method has an EventTracer.
+   * @retval Other errors if execution could not start. `callback` will not be
+   *     called in this case.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  execute_async(ExecutionCallback callback, void* callback_context);
+
   /**
    * EXPERIMENTAL: Advances/executes a single instruction in the method.
    *
@@ -210,6 +301,140 @@ class Method final {
   /// DEPRECATED: Use `reset_execution()` instead.
   ET_DEPRECATED ET_NODISCARD Error experimental_reset_execution();
 
+  /**
+   * EXPERIMENTAL: Returns the number of bytes needed to save the state of the
+   * Method with `save_state()`.
+   *
+   * The state is the data of the memory-planned tensors that the Program
+   * gives initial data for, which is how mutable buffers such as KV caches or
+   * RNN state are serialized. It does not include inputs, outputs or
+   * intermediate values.
+   */
+  ET_EXPERIMENTAL size_t state_nbytes() const;
+
+  /**
+   * EXPERIMENTAL: Copies the state of the Method into `buffer`, so that it can
+   * later be restored with `restore_state()`, e.g. to roll back speculative
+   * decoding or to fork a conversation.
+   *
+   * @param[in] buffer Where to save the state. Must be `state_nbytes()` bytes
+   *     long.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidArgument if `buffer` has the wrong size.
+   * @retval Error::InvalidState if the Method is not initialized.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error save_state(Span<uint8_t> buffer) const;
+
+  /**
+   * EXPERIMENTAL: Restores state saved with `save_state()` by this Method, or
+   * by another Method loaded from the same method of the same Program.
+   *
+   * @param[in] buffer The saved state. Must be `state_nbytes()` bytes long.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidArgument if `buffer` has the wrong size.
+   * @retval Error::InvalidState if the Method is not initialized, or an
+   *     `execute_async()` call is in flight.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error restore_state(Span<const uint8_t> buffer);
+
+  /**
+   * EXPERIMENTAL: Resets the state of the Method to the initial data in the
+   * Program, as it was right after loading.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the Method is not initialized, or an
+   *     `execute_async()` call is in flight.
+   * @returns Other errors if the initial data can't be loaded.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error reset_state();
+
+  /**
+   * EXPERIMENTAL: Lets the kernels of this Method keep data that they derive
+   * from its constant tensors in `cache`, like weights repacked for a GEMM
+   * micro-kernel, instead of deriving it again on every execution.
+   *
+   * Registers the data of every constant tensor of the Method with the cache.
+   * Methods of the same Program may share a cache, and then share the entries
+   * for the constants they have in common.
+   *
+   * @param[in] cache The cache, which must outlive the Method, or nullptr to
+   *     stop using one.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the Method is not initialized, or an
+   *     `execute_async()` call is in flight.
+   * @returns Other errors from KernelCache::register_constant().
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error set_kernel_cache(KernelCache* cache);
+
+  /**
+   * EXPERIMENTAL: Lets `execute()` run independent instructions of each chain
+   * concurrently using `runner`.
+   *
+   * The first call analyzes the argument lists and memory plan of every
+   * instruction to build a schedule of "waves": groups of kernel and delegate
+   * calls that touch disjoint values and disjoint memory-planned storage, and
+   * that can therefore run in any order. Chains that contain control flow are
+   * always executed sequentially. The schedule is allocated from the method
+   * allocator; the temp allocator is used as scratch space while building it.
+   *
+   * Kernels and delegates that run concurrently with other instructions are
+   * called without a temp allocator, so instructions that require temp memory
+   * will fail unless they are alone in their wave. `step()` always executes
+   * sequentially.
+   *
+   * @param[in] runner The runner to dispatch waves to. Must outlive the Method
+   *     or be replaced by a later call. Pass nullptr to go back to sequential
+   *     execution.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::NotSupported if the Method has an EventTracer, which is not
+   *     safe to use from multiple threads.
+   * @retval Error::InvalidState if the Method is not initialized or is in the
+   *     middle of step-based execution.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  set_parallel_runner(ParallelRunner* runner);
+
+  /**
+   * EXPERIMENTAL: Changes runtime options, such as the number of threads, of
+   * every delegate of this Method that runs on the backend `backend_id`; see
+   * `BackendInterface::set_option()`. Stops at the first delegate that fails.
+   *
+   * Must not be called while the Method executes on another thread.
+   *
+   * @param[in] backend_id The id of the backend, as in the program.
+   * @param[in] options The options to set.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::NotFound if no delegate of the Method runs on the backend.
+   * @retval Error::InvalidState if the Method is not initialized or is in the
+   *     middle of an execution.
+   * @returns Other errors from BackendInterface::set_option().
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error set_delegate_options(
+      const char* backend_id,
+      Span<const BackendOption> options);
+
+  /**
+   * EXPERIMENTAL: Reads runtime options of the first delegate of this Method
+   * that runs on the backend `backend_id`; see
+   * `BackendInterface::get_option()`.
+   *
+   * @param[in] backend_id The id of the backend, as in the program.
+   * @param[in,out] options The options to get.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::NotFound if no delegate of the Method runs on the backend.
+   * @retval Error::InvalidState if the Method is not initialized.
+   * @returns Other errors from BackendInterface::get_option().
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error get_delegate_options(
+      const char* backend_id,
+      Span<BackendOption> options) const;
+
   /**
    * Returns the MethodMeta that corresponds to the calling Method.
    */
@@ -232,6 +457,68 @@ class Method final {
 
   EventTracer* get_event_tracer();
 
+  /**
+   * Attaches an EventTracer that logs the events of later executions, or
+   * detaches the current one, without reloading the Method. Unlike the
+   * EventTracer passed to Program::load_method(), it misses the events of
+   * loading the Method.
+   *
+   * @param[in] event_tracer The EventTracer, which must outlive the Method or
+   *     be replaced by a later call, or nullptr to detach the current one.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::NotSupported if `event_tracer` is not null and the Method
+   *     has a ParallelRunner.
+   * @retval Error::InvalidState if the Method is not initialized, or is in the
+   *     middle of an execution.
+   */
+  ET_NODISCARD Error set_event_tracer(EventTracer* event_tracer);
+
+  /**
+   * Limits which calls to `execute()` log events to the EventTracer, so that
+   * production traffic can be profiled statistically. Executions that are not
+   * traced run exactly as if no EventTracer was attached.
+   *
+   * @param[in] period Trace one of every `period` executions, starting with the
+   *     next one. 1, the default, traces every execution and 0 none.
+   * @param[in] min_duration_ticks If not zero, drop the events of traced
+   *     executions that succeed in fewer ticks than this once they end, with
+   *     EventTracer::discard_event_block(). EventTracers that cannot drop
+   *     events keep them.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the Method is in the middle of an
+   *     execution.
+   */
+  ET_NODISCARD Error set_event_tracer_sampling(
+      uint32_t period,
+      et_timestamp_t min_duration_ticks = 0);
+
+  /**
+   * EXPERIMENTAL: Makes delegates that were exported with alternative
+   * lowerings, e.g. for a GPU and a CPU backend, re-measure which of them is
+   * fastest while the Method runs.
+   *
+   * Such a delegate runs the first of its lowerings that loads, in the order
+   * of preference of the program, and falls back to the next one if it fails.
+   * With a non-zero interval, every `num_executions` executions of the
+   * delegate run the next lowering in turn instead, and the delegate then
+   * keeps running the lowering with the lowest moving average latency. This
+   * adapts to e.g. a throttled GPU or a busy NPU.
+   *
+   * Executions on a ParallelRunner or with execute_async() run the selected
+   * lowering without measuring it.
+   *
+   * @param[in] num_executions How often to try another lowering. 0, the
+   *     default, only switches lowerings when one fails.
+   *
+   * @retval Error::Ok on success.
+   * @retval Error::InvalidState if the Method is in the middle of an
+   *     execution.
+   */
+  ET_EXPERIMENTAL ET_NODISCARD Error
+  set_delegate_trial_interval(size_t num_executions);
+
   /// DEPRECATED: Use MethodMeta instead to access metadata, and set_input to
   /// update Method inputs.
   ET_DEPRECATED const EValue& get_input(size_t i) const;
@@ -271,19 +558,36 @@ class Method final {
       const Program* program,
       MemoryManager* memory_manager,
       EventTracer* event_tracer,
-      MemoryAllocator* temp_allocator)
+      MemoryAllocator* temp_allocator,
+      const NamedDataMap* named_data_map)
       : step_state_(),
         program_(program),
         memory_manager_(memory_manager),
         temp_allocator_(temp_allocator),
+        named_data_map_(named_data_map),
         serialization_plan_(nullptr),
         event_tracer_(event_tracer),
+        event_tracer_sampling_period_(1),
+        event_tracer_min_duration_ticks_(0),
+        num_executions_(0),
+        delegate_trial_interval_(0),
+        temp_allocator_id_(0),
+        kernel_cache_(nullptr),
         n_value_(0),
         values_(nullptr),
+        n_constant_data_(0),
+        constant_data_(nullptr),
         n_delegate_(0),
         delegates_(nullptr),
+        n_delegate_allocators_(0),
+        delegate_allocators_(nullptr),
         n_chains_(0),
         chains_(nullptr),
+        parallel_runner_(nullptr),
+        task_errors_(nullptr),
+        constant_stream_(nullptr),
+        async_callback_(nullptr),
+        async_callback_context_(nullptr),
         init_state_(InitializationState::Uninitialized) {}
 
   /// Static factory used by Program.
@@ -291,14 +595,29 @@ class Method final {
       executorch_flatbuffer::ExecutionPlan* s_plan,
       const Program* program,
       MemoryManager* memory_manager,
-      EventTracer* event_tracer);
+      EventTracer* event_tracer,
+      const NamedDataMap* named_data_map,
+      ParallelRunner* init_runner = nullptr);
 
   /**
    * Initialize the method from its serialized representation.
    *
+   * @param[in] s_plan The serialized method.
+   * @param[in] init_runner If not null, the delegates are initialized
+   *     concurrently on it; see Program::load_method().
+   *
    * @returns Error::Ok on success, non-Ok on failure.
    */
-  ET_NODISCARD Error init(executorch_flatbuffer::ExecutionPlan* s_plan);
+  ET_NODISCARD Error init(
+      executorch_flatbuffer::ExecutionPlan* s_plan,
+      ParallelRunner* init_runner = nullptr);
+
+  // Initializes the delegates concurrently on `runner`, each allocating from
+  // a PlatformMemoryAllocator of its own, since the method allocator is not
+  // thread-safe.
+  ET_NODISCARD Error init_delegates_concurrently(
+      ParallelRunner* runner,
+      const NamedDataMap* delegate_data_map);
 
   /// Returns true if the Method was successfully initialized.
   inline bool initialized() const {
@@ -310,38 +629,120 @@ class Method final {
   size_t get_input_index(size_t i) const;
   size_t get_output_index(size_t i) const;
 
-  // Executes a single instruction using the state in step_state_
-  ET_NODISCARD Error execute_instruction();
+  // Executes a single instruction using the state in step_state_.
+  // `next_instr_idx` is the instruction that runs next, on its own, or the size
+  // of the chain if there is no such instruction.
+  ET_NODISCARD Error execute_instruction(size_t next_instr_idx);
+
+  // Builds the wave schedule of every chain for parallel execution.
+  ET_NODISCARD Error build_parallel_schedule();
+
+  // Executes the chain at step_state_.chain_idx one wave at a time.
+  ET_NODISCARD Error execute_chain_in_waves();
+
+  // Executes a kernel or delegate instruction of a parallel wave. Unlike
+  // execute_instruction(), does not touch step_state_ and may be called from
+  // any thread.
+  ET_NODISCARD Error
+  execute_parallel_instruction(size_t chain_idx, size_t instr_idx) const;
+
+  // Runs instructions of an execute_async() call until the method finishes or
+  // an asynchronous delegate call is in flight.
+  void continue_async_execution();
+
+  // Ends an execute_async() call and reports `error` to the caller. Must be the
+  // last use of `this`, since the callback may destroy the Method.
+  void finish_async_execution(Error error);
+
+  // DelegateCompletionCallback for asynchronous delegate calls.
+  static void on_async_delegate_complete(void* method, Error error);
 
   StepState step_state_;
   const Program* program_;
   MemoryManager* memory_manager_;
   MemoryAllocator* temp_allocator_;
+  /// The data of external tensors, if any.
+  const NamedDataMap* named_data_map_;
   executorch_flatbuffer::ExecutionPlan* serialization_plan_;
   EventTracer* event_tracer_;
+  /// Which executions log events to event_tracer_, see
+  /// set_event_tracer_sampling().
+  uint32_t event_tracer_sampling_period_;
+  et_timestamp_t event_tracer_min_duration_ticks_;
+  uint64_t num_executions_;
+  /// See set_delegate_trial_interval().
+  size_t delegate_trial_interval_;
+  /// The id of temp_allocator_ in the event block of the current execution,
+  /// or 0 if its allocations are not being traced.
+  AllocatorID temp_allocator_id_;
+  KernelCache* kernel_cache_;
 
   size_t n_value_;
   EValue* values_;
 
+  /// Data of the constant tensors that are loaded lazily from the Program, or
+  /// from named_data_map_.
+  size_t n_constant_data_;
+  FreeableBuffer* constant_data_;
+
   size_t n_delegate_;
   BackendDelegate* delegates_;
 
+  /// The runtime allocators of the delegates, if they were initialized
+  /// concurrently. Destroyed after delegates_, which may point into them.
+  size_t n_delegate_allocators_;
+  internal::PlatformMemoryAllocator* delegate_allocators_;
+
   size_t n_chains_;
   Chain* chains_;
 
+  ParallelRunner* parallel_runner_;
+  /// One slot per task of the widest wave; only allocated once a schedule has
+  /// been built.
+  Error* task_errors_;
+
+  /// What the constant scratch holds, if the Method streams constants.
+  ConstantStream* constant_stream_;
+
+  /// The callback of the in-flight execute_async() call, if any.
+  ExecutionCallback async_callback_;
+  void* async_callback_context_;
+
   InitializationState init_state_;
 
   /**
    * Parses the elements of the values_ array. On error, n_value_ will be set to
    * the number of successfully-initialized entries so that ~Method doesn't try
-   * to clean up uninitialized entries.
+   * to clean up uninitialized entries. If not null, `streamed_constants`
+   * marks the constants whose data is streamed instead of loaded.
+   */
+  ET_NODISCARD Error parse_values(const bool* streamed_constants);
+
+  /**
+   * Lays out the streamed constants of each instruction in the constant
+   * scratch. `streamed_constants` marks the values to stream.
    */
-  ET_NODISCARD Error parse_values();
+  ET_NODISCARD Error init_constant_stream(const bool* streamed_constants);
+
+  // Makes the data of `constants` available for their instruction, and starts
+  // loading the constants of the next instruction.
+  ET_NODISCARD Error bind_streamed_constants(
+      const StreamedConstants& constants);
+
+  // Releases the data of `constants` once their instruction has run.
+  void unbind_streamed_constants(const StreamedConstants& constants);
+
+  // Starts loading `constants` into a half of the constant scratch.
+  ET_NODISCARD Error
+  start_streamed_loads(size_t half, const StreamedConstants& constants);
+
+  // Waits for the loads in flight into a half of the constant scratch.
+  ET_NODISCARD Error wait_for_streamed_loads(size_t half);
 
   ET_NODISCARD Error resolve_operator(
       int32_t op_index,
-      OpFunction* kernels,
-      size_t kernel_index,
+      OpFunction* kernel,
+      OpBindFunction* bind,
       InstructionArgs args,
       size_t n_args);
 
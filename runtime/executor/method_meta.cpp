@@ -6,6 +6,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
@@ -63,6 +65,15 @@ size_t calculate_nbytes(
   return n * executorch::runtime::elementSize(scalar_type);
 }
 
+bool is_memory_planned_tensor(
+    const executorch_flatbuffer::EValue* serialization_value) {
+  return serialization_value != nullptr &&
+      serialization_value->val_type() ==
+      executorch_flatbuffer::KernelTypes::Tensor &&
+      serialization_value->val_as_Tensor() != nullptr &&
+      serialization_value->val_as_Tensor()->allocation_info() != nullptr;
+}
+
 } // namespace
 
 TensorInfo::TensorInfo(
@@ -210,6 +221,155 @@ Result<int64_t> MethodMeta::memory_planned_buffer_size(size_t index) const {
   return s_plan_->non_const_buffer_sizes()->Get(index + 1);
 }
 
+size_t MethodMeta::num_memory_planned_tensors() const {
+  const auto values = s_plan_->values();
+  if (values == nullptr) {
+    return 0;
+  }
+  size_t count = 0;
+  for (size_t i = 0; i < values->size(); ++i) {
+    if (is_memory_planned_tensor(values->Get(i))) {
+      count++;
+    }
+  }
+  return count;
+}
+
+Error MethodMeta::memory_planned_tensors(Span<PlannedTensorInfo> out) const {
+  const auto num_tensors = num_memory_planned_tensors();
+  ET_CHECK_OR_RETURN_ERROR(
+      out.size() == num_tensors,
+      InvalidArgument,
+      "out has %zu entries, but there are %zu memory-planned tensors",
+      out.size(),
+      num_tensors);
+  if (num_tensors == 0) {
+    return Error::Ok;
+  }
+
+  const auto values = s_plan_->values();
+  size_t next = 0;
+  for (size_t i = 0; i < values->size(); ++i) {
+    const auto serialization_value = values->Get(i);
+    if (!is_memory_planned_tensor(serialization_value)) {
+      continue;
+    }
+    const auto s_tensor = serialization_value->val_as_Tensor();
+    const auto allocation_info = s_tensor->allocation_info();
+    ET_CHECK_OR_RETURN_ERROR(
+        s_tensor->sizes() != nullptr,
+        InvalidProgram,
+        "Missing sizes for value %zu",
+        i);
+    ET_CHECK_OR_RETURN_ERROR(
+        allocation_info->memory_id() > 0,
+        InvalidProgram,
+        "Invalid memory id 0 for value %zu",
+        i);
+    auto& info = out[next++];
+    info.value_index = i;
+    // Memory id zero is reserved; see memory_planned_buffer_size().
+    info.buffer_index = allocation_info->memory_id() - 1;
+    info.offset = (static_cast<uint64_t>(allocation_info->memory_offset_high())
+                   << 32) |
+        allocation_info->memory_offset_low();
+    info.nbytes = calculate_nbytes(
+        Span<const int32_t>(
+            s_tensor->sizes()->data(), s_tensor->sizes()->size()),
+        static_cast<exec_aten::ScalarType>(s_tensor->scalar_type()));
+    info.first_use = -1;
+    info.last_use = -1;
+  }
+
+  // Marks a use of `value_index`, and of the tensors in it if it's a list.
+  auto record_use = [&](int32_t value_index, int64_t instruction_index) {
+    if (value_index < 0 ||
+        static_cast<size_t>(value_index) >= values->size()) {
+      return;
+    }
+    const auto serialization_value = values->Get(value_index);
+    if (serialization_value == nullptr) {
+      return;
+    }
+    const flatbuffers::Vector<int32_t>* items = nullptr;
+    if (serialization_value->val_type() ==
+        executorch_flatbuffer::KernelTypes::TensorList) {
+      items = serialization_value->val_as_TensorList()->items();
+    } else if (
+        serialization_value->val_type() ==
+        executorch_flatbuffer::KernelTypes::OptionalTensorList) {
+      items = serialization_value->val_as_OptionalTensorList()->items();
+    }
+    auto mark = [&](int32_t index) {
+      // `out` is sorted by value index.
+      auto it = std::lower_bound(
+          out.begin(),
+          out.end(),
+          index,
+          [](const PlannedTensorInfo& info, int32_t index) {
+            return info.value_index < static_cast<size_t>(index);
+          });
+      if (it == out.end() || it->value_index != static_cast<size_t>(index)) {
+        return;
+      }
+      if (it->first_use < 0) {
+        it->first_use = instruction_index;
+      }
+      it->last_use = instruction_index;
+    };
+    mark(value_index);
+    if (items != nullptr) {
+      for (int32_t item : *items) {
+        mark(item);
+      }
+    }
+  };
+
+  const auto chains = s_plan_->chains();
+  int64_t instruction_index = 0;
+  for (size_t c = 0; chains != nullptr && c < chains->size(); ++c) {
+    const auto s_chain = chains->Get(c);
+    if (s_chain == nullptr || s_chain->instructions() == nullptr) {
+      continue;
+    }
+    for (const auto instruction : *s_chain->instructions()) {
+      switch (instruction->instr_args_type()) {
+        case executorch_flatbuffer::InstructionArguments::KernelCall: {
+          const auto args = instruction->instr_args_as_KernelCall()->args();
+          for (size_t a = 0; args != nullptr && a < args->size(); ++a) {
+            record_use(args->Get(a), instruction_index);
+          }
+        } break;
+        case executorch_flatbuffer::InstructionArguments::DelegateCall: {
+          const auto args = instruction->instr_args_as_DelegateCall()->args();
+          for (size_t a = 0; args != nullptr && a < args->size(); ++a) {
+            record_use(args->Get(a), instruction_index);
+          }
+        } break;
+        case executorch_flatbuffer::InstructionArguments::MoveCall: {
+          const auto move_call = instruction->instr_args_as_MoveCall();
+          record_use(move_call->move_from(), instruction_index);
+          record_use(move_call->move_to(), instruction_index);
+        } break;
+        case executorch_flatbuffer::InstructionArguments::JumpFalseCall: {
+          record_use(
+              instruction->instr_args_as_JumpFalseCall()->cond_value_index(),
+              instruction_index);
+        } break;
+        case executorch_flatbuffer::InstructionArguments::FreeCall: {
+          record_use(
+              instruction->instr_args_as_FreeCall()->value_index(),
+              instruction_index);
+        } break;
+        default:
+          break;
+      }
+      instruction_index++;
+    }
+  }
+  return Error::Ok;
+}
+
 size_t MethodMeta::num_instructions() const {
   const auto chains = s_plan_->chains();
   if (chains == nullptr) {
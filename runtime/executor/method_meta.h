@@ -98,6 +98,31 @@ class TensorInfo final {
   size_t nbytes_;
 };
 
+/**
+ * Describes where a memory-planned tensor of a method lives, and which
+ * instructions use it.
+ */
+struct PlannedTensorInfo {
+  /// The index of the tensor in the method's values.
+  size_t value_index;
+  /// The memory-planned buffer that holds the tensor. The same index as used
+  /// by MethodMeta::memory_planned_buffer_size().
+  size_t buffer_index;
+  /// The byte offset of the tensor's data in the buffer.
+  size_t offset;
+  /// The size of the tensor's data in bytes. For tensors with dynamic shapes,
+  /// this is the size of the upper bound.
+  size_t nbytes;
+  /// The index of the first instruction that uses the tensor, counting
+  /// instructions across all chains, or -1 if no instruction uses it. Method
+  /// inputs and outputs are also live before and after the instructions that
+  /// use them.
+  int64_t first_use;
+  /// The index of the last instruction that uses the tensor, or -1 if no
+  /// instruction uses it.
+  int64_t last_use;
+};
+
 /**
  * Describes a a method in an ExecuTorch program.
  *
@@ -185,6 +210,26 @@ class MethodMeta final {
    */
   Result<int64_t> memory_planned_buffer_size(size_t index) const;
 
+  /**
+   * Get the number of memory-planned tensors in this method.
+   *
+   * @returns The number of memory-planned tensors.
+   */
+  ET_EXPERIMENTAL size_t num_memory_planned_tensors() const;
+
+  /**
+   * Describes all memory-planned tensors in this method, in value order.
+   *
+   * This walks all instructions of the method to find the tensors' lifetimes,
+   * so it is meant for tooling rather than for use on hot paths.
+   *
+   * @param[out] out Receives the descriptions. Must have exactly
+   *     num_memory_planned_tensors() entries.
+   * @returns Error::Ok on success, or an error on failure.
+   */
+  ET_EXPERIMENTAL Error
+  memory_planned_tensors(Span<PlannedTensorInfo> out) const;
+
   /**
    * Get the number of instructions in this method.
    *
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * EXPERIMENTAL: Runs batches of independent tasks on behalf of a Method.
+ *
+ * The core runtime does not own any threads. Clients that want a Method to
+ * run independent instructions concurrently provide an implementation of this
+ * interface backed by their threading system of choice; see
+ * `executorch/extension/threadpool/threadpool_parallel_runner.h` for one that
+ * uses the ExecuTorch threadpool.
+ */
+class ParallelRunner {
+ public:
+  /// The signature of a task: `context` is passed through unchanged from
+  /// run(), and `task_index` is in the range `[0, num_tasks)`.
+  using TaskFunction = void (*)(void* context, size_t task_index);
+
+  /**
+   * Calls `fn(context, i)` for every `i` in `[0, num_tasks)`. The calls may run
+   * concurrently and in any order, but this method must not return until all
+   * of them have completed.
+   */
+  virtual void run(TaskFunction fn, void* context, size_t num_tasks) = 0;
+
+  virtual ~ParallelRunner() = default;
+};
+
+} // namespace runtime
+} // namespace executorch
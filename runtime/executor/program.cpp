@@ -8,8 +8,10 @@
 
 #include <executorch/runtime/executor/program.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include <executorch/runtime/core/event_tracer_hooks.h>
 #include <executorch/runtime/executor/memory_manager.h>
@@ -58,11 +60,194 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
   return Error::InvalidArgument;
 }
 
+bool is_compressed(const executorch_flatbuffer::DataSegment* data_segment) {
+  return data_segment->compression() !=
+      executorch_flatbuffer::SegmentCompression::NONE;
+}
+
+/**
+ * Returns the size of the data of the segment, once decompressed if it is
+ * compressed.
+ */
+uint64_t segment_data_size(
+    const executorch_flatbuffer::DataSegment* data_segment) {
+  return is_compressed(data_segment) ? data_segment->uncompressed_size()
+                                     : data_segment->size();
+}
+
+/**
+ * Returns the offset in the data source to pass to DataLoader::load() to read
+ * the data of the segment at `offset` within it. For compressed segments,
+ * load() offsets are relative to the uncompressed data.
+ */
+size_t segment_load_offset(
+    const executorch_flatbuffer::DataSegment* data_segment,
+    size_t segment_base_offset,
+    size_t offset) {
+  return is_compressed(data_segment)
+      ? offset
+      : segment_base_offset + data_segment->offset() + offset;
+}
+
+DataLoader::SegmentInfo constant_segment_info(
+    const executorch_flatbuffer::DataSegment* data_segment,
+    size_t segment_index,
+    size_t segment_base_offset) {
+  DataLoader::SegmentInfo info(
+      DataLoader::SegmentInfo::Type::Constant, segment_index);
+  if (is_compressed(data_segment)) {
+    info.compressed_offset = segment_base_offset + data_segment->offset();
+    info.compressed_size = data_segment->size();
+  }
+  return info;
+}
+
+#if ET_ENABLE_PROGRAM_VERIFICATION
+
+/**
+ * Verifies the root Program table like executorch_flatbuffer::Program::Verify()
+ * does, except for the contents of the execution plans, which can then be
+ * verified separately. Keep in sync with `table Program` in
+ * schema/program.fbs.
+ */
+bool verify_program_except_plans(
+    flatbuffers::Verifier& verifier,
+    const executorch_flatbuffer::Program* program) {
+  using executorch_flatbuffer::Program;
+  return program->VerifyTableStart(verifier) &&
+      program->VerifyField<uint32_t>(verifier, Program::VT_VERSION, 4) &&
+      program->VerifyOffset(verifier, Program::VT_EXECUTION_PLAN) &&
+      verifier.VerifyVector(program->execution_plan()) &&
+      program->VerifyOffset(verifier, Program::VT_CONSTANT_BUFFER) &&
+      verifier.VerifyVector(program->constant_buffer()) &&
+      verifier.VerifyVectorOfTables(program->constant_buffer()) &&
+      program->VerifyOffset(verifier, Program::VT_BACKEND_DELEGATE_DATA) &&
+      verifier.VerifyVector(program->backend_delegate_data()) &&
+      verifier.VerifyVectorOfTables(program->backend_delegate_data()) &&
+      program->VerifyOffset(verifier, Program::VT_SEGMENTS) &&
+      verifier.VerifyVector(program->segments()) &&
+      verifier.VerifyVectorOfTables(program->segments()) &&
+      program->VerifyOffset(verifier, Program::VT_CONSTANT_SEGMENT) &&
+      verifier.VerifyTable(program->constant_segment()) &&
+      program->VerifyOffset(verifier, Program::VT_MUTABLE_DATA_SEGMENTS) &&
+      verifier.VerifyVector(program->mutable_data_segments()) &&
+      verifier.VerifyVectorOfTables(program->mutable_data_segments()) &&
+      program->VerifyOffset(verifier, Program::VT_NAMED_DATA) &&
+      verifier.VerifyVector(program->named_data()) &&
+      verifier.VerifyVectorOfTables(program->named_data()) &&
+      verifier.EndTable();
+}
+
+/// The maximum number of tasks that verify execution plans concurrently.
+constexpr size_t kMaxVerificationTasks = 32;
+
+struct PlanVerificationContext {
+  const uint8_t* data;
+  size_t size;
+  const flatbuffers::Vector<
+      flatbuffers::Offset<executorch_flatbuffer::ExecutionPlan>>* plans;
+  size_t num_tasks;
+  // Written only by the task with the same index.
+  bool ok[kMaxVerificationTasks];
+};
+
+/**
+ * Verifies the flatbuffer data of a program. With a runner, the root table is
+ * verified first, and then the execution plans, which hold most of the data,
+ * are verified concurrently with one Verifier per task.
+ */
+bool verify_program(
+    const void* data,
+    size_t size,
+    ParallelRunner* verification_runner) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+  flatbuffers::Verifier verifier(bytes, size);
+  if (verification_runner == nullptr) {
+    return executorch_flatbuffer::VerifyProgramBuffer(verifier);
+  }
+
+  // Program::load() already checked the file identifier, which is the only
+  // other thing that VerifyProgramBuffer() checks.
+  const size_t root_offset = verifier.VerifyOffset(0);
+  if (root_offset == 0) {
+    return false;
+  }
+  const auto* program =
+      reinterpret_cast<const executorch_flatbuffer::Program*>(
+          bytes + root_offset);
+  if (!verify_program_except_plans(verifier, program)) {
+    return false;
+  }
+  const auto* plans = program->execution_plan();
+  if (plans == nullptr || plans->size() < 2) {
+    return verifier.VerifyVectorOfTables(plans);
+  }
+
+  PlanVerificationContext context{};
+  context.data = bytes;
+  context.size = size;
+  context.plans = plans;
+  context.num_tasks = std::min<size_t>(plans->size(), kMaxVerificationTasks);
+  verification_runner->run(
+      [](void* ctx, size_t task_index) {
+        auto* context = static_cast<PlanVerificationContext*>(ctx);
+        flatbuffers::Verifier plan_verifier(context->data, context->size);
+        bool ok = true;
+        for (size_t i = task_index; ok && i < context->plans->size();
+             i += context->num_tasks) {
+          ok = plan_verifier.VerifyTable(context->plans->Get(i));
+        }
+        context->ok[task_index] = ok;
+      },
+      &context,
+      context.num_tasks);
+  for (size_t i = 0; i < context.num_tasks; ++i) {
+    if (!context.ok[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+#endif // ET_ENABLE_PROGRAM_VERIFICATION
+
+/**
+ * Loads the segment described by `segment_info` from `loader`. `loader` is
+ * null if the program has no segments.
+ */
+Result<FreeableBuffer> load_segment(
+    const executorch_flatbuffer::Program* program,
+    DataLoader* loader,
+    size_t segment_base_offset,
+    const DataLoader::SegmentInfo& segment_info) {
+  size_t index = segment_info.segment_index;
+  if (loader == nullptr || segment_base_offset == 0) {
+    ET_LOG(Error, "No segments in program: requested index %zu", index);
+    return Error::NotFound;
+  }
+  size_t num_segments = program->segments()->size();
+  if (index >= num_segments) {
+    ET_LOG(
+        Error, "Segment index %zu out of range (>= %zu)", index, num_segments);
+    return Error::NotFound;
+  }
+  const executorch_flatbuffer::DataSegment* segment =
+      program->segments()->Get(index);
+  // Could fail if offset and size are out of bound for the data, or if this
+  // is reading from a file and fails, or for many other reasons depending on
+  // the implementation of the loader.
+  return loader->load(
+      segment_base_offset + segment->offset(), segment->size(), segment_info);
+}
+
 } // namespace
 
 /* static */ Result<Program> Program::load(
     DataLoader* loader,
-    Program::Verification verification) {
+    Program::Verification verification,
+    Program::ConstantLoading constant_loading,
+    ParallelRunner* verification_runner,
+    VerificationCache* verification_cache) {
   EXECUTORCH_SCOPE_PROF("Program::load");
 
   // See if the program size is in the header.
@@ -123,15 +308,22 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
   if (verification == Verification::InternalConsistency) {
 #if ET_ENABLE_PROGRAM_VERIFICATION
     EXECUTORCH_SCOPE_PROF("Program::verify_internal_consistency");
-    flatbuffers::Verifier verifier(
-        reinterpret_cast<const uint8_t*>(program_data->data()),
-        program_data->size());
-    bool ok = executorch_flatbuffer::VerifyProgramBuffer(verifier);
-    ET_CHECK_OR_RETURN_ERROR(
-        ok,
-        InvalidProgram,
-        "Verification failed; data may be truncated or corrupt");
+    if (verification_cache == nullptr ||
+        !verification_cache->contains(
+            program_data->data(), program_data->size())) {
+      bool ok = verify_program(
+          program_data->data(), program_data->size(), verification_runner);
+      ET_CHECK_OR_RETURN_ERROR(
+          ok,
+          InvalidProgram,
+          "Verification failed; data may be truncated or corrupt");
+      if (verification_cache != nullptr) {
+        verification_cache->insert(program_data->data(), program_data->size());
+      }
+    }
 #else
+    (void)verification_runner;
+    (void)verification_cache;
     ET_LOG(
         Info, "InternalConsistency verification requested but not available");
 #endif
@@ -182,12 +374,42 @@ Result<executorch_flatbuffer::ExecutionPlan*> get_execution_plan(
 
     const executorch_flatbuffer::DataSegment* data_segment =
         segments->Get(constant_segment->segment_index());
-    Result<FreeableBuffer> constant_segment_data = loader->load(
-        segment_base_offset + data_segment->offset(),
-        data_segment->size(),
-        DataLoader::SegmentInfo(
-            DataLoader::SegmentInfo::Type::Constant,
-            constant_segment->segment_index()));
+    if (is_compressed(data_segment)) {
+      ET_CHECK_OR_RETURN_ERROR(
+          data_segment->compression() ==
+              executorch_flatbuffer::SegmentCompression::LZ4_CHUNKED,
+          InvalidProgram,
+          "Unknown constant segment compression %d",
+          static_cast<int>(data_segment->compression()));
+      ET_CHECK_OR_RETURN_ERROR(
+          loader->supports_compressed_segments(),
+          NotSupported,
+          "Constant segment is compressed; load the program through a "
+          "DecompressingDataLoader");
+    }
+    if (constant_loading == ConstantLoading::Lazy ||
+        constant_loading == ConstantLoading::Streamed) {
+      // Methods will load the constants they use from the loader.
+      return Program(
+          loader,
+          segment_base_offset,
+          std::move(program_data.get()),
+          flatbuffer_program,
+          /*constant_segment_data=*/FreeableBuffer{},
+          /*lazy_constants=*/true,
+          /*streamed_constants=*/constant_loading ==
+              ConstantLoading::Streamed);
+    }
+    // Let the loader start reading the constants while the mapping is set up,
+    // or before they are first touched by the first inference.
+    const DataLoader::SegmentInfo segment_info = constant_segment_info(
+        data_segment, constant_segment->segment_index(), segment_base_offset);
+    const size_t load_offset =
+        segment_load_offset(data_segment, segment_base_offset, /*offset=*/0);
+    const size_t load_size = segment_data_size(data_segment);
+    loader->prefetch(load_offset, load_size, segment_info);
+    Result<FreeableBuffer> constant_segment_data =
+        loader->load(load_offset, load_size, segment_info);
     if (!constant_segment_data.ok()) {
       return constant_segment_data.error();
     }
@@ -240,7 +462,9 @@ Result<const char*> Program::get_method_name(size_t plan_index) const {
 Result<Method> Program::load_method(
     const char* method_name,
     MemoryManager* memory_manager,
-    EventTracer* event_tracer) const {
+    EventTracer* event_tracer,
+    const NamedDataMap* named_data_map,
+    ParallelRunner* init_runner) const {
   EXECUTORCH_SCOPE_PROF("Program::load_method");
   internal::event_tracer_create_event_block(event_tracer, "Default");
   internal::EventTracerProfileMethodScope event_tracer_scope =
@@ -257,7 +481,14 @@ Result<Method> Program::load_method(
   if (!plan.ok()) {
     return plan.error();
   }
-  return Method::load(plan.get(), this, memory_manager, event_tracer);
+  prefetch_delegate_segments(plan.get());
+  return Method::load(
+      plan.get(),
+      this,
+      memory_manager,
+      event_tracer,
+      named_data_map,
+      init_runner);
 }
 
 Result<MethodMeta> Program::method_meta(const char* method_name) const {
@@ -288,6 +519,11 @@ Result<const void*> Program::get_constant_buffer_data(
   auto internal_program =
       static_cast<const executorch_flatbuffer::Program*>(internal_program_);
 
+  ET_CHECK_OR_RETURN_ERROR(
+      !lazy_constants_,
+      NotSupported,
+      "Constant segment is loaded lazily; use load_constant_data()");
+
   // Constant data is either in a separate segment (constant_segment_data) and
   // loaded during Program::load, or stored inside the flatbuffer data
   // (constant_buffer).
@@ -346,6 +582,91 @@ Result<const void*> Program::get_constant_buffer_data(
   }
 }
 
+Result<FreeableBuffer> Program::load_constant_data(
+    size_t buffer_index,
+    size_t nbytes) const {
+  EXECUTORCH_SCOPE_PROF("Program::load_constant_data");
+  DataLoader::LoadIntoRequest request;
+  Error err =
+      get_constant_data_request(buffer_index, nbytes, nullptr, &request);
+  if (err != Error::Ok) {
+    return err;
+  }
+  return loader_->load(request.offset, request.size, request.segment_info);
+}
+
+Error Program::get_constant_data_request(
+    size_t buffer_index,
+    size_t nbytes,
+    void* buffer,
+    DataLoader::LoadIntoRequest* out_request) const {
+  ET_CHECK_OR_RETURN_ERROR(
+      lazy_constants_ && loader_ != nullptr,
+      InvalidState,
+      "Constant segment is not loaded lazily");
+
+  // Program::load() checked that the constant segment and its segment entry
+  // exist.
+  const auto* constant_segment = internal_program_->constant_segment();
+  size_t num_elems = constant_segment->offsets()->size();
+  ET_CHECK_OR_RETURN_ERROR(
+      buffer_index < num_elems,
+      InvalidArgument,
+      "Constant segment buffer index %zu invalid for program constant segment range %zu",
+      buffer_index,
+      num_elems);
+
+  uint64_t offset =
+      static_cast<uint64_t>(constant_segment->offsets()->Get(buffer_index));
+  const executorch_flatbuffer::DataSegment* data_segment =
+      internal_program_->segments()->Get(constant_segment->segment_index());
+  const uint64_t segment_size = segment_data_size(data_segment);
+  ET_CHECK_OR_RETURN_ERROR(
+      offset + nbytes <= segment_size,
+      InvalidArgument,
+      "Constant segment offset %" PRIu64
+      " + size_bytes %zu invalid for program constant segment size %" PRIu64,
+      offset,
+      nbytes,
+      segment_size);
+
+  *out_request = DataLoader::LoadIntoRequest{
+      segment_load_offset(data_segment, segment_base_offset_, offset),
+      nbytes,
+      constant_segment_info(
+          data_segment,
+          constant_segment->segment_index(),
+          segment_base_offset_),
+      buffer};
+  return Error::Ok;
+}
+
+Error Program::start_loads_into(
+    Span<const DataLoader::LoadIntoRequest> requests) const {
+  EXECUTORCH_SCOPE_PROF("Program::start_loads_into");
+  if (requests.empty()) {
+    return Error::Ok;
+  }
+  if (loader_ == nullptr || segment_base_offset_ == 0) {
+    ET_LOG(Error, "No segments in program");
+    return Error::NotFound;
+  }
+  return loader_->start_load_into_batch(requests);
+}
+
+Error Program::wait_for_loads_into(
+    Span<const DataLoader::LoadIntoRequest> requests) const {
+  EXECUTORCH_SCOPE_PROF("Program::wait_for_loads_into");
+  if (requests.empty()) {
+    return Error::Ok;
+  }
+  if (loader_ == nullptr || segment_base_offset_ == 0) {
+    ET_LOG(Error, "No segments in program");
+    return Error::NotFound;
+  }
+  return loader_->wait_for_load_into_batch(requests);
+}
+
 Result<const char*> Program::get_output_flattening_encoding(
     const char* method_name) const {
   auto plan = get_execution_plan(internal_program_, method_name);
@@ -396,24 +717,40 @@ Error Program::get_backend_delegate_data(
 Result<FreeableBuffer> Program::LoadSegment(
     const DataLoader::SegmentInfo& segment_info) const {
   EXECUTORCH_SCOPE_PROF("Program::LoadSegment");
-  size_t index = segment_info.segment_index;
-  if (loader_ == nullptr || segment_base_offset_ == 0) {
-    ET_LOG(Error, "No segments in program: requested index %zu", index);
-    return Error::NotFound;
+  return load_segment(
+      internal_program_, loader_, segment_base_offset_, segment_info);
+}
+
+void Program::prefetch_delegate_segments(
+    const executorch_flatbuffer::ExecutionPlan* plan) const {
+  if (loader_ == nullptr || plan->delegates() == nullptr ||
+      internal_program_->segments() == nullptr) {
+    return;
   }
-  size_t num_segments = internal_program_->segments()->size();
-  if (index >= num_segments) {
-    ET_LOG(
-        Error, "Segment index %zu out of range (>= %zu)", index, num_segments);
-    return Error::NotFound;
+  // Method::init() loads delegate data in order; ask for all of it up front
+  // so that later reads overlap with the init of earlier delegates.
+  const size_t num_segments = internal_program_->segments()->size();
+  for (const auto* delegate : *plan->delegates()) {
+    if (delegate == nullptr || delegate->processed() == nullptr ||
+        delegate->processed()->location() !=
+            executorch_flatbuffer::DataLocation::SEGMENT) {
+      continue;
+    }
+    const size_t index = delegate->processed()->index();
+    if (index >= num_segments) {
+      // Method::init() reports the error.
+      continue;
+    }
+    const executorch_flatbuffer::DataSegment* segment =
+        internal_program_->segments()->Get(index);
+    loader_->prefetch(
+        segment_base_offset_ + segment->offset(),
+        segment->size(),
+        DataLoader::SegmentInfo(
+            DataLoader::SegmentInfo::Type::Backend,
+            index,
+            delegate->id() != nullptr ? delegate->id()->c_str() : nullptr));
   }
-  const executorch_flatbuffer::DataSegment* segment =
-      internal_program_->segments()->Get(index);
-  // Could fail if offset and size are out of bound for the data, or if this
-  // is reading from a file and fails, or for many other reasons depending on
-  // the implementation of the loader.
-  return loader_->load(
-      segment_base_offset_ + segment->offset(), segment->size(), segment_info);
 }
 
 Error Program::load_mutable_subsegment_into(
@@ -422,6 +759,37 @@ Error Program::load_mutable_subsegment_into(
     size_t size,
     void* buffer) const {
   EXECUTORCH_SCOPE_PROF("Program::load_subsegment_into");
+  DataLoader::LoadIntoRequest request;
+  Error err = get_mutable_subsegment_request(
+      mutable_data_segments_index, offset_index, size, buffer, &request);
+  if (err != Error::Ok) {
+    return err;
+  }
+
+  // Load the data
+  return loader_->load_into(
+      request.offset, request.size, request.segment_info, request.buffer);
+}
+
+Error Program::load_subsegments_into(
+    Span<const DataLoader::LoadIntoRequest> requests) const {
+  EXECUTORCH_SCOPE_PROF("Program::load_subsegments_into");
+  if (requests.empty()) {
+    return Error::Ok;
+  }
+  if (loader_ == nullptr || segment_base_offset_ == 0) {
+    ET_LOG(Error, "No segments in program");
+    return Error::NotFound;
+  }
+  return loader_->load_into_batch(requests);
+}
+
+Error Program::get_mutable_subsegment_request(
+    size_t mutable_data_segments_index,
+    size_t offset_index,
+    size_t size,
+    void* buffer,
+    DataLoader::LoadIntoRequest* out_request) const {
   // Check that the program has segments.
   if (loader_ == nullptr || segment_base_offset_ == 0) {
     ET_LOG(Error, "No segments in program");
@@ -496,9 +864,107 @@ Error Program::load_mutable_subsegment_into(
       segment_offsets->segment_index(),
       nullptr);
 
-  // Load the data
-  return loader_->load_into(
-      segment_base_offset_ + segment->offset() + offset, size, info, buffer);
+  out_request->offset = segment_base_offset_ + segment->offset() + offset;
+  out_request->size = size;
+  out_request->segment_info = info;
+  out_request->buffer = buffer;
+  return Error::Ok;
+}
+
+const NamedDataMap* Program::get_named_data_map() const {
+  const auto* named_data = internal_program_->named_data();
+  return named_data != nullptr && named_data->size() > 0 ? &named_data_
+                                                          : nullptr;
+}
+
+Result<TensorLayout> Program::NamedDataTable::get_metadata(
+    ET_UNUSED const char* key) const {
+  ET_LOG(Error, "Named data in the program has no tensor layout");
+  return Error::NotSupported;
+}
+
+Result<FreeableBuffer> Program::NamedDataTable::get_data(
+    const char* key) const {
+  const auto* named_data = internal_program_->named_data();
+  if (named_data == nullptr) {
+    return Error::NotFound;
+  }
+  for (const executorch_flatbuffer::NamedData* entry : *named_data) {
+    ET_CHECK_OR_RETURN_ERROR(
+        entry->key() != nullptr && entry->data() != nullptr,
+        InvalidProgram,
+        "Incomplete named data entry");
+    if (std::strcmp(entry->key()->c_str(), key) != 0) {
+      continue;
+    }
+    const size_t index = entry->data()->index();
+    switch (entry->data()->location()) {
+      case executorch_flatbuffer::DataLocation::INLINE: {
+        const auto* data_list = internal_program_->backend_delegate_data();
+        ET_CHECK_OR_RETURN_ERROR(
+            data_list != nullptr && index < data_list->size(),
+            InvalidProgram,
+            "Named data '%s' index %zu out of range",
+            key,
+            index);
+        const auto* data = data_list->Get(index)->data();
+        return FreeableBuffer(data->data(), data->size(), /*free_fn=*/nullptr);
+      }
+      case executorch_flatbuffer::DataLocation::SEGMENT:
+        return load_segment(
+            internal_program_,
+            loader_,
+            segment_base_offset_,
+            DataLoader::SegmentInfo(
+                DataLoader::SegmentInfo::Type::Backend, index, key));
+      default:
+        ET_LOG(
+            Error,
+            "Unknown data location %u",
+            static_cast<unsigned int>(entry->data()->location()));
+        return Error::InvalidProgram;
+    }
+  }
+  return Error::NotFound;
+}
+
+Result<size_t> Program::NamedDataTable::load_data_into(
+    const char* key,
+    void* buffer,
+    size_t size) const {
+  Result<FreeableBuffer> data = get_data(key);
+  if (!data.ok()) {
+    return data.error();
+  }
+  const size_t nbytes = data->size();
+  ET_CHECK_OR_RETURN_ERROR(
+      nbytes <= size,
+      InvalidArgument,
+      "Buffer of %zu bytes is too small for named data '%s' of %zu bytes",
+      size,
+      key,
+      nbytes);
+  std::memcpy(buffer, data->data(), nbytes);
+  data->Free();
+  return nbytes;
+}
+
+Result<size_t> Program::NamedDataTable::get_num_keys() const {
+  const auto* named_data = internal_program_->named_data();
+  return named_data != nullptr ? named_data->size() : 0;
+}
+
+Result<const char*> Program::NamedDataTable::get_key(size_t index) const {
+  const auto* named_data = internal_program_->named_data();
+  ET_CHECK_OR_RETURN_ERROR(
+      named_data != nullptr && index < named_data->size(),
+      InvalidArgument,
+      "Named data index %zu out of range",
+      index);
+  const auto* key = named_data->Get(index)->key();
+  ET_CHECK_OR_RETURN_ERROR(
+      key != nullptr, InvalidProgram, "Named data %zu has no key", index);
+  return key->c_str();
 }
 
 } // namespace runtime
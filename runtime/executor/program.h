@@ -15,15 +15,19 @@
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/freeable_buffer.h>
+#include <executorch/runtime/core/named_data_map.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/method_meta.h>
+#include <executorch/runtime/executor/parallel_runner.h>
+#include <executorch/runtime/executor/verification_cache.h>
 #include <executorch/runtime/platform/compiler.h>
 
 // Forward declare flatbuffer types. This is a public header and must not
 // include the generated flatbuffer header.
 namespace executorch_flatbuffer {
+struct ExecutionPlan;
 struct Program;
 } // namespace executorch_flatbuffer
 
@@ -68,6 +72,42 @@ class Program final {
     InternalConsistency,
   };
 
+  /**
+   * When the data of constant tensors stored in the constant segment is
+   * loaded.
+   */
+  enum class ConstantLoading : uint8_t {
+    /**
+     * Load the whole constant segment during Program::load().
+     */
+    Eager,
+    /**
+     * Load the data of each constant tensor from the DataLoader when a method
+     * that uses it is loaded. Constants used only by methods that are never
+     * loaded are never read. Each Method owns the data of its constants, so a
+     * constant used by several loaded methods is loaded once per method.
+     *
+     * Has no effect on programs that store constants inside the flatbuffer
+     * data.
+     */
+    Lazy,
+    /**
+     * For targets whose constants don't fit in memory, e.g. microcontrollers
+     * with weights in external flash. Like Lazy, but a Method only keeps the
+     * data of a constant tensor in memory while an instruction that uses it
+     * runs: the data of each instruction's constants is loaded into half of
+     * the MemoryManager's constant scratch right before it runs, and the
+     * constants of the next instruction are loaded into the other half while
+     * it runs, with DataLoader::start_load_into_batch().
+     *
+     * The constant scratch must fit the constants of any one instruction
+     * twice. Constants that are outputs of the method, or that are not
+     * arguments of kernel or delegate calls, are loaded at Method init as with
+     * Lazy.
+     */
+    Streamed,
+  };
+
   /**
    * Loads a Program from the provided loader. The Program will hold a pointer
    * to the loader, which must outlive the returned Program instance.
@@ -77,10 +117,20 @@ class Program final {
    *     instance.
    * @param[in] verification The type of verification to do before returning
    *     success.
+   * @param[in] constant_loading When to load the data of constant tensors.
+   * @param[in] verification_runner If not null, the InternalConsistency
+   *     verification of the execution plans runs on it, so that several plans
+   *     can be verified concurrently.
+   * @param[in] verification_cache If not null, InternalConsistency
+   *     verification is skipped for program data that the cache contains, and
+   *     program data that passes it is inserted into the cache.
    */
   ET_NODISCARD static Result<Program> load(
       DataLoader* loader,
-      Verification verification = Verification::Minimal);
+      Verification verification = Verification::Minimal,
+      ConstantLoading constant_loading = ConstantLoading::Eager,
+      ParallelRunner* verification_runner = nullptr,
+      VerificationCache* verification_cache = nullptr);
 
   /// DEPRECATED: Use the lowercase `load()` instead.
   ET_DEPRECATED ET_NODISCARD static Result<Program> Load(
@@ -97,7 +147,8 @@ class Program final {
    * Get the constant buffer inside Program with index buffer_idx.
    * @param[in] buffer_idx the index of the buffer in the constant_buffer.
    * @param[in] nbytes the number of bytes to read from the buffer.
-   * @return The buffer with corresponding index.
+   * @return The buffer with corresponding index. Fails with
+   *     Error::NotSupported if the constants are loaded lazily.
    */
   Result<const void*> get_constant_buffer_data(size_t buffer_idx, size_t nbytes)
       const;
@@ -126,13 +177,26 @@ class Program final {
    *     execution of the loaded method. If `memory_manager.temp_allocator()` is
    *     null, the runtime will allocate temp memory using `et_pal_allocate()`.
    * @param[in] event_tracer The event tracer to use for this method run.
+   * @param[in] named_data_map The data of the method's tensors that are stored
+   *     outside of the program, e.g. in a FlatTensor file. Required if the
+   *     program was exported with external constants, and must outlive the
+   *     Method.
+   * @param[in] init_runner EXPERIMENTAL: If not null, the delegates of the
+   *     method are initialized concurrently on this runner instead of one by
+   *     one, e.g. to pack the weights of many XNNPACK partitions on several
+   *     cores. Each delegate then allocates its runtime memory from
+   *     `et_pal_allocate()`, which must be thread-safe, rather than from the
+   *     method allocator, and the backends must support concurrent calls to
+   *     `BackendInterface::init()`.
    *
    * @returns The loaded method on success, or an error on failure.
    */
   Result<Method> load_method(
       const char* method_name,
       MemoryManager* memory_manager,
-      EventTracer* event_tracer = nullptr) const;
+      EventTracer* event_tracer = nullptr,
+      const NamedDataMap* named_data_map = nullptr,
+      ParallelRunner* init_runner = nullptr) const;
 
   /**
    * Gathers metadata for the named method.
@@ -230,6 +294,58 @@ class Program final {
   ET_NODISCARD Result<FreeableBuffer> LoadSegment(
       const DataLoader::SegmentInfo& segment_info) const;
 
+  /// Hints the loader to read the segments holding the processed data of the
+  /// plan's delegates.
+  void prefetch_delegate_segments(
+      const executorch_flatbuffer::ExecutionPlan* plan) const;
+
+  /// Returns true if constant data must be loaded with load_constant_data().
+  bool has_lazy_constants() const {
+    return lazy_constants_;
+  }
+
+  /// Returns true if Methods stream constant data through their constant
+  /// scratch; see ConstantLoading::Streamed.
+  bool has_streamed_constants() const {
+    return streamed_constants_;
+  }
+
+  /**
+   * Loads the data of a constant tensor from the constant segment. Only valid
+   * if has_lazy_constants() is true.
+   *
+   * @param[in] buffer_index The index of the tensor's data in
+   *     Program.constant_segment.offsets.
+   * @param[in] nbytes The number of bytes to load.
+   *
+   * @returns The data as a FreeableBuffer, if the index and size are valid.
+   */
+  ET_NODISCARD Result<FreeableBuffer> load_constant_data(
+      size_t buffer_index,
+      size_t nbytes) const;
+
+  /**
+   * Validates the data of a constant tensor like load_constant_data(), but
+   * instead of loading it, describes a read of it into `buffer` in
+   * `out_request`, for start_loads_into().
+   */
+  ET_NODISCARD Error get_constant_data_request(
+      size_t buffer_index,
+      size_t nbytes,
+      void* buffer,
+      DataLoader::LoadIntoRequest* out_request) const;
+
+  /**
+   * Starts reads created by get_constant_data_request() without waiting for
+   * them; see DataLoader::start_load_into_batch().
+   */
+  ET_NODISCARD Error
+  start_loads_into(Span<const DataLoader::LoadIntoRequest> requests) const;
+
+  /// Waits for reads started by start_loads_into() with `requests`.
+  ET_NODISCARD Error
+  wait_for_loads_into(Span<const DataLoader::LoadIntoRequest> requests) const;
+
   /**
    * Loads a portion of a mutable segment into the provided buffer.
    *
@@ -254,19 +370,80 @@ class Program final {
       size_t size,
       void* buffer) const;
 
+  /**
+   * Validates a portion of a mutable segment like
+   * load_mutable_subsegment_into(), but instead of loading it, describes the
+   * read in `out_request` so that it can be batched with others and passed to
+   * load_subsegments_into().
+   */
+  ET_NODISCARD Error get_mutable_subsegment_request(
+      size_t mutable_data_segments_index,
+      size_t offset_index,
+      size_t size,
+      void* buffer,
+      DataLoader::LoadIntoRequest* out_request) const;
+
+  /**
+   * Performs reads created by get_mutable_subsegment_request(), possibly
+   * concurrently.
+   */
+  ET_NODISCARD Error
+  load_subsegments_into(Span<const DataLoader::LoadIntoRequest> requests) const;
+
+  /**
+   * Returns the data that delegates look up by key at init, or nullptr if the
+   * program has none. Valid as long as the Program.
+   */
+  const NamedDataMap* get_named_data_map() const;
+
+  /**
+   * A NamedDataMap over Program.named_data. The data is not tensor data, so
+   * get_metadata() is not supported. Only holds pointers that stay valid when
+   * the Program is moved.
+   */
+  class NamedDataTable final : public NamedDataMap {
+   public:
+    NamedDataTable(
+        const executorch_flatbuffer::Program* internal_program,
+        DataLoader* loader,
+        size_t segment_base_offset)
+        : internal_program_(internal_program),
+          loader_(loader),
+          segment_base_offset_(segment_base_offset) {}
+
+    ET_NODISCARD Result<TensorLayout> get_metadata(
+        const char* key) const override;
+    ET_NODISCARD Result<FreeableBuffer> get_data(
+        const char* key) const override;
+    ET_NODISCARD Result<size_t>
+    load_data_into(const char* key, void* buffer, size_t size) const override;
+    ET_NODISCARD Result<size_t> get_num_keys() const override;
+    ET_NODISCARD Result<const char*> get_key(size_t index) const override;
+
+   private:
+    const executorch_flatbuffer::Program* internal_program_;
+    DataLoader* loader_;
+    size_t segment_base_offset_;
+  };
+
  private:
   Program(
       DataLoader* loader,
       size_t segment_base_offset,
       FreeableBuffer&& program_data,
       const executorch_flatbuffer::Program* internal_program,
-      FreeableBuffer&& constant_segment_data)
+      FreeableBuffer&& constant_segment_data,
+      bool lazy_constants = false,
+      bool streamed_constants = false)
       : program_data_(std::move(program_data)),
         // Don't need the loader if there are no segments.
         loader_(segment_base_offset > 0 ? loader : nullptr),
         internal_program_(internal_program),
         segment_base_offset_(segment_base_offset),
-        constant_segment_data_(std::move(constant_segment_data)) {}
+        constant_segment_data_(std::move(constant_segment_data)),
+        lazy_constants_(lazy_constants),
+        streamed_constants_(streamed_constants),
+        named_data_(internal_program, loader_, segment_base_offset) {}
 
   // Not copyable or assignable.
   Program(const Program& rhs) = delete;
@@ -287,8 +464,19 @@ class Program final {
   /// be present in internal_program_.
   size_t segment_base_offset_;
 
-  /// Constant segment data.
+  /// Constant segment data. Empty if there is no constant segment or if it is
+  /// loaded lazily.
   FreeableBuffer constant_segment_data_;
+
+  /// True if the constant segment is loaded one tensor at a time by methods.
+  bool lazy_constants_;
+
+  /// True if Methods also release the data of constants between the
+  /// instructions that use them. Implies lazy_constants_.
+  bool streamed_constants_;
+
+  /// The data that delegates look up by key.
+  NamedDataTable named_data_;
 };
 
 } // namespace runtime
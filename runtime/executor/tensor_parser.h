@@ -10,6 +10,7 @@
 
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/named_data_map.h>
 #include <executorch/runtime/executor/memory_manager.h>
 #include <executorch/runtime/executor/program.h>
 #include <executorch/schema/program_generated.h>
@@ -18,10 +19,125 @@ namespace executorch {
 namespace runtime {
 namespace deserialization {
 
+/**
+ * Storage for the mutable sizes and the strides of the tensors of a method,
+ * allocated as two contiguous arrays instead of as a few small lists per
+ * tensor. Static tensors with the same sizes and dim order share their
+ * strides. Dim orders are never written to, so they point into the Program.
+ *
+ * Use it in two passes over the same tensors, in the same order: reserve()
+ * each of them, allocate(), then pass the arena to parseTensor() for each of
+ * them. In ATen mode, where the parser does not construct TensorImpls, the
+ * arena stays empty.
+ */
+class TensorMetadataArena final {
+ public:
+  /**
+   * @param[in] temp_allocator Scratch space for finding static tensors with
+   *     the same shape, which must stay valid until the last tensor is parsed.
+   *     If null, or if it runs out of memory, no strides are shared.
+   * @param[in] max_num_tensors The largest number of tensors that will be
+   *     reserved.
+   */
+  TensorMetadataArena(MemoryAllocator* temp_allocator, size_t max_num_tensors);
+
+  /// Counts the metadata that parseTensor() will need for `s_tensor`.
+  void reserve(const executorch_flatbuffer::Tensor* s_tensor);
+
+  /// Allocates the metadata of all reserved tensors from `method_allocator`.
+  ET_NODISCARD Error allocate(MemoryAllocator* method_allocator);
+
+  /// The number of strides elements that allocate() allocates.
+  size_t num_strides() const {
+    return num_shared_strides_ + num_own_strides_;
+  }
+
+  /**
+   * Returns the next `dim` elements of the sizes storage, or nullptr if they
+   * were not reserved. For parseTensor().
+   */
+  executorch::aten::SizesType* take_sizes(size_t dim);
+
+  /**
+   * Returns the strides storage of `s_tensor`, or nullptr if it was not
+   * reserved. Sets `initialized` to whether an earlier tensor sharing the
+   * storage has already filled it in. For parseTensor().
+   */
+  executorch::aten::StridesType* take_strides(
+      const executorch_flatbuffer::Tensor* s_tensor,
+      bool* initialized);
+
+ private:
+  /// A slot of the open-addressing table of shared strides.
+  struct SharedStrides {
+    /// The key; an empty slot has null sizes.
+    const int32_t* sizes;
+    const uint8_t* dim_order;
+    size_t dim;
+    /// Index of the strides in the shared part of the storage.
+    size_t offset;
+    bool initialized;
+  };
+
+  SharedStrides* find(const executorch_flatbuffer::Tensor* s_tensor);
+
+  SharedStrides* table_ = nullptr;
+  size_t table_capacity_ = 0;
+
+  size_t num_sizes_ = 0;
+  size_t num_shared_strides_ = 0;
+  size_t num_own_strides_ = 0;
+
+  executorch::aten::SizesType* sizes_ = nullptr;
+  /// The shared strides, followed by those of tensors that don't share.
+  executorch::aten::StridesType* strides_ = nullptr;
+  size_t next_sizes_ = 0;
+  size_t next_own_strides_ = 0;
+};
+
+/**
+ * Deserializes `s_tensor`.
+ *
+ * @param[in] constant_data If `s_tensor` is a constant whose data is loaded
+ *     lazily from the program or from `named_data_map`, an empty
+ *     FreeableBuffer that takes ownership of the tensor's data. It must
+ *     outlive the returned Tensor. May be null otherwise. If it is null for a
+ *     constant of a Program with streamed constants, the tensor has no data.
+ * @param[in] mutable_load If `s_tensor` is memory-planned with initial data,
+ *     and this is non-null, the read of the initial data is described here
+ *     instead of being performed, so that the caller can batch it with others.
+ * @param[in] tensor_impl If non-null, uninitialized storage from
+ *     allocateTensorImpls() to construct the tensor's TensorImpl in, instead
+ *     of allocating it from the method allocator.
+ * @param[in] named_data_map The data of tensors that are stored outside of
+ *     the program. Required if `s_tensor` is external.
+ * @param[in] metadata_arena If non-null, an allocated arena that `s_tensor`
+ *     was reserved in, to take the tensor's sizes and strides from instead of
+ *     allocating them from the method allocator.
+ */
 ET_NODISCARD Result<executorch::aten::Tensor> parseTensor(
     const Program* program,
     MemoryManager* memory_manager,
-    const executorch_flatbuffer::Tensor* s_tensor);
+    const executorch_flatbuffer::Tensor* s_tensor,
+    FreeableBuffer* constant_data = nullptr,
+    DataLoader::LoadIntoRequest* mutable_load = nullptr,
+    executorch::aten::TensorImpl* tensor_impl = nullptr,
+    const NamedDataMap* named_data_map = nullptr,
+    TensorMetadataArena* metadata_arena = nullptr);
+
+/**
+ * Allocates uninitialized storage for `num_tensors` TensorImpls as one
+ * contiguous array, for the tensors of a method to be constructed in with
+ * parseTensor(). Keeping the impls next to each other, rather than between
+ * the sizes and strides of each tensor, lets the metadata of tensors used by
+ * neighboring instructions share cache lines.
+ *
+ * @returns The storage, or nullptr if the TensorImpls are not constructed by
+ *     the parser, as in ATen mode, or if `num_tensors` is zero.
+ */
+ET_NODISCARD Result<executorch::aten::TensorImpl*> allocateTensorImpls(
+    MemoryAllocator* allocator,
+    size_t num_tensors);
 
 ET_NODISCARD Result<BoxedEvalueList<executorch::aten::Tensor>> parseTensorList(
     const flatbuffers::Vector<int32_t>* tensor_indices,
@@ -89,10 +205,23 @@ parseListOptionalType(
  * - constant_buffer = 0, allocation_info = Non Null: Non-constant Tensor.
  * - constant_buffer = 0, allocation_info = Null: Input/placeholder Tensor.
  *
+ * The data of an external tensor is instead looked up by its fully qualified
+ * name in `named_data_map`: a constant external tensor points to it, and a
+ * memory-planned one is initialized with a copy of it.
+ *
  * @param[in] s_tensor The tensor to find the data pointer for.
  * @param[in] program The Program to use for constant buffer data.
  * @param[in] nbytes The amount of memory to get from the allocator.
  * @param[in] allocator The source of memory for non-constant tensors.
+ * @param[in] constant_data If `s_tensor` is a constant whose data is loaded
+ *     lazily from the program or from `named_data_map`, an empty
+ *     FreeableBuffer that takes ownership of the loaded data. May be null
+ *     otherwise. If it is null for a constant of a Program with streamed
+ *     constants, the returned pointer is null.
+ * @param[in] mutable_load If non-null, the read of a memory-planned tensor's
+ *     initial data is described here instead of being performed.
+ * @param[in] named_data_map The data of tensors that are stored outside of
+ *     the program. Required if `s_tensor` is external.
  *
  * @returns On success, the data pointer to use for the tensor. On failure, a
  *     non-Ok Error.
@@ -101,7 +230,48 @@ ET_NODISCARD Result<void*> getTensorDataPtr(
     const executorch_flatbuffer::Tensor* s_tensor,
     const Program* program,
     size_t nbytes,
-    HierarchicalAllocator* allocator);
+    HierarchicalAllocator* allocator,
+    FreeableBuffer* constant_data = nullptr,
+    DataLoader::LoadIntoRequest* mutable_load = nullptr,
+    const NamedDataMap* named_data_map = nullptr);
+
+/**
+ * Returns true if the data of `s_tensor` is stored outside of the Program,
+ * and is looked up by its fully qualified name in a NamedDataMap.
+ */
+inline bool isExternalTensor(const executorch_flatbuffer::Tensor* s_tensor) {
+  return s_tensor->extra_tensor_info() != nullptr &&
+      s_tensor->extra_tensor_info()->location() ==
+      executorch_flatbuffer::TensorDataLocation::EXTERNAL;
+}
+
+/**
+ * Returns true if `s_tensor` is memory-planned and has initial data that is
+ * loaded from a mutable segment.
+ */
+inline bool hasMutableInitialData(
+    const executorch_flatbuffer::Tensor* s_tensor) {
+  return s_tensor->data_buffer_idx() > 0 &&
+      s_tensor->allocation_info() != nullptr && !isExternalTensor(s_tensor);
+}
+
+/**
+ * Returns true if `s_tensor` is a constant tensor, whose data lives in the
+ * Program.
+ */
+inline bool isConstantTensor(const executorch_flatbuffer::Tensor* s_tensor) {
+  return s_tensor->data_buffer_idx() > 0 &&
+      s_tensor->allocation_info() == nullptr && !isExternalTensor(s_tensor);
+}
+
+/**
+ * Returns true if `s_tensor` is a constant tensor, whose data is looked up in
+ * a NamedDataMap.
+ */
+inline bool isExternalConstantTensor(
+    const executorch_flatbuffer::Tensor* s_tensor) {
+  return isExternalTensor(s_tensor) && s_tensor->allocation_info() == nullptr;
+}
 
 } // namespace deserialization
 } // namespace runtime
@@ -31,7 +31,15 @@ void deleteNothing(void*) {}
 Result<at::Tensor> parseTensor(
     const Program* program,
     MemoryManager* memory_manager,
-    const executorch_flatbuffer::Tensor* s_tensor) {
+    const executorch_flatbuffer::Tensor* s_tensor,
+    FreeableBuffer* constant_data,
+    DataLoader::LoadIntoRequest* mutable_load,
+    at::TensorImpl* tensor_impl,
+    const NamedDataMap* named_data_map,
+    TensorMetadataArena* metadata_arena) {
+  // at::Tensors own their impls and metadata.
+  (void)tensor_impl;
+  (void)metadata_arena;
   EXECUTORCH_SCOPE_PROF("TensorParser::parseTensor");
 
   ET_CHECK_OR_RETURN_ERROR(
@@ -102,7 +110,13 @@ Result<at::Tensor> parseTensor(
   } else {
     // Now that we know how big the tensor is, find and assign its memory.
     Result<void*> data_ptr = getTensorDataPtr(
-        s_tensor, program, tensor.nbytes(), memory_manager->planned_memory());
+        s_tensor,
+        program,
+        tensor.nbytes(),
+        memory_manager->planned_memory(),
+        constant_data,
+        mutable_load,
+        named_data_map);
     if (!data_ptr.ok()) {
       ET_LOG(
           Error,
@@ -117,6 +131,44 @@ Result<at::Tensor> parseTensor(
   return tensor;
 }
 
+Result<at::TensorImpl*> allocateTensorImpls(
+    MemoryAllocator* allocator,
+    size_t num_tensors) {
+  (void)allocator;
+  (void)num_tensors;
+  return nullptr;
+}
+
+TensorMetadataArena::TensorMetadataArena(
+    MemoryAllocator* temp_allocator,
+    size_t max_num_tensors) {
+  (void)temp_allocator;
+  (void)max_num_tensors;
+}
+
+void TensorMetadataArena::reserve(
+    const executorch_flatbuffer::Tensor* s_tensor) {
+  (void)s_tensor;
+}
+
+Error TensorMetadataArena::allocate(MemoryAllocator* method_allocator) {
+  (void)method_allocator;
+  return Error::Ok;
+}
+
+executorch::aten::SizesType* TensorMetadataArena::take_sizes(size_t dim) {
+  (void)dim;
+  return nullptr;
+}
+
+executorch::aten::StridesType* TensorMetadataArena::take_strides(
+    const executorch_flatbuffer::Tensor* s_tensor,
+    bool* initialized) {
+  (void)s_tensor;
+  *initialized = false;
+  return nullptr;
+}
+
 } // namespace deserialization
 } // namespace runtime
 } // namespace executorch
@@ -31,6 +31,32 @@ class TensorParser final {
     return program->load_mutable_subsegment_into(
         mutable_data_segments_index, offset_index, size, buffer);
   }
+
+  ET_NODISCARD static Error get_mutable_subsegment_request(
+      const Program* program,
+      size_t mutable_data_segments_index,
+      size_t offset_index,
+      size_t size,
+      void* buffer,
+      DataLoader::LoadIntoRequest* out_request) {
+    return program->get_mutable_subsegment_request(
+        mutable_data_segments_index, offset_index, size, buffer, out_request);
+  }
+
+  static bool has_lazy_constants(const Program* program) {
+    return program->has_lazy_constants();
+  }
+
+  static bool has_streamed_constants(const Program* program) {
+    return program->has_streamed_constants();
+  }
+
+  ET_NODISCARD static Result<FreeableBuffer> load_constant_data(
+      const Program* program,
+      size_t buffer_index,
+      size_t nbytes) {
+    return program->load_constant_data(buffer_index, nbytes);
+  }
 };
 
 namespace {
@@ -66,6 +92,50 @@ ET_NODISCARD Result<void*> getMemPlannedPtr(
   }
   return allocator->get_offset_address(memory_id, memory_offset, nbytes);
 }
+
+// Checks that the external data of `s_tensor` has the layout that the
+// program expects.
+ET_NODISCARD Error validateExternalLayout(
+    const executorch_flatbuffer::Tensor* s_tensor,
+    const char* fqn,
+    const TensorLayout& layout,
+    size_t nbytes) {
+  ET_CHECK_OR_RETURN_ERROR(
+      static_cast<int8_t>(layout.scalar_type()) == s_tensor->scalar_type(),
+      InvalidExternalData,
+      "External tensor '%s' has scalar type %" PRId8 ", expected %" PRId8,
+      fqn,
+      static_cast<int8_t>(layout.scalar_type()),
+      s_tensor->scalar_type());
+  ET_CHECK_OR_RETURN_ERROR(
+      layout.nbytes() == nbytes,
+      InvalidExternalData,
+      "External tensor '%s' has %zu bytes, expected %zu",
+      fqn,
+      layout.nbytes(),
+      nbytes);
+  const auto* sizes = s_tensor->sizes();
+  const auto* dim_order = s_tensor->dim_order();
+  ET_CHECK_OR_RETURN_ERROR(
+      sizes != nullptr && dim_order != nullptr &&
+          layout.sizes().size() == sizes->size() &&
+          layout.dim_order().size() == dim_order->size(),
+      InvalidExternalData,
+      "External tensor '%s' has %zu dims, expected %" PRIu32,
+      fqn,
+      layout.sizes().size(),
+      sizes == nullptr ? 0 : sizes->size());
+  for (size_t i = 0; i < layout.sizes().size(); ++i) {
+    ET_CHECK_OR_RETURN_ERROR(
+        layout.sizes()[i] == sizes->Get(i) &&
+            layout.dim_order()[i] == dim_order->Get(i),
+        InvalidExternalData,
+        "External tensor '%s' differs in size or dim order at dim %zu",
+        fqn,
+        i);
+  }
+  return Error::Ok;
+}
 } // namespace
 
 ET_NODISCARD Result<BoxedEvalueList<exec_aten::Tensor>> parseTensorList(
@@ -106,19 +176,106 @@ ET_NODISCARD Result<void*> getTensorDataPtr(
     const executorch_flatbuffer::Tensor* s_tensor,
     const Program* program,
     size_t nbytes,
-    HierarchicalAllocator* allocator) {
+    HierarchicalAllocator* allocator,
+    FreeableBuffer* constant_data,
+    DataLoader::LoadIntoRequest* mutable_load,
+    const NamedDataMap* named_data_map) {
   auto data_buffer_idx = s_tensor->data_buffer_idx();
   const executorch_flatbuffer::AllocationDetails* allocation_info =
       s_tensor->allocation_info();
 
+  // Stored outside of the program. data_buffer_idx is ignored.
+  if (isExternalTensor(s_tensor)) {
+    const auto* fqn = s_tensor->extra_tensor_info()->fully_qualified_name();
+    ET_CHECK_OR_RETURN_ERROR(
+        fqn != nullptr && fqn->size() > 0,
+        InvalidProgram,
+        "External tensor has no fully qualified name");
+    const char* key = fqn->c_str();
+    ET_CHECK_OR_RETURN_ERROR(
+        named_data_map != nullptr,
+        InvalidArgument,
+        "No NamedDataMap to load external tensor '%s' from",
+        key);
+    auto layout = named_data_map->get_metadata(key);
+    if (!layout.ok()) {
+      ET_LOG(
+          Error,
+          "Failed to get metadata of external tensor '%s': 0x%" PRIx32,
+          key,
+          static_cast<uint32_t>(layout.error()));
+      return layout.error();
+    }
+    auto err = validateExternalLayout(s_tensor, key, layout.get(), nbytes);
+    if (err != Error::Ok) {
+      return err;
+    }
+
+    // Constant: point to the data, which may be shared with other programs.
+    if (allocation_info == nullptr) {
+      ET_CHECK_OR_RETURN_ERROR(
+          constant_data != nullptr,
+          InvalidArgument,
+          "No buffer to hold external constant '%s'",
+          key);
+      if (nbytes == 0) {
+        return nullptr;
+      }
+      auto data = named_data_map->get_data(key);
+      if (!data.ok()) {
+        ET_LOG(
+            Error,
+            "Failed to get data of external tensor '%s': 0x%" PRIx32,
+            key,
+            static_cast<uint32_t>(data.error()));
+        return data.error();
+      }
+      ET_CHECK_OR_RETURN_ERROR(
+          data->size() >= nbytes,
+          InvalidExternalData,
+          "External tensor '%s' has %zu bytes of data, expected %zu",
+          key,
+          data->size(),
+          nbytes);
+      // constant_data is empty, so overwriting it doesn't leak anything.
+      new (constant_data) FreeableBuffer(std::move(data.get()));
+      return const_cast<void*>(constant_data->data());
+    }
+
+    // Memory planned: initialize with a copy of the data.
+    auto planned_ptr = getMemPlannedPtr(allocation_info, nbytes, allocator);
+    if (!planned_ptr.ok()) {
+      return planned_ptr.error();
+    }
+    auto loaded =
+        named_data_map->load_data_into(key, planned_ptr.get(), nbytes);
+    if (!loaded.ok()) {
+      return loaded.error();
+    }
+    return planned_ptr;
+  }
+
   // Memory Planned, with initial state
   if (data_buffer_idx > 0 && allocation_info != nullptr) {
     auto planned_ptr = getMemPlannedPtr(allocation_info, nbytes, allocator);
     if (!planned_ptr.ok()) {
       return planned_ptr.error();
     }
-    auto err = TensorParser::load_mutable_subsegment_into(
-        program, 0, s_tensor->data_buffer_idx(), nbytes, planned_ptr.get());
+    // When the caller batches the loads, only describe this one.
+    auto err = mutable_load != nullptr
+        ? TensorParser::get_mutable_subsegment_request(
+              program,
+              0,
+              s_tensor->data_buffer_idx(),
+              nbytes,
+              planned_ptr.get(),
+              mutable_load)
+        : TensorParser::load_mutable_subsegment_into(
+              program,
+              0,
+              s_tensor->data_buffer_idx(),
+              nbytes,
+              planned_ptr.get());
 
     if (err != Error::Ok) {
       return err;
@@ -127,6 +284,31 @@ ET_NODISCARD Result<void*> getTensorDataPtr(
 
     // Constant
   } else if (data_buffer_idx > 0 && allocation_info == nullptr) {
+    if (TensorParser::has_lazy_constants(program)) {
+      if (constant_data == nullptr &&
+          TensorParser::has_streamed_constants(program)) {
+        // The Method points the tensor at its data in the constant scratch
+        // around each instruction that uses it.
+        return nullptr;
+      }
+      ET_CHECK_OR_RETURN_ERROR(
+          constant_data != nullptr,
+          InvalidArgument,
+          "No buffer to hold lazily-loaded constant %" PRIu32,
+          data_buffer_idx);
+      if (nbytes == 0) {
+        return nullptr;
+      }
+      auto loaded = TensorParser::load_constant_data(
+          program, data_buffer_idx, nbytes);
+      if (!loaded.ok()) {
+        return loaded.error();
+      }
+      // constant_data is empty, so overwriting it doesn't leak anything.
+      new (constant_data) FreeableBuffer(std::move(loaded.get()));
+      return const_cast<void*>(constant_data->data());
+    }
+
     auto const_data =
         program->get_constant_buffer_data(data_buffer_idx, nbytes);
     if (!const_data.ok()) {
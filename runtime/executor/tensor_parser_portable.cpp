@@ -8,6 +8,8 @@
 
 #include <executorch/runtime/executor/tensor_parser.h>
 
+#include <cstring>
+
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/core/exec_aten/util/dim_order_util.h>
 #include <executorch/runtime/core/exec_aten/util/scalar_type_util.h>
@@ -27,7 +29,12 @@ using torch::executor::TensorImpl;
 Result<Tensor> parseTensor(
     const Program* program,
     MemoryManager* memory_manager,
-    const executorch_flatbuffer::Tensor* s_tensor) {
+    const executorch_flatbuffer::Tensor* s_tensor,
+    FreeableBuffer* constant_data,
+    DataLoader::LoadIntoRequest* mutable_load,
+    TensorImpl* tensor_impl,
+    const NamedDataMap* named_data_map,
+    TensorMetadataArena* metadata_arena) {
   EXECUTORCH_SCOPE_PROF("TensorParser::parseTensor");
   auto method_allocator = memory_manager->method_allocator();
 
@@ -74,47 +81,62 @@ Result<Tensor> parseTensor(
       dim);
   const auto serialized_dim_order = s_tensor->dim_order()->data();
 
+  // Dim orders are never written to, even those of dynamic shape tensors, so
+  // they can point into the flatbuffer. Const cast safe here for that reason.
+  exec_aten::DimOrderType* dim_order =
+      const_cast<exec_aten::DimOrderType*>(serialized_dim_order);
   exec_aten::SizesType* sizes = nullptr;
-  exec_aten::DimOrderType* dim_order = nullptr;
   // For dynamic shape tensors, allocate local buffers to allow mutable sizes
   // and strides
   if (dynamism != TensorShapeDynamism::STATIC) {
-    // copy sizes and dim order out of flatbuffer
-    // kimishpate: I think dim order can remain immutable and point to fb
-    // memory, unless we plan to implement in-place permute
-    exec_aten::SizesType* sizes_buf = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-        method_allocator, exec_aten::SizesType, dim);
-    exec_aten::DimOrderType* dim_order_buf = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-        method_allocator, exec_aten::DimOrderType, dim);
+    // copy sizes out of flatbuffer
+    exec_aten::SizesType* sizes_buf = nullptr;
+    if (metadata_arena != nullptr) {
+      sizes_buf = metadata_arena->take_sizes(dim);
+      ET_CHECK_OR_RETURN_ERROR(
+          sizes_buf != nullptr || dim == 0,
+          Internal,
+          "Tensor sizes were not reserved");
+    } else {
+      sizes_buf = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+          method_allocator, exec_aten::SizesType, dim);
+    }
     std::memcpy(
         sizes_buf, serialized_sizes, sizeof(exec_aten::SizesType) * dim);
-    std::memcpy(
-        dim_order_buf,
-        serialized_dim_order,
-        sizeof(exec_aten::DimOrderType) * dim);
-
     sizes = sizes_buf;
-    dim_order = dim_order_buf;
   } else {
     // Const cast safe here as these tensors can't be resized, so these fields
     // will not be modified.
     sizes = const_cast<exec_aten::SizesType*>(serialized_sizes);
-    dim_order = const_cast<exec_aten::DimOrderType*>(serialized_dim_order);
   }
   // We will remove strides from schema.
   // Allocating strides buffer here and populating it.
   // In subsequent diffs we can remove strides accessor, however this
   // will introduce incompatible APIs between ATen Tensor and ETensor.
-  exec_aten::StridesType* strides = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
-      method_allocator, exec_aten::StridesType, dim);
-  auto status = dim_order_to_stride(sizes, dim_order, dim, strides);
-  ET_CHECK_OR_RETURN_ERROR(
-      status == Error::Ok,
-      Internal,
-      "dim_order_to_stride returned invalid status");
+  exec_aten::StridesType* strides = nullptr;
+  bool strides_initialized = false;
+  if (metadata_arena != nullptr) {
+    strides = metadata_arena->take_strides(s_tensor, &strides_initialized);
+    ET_CHECK_OR_RETURN_ERROR(
+        strides != nullptr || dim == 0,
+        Internal,
+        "Tensor strides were not reserved");
+  } else {
+    strides = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+        method_allocator, exec_aten::StridesType, dim);
+  }
+  if (!strides_initialized) {
+    auto status = dim_order_to_stride(sizes, dim_order, dim, strides);
+    ET_CHECK_OR_RETURN_ERROR(
+        status == Error::Ok,
+        Internal,
+        "dim_order_to_stride returned invalid status");
+  }
 
-  auto* tensor_impl =
-      ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(method_allocator, TensorImpl);
+  if (tensor_impl == nullptr) {
+    tensor_impl =
+        ET_ALLOCATE_INSTANCE_OR_RETURN_ERROR(method_allocator, TensorImpl);
+  }
   // Placement new on the allocated memory space. Note that we create this first
   // with null data so we can find its expected size before getting its memory.
   new (tensor_impl) TensorImpl(
@@ -131,7 +153,10 @@ Result<Tensor> parseTensor(
       s_tensor,
       program,
       tensor_impl->nbytes(),
-      memory_manager->planned_memory());
+      memory_manager->planned_memory(),
+      constant_data,
+      mutable_load,
+      named_data_map);
   if (!data_ptr.ok()) {
     ET_LOG(
         Error,
@@ -144,6 +169,152 @@ Result<Tensor> parseTensor(
   return Tensor(tensor_impl);
 }
 
+Result<TensorImpl*> allocateTensorImpls(
+    MemoryAllocator* allocator,
+    size_t num_tensors) {
+  if (num_tensors == 0) {
+    return nullptr;
+  }
+  return ET_ALLOCATE_LIST_OR_RETURN_ERROR(allocator, TensorImpl, num_tensors);
+}
+
+namespace {
+// FNV-1a, over the bytes of a tensor's shape.
+uint64_t hash_bytes(uint64_t hash, const void* data, size_t nbytes) {
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < nbytes; ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  return hash;
+}
+} // namespace
+
+TensorMetadataArena::TensorMetadataArena(
+    MemoryAllocator* temp_allocator,
+    size_t max_num_tensors) {
+  if (temp_allocator == nullptr || max_num_tensors == 0) {
+    return;
+  }
+  // Keep the table at most half full so that probe sequences stay short.
+  size_t capacity = 1;
+  while (capacity < 2 * max_num_tensors) {
+    capacity *= 2;
+  }
+  table_ = temp_allocator->allocateList<SharedStrides>(capacity);
+  if (table_ == nullptr) {
+    // Not fatal: every tensor gets its own strides instead.
+    ET_LOG(Debug, "No temp memory to share tensor strides");
+    return;
+  }
+  for (size_t i = 0; i < capacity; ++i) {
+    table_[i].sizes = nullptr;
+  }
+  table_capacity_ = capacity;
+}
+
+TensorMetadataArena::SharedStrides* TensorMetadataArena::find(
+    const executorch_flatbuffer::Tensor* s_tensor) {
+  const auto s_sizes = s_tensor->sizes();
+  const auto s_dim_order = s_tensor->dim_order();
+  if (table_ == nullptr || s_sizes == nullptr || s_dim_order == nullptr ||
+      s_dim_order->size() != s_sizes->size()) {
+    // Malformed tensors fail to parse; don't let them share anything.
+    return nullptr;
+  }
+  const size_t dim = s_sizes->size();
+  const int32_t* sizes = s_sizes->data();
+  const uint8_t* dim_order = s_dim_order->data();
+  uint64_t hash = hash_bytes(14695981039346656037ULL, &dim, sizeof(dim));
+  hash = hash_bytes(hash, sizes, dim * sizeof(int32_t));
+  hash = hash_bytes(hash, dim_order, dim);
+
+  const size_t mask = table_capacity_ - 1;
+  for (size_t i = hash & mask, probe = 0; probe < table_capacity_;
+       i = (i + 1) & mask, ++probe) {
+    SharedStrides& entry = table_[i];
+    if (entry.sizes == nullptr ||
+        (entry.dim == dim &&
+         std::memcmp(entry.sizes, sizes, dim * sizeof(int32_t)) == 0 &&
+         std::memcmp(entry.dim_order, dim_order, dim) == 0)) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+void TensorMetadataArena::reserve(
+    const executorch_flatbuffer::Tensor* s_tensor) {
+  if (s_tensor->sizes() == nullptr) {
+    return;
+  }
+  const size_t dim = s_tensor->sizes()->size();
+  if (static_cast<TensorShapeDynamism>(s_tensor->shape_dynamism()) !=
+      TensorShapeDynamism::STATIC) {
+    // Resizing writes to the sizes and strides, so they can't be shared.
+    num_sizes_ += dim;
+    num_own_strides_ += dim;
+    return;
+  }
+  SharedStrides* entry = find(s_tensor);
+  if (entry == nullptr) {
+    num_own_strides_ += dim;
+  } else if (entry->sizes == nullptr) {
+    entry->sizes = s_tensor->sizes()->data();
+    entry->dim_order = s_tensor->dim_order()->data();
+    entry->dim = dim;
+    entry->offset = num_shared_strides_;
+    entry->initialized = false;
+    num_shared_strides_ += dim;
+  }
+}
+
+Error TensorMetadataArena::allocate(MemoryAllocator* method_allocator) {
+  sizes_ = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+      method_allocator, exec_aten::SizesType, num_sizes_);
+  strides_ = ET_ALLOCATE_LIST_OR_RETURN_ERROR(
+      method_allocator, exec_aten::StridesType, num_strides());
+  return Error::Ok;
+}
+
+exec_aten::SizesType* TensorMetadataArena::take_sizes(size_t dim) {
+  if (sizes_ == nullptr || next_sizes_ + dim > num_sizes_) {
+    return nullptr;
+  }
+  exec_aten::SizesType* sizes = sizes_ + next_sizes_;
+  next_sizes_ += dim;
+  return sizes;
+}
+
+exec_aten::StridesType* TensorMetadataArena::take_strides(
+    const executorch_flatbuffer::Tensor* s_tensor,
+    bool* initialized) {
+  *initialized = false;
+  if (strides_ == nullptr || s_tensor->sizes() == nullptr) {
+    return nullptr;
+  }
+  if (static_cast<TensorShapeDynamism>(s_tensor->shape_dynamism()) ==
+      TensorShapeDynamism::STATIC) {
+    SharedStrides* entry = find(s_tensor);
+    if (entry != nullptr) {
+      if (entry->sizes == nullptr) {
+        return nullptr;
+      }
+      *initialized = entry->initialized;
+      // The caller fills them in before the next tensor is parsed.
+      entry->initialized = true;
+      return strides_ + entry->offset;
+    }
+  }
+  const size_t dim = s_tensor->sizes()->size();
+  if (next_own_strides_ + dim > num_own_strides_) {
+    return nullptr;
+  }
+  exec_aten::StridesType* strides =
+      strides_ + num_shared_strides_ + next_own_strides_;
+  next_own_strides_ += dim;
+  return strides;
+}
+
 } // namespace deserialization
 } // namespace runtime
 } // namespace executorch
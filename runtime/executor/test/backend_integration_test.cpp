@@ -32,6 +32,7 @@ using exec_aten::ArrayRef;
 using executorch::runtime::BackendExecutionContext;
 using executorch::runtime::BackendInitContext;
 using executorch::runtime::BackendInterface;
+using executorch::runtime::BackendOption;
 using executorch::runtime::CompileSpec;
 using executorch::runtime::DataLoader;
 using executorch::runtime::DelegateHandle;
@@ -40,8 +41,10 @@ using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::MemoryAllocator;
 using executorch::runtime::Method;
+using executorch::runtime::ParallelRunner;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
 using executorch::runtime::testing::ManagedMemoryManager;
 using torch::executor::util::FileDataLoader;
 
@@ -59,6 +62,8 @@ class StubBackend final : public BackendInterface {
   using ExecuteFn =
       std::function<Error(BackendExecutionContext&, DelegateHandle*, EValue**)>;
   using DestroyFn = std::function<void(DelegateHandle*)>;
+  using SetOptionFn =
+      std::function<Error(DelegateHandle*, Span<const BackendOption>)>;
 
   // Default name that this backend is registered as.
   static constexpr char kName[] = "StubBackend";
@@ -115,6 +120,18 @@ class StubBackend final : public BackendInterface {
     }
   }
 
+  void install_set_option(SetOptionFn fn) {
+    set_option_fn_ = fn;
+  }
+
+  Error set_option(DelegateHandle* handle, Span<const BackendOption> options)
+      const override {
+    if (set_option_fn_) {
+      return set_option_fn_.value()(handle, options);
+    }
+    return Error::NotSupported;
+  }
+
   /**
    * Resets to the original constructed state.
    */
@@ -123,6 +140,7 @@ class StubBackend final : public BackendInterface {
     init_fn_.reset();
     execute_fn_.reset();
     destroy_fn_.reset();
+    set_option_fn_.reset();
   }
 
   /**
@@ -155,6 +173,7 @@ class StubBackend final : public BackendInterface {
   std::optional<InitFn> init_fn_;
   std::optional<ExecuteFn> execute_fn_;
   std::optional<DestroyFn> destroy_fn_;
+  std::optional<SetOptionFn> set_option_fn_;
 };
 
 bool StubBackend::registered_ = false;
@@ -572,6 +591,171 @@ TEST_P(BackendIntegrationTest, GetMethodNameDuringExecuteSuccess) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_P(BackendIntegrationTest, SetDelegateOptionsReachesEveryDelegate) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  // Use the processed data as the handle, to tell the delegates apart.
+  StubBackend::singleton().install_init(
+      [&](FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          ET_UNUSED BackendInitContext& backend_init_context)
+          -> Result<DelegateHandle*> {
+        return const_cast<void*>(processed->data());
+      });
+  std::vector<DelegateHandle*> handles;
+  StubBackend::singleton().install_set_option(
+      [&](DelegateHandle* handle, Span<const BackendOption> options) -> Error {
+        EXPECT_EQ(options.size(), 1);
+        EXPECT_STREQ(options[0].key(), "num_threads");
+        EXPECT_EQ(options[0].toInt(), 2);
+        handles.push_back(handle);
+        return Error::Ok;
+      });
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  BackendOption options[] = {{"num_threads", 2}};
+  Error err = method->set_delegate_options("StubBackend", {options, 1});
+  ASSERT_EQ(err, Error::Ok);
+  // The program has at least one delegate, and each gets its own call.
+  ASSERT_GT(handles.size(), 0);
+  for (DelegateHandle* handle : handles) {
+    EXPECT_NE(handle, nullptr);
+  }
+
+  // The backend itself gets a null handle.
+  handles.clear();
+  err = executorch::runtime::set_backend_options("StubBackend", {options, 1});
+  ASSERT_EQ(err, Error::Ok);
+  ASSERT_EQ(handles.size(), 1);
+  EXPECT_EQ(handles[0], nullptr);
+
+  // Other backends are not found.
+  EXPECT_EQ(
+      method->set_delegate_options("NotABackend", {options, 1}),
+      Error::NotFound);
+  EXPECT_EQ(
+      executorch::runtime::set_backend_options("NotABackend", {options, 1}),
+      Error::NotFound);
+}
+
+TEST_P(BackendIntegrationTest, LastDelegateCallIsNotFollowedBySameBackend) {
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  size_t num_calls = 0;
+  StubBackend::singleton().install_execute(
+      [&](BackendExecutionContext& backend_execution_context,
+          ET_UNUSED DelegateHandle* handle,
+          ET_UNUSED EValue** args) -> Error {
+        // The only delegate call of the method must wait for its results.
+        EXPECT_FALSE(backend_execution_context.is_followed_by_same_backend());
+        num_calls++;
+        return Error::Ok;
+      });
+  Result<Program> program = Program::load(&loader.get());
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  EXPECT_TRUE(method.ok());
+  Error err = method->execute();
+  ASSERT_EQ(err, Error::Ok);
+  EXPECT_EQ(num_calls, 1);
+}
+
+TEST_P(BackendIntegrationTest, WaveExecutionOnlyHintsCallsThatRunNext) {
+  // Runs the tasks in order on the calling thread.
+  class InOrderRunner final : public ParallelRunner {
+   public:
+    void run(TaskFunction fn, void* context, size_t num_tasks) override {
+      for (size_t i = 0; i < num_tasks; ++i) {
+        fn(context, i);
+      }
+    }
+  };
+
+  // Two adds lowered to delegate calls of their own, and a sub kernel that
+  // reads the output of the first add alongside the second add.
+  const char* path = std::getenv(
+      using_segments() ? "ET_MODULE_ADD_CHAIN_AND_SUB_PATH"
+                       : "ET_MODULE_ADD_CHAIN_AND_SUB_NOSEGMENTS_PATH");
+  ASSERT_NE(path, nullptr);
+  Result<FileDataLoader> loader = FileDataLoader::from(path);
+  ASSERT_EQ(loader.error(), Error::Ok);
+  std::vector<bool> hints;
+  StubBackend::singleton().install_execute(
+      [&](BackendExecutionContext& backend_execution_context,
+          ET_UNUSED DelegateHandle* handle,
+          ET_UNUSED EValue** args) -> Error {
+        hints.push_back(
+            backend_execution_context.is_followed_by_same_backend());
+        return Error::Ok;
+      });
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  // Run in program order, the first add is followed by the second.
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(hints, std::vector<bool>({true, false}));
+
+  // In waves, the second add runs alongside the sub, which needs the output
+  // of the first add to be ready.
+  InOrderRunner runner;
+  ASSERT_EQ(method->set_parallel_runner(&runner), Error::Ok);
+  hints.clear();
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(hints, std::vector<bool>({false, false}));
+}
+
+TEST_P(BackendIntegrationTest, InitRunnerInitializesEveryDelegate) {
+  // Runs the tasks in order on the calling thread, counting them.
+  class CountingRunner final : public ParallelRunner {
+   public:
+    void run(TaskFunction fn, void* context, size_t num_tasks) override {
+      num_tasks_ += num_tasks;
+      for (size_t i = 0; i < num_tasks; ++i) {
+        fn(context, i);
+      }
+    }
+    size_t num_tasks_ = 0;
+  };
+
+  Result<FileDataLoader> loader = FileDataLoader::from(program_path());
+  ASSERT_EQ(loader.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  size_t num_inits = 0;
+  StubBackend::singleton().install_init(
+      [&](ET_UNUSED FreeableBuffer* processed,
+          ET_UNUSED ArrayRef<CompileSpec> compile_specs,
+          BackendInitContext& backend_init_context) -> Result<DelegateHandle*> {
+        num_inits++;
+        // Each delegate allocates from an allocator of its own.
+        MemoryAllocator* allocator =
+            backend_init_context.get_runtime_allocator();
+        EXPECT_NE(allocator, mmm.get().method_allocator());
+        EXPECT_NE(allocator->allocate(16), nullptr);
+        return nullptr;
+      });
+
+  Result<Program> program = Program::load(&loader.get());
+  ASSERT_EQ(program.error(), Error::Ok);
+  CountingRunner runner;
+  Result<Method> method = program->load_method(
+      "forward",
+      &mmm.get(),
+      /*event_tracer=*/nullptr,
+      /*named_data_map=*/nullptr,
+      &runner);
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_GT(num_inits, 0);
+  EXPECT_EQ(runner.num_tasks_, num_inits);
+  EXPECT_EQ(method->execute(), Error::Ok);
+}
+
 // TODO: Add more tests for the runtime-to-backend interface. E.g.:
 // - Errors during init() or execute() result in runtime init/execution failures
 // - Correct values are passed to init()/execute()
@@ -11,6 +11,9 @@
 
 #include <cstring>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/runner_util/inputs.h>
@@ -27,13 +30,19 @@
 #include <gtest/gtest.h>
 
 using namespace ::testing;
+using executorch::runtime::AllocatorID;
 using executorch::runtime::ArrayRef;
+using executorch::runtime::ChainID;
+using executorch::runtime::DebugHandle;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
+using executorch::runtime::EventTracer;
+using executorch::runtime::EventTracerEntry;
 using executorch::runtime::FreeableBuffer;
 using executorch::runtime::Kernel;
 using executorch::runtime::KernelKey;
 using executorch::runtime::KernelRuntimeContext;
+using executorch::runtime::LoggedEValueType;
 using executorch::runtime::MemoryAllocator;
 using executorch::runtime::Method;
 using executorch::runtime::Program;
@@ -202,12 +211,74 @@ class TempMemoryAllocator final : public MemoryAllocator {
     return (void*)1;
   }
 
+  size_t used_size() const override {
+    return currently_allocated_size;
+  }
+
   void reset() override {
     number_of_resets += 1;
     currently_allocated_size = 0;
   }
 };
 
+/**
+ * EventTracer that records the allocators and allocations that are tracked,
+ * and ignores all other events.
+ */
+class AllocationEventTracer final : public EventTracer {
+ public:
+  // The names of the allocators, in the order of their AllocatorIDs.
+  std::vector<std::string> allocator_names;
+
+  // The (AllocatorID, size) of each allocation.
+  std::vector<std::pair<AllocatorID, size_t>> allocations;
+
+  void create_event_block(const char*) override {
+    allocator_names.clear();
+  }
+  EventTracerEntry start_profiling(const char*, ChainID, DebugHandle) override {
+    return {};
+  }
+  void end_profiling(EventTracerEntry) override {}
+  EventTracerEntry start_profiling_delegate(const char*, DebugHandle)
+      override {
+    return {};
+  }
+  void end_profiling_delegate(EventTracerEntry, const void*, size_t) override {
+  }
+  void log_profiling_delegate(
+      const char*,
+      DebugHandle,
+      et_timestamp_t,
+      et_timestamp_t,
+      const void*,
+      size_t) override {}
+  void track_allocation(AllocatorID id, size_t size) override {
+    allocations.emplace_back(id, size);
+  }
+  AllocatorID track_allocator(const char* name) override {
+    allocator_names.emplace_back(name);
+    return allocator_names.size();
+  }
+  void log_evalue(const EValue&, LoggedEValueType) override {}
+  void log_intermediate_output_delegate(
+      const char*,
+      DebugHandle,
+      const exec_aten::Tensor&) override {}
+  void log_intermediate_output_delegate(
+      const char*,
+      DebugHandle,
+      const ArrayRef<exec_aten::Tensor>) override {}
+  void log_intermediate_output_delegate(const char*, DebugHandle, const int&)
+      override {}
+  void log_intermediate_output_delegate(const char*, DebugHandle, const bool&)
+      override {}
+  void log_intermediate_output_delegate(
+      const char*,
+      DebugHandle,
+      const double&) override {}
+};
+
 class KernelIntegrationTest : public ::testing::Test {
  protected:
   void SetUp() override {
@@ -320,6 +391,35 @@ TEST_F(KernelIntegrationTest, FailurePropagates) {
   EXPECT_EQ(control_->call_count, 3);
 }
 
+TEST_F(KernelIntegrationTest, ExecuteAsyncCanRunAgainAfterFailure) {
+  struct Completion {
+    int calls = 0;
+    Error error = Error::Internal;
+  } completion;
+  auto callback = [](void* context, Error error) {
+    auto* completion = static_cast<Completion*>(context);
+    completion->calls++;
+    completion->error = error;
+  };
+
+  // Tell the kernel to fail. The failure is reported through the callback.
+  control_->call_context_fail = true;
+  control_->fail_value = Error::InvalidArgument;
+  Error err = method_->execute_async(callback, &completion);
+  ASSERT_EQ(err, Error::Ok);
+  EXPECT_EQ(completion.calls, 1);
+  EXPECT_EQ(completion.error, Error::InvalidArgument);
+  EXPECT_EQ(control_->call_count, 1);
+
+  // The failed execution must not leave the Method mid execution.
+  control_->call_context_fail = false;
+  err = method_->execute_async(callback, &completion);
+  ASSERT_EQ(err, Error::Ok);
+  EXPECT_EQ(completion.calls, 2);
+  EXPECT_EQ(completion.error, Error::Ok);
+  EXPECT_EQ(control_->call_count, 2);
+}
+
 TEST_F(KernelIntegrationTest, DefaultPlatformMemoryAllocator) {
   // Tell the kernel to allocate memory. Since no temp allocator is provided,
   // this will allocate memory using the default platform memory allocator.
@@ -379,3 +479,29 @@ TEST_F(KernelTempMemoryAllocatorIntegrationTest, UsingTempMemoryAllocator) {
   EXPECT_EQ(temp_allocator_->number_of_resets, 2);
   EXPECT_EQ(temp_allocator_->currently_allocated_size, 0);
 }
+
+TEST_F(KernelTempMemoryAllocatorIntegrationTest, TracesTempMemoryUsage) {
+#ifndef ET_EVENT_TRACER_ENABLED
+  GTEST_SKIP() << "Event tracer hooks are compiled out";
+#endif
+  AllocationEventTracer event_tracer;
+  ASSERT_EQ(method_->set_event_tracer(&event_tracer), Error::Ok);
+
+  // The temp memory that each instruction used is tracked before the temp
+  // allocator is reset.
+  control_->simulate_temp_memory_allocation = true;
+  control_->temp_memory_size = 4;
+  Error err = method_->execute();
+  EXPECT_EQ(err, Error::Ok);
+  ASSERT_EQ(event_tracer.allocator_names.size(), 1);
+  EXPECT_EQ(event_tracer.allocator_names[0], "temp_allocator");
+  ASSERT_EQ(event_tracer.allocations.size(), 1);
+  EXPECT_EQ(event_tracer.allocations[0].first, 1);
+  EXPECT_EQ(event_tracer.allocations[0].second, 4);
+
+  // Instructions that use no temp memory are not tracked.
+  control_->simulate_temp_memory_allocation = false;
+  err = method_->execute();
+  EXPECT_EQ(err, Error::Ok);
+  EXPECT_EQ(event_tracer.allocations.size(), 1);
+}
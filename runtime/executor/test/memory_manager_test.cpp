@@ -49,6 +49,22 @@ TEST(MemoryManagerTest, CtorWithPlannedMemoryAndTemp) {
   EXPECT_EQ(mm.method_allocator(), &method_allocator);
   EXPECT_EQ(mm.planned_memory(), &planned_memory);
   EXPECT_EQ(mm.temp_allocator(), &temp_allocator);
+  EXPECT_EQ(mm.constant_scratch().size(), 0);
+}
+
+TEST(MemoryManagerTest, CtorWithConstantScratch) {
+  MemoryAllocator method_allocator(0, nullptr);
+  HierarchicalAllocator planned_memory({});
+  uint8_t scratch[32];
+
+  MemoryManager mm(
+      &method_allocator, &planned_memory, nullptr, {scratch, sizeof(scratch)});
+
+  EXPECT_EQ(mm.method_allocator(), &method_allocator);
+  EXPECT_EQ(mm.planned_memory(), &planned_memory);
+  EXPECT_EQ(mm.temp_allocator(), nullptr);
+  EXPECT_EQ(mm.constant_scratch().data(), scratch);
+  EXPECT_EQ(mm.constant_scratch().size(), sizeof(scratch));
 }
 
 TEST(MemoryManagerTest, DEPRECATEDCtor) {
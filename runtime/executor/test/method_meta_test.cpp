@@ -10,6 +10,7 @@
 
 #include <cstdlib>
 #include <filesystem>
+#include <vector>
 
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
@@ -19,8 +20,10 @@
 using namespace ::testing;
 using executorch::runtime::Error;
 using executorch::runtime::MethodMeta;
+using executorch::runtime::PlannedTensorInfo;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
 using executorch::runtime::TensorInfo;
 using torch::executor::util::FileDataLoader;
 
@@ -138,3 +141,41 @@ TEST_F(MethodMetaTest, TensorInfoApi) {
   EXPECT_EQ(
       method_meta->output_tensor_meta(-1).error(), Error::InvalidArgument);
 }
+
+TEST_F(MethodMetaTest, MemoryPlannedTensorsApi) {
+  Result<MethodMeta> method_meta = program_->method_meta("forward");
+  ASSERT_EQ(method_meta.error(), Error::Ok);
+
+  // The two inputs and the output share the single 48-byte planned buffer.
+  const size_t num_tensors = method_meta->num_memory_planned_tensors();
+  EXPECT_EQ(num_tensors, 3);
+
+  std::vector<PlannedTensorInfo> infos(num_tensors);
+  ASSERT_EQ(
+      method_meta->memory_planned_tensors(
+          Span<PlannedTensorInfo>(infos.data(), infos.size())),
+      Error::Ok);
+
+  const auto buffer_size = method_meta->memory_planned_buffer_size(0).get();
+  const int64_t num_instructions = method_meta->num_instructions();
+  for (size_t i = 0; i < infos.size(); ++i) {
+    if (i > 0) {
+      // Sorted by value index.
+      EXPECT_LT(infos[i - 1].value_index, infos[i].value_index);
+    }
+    EXPECT_EQ(infos[i].buffer_index, 0);
+    EXPECT_EQ(infos[i].nbytes, 16);
+    EXPECT_LE(infos[i].offset + infos[i].nbytes, buffer_size);
+    // Every tensor in this model is used by the add kernel.
+    EXPECT_GE(infos[i].first_use, 0);
+    EXPECT_LE(infos[i].first_use, infos[i].last_use);
+    EXPECT_LT(infos[i].last_use, num_instructions);
+  }
+
+  // The output span must have exactly one entry per tensor.
+  std::vector<PlannedTensorInfo> too_small(num_tensors - 1);
+  EXPECT_EQ(
+      method_meta->memory_planned_tensors(
+          Span<PlannedTensorInfo>(too_small.data(), too_small.size())),
+      Error::InvalidArgument);
+}
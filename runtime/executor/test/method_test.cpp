@@ -6,28 +6,44 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <functional>
+#include <vector>
 
+#include <executorch/extension/data_loader/buffer_data_loader.h>
 #include <executorch/extension/data_loader/file_data_loader.h>
 #include <executorch/extension/runner_util/inputs.h>
+#include <executorch/runtime/core/event_tracer.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
 #include <executorch/runtime/executor/method.h>
 #include <executorch/runtime/executor/program.h>
 #include <executorch/runtime/executor/test/managed_memory_manager.h>
+#include <executorch/runtime/kernel/kernel_cache.h>
 #include <executorch/runtime/platform/runtime.h>
+#include <executorch/schema/program_generated.h>
 #include <executorch/test/utils/DeathTest.h>
 #include <gtest/gtest.h>
 
 using namespace ::testing;
 using exec_aten::ArrayRef;
 using executorch::extension::prepare_input_tensors;
+using executorch::runtime::DataLoader;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
+using executorch::runtime::EventTracer;
+using executorch::runtime::FreeableBuffer;
+using executorch::runtime::KernelCache;
+using executorch::runtime::MemoryAllocator;
 using executorch::runtime::Method;
+using executorch::runtime::ParallelRunner;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::Span;
 using executorch::runtime::testing::ManagedMemoryManager;
+using torch::executor::util::BufferDataLoader;
 using torch::executor::util::FileDataLoader;
 
 constexpr size_t kDefaultNonConstMemBytes = 32 * 1024U;
@@ -56,10 +72,13 @@ class MethodTest : public ::testing::Test {
     executorch::runtime::runtime_init();
 
     load_program(std::getenv("ET_MODULE_ADD_PATH"), "add");
+    load_program(
+        std::getenv("ET_MODULE_BRANCHING_DYNAMIC_PATH"), "branching_dynamic");
     load_program(std::getenv("ET_MODULE_INDEX_PATH"), "index");
     load_program(
         std::getenv("ET_MODULE_DYNAMIC_CAT_UNALLOCATED_IO_PATH"), "cat");
     load_program(std::getenv("ET_MODULE_LINEAR_PATH"), "linear");
+    load_program(std::getenv("ET_MODULE_STATEFUL_PATH"), "stateful");
     load_program(
         std::getenv("DEPRECATED_ET_MODULE_LINEAR_CONSTANT_BUFFER_PATH"),
         "linear_constant_buffer");
@@ -268,6 +287,123 @@ TEST_F(MethodTest, AliasedIOTest) {
   }
 }
 
+TEST_F(MethodTest, SetOutputDataPtrsTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["cat"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  ASSERT_EQ(method->outputs_size(), 1);
+
+  float buffer[16] = {};
+  Span<uint8_t> buffers[] = {
+      Span<uint8_t>(reinterpret_cast<uint8_t*>(buffer), sizeof(buffer))};
+
+  // Wrong number of buffers.
+  EXPECT_EQ(
+      method->set_output_data_ptrs(Span<const Span<uint8_t>>()),
+      Error::InvalidArgument);
+
+  // Too small.
+  Span<uint8_t> small_buffers[] = {
+      Span<uint8_t>(reinterpret_cast<uint8_t*>(buffer), 1)};
+  EXPECT_EQ(
+      method->set_output_data_ptrs(
+          Span<const Span<uint8_t>>(small_buffers, 1)),
+      Error::InvalidArgument);
+
+  ASSERT_EQ(
+      method->set_output_data_ptrs(Span<const Span<uint8_t>>(buffers, 1)),
+      Error::Ok);
+  EXPECT_EQ(method->get_output(0).toTensor().const_data_ptr(), buffer);
+
+  // An empty buffer leaves the output unchanged.
+  Span<uint8_t> empty_buffers[1];
+  ASSERT_EQ(
+      method->set_output_data_ptrs(
+          Span<const Span<uint8_t>>(empty_buffers, 1)),
+      Error::Ok);
+  EXPECT_EQ(method->get_output(0).toTensor().const_data_ptr(), buffer);
+}
+
+TEST_F(MethodTest, SetOutputDataPtrsMemoryPlannedTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  ASSERT_EQ(method->outputs_size(), 1);
+
+  // The output of this model is memory-planned, so can't be replaced.
+  float buffer[16] = {};
+  Span<uint8_t> buffers[] = {
+      Span<uint8_t>(reinterpret_cast<uint8_t*>(buffer), sizeof(buffer))};
+  EXPECT_EQ(
+      method->set_output_data_ptrs(Span<const Span<uint8_t>>(buffers, 1)),
+      Error::InvalidState);
+  EXPECT_NE(method->get_output(0).toTensor().const_data_ptr(), buffer);
+}
+
+TEST_F(MethodTest, SaveAndRestoreStateTest) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["stateful"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  // The state is a 2x2 float buffer that starts as ones, and each execution
+  // adds the input of ones to it.
+  const size_t nbytes = method->state_nbytes();
+  ASSERT_EQ(nbytes, 4 * sizeof(float));
+  auto output_value = [&]() {
+    return method->get_output(0).toTensor().const_data_ptr<float>()[0];
+  };
+
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(output_value(), 2.0f);
+
+  std::vector<float> snapshot(4);
+  ASSERT_EQ(
+      method->save_state(
+          Span<uint8_t>(reinterpret_cast<uint8_t*>(snapshot.data()), nbytes)),
+      Error::Ok);
+  EXPECT_EQ(snapshot, std::vector<float>(4, 2.0f));
+
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(output_value(), 3.0f);
+
+  // Rolling back to the snapshot repeats the second execution.
+  ASSERT_EQ(
+      method->restore_state(Span<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(snapshot.data()), nbytes)),
+      Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(output_value(), 3.0f);
+
+  // Resetting goes back to the initial state in the program.
+  ASSERT_EQ(method->reset_state(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(output_value(), 2.0f);
+
+  // Buffers of the wrong size are rejected.
+  EXPECT_EQ(
+      method->save_state(Span<uint8_t>(
+          reinterpret_cast<uint8_t*>(snapshot.data()), nbytes - 1)),
+      Error::InvalidArgument);
+  EXPECT_EQ(
+      method->restore_state(Span<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(snapshot.data()), nbytes + 1)),
+      Error::InvalidArgument);
+}
+
+TEST_F(MethodTest, StatelessMethodHasNoState) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  EXPECT_EQ(method->state_nbytes(), 0);
+  EXPECT_EQ(method->save_state(Span<uint8_t>()), Error::Ok);
+  EXPECT_EQ(method->restore_state(Span<const uint8_t>()), Error::Ok);
+  EXPECT_EQ(method->reset_state(), Error::Ok);
+}
+
 TEST_F(MethodTest, ConstantSegmentTest) {
   // Execute model with constants stored in segment.
   ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
@@ -280,6 +416,108 @@ TEST_F(MethodTest, ConstantSegmentTest) {
   ASSERT_EQ(err, Error::Ok);
 }
 
+TEST_F(MethodTest, LazyConstantSegmentMatchesEager) {
+  // Load the model with constants stored in a segment again, this time loading
+  // the constants when the method is loaded.
+  Result<FileDataLoader> loader =
+      FileDataLoader::from(std::getenv("ET_MODULE_LINEAR_PATH"));
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> lazy_program = Program::load(
+      &loader.get(),
+      Program::Verification::InternalConsistency,
+      Program::ConstantLoading::Lazy);
+  ASSERT_EQ(lazy_program.error(), Error::Ok);
+
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["linear"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& expected = method->get_output(0).toTensor();
+
+  ManagedMemoryManager lazy_mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> lazy_method =
+      lazy_program->load_method("forward", &lazy_mmm.get());
+  ASSERT_EQ(lazy_method.error(), Error::Ok);
+  auto lazy_input_cleanup = prepare_input_tensors(*lazy_method);
+  ASSERT_EQ(lazy_input_cleanup.error(), Error::Ok);
+  ASSERT_EQ(lazy_method->execute(), Error::Ok);
+  const auto& actual = lazy_method->get_output(0).toTensor();
+
+  ASSERT_EQ(actual.nbytes(), expected.nbytes());
+  EXPECT_EQ(
+      std::memcmp(
+          actual.const_data_ptr(), expected.const_data_ptr(), actual.nbytes()),
+      0);
+}
+
+namespace {
+
+// Records the constants that a Method registers, without caching anything.
+class RecordingKernelCache final : public KernelCache {
+ public:
+  Error register_constant(const void* data, size_t nbytes) override {
+    constants.emplace_back(data, nbytes);
+    return Error::Ok;
+  }
+
+  bool is_constant(const void* data) const override {
+    for (const auto& constant : constants) {
+      if (constant.first == data) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<std::pair<const void*, size_t>> constants;
+
+ protected:
+  Result<const void*> get_or_create_impl(
+      const void*,
+      uint32_t,
+      size_t,
+      InitFunction,
+      void*) override {
+    return Error::NotSupported;
+  }
+};
+
+} // namespace
+
+TEST_F(MethodTest, SetKernelCacheRegistersConstants) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["linear"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  RecordingKernelCache cache;
+  ASSERT_EQ(method->set_kernel_cache(&cache), Error::Ok);
+
+  // The model's two constant tensors, but none of its inputs, outputs or
+  // intermediates.
+  ASSERT_EQ(cache.constants.size(), 2);
+  for (const auto& constant : cache.constants) {
+    EXPECT_NE(constant.first, nullptr);
+    EXPECT_GT(constant.second, 0);
+  }
+  for (size_t i = 0; i < method->inputs_size(); ++i) {
+    const auto& input = method->get_input(i);
+    if (input.isTensor()) {
+      EXPECT_FALSE(cache.is_constant(input.toTensor().const_data_ptr()));
+    }
+  }
+
+  // Kernels that don't use the cache still run.
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+  EXPECT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(method->set_kernel_cache(nullptr), Error::Ok);
+}
+
 TEST_F(MethodTest, ConstantBufferTest) {
   // Execute model with constants stored in the program flatbuffer.
   ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
@@ -317,3 +555,540 @@ TEST_F(MethodTest, OptionalTensorListDeserialization) {
   EXPECT_EQ(outputs.toTensor().size(2), 10);
 }
 */
+
+namespace {
+// Runs tasks on the calling thread in reverse order, to check that the tasks
+// of a wave don't depend on each other.
+class ReverseOrderRunner final : public ParallelRunner {
+ public:
+  void run(TaskFunction fn, void* context, size_t num_tasks) override {
+    max_num_tasks = std::max(max_num_tasks, num_tasks);
+    for (size_t i = num_tasks; i > 0; --i) {
+      fn(context, i - 1);
+    }
+  }
+
+  // The number of tasks of the widest wave run so far.
+  size_t max_num_tasks = 0;
+};
+} // namespace
+
+TEST_F(MethodTest, ParallelRunnerMatchesSequentialExecution) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["linear"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& expected = method->get_output(0).toTensor();
+  std::vector<uint8_t> expected_data(
+      expected.const_data_ptr<uint8_t>(),
+      expected.const_data_ptr<uint8_t>() + expected.nbytes());
+
+  ReverseOrderRunner runner;
+  ASSERT_EQ(method->set_parallel_runner(&runner), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& actual = method->get_output(0).toTensor();
+  ASSERT_EQ(actual.nbytes(), expected_data.size());
+  EXPECT_EQ(
+      std::memcmp(
+          actual.const_data_ptr(), expected_data.data(), expected_data.size()),
+      0);
+
+  // Can go back to sequential execution.
+  ASSERT_EQ(method->set_parallel_runner(nullptr), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+}
+
+TEST_F(MethodTest, ParallelRunnerWithoutTempAllocator) {
+  // The temp allocator is optional, so the schedule must not depend on it.
+  ManagedMemoryManager mmm(
+      kDefaultNonConstMemBytes,
+      kDefaultRuntimeMemBytes,
+      /*temp_allocator=*/nullptr);
+  Result<Method> method =
+      programs_["linear"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  ReverseOrderRunner runner;
+  ASSERT_EQ(method->set_parallel_runner(&runner), Error::Ok);
+  EXPECT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(method->execute(), Error::Ok);
+}
+
+TEST_F(MethodTest, ParallelRunnerWithTempAllocator) {
+  std::vector<uint8_t> temp_pool(16 * 1024U);
+  MemoryAllocator temp_allocator(temp_pool.size(), temp_pool.data());
+  ManagedMemoryManager mmm(
+      kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes, &temp_allocator);
+  Result<Method> method =
+      programs_["linear"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  ReverseOrderRunner runner;
+  ASSERT_EQ(method->set_parallel_runner(&runner), Error::Ok);
+  // The analysis released its scratch space.
+  EXPECT_EQ(temp_allocator.used_size(), 0);
+  EXPECT_EQ(method->execute(), Error::Ok);
+}
+
+TEST_F(MethodTest, ParallelRunnerOrdersIntListsAfterSymSize) {
+  // The view sizes are Int lists whose first item is written by a sym_size op,
+  // so the views must run in a later wave than the sym_size.
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["branching_dynamic"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  float buffer[12];
+  for (int i = 0; i < 12; ++i) {
+    buffer[i] = static_cast<float>(i);
+  }
+  int32_t sizes[2] = {3, 4};
+  uint8_t dim_order[2] = {0, 1};
+  int32_t strides[2] = {4, 1};
+
+  // Leaves a stale size of 3 in the Int written by sym_size.
+  exec_aten::TensorImpl impl(
+      exec_aten::ScalarType::Float, 2, sizes, buffer, dim_order, strides);
+  ASSERT_EQ(method->set_input(EValue(exec_aten::Tensor(&impl)), 0), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  EXPECT_EQ(method->get_output(0).toTensor().size(0), 3);
+
+  // Runs the tasks of each wave in reverse order, so a view in the same wave as
+  // the sym_size would see the stale size.
+  ReverseOrderRunner runner;
+  ASSERT_EQ(method->set_parallel_runner(&runner), Error::Ok);
+  sizes[0] = 2;
+  exec_aten::TensorImpl impl_2(
+      exec_aten::ScalarType::Float, 2, sizes, buffer, dim_order, strides);
+  ASSERT_EQ(
+      method->set_input(EValue(exec_aten::Tensor(&impl_2)), 0), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  // The branches did run side by side.
+  EXPECT_GT(runner.max_num_tasks, 1);
+
+  const auto& output = method->get_output(0).toTensor();
+  ASSERT_EQ(output.dim(), 3);
+  EXPECT_EQ(output.size(0), 2);
+  EXPECT_EQ(output.size(1), 2);
+  EXPECT_EQ(output.size(2), 2);
+  // (x + 1) + (x * 2)
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_FLOAT_EQ(output.const_data_ptr<float>()[i], 3.0f * i + 1.0f);
+  }
+}
+
+namespace {
+
+// Performs the reads started with start_load_into_batch() only when they are
+// waited for, like a DMA engine that is slower than the kernels, and fills the
+// buffers with garbage until then.
+class DeferredDataLoader final : public DataLoader {
+ public:
+  explicit DeferredDataLoader(DataLoader* loader) : loader_(loader) {}
+
+  Result<FreeableBuffer> load(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info) const override {
+    return loader_->load(offset, size, segment_info);
+  }
+
+  Error load_into(
+      size_t offset,
+      size_t size,
+      const SegmentInfo& segment_info,
+      void* buffer) const override {
+    return loader_->load_into(offset, size, segment_info, buffer);
+  }
+
+  Error start_load_into_batch(
+      Span<const LoadIntoRequest> requests) const override {
+    for (const auto& request : requests) {
+      std::memset(request.buffer, 0xa5, request.size);
+    }
+    num_started++;
+    return Error::Ok;
+  }
+
+  Error wait_for_load_into_batch(
+      Span<const LoadIntoRequest> requests) const override {
+    num_waited++;
+    return loader_->load_into_batch(requests);
+  }
+
+  Result<size_t> size() const override {
+    return loader_->size();
+  }
+
+  mutable size_t num_started = 0;
+  mutable size_t num_waited = 0;
+
+ private:
+  DataLoader* loader_;
+};
+
+} // namespace
+
+TEST_F(MethodTest, StreamedConstantsMatchEager) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method =
+      programs_["linear"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+  ASSERT_EQ(method->execute(), Error::Ok);
+  const auto& expected = method->get_output(0).toTensor();
+
+  // Load the constants through a loader whose reads only land when they are
+  // waited for, so that using a constant too early changes the output.
+  Result<FileDataLoader> file_loader =
+      FileDataLoader::from(std::getenv("ET_MODULE_LINEAR_PATH"));
+  ASSERT_EQ(file_loader.error(), Error::Ok);
+  DeferredDataLoader loader(&file_loader.get());
+  Result<Program> streamed_program = Program::load(
+      &loader,
+      Program::Verification::InternalConsistency,
+      Program::ConstantLoading::Streamed);
+  ASSERT_EQ(streamed_program.error(), Error::Ok);
+
+  std::vector<uint8_t> scratch(4 * 1024U);
+  ManagedMemoryManager streamed_mmm(
+      kDefaultNonConstMemBytes,
+      kDefaultRuntimeMemBytes,
+      /*temp_allocator=*/nullptr,
+      {scratch.data(), scratch.size()});
+  Result<Method> streamed_method =
+      streamed_program->load_method("forward", &streamed_mmm.get());
+  ASSERT_EQ(streamed_method.error(), Error::Ok);
+  auto streamed_input_cleanup = prepare_input_tensors(*streamed_method);
+  ASSERT_EQ(streamed_input_cleanup.error(), Error::Ok);
+
+  // The constants stay correct when the scratch is reused by later
+  // executions.
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(streamed_method->execute(), Error::Ok);
+    const auto& actual = streamed_method->get_output(0).toTensor();
+    ASSERT_EQ(actual.nbytes(), expected.nbytes());
+    EXPECT_EQ(
+        std::memcmp(
+            actual.const_data_ptr(),
+            expected.const_data_ptr(),
+            actual.nbytes()),
+        0);
+  }
+  EXPECT_GT(loader.num_started, 0);
+  EXPECT_GT(loader.num_waited, 0);
+
+  // The constants' data is only in the scratch while they are used.
+  RecordingKernelCache cache;
+  ASSERT_EQ(streamed_method->set_kernel_cache(&cache), Error::Ok);
+  EXPECT_EQ(cache.constants.size(), 0);
+  ASSERT_EQ(streamed_method->set_kernel_cache(nullptr), Error::Ok);
+
+  // Parallel execution can't share the scratch between instructions.
+  ReverseOrderRunner runner;
+  EXPECT_EQ(
+      streamed_method->set_parallel_runner(&runner), Error::NotSupported);
+}
+
+TEST_F(MethodTest, StreamedConstantsNeedScratch) {
+  Result<FileDataLoader> loader =
+      FileDataLoader::from(std::getenv("ET_MODULE_LINEAR_PATH"));
+  ASSERT_EQ(loader.error(), Error::Ok);
+  Result<Program> program = Program::load(
+      &loader.get(),
+      Program::Verification::Minimal,
+      Program::ConstantLoading::Streamed);
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  // No scratch at all.
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = program->load_method("forward", &mmm.get());
+  EXPECT_EQ(method.error(), Error::MemoryAllocationFailed);
+
+  // Too little scratch for the constants of an instruction.
+  std::vector<uint8_t> scratch(16);
+  ManagedMemoryManager small_mmm(
+      kDefaultNonConstMemBytes,
+      kDefaultRuntimeMemBytes,
+      /*temp_allocator=*/nullptr,
+      {scratch.data(), scratch.size()});
+  Result<Method> small_method =
+      program->load_method("forward", &small_mmm.get());
+  EXPECT_EQ(small_method.error(), Error::MemoryAllocationFailed);
+}
+
+TEST_F(MethodTest, ExecuteAsyncCallsCallback) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  struct Completion {
+    int calls = 0;
+    Error error = Error::Internal;
+  } completion;
+  Error err = method->execute_async(
+      [](void* context, Error error) {
+        auto* completion = static_cast<Completion*>(context);
+        completion->calls++;
+        completion->error = error;
+      },
+      &completion);
+  ASSERT_EQ(err, Error::Ok);
+
+  // The program has no delegates, so execution finished synchronously.
+  EXPECT_EQ(completion.calls, 1);
+  EXPECT_EQ(completion.error, Error::Ok);
+
+  // The method can be executed again afterwards.
+  EXPECT_EQ(method->execute(), Error::Ok);
+}
+
+namespace {
+// Ignores all events.
+class NullEventTracer final : public EventTracer {
+ public:
+  void create_event_block(const char*) override {}
+  executorch::runtime::EventTracerEntry start_profiling(
+      const char*,
+      executorch::runtime::ChainID,
+      executorch::runtime::DebugHandle) override {
+    return {};
+  }
+  void end_profiling(executorch::runtime::EventTracerEntry) override {}
+  executorch::runtime::EventTracerEntry start_profiling_delegate(
+      const char*,
+      executorch::runtime::DebugHandle) override {
+    return {};
+  }
+  void end_profiling_delegate(
+      executorch::runtime::EventTracerEntry,
+      const void*,
+      size_t) override {}
+  void log_profiling_delegate(
+      const char*,
+      executorch::runtime::DebugHandle,
+      et_timestamp_t,
+      et_timestamp_t,
+      const void*,
+      size_t) override {}
+  void track_allocation(executorch::runtime::AllocatorID, size_t) override {}
+  executorch::runtime::AllocatorID track_allocator(const char*) override {
+    return 0;
+  }
+  void log_evalue(const EValue&, executorch::runtime::LoggedEValueType)
+      override {}
+  void log_intermediate_output_delegate(
+      const char*,
+      executorch::runtime::DebugHandle,
+      const exec_aten::Tensor&) override {}
+  void log_intermediate_output_delegate(
+      const char*,
+      executorch::runtime::DebugHandle,
+      const ArrayRef<exec_aten::Tensor>) override {}
+  void log_intermediate_output_delegate(
+      const char*,
+      executorch::runtime::DebugHandle,
+      const int&) override {}
+  void log_intermediate_output_delegate(
+      const char*,
+      executorch::runtime::DebugHandle,
+      const bool&) override {}
+  void log_intermediate_output_delegate(
+      const char*,
+      executorch::runtime::DebugHandle,
+      const double&) override {}
+};
+} // namespace
+
+TEST_F(MethodTest, SetEventTracerOnLoadedMethod) {
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  Result<Method> method = programs_["add"]->load_method("forward", &mmm.get());
+  ASSERT_EQ(method.error(), Error::Ok);
+  EXPECT_EQ(method->get_event_tracer(), nullptr);
+
+  auto input_cleanup = prepare_input_tensors(*method);
+  ASSERT_EQ(input_cleanup.error(), Error::Ok);
+
+  NullEventTracer event_tracer;
+  ASSERT_EQ(method->set_event_tracer(&event_tracer), Error::Ok);
+  EXPECT_EQ(method->get_event_tracer(), &event_tracer);
+  ReverseOrderRunner runner;
+  EXPECT_EQ(method->set_parallel_runner(&runner), Error::NotSupported);
+
+  // Executions that are not traced leave the EventTracer attached.
+  ASSERT_EQ(
+      method->set_event_tracer_sampling(3, /*min_duration_ticks=*/1000),
+      Error::Ok);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(method->execute(), Error::Ok);
+    EXPECT_EQ(method->get_event_tracer(), &event_tracer);
+  }
+
+  ASSERT_EQ(method->set_event_tracer(nullptr), Error::Ok);
+  EXPECT_EQ(method->get_event_tracer(), nullptr);
+  ASSERT_EQ(method->set_parallel_runner(&runner), Error::Ok);
+  EXPECT_EQ(method->set_event_tracer(&event_tracer), Error::NotSupported);
+}
+
+namespace {
+
+using MakeInstruction =
+    std::function<flatbuffers::Offset<executorch_flatbuffer::Instruction>(
+        flatbuffers::FlatBufferBuilder&)>;
+
+/**
+ * Returns a Program whose "forward" method has the values [Int 0, Bool true,
+ * Int 1], no delegates, and a single chain with the one instruction that
+ * `make_instruction` builds.
+ */
+std::vector<uint8_t> make_single_instruction_program(
+    const MakeInstruction& make_instruction) {
+  flatbuffers::FlatBufferBuilder builder;
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::EValue>>
+      values = {
+          executorch_flatbuffer::CreateEValue(
+              builder,
+              executorch_flatbuffer::KernelTypes::Int,
+              executorch_flatbuffer::CreateInt(builder, 0).Union()),
+          executorch_flatbuffer::CreateEValue(
+              builder,
+              executorch_flatbuffer::KernelTypes::Bool,
+              executorch_flatbuffer::CreateBool(builder, true).Union()),
+          executorch_flatbuffer::CreateEValue(
+              builder,
+              executorch_flatbuffer::KernelTypes::Int,
+              executorch_flatbuffer::CreateInt(builder, 1).Union()),
+      };
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::Instruction>>
+      instructions = {make_instruction(builder)};
+  const std::vector<int32_t> no_indices;
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::Chain>>
+      chains = {executorch_flatbuffer::CreateChainDirect(
+          builder, &no_indices, &no_indices, &instructions)};
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::Operator>>
+      operators;
+  const std::vector<
+      flatbuffers::Offset<executorch_flatbuffer::BackendDelegate>>
+      delegates;
+  const std::vector<int64_t> non_const_buffer_sizes = {0};
+  const std::vector<flatbuffers::Offset<executorch_flatbuffer::ExecutionPlan>>
+      plans = {executorch_flatbuffer::CreateExecutionPlanDirect(
+          builder,
+          "forward",
+          /*container_meta_type=*/0,
+          &values,
+          /*inputs=*/&no_indices,
+          /*outputs=*/&no_indices,
+          &chains,
+          &operators,
+          &delegates,
+          &non_const_buffer_sizes)};
+  builder.Finish(
+      executorch_flatbuffer::CreateProgramDirect(
+          builder, /*version=*/0, &plans),
+      executorch_flatbuffer::ProgramIdentifier());
+  return std::vector<uint8_t>(
+      builder.GetBufferPointer(),
+      builder.GetBufferPointer() + builder.GetSize());
+}
+
+/// Returns the error of loading the method of a single instruction program.
+Error load_single_instruction_method(const MakeInstruction& make_instruction) {
+  std::vector<uint8_t> data = make_single_instruction_program(make_instruction);
+  BufferDataLoader loader(data.data(), data.size());
+  Result<Program> program =
+      Program::load(&loader, Program::Verification::InternalConsistency);
+  if (!program.ok()) {
+    return program.error();
+  }
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  return program->load_method("forward", &mmm.get()).error();
+}
+
+} // namespace
+
+TEST_F(MethodTest, InitRejectsOutOfRangeDelegateCall) {
+  // The program has no delegates to call.
+  for (int32_t delegate_index : {-1, 0, 1}) {
+    EXPECT_EQ(
+        load_single_instruction_method([&](auto& builder) {
+          const std::vector<int32_t> args;
+          return executorch_flatbuffer::CreateInstruction(
+              builder,
+              executorch_flatbuffer::InstructionArguments::DelegateCall,
+              executorch_flatbuffer::CreateDelegateCallDirect(
+                  builder, delegate_index, &args)
+                  .Union());
+        }),
+        Error::InvalidProgram)
+        << "delegate_index " << delegate_index;
+  }
+}
+
+TEST_F(MethodTest, InitRejectsOutOfRangeJumpFalseCall) {
+  auto jump_false = [](int32_t cond_value_index, int32_t destination) {
+    return load_single_instruction_method([=](auto& builder) {
+      return executorch_flatbuffer::CreateInstruction(
+          builder,
+          executorch_flatbuffer::InstructionArguments::JumpFalseCall,
+          executorch_flatbuffer::CreateJumpFalseCall(
+              builder, cond_value_index, destination)
+              .Union());
+    });
+  };
+
+  // Jumping to the end of the chain is allowed.
+  EXPECT_EQ(jump_false(/*cond_value_index=*/1, /*destination=*/1), Error::Ok);
+
+  EXPECT_EQ(jump_false(-1, 0), Error::InvalidProgram);
+  EXPECT_EQ(jump_false(3, 0), Error::InvalidProgram);
+  EXPECT_EQ(jump_false(1, -1), Error::InvalidProgram);
+  EXPECT_EQ(jump_false(1, 2), Error::InvalidProgram);
+}
+
+TEST_F(MethodTest, InitRejectsOutOfRangeMoveCall) {
+  auto move = [](int32_t move_from, int32_t move_to) {
+    return load_single_instruction_method([=](auto& builder) {
+      return executorch_flatbuffer::CreateInstruction(
+          builder,
+          executorch_flatbuffer::InstructionArguments::MoveCall,
+          executorch_flatbuffer::CreateMoveCall(builder, move_from, move_to)
+              .Union());
+    });
+  };
+
+  EXPECT_EQ(move(/*move_from=*/0, /*move_to=*/2), Error::Ok);
+
+  EXPECT_EQ(move(-1, 2), Error::InvalidProgram);
+  EXPECT_EQ(move(3, 2), Error::InvalidProgram);
+  EXPECT_EQ(move(0, -1), Error::InvalidProgram);
+  EXPECT_EQ(move(0, 3), Error::InvalidProgram);
+}
+
+TEST_F(MethodTest, InitRejectsInvalidFreeCall) {
+  auto free_value = [](int32_t value_index) {
+    return load_single_instruction_method([=](auto& builder) {
+      return executorch_flatbuffer::CreateInstruction(
+          builder,
+          executorch_flatbuffer::InstructionArguments::FreeCall,
+          executorch_flatbuffer::CreateFreeCall(builder, value_index).Union());
+    });
+  };
+
+  EXPECT_EQ(free_value(-1), Error::InvalidProgram);
+  EXPECT_EQ(free_value(3), Error::InvalidProgram);
+  // Only tensors can be freed.
+  EXPECT_EQ(free_value(0), Error::InvalidProgram);
+}
@@ -28,8 +28,10 @@ using namespace ::testing;
 using executorch::runtime::DataLoader;
 using executorch::runtime::Error;
 using executorch::runtime::FreeableBuffer;
+using executorch::runtime::ParallelRunner;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::VerificationCache;
 using torch::executor::util::BufferDataLoader;
 using torch::executor::util::FileDataLoader;
 
@@ -234,6 +236,139 @@ TEST_F(ProgramTest, VerificationCatchesCorruption) {
   ASSERT_EQ(program.error(), Error::InvalidProgram);
 }
 
+namespace {
+// Runs tasks on the calling thread in reverse order, and counts them.
+class CountingRunner final : public ParallelRunner {
+ public:
+  void run(TaskFunction fn, void* context, size_t num_tasks) override {
+    for (size_t i = num_tasks; i > 0; --i) {
+      fn(context, i - 1);
+    }
+    num_tasks_ += num_tasks;
+  }
+
+  size_t num_tasks_ = 0;
+};
+
+// Remembers the size of the one program it was told about.
+class FakeVerificationCache final : public VerificationCache {
+ public:
+  bool contains(const void* data, size_t size) override {
+    (void)data;
+    ++num_lookups_;
+    return size == verified_size_;
+  }
+
+  void insert(const void* data, size_t size) override {
+    (void)data;
+    verified_size_ = size;
+  }
+
+  size_t verified_size_ = 0;
+  size_t num_lookups_ = 0;
+};
+} // namespace
+
+TEST_F(ProgramTest, ParallelVerificationVerifiesEachPlan) {
+  CountingRunner runner;
+  Result<Program> program = Program::load(
+      multi_loader_.get(),
+      Program::Verification::InternalConsistency,
+      Program::ConstantLoading::Eager,
+      &runner);
+  ASSERT_EQ(program.error(), Error::Ok);
+  // One task per plan.
+  EXPECT_EQ(runner.num_tasks_, program->num_methods());
+}
+
+TEST_F(ProgramTest, ParallelVerificationCatchesCorruption) {
+  // Make a local copy of the data.
+  size_t data_len = multi_loader_->size().get();
+  auto data = std::make_unique<char[]>(data_len);
+  {
+    Result<FreeableBuffer> src = multi_loader_->load(
+        /*offset=*/0,
+        data_len,
+        /*segment_info=*/
+        DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+    ASSERT_EQ(src.error(), Error::Ok);
+    memcpy(data.get(), src->data(), data_len);
+  }
+
+  // Corrupt the second half of the data.
+  std::memset(&data[data_len / 2], 0x55, data_len - (data_len / 2));
+  BufferDataLoader data_loader(data.get(), data_len);
+
+  CountingRunner runner;
+  Result<Program> program = Program::load(
+      &data_loader,
+      Program::Verification::InternalConsistency,
+      Program::ConstantLoading::Eager,
+      &runner);
+  ASSERT_EQ(program.error(), Error::InvalidProgram);
+}
+
+TEST_F(ProgramTest, VerificationCacheSkipsVerifiedData) {
+  FakeVerificationCache cache;
+  CountingRunner runner;
+  {
+    Result<Program> program = Program::load(
+        multi_loader_.get(),
+        Program::Verification::InternalConsistency,
+        Program::ConstantLoading::Eager,
+        &runner,
+        &cache);
+    ASSERT_EQ(program.error(), Error::Ok);
+    EXPECT_EQ(cache.num_lookups_, 1);
+    EXPECT_GT(cache.verified_size_, 0);
+  }
+  const size_t num_tasks = runner.num_tasks_;
+  EXPECT_GT(num_tasks, 0);
+
+  // The second load finds the data in the cache and does not verify it.
+  Result<Program> program = Program::load(
+      multi_loader_.get(),
+      Program::Verification::InternalConsistency,
+      Program::ConstantLoading::Eager,
+      &runner,
+      &cache);
+  ASSERT_EQ(program.error(), Error::Ok);
+  EXPECT_EQ(cache.num_lookups_, 2);
+  EXPECT_EQ(runner.num_tasks_, num_tasks);
+
+  // Minimal verification does not use the cache.
+  Result<Program> minimal_program = Program::load(
+      multi_loader_.get(),
+      Program::Verification::Minimal,
+      Program::ConstantLoading::Eager,
+      &runner,
+      &cache);
+  ASSERT_EQ(minimal_program.error(), Error::Ok);
+  EXPECT_EQ(cache.num_lookups_, 2);
+}
+
+TEST_F(ProgramTest, VerificationCacheSkipsFailedData) {
+  size_t full_data_len = add_loader_->size().get();
+  Result<FreeableBuffer> full_data = add_loader_->load(
+      /*offset=*/0,
+      full_data_len,
+      /*segment_info=*/
+      DataLoader::SegmentInfo(DataLoader::SegmentInfo::Type::Program));
+  ASSERT_EQ(full_data.error(), Error::Ok);
+  BufferDataLoader half_data_loader(full_data->data(), full_data_len / 2);
+
+  // Data that fails verification is not inserted into the cache.
+  FakeVerificationCache cache;
+  Result<Program> program = Program::load(
+      &half_data_loader,
+      Program::Verification::InternalConsistency,
+      Program::ConstantLoading::Eager,
+      /*verification_runner=*/nullptr,
+      &cache);
+  EXPECT_EQ(program.error(), Error::InvalidProgram);
+  EXPECT_EQ(cache.verified_size_, 0);
+}
+
 TEST_F(ProgramTest, UnalignedProgramDataFails) {
   // Make a local copy of the data, on an odd alignment.
   size_t data_len = add_loader_->size().get();
@@ -445,6 +580,23 @@ TEST_F(ProgramTest, LoadConstantSegment) {
   EXPECT_GE(flatbuffer_program->constant_segment()->offsets()->size(), 1);
 }
 
+TEST_F(ProgramTest, LazyConstantSegmentIsNotLoaded) {
+  // Load the serialized ModuleLinear data, with constants in the segment.
+  const char* linear_path = std::getenv("ET_MODULE_LINEAR_PATH");
+  Result<FileDataLoader> linear_loader = FileDataLoader::from(linear_path);
+  ASSERT_EQ(linear_loader.error(), Error::Ok);
+
+  Result<Program> program = Program::load(
+      &linear_loader.get(),
+      Program::Verification::Minimal,
+      Program::ConstantLoading::Lazy);
+  ASSERT_EQ(program.error(), Error::Ok);
+
+  // Constants can't be accessed in bulk, since the segment wasn't loaded.
+  EXPECT_EQ(
+      program->get_constant_buffer_data(1, 1).error(), Error::NotSupported);
+}
+
 TEST_F(ProgramTest, LoadConstantSegmentWhenConstantBufferExists) {
   // Load the serialized ModuleLinear data, with constants in the flatbuffer and
   // no constants in the segment.
@@ -21,9 +21,12 @@ using exec_aten::Tensor;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::FreeableBuffer;
+using executorch::runtime::MemoryAllocator;
 using executorch::runtime::Program;
 using executorch::runtime::Result;
+using executorch::runtime::deserialization::allocateTensorImpls;
 using executorch::runtime::deserialization::parseTensor;
+using executorch::runtime::deserialization::TensorMetadataArena;
 using executorch::runtime::testing::ManagedMemoryManager;
 using torch::executor::util::FileDataLoader;
 
@@ -119,6 +122,106 @@ TEST_F(TensorParserTest, TestModuleAddHalf) {
   test_module_add(half_loader_, ScalarType::Half, sizeof(exec_aten::Half));
 }
 
+TEST_F(TensorParserTest, TestContiguousTensorImpls) {
+  Result<Program> program =
+      Program::load(float_loader_.get(), Program::Verification::Minimal);
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+
+  const executorch_flatbuffer::Program* internal_program =
+      ProgramTestFriend::GetInternalProgram(&program.get());
+  auto flatbuffer_values =
+      internal_program->execution_plan()->Get(0)->values();
+
+  // input x2, output
+  constexpr size_t kNumTensors = 3;
+  Result<exec_aten::TensorImpl*> tensor_impls =
+      allocateTensorImpls(mmm.get().method_allocator(), kNumTensors);
+  ASSERT_EQ(tensor_impls.error(), Error::Ok);
+
+  size_t next_tensor_impl = 0;
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    auto serialization_value = flatbuffer_values->Get(i);
+    if (serialization_value->val_type() !=
+        executorch_flatbuffer::KernelTypes::Tensor) {
+      continue;
+    }
+    exec_aten::TensorImpl* tensor_impl = nullptr;
+    if (tensor_impls.get() != nullptr) {
+      tensor_impl = &tensor_impls.get()[next_tensor_impl];
+    }
+    next_tensor_impl++;
+    Result<Tensor> tensor = parseTensor(
+        &program.get(),
+        &mmm.get(),
+        serialization_value->val_as_Tensor(),
+        /*constant_data=*/nullptr,
+        /*mutable_load=*/nullptr,
+        tensor_impl);
+    ASSERT_EQ(tensor.error(), Error::Ok);
+    EXPECT_EQ(4, tensor->numel());
+    if (tensor_impl != nullptr) {
+      // Constructed in the provided storage.
+      EXPECT_EQ(tensor->unsafeGetTensorImpl(), tensor_impl);
+    }
+  }
+  EXPECT_EQ(next_tensor_impl, kNumTensors);
+}
+
+TEST_F(TensorParserTest, TestMetadataArenaSharesStrides) {
+  Result<Program> program =
+      Program::load(float_loader_.get(), Program::Verification::Minimal);
+  ASSERT_EQ(program.error(), Error::Ok);
+  ManagedMemoryManager mmm(kDefaultNonConstMemBytes, kDefaultRuntimeMemBytes);
+  uint8_t temp_buffer[1024];
+  MemoryAllocator temp_allocator(sizeof(temp_buffer), temp_buffer);
+
+  const executorch_flatbuffer::Program* internal_program =
+      ProgramTestFriend::GetInternalProgram(&program.get());
+  auto flatbuffer_values =
+      internal_program->execution_plan()->Get(0)->values();
+
+  // input x2, output
+  constexpr size_t kNumTensors = 3;
+  TensorMetadataArena arena(&temp_allocator, kNumTensors);
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    auto serialization_value = flatbuffer_values->Get(i);
+    if (serialization_value->val_type() ==
+        executorch_flatbuffer::KernelTypes::Tensor) {
+      arena.reserve(serialization_value->val_as_Tensor());
+    }
+  }
+  ASSERT_EQ(arena.allocate(mmm.get().method_allocator()), Error::Ok);
+  // All three tensors are static with sizes [2, 2], so they share strides.
+  EXPECT_EQ(arena.num_strides(), 2);
+
+  const exec_aten::StridesType* strides = nullptr;
+  for (size_t i = 0; i < flatbuffer_values->size(); ++i) {
+    auto serialization_value = flatbuffer_values->Get(i);
+    if (serialization_value->val_type() !=
+        executorch_flatbuffer::KernelTypes::Tensor) {
+      continue;
+    }
+    Result<Tensor> tensor = parseTensor(
+        &program.get(),
+        &mmm.get(),
+        serialization_value->val_as_Tensor(),
+        /*constant_data=*/nullptr,
+        /*mutable_load=*/nullptr,
+        /*tensor_impl=*/nullptr,
+        /*named_data_map=*/nullptr,
+        &arena);
+    ASSERT_EQ(tensor.error(), Error::Ok);
+    ASSERT_EQ(tensor->dim(), 2);
+    EXPECT_EQ(tensor->strides()[0], 2);
+    EXPECT_EQ(tensor->strides()[1], 1);
+    if (strides == nullptr) {
+      strides = tensor->strides().data();
+    }
+    EXPECT_EQ(tensor->strides().data(), strides);
+  }
+}
+
 TEST_F(TensorParserTest, TestMutableState) {
   // Load the serialized ModuleSimpleTrain data.
   const char* path = std::getenv("ET_MODULE_SIMPLE_TRAIN_PATH");
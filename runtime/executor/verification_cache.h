@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * EXPERIMENTAL: Remembers which program data passed
+ * Program::Verification::InternalConsistency, so that Program::load() can
+ * trust the same data without verifying it again.
+ *
+ * The core runtime does not persist anything itself. Clients provide an
+ * implementation backed by the storage of their choice; see
+ * `executorch/extension/module/file_verification_cache.h` for one that keeps
+ * its records in a file.
+ */
+class VerificationCache {
+ public:
+  /**
+   * Returns true if the `size` bytes of program data at `data` passed
+   * verification before, in which case Program::load() does not verify them.
+   */
+  virtual bool contains(const void* data, size_t size) = 0;
+
+  /**
+   * Records that the `size` bytes of program data at `data` passed
+   * verification.
+   */
+  virtual void insert(const void* data, size_t size) = 0;
+
+  virtual ~VerificationCache() = default;
+};
+
+} // namespace runtime
+} // namespace executorch
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <executorch/runtime/core/error.h>
+#include <executorch/runtime/core/result.h>
+#include <executorch/runtime/platform/compiler.h>
+
+namespace executorch {
+namespace runtime {
+
+/**
+ * EXPERIMENTAL: Holds data that kernels derive from the constant tensors of a
+ * method, like weights repacked into the layout that a kernel's inner loop
+ * reads, so that they are derived once instead of on every execution.
+ *
+ * A Method that has a cache registers the data of its constant tensors with
+ * it, and hands it to kernels through KernelRuntimeContext::kernel_cache().
+ * Entries are keyed by the constant data they were derived from, and a tag
+ * that the kernel chooses to identify the derived format. Since constants
+ * never change, an entry stays valid until the cache is destroyed.
+ *
+ * Kernels of a method may run concurrently, so implementations must be
+ * thread-safe.
+ */
+class KernelCache {
+ public:
+  virtual ~KernelCache() = default;
+
+  /**
+   * Declares that the `nbytes` bytes at `data` hold a constant tensor that
+   * does not change for the lifetime of the cache. Called by Method.
+   */
+  ET_NODISCARD virtual Error register_constant(
+      const void* data,
+      size_t nbytes) = 0;
+
+  /// Returns true if `data` is the start of a registered constant.
+  virtual bool is_constant(const void* data) const = 0;
+
+  /**
+   * Returns the entry for the constant `data` and `tag`, creating it first if
+   * needed. To create an entry, the cache allocates `nbytes` bytes, aligned
+   * for any scalar type, and calls `init(data, nbytes)` on them once, even if
+   * several threads ask for the same entry at the same time.
+   *
+   * @param[in] constant The start of a registered constant.
+   * @param[in] tag Identifies what the entry holds, so that different kernels
+   *     can derive different data from the same constant.
+   * @param[in] nbytes The size of the entry.
+   * @param[in] init A callable with the signature `Error(void* data, size_t
+   *     nbytes)` that fills in a new entry.
+   *
+   * @returns The data of the entry.
+   * @retval Error::NotFound `constant` is not the start of a registered
+   *     constant, so it may change and can't be cached.
+   * @retval Error::InvalidArgument The entry exists with a different size.
+   * @retval Error::MemoryAllocationFailed The entry could not be allocated.
+   * @returns Other errors from `init`, after which the entry is not created.
+   */
+  template <typename Init>
+  ET_NODISCARD Result<const void*>
+  get_or_create(const void* constant, uint32_t tag, size_t nbytes, Init&& init) {
+    using InitType = typename std::remove_reference<Init>::type;
+    return get_or_create_impl(
+        constant,
+        tag,
+        nbytes,
+        [](void* context, void* data, size_t size) -> Error {
+          return (*static_cast<InitType*>(context))(data, size);
+        },
+        const_cast<void*>(static_cast<const void*>(&init)));
+  }
+
+ protected:
+  /// Fills in the `size` bytes of a new entry at `data`.
+  using InitFunction = Error (*)(void* context, void* data, size_t size);
+
+  /**
+   * Implements get_or_create(), calling `init(init_context, data, nbytes)` to
+   * fill in a new entry.
+   */
+  ET_NODISCARD virtual Result<const void*> get_or_create_impl(
+      const void* constant,
+      uint32_t tag,
+      size_t nbytes,
+      InitFunction init,
+      void* init_context) = 0;
+};
+
+} // namespace runtime
+} // namespace executorch
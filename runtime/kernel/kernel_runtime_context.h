@@ -12,6 +12,7 @@
 #include <executorch/runtime/core/event_tracer_hooks.h>
 #include <executorch/runtime/core/memory_allocator.h>
 #include <executorch/runtime/core/result.h>
+#include <executorch/runtime/kernel/kernel_cache.h>
 #include <executorch/runtime/platform/compiler.h>
 
 namespace executorch {
@@ -36,11 +37,16 @@ class KernelRuntimeContext {
    * @param[in] temp_allocator The optional MemoryAllocator used to allocate
    *     temporary memory for the kernel. If not provided, an error will be
    *     returned when calling allocate_temp.
+   * @param[in] kernel_cache The optional KernelCache of the method that runs
+   *     the kernel.
    */
   KernelRuntimeContext(
       EventTracer* event_tracer = nullptr,
-      MemoryAllocator* temp_allocator = nullptr)
-      : event_tracer_(event_tracer), temp_allocator_(temp_allocator) {}
+      MemoryAllocator* temp_allocator = nullptr,
+      KernelCache* kernel_cache = nullptr)
+      : event_tracer_(event_tracer),
+        temp_allocator_(temp_allocator),
+        kernel_cache_(kernel_cache) {}
   /**
    * Tells the runtime that the kernel call has failed. Prefer this over
    * ET_CHECK_*(), which fatally panics the process/system.
@@ -99,11 +105,21 @@ class KernelRuntimeContext {
     return temp_memory;
   }
 
+  /**
+   * EXPERIMENTAL: Returns the cache for data that the kernel derives from
+   * constant tensors, or nullptr if the method has none. Kernels must work
+   * without it.
+   */
+  KernelCache* kernel_cache() {
+    return kernel_cache_;
+  }
+
   // TODO(T147221312): Add a way to resize a tensor.
 
  private:
   EventTracer* event_tracer_ = nullptr;
   MemoryAllocator* temp_allocator_ = nullptr;
+  KernelCache* kernel_cache_ = nullptr;
   Error failure_state_ = Error::Ok;
 };
 
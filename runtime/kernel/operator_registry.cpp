@@ -8,12 +8,25 @@
 
 #include <executorch/runtime/kernel/operator_registry.h>
 
+#include <algorithm>
 #include <cinttypes>
 
 #include <executorch/runtime/platform/assert.h>
 #include <executorch/runtime/platform/platform.h>
 #include <executorch/runtime/platform/system.h>
 
+#if defined(__ELF__)
+// Bounds of the executorch_kernels section, which the linker defines when a
+// linked object has a kernel table in it; see ET_KERNEL_SECTION. Weak, so that
+// they are null when none does.
+extern "C" {
+extern const ::executorch::runtime::Kernel __start_executorch_kernels[]
+    __attribute__((weak));
+extern const ::executorch::runtime::Kernel __stop_executorch_kernels[]
+    __attribute__((weak));
+}
+#endif
+
 namespace executorch {
 namespace runtime {
 
@@ -36,20 +49,163 @@ constexpr uint32_t kMaxRegisteredKernels = kMaxOperators * kMaxKernelsPerOp;
 // until we add each entry to the table, allocate static zeroed memory instead
 // and point the table at it.
 // @lint-ignore CLANGTIDY facebook-hte-CArray
-alignas(sizeof(Kernel)) uint8_t
+alignas(alignof(Kernel)) uint8_t
     registered_kernels_data[kMaxRegisteredKernels * sizeof(Kernel)];
 
-/// Global table of registered kernels.
+/// Storage for the kernels registered with register_kernels().
 Kernel* registered_kernels = reinterpret_cast<Kernel*>(registered_kernels_data);
 
-/// The number of kernels registered in the table.
+/**
+ * Global table of kernels. Points at the executorch_kernels section while all
+ * kernels come from it, so that they are used where the linker put them, and
+ * at registered_kernels once any kernel is registered at runtime.
+ */
+const Kernel* kernel_table = registered_kernels;
+
+/// The number of kernels in the table.
 size_t num_registered_kernels = 0;
 
+/**
+ * Mixes an operator name and kernel key into an FNV-1a hash. The name
+ * terminator and the fallback flag are mixed in too, so that a fallback key
+ * never hashes like a specialized key with an empty string.
+ */
+template <typename T, T kFnvPrime>
+T fnv1a_kernel(T hash, const char* name, const KernelKey& key) {
+  for (const char* c = name; *c != '\0'; ++c) {
+    hash = (hash ^ static_cast<uint8_t>(*c)) * kFnvPrime;
+  }
+  hash = (hash ^ 0u) * kFnvPrime;
+  hash = (hash ^ (key.is_fallback() ? 1u : 2u)) * kFnvPrime;
+  if (!key.is_fallback()) {
+    const char* data = key.data();
+    for (size_t i = 0; i < KernelKey::MAX_SIZE && data[i] != '\0'; ++i) {
+      hash = (hash ^ static_cast<uint8_t>(data[i])) * kFnvPrime;
+    }
+  }
+  return hash;
+}
+
+/// Fingerprint of the names and keys of the kernels in the table, in order.
+uint64_t registry_fingerprint = 14695981039346656037ull;
+
+constexpr uint32_t next_power_of_two(uint32_t n) {
+  uint32_t result = 1;
+  while (result < n) {
+    result <<= 1;
+  }
+  return result;
+}
+
+// Open-addressing hash index over registered_kernels, keyed on the operator
+// name and kernel key, so that lookups don't need to scan the whole table.
+// Each slot holds one plus the index of a kernel in registered_kernels, or zero
+// if the slot is empty. Keeping the index at least twice as large as the
+// kernel table bounds the load factor to 50%, which keeps probe sequences short
+// and guarantees that every probe sequence reaches an empty slot.
+constexpr uint32_t kKernelIndexSize =
+    next_power_of_two(2 * kMaxRegisteredKernels);
+constexpr uint32_t kKernelIndexMask = kKernelIndexSize - 1;
+static_assert(
+    kKernelIndexSize > kMaxRegisteredKernels,
+    "Kernel index must have more slots than the kernel table");
+
+// @lint-ignore CLANGTIDY facebook-hte-CArray
+uint32_t kernel_index[kKernelIndexSize];
+
+/// Hash of an operator name and kernel key, for the kernel index.
+uint32_t hash_kernel(const char* name, const KernelKey& key) {
+  return fnv1a_kernel<uint32_t, 16777619u>(2166136261u, name, key);
+}
+
+/**
+ * Returns the index in kernel_table of the kernel with the given name and key,
+ * or -1 if there is none.
+ */
+int32_t find_kernel(const char* name, const KernelKey& key) {
+  for (uint32_t slot = hash_kernel(name, key) & kKernelIndexMask;;
+       slot = (slot + 1) & kKernelIndexMask) {
+    const uint32_t entry = kernel_index[slot];
+    if (entry == 0) {
+      return -1;
+    }
+    const Kernel& kernel = kernel_table[entry - 1];
+    if (strcmp(kernel.name_, name) == 0 && kernel.kernel_key_ == key) {
+      return static_cast<int32_t>(entry - 1);
+    }
+  }
+}
+
+/// Adds kernel_table[index] to the hash index.
+void index_kernel(uint32_t index) {
+  const Kernel& kernel = kernel_table[index];
+  uint32_t slot = hash_kernel(kernel.name_, kernel.kernel_key_) &
+      kKernelIndexMask;
+  while (kernel_index[slot] != 0) {
+    slot = (slot + 1) & kKernelIndexMask;
+  }
+  kernel_index[slot] = index + 1;
+}
+
+/// Returns the kernels of the executorch_kernels section.
+Span<const Kernel> section_kernels() {
+#if defined(__ELF__)
+  if (__start_executorch_kernels != nullptr) {
+    return {
+        __start_executorch_kernels,
+        static_cast<size_t>(
+            __stop_executorch_kernels - __start_executorch_kernels)};
+  }
+#endif
+  return {};
+}
+
+/**
+ * Indexes the kernels of the executorch_kernels section and points the table
+ * at them. Runs once, on the first use of the registry, so that processes
+ * don't pay for it at static initialization time.
+ */
+void init_section_kernels() {
+  static const bool initialized = []() {
+    const Span<const Kernel> kernels = section_kernels();
+    if (kernels.empty()) {
+      return true;
+    }
+    ET_CHECK_MSG(
+        kernels.size() <= kMaxRegisteredKernels,
+        "%" PRIu32 " kernels in the executorch_kernels section exceed the "
+        "limit %" PRIu32,
+        (uint32_t)kernels.size(),
+        kMaxRegisteredKernels);
+    kernel_table = kernels.data();
+    for (uint32_t i = 0; i < kernels.size(); i++) {
+      const Kernel& kernel = kernels[i];
+      // Skip padding the linker may have put between tables.
+      if (kernel.name_ != nullptr) {
+        ET_CHECK_MSG(
+            find_kernel(kernel.name_, kernel.kernel_key_) < 0,
+            "Re-registering %s, from %s",
+            kernel.name_,
+            et_pal_get_shared_library_name(&kernel));
+        index_kernel(i);
+      }
+      registry_fingerprint = fnv1a_kernel<uint64_t, 1099511628211ull>(
+          registry_fingerprint,
+          kernel.name_ != nullptr ? kernel.name_ : "",
+          kernel.kernel_key_);
+    }
+    num_registered_kernels = kernels.size();
+    return true;
+  }();
+  (void)initialized;
+}
+
 // Registers the kernels, but may return an error.
 Error register_kernels_internal(const Span<const Kernel> kernels) {
   // Operator registration happens in static initialization time before or after
   // PAL init, so call it here. It is safe to call multiple times.
   ::et_pal_init();
+  init_section_kernels();
 
   if (kernels.size() + num_registered_kernels > kMaxRegisteredKernels) {
     ET_LOG(
@@ -63,8 +219,10 @@ Error register_kernels_internal(const Span<const Kernel> kernels) {
         (uint32_t)kernels.size());
     ET_LOG(Error, "======== Kernels already in the registry: ========");
     for (size_t i = 0; i < num_registered_kernels; i++) {
-      ET_LOG(Error, "%s", registered_kernels[i].name_);
-      ET_LOG_KERNEL_KEY(registered_kernels[i].kernel_key_);
+      if (kernel_table[i].name_ != nullptr) {
+        ET_LOG(Error, "%s", kernel_table[i].name_);
+        ET_LOG_KERNEL_KEY(kernel_table[i].kernel_key_);
+      }
     }
     ET_LOG(Error, "======== Kernels being registered: ========");
     for (size_t i = 0; i < kernels.size(); i++) {
@@ -73,21 +231,30 @@ Error register_kernels_internal(const Span<const Kernel> kernels) {
     }
     return Error::Internal;
   }
+  // The table moves to writable storage so that the section kernels keep their
+  // indices and the new kernels follow them.
+  if (kernel_table != registered_kernels) {
+    std::copy(
+        kernel_table,
+        kernel_table + num_registered_kernels,
+        registered_kernels);
+    kernel_table = registered_kernels;
+  }
+
   // for debugging purpose
   const char* lib_name = et_pal_get_shared_library_name(kernels.data());
 
   for (const auto& kernel : kernels) {
-    // Linear search. This is fine if the number of kernels is small.
-    for (int32_t i = 0; i < num_registered_kernels; i++) {
-      Kernel k = registered_kernels[i];
-      if (strcmp(kernel.name_, k.name_) == 0 &&
-          kernel.kernel_key_ == k.kernel_key_) {
-        ET_LOG(Error, "Re-registering %s, from %s", k.name_, lib_name);
-        ET_LOG_KERNEL_KEY(k.kernel_key_);
-        return Error::InvalidArgument;
-      }
+    if (find_kernel(kernel.name_, kernel.kernel_key_) >= 0) {
+      ET_LOG(Error, "Re-registering %s, from %s", kernel.name_, lib_name);
+      ET_LOG_KERNEL_KEY(kernel.kernel_key_);
+      return Error::InvalidArgument;
     }
-    registered_kernels[num_registered_kernels++] = kernel;
+    registered_kernels[num_registered_kernels] = kernel;
+    index_kernel(num_registered_kernels);
+    registry_fingerprint = fnv1a_kernel<uint64_t, 1099511628211ull>(
+        registry_fingerprint, kernel.name_, kernel.kernel_key_);
+    num_registered_kernels++;
   }
   ET_LOG(
       Debug,
@@ -163,24 +330,29 @@ bool registry_has_op_function(
 Result<OpFunction> get_op_function_from_registry(
     const char* name,
     Span<const TensorMeta> meta_list) {
+  Result<const Kernel*> kernel = get_kernel_from_registry(name, meta_list);
+  if (!kernel.ok()) {
+    return kernel.error();
+  }
+  return kernel.get()->op_;
+}
+
+Result<const Kernel*> get_kernel_from_registry(
+    const char* name,
+    Span<const TensorMeta> meta_list) {
   // @lint-ignore CLANGTIDY facebook-hte-CArray
   char buf[KernelKey::MAX_SIZE] = {0};
+  init_section_kernels();
   internal::make_kernel_key_string(meta_list, buf);
   KernelKey kernel_key = KernelKey(buf);
 
-  int32_t fallback_idx = -1;
-  for (size_t idx = 0; idx < num_registered_kernels; idx++) {
-    if (strcmp(registered_kernels[idx].name_, name) == 0) {
-      if (registered_kernels[idx].kernel_key_ == kernel_key) {
-        return registered_kernels[idx].op_;
-      }
-      if (registered_kernels[idx].kernel_key_.is_fallback()) {
-        fallback_idx = idx;
-      }
-    }
+  // Prefer the kernel specialized for these tensors, then the fallback kernel.
+  int32_t idx = find_kernel(name, kernel_key);
+  if (idx < 0) {
+    idx = find_kernel(name, KernelKey());
   }
-  if (fallback_idx != -1) {
-    return registered_kernels[fallback_idx].op_;
+  if (idx >= 0) {
+    return &kernel_table[idx];
   }
   ET_LOG(Error, "kernel '%s' not found.", name);
   ET_LOG_TENSOR_META(meta_list);
@@ -188,7 +360,13 @@ Result<OpFunction> get_op_function_from_registry(
 }
 
 Span<const Kernel> get_registered_kernels() {
-  return {registered_kernels, num_registered_kernels};
+  init_section_kernels();
+  return {kernel_table, num_registered_kernels};
+}
+
+uint64_t get_registry_fingerprint() {
+  init_section_kernels();
+  return registry_fingerprint;
 }
 
 } // namespace runtime
@@ -14,6 +14,7 @@
 #include <executorch/runtime/core/error.h>
 #include <executorch/runtime/core/evalue.h>
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
+#include <executorch/runtime/core/memory_allocator.h>
 #include <executorch/runtime/core/result.h>
 #include <executorch/runtime/core/span.h>
 #include <executorch/runtime/platform/compiler.h>
@@ -45,6 +46,34 @@ namespace runtime {
 class KernelRuntimeContext; // Forward declaration
 using OpFunction = void (*)(KernelRuntimeContext&, EValue**);
 
+/**
+ * EXPERIMENTAL: A call of a kernel whose arguments were unpacked ahead of time
+ * by an OpBindFunction. Calling `function` with `bound_args` has the same
+ * effect as calling the kernel's OpFunction with the EValues that were bound.
+ */
+struct BoundOpFunction {
+  void (*function)(KernelRuntimeContext&, const void* bound_args);
+  const void* bound_args;
+};
+
+/**
+ * EXPERIMENTAL: Unpacks the `n_args` EValues that a kernel will be called with
+ * into typed pointers to their payloads, allocated from `allocator`, so that
+ * each call skips the type checks and conversions of the OpFunction. Called
+ * once per kernel call at Method::init().
+ *
+ * The EValues must outlive the returned call, and keep their types; their
+ * values may change between calls.
+ *
+ * @retval Error::NotSupported if the arguments can't be bound, e.g. because
+ *     they don't have the types of the kernel's signature. Callers then use
+ *     the OpFunction.
+ */
+using OpBindFunction = Result<BoundOpFunction> (*)(
+    MemoryAllocator* allocator,
+    EValue** args,
+    size_t n_args);
+
 /**
  * Dtype and dim order metadata for a Tensor argument to an operator.
  * Used by the Executor to hold the tensor metadata info and retrieve kernel.
@@ -122,9 +151,9 @@ struct TensorMeta {
  */
 struct KernelKey {
  public:
-  KernelKey() : is_fallback_(true) {}
+  constexpr KernelKey() : is_fallback_(true) {}
 
-  /* implicit */ KernelKey(const char* kernel_key_data)
+  /* implicit */ constexpr KernelKey(const char* kernel_key_data)
       : kernel_key_data_(kernel_key_data), is_fallback_(false) {}
 
   constexpr static int MAX_SIZE = 691;
@@ -180,19 +209,55 @@ struct Kernel {
   // Data is not owned by the Kernel struct.
   KernelKey kernel_key_;
   OpFunction op_;
+  /// Optional; lets Method::init() bind the arguments of calls of op_.
+  OpBindFunction bind_ = nullptr;
   /**
    * We are doing a copy of the string pointer instead of duplicating the string
    * itself, we require the lifetime of the operator name to be at least as long
    * as the operator registry.
    */
-  explicit Kernel(const char* name, OpFunction func) : name_(name), op_(func) {}
+  explicit constexpr Kernel(const char* name, OpFunction func)
+      : name_(name), op_(func) {}
 
-  explicit Kernel(const char* name, KernelKey key, OpFunction func)
+  explicit constexpr Kernel(const char* name, KernelKey key, OpFunction func)
       : name_(name), kernel_key_(key), op_(func) {}
 
+  explicit constexpr Kernel(
+      const char* name,
+      OpFunction func,
+      OpBindFunction bind)
+      : name_(name), op_(func), bind_(bind) {}
+
   Kernel() {}
 };
 
+/**
+ * Places a constexpr array of Kernels in the `executorch_kernels` linker
+ * section instead of registering it with register_kernels():
+ *
+ *   ET_KERNEL_SECTION static constexpr Kernel kernels[] = {...};
+ *
+ * The registry reads the kernels of every linked table in that section where
+ * the linker put them, so nothing runs at static initialization time and the
+ * tables stay in read-only data. The kernels come before those registered with
+ * register_kernels() in get_registered_kernels(), in link order. Like a static
+ * registration, the table is only linked if its object file is, so link
+ * libraries that hold tables as whole archives, and into the same executable
+ * or shared library as the registry.
+ *
+ * Only supported on ELF targets, whose linkers define the bounds of the
+ * section; elsewhere the macro is not defined.
+ */
+#if defined(__ELF__)
+// The explicit alignment keeps compilers from over-aligning large tables, which
+// would leave gaps between the tables in the section.
+#define ET_KERNEL_SECTION                \
+  __attribute__((                        \
+      used,                              \
+      section("executorch_kernels"),     \
+      aligned(alignof(::executorch::runtime::Kernel))))
+#endif
+
 namespace internal {
 void make_kernel_key_string(Span<const TensorMeta> key, char* buf);
 } // namespace internal
@@ -214,10 +279,29 @@ bool registry_has_op_function(
     Span<const TensorMeta> meta_list = {});
 
 /**
- * Returns all registered kernels.
+ * Returns the kernel that get_op_function_from_registry() returns the function
+ * of, if present.
+ */
+::executorch::runtime::Result<const Kernel*> get_kernel_from_registry(
+    const char* name,
+    Span<const TensorMeta> meta_list = {});
+
+/**
+ * Returns all registered kernels: those of the executorch_kernels section
+ * first, then those registered with register_kernels(). Entries with a null
+ * name_ are padding between section tables and match no operator.
  */
 Span<const Kernel> get_registered_kernels();
 
+/**
+ * Returns a fingerprint of the registered kernels: their names and kernel keys,
+ * in registration order. Processes with the same fingerprint have the same
+ * kernels at the same positions of get_registered_kernels(), so indices into
+ * it can be computed ahead of time; see the KernelResolution table in
+ * schema/program.fbs.
+ */
+uint64_t get_registry_fingerprint();
+
 /**
  * Registers the provided kernels.
  *
@@ -56,9 +56,11 @@ def define_common_targets():
         runtime.cxx_library(
             name = "kernel_runtime_context" + aten_suffix,
             exported_headers = [
+                "kernel_cache.h",
                 "kernel_runtime_context.h",
             ],
             visibility = [
+                "//executorch/extension/...",
                 "//executorch/kernels/...",
                 "//executorch/runtime/executor/...",
                 "//executorch/runtime/kernel/...",
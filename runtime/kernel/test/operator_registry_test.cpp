@@ -7,6 +7,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <string>
 #include <vector>
 
 #include <executorch/runtime/core/exec_aten/exec_aten.h>
@@ -25,6 +26,7 @@ using exec_aten::Tensor;
 using executorch::runtime::Error;
 using executorch::runtime::EValue;
 using executorch::runtime::get_op_function_from_registry;
+using executorch::runtime::get_registry_fingerprint;
 using executorch::runtime::Kernel;
 using executorch::runtime::KernelKey;
 using executorch::runtime::KernelRuntimeContext;
@@ -302,3 +304,126 @@ TEST_F(OperatorRegistryTest, ExecutorUsesFallbackKernel) {
   auto val = values[0].toScalar().to<int64_t>();
   ASSERT_EQ(val, 100);
 }
+
+TEST_F(OperatorRegistryTest, ExecutorPrefersSpecializedKernelOverFallback) {
+  char buf_long_contiguous[BUF_SIZE];
+  make_kernel_key({{ScalarType::Long, {0, 1, 2, 3}}}, buf_long_contiguous);
+  KernelKey key = KernelKey(buf_long_contiguous);
+
+  Kernel kernels[] = {
+      Kernel(
+          "test::grault",
+          KernelKey{},
+          [](KernelRuntimeContext& context, EValue** stack) {
+            (void)context;
+            *(stack[0]) = Scalar(100);
+          }),
+      Kernel(
+          "test::grault",
+          key,
+          [](KernelRuntimeContext& context, EValue** stack) {
+            (void)context;
+            *(stack[0]) = Scalar(50);
+          }),
+  };
+  auto s1 = register_kernels(kernels);
+  EXPECT_EQ(s1, Error::Ok);
+
+  Tensor::DimOrderType dims[] = {0, 1, 2, 3};
+  auto dim_order_type = Span<Tensor::DimOrderType>(dims, 4);
+  TensorMeta meta_long[] = {TensorMeta(ScalarType::Long, dim_order_type)};
+  TensorMeta meta_float[] = {TensorMeta(ScalarType::Float, dim_order_type)};
+
+  EValue values[1];
+  EValue* evalues[1] = {&values[0]};
+  KernelRuntimeContext context{};
+
+  // The specialized kernel matches Long tensors.
+  Result<OpFunction> func_long = get_op_function_from_registry(
+      "test::grault", Span<const TensorMeta>(meta_long));
+  ASSERT_EQ(func_long.error(), Error::Ok);
+  values[0] = Scalar(0);
+  (*func_long)(context, evalues);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 50);
+
+  // Everything else uses the fallback kernel.
+  Result<OpFunction> func_float = get_op_function_from_registry(
+      "test::grault", Span<const TensorMeta>(meta_float));
+  ASSERT_EQ(func_float.error(), Error::Ok);
+  values[0] = Scalar(0);
+  (*func_float)(context, evalues);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 100);
+}
+
+TEST_F(OperatorRegistryTest, LookupManyKernels) {
+  constexpr size_t kNumKernels = 64;
+  // Kernel names must outlive the registry.
+  static std::vector<std::string> names;
+  names.reserve(kNumKernels);
+  std::vector<Kernel> kernels;
+  for (size_t i = 0; i < kNumKernels; ++i) {
+    names.push_back("test::many_" + std::to_string(i));
+    kernels.emplace_back(
+        names.back().c_str(), [](KernelRuntimeContext&, EValue**) {});
+  }
+  auto s1 = register_kernels({kernels.data(), kernels.size()});
+  EXPECT_EQ(s1, Error::Ok);
+
+  for (size_t i = 0; i < kNumKernels; ++i) {
+    EXPECT_TRUE(registry_has_op_function(names[i].c_str()));
+  }
+  EXPECT_FALSE(registry_has_op_function("test::many_64"));
+  EXPECT_FALSE(registry_has_op_function("test::many_"));
+}
+
+TEST_F(OperatorRegistryTest, RegistryFingerprintChangesOnRegistration) {
+  const uint64_t before = get_registry_fingerprint();
+  EXPECT_EQ(get_registry_fingerprint(), before);
+
+  Kernel kernels[] = {
+      Kernel("test::garply", [](KernelRuntimeContext&, EValue**) {})};
+  auto s1 = register_kernels(kernels);
+  EXPECT_EQ(s1, Error::Ok);
+
+  EXPECT_NE(get_registry_fingerprint(), before);
+}
+
+#if defined(ET_KERNEL_SECTION)
+namespace {
+ET_KERNEL_SECTION constexpr Kernel section_kernels[] = {
+    Kernel(
+        "test::waldo",
+        [](KernelRuntimeContext& context, EValue** stack) {
+          (void)context;
+          *(stack[0]) = Scalar(100);
+        }),
+    Kernel("test::fred", "v1/4;0", [](KernelRuntimeContext&, EValue**) {}),
+};
+} // namespace
+
+TEST_F(OperatorRegistryTest, SectionKernelsAreRegistered) {
+  EXPECT_TRUE(registry_has_op_function("test::waldo"));
+  EXPECT_FALSE(registry_has_op_function("test::fred"));
+
+  Result<OpFunction> func = get_op_function_from_registry("test::waldo");
+  ASSERT_EQ(func.error(), Error::Ok);
+  EValue values[1];
+  values[0] = Scalar(0);
+  EValue* evalues[1] = {&values[0]};
+  KernelRuntimeContext context{};
+  (*func)(context, evalues);
+  EXPECT_EQ(values[0].toScalar().to<int64_t>(), 100);
+
+  // Section kernels come first, and keep their place when more kernels are
+  // registered.
+  Kernel kernels[] = {
+      Kernel("test::plugh", [](KernelRuntimeContext&, EValue**) {})};
+  EXPECT_EQ(register_kernels(kernels), Error::Ok);
+  Span<const Kernel> registered = executorch::runtime::get_registered_kernels();
+  ASSERT_GE(registered.size(), 3);
+  EXPECT_STREQ(registered[0].name_, "test::waldo");
+  EXPECT_STREQ(registered[1].name_, "test::fred");
+  EXPECT_TRUE(registry_has_op_function("test::waldo"));
+  EXPECT_TRUE(registry_has_op_function("test::plugh"));
+}
+#endif
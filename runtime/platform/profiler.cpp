@@ -33,7 +33,31 @@ static mem_prof_event_t* mem_prof_arr =
 
 static uint32_t num_blocks = 0;
 static bool prof_stats_dumped = false;
+static uint32_t num_dropped_events = 0;
+static const profiler_backend_t* backend = nullptr;
 prof_state_t profile_state_tls{-1, 0u};
+
+// Counts an event that did not fit in the profiling buffer, and reports the
+// first one since the last reset.
+void drop_event(const char* buffer_name, const char* max_name) {
+  if (num_dropped_events == 0) {
+    ET_LOG(
+        Error,
+        "The %s profiling buffer is full, dropping events. Increase %s and "
+        "re-compile, or send the events to an EventTracer.",
+        buffer_name,
+        max_name);
+  }
+  num_dropped_events++;
+}
+
+// Clears the profiling entries of the current block.
+void reset_block() {
+  prof_stats_dumped = false;
+  prof_header->prof_entries = 0;
+  prof_header->allocator_entries = 0;
+  prof_header->mem_prof_entries = 0;
+}
 } // namespace
 
 const prof_state_t& get_profile_tls_state() {
@@ -54,15 +78,24 @@ ExecutorchProfilerInstructionScope::~ExecutorchProfilerInstructionScope() {
   set_profile_tls_state(old_state_);
 }
 
+void set_profiler_backend(const profiler_backend_t* new_backend) {
+  backend = new_backend;
+}
+
 uint32_t begin_profiling(const char* name) {
-  ET_CHECK_MSG(
-      prof_header->prof_entries < MAX_PROFILE_EVENTS,
-      "Out of profiling buffer space. Increase MAX_PROFILE_EVENTS and re-compile.");
+  prof_state_t state = get_profile_tls_state();
+  if (backend != nullptr) {
+    return backend->begin_profiling(
+        backend->context, name, state.chain_idx, state.instruction_idx);
+  }
+  if (prof_header->prof_entries >= MAX_PROFILE_EVENTS) {
+    drop_event("perf event", "MAX_PROFILE_EVENTS");
+    return kDroppedProfilingToken;
+  }
   uint32_t curr_counter = prof_header->prof_entries;
   prof_header->prof_entries++;
   prof_arr[curr_counter].end_time = 0;
   prof_arr[curr_counter].name_str = name;
-  prof_state_t state = get_profile_tls_state();
   prof_arr[curr_counter].chain_idx = state.chain_idx;
   prof_arr[curr_counter].instruction_idx = state.instruction_idx;
   // Set start time at the last to ensure that we're not capturing
@@ -72,6 +105,13 @@ uint32_t begin_profiling(const char* name) {
 }
 
 void end_profiling(uint32_t token_id) {
+  if (backend != nullptr) {
+    backend->end_profiling(backend->context, token_id);
+    return;
+  }
+  if (token_id == kDroppedProfilingToken) {
+    return;
+  }
   ET_CHECK_MSG(token_id < MAX_PROFILE_EVENTS, "Invalid token id.");
   prof_arr[token_id].end_time = et_pal_current_ticks();
 }
@@ -80,6 +120,7 @@ void dump_profile_stats(prof_result_t* prof_result) {
   prof_result->prof_data = (uint8_t*)prof_buf;
   prof_result->num_bytes = num_blocks * prof_buf_size;
   prof_result->num_blocks = num_blocks;
+  prof_result->num_dropped_events = num_dropped_events;
 
   if (!prof_stats_dumped) {
     for (size_t i = 0; i < num_blocks; i++) {
@@ -107,20 +148,17 @@ void dump_profile_stats(prof_result_t* prof_result) {
 }
 
 void reset_profile_stats() {
-  prof_stats_dumped = false;
-  prof_header->prof_entries = 0;
-  prof_header->allocator_entries = 0;
-  prof_header->mem_prof_entries = 0;
+  reset_block();
+  num_dropped_events = 0;
 }
 
 void track_allocation(int32_t id, uint32_t size) {
   if (id == -1)
     return;
-  ET_CHECK_MSG(
-      prof_header->mem_prof_entries < MAX_MEM_PROFILE_EVENTS,
-      "Out of memory profiling buffer space. Increase MAX_MEM_PROFILE_EVENTS\
-       to %" PRIu32 " and re-compile.",
-      prof_header->mem_prof_entries);
+  if (prof_header->mem_prof_entries >= MAX_MEM_PROFILE_EVENTS) {
+    drop_event("memory allocation", "MAX_MEM_PROFILE_EVENTS");
+    return;
+  }
   mem_prof_arr[prof_header->mem_prof_entries].allocator_id = id;
   mem_prof_arr[prof_header->mem_prof_entries].allocation_size = size;
   prof_header->mem_prof_entries++;
@@ -144,6 +182,10 @@ uint32_t track_allocator(const char* name) {
 }
 
 void profiling_create_block(const char* name) {
+  if (backend != nullptr) {
+    backend->create_block(backend->context, name);
+    return;
+  }
   // If the current profiling block is not used then continue to use this, if
   // not move onto the next block.
   if (prof_header->prof_entries != 0 || prof_header->mem_prof_entries != 0 ||
@@ -171,7 +213,7 @@ void profiling_create_block(const char* name) {
   prof_header->max_prof_entries = MAX_PROFILE_EVENTS;
   prof_header->max_allocator_entries = MEM_PROFILE_MAX_ALLOCATORS;
   prof_header->max_mem_prof_entries = MAX_MEM_PROFILE_EVENTS;
-  reset_profile_stats();
+  reset_block();
 
   // Set the base addresses for the various profiling entries arrays.
   prof_arr = (prof_event_t*)(base + prof_events_offset);
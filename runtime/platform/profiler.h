@@ -21,13 +21,15 @@ namespace runtime {
 
 // By default we support profiling upto 1024 perf events. Build
 // targets can override this to increase the profiling buffer size
-// during compilation.
+// during compilation. Events beyond this are dropped and counted in
+// prof_result_t.num_dropped_events.
 #ifndef MAX_PROFILE_EVENTS
 #define MAX_PROFILE_EVENTS 1024
 #endif
 // By default we support profiling upto 1024 memory allocation events.
 // Build targets can choose to override this, which will consequently have
-// the effect of increasing/decreasing the profiling buffer size.
+// the effect of increasing/decreasing the profiling buffer size. Allocations
+// beyond this are dropped like perf events.
 #ifndef MAX_MEM_PROFILE_EVENTS
 #define MAX_MEM_PROFILE_EVENTS 1024
 #endif
@@ -75,6 +77,9 @@ typedef struct alignas(8) {
   uint8_t* prof_data;
   uint32_t num_bytes;
   uint32_t num_blocks;
+  // The number of events that did not fit in the profiling buffer since the
+  // last reset, and are missing from prof_data.
+  uint32_t num_dropped_events;
 } prof_result_t;
 
 typedef struct alignas(8) {
@@ -115,10 +120,40 @@ constexpr size_t prof_mem_alloc_info_offset =
 constexpr size_t prof_mem_alloc_events_offset = prof_mem_alloc_info_offset +
     sizeof(prof_allocator_t) * MEM_PROFILE_MAX_ALLOCATORS;
 
+// Token returned by begin_profiling() for an event that was dropped, because
+// the profiling buffer was full. end_profiling() ignores it.
+constexpr uint32_t kDroppedProfilingToken = UINT32_MAX;
+
 // Set the initial state for the profiler assuming we're using the
 // statically allocated buffer declared in the profiler module.
 void profiler_init(void);
 
+/**
+ * Receives the profiling events and blocks of the macros below in place of the
+ * statically allocated profiling buffer. Memory allocations are still tracked
+ * in the profiling buffer.
+ *
+ * Use executorch::runtime::set_profiling_event_tracer() in
+ * runtime/core/event_tracer_profiler.h to send them to an EventTracer.
+ */
+typedef struct {
+  // Passed to each of the functions below.
+  void* context;
+  void (*create_block)(void* context, const char* name);
+  // Returns a token that identifies the event in end_profiling().
+  uint32_t (*begin_profiling)(
+      void* context,
+      const char* name,
+      int32_t chain_idx,
+      uint32_t instruction_idx);
+  void (*end_profiling)(void* context, uint32_t token_id);
+} profiler_backend_t;
+
+// Sends the profiling events to `backend`, which must stay valid until it is
+// replaced, or to the profiling buffer again if it is null. Events that are
+// in progress when the backend changes are lost.
+void set_profiler_backend(const profiler_backend_t* backend);
+
 // This starts the profiling of this event and returns a token
 // by which this event can be referred to in the future.
 uint32_t begin_profiling(const char* name);
@@ -193,6 +228,7 @@ using ::executorch::runtime::end_profiling;
 using ::executorch::runtime::ExecutorchProfiler;
 using ::executorch::runtime::ExecutorchProfilerInstructionScope;
 using ::executorch::runtime::get_profile_tls_state;
+using ::executorch::runtime::kDroppedProfilingToken;
 using ::executorch::runtime::mem_prof_event_t;
 using ::executorch::runtime::prof_allocator_t;
 using ::executorch::runtime::prof_buf_size;
@@ -204,10 +240,12 @@ using ::executorch::runtime::prof_mem_alloc_events_offset;
 using ::executorch::runtime::prof_mem_alloc_info_offset;
 using ::executorch::runtime::prof_result_t;
 using ::executorch::runtime::prof_state_t;
+using ::executorch::runtime::profiler_backend_t;
 using ::executorch::runtime::profiler_init;
 using ::executorch::runtime::profiling_create_block;
 using ::executorch::runtime::reset_profile_stats;
 using ::executorch::runtime::set_profile_tls_state;
+using ::executorch::runtime::set_profiler_backend;
 using ::executorch::runtime::track_allocation;
 using ::executorch::runtime::track_allocator;
 } // namespace executor
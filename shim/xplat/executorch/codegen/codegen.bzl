@@ -399,6 +399,11 @@ def build_portable_lib(name, oplist_header_name, feature = None):
         # header_namespace is only available in xplat. See https://fburl.com/code/we2gvopk
         header_namespace = "executorch/kernels/portable/cpu",
         compiler_flags = ["-Wno-missing-prototypes"] +
+                         # Most kernels do not include selective_build.h
+                         # themselves, and it must be seen before the
+                         # ET_SWITCH macros are defined for the dtype
+                         # selection to apply to them.
+                         ["-include", "executorch/kernels/portable/cpu/selective_build.h"] +
                          # For shared library build, we don't want to expose symbols of
                          # kernel implementation (ex torch::executor::native::tanh_out)
                          # to library users. They should use kernels through registry only.
@@ -552,7 +557,10 @@ def executorch_generated_lib(
         cmd = ("$(exe //executorch/codegen/tools:gen_selected_op_variants) " +
                "--yaml_file_path $(location :{}[selected_operators.yaml]) " +
                "--output_dir $OUT").format(oplist_dir_name),
-        outs = {"selected_op_variants": ["selected_op_variants.h"]},
+        outs = {
+            "selected_op_variants": ["selected_op_variants.h"],
+            "selected_operators": ["selected_operators.h"],
+        },
         default_outs = ["."],
         platforms = platforms,
         visibility = visibility,
@@ -924,6 +924,7 @@ ATEN_OPS = (
         name = "op_permute_copy",
         deps = [
             "//executorch/kernels/portable/cpu/util:copy_ops_util",
+            "//executorch/kernels/portable/cpu/util:transpose_util",
         ],
     ),
     op_target(
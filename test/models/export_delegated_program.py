@@ -8,7 +8,7 @@ import argparse
 import inspect
 import os
 import sys
-from typing import Dict, final, Optional, Sequence, Type
+from typing import Dict, final, Optional, Sequence, Tuple, Type
 
 import executorch.exir as exir
 
@@ -16,11 +16,17 @@ import torch
 from executorch.exir import EdgeCompileConfig, to_edge, to_edge_transform_and_lower
 from executorch.exir.backend.backend_api import to_backend
 from executorch.exir.backend.backend_details import BackendDetails, PreprocessResult
+from executorch.exir.backend.partitioner import (
+    DelegationSpec,
+    Partitioner,
+    PartitionResult,
+)
 from executorch.exir.backend.test.backend_with_compiler_demo import (
     BackendWithCompilerDemo,
 )
+from executorch.exir.dialects._ops import ops as exir_ops
 from torch import nn
-from torch.export import export
+from torch.export import export, ExportedProgram
 
 """Traces and exports delegated nn.Modules to ExecuTorch .pte program files.
 
@@ -87,6 +93,28 @@ class ModuleSubLarge(nn.Module):
         return (torch.ones(n, n, n), 2 * torch.ones(n, n, n), 3 * torch.ones(n, n, n))
 
 
+class ModuleAddChainAndSub(nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    def forward(
+        self, a: torch.Tensor, b: torch.Tensor
+    ) -> Tuple[torch.Tensor, torch.Tensor]:
+        # Each add is a delegate call of its own. The second add and the sub
+        # both only depend on the first add.
+        x: torch.Tensor = torch.add(a, b)
+        y: torch.Tensor = torch.add(x, b)
+        z: torch.Tensor = torch.sub(x, b)
+        return y, z
+
+    def get_random_inputs(self) -> Sequence[torch.Tensor]:
+        return (torch.ones(2, 2), 2 * torch.ones(2, 2))
+
+    @staticmethod
+    def get_partitioner() -> Partitioner:
+        return AddPartitioner()
+
+
 #
 # Backends
 #
@@ -101,6 +129,29 @@ class StubBackend(BackendDetails):
         return PreprocessResult(processed_bytes=b"StubBackend:data")
 
 
+@final
+class AddPartitioner(Partitioner):
+    """Lowers each add to StubBackend in a partition of its own."""
+
+    def __init__(self) -> None:
+        super().__init__()
+        self.delegation_spec = DelegationSpec(StubBackend.__name__, [])
+
+    def partition(self, exported_program: ExportedProgram) -> PartitionResult:
+        partition_tags = {}
+        for node in exported_program.graph.nodes:
+            if (
+                node.op == "call_function"
+                and node.target == exir_ops.edge.aten.add.Tensor
+            ):
+                delegation_tag = f"tag{len(partition_tags)}"
+                node.meta["delegation_tag"] = delegation_tag
+                partition_tags[delegation_tag] = self.delegation_spec
+        return PartitionResult(
+            tagged_exported_program=exported_program, partition_tags=partition_tags
+        )
+
+
 #
 # Program logic
 #
@@ -149,6 +200,13 @@ def export_module_to_program(
             compile_config=edge_config,
             partitioner=[XnnpackPartitioner()],
         ).to_executorch(config=et_config)
+    elif hasattr(eager_module, "get_partitioner"):
+        # pyre-ignore[16]: pyre doesn't know about get_partitioner.
+        executorch_program = (
+            to_edge(exported_program, compile_config=edge_config)
+            .to_backend(eager_module.get_partitioner())
+            .to_executorch(config=et_config)
+        )
     else:
         edge: exir.EdgeProgramManager = to_edge(exported_program)
         lowered_module = to_backend(
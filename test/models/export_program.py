@@ -103,6 +103,25 @@ class ModuleAddHalf(nn.Module):
         )
 
 
+class ModuleBranchingDynamic(nn.Module):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x):
+        # Two branches that only meet at the end, so that their ops can share
+        # waves when executed in parallel. The view sizes are Int lists that
+        # reference the output of a sym_size op.
+        a = torch.add(x, 1.0).view(x.size(0), 2, 2)
+        b = torch.mul(x, 2.0).view(x.size(0), 2, 2)
+        return torch.add(a, b)
+
+    def get_random_inputs(self):
+        return (torch.randn(3, 4),)
+
+    def get_dynamic_shapes(self):
+        return ({0: Dim("dim0_x", max=3)},)
+
+
 class ModuleDynamicCatUnallocatedIO(nn.Module):
     def __init__(self):
         super(ModuleDynamicCatUnallocatedIO, self).__init__()
@@ -182,6 +201,19 @@ class ModuleSimpleTrain(torch.nn.Module):
         return True
 
 
+class ModuleStateful(nn.Module):
+    def __init__(self):
+        super().__init__()
+        self.register_buffer("state", torch.ones(2, 2, dtype=torch.float))
+
+    def forward(self, x):
+        self.state.add_(x)
+        return self.state * 1.0
+
+    def get_random_inputs(self):
+        return (torch.ones(2, 2, dtype=torch.float),)
+
+
 #
 # Main logic.
 #
@@ -62,11 +62,13 @@ def define_common_targets():
         "ModuleAdd",
         "ModuleAddHalf",
         "ModuleBasic",
+        "ModuleBranchingDynamic",
         "ModuleLinear",
         "ModuleMultipleEntry",
         "ModuleIndex",
         "ModuleDynamicCatUnallocatedIO",
         "ModuleSimpleTrain",
+        "ModuleStateful",
     ]
 
     # Generates Executorch .pte program files for various modules at build time.
@@ -125,6 +127,7 @@ def define_common_targets():
 
     # Class names of nn.Modules for :exported_delegated_programs to export.
     DELEGATED_MODULES_TO_EXPORT = [
+        "ModuleAddChainAndSub",
         "ModuleAddMul",
         "ModuleAddLarge",
         "ModuleSubLarge",